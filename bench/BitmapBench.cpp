@@ -187,6 +187,7 @@ enum Flags {
     kRotate_Flag            = 1 << 1,
     kBilerp_Flag            = 1 << 2,
     kBicubic_Flag           = 1 << 3,
+    kIntScale_Flag          = 1 << 4,
 };
 
 static bool isBilerp(uint32_t flags) {
@@ -213,6 +214,9 @@ protected:
         if (fFlags & kScale_Flag) {
             fFullName.append("_scale");
         }
+        if (fFlags & kIntScale_Flag) {
+            fFullName.append("_intscale");
+        }
         if (fFlags & kRotate_Flag) {
             fFullName.append("_rotate");
         }
@@ -236,6 +240,14 @@ protected:
             canvas->scale(SK_Scalar1 * 99/100, SK_Scalar1 * 99/100);
             canvas->translate(-x, -y);
         }
+        if (fFlags & kIntScale_Flag) {
+            const SkScalar x = SkIntToScalar(dim.fWidth) / 2;
+            const SkScalar y = SkIntToScalar(dim.fHeight) / 2;
+
+            canvas->translate(x, y);
+            canvas->scale(SkIntToScalar(3), SkIntToScalar(3));
+            canvas->translate(-x, -y);
+        }
         if (fFlags & kRotate_Flag) {
             const SkScalar x = SkIntToScalar(dim.fWidth) / 2;
             const SkScalar y = SkIntToScalar(dim.fHeight) / 2;
@@ -374,6 +386,10 @@ DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, f
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, true, true, kScale_Flag | kBilerp_Flag); )
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, true, false, kScale_Flag | kBilerp_Flag); )
 
+// integer scale nofilter -> Clamp_S32_opaque_D32_nofilter_intscaleX_shaderproc
+DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kIntScale_Flag); )
+DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, false, false, kIntScale_Flag); )
+
 // scale rotate filter -> S32_opaque_D32_filter_DXDY_{SSE2,SSSE3}
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kScale_Flag | kRotate_Flag | kBilerp_Flag); )
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, false, false, kScale_Flag | kRotate_Flag | kBilerp_Flag); )
@@ -115,3 +115,70 @@ DEF_BENCH(return new BlurBench(REALBIG, kNormal_SkBlurStyle, SkBlurMaskFilter::k
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle, SkBlurMaskFilter::kHighQuality_BlurFlag);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Times SkBlurMask::BoxBlur alone on a size x size A8 mask, so big masks and large sigmas can be
+// tracked without the cost of rasterizing the source.
+class BlurMaskBench : public Benchmark {
+    int           fSize;
+    SkScalar      fSigma;
+    SkBlurQuality fQuality;
+    SkMask        fSrc;
+    SkString      fName;
+
+public:
+    BlurMaskBench(int size, SkScalar sigma, SkBlurQuality quality)
+        : fSize(size), fSigma(sigma), fQuality(quality) {
+        fSrc.fImage = NULL;
+        fName.printf("blurmask_%d_%g_%s", size, SkScalarToFloat(sigma),
+                     kHigh_SkBlurQuality == quality ? "high_quality" : "low_quality");
+    }
+
+    ~BlurMaskBench() {
+        SkMask::FreeImage(fSrc.fImage);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    void onPreDraw() override {
+        SkMask::FreeImage(fSrc.fImage);
+        fSrc.fBounds.set(0, 0, fSize, fSize);
+        fSrc.fFormat = SkMask::kA8_Format;
+        fSrc.fRowBytes = fSize;
+        fSrc.fImage = SkMask::AllocImage(fSrc.computeImageSize());
+
+        SkRandom rand;
+        for (size_t i = 0; i < fSrc.computeImageSize(); ++i) {
+            fSrc.fImage[i] = rand.nextU() & 0xFF;
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkMask dst;
+            dst.fImage = NULL;
+            SkBlurMask::BoxBlur(&dst, fSrc, fSigma, kNormal_SkBlurStyle, fQuality);
+            SkMask::FreeImage(dst.fImage);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new BlurMaskBench(  64,  3, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench(  64, 10, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench( 256,  3, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench( 256, 10, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench( 256, 40, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench(1024,  3, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench(1024, 10, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench(1024, 40, kHigh_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench(1024, 10, kLow_SkBlurQuality);)
+DEF_BENCH(return new BlurMaskBench(1024, 40, kLow_SkBlurQuality);)
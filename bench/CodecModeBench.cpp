@@ -0,0 +1,160 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "CodecModeBench.h"
+#include "SkCodec.h"
+#include "SkScanlineDecoder.h"
+#include "SkStream.h"
+
+const size_t CodecModeBench::kIncrementalChunkSize;
+
+static const char* mode_name(CodecModeBench::Mode mode) {
+    switch (mode) {
+        case CodecModeBench::kScanline_Mode:      return "Scanline";
+        case CodecModeBench::kSkipScanlines_Mode: return "SkipScanlines";
+        case CodecModeBench::kScaled_Mode:        return "Scaled";
+        case CodecModeBench::kSubset_Mode:        return "Subset";
+        case CodecModeBench::kIncremental_Mode:   return "Incremental";
+    }
+    SkDEBUGFAIL("Unknown mode");
+    return "Unknown";
+}
+
+CodecModeBench* CodecModeBench::Create(const SkString& baseName, SkData* encoded, Mode mode,
+                                       float scale) {
+    SkAutoTDelete<CodecModeBench> bench(SkNEW_ARGS(CodecModeBench,
+                                                   (baseName, encoded, mode, scale)));
+    bench->onPreDraw();
+    if (bench->fInfo.isEmpty() || !bench->decode()) {
+        return NULL;
+    }
+    return bench.detach();
+}
+
+CodecModeBench::CodecModeBench(const SkString& baseName, SkData* encoded, Mode mode, float scale)
+    : fMode(mode)
+    , fScale(scale)
+    , fData(SkRef(encoded)) {
+    fName.printf("CodecMode_%s", mode_name(mode));
+    if (kScaled_Mode == mode) {
+        fName.appendf("_%.3g", scale);
+    } else if (kIncremental_Mode == mode) {
+        fName.appendf("_%d", (int)kIncrementalChunkSize);
+    }
+    fName.appendf("_%s", baseName.c_str());
+}
+
+const char* CodecModeBench::onGetName() {
+    return fName.c_str();
+}
+
+bool CodecModeBench::isSuitableFor(Backend backend) {
+    return kNonRendering_Backend == backend;
+}
+
+void CodecModeBench::onPreDraw() {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
+    fInfo = SkImageInfo::MakeUnknown();
+    if (!codec) {
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+
+    switch (fMode) {
+        case kScaled_Mode: {
+            const SkISize size = codec->getScaledDimensions(fScale);
+            if (size == info.dimensions()) {
+                // This codec can't scale by fScale.
+                return;
+            }
+            fInfo = info.makeWH(size.width(), size.height());
+            break;
+        }
+        case kSubset_Mode:
+            fSubset = SkIRect::MakeXYWH(info.width() / 3, info.height() / 3,
+                                        info.width() / 3, info.height() / 3);
+            if (fSubset.isEmpty() || !codec->getValidSubset(&fSubset)) {
+                return;
+            }
+            fInfo = info.makeWH(fSubset.width(), fSubset.height());
+            break;
+        default:
+            fInfo = info;
+            break;
+    }
+
+    fPixelStorage.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+}
+
+bool CodecModeBench::decode() {
+    void* pixels = fPixelStorage.get();
+    const size_t rowBytes = fInfo.minRowBytes();
+
+    switch (fMode) {
+        case kScanline_Mode:
+        case kSkipScanlines_Mode: {
+            SkAutoTDelete<SkScanlineDecoder> decoder(SkScanlineDecoder::NewFromData(fData));
+            if (!decoder || SkCodec::kSuccess != decoder->start(fInfo)) {
+                return false;
+            }
+            int y = 0;
+            if (kSkipScanlines_Mode == fMode) {
+                y = fInfo.height() * 3 / 4;
+                if (SkCodec::kSuccess != decoder->skipScanlines(y)) {
+                    return false;
+                }
+            }
+            for (; y < fInfo.height(); y++) {
+                const SkCodec::Result result =
+                        decoder->getScanlines(SkTAddOffset<void>(pixels, y * rowBytes), 1, 0);
+                if (SkCodec::kSuccess != result && SkCodec::kIncompleteInput != result) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case kScaled_Mode:
+        case kSubset_Mode: {
+            SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(fData));
+            SkCodec::Options options;
+            options.fSubset = kSubset_Mode == fMode ? &fSubset : NULL;
+            const SkCodec::Result result =
+                    codec->getPixels(fInfo, pixels, rowBytes, &options, NULL, NULL);
+            return SkCodec::kSuccess == result || SkCodec::kIncompleteInput == result;
+        }
+        case kIncremental_Mode: {
+            // Hand the codec as little data as it needs to read the header, then the rest in
+            // chunks, as if it were arriving over the network.
+            size_t offset = 0;
+            SkAutoTDelete<SkCodec> codec;
+            while (!codec && offset < fData->size()) {
+                offset = SkTMin(offset + kIncrementalChunkSize, fData->size());
+                codec.reset(SkCodec::NewFromStream(SkNEW_ARGS(SkMemoryStream,
+                                                              (fData->data(), offset, false))));
+            }
+            if (!codec || SkCodec::kSuccess != codec->startIncrementalDecode(fInfo, pixels,
+                                                                             rowBytes)) {
+                return false;
+            }
+            SkCodec::Result result = codec->incrementalDecode(NULL, 0, NULL);
+            while (SkCodec::kIncompleteInput == result && offset < fData->size()) {
+                const size_t length = SkTMin(kIncrementalChunkSize, fData->size() - offset);
+                result = codec->incrementalDecode(fData->bytes() + offset, length, NULL);
+                offset += length;
+            }
+            return SkCodec::kSuccess == result;
+        }
+    }
+    SkDEBUGFAIL("Unknown mode");
+    return false;
+}
+
+void CodecModeBench::onDraw(const int n, SkCanvas*) {
+    for (int i = 0; i < n; i++) {
+        SkAssertResult(this->decode());
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef CodecModeBench_DEFINED
+#define CodecModeBench_DEFINED
+
+#include "Benchmark.h"
+#include "SkData.h"
+#include "SkImageInfo.h"
+#include "SkRect.h"
+#include "SkRefCnt.h"
+#include "SkString.h"
+
+/**
+ *  Time the ways of decoding with SkCodec other than a single full getPixels(), which
+ *  CodecBench covers.
+ */
+class CodecModeBench : public Benchmark {
+public:
+    enum Mode {
+        // Decode every row, one getScanlines() call at a time.
+        kScanline_Mode,
+        // skipScanlines() over the top three quarters, then decode the rest row by row.
+        kSkipScanlines_Mode,
+        // getPixels() into the dimensions getScaledDimensions() picks for the scale.
+        kScaled_Mode,
+        // getPixels() of the middle ninth of the image, using Options::fSubset.
+        kSubset_Mode,
+        // incrementalDecode(), feeding the encoded data kIncrementalChunkSize bytes at a time.
+        kIncremental_Mode,
+    };
+
+    static const size_t kIncrementalChunkSize = 4096;
+
+    /**
+     *  Returns NULL if encoded's codec can't decode in this mode, e.g. because it can't scale
+     *  by scale or decode subsets. scale is only used by kScaled_Mode. Calls encoded->ref().
+     */
+    static CodecModeBench* Create(const SkString& baseName, SkData* encoded, Mode mode,
+                                  float scale = 1.0f);
+
+protected:
+    const char* onGetName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onDraw(const int n, SkCanvas* canvas) override;
+    void onPreDraw() override;
+
+private:
+    CodecModeBench(const SkString& baseName, SkData* encoded, Mode mode, float scale);
+
+    // Returns false if the decode fails.
+    bool decode();
+
+    SkString                fName;
+    const Mode              fMode;
+    const float             fScale;
+    SkAutoTUnref<SkData>    fData;
+    SkImageInfo             fInfo;          // Set in onPreDraw.
+    SkIRect                 fSubset;        // Set in onPreDraw, for kSubset_Mode.
+    SkAutoMalloc            fPixelStorage;
+    typedef Benchmark INHERITED;
+};
+#endif // CodecModeBench_DEFINED
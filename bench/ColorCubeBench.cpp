@@ -14,11 +14,14 @@ class ColorCubeBench : public Benchmark {
     int fCubeDimension;
     SkData* fCubeData;
     SkBitmap fBitmap;
+    bool fTranslucent;
 
 public:
-    ColorCubeBench()
+    // A translucent source has to be unpremultiplied before each lookup.
+    ColorCubeBench(bool translucent = false)
      : fCubeDimension(0)
-     , fCubeData(NULL) {
+     , fCubeData(NULL)
+     , fTranslucent(translucent) {
         fSize = SkISize::Make(2880, 1800); // 2014 Macbook Pro resolution
     }
 
@@ -28,7 +31,7 @@ public:
 
 protected:
     const char* onGetName() override {
-        return "colorcube";
+        return fTranslucent ? "colorcube_translucent" : "colorcube";
     }
 
     void onPreDraw() override {
@@ -47,12 +50,14 @@ protected:
     }
 
 private:
-    static SkShader* MakeLinear(const SkISize& size) {
+    static SkShader* MakeLinear(const SkISize& size, bool translucent) {
         const SkPoint pts[2] = {
                 { 0, 0 },
                 { SkIntToScalar(size.width()), SkIntToScalar(size.height()) }
             };
-        static const SkColor colors[] = { SK_ColorYELLOW, SK_ColorBLUE };
+        static const SkColor opaqueColors[] = { SK_ColorYELLOW, SK_ColorBLUE };
+        static const SkColor translucentColors[] = { 0x80FFFF00, 0x400000FF };
+        const SkColor* colors = translucent ? translucentColors : opaqueColors;
         return SkGradientShader::CreateLinear(
             pts, colors, NULL, 2, SkShader::kRepeat_TileMode, 0, &SkMatrix::I());
     }
@@ -63,7 +68,7 @@ private:
         canvas.clear(0x00000000);
         SkPaint paint;
         paint.setAntiAlias(true);
-        SkShader* shader = MakeLinear(fSize);
+        SkShader* shader = MakeLinear(fSize, fTranslucent);
         paint.setShader(shader);
         SkRect r = { 0, 0, SkIntToScalar(fSize.width()), SkIntToScalar(fSize.height()) };
         canvas.drawRect(r, paint);
@@ -109,3 +114,4 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ColorCubeBench(); )
+DEF_BENCH( return new ColorCubeBench(true); )
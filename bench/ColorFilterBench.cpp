@@ -278,6 +278,48 @@ private:
     typedef ColorFilterBaseBench INHERITED;
 };
 
+// Filters a whole translucent bitmap through a full matrix, so the time goes into filterSpan.
+class ColorMatrixBitmapBench : public Benchmark {
+public:
+    ColorMatrixBitmapBench() {}
+
+protected:
+    const char* onGetName() override {
+        return "colorfilter_matrix_bitmap";
+    }
+
+    void onPreDraw() override {
+        fBitmap.allocN32Pixels(kSize, kSize);
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                *fBitmap.getAddr32(x, y) = SkPreMultiplyARGB(x & 0xFF, y & 0xFF, x & 0xFF, 0x80);
+            }
+        }
+
+        SkScalar sepia[20] = { 0.393f, 0.769f, 0.189f, 0.0f, 0.0f,
+                               0.349f, 0.686f, 0.168f, 0.0f, 0.0f,
+                               0.272f, 0.534f, 0.131f, 0.0f, 0.0f,
+                               0.0f,   0.0f,   0.0f,   1.0f, 0.0f };
+        fFilter.reset(SkColorMatrixFilter::Create(sepia));
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setColorFilter(fFilter);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawBitmap(fBitmap, 0, 0, &paint);
+        }
+    }
+
+private:
+    static const int kSize = 512;
+
+    SkBitmap fBitmap;
+    SkAutoTUnref<SkColorFilter> fFilter;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ColorFilterDimBrightBench(true); )
@@ -297,3 +339,5 @@ DEF_BENCH( return new ColorFilterBrightBlueBench(false); )
 DEF_BENCH( return new ColorFilterBrightBench(false); )
 DEF_BENCH( return new ColorFilterBlueBench(false); )
 DEF_BENCH( return new ColorFilterGrayBench(false); )
+
+DEF_BENCH( return new ColorMatrixBitmapBench(); )
@@ -7,6 +7,7 @@
 
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkBlitMask.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
 #include "SkDraw.h"
@@ -64,7 +65,69 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Blits the coverage of a large AA shape into N32 pixels, the way big glyphs and masked paths
+// are drawn. Most of the mask is either empty or fully covered.
+class BlitMaskBench : public Benchmark {
+    SkColor     fColor;
+    SkString    fName;
+    SkAutoPixmapStorage fCoverage;
+    SkAutoPixmapStorage fDevice;
+public:
+    BlitMaskBench(SkColor color) : fColor(color) {
+        fName.printf("blit_coverage_mask_%08x", color);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onPreDraw() override {
+        SkPath path;
+        path.addCircle(250, 250, 240);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        fCoverage.alloc(SkImageInfo::MakeA8(500, 500));
+        fCoverage.erase(0);
+        SkMatrix identity;
+        identity.setIdentity();
+        SkRasterClip rc(SkIRect::MakeWH(500, 500));
+        SkDraw draw;
+        draw.fDst       = fCoverage;
+        draw.fMatrix    = &identity;
+        draw.fClip      = &rc.bwRgn();
+        draw.fRC        = &rc;
+        draw.drawPathCoverage(path, paint);
+
+        fDevice.alloc(SkImageInfo::MakeN32Premul(500, 500));
+        fDevice.erase(SK_ColorWHITE);
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkMask mask;
+        mask.fImage     = (uint8_t*)fCoverage.writable_addr();
+        mask.fBounds    = SkIRect::MakeWH(500, 500);
+        mask.fRowBytes  = SkToU32(fCoverage.rowBytes());
+        mask.fFormat    = SkMask::kA8_Format;
+        for (int i = 0; i < loops; ++i) {
+            SkBlitMask::BlitColor(fDevice, mask, mask.fBounds, fColor);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new DrawPathBench(false) )
 DEF_BENCH( return new DrawPathBench(true) )
+
+DEF_BENCH( return new BlitMaskBench(SK_ColorBLACK) )
+DEF_BENCH( return new BlitMaskBench(0xFF4080C0) )
+DEF_BENCH( return new BlitMaskBench(0x804080C0) )
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDistanceFieldGen.h"
+#include "SkPaint.h"
+#include "SkString.h"
+#include "SkTemplates.h"
+
+// Generates the distance field of a glyph-sized A8 or BW image, as is done for each new distance
+// field glyph or path.
+class DistanceFieldGenBench : public Benchmark {
+public:
+    DistanceFieldGenBench(int size, bool bw) : fSize(size), fBW(bw) {
+        fName.printf("distance_field_gen_%s_%d", bw ? "bw" : "a8", size);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        fImage.allocPixels(SkImageInfo::MakeA8(fSize, fSize));
+        fImage.eraseColor(0);
+        SkCanvas canvas(fImage);
+        SkPaint paint;
+        paint.setAntiAlias(!fBW);
+        paint.setTextSize(fSize * 0.9f);
+        canvas.drawText("g", 1, fSize * 0.2f, fSize * 0.7f, paint);
+
+        if (fBW) {
+            const int rowBytes = (fSize + 7) / 8;
+            fBWImage.reset(rowBytes * fSize);
+            sk_bzero(fBWImage.get(), rowBytes * fSize);
+            for (int y = 0; y < fSize; ++y) {
+                const uint8_t* src = fImage.getAddr8(0, y);
+                for (int x = 0; x < fSize; ++x) {
+                    if (src[x] >= 0x80) {
+                        fBWImage[y * rowBytes + x / 8] |= 0x80 >> (x & 7);
+                    }
+                }
+            }
+        }
+        fDistanceField.reset((fSize + 2 * SK_DistanceFieldPad) *
+                             (fSize + 2 * SK_DistanceFieldPad));
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            if (fBW) {
+                SkGenerateDistanceFieldFromBWImage(fDistanceField.get(), fBWImage.get(),
+                                                   fSize, fSize, (fSize + 7) / 8);
+            } else {
+                SkGenerateDistanceFieldFromA8Image(fDistanceField.get(),
+                                                   (const unsigned char*)fImage.getPixels(),
+                                                   fSize, fSize, fImage.rowBytes());
+            }
+        }
+    }
+
+private:
+    const int              fSize;
+    const bool             fBW;
+    SkString               fName;
+    SkBitmap               fImage;
+    SkAutoTMalloc<uint8_t> fBWImage;
+    SkAutoTMalloc<uint8_t> fDistanceField;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (32, false)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (64, false)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (64, true)); )
+DEF_BENCH( return SkNEW_ARGS(DistanceFieldGenBench, (256, false)); )
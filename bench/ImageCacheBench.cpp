@@ -26,6 +26,7 @@ struct TestRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(fKey) + sizeof(fValue); }
+    const char* getCategory() const override { return "bench"; }
 
     static bool Visitor(const SkResourceCache::Rec&, void*) {
         return true;
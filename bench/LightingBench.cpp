@@ -10,20 +10,48 @@
 #include "SkDevice.h"
 #include "SkLightingImageFilter.h"
 #include "SkPoint3.h"
+#include "SkString.h"
 
 #define FILTER_WIDTH_SMALL  SkIntToScalar(32)
 #define FILTER_HEIGHT_SMALL SkIntToScalar(32)
 #define FILTER_WIDTH_LARGE  SkIntToScalar(256)
 #define FILTER_HEIGHT_LARGE SkIntToScalar(256)
+// Big enough to be lit in bands on several threads.
+#define FILTER_WIDTH_HUGE   SkIntToScalar(1024)
+#define FILTER_HEIGHT_HUGE  SkIntToScalar(1024)
 
 class LightingBaseBench : public Benchmark {
 public:
-    LightingBaseBench(bool small) : fIsSmall(small) { }
+    enum Size {
+        kSmall_Size,
+        kLarge_Size,
+        kHuge_Size,
+    };
+
+    LightingBaseBench(Size size) : fSize(size) { }
 
 protected:
+    const char* name(const char* prefix) {
+        static const char* kSizeNames[] = { "small", "large", "huge" };
+        if (fName.isEmpty()) {
+            fName.printf("%s_%s", prefix, kSizeNames[fSize]);
+        }
+        return fName.c_str();
+    }
+
     void draw(const int loops, SkCanvas* canvas, SkImageFilter* imageFilter) const {
-        SkRect r = fIsSmall ? SkRect::MakeWH(FILTER_WIDTH_SMALL, FILTER_HEIGHT_SMALL) :
-                              SkRect::MakeWH(FILTER_WIDTH_LARGE, FILTER_HEIGHT_LARGE);
+        SkRect r;
+        switch (fSize) {
+            case kSmall_Size:
+                r = SkRect::MakeWH(FILTER_WIDTH_SMALL, FILTER_HEIGHT_SMALL);
+                break;
+            case kLarge_Size:
+                r = SkRect::MakeWH(FILTER_WIDTH_LARGE, FILTER_HEIGHT_LARGE);
+                break;
+            case kHuge_Size:
+                r = SkRect::MakeWH(FILTER_WIDTH_HUGE, FILTER_HEIGHT_HUGE);
+                break;
+        }
         SkPaint paint;
         paint.setImageFilter(imageFilter)->unref();
         for (int i = 0; i < loops; i++) {
@@ -94,18 +122,19 @@ protected:
         return white;
     }
 
-    bool fIsSmall;
+    Size fSize;
+    SkString fName;
     typedef Benchmark INHERITED;
 };
 
 class LightingPointLitDiffuseBench : public LightingBaseBench {
 public:
-    LightingPointLitDiffuseBench(bool small) : INHERITED(small) {
+    LightingPointLitDiffuseBench(Size size) : INHERITED(size) {
     }
 
 protected:
     const char* onGetName() override {
-        return fIsSmall ? "lightingpointlitdiffuse_small" : "lightingpointlitdiffuse_large";
+        return this->name("lightingpointlitdiffuse");
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -121,12 +150,12 @@ private:
 
 class LightingDistantLitDiffuseBench : public LightingBaseBench {
 public:
-    LightingDistantLitDiffuseBench(bool small) : INHERITED(small) {
+    LightingDistantLitDiffuseBench(Size size) : INHERITED(size) {
     }
 
 protected:
     const char* onGetName() override {
-        return fIsSmall ? "lightingdistantlitdiffuse_small" : "lightingdistantlitdiffuse_large";
+        return this->name("lightingdistantlitdiffuse");
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -142,12 +171,12 @@ private:
 
 class LightingSpotLitDiffuseBench : public LightingBaseBench {
 public:
-    LightingSpotLitDiffuseBench(bool small) : INHERITED(small) {
+    LightingSpotLitDiffuseBench(Size size) : INHERITED(size) {
     }
 
 protected:
     const char* onGetName() override {
-        return fIsSmall ? "lightingspotlitdiffuse_small" : "lightingspotlitdiffuse_large";
+        return this->name("lightingspotlitdiffuse");
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -166,12 +195,12 @@ private:
 
 class LightingPointLitSpecularBench : public LightingBaseBench {
 public:
-    LightingPointLitSpecularBench(bool small) : INHERITED(small) {
+    LightingPointLitSpecularBench(Size size) : INHERITED(size) {
     }
 
 protected:
     const char* onGetName() override {
-        return fIsSmall ? "lightingpointlitspecular_small" : "lightingpointlitspecular_large";
+        return this->name("lightingpointlitspecular");
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -188,12 +217,12 @@ private:
 
 class LightingDistantLitSpecularBench : public LightingBaseBench {
 public:
-    LightingDistantLitSpecularBench(bool small) : INHERITED(small) {
+    LightingDistantLitSpecularBench(Size size) : INHERITED(size) {
     }
 
 protected:
     const char* onGetName() override {
-        return fIsSmall ? "lightingdistantlitspecular_small" : "lightingdistantlitspecular_large";
+        return this->name("lightingdistantlitspecular");
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -210,12 +239,12 @@ private:
 
 class LightingSpotLitSpecularBench : public LightingBaseBench {
 public:
-    LightingSpotLitSpecularBench(bool small) : INHERITED(small) {
+    LightingSpotLitSpecularBench(Size size) : INHERITED(size) {
     }
 
 protected:
     const char* onGetName() override {
-        return fIsSmall ? "lightingspotlitspecular_small" : "lightingspotlitspecular_large";
+        return this->name("lightingspotlitspecular");
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -235,15 +264,21 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH( return new LightingPointLitDiffuseBench(true); )
-DEF_BENCH( return new LightingPointLitDiffuseBench(false); )
-DEF_BENCH( return new LightingDistantLitDiffuseBench(true); )
-DEF_BENCH( return new LightingDistantLitDiffuseBench(false); )
-DEF_BENCH( return new LightingSpotLitDiffuseBench(true); )
-DEF_BENCH( return new LightingSpotLitDiffuseBench(false); )
-DEF_BENCH( return new LightingPointLitSpecularBench(true); )
-DEF_BENCH( return new LightingPointLitSpecularBench(false); )
-DEF_BENCH( return new LightingDistantLitSpecularBench(true); )
-DEF_BENCH( return new LightingDistantLitSpecularBench(false); )
-DEF_BENCH( return new LightingSpotLitSpecularBench(true); )
-DEF_BENCH( return new LightingSpotLitSpecularBench(false); )
+DEF_BENCH( return new LightingPointLitDiffuseBench(LightingBaseBench::kSmall_Size); )
+DEF_BENCH( return new LightingPointLitDiffuseBench(LightingBaseBench::kLarge_Size); )
+DEF_BENCH( return new LightingPointLitDiffuseBench(LightingBaseBench::kHuge_Size); )
+DEF_BENCH( return new LightingDistantLitDiffuseBench(LightingBaseBench::kSmall_Size); )
+DEF_BENCH( return new LightingDistantLitDiffuseBench(LightingBaseBench::kLarge_Size); )
+DEF_BENCH( return new LightingDistantLitDiffuseBench(LightingBaseBench::kHuge_Size); )
+DEF_BENCH( return new LightingSpotLitDiffuseBench(LightingBaseBench::kSmall_Size); )
+DEF_BENCH( return new LightingSpotLitDiffuseBench(LightingBaseBench::kLarge_Size); )
+DEF_BENCH( return new LightingSpotLitDiffuseBench(LightingBaseBench::kHuge_Size); )
+DEF_BENCH( return new LightingPointLitSpecularBench(LightingBaseBench::kSmall_Size); )
+DEF_BENCH( return new LightingPointLitSpecularBench(LightingBaseBench::kLarge_Size); )
+DEF_BENCH( return new LightingPointLitSpecularBench(LightingBaseBench::kHuge_Size); )
+DEF_BENCH( return new LightingDistantLitSpecularBench(LightingBaseBench::kSmall_Size); )
+DEF_BENCH( return new LightingDistantLitSpecularBench(LightingBaseBench::kLarge_Size); )
+DEF_BENCH( return new LightingDistantLitSpecularBench(LightingBaseBench::kHuge_Size); )
+DEF_BENCH( return new LightingSpotLitSpecularBench(LightingBaseBench::kSmall_Size); )
+DEF_BENCH( return new LightingSpotLitSpecularBench(LightingBaseBench::kLarge_Size); )
+DEF_BENCH( return new LightingSpotLitSpecularBench(LightingBaseBench::kHuge_Size); )
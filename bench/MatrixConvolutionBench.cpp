@@ -13,8 +13,14 @@
 
 class MatrixConvolutionBench : public Benchmark {
 public:
-    MatrixConvolutionBench(SkMatrixConvolutionImageFilter::TileMode tileMode, bool convolveAlpha)
-        : fName("matrixconvolution") {
+    // A non-zero size draws one size x size rect instead of random ovals.
+    MatrixConvolutionBench(SkMatrixConvolutionImageFilter::TileMode tileMode, bool convolveAlpha,
+                           int size = 0)
+        : fName("matrixconvolution")
+        , fSize(size) {
+        if (size) {
+            fName.appendf("_%d%s", size, convolveAlpha ? "" : "_noalpha");
+        }
         SkISize kernelSize = SkISize::Make(3, 3);
         SkScalar kernel[9] = {
             SkIntToScalar( 1), SkIntToScalar( 1), SkIntToScalar( 1),
@@ -41,8 +47,9 @@ protected:
         paint.setAntiAlias(true);
         SkRandom rand;
         for (int i = 0; i < loops; i++) {
-            SkRect r = SkRect::MakeWH(rand.nextUScalar1() * 400,
-                                      rand.nextUScalar1() * 400);
+            SkRect r = fSize ? SkRect::MakeWH(SkIntToScalar(fSize), SkIntToScalar(fSize))
+                             : SkRect::MakeWH(rand.nextUScalar1() * 400,
+                                              rand.nextUScalar1() * 400);
             paint.setImageFilter(fFilter);
             canvas->drawOval(r, paint);
         }
@@ -52,9 +59,12 @@ private:
     typedef Benchmark INHERITED;
     SkMatrixConvolutionImageFilter* fFilter;
     SkString fName;
+    int fSize;
 };
 
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClamp_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kRepeat_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, true); )
 DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClampToBlack_TileMode, false); )
+DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClamp_TileMode, true, 1024); )
+DEF_BENCH( return new MatrixConvolutionBench(SkMatrixConvolutionImageFilter::kClamp_TileMode, false, 1024); )
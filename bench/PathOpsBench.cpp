@@ -0,0 +1,128 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkPath.h"
+#include "SkPathOps.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkTArray.h"
+
+// Unions two overlapping polygons with many vertices, like outlines of map regions, where most
+// pairs of edges are too far apart to meet.
+class PathOpsPolygonBench : public Benchmark {
+public:
+    PathOpsPolygonBench(int vertices) : fVertices(vertices) {
+        fName.printf("pathops_union_polygon_%d", vertices);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        make_polygon(&fOne, fVertices, 200, 200, &rand);
+        make_polygon(&fTwo, fVertices, 260, 230, &rand);
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkPath result;
+            Op(fOne, fTwo, kUnion_SkPathOp, &result);
+        }
+    }
+
+private:
+    // A jagged circle, so its edges are short and its neighbors cross the other's edges here
+    // and there.
+    static void make_polygon(SkPath* path, int vertices, SkScalar cx, SkScalar cy,
+                             SkRandom* rand) {
+        for (int i = 0; i < vertices; ++i) {
+            SkScalar angle = 2 * SK_ScalarPI * i / vertices;
+            SkScalar radius = 100 + rand->nextRangeF(-2, 2);
+            SkPoint pt = SkPoint::Make(cx + radius * SkScalarCos(angle),
+                                       cy + radius * SkScalarSin(angle));
+            if (i) {
+                path->lineTo(pt);
+            } else {
+                path->moveTo(pt);
+            }
+        }
+        path->close();
+    }
+
+    const int fVertices;
+    SkString  fName;
+    SkPath    fOne;
+    SkPath    fTwo;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PathOpsPolygonBench, (1000)); )
+DEF_BENCH( return SkNEW_ARGS(PathOpsPolygonBench, (10000)); )
+
+// Unions many small L-shaped paths, like building footprints on a map, with one builder.
+class PathOpsBuilderUnionBench : public Benchmark {
+public:
+    PathOpsBuilderUnionBench(int count) : fCount(count) {
+        fName.printf("pathops_builder_union_%d", count);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onPreDraw() override {
+        SkRandom rand;
+        for (int i = 0; i < fCount; ++i) {
+            SkScalar x = rand.nextRangeF(0, 2000);
+            SkScalar y = rand.nextRangeF(0, 2000);
+            SkScalar size = rand.nextRangeF(5, 60);
+            SkPath& path = fPaths.push_back();
+            path.moveTo(x, y);
+            path.lineTo(x + size, y);
+            path.lineTo(x + size, y + size / 2);
+            path.lineTo(x + size / 2, y + size / 2);
+            path.lineTo(x + size / 2, y + size);
+            path.lineTo(x, y + size);
+            path.close();
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            SkOpBuilder builder;
+            for (int j = 0; j < fPaths.count(); ++j) {
+                builder.add(fPaths[j], kUnion_SkPathOp);
+            }
+            SkPath result;
+            builder.resolve(&result);
+        }
+    }
+
+private:
+    const int        fCount;
+    SkString         fName;
+    SkTArray<SkPath> fPaths;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(PathOpsBuilderUnionBench, (100)); )
+DEF_BENCH( return SkNEW_ARGS(PathOpsBuilderUnionBench, (1000)); )
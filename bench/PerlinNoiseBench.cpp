@@ -10,18 +10,24 @@
 
 class PerlinNoiseBench : public Benchmark {
     SkISize fSize;
+    bool    fSubpixel;
 
 public:
-    PerlinNoiseBench()  {
+    // Noise drawn at a subpixel offset can't come from the cache of rendered noise blocks, so
+    // that variant measures evaluating the noise itself.
+    PerlinNoiseBench(bool subpixel = false) : fSubpixel(subpixel) {
         fSize = SkISize::Make(80, 80);
     }
 
 protected:
     const char* onGetName() override {
-        return "perlinnoise";
+        return fSubpixel ? "perlinnoise_subpixel" : "perlinnoise";
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
+        if (fSubpixel) {
+            canvas->translate(0.5f, 0.5f);
+        }
         this->test(loops, canvas, 0, 0, SkPerlinNoiseShader::kFractalNoise_Type,
                    0.1f, 0.1f, 3, 0, false);
     }
@@ -60,3 +66,4 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new PerlinNoiseBench(); )
+DEF_BENCH( return new PerlinNoiseBench(true); )
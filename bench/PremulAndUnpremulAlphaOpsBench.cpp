@@ -19,9 +19,13 @@ class PremulAndUnpremulAlphaOpsBench : public Benchmark {
     SkBitmap fBmp1, fBmp2;
 
 public:
-    PremulAndUnpremulAlphaOpsBench(SkColorType ct) {
+    // With kPremul_SkAlphaType the pixels are only swizzled (or copied) on the way in and out.
+    PremulAndUnpremulAlphaOpsBench(SkColorType ct, SkAlphaType at = kUnpremul_SkAlphaType) {
         fColorType = ct;
-        fName.printf("premul_and_unpremul_alpha_%s", sk_tool_utils::colortype_name(ct));
+        fAlphaType = at;
+        fName.printf("%s_%s", kPremul_SkAlphaType == at ? "swizzle_pixels"
+                                                        : "premul_and_unpremul_alpha",
+                     sk_tool_utils::colortype_name(ct));
     }
 
 protected:
@@ -30,13 +34,17 @@ protected:
     }
 
     void onPreDraw() override {
-        SkImageInfo info = SkImageInfo::Make(W, H, fColorType, kUnpremul_SkAlphaType);
+        SkImageInfo info = SkImageInfo::Make(W, H, fColorType, fAlphaType);
         fBmp1.allocPixels(info);   // used in writePixels
 
         for (int h = 0; h < H; ++h) {
             for (int w = 0; w < W; ++w) {
                 // SkColor places A in the right slot for either RGBA or BGRA
-                *fBmp1.getAddr32(w, h) = SkColorSetARGB(h & 0xFF, w & 0xFF, w & 0xFF, w & 0xFF);
+                U8CPU a = h & 0xFF, c = w & 0xFF;
+                if (kPremul_SkAlphaType == fAlphaType) {
+                    c = SkMulDiv255Round(c, a);
+                }
+                *fBmp1.getAddr32(w, h) = SkColorSetARGB(a, c, c, c);
             }
         }
 
@@ -56,6 +64,7 @@ protected:
 
 private:
     SkColorType fColorType;
+    SkAlphaType fAlphaType;
     SkString fName;
 
     typedef Benchmark INHERITED;
@@ -64,3 +73,5 @@ private:
 
 DEF_BENCH(return new PremulAndUnpremulAlphaOpsBench(kRGBA_8888_SkColorType));
 DEF_BENCH(return new PremulAndUnpremulAlphaOpsBench(kBGRA_8888_SkColorType));
+DEF_BENCH(return new PremulAndUnpremulAlphaOpsBench(kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+DEF_BENCH(return new PremulAndUnpremulAlphaOpsBench(kBGRA_8888_SkColorType, kPremul_SkAlphaType));
@@ -16,14 +16,19 @@ static const SkScalar GENERATE_EXTENTS = 1000.0f;
 static const int NUM_BUILD_RECTS = 500;
 static const int NUM_QUERY_RECTS = 5000;
 static const int GRID_WIDTH = 100;
+// Roughly the op count of a large SKP.
+static const int NUM_LARGE_RECTS = 100000;
 
 typedef SkRect (*MakeRectProc)(SkRandom&, int, int);
 
 // Time how long it takes to build an R-Tree.
 class RTreeBuildBench : public Benchmark {
 public:
-    RTreeBuildBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_build", name);
+    RTreeBuildBench(const char* name, MakeRectProc proc, int numRects = NUM_BUILD_RECTS,
+                    SkRTreeFactory::BulkLoad bulkLoad = SkRTreeFactory::kSTR_BulkLoad)
+        : fProc(proc), fNumRects(numRects), fBulkLoad(bulkLoad) {
+        fName.printf("rtree_%s%s_build",
+                     SkRTreeFactory::kHilbert_BulkLoad == bulkLoad ? "hilbert_" : "", name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -36,19 +41,21 @@ protected:
     }
     void onDraw(const int loops, SkCanvas* canvas) override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_BUILD_RECTS);
-        for (int i = 0; i < NUM_BUILD_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_BUILD_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
 
         for (int i = 0; i < loops; ++i) {
-            SkRTree tree;
-            tree.insert(rects.get(), NUM_BUILD_RECTS);
+            SkRTree tree(1, fBulkLoad);
+            tree.insert(rects.get(), fNumRects);
             SkASSERT(rects != NULL);  // It'd break this bench if the tree took ownership of rects.
         }
     }
 private:
     MakeRectProc fProc;
+    int fNumRects;
+    SkRTreeFactory::BulkLoad fBulkLoad;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -56,8 +63,11 @@ private:
 // Time how long it takes to perform queries on an R-Tree.
 class RTreeQueryBench : public Benchmark {
 public:
-    RTreeQueryBench(const char* name, MakeRectProc proc) : fProc(proc) {
-        fName.printf("rtree_%s_query", name);
+    RTreeQueryBench(const char* name, MakeRectProc proc, int numRects = NUM_QUERY_RECTS,
+                    SkRTreeFactory::BulkLoad bulkLoad = SkRTreeFactory::kSTR_BulkLoad)
+        : fTree(1, bulkLoad), fProc(proc), fNumRects(numRects) {
+        fName.printf("rtree_%s%s_query",
+                     SkRTreeFactory::kHilbert_BulkLoad == bulkLoad ? "hilbert_" : "", name);
     }
 
     bool isSuitableFor(Backend backend) override {
@@ -69,11 +79,11 @@ protected:
     }
     void onPreDraw() override {
         SkRandom rand;
-        SkAutoTMalloc<SkRect> rects(NUM_QUERY_RECTS);
-        for (int i = 0; i < NUM_QUERY_RECTS; ++i) {
-            rects[i] = fProc(rand, i, NUM_QUERY_RECTS);
+        SkAutoTMalloc<SkRect> rects(fNumRects);
+        for (int i = 0; i < fNumRects; ++i) {
+            rects[i] = fProc(rand, i, fNumRects);
         }
-        fTree.insert(rects.get(), NUM_QUERY_RECTS);
+        fTree.insert(rects.get(), fNumRects);
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -91,6 +101,7 @@ protected:
 private:
     SkRTree fTree;
     MakeRectProc fProc;
+    int fNumRects;
     SkString fName;
     typedef Benchmark INHERITED;
 };
@@ -136,3 +147,21 @@ DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("XY",         &make_XYordered_rect
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("YX",         &make_YXordered_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("random",     &make_random_rects)));
 DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, ("concentric", &make_concentric_rects)));
+
+// Compare the Hilbert bulk load to the default, at the usual size and at the size of a big SKP.
+#define BULK_LOAD_BENCHES(name, proc)                                                         \
+    DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, (name, proc, NUM_BUILD_RECTS,              \
+                                                  SkRTreeFactory::kHilbert_BulkLoad)));     \
+    DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, (name, proc, NUM_QUERY_RECTS,              \
+                                                  SkRTreeFactory::kHilbert_BulkLoad)));     \
+    DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, (name "_large", proc, NUM_LARGE_RECTS)));  \
+    DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, (name "_large", proc, NUM_LARGE_RECTS)));  \
+    DEF_BENCH(return SkNEW_ARGS(RTreeBuildBench, (name "_large", proc, NUM_LARGE_RECTS,     \
+                                                  SkRTreeFactory::kHilbert_BulkLoad)));     \
+    DEF_BENCH(return SkNEW_ARGS(RTreeQueryBench, (name "_large", proc, NUM_LARGE_RECTS,     \
+                                                  SkRTreeFactory::kHilbert_BulkLoad)));
+
+BULK_LOAD_BENCHES("XY",         &make_XYordered_rects)
+BULK_LOAD_BENCHES("YX",         &make_YXordered_rects)
+BULK_LOAD_BENCHES("random",     &make_random_rects)
+BULK_LOAD_BENCHES("concentric", &make_concentric_rects)
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkReadBuffer.h"
+#include "SkValidatingReadBuffer.h"
+#include "SkWriteBuffer.h"
+
+// Reads back a buffer shaped like flattened picture data: runs of small scalar fields (as in
+// paints and effects) between bulk point and glyph arrays, through either the trusting
+// SkReadBuffer or the SkValidatingReadBuffer used for untrusted data.
+class ReadBufferBench : public Benchmark {
+public:
+    ReadBufferBench(bool validating) : fValidating(validating) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    enum {
+        kRecords    = 256,
+        kFields     = 8,
+        kPoints     = 64,
+        kGlyphBytes = 128,
+    };
+
+    const char* onGetName() override {
+        return fValidating ? "readbuffer_validating" : "readbuffer_raw";
+    }
+
+    void onPreDraw() override {
+        SkPoint points[kPoints];
+        uint8_t glyphs[kGlyphBytes];
+        for (int i = 0; i < kPoints; ++i) {
+            points[i].set(SkIntToScalar(i), SkIntToScalar(-i));
+        }
+        for (int i = 0; i < kGlyphBytes; ++i) {
+            glyphs[i] = SkToU8(i);
+        }
+
+        SkWriteBuffer writer;
+        for (int r = 0; r < kRecords; ++r) {
+            for (int f = 0; f < kFields; ++f) {
+                writer.writeInt(f);
+                writer.writeScalar(SK_ScalarHalf);
+            }
+            writer.writePoint(points[r % kPoints]);
+            writer.writePointArray(points, kPoints);
+            writer.writeByteArray(glyphs, kGlyphBytes);
+        }
+        fSize = writer.bytesWritten();
+        fData.reset(fSize);
+        writer.writeToMemory(fData.get());
+    }
+
+    void onDraw(const int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; ++i) {
+            if (fValidating) {
+                SkValidatingReadBuffer reader(fData.get(), fSize);
+                this->read(&reader);
+            } else {
+                SkReadBuffer reader(fData.get(), fSize);
+                this->read(&reader);
+            }
+        }
+    }
+
+private:
+    void read(SkReadBuffer* reader) {
+        SkPoint points[kPoints];
+        uint8_t glyphs[kGlyphBytes];
+        int32_t sum = 0;
+        for (int r = 0; r < kRecords; ++r) {
+            for (int f = 0; f < kFields; ++f) {
+                sum += reader->readInt();
+                sum += SkScalarTruncToInt(reader->readScalar());
+            }
+            reader->readPoint(&points[0]);
+            reader->readPointArray(points, kPoints);
+            reader->readByteArray(glyphs, kGlyphBytes);
+        }
+        SkASSERT(reader->isValid());
+        fSink = sum;
+    }
+
+    bool                    fValidating;
+    SkAutoTMalloc<uint8_t>  fData;
+    size_t                  fSize;
+    int32_t                 fSink;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ReadBufferBench(false); )
+DEF_BENCH( return new ReadBufferBench(true); )
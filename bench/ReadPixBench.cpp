@@ -8,6 +8,8 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkString.h"
+#include "sk_tool_utils.h"
 
 
 /**
@@ -17,11 +19,22 @@
  */
 class ReadPixBench : public Benchmark {
 public:
-    ReadPixBench() {}
+    ReadPixBench() : fColorType(kN32_SkColorType), fAlphaType(kPremul_SkAlphaType)
+                   , fWindowSize(5), fName("readpix") {}
+
+    /**
+     *  Reads larger windows into the given format, so that the time goes into converting
+     *  the pixels rather than into the calls themselves.
+     */
+    ReadPixBench(SkColorType ct, SkAlphaType at)
+        : fColorType(ct), fAlphaType(at), fWindowSize(64) {
+        fName.printf("readpix_%s_%s", sk_tool_utils::colortype_name(ct),
+                     kPremul_SkAlphaType == at ? "premul" : "unpremul");
+    }
 
 protected:
     const char* onGetName() override {
-        return "readpix";
+        return fName.c_str();
     }
 
     void onDraw(const int loops, SkCanvas* canvas) override {
@@ -29,8 +42,8 @@ protected:
 
         SkISize size = canvas->getDeviceSize();
 
-        int offX = (size.width() - kWindowSize) / kNumStepsX;
-        int offY = (size.height() - kWindowSize) / kNumStepsY;
+        int offX = SkTMax(size.width() - fWindowSize, 0) / kNumStepsX;
+        int offY = SkTMax(size.height() - fWindowSize, 0) / kNumStepsY;
 
         SkPaint paint;
 
@@ -43,7 +56,7 @@ protected:
 
         SkBitmap bitmap;
 
-        bitmap.setInfo(SkImageInfo::MakeN32Premul(kWindowSize, kWindowSize));
+        bitmap.setInfo(SkImageInfo::Make(fWindowSize, fWindowSize, fColorType, fAlphaType));
 
         for (int i = 0; i < loops; i++) {
             for (int x = 0; x < kNumStepsX; ++x) {
@@ -57,7 +70,11 @@ protected:
 private:
     static const int kNumStepsX = 30;
     static const int kNumStepsY = 30;
-    static const int kWindowSize = 5;
+
+    SkColorType fColorType;
+    SkAlphaType fAlphaType;
+    int         fWindowSize;
+    SkString    fName;
 
     typedef Benchmark INHERITED;
 };
@@ -65,3 +82,7 @@ private:
 ////////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ReadPixBench(); )
+DEF_BENCH( return new ReadPixBench(kRGBA_8888_SkColorType, kPremul_SkAlphaType); )
+DEF_BENCH( return new ReadPixBench(kBGRA_8888_SkColorType, kPremul_SkAlphaType); )
+DEF_BENCH( return new ReadPixBench(kRGBA_8888_SkColorType, kUnpremul_SkAlphaType); )
+DEF_BENCH( return new ReadPixBench(kBGRA_8888_SkColorType, kUnpremul_SkAlphaType); )
@@ -12,6 +12,7 @@
 
 #if SK_SUPPORT_GPU
 
+#include "GrRectanizer_maxrects.h"
 #include "GrRectanizer_pow2.h"
 #include "GrRectanizer_skyline.h"
 
@@ -20,6 +21,7 @@
  * rectanizers:
  *      Pow2 Rectanizer
  *      Skyline Rectanizer
+ *      MaxRects Rectanizer
  * in the following cases:
  *      random rects (e.g., pull-save-layers forward use case)
  *      random power of two rects
@@ -33,6 +35,7 @@ public:
     enum RectanizerType {
         kPow2_RectanizerType,
         kSkyline_RectanizerType,
+        kMaxRects_RectanizerType,
     };
 
     enum RectType {
@@ -48,9 +51,11 @@ public:
 
         if (kPow2_RectanizerType == fRectanizerType) {
             fName.append("pow2_");
-        } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
+        } else if (kSkyline_RectanizerType == fRectanizerType) {
             fName.append("skyline_");
+        } else {
+            SkASSERT(kMaxRects_RectanizerType == fRectanizerType);
+            fName.append("maxrects_");
         }
 
         if (kRand_RectType == fRectType) {
@@ -77,9 +82,11 @@ protected:
 
         if (kPow2_RectanizerType == fRectanizerType) {
             fRectanizer.reset(SkNEW_ARGS(GrRectanizerPow2, (kWidth, kHeight)));
-        } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
+        } else if (kSkyline_RectanizerType == fRectanizerType) {
             fRectanizer.reset(SkNEW_ARGS(GrRectanizerSkyline, (kWidth, kHeight)));
+        } else {
+            SkASSERT(kMaxRects_RectanizerType == fRectanizerType);
+            fRectanizer.reset(SkNEW_ARGS(GrRectanizerMaxRects, (kWidth, kHeight)));
         }
     }
 
@@ -134,5 +141,11 @@ DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kRandPow2_RectType);)
 DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kSmallPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kMaxRects_RectanizerType,
+                                     RectanizerBench::kRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kMaxRects_RectanizerType,
+                                     RectanizerBench::kRandPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kMaxRects_RectanizerType,
+                                     RectanizerBench::kSmallPow2_RectType);)
 
 #endif
@@ -9,6 +9,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -117,6 +118,52 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Unions many small rects, like the damage of a frame, one at a time or all at once.
+class RegionUnionRectsBench : public Benchmark {
+public:
+    enum {
+        W = 1024,
+        H = 768,
+    };
+
+    RegionUnionRectsBench(int count, bool many) : fMany(many) {
+        fName.printf("region_unionrects_%s_%d", many ? "many" : "loop", count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            *fRects.append() = SkIRect::MakeXYWH(rand.nextU() % W, rand.nextU() % H,
+                                                 1 + rand.nextU() % 32, 1 + rand.nextU() % 32);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            if (fMany) {
+                rgn.opMany(fRects.begin(), fRects.count(), SkRegion::kUnion_Op);
+            } else {
+                for (int j = 0; j < fRects.count(); ++j) {
+                    rgn.op(fRects[j], SkRegion::kUnion_Op);
+                }
+            }
+        }
+    }
+
+private:
+    SkTDArray<SkIRect> fRects;
+    bool               fMany;
+    SkString           fName;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define SMALL   16
@@ -130,3 +177,6 @@ DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, containsrect_proc, "containsre
 DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, sectsrgn_proc, "intersectsrgn")); )
 DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, sectsrect_proc, "intersectsrect")); )
 DEF_BENCH( return SkNEW_ARGS(RegionBench, (SMALL, containsxy_proc, "containsxy")); )
+
+DEF_BENCH( return SkNEW_ARGS(RegionUnionRectsBench, (1000, false)); )
+DEF_BENCH( return SkNEW_ARGS(RegionUnionRectsBench, (1000, true)); )
@@ -73,3 +73,30 @@ SKPAnimationBench::Animation* SKPAnimationBench::CreateZoomAnimation(SkScalar zo
                                                                      double zoomPeriodMs) {
     return SkNEW_ARGS(ZoomAnimation, (zoomMax, zoomPeriodMs));
 }
+
+class ScrollAnimation : public SKPAnimationBench::Animation {
+public:
+    ScrollAnimation(SkScalar contentHeight, double scrollPeriodMs)
+        : fContentHeight(contentHeight)
+        , fScrollPeriodMs(scrollPeriodMs) {
+    }
+
+    virtual const char* getTag() { return "scroll"; }
+
+    virtual void preConcatFrameMatrix(double animationTimeMs, const SkIRect& devBounds,
+                                      SkMatrix* drawMatrix) {
+        double t = fmod(animationTimeMs / fScrollPeriodMs, 1.0); // t is in [0, 1).
+        t = 1 - fabs(2 * t - 1); // Make t ping-pong between 0 and 1, starting at the top.
+        SkScalar distance = SkTMax(0.0f, fContentHeight - devBounds.height());
+        drawMatrix->preTranslate(0, -static_cast<SkScalar>(t * distance));
+    }
+
+private:
+    SkScalar fContentHeight;
+    double   fScrollPeriodMs;
+};
+
+SKPAnimationBench::Animation* SKPAnimationBench::CreateScrollAnimation(SkScalar contentHeight,
+                                                                       double scrollPeriodMs) {
+    return SkNEW_ARGS(ScrollAnimation, (contentHeight, scrollPeriodMs));
+}
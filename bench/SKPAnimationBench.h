@@ -29,6 +29,9 @@ public:
                       bool doLooping);
 
     static Animation* CreateZoomAnimation(SkScalar zoomMax, double zoomPeriodMs);
+    // Scrolls down through contentHeight pixels of content and back up again, every
+    // scrollPeriodMs.
+    static Animation* CreateScrollAnimation(SkScalar contentHeight, double scrollPeriodMs);
 
 protected:
     const char* onGetUniqueName() override;
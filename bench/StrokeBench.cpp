@@ -94,6 +94,19 @@ static SkPath cubic_path_maker() {
     return path;
 }
 
+// Many long polylines, like a chart's series, which are stroked once and then found in the cache.
+static SkPath chart_path_maker() {
+    SkPath path;
+    SkRandom rand;
+    for (int series = 0; series < 32; ++series) {
+        path.moveTo(-X, rand.nextSScalar1() * Y);
+        for (int i = 1; i <= 10 * N; ++i) {
+            path.lineTo(-X + i * (2 * X / (10 * N)), rand.nextSScalar1() * Y);
+        }
+    }
+    return path;
+}
+
 static SkPaint paint_maker() {
     SkPaint paint;
     paint.setStyle(SkPaint::kStroke_Style);
@@ -117,3 +130,5 @@ DEF_BENCH( return SkNEW_ARGS(StrokeBench, (line_path_maker(), paint_maker(), "li
 DEF_BENCH( return SkNEW_ARGS(StrokeBench, (quad_path_maker(), paint_maker(), "quad_.25", .25f)); )
 DEF_BENCH( return SkNEW_ARGS(StrokeBench, (conic_path_maker(), paint_maker(), "conic_.25", .25f)); )
 DEF_BENCH( return SkNEW_ARGS(StrokeBench, (cubic_path_maker(), paint_maker(), "cubic_.25", .25f)); )
+
+DEF_BENCH( return SkNEW_ARGS(StrokeBench, (chart_path_maker(), paint_maker(), "chart_1", 1)); )
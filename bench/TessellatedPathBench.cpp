@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkString.h"
+
+// Redraws one complex concave, non-AA path under changing translations, as a map tile does
+// while panning. Non-AA concave fills go to GrTessellatingPathRenderer, which caches the
+// triangulation unless the path is volatile. Comparing the two variants shows the steady-state
+// cost of re-tessellating.
+class TessellatedPathBench : public Benchmark {
+public:
+    TessellatedPathBench(bool isVolatile) : fIsVolatile(isVolatile) {
+        fName.printf("tessellated_path_%s", isVolatile ? "volatile" : "cached");
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return kGPU_Backend == backend;
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(640, 480);
+    }
+
+    void onPreDraw() override {
+        // A spiky star with curved edges; plenty of work for the tessellator.
+        static const int kPoints = 200;
+        const SkScalar cx = 160, cy = 160;
+        fPath.reset();
+        for (int i = 0; i < kPoints; ++i) {
+            SkScalar angle = 2 * SK_ScalarPI * i / kPoints;
+            SkScalar r = (i & 1) ? 150 : 60;
+            SkPoint pt = SkPoint::Make(cx + r * SkScalarCos(angle), cy + r * SkScalarSin(angle));
+            if (0 == i) {
+                fPath.moveTo(pt);
+            } else if (i % 3) {
+                fPath.lineTo(pt);
+            } else {
+                fPath.quadTo(cx, cy, pt.fX, pt.fY);
+            }
+        }
+        fPath.close();
+        fPath.setIsVolatile(fIsVolatile);
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setAntiAlias(false);
+        paint.setColor(0xFF3060A0);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->save();
+            canvas->translate(SkIntToScalar(i % 300), SkIntToScalar((i / 7) % 150));
+            canvas->drawPath(fPath, paint);
+            canvas->restore();
+        }
+    }
+
+private:
+    SkPath   fPath;
+    SkString fName;
+    bool     fIsVolatile;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(TessellatedPathBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(TessellatedPathBench, (true)); )
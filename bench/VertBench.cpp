@@ -6,17 +6,30 @@
  */
 
 #include "Benchmark.h"
+#include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkImage.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
+#include "SkRSXform.h"
 #include "SkShader.h"
 #include "SkString.h"
 
 enum VertFlags {
-    kColors_VertFlag,
-    kTexture_VertFlag,
+    kColors_VertFlag    = 1 << 0,
+    kTexture_VertFlag   = 1 << 1,
 };
 
+// A small checkerboard, shared by the textured vertex and atlas benches.
+static void make_checker(SkBitmap* bm, int size, int cell) {
+    bm->allocN32Pixels(size, size);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            *bm->getAddr32(x, y) = ((x / cell + y / cell) & 1) ? 0xFF4080C0 : 0xFFFFFFFF;
+        }
+    }
+}
+
 class VertBench : public Benchmark {
     SkString fName;
     enum {
@@ -29,8 +42,11 @@ class VertBench : public Benchmark {
     };
 
     SkPoint fPts[PTS];
+    SkPoint fTexs[PTS];
     SkColor fColors[PTS];
     uint16_t fIdx[IDX];
+    SkAutoTUnref<SkShader> fShader;
+    uint32_t fFlags;
 
     static void load_2_tris(uint16_t idx[], int x, int y, int rb) {
         int n = y * rb + x;
@@ -39,7 +55,7 @@ class VertBench : public Benchmark {
     }
 
 public:
-    VertBench() {
+    VertBench(uint32_t flags) : fFlags(flags) {
         const SkScalar dx = SkIntToScalar(W) / COL;
         const SkScalar dy = SkIntToScalar(H) / COL;
 
@@ -72,7 +88,20 @@ public:
             fColors[i] = rand.nextU() | (0xFF << 24);
         }
 
+        // The texture is laid out exactly like the mesh, so neighbouring triangles share a
+        // texture matrix.
+        for (int i = 0; i < PTS; ++i) {
+            fTexs[i].set(fPts[i].fX / 10, fPts[i].fY / 10);
+        }
+        SkBitmap bm;
+        make_checker(&bm, 64, 8);
+        fShader.reset(SkShader::CreateBitmapShader(bm, SkShader::kRepeat_TileMode,
+                                                   SkShader::kRepeat_TileMode));
+
         fName.set("verts");
+        if (fFlags & kTexture_VertFlag) {
+            fName.append(fFlags & kColors_VertFlag ? "_colors_texture" : "_texture");
+        }
     }
 
 protected:
@@ -80,10 +109,16 @@ protected:
     virtual void onDraw(const int loops, SkCanvas* canvas) {
         SkPaint paint;
         this->setupPaint(&paint);
+        const SkPoint* texs = NULL;
+        if (fFlags & kTexture_VertFlag) {
+            paint.setShader(fShader);
+            texs = fTexs;
+        }
+        const SkColor* colors = (fFlags & kColors_VertFlag) ? fColors : NULL;
 
         for (int i = 0; i < loops; i++) {
             canvas->drawVertices(SkCanvas::kTriangles_VertexMode, PTS,
-                                 fPts, NULL, fColors, NULL, fIdx, IDX, paint);
+                                 fPts, texs, colors, NULL, fIdx, IDX, paint);
         }
     }
 private:
@@ -92,4 +127,69 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-DEF_BENCH( return SkNEW_ARGS(VertBench, ()); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kColors_VertFlag)); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kTexture_VertFlag)); )
+DEF_BENCH( return SkNEW_ARGS(VertBench, (kColors_VertFlag | kTexture_VertFlag)); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Sprites from a sprite sheet, either axis-aligned or rotated, as particle systems draw them.
+class AtlasBench : public Benchmark {
+    enum {
+        kCount      = 500,
+        kCellSize   = 32,
+        kCells      = 4,
+    };
+
+    SkString                fName;
+    SkAutoTUnref<SkImage>   fAtlas;
+    SkRSXform               fXform[kCount];
+    SkRect                  fTex[kCount];
+    bool                    fRotate;
+
+public:
+    AtlasBench(bool rotate) : fRotate(rotate) {
+        fName.printf("atlas_%s", rotate ? "rotated" : "aligned");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPreDraw() override {
+        SkBitmap bm;
+        make_checker(&bm, kCellSize * kCells, kCellSize / 4);
+        fAtlas.reset(SkImage::NewRasterCopy(bm.info(), bm.getPixels(), bm.rowBytes()));
+
+        SkRandom rand;
+        for (int i = 0; i < kCount; ++i) {
+            const SkScalar x = rand.nextRangeScalar(0, 600);
+            const SkScalar y = rand.nextRangeScalar(0, 440);
+            if (fRotate) {
+                fXform[i] = SkRSXform::MakeFromRadians(1, rand.nextRangeScalar(0, SK_ScalarPI),
+                                                       x, y, kCellSize / 2, kCellSize / 2);
+            } else {
+                fXform[i].set(1, 0, x, y);
+            }
+            const int cell = rand.nextULessThan(kCells * kCells);
+            fTex[i].setXYWH(SkIntToScalar(cell % kCells * kCellSize),
+                            SkIntToScalar(cell / kCells * kCellSize),
+                            SkIntToScalar(kCellSize), SkIntToScalar(kCellSize));
+        }
+    }
+
+    void onDraw(const int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setFilterQuality(kLow_SkFilterQuality);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawAtlas(fAtlas, fXform, fTex, kCount, NULL, &paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return SkNEW_ARGS(AtlasBench, (false)); )
+DEF_BENCH( return SkNEW_ARGS(AtlasBench, (true)); )
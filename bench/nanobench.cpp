@@ -11,9 +11,11 @@
 
 #include "Benchmark.h"
 #include "CodecBench.h"
+#include "CodecModeBench.h"
 #include "CrashHandler.h"
 #include "DecodingBench.h"
 #include "GMBench.h"
+#include "PerfCounters.h"
 #include "ProcStats.h"
 #include "ResultsWriter.h"
 #include "RecordingBench.h"
@@ -26,6 +28,7 @@
 #include "Stats.h"
 #include "Timer.h"
 
+#include "SkAllocationCounter.h"
 #include "SkBBoxHierarchy.h"
 #include "SkCanvas.h"
 #include "SkCodec.h"
@@ -36,10 +39,12 @@
 #include "SkOSFile.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureUtils.h"
+#include "SkScan.h"
 #include "SkScanlineDecoder.h"
 #include "SkString.h"
 #include "SkSurface.h"
 #include "SkTaskGroup.h"
+#include "SkThreadUtils.h"
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
     #include "nanobenchAndroid.h"
@@ -108,6 +113,10 @@ DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
 DEFINE_int32(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 DEFINE_bool(resetGpuContext, true, "Reset the GrContext before running each test.");
 DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
+DEFINE_bool(analyticAA, false, "Fill AA paths with analytic coverage instead of supersampling?");
+DEFINE_int32(throughput, 0, "If > 0, also run up to this many copies of each CPU bench at once, "
+                            "each on its own thread and canvas, and report their total ops/sec.");
+DEFINE_double(throughputMs, 500, "How long to run each thread count for --throughput.");
 
 static SkString humanize(double ms) {
     if (FLAGS_verbose) return SkStringPrintf("%llu", (uint64_t)(ms*1e6));
@@ -198,11 +207,18 @@ struct GPUTarget : public Target {
 
 #endif
 
-static double time(int loops, Benchmark* bench, Target* target) {
+// If counters is not NULL, it counts the same work we time.  So does allocs, if not NULL, with
+// allocations made on this thread (see SkAllocationCounter.h).
+static double time(int loops, Benchmark* bench, Target* target, PerfCounters* counters = NULL,
+                   SkAllocationCounts* allocs = NULL) {
     SkCanvas* canvas = target->getCanvas();
     if (canvas) {
         canvas->clear(SK_ColorWHITE);
     }
+    const SkAllocationCounts allocsBefore = SkGetThreadAllocationCounts();
+    if (counters) {
+        counters->start();
+    }
     WallTimer timer;
     timer.start();
     canvas = target->beginTiming(canvas);
@@ -212,9 +228,26 @@ static double time(int loops, Benchmark* bench, Target* target) {
     }
     target->endTiming();
     timer.end();
+    if (counters) {
+        counters->end();
+    }
+    if (allocs) {
+        *allocs = SkGetThreadAllocationCounts() - allocsBefore;
+    }
     return timer.fWall;
 }
 
+// Appends each counter's count from the last time() call, per loop, to its counterSamples.
+static void add_counter_samples(const PerfCounters* counters, int loops,
+                                SkTArray<double> counterSamples[]) {
+    if (!counters) {
+        return;
+    }
+    for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+        counterSamples[c].push_back((double)counters->count((PerfCounters::Counter)c) / loops);
+    }
+}
+
 static double estimate_timer_overhead() {
     double overhead = 0;
     for (int i = 0; i < FLAGS_overheadLoops; i++) {
@@ -571,12 +604,18 @@ public:
                       , fCurrentSKP(0)
                       , fCurrentUseMPD(0)
                       , fCurrentCodec(0)
+                      , fCurrentCodecModeImage(0)
+                      , fCurrentCodecMode(0)
                       , fCurrentImage(0)
                       , fCurrentSubsetImage(0)
                       , fCurrentColorType(0)
                       , fCurrentSubsetType(0)
                       , fUseCodec(0)
-                      , fCurrentAnimSKP(0) {
+                      , fCurrentAnimSKP(0)
+                      , fCopyBenches(NULL)
+                      , fCopyGMs(NULL)
+                      , fCopyUseMPD(false)
+                      , fLogMaxRSS(false) {
         for (int i = 0; i < FLAGS_skps.count(); i++) {
             if (SkStrEndsWith(FLAGS_skps[i], ".skp")) {
                 fSKPs.push_back() = FLAGS_skps[i];
@@ -660,8 +699,14 @@ public:
     }
 
     Benchmark* next() {
+        fCopyBenches = NULL;
+        fCopyGMs = NULL;
+        fCopyPic.reset(NULL);
+        fLogMaxRSS = false;
+
         if (fBenches) {
             Benchmark* bench = fBenches->factory()(NULL);
+            fCopyBenches = fBenches;
             fBenches = fBenches->next();
             fSourceType = "bench";
             fBenchType  = "micro";
@@ -670,6 +715,7 @@ public:
 
         while (fGMs) {
             SkAutoTDelete<skiagm::GM> gm(fGMs->factory()(NULL));
+            fCopyGMs = fGMs;
             fGMs = fGMs->next();
             if (gm->runAsBench()) {
                 fSourceType = "gm";
@@ -718,6 +764,9 @@ public:
                     SkString name = SkOSPath::Basename(path.c_str());
                     fSourceType = "skp";
                     fBenchType = "playback";
+                    fCopyPic.reset(SkRef(pic.get()));
+                    fCopyName = name;
+                    fCopyUseMPD = fUseMPDs[fCurrentUseMPD];
                     return SkNEW_ARGS(SKPBench,
                                       (name.c_str(), pic.get(), fClip, fScales[fCurrentScale],
                                        fUseMPDs[fCurrentUseMPD++], FLAGS_loopSKP));
@@ -802,6 +851,38 @@ public:
             fCurrentColorType = 0;
         }
 
+        // Run the CodecModeBenches
+        static const struct {
+            CodecModeBench::Mode mode;
+            float                scale;
+        } kCodecModes[] = {
+            { CodecModeBench::kScanline_Mode,      1.0f   },
+            { CodecModeBench::kSkipScanlines_Mode, 1.0f   },
+            { CodecModeBench::kScaled_Mode,        0.5f   },
+            { CodecModeBench::kScaled_Mode,        0.25f  },
+            { CodecModeBench::kScaled_Mode,        0.125f },
+            { CodecModeBench::kSubset_Mode,        1.0f   },
+            { CodecModeBench::kIncremental_Mode,   1.0f   },
+        };
+        while (fCurrentCodecModeImage < fImages.count()) {
+            const SkString& path = fImages[fCurrentCodecModeImage];
+            SkAutoTUnref<SkData> encoded(SkData::NewFromFileName(path.c_str()));
+            while (encoded && fCurrentCodecMode < (int)SK_ARRAY_COUNT(kCodecModes)) {
+                const int mode = fCurrentCodecMode++;
+                // Not every codec supports every mode.
+                if (CodecModeBench* bench = CodecModeBench::Create(
+                            SkOSPath::Basename(path.c_str()), encoded,
+                            kCodecModes[mode].mode, kCodecModes[mode].scale)) {
+                    fSourceType = "image";
+                    fBenchType  = "codec_mode";
+                    fLogMaxRSS  = true;
+                    return bench;
+                }
+            }
+            fCurrentCodecMode = 0;
+            fCurrentCodecModeImage++;
+        }
+
         // Run the DecodingBenches
         while (fCurrentImage < fImages.count()) {
             while (fCurrentColorType < fColorTypes.count()) {
@@ -874,6 +955,22 @@ public:
         return NULL;
     }
 
+    // Returns a new copy of the bench last returned by next(), or NULL if we can't make one.
+    // Copies share no state with each other, so each may draw on its own thread.
+    Benchmark* copyCurrent() const {
+        if (fCopyBenches) {
+            return fCopyBenches->factory()(NULL);
+        }
+        if (fCopyGMs) {
+            return SkNEW_ARGS(GMBench, (fCopyGMs->factory()(NULL)));
+        }
+        if (fCopyPic) {
+            return SkNEW_ARGS(SKPBench, (fCopyName.c_str(), fCopyPic.get(), fClip,
+                                         fScales[fCurrentScale], fCopyUseMPD, FLAGS_loopSKP));
+        }
+        return NULL;
+    }
+
     void fillCurrentOptions(ResultsWriter* log) const {
         log->configOption("source_type", fSourceType);
         log->configOption("bench_type",  fBenchType);
@@ -891,6 +988,11 @@ public:
             log->metric("bytes", fSKPBytes);
             log->metric("ops",   fSKPOps);
         }
+        if (fLogMaxRSS) {
+            // The process' high-water mark, so a decode that needs more memory than every bench
+            // before it shows up as a jump here.
+            log->metric("max_rss_mb", sk_tools::getMaxResidentSetSizeMB());
+        }
     }
 
 private:
@@ -925,19 +1027,144 @@ private:
     int fCurrentSKP;
     int fCurrentUseMPD;
     int fCurrentCodec;
+    int fCurrentCodecModeImage;
+    int fCurrentCodecMode;
     int fCurrentImage;
     int fCurrentSubsetImage;
     int fCurrentColorType;
     int fCurrentSubsetType;
     int fUseCodec;
     int fCurrentAnimSKP;
+
+    // Where copyCurrent() makes copies from.  At most one of these is set.
+    const BenchRegistry*      fCopyBenches;
+    const skiagm::GMRegistry* fCopyGMs;
+    SkAutoTUnref<SkPicture>   fCopyPic;
+    SkString                  fCopyName;
+    bool                      fCopyUseMPD;
+
+    // Whether to log the process' max RSS with the results of the bench next() last returned.
+    bool fLogMaxRSS;
 };
 
+struct ThroughputWorker {
+    Benchmark*              bench;
+    SkAutoTUnref<SkSurface> surface;
+    int                     loops;
+    int                     threads;
+    SkAtomic<int32_t>*      ready;
+    double                  opsPerSec;
+};
+
+static void throughput_thread(void* data) {
+    ThroughputWorker* worker = static_cast<ThroughputWorker*>(data);
+    SkCanvas* canvas = worker->surface->getCanvas();
+
+    // Wait for every thread to get here so they all run at the same time.
+    worker->ready->fetch_add(1);
+    while (worker->ready->load() < worker->threads) {}
+
+    int64_t ops = 0;
+    WallTimer timer;
+    timer.start();
+    do {
+        worker->bench->draw(worker->loops, canvas);
+        canvas->flush();
+        ops += worker->loops;
+        timer.end();
+    } while (timer.fWall < FLAGS_throughputMs);
+    worker->opsPerSec = ops / (timer.fWall * 1e-3);
+}
+
+// Runs 1, 2, 4, ... up to FLAGS_throughput copies of the current bench concurrently, each drawing
+// loops at a time into its own raster canvas, and logs their aggregate ops/sec for each count.
+static void run_throughput(const BenchmarkStream& benchStream, Benchmark* bench,
+                           const Config& config, int loops, ResultsWriter* log) {
+    double singleOpsPerSec = 0;
+    for (int threads = 1; threads <= FLAGS_throughput;
+         threads = SkTMin(2 * threads, FLAGS_throughput)) {
+        SkAutoTArray<ThroughputWorker> workers(threads);
+        SkAutoTArray<Benchmark*> copies(threads);
+        SkAtomic<int32_t> ready(0);
+        bool ok = true;
+        for (int i = 0; i < threads; i++) {
+            copies[i] = benchStream.copyCurrent();
+            if (!copies[i]) {
+                ok = false;
+                continue;
+            }
+            copies[i]->preDraw();
+            SkImageInfo info = SkImageInfo::Make(bench->getSize().fX, bench->getSize().fY,
+                                                 config.color, config.alpha);
+            workers[i].bench = copies[i];
+            workers[i].surface.reset(SkSurface::NewRaster(info));
+            workers[i].loops = loops;
+            workers[i].threads = threads;
+            workers[i].ready = &ready;
+            workers[i].opsPerSec = 0;
+            if (!workers[i].surface) {
+                ok = false;
+                continue;
+            }
+            workers[i].surface->getCanvas()->clear(SK_ColorWHITE);
+            copies[i]->perCanvasPreDraw(workers[i].surface->getCanvas());
+        }
+
+        double opsPerSec = 0;
+        if (ok) {
+            SkTArray<SkThread*> running;
+            for (int i = 0; i < threads; i++) {
+                running.push_back(SkNEW_ARGS(SkThread, (throughput_thread, &workers[i])));
+                running.back()->start();
+            }
+            for (int i = 0; i < threads; i++) {
+                running[i]->join();
+                SkDELETE(running[i]);
+                opsPerSec += workers[i].opsPerSec;
+            }
+        }
+
+        for (int i = 0; i < threads; i++) {
+            if (copies[i]) {
+                if (workers[i].surface) {
+                    copies[i]->perCanvasPostDraw(workers[i].surface->getCanvas());
+                }
+                SkDELETE(copies[i]);
+            }
+        }
+        if (!ok) {
+            // Not every bench can be copied.  A warning would only be noise.
+            return;
+        }
+
+        if (1 == threads) {
+            singleOpsPerSec = opsPerSec;
+        }
+        const double scaling = singleOpsPerSec > 0 ? opsPerSec / singleOpsPerSec : 0;
+
+        SkString name = SkStringPrintf("%s_threads_%d", config.name, threads);
+        log->config(name.c_str());
+        log->configOption("name", bench->getName());
+        log->configOption("threads", to_string(threads).c_str());
+        benchStream.fillCurrentOptions(log);
+        log->metric("ops_per_sec", opsPerSec);
+        log->metric("scaling", scaling);
+
+        SkDebugf("%d threads\t%.4g ops/sec\t%.2fx\t%s\t%s\n",
+                 threads, opsPerSec, scaling, config.name, bench->getUniqueName());
+
+        if (threads == FLAGS_throughput) {
+            break;
+        }
+    }
+}
+
 int nanobench_main();
 int nanobench_main() {
     SetupCrashHandler();
     SkAutoGraphics ag;
     SkTaskGroup::Enabler enabled(FLAGS_threads);
+    gSkUseAnalyticAA = FLAGS_analyticAA;
 
 #if SK_SUPPORT_GPU
     GrContextOptions grContextOpts;
@@ -1006,15 +1233,36 @@ int nanobench_main() {
 
     SkTArray<double> samples;
 
+    PerfCounters perfCounters;
+    PerfCounters* counters = NULL;
+    SkTArray<double> counterSamples[PerfCounters::kCounterCount];
+    SkTArray<double> allocSamples, byteSamples;
+    if (FLAGS_perfCounters) {
+        if (perfCounters.open()) {
+            counters = &perfCounters;
+        } else {
+            SkDebugf("WARNING: no hardware performance counters available; "
+                     "ignoring --perfCounters.\n");
+        }
+    }
+
     if (kAutoTuneLoops != FLAGS_loops) {
         SkDebugf("Fixed number of loops; times would only be misleading so we won't print them.\n");
     } else if (FLAGS_quiet) {
         SkDebugf("median\tbench\tconfig\n");
-    } else if (kTimedSampling == FLAGS_samples) {
-        SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\tsamples\tconfig\tbench\n");
     } else {
-        SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\t%-*s\tconfig\tbench\n",
-                 FLAGS_samples, "samples");
+#ifdef SK_COUNT_ALLOCATIONS
+        const char* allocColumns = "allocs/loop\tbytes/loop\t";
+#else
+        const char* allocColumns = "";
+#endif
+        if (kTimedSampling == FLAGS_samples) {
+            SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\tsamples\t"
+                     "%sconfig\tbench\n", allocColumns);
+        } else {
+            SkDebugf("curr/maxrss\tloops\tmin\tmedian\tmean\tmax\tstddev\t%-*s\t"
+                     "%sconfig\tbench\n", FLAGS_samples, "samples", allocColumns);
+        }
     }
 
     SkTDArray<Config> configs;
@@ -1050,10 +1298,28 @@ int nanobench_main() {
                 ? setup_gpu_bench(target, bench.get(), maxFrameLag)
                 : setup_cpu_bench(overhead, target, bench.get());
 
+            for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                counterSamples[c].reset();
+            }
+            allocSamples.reset();
+            byteSamples.reset();
+            SkAllocationCounts allocs;
+            // Peak memory is tracked over the samples only, not the loop calibration above.
+            SkResetThreadAllocationPeak();
+            SkGraphics::ResetResourceCachePeakBytesUsed();
+#if SK_SUPPORT_GPU
+            GrContext* grContext = canvas ? canvas->getGrContext() : NULL;
+            if (grContext) {
+                grContext->resetResourceCachePeakBytes();
+            }
+#endif
             if (kTimedSampling != FLAGS_samples) {
                 samples.reset(FLAGS_samples);
                 for (int s = 0; s < FLAGS_samples; s++) {
-                    samples[s] = time(loops, bench, target) / loops;
+                    samples[s] = time(loops, bench, target, counters, &allocs) / loops;
+                    add_counter_samples(counters, loops, counterSamples);
+                    allocSamples.push_back((double)allocs.allocs / loops);
+                    byteSamples.push_back((double)allocs.bytes / loops);
                 }
             } else if (samplingTimeMs) {
                 samples.reset();
@@ -1064,7 +1330,10 @@ int nanobench_main() {
                 WallTimer timer;
                 timer.start();
                 do {
-                    samples.push_back(time(loops, bench, target) / loops);
+                    samples.push_back(time(loops, bench, target, counters, &allocs) / loops);
+                    add_counter_samples(counters, loops, counterSamples);
+                    allocSamples.push_back((double)allocs.allocs / loops);
+                    byteSamples.push_back((double)allocs.bytes / loops);
                     timer.end();
                 } while (timer.fWall < samplingTimeMs);
             }
@@ -1091,6 +1360,33 @@ int nanobench_main() {
             benchStream.fillCurrentOptions(log.get());
             target->fillOptions(log.get());
             log->metric("min_ms",    stats.min);
+#ifdef SK_COUNT_ALLOCATIONS
+            const double allocsPerLoop = Stats(allocSamples).median,
+                         bytesPerLoop  = Stats(byteSamples).median;
+            log->metric("allocs_per_loop", allocsPerLoop);
+            log->metric("bytes_per_loop",  bytesPerLoop);
+            // Above what this thread already had live when sampling started.
+            log->metric("peak_malloc_bytes", (double)SkGetThreadAllocationPeak());
+            SkString allocColumns = SkStringPrintf("%.4g\t%.4g\t", allocsPerLoop, bytesPerLoop);
+#else
+            SkString allocColumns;
+#endif
+            log->metric("peak_resource_cache_bytes",
+                        (double)SkGraphics::GetResourceCachePeakBytesUsed());
+#if SK_SUPPORT_GPU
+            if (grContext) {
+                log->metric("peak_gpu_cache_bytes", (double)grContext->getResourceCachePeakBytes());
+            }
+#endif
+            if (counters) {
+                // Median counts per loop, recorded as e.g. "cycles".
+                for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                    if (counters->has((PerfCounters::Counter)c)) {
+                        log->metric(PerfCounters::Name((PerfCounters::Counter)c),
+                                    Stats(counterSamples[c]).median);
+                    }
+                }
+            }
             if (runs++ % FLAGS_flushEvery == 0) {
                 log->flush();
             }
@@ -1111,7 +1407,7 @@ int nanobench_main() {
                 SkDebugf("%s\t%s\t%s\n", HUMANIZE(stats.median), bench->getUniqueName(), config);
             } else {
                 const double stddev_percent = 100 * sqrt(stats.var) / stats.mean;
-                SkDebugf("%4d/%-4dMB\t%d\t%s\t%s\t%s\t%s\t%.0f%%\t%s\t%s\t%s\n"
+                SkDebugf("%4d/%-4dMB\t%d\t%s\t%s\t%s\t%s\t%.0f%%\t%s\t%s%s\t%s\n"
                         , sk_tools::getCurrResidentSetSizeMB()
                         , sk_tools::getMaxResidentSetSizeMB()
                         , loops
@@ -1122,6 +1418,7 @@ int nanobench_main() {
                         , stddev_percent
                         , kTimedSampling != FLAGS_samples ? stats.plot.c_str()
                                                           : to_string(samples.count()).c_str()
+                        , allocColumns.c_str()
                         , config
                         , bench->getUniqueName()
                         );
@@ -1139,6 +1436,22 @@ int nanobench_main() {
                     SkDebugf("%s  ", HUMANIZE(samples[i]));
                 }
                 SkDebugf("%s\n", bench->getUniqueName());
+                if (counters) {
+                    SkDebugf("Counters per loop:  ");
+                    for (int c = 0; c < PerfCounters::kCounterCount; c++) {
+                        if (counters->has((PerfCounters::Counter)c)) {
+                            SkDebugf("%s %.4g  ", PerfCounters::Name((PerfCounters::Counter)c),
+                                     Stats(counterSamples[c]).median);
+                        }
+                    }
+                    SkDebugf("%s\n", bench->getUniqueName());
+                }
+            }
+            // Only raster canvases can be drawn to from many threads, and only self-tuned loop
+            // counts are short enough to time this way.
+            if (FLAGS_throughput > 0 && kAutoTuneLoops == FLAGS_loops &&
+                Benchmark::kRaster_Backend == target->config.backend) {
+                run_throughput(benchStream, bench.get(), target->config, loops, log.get());
             }
             cleanup_run(target);
         }
@@ -10,7 +10,9 @@
 #include "DMSrcSink.h"
 #include "DMSrcSinkAndroid.h"
 #include "OverwriteLine.h"
+#include "PerfCounters.h"
 #include "ProcStats.h"
+#include "SkAllocationCounter.h"
 #include "SkBBHFactory.h"
 #include "SkChecksum.h"
 #include "SkCommonFlags.h"
@@ -36,6 +38,9 @@ DEFINE_string(matrix, "1 0 0 1",
               "2x2 scale+skew matrix to apply or upright when using "
               "'matrix' or 'upright' in config.");
 DEFINE_bool(gpu_threading, false, "Allow GPU work to run on multiple threads?");
+DEFINE_int32(gpuThreads, 1,
+             "Without --gpu_threading, split GPU work across this many threads, each running its "
+             "share serially with its own GL contexts.  Use one per GPU on multi-GPU machines.");
 
 DEFINE_string(blacklist, "",
         "Space-separated config/src/srcOptions/name quadruples to blacklist.  '_' matches anything.  E.g. \n"
@@ -109,6 +114,38 @@ static void done(double ms,
     }
 }
 
+// Allocations made by each sink's draws, summed over all srcs.  Only counted in builds with
+// SK_COUNT_ALLOCATIONS; see SkAllocationCounter.h.
+struct SinkAllocations {
+    SkString sink;
+    int      draws;
+    uint64_t allocs;
+    uint64_t bytes;
+};
+SK_DECLARE_STATIC_MUTEX(gSinkAllocationsMutex);
+static SkTArray<SinkAllocations> gSinkAllocations;
+
+static void add_sink_allocations(const char* sink, const SkAllocationCounts& counts) {
+    SkAutoMutexAcquire lock(gSinkAllocationsMutex);
+    for (int i = 0; i < gSinkAllocations.count(); i++) {
+        if (gSinkAllocations[i].sink.equals(sink)) {
+            gSinkAllocations[i].draws++;
+            gSinkAllocations[i].allocs += counts.allocs;
+            gSinkAllocations[i].bytes  += counts.bytes;
+            return;
+        }
+    }
+    SinkAllocations allocations = { SkString(sink), 1, counts.allocs, counts.bytes };
+    gSinkAllocations.push_back(allocations);
+}
+
+// The most memory a task's draw held at once.  mallocBytes is above what its thread had live before
+// the draw; see SkAllocationCounter.h.
+struct PeakBytes {
+    uint64_t mallocBytes;
+    size_t   resourceCacheBytes;
+};
+
 static void start(ImplicitString config, ImplicitString src,
                   ImplicitString srcOptions, ImplicitString name) {
     SkString id = SkStringPrintf("%s %s %s %s", config.c_str(), src.c_str(),
@@ -511,7 +548,25 @@ struct Task {
                 SkDebugf("\nRunning %s->%s", name.c_str(), task->sink.tag);
             }
             start(task->sink.tag, task->src.tag, task->src.options, name.c_str());
+            PerfCounters counters;
+            const bool countPerf = FLAGS_perfCounters && counters.open();
+            if (countPerf) {
+                counters.start();
+            }
+            const SkAllocationCounts allocsBefore = SkGetThreadAllocationCounts();
+            SkResetThreadAllocationPeak();
+            if (0 == FLAGS_threads) {
+                // The resource cache is shared, so its peak is only this task's when tasks
+                // run one at a time.
+                SkGraphics::ResetResourceCachePeakBytesUsed();
+            }
             Error err = task->sink->draw(*task->src, &bitmap, &stream, &log);
+            add_sink_allocations(task->sink.tag, SkGetThreadAllocationCounts() - allocsBefore);
+            const PeakBytes peak = { SkGetThreadAllocationPeak(),
+                                     SkGraphics::GetResourceCachePeakBytesUsed() };
+            if (countPerf) {
+                counters.end();
+            }
             if (!err.isEmpty()) {
                 timer.end();
                 if (err.isFatal()) {
@@ -571,10 +626,12 @@ struct Task {
             if (!FLAGS_writePath.isEmpty()) {
                 const char* ext = task->sink->fileExtension();
                 if (data->getLength()) {
-                    WriteToDisk(*task, md5, ext, data, data->getLength(), NULL);
+                    WriteToDisk(*task, md5, ext, data, data->getLength(), NULL,
+                                countPerf ? &counters : NULL, peak);
                     SkASSERT(bitmap.drawsNothing());
                 } else if (!bitmap.drawsNothing()) {
-                    WriteToDisk(*task, md5, ext, NULL, 0, &bitmap);
+                    WriteToDisk(*task, md5, ext, NULL, 0, &bitmap,
+                                countPerf ? &counters : NULL, peak);
                 }
             }
         }
@@ -586,7 +643,9 @@ struct Task {
                             SkString md5,
                             const char* ext,
                             SkStream* data, size_t len,
-                            const SkBitmap* bitmap) {
+                            const SkBitmap* bitmap,
+                            const PerfCounters* counters,
+                            const PeakBytes& peak) {
         JsonWriter::BitmapResult result;
         result.name          = task.src->name();
         result.config        = task.sink.tag;
@@ -594,6 +653,23 @@ struct Task {
         result.sourceOptions = task.src.options;
         result.ext           = ext;
         result.md5           = md5;
+        for (int c = 0; counters && c < PerfCounters::kCounterCount; c++) {
+            if (counters->has((PerfCounters::Counter)c)) {
+                JsonWriter::PerfCount count = {
+                    PerfCounters::Name((PerfCounters::Counter)c),
+                    (double)counters->count((PerfCounters::Counter)c),
+                };
+                result.perf.push_back(count);
+            }
+        }
+#ifdef SK_COUNT_ALLOCATIONS
+        JsonWriter::PerfCount mallocPeak = { "malloc", (double)peak.mallocBytes };
+        result.peakBytes.push_back(mallocPeak);
+#endif
+        if (0 == FLAGS_threads) {
+            JsonWriter::PerfCount cachePeak = { "resource_cache", (double)peak.resourceCacheBytes };
+            result.peakBytes.push_back(cachePeak);
+        }
         JsonWriter::AddBitmapResult(result);
 
         // If an MD5 is uninteresting, we want it noted in the JSON file,
@@ -729,10 +805,18 @@ static void run_test(skiatest::Test* test) {
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
-// If we're isolating all GPU-bound work to one thread (the default), this function runs all that.
-static void run_enclave_and_gpu_tests(SkTArray<Task>* tasks) {
-    run_enclave(tasks);
-    for (int i = 0; i < gGPUTests.count(); i++) {
+// If we're isolating GPU-bound work (the default), it's dealt out to --gpuThreads workers, each
+// running its share serially on its own thread.  GPUSink makes a new GrContextFactory, and so new
+// GL contexts, for every draw, so workers never share a context.
+struct GPUWorker {
+    SkTArray<Task> tasks;
+    int            firstTest;  // This worker runs gGPUTests[firstTest], [firstTest + workers], ...
+    int            workers;
+};
+
+static void run_gpu_worker(GPUWorker* worker) {
+    run_enclave(&worker->tasks);
+    for (int i = worker->firstTest; i < gGPUTests.count(); i += worker->workers) {
         run_test(&gGPUTests[i]);
     }
 }
@@ -809,6 +893,18 @@ int dm_main() {
         }
     }
 
+    // GPU tasks are dealt round-robin so each worker gets a mix of srcs and sinks.
+    const int gpuWorkerCount = SkTMax(FLAGS_gpuThreads, 1);
+    SkAutoTArray<GPUWorker> gpuWorkers(gpuWorkerCount);
+    for (int w = 0; w < gpuWorkerCount; w++) {
+        gpuWorkers[w].firstTest = w;
+        gpuWorkers[w].workers   = gpuWorkerCount;
+    }
+    const SkTArray<Task>& gpuTasks = enclaves[kGPU_Enclave];
+    for (int i = 0; i < gpuTasks.count(); i++) {
+        gpuWorkers[i % gpuWorkerCount].tasks.push_back(gpuTasks[i]);
+    }
+
     SkTaskGroup tg;
     tg.batch(run_test, gThreadedTests.begin(), gThreadedTests.count());
     for (int i = 0; i < kNumEnclaves; i++) {
@@ -817,7 +913,7 @@ int dm_main() {
                 tg.batch(Task::Run, enclaves[i].begin(), enclaves[i].count());
                 break;
             case kGPU_Enclave:
-                tg.add(run_enclave_and_gpu_tests, &enclaves[i]);
+                tg.batch(run_gpu_worker, gpuWorkers.get(), gpuWorkerCount);
                 break;
             default:
                 tg.add(run_enclave, &enclaves[i]);
@@ -829,6 +925,16 @@ int dm_main() {
     sk_tool_utils::release_portable_typefaces();
 
     SkDebugf("\n");
+#ifdef SK_COUNT_ALLOCATIONS
+    SkDebugf("Allocations per draw:\n");
+    for (int i = 0; i < gSinkAllocations.count(); i++) {
+        const SinkAllocations& sa = gSinkAllocations[i];
+        SkDebugf("\t%s\t%.1f allocs\t%.0f bytes\n",
+                 sa.sink.c_str(), (double)sa.allocs / sa.draws, (double)sa.bytes / sa.draws);
+        JsonWriter::AddSinkAllocations(sa.sink.c_str(), sa.draws, sa.allocs, sa.bytes);
+    }
+    JsonWriter::DumpJson();
+#endif
     if (gFailures.count() > 0) {
         SkDebugf("Failures:\n");
         for (int i = 0; i < gFailures.count(); i++) {
@@ -26,6 +26,21 @@ void JsonWriter::AddBitmapResult(const BitmapResult& result) {
     gBitmapResults.push_back(result);
 }
 
+struct SinkAllocations {
+    SkString sink;
+    int      draws;
+    uint64_t allocs;
+    uint64_t bytes;
+};
+SkTArray<SinkAllocations> gSinkAllocations;
+SK_DECLARE_STATIC_MUTEX(gSinkAllocationsLock);
+
+void JsonWriter::AddSinkAllocations(const char* sink, int draws, uint64_t allocs, uint64_t bytes) {
+    SkAutoMutexAcquire lock(gSinkAllocationsLock);
+    SinkAllocations allocations = { SkString(sink), draws, allocs, bytes };
+    gSinkAllocations.push_back(allocations);
+}
+
 SkTArray<skiatest::Failure> gFailures;
 SK_DECLARE_STATIC_MUTEX(gFailureLock);
 
@@ -64,10 +79,29 @@ void JsonWriter::DumpJson() {
                 result["key"]["source_options"] = gBitmapResults[i].sourceOptions.c_str();
             }
 
+            const SkTArray<PerfCount>& perf = gBitmapResults[i].perf;
+            for (int j = 0; j < perf.count(); j++) {
+                result["perf"][perf[j].name] = perf[j].count;
+            }
+            const SkTArray<PerfCount>& peakBytes = gBitmapResults[i].peakBytes;
+            for (int j = 0; j < peakBytes.count(); j++) {
+                result["peak_bytes"][peakBytes[j].name] = peakBytes[j].count;
+            }
+
             root["results"].append(result);
         }
     }
 
+    {
+        SkAutoMutexAcquire lock(gSinkAllocationsLock);
+        for (int i = 0; i < gSinkAllocations.count(); i++) {
+            Json::Value& result = root["allocations"][gSinkAllocations[i].sink.c_str()];
+            result["draws"]  = gSinkAllocations[i].draws;
+            result["allocs"] = (double)gSinkAllocations[i].allocs;
+            result["bytes"]  = (double)gSinkAllocations[i].bytes;
+        }
+    }
+
     {
         SkAutoMutexAcquire lock(gFailureLock);
         for (int i = 0; i < gFailures.count(); i++) {
@@ -9,6 +9,7 @@
 #define DMJsonWriter_DEFINED
 
 #include "SkString.h"
+#include "SkTArray.h"
 #include "Test.h"
 
 namespace DM {
@@ -19,6 +20,14 @@ namespace DM {
  */
 class JsonWriter {
 public:
+    /**
+     *  A hardware performance counter's count, e.g. "cycles", see --perfCounters.
+     */
+    struct PerfCount {
+        const char* name;         // Unowned, static.
+        double      count;
+    };
+
     /**
      *  Info describing a single run.
      */
@@ -29,6 +38,8 @@ public:
         SkString sourceOptions;   //      "image", "codec", "subset", "scanline"
         SkString md5;             // In ASCII, so 32 bytes long.
         SkString ext;             // Extension of file we wrote: "png", "pdf", ...
+        SkTArray<PerfCount> perf; // Counted while drawing, if --perfCounters.
+        SkTArray<PerfCount> peakBytes;  // Most memory held while drawing, e.g. "malloc".
     };
 
     /**
@@ -36,6 +47,11 @@ public:
      */
     static void AddBitmapResult(const BitmapResult&);
 
+    /**
+     *  Record the total allocations made by a sink's draws; see SkAllocationCounter.h.
+     */
+    static void AddSinkAllocations(const char* sink, int draws, uint64_t allocs, uint64_t bytes);
+
     /**
      *  Add a Failure from a Test.
      */
@@ -474,10 +474,47 @@ private:
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Dashed hairline staircases, which the GPU draws a line at a time, carrying the phase.
+class DashingPolylineGM : public skiagm::GM {
+protected:
+    SkString onShortName() override { return SkString("dashing_polyline"); }
+
+    SkISize onISize() override { return SkISize::Make(400, 400); }
+
+    void onDraw(SkCanvas* canvas) override {
+        SkPath path;
+        path.moveTo(0, 0);
+        for (int i = 1; i <= 8; ++i) {
+            path.lineTo(SkIntToScalar(i * 19), SkIntToScalar((i - 1) * 17));
+            path.lineTo(SkIntToScalar(i * 19), SkIntToScalar(i * 17));
+        }
+
+        SkPaint paint;
+        paint.setStyle(SkPaint::kStroke_Style);
+        canvas->translate(20, 20);
+        for (int aa = 0; aa < 2; ++aa) {
+            paint.setAntiAlias(SkToBool(aa));
+            canvas->save();
+            for (int phase = 0; phase < 3; ++phase) {
+                const SkScalar intervals[] = { SkIntToScalar(5 + 2 * phase), 3 };
+                paint.setPathEffect(SkDashPathEffect::Create(intervals, 2,
+                                                             SkIntToScalar(phase * 4)))->unref();
+                canvas->drawPath(path, paint);
+                canvas->translate(0, 30);
+            }
+            canvas->restore();
+            canvas->translate(200, 0);
+        }
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 DEF_GM(return SkNEW(DashingGM);)
 DEF_GM(return SkNEW(Dashing2GM);)
 DEF_GM(return SkNEW(Dashing3GM);)
 DEF_GM(return SkNEW(Dashing4GM);)
 DEF_GM(return SkNEW_ARGS(Dashing5GM, (true));)
 DEF_GM(return SkNEW_ARGS(Dashing5GM, (false));)
+DEF_GM(return SkNEW(DashingPolylineGM);)
 
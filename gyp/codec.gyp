@@ -37,6 +37,8 @@
         '../src/codec/SkBmpRLECodec.cpp',
         '../src/codec/SkBmpStandardCodec.cpp',
         '../src/codec/SkCodec.cpp',
+        '../src/codec/SkCodecFrameCache.cpp',
+        '../src/codec/SkCodecScratch.cpp',
         '../src/codec/SkCodec_libgif.cpp',
         '../src/codec/SkCodec_libico.cpp',
         '../src/codec/SkCodec_libpng.cpp',
@@ -83,6 +85,7 @@
             ],
             'cflags': [
               '-DTURBO_HAS_SKIP',
+              '-DTURBO_HAS_CROP',
             ],
           }
         ]
@@ -12,7 +12,7 @@
 
   # Generally we shove things into one 'opts' target conditioned on platform.
   # If a particular platform needs some files built with different flags,
-  # those become separate targets: opts_ssse3, opts_sse41, opts_neon.
+  # those become separate targets: opts_ssse3, opts_sse41, opts_avx2, opts_neon.
 
   'targets': [
     {
@@ -34,7 +34,7 @@
       'conditions': [
         [ '"x86" in skia_arch_type and skia_os != "ios"', {
           'cflags': [ '-msse2' ],
-          'dependencies': [ 'opts_ssse3', 'opts_sse41' ],
+          'dependencies': [ 'opts_ssse3', 'opts_sse41', 'opts_avx2' ],
           'sources': [ '<@(sse2_sources)' ],
         }],
 
@@ -128,6 +128,31 @@
         }],
       ],
     },
+    {
+      'target_name': 'opts_avx2',
+      'product_name': 'skia_opts_avx2',
+      'type': 'static_library',
+      'standalone_static_library': 1,
+      'dependencies': [ 'core.gyp:*' ],
+      'include_dirs': [
+          '../include/private',
+          '../src/core',
+          '../src/utils',
+      ],
+      'sources': [ '<@(avx2_sources)' ],
+      'conditions': [
+        [ 'skia_os == "win"', {
+            'defines' : [ 'SK_CPU_SSE_LEVEL=52' ],
+            'msvs_settings': { 'VCCLCompilerTool': { 'AdditionalOptions': [ '/arch:AVX2' ] } },
+        }],
+        [ 'not skia_android_framework', {
+          'cflags': [ '-mavx2' ],
+        }],
+        [ 'skia_os == "mac"', {
+          'xcode_settings': { 'OTHER_CPLUSPLUSFLAGS': [ '-mavx2' ] },
+        }],
+      ],
+    },
     {
       'target_name': 'opts_neon',
       'product_name': 'skia_opts_neon',
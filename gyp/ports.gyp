@@ -207,6 +207,14 @@
             '../src/ports/SkDebug_android.cpp',
           ],
         }],
+        [ 'skia_os == "linux"', {
+          'sources!': [
+            '../src/ports/SkDiscardableMemory_none.cpp',
+          ],
+          'sources': [
+            '../src/ports/SkDiscardableMemory_madvise.cpp',
+          ],
+        }],
       ],
       'direct_dependent_settings': {
         'include_dirs': [
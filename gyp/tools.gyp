@@ -35,6 +35,7 @@
         'skpdiff',
         'skpinfo',
         'skpmaker',
+        'skp_op_timing',
         'test_image_decoder',
         'test_public_includes',
       ],
@@ -115,6 +116,7 @@
       'target_name' : 'timer',
       'type': 'static_library',
       'sources': [
+        '../tools/timer/PerfCounters.cpp',
         '../tools/timer/Timer.cpp',
         '../tools/timer/TimerData.cpp',
       ],
@@ -160,6 +162,9 @@
         '../tools/skdiff_utils.cpp',
         '../tools/skdiff_utils.h',
       ],
+      'include_dirs': [
+        '../src/core',
+      ],
       'dependencies': [
         'skia_lib.gyp:skia_lib',
       ],
@@ -250,6 +255,9 @@
         '../tools/skdiff_utils.cpp',
         '../tools/skdiff_utils.h',
       ],
+      'include_dirs': [
+        '../src/core',
+      ],
       'dependencies': [
         'skia_lib.gyp:skia_lib',
       ],
@@ -449,6 +457,38 @@
         'skia_lib.gyp:skia_lib',
       ],
     },
+    {
+      'target_name': 'skp_op_timing',
+      'type': 'executable',
+      'sources': [
+        '../tools/skp_op_timing.cpp',
+        '../tools/LazyDecodeBitmap.cpp',
+      ],
+      'include_dirs': [
+        '../include/private',
+        '../src/core/',
+        '../src/images',
+        '../src/lazy',
+      ],
+      'dependencies': [
+        'timer',
+        'flags.gyp:flags',
+        'jsoncpp.gyp:jsoncpp',
+        'skia_lib.gyp:skia_lib',
+      ],
+      'conditions': [
+        ['skia_gpu == 1',
+          {
+            'include_dirs' : [
+              '../src/gpu',
+            ],
+            'dependencies': [
+              'gputest.gyp:skgputest',
+            ],
+          },
+        ],
+      ],
+    },
     {
       'target_name': 'picture_renderer',
       'type': 'static_library',
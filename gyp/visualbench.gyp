@@ -24,6 +24,8 @@
       ],
       'sources': [
         '../gm/gm.cpp',
+        '../tools/VisualBench/GpuFrameTimer.h',
+        '../tools/VisualBench/GpuFrameTimer.cpp',
         '../tools/VisualBench/VisualBench.h',
         '../tools/VisualBench/VisualBench.cpp',
         '../tools/VisualBench/VisualBenchmarkStream.h',
@@ -40,6 +42,7 @@
         'etc1.gyp:libetc1',
         'flags.gyp:flags',
         'gputest.gyp:skgputest',
+        'jsoncpp.gyp:jsoncpp',
         'skia_lib.gyp:skia_lib',
         'tools.gyp:proc_stats',
         'tools.gyp:sk_tool_utils',
@@ -38,6 +38,51 @@ void sk_canvas_draw_image_rect(sk_canvas_t*, const sk_image_t*, const sk_rect_t*
                                const sk_rect_t* dst, const sk_paint_t*);
 void sk_canvas_draw_picture(sk_canvas_t*, const sk_picture_t*, const sk_matrix_t*, const sk_paint_t*);
 
+/**
+ *  Opcodes for sk_canvas_execute(). Each op in the stream is a uint32_t opcode followed by its
+ *  arguments, all 4-byte words in native byte order: floats for coordinates, and uint32_t
+ *  indices into the sk_canvas_handles_t tables for paints, paths and images.
+ */
+typedef enum {
+    SAVE_SK_CANVAS_OP               = 0,    // (none)
+    RESTORE_SK_CANVAS_OP            = 1,    // (none)
+    TRANSLATE_SK_CANVAS_OP          = 2,    // float dx, dy
+    SCALE_SK_CANVAS_OP              = 3,    // float sx, sy
+    CONCAT_SK_CANVAS_OP             = 4,    // float mat[9], as in sk_matrix_t
+    CLIP_RECT_SK_CANVAS_OP          = 5,    // float left, top, right, bottom
+    CLIP_PATH_SK_CANVAS_OP          = 6,    // path
+    DRAW_PAINT_SK_CANVAS_OP         = 7,    // paint
+    DRAW_RECT_SK_CANVAS_OP          = 8,    // float left, top, right, bottom; paint
+    DRAW_OVAL_SK_CANVAS_OP          = 9,    // float left, top, right, bottom; paint
+    DRAW_PATH_SK_CANVAS_OP          = 10,   // path; paint
+    DRAW_IMAGE_SK_CANVAS_OP         = 11,   // image; float x, y; paint or SK_CANVAS_NO_PAINT
+    DRAW_IMAGE_RECT_SK_CANVAS_OP    = 12,   // image; float left, top, right, bottom;
+                                            //   paint or SK_CANVAS_NO_PAINT
+} sk_canvas_op_t;
+
+/** Paint index for image ops that draw without a paint. */
+#define SK_CANVAS_NO_PAINT  0xFFFFFFFF
+
+/** The objects that an sk_canvas_execute() stream refers to by index. */
+typedef struct {
+    const sk_paint_t* const*    paints;
+    uint32_t                    paintCount;
+    const sk_path_t* const*     paths;
+    uint32_t                    pathCount;
+    const sk_image_t* const*    images;
+    uint32_t                    imageCount;
+} sk_canvas_handles_t;
+
+/**
+ *  Decode and draw a stream of sk_canvas_op_t ops, so that a binding can submit many draws in
+ *  one call. The stream is length bytes starting at ops, which need not be aligned.
+ *
+ *  Returns true if the whole stream was executed. If an op is unknown, truncated, or refers to
+ *  an index outside its table, returns false; the ops before it will already have been drawn.
+ */
+bool sk_canvas_execute(sk_canvas_t*, const void* ops, size_t length,
+                       const sk_canvas_handles_t*);
+
 SK_C_PLUS_PLUS_END_GUARD
 
 #endif
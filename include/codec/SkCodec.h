@@ -8,6 +8,7 @@
 #ifndef SkCodec_DEFINED
 #define SkCodec_DEFINED
 
+#include "SkBitmap.h"
 #include "SkColor.h"
 #include "SkEncodedFormat.h"
 #include "SkImageInfo.h"
@@ -29,6 +30,9 @@ public:
      *
      *  If NULL is returned, the stream is deleted immediately. Otherwise, the
      *  SkCodec takes ownership of it, and will delete it when done with it.
+     *
+     *  A stream that cannot rewind is buffered as it is read, so the codec can
+     *  read it again.
      */
     static SkCodec* NewFromStream(SkStream*);
 
@@ -141,6 +145,11 @@ public:
         kNo_ZeroInitialized,
     };
 
+    /**
+     *  Used for FrameInfo::fRequiredFrame and Options::fPriorFrame to mean no frame.
+     */
+    static const int kNone = -1;
+
     /**
      *  Additional options to pass to getPixels.
      */
@@ -148,6 +157,9 @@ public:
         Options()
             : fZeroInitialized(kNo_ZeroInitialized)
             , fSubset(NULL)
+            , fParallelDecode(false)
+            , fFrameIndex(0)
+            , fPriorFrame(kNone)
         {}
 
         ZeroInitialized fZeroInitialized;
@@ -156,10 +168,36 @@ public:
          *
          *  Must be within the bounds returned by getInfo().
          *
-         *  If the EncodedFormat is kWEBP_SkEncodedFormat (the only one which
-         *  currently supports subsets), the top and left values must be even.
+         *  Only webp and jpeg support subsets; use getValidSubset() to find one
+         *  they can decode.  Webp requires the top and left values to be even,
+         *  and jpeg requires the left value to be on an iMCU boundary.  Jpeg
+         *  subsets cannot be scaled.
          */
         SkIRect*        fSubset;
+        /**
+         *  If true, the codec may split the decode into independent pieces and
+         *  run them concurrently on SkTaskGroup threads, writing directly into
+         *  the destination rows.  The output is identical to a serial decode.
+         *
+         *  Currently only jpegs with restart markers take advantage of this.
+         */
+        bool            fParallelDecode;
+        /**
+         *  The frame to decode, for images with more than one (see getFrameCount()).
+         *
+         *  A frame that is drawn on top of earlier frames is decoded fully composited, so
+         *  it can only be decoded to kN32_SkColorType, and not as a subset.
+         */
+        int             fFrameIndex;
+        /**
+         *  If not kNone, the pixels passed to getPixels already hold this frame, decoded
+         *  with the same info. If fFrameIndex is drawn on top of it, directly or through
+         *  other frames (see FrameInfo::fRequiredFrame), only the frames above it are
+         *  decoded. Otherwise it is ignored.
+         *
+         *  Playing an animation in order should pass the frame previously decoded here.
+         */
+        int             fPriorFrame;
     };
 
     /**
@@ -200,6 +238,54 @@ public:
      */
     Result getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes);
 
+    /**
+     *  Allocate dst's pixels with allocator (or from the heap, if it is NULL) and decode into
+     *  them. The allocator may place the pixels in memory it owns, with any rowBytes, so a decode
+     *  can land directly in e.g. a buffer pool. If info is NULL, getInfo() is used.
+     *  kIndex8_SkColorType is not supported.
+     *
+     *  On kSuccess or kIncompleteInput dst is marked immutable, so SkImage::NewFromBitmap()
+     *  shares its pixels rather than copying them. Otherwise dst is reset.
+     */
+    Result decodeToBitmap(SkBitmap* dst, const SkImageInfo* info = NULL,
+                          SkBitmap::Allocator* allocator = NULL, const Options* options = NULL);
+
+    /**
+     *  Begin decoding into the given pixels while the encoded data is still arriving.
+     *
+     *  The parameters have the same meaning as in getPixels(), and pixels, ctable and
+     *  ctableCount must remain valid until the decode completes. Everything that the stream
+     *  passed to NewFromStream currently holds is consumed immediately; the remainder of the
+     *  encoded data is passed to incrementalDecode() as it arrives. Because the data already
+     *  read by the codec is read again, the stream must be able to rewind.
+     *
+     *  Starting a new incremental decode abandons the previous one. Calls to getPixels() are
+     *  independent of the incremental decode.
+     *
+     *  @return Result kSuccess if the decode has started, kUnimplemented if this codec does
+     *          not support incremental decoding, or another value explaining the failure.
+     */
+    Result startIncrementalDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                                  const Options*, SkPMColor ctable[], int* ctableCount);
+
+    /**
+     *  Simplified version of startIncrementalDecode() that asserts that info is NOT
+     *  kIndex8_SkColorType and uses the default Options.
+     */
+    Result startIncrementalDecode(const SkImageInfo& info, void* pixels, size_t rowBytes);
+
+    /**
+     *  Continue the decode begun by startIncrementalDecode() with the next length bytes of
+     *  encoded data. Passing no data reports the progress made so far.
+     *
+     *  @param rowsDecoded If not NULL, set to the number of rows, starting from the top, that
+     *         hold decoded pixels. Rows below it may be unwritten or only partially decoded.
+     *         Progressive images may refine the decoded rows on later calls.
+     *  @return Result kSuccess once the whole image has been decoded, kIncompleteInput if
+     *          more data is needed, or another value explaining the failure.
+     */
+    Result incrementalDecode(const void* data, size_t length, int* rowsDecoded);
+
     /**
      *  Some images may initially report that they have alpha due to the format
      *  of the encoded data, but then never use any colors which have alpha
@@ -212,6 +298,55 @@ public:
         return this->onReallyHasAlpha();
     }
 
+    /**
+     *  Return the number of frames in the image. Still images have one; animated gifs and
+     *  webps have one per frame. Counting the frames may require reading the whole stream.
+     */
+    int getFrameCount() { return this->onGetFrameCount(); }
+
+    /**
+     *  Information about one frame of an animated image.
+     */
+    struct FrameInfo {
+        /**
+         *  The frame this one is drawn on top of, once that frame has been disposed of as its
+         *  format requires, or kNone if this frame is drawn on a clear canvas. Decoding this
+         *  frame includes decoding the frames it requires, unless one of them is passed as
+         *  Options::fPriorFrame or is cached.
+         */
+        int fRequiredFrame;
+        /**
+         *  How long to show this frame, in milliseconds.
+         */
+        int fDuration;
+    };
+
+    /**
+     *  Describe frame index. Returns false if index is not less than getFrameCount().
+     */
+    bool getFrameInfo(int index, FrameInfo*);
+
+    /**
+     *  One image for DecodeBatch(): encoded data in, pixels out.
+     */
+    struct BatchItem {
+        BatchItem() : fEncoded(NULL), fScale(1.0f), fResult(kUnimplemented) {}
+
+        SkData*  fEncoded;  // In. Not reffed; must outlive DecodeBatch().
+        float    fScale;    // In. Decode to getScaledDimensions(fScale).
+        SkBitmap fBitmap;   // Out. kN32_SkColorType, allocated by DecodeBatch().
+        Result   fResult;   // Out. kInvalidInput if no codec recognizes fEncoded.
+    };
+
+    /**
+     *  Decode count images, spread over SkTaskGroup threads, and return when all are done.
+     *
+     *  Each thread runs its share of the decodes back to back, recycling the row buffers one
+     *  codec frees for the next, so batches of small images (e.g. thumbnails) pay less per-image
+     *  setup than decoding each with its own NewFromData() and getPixels().
+     */
+    static void DecodeBatch(BatchItem items[], int count);
+
 protected:
     SkCodec(const SkImageInfo&, SkStream*);
 
@@ -226,6 +361,20 @@ protected:
                                void* pixels, size_t rowBytes, const Options&,
                                SkPMColor ctable[], int* ctableCount) = 0;
 
+    /**
+     *  Subclasses that support incremental decoding override both of these. The parameters
+     *  have already been checked as for onGetPixels.
+     */
+    virtual Result onStartIncrementalDecode(const SkImageInfo&, void*, size_t, const Options&,
+                                            SkPMColor*, int*) {
+        return kUnimplemented;
+    }
+
+    virtual Result onIncrementalDecode(const void* /* data */, size_t /* length */,
+                                       int* /* rowsDecoded */) {
+        return kUnimplemented;
+    }
+
     virtual bool onGetValidSubset(SkIRect* /* desiredSubset */) const {
         // By default, subsets are not supported.
         return false;
@@ -233,6 +382,20 @@ protected:
 
     virtual bool onReallyHasAlpha() const { return false; }
 
+    /**
+     *  Subclasses that decode more than one frame override both of these. onGetPixels is then
+     *  asked for Options::fFrameIndex; if that frame has a required frame, the pixels already
+     *  hold it, and the subclass disposes of it and draws the frame on top.
+     */
+    virtual int onGetFrameCount() { return 1; }
+
+    virtual bool onGetFrameInfo(int index, FrameInfo* info) {
+        SkASSERT(0 == index);
+        info->fRequiredFrame = kNone;
+        info->fDuration = 0;
+        return true;
+    }
+
     enum RewindState {
         kRewound_RewindState,
         kNoRewindNecessary_RewindState,
@@ -262,8 +425,15 @@ protected:
     }
 
 private:
+    /**
+     *  Decode a frame other than the first, along with the frames it is drawn on top of.
+     */
+    Result getFramePixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor[], int*);
+
     const SkImageInfo       fInfo;
     SkAutoTDelete<SkStream> fStream;
     bool                    fNeedsRewind;
+    bool                    fIncrementalDecodeStarted;
+    const uint32_t          fUniqueID;  // Keys this codec's frames in SkCodecFrameCache.
 };
 #endif // SkCodec_DEFINED
@@ -23,8 +23,27 @@ public:
 
 class SK_API SkRTreeFactory : public SkBBHFactory {
 public:
+    /**
+     *  How the R-Tree groups bounds into nodes when it is built.
+     *
+     *  kSTR_BulkLoad keeps the bounds in recording order, which is cheap and
+     *  works well when content is drawn roughly top to bottom.
+     *
+     *  kHilbert_BulkLoad sorts the bounds by the position of their centers on
+     *  a Hilbert curve first.  Building and searching cost a sort each, but
+     *  nodes are tighter when recording order does not follow position.
+     */
+    enum BulkLoad {
+        kSTR_BulkLoad,
+        kHilbert_BulkLoad,
+    };
+
+    explicit SkRTreeFactory(BulkLoad bulkLoad = kSTR_BulkLoad) : fBulkLoad(bulkLoad) {}
+
     SkBBoxHierarchy* operator()(const SkRect& bounds) const override;
 private:
+    BulkLoad fBulkLoad;
+
     typedef SkBBHFactory INHERITED;
 };
 
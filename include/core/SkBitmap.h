@@ -91,9 +91,10 @@ public:
 
     /**
      *  Return the shift amount per pixel (i.e. 0 for 1-byte per pixel, 1 for 2-bytes per pixel
-     *  colortypes, 2 for 4-bytes per pixel colortypes). Return 0 for kUnknown_SkColorType.
+     *  colortypes, 2 for 4-bytes per pixel colortypes, 3 for 8-bytes per pixel colortypes).
+     *  Return 0 for kUnknown_SkColorType.
      */
-    int shiftPerPixel() const { return this->bytesPerPixel() >> 1; }
+    int shiftPerPixel() const { return fInfo.shiftPerPixel(); }
 
     ///////////////////////////////////////////////////////////////////////////
 
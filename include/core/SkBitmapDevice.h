@@ -119,6 +119,8 @@ protected:
                               const SkColor colors[], SkXfermode* xmode,
                               const uint16_t indices[], int indexCount,
                               const SkPaint& paint) override;
+    void drawAtlas(const SkDraw&, const SkImage* atlas, const SkRSXform[], const SkRect[],
+                   const SkColor[], int count, SkXfermode::Mode, const SkPaint&) override;
     virtual void drawDevice(const SkDraw&, SkBaseDevice*, int x, int y, const SkPaint&) override;
 
     ///////////////////////////////////////////////////////////////////////////
@@ -164,7 +166,19 @@ private:
 
     SkImageFilter::Cache* getImageFilterCache() override;
 
+    // Damage tracking, used by SkSurface_Raster when SkSurfaceProps::kTrackDamage_Flag is set.
+    // The damage is the device-space bounds of every draw since the last resetDamage(), clipped.
+    bool isTrackingDamage() const { return this->surfaceProps().isTrackDamage(); }
+    const SkIRect& getDamage() const { return fDamage; }
+    void resetDamage() { fDamage.setEmpty(); }
+    // Adds the bounds of drawing localBounds with paint under draw's matrix and clip.
+    void addDrawDamage(const SkDraw&, const SkRect& localBounds, const SkPaint&,
+                       SkScalar devOutset = 0);
+    // Adds devBounds, clipped to the device.
+    void addDamage(const SkIRect& devBounds);
+
     SkBitmap    fBitmap;
+    SkIRect     fDamage;
 
     void setNewSize(const SkISize&);  // Used by SkCanvas for resetForNextPicture().
 
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCacheStats_DEFINED
+#define SkCacheStats_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  A snapshot of one of Skia's caches, as reported by SkGraphics::VisitCacheStats() and
+ *  GrContext::visitCacheStats().
+ *
+ *  fHits, fMisses and fEvictions count up from when the cache was created, so rates come from
+ *  comparing two snapshots. fEvictions only counts entries purged to stay within a budget (or
+ *  by an explicit purge), not entries dropped because what they cached went away.
+ */
+struct SK_API SkCacheStats {
+    const char* fName;          // e.g. "bitmap" or "glyph"; a static string
+    uint64_t    fHits;
+    uint64_t    fMisses;
+    uint64_t    fEvictions;
+    size_t      fBytes;
+    int         fEntries;
+
+    typedef void (*Visitor)(const SkCacheStats&, void* context);
+};
+
+#endif
@@ -1434,6 +1434,12 @@ private:
     void internalDrawPaint(const SkPaint& paint);
     void internalSaveLayer(const SkRect* bounds, const SkPaint*, SaveFlags, SaveLayerStrategy);
     void internalDrawDevice(SkBaseDevice*, int x, int y, const SkPaint*, bool isBitmapDevice);
+    // Draws the paint's image filter applied to src, which sits at pos on device, as a shaded
+    // rect if the filter supports that (see SkImageFilter::filterImageAsShader()). Returns false
+    // if the caller must filterImage() and draw the result as a sprite instead.
+    static bool DrawImageFilterAsShader(const SkDraw&, SkBaseDevice*, const SkBitmap& src,
+                                        const SkIPoint& pos, const SkMatrix& filterMatrix,
+                                        const SkIRect& clipBounds, const SkPaint&);
 
     // shared by save() and saveLayer()
     void internalSave();
@@ -202,6 +202,9 @@ public:
         // When element is applied to the previous elements in the stack is the result known to be
         // equivalent to a single rect intersection? IIOW, is the clip effectively a rectangle.
         bool                    fIsIntersectionOfRects;
+        // If fIsIntersectionOfRects, the intersection of the rects themselves, unrounded, so that
+        // quickContains() needn't walk the stack.
+        SkRect                  fRectsIntersection;
 
         int                     fGenID;
 
@@ -231,6 +234,7 @@ public:
             fFiniteBoundType = kInsideOut_BoundsType;
             fFiniteBound.setEmpty();
             fIsIntersectionOfRects = false;
+            fRectsIntersection.setEmpty();
             fGenID = kInvalidGenID;
         }
 
@@ -464,6 +468,11 @@ private:
      */
     void pushElement(const Element& element);
 
+    /**
+     * Returns true if intersecting element with the clip that ends in prior wouldn't change it.
+     */
+    bool isRedundant(const Element& prior, const Element& element) const;
+
     /**
      * Restore the stack back to the specified save count.
      */
@@ -61,6 +61,17 @@ public:
     static SkDocument* CreatePDF(const char outputFilePath[],
                                  SkScalar dpi = SK_ScalarDefaultRasterDPI);
 
+    /**
+     *  Create a PDF-backed document like CreatePDF(), but write each page to
+     *  the stream as soon as endPage() is called, instead of holding every
+     *  page in memory until close().  Use this for documents with many
+     *  pages.  Resources shared between pages, such as images, are still
+     *  written only once, and fonts are written by close() so that they can
+     *  be subset to the glyphs used by the whole document.
+     */
+    static SkDocument* CreateStreamingPDF(SkWStream*,
+                                          SkScalar dpi = SK_ScalarDefaultRasterDPI);
+
     /**
      *  Create a XPS-backed document, writing the results into the stream.
      *  Returns NULL if XPS is not supported.
@@ -15,7 +15,9 @@
 #include "SkPaint.h"
 
 class SkBitmap;
+class SkCachedData;
 class SkClipStack;
+class SkImage;
 class SkBaseDevice;
 class SkBlitter;
 class SkMatrix;
@@ -23,6 +25,7 @@ class SkPath;
 class SkRegion;
 class SkRasterClip;
 struct SkDrawProcs;
+struct SkRSXform;
 struct SkRect;
 class SkRRect;
 
@@ -73,6 +76,12 @@ public:
                          const SkColor colors[], SkXfermode* xmode,
                          const uint16_t indices[], int ptCount,
                          const SkPaint& paint) const;
+    /**
+     *  Draws each tex[] rect of the atlas, clamped, through its xform. The paint must not have a
+     *  shader, mask filter, path effect or rasterizer; per-sprite colors are not supported.
+     */
+    void    drawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect tex[],
+                      int count, const SkPaint& paint) const;
 
     /**
      *  Overwrite the target with the path's coverage (i.e. its mask).
@@ -95,6 +104,17 @@ public:
                            SkMask* mask, SkMask::CreateMode mode,
                            SkPaint::Style style);
 
+    /** Helper function that creates a mask from a path and filters it with the maskfilter.
+        When the filter is a blur and srcGenID names the path devPath was mapped from by
+        srcToDev, whole masks are shared through SkMaskCache, with the translation snapped to a
+        quarter pixel. On success, *data is either a ref to the cached pixels, which dst points
+        into, or NULL if the caller must free dst's image.
+    */
+    static bool DrawToFilteredMask(const SkPath& devPath, uint32_t srcGenID,
+                                   const SkMatrix& srcToDev, const SkIRect& clipBounds,
+                                   const SkMaskFilter*, const SkMatrix& filterMatrix,
+                                   SkMask* dst, SkCachedData** data, SkPaint::Style style);
+
     enum RectType {
         kHair_RectType,
         kFill_RectType,
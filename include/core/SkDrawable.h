@@ -8,9 +8,12 @@
 #ifndef SkDrawable_DEFINED
 #define SkDrawable_DEFINED
 
+#include "SkMatrix.h"
 #include "SkRefCnt.h"
 
+class GrContext;
 class SkCanvas;
+class SkImage;
 class SkPicture;
 struct SkRect;
 
@@ -24,6 +27,7 @@ struct SkRect;
 class SkDrawable : public SkRefCnt {
 public:
     SkDrawable();
+    virtual ~SkDrawable();
 
     /**
      *  Draws into the specified content. The drawing sequence will be balanced upon return
@@ -58,6 +62,19 @@ public:
      */
     void notifyDrawingChanged();
 
+    /**
+     *  Opt in (or out) of snapshot caching. When enabled, draw() renders onDraw() once into an
+     *  image sized for the canvas' current scale/rotation (on the GPU when the canvas is GPU
+     *  backed), and then just draws that image, snapped to whole device pixels, until the
+     *  generation ID or the scale/rotation changes. Perspective matrices, and canvases that cannot
+     *  make a compatible surface (e.g. picture recorders), always call onDraw().
+     *
+     *  Only enable this for drawables whose content is static between notifyDrawingChanged()
+     *  calls. Disabled by default.
+     */
+    void setCachesSnapshot(bool);
+    bool cachesSnapshot() const { return fCachesSnapshot; }
+
 protected:
     virtual SkRect onGetBounds() = 0;
     virtual void onDraw(SkCanvas*) = 0;
@@ -71,7 +88,18 @@ protected:
     virtual SkPicture* onNewPictureSnapshot();
 
 private:
+    // Draws the cached snapshot (refreshing it if needed). Returns false if the caller should
+    // call onDraw() instead.
+    bool drawSnapshot(SkCanvas*);
+
     int32_t fGenerationID;
+
+    bool                    fCachesSnapshot;
+    SkAutoTUnref<SkImage>   fSnapshot;
+    uint32_t                fSnapshotGenID;
+    SkMatrix                fSnapshotMatrix;   // The CTM it was rendered with, minus translation.
+    SkIPoint                fSnapshotOrigin;   // Where its top-left lands, relative to translation.
+    GrContext*              fSnapshotContext;  // Only compared, never dereferenced.
 };
 
 #endif
@@ -8,7 +8,7 @@
 #ifndef SkGraphics_DEFINED
 #define SkGraphics_DEFINED
 
-#include "SkTypes.h"
+#include "SkCacheStats.h"
 
 class SkData;
 class SkImageGenerator;
@@ -22,6 +22,18 @@ public:
      */
     static void Init();
 
+    /**
+     *  Optionally call this right after Init() to start Skia's expensive one-time setup on a
+     *  background thread: creating the default font manager (which may scan the system's fonts),
+     *  resolving the default typeface, and registering the flattenable factories. Each of these
+     *  otherwise happens lazily on first use, and their initializers are thread-safe, so a caller
+     *  that needs one before the warm-up gets to it just waits for (or does) that piece itself.
+     *
+     *  WarmUp() returns immediately, and calling it again is harmless. Term() waits for any
+     *  warm-up still in progress.
+     */
+    static void WarmUp();
+
     /**
      *  Call this to release any memory held privately, such as the font cache.
      */
@@ -80,6 +92,13 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  Purges the least recently used strikes from the font cache until at most fraction (0..1)
+     *  of its memory is left, e.g. 0.5 to shed the colder half under memory pressure. Does not
+     *  change the limit.
+     */
+    static void PurgeFontCacheToFraction(float fraction);
+
     /**
      *  Scaling bitmaps with the kHigh_SkFilterQuality setting is
      *  expensive, so the result is saved in the global Scaled Image
@@ -89,6 +108,13 @@ public:
      */
     static size_t GetResourceCacheTotalBytesUsed();
 
+    /**
+     *  Returns the most memory the resource cache has used at once since startup or since the
+     *  last ResetResourceCachePeakBytesUsed(), which starts tracking again from the current usage.
+     */
+    static size_t GetResourceCachePeakBytesUsed();
+    static void ResetResourceCachePeakBytesUsed();
+
     /**
      *  These functions get/set the memory usage limit for the resource cache, used for temporary
      *  bitmaps and other resources. Entries are purged from the cache when the memory useage
@@ -103,6 +129,19 @@ public:
      */
     static void PurgeResourceCache();
 
+    /**
+     *  Purges the least recently used entries from the resource cache until at most fraction
+     *  (0..1) of its memory is left. Does not change the limit.
+     */
+    static void PurgeResourceCacheToFraction(float fraction);
+
+    /**
+     *  Calls PurgeFontCacheToFraction() and PurgeResourceCacheToFraction(), to shed the least
+     *  recently used part of the global CPU caches when memory runs low, rather than everything.
+     *  See GrContext::purgeResourcesToFraction() for a context's GPU caches.
+     */
+    static void PurgeToFraction(float fraction);
+
     /**
      *  When the cachable entry is very lage (e.g. a large scaled bitmap), adding it to the cache
      *  can cause most/all of the existing entries to be purged. To avoid the, the client can set
@@ -114,6 +153,14 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  Calls visitor once for each of the global CPU caches: one entry per kind of resource
+     *  cache entry (e.g. "bitmap", "mipmap", "mask", "yuv"), then "glyph" for the font cache's
+     *  strikes and "typeface" for the typeface cache. GPU caches are reported by
+     *  GrContext::visitCacheStats().
+     */
+    static void VisitCacheStats(SkCacheStats::Visitor visitor, void* context);
+
     /**
      *  Applications with command line options may pass optional state, such
      *  as cache sizes, here, for instance:
@@ -127,8 +174,9 @@ public:
     /**
      *  Return the max number of bytes that should be used by the thread-local
      *  font cache.
-     *  If the cache needs to allocate more, it will purge previous entries.
-     *  This max can be changed by calling SetFontCacheLimit().
+     *  If the cache needs to allocate more, it hands its least recently used
+     *  entries back to the shared font cache.
+     *  This max can be changed by calling SetTLSFontCacheLimit().
      *
      *  If this thread has never called SetTLSFontCacheLimit, or has called it
      *  with 0, then this thread is using the shared font cache. In that case,
@@ -76,6 +76,16 @@ public:
      */
     static SkImage* NewFromGenerator(SkImageGenerator*, const SkIRect* subset = NULL);
 
+    /**
+     *  Decode the generator's pixels now, into memory from the allocator (or the heap, if it is
+     *  NULL), and return an image that wraps that memory without copying it. The allocator may
+     *  hand out memory it owns, with any rowBytes; the image keeps that pixel ref alive. Unlike
+     *  NewFromGenerator(), the pixels are not held in the discardable cache and decoded lazily.
+     *  This function will always take ownership of the passed ImageGenerator. Returns NULL on
+     *  error.
+     */
+    static SkImage* NewRasterFromGenerator(SkImageGenerator*, SkBitmap::Allocator* = NULL);
+
     /**
      *  Construct a new SkImage based on the specified encoded data. Returns NULL on failure,
      *  which can mean that the format of the encoded data was not recognized/supported.
@@ -13,6 +13,7 @@
 
 class SkBitmap;
 class SkData;
+class SkPixmap;
 class SkWStream;
 
 class SkImageEncoder {
@@ -60,6 +61,31 @@ public:
      */
     bool encodeStream(SkWStream* stream, const SkBitmap& bm, int quality);
 
+    /**
+     *  Supplies the rows of an image to encodeRows() in bands, top to bottom, so the whole image
+     *  need never be in memory at once, and later bands can still be drawing while earlier ones
+     *  are encoded.
+     */
+    class RowSource {
+    public:
+        virtual ~RowSource() {}
+
+        /**
+         *  Set band to one or more rows starting at row y, with the width, color type and alpha
+         *  type passed to encodeRows() (and, for kIndex_8, the same color table every time).
+         *  The pixels need only stay valid until the next call.  Return false to fail the encode.
+         */
+        virtual bool nextBand(int y, SkPixmap* band) = 0;
+    };
+
+    /**
+     *  Encode an image described by info, pulling its rows from source, writing results to
+     *  stream 'stream', at quality level 'quality' (which can be in range 0-100).  PNG and JPEG
+     *  hold only a row of converted pixels at a time; other formats gather the whole image
+     *  first.  Returns false on failure.
+     */
+    bool encodeRows(SkWStream* stream, const SkImageInfo& info, RowSource* source, int quality);
+
     static SkData* EncodeData(const SkImageInfo&, const void* pixels, size_t rowBytes,
                               Type, int quality);
     static SkData* EncodeData(const SkBitmap&, Type, int quality);
@@ -78,6 +104,13 @@ protected:
      * This must be overridden by each SkImageEncoder implementation.
      */
     virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) = 0;
+
+    /**
+     * Encode the rows pulled from source.  The default copies every row into one bitmap and
+     * calls onEncode(); encoders that can write a row at a time should override this.
+     */
+    virtual bool onEncodeRows(SkWStream* stream, const SkImageInfo& info, RowSource* source,
+                              int quality);
 };
 
 // This macro declares a global (i.e., non-class owned) creation entry point
@@ -21,6 +21,7 @@ class GrTexture;
 class SkBaseDevice;
 class SkBitmap;
 class SkColorFilter;
+class SkShader;
 struct SkIPoint;
 
 /**
@@ -37,12 +38,35 @@ public:
     class Cache : public SkRefCnt {
     public:
         struct Key;
+
+        // How filters are identified in keys. By default each filter object is its own entry.
+        // kContent_KeyMode identifies a filter by its flattened graph instead, so an identical
+        // chain re-created for the next frame finds the last frame's results.
+        enum KeyMode {
+            kUniqueID_KeyMode,
+            kContent_KeyMode,
+        };
+
+        struct Stats {
+            int    fHits;
+            int    fMisses;
+            int    fCount;
+            size_t fBytes;
+        };
+
         virtual ~Cache() {}
         static Cache* Create(size_t maxBytes);
         static Cache* Get();
         virtual bool get(const Key& key, SkBitmap* result, SkIPoint* offset) const = 0;
         virtual void set(const Key& key, const SkBitmap& result, const SkIPoint& offset) = 0;
         virtual void purge() {}
+
+        virtual KeyMode keyMode() const { return kUniqueID_KeyMode; }
+        virtual void setKeyMode(KeyMode) {}
+
+        // Hits and misses are counted since creation or the last resetStats().
+        virtual void getStats(Stats* stats) const { sk_bzero(stats, sizeof(Stats)); }
+        virtual void resetStats() {}
     };
 
     class Context {
@@ -126,6 +150,31 @@ public:
     bool filterImage(Proxy*, const SkBitmap& src, const Context&,
                      SkBitmap* result, SkIPoint* offset) const;
 
+    /**
+     *  Like filterImage(), but evaluates the whole filter graph one output tile at a time, in
+     *  parallel, so that intermediate images are only tile sized. Each tile asks the graph for
+     *  its bounds outset by the filter's reach, as reported by filterBounds(), and keeps just
+     *  the tile. Tiles are sized so that one tile's images take about tileBudget bytes.
+     *
+     *  The result is always N32. Falls back to filterImage() when the output fits in one
+     *  tile or a tile can't be produced on the CPU. Filters whose reach depends on position,
+     *  like non-translating matrix filters, don't tile correctly.
+     */
+    bool filterImageTiled(Proxy*, const SkBitmap& src, const Context&, size_t tileBudget,
+                          SkBitmap* result, SkIPoint* offset) const;
+
+    /**
+     *  Returns true if the result of filterImage() can instead be drawn by filling dstRect (in
+     *  the same space as filterImage()'s offset) with the returned ref'd shader, so the caller
+     *  never allocates the full-size result. The canvas asks this of the last filter in a chain
+     *  when it applies a layer or sprite's filter; inputs are still evaluated with filterImage().
+     *  If this returns false, shader and dstRect are unchanged.
+     */
+    bool filterImageAsShader(Proxy* proxy, const SkBitmap& src, const Context& ctx,
+                             SkShader** shader, SkRect* dstRect) const {
+        return this->onFilterImageAsShader(proxy, src, ctx, shader, dstRect);
+    }
+
     /**
      *  Given the src bounds of an image, this returns the bounds of the result
      *  image after the filter has been applied.
@@ -316,6 +365,13 @@ protected:
     // no inputs.
     virtual bool onFilterBounds(const SkIRect&, const SkMatrix&, SkIRect*) const;
 
+    // Subclasses whose result is just a shader filling a rect may override this to skip
+    // allocating that result; see filterImageAsShader(). The default returns false.
+    virtual bool onFilterImageAsShader(Proxy*, const SkBitmap& /*src*/, const Context&,
+                                       SkShader** /*shader*/, SkRect* /*dstRect*/) const {
+        return false;
+    }
+
     /**
      *  Return true (and return a ref'd colorfilter) if this node in the DAG is just a
      *  colorfilter w/o CropRect constraints.
@@ -368,12 +424,19 @@ private:
 
     bool usesSrcInput() const { return fUsesSrcInput; }
 
+    // An ID shared by every filter whose flattened graph is the same as this one's.
+    uint32_t contentID() const;
+
+    // The key under which this filter's result for src and the given context is cached.
+    Cache::Key cacheKey(const SkBitmap& src, const Context&) const;
+
     typedef SkFlattenable INHERITED;
     int fInputCount;
     SkImageFilter** fInputs;
     bool fUsesSrcInput;
     CropRect fCropRect;
     uint32_t fUniqueID; // Globally unique
+    mutable uint32_t fContentID; // Lazily computed, 0 until then
 };
 
 /**
@@ -8,10 +8,10 @@
 #ifndef SkImageGenerator_DEFINED
 #define SkImageGenerator_DEFINED
 
+#include "SkBitmap.h"
 #include "SkColor.h"
 #include "SkImageInfo.h"
 
-class SkBitmap;
 class SkData;
 class SkImageGenerator;
 class SkMatrix;
@@ -108,6 +108,29 @@ public:
      */
     bool getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes);
 
+    /**
+     *  Allocate the bitmap's pixels with allocator (or from the heap, if it is NULL) and decode
+     *  into them. The allocator may place the pixels in memory it owns, with any rowBytes, so a
+     *  decode can land directly in e.g. a buffer pool. If info is NULL, getInfo() is used.
+     *  kIndex8_SkColorType is not supported.
+     *
+     *  On success the bitmap is marked immutable, so SkImage::NewFromBitmap() shares its pixels
+     *  rather than copying them. On failure the bitmap is reset.
+     */
+    bool tryGenerateBitmap(SkBitmap* bitmap, const SkImageInfo* info = NULL,
+                           SkBitmap::Allocator* allocator = NULL);
+
+    /**
+     *  Returns the smallest size this generator can decode to directly (e.g. using JPEG DCT
+     *  scaling) that is no smaller than getInfo()'s dimensions scaled by desiredScale
+     *  (0 < desiredScale < 1).  getPixels() will then accept an info with those dimensions.
+     *
+     *  Returns getInfo()'s dimensions if the generator can't decode to a smaller size.
+     */
+    SkISize getScaledDimensions(SkScalar desiredScale) {
+        return this->onGetScaledDimensions(desiredScale);
+    }
+
     /**
      *  If planes or rowBytes is NULL or if any entry in planes is NULL or if any entry in rowBytes
      *  is 0, this imagegenerator should output the sizes and return true if it can efficiently
@@ -147,6 +170,7 @@ protected:
     virtual bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3]);
     virtual bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
                                  SkYUVColorSpace* colorSpace);
+    virtual SkISize onGetScaledDimensions(SkScalar desiredScale);
 
 private:
     const SkImageInfo fInfo;
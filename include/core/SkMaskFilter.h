@@ -215,10 +215,12 @@ private:
     /** Helper method that, given a path in device space, will rasterize it into a kA8_Format mask
      and then call filterMask(). If this returns true, the specified blitter will be called
      to render that mask. Returns false if filterMask() returned false.
+     If srcGenID is not 0, it names the path that srcToDev mapped to devPath, and the mask may
+     come from or be added to SkMaskCache.
      This method is not exported to java.
      */
     bool filterPath(const SkPath& devPath, const SkMatrix& ctm, const SkRasterClip&, SkBlitter*,
-                    SkPaint::Style) const;
+                    SkPaint::Style, uint32_t srcGenID, const SkMatrix& srcToDev) const;
 
     /** Helper method that, given a roundRect in device space, will rasterize it into a kA8_Format
      mask and then call filterMask(). If this returns true, the specified blitter will be called
@@ -471,7 +471,7 @@ public:
       The shader's reference count is not affected.
         @return the paint's shader (or NULL)
     */
-    SkShader* getShader() const { return fShader; }
+    SkShader* getShader() const { return fEffects ? fEffects->fShader : NULL; }
 
     /** Set or clear the shader object.
      *  Shaders specify the source color(s) for what is being drawn. If a paint
@@ -500,7 +500,7 @@ public:
         count is not changed.
         @return the paint's colorfilter (or NULL)
     */
-    SkColorFilter* getColorFilter() const { return fColorFilter; }
+    SkColorFilter* getColorFilter() const { return fEffects ? fEffects->fColorFilter : NULL; }
 
     /** Set or clear the paint's colorfilter, returning the parameter.
         <p />
@@ -516,7 +516,7 @@ public:
       The xfermode's reference count is not affected.
         @return the paint's xfermode (or NULL)
     */
-    SkXfermode* getXfermode() const { return fXfermode; }
+    SkXfermode* getXfermode() const { return fEffects ? fEffects->fXfermode : NULL; }
 
     /** Set or clear the xfermode object.
         <p />
@@ -541,7 +541,7 @@ public:
       The patheffect reference count is not affected.
         @return the paint's patheffect (or NULL)
     */
-    SkPathEffect* getPathEffect() const { return fPathEffect; }
+    SkPathEffect* getPathEffect() const { return fEffects ? fEffects->fPathEffect : NULL; }
 
     /** Set or clear the patheffect object.
         <p />
@@ -560,7 +560,7 @@ public:
       The maskfilter reference count is not affected.
         @return the paint's maskfilter (or NULL)
     */
-    SkMaskFilter* getMaskFilter() const { return fMaskFilter; }
+    SkMaskFilter* getMaskFilter() const { return fEffects ? fEffects->fMaskFilter : NULL; }
 
     /** Set or clear the maskfilter object.
         <p />
@@ -582,7 +582,7 @@ public:
         measuring text. The typeface reference count is not affected.
         @return the paint's typeface (or NULL)
     */
-    SkTypeface* getTypeface() const { return fTypeface; }
+    SkTypeface* getTypeface() const { return fEffects ? fEffects->fTypeface : NULL; }
 
     /** Set or clear the typeface object.
         <p />
@@ -601,7 +601,7 @@ public:
         The raster controls how paths/text are turned into alpha masks.
         @return the paint's rasterizer (or NULL)
     */
-    SkRasterizer* getRasterizer() const { return fRasterizer; }
+    SkRasterizer* getRasterizer() const { return fEffects ? fEffects->fRasterizer : NULL; }
 
     /** Set or clear the rasterizer object.
         <p />
@@ -616,10 +616,10 @@ public:
     */
     SkRasterizer* setRasterizer(SkRasterizer* rasterizer);
 
-    SkImageFilter* getImageFilter() const { return fImageFilter; }
+    SkImageFilter* getImageFilter() const { return fEffects ? fEffects->fImageFilter : NULL; }
     SkImageFilter* setImageFilter(SkImageFilter*);
 
-    SkAnnotation* getAnnotation() const { return fAnnotation; }
+    SkAnnotation* getAnnotation() const { return fEffects ? fEffects->fAnnotation : NULL; }
     SkAnnotation* setAnnotation(SkAnnotation*);
 
     /**
@@ -633,7 +633,7 @@ public:
      *  Return the paint's SkDrawLooper (if any). Does not affect the looper's
      *  reference count.
      */
-    SkDrawLooper* getLooper() const { return fLooper; }
+    SkDrawLooper* getLooper() const { return fEffects ? fEffects->fLooper : NULL; }
 
     /**
      *  Set or clear the looper object.
@@ -982,16 +982,32 @@ public:
     SK_TO_STRING_NONVIRT()
 
 private:
-    SkTypeface*     fTypeface;
-    SkPathEffect*   fPathEffect;
-    SkShader*       fShader;
-    SkXfermode*     fXfermode;
-    SkMaskFilter*   fMaskFilter;
-    SkColorFilter*  fColorFilter;
-    SkRasterizer*   fRasterizer;
-    SkDrawLooper*   fLooper;
-    SkImageFilter*  fImageFilter;
-    SkAnnotation*   fAnnotation;
+    /**
+     *  The effect objects live together in one immutable-once-shared block. Copies of a paint
+     *  share it, so copying a paint costs a single ref, and a setter clones it first if it is
+     *  shared (copy-on-write). Each Effects owns a ref on each non-NULL effect.
+     */
+    struct Effects : public SkNVRefCnt<Effects> {
+        Effects();
+        ~Effects();
+
+        // Returns a new, unshared copy (ref'ing each effect).
+        Effects* clone() const;
+
+        SkTypeface*     fTypeface;
+        SkPathEffect*   fPathEffect;
+        SkShader*       fShader;
+        SkXfermode*     fXfermode;
+        SkMaskFilter*   fMaskFilter;
+        SkColorFilter*  fColorFilter;
+        SkRasterizer*   fRasterizer;
+        SkDrawLooper*   fLooper;
+        SkImageFilter*  fImageFilter;
+        SkAnnotation*   fAnnotation;
+    };
+
+    // NULL until an effect is first set.
+    Effects*        fEffects;
 
     SkScalar        fTextSize;
     SkScalar        fTextScaleX;
@@ -1015,6 +1031,11 @@ private:
         uint32_t fBitfieldsUInt;
     };
 
+    // Returns fEffects, first cloning it if it is shared (or creating it if there is none).
+    Effects* writableEffects();
+
+    template <typename T> T* setEffect(T* Effects::* field, T* value);
+
     SkDrawCacheProc    getDrawCacheProc() const;
     SkMeasureCacheProc getMeasureCacheProc(bool needFullMetrics) const;
 
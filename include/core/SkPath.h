@@ -97,8 +97,9 @@ public:
      *  then this function will attempt to compute the convexity (and cache the result).
      */
     Convexity getConvexity() const {
-        if (kUnknown_Convexity != fConvexity) {
-            return static_cast<Convexity>(fConvexity);
+        Convexity convexity = this->getConvexityOrUnknown();
+        if (kUnknown_Convexity != convexity) {
+            return convexity;
         } else {
             return this->internalGetConvexity();
         }
@@ -110,7 +111,9 @@ public:
      *  ComputeConvexity and cache its return value if the current setting is
      *  kUnknown.
      */
-    Convexity getConvexityOrUnknown() const { return (Convexity)fConvexity; }
+    Convexity getConvexityOrUnknown() const {
+        return (Convexity)sk_atomic_load(&fConvexity, sk_memory_order_relaxed);
+    }
 
     /**
      *  Store a convexity setting in the path. There is no automatic check to
@@ -979,6 +982,7 @@ private:
     inline bool hasOnlyMoveTos() const;
 
     Convexity internalGetConvexity() const;
+    Convexity publishConvexity(Convexity) const;
 
     bool isRectContour(bool allowPartial, int* currVerb, const SkPoint** pts,
                        bool* isClosed, Direction* direction) const;
@@ -144,8 +144,58 @@ public:
     static bool InternalOnly_StreamIsSKP(SkStream*, SkPictInfo*);
     static bool InternalOnly_BufferIsSKP(SkReadBuffer*, SkPictInfo*);
 
+    /**
+     *  Counts of the recorded features that make drawing cost more on the GPU than in raster,
+     *  including those of nested pictures.
+     */
+    struct GpuCostFeatures {
+        int   fConcaveAAPaths;      // AA concave paths not drawn as hairlines or distance fields.
+        int   fPathEffects;         // Paints with path effects, other than simple dashed lines.
+        int   fMaskFilters;         // Paints with mask filters.
+        float fConcaveAAPathArea;   // Summed local bounds area of fConcaveAAPaths.
+
+        GpuCostFeatures()
+            : fConcaveAAPaths(0), fPathEffects(0), fMaskFilters(0), fConcaveAAPathArea(0) {}
+
+        GpuCostFeatures& operator+=(const GpuCostFeatures& that) {
+            fConcaveAAPaths    += that.fConcaveAAPaths;
+            fPathEffects       += that.fPathEffects;
+            fMaskFilters       += that.fMaskFilters;
+            fConcaveAAPathArea += that.fConcaveAAPathArea;
+            return *this;
+        }
+    };
+
+    /**
+     *  Tunable weights for estimateGpuCostPenalty().  Each is the extra cost, in arbitrary units,
+     *  of drawing one instance of the matching feature on the GPU instead of in raster.  The
+     *  defaults reproduce the long-standing rule of vetoing more than five slow paths.
+     */
+    struct GpuCostModel {
+        GpuCostModel()
+            : fConcaveAAPath(1)
+            , fPathEffect(1)
+            , fMaskFilter(0)
+            , fConcaveAAPathMegapixel(0)
+            , fBudget(5) {}
+
+        float fConcaveAAPath;
+        float fPathEffect;
+        float fMaskFilter;
+        float fConcaveAAPathMegapixel;  // Per million units of fConcaveAAPathArea.
+        float fBudget;                  // Penalties above this veto GPU rasterization.
+    };
+
+    /** Return the counts of this picture's ops that are slow to draw on the GPU. */
+    virtual GpuCostFeatures gpuCostFeatures() const = 0;
+
+    /** Return the extra cost of drawing this picture on the GPU rather than in raster. */
+    float estimateGpuCostPenalty(const GpuCostModel& = GpuCostModel()) const;
+
     /** Return true if the picture is suitable for rendering on the GPU.  */
     bool suitableForGpuRasterization(GrContext*, const char** whyNot = NULL) const;
+    bool suitableForGpuRasterization(GrContext*, const GpuCostModel&,
+                                     const char** whyNot = NULL) const;
 
     // Sent via SkMessageBus from destructor.
     struct DeletionMessage { int32_t fUniqueID; };  // TODO: -> uint32_t?
@@ -164,9 +214,6 @@ private:
     friend class SkEmptyPicture;
     template <typename> friend class SkMiniPicture;
 
-    virtual int numSlowPaths() const = 0;
-    friend struct SkPathCounter;
-
     // V35: Store SkRect (rather then width & height) in header
     // V36: Remove (obsolete) alphatype from SkColorTable
     // V37: Added shadow only option to SkDropShadowImageFilter (last version to record CLEAR)
@@ -176,10 +223,12 @@ private:
     // V41: Added serialization of SkBitmapSource's filterQuality parameter
     // V42: Added a bool to SkPictureShader serialization to indicate did-we-serialize-a-picture?
     // V43: Added DRAW_IMAGE and DRAW_IMAGE_RECT opt codes to serialized data
+    // V44: Pad streams so op data and the buffer section start 4-byte aligned
+    // V45: Serialize SkRecord ops directly, in a RECORD tag inside the buffer section
 
     // Only SKPs within the min/current picture version range (inclusive) can be read.
     static const uint32_t     MIN_PICTURE_VERSION = 35;     // Produced by Chrome M39.
-    static const uint32_t CURRENT_PICTURE_VERSION = 43;
+    static const uint32_t CURRENT_PICTURE_VERSION = 45;
 
     static_assert(MIN_PICTURE_VERSION <= 41,
                   "Remove kFontFileName and related code from SkFontDescriptor.cpp.");
@@ -191,7 +240,6 @@ private:
     static SkPicture* Forwardport(const SkPictInfo&, const SkPictureData*);
 
     SkPictInfo createHeader() const;
-    SkPictureData* backport() const;
 
     mutable uint32_t fUniqueID;
 };
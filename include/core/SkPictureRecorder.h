@@ -12,6 +12,7 @@
 #include "SkBBHFactory.h"
 #include "SkPicture.h"
 #include "SkRefCnt.h"
+#include "SkTDArray.h"
 
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
 namespace android {
@@ -38,6 +39,12 @@ public:
         // If you call drawPicture() on the recording canvas, this flag forces
         // that to use SkPicture::playback() immediately rather than (e.g.) reffing the picture.
         kPlaybackDrawPicture_RecordFlag  = 0x02,
+
+        // This flag has the recorder keep what it recorded into after it ends the recording, for
+        // the last two recordings. Once the picture or drawable one was ended as has been deleted,
+        // the next recording reuses its storage, rather than allocating new storage for every
+        // recording.
+        kReuseStorage_RecordFlag         = 0x04,
     };
 
     /** Returns the canvas that records the drawing commands.
@@ -102,6 +109,8 @@ public:
 
 private:
     void reset();
+    // Keeps a ref on fRecord as a spare, for kReuseStorage_RecordFlag.
+    void keepSpareRecord();
 
     /** Replay the current (partially recorded) operation stream into
         canvas. This call doesn't close the current recording.
@@ -118,6 +127,7 @@ private:
     SkAutoTUnref<SkBBoxHierarchy> fBBH;
     SkAutoTUnref<SkRecorder>      fRecorder;
     SkAutoTUnref<SkRecord>        fRecord;
+    SkTDArray<SkRecord*>          fSpareRecords;  // a ref on each, for kReuseStorage_RecordFlag
     SkMiniRecorder                fMiniRecorder;
 
     typedef SkNoncopyable INHERITED;
@@ -225,6 +225,24 @@ public:
         return this->onGetYUV8Planes(sizes, planes, rowBytes, colorSpace);
     }
 
+    /**
+     *  Some pixelrefs can generate their pixels at a reduced size more cheaply than generating
+     *  them in full and downsampling (e.g. by decoding a JPEG at a coarser DCT scale).
+     *
+     *  Returns the smallest size this pixelref can generate directly that is no smaller than its
+     *  dimensions scaled by desiredScale (0 < desiredScale < 1), or its own dimensions if it
+     *  can't generate anything smaller.
+     */
+    SkISize getScaledDimensions(SkScalar desiredScale);
+
+    /**
+     *  Generates our pixels, scaled to info's dimensions, into the caller's memory.  info must
+     *  have dimensions returned by getScaledDimensions() and differ from our own.
+     *
+     *  This does not lock our own pixels, and returns false if we can't generate scaled pixels.
+     */
+    bool generateScaledPixels(const SkImageInfo& info, void* pixels, size_t rowBytes);
+
     bool readPixels(SkBitmap* dst, const SkIRect* subset = NULL);
 
     /**
@@ -304,6 +322,12 @@ protected:
     virtual bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
                                  SkYUVColorSpace* colorSpace);
 
+    // default impl returns our own dimensions.  Called inside our mutex.
+    virtual SkISize onGetScaledDimensions(SkScalar desiredScale);
+
+    // default impl returns false.  Called inside our mutex.
+    virtual bool onGenerateScaledPixels(const SkImageInfo&, void* pixels, size_t rowBytes);
+
     /**
      *  Returns the size (in bytes) of the internally allocated memory.
      *  This should be implemented in all serializable SkPixelRef derived classes.
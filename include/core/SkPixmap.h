@@ -73,6 +73,11 @@ public:
     uint64_t getSafeSize64() const { return fInfo.getSafeSize64(fRowBytes); }
     size_t getSafeSize() const { return fInfo.getSafeSize(fRowBytes); }
 
+    const uint64_t* addr64() const {
+        SkASSERT(8 == SkColorTypeBytesPerPixel(fInfo.colorType()));
+        return reinterpret_cast<const uint64_t*>(fPixels);
+    }
+
     const uint32_t* addr32() const {
         SkASSERT(4 == SkColorTypeBytesPerPixel(fInfo.colorType()));
         return reinterpret_cast<const uint32_t*>(fPixels);
@@ -88,6 +93,11 @@ public:
         return reinterpret_cast<const uint8_t*>(fPixels);
     }
 
+    const uint64_t* addr64(int x, int y) const {
+        SkASSERT((unsigned)x < (unsigned)fInfo.width());
+        SkASSERT((unsigned)y < (unsigned)fInfo.height());
+        return (const uint64_t*)((const char*)this->addr64() + y * fRowBytes + (x << 3));
+    }
     const uint32_t* addr32(int x, int y) const {
         SkASSERT((unsigned)x < (unsigned)fInfo.width());
         SkASSERT((unsigned)y < (unsigned)fInfo.height());
@@ -110,6 +120,9 @@ public:
     // Writable versions
 
     void* writable_addr() const { return const_cast<void*>(fPixels); }
+    uint64_t* writable_addr64(int x, int y) const {
+        return const_cast<uint64_t*>(this->addr64(x, y));
+    }
     uint32_t* writable_addr32(int x, int y) const {
         return const_cast<uint32_t*>(this->addr32(x, y));
     }
@@ -120,9 +120,10 @@ public:
     bool setRect(int32_t left, int32_t top, int32_t right, int32_t bottom);
 
     /**
-     *  Set this region to the union of an array of rects. This is generally
-     *  faster than calling region.op(rect, kUnion_Op) in a loop. If count is
-     *  0, then this region is set to the empty region.
+     *  Set this region to the union of an array of rects, built in a single
+     *  top-to-bottom sweep. This is much faster than calling
+     *  region.op(rect, kUnion_Op) in a loop. If count is 0, then this region
+     *  is set to the empty region.
      *  @return true if the resulting region is non-empty
      */
     bool setRects(const SkIRect rects[], int count);
@@ -296,6 +297,17 @@ public:
      */
     bool op(const SkRegion& rgna, const SkRegion& rgnb, Op op);
 
+    /**
+     *  Combine this region with each of an array of rects or regions in turn:
+     *  this = (((this op a[0]) op a[1]) ... op a[count-1]). This is much
+     *  faster than calling op() in a loop when there are many of them: unions,
+     *  intersections and XORs are combined pairwise, differences subtract the
+     *  union of the array, and a union of rects is built with setRects().
+     *  Return true if the resulting region is non-empty.
+     */
+    bool opMany(const SkIRect rects[], int count, Op op);
+    bool opMany(const SkRegion rgns[], int count, Op op);
+
 #ifdef SK_BUILD_FOR_ANDROID
     /** Returns a new char* containing the list of rectangles in this region
      */
@@ -10,6 +10,7 @@
 
 #include "SkRefCnt.h"
 #include "SkScalar.h"
+#include "SkTDArray.h"
 
 class SkData;
 
@@ -428,6 +429,65 @@ private:
     typedef SkWStream INHERITED;
 };
 
+/**
+ *  A stream that keeps what is written to it as a list of SkData segments, so that it can be
+ *  handed on, for example to writev(), without being copied into one contiguous block. Small
+ *  writes are copied into segments of the stream's own, but writeData() appends a segment that
+ *  shares a ref on the data instead.
+ */
+class SK_API SkSegmentedWStream : public SkWStream {
+public:
+    SkSegmentedWStream();
+    virtual ~SkSegmentedWStream();
+
+    bool write(const void* buffer, size_t size) override;
+    size_t bytesWritten() const override { return fBytesWritten; }
+
+    /** Appends data by reference. The data must not change while the stream refers to it. */
+    void writeData(const SkData* data);
+
+    /** The address and size of a segment, in the order a struct iovec has them. */
+    struct Segment {
+        const void* fBase;
+        size_t      fLength;
+    };
+
+    /** Returns the number of segments that getSegments() returns. */
+    int countSegments() const;
+
+    /**
+     *  Fills segments with countSegments() segments, which together hold what has been written
+     *  so far, in order. They stay valid until the stream is written to, reset or deleted.
+     */
+    void getSegments(Segment segments[]) const;
+
+    /**
+     *  Returns what has been written so far as one SkData. This only copies if it's in more than
+     *  one segment. The caller must call unref() when they are finished with the data.
+     */
+    SkData* copyToData() const;
+
+    /**
+     *  Reset, returning a reader stream with the current content, which shares the segments
+     *  rather than copying them.
+     */
+    SkStreamAsset* detachAsStream();
+
+    /** Reset the stream to its original, empty, state. */
+    void reset();
+
+private:
+    // Moves what has been written into fTail since the last segment into a segment of its own.
+    void sealTail();
+
+    SkTDArray<const SkData*> fSegments;   // a ref on each
+    SkData*                  fTail;       // where write() copies to, or NULL
+    size_t                   fTailStart;  // of what is in fTail but not yet in a segment
+    size_t                   fTailUsed;
+    size_t                   fBytesWritten;
+
+    typedef SkWStream INHERITED;
+};
 
 class SK_API SkDebugWStream : public SkWStream {
 public:
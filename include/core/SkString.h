@@ -87,17 +87,17 @@ char*   SkStrAppendS32(char buffer[], int32_t);
 char*   SkStrAppendS64(char buffer[], int64_t, int minDigits);
 
 /**
- *  Floats have at most 8 significant digits, so we limit our %g to that.
- *  However, the total string could be 15 characters: -1.2345678e-005
- *
- *  In theory we should only expect up to 2 digits for the exponent, but on
- *  some platforms we have seen 3 (as in the example above).
+ *  The shortest decimal that reads back as a given float has at most 9
+ *  significant digits, so the total string could be 15 characters:
+ *  -1.23456789e-38
  */
 #define SkStrAppendScalar_MaxSize  15
 
 /**
  *  Write the scaler in decimal format into buffer, and return a pointer to
- *  the next char after the last one written. Note: a terminating 0 is not
+ *  the next char after the last one written. The output is the shortest
+ *  string that reads back as exactly the same float, formatted like printf's
+ *  "%g" but independent of the current locale. Note: a terminating 0 is not
  *  written into buffer, which must be at least SkStrAppendScalar_MaxSize.
  *  Thus if the caller wants to add a 0 at the end, buffer must be at least
  *  SkStrAppendScalar_MaxSize + 1 bytes large.
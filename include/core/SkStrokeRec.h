@@ -62,6 +62,7 @@ public:
         fMiterLimit = miterLimit;
     }
 
+    SkScalar getResScale() const { return fResScale; }
     void setResScale(SkScalar rs) {
         SkASSERT(rs > 0 && SkScalarIsFinite(rs));
         fResScale = rs;
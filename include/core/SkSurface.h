@@ -269,6 +269,21 @@ public:
 
     const SkSurfaceProps& props() const { return fProps; }
 
+    /**
+     *  Returns the bounds, in surface coordinates, of the pixels that may have changed since the
+     *  surface was created or resetDamage() was last called. Callers that copy the surface's
+     *  pixels elsewhere can use this to copy only what changed.
+     *
+     *  Only raster surfaces created with SkSurfaceProps::kTrackDamage_Flag keep track of this;
+     *  all other surfaces always return their full bounds.
+     */
+    SkIRect getDamage();
+
+    /**
+     *  Forgets the damage accumulated so far, so that getDamage() only reports later changes.
+     */
+    void resetDamage();
+
 protected:
     SkSurface(int width, int height, const SkSurfaceProps*);
     SkSurface(const SkImageInfo&, const SkSurfaceProps*);
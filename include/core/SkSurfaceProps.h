@@ -54,6 +54,11 @@ public:
         kDisallowAntiAlias_Flag     = 1 << 0,
         kDisallowDither_Flag        = 1 << 1,
         kUseDistanceFieldFonts_Flag = 1 << 2,
+        /**
+         *  Raster surfaces with this flag keep a bound on the pixels drawn to them, returned by
+         *  SkSurface::getDamage().
+         */
+        kTrackDamage_Flag           = 1 << 3,
     };
     SkSurfaceProps(uint32_t flags, SkPixelGeometry);
 
@@ -70,6 +75,7 @@ public:
     bool isDisallowAA() const { return SkToBool(fFlags & kDisallowAntiAlias_Flag); }
     bool isDisallowDither() const { return SkToBool(fFlags & kDisallowDither_Flag); }
     bool isUseDistanceFieldFonts() const { return SkToBool(fFlags & kUseDistanceFieldFonts_Flag); }
+    bool isTrackDamage() const { return SkToBool(fFlags & kTrackDamage_Flag); }
 
 private:
     SkSurfaceProps();
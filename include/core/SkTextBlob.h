@@ -8,6 +8,7 @@
 #ifndef SkTextBlob_DEFINED
 #define SkTextBlob_DEFINED
 
+#include "SkAtomics.h"
 #include "SkPaint.h"
 #include "SkRefCnt.h"
 #include "SkTArray.h"
@@ -46,6 +47,12 @@ public:
      */
     static const SkTextBlob* CreateFromBuffer(SkReadBuffer&);
 
+    /**
+     *  Posted to SkMessageBus when a blob that some cache has keyed on is deleted, so the cache
+     *  can drop what it holds for that uniqueID.
+     */
+    struct PurgeBlobMessage { uint32_t fID; };
+
 private:
     enum GlyphPositioning {
         kDefault_Positioning      = 0, // Default glyph advances -- zero scalars per glyph.
@@ -92,6 +99,12 @@ private:
 
     static unsigned ScalarsPerGlyph(GlyphPositioning pos);
 
+    // Call when this blob is part of the key to a cache entry, so it posts a PurgeBlobMessage
+    // when it is deleted.
+    void notifyAddedToCache() const {
+        fAddedToCache.store(true);
+    }
+
     friend class GrAtlasTextContext;
     friend class GrTextBlobCache;
     friend class GrTextContext;
@@ -102,6 +115,7 @@ private:
     const int        fRunCount;
     const SkRect     fBounds;
     const uint32_t fUniqueID;
+    mutable SkAtomic<bool> fAddedToCache;
 
     SkDEBUGCODE(size_t fStorageSize;)
 
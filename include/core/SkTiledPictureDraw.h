@@ -0,0 +1,54 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTiledPictureDraw_DEFINED
+#define SkTiledPictureDraw_DEFINED
+
+#include "SkTypes.h"
+
+class SkBitmap;
+class SkMatrix;
+class SkPicture;
+struct SkIRect;
+
+/** \class SkTiledPictureDraw
+
+    Rasterizes a single SkPicture into a raster bitmap using all available cores.
+
+    SkMultiPictureDraw parallelizes across pictures; this parallelizes inside one picture
+    by splitting the destination into tiles and playing the picture back into each tile
+    concurrently.  Each tile only draws the ops its bounding-box hierarchy reports as
+    intersecting that tile.  If the picture was recorded without a BBH, an SkRTree is built
+    once up front and shared by all tiles.
+
+    Each tile is clipped to the picture's cull rect, so unlike SkCanvas::drawPicture(),
+    nothing the picture draws outside its cull rect reaches dst.  Anti-aliased edges that
+    cross a tile boundary may also differ slightly from an untiled draw.
+*/
+class SK_API SkTiledPictureDraw {
+public:
+    static const int kDefaultTileSize = 256;
+
+    /**
+     *  Draw picture into dst.  dst must have allocated pixels.
+     *  The pixels are drawn to directly, with no clear beforehand.
+     *
+     *  @param picture    the picture to draw
+     *  @param dst        the bitmap to rasterize into; tiles share its pixels
+     *  @param matrix     if non-NULL, applied to the CTM when drawing
+     *  @param tileWidth  width of each tile, in device pixels
+     *  @param tileHeight height of each tile, in device pixels
+     *  @param dirty      if non-NULL, only the tiles intersecting this device rect are drawn
+     */
+    static void Draw(const SkPicture* picture, const SkBitmap& dst,
+                     const SkMatrix* matrix = NULL,
+                     int tileWidth = kDefaultTileSize,
+                     int tileHeight = kDefaultTileSize,
+                     const SkIRect* dirty = NULL);
+};
+
+#endif
@@ -45,6 +45,10 @@ public:
 
     uint32_t* reserve(size_t size) { return fWriter.reserve(size); }
 
+    // See SkWriter32::reserveCapacity() and SkWriter32::detachAsData().
+    void reserveCapacity(size_t size) { fWriter.reserveCapacity(size); }
+    SkData* detachAsData() { return fWriter.detachAsData(); }
+
     size_t bytesWritten() const { return fWriter.bytesWritten(); }
 
     void writeByteArray(const void* data, size_t size);
@@ -57,6 +57,13 @@ public:
         return (uint32_t*)fData;
     }
 
+    /**
+     *  Grows the storage, if needed, so that 'size' bytes in total can be written without
+     *  reallocating. Callers that can estimate their final size up front should call this first
+     *  to skip the repeated grow-and-copy steps.
+     */
+    void reserveCapacity(size_t size);
+
     // size MUST be multiple of 4
     uint32_t* reserve(size_t size) {
         SkASSERT(SkAlign4(size) == size);
@@ -235,8 +242,15 @@ public:
      *  Captures a snapshot of the data as it is right now, and return it.
      */
     SkData* snapshotAsData() const;
+
+    /**
+     *  Returns the data written so far and resets the writer. When the data lives in storage we
+     *  allocated, ownership passes to the SkData without copying it.
+     */
+    SkData* detachAsData();
 private:
     void growToAtLeast(size_t size);
+    void setCapacity(size_t capacity);
 
     uint8_t* fData;                    // Points to either fInternal or fExternal.
     size_t fCapacity;                  // Number of bytes we can write to fData.
@@ -83,15 +83,15 @@ public:
         void shadeSpan16(int x, int y, uint16_t[], int count) override;
 
     private:
-        SkPMColor shade(const SkPoint& point, StitchData& stitchData) const;
-        SkScalar calculateTurbulenceValueForPoint(
-            int channel,
-            StitchData& stitchData, const SkPoint& point) const;
-        SkScalar noise2D(int channel,
-                         const StitchData& stitchData, const SkPoint& noiseVector) const;
+        struct BlockCache;
+
+        SkPMColor shade(const SkPoint& point) const;
+        // Returns the rendered block of noise whose top left is (x, y) in noise space.
+        const SkPMColor* findBlock(int x, int y);
 
         SkMatrix fMatrix;
         PaintingData* fPaintingData;
+        BlockCache* fBlockCache;
 
         typedef SkShader::Context INHERITED;
     };
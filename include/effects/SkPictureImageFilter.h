@@ -65,6 +65,8 @@ protected:
     void flatten(SkWriteBuffer&) const override;
     virtual bool onFilterImage(Proxy*, const SkBitmap& src, const Context&,
                                SkBitmap* result, SkIPoint* offset) const override;
+    bool onFilterImageAsShader(Proxy*, const SkBitmap& src, const Context&,
+                               SkShader**, SkRect* dstRect) const override;
 
 private:
 
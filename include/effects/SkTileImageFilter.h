@@ -36,8 +36,16 @@ protected:
         : INHERITED(1, &input, NULL), fSrcRect(srcRect), fDstRect(dstRect) {}
 
     void flatten(SkWriteBuffer& buffer) const override;
+    bool onFilterImageAsShader(Proxy*, const SkBitmap& src, const Context&,
+                               SkShader**, SkRect* dstRect) const override;
 
 private:
+    // Computes the tiled subset of the (input-filtered) source and where it is drawn. Returns
+    // false if the filter fails, and sets *empty if it succeeds but draws nothing.
+    bool computeTile(Proxy*, const SkBitmap& src, const Context&, SkBitmap* subset,
+                     SkMatrix* shaderMatrix, SkRect* dstRect, SkIRect* dstIRect,
+                     bool* empty) const;
+
     SkRect fSrcRect;
     SkRect fDstRect;
 };
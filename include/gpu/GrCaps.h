@@ -127,6 +127,8 @@ public:
     bool compressedTexSubImageSupport() const { return fCompressedTexSubImageSupport; }
     bool oversizedStencilSupport() const { return fOversizedStencilSupport; }
     bool textureBarrierSupport() const { return fTextureBarrierSupport; }
+    /** Whether GrGpu's timer queries can measure GPU time. */
+    bool timerQuerySupport() const { return fTimerQuerySupport; }
 
     bool useDrawInsteadOfClear() const { return fUseDrawInsteadOfClear; }
     bool useDrawInsteadOfPartialRenderTargetWrite() const {
@@ -172,6 +174,8 @@ public:
         kCanMap_MapFlag  = 0x1,       //<! The resource can be mapped. Must be set for any of
                                       //   the other flags to have meaning.k
         kSubset_MapFlag  = 0x2,       //<! The resource can be partially mapped.
+        kPersistent_MapFlag = 0x4,    //<! Buffers can stay mapped while the GPU reads them, with
+                                      //   reuse synchronized by GrGpu fences.
     };
 
     uint32_t mapBufferFlags() const { return fMapBufferFlags; }
@@ -216,6 +220,9 @@ public:
         return fSupportsInstancedDraws;
     }
 
+    /** Can kVec2h_GrVertexAttribType (half float) vertex attributes be used? */
+    bool halfFloatVertexAttributeSupport() const { return fHalfFloatVertexAttributeSupport; }
+
     bool fullClearIsFree() const { return fFullClearIsFree; }
 
 protected:
@@ -237,7 +244,9 @@ protected:
     bool fCompressedTexSubImageSupport               : 1;
     bool fOversizedStencilSupport                    : 1;
     bool fTextureBarrierSupport                      : 1;
+    bool fTimerQuerySupport                          : 1;
     bool fSupportsInstancedDraws                     : 1;
+    bool fHalfFloatVertexAttributeSupport            : 1;
     bool fFullClearIsFree                            : 1;
 
     // Driver workaround
@@ -14,6 +14,7 @@
 #include "GrPathRendererChain.h"
 #include "GrRenderTarget.h"
 #include "GrTextureProvider.h"
+#include "SkCacheStats.h"
 #include "SkMatrix.h"
 #include "SkPathEffect.h"
 #include "SkTypes.h"
@@ -22,8 +23,10 @@ class GrAARectRenderer;
 class GrBatchFontCache;
 class GrCaps;
 struct GrContextOptions;
+class GrDistanceFieldGlyphSet;
 class GrDrawContext;
 class GrDrawTarget;
+class GrFlushTimer;
 class GrFragmentProcessor;
 class GrGpu;
 class GrGpuTraceMarker;
@@ -126,6 +129,13 @@ public:
      */
     void getResourceCacheUsage(int* resourceCount, size_t* resourceBytes) const;
 
+    /**
+     *  Returns the most bytes of video memory the cache has held against its budget since the
+     *  context was created or since the last resetResourceCachePeakBytes().
+     */
+    size_t getResourceCachePeakBytes() const;
+    void resetResourceCachePeakBytes();
+
     /**
      *  Specify the GPU resource cache limits. If the current cache exceeds either
      *  of these, it will be purged (LRU) to keep the cache within these limits.
@@ -137,6 +147,12 @@ public:
      */
     void setResourceCacheLimits(int maxResources, size_t maxResourceBytes);
 
+    /**
+     *  Calls visitor once for each of this context's caches: "gpu-resource", "text-blob",
+     *  "layer" and "font-atlas". The CPU caches are reported by SkGraphics::VisitCacheStats().
+     */
+    void visitCacheStats(SkCacheStats::Visitor visitor, void* context) const;
+
     GrTextureProvider* textureProvider() { return fTextureProvider; }
     const GrTextureProvider* textureProvider() const { return fTextureProvider; }
 
@@ -146,6 +162,14 @@ public:
      */
     void freeGpuResources();
 
+    /**
+     * Frees the least recently used of the GPU resources and text blobs the context caches but
+     * isn't using, until at most fraction (0..1) of their memory is left. Under memory pressure,
+     * purgeResourcesToFraction(0.5f) sheds the colder half instead of everything that
+     * freeGpuResources() would.
+     */
+    void purgeResourcesToFraction(float fraction);
+
     /**
      * Purge all the unlocked resources from the cache.
      * This entry point is mainly meant for timing texture uploads
@@ -153,6 +177,13 @@ public:
      */
     void purgeAllUnlockedResources();
 
+    /**
+     * Distance field text drawn in the style of the set's glyphs will copy them into the glyph
+     * atlas rather than generate their distance fields. Typically called at startup with sets
+     * loaded from disk. The context refs the set.
+     */
+    void addDistanceFieldGlyphs(const GrDistanceFieldGlyphSet*);
+
     /** Access the context capabilities */
     const GrCaps* caps() const { return fCaps; }
 
@@ -249,6 +280,33 @@ public:
                            size_t rowBytes = 0,
                            uint32_t pixelOpsFlags = 0);
 
+    /**
+     * Receives the pixels of a readSurfacePixelsAsync(). The pixels are only valid for the
+     * duration of the call and are NULL if the read failed.
+     */
+    typedef void (*PFReadPixelsFunc)(void* info, const void* pixels, size_t rowBytes);
+
+    /**
+     * Like readSurfacePixels() but doesn't wait for the GPU to finish drawing the surface. The
+     * read is issued after the drawing recorded so far and 'func' is called from a later flush()
+     * or finishAsyncReads() once the pixels have arrived. When the backend can't read the
+     * surface asynchronously, e.g. because a draw is needed to convert its pixels, they are read
+     * synchronously and 'func' is called before this returns. The rectangle must lie within the
+     * surface.
+     *
+     * @return false if the read can't be performed, in which case 'func' is not called.
+     */
+    bool readSurfacePixelsAsync(GrSurface* surface,
+                                int left, int top, int width, int height,
+                                GrPixelConfig config,
+                                PFReadPixelsFunc func, void* info);
+
+    /**
+     * Calls back the asynchronous reads whose pixels have arrived. When 'wait' is true this first
+     * waits for all of them.
+     */
+    void finishAsyncReads(bool wait);
+
     /**
      * Writes a rectangle of pixels to a surface.
      * @param surface       the surface to write to.
@@ -317,6 +375,36 @@ public:
      */
     uint32_t uniqueID() { return fUniqueID; }
 
+    ///////////////////////////////////////////////////////////////////////////
+    // GPU timing
+
+    /** GPU time spent on one kind of work targeting one render target during a flush. */
+    struct GpuTimingEntry {
+        const char* fName;              // The batch's name() or the kind of command.
+        uint32_t    fRenderTargetID;    // GrRenderTarget::getUniqueID(), or SK_InvalidUniqueID.
+        int         fCount;             // Number of batches or commands that were timed.
+        uint64_t    fNanoseconds;
+    };
+
+    struct GpuTimingStats {
+        int                   fFlushID;     // Counts the flushes since timing was enabled.
+        uint64_t              fTotalNanoseconds;
+        const GpuTimingEntry* fEntries;     // Only valid for the duration of the callback.
+        int                   fEntryCount;
+    };
+
+    typedef void (*PFGpuTimingFunc)(const GpuTimingStats& stats, void* info);
+
+    /**
+     * Times the GPU work of each flush with the backend's timer queries and reports it,
+     * aggregated by batch type and render target, to 'func'. Results are read back without
+     * stalling, so a flush is reported from a later flush once the GPU has finished it. Flushes
+     * the driver reports as disjoint (e.g. after a power state change) are dropped. Passing NULL
+     * turns timing off. The callback must not call this. Returns false if the backend cannot time
+     * GPU work.
+     */
+    bool setGpuTimingCallback(PFGpuTimingFunc func, void* info);
+
     ///////////////////////////////////////////////////////////////////////////
     // Functions intended for internal use only.
     GrGpu* getGpu() { return fGpu; }
@@ -324,6 +412,8 @@ public:
     GrBatchFontCache* getBatchFontCache() { return fBatchFontCache; }
     GrLayerCache* getLayerCache() { return fLayerCache.get(); }
     GrTextBlobCache* getTextBlobCache() { return fTextBlobCache; }
+    // NULL unless GPU timing is enabled.
+    GrFlushTimer* getFlushTimer() { return fFlushTimer.get(); }
     bool abandoned() const { return fDrawingMgr.abandoned(); }
     GrResourceProvider* resourceProvider() { return fResourceProvider; }
     const GrResourceProvider* resourceProvider() const { return fResourceProvider; }
@@ -371,6 +461,7 @@ private:
     GrBatchFontCache*               fBatchFontCache;
     SkAutoTDelete<GrLayerCache>     fLayerCache;
     SkAutoTDelete<GrTextBlobCache>  fTextBlobCache;
+    SkAutoTDelete<GrFlushTimer>     fFlushTimer;
 
     GrPathRendererChain*            fPathRendererChain;
     GrSoftwarePathRenderer*         fSoftwarePathRenderer;
@@ -388,6 +479,15 @@ private:
 
     SkTDArray<CleanUpData>          fCleanUpData;
 
+    struct AsyncRead {
+        GrAsyncRead      fRead;
+        PFReadPixelsFunc fFunc;
+        void*            fInfo;
+    };
+
+    // In issue order, which is also the order in which they finish.
+    SkTDArray<AsyncRead>            fAsyncReads;
+
     const uint32_t                  fUniqueID;
 
     GrContext(); // init must be called after the constructor.
@@ -438,7 +538,7 @@ private:
     DrawingMgr                      fDrawingMgr;
 
     void initMockContext();
-    void initCommon();
+    void initCommon(const GrContextOptions&);
 
     /**
      * These functions create premul <-> unpremul effects if it is possible to generate a pair
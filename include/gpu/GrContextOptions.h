@@ -10,7 +10,20 @@
 
 #include "SkTypes.h"
 
+class SkData;
+
 struct GrContextOptions {
+    /** Client-provided storage for data that is expensive to regenerate, e.g. linked GL program
+        binaries. It should persist across runs of the process. Keys and data are opaque. */
+    class PersistentCache {
+    public:
+        virtual ~PersistentCache() {}
+
+        /** Returns the data stored for key, or NULL. The caller takes ownership of a ref. */
+        virtual SkData* load(const SkData& key) = 0;
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
     GrContextOptions()
         : fDrawPathToCompressedTexture(false)
         , fSuppressPrints(false)
@@ -18,7 +31,10 @@ struct GrContextOptions {
         , fMinTextureSizeOverride(0)
         , fSuppressDualSourceBlending(false)
         , fGeometryBufferMapThreshold(-1)
-        , fUseDrawInsteadOfPartialRenderTargetWrite(false) {}
+        , fUseDrawInsteadOfPartialRenderTargetWrite(false)
+        , fPersistentCache(NULL)
+        , fAllowPendingPrograms(false)
+        , fTextBlobCacheLimit(0) {}
 
     // EXPERIMENTAL
     // May be removed in the future, or may become standard depending
@@ -43,6 +59,22 @@ struct GrContextOptions {
 
     /** some gpus have problems with partial writes of the rendertarget */
     bool fUseDrawInsteadOfPartialRenderTargetWrite;
+
+    /** If set, the GrContext stores linked programs here and reuses them in later processes
+        instead of compiling and linking them again. It is not owned by the GrContext and must
+        outlive it. */
+    PersistentCache* fPersistentCache;
+
+    /** If the driver can compile shaders in the background, start compiling all of the new
+        programs a flush needs before drawing any of it, instead of compiling each one when its
+        first draw is reached. Draws still wait for their programs, so nothing is skipped, but
+        the compiles overlap each other and the earlier draws of the flush. */
+    bool fAllowPendingPrograms;
+
+    /** The most bytes of CPU memory the GrContext may spend on text blobs it has laid out for
+        drawing again. The least recently drawn blobs are freed to stay within it. Zero selects
+        the default of 4MB. */
+    size_t fTextBlobCacheLimit;
 };
 
 #endif
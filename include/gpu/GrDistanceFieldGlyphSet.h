@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrDistanceFieldGlyphSet_DEFINED
+#define GrDistanceFieldGlyphSet_DEFINED
+
+#include "SkRefCnt.h"
+#include "SkTDArray.h"
+
+class GrFontDescKey;
+class SkGlyph;
+class SkPaint;
+class SkStream;
+class SkWStream;
+
+/**
+ *  The distance fields and metrics of a set of glyphs of one typeface, precomputed at each of the
+ *  sizes distance field text is drawn from. Once handed to GrContext::addDistanceFieldGlyphs(),
+ *  distance field text drawn with the same typeface and style copies these glyphs into the atlas
+ *  instead of generating them, so a set serialized for the common UI fonts and loaded at startup
+ *  saves all of that work.
+ *
+ *  A set only matches text drawn with the typeface, style and text flags of the paint it was made
+ *  or loaded with (the text size doesn't matter). Glyphs whose metrics no longer match the
+ *  typeface's, say after a font update, are generated as usual.
+ */
+class SK_API GrDistanceFieldGlyphSet : public SkRefCnt {
+public:
+    /**
+     *  Generates the distance fields of count glyphs of the paint's typeface.
+     */
+    static GrDistanceFieldGlyphSet* Create(const SkPaint&, const uint16_t glyphIDs[], int count);
+
+    /**
+     *  Reads a set written by serialize(). The paint must have the typeface and style the set was
+     *  created with. Returns NULL if the stream does not hold a set this build can use.
+     */
+    static GrDistanceFieldGlyphSet* Deserialize(SkStream*, const SkPaint&);
+
+    void serialize(SkWStream*) const;
+
+    ~GrDistanceFieldGlyphSet() override;
+
+    /**
+     *  Returns the number of strikes, one per distance field size, and how many glyphs each has.
+     *  Glyphs with no image, like spaces, are left out.
+     */
+    int countStrikes() const { return fStrikes.count(); }
+    int countGlyphs(int strikeIndex) const;
+
+    /**
+     *  Returns the index of the set's strike with the key, or -1 if it has none.
+     */
+    int findStrike(const GrFontDescKey&) const;
+
+    /**
+     *  Returns the distance field of the glyph, as made for the strike at strikeIndex, or NULL if
+     *  the set doesn't have it or the glyph's metrics have changed since. The image is A8 and
+     *  as big as the glyph's distance field bounds.
+     */
+    const uint8_t* findImage(int strikeIndex, const SkGlyph&) const;
+
+private:
+    struct Strike;
+
+    GrDistanceFieldGlyphSet();
+
+    // Makes a strike for each distance field size, keyed for text drawn with the paint.
+    void initStrikes(const SkPaint&);
+
+    SkTDArray<Strike*> fStrikes;
+
+    typedef SkRefCnt INHERITED;
+};
+
+#endif
@@ -241,6 +241,27 @@ public:
                    const SkRSXform xform[],
                    const SkRect texRect[],
                    const SkColor colors[]);
+
+    /**
+     * Draws a nine-patch of an image. All nine patches are one draw, and consecutive nine-patches
+     * with the same paint batch together.
+     *
+     * @param   paint           describes how to color pixels. Its local coords are in the pixel
+     *                          space of the image.
+     * @param   viewMatrix      transformation matrix, which must not have perspective.
+     * @param   imageWidth      width of the image.
+     * @param   imageHeight     height of the image.
+     * @param   center          the stretchable center of the image.
+     * @param   dst             the rectangle the image is stretched over.
+     */
+    void drawImageNine(GrRenderTarget*,
+                       const GrClip&,
+                       const GrPaint& paint,
+                       const SkMatrix& viewMatrix,
+                       int imageWidth,
+                       int imageHeight,
+                       const SkIRect& center,
+                       const SkRect& dst);
     
     /**
      * Draws an oval.
@@ -167,6 +167,20 @@ public:
         kAdopted_LifeCycle,
     };
 
+    /**
+     * Groups resources for GrResourceCache's per-category budgets and recreation costs.
+     */
+    enum CacheCategory {
+        kRenderTarget_CacheCategory,    //!< render targets and their stencil attachments
+        kTexture_CacheCategory,
+        kBuffer_CacheCategory,          //!< vertex and index buffers
+        kPath_CacheCategory,            //!< GrPath and GrPathRange
+        kOther_CacheCategory,
+
+        kLast_CacheCategory = kOther_CacheCategory
+    };
+    static const int kCacheCategoryCnt = kLast_CacheCategory + 1;
+
     /**
      * Tests whether a object has been abandoned or released. All objects will
      * be in this state after their creating GrContext is destroyed or has
@@ -214,6 +228,9 @@ public:
         associated unique key. */
     const GrUniqueKey& getUniqueKey() const { return fUniqueKey; }
 
+    /** Returns the resource's cache category. This is fixed when the resource joins the cache. */
+    CacheCategory cacheCategory() const { return fCacheCategory; }
+
     /**
      * Attach a custom data object to this resource. The data will remain attached
      * for the lifetime of this resource (until it is abandoned or released).
@@ -296,6 +313,9 @@ private:
 
     virtual size_t onGpuMemorySize() const = 0;
 
+    /** Overridden by subclasses that belong to a more specific category than "other". */
+    virtual CacheCategory onCacheCategory() const { return kOther_CacheCategory; }
+
     // See comments in CacheAccess and ResourcePriv.
     void setUniqueKey(const GrUniqueKey&);
     void removeUniqueKey();
@@ -328,6 +348,7 @@ private:
     mutable size_t              fGpuMemorySize;
 
     LifeCycle                   fLifeCycle;
+    CacheCategory               fCacheCategory;
     const uint32_t              fUniqueID;
 
     SkAutoTUnref<const SkData>  fData;
@@ -162,6 +162,10 @@ protected:
     void onAbandon() override;
 
 private:
+    CacheCategory onCacheCategory() const override {
+        return this->asRenderTarget() ? kRenderTarget_CacheCategory : kTexture_CacheCategory;
+    }
+
     void invokeReleaseProc() {
         if (fReleaseProc) {
             fReleaseProc(fReleaseCtx);
@@ -60,6 +60,13 @@ public:
         return this->existsResourceWithUniqueKey(key);
     }
 
+    /**
+     * Like existsTextureWithUniqueKey(), but may be called from threads other than the one that
+     * owns the context, so long as the context is neither abandoned nor destroyed meanwhile. The
+     * answer may be out of date by the time the caller acts on it.
+     */
+    bool existsTextureWithUniqueKeyFromAnyThread(const GrUniqueKey& key) const;
+
     /**
      * Finds a texture that approximately matches the descriptor. Will be at least as large in width
      * and height as desc specifies. If desc specifies that the texture should be a render target
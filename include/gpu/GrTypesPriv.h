@@ -119,8 +119,9 @@ enum GrVertexAttribType {
     kVec4ub_GrVertexAttribType,  // vector of 4 unsigned bytes, e.g. colors
 
     kVec2s_GrVertexAttribType,   // vector of 2 shorts, e.g. texture coordinates
-    
-    kLast_GrVertexAttribType = kVec2s_GrVertexAttribType
+    kVec2h_GrVertexAttribType,   // vector of 2 half floats, requires GrCaps support
+
+    kLast_GrVertexAttribType = kVec2h_GrVertexAttribType
 };
 static const int kGrVertexAttribTypeCount = kLast_GrVertexAttribType + 1;
 
@@ -129,7 +130,7 @@ static const int kGrVertexAttribTypeCount = kLast_GrVertexAttribType + 1;
  */
 static inline int GrVertexAttribTypeVectorCount(GrVertexAttribType type) {
     SkASSERT(type >= 0 && type < kGrVertexAttribTypeCount);
-    static const int kCounts[] = { 1, 2, 3, 4, 1, 4, 2 };
+    static const int kCounts[] = { 1, 2, 3, 4, 1, 4, 2, 2 };
     return kCounts[type];
 
     GR_STATIC_ASSERT(0 == kFloat_GrVertexAttribType);
@@ -139,6 +140,7 @@ static inline int GrVertexAttribTypeVectorCount(GrVertexAttribType type) {
     GR_STATIC_ASSERT(4 == kUByte_GrVertexAttribType);
     GR_STATIC_ASSERT(5 == kVec4ub_GrVertexAttribType);
     GR_STATIC_ASSERT(6 == kVec2s_GrVertexAttribType);
+    GR_STATIC_ASSERT(7 == kVec2h_GrVertexAttribType);
     GR_STATIC_ASSERT(SK_ARRAY_COUNT(kCounts) == kGrVertexAttribTypeCount);
 }
 
@@ -154,7 +156,8 @@ static inline size_t GrVertexAttribTypeSize(GrVertexAttribType type) {
         4*sizeof(float),        // kVec4f_GrVertexAttribType
         1*sizeof(char),         // kUByte_GrVertexAttribType
         4*sizeof(char),         // kVec4ub_GrVertexAttribType
-        2*sizeof(int16_t)       // kVec2s_GrVertexAttribType
+        2*sizeof(int16_t),      // kVec2s_GrVertexAttribType
+        2*sizeof(uint16_t)      // kVec2h_GrVertexAttribType
     };
     return kSizes[type];
 
@@ -165,6 +168,7 @@ static inline size_t GrVertexAttribTypeSize(GrVertexAttribType type) {
     GR_STATIC_ASSERT(4 == kUByte_GrVertexAttribType);
     GR_STATIC_ASSERT(5 == kVec4ub_GrVertexAttribType);
     GR_STATIC_ASSERT(6 == kVec2s_GrVertexAttribType);
+    GR_STATIC_ASSERT(7 == kVec2h_GrVertexAttribType);
     GR_STATIC_ASSERT(SK_ARRAY_COUNT(kSizes) == kGrVertexAttribTypeCount);
 }
 
@@ -179,6 +183,7 @@ static inline GrSLType GrVertexAttribTypeToSLType(GrVertexAttribType type) {
         case kFloat_GrVertexAttribType:
             return kFloat_GrSLType;
         case kVec2s_GrVertexAttribType:
+        case kVec2h_GrVertexAttribType:
         case kVec2f_GrVertexAttribType:
             return kVec2f_GrSLType;
         case kVec3f_GrVertexAttribType:
@@ -247,6 +252,15 @@ enum GrIOType {
     kRW_GrIOType
 };
 
+/** An opaque handle to a point in the GPU command stream. See GrGpu::insertFence(). */
+typedef uint64_t GrFence;
+
+/** An opaque handle to a GPU timer query. See GrGpu::beginTimerQuery(). */
+typedef uint64_t GrTimerQuery;
+
+/** An opaque handle to a pending asynchronous read. See GrGpu::beginAsyncReadPixels(). */
+typedef uint64_t GrAsyncRead;
+
 struct GrScissorState {
     GrScissorState() : fEnabled(false) {}
     void set(const SkIRect& rect) { fRect = rect; fEnabled = true; }
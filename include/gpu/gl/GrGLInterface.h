@@ -152,6 +152,7 @@ public:
         GLPtr<GrGLBeginQueryProc> fBeginQuery;
         GLPtr<GrGLBindAttribLocationProc> fBindAttribLocation;
         GLPtr<GrGLBindBufferProc> fBindBuffer;
+        GLPtr<GrGLBindBufferRangeProc> fBindBufferRange;
         GLPtr<GrGLBindFragDataLocationProc> fBindFragDataLocation;
         GLPtr<GrGLBindFragDataLocationIndexedProc> fBindFragDataLocationIndexed;
         GLPtr<GrGLBindFramebufferProc> fBindFramebuffer;
@@ -164,11 +165,13 @@ public:
         GLPtr<GrGLBlendFuncProc> fBlendFunc;
         GLPtr<GrGLBlitFramebufferProc> fBlitFramebuffer;
         GLPtr<GrGLBufferDataProc> fBufferData;
+        GLPtr<GrGLBufferStorageProc> fBufferStorage;
         GLPtr<GrGLBufferSubDataProc> fBufferSubData;
         GLPtr<GrGLCheckFramebufferStatusProc> fCheckFramebufferStatus;
         GLPtr<GrGLClearProc> fClear;
         GLPtr<GrGLClearColorProc> fClearColor;
         GLPtr<GrGLClearStencilProc> fClearStencil;
+        GLPtr<GrGLClientWaitSyncProc> fClientWaitSync;
         GLPtr<GrGLColorMaskProc> fColorMask;
         GLPtr<GrGLCompileShaderProc> fCompileShader;
         GLPtr<GrGLCompressedTexImage2DProc> fCompressedTexImage2D;
@@ -184,6 +187,7 @@ public:
         GLPtr<GrGLDeleteQueriesProc> fDeleteQueries;
         GLPtr<GrGLDeleteRenderbuffersProc> fDeleteRenderbuffers;
         GLPtr<GrGLDeleteShaderProc> fDeleteShader;
+        GLPtr<GrGLDeleteSyncProc> fDeleteSync;
         GLPtr<GrGLDeleteTexturesProc> fDeleteTextures;
         GLPtr<GrGLDeleteVertexArraysProc> fDeleteVertexArrays;
         GLPtr<GrGLDepthMaskProc> fDepthMask;
@@ -196,6 +200,7 @@ public:
         GLPtr<GrGLEnableProc> fEnable;
         GLPtr<GrGLEnableVertexAttribArrayProc> fEnableVertexAttribArray;
         GLPtr<GrGLEndQueryProc> fEndQuery;
+        GLPtr<GrGLFenceSyncProc> fFenceSync;
         GLPtr<GrGLFinishProc> fFinish;
         GLPtr<GrGLFlushProc> fFlush;
         GLPtr<GrGLFlushMappedBufferRangeProc> fFlushMappedBufferRange;
@@ -219,6 +224,7 @@ public:
         GLPtr<GrGLGetQueryObjectui64vProc> fGetQueryObjectui64v;
         GLPtr<GrGLGetQueryObjectuivProc> fGetQueryObjectuiv;
         GLPtr<GrGLGetQueryivProc> fGetQueryiv;
+        GLPtr<GrGLGetProgramBinaryProc> fGetProgramBinary;
         GLPtr<GrGLGetProgramInfoLogProc> fGetProgramInfoLog;
         GLPtr<GrGLGetProgramivProc> fGetProgramiv;
         GLPtr<GrGLGetRenderbufferParameterivProc> fGetRenderbufferParameteriv;
@@ -228,6 +234,7 @@ public:
         GLPtr<GrGLGetStringProc> fGetString;
         GLPtr<GrGLGetStringiProc> fGetStringi;
         GLPtr<GrGLGetTexLevelParameterivProc> fGetTexLevelParameteriv;
+        GLPtr<GrGLGetUniformBlockIndexProc> fGetUniformBlockIndex;
         GLPtr<GrGLGetUniformLocationProc> fGetUniformLocation;
         GLPtr<GrGLInsertEventMarkerProc> fInsertEventMarker;
         GLPtr<GrGLInvalidateBufferDataProc> fInvalidateBufferData;
@@ -245,6 +252,8 @@ public:
         GLPtr<GrGLMapTexSubImage2DProc> fMapTexSubImage2D;
         GLPtr<GrGLPixelStoreiProc> fPixelStorei;
         GLPtr<GrGLPopGroupMarkerProc> fPopGroupMarker;
+        GLPtr<GrGLProgramBinaryProc> fProgramBinary;
+        GLPtr<GrGLProgramParameteriProc> fProgramParameteri;
         GLPtr<GrGLPushGroupMarkerProc> fPushGroupMarker;
         GLPtr<GrGLQueryCounterProc> fQueryCounter;
         GLPtr<GrGLRasterSamplesProc> fRasterSamples;
@@ -310,6 +319,7 @@ public:
         GLPtr<GrGLUniform4iProc> fUniform4i;
         GLPtr<GrGLUniform4fvProc> fUniform4fv;
         GLPtr<GrGLUniform4ivProc> fUniform4iv;
+        GLPtr<GrGLUniformBlockBindingProc> fUniformBlockBinding;
         GLPtr<GrGLUniformMatrix2fvProc> fUniformMatrix2fv;
         GLPtr<GrGLUniformMatrix3fvProc> fUniformMatrix3fv;
         GLPtr<GrGLUniformMatrix4fvProc> fUniformMatrix4fv;
@@ -363,6 +373,9 @@ public:
         /* ARB_instanced_arrays */
         GLPtr<GrGLVertexAttribDivisorProc> fVertexAttribDivisor;
 
+        /* ARB_multi_draw_indirect */
+        GLPtr<GrGLMultiDrawElementsIndirectProc> fMultiDrawElementsIndirect;
+
         /* NV_bindless_texture */
         // We use the NVIDIA verson for now because it does not require dynamically uniform handles.
         // We may switch the the ARB version and/or omit methods in the future.
@@ -7,6 +7,7 @@
 #ifndef SkPathOps_DEFINED
 #define SkPathOps_DEFINED
 
+#include "SkChunkAlloc.h"
 #include "SkPreConfig.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
@@ -71,6 +72,8 @@ bool SK_API TightBounds(const SkPath& path, SkRect* result);
   */
 class SK_API SkOpBuilder {
 public:
+    SkOpBuilder();
+
     /** Add one or more paths and their operand. The builder is empty before the first
         path is added, so the result of a single add is (emptyPath OP path).
 
@@ -80,7 +83,8 @@ public:
     void add(const SkPath& path, SkPathOp _operator);
 
     /** Computes the sum of all paths and operands, and resets the builder to its
-        initial state.
+        initial state. If every operand is a union, the paths are unioned in pairs, then
+        the results in pairs, and so on, running the pairs of each round in parallel.
  
         @param result The product of the operands.
         @return True if the operation succeeded.
@@ -90,6 +94,9 @@ public:
 private:
     SkTArray<SkPath> fPathRefs;
     SkTDArray<SkPathOp> fOps;
+    // The ops share one allocator, which holds on to its largest block between them, so resolving
+    // many ops, or reusing the builder, doesn't allocate and free the contours' memory each time.
+    SkChunkAlloc fAllocator;
 
     void reset();
 };
@@ -10,17 +10,50 @@
 #ifndef SkGPipe_DEFINED
 #define SkGPipe_DEFINED
 
+#include "SkBitmap.h"
 #include "SkFlattenable.h"
 #include "SkPicture.h"
+#include "SkTiledPictureDraw.h"
 #include "SkWriter32.h"
 
 class SkCanvas;
+class SkPictureRecorder;
 
 // XLib.h might have defined Status already (ugh)
 #ifdef Status
     #undef Status
 #endif
 
+/**
+ *  Memory that both ends of a cross-process pipe can map, so that a bitmap whose pixels already
+ *  live in it is handed to the reader by handle, rather than having its pixels copied into the
+ *  stream. Each process implements it over its platform's shared memory: the writer gets it from
+ *  SkGPipeController::sharedMemory(), and the reader from SkGPipeReader::setSharedMemory().
+ *
+ *  The reader draws straight from the writer's pixels, so they must not change until the reader
+ *  is done with them.
+ */
+class SkGPipeSharedMemory : public SkRefCnt {
+public:
+    /**
+     *  Called by the writer. If the size bytes at pixels are all in one segment that the reader
+     *  can map, returns true and sets the segment's handle and the offset of pixels in it.
+     */
+    virtual bool findSegment(const void* pixels, size_t size, uint32_t* handle,
+                             size_t* offset) = 0;
+
+    /**
+     *  Called by the reader. Maps the segment with the handle, and returns its address and size,
+     *  or NULL if it can't. Each successful map() is balanced by an unmap() once the bitmaps made
+     *  from it are gone.
+     */
+    virtual void* map(uint32_t handle, size_t* size) = 0;
+    virtual void unmap(uint32_t handle, void* addr) = 0;
+
+private:
+    typedef SkRefCnt INHERITED;
+};
+
 class SkGPipeReader {
 public:
     SkGPipeReader();
@@ -41,19 +74,51 @@ public:
 
     void setCanvas(SkCanvas*);
 
+    /**
+     *  Rather than drawing each op into a canvas as it is read, index the ops by their bounds
+     *  (in an SkRTree) and rasterize them into dst later, with SkTiledPictureDraw: only the
+     *  tiles the ops touch are drawn, concurrently. That happens when the writer finishes or
+     *  drawTiles() is called, so any shared memory the ops draw from must stay unchanged until
+     *  then. dst must have allocated pixels, which the reader draws into without clearing.
+     *  Replaces any canvas set with setCanvas().
+     */
+    void setTiledTarget(const SkBitmap& dst,
+                        int tileWidth = SkTiledPictureDraw::kDefaultTileSize,
+                        int tileHeight = SkTiledPictureDraw::kDefaultTileSize);
+
+    /**
+     *  Rasterize the ops read since the last call into the tiled target, if there is one. The
+     *  current matrix and clip carry over to the ops that follow, but the save stack does not,
+     *  so call this between frames, when the writer's saves are balanced.
+     */
+    void drawTiles();
+
     /**
      *  Set a function for decoding bitmaps that have encoded data.
      */
     void setBitmapDecoder(SkPicture::InstallPixelRefProc proc) { fProc = proc; }
 
+    /**
+     *  Set the shared memory that bitmaps from a cross-process writer may refer to.
+     */
+    void setSharedMemory(SkGPipeSharedMemory*);
+
     // data must be 4-byte aligned
     // length must be a multiple of 4
     Status playback(const void* data, size_t length, uint32_t playbackFlags = 0,
                     size_t* bytesRead = NULL);
 private:
+    void beginTileRecording();
+
     SkCanvas*                       fCanvas;
     class SkGPipeState*             fState;
     SkPicture::InstallPixelRefProc  fProc;
+    SkGPipeSharedMemory*            fSharedMemory;
+
+    SkBitmap                        fTiledTarget;
+    int                             fTileWidth;
+    int                             fTileHeight;
+    SkPictureRecorder*              fTileRecorder;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -87,6 +152,12 @@ public:
     virtual void notifyWritten(size_t bytes) = 0;
     virtual int numberOfReaders() const { return 1; }
 
+    /**
+     *  When recording with kCrossProcess_Flag, bitmaps whose pixels are in this memory are
+     *  written by handle instead of being copied. The default has none.
+     */
+    virtual SkGPipeSharedMemory* sharedMemory() const { return NULL; }
+
     /**
      *  Release resource references that are held in internal caches.
      *  This must only be called after the pipe has been completely flushed.
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGPipeRingController_DEFINED
+#define SkGPipeRingController_DEFINED
+
+#include "SkGPipe.h"
+#include "SkTemplates.h"
+
+class SkSemaphore;
+
+/**
+ *  A controller that hands the pipe from the thread recording into an SkGPipeWriter to one other
+ *  thread playing it back, through a ring buffer of fixed size. Neither side takes a lock: the
+ *  writer hands out blocks of the ring without waiting, and publishes what it has written once
+ *  batchBytes have piled up, so the reader is woken once per batch rather than once per command.
+ *  The writer only waits for the reader when the ring is full.
+ *
+ *  The reader thread calls playback(), which plays back each batch into numberOfReaders() readers,
+ *  one after the other, until the writer finishes. Several readers should be recorded for with
+ *  SkGPipeWriter::kSimultaneousReaders_Flag. The SkGPipeWriter must outlive playback(), since the
+ *  pipe refers to objects the writer owns.
+ */
+class SkGPipeRingController : public SkGPipeController {
+public:
+    enum {
+        kDefaultCapacity   = 256 * 1024,
+        kDefaultBatchBytes = 4 * 1024
+    };
+
+    /**
+     *  capacity is rounded up to a power of 2. A block larger than half of it can't be handed out,
+     *  and ends the recording; the writer asks for blocks of at least 16K.
+     */
+    SkGPipeRingController(size_t capacity = kDefaultCapacity, int numberOfReaders = 1,
+                          size_t batchBytes = kDefaultBatchBytes);
+    virtual ~SkGPipeRingController();
+
+    void* requestBlock(size_t minRequest, size_t* actual) override;
+    void notifyWritten(size_t bytes) override;
+    int numberOfReaders() const override { return fNumberOfReaders; }
+
+    /**
+     *  Publishes what has been written but not yet batched up. Call it on the writer thread, after
+     *  SkGPipeWriter::flushRecording(), to have the reader play back everything recorded so far.
+     */
+    void flush();
+
+    /**
+     *  Call on the reader thread. Plays back the pipe into each of the numberOfReaders() readers as
+     *  it is published, waiting while there is nothing to play, and returns once the writer has
+     *  finished and everything it wrote has been played, or a reader hits an error. Returns the
+     *  status of the last playback, which is kDone_Status if the writer finished normally. After an
+     *  error the writer is told to stop.
+     */
+    SkGPipeReader::Status playback(SkGPipeReader* const readers[], uint32_t playbackFlags = 0);
+
+private:
+    // Publishes fWritten to the reader, and wakes it if it is waiting.
+    void publish();
+    // Waits until the reader has played back everything before end - fCapacity.
+    bool waitForSpace(size_t end);
+    // Waits until the writer has published past head, or finished. Returns the published tail.
+    size_t waitForData(size_t head);
+
+    SkAutoTMalloc<uint8_t> fStorage;
+    const size_t           fCapacity;
+    const size_t           fBatchBytes;
+    const int              fNumberOfReaders;
+
+    // Positions count every byte that has gone through the ring, so the offset of a position in
+    // fStorage is (position & (fCapacity - 1)), and the reader has caught up when they are equal.
+
+    // Only used on the writer thread.
+    size_t fWritten;        // end of what was notified, and where the next block starts
+    size_t fPublished;      // the last value given to fTail
+
+    // Shared by both threads.
+    size_t fTail;           // end of what the reader may play back
+    size_t fHead;           // end of what the reader has played back
+    size_t fWrapAt;         // where the last block that didn't fit before the end of the ring was
+                            // skipped from; nothing is written from there to the end of the lap
+    bool   fWriterDone;     // the writer has finished, and published everything
+    bool   fReaderDone;     // the reader hit an error, and won't read any more
+    bool   fWriterWaiting;  // the writer waits on fSpaceAvailable
+    bool   fReaderWaiting;  // the reader waits on fDataAvailable
+
+    SkAutoTDelete<SkSemaphore> fSpaceAvailable;
+    SkAutoTDelete<SkSemaphore> fDataAvailable;
+};
+
+#endif
@@ -23,6 +23,21 @@
  */
 class SkChecksum : SkNoncopyable {
 private:
+    static inline uint64_t Rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+    static inline uint64_t Read64(const uint8_t* p) {
+        uint64_t x;
+        memcpy(&x, p, 8);
+        return x;
+    }
+    static inline uint64_t Hash64Round(uint64_t acc, uint64_t input) {
+        acc += input * 14029467366897019727ULL;
+        return Rotl64(acc, 31) * 11400714785074694791ULL;
+    }
+    static inline uint64_t Hash64Merge(uint64_t hash, uint64_t v) {
+        hash ^= Hash64Round(0, v);
+        return hash * 11400714785074694791ULL + 9650029242287828579ULL;
+    }
+
     /*
      *  Our Rotate and Mash helpers are meant to automatically do the right
      *  thing depending if sizeof(uintptr_t) is 4 or 8.
@@ -115,6 +130,75 @@ public:
         return Mix(hash);
     }
 
+    /**
+     *  Calculate a 64-bit hash of an arbitrary block of data, e.g. pixels or encoded images,
+     *  for deduplication and cache keys where cryptographic strength (SkMD5, SkSHA1) is not
+     *  needed.  This is xxHash64: it walks the data in 32-byte stripes with four independent
+     *  accumulators, so it runs at close to memory bandwidth on large buffers.
+     *
+     *  @param data Memory address of the data block to be processed.  Need not be aligned.
+     *  @param bytes Size of the data block in bytes.
+     *  @param seed Initial hash seed. (optional)
+     *  @return hash result
+     */
+    static uint64_t Hash64(const void* data, size_t bytes, uint64_t seed=0) {
+        static const uint64_t P1 = 11400714785074694791ULL,
+                              P2 = 14029467366897019727ULL,
+                              P3 =  1609587929392839161ULL,
+                              P4 =  9650029242287828579ULL,
+                              P5 =  2870177450012600261ULL;
+        const uint8_t* p    = (const uint8_t*)data;
+        const uint8_t* stop = p + bytes;
+
+        uint64_t hash;
+        if (bytes >= 32) {
+            uint64_t v1 = seed + P1 + P2,
+                     v2 = seed + P2,
+                     v3 = seed,
+                     v4 = seed - P1;
+            do {
+                v1 = Hash64Round(v1, Read64(p +  0));
+                v2 = Hash64Round(v2, Read64(p +  8));
+                v3 = Hash64Round(v3, Read64(p + 16));
+                v4 = Hash64Round(v4, Read64(p + 24));
+                p += 32;
+            } while (stop - p >= 32);
+
+            hash = Rotl64(v1, 1) + Rotl64(v2, 7) + Rotl64(v3, 12) + Rotl64(v4, 18);
+            hash = Hash64Merge(hash, v1);
+            hash = Hash64Merge(hash, v2);
+            hash = Hash64Merge(hash, v3);
+            hash = Hash64Merge(hash, v4);
+        } else {
+            hash = seed + P5;
+        }
+        hash += bytes;
+
+        // Handle the last 0-31 bytes.
+        for (; stop - p >= 8; p += 8) {
+            hash ^= Hash64Round(0, Read64(p));
+            hash  = Rotl64(hash, 27) * P1 + P4;
+        }
+        if (stop - p >= 4) {
+            uint32_t k;
+            memcpy(&k, p, 4);
+            hash ^= k * P1;
+            hash  = Rotl64(hash, 23) * P2 + P3;
+            p += 4;
+        }
+        for (; p < stop; p++) {
+            hash ^= *p * P5;
+            hash  = Rotl64(hash, 11) * P1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= P2;
+        hash ^= hash >> 29;
+        hash *= P3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
     /**
      *  Compute a 32-bit checksum for a given data block
      *
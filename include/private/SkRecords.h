@@ -65,7 +65,8 @@ namespace SkRecords {
     M(DrawSprite)                                                   \
     M(DrawTextBlob)                                                 \
     M(DrawAtlas)                                                    \
-    M(DrawVertices)
+    M(DrawVertices)                                                 \
+    M(DrawImageRects)
 
 // Defines SkRecords::Type, an enum of all record types.
 #define ENUM(T) T##_Type,
@@ -187,6 +188,22 @@ private:
     T* fPtr;
 };
 
+// Ops often share identical paints, so SkRecord interns them (see SkRecord::internPaint()).
+// A SharedPaint points to one of those, which lives as long as its SkRecord.  It reads like a const
+// SkPaint, but can't be changed in place: intern the changed paint and point at that instead.
+class SharedPaint {
+public:
+    SharedPaint() : fPaint(nullptr) {}
+    SharedPaint(const SkPaint* paint) : fPaint(paint) { SkASSERT(fPaint); }
+
+    operator const SkPaint&() const { return *fPaint; }
+    const SkPaint* operator->() const { return fPaint; }
+    const SkPaint* get() const { return fPaint; }
+
+private:
+    const SkPaint* fPaint;
+};
+
 // PODArray doesn't own the pointer's memory, and we assume the data is POD.
 template <typename T>
 class PODArray {
@@ -219,8 +236,8 @@ private:
 };
 
 // SkPath::getBounds() isn't thread safe unless we precache the bounds in a singlethreaded context.
-// SkPath::cheapComputeDirection() is similar.
-// Recording is a convenient time to cache these, or we can delay it to between record and playback.
+// Recording is a convenient time to cache them.  (Convexity, first direction and the generation ID
+// are published atomically, so those may be computed lazily during concurrent playback.)
 struct PreCachedPath : public SkPath {
     PreCachedPath() {}
     explicit PreCachedPath(const SkPath& path);
@@ -271,12 +288,12 @@ RECORD4(DrawBitmapRectFast, Optional<SkPaint>, paint,
                             ImmutableBitmap, bitmap,
                             Optional<SkRect>, src,
                             SkRect, dst);
-RECORD5(DrawBitmapRectFixedSize, SkPaint, paint,
+RECORD5(DrawBitmapRectFixedSize, SharedPaint, paint,
                                  ImmutableBitmap, bitmap,
                                  SkRect, src,
                                  SkRect, dst,
                                  SkCanvas::SrcRectConstraint, constraint);
-RECORD3(DrawDRRect, SkPaint, paint, SkRRect, outer, SkRRect, inner);
+RECORD3(DrawDRRect, SharedPaint, paint, SkRRect, outer, SkRRect, inner);
 RECORD3(DrawDrawable, Optional<SkMatrix>, matrix, SkRect, worstCaseBounds, int32_t, index);
 RECORD4(DrawImage, Optional<SkPaint>, paint,
                    RefBox<const SkImage>, image,
@@ -291,41 +308,41 @@ RECORD4(DrawImageNine, Optional<SkPaint>, paint,
                        RefBox<const SkImage>, image,
                        SkIRect, center,
                        SkRect, dst);
-RECORD2(DrawOval, SkPaint, paint, SkRect, oval);
-RECORD1(DrawPaint, SkPaint, paint);
-RECORD2(DrawPath, SkPaint, paint, PreCachedPath, path);
+RECORD2(DrawOval, SharedPaint, paint, SkRect, oval);
+RECORD1(DrawPaint, SharedPaint, paint);
+RECORD2(DrawPath, SharedPaint, paint, PreCachedPath, path);
 RECORD3(DrawPicture, Optional<SkPaint>, paint,
                      RefBox<const SkPicture>, picture,
                      TypedMatrix, matrix);
-RECORD4(DrawPoints, SkPaint, paint, SkCanvas::PointMode, mode, unsigned, count, SkPoint*, pts);
-RECORD4(DrawPosText, SkPaint, paint,
+RECORD4(DrawPoints, SharedPaint, paint, SkCanvas::PointMode, mode, unsigned, count, SkPoint*, pts);
+RECORD4(DrawPosText, SharedPaint, paint,
                      PODArray<char>, text,
                      size_t, byteLength,
                      PODArray<SkPoint>, pos);
-RECORD5(DrawPosTextH, SkPaint, paint,
+RECORD5(DrawPosTextH, SharedPaint, paint,
                       PODArray<char>, text,
                       unsigned, byteLength,
                       SkScalar, y,
                       PODArray<SkScalar>, xpos);
-RECORD2(DrawRRect, SkPaint, paint, SkRRect, rrect);
-RECORD2(DrawRect, SkPaint, paint, SkRect, rect);
+RECORD2(DrawRRect, SharedPaint, paint, SkRRect, rrect);
+RECORD2(DrawRect, SharedPaint, paint, SkRect, rect);
 RECORD4(DrawSprite, Optional<SkPaint>, paint, ImmutableBitmap, bitmap, int, left, int, top);
-RECORD5(DrawText, SkPaint, paint,
+RECORD5(DrawText, SharedPaint, paint,
                   PODArray<char>, text,
                   size_t, byteLength,
                   SkScalar, x,
                   SkScalar, y);
-RECORD4(DrawTextBlob, SkPaint, paint,
+RECORD4(DrawTextBlob, SharedPaint, paint,
                       RefBox<const SkTextBlob>, blob,
                       SkScalar, x,
                       SkScalar, y);
-RECORD5(DrawTextOnPath, SkPaint, paint,
+RECORD5(DrawTextOnPath, SharedPaint, paint,
                         PODArray<char>, text,
                         size_t, byteLength,
                         PreCachedPath, path,
                         TypedMatrix, matrix);
 
-RECORD5(DrawPatch, SkPaint, paint,
+RECORD5(DrawPatch, SharedPaint, paint,
                    PODArray<SkPoint>, cubics,
                    PODArray<SkColor>, colors,
                    PODArray<SkPoint>, texCoords,
@@ -344,7 +361,7 @@ RECORD8(DrawAtlas,  Optional<SkPaint>, paint,
 struct DrawVertices {
     static const Type kType = DrawVertices_Type;
 
-    DrawVertices(const SkPaint& paint,
+    DrawVertices(const SkPaint* paint,
                  SkCanvas::VertexMode vmode,
                  int vertexCount,
                  SkPoint* vertices,
@@ -363,7 +380,7 @@ struct DrawVertices {
         , indices(indices)
         , indexCount(indexCount) {}
 
-    SkPaint paint;
+    SharedPaint paint;
     SkCanvas::VertexMode vmode;
     int vertexCount;
     PODArray<SkPoint> vertices;
@@ -374,6 +391,36 @@ struct DrawVertices {
     int indexCount;
 };
 
+// Not a canvas call: SkRecordMergeImageRects() builds these from runs of DrawImageRect sharing an
+// image, paint, and constraint.  Each src maps to its dst by a uniform scale and translate, so the
+// whole run can be drawn as one atlas where that's cheaper.
+struct DrawImageRects {
+    static const Type kType = DrawImageRects_Type;
+
+    DrawImageRects(SkPaint* paint,
+                   const SkImage* image,
+                   SkRect* srcs,
+                   SkRect* dsts,
+                   int count,
+                   SkCanvas::SrcRectConstraint constraint,
+                   const SkRect& cull)
+        : paint(paint)
+        , image(image)
+        , srcs(srcs)
+        , dsts(dsts)
+        , count(count)
+        , constraint(constraint)
+        , cull(cull) {}
+
+    Optional<SkPaint> paint;
+    RefBox<const SkImage> image;
+    PODArray<SkRect> srcs;
+    PODArray<SkRect> dsts;
+    int count;
+    SkCanvas::SrcRectConstraint constraint;
+    SkRect cull;  // The union of all the dsts.
+};
+
 #undef RECORD0
 #undef RECORD1
 #undef RECORD2
@@ -141,6 +141,19 @@ public:
      */
     void silentFlush();
 
+    /**
+     * When enabled, flush() hands the pending commands to a thread of the
+     * canvas' own, which plays them back into the surface while the next
+     * ones are recorded, and flushes the surface's canvas when done. Anything
+     * that needs the surface's pixels, such as newImageSnapshot(), waits for
+     * that thread first, as does deleting the canvas; the surface should not
+     * be used directly before then. Flushes made while a save() is
+     * outstanding are not handed off, but played back right away. The
+     * surface must be one that can be drawn into from another thread, such
+     * as a raster surface. Disabled by default.
+     */
+    void setThreadedPlayback(bool threaded);
+
     SkDrawFilter* setDrawFilter(SkDrawFilter* filter) override;
 
 protected:
@@ -21,6 +21,14 @@ public:
     virtual void removeCanvas(SkCanvas*);
     virtual void removeAll();
 
+    /**
+     *  When enabled, drawPicture() plays the picture back into the N canvases concurrently on an
+     *  SkTaskGroup rather than one after another. Canvases backed by a GrContext are still drawn
+     *  serially on the calling thread, overlapping with the others. To fan a whole frame out,
+     *  record it once with SkPictureRecorder and draw the picture here. Disabled by default.
+     */
+    void setConcurrentPicturePlayback(bool concurrent) { fConcurrentPicturePlayback = concurrent; }
+
     ///////////////////////////////////////////////////////////////////////////
     // These are forwarded to the N canvases we're referencing
 
@@ -82,6 +90,8 @@ protected:
     class Iter;
 
 private:
+    bool fConcurrentPicturePlayback;
+
     typedef SkCanvas INHERITED;
 };
 
@@ -23,6 +23,18 @@ public:
     static size_t ApproximateBytesUsed(const SkPicture* pict) {
         return pict->approximateBytesUsed();
     }
+
+    /**
+     *  Decodes the lazily-generated bitmaps and images the picture would draw into deviceClip
+     *  (or its whole cull rect if NULL) under matrix, so playback finds them already decoded.
+     *
+     *  Each image is requested at the scale and filter quality it is drawn with, so mipmaps and
+     *  high-quality rescales land in the SkResourceCache as well.  Decoding runs in parallel
+     *  across the SkTaskGroup threads; this call returns once it is all done.  It is safe to
+     *  call this on another thread ahead of, or even during, playback of the same picture.
+     */
+    static void PredecodeImages(const SkPicture*, const SkMatrix& matrix = SkMatrix::I(),
+                                const SkIRect* deviceClip = NULL);
 };
 
 #endif
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRingBufferTracer_DEFINED
+#define SkRingBufferTracer_DEFINED
+
+#include "SkEventTracer.h"
+
+class SkWStream;
+
+/**
+ *  An SkEventTracer that keeps the most recent trace events of each thread in a fixed size
+ *  ring buffer, cheap enough to leave installed in production:
+ *
+ *      SkEventTracer::SetInstance(new SkRingBufferTracer);
+ *      ...
+ *      tracer->setEnabled(true);   // when a frame should be profiled
+ *      ...
+ *      tracer->dumpJSON(&stream);  // load the result in chrome://tracing
+ *
+ *  Recording an event takes no locks: each thread appends to its own buffer, overwriting its
+ *  oldest events once the buffer is full. Only the first event a thread records and dumpJSON()
+ *  take a lock. While disabled the TRACE_EVENT macros see every category as off, so they cost
+ *  one load and branch.
+ *
+ *  Events recorded with TRACE_EVENT_FLAG_COPY, and string arguments that need copying, are not
+ *  kept since the ring buffers only store pointers.
+ */
+class SK_API SkRingBufferTracer : public SkEventTracer {
+public:
+    explicit SkRingBufferTracer(int eventsPerThread = 16384);
+    ~SkRingBufferTracer() override;
+
+    /** Turns recording of every category on or off. Recording starts off. */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     *  Writes the events currently held by every thread's buffer in the Chrome trace event
+     *  JSON format. Events still being recorded while this runs may be dumped torn, so it is
+     *  best called between frames.
+     */
+    void dumpJSON(SkWStream*) const;
+
+    const uint8_t* getCategoryGroupEnabled(const char* name) override;
+    const char* getCategoryGroupName(const uint8_t* categoryEnabledFlag) override;
+
+    SkEventTracer::Handle addTraceEvent(char phase,
+                                        const uint8_t* categoryEnabledFlag,
+                                        const char* name,
+                                        uint64_t id,
+                                        int32_t numArgs,
+                                        const char** argNames,
+                                        const uint8_t* argTypes,
+                                        const uint64_t* argValues,
+                                        uint8_t flags) override;
+
+    void updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                  const char* name,
+                                  SkEventTracer::Handle handle) override;
+
+    struct ThreadBuffer;
+
+private:
+    ThreadBuffer* threadBuffer();
+
+    struct Impl;
+    Impl*   fImpl;
+
+    typedef SkEventTracer INHERITED;
+};
+
+#endif
@@ -418,6 +418,175 @@ void sk_canvas_draw_picture(sk_canvas_t* ccanvas, const sk_picture_t* cpicture,
     AsCanvas(ccanvas)->drawPicture(AsPicture(cpicture), matrixPtr, AsPaint(cpaint));
 }
 
+namespace {
+
+// Reads the 4-byte words of an sk_canvas_execute() stream, failing rather than overrunning.
+class OpReader {
+public:
+    OpReader(const void* ops, size_t length)
+        : fCurr(static_cast<const char*>(ops))
+        , fStop(fCurr + length) {}
+
+    bool atEnd() const { return fCurr == fStop; }
+
+    bool readU32(uint32_t* value) { return this->read(value, 1); }
+    bool readFloats(float* values, int count) { return this->read(values, count); }
+
+    bool readRect(SkRect* rect) { return this->readFloats(&rect->fLeft, 4); }
+
+    template <typename T>
+    bool readHandle(const T* const* table, uint32_t count, const T** handle) {
+        uint32_t index;
+        if (!this->readU32(&index) || index >= count || !table[index]) {
+            return false;
+        }
+        *handle = table[index];
+        return true;
+    }
+
+    // As readHandle(), but SK_CANVAS_NO_PAINT reads as NULL.
+    bool readOptionalPaint(const sk_canvas_handles_t& handles, const SkPaint** paint) {
+        uint32_t index;
+        if (!this->readU32(&index)) {
+            return false;
+        }
+        if (SK_CANVAS_NO_PAINT == index) {
+            *paint = NULL;
+            return true;
+        }
+        if (index >= handles.paintCount || !handles.paints[index]) {
+            return false;
+        }
+        *paint = AsPaint(handles.paints[index]);
+        return true;
+    }
+
+private:
+    template <typename T>
+    bool read(T* values, int count) {
+        SK_COMPILE_ASSERT(sizeof(T) == 4, op_stream_words_are_4_bytes);
+        const size_t size = count * sizeof(T);
+        if (SkToSizeT(fStop - fCurr) < size) {
+            return false;
+        }
+        memcpy(values, fCurr, size);
+        fCurr += size;
+        return true;
+    }
+
+    const char* fCurr;
+    const char* fStop;
+};
+
+}  // namespace
+
+bool sk_canvas_execute(sk_canvas_t* ccanvas, const void* ops, size_t length,
+                       const sk_canvas_handles_t* chandles) {
+    SkASSERT(chandles);
+    SkCanvas* canvas = AsCanvas(ccanvas);
+    const sk_canvas_handles_t& handles = *chandles;
+    OpReader reader(ops, length);
+
+    while (!reader.atEnd()) {
+        uint32_t op;
+        if (!reader.readU32(&op)) {
+            return false;
+        }
+
+        float args[9];
+        SkRect rect;
+        const sk_paint_t* cpaint;
+        const sk_path_t* cpath;
+        const sk_image_t* cimage;
+        const SkPaint* paint;
+        switch (op) {
+            case SAVE_SK_CANVAS_OP:
+                canvas->save();
+                break;
+            case RESTORE_SK_CANVAS_OP:
+                canvas->restore();
+                break;
+            case TRANSLATE_SK_CANVAS_OP:
+                if (!reader.readFloats(args, 2)) {
+                    return false;
+                }
+                canvas->translate(args[0], args[1]);
+                break;
+            case SCALE_SK_CANVAS_OP:
+                if (!reader.readFloats(args, 2)) {
+                    return false;
+                }
+                canvas->scale(args[0], args[1]);
+                break;
+            case CONCAT_SK_CANVAS_OP: {
+                sk_matrix_t cmatrix;
+                if (!reader.readFloats(cmatrix.mat, 9)) {
+                    return false;
+                }
+                SkMatrix matrix;
+                from_c_matrix(&cmatrix, &matrix);
+                canvas->concat(matrix);
+            } break;
+            case CLIP_RECT_SK_CANVAS_OP:
+                if (!reader.readRect(&rect)) {
+                    return false;
+                }
+                canvas->clipRect(rect);
+                break;
+            case CLIP_PATH_SK_CANVAS_OP:
+                if (!reader.readHandle(handles.paths, handles.pathCount, &cpath)) {
+                    return false;
+                }
+                canvas->clipPath(AsPath(*cpath));
+                break;
+            case DRAW_PAINT_SK_CANVAS_OP:
+                if (!reader.readHandle(handles.paints, handles.paintCount, &cpaint)) {
+                    return false;
+                }
+                canvas->drawPaint(AsPaint(*cpaint));
+                break;
+            case DRAW_RECT_SK_CANVAS_OP:
+            case DRAW_OVAL_SK_CANVAS_OP:
+                if (!reader.readRect(&rect) ||
+                    !reader.readHandle(handles.paints, handles.paintCount, &cpaint)) {
+                    return false;
+                }
+                if (DRAW_RECT_SK_CANVAS_OP == op) {
+                    canvas->drawRect(rect, AsPaint(*cpaint));
+                } else {
+                    canvas->drawOval(rect, AsPaint(*cpaint));
+                }
+                break;
+            case DRAW_PATH_SK_CANVAS_OP:
+                if (!reader.readHandle(handles.paths, handles.pathCount, &cpath) ||
+                    !reader.readHandle(handles.paints, handles.paintCount, &cpaint)) {
+                    return false;
+                }
+                canvas->drawPath(AsPath(*cpath), AsPaint(*cpaint));
+                break;
+            case DRAW_IMAGE_SK_CANVAS_OP:
+                if (!reader.readHandle(handles.images, handles.imageCount, &cimage) ||
+                    !reader.readFloats(args, 2) ||
+                    !reader.readOptionalPaint(handles, &paint)) {
+                    return false;
+                }
+                canvas->drawImage(AsImage(cimage), args[0], args[1], paint);
+                break;
+            case DRAW_IMAGE_RECT_SK_CANVAS_OP:
+                if (!reader.readHandle(handles.images, handles.imageCount, &cimage) ||
+                    !reader.readRect(&rect) ||
+                    !reader.readOptionalPaint(handles, &paint)) {
+                    return false;
+                }
+                canvas->drawImageRect(AsImage(cimage), rect, paint);
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 sk_surface_t* sk_surface_new_raster(const sk_imageinfo_t* cinfo,
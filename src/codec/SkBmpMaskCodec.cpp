@@ -30,6 +30,9 @@ static bool conversion_possible(const SkImageInfo& dst,
         // Allow output to kN32
         case kN32_SkColorType:
             return true;
+        // Allow output to kRGB_565 from opaque inputs
+        case kRGB_565_SkColorType:
+            return kOpaque_SkAlphaType == src.alphaType();
         default:
             return false;
     }
@@ -63,7 +66,9 @@ SkCodec::Result SkBmpMaskCodec::onGetPixels(const SkImageInfo& dstInfo,
         // Subsets are not supported.
         return kUnimplemented;
     }
-    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+    int sampleX, sampleY;
+    if (!get_sample_sizes(this->getInfo().dimensions(), dstInfo.dimensions(),
+            &sampleX, &sampleY)) {
         SkCodecPrintf("Error: scaling not supported.\n");
         return kInvalidScale;
     }
@@ -74,22 +79,27 @@ SkCodec::Result SkBmpMaskCodec::onGetPixels(const SkImageInfo& dstInfo,
     }
 
     // Initialize a the mask swizzler
-    if (!this->initializeSwizzler(dstInfo)) {
+    if (!this->initializeSwizzler(dstInfo, sampleX)) {
         SkCodecPrintf("Error: cannot initialize swizzler.\n");
         return kInvalidConversion;
     }
 
-    return this->decode(dstInfo, dst, dstRowBytes, opts);
+    return this->decode(dstInfo, dst, dstRowBytes, opts, sampleY);
 }
 
-bool SkBmpMaskCodec::initializeSwizzler(const SkImageInfo& dstInfo) {
+SkISize SkBmpMaskCodec::onGetScaledDimensions(float desiredScale) const {
+    return get_sampled_dimensions(this->getInfo().dimensions(), desiredScale);
+}
+
+bool SkBmpMaskCodec::initializeSwizzler(const SkImageInfo& dstInfo, int sampleX) {
     // Allocate space for a row buffer
-    const size_t rowBytes = SkAlign4(compute_row_bytes(dstInfo.width(), this->bitsPerPixel()));
+    const size_t rowBytes = SkAlign4(compute_row_bytes(this->getInfo().width(),
+            this->bitsPerPixel()));
     fSrcBuffer.reset(SkNEW_ARRAY(uint8_t, rowBytes));
 
     // Create the swizzler
     fMaskSwizzler.reset(SkMaskSwizzler::CreateMaskSwizzler(
-            dstInfo, fMasks, this->bitsPerPixel()));
+            dstInfo, fMasks, this->bitsPerPixel(), sampleX));
 
     if (NULL == fMaskSwizzler.get()) {
         return false;
@@ -100,36 +110,48 @@ bool SkBmpMaskCodec::initializeSwizzler(const SkImageInfo& dstInfo) {
 
 /*
  * Performs the decoding
+ * Rows that are not kept by sampleY are skipped.
  */
 SkCodec::Result SkBmpMaskCodec::decode(const SkImageInfo& dstInfo,
                                        void* dst, size_t dstRowBytes,
-                                       const Options& opts) {
+                                       const Options& opts, int sampleY) {
     // Set constant values
-    const int width = dstInfo.width();
+    const int srcHeight = this->getInfo().height();
     const int height = dstInfo.height();
-    const size_t rowBytes = SkAlign4(compute_row_bytes(width, this->bitsPerPixel()));
+    const size_t rowBytes = SkAlign4(compute_row_bytes(this->getInfo().width(),
+            this->bitsPerPixel()));
 
     // Iterate over rows of the image
     uint8_t* srcRow = fSrcBuffer.get();
-    for (int y = 0; y < height; y++) {
-        // Read a row of the input
-        if (this->stream()->read(srcRow, rowBytes) != rowBytes) {
+    int rowsDecoded = 0;
+    for (int y = 0; y < srcHeight; y++) {
+        int row = SkBmpCodec::kBottomUp_RowOrder == this->rowOrder() ? srcHeight - 1 - y : y;
+        const bool necessary = is_coord_necessary(row, sampleY, height);
+
+        // Read a row of the input, or skip it if it is not sampled
+        const size_t bytes = necessary ? this->stream()->read(srcRow, rowBytes) :
+                this->stream()->skip(rowBytes);
+        if (bytes != rowBytes) {
             SkCodecPrintf("Warning: incomplete input stream.\n");
             // Fill the destination image on failure
             SkPMColor fillColor = dstInfo.alphaType() == kOpaque_SkAlphaType ?
                     SK_ColorBLACK : SK_ColorTRANSPARENT;
             if (kNo_ZeroInitialized == opts.fZeroInitialized || 0 != fillColor) {
-                void* dstStart = this->getDstStartRow(dst, dstRowBytes, y);
-                SkSwizzler::Fill(dstStart, dstInfo, dstRowBytes, dstInfo.height() - y, fillColor,
+                void* dstStart = this->getDstStartRow(dst, dstRowBytes, rowsDecoded);
+                SkSwizzler::Fill(dstStart, dstInfo, dstRowBytes, height - rowsDecoded, fillColor,
                         NULL);
             }
             return kIncompleteInput;
         }
 
+        if (!necessary) {
+            continue;
+        }
+
         // Decode the row in destination format
-        int row = SkBmpCodec::kBottomUp_RowOrder == this->rowOrder() ? height - 1 - y : y;
-        void* dstRow = SkTAddOffset<void>(dst, row * dstRowBytes);
+        void* dstRow = SkTAddOffset<void>(dst, (row / sampleY) * dstRowBytes);
         fMaskSwizzler->swizzle(dstRow, srcRow);
+        rowsDecoded++;
     }
 
     // Finished decoding the entire image
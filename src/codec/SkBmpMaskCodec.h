@@ -37,12 +37,14 @@ protected:
                        size_t dstRowBytes, const Options&, SkPMColor*,
                        int*) override;
 
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+
 private:
 
-    bool initializeSwizzler(const SkImageInfo& dstInfo);
+    bool initializeSwizzler(const SkImageInfo& dstInfo, int sampleX);
 
     Result decode(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
-                  const Options& opts);
+                  const Options& opts, int sampleY);
 
     SkAutoTDelete<SkMasks>              fMasks;        // owned
     SkAutoTDelete<SkMaskSwizzler>       fMaskSwizzler;
@@ -35,6 +35,9 @@ static bool conversion_possible(const SkImageInfo& dst,
         // Allow output to kIndex_8 from compatible inputs
         case kIndex_8_SkColorType:
             return kIndex_8_SkColorType == src.colorType();
+        // Allow output to kRGB_565 from opaque inputs
+        case kRGB_565_SkColorType:
+            return kOpaque_SkAlphaType == src.alphaType();
         default:
             return false;
     }
@@ -73,7 +76,9 @@ SkCodec::Result SkBmpStandardCodec::onGetPixels(const SkImageInfo& dstInfo,
         // Subsets are not supported.
         return kUnimplemented;
     }
-    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+    int sampleX, sampleY;
+    if (!get_sample_sizes(this->getInfo().dimensions(), dstInfo.dimensions(),
+            &sampleX, &sampleY)) {
         SkCodecPrintf("Error: scaling not supported.\n");
         return kInvalidScale;
     }
@@ -93,12 +98,16 @@ SkCodec::Result SkBmpStandardCodec::onGetPixels(const SkImageInfo& dstInfo,
     copy_color_table(dstInfo, fColorTable, inputColorPtr, inputColorCount);
 
     // Initialize a swizzler if necessary
-    if (!this->initializeSwizzler(dstInfo, opts)) {
+    if (!this->initializeSwizzler(dstInfo, opts, sampleX)) {
         SkCodecPrintf("Error: cannot initialize swizzler.\n");
         return kInvalidConversion;
     }
 
-    return this->decode(dstInfo, dst, dstRowBytes, opts);
+    return this->decode(dstInfo, dst, dstRowBytes, opts, sampleX, sampleY);
+}
+
+SkISize SkBmpStandardCodec::onGetScaledDimensions(float desiredScale) const {
+    return get_sampled_dimensions(this->getInfo().dimensions(), desiredScale);
 }
 
 /*
@@ -197,9 +206,10 @@ SkCodec::Result SkBmpStandardCodec::onGetPixels(const SkImageInfo& dstInfo,
 }
 
 bool SkBmpStandardCodec::initializeSwizzler(const SkImageInfo& dstInfo,
-                                            const Options& opts) {
+                                            const Options& opts, int sampleX) {
     // Allocate space for a row buffer
-    const size_t rowBytes = SkAlign4(compute_row_bytes(dstInfo.width(), this->bitsPerPixel()));
+    const size_t rowBytes = SkAlign4(compute_row_bytes(this->getInfo().width(),
+            this->bitsPerPixel()));
     fSrcBuffer.reset(SkNEW_ARRAY(uint8_t, rowBytes));
 
     // Get swizzler configuration
@@ -237,7 +247,7 @@ bool SkBmpStandardCodec::initializeSwizzler(const SkImageInfo& dstInfo,
 
     // Create swizzler
     fSwizzler.reset(SkSwizzler::CreateSwizzler(config,
-            colorPtr, dstInfo, opts.fZeroInitialized));
+            colorPtr, dstInfo, opts.fZeroInitialized, sampleX));
 
     if (NULL == fSwizzler.get()) {
         return false;
@@ -278,19 +288,33 @@ static uint32_t get_fill_color_or_index(uint16_t bitsPerPixels, SkAlphaType alph
 
 /*
  * Performs the bitmap decoding for standard input format
+ * Rows and columns that are not kept by the sample sizes are skipped.
  */
 SkCodec::Result SkBmpStandardCodec::decode(const SkImageInfo& dstInfo,
                                    void* dst, size_t dstRowBytes,
-                                   const Options& opts) {
+                                   const Options& opts, int sampleX, int sampleY) {
     // Set constant values
+    const int srcHeight = this->getInfo().height();
     const int width = dstInfo.width();
     const int height = dstInfo.height();
-    const size_t rowBytes = SkAlign4(compute_row_bytes(width, this->bitsPerPixel()));
+    const size_t rowBytes = SkAlign4(compute_row_bytes(this->getInfo().width(),
+            this->bitsPerPixel()));
 
     // Iterate over rows of the image
-    for (int y = 0; y < height; y++) {
-        // Read a row of the input
-        if (this->stream()->read(fSrcBuffer.get(), rowBytes) != rowBytes) {
+    int rowsDecoded = 0;
+    for (int y = 0; y < srcHeight; y++) {
+        int srcRow;
+        if (SkBmpCodec::kTopDown_RowOrder == this->rowOrder()) {
+            srcRow = y;
+        } else {
+            srcRow = srcHeight - 1 - y;
+        }
+        const bool necessary = is_coord_necessary(srcRow, sampleY, height);
+
+        // Read a row of the input, or skip it if it is not sampled
+        const size_t bytes = necessary ? this->stream()->read(fSrcBuffer.get(), rowBytes) :
+                this->stream()->skip(rowBytes);
+        if (bytes != rowBytes) {
             SkCodecPrintf("Warning: incomplete input stream.\n");
             // Fill the destination image on failure
             // Get the fill color/index and check if it is 0
@@ -302,52 +326,54 @@ SkCodec::Result SkBmpStandardCodec::decode(const SkImageInfo& dstInfo,
                 // Get a pointer to the color table if it exists
                 const SkPMColor* colorPtr = get_color_ptr(fColorTable.get());
 
-                void* dstStart = this->getDstStartRow(dst, dstRowBytes, y);
-                SkSwizzler::Fill(dstStart, dstInfo, dstRowBytes, dstInfo.height() - y,
+                void* dstStart = this->getDstStartRow(dst, dstRowBytes, rowsDecoded);
+                SkSwizzler::Fill(dstStart, dstInfo, dstRowBytes, height - rowsDecoded,
                         fillColorOrIndex, colorPtr);
             }
             return kIncompleteInput;
         }
 
-        // Decode the row in destination format
-        uint32_t row;
-        if (SkBmpCodec::kTopDown_RowOrder == this->rowOrder()) {
-            row = y;
-        } else {
-            row = height - 1 - y;
+        if (!necessary) {
+            continue;
         }
 
-        void* dstRow = SkTAddOffset<void>(dst, row * dstRowBytes);
+        // Decode the row in destination format
+        void* dstRow = SkTAddOffset<void>(dst, (srcRow / sampleY) * dstRowBytes);
         fSwizzler->swizzle(dstRow, fSrcBuffer.get());
+        rowsDecoded++;
     }
 
     // Finally, apply the AND mask for bmp-in-ico images
     if (fInIco) {
         // The AND mask is always 1 bit per pixel
-        const size_t rowBytes = SkAlign4(compute_row_bytes(width, 1));
+        const size_t rowBytes = SkAlign4(compute_row_bytes(this->getInfo().width(), 1));
+        const int startX = get_start_coord(sampleX);
 
         SkPMColor* dstPtr = (SkPMColor*) dst;
-        for (int y = 0; y < height; y++) {
+        for (int y = 0; y < srcHeight; y++) {
             // The srcBuffer will at least be large enough
             if (stream()->read(fSrcBuffer.get(), rowBytes) != rowBytes) {
                 SkCodecPrintf("Warning: incomplete AND mask for bmp-in-ico.\n");
                 return kIncompleteInput;
             }
 
-            int row;
+            int srcRow;
             if (SkBmpCodec::kBottomUp_RowOrder == this->rowOrder()) {
-                row = height - y - 1;
+                srcRow = srcHeight - y - 1;
             } else {
-                row = y;
+                srcRow = y;
+            }
+            if (!is_coord_necessary(srcRow, sampleY, height)) {
+                continue;
             }
 
             SkPMColor* dstRow =
-                    SkTAddOffset<SkPMColor>(dstPtr, row * dstRowBytes);
+                    SkTAddOffset<SkPMColor>(dstPtr, (srcRow / sampleY) * dstRowBytes);
 
             for (int x = 0; x < width; x++) {
                 int quotient;
                 int modulus;
-                SkTDivMod(x, 8, &quotient, &modulus);
+                SkTDivMod(startX + x * sampleX, 8, &quotient, &modulus);
                 uint32_t shift = 7 - modulus;
                 uint32_t alphaBit =
                         (fSrcBuffer.get()[quotient] >> shift) & 0x1;
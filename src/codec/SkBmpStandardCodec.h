@@ -45,6 +45,8 @@ protected:
                        size_t dstRowBytes, const Options&, SkPMColor*,
                        int*) override;
 
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+
 private:
 
     /*
@@ -53,9 +55,10 @@ private:
      */
     bool createColorTable(SkAlphaType alphaType, int* colorCount);
 
-    bool initializeSwizzler(const SkImageInfo& dstInfo, const Options& opts);
+    bool initializeSwizzler(const SkImageInfo& dstInfo, const Options& opts, int sampleX);
 
-    Result decode(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes, const Options& opts);
+    Result decode(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes, const Options& opts,
+                  int sampleX, int sampleY);
 
     SkAutoTUnref<SkColorTable>          fColorTable;     // owned
     const uint32_t                      fNumColors;
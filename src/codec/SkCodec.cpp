@@ -12,11 +12,18 @@
 #include "SkCodec_libico.h"
 #include "SkCodec_libpng.h"
 #include "SkCodec_wbmp.h"
+#include "SkCodecFrameCache.h"
 #include "SkCodecPriv.h"
+#include "SkCodecScratch.h"
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
 #include "SkJpegCodec.h"
 #endif
+#include "SkNextID.h"
+#include "SkRWBuffer.h"
 #include "SkStream.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
+#include "SkTraceEvent.h"
 #include "SkWebpCodec.h"
 
 struct DecoderProc {
@@ -42,7 +49,12 @@ SkCodec* SkCodec::NewFromStream(SkStream* stream) {
     }
 
     SkAutoTDelete<SkStream> streamDeleter(stream);
-    
+    if (!stream->rewind()) {
+        // Sniffing and then decoding read the start of the stream twice, so keep what is read.
+        stream = SkSharedStreamBuffer::NewReader(streamDeleter.detach());
+        streamDeleter.reset(stream);
+    }
+
     SkAutoTDelete<SkCodec> codec(NULL);
     for (uint32_t i = 0; i < SK_ARRAY_COUNT(gDecoderProcs); i++) {
         DecoderProc proc = gDecoderProcs[i];
@@ -79,9 +91,13 @@ SkCodec::SkCodec(const SkImageInfo& info, SkStream* stream)
     : fInfo(info)
     , fStream(stream)
     , fNeedsRewind(false)
+    , fIncrementalDecodeStarted(false)
+    , fUniqueID(SkNextID::ImageID())
 {}
 
-SkCodec::~SkCodec() {}
+SkCodec::~SkCodec() {
+    SkCodecFrameCache::Purge(fUniqueID);
+}
 
 SkCodec::RewindState SkCodec::rewindIfNeeded() {
     // Store the value of fNeedsRewind so we can update it. Next read will
@@ -95,28 +111,43 @@ SkCodec::RewindState SkCodec::rewindIfNeeded() {
                              : kCouldNotRewind_RewindState;
 }
 
-SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
-                                   const Options* options, SkPMColor ctable[], int* ctableCount) {
+/*
+ * Checks the parameters shared by getPixels and startIncrementalDecode.  Clears ctable and
+ * ctableCount if info is not kIndex_8_SkColorType.
+ */
+static SkCodec::Result check_pixel_params(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                                          SkPMColor** ctable, int** ctableCount) {
     if (kUnknown_SkColorType == info.colorType()) {
-        return kInvalidConversion;
+        return SkCodec::kInvalidConversion;
     }
     if (NULL == pixels) {
-        return kInvalidParameters;
+        return SkCodec::kInvalidParameters;
     }
     if (rowBytes < info.minRowBytes()) {
-        return kInvalidParameters;
+        return SkCodec::kInvalidParameters;
     }
 
     if (kIndex_8_SkColorType == info.colorType()) {
-        if (NULL == ctable || NULL == ctableCount) {
-            return kInvalidParameters;
+        if (NULL == *ctable || NULL == *ctableCount) {
+            return SkCodec::kInvalidParameters;
         }
     } else {
-        if (ctableCount) {
-            *ctableCount = 0;
+        if (*ctableCount) {
+            **ctableCount = 0;
         }
-        ctableCount = NULL;
-        ctable = NULL;
+        *ctableCount = NULL;
+        *ctable = NULL;
+    }
+    return SkCodec::kSuccess;
+}
+
+SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                                   const Options* options, SkPMColor ctable[], int* ctableCount) {
+    TRACE_EVENT2("disabled-by-default-skia", "SkCodec::getPixels()",
+                 "width", info.width(), "height", info.height());
+    const Result paramsResult = check_pixel_params(info, pixels, rowBytes, &ctable, &ctableCount);
+    if (kSuccess != paramsResult) {
+        return paramsResult;
     }
 
     // Default options.
@@ -124,7 +155,9 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
     if (NULL == options) {
         options = &optsStorage;
     }
-    const Result result = this->onGetPixels(info, pixels, rowBytes, *options, ctable, ctableCount);
+    const Result result = 0 == options->fFrameIndex
+            ? this->onGetPixels(info, pixels, rowBytes, *options, ctable, ctableCount)
+            : this->getFramePixels(info, pixels, rowBytes, *options, ctable, ctableCount);
 
     if ((kIncompleteInput == result || kSuccess == result) && ctableCount) {
         SkASSERT(*ctableCount >= 0 && *ctableCount <= 256);
@@ -135,3 +168,200 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
 SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes) {
     return this->getPixels(info, pixels, rowBytes, NULL, NULL, NULL);
 }
+
+SkCodec::Result SkCodec::decodeToBitmap(SkBitmap* dst, const SkImageInfo* infoPtr,
+                                        SkBitmap::Allocator* allocator, const Options* options) {
+    const SkImageInfo info = infoPtr ? *infoPtr : this->getInfo();
+    if (kIndex_8_SkColorType == info.colorType()) {
+        dst->reset();
+        return kInvalidConversion;
+    }
+    if (!dst->setInfo(info) || !dst->tryAllocPixels(allocator, NULL)) {
+        dst->reset();
+        return kInvalidParameters;
+    }
+
+    SkAutoLockPixels alp(*dst);
+    if (!dst->getPixels()) {
+        dst->reset();
+        return kInvalidParameters;
+    }
+    const Result result = this->getPixels(dst->info(), dst->getPixels(), dst->rowBytes(),
+                                          options, NULL, NULL);
+    if (kSuccess != result && kIncompleteInput != result) {
+        dst->reset();
+        return result;
+    }
+    dst->setImmutable();
+    return result;
+}
+
+SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& info, void* pixels,
+                                                size_t rowBytes, const Options* options,
+                                                SkPMColor ctable[], int* ctableCount) {
+    fIncrementalDecodeStarted = false;
+    const Result paramsResult = check_pixel_params(info, pixels, rowBytes, &ctable, &ctableCount);
+    if (kSuccess != paramsResult) {
+        return paramsResult;
+    }
+
+    // Default options.
+    Options optsStorage;
+    if (NULL == options) {
+        options = &optsStorage;
+    }
+    if (0 != options->fFrameIndex) {
+        // Only the first frame can be decoded incrementally.
+        return kUnimplemented;
+    }
+    const Result result = this->onStartIncrementalDecode(info, pixels, rowBytes, *options,
+                                                         ctable, ctableCount);
+    if (kSuccess == result) {
+        fIncrementalDecodeStarted = true;
+        if (ctableCount) {
+            SkASSERT(*ctableCount >= 0 && *ctableCount <= 256);
+        }
+    }
+    return result;
+}
+
+SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& info, void* pixels,
+                                                size_t rowBytes) {
+    return this->startIncrementalDecode(info, pixels, rowBytes, NULL, NULL, NULL);
+}
+
+SkCodec::Result SkCodec::incrementalDecode(const void* data, size_t length, int* rowsDecoded) {
+    int rowsStorage;
+    if (NULL == rowsDecoded) {
+        rowsDecoded = &rowsStorage;
+    }
+    *rowsDecoded = 0;
+    if (!fIncrementalDecodeStarted) {
+        return kInvalidParameters;
+    }
+    if (NULL == data && length > 0) {
+        return kInvalidParameters;
+    }
+    return this->onIncrementalDecode(data, length, rowsDecoded);
+}
+
+bool SkCodec::getFrameInfo(int index, FrameInfo* info) {
+    if (index < 0 || index >= this->getFrameCount()) {
+        return false;
+    }
+    return this->onGetFrameInfo(index, info);
+}
+
+// Every kKeyFrameInterval'th frame that gets decoded is cached, so seeking or looping an
+// animation only decodes from the nearest cached frame rather than from the first.
+static const int kKeyFrameInterval = 8;
+
+SkCodec::Result SkCodec::getFramePixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                                        const Options& options, SkPMColor ctable[],
+                                        int* ctableCount) {
+    const int index = options.fFrameIndex;
+    FrameInfo frameInfo;
+    if (!this->getFrameInfo(index, &frameInfo)) {
+        return kInvalidParameters;
+    }
+    if (kNone == frameInfo.fRequiredFrame) {
+        return this->onGetPixels(info, pixels, rowBytes, options, ctable, ctableCount);
+    }
+
+    // Earlier frames show through, so the frames are composited in a single color type.
+    if (kN32_SkColorType != info.colorType()) {
+        return kInvalidConversion;
+    }
+    if (options.fSubset) {
+        return kUnimplemented;
+    }
+
+    // Collect the frames to draw, top first, stopping at a frame the pixels already hold.
+    SkSTArray<16, int, true> frames;
+    bool onClearCanvas = false;
+    for (int frame = index; !onClearCanvas; frame = frameInfo.fRequiredFrame) {
+        if ((frame == options.fPriorFrame && frame != index) ||
+                SkCodecFrameCache::Find(fUniqueID, frame, info, pixels, rowBytes)) {
+            break;
+        }
+        frames.push_back(frame);
+        if (!this->getFrameInfo(frame, &frameInfo)) {
+            return kInvalidInput;
+        }
+        onClearCanvas = kNone == frameInfo.fRequiredFrame;
+    }
+
+    Options frameOptions = options;
+    if (!onClearCanvas) {
+        frameOptions.fZeroInitialized = kNo_ZeroInitialized;
+    }
+    for (int i = frames.count() - 1; i >= 0; i--) {
+        frameOptions.fFrameIndex = frames[i];
+        const Result result = this->onGetPixels(info, pixels, rowBytes, frameOptions, NULL, NULL);
+        if (kSuccess != result) {
+            return result;
+        }
+        if (0 == frames[i] % kKeyFrameInterval) {
+            SkCodecFrameCache::Add(fUniqueID, frames[i], info, pixels, rowBytes);
+        }
+        // Only the bottom frame is drawn onto untouched memory.
+        frameOptions.fZeroInitialized = kNo_ZeroInitialized;
+    }
+    return kSuccess;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void decode_batch_item(SkCodec::BatchItem* item) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(item->fEncoded));
+    if (!codec) {
+        item->fResult = SkCodec::kInvalidInput;
+        return;
+    }
+    const SkISize size = codec->getScaledDimensions(item->fScale);
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType)
+                                             .makeWH(size.width(), size.height());
+    if (!item->fBitmap.tryAllocPixels(info)) {
+        item->fResult = SkCodec::kInvalidParameters;
+        return;
+    }
+    item->fResult = codec->getPixels(info, item->fBitmap.getPixels(), item->fBitmap.rowBytes());
+}
+
+namespace {
+
+// Each worker claims the next undecoded item until none are left, so slow images don't hold up
+// a whole share of the batch.
+struct BatchWorker {
+    SkCodec::BatchItem* fItems;
+    int                 fCount;
+    int32_t*            fNext;
+
+    static void Run(BatchWorker* worker) {
+        SkCodecScratchPool pool;  // Shared by all of this worker's decodes.
+        for (int i = sk_atomic_inc(worker->fNext); i < worker->fCount;
+                 i = sk_atomic_inc(worker->fNext)) {
+            decode_batch_item(&worker->fItems[i]);
+        }
+    }
+};
+
+}  // namespace
+
+void SkCodec::DecodeBatch(BatchItem items[], int count) {
+    TRACE_EVENT1("disabled-by-default-skia", "SkCodec::DecodeBatch()", "count", count);
+    if (count <= 0) {
+        return;
+    }
+    int32_t next = 0;
+    const int workerCount = SkTMin(count, sk_num_cores());
+    SkAutoTArray<BatchWorker> workers(workerCount);
+    for (int i = 0; i < workerCount; i++) {
+        workers[i].fItems = items;
+        workers[i].fCount = count;
+        workers[i].fNext  = &next;
+    }
+    SkTaskGroup tg;
+    tg.batch(BatchWorker::Run, workers.get(), workerCount);
+    tg.wait();
+}
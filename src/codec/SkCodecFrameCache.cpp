@@ -0,0 +1,103 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCodecFrameCache.h"
+#include "SkResourceCache.h"
+
+static uint64_t make_shared_id(uint32_t codecID) {
+    uint64_t sharedID = SkSetFourByteTag('c', 'o', 'd', 'c');
+    return (sharedID << 32) | codecID;
+}
+
+static void copy_rows(const SkImageInfo& info, void* dst, size_t dstRowBytes, const void* src,
+                      size_t srcRowBytes) {
+    const size_t rowLen = info.minRowBytes();
+    for (int y = 0; y < info.height(); y++) {
+        memcpy(dst, src, rowLen);
+        dst = SkTAddOffset<void>(dst, dstRowBytes);
+        src = SkTAddOffset<const void>(src, srcRowBytes);
+    }
+}
+
+namespace {
+static unsigned gFrameKeyNamespaceLabel;
+
+struct FrameKey : public SkResourceCache::Key {
+public:
+    FrameKey(uint32_t codecID, int frame, const SkImageInfo& info)
+        : fCodecID(codecID)
+        , fFrame(frame)
+        , fWidth(info.width())
+        , fHeight(info.height())
+        , fColorType(info.colorType())
+        , fAlphaType(info.alphaType())
+    {
+        this->init(&gFrameKeyNamespaceLabel, make_shared_id(codecID),
+                   sizeof(fCodecID) + sizeof(fFrame) + sizeof(fWidth) + sizeof(fHeight) +
+                   sizeof(fColorType) + sizeof(fAlphaType));
+    }
+
+    uint32_t    fCodecID;
+    int32_t     fFrame;
+    int32_t     fWidth;
+    int32_t     fHeight;
+    int32_t     fColorType;
+    int32_t     fAlphaType;
+};
+
+struct FrameRec : public SkResourceCache::Rec {
+    FrameRec(uint32_t codecID, int frame, const SkBitmap& bitmap)
+        : fKey(codecID, frame, bitmap.info())
+        , fBitmap(bitmap)
+    {}
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fBitmap.getSize(); }
+    const char* getCategory() const override { return "codec-frame"; }
+
+    struct Dst {
+        void*   fPixels;
+        size_t  fRowBytes;
+    };
+
+    // Copies under the cache's lock, so the pixels can't be purged while we read them.
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* context) {
+        const FrameRec& rec = static_cast<const FrameRec&>(baseRec);
+        const Dst* dst = static_cast<const Dst*>(context);
+        copy_rows(rec.fBitmap.info(), dst->fPixels, dst->fRowBytes, rec.fBitmap.getPixels(),
+                  rec.fBitmap.rowBytes());
+        return true;
+    }
+
+private:
+    FrameKey    fKey;
+    SkBitmap    fBitmap;
+};
+} // namespace
+
+bool SkCodecFrameCache::Find(uint32_t codecID, int frame, const SkImageInfo& info, void* dst,
+                             size_t rowBytes) {
+    FrameKey key(codecID, frame, info);
+    FrameRec::Dst context = { dst, rowBytes };
+    return SkResourceCache::Find(key, FrameRec::Finder, &context);
+}
+
+void SkCodecFrameCache::Add(uint32_t codecID, int frame, const SkImageInfo& info,
+                            const void* pixels, size_t rowBytes) {
+    SkBitmap bitmap;
+    if (!bitmap.tryAllocPixels(info)) {
+        return;
+    }
+    copy_rows(info, bitmap.getPixels(), bitmap.rowBytes(), pixels, rowBytes);
+    bitmap.setImmutable();
+    SkResourceCache::Add(SkNEW_ARGS(FrameRec, (codecID, frame, bitmap)));
+}
+
+void SkCodecFrameCache::Purge(uint32_t codecID) {
+    SkResourceCache::PostPurgeSharedID(make_shared_id(codecID));
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecFrameCache_DEFINED
+#define SkCodecFrameCache_DEFINED
+
+#include "SkImageInfo.h"
+
+/**
+ *  Keeps fully composited frames of animated images in the SkResourceCache, so that decoding a
+ *  frame that is drawn on top of earlier ones can start from the nearest cached frame instead of
+ *  from the first.  Entries are keyed by the codec's unique ID, the frame, and the dst info.
+ */
+class SkCodecFrameCache {
+public:
+    /**
+     *  If frame was cached for this codec and info, copy its pixels into dst and return true.
+     */
+    static bool Find(uint32_t codecID, int frame, const SkImageInfo& info, void* dst,
+                     size_t rowBytes);
+
+    /**
+     *  Cache a copy of frame's pixels.
+     */
+    static void Add(uint32_t codecID, int frame, const SkImageInfo& info, const void* pixels,
+                    size_t rowBytes);
+
+    /**
+     *  Drop every frame cached for this codec.  Called when the codec is deleted.
+     */
+    static void Purge(uint32_t codecID);
+};
+
+#endif
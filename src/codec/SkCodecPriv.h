@@ -10,6 +10,7 @@
 
 #include "SkColorTable.h"
 #include "SkImageInfo.h"
+#include "SkScalar.h"
 #include "SkSwizzler.h"
 #include "SkTypes.h"
 #include "SkUtils.h"
@@ -52,6 +53,82 @@ static inline bool valid_alpha(SkAlphaType dstAlpha, SkAlphaType srcAlpha) {
     return true;
 }
 
+/*
+ * Sampled decodes keep every sampleSize-th pixel in each direction, starting
+ * with the pixel at get_start_coord(sampleSize).
+ */
+static inline int get_start_coord(int sampleSize) {
+    return sampleSize / 2;
+}
+
+/*
+ * Get the dimension of a src dimension once it is sampled by sampleSize
+ */
+static inline int get_scaled_dimension(int srcDimension, int sampleSize) {
+    if (sampleSize > srcDimension) {
+        return 1;
+    }
+    return srcDimension / sampleSize;
+}
+
+/*
+ * Get the integer sample size that supports desiredScale.  The sampled image
+ * is never smaller than requested, except that each dimension is at least 1.
+ */
+static inline int get_sample_size(const SkISize& srcDims, float desiredScale) {
+    if (desiredScale >= 1.0f) {
+        return 1;
+    }
+    const int maxSampleSize = SkTMax(srcDims.width(), srcDims.height());
+    if (desiredScale * maxSampleSize <= 1.0f) {
+        return maxSampleSize;
+    }
+    // Use 1 / desiredScale if float error has only nudged it off of an integer
+    const float inverse = 1.0f / desiredScale;
+    int sampleSize = SkScalarRoundToInt(inverse);
+    if (!SkScalarNearlyEqual(inverse, (float) sampleSize)) {
+        sampleSize = SkScalarFloorToInt(inverse);
+    }
+    return SkTMin(maxSampleSize, sampleSize);
+}
+
+/*
+ * Dimensions reported by codecs that decode scaled images by sampling
+ */
+static inline SkISize get_sampled_dimensions(const SkISize& srcDims, float desiredScale) {
+    const int sampleSize = get_sample_size(srcDims, desiredScale);
+    return SkISize::Make(get_scaled_dimension(srcDims.width(), sampleSize),
+                         get_scaled_dimension(srcDims.height(), sampleSize));
+}
+
+/*
+ * Find the sample sizes that take srcDims to dstDims.  Returns false if dstDims
+ * cannot be produced by sampling srcDims.
+ */
+static inline bool get_sample_sizes(const SkISize& srcDims, const SkISize& dstDims,
+                                    int* sampleX, int* sampleY) {
+    if (dstDims.width() <= 0 || dstDims.height() <= 0 ||
+            dstDims.width() > srcDims.width() || dstDims.height() > srcDims.height()) {
+        return false;
+    }
+    *sampleX = srcDims.width() / dstDims.width();
+    *sampleY = srcDims.height() / dstDims.height();
+    return get_scaled_dimension(srcDims.width(), *sampleX) == dstDims.width() &&
+           get_scaled_dimension(srcDims.height(), *sampleY) == dstDims.height();
+}
+
+/*
+ * Whether the src row or column at srcCoord is kept when sampling by sampleSize
+ * down to scaledDim.  If so, it lands at srcCoord / sampleSize in the dst.
+ */
+static inline bool is_coord_necessary(int srcCoord, int sampleSize, int scaledDim) {
+    const int startCoord = get_start_coord(sampleSize);
+    if (srcCoord < startCoord || srcCoord / sampleSize >= scaledDim) {
+        return false;
+    }
+    return 0 == (srcCoord - startCoord) % sampleSize;
+}
+
 /*
  * If there is a color table, get a pointer to the colors, otherwise return NULL
  */
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCodecScratch.h"
+#include "SkTLS.h"
+
+static void* create_current() { return SkNEW_ARGS(SkCodecScratchPool*, (NULL)); }
+static void delete_current(void* current) {
+    SkDELETE(static_cast<SkCodecScratchPool**>(current));
+}
+
+static SkCodecScratchPool** current() {
+    return static_cast<SkCodecScratchPool**>(SkTLS::Get(create_current, delete_current));
+}
+
+SkCodecScratchPool::SkCodecScratchPool() : fCount(0) {
+    SkASSERT(NULL == *current());
+    *current() = this;
+}
+
+SkCodecScratchPool::~SkCodecScratchPool() {
+    SkASSERT(this == *current());
+    *current() = NULL;
+    for (int i = 0; i < fCount; i++) {
+        sk_free(fBuffers[i].fPtr);
+    }
+}
+
+SkCodecScratchPool* SkCodecScratchPool::Current() {
+    return *current();
+}
+
+void* SkCodecScratchPool::take(size_t size, size_t* capacity) {
+    // Take the smallest buffer that fits, leaving the bigger ones for bigger rows.
+    int best = -1;
+    for (int i = 0; i < fCount; i++) {
+        if (fBuffers[i].fCapacity >= size &&
+            (best < 0 || fBuffers[i].fCapacity < fBuffers[best].fCapacity)) {
+            best = i;
+        }
+    }
+    if (best < 0) {
+        return NULL;
+    }
+    void* ptr = fBuffers[best].fPtr;
+    *capacity = fBuffers[best].fCapacity;
+    fBuffers[best] = fBuffers[--fCount];
+    return ptr;
+}
+
+void SkCodecScratchPool::give(void* ptr, size_t capacity) {
+    if (fCount < kMaxBuffers) {
+        fBuffers[fCount].fPtr = ptr;
+        fBuffers[fCount].fCapacity = capacity;
+        fCount++;
+        return;
+    }
+    // Full, so keep the bigger of ptr and our smallest buffer.
+    int smallest = 0;
+    for (int i = 1; i < fCount; i++) {
+        if (fBuffers[i].fCapacity < fBuffers[smallest].fCapacity) {
+            smallest = i;
+        }
+    }
+    if (capacity > fBuffers[smallest].fCapacity) {
+        SkTSwap(ptr, fBuffers[smallest].fPtr);
+        SkTSwap(capacity, fBuffers[smallest].fCapacity);
+    }
+    sk_free(ptr);
+}
+
+void* SkCodecScratch::reset(size_t size) {
+    if (fPtr && fCapacity >= size) {
+        return fPtr;
+    }
+    this->release();
+    if (SkCodecScratchPool* pool = SkCodecScratchPool::Current()) {
+        fPtr = pool->take(size, &fCapacity);
+    }
+    if (!fPtr) {
+        fPtr = sk_malloc_throw(size);
+        fCapacity = size;
+    }
+    return fPtr;
+}
+
+void SkCodecScratch::release() {
+    if (!fPtr) {
+        return;
+    }
+    if (SkCodecScratchPool* pool = SkCodecScratchPool::Current()) {
+        pool->give(fPtr, fCapacity);
+    } else {
+        sk_free(fPtr);
+    }
+    fPtr = NULL;
+    fCapacity = 0;
+}
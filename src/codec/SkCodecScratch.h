@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecScratch_DEFINED
+#define SkCodecScratch_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  While one of these is alive, row buffers that the calling thread's codecs free through
+ *  SkCodecScratch are kept here and handed to the next codec that asks, instead of going back to
+ *  malloc.  SkCodec::DecodeBatch() runs each of its workers under one.  Pools don't nest.
+ */
+class SkCodecScratchPool : SkNoncopyable {
+public:
+    SkCodecScratchPool();
+    ~SkCodecScratchPool();
+
+    /** Returns the calling thread's pool, or NULL. */
+    static SkCodecScratchPool* Current();
+
+private:
+    friend class SkCodecScratch;
+
+    // Returns a kept buffer of at least size bytes, setting *capacity to its size, or NULL.
+    void* take(size_t size, size_t* capacity);
+    // Keeps ptr for reuse, or frees it if the pool is full.
+    void give(void* ptr, size_t capacity);
+
+    static const int kMaxBuffers = 4;
+    struct Buffer {
+        void*  fPtr;
+        size_t fCapacity;
+    };
+    Buffer fBuffers[kMaxBuffers];
+    int    fCount;
+};
+
+/**
+ *  Memory for a codec's row buffers.  Works like SkAutoMalloc, but recycles its memory through
+ *  the thread's SkCodecScratchPool, if there is one.
+ */
+class SkCodecScratch : SkNoncopyable {
+public:
+    SkCodecScratch() : fPtr(NULL), fCapacity(0) {}
+    explicit SkCodecScratch(size_t size) : fPtr(NULL), fCapacity(0) { this->reset(size); }
+    ~SkCodecScratch() { this->release(); }
+
+    /** Returns at least size bytes, keeping the current memory if it is big enough. */
+    void* reset(size_t size);
+
+    void* get() const { return fPtr; }
+
+private:
+    void release();
+
+    void*  fPtr;
+    size_t fCapacity;
+};
+
+#endif
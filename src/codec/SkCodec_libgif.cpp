@@ -9,8 +9,10 @@
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
 #include "SkColorTable.h"
+#include "SkData.h"
 #include "SkGifInterlaceIter.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
 #include "SkSwizzler.h"
 #include "SkUtils.h"
 
@@ -130,6 +132,64 @@ static uint32_t find_trans_index(const SavedImage& image) {
     return SK_MaxU32;
 }
 
+/*
+ * Finds where a frame is drawn, moving or shrinking it to fit inside the canvas.
+ * Returns false if the frame has no pixels.
+ */
+static bool get_frame_rect(const GifImageDesc& desc, int32_t width, int32_t height,
+                           SkIRect* rect) {
+    int32_t imageLeft = desc.Left;
+    int32_t imageTop = desc.Top;
+    int32_t innerWidth = desc.Width;
+    int32_t innerHeight = desc.Height;
+    // Fail on non-positive dimensions
+    if (innerWidth <= 0 || innerHeight <= 0) {
+        return false;
+    }
+    // Treat the following cases as warnings and try to fix
+    if (innerWidth > width) {
+        gif_warning("Inner image too wide, shrinking.\n");
+        innerWidth = width;
+        imageLeft = 0;
+    } else if (imageLeft + innerWidth > width) {
+        gif_warning("Shifting inner image to left to fit.\n");
+        imageLeft = width - innerWidth;
+    } else if (imageLeft < 0) {
+        gif_warning("Shifting image to right to fit\n");
+        imageLeft = 0;
+    }
+    if (innerHeight > height) {
+        gif_warning("Inner image too tall, shrinking.\n");
+        innerHeight = height;
+        imageTop = 0;
+    } else if (imageTop + innerHeight > height) {
+        gif_warning("Shifting inner image up to fit.\n");
+        imageTop = height - innerHeight;
+    } else if (imageTop < 0) {
+        gif_warning("Shifting image down to fit\n");
+        imageTop = 0;
+    }
+    rect->setXYWH(imageLeft, imageTop, innerWidth, innerHeight);
+    return true;
+}
+
+/*
+ * Reads past the image data of the current frame without decompressing it
+ */
+static bool skip_image_data(GifFileType* gif) {
+    int32_t codeSize;
+    GifByteType* codeBlock;
+    if (GIF_ERROR == DGifGetCode(gif, &codeSize, &codeBlock)) {
+        return false;
+    }
+    while (NULL != codeBlock) {
+        if (GIF_ERROR == DGifGetCodeNext(gif, &codeBlock)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /*
  * Read enough of the stream to initialize the SkGifCodec.
  * Returns a bool representing success or failure.
@@ -208,6 +268,13 @@ SkGifCodec::SkGifCodec(const SkImageInfo& srcInfo, SkStream* stream,
                        GifFileType* gif)
     : INHERITED(srcInfo, stream)
     , fGif(gif)
+    , fIncDst(NULL)
+    , fIncDstRowBytes(0)
+    , fIncColorPtr(NULL)
+    , fIncColorCount(NULL)
+    , fIncRowsDecoded(0)
+    , fIncComplete(false)
+    , fFramesParsed(false)
 {}
 
 /*
@@ -234,6 +301,13 @@ static bool conversion_possible(const SkImageInfo& dst,
     }
 }
 
+/*
+ * Reports the dimensions of a sampled decode
+ */
+SkISize SkGifCodec::onGetScaledDimensions(float desiredScale) const {
+    return get_sampled_dimensions(this->getInfo().dimensions(), desiredScale);
+}
+
 /*
  * Initiates the gif decode
  */
@@ -243,17 +317,254 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                         SkPMColor* inputColorPtr,
                                         int* inputColorCount) {
     // Rewind if necessary
+    if (!this->rewindGif()) {
+        return kCouldNotRewind;
+    }
+
+    return this->decodeFrame(fGif, opts.fFrameIndex, dstInfo, dst, dstRowBytes, opts,
+                             inputColorPtr, inputColorCount, NULL);
+}
+
+bool SkGifCodec::rewindGif() {
     SkCodec::RewindState rewindState = this->rewindIfNeeded();
     if (rewindState == kCouldNotRewind_RewindState) {
-        return kCouldNotRewind;
+        return false;
     } else if (rewindState == kRewound_RewindState) {
         GifFileType* gifOut = NULL;
         if (!ReadHeader(this->stream(), NULL, &gifOut)) {
-            return kCouldNotRewind;
-        } else {
-            SkASSERT(NULL != gifOut);
-            fGif.reset(gifOut);
+            return false;
         }
+        SkASSERT(NULL != gifOut);
+        fGif.reset(gifOut);
+    }
+    return true;
+}
+
+/*
+ * Reads every record in the gif, skipping the image data, to find where each frame is drawn,
+ * how long it is shown, and how it is disposed of.
+ */
+void SkGifCodec::parseFrames() {
+    if (fFramesParsed) {
+        return;
+    }
+    fFramesParsed = true;
+    if (!this->rewindGif()) {
+        return;
+    }
+
+    // The graphics control extension that applies to the next image
+    int duration = 0;
+    Disposal disposal = kNotSpecified_Disposal;
+    bool hasTransparency = false;
+
+    const int32_t width = this->getInfo().width();
+    const int32_t height = this->getInfo().height();
+    GifFileType* gif = fGif;
+    GifRecordType recordType;
+    do {
+        // Keep the frames found before any error, so a truncated gif shows what it has.
+        if (GIF_ERROR == DGifGetRecordType(gif, &recordType)) {
+            break;
+        }
+
+        if (IMAGE_DESC_RECORD_TYPE == recordType) {
+            if (GIF_ERROR == DGifGetImageDesc(gif)) {
+                break;
+            }
+            Frame& frame = fFrames.push_back();
+            if (!get_frame_rect(gif->Image, width, height, &frame.fRect)) {
+                frame.fRect.setEmpty();
+            }
+            frame.fDuration = duration;
+            frame.fDisposal = disposal;
+            frame.fHasTransparency = hasTransparency;
+            duration = 0;
+            disposal = kNotSpecified_Disposal;
+            hasTransparency = false;
+            if (!skip_image_data(gif)) {
+                break;
+            }
+        } else if (EXTENSION_RECORD_TYPE == recordType) {
+            int32_t extFunction;
+            GifByteType* extData;
+            if (GIF_ERROR == DGifGetExtension(gif, &extFunction, &extData)) {
+                break;
+            }
+            // The first block of a graphics control extension holds a packed byte,
+            // the delay in hundredths of a second, and the transparent index.
+            if (GRAPHICS_EXT_FUNC_CODE == extFunction && NULL != extData && extData[0] >= 4) {
+                const uint8_t packed = extData[1];
+                duration = (extData[2] | (extData[3] << 8)) * 10;
+                hasTransparency = SkToBool(packed & 1);
+                switch ((packed >> 2) & 7) {
+                    case 0:  disposal = kNotSpecified_Disposal;      break;
+                    case 2:  disposal = kRestoreBackground_Disposal; break;
+                    case 3:  disposal = kRestorePrevious_Disposal;   break;
+                    // Values beyond those defined are treated as keep.
+                    default: disposal = kKeep_Disposal;              break;
+                }
+            }
+            while (NULL != extData) {
+                if (GIF_ERROR == DGifGetExtensionNext(gif, &extData)) {
+                    recordType = TERMINATE_RECORD_TYPE;
+                    break;
+                }
+            }
+        }
+    } while (TERMINATE_RECORD_TYPE != recordType);
+
+    // Find the canvas each frame is drawn on.
+    const SkIRect canvas = SkIRect::MakeWH(width, height);
+    for (int i = 0; i < fFrames.count(); i++) {
+        Frame& frame = fFrames[i];
+        frame.fRequiredFrame = kNone;
+        if (0 == i || (frame.fRect == canvas && !frame.fHasTransparency)) {
+            // Nothing earlier shows through.
+            continue;
+        }
+        // A frame restored to previous leaves the canvas as it was before that frame
+        // was drawn, which is the canvas that frame was drawn on.
+        int required = i - 1;
+        while (kNone != required && kRestorePrevious_Disposal == fFrames[required].fDisposal) {
+            required = fFrames[required].fRequiredFrame;
+        }
+        frame.fRequiredFrame = required;
+    }
+}
+
+int SkGifCodec::onGetFrameCount() {
+    this->parseFrames();
+    return fFrames.count();
+}
+
+bool SkGifCodec::onGetFrameInfo(int index, FrameInfo* info) {
+    this->parseFrames();
+    if (index >= fFrames.count()) {
+        return false;
+    }
+    info->fRequiredFrame = fFrames[index].fRequiredFrame;
+    info->fDuration = fFrames[index].fDuration;
+    return true;
+}
+
+/*
+ * Returns the dst row that the src row srcY is swizzled into, or NULL if the row
+ * is not sampled
+ */
+static void* get_dst_row(void* dst, size_t dstRowBytes, int32_t srcY, int sampleY,
+                         int32_t dstHeight) {
+    if (!is_coord_necessary(srcY, sampleY, dstHeight)) {
+        return NULL;
+    }
+    return SkTAddOffset<void>(dst, dstRowBytes * (srcY / sampleY));
+}
+
+/*
+ * Returns the number of dst rows, starting from the top, that are complete once the
+ * first srcRowsDecoded rows of the src have been decoded
+ */
+static int get_dst_rows_decoded(int32_t srcRowsDecoded, int sampleY, int32_t dstHeight) {
+    const int32_t startY = get_start_coord(sampleY);
+    if (srcRowsDecoded <= startY) {
+        return 0;
+    }
+    return SkTMin(dstHeight, (srcRowsDecoded - startY + sampleY - 1) / sampleY);
+}
+
+/*
+ * Clears the dst pixels sampled from rect of the src to transparent
+ */
+static void clear_rect(const SkIRect& rect, const SkImageInfo& dstInfo, void* dst,
+                       size_t dstRowBytes, int sampleX, int sampleY) {
+    for (int32_t y = rect.fTop; y < rect.fBottom; y++) {
+        uint32_t* dstRow = static_cast<uint32_t*>(get_dst_row(dst, dstRowBytes, y, sampleY,
+                                                              dstInfo.height()));
+        if (NULL == dstRow) {
+            continue;
+        }
+        for (int32_t x = rect.fLeft; x < rect.fRight; x++) {
+            if (is_coord_necessary(x, sampleX, dstInfo.width())) {
+                dstRow[x / sampleX] = SK_ColorTRANSPARENT;
+            }
+        }
+    }
+}
+
+/*
+ * Draws a row of indices that starts at column left of the src onto dstRow, skipping
+ * transparent and out of range indices
+ */
+static void composite_row(uint32_t* dstRow, const uint8_t* src, int32_t left, int32_t width,
+                          const SkPMColor* colorTable, uint32_t colorCount, uint32_t transIndex,
+                          int sampleX, int32_t dstWidth) {
+    for (int32_t x = 0; x < width; x++) {
+        const uint32_t index = src[x];
+        if (index != transIndex && index < colorCount &&
+                is_coord_necessary(left + x, sampleX, dstWidth)) {
+            dstRow[(left + x) / sampleX] = colorTable[index];
+        }
+    }
+}
+
+SkCodec::Result SkGifCodec::compositeFrame(GifFileType* gif, int frameIndex,
+                                           const SkIRect& frameRect, uint32_t transIndex,
+                                           const SkImageInfo& dstInfo, void* dst,
+                                           size_t dstRowBytes, int sampleX, int sampleY) {
+    SkASSERT(kN32_SkColorType == dstInfo.colorType());
+    const Frame& required = fFrames[fFrames[frameIndex].fRequiredFrame];
+    if (kRestoreBackground_Disposal == required.fDisposal) {
+        clear_rect(required.fRect, dstInfo, dst, dstRowBytes, sampleX, sampleY);
+    }
+
+    SkPMColor colorTable[256];
+    uint32_t colorCount = 0;
+    ColorMapObject* colorMap = gif->Image.ColorMap;
+    if (NULL == colorMap) {
+        colorMap = gif->SColorMap;
+    }
+    if (NULL != colorMap) {
+        colorCount = SkTMin(colorMap->ColorCount, 256);
+        for (uint32_t i = 0; i < colorCount; i++) {
+            colorTable[i] = SkPackARGB32(0xFF, colorMap->Colors[i].Red,
+                                         colorMap->Colors[i].Green, colorMap->Colors[i].Blue);
+        }
+    }
+
+    const int32_t innerWidth = frameRect.width();
+    const int32_t innerHeight = frameRect.height();
+    SkAutoTMalloc<uint8_t> line(innerWidth);
+    SkGifInterlaceIter iter(innerHeight);
+    for (int32_t y = 0; y < innerHeight; y++) {
+        // Rows that are not decoded leave the frame below showing.
+        if (GIF_ERROR == DGifGetLine(gif, line.get(), innerWidth)) {
+            return gif_error(SkStringPrintf("Could not decode line %d of %d.\n",
+                    y, innerHeight - 1).c_str(), kIncompleteInput);
+        }
+        const int32_t srcY = frameRect.fTop + (gif->Image.Interlace ? iter.nextY() : y);
+        uint32_t* dstRow = static_cast<uint32_t*>(get_dst_row(dst, dstRowBytes, srcY, sampleY,
+                                                              dstInfo.height()));
+        if (NULL != dstRow) {
+            composite_row(dstRow, line.get(), frameRect.fLeft, innerWidth, colorTable,
+                          colorCount, transIndex, sampleX, dstInfo.width());
+        }
+    }
+    return kSuccess;
+}
+
+/*
+ * Decodes image frameIndex in the gif.  If rowsDecoded is not NULL, it is set to the number
+ * of rows, starting from the top, that were decoded.
+ */
+SkCodec::Result SkGifCodec::decodeFrame(GifFileType* gif, int frameIndex,
+                                        const SkImageInfo& dstInfo,
+                                        void* dst, size_t dstRowBytes,
+                                        const Options& opts,
+                                        SkPMColor* inputColorPtr,
+                                        int* inputColorCount,
+                                        int* rowsDecoded) {
+    if (rowsDecoded) {
+        *rowsDecoded = 0;
     }
 
     // Check for valid input parameters
@@ -261,9 +572,12 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
         // Subsets are not supported.
         return kUnimplemented;
     }
-    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+    int sampleX, sampleY;
+    if (!get_sample_sizes(this->getInfo().dimensions(), dstInfo.dimensions(),
+            &sampleX, &sampleY)) {
         return gif_error("Scaling not supported.\n", kInvalidScale);
     }
+    const bool sampled = sampleX > 1 || sampleY > 1;
     if (!conversion_possible(dstInfo, this->getInfo())) {
         return gif_error("Cannot convert input type to output type.\n",
                 kInvalidConversion);
@@ -280,64 +594,57 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
     int32_t extFunction;
 #endif
 
-    // We will loop over components of gif images until we find an image.  Once
-    // we find an image, we will decode and return it.  While many gif files
-    // contain more than one image, we will simply decode the first image.
-    const int32_t width = dstInfo.width();
-    const int32_t height = dstInfo.height();
+    // We will loop over components of gif images until we find image
+    // frameIndex, skipping the images before it.  Once we find it, we will
+    // decode and return it.
+    const int32_t width = this->getInfo().width();
+    const int32_t height = this->getInfo().height();
     GifRecordType recordType;
     do {
         // Get the current record type
-        if (GIF_ERROR == DGifGetRecordType(fGif, &recordType)) {
+        if (GIF_ERROR == DGifGetRecordType(gif, &recordType)) {
             return gif_error("DGifGetRecordType failed.\n", kInvalidInput);
         }
 
         switch (recordType) {
             case IMAGE_DESC_RECORD_TYPE: {
                 // Read the image descriptor
-                if (GIF_ERROR == DGifGetImageDesc(fGif)) {
+                if (GIF_ERROR == DGifGetImageDesc(gif)) {
                     return gif_error("DGifGetImageDesc failed.\n",
                             kInvalidInput);
                 }
 
                 // If reading the image descriptor is successful, the image
                 // count will be incremented
-                SkASSERT(fGif->ImageCount >= 1);
-                SavedImage* image = &fGif->SavedImages[fGif->ImageCount - 1];
+                SkASSERT(gif->ImageCount >= 1);
+                if (gif->ImageCount - 1 < frameIndex) {
+                    // Skip an earlier frame, and the extensions that applied to it.
+                    if (!skip_image_data(gif)) {
+                        return gif_error("Could not skip frame.\n", kIncompleteInput);
+                    }
+                    FreeExtension(&saveExt);
+                    saveExt.ExtensionBlocks = NULL;
+                    saveExt.ExtensionBlockCount = 0;
+                    break;
+                }
+                SavedImage* image = &gif->SavedImages[gif->ImageCount - 1];
 
                 // Process the descriptor
-                const GifImageDesc& desc = image->ImageDesc;
-                int32_t imageLeft = desc.Left;
-                int32_t imageTop = desc.Top;
-                int32_t innerWidth = desc.Width;
-                int32_t innerHeight = desc.Height;
-                // Fail on non-positive dimensions
-                if (innerWidth <= 0 || innerHeight <= 0) {
+                SkIRect frameRect;
+                if (!get_frame_rect(image->ImageDesc, width, height, &frameRect)) {
                     return gif_error("Invalid dimensions for inner image.\n",
                             kInvalidInput);
                 }
-                // Treat the following cases as warnings and try to fix
-                if (innerWidth > width) {
-                    gif_warning("Inner image too wide, shrinking.\n");
-                    innerWidth = width;
-                    imageLeft = 0;
-                } else if (imageLeft + innerWidth > width) {
-                    gif_warning("Shifting inner image to left to fit.\n");
-                    imageLeft = width - innerWidth;
-                } else if (imageLeft < 0) {
-                    gif_warning("Shifting image to right to fit\n");
-                    imageLeft = 0;
-                }
-                if (innerHeight > height) {
-                    gif_warning("Inner image too tall, shrinking.\n");
-                    innerHeight = height;
-                    imageTop = 0;
-                } else if (imageTop + innerHeight > height) {
-                    gif_warning("Shifting inner image up to fit.\n");
-                    imageTop = height - innerHeight;
-                } else if (imageTop < 0) {
-                    gif_warning("Shifting image down to fit\n");
-                    imageTop = 0;
+                int32_t imageLeft = frameRect.fLeft;
+                int32_t imageTop = frameRect.fTop;
+                int32_t innerWidth = frameRect.width();
+                int32_t innerHeight = frameRect.height();
+
+                // A frame drawn on top of an earlier one leaves it showing through.
+                if (frameIndex > 0 && kNone != fFrames[frameIndex].fRequiredFrame) {
+                    return this->compositeFrame(gif, frameIndex, frameRect,
+                            find_trans_index(saveExt), dstInfo, dst, dstRowBytes,
+                            sampleX, sampleY);
                 }
 
                 // Create a color table to store colors the giflib colorMap
@@ -356,10 +663,10 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                 uint32_t colorCount = 0;
                 // Allocate maximum storage to deal with invalid indices safely
                 const uint32_t maxColors = 256;
-                ColorMapObject* colorMap = fGif->Image.ColorMap;
+                ColorMapObject* colorMap = gif->Image.ColorMap;
                 // If there is no local color table, use the global color table
                 if (NULL == colorMap) {
-                    colorMap = fGif->SColorMap;
+                    colorMap = gif->SColorMap;
                 }
                 if (NULL != colorMap) {
                     colorCount = colorMap->ColorCount;
@@ -375,7 +682,7 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                 }
 
                 // This is used to fill unspecified pixels in the image data.
-                uint32_t fillIndex = fGif->SBackGroundColor;
+                uint32_t fillIndex = gif->SBackGroundColor;
                 ZeroInitialized zeroInit = opts.fZeroInitialized;
 
                 // Gifs have the option to specify the color at a single
@@ -415,18 +722,43 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                     colorTable[i] = colorTable[fillIndex];
                 } 
 
+                // The frame's row y is swizzled into dst row
+                // (rowOffset + y) / sampleY, if that row is sampled.
+                int32_t rowOffset = 0;
+                int32_t scaledHeight = innerHeight;
+
+                // Stores output from dgiflib
+                SkAutoTDeleteArray<uint8_t> buffer(NULL);
+                uint8_t* lineBuffer;
+
                 // Check if image is only a subset of the image frame
                 SkAutoTDelete<SkSwizzler> swizzler(NULL);
-                if (innerWidth < width || innerHeight < height) {
+                if (sampled) {
+                    // The sampled columns may begin anywhere within the frame,
+                    // so each line is placed in a row of the full width that
+                    // is padded with the fill index, and that row is sampled.
+                    if (!skipBackground && (innerWidth < width || innerHeight < height)) {
+                        SkSwizzler::Fill(dst, dstInfo, dstRowBytes, dstInfo.height(),
+                                fillIndex, colorTable);
+                    }
+                    rowOffset = imageTop;
+                    scaledHeight = dstInfo.height();
+
+                    buffer.reset(SkNEW_ARRAY(uint8_t, width));
+                    memset(buffer.get(), fillIndex, width);
+                    lineBuffer = buffer.get() + imageLeft;
+
+                    swizzler.reset(SkSwizzler::CreateSwizzler(
+                            SkSwizzler::kIndex, colorTable, dstInfo, zeroInit,
+                            sampleX));
+                } else if (innerWidth < width || innerHeight < height) {
 
                     // Modify the destination info
                     const SkImageInfo subsetDstInfo =
                             dstInfo.makeWH(innerWidth, innerHeight);
 
-                    // Fill the destination with the fill color
-                    // FIXME: This may not be the behavior that we want for
-                    //        animated gifs where we draw on top of the
-                    //        previous frame.
+                    // Fill the destination with the fill color.  Frames drawn on
+                    // top of an earlier frame are handled by compositeFrame.
                     if (!skipBackground) {
                         SkSwizzler::Fill(dst, dstInfo, dstRowBytes, height,
                                 fillIndex, colorTable);
@@ -439,86 +771,100 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                             dstRowBytes * imageTop +
                             dstBytesPerPixel * imageLeft);
 
+                    buffer.reset(SkNEW_ARRAY(uint8_t, innerWidth));
+                    lineBuffer = buffer.get();
+
                     // Create the subset swizzler
                     swizzler.reset(SkSwizzler::CreateSwizzler(
                             SkSwizzler::kIndex, colorTable, subsetDstInfo,
-                            zeroInit));
+                            zeroInit, 1));
                 } else {
+                    buffer.reset(SkNEW_ARRAY(uint8_t, innerWidth));
+                    lineBuffer = buffer.get();
+
                     // Create the fully dimensional swizzler
                     swizzler.reset(SkSwizzler::CreateSwizzler(
-                            SkSwizzler::kIndex, colorTable, dstInfo, zeroInit));
+                            SkSwizzler::kIndex, colorTable, dstInfo, zeroInit, 1));
                 }
 
-                // Stores output from dgiflib and input to the swizzler
-                SkAutoTDeleteArray<uint8_t>
-                        buffer(SkNEW_ARRAY(uint8_t, innerWidth));
-
                 // Check the interlace flag and iterate over rows of the input
-                if (fGif->Image.Interlace) {
+                if (gif->Image.Interlace) {
                     // In interlace mode, the rows of input are rearranged in
                     // the output image.  We use an iterator to take care of
                     // the rearranging.
                     SkGifInterlaceIter iter(innerHeight);
                     for (int32_t y = 0; y < innerHeight; y++) {
-                        if (GIF_ERROR == DGifGetLine(fGif, buffer.get(),
+                        if (GIF_ERROR == DGifGetLine(gif, lineBuffer,
                                 innerWidth)) {
                             // Recover from error by filling remainder of image
                             if (!skipBackground) {
-                                memset(buffer.get(), fillIndex, innerWidth);
+                                memset(lineBuffer, fillIndex, innerWidth);
                                 for (; y < innerHeight; y++) {
-                                    void* dstRow = SkTAddOffset<void>(dst,
-                                            dstRowBytes * iter.nextY());
-                                    swizzler->swizzle(dstRow, buffer.get());
+                                    void* dstRow = get_dst_row(dst, dstRowBytes,
+                                            rowOffset + iter.nextY(), sampleY, scaledHeight);
+                                    if (NULL != dstRow) {
+                                        swizzler->swizzle(dstRow, buffer.get());
+                                    }
+                                }
+                            }
+                            if (rowsDecoded) {
+                                // Rows are complete once the last pass, which holds
+                                // the odd rows, reaches them.
+                                const int32_t lastPassStart = innerHeight - innerHeight / 2;
+                                int32_t srcRowsDecoded = imageTop;
+                                if (y >= lastPassStart) {
+                                    srcRowsDecoded += 2 * (y - lastPassStart) + 1;
                                 }
+                                *rowsDecoded = get_dst_rows_decoded(srcRowsDecoded, sampleY,
+                                        dstInfo.height());
                             }
                             return gif_error(SkStringPrintf(
                                     "Could not decode line %d of %d.\n",
                                     y, height - 1).c_str(), kIncompleteInput);
                         }
-                        void* dstRow = SkTAddOffset<void>(
-                                dst, dstRowBytes * iter.nextY());
-                        swizzler->swizzle(dstRow, buffer.get());
+                        void* dstRow = get_dst_row(dst, dstRowBytes,
+                                rowOffset + iter.nextY(), sampleY, scaledHeight);
+                        if (NULL != dstRow) {
+                            swizzler->swizzle(dstRow, buffer.get());
+                        }
                     }
                 } else {
                     // Standard mode
-                    void* dstRow = dst;
                     for (int32_t y = 0; y < innerHeight; y++) {
-                        if (GIF_ERROR == DGifGetLine(fGif, buffer.get(),
+                        if (GIF_ERROR == DGifGetLine(gif, lineBuffer,
                                 innerWidth)) {
                             if (!skipBackground) {
-                                SkSwizzler::Fill(dstRow, dstInfo, dstRowBytes,
-                                        innerHeight - y, fillIndex, colorTable);
+                                memset(lineBuffer, fillIndex, innerWidth);
+                                for (int32_t fillY = y; fillY < innerHeight; fillY++) {
+                                    void* dstRow = get_dst_row(dst, dstRowBytes,
+                                            rowOffset + fillY, sampleY, scaledHeight);
+                                    if (NULL != dstRow) {
+                                        swizzler->swizzle(dstRow, buffer.get());
+                                    }
+                                }
+                            }
+                            if (rowsDecoded) {
+                                *rowsDecoded = get_dst_rows_decoded(imageTop + y, sampleY,
+                                        dstInfo.height());
                             }
                             return gif_error(SkStringPrintf(
                                     "Could not decode line %d of %d.\n",
                                     y, height - 1).c_str(), kIncompleteInput);
                         }
-                        swizzler->swizzle(dstRow, buffer.get());
-                        dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
+                        void* dstRow = get_dst_row(dst, dstRowBytes, rowOffset + y,
+                                sampleY, scaledHeight);
+                        if (NULL != dstRow) {
+                            swizzler->swizzle(dstRow, buffer.get());
+                        }
                     }
                 }
 
-                // FIXME: Gif files may have multiple images stored in a single
-                //        file.  This is most commonly used to enable
-                //        animations.  Since we are leaving animated gifs as a
-                //        TODO, we will return kSuccess after decoding the
-                //        first image in the file.  This is the same behavior
-                //        as SkImageDecoder_libgif.
-                //
-                //        Most times this works pretty well, but sometimes it
-                //        doesn't.  For example, I have an animated test image
-                //        where the first image in the file is 1x1, but the
-                //        subsequent images are meaningful.  This currently
-                //        displays the 1x1 image, which is not ideal.  Right
-                //        now I am leaving this as an issue that will be
-                //        addressed when we implement animated gifs.
-                //
-                //        It is also possible (not explicitly disallowed in the
-                //        specification) that gif files provide multiple
-                //        images in a single file that are all meant to be
-                //        displayed in the same frame together.  I will
-                //        currently leave this unimplemented until I find a
-                //        test case that expects this behavior.
+                // Gif files may also provide multiple images that are all
+                // meant to be displayed together.  Those are decoded as
+                // frames with no duration, each drawn on top of the last.
+                if (rowsDecoded) {
+                    *rowsDecoded = dstInfo.height();
+                }
                 return kSuccess;
             }
 
@@ -528,10 +874,10 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                 // Read extension data
 #if GIFLIB_MAJOR < 5
                 if (GIF_ERROR ==
-                        DGifGetExtension(fGif, &saveExt.Function, &extData)) {
+                        DGifGetExtension(gif, &saveExt.Function, &extData)) {
 #else
                 if (GIF_ERROR ==
-                        DGifGetExtension(fGif, &extFunction, &extData)) {
+                        DGifGetExtension(gif, &extFunction, &extData)) {
 #endif
                     return gif_error("Could not get extension.\n",
                             kIncompleteInput);
@@ -553,7 +899,7 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
                                 kIncompleteInput);
                     }
                     // Move to the next block
-                    if (GIF_ERROR == DGifGetExtensionNext(fGif, &extData)) {
+                    if (GIF_ERROR == DGifGetExtensionNext(gif, &extData)) {
                         return gif_error("Could not get next extension.\n",
                                 kIncompleteInput);
                     }
@@ -578,3 +924,78 @@ SkCodec::Result SkGifCodec::onGetPixels(const SkImageInfo& dstInfo,
     return gif_error("Could not find any images to decode in gif file.\n",
             kInvalidInput);
 }
+
+/*
+ * Begins an incremental decode
+ */
+SkCodec::Result SkGifCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo,
+                                                     void* dst, size_t dstRowBytes,
+                                                     const Options& opts,
+                                                     SkPMColor* inputColorPtr,
+                                                     int* inputColorCount) {
+    // Check for valid input parameters
+    if (opts.fSubset) {
+        // Subsets are not supported.
+        return kUnimplemented;
+    }
+    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return gif_error("Scaling not supported.\n", kInvalidScale);
+    }
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return gif_error("Cannot convert input type to output type.\n",
+                kInvalidConversion);
+    }
+
+    // Keep everything the stream holds.  The next call to onGetPixels will rewind and
+    // read the header again.
+    if (kCouldNotRewind_RewindState == this->rewindIfNeeded() || !this->stream()->rewind()) {
+        return kCouldNotRewind;
+    }
+    SkAutoTUnref<SkData> data(SkCopyStreamToData(this->stream()));
+    fIncData.reset();
+    fIncData.append(SkToInt(data->size()), data->bytes());
+
+    fIncDstInfo = dstInfo;
+    fIncDst = dst;
+    fIncDstRowBytes = dstRowBytes;
+    fIncOptions = opts;
+    fIncColorPtr = inputColorPtr;
+    fIncColorCount = inputColorCount;
+    fIncRowsDecoded = 0;
+    fIncComplete = false;
+
+    int rowsDecoded;
+    this->onIncrementalDecode(NULL, 0, &rowsDecoded);
+    return kSuccess;
+}
+
+/*
+ * giflib reads by blocking on a callback, so it cannot suspend when the data runs out.
+ * Instead, we decode again from the start of the data that has arrived so far.
+ */
+SkCodec::Result SkGifCodec::onIncrementalDecode(const void* data, size_t length,
+                                                int* rowsDecoded) {
+    if (fIncComplete) {
+        *rowsDecoded = fIncRowsDecoded;
+        return kSuccess;
+    }
+    fIncData.append(SkToInt(length), static_cast<const uint8_t*>(data));
+
+    SkMemoryStream stream(fIncData.begin(), fIncData.count(), false);
+    SkAutoTCallVProc<GifFileType, CloseGif> gif(open_gif(&stream));
+    if (NULL != gif) {
+        int rows;
+        const Result result = this->decodeFrame(gif, 0, fIncDstInfo, fIncDst, fIncDstRowBytes,
+                fIncOptions, fIncColorPtr, fIncColorCount, &rows);
+        fIncRowsDecoded = SkTMax(fIncRowsDecoded, rows);
+        if (kSuccess == result) {
+            fIncComplete = true;
+            fIncData.reset();
+        }
+    }
+
+    // giflib does not distinguish truncated data from invalid data, so any failure is
+    // treated as a request for more data.
+    *rowsDecoded = fIncRowsDecoded;
+    return fIncComplete ? kSuccess : kIncompleteInput;
+}
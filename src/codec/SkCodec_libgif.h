@@ -7,6 +7,8 @@
 
 #include "SkCodec.h"
 #include "SkImageInfo.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
 
 #include "gif_lib.h"
 
@@ -54,18 +56,64 @@ protected:
      */
     static bool ReadHeader(SkStream* stream, SkCodec** codecOut, GifFileType** gifOut);
 
+    /*
+     * Reports the dimensions of a sampled decode
+     */
+    SkISize onGetScaledDimensions(float desiredScale) const override;
+
     /*
      * Initiates the gif decode
      */
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&,
             SkPMColor*, int32_t*) override;
 
+    /*
+     * Begins an incremental decode
+     */
+    Result onStartIncrementalDecode(const SkImageInfo&, void*, size_t, const Options&,
+            SkPMColor*, int32_t*) override;
+
+    /*
+     * Decodes the data that has arrived so far again from the start, since giflib
+     * cannot suspend
+     */
+    Result onIncrementalDecode(const void*, size_t, int*) override;
+
     SkEncodedFormat onGetEncodedFormat() const override {
         return kGIF_SkEncodedFormat;
     }
 
+    /*
+     * Reads through the whole stream, the first time, to find the frames
+     */
+    int onGetFrameCount() override;
+
+    bool onGetFrameInfo(int index, FrameInfo* info) override;
+
 private:
 
+    /*
+     * How a frame is cleared away before the next frame is drawn, from its graphics
+     * control extension
+     */
+    enum Disposal {
+        kNotSpecified_Disposal,
+        kKeep_Disposal,
+        kRestoreBackground_Disposal,
+        kRestorePrevious_Disposal,
+    };
+
+    /*
+     * What we need to know about each frame in order to draw the frames after it
+     */
+    struct Frame {
+        SkIRect  fRect;             // Within the canvas
+        int      fDuration;         // In milliseconds
+        Disposal fDisposal;
+        bool     fHasTransparency;
+        int      fRequiredFrame;
+    };
+
     /*
      * This function cleans up the gif object after the decode completes
      * It is used in a SkAutoTCallIProc template
@@ -89,7 +137,50 @@ private:
      */
     SkGifCodec(const SkImageInfo& srcInfo, SkStream* stream, GifFileType* gif);
 
+    /*
+     * Rewinds the stream if it has been read, and reads the header into a new fGif
+     */
+    bool rewindGif();
+
+    /*
+     * Fills in fFrames, once
+     */
+    void parseFrames();
+
+    /*
+     * Decodes image frameIndex found by gif, which may be fGif or a gif reading the data
+     * of an incremental decode.  If the frame has a required frame, dst already holds it.
+     *
+     * @param rowsDecoded If not NULL, set to the number of rows, starting from the top, that
+     *                    were decoded
+     */
+    Result decodeFrame(GifFileType* gif, int frameIndex, const SkImageInfo& dstInfo, void* dst,
+            size_t dstRowBytes, const Options& opts, SkPMColor* inputColorPtr,
+            int32_t* inputColorCount, int* rowsDecoded);
+
+    /*
+     * Disposes of the required frame held by dst and draws the image data of frameIndex,
+     * found at frameRect, on top of it, leaving its transparent pixels unchanged
+     */
+    Result compositeFrame(GifFileType* gif, int frameIndex, const SkIRect& frameRect,
+            uint32_t transIndex, const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            int sampleX, int sampleY);
+
     SkAutoTCallVProc<GifFileType, CloseGif> fGif; // owned
 
+    // The parameters and data of an incremental decode
+    SkTDArray<uint8_t>                      fIncData;
+    SkImageInfo                             fIncDstInfo;
+    void*                                   fIncDst;
+    size_t                                  fIncDstRowBytes;
+    Options                                 fIncOptions;
+    SkPMColor*                              fIncColorPtr;
+    int32_t*                                fIncColorCount;
+    int                                     fIncRowsDecoded;
+    bool                                    fIncComplete;
+
+    SkTArray<Frame, true>                   fFrames;
+    bool                                    fFramesParsed;
+
     typedef SkCodec INHERITED;
 };
@@ -7,13 +7,16 @@
 
 #include "SkCodec_libpng.h"
 #include "SkCodecPriv.h"
+#include "SkCodecScratch.h"
 #include "SkColorPriv.h"
 #include "SkColorTable.h"
 #include "SkBitmap.h"
+#include "SkData.h"
 #include "SkMath.h"
 #include "SkScanlineDecoder.h"
 #include "SkSize.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
 #include "SkSwizzler.h"
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -209,6 +212,81 @@ bool SkPngCodec::IsPng(SkStream* stream) {
     return true;
 }
 
+// Sets the transforms that convert the image data to a format the swizzler can read, and
+// computes the default SkColorType and SkAlphaType of the image. Must be called after the
+// header has been read.
+static void set_transforms(png_structp png_ptr, png_infop info_ptr,
+                           SkColorType* skColorTypePtr, SkAlphaType* skAlphaTypePtr) {
+    png_uint_32 origWidth, origHeight;
+    int bitDepth, colorType;
+    png_get_IHDR(png_ptr, info_ptr, &origWidth, &origHeight, &bitDepth,
+                 &colorType, int_p_NULL, int_p_NULL, int_p_NULL);
+
+    // Tell libpng to strip 16 bit/color files down to 8 bits/color
+    if (bitDepth == 16) {
+        png_set_strip_16(png_ptr);
+    }
+#ifdef PNG_READ_PACK_SUPPORTED
+    // Extract multiple pixels with bit depths of 1, 2, and 4 from a single
+    // byte into separate bytes (useful for paletted and grayscale images).
+    if (bitDepth < 8) {
+        png_set_packing(png_ptr);
+    }
+#endif
+    // Expand grayscale images to the full 8 bits from 1, 2, or 4 bits/pixel.
+    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) {
+        png_set_expand_gray_1_2_4_to_8(png_ptr);
+    }
+
+    // Now determine the default SkColorType and SkAlphaType and set required transforms
+    switch (colorType) {
+        case PNG_COLOR_TYPE_PALETTE:
+            *skColorTypePtr = kIndex_8_SkColorType;
+            *skAlphaTypePtr = has_transparency_in_tRNS(png_ptr, info_ptr) ?
+                    kUnpremul_SkAlphaType : kOpaque_SkAlphaType;
+            break;
+        case PNG_COLOR_TYPE_RGB:
+            if (has_transparency_in_tRNS(png_ptr, info_ptr)) {
+                //convert to RGBA with tranparency information in tRNS chunk if it exists
+                png_set_tRNS_to_alpha(png_ptr);
+                *skAlphaTypePtr = kUnpremul_SkAlphaType;
+            } else {
+                //convert to RGBA with Opaque Alpha 
+                png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+                *skAlphaTypePtr = kOpaque_SkAlphaType;
+            }
+            *skColorTypePtr = kN32_SkColorType;
+            break;
+        case PNG_COLOR_TYPE_GRAY:
+            if (has_transparency_in_tRNS(png_ptr, info_ptr)) {
+                //FIXME: support gray with alpha as a color type
+                //convert to RGBA if there is transparentcy info in the tRNS chunk
+                png_set_tRNS_to_alpha(png_ptr);
+                png_set_gray_to_rgb(png_ptr);
+                *skColorTypePtr = kN32_SkColorType;
+                *skAlphaTypePtr = kUnpremul_SkAlphaType;
+            } else {
+                *skColorTypePtr = kGray_8_SkColorType;
+                *skAlphaTypePtr = kOpaque_SkAlphaType;
+            }
+            break;
+        case PNG_COLOR_TYPE_GRAY_ALPHA:
+            //FIXME: support gray with alpha as a color type 
+            //convert to RGBA 
+            png_set_gray_to_rgb(png_ptr);
+            *skColorTypePtr = kN32_SkColorType;
+            *skAlphaTypePtr = kUnpremul_SkAlphaType;
+            break;
+        case PNG_COLOR_TYPE_RGBA:
+            *skColorTypePtr = kN32_SkColorType;
+            *skAlphaTypePtr = kUnpremul_SkAlphaType;
+            break;
+        default:
+            //all the color types have been covered above
+            SkASSERT(false);
+    }
+}
+
 // Reads the header, and initializes the passed in fields, if not NULL (except
 // stream, which is passed to the read function).
 // Returns true on success, in which case the caller is responsible for calling
@@ -266,71 +344,9 @@ static bool read_header(SkStream* stream, png_structp* png_ptrp,
         }
     }
 
-    // Tell libpng to strip 16 bit/color files down to 8 bits/color
-    if (bitDepth == 16) {
-        png_set_strip_16(png_ptr);
-    }
-#ifdef PNG_READ_PACK_SUPPORTED
-    // Extract multiple pixels with bit depths of 1, 2, and 4 from a single
-    // byte into separate bytes (useful for paletted and grayscale images).
-    if (bitDepth < 8) {
-        png_set_packing(png_ptr);
-    }
-#endif
-    // Expand grayscale images to the full 8 bits from 1, 2, or 4 bits/pixel.
-    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8) {
-        png_set_expand_gray_1_2_4_to_8(png_ptr);
-    }
-
-    // Now determine the default SkColorType and SkAlphaType and set required transforms
     SkColorType skColorType;
     SkAlphaType skAlphaType;
-    switch (colorType) {
-        case PNG_COLOR_TYPE_PALETTE:
-            skColorType = kIndex_8_SkColorType;
-            skAlphaType = has_transparency_in_tRNS(png_ptr, info_ptr) ?
-                    kUnpremul_SkAlphaType : kOpaque_SkAlphaType;
-            break;
-        case PNG_COLOR_TYPE_RGB:
-            if (has_transparency_in_tRNS(png_ptr, info_ptr)) {
-                //convert to RGBA with tranparency information in tRNS chunk if it exists
-                png_set_tRNS_to_alpha(png_ptr);
-                skAlphaType = kUnpremul_SkAlphaType;
-            } else {
-                //convert to RGBA with Opaque Alpha 
-                png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
-                skAlphaType = kOpaque_SkAlphaType;
-            }
-            skColorType = kN32_SkColorType;
-            break;
-        case PNG_COLOR_TYPE_GRAY:
-            if (has_transparency_in_tRNS(png_ptr, info_ptr)) {
-                //FIXME: support gray with alpha as a color type
-                //convert to RGBA if there is transparentcy info in the tRNS chunk
-                png_set_tRNS_to_alpha(png_ptr);
-                png_set_gray_to_rgb(png_ptr);
-                skColorType = kN32_SkColorType;
-                skAlphaType = kUnpremul_SkAlphaType;
-            } else {
-                skColorType = kGray_8_SkColorType;
-                skAlphaType = kOpaque_SkAlphaType;
-            }
-            break;
-        case PNG_COLOR_TYPE_GRAY_ALPHA:
-            //FIXME: support gray with alpha as a color type 
-            //convert to RGBA 
-            png_set_gray_to_rgb(png_ptr);
-            skColorType = kN32_SkColorType;
-            skAlphaType = kUnpremul_SkAlphaType;
-            break;
-        case PNG_COLOR_TYPE_RGBA:
-            skColorType = kN32_SkColorType;
-            skAlphaType = kUnpremul_SkAlphaType;
-            break;
-        default:
-            //all the color types have been covered above
-            SkASSERT(false);
-    }
+    set_transforms(png_ptr, info_ptr, &skColorType, &skAlphaType);
 
     // FIXME: Also need to check for sRGB (skbug.com/3471).
 
@@ -371,9 +387,16 @@ SkPngCodec::SkPngCodec(const SkImageInfo& info, SkStream* stream,
     , fNumberPasses(INVALID_NUMBER_PASSES)
     , fReallyHasAlpha(false)
     , fBitDepth(bitDepth)
+    , fIncPng_ptr(NULL)
+    , fIncInfo_ptr(NULL)
+    , fIncDst(NULL)
+    , fIncDstRowBytes(0)
+    , fIncRowsDecoded(0)
+    , fIncComplete(false)
 {}
 
 SkPngCodec::~SkPngCodec() {
+    this->destroyIncrementalReadStruct();
     this->destroyReadStruct();
 }
 
@@ -387,6 +410,15 @@ void SkPngCodec::destroyReadStruct() {
     }
 }
 
+void SkPngCodec::destroyIncrementalReadStruct() {
+    if (fIncPng_ptr) {
+        png_infopp info_pp = fIncInfo_ptr ? &fIncInfo_ptr : NULL;
+        png_destroy_read_struct(&fIncPng_ptr, info_pp, png_infopp_NULL);
+        fIncPng_ptr = NULL;
+        fIncInfo_ptr = NULL;
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Getting the pixels
 ///////////////////////////////////////////////////////////////////////////////
@@ -416,7 +448,8 @@ static bool conversion_possible(const SkImageInfo& dst, const SkImageInfo& src)
 SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
                                                const Options& options,
                                                SkPMColor ctable[],
-                                               int* ctableCount) {
+                                               int* ctableCount,
+                                               int sampleX) {
     // FIXME: Could we use the return value of setjmp to specify the type of
     // error?
     if (setjmp(png_jmpbuf(fPng_ptr))) {
@@ -462,7 +495,7 @@ SkCodec::Result SkPngCodec::initializeSwizzler(const SkImageInfo& requestedInfo,
     // Create the swizzler.  SkPngCodec retains ownership of the color table.
     const SkPMColor* colors = get_color_ptr(fColorTable.get());
     fSwizzler.reset(SkSwizzler::CreateSwizzler(fSrcConfig, colors, requestedInfo,
-            options.fZeroInitialized));
+            options.fZeroInitialized, sampleX));
     if (!fSwizzler) {
         // FIXME: CreateSwizzler could fail for another reason.
         return kUnimplemented;
@@ -499,6 +532,10 @@ bool SkPngCodec::handleRewind() {
     }
 }
 
+SkISize SkPngCodec::onGetScaledDimensions(float desiredScale) const {
+    return get_sampled_dimensions(this->getInfo().dimensions(), desiredScale);
+}
+
 SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void* dst,
                                         size_t dstRowBytes, const Options& options,
                                         SkPMColor ctable[], int* ctableCount) {
@@ -509,7 +546,9 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
         // Subsets are not supported.
         return kUnimplemented;
     }
-    if (requestedInfo.dimensions() != this->getInfo().dimensions()) {
+    int sampleX, sampleY;
+    if (!get_sample_sizes(this->getInfo().dimensions(), requestedInfo.dimensions(),
+            &sampleX, &sampleY)) {
         return kInvalidScale;
     }
     if (!this->handleRewind()) {
@@ -518,7 +557,7 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
 
     // Note that ctable and ctableCount may be modified if there is a color table
     const Result result = this->initializeSwizzler(requestedInfo, options,
-                                                   ctable, ctableCount);
+                                                   ctable, ctableCount, sampleX);
     if (result != kSuccess) {
         return result;
     }
@@ -530,15 +569,17 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
     }
 
     SkASSERT(fNumberPasses != INVALID_NUMBER_PASSES);
-    SkAutoMalloc storage;
+    SkCodecScratch storage;
     void* dstRow = dst;
+    // Rows and columns that are not sampled are decoded by libpng, but never swizzled.
+    const int srcWidth = this->getInfo().width();
+    const int dstHeight = requestedInfo.height();
+    const int bpp = SkSwizzler::BytesPerPixel(fSrcConfig);
+    const size_t srcRowBytes = srcWidth * bpp;
     if (fNumberPasses > 1) {
-        const int width = requestedInfo.width();
-        const int height = requestedInfo.height();
-        const int bpp = SkSwizzler::BytesPerPixel(fSrcConfig);
-        const size_t srcRowBytes = width * bpp;
+        const int height = this->getInfo().height();
 
-        storage.reset(width * height * bpp);
+        storage.reset(height * srcRowBytes);
         uint8_t* const base = static_cast<uint8_t*>(storage.get());
 
         for (int i = 0; i < fNumberPasses; i++) {
@@ -551,19 +592,23 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
         }
 
         // Now swizzle it.
-        uint8_t* srcRow = base;
-        for (int y = 0; y < height; y++) {
+        uint8_t* srcRow = base + get_start_coord(sampleY) * srcRowBytes;
+        for (int y = 0; y < dstHeight; y++) {
             fReallyHasAlpha |= !SkSwizzler::IsOpaque(fSwizzler->swizzle(dstRow, srcRow));
             dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
-            srcRow += srcRowBytes;
+            srcRow += sampleY * srcRowBytes;
         }
     } else {
-        storage.reset(requestedInfo.width() * SkSwizzler::BytesPerPixel(fSrcConfig));
+        storage.reset(srcRowBytes);
         uint8_t* srcRow = static_cast<uint8_t*>(storage.get());
-        for (int y = 0; y < requestedInfo.height(); y++) {
+        // Stop reading once the last sampled row has been swizzled.
+        const int lastRow = get_start_coord(sampleY) + (dstHeight - 1) * sampleY;
+        for (int y = 0; y <= lastRow; y++) {
             png_read_rows(fPng_ptr, &srcRow, png_bytepp_NULL, 1);
-            fReallyHasAlpha |= !SkSwizzler::IsOpaque(fSwizzler->swizzle(dstRow, srcRow));
-            dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
+            if (is_coord_necessary(y, sampleY, dstHeight)) {
+                fReallyHasAlpha |= !SkSwizzler::IsOpaque(fSwizzler->swizzle(dstRow, srcRow));
+                dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
+            }
         }
     }
 
@@ -581,6 +626,139 @@ SkCodec::Result SkPngCodec::onGetPixels(const SkImageInfo& requestedInfo, void*
     return kSuccess;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Incremental decoding
+///////////////////////////////////////////////////////////////////////////////
+
+void SkPngCodec::IncrementalInfoCallback(png_structp png_ptr, png_infop info_ptr) {
+    // Match the transforms of fPng_ptr, so the rows are in the format the swizzler expects.
+    SkColorType colorType;
+    SkAlphaType alphaType;
+    set_transforms(png_ptr, info_ptr, &colorType, &alphaType);
+    png_set_interlace_handling(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+}
+
+void SkPngCodec::IncrementalRowCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum,
+                                        int pass) {
+    SkPngCodec* codec = static_cast<SkPngCodec*>(png_get_progressive_ptr(png_ptr));
+    const int y = rowNum;
+    SkASSERT(y < codec->getInfo().height());
+
+    // libpng passes NULL for the rows of an interlaced image that are not part of this pass.
+    if (row) {
+        uint8_t* srcRow = row;
+        if (codec->fNumberPasses > 1) {
+            const size_t srcRowBytes = codec->getInfo().width() *
+                    SkSwizzler::BytesPerPixel(codec->fSrcConfig);
+            srcRow = SkTAddOffset<uint8_t>(codec->fIncStorage.get(), y * srcRowBytes);
+            png_progressive_combine_row(png_ptr, srcRow, row);
+        }
+        void* dstRow = SkTAddOffset<void>(codec->fIncDst, y * codec->fIncDstRowBytes);
+        codec->fReallyHasAlpha |= !SkSwizzler::IsOpaque(codec->fSwizzler->swizzle(dstRow, srcRow));
+    }
+
+    // Rows are complete once the last pass reaches them.
+    if (pass == codec->fNumberPasses - 1) {
+        codec->fIncRowsDecoded = SkTMax(codec->fIncRowsDecoded, y + 1);
+    }
+}
+
+void SkPngCodec::IncrementalEndCallback(png_structp png_ptr, png_infop) {
+    SkPngCodec* codec = static_cast<SkPngCodec*>(png_get_progressive_ptr(png_ptr));
+    codec->fIncRowsDecoded = codec->getInfo().height();
+    codec->fIncComplete = true;
+}
+
+SkCodec::Result SkPngCodec::onStartIncrementalDecode(const SkImageInfo& requestedInfo, void* dst,
+                                                     size_t dstRowBytes, const Options& options,
+                                                     SkPMColor ctable[], int* ctableCount) {
+    this->destroyIncrementalReadStruct();
+    if (!conversion_possible(requestedInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+    if (options.fSubset) {
+        // Subsets are not supported.
+        return kUnimplemented;
+    }
+    if (requestedInfo.dimensions() != this->getInfo().dimensions()) {
+        return kInvalidScale;
+    }
+    if (!this->handleRewind()) {
+        return kCouldNotRewind;
+    }
+
+    // fPng_ptr has already read the header, so use it to build the swizzler and color table.
+    const Result result = this->initializeSwizzler(requestedInfo, options,
+                                                   ctable, ctableCount, 1);
+    if (result != kSuccess) {
+        return result;
+    }
+    SkASSERT(fNumberPasses != INVALID_NUMBER_PASSES);
+
+    fIncPng_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL,
+                                         sk_error_fn, sk_warning_fn);
+    if (!fIncPng_ptr) {
+        return kInvalidInput;
+    }
+    fIncInfo_ptr = png_create_info_struct(fIncPng_ptr);
+    if (!fIncInfo_ptr) {
+        this->destroyIncrementalReadStruct();
+        return kInvalidInput;
+    }
+    png_set_progressive_read_fn(fIncPng_ptr, this, IncrementalInfoCallback,
+                                IncrementalRowCallback, IncrementalEndCallback);
+
+    fIncDst = dst;
+    fIncDstRowBytes = dstRowBytes;
+    fIncRowsDecoded = 0;
+    fIncComplete = false;
+    if (fNumberPasses > 1) {
+        const size_t size = requestedInfo.width() * requestedInfo.height() *
+                SkSwizzler::BytesPerPixel(fSrcConfig);
+        sk_bzero(fIncStorage.reset(size), size);
+    }
+
+    // Push everything the stream holds, starting again from the signature.
+    SkStream* stream = this->stream();
+    if (!stream->rewind()) {
+        this->destroyIncrementalReadStruct();
+        return kCouldNotRewind;
+    }
+    SkAutoTUnref<SkData> data(SkCopyStreamToData(stream));
+    int rowsDecoded;
+    const Result pushResult = this->onIncrementalDecode(data->data(), data->size(), &rowsDecoded);
+    return kIncompleteInput == pushResult ? kSuccess : pushResult;
+}
+
+SkCodec::Result SkPngCodec::onIncrementalDecode(const void* data, size_t length,
+                                                int* rowsDecoded) {
+    *rowsDecoded = fIncRowsDecoded;
+    if (fIncComplete) {
+        return kSuccess;
+    }
+    if (!fIncPng_ptr) {
+        // A previous call failed.
+        return kInvalidInput;
+    }
+
+    // FIXME: Could we use the return value of setjmp to specify the type of
+    // error?
+    if (setjmp(png_jmpbuf(fIncPng_ptr))) {
+        SkCodecPrintf("setjmp long jump!\n");
+        this->destroyIncrementalReadStruct();
+        *rowsDecoded = fIncRowsDecoded;
+        return fIncComplete ? kSuccess : kInvalidInput;
+    }
+    if (length > 0) {
+        png_process_data(fIncPng_ptr, fIncInfo_ptr,
+                         static_cast<png_bytep>(const_cast<void*>(data)), length);
+    }
+
+    *rowsDecoded = fIncRowsDecoded;
+    return fIncComplete ? kSuccess : kIncompleteInput;
+}
+
 class SkPngScanlineDecoder : public SkScanlineDecoder {
 public:
     SkPngScanlineDecoder(const SkImageInfo& srcInfo, SkPngCodec* codec)
@@ -607,7 +785,7 @@ public:
         }
 
         const SkCodec::Result result = fCodec->initializeSwizzler(dstInfo, options, ctable,
-                                                                  ctableCount);
+                                                                  ctableCount, 1);
         if (result != SkCodec::kSuccess) {
             return result;
         }
@@ -655,7 +833,7 @@ public:
 private:
     SkAutoTDelete<SkPngCodec>   fCodec;
     bool                        fHasAlpha;
-    SkAutoMalloc                fStorage;
+    SkCodecScratch              fStorage;
     uint8_t*                    fSrcRow;
 
     typedef SkScanlineDecoder INHERITED;
@@ -691,7 +869,7 @@ public:
         }
 
         const SkCodec::Result result = fCodec->initializeSwizzler(dstInfo, options, ctable,
-                                                                  ctableCount);
+                                                                  ctableCount, 1);
         if (result != SkCodec::kSuccess) {
             return result;
         }
@@ -32,8 +32,12 @@ public:
     virtual ~SkPngCodec();
 
 protected:
+    SkISize onGetScaledDimensions(float desiredScale) const override;
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, SkPMColor*, int*)
             override;
+    Result onStartIncrementalDecode(const SkImageInfo&, void*, size_t, const Options&,
+                                    SkPMColor*, int*) override;
+    Result onIncrementalDecode(const void*, size_t, int*) override;
     SkEncodedFormat onGetEncodedFormat() const override { return kPNG_SkEncodedFormat; }
     bool onReallyHasAlpha() const override { return fReallyHasAlpha; }
 private:
@@ -49,17 +53,34 @@ private:
     bool                        fReallyHasAlpha;
     int                         fBitDepth;
 
+    // An incremental decode pushes data into a second read struct in progressive mode, so
+    // that libpng can return whenever it runs out of data.
+    png_structp                 fIncPng_ptr;
+    png_infop                   fIncInfo_ptr;
+    void*                       fIncDst;
+    size_t                      fIncDstRowBytes;
+    SkAutoMalloc                fIncStorage;    // Accumulates the passes of interlaced images.
+    int                         fIncRowsDecoded;
+    bool                        fIncComplete;
+
     SkPngCodec(const SkImageInfo&, SkStream*, png_structp, png_infop, int);
 
 
     // Helper to set up swizzler and color table. Also calls png_read_update_info.
+    // Only every sampleX-th pixel of each row is swizzled.
     Result initializeSwizzler(const SkImageInfo& requestedInfo, const Options&,
-                              SkPMColor*, int* ctableCount);
+                              SkPMColor*, int* ctableCount, int sampleX);
 
     // Calls rewindIfNeeded and returns true if the decoder can continue.
     bool handleRewind();
     bool decodePalette(bool premultiply, int* ctableCount);
     void destroyReadStruct();
+    void destroyIncrementalReadStruct();
+
+    // Callbacks for the progressive read struct.
+    static void IncrementalInfoCallback(png_structp, png_infop);
+    static void IncrementalRowCallback(png_structp, png_bytep, png_uint_32, int);
+    static void IncrementalEndCallback(png_structp, png_infop);
 
     friend class SkPngScanlineDecoder;
     friend class SkPngInterlacedScanlineDecoder;
@@ -79,17 +79,15 @@ bool SkWbmpCodec::handleRewind() {
 }
 
 SkSwizzler* SkWbmpCodec::initializeSwizzler(const SkImageInfo& info,
-        const SkPMColor* ctable, const Options& opts) {
-    // TODO (msarett): Reenable support for 565 if it is desired
-    //                 skbug.com/3683
-
+        const SkPMColor* ctable, const Options& opts, int sampleX) {
     // Create the swizzler based on the desired color type
     switch (info.colorType()) {
         case kIndex_8_SkColorType:
         case kN32_SkColorType:
+        case kRGB_565_SkColorType:
         case kGray_8_SkColorType:
             return SkSwizzler::CreateSwizzler(
-                    SkSwizzler::kBit, ctable, info, opts.fZeroInitialized);
+                    SkSwizzler::kBit, ctable, info, opts.fZeroInitialized, sampleX);
         default:
             return NULL;
     }
@@ -111,6 +109,10 @@ SkEncodedFormat SkWbmpCodec::onGetEncodedFormat() const {
     return kWBMP_SkEncodedFormat;
 }
 
+SkISize SkWbmpCodec::onGetScaledDimensions(float desiredScale) const {
+    return get_sampled_dimensions(this->getInfo().dimensions(), desiredScale);
+}
+
 SkCodec::Result SkWbmpCodec::onGetPixels(const SkImageInfo& info,
                                          void* dst,
                                          size_t rowBytes,
@@ -124,7 +126,8 @@ SkCodec::Result SkWbmpCodec::onGetPixels(const SkImageInfo& info,
         // Subsets are not supported.
         return kUnimplemented;
     }
-    if (info.dimensions() != this->getInfo().dimensions()) {
+    int sampleX, sampleY;
+    if (!get_sample_sizes(this->getInfo().dimensions(), info.dimensions(), &sampleX, &sampleY)) {
         return kInvalidScale;
     }
 
@@ -133,16 +136,24 @@ SkCodec::Result SkWbmpCodec::onGetPixels(const SkImageInfo& info,
 
 
     // Initialize the swizzler
-    SkAutoTDelete<SkSwizzler> swizzler(this->initializeSwizzler(info, ctable, options));
+    SkAutoTDelete<SkSwizzler> swizzler(this->initializeSwizzler(info, ctable, options, sampleX));
     if (NULL == swizzler.get()) {
         return kInvalidConversion;
     }
 
-    // Perform the decode
-    SkISize size = info.dimensions();
+    // Perform the decode, skipping the rows that are not sampled
     SkAutoTMalloc<uint8_t> src(fSrcRowBytes);
     void* dstRow = dst;
-    for (int y = 0; y < size.height(); ++y) {
+    const int srcHeight = this->getInfo().height();
+    const int lastRow = get_start_coord(sampleY) + (info.height() - 1) * sampleY;
+    SkASSERT(lastRow < srcHeight);
+    for (int y = 0; y <= lastRow; ++y) {
+        if (!is_coord_necessary(y, sampleY, info.height())) {
+            if (this->stream()->skip(fSrcRowBytes) != fSrcRowBytes) {
+                return kIncompleteInput;
+            }
+            continue;
+        }
         Result rowResult = this->readRow(src.get());
         if (kSuccess != rowResult) {
             return rowResult;
@@ -218,7 +229,7 @@ public:
 
         // Initialize the swizzler
         fSwizzler.reset(fCodec->initializeSwizzler(dstInfo,
-                get_color_ptr(fColorTable.get()), options));
+                get_color_ptr(fColorTable.get()), options, 1));
         if (NULL == fSwizzler.get()) {
             return SkCodec::kInvalidInput;
         }
@@ -31,6 +31,7 @@ public:
     static SkScanlineDecoder* NewSDFromStream(SkStream*);
 protected:
     SkEncodedFormat onGetEncodedFormat() const override;
+    SkISize onGetScaledDimensions(float desiredScale) const override;
     Result onGetPixels(const SkImageInfo&, void*, size_t,
                        const Options&, SkPMColor[], int*) override;
 private:
@@ -44,7 +45,7 @@ private:
      * Returns a swizzler on success, NULL on failure
      */
     SkSwizzler* initializeSwizzler(const SkImageInfo& info, const SkPMColor* ctable,
-                                   const Options& opts);
+                                   const Options& opts, int sampleX);
 
     /*
      * Read a src row from the encoded stream
@@ -11,8 +11,12 @@
 #include "SkJpegUtility_codec.h"
 #include "SkCodecPriv.h"
 #include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkScanlineDecoder.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTypes.h"
 
@@ -26,6 +30,15 @@ extern "C" {
     #include "jpeglib.h"
 }
 
+#ifndef TURBO_HAS_SKIP
+#define turbo_jpeg_skip_scanlines(dinfo, count)                              \
+    SkAutoMalloc storage(dinfo->output_width * dinfo->out_color_components); \
+    uint8_t* storagePtr = static_cast<uint8_t*>(storage.get());              \
+    for (int y = 0; y < count; y++) {                                        \
+        turbo_jpeg_read_scanlines(dinfo, &storagePtr, 1);                    \
+    }
+#endif
+
 /*
  * Convert a row of CMYK samples to RGBA in place.
  * Note that this method moves the row pointer.
@@ -148,6 +161,11 @@ SkJpegCodec::SkJpegCodec(const SkImageInfo& srcInfo, SkStream* stream,
     , fDecoderMgr(decoderMgr)
 {}
 
+/*
+ * Out of line so that JpegIncrementalDecode is a complete type
+ */
+SkJpegCodec::~SkJpegCodec() {}
+
 /*
  * Return a valid set of output dimensions for this decoder, given an input scale
  */
@@ -297,6 +315,426 @@ bool SkJpegCodec::scaleToDimensions(uint32_t dstWidth, uint32_t dstHeight) {
     return true;
 }
 
+/*
+ * Layout of a sequential, single scan jpeg with restart markers.
+ * All offsets index the encoded data.
+ */
+struct JpegRestartLayout {
+    size_t            fHeightOffset;    // big-endian image height in the SOF segment
+    size_t            fScanStart;       // first byte of entropy coded data
+    size_t            fScanEnd;         // offset of the EOI marker
+    SkTDArray<size_t> fIntervalStarts;  // first byte of each restart interval
+    int               fRestartInterval; // MCUs per restart interval
+    int               fMCUsPerRow;
+    int               fMCURows;
+    int               fMCUHeight;       // in pixels
+};
+
+static inline int read_be16(const uint8_t* ptr) {
+    return (ptr[0] << 8) | ptr[1];
+}
+
+/*
+ * Finds the restart intervals of a jpeg.  Returns false unless the image is a huffman coded,
+ * sequential jpeg with a single scan containing every component, and the restart intervals
+ * cover every MCU of the image.
+ */
+static bool parse_restart_layout(const uint8_t* data, size_t size, JpegRestartLayout* layout) {
+    if (size < 4 || 0xFF != data[0] || 0xD8 != data[1]) {
+        return false;
+    }
+
+    int width = 0;
+    int height = 0;
+    int numComponents = 0;
+    int maxH = 1;
+    int maxV = 1;
+    layout->fHeightOffset = 0;
+    layout->fScanStart = 0;
+    layout->fRestartInterval = 0;
+
+    // Walk the marker segments up to the start of the scan
+    size_t pos = 2;
+    while (0 == layout->fScanStart) {
+        // Markers may be preceded by any number of fill bytes
+        while (pos + 1 < size && 0xFF == data[pos] && 0xFF == data[pos + 1]) {
+            pos++;
+        }
+        if (pos + 4 > size || 0xFF != data[pos]) {
+            return false;
+        }
+        const uint8_t marker = data[pos + 1];
+        if ((marker >= 0xD0 && marker <= 0xD9) || 0x01 == marker) {
+            // RSTn, SOI, EOI and TEM do not belong before the first scan
+            return false;
+        }
+        const size_t length = read_be16(&data[pos + 2]);
+        if (length < 2 || pos + 2 + length > size) {
+            return false;
+        }
+        const uint8_t* segment = &data[pos + 4];
+
+        if (0xC0 == marker || 0xC1 == marker) {
+            // Baseline or extended sequential frame
+            if (length < 8) {
+                return false;
+            }
+            height = read_be16(&segment[1]);
+            width = read_be16(&segment[3]);
+            numComponents = segment[5];
+            if (0 == width || 0 == height || 0 == numComponents ||
+                    length < 8 + 3 * (size_t) numComponents) {
+                return false;
+            }
+            for (int i = 0; i < numComponents; i++) {
+                const uint8_t sampling = segment[6 + 3 * i + 1];
+                maxH = SkTMax(maxH, sampling >> 4);
+                maxV = SkTMax(maxV, sampling & 0xF);
+            }
+            layout->fHeightOffset = pos + 5;
+        } else if (marker >= 0xC2 && marker <= 0xCF && 0xC4 != marker) {
+            // Progressive, lossless, hierarchical or arithmetic coded
+            return false;
+        } else if (0xDD == marker) {
+            if (length < 4) {
+                return false;
+            }
+            layout->fRestartInterval = read_be16(segment);
+        } else if (0xDA == marker) {
+            if (0 == layout->fHeightOffset || length < 3 || segment[0] != numComponents) {
+                return false;
+            }
+            layout->fScanStart = pos + 2 + length;
+        }
+        pos += 2 + length;
+    }
+
+    if (0 == layout->fRestartInterval || (1 == numComponents && (1 != maxH || 1 != maxV))) {
+        return false;
+    }
+
+    // Find the restart markers in the entropy coded data
+    layout->fIntervalStarts.rewind();
+    *layout->fIntervalStarts.append() = layout->fScanStart;
+    layout->fScanEnd = 0;
+    for (pos = layout->fScanStart; pos + 1 < size && 0 == layout->fScanEnd;) {
+        if (0xFF != data[pos]) {
+            pos++;
+            continue;
+        }
+        const uint8_t marker = data[pos + 1];
+        if (0x00 == marker) {
+            // Stuffed zero byte
+            pos += 2;
+        } else if (0xFF == marker) {
+            // Fill byte
+            pos++;
+        } else if (marker >= 0xD0 && marker <= 0xD7) {
+            pos += 2;
+            *layout->fIntervalStarts.append() = pos;
+        } else if (0xD9 == marker) {
+            layout->fScanEnd = pos;
+        } else {
+            // Another scan or a DNL marker
+            return false;
+        }
+    }
+    if (0 == layout->fScanEnd) {
+        // Truncated, let the serial decode handle the incomplete input
+        return false;
+    }
+
+    // A single component scan is not interleaved, so each MCU is one block
+    const int mcuWidth = 1 == numComponents ? DCTSIZE : DCTSIZE * maxH;
+    layout->fMCUHeight = 1 == numComponents ? DCTSIZE : DCTSIZE * maxV;
+    layout->fMCUsPerRow = (width + mcuWidth - 1) / mcuWidth;
+    layout->fMCURows = (height + layout->fMCUHeight - 1) / layout->fMCUHeight;
+    const int totalMCUs = layout->fMCUsPerRow * layout->fMCURows;
+    const int intervalCount =
+            (totalMCUs + layout->fRestartInterval - 1) / layout->fRestartInterval;
+    return intervalCount == layout->fIntervalStarts.count();
+}
+
+/*
+ * One horizontal band of an image decoded in parallel
+ */
+struct JpegBand {
+    const SkData*            fData;
+    const JpegRestartLayout* fLayout;
+    const SkImageInfo*       fDstInfo;
+    J_COLOR_SPACE            fColorSpace;
+    void*                    fDst;
+    size_t                   fRowBytes;
+    int                      fDecodeRow;  // first MCU row decoded, starts a restart interval
+    int                      fStartRow;   // first MCU row written to fDst
+    int                      fEndRow;     // MCU row after the last one written to fDst
+    bool                     fSuccess;
+};
+
+/*
+ * Decodes a band by handing libjpeg a jpeg that begins at fDecodeRow.  The MCU rows above
+ * fStartRow and the one below fEndRow are decoded to give the upsampler the same context as
+ * in a serial decode, which keeps the output identical.
+ */
+static bool decode_band(const JpegBand& band) {
+    const JpegRestartLayout& layout = *band.fLayout;
+    const uint8_t* src = band.fData->bytes();
+    const int mcuHeight = layout.fMCUHeight;
+    const int dstHeight = band.fDstInfo->height();
+
+    const int lastRow = SkTMin(band.fEndRow, layout.fMCURows - 1);
+    const int firstInterval = band.fDecodeRow * layout.fMCUsPerRow / layout.fRestartInterval;
+    const int lastInterval = ((lastRow + 1) * layout.fMCUsPerRow - 1) / layout.fRestartInterval;
+    const size_t scanStart = layout.fIntervalStarts[firstInterval];
+    const size_t scanEnd = lastInterval + 1 < layout.fIntervalStarts.count() ?
+            layout.fIntervalStarts[lastInterval + 1] - 2 : layout.fScanEnd;
+
+    // Copy the headers with a shorter image height, followed by the restart intervals we
+    // need, renumbered so they appear to start the scan.
+    const size_t headerSize = layout.fScanStart;
+    const size_t size = headerSize + (scanEnd - scanStart) + 2;
+    SkAutoTMalloc<uint8_t> storage(size);
+    uint8_t* jpeg = storage.get();
+    memcpy(jpeg, src, headerSize);
+    const int height = dstHeight - band.fDecodeRow * mcuHeight;
+    jpeg[layout.fHeightOffset] = (uint8_t) (height >> 8);
+    jpeg[layout.fHeightOffset + 1] = (uint8_t) height;
+    memcpy(jpeg + headerSize, src + scanStart, scanEnd - scanStart);
+    for (int i = firstInterval + 1; i <= lastInterval; i++) {
+        jpeg[headerSize + layout.fIntervalStarts[i] - 1 - scanStart] =
+                (uint8_t) (0xD0 + ((i - firstInterval - 1) & 7));
+    }
+    jpeg[size - 2] = 0xFF;
+    jpeg[size - 1] = 0xD9;
+
+    SkMemoryStream stream(jpeg, size, false);
+    JpegDecoderMgr decoderMgr(&stream);
+    SkAutoTMalloc<JSAMPLE> skipRow(band.fDstInfo->minRowBytes());
+
+    // libjpeg errors will be caught and reported here
+    if (setjmp(decoderMgr.getJmpBuf())) {
+        return decoderMgr.returnFalse("setjmp");
+    }
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != turbo_jpeg_read_header(dinfo, true)) {
+        return decoderMgr.returnFalse("read_header");
+    }
+    dinfo->out_color_space = band.fColorSpace;
+    if (!turbo_jpeg_start_decompress(dinfo)) {
+        return decoderMgr.returnFalse("start_decompress");
+    }
+
+    const int skipCount = (band.fStartRow - band.fDecodeRow) * mcuHeight;
+    JSAMPLE* dstRow = skipRow.get();
+    for (int y = 0; y < skipCount; y++) {
+        if (1 != turbo_jpeg_read_scanlines(dinfo, &dstRow, 1)) {
+            return decoderMgr.returnFalse("read_scanlines");
+        }
+    }
+
+    const int rowCount = SkTMin(band.fEndRow * mcuHeight, dstHeight) - band.fStartRow * mcuHeight;
+    dstRow = SkTAddOffset<JSAMPLE>(band.fDst, band.fStartRow * mcuHeight * band.fRowBytes);
+    for (int y = 0; y < rowCount; y++) {
+        if (1 != turbo_jpeg_read_scanlines(dinfo, &dstRow, 1)) {
+            return decoderMgr.returnFalse("read_scanlines");
+        }
+        if (JCS_CMYK == dinfo->out_color_space) {
+            convert_CMYK_to_RGBA(dstRow, band.fDstInfo->width());
+        }
+        dstRow = SkTAddOffset<JSAMPLE>(dstRow, band.fRowBytes);
+    }
+
+    // The rest of the image is not needed, ~JpegDecoderMgr() will abort the decompress.
+    return true;
+}
+
+SkCodec::Result SkJpegCodec::decodeInParallel(const SkImageInfo& dstInfo, void* dst,
+                                              size_t dstRowBytes) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const int bandCount = sk_num_cores();
+    if (bandCount < 2 || dinfo->progressive_mode || 0 == dinfo->restart_interval ||
+            dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return kUnimplemented;
+    }
+
+    // Every band needs random access to the encoded data
+    SkStream* stream = this->stream();
+    if (!stream->rewind()) {
+        return kUnimplemented;
+    }
+    SkAutoTUnref<SkData> data(SkCopyStreamToData(stream));
+
+    JpegRestartLayout layout;
+    SkTDArray<JpegBand> bands;
+    if (parse_restart_layout(data->bytes(), data->size(), &layout)) {
+        const int rows = layout.fMCURows;
+        const int mcusPerRow = layout.fMCUsPerRow;
+        const int interval = layout.fRestartInterval;
+
+        // Split the image as evenly as we can at MCU rows that begin a restart interval
+        SkTDArray<int> splits;
+        *splits.append() = 0;
+        for (int row = 1; row < rows && splits.count() < bandCount; row++) {
+            if (0 == (row * mcusPerRow) % interval && row >= splits.count() * rows / bandCount) {
+                *splits.append() = row;
+            }
+        }
+        *splits.append() = rows;
+
+        for (int i = 0; i + 1 < splits.count(); i++) {
+            JpegBand* band = bands.append();
+            band->fData = data;
+            band->fLayout = &layout;
+            band->fDstInfo = &dstInfo;
+            band->fColorSpace = dinfo->out_color_space;
+            band->fDst = dst;
+            band->fRowBytes = dstRowBytes;
+            band->fStartRow = splits[i];
+            band->fEndRow = splits[i + 1];
+            band->fSuccess = false;
+
+            // Start decoding at the previous restart interval in order to
+            // reproduce the upsampling of the rows above fStartRow.
+            int decodeRow = SkTMax(0, band->fStartRow - 1);
+            while (decodeRow > 0 && 0 != (decodeRow * mcusPerRow) % interval) {
+                decodeRow--;
+            }
+            band->fDecodeRow = decodeRow;
+        }
+    }
+
+    if (bands.count() >= 2) {
+        JpegBand* bandArray = bands.begin();
+        sk_parallel_for(bands.count(), [bandArray](int i) {
+            bandArray[i].fSuccess = decode_band(bandArray[i]);
+        });
+
+        bool success = true;
+        for (int i = 0; i < bands.count(); i++) {
+            success = success && bands[i].fSuccess;
+        }
+        if (success) {
+            return kSuccess;
+        }
+    }
+
+    // Reset the decoder so the caller can fall back to a serial decode
+    JpegDecoderMgr* decoderMgr = NULL;
+    if (!stream->rewind() || !ReadHeader(stream, NULL, &decoderMgr)) {
+        return fDecoderMgr->returnFailure("could not rewind", kCouldNotRewind);
+    }
+    SkASSERT(NULL != decoderMgr);
+    fDecoderMgr.reset(decoderMgr);
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+    if (!this->setOutputColorSpace(dstInfo) ||
+            !this->scaleToDimensions(dstInfo.width(), dstInfo.height())) {
+        return fDecoderMgr->returnFailure("reset decoder", kInvalidInput);
+    }
+    return kUnimplemented;
+}
+
+/*
+ * Returns the width of an iMCU column, which subsets must begin on
+ */
+static int get_imcu_width(jpeg_decompress_struct* dinfo) {
+    return 1 == dinfo->num_components ? DCTSIZE : DCTSIZE * dinfo->max_h_samp_factor;
+}
+
+bool SkJpegCodec::onGetValidSubset(SkIRect* desiredSubset) const {
+    if (!desiredSubset) {
+        return false;
+    }
+
+    SkIRect bounds = SkIRect::MakeSize(this->getInfo().dimensions());
+    if (!desiredSubset->intersect(bounds)) {
+        return false;
+    }
+
+    // Columns are cropped in whole iMCUs, so snap the left edge down to one.  Any rows
+    // can be skipped.
+    const int imcuWidth = get_imcu_width(fDecoderMgr->dinfo());
+    desiredSubset->fLeft = desiredSubset->fLeft / imcuWidth * imcuWidth;
+    return true;
+}
+
+/*
+ * Decodes only the rows and iMCU columns of subset.  The rows above it are skipped without
+ * being upsampled or color converted, and decoding stops once its last row is read.
+ * Must be called after setOutputColorSpace(), from a function that has set the jump location.
+ */
+SkCodec::Result SkJpegCodec::decodeSubset(const SkImageInfo& dstInfo, void* dst,
+                                          size_t dstRowBytes, const SkIRect& subset,
+                                          const Options& options) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (!SkIRect::MakeSize(this->getInfo().dimensions()).contains(subset) ||
+            0 != subset.left() % get_imcu_width(dinfo)) {
+        return fDecoderMgr->returnFailure("invalid subset", kInvalidParameters);
+    }
+    if (dstInfo.dimensions() != subset.size()) {
+        // Scaled subsets are not supported.
+        return fDecoderMgr->returnFailure("cannot scale subset", kInvalidScale);
+    }
+    const SkISize& size = this->getInfo().dimensions();
+    if (!this->scaleToDimensions(size.width(), size.height())) {
+        return fDecoderMgr->returnFailure("cannot reset scale", kInvalidScale);
+    }
+    if (!turbo_jpeg_start_decompress(dinfo)) {
+        return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
+    }
+
+#ifdef TURBO_HAS_CROP
+    // Only the iMCU columns of the subset are decoded, and written directly to dst.
+    JDIMENSION cropLeft = subset.left();
+    JDIMENSION cropWidth = subset.width();
+    turbo_jpeg_crop_scanline(dinfo, &cropLeft, &cropWidth);
+    SkASSERT((int) cropLeft == subset.left() && (int) cropWidth == subset.width());
+    const size_t srcLeftBytes = 0;
+#else
+    // Whole rows are decoded, and the subset copied out of them.
+    const size_t srcLeftBytes = subset.left() * dstInfo.bytesPerPixel();
+#endif
+    SkAutoTMalloc<JSAMPLE> rowStorage(dinfo->output_width * dinfo->out_color_components);
+
+    {
+        const int skipCount = subset.top();
+        turbo_jpeg_skip_scanlines(dinfo, skipCount);
+    }
+
+    const bool copyRows = 0 != srcLeftBytes || dinfo->output_width != (JDIMENSION) subset.width();
+    const size_t rowLen = dstInfo.minRowBytes();
+    JSAMPLE* dstRow = (JSAMPLE*) dst;
+    for (int y = 0; y < subset.height(); y++) {
+        JSAMPLE* row = copyRows ? rowStorage.get() : dstRow;
+        if (1 != turbo_jpeg_read_scanlines(dinfo, &row, 1)) {
+            // Fill the remainder with black, as in onGetPixels.
+            if (kNo_ZeroInitialized == options.fZeroInitialized ||
+                    kN32_SkColorType == dstInfo.colorType()) {
+                SkSwizzler::Fill(dstRow, dstInfo, dstRowBytes, subset.height() - y,
+                        SK_ColorBLACK, NULL);
+            }
+            dinfo->output_scanline = dinfo->output_height;
+            turbo_jpeg_finish_decompress(dinfo);
+            return fDecoderMgr->returnFailure("Incomplete image data", kIncompleteInput);
+        }
+        if (copyRows) {
+            memcpy(dstRow, rowStorage.get() + srcLeftBytes, rowLen);
+        }
+        if (JCS_CMYK == dinfo->out_color_space) {
+            convert_CMYK_to_RGBA(dstRow, subset.width());
+        }
+        dstRow = SkTAddOffset<JSAMPLE>(dstRow, dstRowBytes);
+    }
+
+    // The rows below the subset are not needed.  Prevent libjpeg-turbo from failing on a
+    // partial decode.
+    dinfo->output_scanline = dinfo->output_height;
+    turbo_jpeg_finish_decompress(dinfo);
+    return kSuccess;
+}
+
 /*
  * Performs the jpeg decode
  */
@@ -308,11 +746,6 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("could not rewind stream", kCouldNotRewind);
     }
 
-    if (options.fSubset) {
-        // Subsets are not supported.
-        return kUnimplemented;
-    }
-
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -326,11 +759,28 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return fDecoderMgr->returnFailure("conversion_possible", kInvalidConversion);
     }
 
+    if (options.fSubset) {
+        return this->decodeSubset(dstInfo, dst, dstRowBytes, *options.fSubset, options);
+    }
+
     // Perform the necessary scaling
     if (!this->scaleToDimensions(dstInfo.width(), dstInfo.height())) {
         return fDecoderMgr->returnFailure("cannot scale to requested dims", kInvalidScale);
     }
 
+    if (options.fParallelDecode) {
+        const Result result = this->decodeInParallel(dstInfo, dst, dstRowBytes);
+        if (kUnimplemented != result) {
+            return result;
+        }
+
+        // The decoder may have been reset, so set the jump location again
+        dinfo = fDecoderMgr->dinfo();
+        if (setjmp(fDecoderMgr->getJmpBuf())) {
+            return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+        }
+    }
+
     // Now, given valid output dimensions, we can start the decompress
     if (!turbo_jpeg_start_decompress(dinfo)) {
         return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
@@ -384,6 +834,202 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+/*
+ * State of an incremental decode
+ */
+struct JpegIncrementalDecode {
+    enum State {
+        kReadHeader_State,
+        kStartDecompress_State,
+        kStartOutput_State,      // buffered image mode only
+        kReadScanlines_State,
+        kFinishOutput_State,     // buffered image mode only
+        kConsumeInput_State,     // buffered image mode only
+        kFinishDecompress_State,
+        kComplete_State,
+        kFailed_State,
+    };
+
+    // The source manager must outlive the decoder manager that reads from it
+    skjpeg_incremental_source_mgr fSrcMgr;
+    SkAutoTDelete<JpegDecoderMgr> fDecoderMgr;
+    State                         fState;
+    J_COLOR_SPACE                 fColorSpace;
+    unsigned int                  fScaleNum;
+    unsigned int                  fScaleDenom;
+    void*                         fDst;
+    size_t                        fDstRowBytes;
+    int                           fRowsDecoded;
+};
+
+/*
+ * Runs the decode until libjpeg suspends for lack of data or the image is complete
+ */
+static SkCodec::Result continue_incremental_decode(JpegIncrementalDecode* inc) {
+    JpegDecoderMgr* decoderMgr = inc->fDecoderMgr.get();
+    jpeg_decompress_struct* dinfo = decoderMgr->dinfo();
+
+    // libjpeg errors will be caught and reported here
+    if (setjmp(decoderMgr->getJmpBuf())) {
+        inc->fState = JpegIncrementalDecode::kFailed_State;
+        return decoderMgr->returnFailure("setjmp", SkCodec::kInvalidInput);
+    }
+
+    while (true) {
+        switch (inc->fState) {
+            case JpegIncrementalDecode::kReadHeader_State:
+                if (JPEG_HEADER_OK != turbo_jpeg_read_header(dinfo, true)) {
+                    return SkCodec::kIncompleteInput;
+                }
+                // Match the output of the codec's decompress struct
+                dinfo->out_color_space = inc->fColorSpace;
+                dinfo->scale_num = inc->fScaleNum;
+                dinfo->scale_denom = inc->fScaleDenom;
+                // Buffered image mode lets us draw each scan of a progressive image
+                dinfo->buffered_image = turbo_jpeg_has_multiple_scans(dinfo);
+                inc->fState = JpegIncrementalDecode::kStartDecompress_State;
+                break;
+            case JpegIncrementalDecode::kStartDecompress_State:
+                if (!turbo_jpeg_start_decompress(dinfo)) {
+                    return SkCodec::kIncompleteInput;
+                }
+                inc->fState = dinfo->buffered_image ? JpegIncrementalDecode::kStartOutput_State
+                                                    : JpegIncrementalDecode::kReadScanlines_State;
+                break;
+            case JpegIncrementalDecode::kStartOutput_State:
+                // Draw the most recent scan
+                if (!turbo_jpeg_start_output(dinfo, dinfo->input_scan_number)) {
+                    return SkCodec::kIncompleteInput;
+                }
+                inc->fState = JpegIncrementalDecode::kReadScanlines_State;
+                break;
+            case JpegIncrementalDecode::kReadScanlines_State:
+                while (dinfo->output_scanline < dinfo->output_height) {
+                    JSAMPLE* dstRow = SkTAddOffset<JSAMPLE>(inc->fDst,
+                            dinfo->output_scanline * inc->fDstRowBytes);
+                    if (1 != turbo_jpeg_read_scanlines(dinfo, &dstRow, 1)) {
+                        return SkCodec::kIncompleteInput;
+                    }
+
+                    // Convert to RGBA if necessary
+                    if (JCS_CMYK == dinfo->out_color_space) {
+                        convert_CMYK_to_RGBA(dstRow, dinfo->output_width);
+                    }
+                    inc->fRowsDecoded = SkTMax(inc->fRowsDecoded, (int) dinfo->output_scanline);
+                }
+                inc->fState = dinfo->buffered_image ? JpegIncrementalDecode::kFinishOutput_State
+                                                    : JpegIncrementalDecode::kFinishDecompress_State;
+                break;
+            case JpegIncrementalDecode::kFinishOutput_State:
+                if (!turbo_jpeg_finish_output(dinfo)) {
+                    return SkCodec::kIncompleteInput;
+                }
+                inc->fState = JpegIncrementalDecode::kConsumeInput_State;
+                break;
+            case JpegIncrementalDecode::kConsumeInput_State: {
+                // Absorb all of the available data, so that we skip straight to the latest scan
+                int status;
+                do {
+                    status = turbo_jpeg_consume_input(dinfo);
+                } while (JPEG_SUSPENDED != status && JPEG_REACHED_EOI != status);
+
+                const bool newScan = dinfo->input_scan_number != dinfo->output_scan_number;
+                if (newScan) {
+                    inc->fState = JpegIncrementalDecode::kStartOutput_State;
+                } else if (turbo_jpeg_input_complete(dinfo)) {
+                    // The final scan has been drawn
+                    inc->fState = JpegIncrementalDecode::kFinishDecompress_State;
+                } else {
+                    return SkCodec::kIncompleteInput;
+                }
+                break;
+            }
+            case JpegIncrementalDecode::kFinishDecompress_State:
+                if (!turbo_jpeg_finish_decompress(dinfo)) {
+                    return SkCodec::kIncompleteInput;
+                }
+                inc->fRowsDecoded = dinfo->output_height;
+                inc->fState = JpegIncrementalDecode::kComplete_State;
+                break;
+            case JpegIncrementalDecode::kComplete_State:
+                return SkCodec::kSuccess;
+            case JpegIncrementalDecode::kFailed_State:
+                return SkCodec::kInvalidInput;
+        }
+    }
+}
+
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t dstRowBytes,
+                                                      const Options& options, SkPMColor*, int*) {
+    fIncremental.reset(NULL);
+
+    // Rewind the stream if needed
+    if (!this->handleRewind()) {
+        return fDecoderMgr->returnFailure("could not rewind stream", kCouldNotRewind);
+    }
+
+    if (options.fSubset) {
+        // Subsets are not supported.
+        return kUnimplemented;
+    }
+
+    // Set the jump location for libjpeg errors
+    if (setjmp(fDecoderMgr->getJmpBuf())) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    // Use the codec's decompress struct to check the request, since it has read the header
+    if (!this->setOutputColorSpace(dstInfo)) {
+        return fDecoderMgr->returnFailure("conversion_possible", kInvalidConversion);
+    }
+    if (!this->scaleToDimensions(dstInfo.width(), dstInfo.height())) {
+        return fDecoderMgr->returnFailure("cannot scale to requested dims", kInvalidScale);
+    }
+
+    SkAutoTDelete<JpegIncrementalDecode> inc(SkNEW(JpegIncrementalDecode));
+    inc->fDecoderMgr.reset(SkNEW_ARGS(JpegDecoderMgr, (&inc->fSrcMgr)));
+    if (setjmp(inc->fDecoderMgr->getJmpBuf())) {
+        return inc->fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+    inc->fDecoderMgr->init();
+    inc->fState = JpegIncrementalDecode::kReadHeader_State;
+    inc->fColorSpace = fDecoderMgr->dinfo()->out_color_space;
+    inc->fScaleNum = fDecoderMgr->dinfo()->scale_num;
+    inc->fScaleDenom = fDecoderMgr->dinfo()->scale_denom;
+    inc->fDst = dst;
+    inc->fDstRowBytes = dstRowBytes;
+    inc->fRowsDecoded = 0;
+
+    // Start again from the beginning of everything the stream holds
+    SkStream* stream = this->stream();
+    if (!stream->rewind()) {
+        return fDecoderMgr->returnFailure("could not rewind stream", kCouldNotRewind);
+    }
+    SkAutoTUnref<SkData> data(SkCopyStreamToData(stream));
+    inc->fSrcMgr.append(data->data(), data->size());
+
+    const Result result = continue_incremental_decode(inc);
+    if (kSuccess != result && kIncompleteInput != result) {
+        return result;
+    }
+    fIncremental.reset(inc.detach());
+    return kSuccess;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(const void* data, size_t length,
+                                                 int* rowsDecoded) {
+    if (!fIncremental) {
+        return kInvalidInput;
+    }
+    if (length > 0) {
+        fIncremental->fSrcMgr.append(data, length);
+    }
+    const Result result = continue_incremental_decode(fIncremental);
+    *rowsDecoded = fIncremental->fRowsDecoded;
+    return result;
+}
+
 /*
  * Enable scanline decoding for jpegs
  */
@@ -476,15 +1122,6 @@ public:
         return SkCodec::kSuccess;
     }
 
-#ifndef TURBO_HAS_SKIP
-#define turbo_jpeg_skip_scanlines(dinfo, count)                              \
-    SkAutoMalloc storage(dinfo->output_width * dinfo->out_color_components); \
-    uint8_t* storagePtr = static_cast<uint8_t*>(storage.get());              \
-    for (int y = 0; y < count; y++) {                                        \
-        turbo_jpeg_read_scanlines(dinfo, &storagePtr, 1);                    \
-    }
-#endif
-
     SkCodec::Result onSkipScanlines(int count) override {
         // Set the jump location for libjpeg errors
         if (setjmp(fCodec->fDecoderMgr->getJmpBuf())) {
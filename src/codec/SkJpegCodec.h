@@ -19,6 +19,7 @@ extern "C" {
 }
 
 class SkScanlineDecoder;
+struct JpegIncrementalDecode;
 
 /*
  *
@@ -48,6 +49,8 @@ public:
      */
     static SkScanlineDecoder* NewSDFromStream(SkStream*);
 
+    virtual ~SkJpegCodec();
+
 protected:
 
     /*
@@ -61,10 +64,24 @@ protected:
     Result onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes, const Options&,
             SkPMColor*, int*) override;
 
+    /*
+     * Begins a decode that suspends whenever it runs out of data.  Progressive jpegs are
+     * drawn each time a new scan arrives.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            const Options&, SkPMColor*, int*) override;
+
+    Result onIncrementalDecode(const void* data, size_t length, int* rowsDecoded) override;
+
     SkEncodedFormat onGetEncodedFormat() const override {
         return kJPEG_SkEncodedFormat;
     }
 
+    /*
+     * Snaps the left edge of the subset to an iMCU boundary
+     */
+    bool onGetValidSubset(SkIRect* desiredSubset) const override;
+
 private:
 
     /*
@@ -118,13 +135,31 @@ private:
      */
     bool scaleToDimensions(uint32_t width, uint32_t height);
 
+    /*
+     * Decodes bands of restart intervals concurrently on SkTaskGroup threads.
+     * Must be called after setOutputColorSpace() and scaleToDimensions().
+     *
+     * Returns kUnimplemented if the image cannot be split, in which case fDecoderMgr is left
+     * ready for a serial decode.  Any other result is the final result of the decode.
+     */
+    Result decodeInParallel(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes);
+
+    /*
+     * Decodes a subset, skipping the rows above it and, with libjpeg-turbo's
+     * jpeg_crop_scanline, the columns outside it.
+     * Must be called after setOutputColorSpace().
+     */
+    Result decodeSubset(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
+            const SkIRect& subset, const Options& options);
+
     /*
      * Create the swizzler based on the encoded format
      */
     void initializeSwizzler(const SkImageInfo& dstInfo, void* dst, size_t dstRowBytes,
             const Options& options);
 
-    SkAutoTDelete<JpegDecoderMgr> fDecoderMgr;
+    SkAutoTDelete<JpegDecoderMgr>        fDecoderMgr;
+    SkAutoTDelete<JpegIncrementalDecode> fIncremental;
 
     friend class SkJpegScanlineDecoder;
 
@@ -48,6 +48,17 @@ SkColorType JpegDecoderMgr::getColorType() {
 
 JpegDecoderMgr::JpegDecoderMgr(SkStream* stream)
     : fSrcMgr(stream)
+    , fSrc(&fSrcMgr)
+    , fInit(false)
+{
+    // Error manager must be set before any calls to libjeg in order to handle failures
+    fDInfo.err = turbo_jpeg_std_error(&fErrorMgr);
+    fErrorMgr.error_exit = skjpeg_err_exit;
+}
+
+JpegDecoderMgr::JpegDecoderMgr(jpeg_source_mgr* srcMgr)
+    : fSrcMgr(NULL)
+    , fSrc(srcMgr)
     , fInit(false)
 {
     // Error manager must be set before any calls to libjeg in order to handle failures
@@ -58,7 +69,7 @@ JpegDecoderMgr::JpegDecoderMgr(SkStream* stream)
 void JpegDecoderMgr::init() {
     jpeg_create_decompress(&fDInfo);
     fInit = true;
-    fDInfo.src = &fSrcMgr;
+    fDInfo.src = fSrc;
     fDInfo.err->emit_message = &emit_message;
     fDInfo.err->output_message = &output_message;
 }
@@ -41,6 +41,12 @@ public:
      */
     JpegDecoderMgr(SkStream* stream);
 
+    /*
+     * Create a decode manager that reads from the given source manager instead of a stream
+     * Does not take ownership of srcMgr
+     */
+    JpegDecoderMgr(jpeg_source_mgr* srcMgr);
+
     /*
      * Initialize decompress struct
      * Initialize the source manager
@@ -71,6 +77,7 @@ private:
 
     jpeg_decompress_struct fDInfo;
     skjpeg_source_mgr      fSrcMgr;
+    jpeg_source_mgr*       fSrc;         // either &fSrcMgr or unowned
     skjpeg_error_mgr       fErrorMgr;
     bool                   fInit;
 };
@@ -77,6 +77,63 @@ skjpeg_source_mgr::skjpeg_source_mgr(SkStream* stream)
     term_source = sk_term_source;
 }
 
+/*
+ * Initialize the incremental source manager
+ */
+static void sk_init_incremental_source(j_decompress_ptr dinfo) {
+    // The buffer may already hold data, so there is nothing to reset
+}
+
+/*
+ * The incremental source manager only holds the data it has been given.
+ * Returning false tells libjpeg to suspend until more has been appended.
+ */
+static boolean sk_fill_incremental_input_buffer(j_decompress_ptr dinfo) {
+    return false;
+}
+
+/*
+ * Skip a certain number of bytes, some of which may not have arrived yet
+ */
+static void sk_skip_incremental_input_data(j_decompress_ptr dinfo, long numBytes) {
+    skjpeg_incremental_source_mgr* src = (skjpeg_incremental_source_mgr*) dinfo->src;
+    size_t bytes = (size_t) numBytes;
+
+    if (bytes > src->bytes_in_buffer) {
+        src->fBytesToSkip += bytes - src->bytes_in_buffer;
+        src->next_input_byte += src->bytes_in_buffer;
+        src->bytes_in_buffer = 0;
+    } else {
+        src->next_input_byte += numBytes;
+        src->bytes_in_buffer -= numBytes;
+    }
+}
+
+skjpeg_incremental_source_mgr::skjpeg_incremental_source_mgr()
+    : fBytesToSkip(0)
+{
+    init_source = sk_init_incremental_source;
+    fill_input_buffer = sk_fill_incremental_input_buffer;
+    skip_input_data = sk_skip_incremental_input_data;
+    resync_to_restart = turbo_jpeg_resync_to_restart;
+    term_source = sk_term_source;
+    next_input_byte = NULL;
+    bytes_in_buffer = 0;
+}
+
+void skjpeg_incremental_source_mgr::append(const void* data, size_t length) {
+    // libjpeg will not back up past next_input_byte, so the data before it can be dropped
+    const size_t consumed = fBuffer.count() - bytes_in_buffer;
+    fBuffer.remove(0, SkToInt(consumed));
+
+    const size_t skip = SkTMin(fBytesToSkip, length);
+    fBytesToSkip -= skip;
+    fBuffer.append(SkToInt(length - skip), static_cast<const uint8_t*>(data) + skip);
+
+    next_input_byte = (const JOCTET*) fBuffer.begin();
+    bytes_in_buffer = fBuffer.count();
+}
+
 /*
  * Call longjmp to continue execution on an error
  */
@@ -10,6 +10,7 @@
 #define SkJpegUtility_codec_DEFINED
 
 #include "SkStream.h"
+#include "SkTDArray.h"
 
 #include <setjmp.h>
 // stdio is needed for jpeglib
@@ -48,4 +49,20 @@ struct skjpeg_source_mgr : jpeg_source_mgr {
     uint8_t fBuffer[kBufferSize];
 };
 
+/*
+ * Source handling struct for incremental decodes.  Data is appended as it arrives, and
+ * libjpeg suspends when it runs out.
+ */
+struct skjpeg_incremental_source_mgr : jpeg_source_mgr {
+    skjpeg_incremental_source_mgr();
+
+    /*
+     * Discards the data that libjpeg has consumed and appends the new data
+     */
+    void append(const void* data, size_t length);
+
+    SkTDArray<uint8_t> fBuffer;
+    size_t             fBytesToSkip; // skipped by libjpeg, but not yet appended
+};
+
 #endif
@@ -23,10 +23,13 @@ public:
     /*
      * Create a new swizzler
      * @param masks Unowned pointer to helper class
+     * @param sampleX Only every sampleX-th src pixel is written to the dst,
+     *                starting with the pixel at sampleX / 2
      */
     static SkMaskSwizzler* CreateMaskSwizzler(const SkImageInfo& imageInfo,
                                               SkMasks* masks,
-                                              uint32_t bitsPerPixel);
+                                              uint32_t bitsPerPixel,
+                                              uint32_t sampleX);
 
     /*
      * Swizzle a row
@@ -40,17 +43,19 @@ private:
      */
     typedef SkSwizzler::ResultAlpha (*RowProc)(
             void* dstRow, const uint8_t* srcRow, int width,
-            SkMasks* masks);
+            SkMasks* masks, uint32_t startX, uint32_t sampleX);
 
     /*
      * Constructor for mask swizzler
      */
-    SkMaskSwizzler(const SkImageInfo& info, SkMasks* masks, RowProc proc);
+    SkMaskSwizzler(const SkImageInfo& info, SkMasks* masks, RowProc proc,
+                   uint32_t sampleX);
 
     // Fields
     const SkImageInfo& fDstInfo;
     SkMasks*           fMasks;       // unowned
     const RowProc      fRowProc;
+    const uint32_t     fSampleX;
 };
 
 #endif
@@ -9,6 +9,7 @@
 #include "SkCodec_libpng.h"
 #include "SkCodec_wbmp.h"
 #include "SkCodecPriv.h"
+#include "SkTraceEvent.h"
 #ifndef SK_BUILD_FOR_ANDROID_FRAMEWORK
 #include "SkJpegCodec.h"
 #endif
@@ -68,6 +69,8 @@ SkScanlineDecoder* SkScanlineDecoder::NewFromData(SkData* data) {
 
 SkCodec::Result SkScanlineDecoder::start(const SkImageInfo& dstInfo,
         const SkCodec::Options* options, SkPMColor ctable[], int* ctableCount) {
+    TRACE_EVENT2("disabled-by-default-skia", "SkScanlineDecoder::start()",
+                 "width", dstInfo.width(), "height", dstInfo.height());
     // Ensure that valid color ptrs are passed in for kIndex8 color type
     if (kIndex_8_SkColorType == dstInfo.colorType()) {
         if (NULL == ctable || NULL == ctableCount) {
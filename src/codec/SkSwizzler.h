@@ -117,15 +117,20 @@ public:
     /**
      *  Create a new SkSwizzler.
      *  @param SrcConfig Description of the format of the source.
-     *  @param SkImageInfo dimensions() describe both the src and the dst.
-     *              Other fields describe the dst.
+     *  @param SkImageInfo Describes the dst. Its width is the number of pixels
+     *              written per row.
      *  @param ZeroInitialized Whether dst is zero-initialized. The
                                implementation may choose to skip writing zeroes
      *                         if set to kYes_ZeroInitialized.
+     *  @param sampleX Only every sampleX-th pixel of a src row is written to the
+     *                 dst, starting with the pixel at sampleX / 2. A src row
+     *                 therefore holds at least sampleX * width pixels. Use 1 to
+     *                 swizzle every pixel.
      *  @return A new SkSwizzler or NULL on failure.
      */
     static SkSwizzler* CreateSwizzler(SrcConfig, const SkPMColor* ctable,
-                                      const SkImageInfo&, SkCodec::ZeroInitialized);
+                                      const SkImageInfo&, SkCodec::ZeroInitialized,
+                                      int sampleX);
 
     /**
      * Fill the remainder of the destination with a single color
@@ -155,6 +160,10 @@ public:
      *
      * If dstInfo.colorType() is kGray, colorOrIndex is always treated as an 8-bit color.
      *
+     * If dstInfo.colorType() is kRGB_565, a NULL colorTable means colorOrIndex is treated
+     * as a 16-bit color, and a non-NULL colorTable means each 2-byte pixel will be set to
+     * colorTable[(uint8_t) colorOrIndex], converted to 565.
+     *
      * Other SkColorTypes are not supported.
      *
      */
@@ -181,27 +190,31 @@ private:
      *  Method for converting raw data to Skia pixels.
      *  @param dstRow Row in which to write the resulting pixels.
      *  @param src Row of src data, in format specified by SrcConfig
-     *  @param width Width in pixels
-     *  @param deltaSrc if bitsPerPixel % 8 == 0, deltaSrc is bytesPerPixel
-     *                  else, deltaSrc is bitsPerPixel
+     *  @param dstWidth Width in pixels of the destination
+     *  @param bpp if bitsPerPixel % 8 == 0, bpp is bytesPerPixel
+     *             else, bpp is bitsPerPixel
+     *  @param deltaSrc bpp * sampleX, the distance between consecutive src
+     *                  pixels that are written to the dst
+     *  @param offset The distance from the start of src to the first pixel
+     *                that is written, in the same units as bpp
      *  @param ctable Colors (used for kIndex source).
      */
     typedef ResultAlpha (*RowProc)(void* SK_RESTRICT dstRow,
                                    const uint8_t* SK_RESTRICT src,
-                                   int width, int deltaSrc,
+                                   int dstWidth, int bpp, int deltaSrc, int offset,
                                    const SkPMColor ctable[]);
 
     const RowProc       fRowProc;
     const SkPMColor*    fColorTable;      // Unowned pointer
-    const int           fDeltaSrc;        // if bitsPerPixel % 8 == 0
-                                          //     deltaSrc is bytesPerPixel
+    const int           fSrcPixelSize;    // if bitsPerPixel % 8 == 0
+                                          //     fSrcPixelSize is bytesPerPixel
                                           // else
-                                          //     deltaSrc is bitsPerPixel
+                                          //     fSrcPixelSize is bitsPerPixel
+    const int           fSampleX;
     const SkImageInfo   fDstInfo;
-    int                 fCurrY;
 
-    SkSwizzler(RowProc proc, const SkPMColor* ctable, int deltaSrc,
-               const SkImageInfo& info);
+    SkSwizzler(RowProc proc, const SkPMColor* ctable, int srcPixelSize,
+               const SkImageInfo& info, int sampleX);
 
 };
 #endif // SkSwizzler_DEFINED
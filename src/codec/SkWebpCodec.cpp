@@ -6,6 +6,8 @@
  */
 
 #include "SkWebpCodec.h"
+#include "SkMath.h"
+#include "SkStreamPriv.h"
 #include "SkTemplates.h"
 
 // A WebP decoder on top of (subset of) libwebp
@@ -17,6 +19,7 @@
 // If moving libwebp out of skia source tree, path for webp headers must be
 // updated accordingly. Here, we enforce using local copy in webp sub-directory.
 #include "webp/decode.h"
+#include "webp/demux.h"
 #include "webp/encode.h"
 
 bool SkWebpCodec::IsWebp(SkStream* stream) {
@@ -36,7 +39,7 @@ static const size_t WEBP_VP8_HEADER_SIZE = 30;
 // Parse headers of RIFF container, and check for valid Webp (VP8) content.
 // NOTE: This calls peek instead of read, since onGetPixels will need these
 // bytes again.
-static bool webp_parse_header(SkStream* stream, SkImageInfo* info) {
+static bool webp_parse_header(SkStream* stream, SkImageInfo* info, bool* animated) {
     unsigned char buffer[WEBP_VP8_HEADER_SIZE];
     if (!stream->peek(buffer, WEBP_VP8_HEADER_SIZE)) {
         return false;
@@ -65,9 +68,14 @@ static bool webp_parse_header(SkStream* stream, SkImageInfo* info) {
         // Is unpremul the right type? Clients of SkCodec may assume it's the
         // best type, when Skia currently cannot draw unpremul (and raster is faster
         // with premul).
+        // Animations are drawn on a transparent canvas, so may have alpha even if no
+        // frame does.
         *info = SkImageInfo::Make(features.width, features.height, kN32_SkColorType,
-                                  SkToBool(features.has_alpha) ? kUnpremul_SkAlphaType
-                                                              : kOpaque_SkAlphaType);
+                                  SkToBool(features.has_alpha) || features.has_animation
+                                          ? kUnpremul_SkAlphaType : kOpaque_SkAlphaType);
+    }
+    if (animated) {
+        *animated = SkToBool(features.has_animation);
     }
     return true;
 }
@@ -75,8 +83,9 @@ static bool webp_parse_header(SkStream* stream, SkImageInfo* info) {
 SkCodec* SkWebpCodec::NewFromStream(SkStream* stream) {
     SkAutoTDelete<SkStream> streamDeleter(stream);
     SkImageInfo info;
-    if (webp_parse_header(stream, &info)) {
-        return SkNEW_ARGS(SkWebpCodec, (info, streamDeleter.detach()));
+    bool animated;
+    if (webp_parse_header(stream, &info, &animated)) {
+        return SkNEW_ARGS(SkWebpCodec, (info, streamDeleter.detach(), animated));
     }
     return NULL;
 }
@@ -153,6 +162,11 @@ bool SkWebpCodec::onGetValidSubset(SkIRect* desiredSubset) const {
 
 SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
                                          const Options& options, SkPMColor*, int*) {
+    if (fAnimated) {
+        // WebPIDecode only decodes still images.
+        return this->decodeFrame(dstInfo, dst, rowBytes, options);
+    }
+
     switch (this->rewindIfNeeded()) {
         case kCouldNotRewind_RewindState:
             return kCouldNotRewind;
@@ -258,5 +272,191 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     }
 }
 
-SkWebpCodec::SkWebpCodec(const SkImageInfo& info, SkStream* stream)
-    : INHERITED(info, stream) {}
+bool SkWebpCodec::parseFrames() {
+    if (fFramesParsed) {
+        return NULL != fDemux;
+    }
+    fFramesParsed = true;
+    if (kCouldNotRewind_RewindState == this->rewindIfNeeded()) {
+        return false;
+    }
+    fData.reset(SkCopyStreamToData(this->stream()));
+    WebPData data = { fData->bytes(), fData->size() };
+    fDemux = WebPDemux(&data);
+    if (NULL == fDemux) {
+        return false;
+    }
+
+    const SkIRect canvas = SkIRect::MakeSize(this->getInfo().dimensions());
+    const int frameCount = WebPDemuxGetI(fDemux, WEBP_FF_FRAME_COUNT);
+    for (int i = 0; i < frameCount; i++) {
+        WebPIterator iter;
+        // Frames are numbered from 1.
+        if (!WebPDemuxGetFrame(fDemux, i + 1, &iter)) {
+            break;
+        }
+        const SkIRect rect = SkIRect::MakeXYWH(iter.x_offset, iter.y_offset, iter.width,
+                                               iter.height);
+        if (!canvas.contains(rect)) {
+            WebPDemuxReleaseIterator(&iter);
+            break;
+        }
+        Frame& frame = fFrames.push_back();
+        frame.fRect = rect;
+        frame.fDuration = iter.duration;
+        frame.fDisposeToBackground = WEBP_MUX_DISPOSE_BACKGROUND == iter.dispose_method;
+        frame.fBlend = WEBP_MUX_BLEND == iter.blend_method;
+        frame.fHasAlpha = SkToBool(iter.has_alpha);
+        WebPDemuxReleaseIterator(&iter);
+
+        // A frame is drawn on a clear canvas if it replaces every pixel, or if the frame
+        // before it leaves the canvas clear.
+        frame.fRequiredFrame = kNone;
+        if (0 == i || (frame.fRect == canvas && (!frame.fHasAlpha || !frame.fBlend))) {
+            continue;
+        }
+        const Frame& prev = fFrames[i - 1];
+        if (prev.fDisposeToBackground &&
+                (prev.fRect == canvas || kNone == prev.fRequiredFrame)) {
+            continue;
+        }
+        frame.fRequiredFrame = i - 1;
+    }
+    return true;
+}
+
+int SkWebpCodec::onGetFrameCount() {
+    if (!fAnimated) {
+        return 1;
+    }
+    this->parseFrames();
+    return fFrames.count();
+}
+
+bool SkWebpCodec::onGetFrameInfo(int index, FrameInfo* info) {
+    if (!fAnimated) {
+        return INHERITED::onGetFrameInfo(index, info);
+    }
+    if (!this->parseFrames() || index >= fFrames.count()) {
+        return false;
+    }
+    info->fRequiredFrame = fFrames[index].fRequiredFrame;
+    info->fDuration = fFrames[index].fDuration;
+    return true;
+}
+
+static void clear_rect(const SkIRect& rect, void* dst, size_t rowBytes) {
+    for (int y = rect.fTop; y < rect.fBottom; y++) {
+        sk_bzero(SkTAddOffset<uint32_t>(dst, y * rowBytes) + rect.fLeft, rect.width() * 4);
+    }
+}
+
+// Both 8888 byte orders keep alpha in the last byte, so these work on either.
+static void blend_row_premul(uint8_t* dst, const uint8_t* src, int width) {
+    for (int x = 0; x < width; x++, dst += 4, src += 4) {
+        const unsigned srcA = src[3];
+        if (0xFF == srcA) {
+            memcpy(dst, src, 4);
+        } else if (0 != srcA) {
+            for (int i = 0; i < 4; i++) {
+                dst[i] = src[i] + SkMulDiv255Round(dst[i], 0xFF - srcA);
+            }
+        }
+    }
+}
+
+// Matches the blending of libwebp's own animation decoder.
+static void blend_row_unpremul(uint8_t* dst, const uint8_t* src, int width) {
+    for (int x = 0; x < width; x++, dst += 4, src += 4) {
+        const unsigned srcA = src[3];
+        if (0 == srcA) {
+            continue;
+        }
+        const unsigned dstFactorA = (dst[3] * (256 - srcA)) >> 8;
+        const unsigned blendA = srcA + dstFactorA;
+        const uint32_t scale = (1u << 24) / blendA;
+        for (int i = 0; i < 3; i++) {
+            dst[i] = ((src[i] * srcA + dst[i] * dstFactorA) * scale) >> 24;
+        }
+        dst[3] = blendA;
+    }
+}
+
+SkCodec::Result SkWebpCodec::decodeFrame(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                         const Options& options) {
+    if (!this->parseFrames()) {
+        return kInvalidInput;
+    }
+    const int index = options.fFrameIndex;
+    if (index >= fFrames.count()) {
+        return kInvalidParameters;
+    }
+    if (options.fSubset) {
+        return kUnimplemented;
+    }
+    if (dstInfo.dimensions() != this->getInfo().dimensions()) {
+        return kInvalidScale;
+    }
+    if (!conversion_possible(dstInfo, this->getInfo())) {
+        return kInvalidConversion;
+    }
+
+    const Frame& frame = fFrames[index];
+    if (kNone == frame.fRequiredFrame) {
+        if (kNo_ZeroInitialized == options.fZeroInitialized) {
+            clear_rect(SkIRect::MakeSize(dstInfo.dimensions()), dst, rowBytes);
+        }
+    } else if (fFrames[frame.fRequiredFrame].fDisposeToBackground) {
+        clear_rect(fFrames[frame.fRequiredFrame].fRect, dst, rowBytes);
+    }
+
+    WebPIterator iter;
+    if (!WebPDemuxGetFrame(fDemux, index + 1, &iter)) {
+        return kInvalidInput;
+    }
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoRelease(&iter);
+
+    WebPDecoderConfig config;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        return kInvalidInput;
+    }
+    SkAutoTCallVProc<WebPDecBuffer, WebPFreeDecBuffer> autoFree(&(config.output));
+
+    // Decode the frame on its own, then draw it onto the canvas.
+    const bool premul = kPremul_SkAlphaType == dstInfo.alphaType();
+    const size_t frameRowBytes = frame.fRect.width() * 4;
+    SkAutoTMalloc<uint8_t> pixels(frameRowBytes * frame.fRect.height());
+    config.output.colorspace = webp_decode_mode(dstInfo.colorType(), premul);
+    config.output.u.RGBA.rgba = pixels.get();
+    config.output.u.RGBA.stride = (int) frameRowBytes;
+    config.output.u.RGBA.size = frameRowBytes * frame.fRect.height();
+    config.output.is_external_memory = 1;
+    if (VP8_STATUS_OK != WebPDecode(iter.fragment.bytes, iter.fragment.size, &config)) {
+        return kInvalidInput;
+    }
+
+    const bool blend = frame.fBlend && frame.fHasAlpha;
+    for (int y = 0; y < frame.fRect.height(); y++) {
+        uint8_t* dstRow = SkTAddOffset<uint8_t>(dst, (frame.fRect.fTop + y) * rowBytes) +
+                          frame.fRect.fLeft * 4;
+        const uint8_t* srcRow = pixels.get() + y * frameRowBytes;
+        if (!blend) {
+            memcpy(dstRow, srcRow, frameRowBytes);
+        } else if (premul) {
+            blend_row_premul(dstRow, srcRow, frame.fRect.width());
+        } else {
+            blend_row_unpremul(dstRow, srcRow, frame.fRect.width());
+        }
+    }
+    return kSuccess;
+}
+
+SkWebpCodec::SkWebpCodec(const SkImageInfo& info, SkStream* stream, bool animated)
+    : INHERITED(info, stream)
+    , fAnimated(animated)
+    , fFramesParsed(false)
+    , fDemux(NULL) {}
+
+SkWebpCodec::~SkWebpCodec() {
+    WebPDemuxDelete(fDemux);
+}
@@ -9,11 +9,14 @@
 #define SkWebpCodec_DEFINED
 
 #include "SkCodec.h"
+#include "SkData.h"
 #include "SkEncodedFormat.h"
 #include "SkImageInfo.h"
+#include "SkTArray.h"
 #include "SkTypes.h"
 
 class SkStream;
+struct WebPDemuxer;
 
 class SkWebpCodec final : public SkCodec {
 public:
@@ -32,8 +35,34 @@ protected:
     SkISize onGetScaledDimensions(float desiredScale) const override;
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
+
+    // Animated webps read the whole stream, the first time, to find their frames.
+    int onGetFrameCount() override;
+    bool onGetFrameInfo(int index, FrameInfo* info) override;
 private:
-    SkWebpCodec(const SkImageInfo&, SkStream*);
+    SkWebpCodec(const SkImageInfo&, SkStream*, bool animated);
+    ~SkWebpCodec() override;
+
+    // Reads the stream into fData and fills in fFrames, once. Returns false on failure.
+    bool parseFrames();
+
+    // Decodes Options::fFrameIndex of an animated webp on top of the frame it requires.
+    Result decodeFrame(const SkImageInfo&, void*, size_t, const Options&);
+
+    struct Frame {
+        SkIRect fRect;                  // Within the canvas.
+        int     fDuration;              // In milliseconds.
+        bool    fDisposeToBackground;   // Cleared to transparent before the next frame.
+        bool    fBlend;                 // Blended with the canvas, rather than replacing it.
+        bool    fHasAlpha;
+        int     fRequiredFrame;
+    };
+
+    const bool              fAnimated;
+    bool                    fFramesParsed;
+    SkAutoTUnref<SkData>    fData;      // The whole file, read by fDemux.
+    WebPDemuxer*            fDemux;     // Owned.
+    SkTArray<Frame, true>   fFrames;
 
     typedef SkCodec INHERITED;
 };
@@ -12,6 +12,7 @@
 #include "SkColorPriv.h"
 #include "SkPath.h"
 #include "SkScan.h"
+#include "SkTLS.h"
 #include "SkUtils.h"
 
 class AutoAAClipValidate {
@@ -759,7 +760,16 @@ bool SkAAClip::setRect(const SkRect& r, bool doAA) {
 
     AUTO_AACLIP_VALIDATE(*this);
 
-    // TODO: special case this
+    // With its edges on pixel boundaries, an antialiased rect covers whole pixels at full alpha,
+    // so there's nothing to scan convert.
+    if (doAA) {
+        SkIRect ir;
+        r.round(&ir);
+        if (SkIntToScalar(ir.fLeft) == r.fLeft && SkIntToScalar(ir.fTop) == r.fTop &&
+            SkIntToScalar(ir.fRight) == r.fRight && SkIntToScalar(ir.fBottom) == r.fBottom) {
+            return this->setRect(ir);
+        }
+    }
 
     SkPath path;
     path.addRect(r);
@@ -948,16 +958,50 @@ class SkAAClip::Builder {
     struct Row {
         int fY;
         int fWidth;
-        SkTDArray<uint8_t>* fData;
+        int fOffset;    // of the row's runs in fData, which run up to the next row's
     };
-    SkTDArray<Row>  fRows;
+
+    // The rows and their runs, all in one buffer. Each thread keeps one of these for its
+    // builders to reuse, so that changing the clip doesn't allocate anything but the result.
+    struct Storage {
+        Storage() : fInUse(false) {}
+
+        SkTDArray<Row>      fRows;
+        SkTDArray<uint8_t>  fData;
+        bool                fInUse;
+
+        static void* Create() { return SkNEW(Storage); }
+        static void Delete(void* storage) { SkDELETE(static_cast<Storage*>(storage)); }
+    };
+
+    // A builder hands back anything bigger than this, rather than keeping it for the next one.
+    static const int kMaxPooledBytes = 64 * 1024;
+
+    Storage  fOwnStorage;   // only used if this thread's storage is taken by another builder
+    Storage* fStorage;
+    SkTDArray<Row>& fRows;
+    SkTDArray<uint8_t>& fData;
     Row* fCurrRow;
     int fPrevY;
     int fWidth;
     int fMinY;
 
+    static Storage* GetStorage(Storage* ownStorage) {
+        Storage* storage = static_cast<Storage*>(SkTLS::Get(Storage::Create, Storage::Delete));
+        if (storage->fInUse) {
+            storage = ownStorage;
+        }
+        SkASSERT(0 == storage->fRows.count() && 0 == storage->fData.count());
+        storage->fInUse = true;
+        return storage;
+    }
+
 public:
-    Builder(const SkIRect& bounds) : fBounds(bounds) {
+    Builder(const SkIRect& bounds)
+        : fBounds(bounds)
+        , fStorage(GetStorage(&fOwnStorage))
+        , fRows(fStorage->fRows)
+        , fData(fStorage->fData) {
         fPrevY = -1;
         fWidth = bounds.width();
         fCurrRow = NULL;
@@ -965,12 +1009,17 @@ public:
     }
 
     ~Builder() {
-        Row* row = fRows.begin();
-        Row* stop = fRows.end();
-        while (row < stop) {
-            delete row->fData;
-            row += 1;
+        if (fRows.reserved() > kMaxPooledBytes / SkToInt(sizeof(Row))) {
+            fRows.reset();
+        } else {
+            fRows.rewind();
         }
+        if (fData.reserved() > kMaxPooledBytes) {
+            fData.reset();
+        } else {
+            fData.rewind();
+        }
+        fStorage->fInUse = false;
     }
 
     const SkIRect& getBounds() const { return fBounds; }
@@ -990,24 +1039,21 @@ public:
             row = this->flushRow(true);
             row->fY = y;
             row->fWidth = 0;
-            SkASSERT(row->fData);
-            SkASSERT(0 == row->fData->count());
+            SkASSERT(row->fOffset == fData.count());
             fCurrRow = row;
         }
 
         SkASSERT(row->fWidth <= x);
         SkASSERT(row->fWidth < fBounds.width());
 
-        SkTDArray<uint8_t>& data = *row->fData;
-
         int gap = x - row->fWidth;
         if (gap) {
-            AppendRun(data, 0, gap);
+            AppendRun(fData, 0, gap);
             row->fWidth += gap;
             SkASSERT(row->fWidth < fBounds.width());
         }
 
-        AppendRun(data, alpha, count);
+        AppendRun(fData, alpha, count);
         row->fWidth += count;
         SkASSERT(row->fWidth <= fBounds.width());
     }
@@ -1071,15 +1117,7 @@ public:
     bool finish(SkAAClip* target) {
         this->flushRow(false);
 
-        const Row* row = fRows.begin();
-        const Row* stop = fRows.end();
-
-        size_t dataSize = 0;
-        while (row < stop) {
-            dataSize += row->fData->count();
-            row += 1;
-        }
-
+        const size_t dataSize = fData.count();
         if (0 == dataSize) {
             return target->setEmpty();
         }
@@ -1091,28 +1129,19 @@ public:
 
         RunHead* head = RunHead::Alloc(fRows.count(), dataSize);
         YOffset* yoffset = head->yoffsets();
-        uint8_t* data = head->data();
-        uint8_t* baseData = data;
+        memcpy(head->data(), fData.begin(), dataSize);
 
-        row = fRows.begin();
-        SkDEBUGCODE(int prevY = row->fY - 1;)
-        while (row < stop) {
-            SkASSERT(prevY < row->fY);  // must be monotonic
-            SkDEBUGCODE(prevY = row->fY);
+        SkDEBUGCODE(int prevY = fRows[0].fY - 1;)
+        for (int i = 0; i < fRows.count(); ++i) {
+            const Row& row = fRows[i];
+            SkASSERT(prevY < row.fY);  // must be monotonic
+            SkDEBUGCODE(prevY = row.fY);
+            SkASSERT(SkToInt(compute_row_length(head->data() + row.fOffset, fBounds.width())) ==
+                     this->rowSize(i));
 
-            yoffset->fY = row->fY - adjustY;
-            yoffset->fOffset = SkToU32(data - baseData);
+            yoffset->fY = row.fY - adjustY;
+            yoffset->fOffset = SkToU32(row.fOffset);
             yoffset += 1;
-
-            size_t n = row->fData->count();
-            memcpy(data, row->fData->begin(), n);
-#ifdef SK_DEBUG
-            size_t bytesNeeded = compute_row_length(data, fBounds.width());
-            SkASSERT(bytesNeeded == n);
-#endif
-            data += n;
-
-            row += 1;
         }
 
         target->freeRuns();
@@ -1127,10 +1156,9 @@ public:
         for (y = 0; y < fRows.count(); ++y) {
             const Row& row = fRows[y];
             SkDebugf("Y:%3d W:%3d", row.fY, row.fWidth);
-            const SkTDArray<uint8_t>& data = *row.fData;
-            int count = data.count();
+            int count = this->rowSize(y);
             SkASSERT(!(count & 1));
-            const uint8_t* ptr = data.begin();
+            const uint8_t* ptr = fData.begin() + row.fOffset;
             for (int x = 0; x < count; x += 2) {
                 SkDebugf(" [%3d:%02X]", ptr[0], ptr[1]);
                 ptr += 2;
@@ -1149,8 +1177,8 @@ public:
             const Row& row = fRows[i];
             SkASSERT(prevY < row.fY);
             SkASSERT(fWidth == row.fWidth);
-            int count = row.fData->count();
-            const uint8_t* ptr = row.fData->begin();
+            int count = this->rowSize(i);
+            const uint8_t* ptr = fData.begin() + row.fOffset;
             SkASSERT(!(count & 1));
             int w = 0;
             for (int x = 0; x < count; x += 2) {
@@ -1172,10 +1200,17 @@ public:
     }
 
 private:
+    int rowSize(int index) const {
+        int end = index + 1 < fRows.count() ? fRows[index + 1].fOffset : fData.count();
+        return end - fRows[index].fOffset;
+    }
+
+    // row must be the last one, the only one still being added to
     void flushRowH(Row* row) {
+        SkASSERT(row == &fRows.top());
         // flush current row if needed
         if (row->fWidth < fWidth) {
-            AppendRun(*row->fData, 0, fWidth - row->fWidth);
+            AppendRun(fData, 0, fWidth - row->fWidth);
             row->fWidth = fWidth;
         }
     }
@@ -1192,26 +1227,22 @@ private:
             Row* curr = &fRows[count - 1];
             SkASSERT(prev->fWidth == fWidth);
             SkASSERT(curr->fWidth == fWidth);
-            if (*prev->fData == *curr->fData) {
+            const int size = this->rowSize(count - 1);
+            if (this->rowSize(count - 2) == size &&
+                    !memcmp(fData.begin() + prev->fOffset, fData.begin() + curr->fOffset, size)) {
                 prev->fY = curr->fY;
+                fData.setCount(curr->fOffset);
                 if (readyForAnother) {
-                    curr->fData->rewind();
                     next = curr;
                 } else {
-                    delete curr->fData;
-                    fRows.removeShuffle(count - 1);
-                }
-            } else {
-                if (readyForAnother) {
-                    next = fRows.append();
-                    next->fData = new SkTDArray<uint8_t>;
+                    fRows.setCount(count - 1);
                 }
+                return next;
             }
-        } else {
-            if (readyForAnother) {
-                next = fRows.append();
-                next->fData = new SkTDArray<uint8_t>;
-            }
+        }
+        if (readyForAnother) {
+            next = fRows.append();
+            next->fOffset = fData.count();
         }
         return next;
     }
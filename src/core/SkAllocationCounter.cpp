@@ -0,0 +1,114 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAllocationCounter.h"
+
+#ifdef SK_COUNT_ALLOCATIONS
+
+#include <new>
+#include <stdlib.h>
+
+#if defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
+    #include <malloc/malloc.h>
+    static size_t usable_size(void* p) { return malloc_size(p); }
+#elif defined(SK_BUILD_FOR_WIN32)
+    #include <malloc.h>
+    static size_t usable_size(void* p) { return _msize(p); }
+#else
+    #include <malloc.h>
+    static size_t usable_size(void* p) { return malloc_usable_size(p); }
+#endif
+
+// These are touched by every allocation, so they're plain thread-locals, not SkTLS.
+// gLive goes negative if a thread frees more than it allocates.
+#if defined(_MSC_VER)
+    static __declspec(thread) uint64_t gAllocs;
+    static __declspec(thread) uint64_t gBytes;
+    static __declspec(thread) int64_t  gLive;
+    static __declspec(thread) int64_t  gPeak;
+    static __declspec(thread) int64_t  gPeakBase;
+#else
+    static __thread uint64_t gAllocs;
+    static __thread uint64_t gBytes;
+    static __thread int64_t  gLive;
+    static __thread int64_t  gPeak;
+    static __thread int64_t  gPeakBase;
+#endif
+
+void SkCountAllocation(size_t bytes) {
+    gAllocs++;
+    gBytes += bytes;
+}
+
+void SkCountLive(void* p) {
+    if (p) {
+        gLive += usable_size(p);
+        gPeak = SkTMax(gLive, gPeak);
+    }
+}
+
+void SkCountFree(void* p) {
+    if (p) {
+        gLive -= usable_size(p);
+    }
+}
+
+SkAllocationCounts SkGetThreadAllocationCounts() {
+    SkAllocationCounts counts = { gAllocs, gBytes };
+    return counts;
+}
+
+void SkResetThreadAllocationPeak() {
+    gPeak = gPeakBase = gLive;
+}
+
+uint64_t SkGetThreadAllocationPeak() {
+    return gPeak - gPeakBase;
+}
+
+// Interpose the global operator new and delete so that C++ allocations are counted too.
+
+static void* counted_new(size_t size) {
+    SkCountAllocation(size);
+    // operator new must return a unique pointer, even for 0 bytes.
+    void* p = malloc(size ? size : 1);
+    if (!p) {
+        sk_out_of_memory();
+    }
+    SkCountLive(p);
+    return p;
+}
+
+static void counted_delete(void* p) {
+    SkCountFree(p);
+    free(p);
+}
+
+void* operator new(size_t size) { return counted_new(size); }
+void* operator new[](size_t size) { return counted_new(size); }
+void* operator new(size_t size, const std::nothrow_t&) throw() { return counted_new(size); }
+void* operator new[](size_t size, const std::nothrow_t&) throw() { return counted_new(size); }
+
+void operator delete(void* p) throw() { counted_delete(p); }
+void operator delete[](void* p) throw() { counted_delete(p); }
+void operator delete(void* p, const std::nothrow_t&) throw() { counted_delete(p); }
+void operator delete[](void* p, const std::nothrow_t&) throw() { counted_delete(p); }
+
+#else
+
+void SkCountAllocation(size_t) {}
+void SkCountLive(void*) {}
+void SkCountFree(void*) {}
+void SkResetThreadAllocationPeak() {}
+uint64_t SkGetThreadAllocationPeak() { return 0; }
+
+SkAllocationCounts SkGetThreadAllocationCounts() {
+    SkAllocationCounts counts = { 0, 0 };
+    return counts;
+}
+
+#endif
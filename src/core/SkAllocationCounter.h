@@ -0,0 +1,57 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAllocationCounter_DEFINED
+#define SkAllocationCounter_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ *  Allocation counting, for finding malloc churn in benchmarks.
+ *
+ *  Builds with SK_COUNT_ALLOCATIONS defined (gyp: skia_count_allocations=1) count every
+ *  allocation made through sk_malloc_*, sk_calloc_*, sk_realloc_throw and the global operator
+ *  new, per thread.  Other builds count nothing, and SkGetThreadAllocationCounts() always
+ *  returns zeros.
+ */
+struct SkAllocationCounts {
+    uint64_t allocs;  // Number of allocations.
+    uint64_t bytes;   // Total bytes requested by those allocations.
+
+    SkAllocationCounts operator-(const SkAllocationCounts& that) const {
+        SkAllocationCounts diff = { allocs - that.allocs, bytes - that.bytes };
+        return diff;
+    }
+};
+
+/** Returns the allocations made so far by the calling thread. */
+SkAllocationCounts SkGetThreadAllocationCounts();
+
+/**
+ *  Peak tracking, for finding memory footprint regressions.
+ *
+ *  The same builds track the bytes live on each thread, counting a free against the thread that
+ *  frees, whichever thread allocated.  Sizes are malloc's usable sizes, not those requested.
+ *  Other builds track nothing, and SkGetThreadAllocationPeak() always returns zero.
+ */
+
+/** Starts a new peak from the bytes live on the calling thread now. */
+void SkResetThreadAllocationPeak();
+
+/** Returns the most bytes live on the calling thread since the last reset, less those live then. */
+uint64_t SkGetThreadAllocationPeak();
+
+/** Counts one allocation of bytes on the calling thread.  Called by the memory ports. */
+void SkCountAllocation(size_t bytes);
+
+/** Counts p, just returned by malloc, calloc or realloc, as live.  Called by the memory ports. */
+void SkCountLive(void* p);
+
+/** Counts p, about to be freed or realloc'd, as no longer live.  Called by the memory ports. */
+void SkCountFree(void* p);
+
+#endif
@@ -64,7 +64,9 @@ const SkBigPicture::Analysis& SkBigPicture::analysis() const {
 SkRect SkBigPicture::cullRect()            const { return fCullRect; }
 bool   SkBigPicture::hasText()             const { return this->analysis().fHasText; }
 bool   SkBigPicture::willPlayBackBitmaps() const { return this->analysis().fWillPlaybackBitmaps; }
-int    SkBigPicture::numSlowPaths() const { return this->analysis().fNumSlowPathsAndDashEffects; }
+SkPicture::GpuCostFeatures SkBigPicture::gpuCostFeatures() const {
+    return this->analysis().fGpuCostFeatures;
+}
 int    SkBigPicture::approximateOpCount()   const { return fRecord->count(); }
 size_t SkBigPicture::approximateBytesUsed() const {
     size_t bytes = sizeof(*this) + fRecord->bytesUsed() + fApproxBytesUsedBySubPictures;
@@ -94,5 +96,5 @@ SkBigPicture::Analysis::Analysis(const SkRecord& record) {
 
     fHasText                    = hasText;
     fWillPlaybackBitmaps        = hasBitmap;
-    fNumSlowPathsAndDashEffects = SkTMin<int>(path.fNumSlowPathsAndDashEffects, 255);
+    fGpuCostFeatures            = path.fFeatures;
 }
@@ -46,6 +46,7 @@ public:
     SkRect cullRect() const override;
     bool hasText() const override;
     bool willPlayBackBitmaps() const override;
+    GpuCostFeatures gpuCostFeatures() const override;
     int approximateOpCount() const override;
     size_t approximateBytesUsed() const override;
     const SkBigPicture* asSkBigPicture() const override { return this; }
@@ -59,6 +60,9 @@ public:
     const SkBBoxHierarchy* bbh() const { return fBBH; }
     const SkRecord*     record() const { return fRecord; }
     const AccelData* accelData() const { return fAccelData; }
+    // Used by SkTiledPictureDraw
+    int drawableCount() const;
+    SkPicture const* const* drawablePicts() const;
 
 private:
     struct Analysis {
@@ -66,15 +70,12 @@ private:
 
         bool suitableForGpuRasterization(const char** reason) const;
 
-        uint8_t fNumSlowPathsAndDashEffects;
+        GpuCostFeatures fGpuCostFeatures;
         bool    fWillPlaybackBitmaps : 1;
         bool    fHasText             : 1;
     };
 
-    int numSlowPaths() const override;
     const Analysis& analysis() const;
-    int drawableCount() const;
-    SkPicture const* const* drawablePicts() const;
 
     const SkRect                          fCullRect;
     const size_t                          fApproxBytesUsedBySubPictures;
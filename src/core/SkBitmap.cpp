@@ -9,10 +9,12 @@
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
 #include "SkData.h"
+#include "SkHalf.h"
 #include "SkFilterQuality.h"
 #include "SkMallocPixelRef.h"
 #include "SkMask.h"
 #include "SkMath.h"
+#include "SkPMFloat.h"
 #include "SkPixelRef.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
@@ -524,6 +526,9 @@ void* SkBitmap::getAddr(int x, int y) const {
     if (base) {
         base += y * this->rowBytes();
         switch (this->colorType()) {
+            case kRGBA_F16_SkColorType:
+                base += x << 3;
+                break;
             case kRGBA_8888_SkColorType:
             case kBGRA_8888_SkColorType:
                 base += x << 2;
@@ -577,6 +582,11 @@ SkColor SkBitmap::getColor(int x, int y) const {
             uint32_t* addr = this->getAddr32(x, y);
             return SkUnPreMultiply::PMColorToColor(addr[0]);
         }
+        case kRGBA_F16_SkColorType: {
+            const uint64_t* addr = (const uint64_t*)this->getAddr(x, y);
+            SkPMColor c = SkPMFloat(SkHalfToPMFloat(addr[0])).round();
+            return SkUnPreMultiply::PMColorToColor(c);
+        }
         default:
             SkASSERT(false);
             return 0;
@@ -646,6 +656,17 @@ static bool compute_is_opaque(const SkPixmap& pmap) {
             }
             return true;
         }
+        case kRGBA_F16_SkColorType: {
+            for (int y = 0; y < height; ++y) {
+                const uint64_t* row = pmap.addr64(0, y);
+                for (int x = 0; x < width; ++x) {
+                    if (SkHalfToFloat((SkHalf)(row[x] >> 48)) < 1.0f) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
         default:
             break;
     }
@@ -768,6 +789,8 @@ bool SkBitmap::canCopyTo(SkColorType dstColorType) const {
             break;
         case kARGB_4444_SkColorType:
             return sameConfigs || kN32_SkColorType == srcCT || kIndex_8_SkColorType == srcCT;
+        case kRGBA_F16_SkColorType:
+            return sameConfigs || kN32_SkColorType == srcCT;
         case kGray_8_SkColorType:
             switch (srcCT) {
                 case kGray_8_SkColorType:
@@ -55,6 +55,7 @@ SkBitmapController::State* SkBitmapController::requestBitmap(const SkBitmap& bm,
 #include "SkBitmapCache.h"
 #include "SkBitmapScaler.h"
 #include "SkMipMap.h"
+#include "SkPixelRef.h"
 #include "SkResourceCache.h"
 
 class SkDefaultBitmapControllerState : public SkBitmapController::State {
@@ -65,6 +66,7 @@ private:
     SkBitmap                     fResultBitmap;
     SkAutoTUnref<const SkMipMap> fCurrMip;
     
+    bool processScaledDecodeRequest(const SkBitmap& orig);
     bool processHQRequest(const SkBitmap& orig);
     bool processMediumRequest(const SkBitmap& orig);
 };
@@ -83,6 +85,64 @@ static inline bool cache_size_okay(const SkBitmap& bm, const SkMatrix& invMat) {
     return size < (maximumAllocation * invMat.getScaleX() * invMat.getScaleY());
 }
 
+/*
+ *  When a lazy bitmap is drawn scaled down with filtering, ask its pixelref to generate a smaller
+ *  version directly (e.g. a JPEG decoded with DCT scaling) rather than decoding it in full just
+ *  to filter it back down again.  The result is cached by its size, and is never smaller than
+ *  we'll draw it, so the HQ and medium steps can still refine it.
+ */
+bool SkDefaultBitmapControllerState::processScaledDecodeRequest(const SkBitmap& origBitmap) {
+    SkPixelRef* pr = origBitmap.pixelRef();
+    if (fQuality < kMedium_SkFilterQuality || NULL == pr || origBitmap.getPixels() ||
+        kN32_SkColorType != origBitmap.colorType() || fInvMatrix.hasPerspective()) {
+        return false;
+    }
+    // Only whole bitmaps, as a subset's pixelref origin would have to be scaled too.
+    if (origBitmap.width() != pr->info().width() || origBitmap.height() != pr->info().height()) {
+        return false;
+    }
+
+    SkSize invScale;
+    if (!fInvMatrix.decomposeScale(&invScale)) {
+        return false;
+    }
+    // Keep enough resolution for the less-shrunk axis.
+    const SkScalar desiredScale = SkScalarInvert(SkMinScalar(invScale.width(),
+                                                             invScale.height()));
+    if (!(desiredScale < 1)) {
+        return false;
+    }
+    const SkISize size = pr->getScaledDimensions(desiredScale);
+    if (size.isEmpty() || size == origBitmap.dimensions()) {
+        return false;
+    }
+
+    const SkScalar width = SkIntToScalar(size.width()),
+                   height = SkIntToScalar(size.height());
+    if (!SkBitmapCache::Find(origBitmap, width, height, &fResultBitmap)) {
+        SkBitmap scaled;
+        if (!scaled.setInfo(origBitmap.info().makeWH(size.width(), size.height()))) {
+            return false;
+        }
+        SkBitmap::Allocator* allocator = SkResourceCache::GetAllocator();
+        if (!(allocator ? allocator->allocPixelRef(&scaled, NULL) : scaled.tryAllocPixels())) {
+            return false;
+        }
+        SkAutoLockPixels alp(scaled);
+        if (!pr->generateScaledPixels(scaled.info(), scaled.getPixels(), scaled.rowBytes())) {
+            return false;
+        }
+        scaled.setImmutable();
+        SkBitmapCache::Add(origBitmap, width, height, scaled);
+        fResultBitmap = scaled;
+        fResultBitmap.lockPixels();
+    }
+
+    SkASSERT(fResultBitmap.getPixels());
+    fInvMatrix.postScale(width / origBitmap.width(), height / origBitmap.height());
+    return true;
+}
+
 /*
  *  High quality is implemented by performing up-right scale-only filtering and then
  *  using bilerp for any remaining transformations.
@@ -202,10 +262,18 @@ SkDefaultBitmapControllerState::SkDefaultBitmapControllerState(const SkBitmap& s
     fInvMatrix = inv;
     fQuality = qual;
 
-    if (this->processHQRequest(src) || this->processMediumRequest(src)) {
+    // If we can decode src smaller, the HQ and medium steps work from that instead.
+    SkBitmap decoded;
+    const SkBitmap* bitmap = &src;
+    if (this->processScaledDecodeRequest(src)) {
+        decoded = fResultBitmap;
+        bitmap = &decoded;
+    }
+
+    if (this->processHQRequest(*bitmap) || this->processMediumRequest(*bitmap)) {
         SkASSERT(fResultBitmap.getPixels());
     } else {
-        fResultBitmap = src;
+        fResultBitmap = *bitmap;
         fResultBitmap.lockPixels();
         // lock may fail to give us pixels
     }
@@ -13,8 +13,11 @@
 #include "SkPath.h"
 #include "SkPixelRef.h"
 #include "SkPixmap.h"
+#include "SkRasterClip.h"
+#include "SkRRect.h"
 #include "SkShader.h"
 #include "SkSurface.h"
+#include "SkTemplates.h"
 #include "SkXfermode.h"
 
 class SkColorTable;
@@ -53,6 +56,7 @@ static bool valid_for_bitmap_device(const SkImageInfo& info,
             canonicalAlphaType = kOpaque_SkAlphaType;
             break;
         case kN32_SkColorType:
+        case kRGBA_F16_SkColorType:
             break;
         default:
             return false;
@@ -66,7 +70,8 @@ static bool valid_for_bitmap_device(const SkImageInfo& info,
 
 SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap)
     : INHERITED(SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType))
-    , fBitmap(bitmap) {
+    , fBitmap(bitmap)
+    , fDamage(SkIRect::MakeEmpty()) {
     SkASSERT(valid_for_bitmap_device(bitmap.info(), NULL));
 }
 
@@ -76,7 +81,8 @@ SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& info) {
 
 SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps)
     : INHERITED(surfaceProps)
-    , fBitmap(bitmap) {
+    , fBitmap(bitmap)
+    , fDamage(SkIRect::MakeEmpty()) {
     SkASSERT(valid_for_bitmap_device(bitmap.info(), NULL));
 }
 
@@ -123,7 +129,10 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
 }
 
 SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPaint*) {
-    const SkSurfaceProps surfaceProps(this->surfaceProps().flags(), cinfo.fPixelGeometry);
+    // Layers are drawn back into us, so only the base device needs to track damage.
+    const SkSurfaceProps surfaceProps(this->surfaceProps().flags() &
+                                      ~SkSurfaceProps::kTrackDamage_Flag,
+                                      cinfo.fPixelGeometry);
     return SkBitmapDevice::Create(cinfo.fInfo, surfaceProps);
 }
 
@@ -134,6 +143,8 @@ const SkBitmap& SkBitmapDevice::onAccessBitmap() {
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
     if (fBitmap.lockPixelsAreWritable() && this->onPeekPixels(pmap)) {
         fBitmap.notifyPixelsChanged();
+        // The caller may write anywhere.
+        this->addDamage(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()));
         return true;
     }
     return false;
@@ -163,6 +174,7 @@ bool SkBitmapDevice::onWritePixels(const SkImageInfo& srcInfo, const void* srcPi
 
     if (SkPixelInfo::CopyPixels(dstInfo, dstPixels, dstRowBytes, srcInfo, srcPixels, srcRowBytes)) {
         fBitmap.notifyPixelsChanged();
+        this->addDamage(SkIRect::MakeXYWH(x, y, srcInfo.width(), srcInfo.height()));
         return true;
     }
     return false;
@@ -189,18 +201,103 @@ void SkBitmapDevice::onDetachFromCanvas() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SkBitmapDevice::addDamage(const SkIRect& devBounds) {
+    if (!this->isTrackingDamage()) {
+        return;
+    }
+    SkIRect r = devBounds;
+    if (r.intersect(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()))) {
+        fDamage.join(r);
+    }
+}
+
+void SkBitmapDevice::addDrawDamage(const SkDraw& draw, const SkRect& localBounds,
+                                   const SkPaint& paint, SkScalar devOutset) {
+    if (!this->isTrackingDamage() || draw.fRC->isEmpty()) {
+        return;
+    }
+    const SkIRect& clipBounds = draw.fRC->getBounds();
+    // Perspective can map geometry behind the eye, so we can only trust the clip then.
+    if (!paint.canComputeFastBounds() || draw.fMatrix->hasPerspective()) {
+        this->addDamage(clipBounds);
+        return;
+    }
+    SkRect storage;
+    SkRect devBounds;
+    draw.fMatrix->mapRect(&devBounds, paint.computeFastBounds(localBounds, &storage));
+    // Antialiasing and hairlines can touch a pixel beyond the geometry.
+    devBounds.outset(devOutset + 1, devOutset + 1);
+    if (devBounds.intersect(SkRect::Make(clipBounds))) {
+        this->addDamage(devBounds.roundOut());
+    }
+}
+
+// Computes the bounds of drawing text with paint, relative to the origin of its first glyph.
+static bool text_bounds(const SkPaint& paint, const void* text, size_t len, SkRect* bounds) {
+    if (paint.isVerticalText()) {
+        return false;
+    }
+    SkScalar width = paint.measureText(text, len, bounds);
+    switch (paint.getTextAlign()) {
+        case SkPaint::kLeft_Align:
+            break;
+        case SkPaint::kCenter_Align:
+            bounds->offset(-SkScalarHalf(width), 0);
+            break;
+        case SkPaint::kRight_Align:
+            bounds->offset(-width, 0);
+            break;
+    }
+    return bounds->isFinite();
+}
+
+// Computes the bounds of drawing glyphs at positions, like drawPosText().
+static bool pos_text_bounds(const SkPaint& paint, const void* text, size_t len,
+                            const SkScalar pos[], int scalarsPerPos, const SkPoint& offset,
+                            SkRect* bounds) {
+    if (paint.isVerticalText()) {
+        return false;
+    }
+    const int count = paint.countText(text, len);
+    SkAutoSTMalloc<64, SkScalar> widths(count);
+    SkAutoSTMalloc<64, SkRect> glyphBounds(count);
+    paint.getTextWidths(text, len, widths.get(), glyphBounds.get());
+
+    bounds->setEmpty();
+    for (int i = 0; i < count; ++i) {
+        SkScalar x = offset.x() + pos[i * scalarsPerPos];
+        SkScalar y = offset.y() + (2 == scalarsPerPos ? pos[i * 2 + 1] : 0);
+        if (SkPaint::kCenter_Align == paint.getTextAlign()) {
+            x -= SkScalarHalf(widths[i]);
+        } else if (SkPaint::kRight_Align == paint.getTextAlign()) {
+            x -= widths[i];
+        }
+        SkRect r = glyphBounds[i];
+        r.offset(x, y);
+        bounds->join(r);
+    }
+    return bounds->isFinite();
+}
+
 void SkBitmapDevice::drawPaint(const SkDraw& draw, const SkPaint& paint) {
+    this->addDamage(draw.fRC->getBounds());
     draw.drawPaint(paint);
 }
 
 void SkBitmapDevice::drawPoints(const SkDraw& draw, SkCanvas::PointMode mode, size_t count,
                                 const SkPoint pts[], const SkPaint& paint) {
     CHECK_FOR_ANNOTATION(paint);
+    if (this->isTrackingDamage()) {
+        SkRect bounds;
+        bounds.set(pts, SkToInt(count));
+        this->addDrawDamage(draw, bounds, paint);
+    }
     draw.drawPoints(mode, count, pts, paint);
 }
 
 void SkBitmapDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint& paint) {
     CHECK_FOR_ANNOTATION(paint);
+    this->addDrawDamage(draw, r, paint);
     draw.drawRect(r, paint);
 }
 
@@ -225,6 +322,7 @@ void SkBitmapDevice::drawRRect(const SkDraw& draw, const SkRRect& rrect, const S
     // required to override drawRRect.
     this->drawPath(draw, path, paint, NULL, true);
 #else
+    this->addDrawDamage(draw, rrect.getBounds(), paint);
     draw.drawRRect(rrect, paint);
 #endif
 }
@@ -233,11 +331,27 @@ void SkBitmapDevice::drawPath(const SkDraw& draw, const SkPath& path,
                               const SkPaint& paint, const SkMatrix* prePathMatrix,
                               bool pathIsMutable) {
     CHECK_FOR_ANNOTATION(paint);
+    if (this->isTrackingDamage()) {
+        if (path.isInverseFillType()) {
+            this->addDamage(draw.fRC->getBounds());
+        } else {
+            SkRect bounds = path.getBounds();
+            if (prePathMatrix) {
+                prePathMatrix->mapRect(&bounds);
+            }
+            this->addDrawDamage(draw, bounds, paint);
+        }
+    }
     draw.drawPath(path, paint, prePathMatrix, pathIsMutable);
 }
 
 void SkBitmapDevice::drawBitmap(const SkDraw& draw, const SkBitmap& bitmap,
                                 const SkMatrix& matrix, const SkPaint& paint) {
+    if (this->isTrackingDamage()) {
+        SkRect bounds;
+        matrix.mapRect(&bounds, SkRect::MakeIWH(bitmap.width(), bitmap.height()));
+        this->addDrawDamage(draw, bounds, paint);
+    }
     draw.drawBitmap(bitmap, matrix, NULL, paint);
 }
 
@@ -248,6 +362,7 @@ void SkBitmapDevice::drawBitmapRect(const SkDraw& draw, const SkBitmap& bitmap,
     SkRect      bitmapBounds, tmpSrc, tmpDst;
     SkBitmap    tmpBitmap;
 
+    this->addDrawDamage(draw, dst, paint);
     bitmapBounds.isetWH(bitmap.width(), bitmap.height());
 
     // Compute matrix from the two rectangles
@@ -334,17 +449,41 @@ void SkBitmapDevice::drawBitmapRect(const SkDraw& draw, const SkBitmap& bitmap,
 
 void SkBitmapDevice::drawSprite(const SkDraw& draw, const SkBitmap& bitmap,
                                 int x, int y, const SkPaint& paint) {
+    if (this->isTrackingDamage()) {
+        SkIRect bounds = SkIRect::MakeXYWH(x, y, bitmap.width(), bitmap.height());
+        if (bounds.intersect(draw.fRC->getBounds())) {
+            this->addDamage(bounds);
+        }
+    }
     draw.drawSprite(bitmap, x, y, paint);
 }
 
 void SkBitmapDevice::drawText(const SkDraw& draw, const void* text, size_t len,
                               SkScalar x, SkScalar y, const SkPaint& paint) {
+    if (this->isTrackingDamage()) {
+        SkRect bounds;
+        if (text_bounds(paint, text, len, &bounds)) {
+            bounds.offset(x, y);
+            // Glyphs are hinted at device scale, so they may not quite match their measurements.
+            this->addDrawDamage(draw, bounds, paint, SK_Scalar1);
+        } else {
+            this->addDamage(draw.fRC->getBounds());
+        }
+    }
     draw.drawText((const char*)text, len, x, y, paint);
 }
 
 void SkBitmapDevice::drawPosText(const SkDraw& draw, const void* text, size_t len,
                                  const SkScalar xpos[], int scalarsPerPos,
                                  const SkPoint& offset, const SkPaint& paint) {
+    if (this->isTrackingDamage()) {
+        SkRect bounds;
+        if (pos_text_bounds(paint, text, len, xpos, scalarsPerPos, offset, &bounds)) {
+            this->addDrawDamage(draw, bounds, paint, SK_Scalar1);
+        } else {
+            this->addDamage(draw.fRC->getBounds());
+        }
+    }
     draw.drawPosText((const char*)text, len, xpos, scalarsPerPos, offset, paint);
 }
 
@@ -354,13 +493,47 @@ void SkBitmapDevice::drawVertices(const SkDraw& draw, SkCanvas::VertexMode vmode
                                   const SkColor colors[], SkXfermode* xmode,
                                   const uint16_t indices[], int indexCount,
                                   const SkPaint& paint) {
+    if (this->isTrackingDamage()) {
+        SkRect bounds;
+        bounds.set(verts, vertexCount);
+        this->addDrawDamage(draw, bounds, paint);
+    }
     draw.drawVertices(vmode, vertexCount, verts, textures, colors, xmode,
                       indices, indexCount, paint);
 }
 
+void SkBitmapDevice::drawAtlas(const SkDraw& draw, const SkImage* atlas, const SkRSXform xform[],
+                               const SkRect tex[], const SkColor colors[], int count,
+                               SkXfermode::Mode mode, const SkPaint& paint) {
+    // Tinted sprites need a color filter per sprite, and the rest need the general path pipeline.
+    bool tinted = false;
+    for (int i = 0; colors && i < count; ++i) {
+        if (colors[i] != SK_ColorWHITE) {
+            tinted = true;
+            break;
+        }
+    }
+    if (tinted || paint.getMaskFilter() || paint.getPathEffect() || paint.getRasterizer()) {
+        this->INHERITED::drawAtlas(draw, atlas, xform, tex, colors, count, mode, paint);
+        return;
+    }
+
+    if (this->isTrackingDamage()) {
+        this->addDamage(draw.fRC->getBounds());
+    }
+    draw.drawAtlas(atlas, xform, tex, count, paint);
+}
+
 void SkBitmapDevice::drawDevice(const SkDraw& draw, SkBaseDevice* device,
                                 int x, int y, const SkPaint& paint) {
-    draw.drawSprite(static_cast<SkBitmapDevice*>(device)->fBitmap, x, y, paint);
+    const SkBitmap& src = static_cast<SkBitmapDevice*>(device)->fBitmap;
+    if (this->isTrackingDamage()) {
+        SkIRect bounds = SkIRect::MakeXYWH(x, y, src.width(), src.height());
+        if (bounds.intersect(draw.fRC->getBounds())) {
+            this->addDamage(bounds);
+        }
+    }
+    draw.drawSprite(src, x, y, paint);
 }
 
 SkSurface* SkBitmapDevice::newSurface(const SkImageInfo& info, const SkSurfaceProps& props) {
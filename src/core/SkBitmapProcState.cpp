@@ -10,6 +10,8 @@
 #include "SkBitmapProcState.h"
 #include "SkColorPriv.h"
 #include "SkFilterProc.h"
+#include "SkHalf.h"
+#include "SkPMFloat.h"
 #include "SkPaint.h"
 #include "SkShader.h"   // for tilemodes
 #include "SkUtilsArm.h"
@@ -32,6 +34,7 @@ extern void  Clamp_SI8_opaque_D32_filter_DX_shaderproc_neon(const SkBitmapProcSt
 #endif
 
 extern void Clamp_S32_opaque_D32_nofilter_DX_shaderproc(const SkBitmapProcState&, int, int, uint32_t*, int);
+extern void Clamp_S32_opaque_D32_nofilter_intscaleX_shaderproc(const SkBitmapProcState&, int, int, uint32_t*, int);
 
 #define   NAME_WRAP(x)  x
 #include "SkBitmapProcState_filter.h"
@@ -103,6 +106,101 @@ static bool valid_for_filtering(unsigned dimension) {
     return (dimension & ~0x3FFF) == 0;
 }
 
+static inline int tile_f16(int i, int size, SkShader::TileMode mode) {
+    switch (mode) {
+        case SkShader::kClamp_TileMode:
+            return SkClampMax(i, size - 1);
+        case SkShader::kRepeat_TileMode:
+            i %= size;
+            return i < 0 ? i + size : i;
+        case SkShader::kMirror_TileMode: {
+            int period = 2 * size;
+            i %= period;
+            if (i < 0) {
+                i += period;
+            }
+            return i < size ? i : period - 1 - i;
+        }
+        default:
+            SkDEBUGFAIL("unknown tile mode");
+            return 0;
+    }
+}
+
+// Half-float sources are sampled (and filtered) in floats, one pixel at a time, so there are no
+// separate matrix and sample procs for them.
+static void F16_D32_shaderproc(const SkBitmapProcState& s, int x, int y,
+                               SkPMColor* SK_RESTRICT colors, int count) {
+    SkASSERT(!s.fInvMatrix.hasPerspective());
+    SkASSERT(kRGBA_F16_SkColorType == s.fPixmap.colorType());
+
+    const SkShader::TileMode tx = (SkShader::TileMode)s.fTileModeX;
+    const SkShader::TileMode ty = (SkShader::TileMode)s.fTileModeY;
+    const int width = s.fPixmap.width();
+    const int height = s.fPixmap.height();
+    const bool filter = kNone_SkFilterQuality != s.fFilterLevel;
+    const Sk4f alphaScale(s.fAlphaScale * (1.0f / 256));
+
+    SkPoint pt;
+    s.fInvProc(s.fInvMatrix, SkIntToScalar(x) + SK_ScalarHalf,
+               SkIntToScalar(y) + SK_ScalarHalf, &pt);
+    const float dx = s.fInvMatrix.getScaleX(),
+                dy = s.fInvMatrix.getSkewY();
+    float fx = pt.fX,
+          fy = pt.fY;
+
+    for (int i = 0; i < count; ++i) {
+        Sk4f c;
+        if (filter) {
+            float sx = fx - 0.5f,
+                  sy = fy - 0.5f;
+            int x0 = (int)floorf(sx),
+                y0 = (int)floorf(sy);
+            Sk4f wx(sx - x0),
+                 wy(sy - y0);
+            int ix0 = tile_f16(x0, width, tx),
+                ix1 = tile_f16(x0 + 1, width, tx);
+            const uint64_t* row0 = s.fPixmap.addr64(0, tile_f16(y0, height, ty));
+            const uint64_t* row1 = s.fPixmap.addr64(0, tile_f16(y0 + 1, height, ty));
+
+            Sk4f top = SkHalfToPMFloat(row0[ix0]),
+                 bot = SkHalfToPMFloat(row1[ix0]);
+            Sk4f left = top + (bot - top) * wy;
+            top = SkHalfToPMFloat(row0[ix1]);
+            bot = SkHalfToPMFloat(row1[ix1]);
+            Sk4f right = top + (bot - top) * wy;
+            c = left + (right - left) * wx;
+        } else {
+            int ix = tile_f16((int)floorf(fx), width, tx),
+                iy = tile_f16((int)floorf(fy), height, ty);
+            c = SkHalfToPMFloat(*s.fPixmap.addr64(ix, iy));
+        }
+        colors[i] = SkPMFloat(c * alphaScale).round();
+        fx += dx;
+        fy += dy;
+    }
+}
+
+bool SkBitmapProcState::setupForF16(const SkPaint& paint) {
+    if (fInvMatrix.hasPerspective() || kUnpremul_SkAlphaType == fPixmap.alphaType()) {
+        return false;
+    }
+    fInvProc = fInvMatrix.getMapXYProc();
+    fInvType = fInvMatrix.getType();
+    fAlphaScale = SkAlpha255To256(paint.getAlpha());
+
+    // The bitmap controller has already handled anything above low quality, and filtering in
+    // floats has none of the size limits of the fixed point procs.
+    SkASSERT(fFilterLevel <= kLow_SkFilterQuality);
+
+    fMatrixProc = NULL;
+    fSampleProc32 = NULL;
+    fSampleProc16 = NULL;
+    fShaderProc16 = NULL;
+    fShaderProc32 = F16_D32_shaderproc;
+    return true;
+}
+
 /*
  *  Analyze filter-quality and matrix, and decide how to implement that.
  *
@@ -129,6 +227,10 @@ bool SkBitmapProcState::chooseProcs(const SkMatrix& inv, const SkPaint& paint) {
     fInvMatrix = fBMState->invMatrix();
     fFilterLevel = fBMState->quality();
     SkASSERT(fPixmap.addr());
+
+    if (kRGBA_F16_SkColorType == fPixmap.colorType()) {
+        return this->setupForF16(paint);
+    }
     
     bool trivialMatrix = (fInvMatrix.getType() & ~SkMatrix::kTranslate_Mask) == 0;
     bool clampClamp = SkShader::kClamp_TileMode == fTileModeX &&
@@ -237,6 +339,7 @@ bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp,
             case kRGB_565_SkColorType:
                 index |= 8;
                 break;
+#ifndef SK_LEAN_COLOR_TYPES
             case kIndex_8_SkColorType:
                 if (kPremul_SkAlphaType != at && kOpaque_SkAlphaType != at) {
                     return false;
@@ -249,6 +352,7 @@ bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp,
                 }
                 index |= 24;
                 break;
+#endif
             case kAlpha_8_SkColorType:
                 index |= 32;
                 fPaintPMColor = SkPreMultiplyColor(paint.getColor());
@@ -282,6 +386,7 @@ bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp,
             S16_opaque_D32_filter_DX,
             S16_alpha_D32_filter_DX,
 
+#ifndef SK_LEAN_COLOR_TYPES
             SI8_opaque_D32_nofilter_DXDY,
             SI8_alpha_D32_nofilter_DXDY,
             SI8_opaque_D32_nofilter_DX,
@@ -299,6 +404,11 @@ bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp,
             S4444_alpha_D32_filter_DXDY,
             S4444_opaque_D32_filter_DX,
             S4444_alpha_D32_filter_DX,
+#else
+            // Index8 and 4444 sources are compiled out of lean builds
+            NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+            NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+#endif
             
             // A8 treats alpha/opaque the same (equally efficient)
             SA8_alpha_D32_nofilter_DXDY,
@@ -332,10 +442,14 @@ bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp,
             S16_D16_filter_DXDY,
             S16_D16_filter_DX,
 
+#ifndef SK_LEAN_COLOR_TYPES
             SI8_D16_nofilter_DXDY,
             SI8_D16_nofilter_DX,
             SI8_D16_filter_DXDY,
             SI8_D16_filter_DX,
+#else
+            NULL, NULL, NULL, NULL,
+#endif
 
             // Don't support 4444 -> 565
             NULL, NULL, NULL, NULL,
@@ -358,10 +472,16 @@ bool SkBitmapProcState::chooseScanlineProcs(bool trivialMatrix, bool clampClamp,
                        SkShader::kRepeat_TileMode == fTileModeY) {
                 fShaderProc16 = SK_ARM_NEON_WRAP(Repeat_S16_D16_filter_DX_shaderproc);
             }
+#ifndef SK_LEAN_COLOR_TYPES
         } else if (SK_ARM_NEON_WRAP(SI8_opaque_D32_filter_DX) == fSampleProc32 && clampClamp) {
             fShaderProc32 = SK_ARM_NEON_WRAP(Clamp_SI8_opaque_D32_filter_DX_shaderproc);
+#endif
         } else if (S32_opaque_D32_nofilter_DX == fSampleProc32 && clampClamp) {
-            fShaderProc32 = Clamp_S32_opaque_D32_nofilter_DX_shaderproc;
+            if (this->setupForIntegerScaleX()) {
+                fShaderProc32 = Clamp_S32_opaque_D32_nofilter_intscaleX_shaderproc;
+            } else {
+                fShaderProc32 = Clamp_S32_opaque_D32_nofilter_DX_shaderproc;
+            }
         }
 
         if (NULL == fShaderProc32) {
@@ -630,6 +750,24 @@ bool SkBitmapProcState::setupForTranslate() {
     return true;
 }
 
+bool SkBitmapProcState::setupForIntegerScaleX() {
+    if (!(fInvType & SkMatrix::kScale_Mask) || fInvMatrix.getScaleX() <= 0) {
+        return false;
+    }
+    // Only upscales gain from replication, and large scales are rare enough to leave alone.
+    static const int kMaxScale = 16;
+    const SkScalar scale = SkScalarInvert(fInvMatrix.getScaleX());
+    const int intScale = SkScalarRoundToInt(scale);
+    if (intScale < 2 || intScale > kMaxScale ||
+        !SkScalarNearlyEqual(scale, SkIntToScalar(intScale), SK_Scalar1 / 4096)) {
+        return false;
+    }
+
+    // As in setupForTranslate(), fFilterOneX is free since we're not filtered.
+    fFilterOneX = intScale;
+    return true;
+}
+
 SkBitmapProcState::ShaderProc32 SkBitmapProcState::chooseShaderProc32() {
 
     if (kN32_SkColorType != fPixmap.colorType()) {
@@ -847,3 +985,38 @@ void  Clamp_S32_opaque_D32_nofilter_DX_shaderproc(const SkBitmapProcState& s, in
     }
 }
 
+void Clamp_S32_opaque_D32_nofilter_intscaleX_shaderproc(const SkBitmapProcState& s, int x, int y,
+                                                        SkPMColor* SK_RESTRICT colors, int count) {
+    SkASSERT((s.fInvType & ~(SkMatrix::kTranslate_Mask | SkMatrix::kScale_Mask)) == 0);
+    SkASSERT(count > 0 && colors != NULL);
+    SkASSERT(kNone_SkFilterQuality == s.fFilterLevel);
+
+    // setupForIntegerScaleX() stored the number of device pixels per source pixel.
+    const int scale = s.fFilterOneX;
+    const int maxX = s.fPixmap.width() - 1;
+    const int maxY = s.fPixmap.height() - 1;
+
+    SkPoint pt;
+    s.fInvProc(s.fInvMatrix, SkIntToScalar(x) + SK_ScalarHalf,
+               SkIntToScalar(y) + SK_ScalarHalf, &pt);
+    const SkPMColor* row = s.fPixmap.addr32(0, SkClampMax(SkScalarFloorToInt(pt.fY), maxY));
+
+    int ix = SkScalarFloorToInt(pt.fX);
+    // The first source pixel may already be partially covered by the pixels left of x.
+    int phase = SkScalarFloorToInt((pt.fX - SkIntToScalar(ix)) * scale);
+    int run = scale - SkTPin(phase, 0, scale - 1);
+
+    // Each source pixel is replicated across 'scale' device pixels instead of being sampled
+    // once per device pixel.
+    while (count > 0) {
+        const SkPMColor color = row[SkClampMax(ix, maxX)];
+        const int n = SkMin32(run, count);
+        for (int i = 0; i < n; ++i) {
+            colors[i] = color;
+        }
+        colors += n;
+        count -= n;
+        ix += 1;
+        run = scale;
+    }
+}
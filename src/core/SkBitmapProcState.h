@@ -143,6 +143,12 @@ private:
     // Return false if we failed to setup for fast translate (e.g. overflow)
     bool setupForTranslate();
 
+    // Return false unless the matrix magnifies X by a whole number of device pixels
+    bool setupForIntegerScaleX();
+
+    // Return false if we can't sample this half-float bitmap (e.g. perspective)
+    bool setupForF16(const SkPaint&);
+
 #ifdef SK_DEBUG
     static void DebugMatrixProc(const SkBitmapProcState&,
                                 uint32_t[], int count, int x, int y);
@@ -144,6 +144,7 @@ static inline U8CPU Filter_8(unsigned x, unsigned y,
 #define SRC_TO_FILTER(src)      src
 #include "SkBitmapProcState_sample.h"
 
+#ifndef SK_LEAN_COLOR_TYPES
 // SRC == Index8
 
 #undef FILTER_PROC
@@ -206,6 +207,8 @@ static inline U8CPU Filter_8(unsigned x, unsigned y,
 #define SRC_TO_FILTER(src)      src
 #include "SkBitmapProcState_sample.h"
 
+#endif
+
 // SRC == A8
 
 #undef FILTER_PROC
@@ -285,6 +288,7 @@ static inline U8CPU Filter_8(unsigned x, unsigned y,
 #define SRC_TO_FILTER(src)      src
 #include "SkBitmapProcState_sample.h"
 
+#ifndef SK_LEAN_COLOR_TYPES
 // SRC == Index8
 
 #undef FILTER_PROC
@@ -304,6 +308,7 @@ static inline U8CPU Filter_8(unsigned x, unsigned y,
 #define SRC_TO_FILTER(src)      table[src]
 #define POSTAMBLE(state)
 #include "SkBitmapProcState_sample.h"
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -343,6 +348,7 @@ static inline U8CPU Filter_8(unsigned x, unsigned y,
 #include "SkBitmapProcState_shaderproc.h"
 
 
+#ifndef SK_LEAN_COLOR_TYPES
 #define TILEX_PROCF(fx, max)    SkClampMax((fx) >> 16, max)
 #define TILEY_PROCF(fy, max)    SkClampMax((fy) >> 16, max)
 #define TILEX_LOW_BITS(fx, max) (((fx) >> 12) & 0xF)
@@ -358,5 +364,6 @@ static inline U8CPU Filter_8(unsigned x, unsigned y,
 #define SRC_TO_FILTER(src)      table[src]
 #define POSTAMBLE(state)
 #include "SkBitmapProcState_shaderproc.h"
+#endif
 
 #undef NAME_WRAP
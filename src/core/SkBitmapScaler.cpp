@@ -107,17 +107,14 @@ SkResizeFilter::SkResizeFilter(SkBitmapScaler::ResizeMethod method,
     }
 }
 
-// TODO(egouriou): Take advantage of periods in the convolution.
 // Practical resizing filters are periodic outside of the border area.
 // For Lanczos, a scaling by a (reduced) factor of p/q (q pixels in the
 // source become p pixels in the destination) will have a period of p.
 // A nice consequence is a period of 1 when downscaling by an integral
-// factor. Downscaling from typical display resolutions is also bound
-// to produce interesting periods as those are chosen to have multiple
-// small factors.
-// Small periods reduce computational load and improve cache usage if
-// the coefficients can be shared. For periods of 1 we can consider
-// loading the factors only once outside the borders.
+// factor. SkConvolutionFilter1D::AddFilter() shares the factors of filters
+// within a short period, which keeps them in cache during the convolution.
+// TODO(egouriou): For periods of 1 we can consider loading the factors only
+// once outside the borders.
 void SkResizeFilter::computeFilters(int srcSize,
                                   float destSubsetLo, float destSubsetSize,
                                   float scale,
@@ -8,25 +8,64 @@
 #include "SkBlitMask.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkUtils.h"
+
+// Returns how many of the first n coverage values are part of a run of whole words of four
+// all matching aa4. Compares four bytes at a time so long runs are found quickly.
+static inline int a8_run_length(const uint8_t* SK_RESTRICT mask, int n, uint32_t aa4) {
+    int run = 0;
+    while (run + 4 <= n) {
+        uint32_t m;
+        memcpy(&m, mask + run, 4);
+        if (m != aa4) {
+            break;
+        }
+        run += 4;
+    }
+    return run;
+}
+
+// Blits one row of A8 coverage with blend(dst, aa). Runs of zero coverage are skipped, and when
+// the color is opaque runs of full coverage are filled with pmc, so large glyphs and shapes only
+// pay for blending along their edges.
+template <bool kOpaque, typename Blend>
+static inline void blit_a8_row(SkPMColor* SK_RESTRICT device, const uint8_t* SK_RESTRICT mask,
+                               int width, SkPMColor pmc, const Blend& blend) {
+    while (width >= 4) {
+        int run = a8_run_length(mask, width, 0);
+        if (0 == run && kOpaque) {
+            run = a8_run_length(mask, width, 0xFFFFFFFF);
+            if (run > 0) {
+                sk_memset32(device, pmc, run);
+            }
+        }
+        if (0 == run) {
+            for (int i = 0; i < 4; i++) {
+                device[i] = blend(device[i], mask[i]);
+            }
+            run = 4;
+        }
+        device += run;
+        mask += run;
+        width -= run;
+    }
+    for (int i = 0; i < width; i++) {
+        device[i] = blend(device[i], mask[i]);
+    }
+}
 
 static void D32_A8_Color(void* SK_RESTRICT dst, size_t dstRB,
                          const void* SK_RESTRICT maskPtr, size_t maskRB,
                          SkColor color, int width, int height) {
     SkPMColor pmc = SkPreMultiplyColor(color);
-    size_t dstOffset = dstRB - (width << 2);
-    size_t maskOffset = maskRB - width;
     SkPMColor* SK_RESTRICT device = (SkPMColor *)dst;
     const uint8_t* SK_RESTRICT mask = (const uint8_t*)maskPtr;
 
+    auto blend = [pmc](SkPMColor d, unsigned aa) { return SkBlendARGB32(pmc, d, aa); };
     do {
-        int w = width;
-        do {
-            unsigned aa = *mask++;
-            *device = SkBlendARGB32(pmc, *device, aa);
-            device += 1;
-        } while (--w != 0);
-        device = (uint32_t*)((char*)device + dstOffset);
-        mask += maskOffset;
+        blit_a8_row<false>(device, mask, width, pmc, blend);
+        device = (uint32_t*)((char*)device + dstRB);
+        mask += maskRB;
     } while (--height != 0);
 }
 
@@ -37,15 +76,11 @@ static void D32_A8_Opaque(void* SK_RESTRICT dst, size_t dstRB,
     SkPMColor* SK_RESTRICT device = (SkPMColor*)dst;
     const uint8_t* SK_RESTRICT mask = (const uint8_t*)maskPtr;
 
-    maskRB -= width;
-    dstRB -= (width << 2);
+    auto blend = [pmc](SkPMColor d, unsigned aa) {
+        return SkAlphaMulQ(pmc, SkAlpha255To256(aa)) + SkAlphaMulQ(d, SkAlpha255To256(255 - aa));
+    };
     do {
-        int w = width;
-        do {
-            unsigned aa = *mask++;
-            *device = SkAlphaMulQ(pmc, SkAlpha255To256(aa)) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
-            device += 1;
-        } while (--w != 0);
+        blit_a8_row<true>(device, mask, width, pmc, blend);
         device = (uint32_t*)((char*)device + dstRB);
         mask += maskRB;
     } while (--height != 0);
@@ -57,15 +92,11 @@ static void D32_A8_Black(void* SK_RESTRICT dst, size_t dstRB,
     SkPMColor* SK_RESTRICT device = (SkPMColor*)dst;
     const uint8_t* SK_RESTRICT mask = (const uint8_t*)maskPtr;
 
-    maskRB -= width;
-    dstRB -= (width << 2);
+    auto blend = [](SkPMColor d, unsigned aa) {
+        return (aa << SK_A32_SHIFT) + SkAlphaMulQ(d, SkAlpha255To256(255 - aa));
+    };
     do {
-        int w = width;
-        do {
-            unsigned aa = *mask++;
-            *device = (aa << SK_A32_SHIFT) + SkAlphaMulQ(*device, SkAlpha255To256(255 - aa));
-            device += 1;
-        } while (--w != 0);
+        blit_a8_row<true>(device, mask, width, SkPackARGB32(0xFF, 0, 0, 0), blend);
         device = (uint32_t*)((char*)device + dstRB);
         mask += maskRB;
     } while (--height != 0);
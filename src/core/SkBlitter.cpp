@@ -898,6 +898,10 @@ SkBlitter* SkBlitter::Choose(const SkPixmap& device,
             blitter = SkBlitter_ChooseD565(device, *paint, shaderContext, allocator);
             break;
 
+        case kRGBA_F16_SkColorType:
+            blitter = SkBlitter_ChooseF16(device, *paint, shaderContext, allocator);
+            break;
+
         case kN32_SkColorType:
             if (shader) {
                 blitter = allocator->createT<SkARGB32_Shader_Blitter>(
@@ -353,6 +353,9 @@ SkARGB32_Shader_Blitter::SkARGB32_Shader_Blitter(const SkPixmap& device,
     }
 
     fConstInY = SkToBool(shaderContext->getFlags() & SkShader::kConstInY32_Flag);
+
+    // Bitmap shaders can be called without a virtual call per span.
+    fShadeProc = shaderContext->asAShadeProc(&fShadeProcContext);
 }
 
 SkARGB32_Shader_Blitter::~SkARGB32_Shader_Blitter() {
@@ -360,21 +363,37 @@ SkARGB32_Shader_Blitter::~SkARGB32_Shader_Blitter() {
     sk_free(fBuffer);
 }
 
+// Shading a whole row into fBuffer and then blending it streams the row through memory twice.
+// Alternating between the shader (including any color filter it wraps) and the blend a chunk at
+// a time keeps the shaded colors in L1 instead.
+static const int kFusedChunkSize = 128;
+
+void SkARGB32_Shader_Blitter::shadeAndBlend(int x, int y, uint32_t device[], int count,
+                                            SkBlitRow::Proc32 proc, U8CPU alpha) {
+    SkPMColor* span = fBuffer;
+    while (count > 0) {
+        int n = SkTMin(count, kFusedChunkSize);
+        this->shade(x, y, span, n);
+        proc(device, span, n, alpha);
+        x += n;
+        device += n;
+        count -= n;
+    }
+}
+
 void SkARGB32_Shader_Blitter::blitH(int x, int y, int width) {
     SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width());
 
     uint32_t* device = fDevice.writable_addr32(x, y);
 
     if (fShadeDirectlyIntoDevice) {
-        fShaderContext->shadeSpan(x, y, device, width);
-    } else {
+        this->shade(x, y, device, width);
+    } else if (fXfermode) {
         SkPMColor*  span = fBuffer;
         fShaderContext->shadeSpan(x, y, span, width);
-        if (fXfermode) {
-            fXfermode->xfer32(device, span, width, NULL);
-        } else {
-            fProc32(device, span, width, 255);
-        }
+        fXfermode->xfer32(device, span, width, NULL);
+    } else {
+        this->shadeAndBlend(x, y, device, width, fProc32, 255);
     }
 }
 
@@ -443,10 +462,8 @@ void SkARGB32_Shader_Blitter::blitRect(int x, int y, int width, int height) {
                 device = (uint32_t*)((char*)device + deviceRB);
             } while (--height > 0);
         } else {
-            SkBlitRow::Proc32 proc = fProc32;
             do {
-                shaderContext->shadeSpan(x, y, span, width);
-                proc(device, span, width, 255);
+                this->shadeAndBlend(x, y, device, width, fProc32, 255);
                 y += 1;
                 device = (uint32_t*)((char*)device + deviceRB);
             } while (--height > 0);
@@ -514,11 +531,10 @@ void SkARGB32_Shader_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
             }
             int aa = *antialias;
             if (aa) {
-                shaderContext->shadeSpan(x, y, span, count);
                 if (aa == 255) {
-                    fProc32(device, span, count, 255);
+                    this->shadeAndBlend(x, y, device, count, fProc32, 255);
                 } else {
-                    fProc32Blend(device, span, count, aa);
+                    this->shadeAndBlend(x, y, device, count, fProc32Blend, aa);
                 }
             }
             device += count;
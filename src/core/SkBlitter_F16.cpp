@@ -0,0 +1,293 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCoreBlitters.h"
+#include "SkColorPriv.h"
+#include "SkHalf.h"
+#include "SkPMFloat.h"
+#include "SkShader.h"
+#include "SkXfermode.h"
+
+/*  Blitters for kRGBA_F16_SkColorType. Each pixel is loaded into an SkPMFloat, blended in float
+    and stored back as halfs, so blending happens at full float precision and values above 1
+    written by earlier draws survive later ones.
+ */
+
+static inline Sk4f coverage_to_float(unsigned aa) {
+    return Sk4f(aa * (1.0f / 255));
+}
+
+static inline SkPMFloat srcover(const SkPMFloat& s, const SkPMFloat& d) {
+    return s + d * (Sk4f(1) - s.alphas());
+}
+
+// Blends src over the pixels in dst, scaling src by aa[] (or not at all if aa is NULL).
+static void srcover_row(uint64_t dst[], const SkPMFloat& src, int count, const SkAlpha aa[]) {
+    if (NULL == aa && 1.0f == src.a()) {
+        const uint64_t src16 = SkPMFloatToHalf(src);
+        for (int i = 0; i < count; ++i) {
+            dst[i] = src16;
+        }
+        return;
+    }
+    for (int i = 0; i < count; ++i) {
+        SkPMFloat s = aa ? SkPMFloat(src * coverage_to_float(aa[i])) : src;
+        dst[i] = SkPMFloatToHalf(srcover(s, SkHalfToPMFloat(dst[i])));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+class SkF16_Blitter : public SkRasterBlitter {
+public:
+    SkF16_Blitter(const SkPixmap& device, const SkPaint& paint);
+    void blitH(int x, int y, int width) override;
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override;
+    void blitV(int x, int y, int height, SkAlpha alpha) override;
+    void blitRect(int x, int y, int width, int height) override;
+    void blitMask(const SkMask&, const SkIRect&) override;
+
+private:
+    SkPMFloat   fColor;
+
+    typedef SkRasterBlitter INHERITED;
+};
+
+SkF16_Blitter::SkF16_Blitter(const SkPixmap& device, const SkPaint& paint)
+    : INHERITED(device) {
+    SkColor color = paint.getColor();
+    float a = SkColorGetA(color) * (1.0f / 255);
+    float scale = a * (1.0f / 255);
+    fColor = SkPMFloat::FromARGB(a, SkColorGetR(color) * scale, SkColorGetG(color) * scale,
+                                 SkColorGetB(color) * scale);
+}
+
+void SkF16_Blitter::blitH(int x, int y, int width) {
+    SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width());
+    srcover_row(fDevice.writable_addr64(x, y), fColor, width, NULL);
+}
+
+void SkF16_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) {
+    uint64_t* device = fDevice.writable_addr64(x, y);
+    for (;;) {
+        int count = runs[0];
+        SkASSERT(count >= 0);
+        if (count <= 0) {
+            return;
+        }
+        unsigned aa = antialias[0];
+        if (aa) {
+            if (255 == aa) {
+                srcover_row(device, fColor, count, NULL);
+            } else {
+                srcover_row(device, SkPMFloat(fColor * coverage_to_float(aa)), count, NULL);
+            }
+        }
+        runs += count;
+        antialias += count;
+        device += count;
+    }
+}
+
+void SkF16_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
+    if (0 == alpha) {
+        return;
+    }
+    SkPMFloat color = 255 == alpha ? fColor : SkPMFloat(fColor * coverage_to_float(alpha));
+    uint64_t* device = fDevice.writable_addr64(x, y);
+    size_t deviceRB = fDevice.rowBytes();
+    while (--height >= 0) {
+        srcover_row(device, color, 1, NULL);
+        device = (uint64_t*)((char*)device + deviceRB);
+    }
+}
+
+void SkF16_Blitter::blitRect(int x, int y, int width, int height) {
+    SkASSERT(x >= 0 && y >= 0 && x + width <= fDevice.width() && y + height <= fDevice.height());
+    uint64_t* device = fDevice.writable_addr64(x, y);
+    size_t deviceRB = fDevice.rowBytes();
+    while (--height >= 0) {
+        srcover_row(device, fColor, width, NULL);
+        device = (uint64_t*)((char*)device + deviceRB);
+    }
+}
+
+void SkF16_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
+    if (SkMask::kA8_Format != mask.fFormat) {
+        this->INHERITED::blitMask(mask, clip);
+        return;
+    }
+    SkASSERT(mask.fBounds.contains(clip));
+
+    const uint8_t* maskRow = mask.getAddr8(clip.fLeft, clip.fTop);
+    uint64_t* device = fDevice.writable_addr64(clip.fLeft, clip.fTop);
+    size_t deviceRB = fDevice.rowBytes();
+    for (int height = clip.height(); height > 0; --height) {
+        srcover_row(device, fColor, clip.width(), maskRow);
+        device = (uint64_t*)((char*)device + deviceRB);
+        maskRow += mask.fRowBytes;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static inline Sk4f xfer_coeff(SkXfermode::Coeff coeff, const SkPMFloat& s, const SkPMFloat& d) {
+    switch (coeff) {
+        case SkXfermode::kZero_Coeff: return Sk4f(0);
+        case SkXfermode::kOne_Coeff:  return Sk4f(1);
+        case SkXfermode::kSC_Coeff:   return s;
+        case SkXfermode::kISC_Coeff:  return Sk4f(1) - s;
+        case SkXfermode::kDC_Coeff:   return d;
+        case SkXfermode::kIDC_Coeff:  return Sk4f(1) - d;
+        case SkXfermode::kSA_Coeff:   return s.alphas();
+        case SkXfermode::kISA_Coeff:  return Sk4f(1) - s.alphas();
+        case SkXfermode::kDA_Coeff:   return d.alphas();
+        case SkXfermode::kIDA_Coeff:  return Sk4f(1) - d.alphas();
+        default:
+            SkDEBUGFAIL("unknown coeff");
+            return Sk4f(0);
+    }
+}
+
+class SkF16_Shader_Blitter : public SkShaderBlitter {
+public:
+    SkF16_Shader_Blitter(const SkPixmap& device, const SkPaint& paint,
+                         SkShader::Context* shaderContext);
+    virtual ~SkF16_Shader_Blitter();
+    void blitH(int x, int y, int width) override;
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override;
+    void blitMask(const SkMask&, const SkIRect&) override;
+
+private:
+    // Shades count pixels starting at x,y and blends them into the device, scaling by aa[]
+    // unless it is NULL.
+    void shadeAndBlend(int x, int y, int count, const SkAlpha aa[]);
+
+    SkXfermode*         fXfermode;
+    SkXfermode::Coeff   fSrcCoeff;
+    SkXfermode::Coeff   fDstCoeff;
+    bool                fHasCoeffs;
+    SkPMColor*          fBuffer;
+    // Modes that can't be expressed with coefficients are blended on SkPMColors in here.
+    SkPMColor*          fDstBuffer;
+    // Holds the coverage of a partially covered run in blitAntiH.
+    SkAlpha*            fAABuffer;
+
+    // illegal
+    SkF16_Shader_Blitter& operator=(const SkF16_Shader_Blitter&);
+
+    typedef SkShaderBlitter INHERITED;
+};
+
+SkF16_Shader_Blitter::SkF16_Shader_Blitter(const SkPixmap& device, const SkPaint& paint,
+                                           SkShader::Context* shaderContext)
+    : INHERITED(device, paint, shaderContext) {
+    fXfermode = SkSafeRef(paint.getXfermode());
+    SkXfermode::Mode mode;
+    fHasCoeffs = NULL == fXfermode || (fXfermode->asMode(&mode) &&
+                                       SkXfermode::ModeAsCoeff(mode, &fSrcCoeff, &fDstCoeff));
+
+    int width = device.width();
+    fBuffer = (SkPMColor*)sk_malloc_throw(width * (2 * sizeof(SkPMColor) + sizeof(SkAlpha)));
+    fDstBuffer = fBuffer + width;
+    fAABuffer = (SkAlpha*)(fDstBuffer + width);
+}
+
+SkF16_Shader_Blitter::~SkF16_Shader_Blitter() {
+    SkSafeUnref(fXfermode);
+    sk_free(fBuffer);
+}
+
+void SkF16_Shader_Blitter::shadeAndBlend(int x, int y, int count, const SkAlpha aa[]) {
+    SkASSERT(x >= 0 && y >= 0 && x + count <= fDevice.width());
+    uint64_t* device = fDevice.writable_addr64(x, y);
+    const SkPMColor* src = fBuffer;
+    fShaderContext->shadeSpan(x, y, fBuffer, count);
+
+    if (!fHasCoeffs) {
+        SkPMColor* dst = fDstBuffer;
+        for (int i = 0; i < count; ++i) {
+            dst[i] = SkPMFloat(SkHalfToPMFloat(device[i])).round();
+        }
+        fXfermode->xfer32(dst, src, count, aa);
+        for (int i = 0; i < count; ++i) {
+            device[i] = SkPMFloatToHalf(SkPMFloat::FromPMColor(dst[i]));
+        }
+        return;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        SkPMFloat s = SkPMFloat::FromPMColor(src[i]);
+        SkPMFloat d = SkHalfToPMFloat(device[i]);
+        SkPMFloat result = fXfermode ? SkPMFloat(s * xfer_coeff(fSrcCoeff, s, d) +
+                                                 d * xfer_coeff(fDstCoeff, s, d))
+                                     : srcover(s, d);
+        if (aa) {
+            result = d + (result - d) * coverage_to_float(aa[i]);
+        }
+        device[i] = SkPMFloatToHalf(result);
+    }
+}
+
+void SkF16_Shader_Blitter::blitH(int x, int y, int width) {
+    this->shadeAndBlend(x, y, width, NULL);
+}
+
+void SkF16_Shader_Blitter::blitAntiH(int x, int y, const SkAlpha antialias[],
+                                     const int16_t runs[]) {
+    for (;;) {
+        int count = runs[0];
+        SkASSERT(count >= 0);
+        if (count <= 0) {
+            return;
+        }
+        unsigned aa = antialias[0];
+        if (255 == aa) {
+            this->shadeAndBlend(x, y, count, NULL);
+        } else if (aa) {
+            memset(fAABuffer, aa, count);
+            this->shadeAndBlend(x, y, count, fAABuffer);
+        }
+        runs += count;
+        antialias += count;
+        x += count;
+    }
+}
+
+void SkF16_Shader_Blitter::blitMask(const SkMask& mask, const SkIRect& clip) {
+    if (SkMask::kA8_Format != mask.fFormat) {
+        this->INHERITED::blitMask(mask, clip);
+        return;
+    }
+    SkASSERT(mask.fBounds.contains(clip));
+
+    const uint8_t* maskRow = mask.getAddr8(clip.fLeft, clip.fTop);
+    for (int y = clip.fTop; y < clip.fBottom; ++y) {
+        this->shadeAndBlend(clip.fLeft, y, clip.width(), maskRow);
+        maskRow += mask.fRowBytes;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkBlitter* SkBlitter_ChooseF16(const SkPixmap& device, const SkPaint& paint,
+                               SkShader::Context* shaderContext,
+                               SkTBlitterAllocator* allocator) {
+    SkASSERT(allocator != NULL);
+
+    // we require a shader if there is an xfermode, handled by our caller
+    SkASSERT(NULL == paint.getXfermode() || paint.getShader());
+
+    if (paint.getShader()) {
+        SkASSERT(shaderContext != NULL);
+        return allocator->createT<SkF16_Shader_Blitter>(device, paint, shaderContext);
+    }
+    if (0 == paint.getAlpha()) {
+        return allocator->createT<SkNullBlitter>();
+    }
+    return allocator->createT<SkF16_Blitter>(device, paint);
+}
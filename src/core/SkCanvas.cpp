@@ -19,6 +19,7 @@
 #include "SkImage.h"
 #include "SkMetaData.h"
 #include "SkNinePatchIter.h"
+#include "SkNx.h"
 #include "SkPaintPriv.h"
 #include "SkPatchUtils.h"
 #include "SkPicture.h"
@@ -748,6 +749,7 @@ SkMetaData& SkCanvas::getMetaData() {
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkCanvas::flush() {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::flush()");
     SkBaseDevice* device = this->getDevice();
     if (device) {
         device->flush();
@@ -1076,6 +1078,7 @@ int SkCanvas::saveLayer(const SkRect* bounds, const SkPaint* paint, SaveFlags fl
 
 void SkCanvas::internalSaveLayer(const SkRect* bounds, const SkPaint* paint, SaveFlags flags,
                                  SaveLayerStrategy strategy) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::saveLayer()");
 #ifndef SK_SUPPORT_LEGACY_CLIPTOLAYERFLAG
     flags |= kClipToLayer_SaveFlag;
 #endif
@@ -1160,6 +1163,7 @@ int SkCanvas::saveLayerAlpha(const SkRect* bounds, U8CPU alpha,
 }
 
 void SkCanvas::internalRestore() {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::restore()");
     SkASSERT(fMCStack.count() != 0);
 
     fDeviceCMDirty = true;
@@ -1306,13 +1310,50 @@ void SkCanvas::internalDrawBitmap(const SkBitmap& bitmap,
         bounds = &paint->computeFastBounds(storage, &storage);
     }
 
-    LOOPER_BEGIN(*paint, SkDrawFilter::kBitmap_Type, bounds)
-
-    while (iter.next()) {
-        iter.fDevice->drawBitmap(iter, bitmap, matrix, looper.paint());
+    // A bitmap that covers the whole surface lets a snapshot's copy-on-write skip the copy.
+    if (bounds && matrix.rectStaysRect()) {
+        this->predrawNotify(bounds, paint, bitmap.isOpaque());
+    } else {
+        this->predrawNotify();
     }
+    AutoDrawLooper looper(this, fProps, *paint, false, bounds);
+    while (looper.next(SkDrawFilter::kBitmap_Type)) {
+        SkDrawIter iter(this);
+        while (iter.next()) {
+            iter.fDevice->drawBitmap(iter, bitmap, matrix, looper.paint());
+        }
+    }
+}
 
-    LOOPER_END
+bool SkCanvas::DrawImageFilterAsShader(const SkDraw& draw, SkBaseDevice* device,
+                                       const SkBitmap& src, const SkIPoint& pos,
+                                       const SkMatrix& filterMatrix, const SkIRect& clipBounds,
+                                       const SkPaint& paint) {
+    SkImageFilter::Proxy proxy(device);
+    SkAutoTUnref<SkImageFilter::Cache> cache(device->getImageFilterCache());
+    SkImageFilter::Context ctx(filterMatrix, clipBounds, cache.get());
+    SkShader* shader;
+    SkRect rect;
+    if (!paint.getImageFilter()->filterImageAsShader(&proxy, src, ctx, &shader, &rect)) {
+        return false;
+    }
+    SkAutoTUnref<SkShader> autoShader(shader);
+
+    // The filter's result space has src's origin at (0,0); the device has it at pos.
+    const SkMatrix toDevice = SkMatrix::MakeTrans(SkIntToScalar(pos.x()), SkIntToScalar(pos.y()));
+    SkPaint shaderPaint(paint);
+    shaderPaint.setImageFilter(NULL);
+    // Sprites are neither antialiased nor filtered; the shaded rect shouldn't be either.
+    shaderPaint.setAntiAlias(false);
+    shaderPaint.setFilterQuality(kNone_SkFilterQuality);
+    shaderPaint.setShader(SkShader::CreateLocalMatrixShader(shader, toDevice))->unref();
+    rect.offset(SkIntToScalar(pos.x()), SkIntToScalar(pos.y()));
+
+    // Like a sprite, the rect is in device space.
+    SkDraw deviceDraw(draw);
+    deviceDraw.fMatrix = &SkMatrix::I();
+    device->drawRect(deviceDraw, rect, shaderPaint);
+    return true;
 }
 
 void SkCanvas::internalDrawDevice(SkBaseDevice* srcDev, int x, int y,
@@ -1336,6 +1377,9 @@ void SkCanvas::internalDrawDevice(SkBaseDevice* srcDev, int x, int y,
             SkMatrix matrix = *iter.fMatrix;
             matrix.postTranslate(SkIntToScalar(-pos.x()), SkIntToScalar(-pos.y()));
             SkIRect clipBounds = SkIRect::MakeWH(srcDev->width(), srcDev->height());
+            if (DrawImageFilterAsShader(iter, dstDev, src, pos, matrix, clipBounds, *paint)) {
+                continue;
+            }
             SkAutoTUnref<SkImageFilter::Cache> cache(dstDev->getImageFilterCache());
             SkImageFilter::Context ctx(matrix, clipBounds, cache.get());
             if (filter->filterImage(&proxy, src, ctx, &dst, &offset)) {
@@ -1387,6 +1431,10 @@ void SkCanvas::onDrawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint*
             SkMatrix matrix = *iter.fMatrix;
             matrix.postTranslate(SkIntToScalar(-pos.x()), SkIntToScalar(-pos.y()));
             const SkIRect clipBounds = bitmap.bounds();
+            if (DrawImageFilterAsShader(iter, iter.fDevice, bitmap, pos, matrix, clipBounds,
+                                        *paint)) {
+                continue;
+            }
             SkAutoTUnref<SkImageFilter::Cache> cache(iter.fDevice->getImageFilterCache());
             SkImageFilter::Context ctx(matrix, clipBounds, cache.get());
             if (filter->filterImage(&proxy, bitmap, ctx, &dst, &offset)) {
@@ -1695,9 +1743,29 @@ bool SkCanvas::quickReject(const SkRect& rect) const {
         return true;
     }
 
-    if (fMCRec->fMatrix.hasPerspective()) {
+    const SkMatrix& matrix = fMCRec->fMatrix;
+    if (matrix.isScaleTranslate() && matrix.getScaleX() > 0 && matrix.getScaleY() > 0) {
+        // Map the rect to device space, where the clip bounds are already known, rather than
+        // inverting the matrix whenever it changes. The rect is outside if its left or top is
+        // past the clip's right or bottom, or its right or bottom is before the clip's left or
+        // top, with the clip outset like getClipBounds() does, in case we are antialiasing.
+        const SkIRect& clip = fMCRec->fRasterClip.getBounds();
+        const SkScalar inf = SK_ScalarInfinity;
+        const Sk4f clipLo(-inf, -inf, SkIntToScalar(clip.fLeft - 1), SkIntToScalar(clip.fTop - 1)),
+                   clipHi(SkIntToScalar(clip.fRight + 1), SkIntToScalar(clip.fBottom + 1), inf, inf);
+        Sk4f dev = Sk4f::Load(&rect.fLeft);
+        if (matrix.getType() & SkMatrix::kScale_Mask) {
+            const SkScalar sx = matrix.getScaleX(),
+                           sy = matrix.getScaleY();
+            dev = dev * Sk4f(sx, sy, sx, sy);
+        }
+        const SkScalar tx = matrix.getTranslateX(),
+                       ty = matrix.getTranslateY();
+        dev = dev + Sk4f(tx, ty, tx, ty);
+        return (dev >= clipHi).anyTrue() || (dev <= clipLo).anyTrue();
+    } else if (matrix.hasPerspective()) {
         SkRect dst;
-        fMCRec->fMatrix.mapRect(&dst, rect);
+        matrix.mapRect(&dst, rect);
         return !SkIRect::Intersects(dst.roundOut(), fMCRec->fRasterClip.getBounds());
     } else {
         const SkRect& clipR = this->getLocalClipBounds();
@@ -2184,7 +2252,8 @@ void SkCanvas::onDrawImage(const SkImage* image, SkScalar x, SkScalar y, const S
         paint = lazy.init();
     }
     
-    LOOPER_BEGIN(*paint, SkDrawFilter::kBitmap_Type, &bounds)
+    LOOPER_BEGIN_CHECK_COMPLETE_OVERWRITE(*paint, SkDrawFilter::kBitmap_Type, &bounds,
+                                          image->isOpaque())
     
     while (iter.next()) {
         iter.fDevice->drawImage(iter, image, x, y, looper.paint());
@@ -2621,6 +2690,7 @@ void SkCanvas::drawDrawable(SkDrawable* dr, const SkMatrix* matrix) {
 }
 
 void SkCanvas::onDrawDrawable(SkDrawable* dr, const SkMatrix* matrix) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkCanvas::drawDrawable()");
     SkRect bounds = dr->getBounds();
     if (matrix) {
         matrix->mapRect(&bounds);
@@ -2634,6 +2704,7 @@ void SkCanvas::onDrawDrawable(SkDrawable* dr, const SkMatrix* matrix) {
 void SkCanvas::onDrawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect tex[],
                            const SkColor colors[], int count, SkXfermode::Mode mode,
                            const SkRect* cull, const SkPaint* paint) {
+    TRACE_EVENT1("disabled-by-default-skia", "SkCanvas::drawAtlas()", "count", count);
     if (cull && this->quickReject(*cull)) {
         return;
     }
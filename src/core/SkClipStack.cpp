@@ -40,6 +40,7 @@ SkClipStack::Element::Element(const Element& that) {
     fFiniteBoundType = that.fFiniteBoundType;
     fFiniteBound = that.fFiniteBound;
     fIsIntersectionOfRects = that.fIsIntersectionOfRects;
+    fRectsIntersection = that.fRectsIntersection;
     fGenID = that.fGenID;
 }
 
@@ -395,10 +396,15 @@ void SkClipStack::Element::updateBoundAndGenID(const Element* prior) {
             fFiniteBoundType = kNormal_BoundsType;
 
             if (SkRegion::kReplace_Op == fOp ||
-                (SkRegion::kIntersect_Op == fOp && NULL == prior) ||
-                (SkRegion::kIntersect_Op == fOp && prior->fIsIntersectionOfRects &&
-                    prior->rectRectIntersectAllowed(this->getRect(), fDoAA))) {
+                (SkRegion::kIntersect_Op == fOp && NULL == prior)) {
                 fIsIntersectionOfRects = true;
+                fRectsIntersection = this->getRect();
+            } else if (SkRegion::kIntersect_Op == fOp && prior->fIsIntersectionOfRects &&
+                       prior->rectRectIntersectAllowed(this->getRect(), fDoAA)) {
+                fIsIntersectionOfRects = true;
+                if (!fRectsIntersection.intersect(prior->fRectsIntersection, this->getRect())) {
+                    fRectsIntersection.setEmpty();
+                }
             }
             break;
         case kRRect_Type:
@@ -617,6 +623,11 @@ void SkClipStack::getBounds(SkRect* canvFiniteBound,
 }
 
 bool SkClipStack::quickContains(const SkRect& rect) const {
+    const Element* top = (const Element*)fDeque.back();
+    if (top && top->fIsIntersectionOfRects) {
+        // the same as checking each of the rects below
+        return top->fRectsIntersection.contains(rect);
+    }
 
     Iter iter(*this, Iter::kTop_IterStart);
     const Element* element = iter.prev();
@@ -670,11 +681,26 @@ bool SkClipStack::asPath(SkPath *path) const {
     return isAA;
 }
 
+// Intersecting with a shape that covers every pixel the clip could let through, with or without
+// aa, changes nothing, so deep save stacks that keep clipping to the same bounds don't grow.
+bool SkClipStack::isRedundant(const Element& prior, const Element& element) const {
+    if (SkRegion::kIntersect_Op != element.getOp() || Element::kEmpty_Type == prior.fType ||
+        element.isInverseFilled() || kNormal_BoundsType != prior.fFiniteBoundType) {
+        return false;
+    }
+    SkRect pixels = SkRect::Make(prior.fFiniteBound.roundOut());
+    return !pixels.isEmpty() && element.contains(pixels);
+}
+
 void SkClipStack::pushElement(const Element& element) {
     // Use reverse iterator instead of back because Rect path may need previous
     SkDeque::Iter iter(fDeque, SkDeque::Iter::kBack_IterStart);
     Element* prior = (Element*) iter.prev();
 
+    if (prior && this->isRedundant(*prior, element)) {
+        return;
+    }
+
     if (prior) {
         if (prior->canBeIntersectedInPlace(fSaveCount, element.getOp())) {
             switch (prior->fType) {
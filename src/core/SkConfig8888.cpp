@@ -11,7 +11,7 @@
 #include "SkColorPriv.h"
 #include "SkDither.h"
 #include "SkMathPriv.h"
-#include "SkUnPreMultiply.h"
+#include "SkOpts.h"
 
 enum AlphaVerb {
     kNothing_AlphaVerb,
@@ -19,36 +19,6 @@ enum AlphaVerb {
     kUnpremul_AlphaVerb,
 };
 
-template <bool doSwapRB, AlphaVerb doAlpha> uint32_t convert32(uint32_t c) {
-    if (doSwapRB) {
-        c = SkSwizzle_RB(c);
-    }
-
-    // Lucky for us, in both RGBA and BGRA, the alpha component is always in the same place, so
-    // we can perform premul or unpremul the same way without knowing the swizzles for RGB.
-    switch (doAlpha) {
-        case kNothing_AlphaVerb:
-            // no change
-            break;
-        case kPremul_AlphaVerb:
-            c = SkPreMultiplyARGB(SkGetPackedA32(c), SkGetPackedR32(c),
-                                  SkGetPackedG32(c), SkGetPackedB32(c));
-            break;
-        case kUnpremul_AlphaVerb:
-            c = SkUnPreMultiply::UnPreMultiplyPreservingByteOrder(c);
-            break;
-    }
-    return c;
-}
-
-template <bool doSwapRB, AlphaVerb doAlpha>
-void convert32_row(uint32_t* dst, const uint32_t* src, int count) {
-    // This has to be correct if src == dst (but not partial overlap)
-    for (int i = 0; i < count; ++i) {
-        dst[i] = convert32<doSwapRB, doAlpha>(src[i]);
-    }
-}
-
 static bool is_32bit_colortype(SkColorType ct) {
     return kRGBA_8888_SkColorType == ct || kBGRA_8888_SkColorType == ct;
 }
@@ -70,10 +40,6 @@ static AlphaVerb compute_AlphaVerb(SkAlphaType src, SkAlphaType dst) {
     }
 }
 
-static void memcpy32_row(uint32_t* dst, const uint32_t* src, int count) {
-    memcpy(dst, src, count * 4);
-}
-
 bool SkSrcPixelInfo::convertPixelsTo(SkDstPixelInfo* dst, int width, int height) const {
     if (width <= 0 || height <= 0) {
         return false;
@@ -83,45 +49,43 @@ bool SkSrcPixelInfo::convertPixelsTo(SkDstPixelInfo* dst, int width, int height)
         return false;
     }
 
-    void (*proc)(uint32_t* dst, const uint32_t* src, int count);
     AlphaVerb doAlpha = compute_AlphaVerb(fAlphaType, dst->fAlphaType);
     bool doSwapRB = fColorType != dst->fColorType;
 
+    uint8_t* dstP = static_cast<uint8_t*>(dst->fPixels);
+    const uint8_t* srcP = static_cast<const uint8_t*>(fPixels);
+
+    if (kNothing_AlphaVerb == doAlpha && !doSwapRB) {
+        if (fPixels != dst->fPixels) {
+            for (int y = 0; y < height; ++y) {
+                memcpy(dstP, srcP, width * 4);
+                dstP += dst->fRowBytes;
+                srcP += fRowBytes;
+            }
+        }
+        return true;
+    }
+
+    // Lucky for us, in both RGBA and BGRA, the alpha component is always in the same place, so
+    // we can perform premul or unpremul the same way without knowing the swizzles for RGB.
+    // These procs also work in place, which we need when src == dst (but not partial overlap).
+    SkOpts::Swizzle_8888 proc = nullptr;
     switch (doAlpha) {
         case kNothing_AlphaVerb:
-            if (doSwapRB) {
-                proc = convert32_row<true, kNothing_AlphaVerb>;
-            } else {
-                if (fPixels == dst->fPixels) {
-                    return true;
-                }
-                proc = memcpy32_row;
-            }
+            proc = SkOpts::RGBA_to_BGRA;
             break;
         case kPremul_AlphaVerb:
-            if (doSwapRB) {
-                proc = convert32_row<true, kPremul_AlphaVerb>;
-            } else {
-                proc = convert32_row<false, kPremul_AlphaVerb>;
-            }
+            proc = doSwapRB ? SkOpts::RGBA_to_bgrA : SkOpts::RGBA_to_rgbA;
             break;
         case kUnpremul_AlphaVerb:
-            if (doSwapRB) {
-                proc = convert32_row<true, kUnpremul_AlphaVerb>;
-            } else {
-                proc = convert32_row<false, kUnpremul_AlphaVerb>;
-            }
+            proc = doSwapRB ? SkOpts::rgbA_to_BGRA : SkOpts::rgbA_to_RGBA;
             break;
     }
 
-    uint32_t* dstP = static_cast<uint32_t*>(dst->fPixels);
-    const uint32_t* srcP = static_cast<const uint32_t*>(fPixels);
-    size_t srcInc = fRowBytes >> 2;
-    size_t dstInc = dst->fRowBytes >> 2;
     for (int y = 0; y < height; ++y) {
-        proc(dstP, srcP, width);
-        dstP += dstInc;
-        srcP += srcInc;
+        proc(reinterpret_cast<uint32_t*>(dstP), srcP, width);
+        dstP += dst->fRowBytes;
+        srcP += fRowBytes;
     }
     return true;
 }
@@ -204,6 +168,7 @@ bool SkPixelInfo::CopyPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t
                 break;
             case kIndex_8_SkColorType:
             case kARGB_4444_SkColorType:
+            case kRGBA_F16_SkColorType:
                 if (srcInfo.alphaType() != dstInfo.alphaType()) {
                     return false;
                 }
@@ -4,6 +4,7 @@
 
 #include "SkConvolver.h"
 #include "SkSize.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 
 namespace {
@@ -321,10 +322,6 @@ void SkConvolutionFilter1D::AddFilter(int filterOffset,
         filterOffset += firstNonZero;
         filterLength = lastNonZero + 1 - firstNonZero;
         SkASSERT(filterLength > 0);
-
-        for (int i = firstNonZero; i <= lastNonZero; i++) {
-            fFilterValues.push_back(filterValues[i]);
-        }
     } else {
         // Here all the factors were zeroes.
         filterLength = 0;
@@ -332,9 +329,29 @@ void SkConvolutionFilter1D::AddFilter(int filterOffset,
 
     FilterInstance instance;
 
-    // We pushed filterLength elements onto fFilterValues
-    instance.fDataLocation = (static_cast<int>(fFilterValues.count()) -
-                                               filterLength);
+    // Resampling filters are periodic away from the edges: scaling by p/q repeats every p
+    // output pixels, and every pixel for integral downscales. Share the factors with a
+    // recent filter when they match, which keeps the convolution's working set small.
+    int dataLocation = -1;
+    const int oldest = SkTMax(0, fFilters.count() - kMaxFilterPeriod);
+    for (int i = fFilters.count() - 1; filterLength > 0 && i >= oldest; --i) {
+        const FilterInstance& other = fFilters[i];
+        if (other.fTrimmedLength == filterLength &&
+            !memcmp(&fFilterValues[other.fDataLocation], &filterValues[firstNonZero],
+                    filterLength * sizeof(ConvolutionFixed))) {
+            dataLocation = other.fDataLocation;
+            break;
+        }
+    }
+    if (dataLocation < 0) {
+        for (int i = 0; i < filterLength; i++) {
+            fFilterValues.push_back(filterValues[firstNonZero + i]);
+        }
+        // We pushed filterLength elements onto fFilterValues
+        dataLocation = static_cast<int>(fFilterValues.count()) - filterLength;
+    }
+
+    instance.fDataLocation = dataLocation;
     instance.fOffset = filterOffset;
     instance.fTrimmedLength = filterLength;
     instance.fLength = filterSize;
@@ -358,15 +375,32 @@ const SkConvolutionFilter1D::ConvolutionFixed* SkConvolutionFilter1D::GetSingleF
     return &fFilterValues[filter.fDataLocation];
 }
 
-void BGRAConvolve2D(const unsigned char* sourceData,
-                    int sourceByteRowStride,
-                    bool sourceHasAlpha,
-                    const SkConvolutionFilter1D& filterX,
-                    const SkConvolutionFilter1D& filterY,
-                    int outputByteRowStride,
-                    unsigned char* output,
-                    const SkConvolutionProcs& convolveProcs,
-                    bool useSimdIfPossible) {
+namespace {
+
+// Everything convolve_rows() needs besides the range of output rows it produces.
+struct ConvolveArgs {
+    const unsigned char*         fSourceData;
+    int                          fSourceByteRowStride;
+    bool                         fSourceHasAlpha;
+    const SkConvolutionFilter1D* fFilterX;
+    const SkConvolutionFilter1D* fFilterY;
+    int                          fOutputByteRowStride;
+    unsigned char*               fOutput;
+    const SkConvolutionProcs*    fProcs;
+};
+
+// Produces output rows [firstOutY, endOutY). Each call keeps its own
+// circular buffer of horizontally convolved rows, so calls for disjoint
+// ranges can run at the same time; each one repeats the horizontal pass
+// for the source rows its first vertical filter overlaps with the range
+// above it.
+void convolve_rows(const ConvolveArgs& args, int firstOutY, int endOutY) {
+    const unsigned char* sourceData = args.fSourceData;
+    const int sourceByteRowStride = args.fSourceByteRowStride;
+    const bool sourceHasAlpha = args.fSourceHasAlpha;
+    const SkConvolutionFilter1D& filterX = *args.fFilterX;
+    const SkConvolutionFilter1D& filterY = *args.fFilterY;
+    const SkConvolutionProcs& convolveProcs = *args.fProcs;
 
     int maxYFilterSize = filterY.maxFilter();
 
@@ -375,9 +409,16 @@ void BGRAConvolve2D(const unsigned char* sourceData,
     // image (this is the case when we are only resizing a subset), then we
     // don't want to generate any output rows before that. Compute the starting
     // row for convolution as the first pixel for the first vertical filter.
+    // Trimming zero factors can leave a later filter starting a little
+    // earlier, which matters when this range starts mid-image.
     int filterOffset, filterLength;
     const SkConvolutionFilter1D::ConvolutionFixed* filterValues =
-        filterY.FilterForValue(0, &filterOffset, &filterLength);
+        filterY.FilterForValue(firstOutY, &filterOffset, &filterLength);
+    for (int outY = firstOutY + 1; outY < endOutY; outY++) {
+        int offset, length;
+        filterY.FilterForValue(outY, &offset, &length);
+        filterOffset = SkTMin(filterOffset, offset);
+    }
     int nextXRow = filterOffset;
 
     // We loop over each row in the input doing a horizontal convolution. This
@@ -399,7 +440,6 @@ void BGRAConvolve2D(const unsigned char* sourceData,
 
     // Loop over every possible output row, processing just enough horizontal
     // convolutions to run each subsequent vertical convolution.
-    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
     int numOutputRows = filterY.numValues();
 
     // We need to check which is the last line to convolve before we advance 4
@@ -421,7 +461,7 @@ void BGRAConvolve2D(const unsigned char* sourceData,
     filterY.FilterForValue(numOutputRows - 1, &lastFilterOffset,
                            &lastFilterLength);
 
-    for (int outY = 0; outY < numOutputRows; outY++) {
+    for (int outY = firstOutY; outY < endOutY; outY++) {
         filterValues = filterY.FilterForValue(outY,
                                               &filterOffset, &filterLength);
 
@@ -462,7 +502,8 @@ void BGRAConvolve2D(const unsigned char* sourceData,
         }
 
         // Compute where in the output image this row of final data will go.
-        unsigned char* curOutputRow = &output[(uint64_t)outY * outputByteRowStride];
+        unsigned char* curOutputRow =
+            &args.fOutput[(uint64_t)outY * args.fOutputByteRowStride];
 
         // Get the list of rows that the circular buffer has, in order.
         int firstRowInCircularBuffer;
@@ -487,3 +528,40 @@ void BGRAConvolve2D(const unsigned char* sourceData,
         }
     }
 }
+
+}  // namespace
+
+// Below this many output rows per band, redoing the horizontal pass for the
+// rows shared with the band above costs more than threading saves.
+static const int kMinRowsPerBand = 64;
+static const int kMaxBands = 16;
+
+void BGRAConvolve2D(const unsigned char* sourceData,
+                    int sourceByteRowStride,
+                    bool sourceHasAlpha,
+                    const SkConvolutionFilter1D& filterX,
+                    const SkConvolutionFilter1D& filterY,
+                    int outputByteRowStride,
+                    unsigned char* output,
+                    const SkConvolutionProcs& convolveProcs,
+                    bool useSimdIfPossible) {
+    SkASSERT(outputByteRowStride >= filterX.numValues() * 4);
+
+    const ConvolveArgs args = {
+        sourceData, sourceByteRowStride, sourceHasAlpha, &filterX, &filterY,
+        outputByteRowStride, output, &convolveProcs
+    };
+    const int numOutputRows = filterY.numValues();
+    const int bandCount = SkTPin(numOutputRows / kMinRowsPerBand, 1, kMaxBands);
+    if (1 == bandCount) {
+        convolve_rows(args, 0, numOutputRows);
+        return;
+    }
+
+    // Every output row is computed exactly as in a single pass, so the
+    // result doesn't depend on the number of bands.
+    sk_parallel_for(bandCount, [&](int i) {
+        convolve_rows(args, numOutputRows * i / bandCount,
+                      numOutputRows * (i + 1) / bandCount);
+    });
+}
@@ -134,6 +134,9 @@ private:
     // Stores the information for each filter added to this class.
     SkTArray<FilterInstance> fFilters;
 
+    // How many of the most recent filters AddFilter() searches for identical factors.
+    static const int kMaxFilterPeriod = 16;
+
     // We store all the filter values in this flat list, indexed by
     // |FilterInstance.data_location| to avoid the mallocs required for storing
     // each one separately.
@@ -172,10 +172,24 @@ public:
     void blitMask(const SkMask&, const SkIRect&) override;
 
 private:
+    void shade(int x, int y, SkPMColor span[], int count) {
+        if (fShadeProc) {
+            fShadeProc(fShadeProcContext, x, y, span, count);
+        } else {
+            fShaderContext->shadeSpan(x, y, span, count);
+        }
+    }
+
+    // Shades and blends a span with proc in chunks small enough to stay in L1.
+    void shadeAndBlend(int x, int y, uint32_t device[], int count, SkBlitRow::Proc32 proc,
+                       U8CPU alpha);
+
     SkXfermode*         fXfermode;
     SkPMColor*          fBuffer;
     SkBlitRow::Proc32   fProc32;
     SkBlitRow::Proc32   fProc32Blend;
+    SkShader::Context::ShadeProc fShadeProc;
+    void*               fShadeProcContext;
     bool                fShadeDirectlyIntoDevice;
     bool                fConstInY;
 
@@ -204,4 +218,8 @@ SkBlitter* SkBlitter_ChooseD565(const SkPixmap& device, const SkPaint& paint,
                                 SkShader::Context* shaderContext,
                                 SkTBlitterAllocator* allocator);
 
+SkBlitter* SkBlitter_ChooseF16(const SkPixmap& device, const SkPaint& paint,
+                               SkShader::Context* shaderContext,
+                               SkTBlitterAllocator* allocator);
+
 #endif
@@ -125,3 +125,33 @@ bool SkDeviceLooper::next() {
     fState = kDone_State;
     return false;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Below this many pixels the cost of handing bands to other threads, and of choosing a blitter
+// for each band, outweighs what drawing them concurrently can win.
+static const int64_t kMinParallelArea = 512 * 512;
+// Bands shorter than this don't amortize their blitter setup.
+static const int kMinBandHeight = 32;
+
+int SkDeviceLooper::CountBands(const SkRasterClip& rc, const SkIRect& bounds,
+                               SkIRect* clippedBounds) {
+    if (rc.isEmpty() || !clippedBounds->intersect(bounds, rc.getBounds())) {
+        return 1;
+    }
+    const int cores = sk_num_cores();
+    if (cores <= 1 ||
+        sk_64_mul(clippedBounds->width(), clippedBounds->height()) < kMinParallelArea) {
+        return 1;
+    }
+    // A few bands per core lets idle threads pick up the slack when bands cost unequal amounts.
+    return SkTMax(1, SkTMin(clippedBounds->height() / kMinBandHeight, 4 * cores));
+}
+
+SkIRect SkDeviceLooper::BandBounds(const SkIRect& bounds, int index, int count) {
+    SkASSERT(index >= 0 && index < count);
+    const int64_t height = bounds.height();
+    const int top = bounds.top() + (int)(height * index / count);
+    const int bottom = bounds.top() + (int)(height * (index + 1) / count);
+    return SkIRect::MakeLTRB(bounds.left(), top, bounds.right(), bottom);
+}
@@ -11,6 +11,7 @@
 #include "SkBitmap.h"
 #include "SkMatrix.h"
 #include "SkRasterClip.h"
+#include "SkTaskGroup.h"
 
 /**
  *  Helper class to manage "tiling" a large coordinate space into managable
@@ -59,6 +60,38 @@ public:
      */
     bool next();
 
+    /**
+     *  Fill-rate bound draws over large areas can be rasterized on several threads. This splits
+     *  the part of bounds inside rc into horizontal bands and calls proc(bandRC) for each band on
+     *  SkTaskGroup, where bandRC is rc restricted to that band. proc must choose its own blitter
+     *  (and make its own looper) for each call, and only touch pixels inside the clip it is
+     *  given. Small draws, and single core machines, call proc(rc) once on the calling thread.
+     *
+     *  Bands only run concurrently if an SkTaskGroup::Enabler is alive; otherwise they are drawn
+     *  one after another.
+     */
+    template <typename Proc>
+    static void ForEachBand(const SkRasterClip& rc, const SkIRect& bounds, const Proc& proc) {
+        SkIRect clippedBounds;
+        const int bands = CountBands(rc, bounds, &clippedBounds);
+        if (bands <= 1) {
+            proc(rc);
+            return;
+        }
+        sk_parallel_for(bands, [&](int i) {
+            SkRasterClip bandRC(rc);
+            if (bandRC.op(BandBounds(clippedBounds, i, bands), SkRegion::kIntersect_Op)) {
+                proc(bandRC);
+            }
+        });
+    }
+
+    // Returns how many bands ForEachBand() splits bounds into, and the part of bounds in rc.
+    static int CountBands(const SkRasterClip& rc, const SkIRect& bounds, SkIRect* clippedBounds);
+
+    // Returns the index'th of count bands of rows of bounds.
+    static SkIRect BandBounds(const SkIRect& bounds, int index, int count);
+
 private:
     const SkPixmap&     fBaseDst;
     const SkRasterClip& fBaseRC;
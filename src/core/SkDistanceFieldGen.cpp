@@ -6,49 +6,35 @@
  */
 
 #include "SkDistanceFieldGen.h"
+#include "SkNx.h"
 #include "SkPoint.h"
+#include "SkTemplates.h"
 
+// The distance data is kept in planes, one value per texel in each, so that a row of texels can be
+// checked against the row above or below it four at a time.
 struct DFData {
-    float   fAlpha;      // alpha value of source texel
-    float   fDistSq;     // distance squared to nearest (so far) edge texel
-    SkPoint fDistVector; // distance vector to nearest (so far) edge texel
+    float* fAlpha;   // alpha value of source texel
+    float* fDistSq;  // distance squared to nearest (so far) edge texel
+    float* fDistX;   // distance vector to nearest (so far) edge texel
+    float* fDistY;
 };
 
-enum NeighborFlags {
-    kLeft_NeighborFlag        = 0x01,
-    kRight_NeighborFlag       = 0x02,
-    kTopLeft_NeighborFlag     = 0x04,
-    kTop_NeighborFlag         = 0x08,
-    kTopRight_NeighborFlag    = 0x10,
-    kBottomLeft_NeighborFlag  = 0x20,
-    kBottom_NeighborFlag      = 0x40,
-    kBottomRight_NeighborFlag = 0x80,
-    kAll_NeighborFlags        = 0xff,
-
-    kNeighborFlagCount        = 8
-};
+// we expand our temp data by one more on each side than the distance field to simplify
+// the scanning code -- will always be treated as infinitely far away
+static const int kDataPad = SK_DistanceFieldPad + 1;
 
 // We treat an "edge" as a place where we cross from >=128 to <128, or vice versa, or
 // where we have two non-zero pixels that are <128.
-// 'neighborFlags' is used to limit the directions in which we test to avoid indexing
-// outside of the image
-static bool found_edge(const unsigned char* imagePtr, int width, int neighborFlags) {
-    // the order of these should match the neighbor flags above
+static bool found_edge(const unsigned char* imagePtr, int width) {
     const int kNum8ConnectedNeighbors = 8;
     const int offsets[8] = {-1, 1, -width-1, -width, -width+1, width-1, width, width+1 };
-    SkASSERT(kNum8ConnectedNeighbors == kNeighborFlagCount);
 
     // search for an edge
     unsigned char currVal = *imagePtr;
     unsigned char currCheck = (currVal >> 7);
     for (int i = 0; i < kNum8ConnectedNeighbors; ++i) {
-        unsigned char neighborVal;
-        if ((1 << i) & neighborFlags) {
-            const unsigned char* checkPtr = imagePtr + offsets[i];
-            neighborVal = *checkPtr;
-        } else {
-            neighborVal = 0;
-        }
+        const unsigned char* checkPtr = imagePtr + offsets[i];
+        unsigned char neighborVal = *checkPtr;
         unsigned char neighborCheck = (neighborVal >> 7);
         SkASSERT(currCheck == 0 || currCheck == 1);
         SkASSERT(neighborCheck == 0 || neighborCheck == 1);
@@ -63,43 +49,53 @@ static bool found_edge(const unsigned char* imagePtr, int width, int neighborFla
     return false;
 }
 
-static void init_glyph_data(DFData* data, unsigned char* edges, const unsigned char* image,
-                            int dataWidth, int dataHeight,
-                            int imageWidth, int imageHeight,
-                            int pad) {
-    data += pad*dataWidth;
-    data += pad;
-    edges += (pad*dataWidth + pad);
-
-    for (int j = 0; j < imageHeight; ++j) {
-        for (int i = 0; i < imageWidth; ++i) {
-            if (255 == *image) {
-                data->fAlpha = 1.0f;
-            } else {
-                data->fAlpha = (*image)*0.00392156862f;  // 1/255
-            }
-            int checkMask = kAll_NeighborFlags;
-            if (i == 0) {
-                checkMask &= ~(kLeft_NeighborFlag|kTopLeft_NeighborFlag|kBottomLeft_NeighborFlag);
-            }
-            if (i == imageWidth-1) {
-                checkMask &= ~(kRight_NeighborFlag|kTopRight_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (j == 0) {
-                checkMask &= ~(kTopLeft_NeighborFlag|kTop_NeighborFlag|kTopRight_NeighborFlag);
-            }
-            if (j == imageHeight-1) {
-                checkMask &= ~(kBottomLeft_NeighborFlag|kBottom_NeighborFlag|kBottomRight_NeighborFlag);
-            }
-            if (found_edge(image, imageWidth, checkMask)) {
-                *edges = 255;  // using 255 makes for convenient debug rendering
+// The same test as found_edge(), for 16 pixels at once. Returns non-zero for those on an edge.
+static Sk16b found_edges(const unsigned char* imagePtr, int width) {
+    const int offsets[8] = {-1, 1, -width-1, -width, -width+1, width-1, width, width+1 };
+    const Sk16b zero(0), below(128), above(127);
+
+    const Sk16b currVal = Sk16b::Load(imagePtr);
+    const Sk16b currHigh = above < currVal;
+    Sk16b edges = zero;
+    for (int i = 0; i < 8; ++i) {
+        const Sk16b neighborVal = Sk16b::Load(imagePtr + offsets[i]);
+        // It's an edge if the lower of the two is <128, and either it's >0 or the other is >=128.
+        // (The masks are 0 or ~0, so Min() is an and and saturatedAdd() an or.)
+        const Sk16b minVal = Sk16b::Min(currVal, neighborVal);
+        const Sk16b eitherHigh = currHigh.saturatedAdd(above < neighborVal);
+        edges = edges.saturatedAdd(Sk16b::Min(minVal < below,
+                                              (zero < minVal).saturatedAdd(eitherHigh)));
+    }
+    return edges;
+}
+
+// The image is as big as the data, with the glyph's pixels kDataPad in from each side and zero
+// all around them.
+static void init_glyph_data(float* alpha, unsigned char* edges, const unsigned char* image,
+                            int dataWidth, int dataHeight) {
+    for (int k = 0; k < dataWidth*dataHeight; ++k) {
+        if (255 == image[k]) {
+            alpha[k] = 1.0f;
+        } else {
+            alpha[k] = image[k]*0.00392156862f;  // 1/255
+        }
+    }
+
+    // The outermost texels are too far out to be on an edge, so every neighbor we read is in the
+    // image. The texels around the glyph's pixels, being zero beside zero, are only on an edge
+    // if they are next to one of its pixels.
+    for (int j = 1; j < dataHeight-1; ++j) {
+        int k = j*dataWidth + 1;
+        const int rowEnd = (j+1)*dataWidth - 1;
+        for (; k + 16 <= rowEnd; k += 16) {
+            // using 255 makes for convenient debug rendering
+            found_edges(image + k, dataWidth).store(edges + k);
+        }
+        for (; k < rowEnd; ++k) {
+            if (found_edge(image + k, dataWidth)) {
+                edges[k] = 255;
             }
-            ++data;
-            ++image;
-            ++edges;
         }
-        data += 2*pad;
-        edges += 2*pad;
     }
 }
 
@@ -145,14 +141,11 @@ static float edge_distance(const SkPoint& direction, float alpha) {
     return distance;
 }
 
-static void init_distances(DFData* data, unsigned char* edges, int width, int height) {
-    // skip one pixel border
-    DFData* currData = data;
-    DFData* prevData = data - width;
-    DFData* nextData = data + width;
-
+static void init_distances(const DFData& data, unsigned char* edges, int width, int height) {
+    const float* alpha = data.fAlpha;
     for (int j = 0; j < height; ++j) {
         for (int i = 0; i < width; ++i) {
+            const int k = j*width + i;
             if (*edges) {
                 // we should not be in the one-pixel outside band
                 SkASSERT(i > 0 && i < width-1 && j > 0 && j < height-1);
@@ -160,155 +153,206 @@ static void init_distances(DFData* data, unsigned char* edges, int width, int he
                 // +y is down in this case
                 // i.e., if you're outside, gradient points towards edge
                 // if you're inside, gradient points away from edge
+                const int prev = k - width;
+                const int next = k + width;
                 SkPoint currGrad;
-                currGrad.fX = (prevData+1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*(currData+1)->fAlpha
-                             - SK_ScalarSqrt2*(currData-1)->fAlpha
-                             + (nextData+1)->fAlpha - (nextData-1)->fAlpha;
-                currGrad.fY = (nextData-1)->fAlpha - (prevData-1)->fAlpha
-                             + SK_ScalarSqrt2*nextData->fAlpha
-                             - SK_ScalarSqrt2*prevData->fAlpha
-                             + (nextData+1)->fAlpha - (prevData+1)->fAlpha;
+                currGrad.fX = alpha[prev+1] - alpha[prev-1]
+                             + SK_ScalarSqrt2*alpha[k+1]
+                             - SK_ScalarSqrt2*alpha[k-1]
+                             + alpha[next+1] - alpha[next-1];
+                currGrad.fY = alpha[next-1] - alpha[prev-1]
+                             + SK_ScalarSqrt2*alpha[next]
+                             - SK_ScalarSqrt2*alpha[prev]
+                             + alpha[next+1] - alpha[prev+1];
                 currGrad.setLengthFast(1.0f);
 
                 // init squared distance to edge and distance vector
-                float dist = edge_distance(currGrad, currData->fAlpha);
-                currGrad.scale(dist, &currData->fDistVector);
-                currData->fDistSq = dist*dist;
+                float dist = edge_distance(currGrad, alpha[k]);
+                data.fDistX[k] = currGrad.fX*dist;
+                data.fDistY[k] = currGrad.fY*dist;
+                data.fDistSq[k] = dist*dist;
             } else {
                 // init distance to "far away"
-                currData->fDistSq = 2000000.f;
-                currData->fDistVector.fX = 1000.f;
-                currData->fDistVector.fY = 1000.f;
+                data.fDistSq[k] = 2000000.f;
+                data.fDistX[k] = 1000.f;
+                data.fDistY[k] = 1000.f;
             }
-            ++currData;
-            ++prevData;
-            ++nextData;
             ++edges;
         }
     }
 }
 
 // Danielsson's 8SSEDT
+//
+// Each texel takes the distance through whichever of its neighbors is nearest an edge. The checks
+// against the row above (on the way down) or below (on the way up) don't depend on the other
+// texels of the row, so they are done four texels at a time; those against the left and right
+// neighbors have to sweep along the row. The same code handles both float and Sk4f texels.
+
+static inline void load(const float* src, float* dst) { *dst = *src; }
+static inline void load(const float* src, Sk4f* dst) { *dst = Sk4f::Load(src); }
+static inline void store(float src, float* dst) { *dst = src; }
+static inline void store(const Sk4f& src, float* dst) { src.store(dst); }
+static inline float pick(bool cond, float t, float e) { return cond ? t : e; }
+static inline Sk4f pick(const Sk4f& cond, const Sk4f& t, const Sk4f& e) {
+    return cond.thenElse(t, e);
+}
+
+// Takes the distance through a neighbor if it is strictly nearer, so on a tie whichever neighbor
+// was checked first wins.
+template <typename T>
+static void check_neighbor(const T& distSq, const T& distX, const T& distY,
+                           T* currSq, T* currX, T* currY) {
+    const auto nearer = distSq < *currSq;
+    *currSq = pick(nearer, distSq, *currSq);
+    *currX = pick(nearer, distX, *currX);
+    *currY = pick(nearer, distY, *currY);
+}
+
+template <typename T>
+static void load_neighbor(const DFData& data, int k, T* distSq, T* distX, T* distY) {
+    load(data.fDistSq + k, distSq);
+    load(data.fDistX + k, distX);
+    load(data.fDistY + k, distY);
+}
+
+// forward pass, upper left, up and upper right
+template <typename T>
+static void check_upper(const DFData& data, int k, int width, T* currSq, T* currX, T* currY) {
+    const T one(1.0f), two(2.0f);
+    T distSq, distX, distY;
 
-// first stage forward pass
-// (forward in Y, forward in X)
-static void F1(DFData* curr, int width) {
     // upper left
-    DFData* check = curr - width-1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*(distVec.fX + distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+    load_neighbor(data, k - width-1, &distSq, &distX, &distY);
+    check_neighbor(distSq - two*(distX + distY - one), distX - one, distY - one,
+                   currSq, currX, currY);
 
     // up
-    check = curr - width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+    load_neighbor(data, k - width, &distSq, &distX, &distY);
+    check_neighbor(distSq - two*distY + one, distX, distY - one, currSq, currX, currY);
 
     // upper right
-    check = curr - width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX - distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-
-    // left
-    check = curr - 1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+    load_neighbor(data, k - width+1, &distSq, &distX, &distY);
+    check_neighbor(distSq + two*(distX - distY + one), distX + one, distY - one,
+                   currSq, currX, currY);
 }
 
-// second stage forward pass
-// (forward in Y, backward in X)
-static void F2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    float distSq = check->fDistSq;
-    SkPoint distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
-}
+// backward pass, bottom left, bottom and bottom right
+template <typename T>
+static void check_lower(const DFData& data, int k, int width, T* currSq, T* currX, T* currY) {
+    const T one(1.0f), two(2.0f);
+    T distSq, distX, distY;
 
-// first stage backward pass
-// (backward in Y, forward in X)
-static void B1(DFData* curr, int width) {
-    // left
-    DFData* check = curr - 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq - 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
-    }
+    // bottom left
+    load_neighbor(data, k + width-1, &distSq, &distX, &distY);
+    check_neighbor(distSq - two*(distX - distY - one), distX - one, distY + one,
+                   currSq, currX, currY);
+
+    // bottom
+    load_neighbor(data, k + width, &distSq, &distX, &distY);
+    check_neighbor(distSq + two*distY + one, distX, distY + one, currSq, currX, currY);
+
+    // bottom right
+    load_neighbor(data, k + width+1, &distSq, &distX, &distY);
+    check_neighbor(distSq + two*(distX + distY + one), distX + one, distY + one,
+                   currSq, currX, currY);
 }
 
-// second stage backward pass
-// (backward in Y, backwards in X)
-static void B2(DFData* curr, int width) {
-    // right
-    DFData* check = curr + 1;
-    SkPoint distVec = check->fDistVector;
-    float distSq = check->fDistSq + 2.0f*distVec.fX + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+// Checks count texels, starting at k, against their neighbors in the row above or below.
+// Edge texels keep their distances.
+template <bool kUpper>
+static void check_row(const DFData& data, const unsigned char* edges, int k, int count,
+                      int width) {
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        Sk4f origSq, origX, origY;
+        load_neighbor(data, k + i, &origSq, &origX, &origY);
+        Sk4f currSq = origSq, currX = origX, currY = origY;
+        if (kUpper) {
+            check_upper(data, k + i, width, &currSq, &currX, &currY);
+        } else {
+            check_lower(data, k + i, width, &currSq, &currX, &currY);
+        }
+        const unsigned char* e = edges + k + i;
+        const Sk4f notEdge = Sk4f(e[0], e[1], e[2], e[3]) == Sk4f(0.0f);
+        store(pick(notEdge, currSq, origSq), data.fDistSq + k + i);
+        store(pick(notEdge, currX, origX), data.fDistX + k + i);
+        store(pick(notEdge, currY, origY), data.fDistY + k + i);
     }
-
-    // bottom left
-    check = curr + width-1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq - 2.0f*(distVec.fX - distVec.fY - 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX -= 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+    for (; i < count; ++i) {
+        if (!edges[k + i]) {
+            float currSq, currX, currY;
+            load_neighbor(data, k + i, &currSq, &currX, &currY);
+            if (kUpper) {
+                check_upper(data, k + i, width, &currSq, &currX, &currY);
+            } else {
+                check_lower(data, k + i, width, &currSq, &currX, &currY);
+            }
+            store(currSq, data.fDistSq + k + i);
+            store(currX, data.fDistX + k + i);
+            store(currY, data.fDistY + k + i);
+        }
     }
+}
 
-    // bottom
-    check = curr + width;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*distVec.fY + 1.0f;
-    if (distSq < curr->fDistSq) {
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+// Sweeps forward along count texels, starting at k, checking each against its left neighbor.
+// The neighbor's distance is carried along in registers rather than read back.
+static void check_left(const DFData& data, const unsigned char* edges, int k, int count) {
+    float prevSq = data.fDistSq[k-1];
+    float prevX = data.fDistX[k-1];
+    float prevY = data.fDistY[k-1];
+    for (int i = k; i < k + count; ++i) {
+        float currSq = data.fDistSq[i];
+        float currX = data.fDistX[i];
+        float currY = data.fDistY[i];
+        // don't need to calculate distance for edge pixels
+        if (!edges[i]) {
+            const float distSq = prevSq - 2.0f*prevX + 1.0f;
+            if (distSq < currSq) {
+                currSq = distSq;
+                currX = prevX - 1.0f;
+                currY = prevY;
+                data.fDistSq[i] = currSq;
+                data.fDistX[i] = currX;
+                data.fDistY[i] = currY;
+            }
+        }
+        prevSq = currSq;
+        prevX = currX;
+        prevY = currY;
     }
+}
 
-    // bottom right
-    check = curr + width+1;
-    distVec = check->fDistVector;
-    distSq = check->fDistSq + 2.0f*(distVec.fX + distVec.fY + 1.0f);
-    if (distSq < curr->fDistSq) {
-        distVec.fX += 1.0f;
-        distVec.fY += 1.0f;
-        curr->fDistSq = distSq;
-        curr->fDistVector = distVec;
+// Sweeps backward along count texels, starting at k, checking each against its right neighbor.
+// If the right neighbor should have been checked before some others, whose check has already
+// been done, those texels' distance squared from before the others were checked is in origSq and
+// the right neighbor also wins any tie with them.
+static void check_right(const DFData& data, const unsigned char* edges, int k, int count,
+                        const float* origSq) {
+    float nextSq = data.fDistSq[k+count];
+    float nextX = data.fDistX[k+count];
+    float nextY = data.fDistY[k+count];
+    for (int i = count-1; i >= 0; --i) {
+        const int curr = k + i;
+        float currSq = data.fDistSq[curr];
+        float currX = data.fDistX[curr];
+        float currY = data.fDistY[curr];
+        // don't need to calculate distance for edge pixels
+        if (!edges[curr]) {
+            const float distSq = nextSq + 2.0f*nextX + 1.0f;
+            // a texel's distance only ever changes if it gets strictly nearer
+            if (distSq < currSq || (origSq && distSq == currSq && currSq != origSq[i])) {
+                currSq = distSq;
+                currX = nextX + 1.0f;
+                currY = nextY;
+                data.fDistSq[curr] = currSq;
+                data.fDistX[curr] = currX;
+                data.fDistY[curr] = currY;
+            }
+        }
+        nextSq = currSq;
+        nextX = currX;
+        nextY = currY;
     }
 }
 
@@ -327,7 +371,7 @@ static unsigned char pack_distance_field_val(float dist, float distanceMagnitude
 }
 #endif
 
-// assumes a padded 8-bit image and distance field
+// assumes an 8-bit image padded by kDataPad, and a padded distance field
 // width and height are the original width and height of the image
 static bool generate_distance_field_from_image(unsigned char* distanceField,
                                                const unsigned char* copyPtr,
@@ -335,104 +379,64 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
     SkASSERT(distanceField);
     SkASSERT(copyPtr);
 
-    // we expand our temp data by one more on each side to simplify
-    // the scanning code -- will always be treated as infinitely far away
-    int pad = SK_DistanceFieldPad + 1;
-
     // set params for distance field data
-    int dataWidth = width + 2*pad;
-    int dataHeight = height + 2*pad;
+    int dataWidth = width + 2*kDataPad;
+    int dataHeight = height + 2*kDataPad;
 
     // create temp data
-    size_t dataSize = dataWidth*dataHeight*sizeof(DFData);
+    const int texelCount = dataWidth*dataHeight;
+    size_t dataSize = 4*texelCount*sizeof(float);
     SkAutoSMalloc<1024> dfStorage(dataSize);
-    DFData* dataPtr = (DFData*) dfStorage.get();
-    sk_bzero(dataPtr, dataSize);
+    sk_bzero(dfStorage.get(), dataSize);
+    DFData data;
+    data.fAlpha = (float*) dfStorage.get();
+    data.fDistSq = data.fAlpha + texelCount;
+    data.fDistX = data.fDistSq + texelCount;
+    data.fDistY = data.fDistX + texelCount;
 
     SkAutoSMalloc<1024> edgeStorage(dataWidth*dataHeight*sizeof(char));
     unsigned char* edgePtr = (unsigned char*) edgeStorage.get();
     sk_bzero(edgePtr, dataWidth*dataHeight*sizeof(char));
 
     // copy glyph into distance field storage
-    init_glyph_data(dataPtr, edgePtr, copyPtr,
-                    dataWidth, dataHeight,
-                    width+2, height+2, SK_DistanceFieldPad);
+    init_glyph_data(data.fAlpha, edgePtr, copyPtr, dataWidth, dataHeight);
 
     // create initial distance data, particularly at edges
-    init_distances(dataPtr, edgePtr, dataWidth, dataHeight);
+    init_distances(data, edgePtr, dataWidth, dataHeight);
 
     // now perform Euclidean distance transform to propagate distances
+    // (the outer buffer is skipped)
+    const int rowCount = dataWidth-2;
 
     // forwards in y
-    DFData* currData = dataPtr+dataWidth+1; // skip outer buffer
-    unsigned char* currEdge = edgePtr+dataWidth+1;
     for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                F2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData += dataWidth+1;
-        currEdge += dataWidth+1;
+        const int rowStart = j*dataWidth + 1;
+        check_row<true>(data, edgePtr, rowStart, rowCount, dataWidth);
+        check_left(data, edgePtr, rowStart, rowCount);
+        check_right(data, edgePtr, rowStart, rowCount, NULL);
     }
 
     // backwards in y
-    currData = dataPtr+dataWidth*(dataHeight-2) - 1; // skip outer buffer
-    currEdge = edgePtr+dataWidth*(dataHeight-2) - 1;
-    for (int j = 1; j < dataHeight-1; ++j) {
-        // forwards in x
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B1(currData, dataWidth);
-            }
-            ++currData;
-            ++currEdge;
-        }
-
-        // backwards in x
-        --currData; // reset to end
-        --currEdge;
-        for (int i = 1; i < dataWidth-1; ++i) {
-            // don't need to calculate distance for edge pixels
-            if (!*currEdge) {
-                B2(currData, dataWidth);
-            }
-            --currData;
-            --currEdge;
-        }
-
-        currData -= dataWidth-1;
-        currEdge -= dataWidth-1;
+    // The right neighbor comes before the row below, so each row's distances from before that
+    // is checked are kept to break ties the same way.
+    SkAutoSTMalloc<128, float> origSq(rowCount);
+    for (int j = dataHeight-2; j > 0; --j) {
+        const int rowStart = j*dataWidth + 1;
+        check_left(data, edgePtr, rowStart, rowCount);
+        memcpy(origSq.get(), data.fDistSq + rowStart, rowCount*sizeof(float));
+        check_row<false>(data, edgePtr, rowStart, rowCount, dataWidth);
+        check_right(data, edgePtr, rowStart, rowCount, origSq.get());
     }
 
     // copy results to final distance field data
-    currData = dataPtr + dataWidth+1;
-    currEdge = edgePtr + dataWidth+1;
     unsigned char *dfPtr = distanceField;
     for (int j = 1; j < dataHeight-1; ++j) {
         for (int i = 1; i < dataWidth-1; ++i) {
+            const int k = j*dataWidth + i;
 #if DUMP_EDGE
-            float alpha = currData->fAlpha;
+            float alpha = data.fAlpha[k];
             float edge = 0.0f;
-            if (*currEdge) {
+            if (edgePtr[k]) {
                 edge = 0.25f;
             }
             // blend with original image
@@ -441,18 +445,14 @@ static bool generate_distance_field_from_image(unsigned char* distanceField,
             *dfPtr++ = val;
 #else
             float dist;
-            if (currData->fAlpha > 0.5f) {
-                dist = -SkScalarSqrt(currData->fDistSq);
+            if (data.fAlpha[k] > 0.5f) {
+                dist = -SkScalarSqrt(data.fDistSq[k]);
             } else {
-                dist = SkScalarSqrt(currData->fDistSq);
+                dist = SkScalarSqrt(data.fDistSq[k]);
             }
             *dfPtr++ = pack_distance_field_val(dist, (float)SK_DistanceFieldMagnitude);
 #endif
-            ++currData;
-            ++currEdge;
         }
-        currData += 2;
-        currEdge += 2;
     }
 
     return true;
@@ -466,22 +466,20 @@ bool SkGenerateDistanceFieldFromA8Image(unsigned char* distanceField,
     SkASSERT(image);
 
     // create temp data
-    SkAutoSMalloc<1024> copyStorage((width+2)*(height+2)*sizeof(char));
+    const int copyWidth = width + 2*kDataPad;
+    const size_t copySize = copyWidth*(height + 2*kDataPad)*sizeof(char);
+    SkAutoSMalloc<1024> copyStorage(copySize);
     unsigned char* copyPtr = (unsigned char*) copyStorage.get();
 
     // we copy our source image into a padded copy to ensure we catch edge transitions
     // around the outside
     const unsigned char* currSrcScanLine = image;
-    sk_bzero(copyPtr, (width+2)*sizeof(char));
-    unsigned char* currDestPtr = copyPtr + width + 2;
+    sk_bzero(copyPtr, copySize);
     for (int i = 0; i < height; ++i) {
-        *currDestPtr++ = 0;
-        memcpy(currDestPtr, currSrcScanLine, rowBytes);
+        unsigned char* currDestPtr = copyPtr + (kDataPad + i)*copyWidth + kDataPad;
+        memcpy(currDestPtr, currSrcScanLine, width);
         currSrcScanLine += rowBytes;
-        currDestPtr += width;
-        *currDestPtr++ = 0;
     }
-    sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
     return generate_distance_field_from_image(distanceField, copyPtr, width, height);
 }
@@ -494,16 +492,17 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
     SkASSERT(image);
 
     // create temp data
-    SkAutoSMalloc<1024> copyStorage((width+2)*(height+2)*sizeof(char));
+    const int copyWidth = width + 2*kDataPad;
+    const size_t copySize = copyWidth*(height + 2*kDataPad)*sizeof(char);
+    SkAutoSMalloc<1024> copyStorage(copySize);
     unsigned char* copyPtr = (unsigned char*) copyStorage.get();
 
     // we copy our source image into a padded copy to ensure we catch edge transitions
     // around the outside
     const unsigned char* currSrcScanLine = image;
-    sk_bzero(copyPtr, (width+2)*sizeof(char));
-    unsigned char* currDestPtr = copyPtr + width + 2;
+    sk_bzero(copyPtr, copySize);
     for (int i = 0; i < height; ++i) {
-        *currDestPtr++ = 0;
+        unsigned char* currDestPtr = copyPtr + (kDataPad + i)*copyWidth + kDataPad;
         int rowWritesLeft = width;
         const unsigned char *maskPtr = currSrcScanLine;
         while (rowWritesLeft > 0) {
@@ -513,9 +512,7 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
             }
         }
         currSrcScanLine += rowBytes;
-        *currDestPtr++ = 0;
     }
-    sk_bzero(currDestPtr, (width+2)*sizeof(char));
 
     return generate_distance_field_from_image(distanceField, copyPtr, width, height);
 }
@@ -281,9 +281,11 @@ void SkDraw::drawPaint(const SkPaint& paint) const {
         }
     }
 
-    // normal case: use a blitter
-    SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
-    SkScan::FillIRect(devRect, *fRC, blitter.get());
+    // normal case: use a blitter, one per band so large shader fills can draw in parallel
+    SkDeviceLooper::ForEachBand(*fRC, devRect, [&](const SkRasterClip& rc) {
+        SkAutoBlitterChoose blitter(fDst, *fMatrix, paint);
+        SkScan::FillIRect(devRect, rc, blitter.get());
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -850,46 +852,50 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
         return;
     }
 
-    SkDeviceLooper looper(fDst, *fRC, ir, paint.isAntiAlias());
-    while (looper.next()) {
-        SkRect localDevRect;
-        looper.mapRect(&localDevRect, devRect);
-        SkMatrix localMatrix;
-        looper.mapMatrix(&localMatrix, *matrix);
-
-        SkAutoBlitterChoose blitterStorage(looper.getPixmap(), localMatrix, paint);
-        const SkRasterClip& clip = looper.getRC();
-        SkBlitter*          blitter = blitterStorage.get();
-
-        // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
-        // case we are also hairline (if we've gotten to here), which devolves to
-        // effectively just kFill
-        switch (rtype) {
-            case kFill_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiFillRect(localDevRect, clip, blitter);
-                } else {
-                    SkScan::FillRect(localDevRect, clip, blitter);
-                }
-                break;
-            case kStroke_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiFrameRect(localDevRect, strokeSize, clip, blitter);
-                } else {
-                    SkScan::FrameRect(localDevRect, strokeSize, clip, blitter);
-                }
-                break;
-            case kHair_RectType:
-                if (paint.isAntiAlias()) {
-                    SkScan::AntiHairRect(localDevRect, clip, blitter);
-                } else {
-                    SkScan::HairRect(localDevRect, clip, blitter);
-                }
-                break;
-            default:
-                SkDEBUGFAIL("bad rtype");
+    // Large rects, such as bitmaps and shader fills, are split into bands of rows that are
+    // drawn concurrently, each with its own blitter.
+    SkDeviceLooper::ForEachBand(*fRC, ir, [&](const SkRasterClip& bandRC) {
+        SkDeviceLooper looper(fDst, bandRC, ir, paint.isAntiAlias());
+        while (looper.next()) {
+            SkRect localDevRect;
+            looper.mapRect(&localDevRect, devRect);
+            SkMatrix localMatrix;
+            looper.mapMatrix(&localMatrix, *matrix);
+
+            SkAutoBlitterChoose blitterStorage(looper.getPixmap(), localMatrix, paint);
+            const SkRasterClip& clip = looper.getRC();
+            SkBlitter*          blitter = blitterStorage.get();
+
+            // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
+            // case we are also hairline (if we've gotten to here), which devolves to
+            // effectively just kFill
+            switch (rtype) {
+                case kFill_RectType:
+                    if (paint.isAntiAlias()) {
+                        SkScan::AntiFillRect(localDevRect, clip, blitter);
+                    } else {
+                        SkScan::FillRect(localDevRect, clip, blitter);
+                    }
+                    break;
+                case kStroke_RectType:
+                    if (paint.isAntiAlias()) {
+                        SkScan::AntiFrameRect(localDevRect, strokeSize, clip, blitter);
+                    } else {
+                        SkScan::FrameRect(localDevRect, strokeSize, clip, blitter);
+                    }
+                    break;
+                case kHair_RectType:
+                    if (paint.isAntiAlias()) {
+                        SkScan::AntiHairRect(localDevRect, clip, blitter);
+                    } else {
+                        SkScan::HairRect(localDevRect, clip, blitter);
+                    }
+                    break;
+                default:
+                    SkDEBUGFAIL("bad rtype");
+            }
         }
-    }
+    });
 }
 
 void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
@@ -1114,7 +1120,13 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     if (paint->getMaskFilter()) {
         SkPaint::Style style = doFill ? SkPaint::kFill_Style :
             SkPaint::kStroke_Style;
-        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *fRC, blitter, style)) {
+        // Only a path that reached device space unchanged can be found again by its ID.
+        uint32_t srcGenID = 0;
+        if (pathPtr == &origSrcPath && doFill && !origSrcPath.isVolatile()) {
+            srcGenID = origSrcPath.getGenerationID();
+        }
+        if (paint->getMaskFilter()->filterPath(*devPathPtr, *fMatrix, *fRC, blitter, style,
+                                               srcGenID, *matrix)) {
             return; // filterPath() called the blitter, so we're done
         }
     }
@@ -1907,7 +1919,9 @@ public:
 
     private:
         SkMatrix    fDstToUnit;
+        SkMatrix    fCTMInverse;    // computed once, rather than for every triangle
         SkPMColor   fColors[3];
+        bool        fCTMInvertible;
 
         typedef SkShader::Context INHERITED;
     };
@@ -1944,13 +1958,10 @@ bool SkTriColorShader::TriColorShaderContext::setup(const SkPoint pts[], const S
     if (!m.invert(&im)) {
         return false;
     }
-    // We can't call getTotalInverse(), because we explicitly don't want to look at the localmatrix
-    // as our interators are intrinsically tied to the vertices, and nothing else.
-    SkMatrix ctmInv;
-    if (!this->getCTM().invert(&ctmInv)) {
+    if (!fCTMInvertible) {
         return false;
     }
-    fDstToUnit.setConcat(im, ctmInv);
+    fDstToUnit.setConcat(im, fCTMInverse);
     return true;
 }
 
@@ -1971,7 +1982,11 @@ static int ScalarTo256(SkScalar v) {
 
 SkTriColorShader::TriColorShaderContext::TriColorShaderContext(const SkTriColorShader& shader,
                                                                const ContextRec& rec)
-    : INHERITED(shader, rec) {}
+    : INHERITED(shader, rec) {
+    // We can't call getTotalInverse(), because we explicitly don't want to look at the localmatrix
+    // as our interators are intrinsically tied to the vertices, and nothing else.
+    fCTMInvertible = this->getCTM().invert(&fCTMInverse);
+}
 
 SkTriColorShader::TriColorShaderContext::~TriColorShaderContext() {}
 
@@ -1982,10 +1997,25 @@ void SkTriColorShader::TriColorShaderContext::shadeSpan(int x, int y, SkPMColor
     const int alphaScale = Sk255To256(this->getPaintAlpha());
 
     SkPoint src;
+    SkScalar dx = 0, dy = 0;
+    const bool affine = !fDstToUnit.hasPerspective();
+    if (affine) {
+        // Step along the span instead of mapping every pixel.
+        fDstToUnit.mapXY(SkIntToScalar(x), SkIntToScalar(y), &src);
+        dx = fDstToUnit.getScaleX();
+        dy = fDstToUnit.getSkewY();
+    }
 
     for (int i = 0; i < count; i++) {
-        fDstToUnit.mapXY(SkIntToScalar(x), SkIntToScalar(y), &src);
-        x += 1;
+        if (affine) {
+            if (i > 0) {
+                src.fX += dx;
+                src.fY += dy;
+            }
+        } else {
+            fDstToUnit.mapXY(SkIntToScalar(x), SkIntToScalar(y), &src);
+            x += 1;
+        }
 
         int scale1 = ScalarTo256(src.fX);
         int scale2 = ScalarTo256(src.fY);
@@ -2095,12 +2125,23 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
     VertState::Proc vertProc = state.chooseProc(vmode);
 
     if (textures || colors) {
+        // Meshes usually map whole runs of triangles (e.g. every quad of a grid) with the same
+        // texture matrix, so only rebuild the shader context when it actually changes.
+        SkMatrix prevM;
+        bool hasPrevM = false;
+        bool prevResetOK = true;
+
         while (vertProc(&state)) {
             if (textures) {
                 SkMatrix tempM;
                 if (texture_to_matrix(state, vertices, textures, &tempM)) {
-                    SkShader::ContextRec rec(p, *fMatrix, &tempM);
-                    if (!blitter->resetShaderContext(rec)) {
+                    if (!hasPrevM || tempM != prevM) {
+                        SkShader::ContextRec rec(p, *fMatrix, &tempM);
+                        prevResetOK = blitter->resetShaderContext(rec);
+                        prevM = tempM;
+                        hasPrevM = true;
+                    }
+                    if (!prevResetOK) {
                         continue;
                     }
                 }
@@ -2149,6 +2190,73 @@ void SkDraw::drawVertices(SkCanvas::VertexMode vmode, int count,
     }
 }
 
+#include "SkImage.h"
+#include "SkRSXform.h"
+
+void SkDraw::drawAtlas(const SkImage* atlas, const SkRSXform xform[], const SkRect tex[],
+                       int count, const SkPaint& paint) const {
+    SkASSERT(atlas);
+    SkASSERT(0 == count || (xform && tex));
+
+    if (count <= 0 || fRC->isEmpty()) {
+        return;
+    }
+
+    // One shader and one blitter serve every sprite: each sprite just swaps in its own local
+    // matrix, instead of building a new shader, paint and path per sprite.
+    SkPaint p(paint);
+    p.setShader(atlas->newShader(SkShader::kClamp_TileMode, SkShader::kClamp_TileMode))->unref();
+
+    SkAutoBlitterChoose blitter(fDst, *fMatrix, p);
+    if (blitter->isNullBlitter()) {
+        return;
+    }
+
+    const bool doAA = paint.isAntiAlias();
+    const bool ctmStaysRect = fMatrix->rectStaysRect();
+    SkPath path;
+    path.setIsVolatile(true);
+
+    for (int i = 0; i < count; ++i) {
+        if (tex[i].isEmpty()) {
+            continue;
+        }
+
+        SkMatrix localM;
+        localM.setRSXform(xform[i]);
+        localM.preTranslate(-tex[i].left(), -tex[i].top());
+        SkShader::ContextRec rec(p, *fMatrix, &localM);
+        if (!blitter->resetShaderContext(rec)) {
+            continue;
+        }
+
+        SkPoint quad[4];
+        xform[i].toQuad(tex[i].width(), tex[i].height(), quad);
+
+        if (ctmStaysRect && xform[i].rectStaysRect()) {
+            // Axis-aligned in device space: scan the sprite as a rect.
+            SkRect devRect;
+            fMatrix->mapPoints(quad, 4);
+            devRect.set(quad, 4);
+            if (doAA) {
+                SkScan::AntiFillRect(devRect, *fRC, blitter.get());
+            } else {
+                SkScan::FillRect(devRect, *fRC, blitter.get());
+            }
+        } else {
+            path.rewind();
+            path.addPoly(quad, 4, true);
+            path.setConvexity(SkPath::kConvex_Convexity);
+            path.transform(*fMatrix);
+            if (doAA) {
+                SkScan::AntiFillPath(path, *fRC, blitter.get());
+            } else {
+                SkScan::FillPath(path, *fRC, blitter.get());
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -2174,6 +2282,7 @@ void SkDraw::validate() const {
 #include "SkDraw.h"
 #include "SkRegion.h"
 #include "SkBlitter.h"
+#include "SkMaskCache.h"
 
 static bool compute_bounds(const SkPath& devPath, const SkIRect* clipBounds,
                            const SkMaskFilter* filter, const SkMatrix* filterMatrix,
@@ -2267,3 +2376,82 @@ bool SkDraw::DrawToMask(const SkPath& devPath, const SkIRect* clipBounds,
 
     return true;
 }
+
+static bool filter_mask(const SkPath& devPath, const SkIRect& clipBounds,
+                        const SkMaskFilter* filter, const SkMatrix& filterMatrix,
+                        SkMask* dst, SkPaint::Style style) {
+    SkMask srcM;
+    if (!SkDraw::DrawToMask(devPath, &clipBounds, filter, &filterMatrix, &srcM,
+                            SkMask::kComputeBoundsAndRenderImage_CreateMode, style)) {
+        return false;
+    }
+    SkAutoMaskFreeImage autoSrc(srcM.fImage);
+    return filter->filterMask(dst, srcM, filterMatrix, NULL);
+}
+
+// Cached path masks are built with their translation snapped to this fraction of a pixel.
+static const int kMaskSubpixelSteps = 4;
+
+bool SkDraw::DrawToFilteredMask(const SkPath& devPath, uint32_t srcGenID,
+                                const SkMatrix& srcToDev, const SkIRect& clipBounds,
+                                const SkMaskFilter* filter, const SkMatrix& filterMatrix,
+                                SkMask* dst, SkCachedData** data, SkPaint::Style style) {
+    *data = NULL;
+
+    SkMaskFilter::BlurRec rec;
+    if (0 == srcGenID || SkPaint::kFill_Style != style || devPath.isInverseFillType() ||
+            srcToDev.hasPerspective() || !filter->asABlur(&rec)) {
+        return filter_mask(devPath, clipBounds, filter, filterMatrix, dst, style);
+    }
+
+    const SkScalar tx = srcToDev.getTranslateX(),
+                   ty = srcToDev.getTranslateY();
+    const int ix = SkScalarFloorToInt(tx),
+              iy = SkScalarFloorToInt(ty);
+    SkMatrix keyMatrix = srcToDev;
+    keyMatrix.setTranslateX(SkScalarFloorToScalar((tx - ix) * kMaskSubpixelSteps) /
+                            kMaskSubpixelSteps);
+    keyMatrix.setTranslateY(SkScalarFloorToScalar((ty - iy) * kMaskSubpixelSteps) /
+                            kMaskSubpixelSteps);
+    SkPath snappedPath;
+    devPath.offset(ix + keyMatrix.getTranslateX() - tx, iy + keyMatrix.getTranslateY() - ty,
+                   &snappedPath);
+
+    // Only cache masks the clip didn't cut, so they can be reused under any clip.
+    SkMask wholeM, clippedM;
+    if (!DrawToMask(snappedPath, NULL, filter, &filterMatrix, &wholeM,
+                    SkMask::kJustComputeBounds_CreateMode, style) ||
+        !DrawToMask(snappedPath, &clipBounds, filter, &filterMatrix, &clippedM,
+                    SkMask::kJustComputeBounds_CreateMode, style)) {
+        return false;
+    }
+    if (wholeM.fBounds != clippedM.fBounds) {
+        return filter_mask(devPath, clipBounds, filter, filterMatrix, dst, style);
+    }
+
+    const SkScalar sigma = filterMatrix.mapRadius(rec.fSigma);
+    const SkPath::FillType fillType = devPath.getFillType();
+    *data = SkMaskCache::FindAndRef(sigma, rec.fStyle, rec.fQuality, srcGenID, fillType,
+                                    keyMatrix, dst);
+    if (*data) {
+        dst->fBounds.offset(ix, iy);
+        return true;
+    }
+
+    if (!filter_mask(snappedPath, clipBounds, filter, filterMatrix, dst, style)) {
+        return false;
+    }
+    const size_t size = dst->computeTotalImageSize();
+    *data = SkResourceCache::NewCachedData(size);
+    if (*data) {
+        memcpy((*data)->writable_data(), dst->fImage, size);
+        SkMask::FreeImage(dst->fImage);
+        dst->fImage = (uint8_t*)(*data)->data();
+
+        SkMask cachedM = *dst;
+        cachedM.fBounds.offset(-ix, -iy);
+        SkMaskCache::Add(sigma, rec.fStyle, rec.fQuality, srcGenID, fillType, keyMatrix,
+                         cachedM, *data);
+    }
+    return true;
+}
@@ -8,6 +8,8 @@
 #include "SkAtomics.h"
 #include "SkCanvas.h"
 #include "SkDrawable.h"
+#include "SkImage.h"
+#include "SkSurface.h"
 
 static int32_t next_generation_id() {
     static int32_t gCanvasDrawableGenerationID;
@@ -21,7 +23,13 @@ static int32_t next_generation_id() {
     return genID;
 }
 
-SkDrawable::SkDrawable() : fGenerationID(0) {}
+SkDrawable::SkDrawable()
+    : fGenerationID(0)
+    , fCachesSnapshot(false)
+    , fSnapshotGenID(0)
+    , fSnapshotContext(NULL) {}
+
+SkDrawable::~SkDrawable() {}
 
 static void draw_bbox(SkCanvas* canvas, const SkRect& r) {
     SkPaint paint;
@@ -37,6 +45,9 @@ void SkDrawable::draw(SkCanvas* canvas, const SkMatrix* matrix) {
     if (matrix) {
         canvas->concat(*matrix);
     }
+    if (fCachesSnapshot && this->drawSnapshot(canvas)) {
+        return;
+    }
     this->onDraw(canvas);
 
     if (false) {
@@ -68,6 +79,73 @@ void SkDrawable::notifyDrawingChanged() {
     fGenerationID = 0;
 }
 
+void SkDrawable::setCachesSnapshot(bool caches) {
+    fCachesSnapshot = caches;
+    if (!caches) {
+        fSnapshot.reset(NULL);
+    }
+}
+
+// Larger than this and the snapshot is likely to cost more than it saves (or fail to allocate).
+static const int kMaxSnapshotDimension = 2048;
+
+bool SkDrawable::drawSnapshot(SkCanvas* canvas) {
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    if (ctm.hasPerspective()) {
+        return false;
+    }
+
+    // The snapshot is rendered with everything but the translation, so scrolling reuses it.
+    SkMatrix linear = ctm;
+    linear.setTranslateX(0);
+    linear.setTranslateY(0);
+
+    GrContext* context = canvas->getGrContext();
+    const uint32_t genID = this->getGenerationID();
+    if (!fSnapshot || fSnapshotGenID != genID || fSnapshotMatrix != linear ||
+        fSnapshotContext != context) {
+        fSnapshot.reset(NULL);
+
+        SkRect devBounds;
+        linear.mapRect(&devBounds, this->getBounds());
+        const SkIRect snapBounds = devBounds.roundOut();
+        if (snapBounds.isEmpty() ||
+            snapBounds.width() > kMaxSnapshotDimension ||
+            snapBounds.height() > kMaxSnapshotDimension) {
+            return false;
+        }
+
+        const SkImageInfo info = SkImageInfo::MakeN32Premul(snapBounds.width(),
+                                                            snapBounds.height());
+        SkAutoTUnref<SkSurface> surface(canvas->newSurface(info));
+        if (!surface) {
+            return false;
+        }
+        SkCanvas* snapCanvas = surface->getCanvas();
+        snapCanvas->clear(SK_ColorTRANSPARENT);
+        snapCanvas->translate(-SkIntToScalar(snapBounds.fLeft), -SkIntToScalar(snapBounds.fTop));
+        snapCanvas->concat(linear);
+        this->onDraw(snapCanvas);
+
+        fSnapshot.reset(surface->newImageSnapshot());
+        if (!fSnapshot) {
+            return false;
+        }
+        fSnapshotGenID = genID;
+        fSnapshotMatrix = linear;
+        fSnapshotOrigin.set(snapBounds.fLeft, snapBounds.fTop);
+        fSnapshotContext = context;
+    }
+
+    // Draw 1:1 in device space, on whole pixels, so the cached pixels are never resampled.
+    // Our caller restores the matrix.
+    const SkScalar x = SkScalarRoundToScalar(ctm.getTranslateX()) + fSnapshotOrigin.fX;
+    const SkScalar y = SkScalarRoundToScalar(ctm.getTranslateY()) + fSnapshotOrigin.fY;
+    canvas->setMatrix(SkMatrix::I());
+    canvas->drawImage(fSnapshot, x, y);
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SkPictureRecorder.h"
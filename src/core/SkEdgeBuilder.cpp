@@ -7,10 +7,13 @@
  */
 #include "SkEdgeBuilder.h"
 #include "SkPath.h"
+#include "SkChecksum.h"
 #include "SkEdge.h"
 #include "SkEdgeClipper.h"
 #include "SkLineClipper.h"
 #include "SkGeometry.h"
+#include "SkPathPriv.h"
+#include "SkResourceCache.h"
 
 template <typename T> static T* typedAllocThrow(SkChunkAlloc& alloc) {
     return static_cast<T*>(alloc.allocThrow(sizeof(T)));
@@ -263,3 +266,131 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, int shiftUp,
     fEdgeList = fList.begin();
     return fList.count();
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Below this many points, building the edges costs about as much as hashing and comparing the
+// path to find them.
+static const int kMinCachedEdgePoints = 256;
+
+static size_t edge_size(const SkEdge* edge) {
+    if (0 == edge->fCurveCount) {
+        return sizeof(SkEdge);
+    }
+    return edge->fCurveCount > 0 ? sizeof(SkQuadraticEdge) : sizeof(SkCubicEdge);
+}
+
+namespace {
+static unsigned gEdgeListKeyNamespaceLabel;
+
+// Device space paths are usually new SkPathRefs each draw (the matrix has been applied to a
+// copy), so the key hashes the points themselves. The Rec keeps a ref to the path it was built
+// from to rule out collisions.
+struct EdgeListKey : public SkResourceCache::Key {
+public:
+    EdgeListKey(const SkPath& path, const SkIRect* clip, int shiftUp, bool canCullToTheRight)
+        : fPointHash(SkChecksum::Murmur3(SkPathPriv::PointData(path),
+                                         path.countPoints() * sizeof(SkPoint)))
+        , fPointCount(path.countPoints())
+        , fVerbCount(path.countVerbs())
+        , fClip(clip ? *clip : SkIRect::MakeEmpty())
+        , fHasClip(SkToBool(clip))
+        , fShiftUp(shiftUp)
+        , fCanCullToTheRight(canCullToTheRight)
+    {
+        this->init(&gEdgeListKeyNamespaceLabel, 0,
+                   sizeof(fPointHash) + sizeof(fPointCount) + sizeof(fVerbCount) +
+                   sizeof(fClip) + sizeof(fHasClip) + sizeof(fShiftUp) +
+                   sizeof(fCanCullToTheRight));
+    }
+
+    uint32_t fPointHash;
+    int32_t  fPointCount;
+    int32_t  fVerbCount;
+    SkIRect  fClip;
+    int32_t  fHasClip;
+    int32_t  fShiftUp;
+    int32_t  fCanCullToTheRight;
+};
+
+struct EdgeListContext {
+    const SkPath*       fPath;
+    SkChunkAlloc*       fAlloc;
+    SkTDArray<SkEdge*>* fList;
+};
+
+// Holds a pristine copy of the built edges, which the scan converter advances in place, so
+// every hit copies them out again.
+struct EdgeListRec : public SkResourceCache::Rec {
+    EdgeListRec(const EdgeListKey& key, const SkPath& path, SkEdge* const edges[], int count)
+        : fKey(key)
+        , fPath(path)
+        , fCount(count)
+        , fEdgeBytes(0)
+        , fOffsets(count)
+    {
+        for (int i = 0; i < count; ++i) {
+            fOffsets[i] = SkToU32(fEdgeBytes);
+            fEdgeBytes += edge_size(edges[i]);
+        }
+        fEdges.reset(fEdgeBytes);
+        for (int i = 0; i < count; ++i) {
+            memcpy(fEdges.get() + fOffsets[i], edges[i], edge_size(edges[i]));
+        }
+    }
+
+    EdgeListKey              fKey;
+    SkPath                   fPath;
+    int                      fCount;
+    size_t                   fEdgeBytes;
+    SkAutoTMalloc<uint32_t>  fOffsets;
+    SkAutoTMalloc<char>      fEdges;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fEdgeBytes + fCount * sizeof(uint32_t) +
+               fPath.countPoints() * sizeof(SkPoint) + fPath.countVerbs();
+    }
+    const char* getCategory() const override { return "edge-list"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const EdgeListRec& rec = static_cast<const EdgeListRec&>(baseRec);
+        EdgeListContext* context = static_cast<EdgeListContext*>(contextData);
+        if (rec.fPath != *context->fPath) {
+            // A hash collision; let the new path's edges replace these.
+            return false;
+        }
+        char* edges = static_cast<char*>(context->fAlloc->allocThrow(rec.fEdgeBytes));
+        memcpy(edges, rec.fEdges.get(), rec.fEdgeBytes);
+        SkEdge** list = context->fList->append(rec.fCount);
+        for (int i = 0; i < rec.fCount; ++i) {
+            list[i] = reinterpret_cast<SkEdge*>(edges + rec.fOffsets[i]);
+        }
+        return true;
+    }
+};
+} // namespace
+
+int SkEdgeBuilder::buildCached(const SkPath& path, const SkIRect* iclip, int shiftUp,
+                               bool canCullToTheRight) {
+    if (path.isVolatile() || path.countPoints() < kMinCachedEdgePoints) {
+        return this->build(path, iclip, shiftUp, canCullToTheRight);
+    }
+
+    fAlloc.reset();
+    fList.reset();
+    fShiftUp = shiftUp;
+
+    EdgeListKey key(path, iclip, shiftUp, canCullToTheRight);
+    EdgeListContext context = { &path, &fAlloc, &fList };
+    if (SkResourceCache::Find(key, EdgeListRec::Visitor, &context)) {
+        fEdgeList = fList.begin();
+        return fList.count();
+    }
+
+    int count = this->build(path, iclip, shiftUp, canCullToTheRight);
+    if (count > 0) {
+        SkResourceCache::Add(SkNEW_ARGS(EdgeListRec, (key, path, fEdgeList, count)));
+    }
+    return count;
+}
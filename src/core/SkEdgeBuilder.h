@@ -24,6 +24,12 @@ public:
     // is returned from edgeList().
     int build(const SkPath& path, const SkIRect* clip, int shiftUp, bool clipToTheRight);
 
+    // Same as build(), but for large non-volatile paths, first looks in SkResourceCache for the
+    // edges of an identical path built with the same clip and shift, and adds its own if none
+    // are found. Redrawing a complex path under an unchanged matrix then skips clipping and
+    // setting up its edges.
+    int buildCached(const SkPath& path, const SkIRect* clip, int shiftUp, bool clipToTheRight);
+
     SkEdge** edgeList() { return fEdgeList; }
 
 private:
@@ -6,6 +6,7 @@
  */
 
 #include "SkFlattenable.h"
+#include "SkChecksum.h"
 #include "SkPtrRecorder.h"
 #include "SkReadBuffer.h"
 
@@ -59,6 +60,44 @@ struct Entry {
 static int gCount;
 static Entry gEntries[MAX_ENTRY_COUNT];
 
+// Open-addressed hash tables over gEntries, one keyed by name and one by factory, filled in as
+// entries are registered. Each slot holds an index into gEntries plus one, so zero is empty.
+// They are at most half full, so probes stay short.
+#define SLOT_COUNT  (2 * MAX_ENTRY_COUNT)
+SK_COMPILE_ASSERT(0 == (SLOT_COUNT & (SLOT_COUNT - 1)), slot_count_must_be_pow2);
+SK_COMPILE_ASSERT(MAX_ENTRY_COUNT < (1 << 15), entry_index_must_fit_in_slot);
+
+static uint16_t gNameSlots[SLOT_COUNT];
+static uint16_t gFactorySlots[SLOT_COUNT];
+
+static uint32_t hash_name(const char name[]) {
+    return SkChecksum::Murmur3(name, strlen(name));
+}
+
+static uint32_t hash_factory(SkFlattenable::Factory factory) {
+    return SkChecksum::Mix(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(factory)));
+}
+
+// Returns the slot holding name, or the empty slot where it would go.
+static uint16_t* find_name_slot(const char name[]) {
+    for (uint32_t i = hash_name(name);; ++i) {
+        uint16_t* slot = &gNameSlots[i & (SLOT_COUNT - 1)];
+        if (0 == *slot || 0 == strcmp(gEntries[*slot - 1].fName, name)) {
+            return slot;
+        }
+    }
+}
+
+// Returns the slot holding factory, or the empty slot where it would go.
+static uint16_t* find_factory_slot(SkFlattenable::Factory factory) {
+    for (uint32_t i = hash_factory(factory);; ++i) {
+        uint16_t* slot = &gFactorySlots[i & (SLOT_COUNT - 1)];
+        if (0 == *slot || gEntries[*slot - 1].fFactory == factory) {
+            return slot;
+        }
+    }
+}
+
 void SkFlattenable::Register(const char name[], Factory factory, SkFlattenable::Type type) {
     SkASSERT(name);
     SkASSERT(factory);
@@ -75,6 +114,11 @@ void SkFlattenable::Register(const char name[], Factory factory, SkFlattenable::
     gEntries[gCount].fFactory = factory;
     gEntries[gCount].fType = type;
     gCount += 1;
+
+    // As when these were linear scans from the end, a later registration of the same name or
+    // factory wins.
+    *find_name_slot(name) = SkToU16(gCount);
+    *find_factory_slot(factory) = SkToU16(gCount);
 }
 
 #ifdef SK_DEBUG
@@ -92,13 +136,8 @@ SkFlattenable::Factory SkFlattenable::NameToFactory(const char name[]) {
 #ifdef SK_DEBUG
     report_no_entries(__FUNCTION__);
 #endif
-    const Entry* entries = gEntries;
-    for (int i = gCount - 1; i >= 0; --i) {
-        if (strcmp(entries[i].fName, name) == 0) {
-            return entries[i].fFactory;
-        }
-    }
-    return NULL;
+    const uint16_t slot = *find_name_slot(name);
+    return slot ? gEntries[slot - 1].fFactory : NULL;
 }
 
 bool SkFlattenable::NameToType(const char name[], SkFlattenable::Type* type) {
@@ -107,12 +146,10 @@ bool SkFlattenable::NameToType(const char name[], SkFlattenable::Type* type) {
 #ifdef SK_DEBUG
     report_no_entries(__FUNCTION__);
 #endif
-    const Entry* entries = gEntries;
-    for (int i = gCount - 1; i >= 0; --i) {
-        if (strcmp(entries[i].fName, name) == 0) {
-            *type = entries[i].fType;
-            return true;
-        }
+    const uint16_t slot = *find_name_slot(name);
+    if (slot) {
+        *type = gEntries[slot - 1].fType;
+        return true;
     }
     return false;
 }
@@ -122,11 +159,6 @@ const char* SkFlattenable::FactoryToName(Factory fact) {
 #ifdef SK_DEBUG
     report_no_entries(__FUNCTION__);
 #endif
-    const Entry* entries = gEntries;
-    for (int i = gCount - 1; i >= 0; --i) {
-        if (entries[i].fFactory == fact) {
-            return entries[i].fName;
-        }
-    }
-    return NULL;
+    const uint16_t slot = *find_factory_slot(fact);
+    return slot ? gEntries[slot - 1].fName : NULL;
 }
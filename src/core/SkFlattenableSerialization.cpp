@@ -14,10 +14,7 @@
 SkData* SkValidatingSerializeFlattenable(SkFlattenable* flattenable) {
     SkWriteBuffer writer(SkWriteBuffer::kValidation_Flag);
     writer.writeFlattenable(flattenable);
-    size_t size = writer.bytesWritten();
-    SkData* data = SkData::NewUninitialized(size);
-    writer.writeToMemory(data->writable_data());
-    return data;
+    return writer.detachAsData();
 }
 
 SkFlattenable* SkValidatingDeserializeFlattenable(const void* data, size_t size,
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkFloatToDecimal.h"
+#include "SkFloatBits.h"
+#include "SkScalar.h"
+
+/*  This is the float half of Ulf Adams' Ryu algorithm ("Ryu: Fast Float-to-String Conversion",
+ *  PLDI 2018). The value and the two halfway points to its neighbors are scaled by a power of ten
+ *  using 64-bit fixed point approximations of 5^q and 5^-q, then decimal digits are dropped for as
+ *  long as the scaled halfway points still disagree. The tables were generated with
+ *
+ *      kPow5InvSplit[q] = floor(2^(pow5_bits(q) - 1 + kPow5InvBitCount) / 5^q) + 1
+ *      kPow5Split[i]    = floor(5^i / 2^(pow5_bits(i) - kPow5BitCount))
+ */
+
+static const int kMantissaBits = 23;
+static const int kExponentBias = 127;
+static const int kPow5InvBitCount = 59;
+static const int kPow5BitCount = 61;
+
+static const uint64_t kPow5InvSplit[] = {
+    0x0800000000000001ULL, 0x0666666666666667ULL, 0x051eb851eb851eb9ULL,
+    0x04189374bc6a7efaULL, 0x068db8bac710cb2aULL, 0x053e2d6238da3c22ULL,
+    0x0431bde82d7b634eULL, 0x06b5fca6af2bd216ULL, 0x055e63b88c230e78ULL,
+    0x044b82fa09b5a52dULL, 0x06df37f675ef6eaeULL, 0x057f5ff85e592558ULL,
+    0x0465e6604b7a8447ULL, 0x0709709a125da071ULL, 0x05a126e1a84ae6c1ULL,
+    0x0480ebe7b9d58567ULL, 0x0734aca5f6226f0bULL, 0x05c3bd5191b525a3ULL,
+    0x049c97747490eae9ULL, 0x0760f253edb4ab0eULL, 0x05e72843249088d8ULL,
+    0x04b8ed0283a6d3e0ULL, 0x078e480405d7b966ULL, 0x060b6cd004ac9452ULL,
+    0x04d5f0a66a23a9dbULL, 0x07bcb43d769f762bULL, 0x063090312bb2c4efULL,
+    0x04f3a68dbc8f03f3ULL, 0x07ec3daf94180651ULL, 0x065697bfa9acd1daULL,
+    0x051212ffbaf0a7e2ULL,
+};
+
+static const uint64_t kPow5Split[] = {
+    0x1000000000000000ULL, 0x1400000000000000ULL, 0x1900000000000000ULL,
+    0x1f40000000000000ULL, 0x1388000000000000ULL, 0x186a000000000000ULL,
+    0x1e84800000000000ULL, 0x1312d00000000000ULL, 0x17d7840000000000ULL,
+    0x1dcd650000000000ULL, 0x12a05f2000000000ULL, 0x174876e800000000ULL,
+    0x1d1a94a200000000ULL, 0x12309ce540000000ULL, 0x16bcc41e90000000ULL,
+    0x1c6bf52634000000ULL, 0x11c37937e0800000ULL, 0x16345785d8a00000ULL,
+    0x1bc16d674ec80000ULL, 0x1158e460913d0000ULL, 0x15af1d78b58c4000ULL,
+    0x1b1ae4d6e2ef5000ULL, 0x10f0cf064dd59200ULL, 0x152d02c7e14af680ULL,
+    0x1a784379d99db420ULL, 0x108b2a2c28029094ULL, 0x14adf4b7320334b9ULL,
+    0x19d971e4fe8401e7ULL, 0x1027e72f1f128130ULL, 0x1431e0fae6d7217cULL,
+    0x193e5939a08ce9dbULL, 0x1f8def8808b02452ULL, 0x13b8b5b5056e16b3ULL,
+    0x18a6e32246c99c60ULL, 0x1ed09bead87c0378ULL, 0x13426172c74d822bULL,
+    0x1812f9cf7920e2b6ULL, 0x1e17b84357691b64ULL, 0x12ced32a16a1b11eULL,
+    0x178287f49c4a1d66ULL, 0x1d6329f1c35ca4bfULL, 0x125dfa371a19e6f7ULL,
+    0x16f578c4e0a060b5ULL, 0x1cb2d6f618c878e3ULL, 0x11efc659cf7d4b8dULL,
+    0x166bb7f0435c9e71ULL, 0x1c06a5ec5433c60dULL,
+};
+
+// ceil(log2(5^e)), or 1 when e == 0.
+static int pow5_bits(int e) {
+    return ((e * 1217359) >> 19) + 1;
+}
+
+// floor(log10(2^e))
+static uint32_t log10_pow2(int e) {
+    return (e * 78913) >> 18;
+}
+
+// floor(log10(5^e))
+static uint32_t log10_pow5(int e) {
+    return (e * 732923) >> 20;
+}
+
+static bool is_multiple_of_pow5(uint32_t value, uint32_t p) {
+    uint32_t count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        ++count;
+    }
+    return count >= p;
+}
+
+static bool is_multiple_of_pow2(uint32_t value, uint32_t p) {
+    return (value & ((1u << p) - 1)) == 0;
+}
+
+// (m * factor) >> shift, where shift > 32.
+static uint32_t mul_shift(uint32_t m, uint64_t factor, int shift) {
+    SkASSERT(shift > 32);
+    uint64_t lo = (uint64_t)m * (uint32_t)factor;
+    uint64_t hi = (uint64_t)m * (uint32_t)(factor >> 32);
+    return (uint32_t)(((lo >> 32) + hi) >> (shift - 32));
+}
+
+static uint32_t mul_pow5_inv_div_pow2(uint32_t m, uint32_t q, int j) {
+    SkASSERT(q < SK_ARRAY_COUNT(kPow5InvSplit));
+    return mul_shift(m, kPow5InvSplit[q], j);
+}
+
+static uint32_t mul_pow5_div_pow2(uint32_t m, uint32_t i, int j) {
+    SkASSERT(i < SK_ARRAY_COUNT(kPow5Split));
+    return mul_shift(m, kPow5Split[i], j);
+}
+
+uint32_t SkFloatToDecimal(float value, int* exponent) {
+    SkASSERT(value > 0 && SkScalarIsFinite(value));
+    const uint32_t bits = SkFloat2Bits(value);
+    const uint32_t ieeeMantissa = bits & ((1u << kMantissaBits) - 1);
+    const uint32_t ieeeExponent = bits >> kMantissaBits;
+
+    // value == m2 * 2^e2, with two extra bits of room for the halfway points.
+    int e2;
+    uint32_t m2;
+    if (0 == ieeeExponent) {
+        e2 = 1 - kExponentBias - kMantissaBits - 2;
+        m2 = ieeeMantissa;
+    } else {
+        e2 = ieeeExponent - kExponentBias - kMantissaBits - 2;
+        m2 = (1u << kMantissaBits) | ieeeMantissa;
+    }
+    // Round-half-even parsing accepts the halfway points only when the mantissa is even.
+    const bool acceptBounds = (m2 & 1) == 0;
+
+    // The value and its lower and upper halfway points, times 4. The lower neighbor is closer
+    // when value is the smallest float of its binade.
+    const uint32_t mv = 4 * m2;
+    const uint32_t mp = 4 * m2 + 2;
+    const uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+    const uint32_t mm = 4 * m2 - 1 - mmShift;
+
+    // Scale all three by a power of ten, tracking whether any digits were lost doing so.
+    uint32_t vr, vp, vm;
+    int e10;
+    bool vmIsTrailingZeros = false;
+    bool vrIsTrailingZeros = false;
+    uint32_t lastRemovedDigit = 0;
+    if (e2 >= 0) {
+        const uint32_t q = log10_pow2(e2);
+        e10 = q;
+        const int k = kPow5InvBitCount + pow5_bits(q) - 1;
+        const int i = -e2 + q + k;
+        vr = mul_pow5_inv_div_pow2(mv, q, i);
+        vp = mul_pow5_inv_div_pow2(mp, q, i);
+        vm = mul_pow5_inv_div_pow2(mm, q, i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // The loop below won't run, but we still need the digit that scaling removed.
+            const int l = kPow5InvBitCount + pow5_bits(q - 1) - 1;
+            lastRemovedDigit = mul_pow5_inv_div_pow2(mv, q - 1, -e2 + q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            // At most one of mp, mv, and mm can be a multiple of 5.
+            if (mv % 5 == 0) {
+                vrIsTrailingZeros = is_multiple_of_pow5(mv, q);
+            } else if (acceptBounds) {
+                vmIsTrailingZeros = is_multiple_of_pow5(mm, q);
+            } else {
+                vp -= is_multiple_of_pow5(mp, q);
+            }
+        }
+    } else {
+        const uint32_t q = log10_pow5(-e2);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = pow5_bits(i) - kPow5BitCount;
+        int j = q - k;
+        vr = mul_pow5_div_pow2(mv, i, j);
+        vp = mul_pow5_div_pow2(mp, i, j);
+        vm = mul_pow5_div_pow2(mm, i, j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = q - 1 - (pow5_bits(i + 1) - kPow5BitCount);
+            lastRemovedDigit = mul_pow5_div_pow2(mv, i + 1, j) % 10;
+        }
+        if (q <= 1) {
+            // mv has at least two trailing zero bits; mp one; mm one only if mmShift is set.
+            vrIsTrailingZeros = true;
+            if (acceptBounds) {
+                vmIsTrailingZeros = mmShift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 31) {
+            vrIsTrailingZeros = is_multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    // Drop digits while the interval still holds a shorter number, then round what is left.
+    int removed = 0;
+    uint32_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+            // The exact value ends in ...50000, so round half to even.
+            lastRemovedDigit = 4;
+        }
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) ||
+                       lastRemovedDigit >= 5);
+    } else {
+        while (vp / 10 > vm / 10) {
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || lastRemovedDigit >= 5);
+    }
+
+    // Rounding up may leave trailing zeros behind; callers expect none.
+    while (output % 10 == 0) {
+        output /= 10;
+        ++removed;
+    }
+    SkASSERT(output > 0 && output < 1000000000);
+    *exponent = e10 + removed;
+    return output;
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkFloatToDecimal_DEFINED
+#define SkFloatToDecimal_DEFINED
+
+#include "SkTypes.h"
+
+/** The most significant digits SkFloatToDecimal() can return. */
+#define SkFloatToDecimal_MaxDigits  9
+
+/**
+ *  Finds the shortest decimal number that reads back as exactly value, which must be finite and
+ *  greater than zero. Returns its significand, which has no trailing zeros and at most
+ *  SkFloatToDecimal_MaxDigits digits, and sets exponent so that
+ *  value == (float)(significand * 10^exponent).
+ *
+ *  When several numbers of that length round-trip, the one closest to value is returned.
+ *  This uses only integer arithmetic, so it is independent of the C locale and of printf.
+ */
+uint32_t SkFloatToDecimal(float value, int* exponent);
+
+#endif
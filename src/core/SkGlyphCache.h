@@ -8,6 +8,7 @@
 #define SkGlyphCache_DEFINED
 
 #include "SkBitmap.h"
+#include "SkCacheStats.h"
 #include "SkChunkAlloc.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
@@ -55,6 +56,16 @@ public:
     const SkGlyph& getUnicharMetrics(SkUnichar, SkFixed x, SkFixed y);
     const SkGlyph& getGlyphIDMetrics(uint16_t, SkFixed x, SkFixed y);
 
+    /** Bulk lookups for measuring runs of text in one call. For each of count glyph ids (or
+        chars), write the glyph's fAdvanceX to advanceX[i], its fAdvanceY to advanceY[i], and its
+        bounds, relative to its origin, to bounds[i]. Any of the outputs may be null. Asking for
+        bounds looks up the full metrics, as getGlyphIDMetrics does; otherwise only the advances.
+    */
+    void getGlyphIDAdvances(const uint16_t glyphIDs[], int count,
+                            SkFixed advanceX[], SkFixed advanceY[], SkIRect bounds[]);
+    void getUnicharAdvances(const SkUnichar chars[], int count,
+                            SkFixed advanceX[], SkFixed advanceY[], SkIRect bounds[]);
+
     /** Return the glyphID for the specified Unichar. If the char has already been seen, use the
         existing cache entry. If not, ask the scalercontext to compute it for us.
     */
@@ -73,6 +84,12 @@ public:
     */
     const void* findImage(const SkGlyph&);
 
+    /** Generates the images of count glyphs of this strike at once, spreading the work over the
+        task threads when there are many, each with its own scaler context. Glyphs that already
+        have images are skipped. The glyphs must not be moved by new lookups while this runs.
+    */
+    void findImages(const SkGlyph* glyphs[], int count);
+
     /** Return the Path associated with the glyph. If it has not been generated this will trigger
         that.
     */
@@ -138,6 +155,9 @@ public:
 
     static void Dump();
 
+    /** Reports the global cache of strikes as "glyph", not counting strikes parked per thread. */
+    static void VisitStats(SkCacheStats::Visitor, void* context);
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
@@ -165,6 +185,7 @@ public:
 
 private:
     friend class SkGlyphCache_Globals;
+    friend class SkGlyphCache_TLS;
 
     enum MetricsType {
         kJustAdvance_MetricsType,
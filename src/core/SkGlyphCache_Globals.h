@@ -8,6 +8,7 @@
 #ifndef SkGlyphCache_Globals_DEFINED
 #define SkGlyphCache_Globals_DEFINED
 
+#include "SkAtomics.h"
 #include "SkGlyphCache.h"
 #include "SkMutex.h"
 #include "SkSpinlock.h"
@@ -21,6 +22,12 @@
     #define SK_DEFAULT_FONT_CACHE_LIMIT     (2 * 1024 * 1024)
 #endif
 
+// Byte limit for each thread's private front-end to the global cache, for threads that never
+// call SkGraphics::SetTLSFontCacheLimit().  0 means threads share only the global cache.
+#ifndef SK_DEFAULT_TLS_FONT_CACHE_LIMIT
+    #define SK_DEFAULT_TLS_FONT_CACHE_LIMIT 0
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkGlyphCache_Globals {
@@ -31,6 +38,9 @@ public:
         fCacheSizeLimit = SK_DEFAULT_FONT_CACHE_LIMIT;
         fCacheCount = 0;
         fCacheCountLimit = SK_DEFAULT_FONT_CACHE_COUNT_LIMIT;
+        fHits = 0;
+        fMisses = 0;
+        fEvictions = 0;
     }
 
     ~SkGlyphCache_Globals() {
@@ -70,6 +80,17 @@ public:
     }
 
     void purgeAll(); // does not change budget
+    // Purges the least recently used strikes until at most fraction (0..1) of the memory used is
+    // left. Does not change budget.
+    void purgeToFraction(float fraction);
+
+    // Strike lookups, counted by VisitCache() without holding fLock.
+    void countHit()  { sk_atomic_fetch_add<int64_t>(&fHits, 1, sk_memory_order_relaxed); }
+    void countMiss() { sk_atomic_fetch_add<int64_t>(&fMisses, 1, sk_memory_order_relaxed); }
+    int64_t hits() const { return sk_atomic_load(&fHits, sk_memory_order_relaxed); }
+    int64_t misses() const { return sk_atomic_load(&fMisses, sk_memory_order_relaxed); }
+    // Strikes deleted by internalPurge(). Only access while holding fLock.
+    int64_t evictions() const { return fEvictions; }
 
     // call when a glyphcache is available for caching (i.e. not in use)
     void attachCacheToHead(SkGlyphCache*);
@@ -84,6 +105,9 @@ private:
     size_t  fCacheSizeLimit;
     int32_t fCacheCountLimit;
     int32_t fCacheCount;
+    int64_t fHits;
+    int64_t fMisses;
+    int64_t fEvictions;
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
     // and attempt to purge caches to match.
@@ -91,4 +115,49 @@ private:
     size_t internalPurge(size_t minBytesNeeded = 0);
 };
 
+/**
+ *  A per-thread front-end to SkGlyphCache_Globals.
+ *
+ *  When a thread has a non-zero TLS font cache limit, strikes it attaches are parked here
+ *  instead of on the global list, and its next VisitCache() with the same descriptor finds them
+ *  again without touching SkGlyphCache_Globals::fLock.  Threads drawing the same typeface and
+ *  size then stop fighting over the global lock and over the same detached strike.
+ *
+ *  Strikes evicted from here, or left here when the thread exits, go back to the global cache.
+ *  Parked strikes don't count against the global budget; each thread bounds its own.
+ */
+class SkGlyphCache_TLS {
+public:
+    SkGlyphCache_TLS() : fHead(NULL), fCount(0), fLimit(SK_DEFAULT_TLS_FONT_CACHE_LIMIT) {}
+    ~SkGlyphCache_TLS() { this->purgeAll(); }
+
+    // Returns this thread's front-end, creating it if needed.
+    static SkGlyphCache_TLS* Get();
+    // Returns this thread's front-end if it has one (or would get one by default), else NULL.
+    static SkGlyphCache_TLS* Find();
+
+    // Removes and returns a parked strike matching desc, or NULL.
+    SkGlyphCache* detach(const SkDescriptor& desc);
+
+    // Parks cache as the most recently used strike.  Returns false (leaving cache untouched)
+    // if this thread has no TLS budget.
+    bool attach(SkGlyphCache* cache);
+
+    size_t getLimit() const { return fLimit; }
+    void setLimit(size_t limit);
+
+    // Returns all parked strikes to the global cache.
+    void purgeAll();
+
+private:
+    static const int kMaxCount = 16;
+
+    void unlink(SkGlyphCache*);
+    void trim();
+
+    SkGlyphCache* fHead;    // MRU order, linked through fNext/fPrev.
+    int           fCount;
+    size_t        fLimit;
+};
+
 #endif
@@ -11,6 +11,8 @@
 
 #include "SkBlitter.h"
 #include "SkCanvas.h"
+#include "SkFlattenable.h"
+#include "SkFontMgr.h"
 #include "SkGeometry.h"
 #include "SkMath.h"
 #include "SkMatrix.h"
@@ -24,7 +26,9 @@
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkTSearch.h"
+#include "SkThreadUtils.h"
 #include "SkTime.h"
+#include "SkTypeface.h"
 #include "SkUtils.h"
 #include "SkXfermode.h"
 
@@ -54,7 +58,44 @@ void SkGraphics::Init() {
 #endif
 }
 
+static void warm_up(void*) {
+    // Any factory lookup registers all of the flattenables first.
+    (void)SkFlattenable::NameToFactory("");
+    SkAutoTUnref<SkFontMgr> fontMgr(SkFontMgr::RefDefault());
+    SkAutoTUnref<SkTypeface> typeface(SkTypeface::RefDefault());
+}
+
+SK_DECLARE_STATIC_MUTEX(gWarmUpMutex);
+static SkThread* gWarmUpThread;
+
+void SkGraphics::WarmUp() {
+    SkAutoMutexAcquire ama(gWarmUpMutex);
+    if (gWarmUpThread) {
+        return;
+    }
+    gWarmUpThread = SkNEW_ARGS(SkThread, (warm_up));
+    if (!gWarmUpThread->start()) {
+        // Couldn't get a thread, so do the work now rather than not at all.
+        warm_up(NULL);
+    }
+}
+
+static void finish_warm_up() {
+    SkAutoMutexAcquire ama(gWarmUpMutex);
+    if (gWarmUpThread) {
+        gWarmUpThread->join();
+        SkDELETE(gWarmUpThread);
+        gWarmUpThread = NULL;
+    }
+}
+
+void SkGraphics::PurgeToFraction(float fraction) {
+    PurgeFontCacheToFraction(fraction);
+    PurgeResourceCacheToFraction(fraction);
+}
+
 void SkGraphics::Term() {
+    finish_warm_up();
     PurgeFontCache();
     PurgeResourceCache();
     SkPaint::Term();
@@ -8,6 +8,8 @@
 #ifndef SkHalf_DEFINED
 #define SkHalf_DEFINED
 
+#include "SkColorPriv.h"
+#include "SkNx.h"
 #include "SkTypes.h"
 
 // 16-bit floating point value
@@ -23,4 +25,99 @@ typedef uint16_t SkHalf;
 float SkHalfToFloat(SkHalf h);
 SkHalf SkFloatToHalf(float f);
 
+// Convert between four halfs packed in R,G,B,A memory order (as in kRGBA_F16_SkColorType) and
+// an Sk4f holding the same components in SkPMColor order (as in SkPMFloat). These only handle
+// finite, non-negative values, which covers premultiplied colors: SkPMFloatToHalf clamps its
+// input to [0, 65504] and both flush NaN to 0.
+static inline Sk4f SkHalfToPMFloat(uint64_t rgba);
+static inline uint64_t SkPMFloatToHalf(const Sk4f& pm);
+
+// A non-negative half's bits, shifted into a float's exponent and mantissa, are the same value
+// scaled by 2^-112 (the difference between the exponent biases). This holds for denormals too.
+#define SK_HalfToFloatScale 5.192296858534828e+33f  // 2^112
+#define SK_FloatToHalfScale 1.925929944387236e-34f  // 2^-112
+
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+static inline Sk4f SkHalfToPMFloat(uint64_t rgba) {
+    __m128i h = _mm_loadl_epi64((const __m128i*)&rgba);
+#ifndef SK_PMCOLOR_IS_RGBA
+    h = _mm_shufflelo_epi16(h, _MM_SHUFFLE(3,0,1,2));  // RGBA -> BGRA
+#endif
+    __m128i bits = _mm_slli_epi32(_mm_unpacklo_epi16(h, _mm_setzero_si128()), 13);
+    return Sk4f(_mm_castsi128_ps(bits)) * Sk4f(SK_HalfToFloatScale);
+}
+
+static inline uint64_t SkPMFloatToHalf(const Sk4f& pm) {
+    Sk4f scaled = Sk4f::Min(Sk4f::Max(pm, Sk4f(0)), Sk4f(65504.0f)) * Sk4f(SK_FloatToHalfScale);
+    // Round to nearest before dropping the 13 low mantissa bits.
+    __m128i bits = _mm_add_epi32(_mm_castps_si128(scaled.fVec), _mm_set1_epi32(0x1000));
+    bits = _mm_srli_epi32(bits, 13);
+    __m128i h = _mm_packs_epi32(bits, bits);  // No saturation, every value is <= 0x7bff.
+#ifndef SK_PMCOLOR_IS_RGBA
+    h = _mm_shufflelo_epi16(h, _MM_SHUFFLE(3,0,1,2));  // BGRA -> RGBA
+#endif
+    uint64_t rgba;
+    _mm_storel_epi64((__m128i*)&rgba, h);
+    return rgba;
+}
+
+#elif !defined(SKNX_NO_SIMD) && defined(SK_ARM_HAS_NEON)
+
+#ifndef SK_PMCOLOR_IS_RGBA
+static inline uint16x4_t sk_swap_rb_u16(uint16x4_t h) {
+    static const uint8_t kSwapRB[] = { 4,5, 2,3, 0,1, 6,7 };
+    return vreinterpret_u16_u8(vtbl1_u8(vreinterpret_u8_u16(h), vld1_u8(kSwapRB)));
+}
+#endif
+
+static inline Sk4f SkHalfToPMFloat(uint64_t rgba) {
+    uint16x4_t h = vcreate_u16(rgba);
+#ifndef SK_PMCOLOR_IS_RGBA
+    h = sk_swap_rb_u16(h);
+#endif
+    uint32x4_t bits = vshlq_n_u32(vmovl_u16(h), 13);
+    return Sk4f(vreinterpretq_f32_u32(bits)) * Sk4f(SK_HalfToFloatScale);
+}
+
+static inline uint64_t SkPMFloatToHalf(const Sk4f& pm) {
+    Sk4f scaled = Sk4f::Min(Sk4f::Max(pm, Sk4f(0)), Sk4f(65504.0f)) * Sk4f(SK_FloatToHalfScale);
+    // Round to nearest before dropping the 13 low mantissa bits.
+    uint32x4_t bits = vaddq_u32(vreinterpretq_u32_f32(scaled.fVec), vdupq_n_u32(0x1000));
+    uint16x4_t h = vmovn_u32(vshrq_n_u32(bits, 13));
+#ifndef SK_PMCOLOR_IS_RGBA
+    h = sk_swap_rb_u16(h);
+#endif
+    return vget_lane_u64(vreinterpret_u64_u16(h), 0);
+}
+
+#else
+
+static inline Sk4f SkHalfToPMFloat(uint64_t rgba) {
+    float r = SkHalfToFloat((SkHalf)(rgba >>  0)),
+          g = SkHalfToFloat((SkHalf)(rgba >> 16)),
+          b = SkHalfToFloat((SkHalf)(rgba >> 32)),
+          a = SkHalfToFloat((SkHalf)(rgba >> 48));
+#ifdef SK_PMCOLOR_IS_RGBA
+    return Sk4f(r, g, b, a);
+#else
+    return Sk4f(b, g, r, a);
+#endif
+}
+
+static inline uint64_t SkPMFloatToHalf(const Sk4f& pm) {
+    Sk4f clamped = Sk4f::Min(Sk4f::Max(pm, Sk4f(0)), Sk4f(65504.0f));
+    float c[4];
+    clamped.store(c);
+#ifndef SK_PMCOLOR_IS_RGBA
+    SkTSwap(c[0], c[2]);
+#endif
+    return (uint64_t)SkFloatToHalf(c[0]) <<  0 |
+           (uint64_t)SkFloatToHalf(c[1]) << 16 |
+           (uint64_t)SkFloatToHalf(c[2]) << 32 |
+           (uint64_t)SkFloatToHalf(c[3]) << 48;
+}
+
+#endif
+
 #endif
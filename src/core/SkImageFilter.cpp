@@ -16,7 +16,9 @@
 #include "SkMutex.h"
 #include "SkReadBuffer.h"
 #include "SkRect.h"
+#include "SkTaskGroup.h"
 #include "SkTDynamicHash.h"
+#include "SkTHash.h"
 #include "SkTInternalLList.h"
 #include "SkValidationUtils.h"
 #include "SkWriteBuffer.h"
@@ -102,6 +104,60 @@ static int32_t next_image_filter_unique_id() {
     return id;
 }
 
+namespace {
+
+// Interns flattened filter graphs, handing out IDs from the unique ID space so that content IDs
+// and unique IDs never collide in cache keys. The flattened bytes are kept so that equal IDs
+// mean equal graphs, not just equal hashes; past kMaxContentBytes the table starts over, which
+// only costs later filters a miss.
+class ContentIDTable {
+public:
+    ContentIDTable() : fBytes(0) {}
+
+    uint32_t find(const SkString& content) {
+        SkAutoMutexAcquire lock(fMutex);
+        if (uint32_t* id = fIDs.find(content)) {
+            return *id;
+        }
+        if (fBytes + content.size() > kMaxContentBytes) {
+            fIDs.reset();
+            fBytes = 0;
+        }
+        fBytes += content.size();
+        return *fIDs.set(content, next_image_filter_unique_id());
+    }
+
+private:
+    static const size_t kMaxContentBytes = 4 * 1024 * 1024;
+
+    static uint32_t Hash(const SkString& content) {
+        return SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(content.c_str()),
+                                   content.size());
+    }
+
+    SkMutex                              fMutex;
+    SkTHashMap<SkString, uint32_t, Hash> fIDs;
+    size_t                               fBytes;
+};
+
+} // namespace
+
+SK_DECLARE_STATIC_LAZY_PTR(ContentIDTable, content_ids);
+
+uint32_t SkImageFilter::contentID() const {
+    uint32_t id = sk_atomic_load(&fContentID, sk_memory_order_relaxed);
+    if (0 == id) {
+        SkWriteBuffer buffer;
+        buffer.writeFlattenable(this);
+        SkString content(buffer.bytesWritten());
+        buffer.writeToMemory(content.writable_str());
+        // Racing threads intern the same bytes, so they agree on the ID.
+        id = content_ids.get()->find(content);
+        sk_atomic_store(&fContentID, id, sk_memory_order_relaxed);
+    }
+    return id;
+}
+
 struct SkImageFilter::Cache::Key {
     Key(const uint32_t uniqueID, const SkMatrix& matrix, const SkIRect& clipBounds, uint32_t srcGenID)
       : fUniqueID(uniqueID), fMatrix(matrix), fClipBounds(clipBounds), fSrcGenID(srcGenID) {
@@ -180,7 +236,8 @@ SkImageFilter::SkImageFilter(int inputCount, SkImageFilter** inputs, const CropR
     fInputs(new SkImageFilter*[inputCount]),
     fUsesSrcInput(false),
     fCropRect(cropRect ? *cropRect : CropRect(SkRect(), 0x0)),
-    fUniqueID(next_image_filter_unique_id()) {
+    fUniqueID(next_image_filter_unique_id()),
+    fContentID(0) {
     for (int i = 0; i < inputCount; ++i) {
         if (NULL == inputs[i] || inputs[i]->usesSrcInput()) {
             fUsesSrcInput = true;
@@ -199,7 +256,8 @@ SkImageFilter::~SkImageFilter() {
 
 SkImageFilter::SkImageFilter(int inputCount, SkReadBuffer& buffer)
   : fUsesSrcInput(false)
-  , fUniqueID(next_image_filter_unique_id()) {
+  , fUniqueID(next_image_filter_unique_id())
+  , fContentID(0) {
     Common common;
     if (common.unflatten(buffer, inputCount)) {
         fCropRect = common.cropRect();
@@ -230,13 +288,22 @@ void SkImageFilter::flatten(SkWriteBuffer& buffer) const {
     buffer.writeUInt(fCropRect.flags());
 }
 
+SkImageFilter::Cache::Key SkImageFilter::cacheKey(const SkBitmap& src,
+                                                  const Context& context) const {
+    uint32_t srcGenID = fUsesSrcInput ? src.getGenerationID() : 0;
+    uint32_t filterID = fUniqueID;
+    if (context.cache() && Cache::kContent_KeyMode == context.cache()->keyMode()) {
+        filterID = this->contentID();
+    }
+    return Cache::Key(filterID, context.ctm(), context.clipBounds(), srcGenID);
+}
+
 bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
                                 const Context& context,
                                 SkBitmap* result, SkIPoint* offset) const {
     SkASSERT(result);
     SkASSERT(offset);
-    uint32_t srcGenID = fUsesSrcInput ? src.getGenerationID() : 0;
-    Cache::Key key(fUniqueID, context.ctm(), context.clipBounds(), srcGenID);
+    const Cache::Key key = this->cacheKey(src, context);
     if (context.cache()) {
         if (context.cache()->get(key, result, offset)) {
             return true;
@@ -256,6 +323,90 @@ bool SkImageFilter::filterImage(Proxy* proxy, const SkBitmap& src,
     return false;
 }
 
+// Tiles smaller than this aren't worth the overlap they recompute.
+static const int kMinFilterTileSize = 64;
+
+bool SkImageFilter::filterImageTiled(Proxy* proxy, const SkBitmap& src, const Context& context,
+                                     size_t tileBudget, SkBitmap* result,
+                                     SkIPoint* offset) const {
+    SkASSERT(result);
+    SkASSERT(offset);
+    SkIRect srcBounds, bounds;
+    src.getBounds(&srcBounds);
+    if (!this->filterBounds(srcBounds, context.ctm(), &bounds) ||
+        !bounds.intersect(context.clipBounds())) {
+        return this->filterImage(proxy, src, context, result, offset);
+    }
+
+    // How far an output pixel can read from, in any direction.
+    const SkIRect probe = SkIRect::MakeXYWH(bounds.fLeft, bounds.fTop, 1, 1);
+    SkIRect reach;
+    if (!this->filterBounds(probe, context.ctm(), &reach)) {
+        return this->filterImage(proxy, src, context, result, offset);
+    }
+    const int margin = SkTMax(SkTMax(SkAbs32(probe.fLeft - reach.fLeft),
+                                     SkAbs32(probe.fTop - reach.fTop)),
+                              SkTMax(SkAbs32(reach.fRight - probe.fRight),
+                                     SkAbs32(reach.fBottom - probe.fBottom)));
+
+    const int tileSize = SkScalarFloorToInt(SkScalarSqrt(SkIntToScalar(tileBudget) /
+                                                         sizeof(SkPMColor))) - 2 * margin;
+    if (tileSize < kMinFilterTileSize ||
+        (bounds.width() <= tileSize && bounds.height() <= tileSize)) {
+        return this->filterImage(proxy, src, context, result, offset);
+    }
+
+    SkBitmap dst;
+    if (!dst.tryAllocPixels(SkImageInfo::MakeN32Premul(bounds.width(), bounds.height()))) {
+        return false;
+    }
+    dst.eraseColor(SK_ColorTRANSPARENT);
+
+    const int tilesX = (bounds.width() + tileSize - 1) / tileSize,
+              tilesY = (bounds.height() + tileSize - 1) / tileSize;
+    SkAutoTMalloc<bool> tileOK(tilesX * tilesY);
+    sk_parallel_for(tilesX * tilesY, [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH(bounds.fLeft + (i % tilesX) * tileSize,
+                                         bounds.fTop + (i / tilesX) * tileSize,
+                                         tileSize, tileSize);
+        tile.intersect(bounds);
+        SkIRect request = tile.makeOutset(margin, margin);
+        request.intersect(context.clipBounds());
+
+        // Tiles don't share the cache: their entries would never be found again.
+        Context tileContext(context.ctm(), request, NULL);
+        SkBitmap tileResult;
+        SkIPoint tileOffset = SkIPoint::Make(0, 0);
+        tileOK[i] = this->filterImage(proxy, src, tileContext, &tileResult, &tileOffset) &&
+                    kN32_SkColorType == tileResult.colorType();
+        if (!tileOK[i]) {
+            return;
+        }
+
+        SkAutoLockPixels alp(tileResult);
+        SkIRect copy = SkIRect::MakeXYWH(tileOffset.x(), tileOffset.y(),
+                                         tileResult.width(), tileResult.height());
+        if (!tileResult.getPixels()) {
+            tileOK[i] = false;
+        } else if (copy.intersect(tile)) {
+            for (int y = copy.fTop; y < copy.fBottom; ++y) {
+                memcpy(dst.getAddr32(copy.fLeft - bounds.fLeft, y - bounds.fTop),
+                       tileResult.getAddr32(copy.fLeft - tileOffset.x(), y - tileOffset.y()),
+                       copy.width() * sizeof(SkPMColor));
+            }
+        }
+    });
+
+    for (int i = 0; i < tilesX * tilesY; ++i) {
+        if (!tileOK[i]) {
+            return this->filterImage(proxy, src, context, result, offset);
+        }
+    }
+    result->swap(dst);
+    *offset = SkIPoint::Make(bounds.fLeft, bounds.fTop);
+    return true;
+}
+
 bool SkImageFilter::filterBounds(const SkIRect& src, const SkMatrix& ctm,
                                  SkIRect* dst) const {
     SkASSERT(dst);
@@ -439,7 +590,19 @@ bool SkImageFilter::getInputResultGPU(SkImageFilter::Proxy* proxy,
     GrContext* context = src.getTexture()->getContext();
 
     if (this->canFilterImageGPU()) {
-        return this->filterImageGPU(proxy, src, ctx, result, offset);
+        // Share the cache with filterImage(), so that an unchanged input (e.g. the displacement
+        // map of an SkDisplacementMapEffect) isn't re-rendered on every frame.
+        const Cache::Key key = this->cacheKey(src, ctx);
+        if (ctx.cache() && ctx.cache()->get(key, result, offset)) {
+            return true;
+        }
+        if (!this->filterImageGPU(proxy, src, ctx, result, offset)) {
+            return false;
+        }
+        if (ctx.cache()) {
+            ctx.cache()->set(key, *result, *offset);
+        }
+        return true;
     } else {
         if (this->filterImage(proxy, src, ctx, result, offset)) {
             if (!result->getTexture()) {
@@ -462,7 +625,12 @@ namespace {
 
 class CacheImpl : public SkImageFilter::Cache {
 public:
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) {
+    CacheImpl(size_t maxBytes)
+        : fMaxBytes(maxBytes)
+        , fCurrentBytes(0)
+        , fKeyMode(kUniqueID_KeyMode)
+        , fHits(0)
+        , fMisses(0) {
     }
     virtual ~CacheImpl() {
         SkTDynamicHash<Value, Key>::Iter iter(&fLookup);
@@ -496,8 +664,10 @@ public:
                 fLRU.remove(v);
                 fLRU.addToHead(v);
             }
+            fHits++;
             return true;
         }
+        fMisses++;
         return false;
     }
     void set(const Key& key, const SkBitmap& result, const SkIPoint& offset) override {
@@ -528,6 +698,27 @@ public:
         }
     }
 
+    KeyMode keyMode() const override {
+        return (KeyMode)sk_atomic_load(&fKeyMode, sk_memory_order_relaxed);
+    }
+
+    void setKeyMode(KeyMode mode) override {
+        sk_atomic_store(&fKeyMode, (int32_t)mode, sk_memory_order_relaxed);
+    }
+
+    void getStats(Stats* stats) const override {
+        SkAutoMutexAcquire mutex(fMutex);
+        stats->fHits = fHits;
+        stats->fMisses = fMisses;
+        stats->fCount = fLookup.count();
+        stats->fBytes = fCurrentBytes;
+    }
+
+    void resetStats() override {
+        SkAutoMutexAcquire mutex(fMutex);
+        fHits = fMisses = 0;
+    }
+
 private:
     void removeInternal(Value* v) {
         fCurrentBytes -= v->fBitmap.getSize();
@@ -540,6 +731,10 @@ private:
     mutable SkTInternalLList<Value>    fLRU;
     size_t                             fMaxBytes;
     size_t                             fCurrentBytes;
+    // Both modes draw IDs from the same space, so switching modes never confuses old entries.
+    int32_t                            fKeyMode;
+    mutable int                        fHits;
+    mutable int                        fMisses;
     mutable SkMutex                    fMutex;
 };
 
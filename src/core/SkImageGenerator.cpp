@@ -46,6 +46,28 @@ bool SkImageGenerator::getPixels(const SkImageInfo& info, void* pixels, size_t r
     return this->getPixels(info, pixels, rowBytes, NULL, NULL);
 }
 
+bool SkImageGenerator::tryGenerateBitmap(SkBitmap* bitmap, const SkImageInfo* infoPtr,
+                                         SkBitmap::Allocator* allocator) {
+    const SkImageInfo info = infoPtr ? *infoPtr : this->getInfo();
+    if (kIndex_8_SkColorType == info.colorType() || !bitmap->setInfo(info)) {
+        bitmap->reset();
+        return false;
+    }
+    if (!bitmap->tryAllocPixels(allocator, NULL)) {
+        bitmap->reset();
+        return false;
+    }
+
+    SkAutoLockPixels alp(*bitmap);
+    if (!bitmap->getPixels() ||
+        !this->getPixels(bitmap->info(), bitmap->getPixels(), bitmap->rowBytes())) {
+        bitmap->reset();
+        return false;
+    }
+    bitmap->setImmutable();
+    return true;
+}
+
 bool SkImageGenerator::getYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
                                      SkYUVColorSpace* colorSpace) {
 #ifdef SK_DEBUG
@@ -104,6 +126,10 @@ SkData* SkImageGenerator::onRefEncodedData() {
     return NULL;
 }
 
+SkISize SkImageGenerator::onGetScaledDimensions(SkScalar) {
+    return SkISize::Make(fInfo.width(), fInfo.height());
+}
+
 bool SkImageGenerator::onGetPixels(const SkImageInfo& info, void* dst, size_t rb,
                                    SkPMColor* colors, int* colorCount) {
     return false;
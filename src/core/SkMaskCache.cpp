@@ -53,6 +53,7 @@ struct RRectBlurRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "mask"; }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
         const RRectBlurRec& rec = static_cast<const RRectBlurRec&>(baseRec);
@@ -144,6 +145,7 @@ struct RectsBlurRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "mask"; }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
         const RectsBlurRec& rec = static_cast<const RectsBlurRec&>(baseRec);
@@ -181,3 +183,94 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
     RectsBlurKey key(sigma, style, quality, rects, count);
     return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(RectsBlurRec, (key, mask, data)));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathBlurKeyNamespaceLabel;
+
+struct PathBlurKey : public SkResourceCache::Key {
+public:
+    PathBlurKey(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                uint32_t pathGenID, SkPath::FillType fillType, const SkMatrix& matrix)
+        : fSigma(sigma)
+        , fStyle(style)
+        , fQuality(quality)
+        , fFillType(fillType)
+    {
+        SkASSERT(!matrix.hasPerspective());
+        fMatrix[0] = matrix.getScaleX();
+        fMatrix[1] = matrix.getSkewX();
+        fMatrix[2] = matrix.getTranslateX();
+        fMatrix[3] = matrix.getSkewY();
+        fMatrix[4] = matrix.getScaleY();
+        fMatrix[5] = matrix.getTranslateY();
+
+        this->init(&gPathBlurKeyNamespaceLabel, pathGenID,
+                   sizeof(fSigma) + sizeof(fStyle) + sizeof(fQuality) + sizeof(fFillType) +
+                   sizeof(fMatrix));
+    }
+
+    SkScalar    fSigma;
+    int32_t     fStyle;
+    int32_t     fQuality;
+    int32_t     fFillType;
+    SkScalar    fMatrix[6];
+};
+
+struct PathBlurRec : public SkResourceCache::Rec {
+    PathBlurRec(PathBlurKey key, const SkMask& mask, SkCachedData* data)
+        : fKey(key)
+    {
+        fValue.fMask = mask;
+        fValue.fData = data;
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PathBlurRec() {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PathBlurKey    fKey;
+    MaskValue      fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "mask"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathBlurRec& rec = static_cast<const PathBlurRec&>(baseRec);
+        MaskValue* result = static_cast<MaskValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (NULL == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                      uint32_t pathGenID, SkPath::FillType fillType,
+                                      const SkMatrix& matrix, SkMask* mask,
+                                      SkResourceCache* localCache) {
+    MaskValue result;
+    PathBlurKey key(sigma, style, quality, pathGenID, fillType, matrix);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathBlurRec::Visitor, &result)) {
+        return NULL;
+    }
+
+    *mask = result.fMask;
+    mask->fImage = (uint8_t*)(result.fData->data());
+    return result.fData;
+}
+
+void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                      uint32_t pathGenID, SkPath::FillType fillType, const SkMatrix& matrix,
+                      const SkMask& mask, SkCachedData* data, SkResourceCache* localCache) {
+    PathBlurKey key(sigma, style, quality, pathGenID, fillType, matrix);
+    return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(PathBlurRec, (key, mask, data)));
+}
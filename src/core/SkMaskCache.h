@@ -11,6 +11,8 @@
 #include "SkBlurTypes.h"
 #include "SkCachedData.h"
 #include "SkMask.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
 #include "SkRect.h"
 #include "SkResourceCache.h"
 #include "SkRRect.h"
@@ -29,6 +31,15 @@ public:
     static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                                     const SkRect rects[], int count, SkMask* mask,
                                     SkResourceCache* localCache = NULL);
+    /**
+     * Path masks are keyed by the source path's generation ID and fill type, and by the matrix
+     * that took it to device space. The caller removes the matrix's integer translation and
+     * stores the mask relative to it, so the entry can be reused wherever the path is drawn.
+     */
+    static SkCachedData* FindAndRef(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                                    uint32_t pathGenID, SkPath::FillType fillType,
+                                    const SkMatrix& matrix, SkMask* mask,
+                                    SkResourceCache* localCache = NULL);
 
     /**
      * Add a mask and its pixel-data to the cache.
@@ -39,6 +50,10 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = NULL);
+    static void Add(SkScalar sigma, SkBlurStyle style, SkBlurQuality quality,
+                    uint32_t pathGenID, SkPath::FillType fillType, const SkMatrix& matrix,
+                    const SkMask& mask, SkCachedData* data,
+                    SkResourceCache* localCache = NULL);
 };
 
 #endif
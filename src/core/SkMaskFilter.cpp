@@ -235,7 +235,8 @@ bool SkMaskFilter::filterRRect(const SkRRect& devRRect, const SkMatrix& matrix,
 
 bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
                               const SkRasterClip& clip, SkBlitter* blitter,
-                              SkPaint::Style style) const {
+                              SkPaint::Style style, uint32_t srcGenID,
+                              const SkMatrix& srcToDev) const {
     SkRect rects[2];
     int rectCount = 0;
     if (SkPaint::kFill_Style == style) {
@@ -261,19 +262,15 @@ bool SkMaskFilter::filterPath(const SkPath& devPath, const SkMatrix& matrix,
         }
     }
 
-    SkMask  srcM, dstM;
-
-    if (!SkDraw::DrawToMask(devPath, &clip.getBounds(), this, &matrix, &srcM,
-                            SkMask::kComputeBoundsAndRenderImage_CreateMode,
-                            style)) {
-        return false;
-    }
-    SkAutoMaskFreeImage autoSrc(srcM.fImage);
+    SkMask          dstM;
+    SkCachedData*   data;
 
-    if (!this->filterMask(&dstM, srcM, matrix, NULL)) {
+    if (!SkDraw::DrawToFilteredMask(devPath, srcGenID, srcToDev, clip.getBounds(), this, matrix,
+                                    &dstM, &data, style)) {
         return false;
     }
-    SkAutoMaskFreeImage autoDst(dstM.fImage);
+    SkAutoTUnref<SkCachedData> cache(data);
+    SkAutoMaskFreeImage autoDst(data ? NULL : dstM.fImage);
 
     // if we get here, we need to (possibly) resolve the clip and blitter
     SkAAClipBlitterWrapper wrapper(clip, blitter);
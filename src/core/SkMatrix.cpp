@@ -9,7 +9,7 @@
 #include "SkFloatBits.h"
 #include "SkRSXform.h"
 #include "SkString.h"
-#include "SkNx.h"
+#include "SkOpts.h"
 
 #include <stddef.h>
 
@@ -909,68 +909,22 @@ void SkMatrix::Identity_pts(const SkMatrix& m, SkPoint dst[], const SkPoint src[
 void SkMatrix::Trans_pts(const SkMatrix& m, SkPoint dst[], const SkPoint src[], int count) {
     SkASSERT(m.getType() <= kTranslate_Mask);
 
-    if (count > 0) {
-        SkScalar tx = m.getTranslateX();
-        SkScalar ty = m.getTranslateY();
-        if (count & 1) {
-            dst->fX = src->fX + tx;
-            dst->fY = src->fY + ty;
-            src += 1;
-            dst += 1;
-        }
-        Sk4s trans4(tx, ty, tx, ty);
-        count >>= 1;
-        if (count & 1) {
-            (Sk4s::Load(&src->fX) + trans4).store(&dst->fX);
-            src += 2;
-            dst += 2;
-        }
-        count >>= 1;
-        for (int i = 0; i < count; ++i) {
-            (Sk4s::Load(&src[0].fX) + trans4).store(&dst[0].fX);
-            (Sk4s::Load(&src[2].fX) + trans4).store(&dst[2].fX);
-            src += 4;
-            dst += 4;
-        }
-    }
+    SkOpts::matrix_translate(dst, src, count, m.fMat);
 }
 
 void SkMatrix::Scale_pts(const SkMatrix& m, SkPoint dst[], const SkPoint src[], int count) {
     SkASSERT(m.getType() <= (kScale_Mask | kTranslate_Mask));
 
-    if (count > 0) {
-        SkScalar tx = m.getTranslateX();
-        SkScalar ty = m.getTranslateY();
-        SkScalar sx = m.getScaleX();
-        SkScalar sy = m.getScaleY();
-        if (count & 1) {
-            dst->fX = src->fX * sx + tx;
-            dst->fY = src->fY * sy + ty;
-            src += 1;
-            dst += 1;
-        }
-        Sk4s trans4(tx, ty, tx, ty);
-        Sk4s scale4(sx, sy, sx, sy);
-        count >>= 1;
-        if (count & 1) {
-            (Sk4s::Load(&src->fX) * scale4 + trans4).store(&dst->fX);
-            src += 2;
-            dst += 2;
-        }
-        count >>= 1;
-        for (int i = 0; i < count; ++i) {
-            (Sk4s::Load(&src[0].fX) * scale4 + trans4).store(&dst[0].fX);
-            (Sk4s::Load(&src[2].fX) * scale4 + trans4).store(&dst[2].fX);
-            src += 4;
-            dst += 4;
-        }
-    }
+    SkOpts::matrix_scale_translate(dst, src, count, m.fMat);
 }
 
 void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
                          const SkPoint src[], int count) {
     SkASSERT(m.hasPerspective());
 
+#ifdef SK_LEGACY_MATRIX_MATH_ORDER
+    SkOpts::matrix_perspective(dst, src, count, m.fMat);
+#else
     if (count > 0) {
         do {
             SkScalar sy = src->fY;
@@ -979,11 +933,7 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
 
             SkScalar x = sdot(sx, m.fMat[kMScaleX], sy, m.fMat[kMSkewX])  + m.fMat[kMTransX];
             SkScalar y = sdot(sx, m.fMat[kMSkewY],  sy, m.fMat[kMScaleY]) + m.fMat[kMTransY];
-#ifdef SK_LEGACY_MATRIX_MATH_ORDER
-            SkScalar z = sx * m.fMat[kMPersp0] + (sy * m.fMat[kMPersp1] + m.fMat[kMPersp2]);
-#else
             SkScalar z = sdot(sx, m.fMat[kMPersp0], sy, m.fMat[kMPersp1]) + m.fMat[kMPersp2];
-#endif
             if (z) {
                 z = SkScalarFastInvert(z);
             }
@@ -993,36 +943,13 @@ void SkMatrix::Persp_pts(const SkMatrix& m, SkPoint dst[],
             dst += 1;
         } while (--count);
     }
+#endif
 }
 
 void SkMatrix::Affine_vpts(const SkMatrix& m, SkPoint dst[], const SkPoint src[], int count) {
     SkASSERT(m.getType() != kPerspective_Mask);
 
-    if (count > 0) {
-        SkScalar tx = m.getTranslateX();
-        SkScalar ty = m.getTranslateY();
-        SkScalar sx = m.getScaleX();
-        SkScalar sy = m.getScaleY();
-        SkScalar kx = m.getSkewX();
-        SkScalar ky = m.getSkewY();
-        if (count & 1) {
-            dst->set(src->fX * sx + src->fY * kx + tx,
-                     src->fX * ky + src->fY * sy + ty);
-            src += 1;
-            dst += 1;
-        }
-        Sk4s trans4(tx, ty, tx, ty);
-        Sk4s scale4(sx, sy, sx, sy);
-        Sk4s  skew4(kx, ky, kx, ky);    // applied to swizzle of src4
-        count >>= 1;
-        for (int i = 0; i < count; ++i) {
-            Sk4s src4 = Sk4s::Load(&src->fX);
-            Sk4s swz4(src[0].fY, src[0].fX, src[1].fY, src[1].fX);  // need ABCD -> BADC
-            (src4 * scale4 + swz4 * skew4 + trans4).store(&dst->fX);
-            src += 2;
-            dst += 2;
-        }
-    }
+    SkOpts::matrix_affine(dst, src, count, m.fMat);
 }
 
 const SkMatrix::MapPtsProc SkMatrix::gMapPtsProcs[] = {
@@ -24,16 +24,17 @@ public:
     int    approximateOpCount()   const override { return 0; }
     SkRect cullRect()             const override { return SkRect::MakeEmpty(); }
     bool   hasText()              const override { return false; }
-    int    numSlowPaths()         const override { return 0; }
     bool   willPlayBackBitmaps()  const override { return false; }
+    GpuCostFeatures gpuCostFeatures() const override { return GpuCostFeatures(); }
 };
 SK_DECLARE_STATIC_LAZY_PTR(SkEmptyPicture, gEmptyPicture);
 
 template <typename T>
 class SkMiniPicture final : public SkPicture {
 public:
-    SkMiniPicture(SkRect cull, T* op) : fCull(cull) {
+    SkMiniPicture(SkRect cull, T* op, const SkPaint& paint) : fCull(cull), fPaint(paint) {
         memcpy(&fOp, op, sizeof(fOp));  // We take ownership of op's guts.
+        fOp.paint = &fPaint;            // With no SkRecord to intern it, we keep the paint here.
     }
 
     void playback(SkCanvas* c, AbortCallback*) const override {
@@ -45,15 +46,16 @@ public:
     SkRect cullRect()             const override { return fCull; }
     bool   hasText()              const override { return SkTextHunter()(fOp); }
     bool   willPlayBackBitmaps()  const override { return SkBitmapHunter()(fOp); }
-    int    numSlowPaths()         const override {
+    GpuCostFeatures gpuCostFeatures() const override {
         SkPathCounter counter;
         counter(fOp);
-        return counter.fNumSlowPathsAndDashEffects;
+        return counter.fFeatures;
     }
 
 private:
-    SkRect fCull;
-    T      fOp;
+    SkRect  fCull;
+    SkPaint fPaint;
+    T       fOp;
 };
 
 
@@ -84,28 +86,32 @@ bool SkMiniRecorder::drawBitmapRect(const SkBitmap& bm, const SkRect* src, const
     if (!p) {
         p = defaultPaint.init();
     }
-    TRY_TO_STORE(DrawBitmapRectFixedSize, *p, bm, *src, dst, constraint);
+    TRY_TO_STORE(DrawBitmapRectFixedSize, fPaint.set(*p), bm, *src, dst, constraint);
 }
 
 bool SkMiniRecorder::drawRect(const SkRect& rect, const SkPaint& paint) {
-    TRY_TO_STORE(DrawRect, paint, rect);
+    TRY_TO_STORE(DrawRect, fPaint.set(paint), rect);
 }
 
 bool SkMiniRecorder::drawPath(const SkPath& path, const SkPaint& paint) {
-    TRY_TO_STORE(DrawPath, paint, path);
+    TRY_TO_STORE(DrawPath, fPaint.set(paint), path);
 }
 
 bool SkMiniRecorder::drawTextBlob(const SkTextBlob* b, SkScalar x, SkScalar y, const SkPaint& p) {
-    TRY_TO_STORE(DrawTextBlob, p, b, x, y);
+    TRY_TO_STORE(DrawTextBlob, fPaint.set(p), b, x, y);
 }
 #undef TRY_TO_STORE
 
 
 SkPicture* SkMiniRecorder::detachAsPicture(const SkRect& cull) {
-#define CASE(Type)               \
-    case State::k##Type:         \
-        fState = State::kEmpty;  \
-        return SkNEW_ARGS(SkMiniPicture<Type>, (cull, reinterpret_cast<Type*>(fBuffer.get())))
+#define CASE(Type)                                                                    \
+    case State::k##Type: {                                                            \
+        fState = State::kEmpty;                                                       \
+        SkPicture* picture = SkNEW_ARGS(SkMiniPicture<Type>,                          \
+                (cull, reinterpret_cast<Type*>(fBuffer.get()), *fPaint.get()));       \
+        fPaint.reset();                                                               \
+        return picture;                                                               \
+    }
 
     switch (fState) {
         case State::kEmpty: return SkRef(gEmptyPicture.get());
@@ -126,6 +132,7 @@ void SkMiniRecorder::flushAndReset(SkCanvas* canvas) {
         Type* op = reinterpret_cast<Type*>(fBuffer.get());          \
         SkRecords::Draw(canvas, nullptr, nullptr, 0, nullptr)(*op); \
         op->~Type();                                                \
+        fPaint.reset();                                             \
     } return
 
     switch (fState) {
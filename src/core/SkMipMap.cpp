@@ -8,95 +8,8 @@
 #include "SkMipMap.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
-
-static void downsample32_nocheck(void* dst, int, int, const void* srcPtr, const SkPixmap& srcPM) {
-    const uint32_t* p = static_cast<const uint32_t*>(srcPtr);
-    const uint32_t* baseP = p;
-    uint32_t c, ag, rb;
-
-    c = *p; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
-    p += 1;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    p = baseP;
-    p += srcPM.rowBytes() >> 2;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-    p += 1;
-
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    *(uint32_t*)dst = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
-}
-
-static void downsample32_check(void* dst, int x, int y, const void* srcPtr, const SkPixmap& srcPM) {
-    const uint32_t* p = static_cast<const uint32_t*>(srcPtr);
-    const uint32_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcPM.addr32(x, y) == p);
-
-    SkPMColor c, ag, rb;
-
-    c = *p; ag = (c >> 8) & 0xFF00FF; rb = c & 0xFF00FF;
-    if (x < srcPM.width() - 1) {
-        p += 1;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    p = baseP;
-    if (y < srcPM.height() - 1) {
-        p += srcPM.rowBytes() >> 2;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-    if (x < srcPM.width() - 1) {
-        p += 1;
-    }
-    c = *p; ag += (c >> 8) & 0xFF00FF; rb += c & 0xFF00FF;
-
-    *((uint32_t*)dst) = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
-}
-
-static inline uint32_t expand16(U16CPU c) {
-    return (c & ~SK_G16_MASK_IN_PLACE) | ((c & SK_G16_MASK_IN_PLACE) << 16);
-}
-
-// returns dirt in the top 16bits, but we don't care, since we only
-// store the low 16bits.
-static inline U16CPU pack16(uint32_t c) {
-    return (c & ~SK_G16_MASK_IN_PLACE) | ((c >> 16) & SK_G16_MASK_IN_PLACE);
-}
-
-static void downsample16(void* dst, int x, int y, const void* srcPtr, const SkPixmap& srcPM) {
-    const uint16_t* p = static_cast<const uint16_t*>(srcPtr);
-    const uint16_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcPM.addr16(x, y) == p);
-
-    SkPMColor c;
-
-    c = expand16(*p);
-    if (x < srcPM.width() - 1) {
-        p += 1;
-    }
-    c += expand16(*p);
-
-    p = baseP;
-    if (y < srcPM.height() - 1) {
-        p += srcPM.rowBytes() >> 1;
-    }
-    c += expand16(*p);
-    if (x < srcPM.width() - 1) {
-        p += 1;
-    }
-    c += expand16(*p);
-
-    *((uint16_t*)dst) = (uint16_t)pack16(c >> 2);
-}
+#include "SkOpts.h"
+#include "SkTaskGroup.h"
 
 static uint32_t expand4444(U16CPU c) {
     return (c & 0xF0F) | ((c & ~0xF0F) << 12);
@@ -106,67 +19,21 @@ static U16CPU collaps4444(uint32_t c) {
     return (c & 0xF0F) | ((c >> 12) & ~0xF0F);
 }
 
-static void downsample4444(void* dst, int x, int y, const void* srcPtr, const SkPixmap& srcPM) {
-    const uint16_t* p = static_cast<const uint16_t*>(srcPtr);
-    const uint16_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcPM.addr16(x, y) == p);
-
-    uint32_t c;
-
-    c = expand4444(*p);
-    if (x < srcPM.width() - 1) {
-        p += 1;
+static void downsample4444(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src);
+    const uint16_t* p1 = reinterpret_cast<const uint16_t*>((const char*)src + srcRowBytes);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+    for (int i = 0; i < count; i++) {
+        uint32_t c = expand4444(p0[0]) + expand4444(p0[1]) + expand4444(p1[0]) + expand4444(p1[1]);
+        *d++ = (uint16_t)collaps4444(c >> 2);
+        p0 += 2;
+        p1 += 2;
     }
-    c += expand4444(*p);
-
-    p = baseP;
-    if (y < srcPM.height() - 1) {
-        p += srcPM.rowBytes() >> 1;
-    }
-    c += expand4444(*p);
-    if (x < srcPM.width() - 1) {
-        p += 1;
-    }
-    c += expand4444(*p);
-
-   *((uint16_t*)dst) = (uint16_t)collaps4444(c >> 2);
 }
 
-static void downsample8_nocheck(void* dst, int, int, const void* srcPtr, const SkPixmap& srcPM) {
-    const size_t rb = srcPM.rowBytes();
-    const uint8_t* p = static_cast<const uint8_t*>(srcPtr);
-    *(uint8_t*)dst = (p[0] + p[1] + p[rb] + p[rb + 1]) >> 2;
-}
-
-static void downsample8_check(void* dst, int x, int y, const void* srcPtr, const SkPixmap& srcPM) {
-    const uint8_t* p = static_cast<const uint8_t*>(srcPtr);
-    const uint8_t* baseP = p;
-
-    x <<= 1;
-    y <<= 1;
-    SkASSERT(srcPM.addr8(x, y) == p);
-
-    unsigned c = *p;
-    if (x < srcPM.width() - 1) {
-        p += 1;
-    }
-    c += *p;
-
-    p = baseP;
-    if (y < srcPM.height() - 1) {
-        p += srcPM.rowBytes();
-    }
-    c += *p;
-    if (x < srcPM.width() - 1) {
-        p += 1;
-    }
-    c += *p;
-
-    *(uint8_t*)dst = c >> 2;
-}
+// Levels with at least this many pixels are built in parallel bands of kRowsPerBand rows.
+static const int kMinParallelPixels = 256 * 1024;
+static const int kRowsPerBand = 64;
 
 size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     if (levelCount < 0) {
@@ -179,31 +46,25 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return sk_64_asS32(size);
 }
 
-typedef void SkDownSampleProc(void*, int x, int y, const void* srcPtr, const SkPixmap& srcPM);
-
 SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
-    SkDownSampleProc* proc_nocheck, *proc_check;
+    SkOpts::Downsample proc;
 
     const SkColorType ct = src.colorType();
     const SkAlphaType at = src.alphaType();
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
-            proc_check = downsample32_check;
-            proc_nocheck = downsample32_nocheck;
+            proc = SkOpts::downsample_8888;
             break;
         case kRGB_565_SkColorType:
-            proc_check = downsample16;
-            proc_nocheck = proc_check;
+            proc = SkOpts::downsample_565;
             break;
         case kARGB_4444_SkColorType:
-            proc_check = downsample4444;
-            proc_nocheck = proc_check;
+            proc = downsample4444;
             break;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
-            proc_check = downsample8_check;
-            proc_nocheck = downsample8_nocheck;
+            proc = SkOpts::downsample_a8;
             break;
         default:
             return NULL; // don't build mipmaps for any other colortypes (yet)
@@ -280,35 +141,20 @@ SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
 
         SkPixmap dstPM(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
 
-        const int widthEven = width & ~1;
-        const int heightEven = height & ~1;
-        const size_t pixelSize = srcPM.info().bytesPerPixel();
-
-        const void* srcBasePtr = srcPM.addr();
-        void* dstBasePtr = dstPM.writable_addr();
-        for (int y = 0; y < heightEven; y++) {
-            const void* srcPtr = srcBasePtr;
-            void* dstPtr = dstBasePtr;
-            for (int x = 0; x < widthEven; x++) {
-                proc_nocheck(dstPtr, x, y, srcPtr, srcPM);
-                srcPtr = (char*)srcPtr + pixelSize * 2;
-                dstPtr = (char*)dstPtr + pixelSize;
-            }
-            if (width & 1) {
-                proc_check(dstPtr, widthEven, y, srcPtr, srcPM);
-            }
-
-            srcBasePtr = (char*)srcBasePtr + srcPM.rowBytes() * 2;
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
-        }
-        if (height & 1) {
-            const void* srcPtr = srcBasePtr;
-            void* dstPtr = dstBasePtr;
-            for (int x = 0; x < width; x++) {
-                proc_check(dstPtr, x, heightEven, srcPtr, srcPM);
-                srcPtr = (char*)srcPtr + pixelSize * 2;
-                dstPtr = (char*)dstPtr + pixelSize;
+        // Each destination pixel averages a full 2x2 block; an odd last source row or column
+        // is dropped.
+        auto downsampleRows = [&](int top, int bottom) {
+            for (int y = top; y < bottom; y++) {
+                proc(addr + y * rowBytes, srcPM.addr(0, 2 * y), srcPM.rowBytes(), width);
             }
+        };
+        if (width * height >= kMinParallelPixels) {
+            const int bands = (height + kRowsPerBand - 1) / kRowsPerBand;
+            sk_parallel_for(bands, [&](int i) {
+                downsampleRows(i * kRowsPerBand, SkTMin((i + 1) * kRowsPerBand, height));
+            });
+        } else {
+            downsampleRows(0, height);
         }
         srcPM = dstPM;
         addr += height * rowBytes;
@@ -10,8 +10,14 @@
 
 #define SK_OPTS_NS portable
 #include "SkBlurImageFilter_opts.h"
+#include "SkBlurMask_opts.h"
+#include "SkColorCubeFilter_opts.h"
+#include "SkColorMatrixFilter_opts.h"
 #include "SkFloatingPoint_opts.h"
+#include "SkMatrix_opts.h"
+#include "SkMipMap_opts.h"
 #include "SkMorphologyImageFilter_opts.h"
+#include "SkSwizzler_opts.h"
 #include "SkTextureCompressor_opts.h"
 #include "SkUtils_opts.h"
 #include "SkXfermode_opts.h"
@@ -20,10 +26,34 @@
     #if defined(SK_BUILD_FOR_WIN32)
         #include <intrin.h>
         static void cpuid(uint32_t abcd[4]) { __cpuid((int*)abcd, 1); }
+        static uint32_t cpuid_max() { int abcd[4]; __cpuid(abcd, 0); return abcd[0]; }
+        static void cpuid7(uint32_t abcd[4]) { __cpuidex((int*)abcd, 7, 0); }
+        static uint64_t xgetbv() { return _xgetbv(0); }
     #else
         #include <cpuid.h>
         static void cpuid(uint32_t abcd[4]) { __get_cpuid(1, abcd+0, abcd+1, abcd+2, abcd+3); }
+        static uint32_t cpuid_max() { return __get_cpuid_max(0, nullptr); }
+        static void cpuid7(uint32_t abcd[4]) {
+            __cpuid_count(7, 0, abcd[0], abcd[1], abcd[2], abcd[3]);
+        }
+        static uint64_t xgetbv() {
+            uint32_t eax, edx;
+            __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (uint64_t)edx << 32 | eax;
+        }
     #endif
+
+    // AVX2 needs the CPU to support it and the OS to save YMM registers across context switches.
+    static bool supports_avx2(const uint32_t abcd1[4]) {
+        const bool osxsave = abcd1[2] & (1<<27),
+                   avx     = abcd1[2] & (1<<28);
+        if (!osxsave || !avx || (xgetbv() & 6) != 6 || cpuid_max() < 7) {
+            return false;
+        }
+        uint32_t abcd7[] = {0,0,0,0};
+        cpuid7(abcd7);
+        return abcd7[1] & (1<<5);
+    }
 #elif !defined(SK_ARM_HAS_NEON) && defined(SK_CPU_ARM32) && defined(SK_BUILD_FOR_ANDROID)
     #include <cpu-features.h>
 #endif
@@ -50,12 +80,38 @@ namespace SkOpts {
     decltype(texture_compressor)       texture_compressor = portable::texture_compressor;
     decltype(fill_block_dimensions) fill_block_dimensions = portable::fill_block_dimensions;
 
+    decltype(RGBA_to_rgbA) RGBA_to_rgbA = portable::RGBA_to_rgbA;
+    decltype(RGBA_to_bgrA) RGBA_to_bgrA = portable::RGBA_to_bgrA;
+    decltype(RGBA_to_BGRA) RGBA_to_BGRA = portable::RGBA_to_BGRA;
+    decltype(rgbA_to_RGBA) rgbA_to_RGBA = portable::rgbA_to_RGBA;
+    decltype(rgbA_to_BGRA) rgbA_to_BGRA = portable::rgbA_to_BGRA;
+    decltype(RGB_to_RGB1)   RGB_to_RGB1 = portable::RGB_to_RGB1;
+    decltype(RGB_to_BGR1)   RGB_to_BGR1 = portable::RGB_to_BGR1;
+    decltype(gray_to_RGB1) gray_to_RGB1 = portable::gray_to_RGB1;
+    decltype(index_to_color) index_to_color = portable::index_to_color;
+
+    decltype(downsample_8888) downsample_8888 = portable::downsample_8888;
+    decltype(downsample_565)   downsample_565 = portable::downsample_565;
+    decltype(downsample_a8)     downsample_a8 = portable::downsample_a8;
+
+    decltype(blur_mask_row)               blur_mask_row = portable::blur_mask_row;
+    decltype(blur_mask_interp_row) blur_mask_interp_row = portable::blur_mask_interp_row;
+
+    decltype(color_matrix_filter_span) color_matrix_filter_span = portable::color_matrix_filter_span;
+    decltype(color_cube_filter_span)     color_cube_filter_span = portable::color_cube_filter_span;
+
+    decltype(matrix_translate)             matrix_translate = portable::matrix_translate;
+    decltype(matrix_scale_translate) matrix_scale_translate = portable::matrix_scale_translate;
+    decltype(matrix_affine)                   matrix_affine = portable::matrix_affine;
+    decltype(matrix_perspective)         matrix_perspective = portable::matrix_perspective;
+
     // Each Init_foo() is defined in src/opts/SkOpts_foo.cpp.
     void Init_sse2();
     void Init_ssse3();
     void Init_sse41();
+    void Init_avx2();
     void Init_neon();
-    //TODO: _dsp2, _armv7, _armv8, _x86, _x86_64, _sse42, _avx, avx2, ... ?
+    //TODO: _dsp2, _armv7, _armv8, _x86, _x86_64, _sse42, _avx, ... ?
 
     static void init() {
         // TODO: Chrome's not linking _sse* opts on iOS simulator builds.  Bug or feature?
@@ -65,6 +121,7 @@ namespace SkOpts {
         if (abcd[3] & (1<<26)) { Init_sse2(); }
         if (abcd[2] & (1<< 9)) { Init_ssse3(); }
         if (abcd[2] & (1<<19)) { Init_sse41(); }
+        if (supports_avx2(abcd)) { Init_avx2(); }
     #elif defined(SK_ARM_HAS_NEON)
         Init_neon();
     #elif defined(SK_CPU_ARM32) && defined(SK_BUILD_FOR_ANDROID)
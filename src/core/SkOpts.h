@@ -13,6 +13,7 @@
 #include "SkXfermode.h"
 
 struct ProcCoeff;
+struct SkPoint;
 
 namespace SkOpts {
     // Call to replace pointers to portable functions with pointers to CPU-specific functions.
@@ -43,6 +44,51 @@ namespace SkOpts {
     extern TextureCompressor (*texture_compressor)(SkColorType, SkTextureCompressor::Format);
     extern bool (*fill_block_dimensions)(SkTextureCompressor::Format, int* x, int* y);
 
+    // Swizzle count pixels from src into dst, naming bytes in memory order.  Procs that read
+    // alpha return the AND of every alpha in the high byte and the OR in the low byte.  They may
+    // be called in place, with dst == src.
+    typedef uint16_t (*Swizzle_8888)(uint32_t* dst, const uint8_t* src, int count);
+    extern Swizzle_8888 RGBA_to_rgbA,    // Premultiply, keeping byte order.
+                        RGBA_to_bgrA,    // Premultiply, swapping R and B.
+                        RGBA_to_BGRA,    // Swap R and B.
+                        rgbA_to_RGBA,    // Unpremultiply, keeping byte order.
+                        rgbA_to_BGRA;    // Unpremultiply, swapping R and B.
+
+    typedef void (*Swizzle_opaque)(uint32_t* dst, const uint8_t* src, int count);
+    extern Swizzle_opaque RGB_to_RGB1,   // 3 bytes per src pixel, alpha set to 0xFF.
+                          RGB_to_BGR1,   // Same, swapping R and B.
+                          gray_to_RGB1;  // 1 byte per src pixel.
+
+    // Looks up each src index in table, which may run to 256 entries.
+    extern uint16_t (*index_to_color)(uint32_t* dst, const uint8_t* src, int count,
+                                      const uint32_t table[]);
+
+    // Box filter count mipmap pixels from the 2x2 blocks of the two rows at src.
+    typedef void (*Downsample)(void* dst, const void* src, size_t srcRowBytes, int count);
+    extern Downsample downsample_8888, downsample_565, downsample_a8;
+
+    // Step a vertical box blur of an A8 mask down one row; see SkBlurMask_opts.h.
+    extern void (*blur_mask_row)(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                                 const uint8_t sub[], uint32_t scale, int count);
+    extern void (*blur_mask_interp_row)(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                                        const uint8_t sub[], const uint8_t inner[],
+                                        uint32_t outerScale, uint32_t innerScale, int count);
+
+    // Filter count pixels through a 4x5 color matrix; see SkColorMatrixFilter_opts.h.
+    extern void (*color_matrix_filter_span)(const float transpose[20], const SkPMColor src[],
+                                            int count, SkPMColor dst[]);
+
+    // Filter count pixels through a 3D color lookup table; see SkColorCubeFilter_opts.h.
+    extern void (*color_cube_filter_span)(const SkPMColor src[], int count, SkPMColor dst[],
+                                          const int* colorToIndex[2],
+                                          const SkScalar* colorToFactors[2],
+                                          int dim, const SkColor* colorCube);
+
+    // Map count points through the values of a matrix of at most the named type; see
+    // SkMatrix_opts.h.
+    typedef void (*MapPts)(SkPoint dst[], const SkPoint src[], int count, const SkScalar mat[9]);
+    extern MapPts matrix_translate, matrix_scale_translate, matrix_affine, matrix_perspective;
+
 }
 
 #endif//SkOpts_DEFINED
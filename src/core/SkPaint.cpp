@@ -28,6 +28,7 @@
 #include "SkShader.h"
 #include "SkStringUtils.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkTextFormatParams.h"
 #include "SkTextToPathIter.h"
 #include "SkTLazy.h"
@@ -39,7 +40,7 @@
 // e.g. setTextSize(-1)
 //#define SK_REPORT_API_RANGE_CHECK
 
-SkPaint::SkPaint() {
+SkPaint::Effects::Effects() {
     fTypeface    = NULL;
     fPathEffect  = NULL;
     fShader      = NULL;
@@ -50,6 +51,40 @@ SkPaint::SkPaint() {
     fLooper      = NULL;
     fImageFilter = NULL;
     fAnnotation  = NULL;
+}
+
+SkPaint::Effects::~Effects() {
+    SkSafeUnref(fTypeface);
+    SkSafeUnref(fPathEffect);
+    SkSafeUnref(fShader);
+    SkSafeUnref(fXfermode);
+    SkSafeUnref(fMaskFilter);
+    SkSafeUnref(fColorFilter);
+    SkSafeUnref(fRasterizer);
+    SkSafeUnref(fLooper);
+    SkSafeUnref(fImageFilter);
+    SkSafeUnref(fAnnotation);
+}
+
+SkPaint::Effects* SkPaint::Effects::clone() const {
+    Effects* copy = SkNEW(Effects);
+#define REF_COPY(field) copy->field = SkSafeRef(field)
+    REF_COPY(fTypeface);
+    REF_COPY(fPathEffect);
+    REF_COPY(fShader);
+    REF_COPY(fXfermode);
+    REF_COPY(fMaskFilter);
+    REF_COPY(fColorFilter);
+    REF_COPY(fRasterizer);
+    REF_COPY(fLooper);
+    REF_COPY(fImageFilter);
+    REF_COPY(fAnnotation);
+#undef REF_COPY
+    return copy;
+}
+
+SkPaint::SkPaint() {
+    fEffects = NULL;
 
     fTextSize   = SkPaintDefaults_TextSize;
     fTextScaleX = SK_Scalar1;
@@ -71,18 +106,8 @@ SkPaint::SkPaint() {
 
 SkPaint::SkPaint(const SkPaint& src) {
 #define COPY(field) field = src.field
-#define REF_COPY(field) field = SkSafeRef(src.field)
 
-    REF_COPY(fTypeface);
-    REF_COPY(fPathEffect);
-    REF_COPY(fShader);
-    REF_COPY(fXfermode);
-    REF_COPY(fMaskFilter);
-    REF_COPY(fColorFilter);
-    REF_COPY(fRasterizer);
-    REF_COPY(fLooper);
-    REF_COPY(fImageFilter);
-    REF_COPY(fAnnotation);
+    fEffects = SkSafeRef(src.fEffects);
 
     COPY(fTextSize);
     COPY(fTextScaleX);
@@ -93,20 +118,10 @@ SkPaint::SkPaint(const SkPaint& src) {
     COPY(fBitfields);
 
 #undef COPY
-#undef REF_COPY
 }
 
 SkPaint::~SkPaint() {
-    SkSafeUnref(fTypeface);
-    SkSafeUnref(fPathEffect);
-    SkSafeUnref(fShader);
-    SkSafeUnref(fXfermode);
-    SkSafeUnref(fMaskFilter);
-    SkSafeUnref(fColorFilter);
-    SkSafeUnref(fRasterizer);
-    SkSafeUnref(fLooper);
-    SkSafeUnref(fImageFilter);
-    SkSafeUnref(fAnnotation);
+    SkSafeUnref(fEffects);
 }
 
 SkPaint& SkPaint::operator=(const SkPaint& src) {
@@ -115,18 +130,8 @@ SkPaint& SkPaint::operator=(const SkPaint& src) {
     }
 
 #define COPY(field) field = src.field
-#define REF_COPY(field) SkSafeUnref(field); field = SkSafeRef(src.field)
 
-    REF_COPY(fTypeface);
-    REF_COPY(fPathEffect);
-    REF_COPY(fShader);
-    REF_COPY(fXfermode);
-    REF_COPY(fMaskFilter);
-    REF_COPY(fColorFilter);
-    REF_COPY(fRasterizer);
-    REF_COPY(fLooper);
-    REF_COPY(fImageFilter);
-    REF_COPY(fAnnotation);
+    SkRefCnt_SafeAssign(fEffects, src.fEffects);
 
     COPY(fTextSize);
     COPY(fTextScaleX);
@@ -139,21 +144,21 @@ SkPaint& SkPaint::operator=(const SkPaint& src) {
     return *this;
 
 #undef COPY
-#undef REF_COPY
 }
 
 bool operator==(const SkPaint& a, const SkPaint& b) {
 #define EQUAL(field) (a.field == b.field)
-    return EQUAL(fTypeface)
-        && EQUAL(fPathEffect)
-        && EQUAL(fShader)
-        && EQUAL(fXfermode)
-        && EQUAL(fMaskFilter)
-        && EQUAL(fColorFilter)
-        && EQUAL(fRasterizer)
-        && EQUAL(fLooper)
-        && EQUAL(fImageFilter)
-        && EQUAL(fAnnotation)
+#define EQUAL_EFFECT(getter) (a.getter() == b.getter())
+    return (EQUAL(fEffects) || (EQUAL_EFFECT(getTypeface)
+                                && EQUAL_EFFECT(getPathEffect)
+                                && EQUAL_EFFECT(getShader)
+                                && EQUAL_EFFECT(getXfermode)
+                                && EQUAL_EFFECT(getMaskFilter)
+                                && EQUAL_EFFECT(getColorFilter)
+                                && EQUAL_EFFECT(getRasterizer)
+                                && EQUAL_EFFECT(getLooper)
+                                && EQUAL_EFFECT(getImageFilter)
+                                && EQUAL_EFFECT(getAnnotation)))
         && EQUAL(fTextSize)
         && EQUAL(fTextScaleX)
         && EQUAL(fTextSkewX)
@@ -163,6 +168,28 @@ bool operator==(const SkPaint& a, const SkPaint& b) {
         && EQUAL(fBitfieldsUInt)
         ;
 #undef EQUAL
+#undef EQUAL_EFFECT
+}
+
+SkPaint::Effects* SkPaint::writableEffects() {
+    if (NULL == fEffects) {
+        fEffects = SkNEW(Effects);
+    } else if (!fEffects->unique()) {
+        Effects* copy = fEffects->clone();
+        fEffects->unref();
+        fEffects = copy;
+    }
+    return fEffects;
+}
+
+template <typename T> T* SkPaint::setEffect(T* Effects::* field, T* value) {
+    // Setting what's already there (typically NULL) must not clone or allocate.
+    T* current = fEffects ? fEffects->*field : NULL;
+    if (current != value) {
+        T*& slot = this->writableEffects()->*field;
+        SkRefCnt_SafeAssign(slot, value);
+    }
+    return value;
 }
 
 void SkPaint::reset() {
@@ -336,28 +363,23 @@ void SkPaint::setTextEncoding(TextEncoding encoding) {
 ///////////////////////////////////////////////////////////////////////////////
 
 SkTypeface* SkPaint::setTypeface(SkTypeface* font) {
-    SkRefCnt_SafeAssign(fTypeface, font);
-    return font;
+    return this->setEffect(&Effects::fTypeface, font);
 }
 
 SkRasterizer* SkPaint::setRasterizer(SkRasterizer* r) {
-    SkRefCnt_SafeAssign(fRasterizer, r);
-    return r;
+    return this->setEffect(&Effects::fRasterizer, r);
 }
 
 SkDrawLooper* SkPaint::setLooper(SkDrawLooper* looper) {
-    SkRefCnt_SafeAssign(fLooper, looper);
-    return looper;
+    return this->setEffect(&Effects::fLooper, looper);
 }
 
 SkImageFilter* SkPaint::setImageFilter(SkImageFilter* imageFilter) {
-    SkRefCnt_SafeAssign(fImageFilter, imageFilter);
-    return imageFilter;
+    return this->setEffect(&Effects::fImageFilter, imageFilter);
 }
 
 SkAnnotation* SkPaint::setAnnotation(SkAnnotation* annotation) {
-    SkRefCnt_SafeAssign(fAnnotation, annotation);
-    return annotation;
+    return this->setEffect(&Effects::fAnnotation, annotation);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -823,6 +845,39 @@ static SkFixed advance(const SkGlyph& glyph, int xyIndex) {
     return (&glyph.fAdvanceX)[xyIndex];
 }
 
+// Glyph id and UTF32 text are already arrays the strike can look up in bulk, a chunk at a time,
+// so long as no auto-kerning needs each glyph's lsb and rsb deltas.
+static bool can_measure_in_bulk(const SkPaint& paint) {
+    return !paint.isDevKernText() &&
+           (SkPaint::kGlyphID_TextEncoding == paint.getTextEncoding() ||
+            SkPaint::kUTF32_TextEncoding == paint.getTextEncoding());
+}
+
+static const int kBulkMeasureCount = 128;
+
+// Looks up the advances (along xyIndex) and, if bounds is not null, the bounds of the next chunk
+// of glyphs in text, returning how many there were.
+static int bulk_measure_next(SkGlyphCache* cache, SkPaint::TextEncoding encoding,
+                             const char** text, const char* stop, int xyIndex,
+                             SkFixed advances[kBulkMeasureCount], SkIRect* bounds) {
+    SkFixed* advanceX = xyIndex ? NULL : advances;
+    SkFixed* advanceY = xyIndex ? advances : NULL;
+    int count;
+    if (SkPaint::kGlyphID_TextEncoding == encoding) {
+        const uint16_t* glyphIDs = (const uint16_t*)*text;
+        count = SkTMin<int>(kBulkMeasureCount, (const uint16_t*)stop - glyphIDs);
+        cache->getGlyphIDAdvances(glyphIDs, count, advanceX, advanceY, bounds);
+        *text = (const char*)(glyphIDs + count);
+    } else {
+        SkASSERT(SkPaint::kUTF32_TextEncoding == encoding);
+        const SkUnichar* chars = (const SkUnichar*)*text;
+        count = SkTMin<int>(kBulkMeasureCount, (const SkUnichar*)stop - chars);
+        cache->getUnicharAdvances(chars, count, advanceX, advanceY, bounds);
+        *text = (const char*)(chars + count);
+    }
+    return count;
+}
+
 SkScalar SkPaint::measure_text(SkGlyphCache* cache,
                                const char* text, size_t byteLength,
                                int* count, SkRect* bounds) const {
@@ -847,8 +902,37 @@ SkScalar SkPaint::measure_text(SkGlyphCache* cache,
         joinBoundsProc = join_bounds_x;
     }
 
-    int         n = 1;
     const char* stop = (const char*)text + byteLength;
+
+    if (can_measure_in_bulk(*this)) {
+        SkFixed advances[kBulkMeasureCount];
+        SkIRect glyphBounds[kBulkMeasureCount];
+        Sk48Dot16 x = 0;
+        int n = 0;
+        while (text < stop) {
+            int chunk = bulk_measure_next(cache, this->getTextEncoding(), &text, stop, xyIndex,
+                                          advances, bounds ? glyphBounds : NULL);
+            for (int i = 0; i < chunk; ++i) {
+                if (bounds) {
+                    SkRect r = SkRect::Make(glyphBounds[i]);
+                    if (0 == n + i) {
+                        *bounds = r;
+                    } else {
+                        SkScalar d = Sk48Dot16ToScalar(x);
+                        bounds->join(xyIndex ? r.makeOffset(0, d) : r.makeOffset(d, 0));
+                    }
+                }
+                x += advances[i];
+            }
+            n += chunk;
+        }
+        SkASSERT(text == stop);
+
+        *count = n;
+        return Sk48Dot16ToScalar(x);
+    }
+
+    int         n = 1;
     const SkGlyph* g = &glyphCacheProc(cache, &text);
     // our accumulated fixed-point advances might overflow 16.16, so we use
     // a 48.16 (64bit) accumulator, and then convert that to scalar at the
@@ -1086,7 +1170,31 @@ int SkPaint::getTextWidths(const void* textData, size_t byteLength,
     int         count = 0;
     const int   xyIndex = paint.isVerticalText() ? 1 : 0;
 
-    if (this->isDevKernText()) {
+    if (can_measure_in_bulk(paint)) {
+        SkFixed advances[kBulkMeasureCount];
+        SkIRect glyphBounds[kBulkMeasureCount];
+        while (text < stop) {
+            int chunk = bulk_measure_next(cache, paint.getTextEncoding(), &text, stop, xyIndex,
+                                          advances, bounds ? glyphBounds : NULL);
+            for (int i = 0; i < chunk; ++i) {
+                if (widths) {
+                    SkScalar w = SkFixedToScalar(advances[i]);
+                    *widths++ = scale ? SkScalarMul(w, scale) : w;
+                }
+                if (bounds) {
+                    const SkIRect& r = glyphBounds[i];
+                    if (scale) {
+                        bounds->set(r.fLeft * scale, r.fTop * scale,
+                                    r.fRight * scale, r.fBottom * scale);
+                    } else {
+                        bounds->set(r);
+                    }
+                    bounds++;
+                }
+            }
+            count += chunk;
+        }
+    } else if (this->isDevKernText()) {
         // we adjust the widths returned here through auto-kerning
         SkAutoKern  autokern;
         SkFixed     prevWidth = 0;
@@ -1749,7 +1857,7 @@ void SkPaint::descriptorProc(const SkSurfaceProps* surfaceProps,
     test_desc(rec, pe, &peBuffer, mf, &mfBuffer, ra, &raBuffer, desc, descSize);
 #endif
 
-    proc(fTypeface, desc, context);
+    proc(this->getTypeface(), desc, context);
 }
 
 SkGlyphCache* SkPaint::detachCache(const SkSurfaceProps* surfaceProps,
@@ -1942,9 +2050,9 @@ void SkPaint::flatten(SkWriteBuffer& buffer) const {
         buffer.writeFlattenable(this->getLooper());
         buffer.writeFlattenable(this->getImageFilter());
 
-        if (fAnnotation) {
+        if (SkAnnotation* annotation = this->getAnnotation()) {
             buffer.writeBool(true);
-            fAnnotation->writeToBuffer(buffer);
+            annotation->writeToBuffer(buffer);
         } else {
             buffer.writeBool(false);
         }
@@ -2006,38 +2114,36 @@ void SkPaint::unflatten(SkReadBuffer& buffer) {
 ///////////////////////////////////////////////////////////////////////////////
 
 SkShader* SkPaint::setShader(SkShader* shader) {
-    SkRefCnt_SafeAssign(fShader, shader);
-    return shader;
+    return this->setEffect(&Effects::fShader, shader);
 }
 
 SkColorFilter* SkPaint::setColorFilter(SkColorFilter* filter) {
-    SkRefCnt_SafeAssign(fColorFilter, filter);
-    return filter;
+    return this->setEffect(&Effects::fColorFilter, filter);
 }
 
 SkXfermode* SkPaint::setXfermode(SkXfermode* mode) {
-    SkRefCnt_SafeAssign(fXfermode, mode);
-    return mode;
+    return this->setEffect(&Effects::fXfermode, mode);
 }
 
 SkXfermode* SkPaint::setXfermodeMode(SkXfermode::Mode mode) {
-    SkSafeUnref(fXfermode);
-    fXfermode = SkXfermode::Create(mode);
-    return fXfermode;
+    SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create(mode));
+    return this->setXfermode(xfer);
 }
 
 SkPathEffect* SkPaint::setPathEffect(SkPathEffect* effect) {
-    SkRefCnt_SafeAssign(fPathEffect, effect);
-    return effect;
+    return this->setEffect(&Effects::fPathEffect, effect);
 }
 
 SkMaskFilter* SkPaint::setMaskFilter(SkMaskFilter* filter) {
-    SkRefCnt_SafeAssign(fMaskFilter, filter);
-    return filter;
+    return this->setEffect(&Effects::fMaskFilter, filter);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Strokes of paths with at least this many points are kept in the SkStrokeCache, so redrawing
+// the same long path, say a chart's lines, doesn't stroke it again.
+static const int kMinCachedStrokePoints = 256;
+
 bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect,
                           SkScalar resScale) const {
     SkStrokeRec rec(*this, resScale);
@@ -2045,10 +2151,23 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
     const SkPath* srcPtr = &src;
     SkPath tmpPath;
 
-    if (fPathEffect && fPathEffect->filterPath(&tmpPath, src, &rec, cullRect)) {
+    SkPathEffect* pathEffect = this->getPathEffect();
+    if (pathEffect && pathEffect->filterPath(&tmpPath, src, &rec, cullRect)) {
         srcPtr = &tmpPath;
     }
 
+    // A path effect makes a new path each time, so only the caller's own paths are cached.
+    if (srcPtr == &src && rec.needToApply() && !src.isVolatile() &&
+        src.countPoints() >= kMinCachedStrokePoints) {
+        const uint32_t genID = src.getGenerationID();
+        const SkPath::FillType fillType = src.getFillType();
+        if (!SkStrokeCache::Find(genID, fillType, rec, dst)) {
+            SkAssertResult(rec.applyToPath(dst, src));
+            SkStrokeCache::Add(genID, fillType, rec, *dst);
+        }
+        return true;
+    }
+
     if (!rec.applyToPath(dst, *srcPtr)) {
         if (srcPtr == &tmpPath) {
             // If path's were copy-on-write, this trick would not be needed.
@@ -2392,11 +2511,11 @@ static bool affects_alpha(const SkImageFilter* imf) {
 }
 
 bool SkPaint::nothingToDraw() const {
-    if (fLooper) {
+    if (this->getLooper()) {
         return false;
     }
     SkXfermode::Mode mode;
-    if (SkXfermode::AsMode(fXfermode, &mode)) {
+    if (SkXfermode::AsMode(this->getXfermode(), &mode)) {
         switch (mode) {
             case SkXfermode::kSrcOver_Mode:
             case SkXfermode::kSrcATop_Mode:
@@ -2404,7 +2523,8 @@ bool SkPaint::nothingToDraw() const {
             case SkXfermode::kDstOver_Mode:
             case SkXfermode::kPlus_Mode:
                 if (0 == this->getAlpha()) {
-                    return !affects_alpha(fColorFilter) && !affects_alpha(fImageFilter);
+                    return !affects_alpha(this->getColorFilter()) &&
+                           !affects_alpha(this->getImageFilter());
                 }
                 break;
             case SkXfermode::kDst_Mode:
@@ -2417,10 +2537,19 @@ bool SkPaint::nothingToDraw() const {
 }
 
 uint32_t SkPaint::getHash() const {
-    // We're going to hash 10 pointers and 7 32-bit values, finishing up with fBitfields,
-    // so fBitfields should be 10 pointers and 6 32-bit values from the start.
-    SK_COMPILE_ASSERT(offsetof(SkPaint, fBitfields) == 10 * sizeof(void*) + 6 * sizeof(uint32_t),
+    // Hash the 10 effect pointers rather than fEffects, so equal paints hash the same whether or
+    // not they share an Effects block.
+    const void* effects[] = {
+        this->getTypeface(), this->getPathEffect(), this->getShader(), this->getXfermode(),
+        this->getMaskFilter(), this->getColorFilter(), this->getRasterizer(), this->getLooper(),
+        this->getImageFilter(), this->getAnnotation(),
+    };
+    uint32_t hash = SkChecksum::Murmur3(effects, sizeof(effects));
+
+    // Then 7 32-bit values, finishing up with fBitfields, so fBitfields should be 6 32-bit values
+    // after fTextSize.
+    SK_COMPILE_ASSERT(offsetof(SkPaint, fBitfields) ==
+                      offsetof(SkPaint, fTextSize) + 6 * sizeof(uint32_t),
                       SkPaint_notPackedTightly);
-    return SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(this),
-                               offsetof(SkPaint, fBitfields) + sizeof(fBitfields));
+    return SkChecksum::Murmur3(&fTextSize, 7 * sizeof(uint32_t), hash);
 }
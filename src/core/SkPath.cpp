@@ -165,8 +165,9 @@ void SkPath::copyFields(const SkPath& that) {
     //fPathRef is assumed to have been set by the caller.
     fLastMoveToIndex = that.fLastMoveToIndex;
     fFillType        = that.fFillType;
-    fConvexity       = that.fConvexity;
-    fFirstDirection  = that.fFirstDirection;
+    // that may be a path shared with other threads which are lazily filling in these caches.
+    fConvexity       = sk_atomic_load(&that.fConvexity, sk_memory_order_relaxed);
+    fFirstDirection  = sk_atomic_load(&that.fFirstDirection, sk_memory_order_relaxed);
     fIsVolatile      = that.fIsVolatile;
 }
 
@@ -1482,22 +1483,23 @@ void SkPath::transform(const SkMatrix& matrix, SkPath* dst) const {
     } else {
         SkPathRef::CreateTransformedCopy(&dst->fPathRef, *fPathRef.get(), matrix);
 
+        const uint8_t firstDirection = sk_atomic_load(&fFirstDirection, sk_memory_order_relaxed);
         if (this != dst) {
             dst->fFillType = fFillType;
-            dst->fConvexity = fConvexity;
+            dst->fConvexity = sk_atomic_load(&fConvexity, sk_memory_order_relaxed);
             dst->fIsVolatile = fIsVolatile;
         }
 
-        if (SkPathPriv::kUnknown_FirstDirection == fFirstDirection) {
+        if (SkPathPriv::kUnknown_FirstDirection == firstDirection) {
             dst->fFirstDirection = SkPathPriv::kUnknown_FirstDirection;
         } else {
             SkScalar det2x2 =
                 SkScalarMul(matrix.get(SkMatrix::kMScaleX), matrix.get(SkMatrix::kMScaleY)) -
                 SkScalarMul(matrix.get(SkMatrix::kMSkewX), matrix.get(SkMatrix::kMSkewY));
             if (det2x2 < 0) {
-                dst->fFirstDirection = SkPathPriv::OppositeFirstDirection((SkPathPriv::FirstDirection)fFirstDirection);
+                dst->fFirstDirection = SkPathPriv::OppositeFirstDirection((SkPathPriv::FirstDirection)firstDirection);
             } else if (det2x2 > 0) {
-                dst->fFirstDirection = fFirstDirection;
+                dst->fFirstDirection = firstDirection;
             } else {
                 dst->fConvexity = kUnknown_Convexity;
                 dst->fFirstDirection = SkPathPriv::kUnknown_FirstDirection;
@@ -2241,7 +2243,7 @@ private:
 };
 
 SkPath::Convexity SkPath::internalGetConvexity() const {
-    SkASSERT(kUnknown_Convexity == fConvexity);
+    SkASSERT(kUnknown_Convexity == this->getConvexityOrUnknown());
     SkPoint         pts[4];
     SkPath::Verb    verb;
     SkPath::Iter    iter(*this, true);
@@ -2257,8 +2259,7 @@ SkPath::Convexity SkPath::internalGetConvexity() const {
         switch (verb) {
             case kMove_Verb:
                 if (++contourCount > 1) {
-                    fConvexity = kConcave_Convexity;
-                    return kConcave_Convexity;
+                    return this->publishConvexity(kConcave_Convexity);
                 }
                 pts[1] = pts[0];
                 // fall through
@@ -2283,8 +2284,7 @@ SkPath::Convexity SkPath::internalGetConvexity() const {
                 break;
             default:
                 SkDEBUGFAIL("bad verb");
-                fConvexity = kConcave_Convexity;
-                return kConcave_Convexity;
+                return this->publishConvexity(kConcave_Convexity);
         }
 
         for (int i = 1; i <= count; i++) {
@@ -2295,15 +2295,24 @@ SkPath::Convexity SkPath::internalGetConvexity() const {
             return kUnknown_Convexity;
         }
         if (kConcave_Convexity == state.getConvexity()) {
-            fConvexity = kConcave_Convexity;
-            return kConcave_Convexity;
+            return this->publishConvexity(kConcave_Convexity);
         }
     }
-    fConvexity = state.getConvexity();
-    if (kConvex_Convexity == fConvexity && SkPathPriv::kUnknown_FirstDirection == fFirstDirection) {
-        fFirstDirection = state.getFirstDirection();
+    const Convexity convexity = state.getConvexity();
+    if (kConvex_Convexity == convexity) {
+        // Only fill in the direction if no one else has; CheapComputeFirstDirection() may race us.
+        uint8_t unknown = SkPathPriv::kUnknown_FirstDirection;
+        sk_atomic_compare_exchange(&fFirstDirection, &unknown, (uint8_t)state.getFirstDirection(),
+                                   sk_memory_order_relaxed, sk_memory_order_relaxed);
     }
-    return static_cast<Convexity>(fConvexity);
+    return this->publishConvexity(convexity);
+}
+
+SkPath::Convexity SkPath::publishConvexity(Convexity convexity) const {
+    // Const paths may be shared across threads (e.g. by a picture played back in parallel).
+    // Every thread computes the same answer, so a relaxed store is enough to make caching safe.
+    sk_atomic_store(&fConvexity, (uint8_t)convexity, sk_memory_order_relaxed);
+    return convexity;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2475,16 +2484,16 @@ static void crossToDir(SkScalar cross, SkPathPriv::FirstDirection* dir) {
  *  its cross product.
  */
 bool SkPathPriv::CheapComputeFirstDirection(const SkPath& path, FirstDirection* dir) {
-    if (kUnknown_FirstDirection != path.fFirstDirection) {
-        *dir = static_cast<FirstDirection>(path.fFirstDirection);
+    const uint8_t cached = sk_atomic_load(&path.fFirstDirection, sk_memory_order_relaxed);
+    if (kUnknown_FirstDirection != cached) {
+        *dir = static_cast<FirstDirection>(cached);
         return true;
     }
 
     // don't want to pay the cost for computing this if it
     // is unknown, so we don't call isConvex()
     if (SkPath::kConvex_Convexity == path.getConvexityOrUnknown()) {
-        SkASSERT(kUnknown_FirstDirection == path.fFirstDirection);
-        *dir = static_cast<FirstDirection>(path.fFirstDirection);
+        *dir = kUnknown_FirstDirection;
         return false;
     }
 
@@ -2557,7 +2566,7 @@ bool SkPathPriv::CheapComputeFirstDirection(const SkPath& path, FirstDirection*
     }
     if (ymaxCross) {
         crossToDir(ymaxCross, dir);
-        path.fFirstDirection = *dir;
+        sk_atomic_store(&path.fFirstDirection, (uint8_t)*dir, sk_memory_order_relaxed);
         return true;
     } else {
         return false;
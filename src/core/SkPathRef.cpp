@@ -427,19 +427,30 @@ SkPoint* SkPathRef::growForVerb(int /* SkPath::Verb*/ verb, SkScalar weight) {
 uint32_t SkPathRef::genID() const {
     SkASSERT(!fEditorsAttached);
     static const uint32_t kMask = (static_cast<int64_t>(1) << SkPath::kPathRefGenIDBitCnt) - 1;
-    if (!fGenerationID) {
+    // Immutable path refs are shared by threads playing back the same picture, so the lazily
+    // assigned ID is published with a compare-exchange: every caller sees the same ID.
+    uint32_t id = sk_atomic_load(&fGenerationID, sk_memory_order_relaxed);
+    while (0 == id) {
+        uint32_t next;
         if (0 == fPointCnt && 0 == fVerbCnt) {
-            fGenerationID = kEmptyGenID;
+            next = kEmptyGenID;
         } else {
             static int32_t  gPathRefGenerationID;
             // do a loop in case our global wraps around, as we never want to return a 0 or the
             // empty ID
             do {
-                fGenerationID = (sk_atomic_inc(&gPathRefGenerationID) + 1) & kMask;
-            } while (fGenerationID <= kEmptyGenID);
+                next = (sk_atomic_inc(&gPathRefGenerationID) + 1) & kMask;
+            } while (next <= kEmptyGenID);
+        }
+        if (sk_atomic_compare_exchange(&fGenerationID, &id, next,
+                                       sk_memory_order_relaxed,
+                                       sk_memory_order_relaxed)) {
+            id = next;
+        } else {
+            // sk_atomic_compare_exchange replaced id with the current value of fGenerationID.
         }
     }
-    return fGenerationID;
+    return id;
 }
 
 void SkPathRef::addGenIDChangeListener(GenIDChangeListener* listener) {
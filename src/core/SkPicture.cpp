@@ -10,7 +10,6 @@
 #include "SkPicture.h"
 #include "SkPictureData.h"
 #include "SkPicturePlayback.h"
-#include "SkPictureRecord.h"
 #include "SkPictureRecorder.h"
 
 #if defined(SK_DISALLOW_CROSSPROCESS_PICTUREIMAGEFILTERS) || \
@@ -132,6 +131,12 @@ SkPicture* SkPicture::Forwardport(const SkPictInfo& info, const SkPictureData* d
     if (!data) {
         return nullptr;
     }
+    if (SkPicture* recorded = data->recordedPicture()) {
+        return SkRef(recorded);
+    }
+    if (!data->opData()) {
+        return nullptr;
+    }
     SkPicturePlayback playback(data);
     SkPictureRecorder r;
     playback.draw(r.beginRecording(info.fCullRect), nullptr/*no callback*/);
@@ -156,46 +161,40 @@ SkPicture* SkPicture::CreateFromBuffer(SkReadBuffer& buffer) {
     return Forwardport(info, data);
 }
 
-SkPictureData* SkPicture::backport() const {
-    SkPictInfo info = this->createHeader();
-    SkPictureRecord rec(SkISize::Make(info.fCullRect.width(), info.fCullRect.height()), 0/*flags*/);
-    rec.beginRecording();
-        this->playback(&rec);
-    rec.endRecording();
-    return SkNEW_ARGS(SkPictureData, (rec, info, false/*deep copy ops?*/));
-}
-
 void SkPicture::serialize(SkWStream* stream, SkPixelSerializer* pixelSerializer) const {
     SkPictInfo info = this->createHeader();
-    SkAutoTDelete<SkPictureData> data(this->backport());
 
     stream->write(&info, sizeof(info));
-    if (data) {
-        stream->writeBool(true);
-        data->serialize(stream, pixelSerializer);
-    } else {
-        stream->writeBool(false);
-    }
+    stream->writeBool(true);
+    SkPictureData::SerializeRecord(*this, stream, pixelSerializer);
 }
 
 void SkPicture::flatten(SkWriteBuffer& buffer) const {
     SkPictInfo info = this->createHeader();
-    SkAutoTDelete<SkPictureData> data(this->backport());
 
     buffer.writeByteArray(&info.fMagic, sizeof(info.fMagic));
     buffer.writeUInt(info.fVersion);
     buffer.writeRect(info.fCullRect);
     buffer.writeUInt(info.fFlags);
-    if (data) {
-        buffer.writeBool(true);
-        data->flatten(buffer);
-    } else {
-        buffer.writeBool(false);
-    }
+    buffer.writeBool(true);
+    SkPictureData::FlattenRecord(*this, buffer);
+}
+
+float SkPicture::estimateGpuCostPenalty(const GpuCostModel& model) const {
+    const GpuCostFeatures features = this->gpuCostFeatures();
+    return features.fConcaveAAPaths * model.fConcaveAAPath
+         + features.fPathEffects    * model.fPathEffect
+         + features.fMaskFilters    * model.fMaskFilter
+         + features.fConcaveAAPathArea * (model.fConcaveAAPathMegapixel / 1000000);
+}
+
+bool SkPicture::suitableForGpuRasterization(GrContext* context, const char** whyNot) const {
+    return this->suitableForGpuRasterization(context, GpuCostModel(), whyNot);
 }
 
-bool SkPicture::suitableForGpuRasterization(GrContext*, const char** whyNot) const {
-    if (this->numSlowPaths() > 5) {
+bool SkPicture::suitableForGpuRasterization(GrContext*, const GpuCostModel& model,
+                                            const char** whyNot) const {
+    if (this->estimateGpuCostPenalty(model) > model.fBudget) {
         if (whyNot) { *whyNot = "Too many slow paths (either concave or dashed)."; }
         return false;
     }
@@ -8,7 +8,7 @@
 // Some shared code used by both SkBigPicture and SkMiniPicture.
 //   SkTextHunter   -- SkRecord visitor that returns true when the op draws text.
 //   SkBitmapHunter -- SkRecord visitor that returns true when the op draws a bitmap.
-//   SkPathCounter  -- SkRecord visitor that counts paths that draw slowly on the GPU.
+//   SkPathCounter  -- SkRecord visitor that counts features that draw slowly on the GPU.
 
 #include "SkPathEffect.h"
 #include "SkRecords.h"
@@ -72,7 +72,6 @@ struct SkBitmapHunter {
     static SK_WHEN(!HasMember_paint<T>, bool) CheckPaint(const T&) { return false; }
 };
 
-// TODO: might be nicer to have operator() return an int (the number of slow paths) ?
 struct SkPathCounter {
     SK_CREATE_MEMBER_DETECTOR(paint);
 
@@ -80,46 +79,48 @@ struct SkPathCounter {
     static const SkPaint* AsPtr(const SkPaint& p) { return &p; }
     static const SkPaint* AsPtr(const SkRecords::Optional<SkPaint>& p) { return p; }
 
-    SkPathCounter() : fNumSlowPathsAndDashEffects(0) {}
-
     // Recurse into nested pictures.
     void operator()(const SkRecords::DrawPicture& op) {
-        fNumSlowPathsAndDashEffects += op.picture->numSlowPaths();
+        fFeatures += op.picture->gpuCostFeatures();
     }
 
     void checkPaint(const SkPaint* paint) {
         if (paint && paint->getPathEffect()) {
             // Initially assume it's slow.
-            fNumSlowPathsAndDashEffects++;
+            fFeatures.fPathEffects++;
+        }
+        if (paint && paint->getMaskFilter()) {
+            fFeatures.fMaskFilters++;
         }
     }
 
     void operator()(const SkRecords::DrawPoints& op) {
-        this->checkPaint(&op.paint);
-        const SkPathEffect* effect = op.paint.getPathEffect();
+        this->checkPaint(op.paint.get());
+        const SkPathEffect* effect = op.paint->getPathEffect();
         if (effect) {
             SkPathEffect::DashInfo info;
             SkPathEffect::DashType dashType = effect->asADash(&info);
-            if (2 == op.count && SkPaint::kRound_Cap != op.paint.getStrokeCap() &&
+            if (2 == op.count && SkPaint::kRound_Cap != op.paint->getStrokeCap() &&
                 SkPathEffect::kDash_DashType == dashType && 2 == info.fCount) {
-                fNumSlowPathsAndDashEffects--;
+                fFeatures.fPathEffects--;
             }
         }
     }
 
     void operator()(const SkRecords::DrawPath& op) {
-        this->checkPaint(&op.paint);
-        if (op.paint.isAntiAlias() && !op.path.isConvex()) {
-            SkPaint::Style paintStyle = op.paint.getStyle();
+        this->checkPaint(op.paint.get());
+        if (op.paint->isAntiAlias() && !op.path.isConvex()) {
+            SkPaint::Style paintStyle = op.paint->getStyle();
             const SkRect& pathBounds = op.path.getBounds();
             if (SkPaint::kStroke_Style == paintStyle &&
-                0 == op.paint.getStrokeWidth()) {
+                0 == op.paint->getStrokeWidth()) {
                 // AA hairline concave path is not slow.
             } else if (SkPaint::kFill_Style == paintStyle && pathBounds.width() < 64.f &&
                        pathBounds.height() < 64.f && !op.path.isVolatile()) {
                 // AADF eligible concave path is not slow.
             } else {
-                fNumSlowPathsAndDashEffects++;
+                fFeatures.fConcaveAAPaths++;
+                fFeatures.fConcaveAAPathArea += pathBounds.width() * pathBounds.height();
             }
         }
     }
@@ -132,5 +133,5 @@ struct SkPathCounter {
     template <typename T>
     SK_WHEN(!HasMember_paint<T>, void) operator()(const T& op) { /* do nothing */ }
 
-    int fNumSlowPathsAndDashEffects;
+    SkPicture::GpuCostFeatures fFeatures;
 };
@@ -8,6 +8,7 @@
 #include "SkPictureData.h"
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
+#include "SkRecordSerialize.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
@@ -155,6 +156,17 @@ static void write_tag_size(SkWStream* stream, uint32_t tag, size_t size) {
     stream->write32(SkToU32(size));
 }
 
+// Pad the stream so the contents of the next tag, after its tag and size, are 4-byte aligned.
+static void write_padding(SkWStream* stream) {
+    // The padding tag and size, then the next tag and size, precede the aligned contents.
+    const size_t unpadded = stream->bytesWritten() + 4 * sizeof(uint32_t);
+    const size_t padding = SkAlign4(unpadded) - unpadded;
+    write_tag_size(stream, SK_PICT_PADDING_TAG, padding);
+    for (size_t i = 0; i < padding; ++i) {
+        stream->write8(0);
+    }
+}
+
 void SkPictureData::WriteFactories(SkWStream* stream, const SkFactorySet& rec) {
     int count = rec.count();
 
@@ -244,6 +256,7 @@ void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
 
 void SkPictureData::serialize(SkWStream* stream,
                               SkPixelSerializer* pixelSerializer) const {
+    write_padding(stream);
     write_tag_size(stream, SK_PICT_READER_TAG, fOpData->size());
     stream->write(fOpData->bytes(), fOpData->size());
 
@@ -273,6 +286,7 @@ void SkPictureData::serialize(SkWStream* stream,
         WriteFactories(stream, factSet);
         WriteTypefaces(stream, typefaceSet);
 
+        write_padding(stream);
         write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
         buffer.writeToStream(stream);
     }
@@ -296,6 +310,37 @@ void SkPictureData::flatten(SkWriteBuffer& buffer) const {
     buffer.write32(SK_PICT_EOF_TAG);
 }
 
+void SkPictureData::SerializeRecord(const SkPicture& picture, SkWStream* stream,
+                                    SkPixelSerializer* pixelSerializer) {
+    SkRefCntSet  typefaceSet;
+    SkFactorySet factSet;
+
+    SkWriteBuffer buffer(SkWriteBuffer::kCrossProcess_Flag);
+    buffer.setTypefaceRecorder(&typefaceSet);
+    buffer.setFactoryRecorder(&factSet);
+    buffer.setPixelSerializer(pixelSerializer);
+    // The recorded ops' in-memory size is a close estimate of their serialized size.
+    buffer.reserveCapacity(picture.approximateBytesUsed());
+
+    write_tag_size(buffer, SK_PICT_RECORD_TAG, 1);
+    SkRecordSerialize(picture, &buffer);
+
+    WriteFactories(stream, factSet);
+    WriteTypefaces(stream, typefaceSet);
+
+    write_padding(stream);
+    write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
+    buffer.writeToStream(stream);
+
+    stream->write32(SK_PICT_EOF_TAG);
+}
+
+void SkPictureData::FlattenRecord(const SkPicture& picture, SkWriteBuffer& buffer) {
+    write_tag_size(buffer, SK_PICT_RECORD_TAG, 1);
+    SkRecordSerialize(picture, &buffer);
+    buffer.write32(SK_PICT_EOF_TAG);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -321,6 +366,24 @@ static uint32_t pictInfoFlagsToReadBufferFlags(uint32_t pictInfoFlags) {
     return rbMask;
 }
 
+// If the stream is in memory and its next size bytes are 4-byte aligned, skip over them and
+// return their address, so they can be read in place rather than copied.
+static const void* skip_in_place(SkStream* stream, size_t size) {
+    const char* base = static_cast<const char*>(stream->getMemoryBase());
+    if (!base || !stream->hasPosition() || !stream->hasLength()) {
+        return NULL;
+    }
+    const size_t position = stream->getPosition();
+    if (position > stream->getLength() || size > stream->getLength() - position) {
+        return NULL;
+    }
+    const char* contents = base + position;
+    if (!SkIsAlign4((uintptr_t)contents) || stream->skip(size) != size) {
+        return NULL;
+    }
+    return contents;
+}
+
 bool SkPictureData::parseStreamTag(SkStream* stream,
                                    uint32_t tag,
                                    uint32_t size,
@@ -339,11 +402,20 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(NULL == fOpData);
-            fOpData = SkData::NewFromStream(stream, size);
+            if (const void* ops = skip_in_place(stream, size)) {
+                fOpData = SkData::NewWithoutCopy(ops, size);
+            } else {
+                fOpData = SkData::NewFromStream(stream, size);
+            }
             if (!fOpData) {
                 return false;
             }
             break;
+        case SK_PICT_PADDING_TAG:
+            if (stream->skip(size) != size) {
+                return false;
+            }
+            break;
         case SK_PICT_FACTORY_TAG: {
             SkASSERT(!haveBuffer);
             size = stream->readU32();
@@ -384,13 +456,17 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
             }
         } break;
         case SK_PICT_BUFFER_SIZE_TAG: {
-            SkAutoMalloc storage(size);
-            if (stream->read(storage.get(), size) != size) {
-                return false;
+            SkAutoMalloc storage;
+            const void* contents = skip_in_place(stream, size);
+            if (!contents) {
+                if (stream->read(storage.reset(size), size) != size) {
+                    return false;
+                }
+                contents = storage.get();
             }
 
             /* Should we use SkValidatingReadBuffer instead? */
-            SkReadBuffer buffer(storage.get(), size);
+            SkReadBuffer buffer(contents, size);
             buffer.setFlags(pictInfoFlagsToReadBufferFlags(fInfo.fFlags));
             buffer.setVersion(fInfo.fVersion);
 
@@ -415,23 +491,7 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
 }
 
 static const SkImage* create_image_from_buffer(SkReadBuffer& buffer) {
-    int width = buffer.read32();
-    int height = buffer.read32();
-    if (width <= 0 || height <= 0) {    // SkImage never has a zero dimension
-        buffer.validate(false);
-        return NULL;
-    }
-
-    SkAutoTUnref<SkData> encoded(buffer.readByteArrayAsData());
-    int originX = buffer.read32();
-    int originY = buffer.read32();
-    if (0 == encoded->size() || originX < 0 || originY < 0) {
-        buffer.validate(false);
-        return NULL;
-    }
-
-    const SkIRect subset = SkIRect::MakeXYWH(originX, originY, width, height);
-    return SkImage::NewFromEncoded(encoded, &subset);
+    return buffer.readImage();
 }
 
 // Need a shallow wrapper to return const SkPicture* to match the other factories,
@@ -515,6 +575,15 @@ bool SkPictureData::parseBufferTag(SkReadBuffer& buffer, uint32_t tag, uint32_t
                 return false;
             }
             break;
+        case SK_PICT_RECORD_TAG:
+            if (!buffer.validate(NULL == fRecordedPicture.get())) {
+                return false;
+            }
+            fRecordedPicture.reset(SkRecordDeserialize(&buffer));
+            if (!fRecordedPicture) {
+                return false;
+            }
+            break;
         case SK_PICT_READER_TAG: {
             SkAutoDataUnref data(SkData::NewUninitialized(size));
             if (!buffer.readByteArray(data->writable_data(), size) ||
@@ -52,6 +52,11 @@ struct SkPictInfo {
 #define SK_PICT_PATH_BUFFER_TAG     SkSetFourByteTag('p', 't', 'h', ' ')
 #define SK_PICT_TEXTBLOB_BUFFER_TAG SkSetFourByteTag('b', 'l', 'o', 'b')
 #define SK_PICT_IMAGE_BUFFER_TAG    SkSetFourByteTag('i', 'm', 'a', 'g')
+// A whole picture written by SkRecordSerialize(), in place of the tags above (V45+)
+#define SK_PICT_RECORD_TAG          SkSetFourByteTag('r', 'c', 'r', 'd')
+
+// Zero bytes that align the contents of the tag that follows (V44+)
+#define SK_PICT_PADDING_TAG SkSetFourByteTag('p', 'a', 'd', ' ')
 
 // Always write this guy last (with no length field afterwards)
 #define SK_PICT_EOF_TAG     SkSetFourByteTag('e', 'o', 'f', ' ')
@@ -59,7 +64,8 @@ struct SkPictInfo {
 class SkPictureData {
 public:
     SkPictureData(const SkPictureRecord& record, const SkPictInfo&, bool deepCopyOps);
-    // Does not affect ownership of SkStream.
+    // Does not affect ownership of SkStream.  If the stream has a memory base (e.g. a mapped
+    // file), the op data may refer to it in place, so the stream must outlive the result.
     static SkPictureData* CreateFromStream(SkStream*,
                                            const SkPictInfo&,
                                            SkPicture::InstallPixelRefProc);
@@ -70,6 +76,10 @@ public:
     void serialize(SkWStream*, SkPixelSerializer*) const;
     void flatten(SkWriteBuffer&) const;
 
+    // Write a picture's SkRecord directly, to be read back as recordedPicture().
+    static void SerializeRecord(const SkPicture&, SkWStream*, SkPixelSerializer*);
+    static void FlattenRecord(const SkPicture&, SkWriteBuffer&);
+
     bool containsBitmaps() const;
 
     bool hasText() const { return fContentInfo.hasText(); }
@@ -78,6 +88,9 @@ public:
 
     const SkData* opData() const { return fOpData; }
 
+    // If we were read from a RECORD tag, the picture it held.  Otherwise NULL.
+    SkPicture* recordedPicture() const { return fRecordedPicture; }
+
 protected:
     explicit SkPictureData(const SkPictInfo& info);
 
@@ -157,6 +170,7 @@ private:
     SkTArray<SkPath>   fPaths;
 
     SkData* fOpData;    // opcodes and parameters
+    SkAutoTUnref<SkPicture> fRecordedPicture;
 
     const SkPicture** fPictureRefs;
     int fPictureCount;
@@ -22,7 +22,9 @@ SkPictureRecorder::SkPictureRecorder() {
     fRecorder.reset(SkNEW_ARGS(SkRecorder, (nullptr, SkRect::MakeWH(0,0), &fMiniRecorder)));
 }
 
-SkPictureRecorder::~SkPictureRecorder() {}
+SkPictureRecorder::~SkPictureRecorder() {
+    fSpareRecords.unrefAll();
+}
 
 SkCanvas* SkPictureRecorder::beginRecording(const SkRect& cullRect,
                                             SkBBHFactory* bbhFactory /* = NULL */,
@@ -36,16 +38,45 @@ SkCanvas* SkPictureRecorder::beginRecording(const SkRect& cullRect,
     }
 
     if (!fRecord) {
-        fRecord.reset(SkNEW(SkRecord));
+        // A spare is unique once what it was ended as has been deleted.
+        for (int i = 0; i < fSpareRecords.count(); ++i) {
+            if (fSpareRecords[i]->unique()) {
+                fRecord.reset(fSpareRecords[i]);
+                fSpareRecords.remove(i);
+                fRecord->reset();
+                break;
+            }
+        }
+        if (!fRecord) {
+            fRecord.reset(SkNEW(SkRecord));
+        }
+    }
+    // Small nested pictures are inlined, unless we're extracting saveLayer info: GPU layer
+    // hoisting identifies nested layers by the picture that holds them.
+    SkRecorder::DrawPictureMode dpm = SkRecorder::InlineSmall_DrawPictureMode;
+    if (recordFlags & kPlaybackDrawPicture_RecordFlag) {
+        dpm = SkRecorder::Playback_DrawPictureMode;
+    } else if (recordFlags & kComputeSaveLayerInfo_RecordFlag) {
+        dpm = SkRecorder::Record_DrawPictureMode;
     }
-    SkRecorder::DrawPictureMode dpm = (recordFlags & kPlaybackDrawPicture_RecordFlag)
-        ? SkRecorder::Playback_DrawPictureMode
-        : SkRecorder::Record_DrawPictureMode;
     fRecorder->reset(fRecord.get(), cullRect, dpm, &fMiniRecorder);
     fActivelyRecording = true;
     return this->getRecordingCanvas();
 }
 
+void SkPictureRecorder::keepSpareRecord() {
+    static const int kMaxSpareRecords = 2;
+    if (!(fFlags & kReuseStorage_RecordFlag)) {
+        fSpareRecords.unrefAll();
+        return;
+    }
+    if (fSpareRecords.count() == kMaxSpareRecords) {
+        fSpareRecords[0]->unref();
+        fSpareRecords.remove(0);
+    }
+    *fSpareRecords.append() = SkRef(fRecord.get());
+}
+
 SkCanvas* SkPictureRecorder::getRecordingCanvas() {
     return fActivelyRecording ? fRecorder.get() : nullptr;
 }
@@ -83,6 +114,8 @@ SkPicture* SkPictureRecorder::endRecordingAsPicture() {
         fCullRect = bbhBound;
     }
 
+    this->keepSpareRecord();
+
     size_t subPictureBytes = fRecorder->approxBytesUsedBySubPictures();
     for (int i = 0; pictList && i < pictList->count(); i++) {
         subPictureBytes += SkPictureUtils::ApproximateBytesUsed(pictList->begin()[i]);
@@ -200,6 +233,7 @@ SkDrawable* SkPictureRecorder::endRecordingAsDrawable() {
                                          SkToBool(fFlags & kComputeSaveLayerInfo_RecordFlag)));
 
     // release our refs now, so only the drawable will be the owner.
+    this->keepSpareRecord();
     fRecord.reset(NULL);
     fBBH.reset(NULL);
 
@@ -75,6 +75,7 @@ struct BitmapShaderRec : public SkResourceCache::Rec {
     size_t bytesUsed() const override {
         return sizeof(fKey) + sizeof(SkShader) + fBitmapBytes;
     }
+    const char* getCategory() const override { return "picture-shader"; }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextShader) {
         const BitmapShaderRec& rec = static_cast<const BitmapShaderRec&>(baseRec);
@@ -100,6 +101,89 @@ static bool cache_try_alloc_pixels(SkBitmap* bitmap) {
         : bitmap->tryAllocPixels();
 }
 
+// Tiles are rasterized at scales rounded up to one of kScaleBucketsPerOctave steps per power of
+// two, so nearby CTM scales share a cached tile.
+#ifndef SK_PICTURE_SHADER_SCALE_BUCKETS_PER_OCTAVE
+    #define SK_PICTURE_SHADER_SCALE_BUCKETS_PER_OCTAVE 4
+#endif
+static const int kScaleBucketsPerOctave = SK_PICTURE_SHADER_SCALE_BUCKETS_PER_OCTAVE;
+
+static int scale_bucket(SkScalar scale) {
+    SkASSERT(scale > 0);
+    // Nudge down a little so exact steps (e.g. a scale of 1) land in their own bucket.
+    const double steps = log(scale) / log(2.0) * kScaleBucketsPerOctave;
+    return SkTPin((int)ceil(steps - 1e-4), -1024, 1024);
+}
+
+static SkScalar bucket_scale(int bucket) {
+    return SkDoubleToScalar(pow(2.0, (double)bucket / kScaleBucketsPerOctave));
+}
+
+struct TileSpec {
+    SkISize fSize;   // In pixels.
+    SkSize  fScale;  // The actual scale, compensating for rounding & clamping.
+};
+
+static bool make_tile_spec(const SkRect& tile, int bucketX, int bucketY, int maxTextureSize,
+                           TileSpec* spec) {
+    SkSize scaledSize = SkSize::Make(bucket_scale(bucketX) * tile.width(),
+                                     bucket_scale(bucketY) * tile.height());
+
+    // Clamp the tile size to about 4M pixels
+    static const SkScalar kMaxTileArea = 2048 * 2048;
+    SkScalar tileArea = SkScalarMul(scaledSize.width(), scaledSize.height());
+    if (tileArea > kMaxTileArea) {
+        SkScalar clampScale = SkScalarSqrt(kMaxTileArea / tileArea);
+        scaledSize.set(SkScalarMul(scaledSize.width(), clampScale),
+                       SkScalarMul(scaledSize.height(), clampScale));
+    }
+#if SK_SUPPORT_GPU
+    // Scale down the tile size if larger than maxTextureSize for GPU Path or it should fail on create texture
+    if (maxTextureSize) {
+        if (scaledSize.width() > maxTextureSize || scaledSize.height() > maxTextureSize) {
+            SkScalar downScale = maxTextureSize / SkMax32(scaledSize.width(), scaledSize.height());
+            scaledSize.set(SkScalarFloorToScalar(SkScalarMul(scaledSize.width(), downScale)),
+                           SkScalarFloorToScalar(SkScalarMul(scaledSize.height(), downScale)));
+        }
+    }
+#endif
+
+    spec->fSize = scaledSize.toRound();
+    if (spec->fSize.isEmpty()) {
+        return false;
+    }
+    spec->fScale = SkSize::Make(SkIntToScalar(spec->fSize.width()) / tile.width(),
+                                SkIntToScalar(spec->fSize.height()) / tile.height());
+    return true;
+}
+
+// Rasterizes the tile described by spec and adds it to the resource cache under key.
+static SkShader* rasterize_tile(const SkPicture* picture, const SkRect& tile,
+                                SkShader::TileMode tmx, SkShader::TileMode tmy,
+                                const SkMatrix& localMatrix,
+                                const BitmapShaderKey& key, const TileSpec& spec) {
+    SkBitmap bm;
+    bm.setInfo(SkImageInfo::MakeN32Premul(spec.fSize));
+    if (!cache_try_alloc_pixels(&bm)) {
+        return SkShader::CreateEmptyShader();
+    }
+    bm.eraseColor(SK_ColorTRANSPARENT);
+
+    // Always disable LCD text, since we can't assume our image will be opaque.
+    SkCanvas canvas(bm, SkSurfaceProps(0, kUnknown_SkPixelGeometry));
+
+    canvas.scale(spec.fScale.width(), spec.fScale.height());
+    canvas.translate(-tile.x(), -tile.y());
+    canvas.drawPicture(picture);
+
+    SkMatrix shaderMatrix = localMatrix;
+    shaderMatrix.preScale(1 / spec.fScale.width(), 1 / spec.fScale.height());
+    SkShader* tileShader = SkShader::CreateBitmapShader(bm, tmx, tmy, &shaderMatrix);
+
+    SkResourceCache::Add(SkNEW_ARGS(BitmapShaderRec, (key, tileShader, bm.getSize())));
+    return tileShader;
+}
+
 } // namespace
 
 SkPictureShader::SkPictureShader(const SkPicture* picture, TileMode tmx, TileMode tmy,
@@ -112,6 +196,8 @@ SkPictureShader::SkPictureShader(const SkPicture* picture, TileMode tmx, TileMod
 }
 
 SkPictureShader::~SkPictureShader() {
+    // Background tile rasterizations use our picture and pending list, so let them finish first.
+    fTileTasks.wait();
     fPicture->unref();
 }
 
@@ -168,6 +254,17 @@ void SkPictureShader::flatten(SkWriteBuffer& buffer) const {
     }
 }
 
+struct SkPictureShader::TileRequest {
+    TileRequest(const SkPictureShader* shader, const BitmapShaderKey& key, const TileSpec& spec)
+        : fShader(shader)
+        , fKey(key)
+        , fSpec(spec) {}
+
+    const SkPictureShader* fShader;
+    BitmapShaderKey        fKey;
+    TileSpec               fSpec;
+};
+
 SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatrix* localM,
                                             const int maxTextureSize) const {
     SkASSERT(fPicture && !fPicture->cullRect().isEmpty());
@@ -188,68 +285,85 @@ SkShader* SkPictureShader::refBitmapShader(const SkMatrix& matrix, const SkMatri
         scale.set(SkScalarSqrt(m.getScaleX() * m.getScaleX() + m.getSkewX() * m.getSkewX()),
                   SkScalarSqrt(m.getScaleY() * m.getScaleY() + m.getSkewY() * m.getSkewY()));
     }
-    SkSize scaledSize = SkSize::Make(SkScalarAbs(scale.x() * fTile.width()),
-                                     SkScalarAbs(scale.y() * fTile.height()));
-
-    // Clamp the tile size to about 4M pixels
-    static const SkScalar kMaxTileArea = 2048 * 2048;
-    SkScalar tileArea = SkScalarMul(scaledSize.width(), scaledSize.height());
-    if (tileArea > kMaxTileArea) {
-        SkScalar clampScale = SkScalarSqrt(kMaxTileArea / tileArea);
-        scaledSize.set(SkScalarMul(scaledSize.width(), clampScale),
-                       SkScalarMul(scaledSize.height(), clampScale));
-    }
-#if SK_SUPPORT_GPU
-    // Scale down the tile size if larger than maxTextureSize for GPU Path or it should fail on create texture
-    if (maxTextureSize) {
-        if (scaledSize.width() > maxTextureSize || scaledSize.height() > maxTextureSize) {
-            SkScalar downScale = maxTextureSize / SkMax32(scaledSize.width(), scaledSize.height());
-            scaledSize.set(SkScalarFloorToScalar(SkScalarMul(scaledSize.width(), downScale)),
-                           SkScalarFloorToScalar(SkScalarMul(scaledSize.height(), downScale)));
-        }
+    scale.set(SkScalarAbs(scale.x()), SkScalarAbs(scale.y()));
+    if (!(scale.x() > 0 && scale.y() > 0) || !SkScalarsAreFinite(scale.x(), scale.y())) {
+        return SkShader::CreateEmptyShader();
     }
-#endif
 
-    SkISize tileSize = scaledSize.toRound();
-    if (tileSize.isEmpty()) {
+    const int bucketX = scale_bucket(scale.x()),
+              bucketY = scale_bucket(scale.y());
+
+    TileSpec spec;
+    if (!make_tile_spec(fTile, bucketX, bucketY, maxTextureSize, &spec)) {
         return SkShader::CreateEmptyShader();
     }
 
-    // The actual scale, compensating for rounding & clamping.
-    SkSize tileScale = SkSize::Make(SkIntToScalar(tileSize.width()) / fTile.width(),
-                                    SkIntToScalar(tileSize.height()) / fTile.height());
-
     SkAutoTUnref<SkShader> tileShader;
     BitmapShaderKey key(fPicture->uniqueID(),
                         fTile,
                         fTmx,
                         fTmy,
-                        tileScale,
+                        spec.fScale,
                         this->getLocalMatrix());
+    if (SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
+        return tileShader.detach();
+    }
 
-    if (!SkResourceCache::Find(key, BitmapShaderRec::Visitor, &tileShader)) {
-        SkBitmap bm;
-        bm.setInfo(SkImageInfo::MakeN32Premul(tileSize));
-        if (!cache_try_alloc_pixels(&bm)) {
-            return SkShader::CreateEmptyShader();
+    // Our bucket isn't cached.  If a tile from a nearby bucket is, shade with that for now
+    // (preferring the larger, downsampled neighbour at each distance) and rasterize ours in the
+    // background rather than stalling this draw.
+    for (int distance = 1; distance <= kScaleBucketsPerOctave; distance++) {
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            TileSpec nearby;
+            if (!make_tile_spec(fTile, bucketX + sign * distance, bucketY + sign * distance,
+                                maxTextureSize, &nearby) ||
+                nearby.fSize == spec.fSize) {
+                continue;
+            }
+            BitmapShaderKey nearbyKey(fPicture->uniqueID(),
+                                      fTile,
+                                      fTmx,
+                                      fTmy,
+                                      nearby.fScale,
+                                      this->getLocalMatrix());
+            if (SkResourceCache::Find(nearbyKey, BitmapShaderRec::Visitor, &tileShader)) {
+                this->scheduleTile(SkNEW_ARGS(TileRequest, (this, key, spec)));
+                return tileShader.detach();
+            }
         }
-        bm.eraseColor(SK_ColorTRANSPARENT);
-
-        // Always disable LCD text, since we can't assume our image will be opaque.
-        SkCanvas canvas(bm, SkSurfaceProps(0, kUnknown_SkPixelGeometry));
-
-        canvas.scale(tileScale.width(), tileScale.height());
-        canvas.translate(-fTile.x(), -fTile.y());
-        canvas.drawPicture(fPicture);
+    }
 
-        SkMatrix shaderMatrix = this->getLocalMatrix();
-        shaderMatrix.preScale(1 / tileScale.width(), 1 / tileScale.height());
-        tileShader.reset(CreateBitmapShader(bm, fTmx, fTmy, &shaderMatrix));
+    // Nothing close enough is cached, so we have to rasterize our tile right now.
+    tileShader.reset(rasterize_tile(fPicture, fTile, fTmx, fTmy, this->getLocalMatrix(),
+                                    key, spec));
+    return tileShader.detach();
+}
 
-        SkResourceCache::Add(SkNEW_ARGS(BitmapShaderRec, (key, tileShader.get(), bm.getSize())));
+void SkPictureShader::scheduleTile(TileRequest* request) const {
+    {
+        SkAutoMutexAcquire lock(fPendingTilesMutex);
+        if (fPendingTiles.find(request->fKey.hash()) >= 0) {
+            SkDELETE(request);
+            return;
+        }
+        *fPendingTiles.append() = request->fKey.hash();
     }
+    fTileTasks.add(&SkPictureShader::RasterizeTileTask, request);
+}
 
-    return tileShader.detach();
+void SkPictureShader::RasterizeTileTask(TileRequest* request) {
+    const SkPictureShader* shader = request->fShader;
+    SkAutoTUnref<SkShader> tileShader(rasterize_tile(shader->fPicture, shader->fTile,
+                                                     shader->fTmx, shader->fTmy,
+                                                     shader->getLocalMatrix(),
+                                                     request->fKey, request->fSpec));
+    {
+        SkAutoMutexAcquire lock(shader->fPendingTilesMutex);
+        int index = shader->fPendingTiles.find(request->fKey.hash());
+        SkASSERT(index >= 0);
+        shader->fPendingTiles.removeShuffle(index);
+    }
+    SkDELETE(request);
 }
 
 size_t SkPictureShader::contextSize() const {
@@ -8,7 +8,10 @@
 #ifndef SkPictureShader_DEFINED
 #define SkPictureShader_DEFINED
 
+#include "SkMutex.h"
 #include "SkShader.h"
+#include "SkTDArray.h"
+#include "SkTaskGroup.h"
 
 class SkBitmap;
 class SkPicture;
@@ -18,6 +21,10 @@ class SkPicture;
  *
  * The SkPicture is first rendered into a tile, which is then used to shade the area according
  * to specified tiling rules.
+ *
+ * Tiles are rasterized at bucketed scales, so small changes to the CTM (e.g. while zooming) keep
+ * hitting the same cached tile.  When the bucket does change and a tile from a nearby bucket is
+ * still cached, that tile is used while the new one is rasterized in the background.
  */
 class SkPictureShader : public SkShader {
 public:
@@ -44,10 +51,20 @@ private:
 
     SkShader* refBitmapShader(const SkMatrix&, const SkMatrix* localMatrix, const int maxTextureSize = 0) const;
 
+    struct TileRequest;
+    static void RasterizeTileTask(TileRequest*);
+    void scheduleTile(TileRequest*) const;
+
     const SkPicture* fPicture;
     SkRect           fTile;
     TileMode         fTmx, fTmy;
 
+    // Background rasterization of tiles for new scale buckets.  fPendingTiles holds the cache key
+    // hashes of the tiles currently being rasterized, so each is only requested once.
+    mutable SkTaskGroup         fTileTasks;
+    mutable SkMutex             fPendingTilesMutex;
+    mutable SkTDArray<uint32_t> fPendingTiles;
+
     class PictureShaderContext : public SkShader::Context {
     public:
         static Context* Create(void* storage, const SkPictureShader&, const ContextRec&,
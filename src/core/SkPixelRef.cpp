@@ -399,6 +399,32 @@ bool SkPixelRef::onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBy
     return false;
 }
 
+SkISize SkPixelRef::onGetScaledDimensions(SkScalar) {
+    return SkISize::Make(fInfo.width(), fInfo.height());
+}
+
+bool SkPixelRef::onGenerateScaledPixels(const SkImageInfo&, void*, size_t) {
+    return false;
+}
+
+SkISize SkPixelRef::getScaledDimensions(SkScalar desiredScale) {
+    if (!(desiredScale > 0 && desiredScale < 1)) {
+        return SkISize::Make(fInfo.width(), fInfo.height());
+    }
+    SkAutoMutexAcquire ac(*fMutex);
+    return this->onGetScaledDimensions(desiredScale);
+}
+
+bool SkPixelRef::generateScaledPixels(const SkImageInfo& info, void* pixels, size_t rowBytes) {
+    if (info.isEmpty() || NULL == pixels || rowBytes < info.minRowBytes() ||
+        kIndex_8_SkColorType == info.colorType() ||
+        (info.width() == fInfo.width() && info.height() == fInfo.height())) {
+        return false;
+    }
+    SkAutoMutexAcquire ac(*fMutex);
+    return this->onGenerateScaledPixels(info, pixels, rowBytes);
+}
+
 size_t SkPixelRef::getAllocatedSizeInBytes() const {
     return 0;
 }
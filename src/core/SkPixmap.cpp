@@ -7,7 +7,9 @@
 
 #include "SkColorPriv.h"
 #include "SkConfig8888.h"
+#include "SkHalf.h"
 #include "SkMask.h"
+#include "SkPMFloat.h"
 #include "SkPixmap.h"
 #include "SkUtils.h"
 
@@ -199,6 +201,23 @@ bool SkPixmap::erase(SkColor color, const SkIRect& inArea) const {
             }
             break;
         }
+        case kRGBA_F16_SkColorType: {
+            uint64_t* p = this->writable_addr64(area.fLeft, area.fTop);
+
+            // Premultiply in float so the half-float color keeps its precision.
+            float fa = a * (1.0f / 255);
+            float scale = kPremul_SkAlphaType == this->alphaType() ? fa * (1.0f / 255)
+                                                                   : (1.0f / 255);
+            uint64_t v = SkPMFloatToHalf(SkPMFloat::FromARGB(fa, r * scale, g * scale, b * scale));
+
+            while (--height >= 0) {
+                for (int x = 0; x < width; ++x) {
+                    p[x] = v;
+                }
+                p = (uint64_t*)((char*)p + rowBytes);
+            }
+            break;
+        }
         default:
             return false; // no change, so don't call notifyPixelsChanged()
     }
@@ -5,9 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkNx.h"
 #include "SkRTree.h"
+#include "SkTSort.h"
 
-SkRTree::SkRTree(SkScalar aspectRatio) : fCount(0), fAspectRatio(aspectRatio) {}
+SkRTree::SkRTree(SkScalar aspectRatio, SkRTreeFactory::BulkLoad bulkLoad)
+    : fCount(0), fAspectRatio(aspectRatio), fBulkLoad(bulkLoad) {}
 
 SkRect SkRTree::getRootBound() const {
     if (fCount) {
@@ -31,7 +34,7 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
 
         Branch* b = branches.push();
         b->fBounds = bounds;
-        b->fOpIndex = i;
+        b->fIndex = i;
     }
 
     fCount = branches.count();
@@ -39,11 +42,13 @@ void SkRTree::insert(const SkRect boundsArray[], int N) {
         if (1 == fCount) {
             fNodes.setReserve(1);
             Node* n = this->allocateNodeAtLevel(0);
-            n->fNumChildren = 1;
-            n->fChildren[0] = branches[0];
-            fRoot.fSubtree = n;
-            fRoot.fBounds  = branches[0].fBounds;
+            n->addChild(branches[0]);
+            fRoot.fIndex  = 0;
+            fRoot.fBounds = branches[0].fBounds;
         } else {
+            if (SkRTreeFactory::kHilbert_BulkLoad == fBulkLoad) {
+                HilbertSort(&branches);
+            }
             fNodes.setReserve(CountNodes(fCount, fAspectRatio));
             fRoot = this->bulkLoad(&branches);
         }
@@ -56,6 +61,11 @@ SkRTree::Node* SkRTree::allocateNodeAtLevel(uint16_t level) {
     SkASSERT(fNodes.begin() == p);  // If this fails, we didn't setReserve() enough.
     out->fNumChildren = 0;
     out->fLevel = level;
+    for (int i = 0; i < kChildSlots; ++i) {
+        out->fLeft[i] = out->fTop[i]     =  SK_ScalarInfinity;
+        out->fRight[i] = out->fBottom[i] = -SK_ScalarInfinity;
+        out->fChildren[i] = 0;
+    }
     return out;
 }
 
@@ -100,6 +110,65 @@ int SkRTree::CountNodes(int branches, SkScalar aspectRatio) {
     return nodes + CountNodes(nodes, aspectRatio);
 }
 
+// Position of (x, y) along a Hilbert curve filling a 2^16 x 2^16 grid.
+static uint32_t hilbert_index(uint32_t x, uint32_t y) {
+    static const uint32_t kMax = 0xFFFF;
+    uint32_t d = 0;
+    for (uint32_t s = 1 << 15; s > 0; s >>= 1) {
+        uint32_t rx = (x & s) ? 1 : 0;
+        uint32_t ry = (y & s) ? 1 : 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate the quadrant so the curve within it starts and ends in the right corners.
+        if (0 == ry) {
+            if (1 == rx) {
+                x = kMax - x;
+                y = kMax - y;
+            }
+            SkTSwap(x, y);
+        }
+    }
+    return d;
+}
+
+namespace {
+struct HilbertBranch {
+    uint32_t fIndex;
+    int fBranch;
+    bool operator<(const HilbertBranch& other) const {
+        return fIndex < other.fIndex || (fIndex == other.fIndex && fBranch < other.fBranch);
+    }
+};
+}  // namespace
+
+void SkRTree::HilbertSort(SkTDArray<Branch>* branches) {
+    const int count = branches->count();
+    SkRect bounds = (*branches)[0].fBounds;
+    for (int i = 1; i < count; ++i) {
+        bounds.join((*branches)[i].fBounds);
+    }
+    // Map the centers onto the grid. Bounds may be empty in either dimension.
+    const SkScalar kGridMax = 65535;
+    const SkScalar scaleX = bounds.width()  > 0 ? kGridMax / bounds.width()  : 0;
+    const SkScalar scaleY = bounds.height() > 0 ? kGridMax / bounds.height() : 0;
+
+    SkAutoTMalloc<HilbertBranch> sorted(count);
+    for (int i = 0; i < count; ++i) {
+        const SkRect& r = (*branches)[i].fBounds;
+        uint32_t x = (uint32_t)SkScalarTruncToInt((r.centerX() - bounds.fLeft) * scaleX);
+        uint32_t y = (uint32_t)SkScalarTruncToInt((r.centerY() - bounds.fTop)  * scaleY);
+        sorted[i].fIndex  = hilbert_index(SkTMin<uint32_t>(x, 0xFFFF), SkTMin<uint32_t>(y, 0xFFFF));
+        sorted[i].fBranch = i;
+    }
+    SkTQSort(sorted.get(), sorted.get() + count - 1);
+
+    SkTDArray<Branch> reordered;
+    reordered.setCount(count);
+    for (int i = 0; i < count; ++i) {
+        reordered[i] = (*branches)[sorted[i].fBranch];
+    }
+    branches->swap(reordered);
+}
+
 SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
     if (branches->count() == 1) { // Only one branch.  It will be the root.
         return (*branches)[0];
@@ -141,16 +210,14 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
                 }
             }
             Node* n = allocateNodeAtLevel(level);
-            n->fNumChildren = 1;
-            n->fChildren[0] = (*branches)[currentBranch];
+            n->addChild((*branches)[currentBranch]);
             Branch b;
             b.fBounds = (*branches)[currentBranch].fBounds;
-            b.fSubtree = n;
+            b.fIndex = SkToU32(n - fNodes.begin());
             ++currentBranch;
             for (int k = 1; k < incrementBy && currentBranch < branches->count(); ++k) {
                 b.fBounds.join((*branches)[currentBranch].fBounds);
-                n->fChildren[k] = (*branches)[currentBranch];
-                ++n->fNumChildren;
+                n->addChild((*branches)[currentBranch]);
                 ++currentBranch;
             }
             (*branches)[newBranches] = b;
@@ -163,17 +230,39 @@ SkRTree::Branch SkRTree::bulkLoad(SkTDArray<Branch>* branches, int level) {
 
 void SkRTree::search(const SkRect& query, SkTDArray<unsigned>* results) const {
     if (fCount > 0 && SkRect::Intersects(fRoot.fBounds, query)) {
-        this->search(fRoot.fSubtree, query, results);
+        const int start = results->count();
+        this->search(fNodes[fRoot.fIndex], query, results);
+        // Hilbert order loses the op order the leaves were given in; callers want it back.
+        if (SkRTreeFactory::kHilbert_BulkLoad == fBulkLoad && results->count() - start > 1) {
+            SkTQSort(results->begin() + start, results->end() - 1);
+        }
     }
 }
 
-void SkRTree::search(Node* node, const SkRect& query, SkTDArray<unsigned>* results) const {
-    for (int i = 0; i < node->fNumChildren; ++i) {
-        if (SkRect::Intersects(node->fChildren[i].fBounds, query)) {
-            if (0 == node->fLevel) {
-                results->push(node->fChildren[i].fOpIndex);
-            } else {
-                this->search(node->fChildren[i].fSubtree, query, results);
+void SkRTree::search(const Node& node, const SkRect& query,
+                     SkTDArray<unsigned>* results) const {
+    const Sk4s queryL(query.fLeft), queryT(query.fTop), queryR(query.fRight), queryB(query.fBottom);
+    const Sk4s zero(0);
+    for (int i = 0; i < node.fNumChildren; i += 4) {
+        // A child intersects the query when their overlap is positive in both directions.
+        Sk4s w = Sk4s::Min(Sk4s::Load(node.fRight + i), queryR) -
+                 Sk4s::Max(Sk4s::Load(node.fLeft + i), queryL);
+        Sk4s h = Sk4s::Min(Sk4s::Load(node.fBottom + i), queryB) -
+                 Sk4s::Max(Sk4s::Load(node.fTop + i), queryT);
+        Sk4s overlap = Sk4s::Min(w, h);
+        if (!(overlap > zero).anyTrue()) {
+            continue;
+        }
+        SkScalar overlaps[4];
+        overlap.store(overlaps);
+        // Empty slots never overlap, so there is no need to check fNumChildren here.
+        for (int j = 0; j < 4; ++j) {
+            if (overlaps[j] > 0) {
+                if (0 == node.fLevel) {
+                    results->push(node.fChildren[i + j]);
+                } else {
+                    this->search(fNodes[node.fChildren[i + j]], query, results);
+                }
             }
         }
     }
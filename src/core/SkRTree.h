@@ -9,6 +9,7 @@
 #ifndef SkRTree_DEFINED
 #define SkRTree_DEFINED
 
+#include "SkBBHFactory.h"
 #include "SkBBoxHierarchy.h"
 #include "SkRect.h"
 #include "SkTDArray.h"
@@ -18,11 +19,11 @@
  * bounding rectangles.
  *
  * It only supports bulk-loading, i.e. creation from a batch of bounding rectangles.
- * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm.
+ * This performs a bottom-up bulk load using the STR (sort-tile-recursive) algorithm, or
+ * optionally the Hilbert pack variant, which first sorts rects by the position of their
+ * centers on the Hilbert curve.
  *
- * TODO: Experiment with other bulk-load algorithms (in particular the Hilbert pack variant,
- * which groups rects by position on the Hilbert curve, is probably worth a look). There also
- * exist top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
+ * TODO: Experiment with top-down bulk load variants (VAMSplit, TopDownGreedy, etc).
  *
  * For more details see:
  *
@@ -31,14 +32,15 @@
  */
 class SkRTree : public SkBBoxHierarchy {
 public:
-    
-
     /**
      * If you have some prior information about the distribution of bounds you're expecting, you
      * can provide an optional aspect ratio parameter. This allows the bulk-load algorithm to
      * create better proportioned tiles of rectangles.
+     *
+     * search() returns op indices in ascending order with either bulk load.
      */
-    explicit SkRTree(SkScalar aspectRatio = 1);
+    explicit SkRTree(SkScalar aspectRatio = 1,
+                     SkRTreeFactory::BulkLoad = SkRTreeFactory::kSTR_BulkLoad);
     virtual ~SkRTree() {}
 
     void insert(const SkRect[], int N) override;
@@ -48,7 +50,7 @@ public:
     // Methods and constants below here are only public for tests.
 
     // Return the depth of the tree structure.
-    int getDepth() const { return fCount ? fRoot.fSubtree->fLevel + 1 : 0; }
+    int getDepth() const { return fCount ? fNodes[fRoot.fIndex].fLevel + 1 : 0; }
     // Insertion count (not overall node count, which may be greater).
     int getCount() const { return fCount; }
 
@@ -60,23 +62,42 @@ public:
                      kMaxChildren = 11;
 
 private:
-    struct Node;
+    // Children are tested four at a time, so nodes have room for a multiple of four.
+    static const int kChildSlots = SkAlign4(kMaxChildren);
 
     struct Branch {
-        union {
-            Node* fSubtree;
-            unsigned fOpIndex;
-        };
+        // For leaves this is the op index, otherwise the index of the node in fNodes.
+        unsigned fIndex;
         SkRect fBounds;
     };
 
+    // Nodes are allocated bottom-up into fNodes, so each level is contiguous and the tree
+    // is searched without chasing pointers.  Child bounds are stored one array per edge.
+    // Slots from fNumChildren on hold bounds that intersect nothing.
     struct Node {
         uint16_t fNumChildren;
         uint16_t fLevel;
-        Branch fChildren[kMaxChildren];
+        SkScalar fLeft[kChildSlots];
+        SkScalar fTop[kChildSlots];
+        SkScalar fRight[kChildSlots];
+        SkScalar fBottom[kChildSlots];
+        unsigned fChildren[kChildSlots];
+
+        void addChild(const Branch& branch) {
+            SkASSERT(fNumChildren < kMaxChildren);
+            fLeft  [fNumChildren] = branch.fBounds.fLeft;
+            fTop   [fNumChildren] = branch.fBounds.fTop;
+            fRight [fNumChildren] = branch.fBounds.fRight;
+            fBottom[fNumChildren] = branch.fBounds.fBottom;
+            fChildren[fNumChildren] = branch.fIndex;
+            ++fNumChildren;
+        }
     };
 
-    void search(Node* root, const SkRect& query, SkTDArray<unsigned>* results) const;
+    void search(const Node&, const SkRect& query, SkTDArray<unsigned>* results) const;
+
+    // Reorders the branches by the Hilbert index of their centers.
+    static void HilbertSort(SkTDArray<Branch>* branches);
 
     // Consumes the input array.
     Branch bulkLoad(SkTDArray<Branch>* branches, int level = 0);
@@ -89,6 +110,7 @@ private:
     // This is the count of data elements (rather than total nodes in the tree)
     int fCount;
     SkScalar fAspectRatio;
+    SkRTreeFactory::BulkLoad fBulkLoad;
     Branch fRoot;
     SkTDArray<Node> fNodes;
 
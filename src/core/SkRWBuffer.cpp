@@ -6,6 +6,7 @@
  */
 
 #include "SkRWBuffer.h"
+#include "SkData.h"
 #include "SkStream.h"
 
 // Force small chunks to be a page's worth
@@ -15,8 +16,9 @@ struct SkBufferBlock {
     SkBufferBlock*  fNext;
     size_t          fUsed;
     size_t          fCapacity;
+    const SkData*   fData;      // if set, the block's bytes are fData's, and it is full
 
-    const void* startData() const { return this + 1; };
+    const void* startData() const { return fData ? fData->data() : this + 1; };
 
     size_t avail() const { return fCapacity - fUsed; }
     void* availData() { return (char*)this->startData() + fUsed; }
@@ -27,9 +29,26 @@ struct SkBufferBlock {
         block->fNext = NULL;
         block->fUsed = 0;
         block->fCapacity = capacity;
+        block->fData = NULL;
         return block;
     }
 
+    // Refers to data's bytes rather than copying them.
+    static SkBufferBlock* AllocShared(const SkData* data) {
+        SkASSERT(data->size() > 0);
+        SkBufferBlock* block = (SkBufferBlock*)sk_malloc_throw(sizeof(SkBufferBlock));
+        block->fNext = NULL;
+        block->fUsed = data->size();
+        block->fCapacity = data->size();
+        block->fData = SkRef(data);
+        return block;
+    }
+
+    static void Free(SkBufferBlock* block) {
+        SkSafeUnref(block->fData);
+        sk_free(block);
+    }
+
     // Return number of bytes actually appended
     size_t append(const void* src, size_t length) {
         this->validate();
@@ -71,6 +90,18 @@ struct SkBufferHead {
         head->fBlock.fNext = NULL;
         head->fBlock.fUsed = 0;
         head->fBlock.fCapacity = capacity;
+        head->fBlock.fData = NULL;
+        return head;
+    }
+
+    static SkBufferHead* AllocShared(const SkData* data) {
+        SkASSERT(data->size() > 0);
+        SkBufferHead* head = (SkBufferHead*)sk_malloc_throw(sizeof(SkBufferHead));
+        head->fRefCnt = 1;
+        head->fBlock.fNext = NULL;
+        head->fBlock.fUsed = data->size();
+        head->fBlock.fCapacity = data->size();
+        head->fBlock.fData = SkRef(data);
         return head;
     }
 
@@ -85,10 +116,11 @@ struct SkBufferHead {
         if (1 == sk_atomic_fetch_add(&fRefCnt, -1, sk_memory_order_acq_rel)) {
             // Like unique(), the acquire is only needed on success.
             SkBufferBlock* block = fBlock.fNext;
+            SkSafeUnref(fBlock.fData);
             sk_free((void*)this);
             while (block) {
                 SkBufferBlock* next = block->fNext;
-                sk_free(block);
+                SkBufferBlock::Free(block);
                 block = next;
             }
         }
@@ -165,7 +197,9 @@ SkRWBuffer::SkRWBuffer(size_t initialCapacity) : fHead(NULL), fTail(NULL), fTota
 
 SkRWBuffer::~SkRWBuffer() {
     this->validate();
-    fHead->unref();
+    if (fHead) {
+        fHead->unref();
+    }
 }
 
 void SkRWBuffer::append(const void* src, size_t length) {
@@ -196,6 +230,26 @@ void SkRWBuffer::append(const void* src, size_t length) {
     this->validate();
 }
 
+void SkRWBuffer::append(const SkData* data) {
+    this->validate();
+    if (0 == data->size()) {
+        return;
+    }
+
+    fTotalUsed += data->size();
+
+    // The shared block is full, so the next append starts a block of our own after it.
+    if (NULL == fHead) {
+        fHead = SkBufferHead::AllocShared(data);
+        fTail = &fHead->fBlock;
+    } else {
+        SkBufferBlock* block = SkBufferBlock::AllocShared(data);
+        fTail->fNext = block;
+        fTail = block;
+    }
+    this->validate();
+}
+
 void* SkRWBuffer::append(size_t length) {
     this->validate();
     if (0 == length) {
@@ -351,3 +405,124 @@ SkStreamAsset* SkRWBuffer::newStreamSnapshot() const {
     SkAutoTUnref<SkROBuffer> buffer(this->newRBufferSnapshot());
     return SkNEW_ARGS(SkROBufferStreamAsset, (buffer));
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Reads an SkSharedStreamBuffer, taking a new snapshot of it whenever it reads past the end of the
+// current one.
+class SkSharedStreamReader : public SkStreamRewindable {
+public:
+    SkSharedStreamReader(SkSharedStreamBuffer* buffer)
+        : fBuffer(SkRef(buffer))
+        , fIter(NULL)
+        , fBlockStart(0)
+        , fPosition(0) {}
+
+    size_t read(void* dst, size_t size) override {
+        size_t bytesRead = 0;
+        while (bytesRead < size) {
+            if (fPosition == this->snapshotSize() && !this->refill(size - bytesRead)) {
+                break;  // ran out of data
+            }
+            // fPosition is within the snapshot, so fIter's block, or a later one, holds it.
+            const size_t offset = fPosition - fBlockStart;
+            if (offset == fIter.size()) {
+                fBlockStart += fIter.size();
+                SkAssertResult(fIter.next());
+                continue;
+            }
+            const size_t avail = SkTMin(fIter.size() - offset, size - bytesRead);
+            if (dst) {
+                memcpy((char*)dst + bytesRead, (const char*)fIter.data() + offset, avail);
+            }
+            bytesRead += avail;
+            fPosition += avail;
+        }
+        return bytesRead;
+    }
+
+    bool isAtEnd() const override {
+        return fPosition == this->snapshotSize() && fBuffer->isAtEnd(fPosition);
+    }
+
+    bool rewind() override {
+        fIter.reset(fSnapshot);
+        fBlockStart = fPosition = 0;
+        return true;
+    }
+
+    SkStreamRewindable* duplicate() const override {
+        return SkNEW_ARGS(SkSharedStreamReader, (fBuffer));
+    }
+
+    bool hasPosition() const override { return true; }
+    size_t getPosition() const override { return fPosition; }
+
+    bool hasLength() const override { return fBuffer->fHasLength; }
+    size_t getLength() const override { return fBuffer->fLength; }
+
+private:
+    size_t snapshotSize() const { return fSnapshot ? fSnapshot->size() : 0; }
+
+    // Takes a new snapshot that holds at least one byte past fPosition, asking for want bytes.
+    // Returns false if the stream has nothing more.
+    bool refill(size_t want) {
+        SkAutoTUnref<SkROBuffer> snapshot(fBuffer->newSnapshotTo(fPosition + want));
+        if (snapshot->size() <= fPosition) {
+            return false;
+        }
+        fSnapshot.reset(snapshot.detach());
+
+        // The old blocks are unchanged, so find fPosition's block again in the new snapshot.
+        fIter.reset(fSnapshot);
+        fBlockStart = 0;
+        while (fBlockStart + fIter.size() <= fPosition) {
+            fBlockStart += fIter.size();
+            SkAssertResult(fIter.next());
+        }
+        return true;
+    }
+
+    SkAutoTUnref<SkSharedStreamBuffer> fBuffer;
+    SkAutoTUnref<SkROBuffer>           fSnapshot;    // NULL until the first read
+    SkROBuffer::Iter                   fIter;
+    size_t                             fBlockStart;  // offset of fIter's block
+    size_t                             fPosition;
+};
+
+SkSharedStreamBuffer::SkSharedStreamBuffer(SkStream* stream)
+    : fStream(stream)
+    , fHasLength(stream->hasPosition() && stream->hasLength())
+    , fLength(fHasLength ? stream->getLength() - stream->getPosition() : 0) {}
+
+SkSharedStreamBuffer::~SkSharedStreamBuffer() {}
+
+SkStreamRewindable* SkSharedStreamBuffer::newReader() {
+    return SkNEW_ARGS(SkSharedStreamReader, (this));
+}
+
+SkStreamRewindable* SkSharedStreamBuffer::NewReader(SkStream* stream) {
+    if (NULL == stream) {
+        return NULL;
+    }
+    SkAutoTUnref<SkSharedStreamBuffer> buffer(SkNEW_ARGS(SkSharedStreamBuffer, (stream)));
+    return buffer->newReader();
+}
+
+SkROBuffer* SkSharedStreamBuffer::newSnapshotTo(size_t end) {
+    SkAutoMutexAcquire lock(fMutex);
+    char chunk[4096];
+    while (fBuffer.size() < end) {
+        const size_t bytes = fStream->read(chunk, SkTMin(sizeof(chunk), end - fBuffer.size()));
+        if (0 == bytes) {
+            break;
+        }
+        fBuffer.append(chunk, bytes);
+    }
+    return fBuffer.newRBufferSnapshot();
+}
+
+bool SkSharedStreamBuffer::isAtEnd(size_t position) const {
+    SkAutoMutexAcquire lock(fMutex);
+    return position >= fBuffer.size() && fStream->isAtEnd();
+}
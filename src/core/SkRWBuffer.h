@@ -8,12 +8,17 @@
 #ifndef SkRWBuffer_DEFINED
 #define SkRWBuffer_DEFINED
 
+#include "SkMutex.h"
 #include "SkRefCnt.h"
+#include "SkTemplates.h"
 
 struct SkBufferBlock;
 struct SkBufferHead;
+class SkData;
 class SkRWBuffer;
+class SkStream;
 class SkStreamAsset;
+class SkStreamRewindable;
 
 /**
  *  Contains a read-only, thread-sharable block of memory. To access the memory, the caller must
@@ -79,6 +84,12 @@ public:
     void append(const void* buffer, size_t length);
     void* append(size_t length);
 
+    /**
+     *  Appends data's bytes without copying them: the buffer, and the snapshots that see them,
+     *  share a ref on data instead.
+     */
+    void append(const SkData* data);
+
     SkROBuffer* newRBufferSnapshot() const;
     SkStreamAsset* newStreamSnapshot() const;
     
@@ -94,4 +105,43 @@ private:
     size_t          fTotalUsed;
 };
 
+/**
+ *  Reads a stream into an SkRWBuffer as its readers need it, so that any number of readers can
+ *  read the stream from the start, and rewind, while sharing the one copy of it.  Unlike
+ *  SkFrontBufferedStream, there is no limit on how far a reader may go before it rewinds.
+ *  Readers may be used on different threads.
+ */
+class SkSharedStreamBuffer : public SkRefCnt {
+public:
+    /** Takes ownership of stream, which must be positioned at the start of the data. */
+    explicit SkSharedStreamBuffer(SkStream* stream);
+    virtual ~SkSharedStreamBuffer();
+
+    /**
+     *  Returns a new reader, positioned at the start.  Its duplicate() returns another reader of
+     *  this buffer.  The caller must delete it.
+     */
+    SkStreamRewindable* newReader();
+
+    /** Buffers stream, which it takes ownership of, and returns the buffer's first reader. */
+    static SkStreamRewindable* NewReader(SkStream* stream);
+
+private:
+    friend class SkSharedStreamReader;
+
+    // Reads the stream until at least end bytes are buffered, or it runs out, and returns a
+    // snapshot of what has been buffered.
+    SkROBuffer* newSnapshotTo(size_t end);
+    // True if everything has been read from the stream, and position is beyond it.
+    bool isAtEnd(size_t position) const;
+
+    mutable SkMutex         fMutex;
+    SkAutoTDelete<SkStream> fStream;
+    SkRWBuffer              fBuffer;
+    bool                    fHasLength;
+    size_t                  fLength;
+
+    typedef SkRefCnt INHERITED;
+};
+
 #endif
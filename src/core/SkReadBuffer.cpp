@@ -8,6 +8,7 @@
 
 #include "SkBitmap.h"
 #include "SkErrorInternals.h"
+#include "SkImage.h"
 #include "SkReadBuffer.h"
 #include "SkStream.h"
 #include "SkTypeface.h"
@@ -274,6 +275,26 @@ bool SkReadBuffer::readBitmap(SkBitmap* bitmap) {
     return false;
 }
 
+SkImage* SkReadBuffer::readImage() {
+    int width = this->read32();
+    int height = this->read32();
+    if (width <= 0 || height <= 0) {    // SkImage never has a zero dimension
+        this->validate(false);
+        return NULL;
+    }
+
+    SkAutoTUnref<SkData> encoded(this->readByteArrayAsData());
+    int originX = this->read32();
+    int originY = this->read32();
+    if (0 == encoded->size() || originX < 0 || originY < 0) {
+        this->validate(false);
+        return NULL;
+    }
+
+    const SkIRect subset = SkIRect::MakeXYWH(originX, originY, width, height);
+    return SkImage::NewFromEncoded(encoded, &subset);
+}
+
 SkTypeface* SkReadBuffer::readTypeface() {
 
     uint32_t index = fReader.readU32();
@@ -26,6 +26,7 @@
 #include "SkXfermode.h"
 
 class SkBitmap;
+class SkImage;
 
 #if defined(SK_DEBUG) && defined(SK_BUILD_FOR_MAC)
     #define DEBUG_NON_DETERMINISTIC_ASSERT
@@ -169,6 +170,11 @@ public:
      */
     bool readBitmap(SkBitmap* bitmap);
 
+    /**
+     *  Returns an image written by SkWriteBuffer::writeImage(), or NULL if it could not be read.
+     */
+    SkImage* readImage();
+
     virtual SkTypeface* readTypeface();
 
     void setBitmapStorage(SkBitmapHeapReader* bitmapStorage) {
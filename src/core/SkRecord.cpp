@@ -8,10 +8,31 @@
 #include "SkRecord.h"
 
 SkRecord::~SkRecord() {
+    this->destroyCommands();
+}
+
+void SkRecord::reset() {
+    this->destroyCommands();
+    fCount = 0;
+    fPaints.reset();
+    fAlloc.reset(kInlineAllocLgBytes+1, fInlineAlloc, sizeof(fInlineAlloc));
+}
+
+void SkRecord::destroyCommands() {
     Destroyer destroyer;
     for (unsigned i = 0; i < this->count(); i++) {
         this->mutate<void>(i, destroyer);
     }
+    fPaints.foreach([](const SkPaint** paint) { (*paint)->~SkPaint(); });
+}
+
+const SkPaint* SkRecord::internPaint(const SkPaint& paint) {
+    if (const SkPaint** found = fPaints.find(paint)) {
+        return *found;
+    }
+    const SkPaint* copy = SkNEW_PLACEMENT_ARGS(this->alloc<SkPaint>(), SkPaint, (paint));
+    fPaints.set(copy);
+    return copy;
 }
 
 void SkRecord::grow() {
@@ -9,6 +9,7 @@
 #define SkRecord_DEFINED
 
 #include "SkRecords.h"
+#include "SkTHash.h"
 #include "SkTLogic.h"
 #include "SkTemplates.h"
 #include "SkVarAlloc.h"
@@ -39,6 +40,10 @@ public:
                  fInlineAlloc, sizeof(fInlineAlloc)) {}
     ~SkRecord();
 
+    // Destroys every command, leaving this SkRecord empty to record into again.  The space for
+    // the commands is kept, and blocks of command data go back to SkVarAlloc for reuse.
+    void reset();
+
     // Returns the number of canvas commands in this SkRecord.
     unsigned count() const { return fCount; }
 
@@ -71,6 +76,10 @@ public:
         return (T*)fAlloc.alloc(sizeof(T) * count, SK_MALLOC_THROW);
     }
 
+    // Returns a copy of paint that lives as long as this SkRecord, shared by every caller passing
+    // an equal paint.  This is how commands get the paints their SkRecords::SharedPaint point to.
+    const SkPaint* internPaint(const SkPaint& paint);
+
     // Add a new command of type T to the end of this SkRecord.
     // You are expected to placement new an object of type T onto this pointer.
     template <typename T>
@@ -127,6 +136,9 @@ private:
     // We store the types of each of the pointers alongside the pointer.
     // The cost to append a T to this structure is 8 + sizeof(T) bytes.
 
+    // Destroys every command and interned paint, but doesn't reset fCount or fPaints.
+    void destroyCommands();
+
     // A mutator that can be used with replace to destroy canvas commands.
     struct Destroyer {
         template <typename T>
@@ -144,6 +156,11 @@ private:
 
     void grow();
 
+    struct PaintTraits {
+        static const SkPaint& GetKey(const SkPaint* paint) { return *paint; }
+        static uint32_t Hash(const SkPaint& paint) { return paint.getHash(); }
+    };
+
     // A typed pointer to some bytes in fAlloc.  visit() and mutate() allow polymorphic dispatch.
     struct Record {
         // On 32-bit machines we store type in 4 bytes, followed by a pointer.  Simple.
@@ -193,6 +210,9 @@ private:
     // chunks, returning a stable handle to that data for later retrieval.
     SkVarAlloc fAlloc;
     char fInlineAlloc[1 << kInlineAllocLgBytes];
+
+    // The paints handed out by internPaint(), which live in fAlloc.
+    SkTHashTable<const SkPaint*, SkPaint, PaintTraits> fPaints;
 };
 
 #endif//SkRecord_DEFINED
@@ -5,9 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkColorFilter.h"
 #include "SkLayerInfo.h"
 #include "SkRecordDraw.h"
 #include "SkPatchUtils.h"
+#include "SkTaskGroup.h"
+#include "SkTraceEvent.h"
+
+static void cull_occluded_ops(const SkRecord&, const SkCanvas*, const SkRect& query,
+                              SkTDArray<unsigned>* ops);
 
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
@@ -16,51 +22,54 @@ void SkRecordDraw(const SkRecord& record,
                   int drawableCount,
                   const SkBBoxHierarchy* bbh,
                   SkPicture::AbortCallback* callback) {
+    TRACE_EVENT1("disabled-by-default-skia", "SkRecordDraw()", "ops", record.count());
     SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
 
+    // The SkRecord and BBH were recorded in identity space.  This canvas
+    // is not necessarily in that same space.  getClipBounds() returns us
+    // this canvas' clip bounds transformed back into identity space, which
+    // lets us query the BBH.
+    SkRect query;
+    if (!canvas->getClipBounds(&query)) {
+        query.setEmpty();
+    }
+
+    SkTDArray<unsigned> ops;
     if (bbh) {
         // Draw only ops that affect pixels in the canvas's current clip.
-        // The SkRecord and BBH were recorded in identity space.  This canvas
-        // is not necessarily in that same space.  getClipBounds() returns us
-        // this canvas' clip bounds transformed back into identity space, which
-        // lets us query the BBH.
-        SkRect query;
-        if (!canvas->getClipBounds(&query)) {
-            query.setEmpty();
-        }
-
-        SkTDArray<unsigned> ops;
         bbh->search(query, &ops);
-
-        SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
-        for (int i = 0; i < ops.count(); i++) {
-            if (callback && callback->abort()) {
-                return;
-            }
-            // This visit call uses the SkRecords::Draw::operator() to call
-            // methods on the |canvas|, wrapped by methods defined with the
-            // DRAW() macro.
-            record.visit<void>(ops[i], draw);
-        }
     } else {
         // Draw all ops.
-        SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
+        ops.setCount(record.count());
         for (unsigned i = 0; i < record.count(); i++) {
-            if (callback && callback->abort()) {
-                return;
-            }
-            // This visit call uses the SkRecords::Draw::operator() to call
-            // methods on the |canvas|, wrapped by methods defined with the
-            // DRAW() macro.
-            record.visit<void>(i, draw);
+            ops[i] = i;
         }
     }
+
+    // Finding hidden ops means looking at the whole record, so don't bother when the BBH has
+    // already narrowed things down to a small part of it.
+    if (ops.count() > 0 && 2 * (unsigned)ops.count() >= record.count()) {
+        TRACE_EVENT0("disabled-by-default-skia", "SkRecordDraw::cullOccludedOps()");
+        cull_occluded_ops(record, canvas, query, &ops);
+    }
+
+    SkRecords::Draw draw(canvas, drawablePicts, drawables, drawableCount);
+    for (int i = 0; i < ops.count(); i++) {
+        if (callback && callback->abort()) {
+            return;
+        }
+        // This visit call uses the SkRecords::Draw::operator() to call
+        // methods on the |canvas|, wrapped by methods defined with the
+        // DRAW() macro.
+        record.visit<void>(ops[i], draw);
+    }
 }
 
 void SkRecordPartialDraw(const SkRecord& record, SkCanvas* canvas,
                          SkPicture const* const drawablePicts[], int drawableCount,
                          unsigned start, unsigned stop,
                          const SkMatrix& initialCTM) {
+    TRACE_EVENT0("disabled-by-default-skia", "SkRecordPartialDraw()");
     SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
 
     stop = SkTMin(stop, record.count());
@@ -95,7 +104,7 @@ DRAW(DrawBitmapRectFast,
         legacy_drawBitmapRect(r.bitmap.shallowCopy(), r.src, r.dst, r.paint,
                        SkCanvas::kFast_SrcRectConstraint));
 DRAW(DrawBitmapRectFixedSize,
-        legacy_drawBitmapRect(r.bitmap.shallowCopy(), &r.src, r.dst, &r.paint, r.constraint));
+        legacy_drawBitmapRect(r.bitmap.shallowCopy(), &r.src, r.dst, r.paint.get(), r.constraint));
 DRAW(DrawDRRect, drawDRRect(r.outer, r.inner, r.paint));
 DRAW(DrawImage, drawImage(r.image, r.left, r.top, r.paint));
 DRAW(DrawImageRect, legacy_drawImageRect(r.image, r.src, r.dst, r.paint, r.constraint));
@@ -119,6 +128,25 @@ DRAW(DrawVertices, drawVertices(r.vmode, r.vertexCount, r.vertices, r.texs, r.co
                                 r.xmode.get(), r.indices, r.indexCount, r.paint));
 #undef DRAW
 
+template <> void Draw::draw(const DrawImageRects& r) {
+    // Ganesh draws the whole run as a single atlas batch.  Elsewhere drawing an atlas is slower
+    // than drawing each image rect, which can often be blit straight to the device.
+    if (fCanvas->getGrContext()) {
+        SkAutoSTMalloc<32, SkRSXform> xforms(r.count);
+        for (int i = 0; i < r.count; i++) {
+            const SkRect& src = r.srcs[i];
+            const SkRect& dst = r.dsts[i];
+            xforms[i] = SkRSXform::Make(dst.width() / src.width(), 0, dst.fLeft, dst.fTop);
+        }
+        fCanvas->drawAtlas(r.image, xforms.get(), r.srcs, NULL, r.count,
+                           SkXfermode::kModulate_Mode, &r.cull, r.paint);
+        return;
+    }
+    for (int i = 0; i < r.count; i++) {
+        fCanvas->legacy_drawImageRect(r.image, &r.srcs[i], r.dsts[i], r.paint, r.constraint);
+    }
+}
+
 template <> void Draw::draw(const DrawDrawable& r) {
     SkASSERT(r.index >= 0);
     SkASSERT(r.index < fDrawableCount);
@@ -148,12 +176,28 @@ template <> void Draw::draw(const DrawDrawable& r) {
 // the block, and control ops are stashed away for later.  When we finish the
 // block with a Restore, our bounds are complete, and we go back and fill them
 // in for all the control ops we stashed away.
+//
+// For large records that work can be split into passes.  A serial kState_Pass tracks only the
+// CTM, clip and save stack, saving that state every so often.  Starting from those states,
+// kDraws_Pass visitors can then compute the bounds of all the drawing ops in parallel.  Finally
+// a serial kBlocks_Pass fills in Save/Restore blocks and control ops from those bounds.
 class FillBounds : SkNoncopyable {
 public:
-    FillBounds(const SkRect& cullRect, const SkRecord& record)
+    enum Pass {
+        kAll_Pass,     // Fill the bounds of every op.
+        kState_Pass,   // Only track the CTM, clip, and save stack.
+        kDraws_Pass,   // Fill the bounds of drawing ops.
+        kBlocks_Pass,  // Fill the bounds of all other ops, given the bounds of drawing ops.
+    };
+
+    // Passes after the first can share the first's bounds by passing in its sharedBounds().
+    FillBounds(const SkRect& cullRect, const SkRecord& record,
+               Pass pass = kAll_Pass, SkRect* sharedBounds = NULL)
         : fNumRecords(record.count())
         , fCullRect(cullRect)
-        , fBounds(record.count())
+        , fPass(pass)
+        , fOwnedBounds(sharedBounds ? 0 : record.count())
+        , fBounds(sharedBounds ? sharedBounds : fOwnedBounds.get())
     {
         // Calculate bounds for all ops.  This won't go quite in order, so we'll need
         // to store the bounds separately then feed them in to the BBH later in order.
@@ -177,10 +221,12 @@ public:
 
         // Finally feed all stored bounds into the BBH.  They'll be returned in this order.
         if (bbh) {
-            bbh->insert(fBounds.get(), fNumRecords);
+            bbh->insert(fBounds, fNumRecords);
         }
     }
 
+    SkRect* sharedBounds() { return fBounds; }
+
     template <typename T> void operator()(const T& op) {
         this->updateCTM(op);
         this->updateClipBounds(op);
@@ -190,6 +236,31 @@ public:
     // In this file, SkRect are in local coordinates, Bounds are translated back to identity space.
     typedef SkRect Bounds;
 
+    struct SaveBounds {
+        int controlOps;        // Number of control ops in this Save block, including the Save.
+        Bounds bounds;         // Bounds of everything in the block.
+        const SkPaint* paint;  // Unowned.  If set, adjusts the bounds of all ops in this block.
+    };
+
+    // Everything a kDraws_Pass needs to start partway through the record.
+    struct State {
+        const SkMatrix* ctm;
+        Bounds clipBounds;
+        SkTDArray<SaveBounds> saveStack;
+    };
+    void saveState(State* state) const {
+        SkASSERT(kState_Pass == fPass);
+        state->ctm = fCTM;
+        state->clipBounds = fCurrentClipBounds;
+        state->saveStack = fSaveStack;
+    }
+    void loadState(const State& state) {
+        SkASSERT(kDraws_Pass == fPass);
+        fCTM = state.ctm;
+        fCurrentClipBounds = state.clipBounds;
+        fSaveStack = state.saveStack;
+    }
+
     unsigned currentOp() const { return fCurrentOp; }
     const SkMatrix& ctm() const { return *fCTM; }
     const Bounds& getBounds(unsigned index) const { return fBounds[index]; }
@@ -223,12 +294,6 @@ public:
     }
 
 private:
-    struct SaveBounds {
-        int controlOps;        // Number of control ops in this Save block, including the Save.
-        Bounds bounds;         // Bounds of everything in the block.
-        const SkPaint* paint;  // Unowned.  If set, adjusts the bounds of all ops in this block.
-    };
-
     // Only Restore and SetMatrix change the CTM.
     template <typename T> void updateCTM(const T&) {}
     void updateCTM(const Restore& op)   { fCTM = &op.matrix; }
@@ -282,7 +347,12 @@ private:
     // from the bounds of the ops in the same Save block.
     void trackBounds(const Save&)          { this->pushSaveBlock(NULL); }
     void trackBounds(const SaveLayer& op)  { this->pushSaveBlock(op.paint); }
-    void trackBounds(const Restore&) { fBounds[fCurrentOp] = this->popSaveBlock(); }
+    void trackBounds(const Restore&) {
+        const Bounds bounds = this->popSaveBlock();
+        if (this->tracksBlocks()) {
+            fBounds[fCurrentOp] = bounds;
+        }
+    }
 
     void trackBounds(const SetMatrix&)         { this->pushControl(); }
     void trackBounds(const ClipRect&)          { this->pushControl(); }
@@ -292,10 +362,18 @@ private:
 
     // For all other ops, we can calculate and store the bounds directly now.
     template <typename T> void trackBounds(const T& op) {
-        fBounds[fCurrentOp] = this->bounds(op);
+        switch (fPass) {
+            case kState_Pass:  return;
+            case kDraws_Pass:  fBounds[fCurrentOp] = this->bounds(op); return;
+            case kBlocks_Pass: break;  // A kDraws_Pass has already filled fBounds[fCurrentOp].
+            case kAll_Pass:    fBounds[fCurrentOp] = this->bounds(op); break;
+        }
         this->updateSaveBounds(fBounds[fCurrentOp]);
     }
 
+    // Only these passes need to track control ops and the bounds of Save blocks.
+    bool tracksBlocks() const { return kAll_Pass == fPass || kBlocks_Pass == fPass; }
+
     void pushSaveBlock(const SkPaint* paint) {
         // Starting a new Save block.  Push a new entry to represent that.
         SaveBounds sb;
@@ -367,6 +445,9 @@ private:
     }
 
     void pushControl() {
+        if (!this->tracksBlocks()) {
+            return;
+        }
         fControlIndices.push(fCurrentOp);
         if (!fSaveStack.isEmpty()) {
             fSaveStack.top().controlOps++;
@@ -399,13 +480,13 @@ private:
         return rect;
     }
 
-    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, &op.paint); }
-    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, &op.paint); }
+    Bounds bounds(const DrawRect& op) const { return this->adjustAndMap(op.rect, op.paint.get()); }
+    Bounds bounds(const DrawOval& op) const { return this->adjustAndMap(op.oval, op.paint.get()); }
     Bounds bounds(const DrawRRect& op) const {
-        return this->adjustAndMap(op.rrect.rect(), &op.paint);
+        return this->adjustAndMap(op.rrect.rect(), op.paint.get());
     }
     Bounds bounds(const DrawDRRect& op) const {
-        return this->adjustAndMap(op.outer.rect(), &op.paint);
+        return this->adjustAndMap(op.outer.rect(), op.paint.get());
     }
     Bounds bounds(const DrawImage& op) const {
         const SkImage* image = op.image;
@@ -416,6 +497,9 @@ private:
     Bounds bounds(const DrawImageRect& op) const {
         return this->adjustAndMap(op.dst, op.paint);
     }
+    Bounds bounds(const DrawImageRects& op) const {
+        return this->adjustAndMap(op.cull, op.paint);
+    }
     Bounds bounds(const DrawImageNine& op) const {
         return this->adjustAndMap(op.dst, op.paint);
     }
@@ -426,7 +510,7 @@ private:
         return this->adjustAndMap(op.dst, op.paint);
     }
     Bounds bounds(const DrawBitmapRectFixedSize& op) const {
-        return this->adjustAndMap(op.dst, &op.paint);
+        return this->adjustAndMap(op.dst, op.paint.get());
     }
     Bounds bounds(const DrawBitmapNine& op) const {
         return this->adjustAndMap(op.dst, op.paint);
@@ -438,28 +522,29 @@ private:
     }
 
     Bounds bounds(const DrawPath& op) const {
-        return op.path.isInverseFillType() ? fCurrentClipBounds
-                                           : this->adjustAndMap(op.path.getBounds(), &op.paint);
+        return op.path.isInverseFillType()
+                ? fCurrentClipBounds
+                : this->adjustAndMap(op.path.getBounds(), op.paint.get());
     }
     Bounds bounds(const DrawPoints& op) const {
         SkRect dst;
         dst.set(op.pts, op.count);
 
         // Pad the bounding box a little to make sure hairline points' bounds aren't empty.
-        SkScalar stroke = SkMaxScalar(op.paint.getStrokeWidth(), 0.01f);
+        SkScalar stroke = SkMaxScalar(op.paint->getStrokeWidth(), 0.01f);
         dst.outset(stroke/2, stroke/2);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPatch& op) const {
         SkRect dst;
         dst.set(op.cubics, SkPatchUtils::kNumCtrlPts);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawVertices& op) const {
         SkRect dst;
         dst.set(op.vertices, op.vertexCount);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawAtlas& op) const {
@@ -477,7 +562,7 @@ private:
     }
 
     Bounds bounds(const DrawPosText& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -485,10 +570,10 @@ private:
         SkRect dst;
         dst.set(op.pos, N);
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawPosTextH& op) const {
-        const int N = op.paint.countText(op.text, op.byteLength);
+        const int N = op.paint->countText(op.text, op.byteLength);
         if (N == 0) {
             return Bounds::MakeEmpty();
         }
@@ -500,7 +585,7 @@ private:
         }
         SkRect dst = { left, op.y, right, op.y };
         AdjustTextForFontMetrics(&dst, op.paint);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
     Bounds bounds(const DrawTextOnPath& op) const {
         SkRect dst = op.path.getBounds();
@@ -515,13 +600,13 @@ private:
         SkASSERT(pad.fRight > pad.fBottom);
         dst.outset(pad.fRight, pad.fRight);
 
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawTextBlob& op) const {
         SkRect dst = op.blob->bounds();
         dst.offset(op.x, op.y);
-        return this->adjustAndMap(dst, &op.paint);
+        return this->adjustAndMap(dst, op.paint.get());
     }
 
     Bounds bounds(const DrawDrawable& op) const {
@@ -579,8 +664,11 @@ private:
     // We do not guarantee anything for operations outside of the cull rect
     const SkRect fCullRect;
 
+    const Pass fPass;
+
     // Conservative identity-space bounds for each op in the SkRecord.
-    SkAutoTMalloc<Bounds> fBounds;
+    SkAutoTMalloc<Bounds> fOwnedBounds;
+    Bounds* fBounds;
 
     // We walk fCurrentOp through the SkRecord, as we go using updateCTM()
     // and updateClipBounds() to maintain the exact CTM (fCTM) and conservative
@@ -594,6 +682,278 @@ private:
     SkTDArray<unsigned>   fControlIndices;
 };
 
+// SkRecord visitor that finds drawing ops hidden beneath later opaque ops.
+//
+// Ops are visited in order.  A FillBounds visitor running alongside gives us the identity-space
+// bounds of each drawing op, which we map through the playback CTM into device space.  We also
+// note which ops cover a device-space rectangle with opaque pixels: opaque rects, paints, and
+// images drawn under a rect-preserving CTM and inside a clip that is known to be a rectangle.
+// cull() then walks the ops back to front, dropping drawing ops whose bounds lie entirely inside
+// an opaque rectangle drawn later.
+//
+// Ops inside SaveLayers are never dropped and never occlude: the layer's paint decides how (and
+// where) they finally land.
+class FindOccluded : SkNoncopyable {
+public:
+    FindOccluded(const SkRect& cullRect, const SkRecord& record, const SkMatrix& playbackCTM,
+                 const SkIRect& devClipBounds)
+        : fBounds(cullRect, record)
+        , fPlaybackCTM(playbackCTM)
+        , fDevClipBounds(SkRect::Make(devClipBounds)) {
+        ClipState base;
+        base.opaqueClip = fDevClipBounds;
+        base.inLayer = false;
+        fClipStack.push(base);
+    }
+
+    void setCurrentOp(unsigned currentOp) {
+        fBounds.setCurrentOp(currentOp);
+        fCurrentOp = currentOp;
+    }
+
+    template <typename T> void operator()(const T& op) {
+        fBounds(op);
+        this->updateClipState(op);
+        this->trackOp(op);
+    }
+
+    // Removes the indices of hidden drawing ops from ops.
+    void cull(SkTDArray<unsigned>* ops) const {
+        // A handful of the largest occluders catches the common cases (backgrounds, tiles, full
+        // size images) without making the walk quadratic.
+        static const int kMaxOccluders = 4;
+        SkRect occluders[kMaxOccluders];
+        int occluderCount = 0;
+
+        SkAutoTMalloc<bool> hidden(fOps.count());
+        bool anyHidden = false;
+        for (int i = fOps.count() - 1; i >= 0; i--) {
+            const OpInfo& op = fOps[i];
+            hidden[i] = false;
+            if (op.isDraw) {
+                for (int j = 0; j < occluderCount; j++) {
+                    if (occluders[j].contains(op.devBounds)) {
+                        hidden[i] = anyHidden = true;
+                        break;
+                    }
+                }
+            }
+            if (op.occluded.isEmpty()) {
+                continue;
+            }
+            if (occluderCount < kMaxOccluders) {
+                occluders[occluderCount++] = op.occluded;
+                continue;
+            }
+            int smallest = 0;
+            for (int j = 1; j < kMaxOccluders; j++) {
+                if (area(occluders[j]) < area(occluders[smallest])) {
+                    smallest = j;
+                }
+            }
+            if (area(op.occluded) > area(occluders[smallest])) {
+                occluders[smallest] = op.occluded;
+            }
+        }
+
+        if (anyHidden) {
+            int kept = 0;
+            for (int i = 0; i < ops->count(); i++) {
+                if (!hidden[(*ops)[i]]) {
+                    (*ops)[kept++] = (*ops)[i];
+                }
+            }
+            ops->setCount(kept);
+        }
+    }
+
+private:
+    struct ClipState {
+        SkRect opaqueClip;  // Device pixels known to be entirely inside the clip, maybe empty.
+        bool   inLayer;
+    };
+
+    struct OpInfo {
+        bool   isDraw;
+        SkRect devBounds;  // Conservative device bounds of a drawing op's pixels.
+        SkRect occluded;   // Device pixels this op is known to cover opaquely, maybe empty.
+    };
+
+    static SkScalar area(const SkRect& r) { return r.width() * r.height(); }
+
+    SkMatrix ctm() const { return SkMatrix::Concat(fPlaybackCTM, fBounds.ctm()); }
+
+    // Returns the whole device pixels inside rect mapped by ctm, clipped to the device clip.
+    SkRect insidePixels(const SkMatrix& ctm, const SkRect& rect) const {
+        SkRect r;
+        ctm.mapRect(&r, rect);
+        if (!r.intersect(fDevClipBounds)) {
+            return SkRect::MakeEmpty();
+        }
+        SkIRect inside;
+        r.roundIn(&inside);
+        return inside.isEmpty() ? SkRect::MakeEmpty() : SkRect::Make(inside);
+    }
+
+    template <typename T> void updateClipState(const T&) {}
+    void updateClipState(const Save&) { fClipStack.push(fClipStack.top()); }
+    void updateClipState(const SaveLayer&) {
+        ClipState state = fClipStack.top();
+        state.inLayer = true;
+        fClipStack.push(state);
+    }
+    void updateClipState(const Restore&) {
+        // SkRecordDraw balances unmatched Restores for us, so never pop our base state.
+        if (fClipStack.count() > 1) {
+            fClipStack.pop();
+        }
+    }
+    void updateClipState(const ClipRect& op) {
+        ClipState& state = fClipStack.top();
+        const SkMatrix ctm = this->ctm();
+        if (SkRegion::kIntersect_Op == op.opAA.op && ctm.rectStaysRect()) {
+            SkRect inside = this->insidePixels(ctm, op.rect);
+            if (!state.opaqueClip.intersect(inside)) {
+                state.opaqueClip.setEmpty();
+            }
+        } else {
+            state.opaqueClip.setEmpty();
+        }
+    }
+    // We don't know which pixels are entirely inside any other kind of clip.
+    void updateClipState(const ClipRRect&)  { fClipStack.top().opaqueClip.setEmpty(); }
+    void updateClipState(const ClipPath&)   { fClipStack.top().opaqueClip.setEmpty(); }
+    void updateClipState(const ClipRegion&) { fClipStack.top().opaqueClip.setEmpty(); }
+
+    // Control ops are never culled and never occlude.
+    void trackControl() {
+        OpInfo* info = fOps.append();
+        info->isDraw = false;
+        info->devBounds.setEmpty();
+        info->occluded.setEmpty();
+    }
+    void trackOp(const NoOp&)       { this->trackControl(); }
+    void trackOp(const Save&)       { this->trackControl(); }
+    void trackOp(const SaveLayer&)  { this->trackControl(); }
+    void trackOp(const Restore&)    { this->trackControl(); }
+    void trackOp(const SetMatrix&)  { this->trackControl(); }
+    void trackOp(const ClipRect&)   { this->trackControl(); }
+    void trackOp(const ClipRRect&)  { this->trackControl(); }
+    void trackOp(const ClipPath&)   { this->trackControl(); }
+    void trackOp(const ClipRegion&) { this->trackControl(); }
+
+    template <typename T> void trackOp(const T& op) {
+        OpInfo* info = fOps.append();
+        info->isDraw = !fClipStack.top().inLayer;
+        info->occluded.setEmpty();
+        if (!info->isDraw) {
+            info->devBounds.setEmpty();
+            return;
+        }
+        // Antialiasing and hairlines may touch the pixels just outside the bounds.
+        fPlaybackCTM.mapRect(&info->devBounds, fBounds.getBounds(fCurrentOp));
+        info->devBounds.outset(1, 1);
+
+        SkRect rect;
+        const SkMatrix ctm = this->ctm();
+        if (ctm.rectStaysRect() && this->opaqueRect(op, &rect)) {
+            info->occluded = this->insidePixels(ctm, rect);
+            if (!info->occluded.intersect(fClipStack.top().opaqueClip)) {
+                info->occluded.setEmpty();
+            }
+        }
+    }
+
+    // Returns true if paint draws opaque pixels everywhere its geometry covers, given whether
+    // what it draws (its color or shader, or an image) is opaque.
+    static bool PaintIsOpaque(const SkPaint* paint, bool srcIsOpaque) {
+        if (!paint) {
+            return srcIsOpaque;
+        }
+        if (paint->getStyle() != SkPaint::kFill_Style ||
+            paint->getAlpha() != 0xFF ||
+            paint->getMaskFilter() ||
+            paint->getPathEffect() ||
+            paint->getRasterizer() ||
+            paint->getLooper() ||
+            paint->getImageFilter()) {
+            return false;
+        }
+        if (const SkColorFilter* cf = paint->getColorFilter()) {
+            if (!(cf->getFlags() & SkColorFilter::kAlphaUnchanged_Flag)) {
+                return false;
+            }
+        }
+        SkXfermode* xfer = paint->getXfermode();
+        if (xfer && !SkXfermode::IsMode(xfer, SkXfermode::kSrcOver_Mode) &&
+                    !SkXfermode::IsMode(xfer, SkXfermode::kSrc_Mode)) {
+            return false;
+        }
+        return srcIsOpaque;
+    }
+    static bool PaintColorIsOpaque(const SkPaint& paint) {
+        return PaintIsOpaque(&paint, !paint.getShader() || paint.getShader()->isOpaque());
+    }
+    // Images draw all of dst only if src (if any) lies inside them.
+    static bool SrcInside(const SkRect* src, int width, int height) {
+        return !src || SkRect::MakeIWH(width, height).contains(*src);
+    }
+
+    // Most ops don't draw opaque rectangles we can rely on.
+    template <typename T> bool opaqueRect(const T&, SkRect*) const { return false; }
+
+    bool opaqueRect(const DrawRect& op, SkRect* rect) const {
+        *rect = op.rect;
+        rect->sort();
+        return PaintColorIsOpaque(op.paint);
+    }
+    bool opaqueRect(const DrawPaint& op, SkRect* rect) const {
+        // Drawing a paint fills the whole clip, so opaqueClip alone limits what it covers.
+        *rect = SkRect::MakeLargest();
+        return PaintColorIsOpaque(op.paint);
+    }
+    bool opaqueRect(const DrawImage& op, SkRect* rect) const {
+        *rect = SkRect::MakeXYWH(op.left, op.top, SkIntToScalar(op.image->width()),
+                                 SkIntToScalar(op.image->height()));
+        return PaintIsOpaque(op.paint, op.image->isOpaque());
+    }
+    bool opaqueRect(const DrawImageRect& op, SkRect* rect) const {
+        *rect = op.dst;
+        return SrcInside(op.src, op.image->width(), op.image->height()) &&
+               PaintIsOpaque(op.paint, op.image->isOpaque());
+    }
+    bool opaqueRect(const DrawBitmap& op, SkRect* rect) const {
+        const SkBitmap& bm = op.bitmap.shallowCopy();
+        *rect = SkRect::MakeXYWH(op.left, op.top, SkIntToScalar(bm.width()),
+                                 SkIntToScalar(bm.height()));
+        return PaintIsOpaque(op.paint, bm.isOpaque());
+    }
+    bool opaqueRect(const DrawBitmapRect& op, SkRect* rect) const {
+        const SkBitmap& bm = op.bitmap.shallowCopy();
+        *rect = op.dst;
+        return SrcInside(op.src, bm.width(), bm.height()) && PaintIsOpaque(op.paint, bm.isOpaque());
+    }
+    bool opaqueRect(const DrawBitmapRectFast& op, SkRect* rect) const {
+        const SkBitmap& bm = op.bitmap.shallowCopy();
+        *rect = op.dst;
+        return SrcInside(op.src, bm.width(), bm.height()) && PaintIsOpaque(op.paint, bm.isOpaque());
+    }
+    bool opaqueRect(const DrawBitmapRectFixedSize& op, SkRect* rect) const {
+        const SkBitmap& bm = op.bitmap.shallowCopy();
+        *rect = op.dst;
+        return SrcInside(&op.src, bm.width(), bm.height()) &&
+               PaintIsOpaque(op.paint.get(), bm.isOpaque());
+    }
+
+    FillBounds fBounds;
+    const SkMatrix fPlaybackCTM;
+    const SkRect fDevClipBounds;
+    unsigned fCurrentOp;
+
+    SkTDArray<ClipState> fClipStack;
+    SkTDArray<OpInfo> fOps;
+};
+
 // SkRecord visitor to gather saveLayer/restore information.
 class CollectLayers : SkNoncopyable {
 public:
@@ -792,7 +1152,68 @@ private:
 
 }  // namespace SkRecords
 
+static void cull_occluded_ops(const SkRecord& record, const SkCanvas* canvas, const SkRect& query,
+                              SkTDArray<unsigned>* ops) {
+    const SkMatrix& ctm = canvas->getTotalMatrix();
+    SkIRect devClip;
+    // Draw filters can change any paint, and our device bounds need an affine CTM.
+    if (canvas->getDrawFilter() || ctm.hasPerspective() || !canvas->getClipDeviceBounds(&devClip)) {
+        return;
+    }
+
+    SkRecords::FindOccluded visitor(query, record, ctm, devClip);
+    for (unsigned curOp = 0; curOp < record.count(); curOp++) {
+        visitor.setCurrentOp(curOp);
+        record.visit<void>(curOp, visitor);
+    }
+    visitor.cull(ops);
+}
+
+// Records with at least this many ops compute their drawing ops' bounds in parallel chunks.
+static const unsigned kOpsPerBoundsChunk = 1 << 13;
+
+static void fill_bounds_in_parallel(const SkRect& cullRect, const SkRecord& record,
+                                    SkBBoxHierarchy* bbh) {
+    using SkRecords::FillBounds;
+    FillBounds blocks(cullRect, record, FillBounds::kBlocks_Pass);
+
+    // Find the state at the start of each chunk.
+    const int chunkCount = SkToInt((record.count() - 1) / kOpsPerBoundsChunk + 1);
+    SkTArray<FillBounds::State> states(chunkCount);
+    {
+        FillBounds state(cullRect, record, FillBounds::kState_Pass, blocks.sharedBounds());
+        for (unsigned curOp = 0; curOp < record.count(); curOp++) {
+            if (0 == curOp % kOpsPerBoundsChunk) {
+                state.saveState(&states.push_back());
+            }
+            state.setCurrentOp(curOp);
+            record.visit<void>(curOp, state);
+        }
+    }
+
+    sk_parallel_for(chunkCount, [&](int i) {
+        FillBounds draws(cullRect, record, FillBounds::kDraws_Pass, blocks.sharedBounds());
+        draws.loadState(states[i]);
+        const unsigned stop = SkTMin(record.count(), (i + 1) * kOpsPerBoundsChunk);
+        for (unsigned curOp = i * kOpsPerBoundsChunk; curOp < stop; curOp++) {
+            draws.setCurrentOp(curOp);
+            record.visit<void>(curOp, draws);
+        }
+    });
+
+    for (unsigned curOp = 0; curOp < record.count(); curOp++) {
+        blocks.setCurrentOp(curOp);
+        record.visit<void>(curOp, blocks);
+    }
+    blocks.cleanUp(bbh);
+}
+
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkBBoxHierarchy* bbh) {
+    TRACE_EVENT1("disabled-by-default-skia", "SkRecordFillBounds()", "ops", record.count());
+    if (record.count() >= 2 * kOpsPerBoundsChunk && sk_num_cores() > 1) {
+        return fill_bounds_in_parallel(cullRect, record, bbh);
+    }
+
     SkRecords::FillBounds visitor(cullRect, record);
 
     for (unsigned curOp = 0; curOp < record.count(); curOp++) {
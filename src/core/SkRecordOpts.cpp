@@ -7,9 +7,12 @@
 
 #include "SkRecordOpts.h"
 
+#include "SkImage.h"
 #include "SkRecordPattern.h"
 #include "SkRecords.h"
+#include "SkShader.h"
 #include "SkTDArray.h"
+#include "SkXfermode.h"
 
 using namespace SkRecords;
 
@@ -20,8 +23,14 @@ void SkRecordOptimize(SkRecord* record) {
     // Save-NoDraw-Restore sequences better than we can here.
     //SkRecordNoopSaveRestores(record);
 
+    SkRecordNoopRedundantSetMatrices(record);
+    SkRecordNoopRedundantClipRects(record);
+
     SkRecordNoopSaveLayerDrawRestores(record);
     SkRecordMergeSvgOpacityAndFilterLayers(record);
+
+    SkRecordNoopOccludedDrawRects(record);
+    SkRecordMergeImageRects(record);
 }
 
 // Most of the optimizations in this file are pattern-based.  These are all defined as structs with:
@@ -143,6 +152,30 @@ void SkRecordNoopSaveRestores(SkRecord* record) {
     while (apply(&onlyDraws, record) || apply(&noDraws, record));
 }
 
+// Gives a drawing command matched by IsDraw a new paint.  Commands holding a SharedPaint point to
+// a newly interned paint, leaving any other commands sharing the old one alone.
+class DrawPaintReplacer {
+    SK_CREATE_MEMBER_DETECTOR(paint);
+public:
+    DrawPaintReplacer(SkRecord* record, const SkPaint& paint) : fRecord(record), fPaint(paint) {}
+
+    template <typename T>
+    SK_WHEN(HasMember_paint<T>, void) operator()(T* draw) { this->replace(&draw->paint); }
+
+    template <typename T>
+    SK_WHEN(!HasMember_paint<T>, void) operator()(T*) { SkDEBUGFAIL("Not a draw."); }
+
+private:
+    void replace(Optional<SkPaint>* paint) {
+        SkPaint* ptr = *paint;
+        *ptr = fPaint;
+    }
+    void replace(SharedPaint* paint) { *paint = fRecord->internPaint(fPaint); }
+
+    SkRecord* fRecord;
+    const SkPaint& fPaint;
+};
+
 // For some SaveLayer-[drawing command]-Restore patterns, merge the SaveLayer's alpha into the
 // draw, and no-op the SaveLayer and Restore.
 struct SaveLayerDrawRestoreNooper {
@@ -156,16 +189,19 @@ struct SaveLayerDrawRestoreNooper {
             return KillSaveLayerAndRestore(record, begin);
         }
 
-        SkPaint* drawPaint = pattern->second<SkPaint>();
+        const SkPaint* drawPaint = pattern->second<const SkPaint>();
         if (drawPaint == NULL) {
             // We can just give the draw the SaveLayer's paint.
             // TODO(mtklein): figure out how to do this clearly
             return false;
         }
 
-        if (!fold_opacity_layer_color_to_paint(*layerPaint, false /*isSaveLayer*/, drawPaint)) {
+        SkPaint foldedPaint(*drawPaint);
+        if (!fold_opacity_layer_color_to_paint(*layerPaint, false /*isSaveLayer*/, &foldedPaint)) {
             return false;
         }
+        DrawPaintReplacer replacer(record, foldedPaint);
+        record->mutate<void>(begin+1, replacer);
 
         return KillSaveLayerAndRestore(record, begin);
     }
@@ -230,3 +266,297 @@ void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord* record) {
     SvgOpacityAndFilterLayerMergePass pass;
     apply(&pass, record);
 }
+
+// The rest of the optimizations in this file need to know the matrix and clip each command sees,
+// so instead of matching patterns they walk the SkRecord in order, tracking that state as they go.
+// Like SkRecordDraw, they rely on SetMatrix and Restore holding the absolute matrix, and on clip
+// commands and Restore holding the device bounds of the clip they leave behind.
+template <typename Pass>
+static void walk(Pass* pass, SkRecord* record) {
+    for (unsigned i = 0; i < record->count(); i++) {
+        pass->fCurrentOp = i;
+        record->mutate<void>(i, *pass);
+    }
+}
+
+// Layout engines often set the matrix they've already got, e.g. resetting it for each element.
+struct RedundantSetMatrixNooper {
+    RedundantSetMatrixNooper(SkRecord* record)
+        : fCurrentOp(0), fRecord(record), fCTM(&SkMatrix::I()) {}
+
+    template <typename T> void operator()(T*) {}
+
+    void operator()(Restore* op) { fCTM = &op->matrix; }
+    void operator()(SetMatrix* op) {
+        if (op->matrix == *fCTM) {
+            fRecord->replace<NoOp>(fCurrentOp);
+            return;
+        }
+        fCTM = &op->matrix;
+    }
+
+    unsigned fCurrentOp;
+    SkRecord* fRecord;
+    const SkMatrix* fCTM;
+};
+void SkRecordNoopRedundantSetMatrices(SkRecord* record) {
+    RedundantSetMatrixNooper pass(record);
+    walk(&pass, record);
+}
+
+// An intersecting ClipRect can't change a clip that lies entirely inside its rect.  We only know
+// the conservative device bounds of the current clip, so the rect must contain all of them, with a
+// pixel to spare if the rect is anti-aliased so its soft edges can't touch the clip either.
+struct RedundantClipRectNooper {
+    RedundantClipRectNooper(SkRecord* record)
+        : fCurrentOp(0), fRecord(record), fCTM(&SkMatrix::I()), fClipKnown(false) {}
+
+    template <typename T> void operator()(T*) {}
+
+    void operator()(SetMatrix* op)  { fCTM = &op->matrix; }
+    void operator()(Restore* op)    { fCTM = &op->matrix; this->setClip(op->devBounds); }
+    void operator()(ClipPath* op)   { this->setClip(op->devBounds); }
+    void operator()(ClipRRect* op)  { this->setClip(op->devBounds); }
+    void operator()(ClipRegion* op) { this->setClip(op->devBounds); }
+
+    // A SaveLayer with bounds may shrink the clip further.  That's fine: smaller is still inside.
+
+    void operator()(ClipRect* op) {
+        if (fClipKnown && SkRegion::kIntersect_Op == op->opAA.op && fCTM->rectStaysRect()) {
+            SkRect devRect;
+            fCTM->mapRect(&devRect, op->rect);
+
+            SkRect clip = SkRect::Make(fClip);
+            if (op->opAA.aa) {
+                clip.outset(SK_Scalar1, SK_Scalar1);
+            }
+            if (devRect.contains(clip)) {
+                fRecord->replace<NoOp>(fCurrentOp);
+                return;
+            }
+        }
+        this->setClip(op->devBounds);
+    }
+
+    void setClip(const SkIRect& devBounds) {
+        fClip = devBounds;
+        fClipKnown = true;
+    }
+
+    unsigned fCurrentOp;
+    SkRecord* fRecord;
+    const SkMatrix* fCTM;
+    SkIRect fClip;
+    bool fClipKnown;  // We don't know the clip until we see a clip command or Restore.
+};
+void SkRecordNoopRedundantClipRects(SkRecord* record) {
+    RedundantClipRectNooper pass(record);
+    walk(&pass, record);
+}
+
+// Within a run of DrawRects sharing a matrix, clip, and layer, an opaque DrawRect hides any earlier
+// DrawRect it covers completely.  We compare whole device pixels: the pixels the earlier draw might
+// touch, padded by one, must all be fully covered by the later one.  Anti-aliased clips blend the
+// earlier draw back in along their edges, so we don't look for occlusion inside them.
+struct OccludedDrawRectNooper {
+    OccludedDrawRectNooper(SkRecord* record)
+        : fCurrentOp(0), fRecord(record), fCTM(&SkMatrix::I()) {
+        fAAClipStack.push(false);
+    }
+
+    // Anything else might read what's been drawn or change how the next draw lands.
+    template <typename T> void operator()(T*) { fRun.rewind(); }
+
+    void operator()(NoOp*) {}
+
+    void operator()(Save*)      { fRun.rewind(); fAAClipStack.push(fAAClipStack.top()); }
+    void operator()(SaveLayer*) { fRun.rewind(); fAAClipStack.push(fAAClipStack.top()); }
+    void operator()(Restore* op) {
+        fRun.rewind();
+        fCTM = &op->matrix;
+        if (fAAClipStack.count() > 1) {
+            fAAClipStack.pop();
+        }
+    }
+    void operator()(SetMatrix* op) { fRun.rewind(); fCTM = &op->matrix; }
+
+    void operator()(ClipPath* op)  { fRun.rewind(); fAAClipStack.top() |= op->opAA.aa; }
+    void operator()(ClipRRect* op) { fRun.rewind(); fAAClipStack.top() |= op->opAA.aa; }
+    void operator()(ClipRect* op)  { fRun.rewind(); fAAClipStack.top() |= op->opAA.aa; }
+
+    void operator()(DrawRect* op) {
+        if (!fCTM->rectStaysRect()) {
+            // Nothing is in the run now, and nothing can join it until the matrix changes.
+            return;
+        }
+        SkRect rect = op->rect;
+        rect.sort();
+
+        if (!fAAClipStack.top() && IsOpaqueFill(op->paint)) {
+            SkRect devRect;
+            fCTM->mapRect(&devRect, rect);
+            SkIRect covered;
+            devRect.roundIn(&covered);
+
+            for (int i = fRun.count() - 1; i >= 0; i--) {
+                if (covered.contains(fRun[i].devBounds)) {
+                    fRecord->replace<NoOp>(fRun[i].index);
+                    fRun.remove(i);
+                }
+            }
+        }
+
+        if (op->paint->canComputeFastBounds()) {
+            SkRect storage;
+            SkRect devRect;
+            fCTM->mapRect(&devRect, op->paint->computeFastBounds(rect, &storage));
+
+            Visible visible;
+            visible.index = fCurrentOp;
+            devRect.roundOut(&visible.devBounds);
+            visible.devBounds.outset(1, 1);
+
+            if (fRun.count() == kMaxRun) {
+                fRun.remove(0);
+            }
+            fRun.push(visible);
+        }
+    }
+
+    // Does this paint overwrite every pixel it fully covers?
+    static bool IsOpaqueFill(const SkPaint& paint) {
+        const SkShader* shader = paint.getShader();
+        return SkPaint::kFill_Style == paint.getStyle()
+            && 0xFF == paint.getAlpha()
+            && (NULL == shader || shader->isOpaque())
+            && (SkXfermode::IsMode(paint.getXfermode(), SkXfermode::kSrcOver_Mode) ||
+                SkXfermode::IsMode(paint.getXfermode(), SkXfermode::kSrc_Mode))
+            && !paint.getPathEffect()
+            && !paint.getMaskFilter()
+            && !paint.getColorFilter()
+            && !paint.getRasterizer()
+            && !paint.getLooper()
+            && !paint.getImageFilter();
+    }
+
+    // How many earlier DrawRects we'll check against each opaque one.
+    static const int kMaxRun = 16;
+
+    struct Visible {
+        unsigned index;
+        SkIRect devBounds;  // Every pixel this DrawRect might touch, padded by one.
+    };
+
+    unsigned fCurrentOp;
+    SkRecord* fRecord;
+    const SkMatrix* fCTM;
+    SkTDArray<Visible> fRun;
+    SkTDArray<bool> fAAClipStack;  // Is there an anti-aliased clip in effect?
+};
+void SkRecordNoopOccludedDrawRects(SkRecord* record) {
+    OccludedDrawRectNooper pass(record);
+    walk(&pass, record);
+}
+
+// Can this DrawImageRect be drawn as part of an atlas?  Atlases draw each image rect as a
+// non-anti-aliased quad textured with a clamped image shader, without any strict src constraint.
+static bool can_merge_image_rect(const DrawImageRect& op) {
+    const SkPaint* paint = op.paint;
+    if (paint && (paint->isAntiAlias()   ||
+                  paint->getShader()     ||
+                  paint->getPathEffect() ||
+                  paint->getMaskFilter() ||
+                  paint->getRasterizer() ||
+                  paint->getLooper()     ||
+                  paint->getImageFilter())) {
+        return false;
+    }
+
+    const SkRect src = op.src ? *op.src : SkRect::MakeIWH(op.image->width(), op.image->height());
+    if (src.isEmpty() || op.dst.isEmpty()) {
+        return false;
+    }
+    // A strict constraint keeps filtering from reading outside src.  The atlas can't promise that.
+    const bool filtered = paint && kNone_SkFilterQuality != paint->getFilterQuality();
+    if (filtered && SkCanvas::kStrict_SrcRectConstraint == op.constraint &&
+        src != SkRect::MakeIWH(op.image->width(), op.image->height())) {
+        return false;
+    }
+
+    // An RSXform can only scale uniformly.
+    return SkScalarNearlyEqual(op.dst.width()  / src.width(),
+                               op.dst.height() / src.height());
+}
+
+static bool can_merge_image_rects(const DrawImageRect& a, const DrawImageRect& b) {
+    if (a.image != b.image || a.constraint != b.constraint) {
+        return false;
+    }
+    const SkPaint* pa = a.paint;
+    const SkPaint* pb = b.paint;
+    if (pa ? !(pb && *pa == *pb) : SkToBool(pb)) {
+        return false;
+    }
+    return can_merge_image_rect(b);
+}
+
+// Replaces the DrawImageRects at the indices in run with one DrawImageRects.
+static void merge_image_rects(SkRecord* record, const SkTDArray<unsigned>& run) {
+    const int count = run.count();
+    SkRect* srcs = record->alloc<SkRect>(count);
+    SkRect* dsts = record->alloc<SkRect>(count);
+    SkRect cull = SkRect::MakeEmpty();
+
+    Is<DrawImageRect> first;
+    for (int i = count - 1; i >= 0; i--) {
+        SkAssertResult(record->mutate<bool>(run[i], first));
+        const DrawImageRect& op = *first.get();
+        srcs[i] = op.src ? *op.src : SkRect::MakeIWH(op.image->width(), op.image->height());
+        dsts[i] = op.dst;
+        cull.join(op.dst);
+    }
+
+    SkPaint* paint = NULL;
+    if (first.get()->paint) {
+        paint = SkNEW_PLACEMENT_ARGS(record->alloc<SkPaint>(), SkPaint, (*first.get()->paint));
+    }
+    SkAutoTUnref<const SkImage> image(SkRef(static_cast<const SkImage*>(first.get()->image)));
+    const SkCanvas::SrcRectConstraint constraint = first.get()->constraint;
+
+    for (int i = 1; i < count; i++) {
+        record->replace<NoOp>(run[i]);
+    }
+    SkNEW_PLACEMENT_ARGS(record->replace<DrawImageRects>(run[0]), DrawImageRects,
+                         (paint, image, srcs, dsts, count, constraint, cull));
+}
+
+void SkRecordMergeImageRects(SkRecord* record) {
+    SkTDArray<unsigned> run;
+    unsigned i = 0;
+    while (i < record->count()) {
+        Is<DrawImageRect> first;
+        if (!record->mutate<bool>(i, first) || !can_merge_image_rect(*first.get())) {
+            i++;
+            continue;
+        }
+
+        // Extend the run as far as we can, skipping over any NoOps.
+        run.rewind();
+        run.push(i);
+        for (i++; i < record->count(); i++) {
+            Is<NoOp> noop;
+            if (record->mutate<bool>(i, noop)) {
+                continue;
+            }
+            Is<DrawImageRect> next;
+            if (!record->mutate<bool>(i, next) || !can_merge_image_rects(*first.get(), *next.get())) {
+                break;
+            }
+            run.push(i);
+        }
+
+        if (run.count() > 1) {
+            merge_image_rects(record, run);
+        }
+    }
+}
@@ -24,4 +24,18 @@ void SkRecordNoopSaveLayerDrawRestores(SkRecord*);
 // the alpha of the first SaveLayer to the second SaveLayer.
 void SkRecordMergeSvgOpacityAndFilterLayers(SkRecord*);
 
+// No-ops SetMatrix commands that set the matrix already in effect.
+void SkRecordNoopRedundantSetMatrices(SkRecord*);
+
+// No-ops intersecting ClipRect commands whose rect already contains the current clip.
+void SkRecordNoopRedundantClipRects(SkRecord*);
+
+// No-ops DrawRect commands that are entirely covered by a later opaque DrawRect in the same
+// matrix and clip.
+void SkRecordNoopOccludedDrawRects(SkRecord*);
+
+// Merges runs of DrawImageRect that share an image, paint, and constraint, and that each draw with
+// a uniform scale, into single DrawImageRects commands.
+void SkRecordMergeImageRects(SkRecord*);
+
 #endif//SkRecordOpts_DEFINED
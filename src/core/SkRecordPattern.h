@@ -32,13 +32,14 @@ private:
     type* fPtr;
 };
 
-// Matches any command that draws, and stores its paint.
+// Matches any command that draws, and stores its paint.  Many commands share their paints, so
+// the paint is read-only; see SkRecordOpts.cpp for how to replace it.
 class IsDraw {
     SK_CREATE_MEMBER_DETECTOR(paint);
 public:
     IsDraw() : fPaint(NULL) {}
 
-    typedef SkPaint type;
+    typedef const SkPaint type;
     type* get() { return fPaint; }
 
     template <typename T>
@@ -62,7 +63,7 @@ public:
 private:
     // Abstracts away whether the paint is always part of the command or optional.
     template <typename T> static T* AsPtr(SkRecords::Optional<T>& x) { return x; }
-    template <typename T> static T* AsPtr(T& x) { return &x; }
+    static const SkPaint* AsPtr(SkRecords::SharedPaint& x) { return x.get(); }
 
     type* fPaint;
 };
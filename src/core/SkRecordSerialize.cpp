@@ -0,0 +1,946 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBigPicture.h"
+#include "SkImage.h"
+#include "SkPatchUtils.h"
+#include "SkPictureRecorder.h"
+#include "SkReadBuffer.h"
+#include "SkRecord.h"
+#include "SkRecordSerialize.h"
+#include "SkRecorder.h"
+#include "SkRecords.h"
+#include "SkTHash.h"
+#include "SkTextBlob.h"
+#include "SkWriteBuffer.h"
+
+// The serialized form of a picture is
+//     cull rect
+//     paints, paths, bitmaps, images, text blobs and sub-pictures, each as a count then entries
+//     op count, then for each op its SkRecords::Type and its arguments.
+// Ops refer to dictionary entries by index, with optional entries stored as index+1 (0 means NULL).
+// Optional rects and flattenables are a bool then the value, and arrays of POD are written as byte arrays, whose
+// lengths imply the counts that go with them.
+
+using namespace SkRecords;
+
+namespace {
+
+struct PaintKey {
+    const SkPaint* fPaint;
+    bool operator==(const PaintKey& that) const { return *fPaint == *that.fPaint; }
+    static uint32_t Hash(const PaintKey& key) { return key.fPaint->getHash(); }
+};
+
+// Paths with the same generation ID are equal, so that's a fine hash.
+struct PathKey {
+    const SkPath* fPath;
+    bool operator==(const PathKey& that) const { return *fPath == *that.fPath; }
+    static uint32_t Hash(const PathKey& key) { return key.fPath->getGenerationID(); }
+};
+
+struct BitmapKey {
+    uint32_t fGenID;
+    SkIRect  fSubset;
+    bool operator==(const BitmapKey& that) const {
+        return fGenID == that.fGenID && fSubset == that.fSubset;
+    }
+};
+
+// Returns the index of key's value in values, appending value if key has not been seen before.
+template <typename Map, typename K, typename T>
+static int intern(Map* indices, const K& key, SkTDArray<T>* values, T value) {
+    if (int* index = indices->find(key)) {
+        return *index;
+    }
+    *values->append() = value;
+    return *indices->set(key, values->count() - 1);
+}
+
+// Writes an SkRecord in two passes over its ops: the first, with no output buffer, just collects
+// the dictionaries; the second writes those dictionaries and then the ops referring to them.
+class Writer : SkNoncopyable {
+public:
+    explicit Writer(const SkRecord& record) : fRecord(record), fOut(NULL) {}
+
+    void write(SkWriteBuffer*);
+
+    template <typename T> void operator()(const T& r) {
+        if (fOut) {
+            fOut->writeUInt(T::kType);
+        }
+        this->fields(r);
+    }
+
+private:
+    // Writes the arguments of one op, after the op's type.  Specialized for each SkRecords type.
+    template <typename T> void fields(const T&);
+
+    void writeDictionaries();
+
+    void u32(uint32_t v)    { if (fOut) { fOut->writeUInt(v);   } }
+    void i32(int32_t v)     { if (fOut) { fOut->writeInt(v);    } }
+    void scalar(SkScalar v) { if (fOut) { fOut->writeScalar(v); } }
+    void boolean(bool v)    { if (fOut) { fOut->writeBool(v);   } }
+
+    void rect(const SkRect& r)        { if (fOut) { fOut->writeRect(r);   } }
+    void irect(const SkIRect& r)      { if (fOut) { fOut->writeIRect(r);  } }
+    void matrix(const SkMatrix& m)    { if (fOut) { fOut->writeMatrix(m); } }
+    void region(const SkRegion& r)    { if (fOut) { fOut->writeRegion(r); } }
+
+    void optRect(const SkRect* r) {
+        this->boolean(SkToBool(r));
+        if (r) {
+            this->rect(*r);
+        }
+    }
+
+    // A NULL flattenable is written as just false, as readers with an empty factory table can't
+    // tell how wide the NULL entry that writeFlattenable() writes is.
+    void flattenable(const SkFlattenable* f) {
+        this->boolean(SkToBool(f));
+        if (f && fOut) {
+            fOut->writeFlattenable(f);
+        }
+    }
+
+    void rrect(const SkRRect& rrect) {
+        char storage[SkRRect::kSizeInMemory];
+        rrect.writeToMemory(storage);
+        this->array(storage, SkRRect::kSizeInMemory);
+    }
+
+    template <typename T> void array(const T* values, size_t count) {
+        if (fOut) {
+            fOut->writeByteArray(values, values ? count * sizeof(T) : 0);
+        }
+    }
+
+    void paint(const SkPaint& paint) {
+        PaintKey key = { &paint };
+        this->i32(intern(&fPaintIndices, key, &fPaints, &paint));
+    }
+    void optPaint(const SkPaint* paint) {
+        if (paint) {
+            PaintKey key = { paint };
+            this->i32(intern(&fPaintIndices, key, &fPaints, paint) + 1);
+        } else {
+            this->i32(0);
+        }
+    }
+    void path(const SkPath& path) {
+        PathKey key = { &path };
+        this->i32(intern(&fPathIndices, key, &fPaths, &path));
+    }
+    void bitmap(const ImmutableBitmap& immutable) {
+        const SkBitmap bitmap = immutable.shallowCopy();
+        const SkIPoint origin = bitmap.pixelRefOrigin();
+        BitmapKey key = {
+            bitmap.getGenerationID(),
+            SkIRect::MakeXYWH(origin.x(), origin.y(), bitmap.width(), bitmap.height()),
+        };
+        this->i32(intern(&fBitmapIndices, key, &fBitmaps, &immutable));
+    }
+    void image(const SkImage* image) {
+        this->i32(intern(&fImageIndices, image->uniqueID(), &fImages, image));
+    }
+    void blob(const SkTextBlob* blob) {
+        this->i32(intern(&fBlobIndices, blob->uniqueID(), &fBlobs, blob));
+    }
+    void picture(const SkPicture* picture) {
+        this->i32(intern(&fPictureIndices, picture->uniqueID(), &fPictures, picture));
+    }
+
+    const SkRecord& fRecord;
+    SkWriteBuffer* fOut;
+
+    SkTHashMap<PaintKey, int, PaintKey::Hash> fPaintIndices;
+    SkTHashMap<PathKey, int, PathKey::Hash>   fPathIndices;
+    SkTHashMap<BitmapKey, int>                fBitmapIndices;
+    SkTHashMap<uint32_t, int>                 fImageIndices, fBlobIndices, fPictureIndices;
+
+    SkTDArray<const SkPaint*>         fPaints;
+    SkTDArray<const SkPath*>          fPaths;
+    SkTDArray<const ImmutableBitmap*> fBitmaps;
+    SkTDArray<const SkImage*>         fImages;
+    SkTDArray<const SkTextBlob*>      fBlobs;
+    SkTDArray<const SkPicture*>       fPictures;
+};
+
+template <> void Writer::fields(const NoOp&) {}
+template <> void Writer::fields(const Restore&) {}
+template <> void Writer::fields(const Save&) {}
+template <> void Writer::fields(const SaveLayer& r) {
+    this->optRect(r.bounds);
+    this->optPaint(r.paint);
+    this->u32(r.flags);
+}
+template <> void Writer::fields(const SetMatrix& r) { this->matrix(r.matrix); }
+
+template <> void Writer::fields(const ClipPath& r) {
+    this->path(r.path);
+    this->u32(r.opAA.op);
+    this->boolean(r.opAA.aa);
+}
+template <> void Writer::fields(const ClipRRect& r) {
+    this->rrect(r.rrect);
+    this->u32(r.opAA.op);
+    this->boolean(r.opAA.aa);
+}
+template <> void Writer::fields(const ClipRect& r) {
+    this->rect(r.rect);
+    this->u32(r.opAA.op);
+    this->boolean(r.opAA.aa);
+}
+template <> void Writer::fields(const ClipRegion& r) {
+    this->region(r.region);
+    this->u32(r.op);
+}
+
+template <> void Writer::fields(const DrawBitmap& r) {
+    this->optPaint(r.paint);
+    this->bitmap(r.bitmap);
+    this->scalar(r.left);
+    this->scalar(r.top);
+}
+template <> void Writer::fields(const DrawBitmapNine& r) {
+    this->optPaint(r.paint);
+    this->bitmap(r.bitmap);
+    this->irect(r.center);
+    this->rect(r.dst);
+}
+template <> void Writer::fields(const DrawBitmapRect& r) {
+    this->optPaint(r.paint);
+    this->bitmap(r.bitmap);
+    this->optRect(r.src);
+    this->rect(r.dst);
+}
+template <> void Writer::fields(const DrawBitmapRectFast& r) {
+    this->optPaint(r.paint);
+    this->bitmap(r.bitmap);
+    this->optRect(r.src);
+    this->rect(r.dst);
+}
+template <> void Writer::fields(const DrawBitmapRectFixedSize& r) {
+    this->paint(r.paint);
+    this->bitmap(r.bitmap);
+    this->rect(r.src);
+    this->rect(r.dst);
+    this->u32(r.constraint);
+}
+template <> void Writer::fields(const DrawDrawable&) {
+    // We serialize from records that have had their drawables drawn as pictures.
+    SkASSERT(false);
+}
+template <> void Writer::fields(const DrawImage& r) {
+    this->optPaint(r.paint);
+    this->image(r.image);
+    this->scalar(r.left);
+    this->scalar(r.top);
+}
+template <> void Writer::fields(const DrawImageRect& r) {
+    this->optPaint(r.paint);
+    this->image(r.image);
+    this->optRect(r.src);
+    this->rect(r.dst);
+    this->u32(r.constraint);
+}
+template <> void Writer::fields(const DrawImageNine& r) {
+    this->optPaint(r.paint);
+    this->image(r.image);
+    this->irect(r.center);
+    this->rect(r.dst);
+}
+template <> void Writer::fields(const DrawDRRect& r) {
+    this->paint(r.paint);
+    this->rrect(r.outer);
+    this->rrect(r.inner);
+}
+template <> void Writer::fields(const DrawOval& r) {
+    this->paint(r.paint);
+    this->rect(r.oval);
+}
+template <> void Writer::fields(const DrawPaint& r) { this->paint(r.paint); }
+template <> void Writer::fields(const DrawPath& r) {
+    this->paint(r.paint);
+    this->path(r.path);
+}
+template <> void Writer::fields(const DrawPatch& r) {
+    this->paint(r.paint);
+    this->array<SkPoint>(r.cubics, SkPatchUtils::kNumCtrlPts);
+    this->array<SkColor>(r.colors, 4);
+    this->array<SkPoint>(r.texCoords, 4);
+    this->flattenable(r.xmode);
+}
+template <> void Writer::fields(const DrawPicture& r) {
+    this->optPaint(r.paint);
+    this->picture(r.picture);
+    this->matrix(r.matrix);
+}
+template <> void Writer::fields(const DrawPoints& r) {
+    this->paint(r.paint);
+    this->u32(r.mode);
+    this->array<SkPoint>(r.pts, r.count);
+}
+template <> void Writer::fields(const DrawPosText& r) {
+    this->paint(r.paint);
+    this->array<char>(r.text, r.byteLength);
+    this->array<SkPoint>(r.pos, r.paint->countText(r.text, r.byteLength));
+}
+template <> void Writer::fields(const DrawPosTextH& r) {
+    this->paint(r.paint);
+    this->array<char>(r.text, r.byteLength);
+    this->scalar(r.y);
+    this->array<SkScalar>(r.xpos, r.paint->countText(r.text, r.byteLength));
+}
+template <> void Writer::fields(const DrawRRect& r) {
+    this->paint(r.paint);
+    this->rrect(r.rrect);
+}
+template <> void Writer::fields(const DrawRect& r) {
+    this->paint(r.paint);
+    this->rect(r.rect);
+}
+template <> void Writer::fields(const DrawSprite& r) {
+    this->optPaint(r.paint);
+    this->bitmap(r.bitmap);
+    this->i32(r.left);
+    this->i32(r.top);
+}
+template <> void Writer::fields(const DrawText& r) {
+    this->paint(r.paint);
+    this->array<char>(r.text, r.byteLength);
+    this->scalar(r.x);
+    this->scalar(r.y);
+}
+template <> void Writer::fields(const DrawTextBlob& r) {
+    this->paint(r.paint);
+    this->blob(r.blob);
+    this->scalar(r.x);
+    this->scalar(r.y);
+}
+template <> void Writer::fields(const DrawTextOnPath& r) {
+    this->paint(r.paint);
+    this->array<char>(r.text, r.byteLength);
+    this->path(r.path);
+    this->matrix(r.matrix);
+}
+template <> void Writer::fields(const DrawAtlas& r) {
+    this->optPaint(r.paint);
+    this->image(r.atlas);
+    this->array<SkRSXform>(r.xforms, r.count);
+    this->array<SkRect>(r.texs, r.count);
+    this->array<SkColor>(r.colors, r.count);
+    this->u32(r.mode);
+    this->optRect(r.cull);
+}
+template <> void Writer::fields(const DrawImageRects& r) {
+    this->optPaint(r.paint);
+    this->image(r.image);
+    this->array<SkRect>(r.srcs, r.count);
+    this->array<SkRect>(r.dsts, r.count);
+    this->u32(r.constraint);
+}
+template <> void Writer::fields(const DrawVertices& r) {
+    this->paint(r.paint);
+    this->u32(r.vmode);
+    this->array<SkPoint>(r.vertices, r.vertexCount);
+    this->array<SkPoint>(r.texs, r.vertexCount);
+    this->array<SkColor>(r.colors, r.vertexCount);
+    this->flattenable(r.xmode.get());
+    this->array<uint16_t>(r.indices, r.indexCount);
+}
+
+void Writer::write(SkWriteBuffer* out) {
+    SkASSERT(NULL == fOut);
+    for (unsigned i = 0; i < fRecord.count(); i++) {
+        fRecord.visit<void>(i, *this);
+    }
+
+    fOut = out;
+    this->writeDictionaries();
+    fOut->writeUInt(fRecord.count());
+    for (unsigned i = 0; i < fRecord.count(); i++) {
+        fRecord.visit<void>(i, *this);
+    }
+}
+
+void Writer::writeDictionaries() {
+    fOut->writeUInt(fPaints.count());
+    for (int i = 0; i < fPaints.count(); i++) {
+        fOut->writePaint(*fPaints[i]);
+    }
+    fOut->writeUInt(fPaths.count());
+    for (int i = 0; i < fPaths.count(); i++) {
+        fOut->writePath(*fPaths[i]);
+    }
+    fOut->writeUInt(fBitmaps.count());
+    for (int i = 0; i < fBitmaps.count(); i++) {
+        fOut->writeBitmap(fBitmaps[i]->shallowCopy());
+    }
+    fOut->writeUInt(fImages.count());
+    for (int i = 0; i < fImages.count(); i++) {
+        fOut->writeImage(fImages[i]);
+    }
+    fOut->writeUInt(fBlobs.count());
+    for (int i = 0; i < fBlobs.count(); i++) {
+        fBlobs[i]->flatten(*fOut);
+    }
+    fOut->writeUInt(fPictures.count());
+    for (int i = 0; i < fPictures.count(); i++) {
+        SkRecordSerialize(*fPictures[i], fOut);
+    }
+}
+
+// Reads the dictionaries and then the ops written by Writer, replaying each op into a canvas.
+// The buffer may not be validating, so we check everything we index or allocate with ourselves.
+class Reader : SkNoncopyable {
+public:
+    explicit Reader(SkReadBuffer* in) : fIn(in), fOK(true) {}
+    ~Reader() {
+        fImages.unrefAll();
+        fBlobs.unrefAll();
+        fPictures.unrefAll();
+    }
+
+    bool read(SkCanvas*);
+
+private:
+    // Reads the arguments of one op and draws it.  Specialized for each SkRecords type.
+    template <typename T> void op(SkCanvas*);
+
+    bool readOp(SkCanvas*);
+    bool readDictionaries();
+
+    bool check(bool ok) {
+        fOK = fIn->validate(ok) && ok && fOK;
+        return fOK;
+    }
+    bool ok() { return fOK && fIn->isValid(); }
+
+    size_t available() { return fIn->size() - fIn->offset(); }
+
+    // Reads a count of entries that each take at least 4 bytes.
+    int count() {
+        uint32_t n = fIn->readUInt();
+        return this->check(n <= this->available() / 4) ? SkToInt(n) : 0;
+    }
+
+    uint32_t u32()  { return fIn->readUInt();   }
+    int32_t i32()   { return fIn->readInt();    }
+    SkScalar scalar() { return fIn->readScalar(); }
+    bool boolean()  { return fIn->readBool();   }
+
+    template <typename E> E enumeration(E last) {
+        uint32_t v = fIn->readUInt();
+        return this->check(v <= (uint32_t)last) ? (E)v : (E)0;
+    }
+
+    SkRect rect()     { SkRect r;   fIn->readRect(&r);    return r; }
+    SkIRect irect()   { SkIRect r;  fIn->readIRect(&r);   return r; }
+    SkMatrix matrix() { SkMatrix m; fIn->readMatrix(&m);  return m; }
+
+    const SkRect* optRect(SkRect* storage) {
+        if (!this->boolean()) {
+            return NULL;
+        }
+        *storage = this->rect();
+        return storage;
+    }
+
+    SkXfermode* xfermode() {
+        return this->boolean() ? fIn->readXfermode() : NULL;
+    }
+
+    SkRRect rrect() {
+        SkAutoTMalloc<char> storage;
+        int size;
+        const char* bytes = this->array(&storage, &size);
+        SkRRect rrect;
+        this->check(SkRRect::kSizeInMemory == rrect.readFromMemory(bytes, size));
+        return rrect;
+    }
+
+    // Returns NULL for an empty array.
+    template <typename T> const T* array(SkAutoTMalloc<T>* storage, int* count) {
+        const size_t bytes = fIn->getArrayCount();
+        if (!this->check(bytes % sizeof(T) == 0 && bytes + 4 <= this->available())) {
+            *count = 0;
+            return NULL;
+        }
+        *count = SkToInt(bytes / sizeof(T));
+        storage->reset(*count);
+        fIn->readByteArray(storage->get(), bytes);
+        return *count ? storage->get() : NULL;
+    }
+
+    int index(int count) {
+        int i = fIn->readInt();
+        return this->check(i >= 0 && i < count) ? i : -1;
+    }
+
+    const SkPaint& paint() {
+        int i = this->index(fPaints.count());
+        return i < 0 ? fEmptyPaint : fPaints[i];
+    }
+    const SkPaint* optPaint() {
+        int i = this->index(fPaints.count() + 1);
+        return i > 0 ? &fPaints[i - 1] : NULL;
+    }
+    const SkPath& path() {
+        int i = this->index(fPaths.count());
+        return i < 0 ? fEmptyPath : fPaths[i];
+    }
+    const SkBitmap& bitmap() {
+        int i = this->index(fBitmaps.count());
+        return i < 0 ? fEmptyBitmap : fBitmaps[i];
+    }
+    const SkImage* image() {
+        int i = this->index(fImages.count());
+        return i < 0 ? NULL : fImages[i];
+    }
+    const SkTextBlob* blob() {
+        int i = this->index(fBlobs.count());
+        return i < 0 ? NULL : fBlobs[i];
+    }
+    const SkPicture* picture() {
+        int i = this->index(fPictures.count());
+        return i < 0 ? NULL : fPictures[i];
+    }
+
+    SkReadBuffer* fIn;
+    bool fOK;
+
+    SkTArray<SkPaint>  fPaints;
+    SkTArray<SkPath>   fPaths;
+    SkTArray<SkBitmap> fBitmaps;
+    SkTDArray<const SkImage*>    fImages;
+    SkTDArray<const SkTextBlob*> fBlobs;
+    SkTDArray<const SkPicture*>  fPictures;
+
+    // Stand-ins for bad indices, so we can finish reading an op before noticing it failed.
+    const SkPaint  fEmptyPaint;
+    const SkPath   fEmptyPath;
+    const SkBitmap fEmptyBitmap;
+};
+
+template <> void Reader::op<NoOp>(SkCanvas*) {}
+template <> void Reader::op<Restore>(SkCanvas* canvas) { canvas->restore(); }
+template <> void Reader::op<Save>(SkCanvas* canvas) { canvas->save(); }
+template <> void Reader::op<SaveLayer>(SkCanvas* canvas) {
+    SkRect storage;
+    const SkRect* bounds = this->optRect(&storage);
+    const SkPaint* paint = this->optPaint();
+    SkCanvas::SaveFlags flags = (SkCanvas::SaveFlags)this->u32();
+    if (this->ok()) {
+        canvas->saveLayer(bounds, paint, flags);
+    }
+}
+template <> void Reader::op<SetMatrix>(SkCanvas* canvas) {
+    SkMatrix matrix = this->matrix();
+    if (this->ok()) {
+        canvas->setMatrix(matrix);
+    }
+}
+
+template <> void Reader::op<ClipPath>(SkCanvas* canvas) {
+    const SkPath& path = this->path();
+    SkRegion::Op op = this->enumeration(SkRegion::kLastOp);
+    bool aa = this->boolean();
+    if (this->ok()) {
+        canvas->clipPath(path, op, aa);
+    }
+}
+template <> void Reader::op<ClipRRect>(SkCanvas* canvas) {
+    SkRRect rrect = this->rrect();
+    SkRegion::Op op = this->enumeration(SkRegion::kLastOp);
+    bool aa = this->boolean();
+    if (this->ok()) {
+        canvas->clipRRect(rrect, op, aa);
+    }
+}
+template <> void Reader::op<ClipRect>(SkCanvas* canvas) {
+    SkRect rect = this->rect();
+    SkRegion::Op op = this->enumeration(SkRegion::kLastOp);
+    bool aa = this->boolean();
+    if (this->ok()) {
+        canvas->clipRect(rect, op, aa);
+    }
+}
+template <> void Reader::op<ClipRegion>(SkCanvas* canvas) {
+    SkRegion region;
+    fIn->readRegion(&region);
+    SkRegion::Op op = this->enumeration(SkRegion::kLastOp);
+    if (this->ok()) {
+        canvas->clipRegion(region, op);
+    }
+}
+
+template <> void Reader::op<DrawBitmap>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkBitmap& bitmap = this->bitmap();
+    SkScalar left = this->scalar(),
+             top  = this->scalar();
+    if (this->ok()) {
+        canvas->drawBitmap(bitmap, left, top, paint);
+    }
+}
+template <> void Reader::op<DrawBitmapNine>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkBitmap& bitmap = this->bitmap();
+    SkIRect center = this->irect();
+    SkRect dst = this->rect();
+    if (this->ok()) {
+        canvas->drawBitmapNine(bitmap, center, dst, paint);
+    }
+}
+template <> void Reader::op<DrawBitmapRect>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkBitmap& bitmap = this->bitmap();
+    SkRect storage;
+    const SkRect* src = this->optRect(&storage);
+    SkRect dst = this->rect();
+    if (this->ok()) {
+        canvas->legacy_drawBitmapRect(bitmap, src, dst, paint, SkCanvas::kStrict_SrcRectConstraint);
+    }
+}
+template <> void Reader::op<DrawBitmapRectFast>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkBitmap& bitmap = this->bitmap();
+    SkRect storage;
+    const SkRect* src = this->optRect(&storage);
+    SkRect dst = this->rect();
+    if (this->ok()) {
+        canvas->legacy_drawBitmapRect(bitmap, src, dst, paint, SkCanvas::kFast_SrcRectConstraint);
+    }
+}
+template <> void Reader::op<DrawBitmapRectFixedSize>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    const SkBitmap& bitmap = this->bitmap();
+    SkRect src = this->rect(),
+           dst = this->rect();
+    SkCanvas::SrcRectConstraint constraint =
+            this->enumeration(SkCanvas::kFast_SrcRectConstraint);
+    if (this->ok()) {
+        canvas->legacy_drawBitmapRect(bitmap, &src, dst, &paint, constraint);
+    }
+}
+template <> void Reader::op<DrawDrawable>(SkCanvas*) {
+    // Writer never writes these.
+    this->check(false);
+}
+template <> void Reader::op<DrawImage>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkImage* image = this->image();
+    SkScalar left = this->scalar(),
+             top  = this->scalar();
+    if (this->ok()) {
+        canvas->drawImage(image, left, top, paint);
+    }
+}
+template <> void Reader::op<DrawImageRect>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkImage* image = this->image();
+    SkRect storage;
+    const SkRect* src = this->optRect(&storage);
+    SkRect dst = this->rect();
+    SkCanvas::SrcRectConstraint constraint =
+            this->enumeration(SkCanvas::kFast_SrcRectConstraint);
+    if (this->ok()) {
+        canvas->legacy_drawImageRect(image, src, dst, paint, constraint);
+    }
+}
+template <> void Reader::op<DrawImageNine>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkImage* image = this->image();
+    SkIRect center = this->irect();
+    SkRect dst = this->rect();
+    if (this->ok()) {
+        canvas->drawImageNine(image, center, dst, paint);
+    }
+}
+template <> void Reader::op<DrawDRRect>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkRRect outer = this->rrect(),
+            inner = this->rrect();
+    if (this->ok()) {
+        canvas->drawDRRect(outer, inner, paint);
+    }
+}
+template <> void Reader::op<DrawOval>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkRect oval = this->rect();
+    if (this->ok()) {
+        canvas->drawOval(oval, paint);
+    }
+}
+template <> void Reader::op<DrawPaint>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    if (this->ok()) {
+        canvas->drawPaint(paint);
+    }
+}
+template <> void Reader::op<DrawPath>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    const SkPath& path = this->path();
+    if (this->ok()) {
+        canvas->drawPath(path, paint);
+    }
+}
+template <> void Reader::op<DrawPatch>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkAutoTMalloc<SkPoint> cubicStorage, texStorage;
+    SkAutoTMalloc<SkColor> colorStorage;
+    int cubicCount, colorCount, texCount;
+    const SkPoint* cubics = this->array(&cubicStorage, &cubicCount);
+    const SkColor* colors = this->array(&colorStorage, &colorCount);
+    const SkPoint* texCoords = this->array(&texStorage, &texCount);
+    SkAutoTUnref<SkXfermode> xmode(this->xfermode());
+    if (this->check(cubicCount == SkPatchUtils::kNumCtrlPts &&
+                    (0 == colorCount || 4 == colorCount) &&
+                    (0 == texCount || 4 == texCount)) && this->ok()) {
+        canvas->drawPatch(cubics, colors, texCoords, xmode, paint);
+    }
+}
+template <> void Reader::op<DrawPicture>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkPicture* picture = this->picture();
+    SkMatrix matrix = this->matrix();
+    if (this->ok()) {
+        canvas->drawPicture(picture, &matrix, paint);
+    }
+}
+template <> void Reader::op<DrawPoints>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkCanvas::PointMode mode = this->enumeration(SkCanvas::kPolygon_PointMode);
+    SkAutoTMalloc<SkPoint> storage;
+    int count;
+    const SkPoint* pts = this->array(&storage, &count);
+    if (this->ok()) {
+        canvas->drawPoints(mode, count, pts, paint);
+    }
+}
+template <> void Reader::op<DrawPosText>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkAutoTMalloc<char> textStorage;
+    SkAutoTMalloc<SkPoint> posStorage;
+    int byteLength, posCount;
+    const char* text = this->array(&textStorage, &byteLength);
+    const SkPoint* pos = this->array(&posStorage, &posCount);
+    if (this->check(posCount == paint.countText(text, byteLength)) && this->ok()) {
+        canvas->drawPosText(text, byteLength, pos, paint);
+    }
+}
+template <> void Reader::op<DrawPosTextH>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkAutoTMalloc<char> textStorage;
+    SkAutoTMalloc<SkScalar> xposStorage;
+    int byteLength, xposCount;
+    const char* text = this->array(&textStorage, &byteLength);
+    SkScalar y = this->scalar();
+    const SkScalar* xpos = this->array(&xposStorage, &xposCount);
+    if (this->check(xposCount == paint.countText(text, byteLength)) && this->ok()) {
+        canvas->drawPosTextH(text, byteLength, xpos, y, paint);
+    }
+}
+template <> void Reader::op<DrawRRect>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkRRect rrect = this->rrect();
+    if (this->ok()) {
+        canvas->drawRRect(rrect, paint);
+    }
+}
+template <> void Reader::op<DrawRect>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkRect rect = this->rect();
+    if (this->ok()) {
+        canvas->drawRect(rect, paint);
+    }
+}
+template <> void Reader::op<DrawSprite>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkBitmap& bitmap = this->bitmap();
+    int left = this->i32(),
+        top  = this->i32();
+    if (this->ok()) {
+        canvas->drawSprite(bitmap, left, top, paint);
+    }
+}
+template <> void Reader::op<DrawText>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkAutoTMalloc<char> storage;
+    int byteLength;
+    const char* text = this->array(&storage, &byteLength);
+    SkScalar x = this->scalar(),
+             y = this->scalar();
+    if (this->ok()) {
+        canvas->drawText(text, byteLength, x, y, paint);
+    }
+}
+template <> void Reader::op<DrawTextBlob>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    const SkTextBlob* blob = this->blob();
+    SkScalar x = this->scalar(),
+             y = this->scalar();
+    if (this->ok()) {
+        canvas->drawTextBlob(blob, x, y, paint);
+    }
+}
+template <> void Reader::op<DrawTextOnPath>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkAutoTMalloc<char> storage;
+    int byteLength;
+    const char* text = this->array(&storage, &byteLength);
+    const SkPath& path = this->path();
+    SkMatrix matrix = this->matrix();
+    if (this->ok()) {
+        canvas->drawTextOnPath(text, byteLength, path, &matrix, paint);
+    }
+}
+template <> void Reader::op<DrawAtlas>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkImage* atlas = this->image();
+    SkAutoTMalloc<SkRSXform> xformStorage;
+    SkAutoTMalloc<SkRect> texStorage;
+    SkAutoTMalloc<SkColor> colorStorage;
+    int count, texCount, colorCount;
+    const SkRSXform* xforms = this->array(&xformStorage, &count);
+    const SkRect* texs = this->array(&texStorage, &texCount);
+    const SkColor* colors = this->array(&colorStorage, &colorCount);
+    SkXfermode::Mode mode = this->enumeration(SkXfermode::kLastMode);
+    SkRect cullStorage;
+    const SkRect* cull = this->optRect(&cullStorage);
+    if (this->check(texCount == count && (0 == colorCount || colorCount == count)) &&
+        this->ok()) {
+        canvas->drawAtlas(atlas, xforms, texs, colors, count, mode, cull, paint);
+    }
+}
+// The canvas we draw into records separate DrawImageRect ops, which SkRecordOptimize() re-merges.
+template <> void Reader::op<DrawImageRects>(SkCanvas* canvas) {
+    const SkPaint* paint = this->optPaint();
+    const SkImage* image = this->image();
+    SkAutoTMalloc<SkRect> srcStorage, dstStorage;
+    int count, dstCount;
+    const SkRect* srcs = this->array(&srcStorage, &count);
+    const SkRect* dsts = this->array(&dstStorage, &dstCount);
+    SkCanvas::SrcRectConstraint constraint =
+            this->enumeration(SkCanvas::kFast_SrcRectConstraint);
+    if (this->check(dstCount == count) && this->ok()) {
+        for (int i = 0; i < count; i++) {
+            canvas->legacy_drawImageRect(image, &srcs[i], dsts[i], paint, constraint);
+        }
+    }
+}
+template <> void Reader::op<DrawVertices>(SkCanvas* canvas) {
+    const SkPaint& paint = this->paint();
+    SkCanvas::VertexMode vmode = this->enumeration(SkCanvas::kTriangleFan_VertexMode);
+    SkAutoTMalloc<SkPoint> vertexStorage, texStorage;
+    SkAutoTMalloc<SkColor> colorStorage;
+    SkAutoTMalloc<uint16_t> indexStorage;
+    int vertexCount, texCount, colorCount, indexCount;
+    const SkPoint* vertices = this->array(&vertexStorage, &vertexCount);
+    const SkPoint* texs = this->array(&texStorage, &texCount);
+    const SkColor* colors = this->array(&colorStorage, &colorCount);
+    SkAutoTUnref<SkXfermode> xmode(this->xfermode());
+    const uint16_t* indices = this->array(&indexStorage, &indexCount);
+    if (this->check((0 == texCount || texCount == vertexCount) &&
+                    (0 == colorCount || colorCount == vertexCount)) && this->ok()) {
+        canvas->drawVertices(vmode, vertexCount, vertices, texs, colors, xmode,
+                             indices, indexCount, paint);
+    }
+}
+
+bool Reader::readDictionaries() {
+    fPaints.reset(this->count());
+    for (int i = 0; this->ok() && i < fPaints.count(); i++) {
+        fIn->readPaint(&fPaints[i]);
+    }
+    fPaths.reset(this->count());
+    for (int i = 0; this->ok() && i < fPaths.count(); i++) {
+        fIn->readPath(&fPaths[i]);
+    }
+    fBitmaps.reset(this->count());
+    for (int i = 0; this->ok() && i < fBitmaps.count(); i++) {
+        fIn->readBitmap(&fBitmaps[i]);
+        fBitmaps[i].setImmutable();
+    }
+    for (int i = this->count(); this->ok() && i > 0; i--) {
+        const SkImage* image = fIn->readImage();
+        if (this->check(SkToBool(image))) {
+            *fImages.append() = image;
+        }
+    }
+    for (int i = this->count(); this->ok() && i > 0; i--) {
+        const SkTextBlob* blob = SkTextBlob::CreateFromBuffer(*fIn);
+        if (this->check(SkToBool(blob))) {
+            *fBlobs.append() = blob;
+        }
+    }
+    for (int i = this->count(); this->ok() && i > 0; i--) {
+        const SkPicture* picture = SkRecordDeserialize(fIn);
+        if (this->check(SkToBool(picture))) {
+            *fPictures.append() = picture;
+        }
+    }
+    return this->ok();
+}
+
+bool Reader::readOp(SkCanvas* canvas) {
+    switch (fIn->readUInt()) {
+    #define CASE(T) case T##_Type: this->op<T>(canvas); break;
+        SK_RECORD_TYPES(CASE)
+    #undef CASE
+        default: this->check(false); break;
+    }
+    return this->ok();
+}
+
+bool Reader::read(SkCanvas* canvas) {
+    if (!this->readDictionaries()) {
+        return false;
+    }
+    for (int i = this->count(); i > 0; i--) {
+        if (!this->readOp(canvas)) {
+            return false;
+        }
+    }
+    return this->ok();
+}
+
+}  // namespace
+
+// Our caller may have handed us any sort of picture.  If it's not already backed by a plain
+// SkRecord, draw it into one.
+static const SkRecord* record_of(const SkPicture& picture, SkRecord* scratch) {
+    if (const SkBigPicture* big = picture.asSkBigPicture()) {
+        if (0 == big->drawableCount()) {
+            return big->record();
+        }
+    }
+    SkRecorder recorder(scratch, picture.cullRect());
+    picture.playback(&recorder);
+    return scratch;
+}
+
+void SkRecordSerialize(const SkPicture& picture, SkWriteBuffer* buffer) {
+    SkRecord scratch;
+    const SkRecord* record = record_of(picture, &scratch);
+
+    buffer->writeRect(picture.cullRect());
+    Writer(*record).write(buffer);
+}
+
+SkPicture* SkRecordDeserialize(SkReadBuffer* buffer) {
+    SkRect cullRect;
+    buffer->readRect(&cullRect);
+
+    SkPictureRecorder recorder;
+    if (!Reader(buffer).read(recorder.beginRecording(cullRect))) {
+        return NULL;
+    }
+    return recorder.endRecording();
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRecordSerialize_DEFINED
+#define SkRecordSerialize_DEFINED
+
+class SkPicture;
+class SkReadBuffer;
+class SkWriteBuffer;
+
+// Writes a picture's SkRecord ops directly, one per SkRecords type, followed by their arguments.
+// Paints, paths, bitmaps, images, text blobs and sub-pictures are each written once into shared
+// dictionaries, which the ops then refer to by index.
+void SkRecordSerialize(const SkPicture&, SkWriteBuffer*);
+
+// Reads a picture written by SkRecordSerialize(), recording its ops straight back into an
+// SkRecord.  Returns NULL if the buffer is invalid.
+SkPicture* SkRecordDeserialize(SkReadBuffer*);
+
+#endif//SkRecordSerialize_DEFINED
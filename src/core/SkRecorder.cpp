@@ -128,31 +128,32 @@ void SkRecorder::flushMiniRecorder() {
 }
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    APPEND(DrawPaint, paint);
+    APPEND(DrawPaint, fRecord->internPaint(paint));
 }
 
 void SkRecorder::onDrawPoints(PointMode mode,
                               size_t count,
                               const SkPoint pts[],
                               const SkPaint& paint) {
-    APPEND(DrawPoints, paint, mode, SkToUInt(count), this->copy(pts, count));
+    APPEND(DrawPoints,
+           fRecord->internPaint(paint), mode, SkToUInt(count), this->copy(pts, count));
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     TRY_MINIRECORDER(drawRect, rect, paint);
-    APPEND(DrawRect, paint, rect);
+    APPEND(DrawRect, fRecord->internPaint(paint), rect);
 }
 
 void SkRecorder::onDrawOval(const SkRect& oval, const SkPaint& paint) {
-    APPEND(DrawOval, paint, oval);
+    APPEND(DrawOval, fRecord->internPaint(paint), oval);
 }
 
 void SkRecorder::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    APPEND(DrawRRect, paint, rrect);
+    APPEND(DrawRRect, fRecord->internPaint(paint), rrect);
 }
 
 void SkRecorder::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    APPEND(DrawDRRect, paint, outer, inner);
+    APPEND(DrawDRRect, fRecord->internPaint(paint), outer, inner);
 }
 
 void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
@@ -165,7 +166,7 @@ void SkRecorder::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) {
 
 void SkRecorder::onDrawPath(const SkPath& path, const SkPaint& paint) {
     TRY_MINIRECORDER(drawPath, path, paint);
-    APPEND(DrawPath, paint, path);
+    APPEND(DrawPath, fRecord->internPaint(paint), path);
 }
 
 void SkRecorder::onDrawBitmap(const SkBitmap& bitmap,
@@ -240,14 +241,18 @@ void SkRecorder::onDrawSprite(const SkBitmap& bitmap, int left, int top, const S
 void SkRecorder::onDrawText(const void* text, size_t byteLength,
                             SkScalar x, SkScalar y, const SkPaint& paint) {
     APPEND(DrawText,
-           paint, this->copy((const char*)text, byteLength), byteLength, x, y);
+           fRecord->internPaint(paint),
+           this->copy((const char*)text, byteLength),
+           byteLength,
+           x,
+           y);
 }
 
 void SkRecorder::onDrawPosText(const void* text, size_t byteLength,
                                const SkPoint pos[], const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosText,
-           paint,
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            this->copy(pos, points));
@@ -257,7 +262,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
                                 const SkScalar xpos[], SkScalar constY, const SkPaint& paint) {
     const unsigned points = paint.countText(text, byteLength);
     APPEND(DrawPosTextH,
-           paint,
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            SkToUInt(byteLength),
            constY,
@@ -267,7 +272,7 @@ void SkRecorder::onDrawPosTextH(const void* text, size_t byteLength,
 void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                   const SkMatrix* matrix, const SkPaint& paint) {
     APPEND(DrawTextOnPath,
-           paint,
+           fRecord->internPaint(paint),
            this->copy((const char*)text, byteLength),
            byteLength,
            path,
@@ -277,17 +282,21 @@ void SkRecorder::onDrawTextOnPath(const void* text, size_t byteLength, const SkP
 void SkRecorder::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                 const SkPaint& paint) {
     TRY_MINIRECORDER(drawTextBlob, blob, x, y, paint);
-    APPEND(DrawTextBlob, paint, blob, x, y);
+    APPEND(DrawTextBlob, fRecord->internPaint(paint), blob, x, y);
 }
 
 void SkRecorder::onDrawPicture(const SkPicture* pic, const SkMatrix* matrix, const SkPaint* paint) {
-    if (fDrawPictureMode == Record_DrawPictureMode) {
-        fApproxBytesUsedBySubPictures += SkPictureUtils::ApproximateBytesUsed(pic);
-        APPEND(DrawPicture, this->copy(paint), pic, matrix ? *matrix : SkMatrix::I());
-    } else {
-        SkASSERT(fDrawPictureMode == Playback_DrawPictureMode);
+    // Inlining a small picture lets its ops share our BBH and peephole optimizations, and saves
+    // the nested save/concat/restore and BBH search each time it's played back.
+    const bool inlinePicture = fDrawPictureMode == Playback_DrawPictureMode ||
+                         (fDrawPictureMode == InlineSmall_DrawPictureMode &&
+                          pic->approximateOpCount() <= kMaxPictureOpsToInline);
+    if (inlinePicture) {
         SkAutoCanvasMatrixPaint acmp(this, matrix, paint, pic->cullRect());
         pic->playback(this);
+    } else {
+        fApproxBytesUsedBySubPictures += SkPictureUtils::ApproximateBytesUsed(pic);
+        APPEND(DrawPicture, this->copy(paint), pic, matrix ? *matrix : SkMatrix::I());
     }
 }
 
@@ -296,7 +305,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
                                 const SkPoint texs[], const SkColor colors[],
                                 SkXfermode* xmode,
                                 const uint16_t indices[], int indexCount, const SkPaint& paint) {
-    APPEND(DrawVertices, paint,
+    APPEND(DrawVertices, fRecord->internPaint(paint),
                          vmode,
                          vertexCount,
                          this->copy(vertices, vertexCount),
@@ -309,7 +318,7 @@ void SkRecorder::onDrawVertices(VertexMode vmode,
 
 void SkRecorder::onDrawPatch(const SkPoint cubics[12], const SkColor colors[4],
                              const SkPoint texCoords[4], SkXfermode* xmode, const SkPaint& paint) {
-    APPEND(DrawPatch, paint,
+    APPEND(DrawPatch, fRecord->internPaint(paint),
            cubics ? this->copy(cubics, SkPatchUtils::kNumCtrlPts) : NULL,
            colors ? this->copy(colors, SkPatchUtils::kNumCorners) : NULL,
            texCoords ? this->copy(texCoords, SkPatchUtils::kNumCorners) : NULL,
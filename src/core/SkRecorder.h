@@ -42,7 +42,14 @@ public:
     SkRecorder(SkRecord*, int width, int height, SkMiniRecorder* = nullptr);   // legacy version
     SkRecorder(SkRecord*, const SkRect& bounds, SkMiniRecorder* = nullptr);
 
-    enum DrawPictureMode { Record_DrawPictureMode, Playback_DrawPictureMode };
+    // Record_ refs every picture drawn, Playback_ inlines every picture drawn, and InlineSmall_
+    // inlines pictures of at most kMaxPictureOpsToInline ops and refs the rest.
+    enum DrawPictureMode {
+        Record_DrawPictureMode,
+        Playback_DrawPictureMode,
+        InlineSmall_DrawPictureMode,
+    };
+    static const int kMaxPictureOpsToInline = 16;
     void reset(SkRecord*, const SkRect& bounds, DrawPictureMode, SkMiniRecorder* = nullptr);
 
     size_t approxBytesUsedBySubPictures() const { return fApproxBytesUsedBySubPictures; }
@@ -5,7 +5,6 @@
  * found in the LICENSE file.
  */
 
-#include "SkPathPriv.h"
 #include "SkRecords.h"
 
 namespace SkRecords {
@@ -20,10 +19,6 @@ namespace SkRecords {
 
     PreCachedPath::PreCachedPath(const SkPath& path) : SkPath(path) {
         this->updateBoundsCache();
-#if 0  // Disabled to see if we ever really race on this.  It costs time, chromium:496982.
-        SkPathPriv::FirstDirection junk;
-        (void)SkPathPriv::CheapComputeFirstDirection(*this, &junk);
-#endif
     }
 
     TypedMatrix::TypedMatrix(const SkMatrix& matrix) : SkMatrix(matrix) {
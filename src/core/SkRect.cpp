@@ -52,6 +52,9 @@ static inline bool is_finite(const Sk4s& value) {
     return finite.allTrue();
 }
 
+// Below this many points, merging a second set of accumulators costs more than it saves.
+static const int kUnrolledBoundsMinCount = 32;
+
 bool SkRect::setBoundsCheck(const SkPoint pts[], int count) {
     SkASSERT((pts && count > 0) || count == 0);
 
@@ -74,6 +77,26 @@ bool SkRect::setBoundsCheck(const SkPoint pts[], int count) {
         accum = max = min;
         accum = accum * Sk4s(0);
 
+        // For longer arrays, take four points at a time into two sets of accumulators, so the
+        // loads and min/max of one pair don't wait on the other's.
+        if (count >= kUnrolledBoundsMinCount) {
+            Sk4s min2 = min, max2 = max, accum2 = accum;
+            for (; count >= 4; count -= 4) {
+                Sk4s xy = Sk4s::Load(&pts[0].fX);
+                Sk4s xy2 = Sk4s::Load(&pts[2].fX);
+                accum = accum * xy;
+                accum2 = accum2 * xy2;
+                min = Sk4s::Min(min, xy);
+                min2 = Sk4s::Min(min2, xy2);
+                max = Sk4s::Max(max, xy);
+                max2 = Sk4s::Max(max2, xy2);
+                pts += 4;
+            }
+            accum = accum * accum2;
+            min = Sk4s::Min(min, min2);
+            max = Sk4s::Max(max, max2);
+        }
+
         count >>= 1;
         for (int i = 0; i < count; ++i) {
             Sk4s xy = Sk4s::Load(&pts->fX);
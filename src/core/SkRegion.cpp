@@ -9,6 +9,8 @@
 
 #include "SkAtomics.h"
 #include "SkRegionPriv.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
 #include "SkTemplates.h"
 #include "SkUtils.h"
 
@@ -585,16 +587,139 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+static bool top_less_than(const SkIRect& a, const SkIRect& b) {
+    return a.fTop < b.fTop;
+}
+
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
+    // Gather the non-empty rects, top to bottom, and every y where one of them starts or stops.
+    SkTDArray<SkIRect> sorted;
+    SkTDArray<RunType> ys;
+    for (int i = 0; i < count; i++) {
+        if (!rects[i].isEmpty()) {
+            *sorted.append() = rects[i];
+            *ys.append() = rects[i].fTop;
+            *ys.append() = rects[i].fBottom;
+        }
+    }
+    if (sorted.count() <= 1) {
+        return sorted.isEmpty() ? this->setEmpty() : this->setRect(sorted[0]);
+    }
+    SkTQSort(sorted.begin(), sorted.end() - 1, top_less_than);
+    SkTQSort(ys.begin(), ys.end() - 1);
+
+    // Each band between two of those ys is covered by the same rects, kept here in order of
+    // their left edges, so that the band's intervals are merged in one pass. A band with the
+    // same intervals as the one above it just moves that one's bottom down.
+    SkTDArray<const SkIRect*> active;
+    SkTDArray<RunType> runs;
+    *runs.append() = ys[0];
+    int prevIntervals = -1;     // index in runs of the last band's interval count
+    int next = 0;
+    for (int i = 0; i < ys.count() - 1; i++) {
+        const int top = ys[i];
+        const int bottom = ys[i + 1];
+        if (top == bottom) {
+            continue;
+        }
+
+        int kept = 0;
+        for (int j = 0; j < active.count(); j++) {
+            if (active[j]->fBottom > top) {
+                active[kept++] = active[j];
+            }
+        }
+        active.setCount(kept);
+        for (; next < sorted.count() && sorted[next].fTop <= top; next++) {
+            const SkIRect* rect = &sorted[next];
+            int j = active.count();
+            while (j > 0 && active[j - 1]->fLeft > rect->fLeft) {
+                j--;
+            }
+            *active.insert(j) = rect;
+        }
+
+        const int start = runs.count();
+        runs.append(2);     // bottom and interval count
+        for (int j = 0; j < active.count(); j++) {
+            const SkIRect* rect = active[j];
+            if (runs.count() > start + 2 && runs.top() >= rect->fLeft) {
+                runs.top() = SkMax32(runs.top(), rect->fRight);
+            } else {
+                *runs.append() = rect->fLeft;
+                *runs.append() = rect->fRight;
+            }
+        }
+        const int intervals = (runs.count() - start - 2) >> 1;
+        *runs.append() = kRunTypeSentinel;
+
+        if (prevIntervals >= 0 && runs[prevIntervals] == intervals &&
+                !memcmp(&runs[prevIntervals + 1], &runs[start + 2],
+                        2 * intervals * sizeof(RunType))) {
+            runs[prevIntervals - 1] = bottom;
+            runs.setCount(start);
+        } else {
+            runs[start] = bottom;
+            runs[start + 1] = intervals;
+            prevIntervals = start + 1;
         }
     }
-    return !this->isEmpty();
+    *runs.append() = kRunTypeSentinel;
+    return this->setRuns(runs.begin(), runs.count());
+}
+
+// Sets dst to dst op rgns[0] op ... op rgns[count-1], combining them pairwise so that each
+// region is merged about log(count) times rather than once per region after it. Only for ops
+// whose result doesn't depend on the order they are applied in.
+static bool op_tree(SkRegion* dst, const SkRegion rgns[], int count, SkRegion::Op op) {
+    SkAutoTArray<SkRegion> tree(count + 1);
+    tree[0] = *dst;
+    for (int i = 0; i < count; i++) {
+        tree[i + 1] = rgns[i];
+    }
+    for (int n = count + 1; n > 1; n = (n + 1) >> 1) {
+        for (int i = 0; i + 1 < n; i += 2) {
+            tree[i >> 1].op(tree[i], tree[i + 1], op);
+        }
+        if (n & 1) {
+            tree[n >> 1] = tree[n - 1];
+        }
+    }
+    dst->swap(tree[0]);
+    return !dst->isEmpty();
+}
+
+bool SkRegion::opMany(const SkRegion rgns[], int count, Op op) {
+    switch (op) {
+        case kIntersect_Op:
+        case kUnion_Op:
+        case kXOR_Op:
+            return op_tree(this, rgns, count, op);
+        case kDifference_Op: {
+            SkRegion all;
+            op_tree(&all, rgns, count, kUnion_Op);
+            return this->op(all, kDifference_Op);
+        }
+        default:
+            // reverse difference and replace depend on the order
+            for (int i = 0; i < count; i++) {
+                this->op(rgns[i], op);
+            }
+            return !this->isEmpty();
+    }
+}
+
+bool SkRegion::opMany(const SkIRect rects[], int count, Op op) {
+    if (kUnion_Op == op || kDifference_Op == op) {
+        SkRegion all;
+        all.setRects(rects, count);
+        return this->op(all, op);
+    }
+    SkAutoTArray<SkRegion> rgns(count);
+    for (int i = 0; i < count; i++) {
+        rgns[i].setRect(rects[i]);
+    }
+    return this->opMany(rgns.get(), count, op);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
 #include "SkMessageBus.h"
 #include "SkMipMap.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 #include "SkPixelRef.h"
 #include "SkResourceCache.h"
 
@@ -49,10 +50,10 @@ void SkResourceCache::Key::init(void* nameSpace, uint64_t sharedID, size_t lengt
                                 (fCount32 - kUnhashedLocal32s) << 2);
 }
 
-#include "SkTDynamicHash.h"
+#include "SkTGroupProbeHash.h"
 
 class SkResourceCache::Hash :
-    public SkTDynamicHash<SkResourceCache::Rec, SkResourceCache::Key> {};
+    public SkTGroupProbeHash<SkResourceCache::Rec, SkResourceCache::Key> {};
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -62,6 +63,7 @@ void SkResourceCache::init() {
     fTail = NULL;
     fHash = new Hash;
     fTotalBytesUsed = 0;
+    fPeakBytesUsed = 0;
     fCount = 0;
     fSingleAllocationByteLimit = 0;
     fAllocator = NULL;
@@ -207,19 +209,34 @@ SkResourceCache::~SkResourceCache() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+SkResourceCache::NamespaceStats* SkResourceCache::findNamespaceStats(void* nameSpace) {
+    // There are only a handful of namespaces.
+    for (int i = 0; i < fNamespaceStats.count(); ++i) {
+        if (fNamespaceStats[i].fNamespace == nameSpace) {
+            return &fNamespaceStats[i];
+        }
+    }
+    NamespaceStats* stats = fNamespaceStats.append();
+    sk_bzero(stats, sizeof(NamespaceStats));
+    stats->fNamespace = nameSpace;
+    return stats;
+}
+
 bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     this->checkMessages();
 
+    NamespaceStats* stats = this->findNamespaceStats(key.getNamespace());
     Rec* rec = fHash->find(key);
     if (rec) {
         if (visitor(*rec, context)) {
             this->moveToHead(rec);  // for our LRU
+            stats->fHits += 1;
             return true;
         } else {
             this->remove(rec);  // stale
-            return false;
         }
     }
+    stats->fMisses += 1;
     return false;
 }
 
@@ -249,6 +266,12 @@ void SkResourceCache::add(Rec* rec) {
     this->addToHead(rec);
     fHash->add(rec);
 
+    NamespaceStats* stats = this->findNamespaceStats(rec->getKey().getNamespace());
+    SkASSERT(NULL == stats->fCategory || 0 == strcmp(stats->fCategory, rec->getCategory()));
+    stats->fCategory = rec->getCategory();
+    stats->fBytes += rec->bytesUsed();
+    stats->fCount += 1;
+
     if (gDumpCacheTransactions) {
         SkString bytesStr, totalStr;
         make_size_str(rec->bytesUsed(), &bytesStr);
@@ -271,6 +294,11 @@ void SkResourceCache::remove(Rec* rec) {
     fTotalBytesUsed -= used;
     fCount -= 1;
 
+    NamespaceStats* stats = this->findNamespaceStats(rec->getKey().getNamespace());
+    SkASSERT(stats->fBytes >= used && stats->fCount > 0);
+    stats->fBytes -= used;
+    stats->fCount -= 1;
+
     if (gDumpCacheTransactions) {
         SkString bytesStr, totalStr;
         make_size_str(used, &bytesStr);
@@ -301,6 +329,23 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
         }
 
         Rec* prev = rec->fPrev;
+        this->findNamespaceStats(rec->getKey().getNamespace())->fEvictions += 1;
+        this->remove(rec);
+        rec = prev;
+    }
+}
+
+void SkResourceCache::purgeToFraction(float fraction) {
+    fraction = SkTPin(fraction, 0.0f, 1.0f);
+    // Discardable entries are budgeted by count, the rest by bytes, as in purgeAsNeeded().
+    const size_t byteTarget = fDiscardableFactory ? SK_MaxU32
+                                                  : static_cast<size_t>(fTotalBytesUsed * fraction);
+    const int countTarget = fDiscardableFactory ? static_cast<int>(fCount * fraction) : SK_MaxS32;
+
+    Rec* rec = fTail;
+    while (rec && (fTotalBytesUsed > byteTarget || fCount > countTarget)) {
+        Rec* prev = rec->fPrev;
+        this->findNamespaceStats(rec->getKey().getNamespace())->fEvictions += 1;
         this->remove(rec);
         rec = prev;
     }
@@ -421,6 +466,7 @@ void SkResourceCache::addToHead(Rec* rec) {
         fTail = rec;
     }
     fTotalBytesUsed += rec->bytesUsed();
+    fPeakBytesUsed = SkTMax(fTotalBytesUsed, fPeakBytesUsed);
     fCount += 1;
 
     this->validate();
@@ -480,6 +526,20 @@ void SkResourceCache::dump() const {
              fCount, fTotalBytesUsed, fDiscardableFactory ? "discardable" : "malloc");
 }
 
+void SkResourceCache::visitStats(SkCacheStats::Visitor visitor, void* context) const {
+    for (int i = 0; i < fNamespaceStats.count(); ++i) {
+        const NamespaceStats& ns = fNamespaceStats[i];
+        SkCacheStats stats;
+        stats.fName = ns.fCategory ? ns.fCategory : "unknown";
+        stats.fHits = ns.fHits;
+        stats.fMisses = ns.fMisses;
+        stats.fEvictions = ns.fEvictions;
+        stats.fBytes = ns.fBytes;
+        stats.fEntries = ns.fCount;
+        visitor(stats, context);
+    }
+}
+
 size_t SkResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
     size_t oldLimit = fSingleAllocationByteLimit;
     fSingleAllocationByteLimit = newLimit;
@@ -516,96 +576,204 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-SK_DECLARE_STATIC_MUTEX(gMutex);
-static SkResourceCache* gResourceCache = NULL;
-static void cleanup_gResourceCache() {
+// The global cache may be split into independent shards to cut lock contention when many
+// threads hit it at once.  Each shard is a complete SkResourceCache with its own mutex, LRU,
+// and an equal slice of the byte budget; a Key always lands in the shard picked by its hash().
+// Each shard subscribes to PurgeSharedIDMessages itself, so PostPurgeSharedID() reaches them all.
+// The default of 1 shard behaves exactly like a single global cache.
+#ifndef SK_RESOURCE_CACHE_SHARD_COUNT
+    #define SK_RESOURCE_CACHE_SHARD_COUNT 1
+#endif
+
+namespace {
+
+struct Shard {
+    SkMutex          fMutex;
+    SkResourceCache* fCache;
+};
+
+}  // namespace
+
+static const int kShardCount = SK_RESOURCE_CACHE_SHARD_COUNT;
+SK_COMPILE_ASSERT(kShardCount > 0, resource_cache_needs_at_least_one_shard);
+
+SK_DECLARE_STATIC_ONCE(gShardsOnce);
+static Shard* gShards = NULL;
+static SkAtomic<uint32_t> gNextCachedDataShard;
+
+static void cleanup_gShards() {
     // We'll clean this up in our own tests, but disable for clients.
     // Chrome seems to have funky multi-process things going on in unit tests that
     // makes this unsafe to delete when the main process atexit()s.
     // SkLazyPtr does the same sort of thing.
 #if SK_DEVELOPER
-    SkDELETE(gResourceCache);
+    for (int i = 0; i < kShardCount; ++i) {
+        SkDELETE(gShards[i].fCache);
+    }
+    SkDELETE_ARRAY(gShards);
 #endif
 }
 
-/** Must hold gMutex when calling. */
-static SkResourceCache* get_cache() {
-    // gMutex is always held when this is called, so we don't need to be fancy in here.
-    gMutex.assertHeld();
-    if (NULL == gResourceCache) {
+// Shard i gets byteLimit / kShardCount, with the remainder spread over the first shards,
+// so the slices always sum back to exactly byteLimit.
+static size_t shard_byte_limit(size_t byteLimit, int i) {
+    return byteLimit / kShardCount + ((size_t)i < byteLimit % kShardCount ? 1 : 0);
+}
+
+static void create_shards(int) {
+    gShards = SkNEW_ARRAY(Shard, kShardCount);
+    for (int i = 0; i < kShardCount; ++i) {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SkDiscardableMemory::Create));
+        gShards[i].fCache = SkNEW_ARGS(SkResourceCache, (SkDiscardableMemory::Create));
 #else
-        gResourceCache = SkNEW_ARGS(SkResourceCache, (SK_DEFAULT_IMAGE_CACHE_LIMIT));
+        gShards[i].fCache = SkNEW_ARGS(SkResourceCache,
+                                       (shard_byte_limit(SK_DEFAULT_IMAGE_CACHE_LIMIT, i)));
 #endif
-        atexit(cleanup_gResourceCache);
     }
-    return gResourceCache;
+    atexit(cleanup_gShards);
+}
+
+static Shard* get_shards() {
+    SkOnce(&gShardsOnce, create_shards, 0);
+    return gShards;
+}
+
+static Shard* get_shard(const SkResourceCache::Key& key) {
+    return &get_shards()[key.hash() % kShardCount];
+}
+
+/** Calls fn(shard's cache) for each shard in turn, holding only that shard's mutex. */
+template <typename Fn>
+static void for_each_shard(const Fn& fn) {
+    Shard* shards = get_shards();
+    for (int i = 0; i < kShardCount; ++i) {
+        SkAutoMutexAcquire am(shards[i].fMutex);
+        fn(i, shards[i].fCache);
+    }
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalBytesUsed();
+    size_t used = 0;
+    for_each_shard([&](int, SkResourceCache* cache) { used += cache->getTotalBytesUsed(); });
+    return used;
+}
+
+size_t SkResourceCache::GetPeakBytesUsed() {
+    size_t peak = 0;
+    for_each_shard([&](int, SkResourceCache* cache) { peak += cache->getPeakBytesUsed(); });
+    return peak;
+}
+
+void SkResourceCache::ResetPeakBytesUsed() {
+    for_each_shard([](int, SkResourceCache* cache) { cache->resetPeakBytesUsed(); });
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getTotalByteLimit();
+    size_t limit = 0;
+    for_each_shard([&](int, SkResourceCache* cache) { limit += cache->getTotalByteLimit(); });
+    return limit;
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setTotalByteLimit(newLimit);
+    size_t prevLimit = 0;
+    for_each_shard([&](int i, SkResourceCache* cache) {
+        prevLimit += cache->setTotalByteLimit(shard_byte_limit(newLimit, i));
+    });
+    return prevLimit;
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->discardableFactory();
+    Shard* shard = &get_shards()[0];
+    SkAutoMutexAcquire am(shard->fMutex);
+    return shard->fCache->discardableFactory();
 }
 
 SkBitmap::Allocator* SkResourceCache::GetAllocator() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->allocator();
+    Shard* shard = &get_shards()[0];
+    SkAutoMutexAcquire am(shard->fMutex);
+    return shard->fCache->allocator();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->newCachedData(bytes);
+    // Any shard can hand out SkCachedData, so spread the callers around.
+    uint32_t index = gNextCachedDataShard.fetch_add(1, sk_memory_order_relaxed);
+    Shard* shard = &get_shards()[index % kShardCount];
+    SkAutoMutexAcquire am(shard->fMutex);
+    return shard->fCache->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->dump();
+    for_each_shard([](int, SkResourceCache* cache) { cache->dump(); });
+}
+
+// Sums the stats of categories spread over several namespaces and shards.
+static void accumulate_stats(const SkCacheStats& stats, void* context) {
+    SkTDArray<SkCacheStats>* all = static_cast<SkTDArray<SkCacheStats>*>(context);
+    for (int i = 0; i < all->count(); ++i) {
+        SkCacheStats& sum = (*all)[i];
+        if (0 == strcmp(sum.fName, stats.fName)) {
+            sum.fHits += stats.fHits;
+            sum.fMisses += stats.fMisses;
+            sum.fEvictions += stats.fEvictions;
+            sum.fBytes += stats.fBytes;
+            sum.fEntries += stats.fEntries;
+            return;
+        }
+    }
+    *all->append() = stats;
+}
+
+void SkResourceCache::VisitStats(SkCacheStats::Visitor visitor, void* context) {
+    SkTDArray<SkCacheStats> all;
+    for_each_shard([&](int, SkResourceCache* cache) { cache->visitStats(accumulate_stats, &all); });
+    // The shard locks are released, so the visitor may use the cache.
+    for (int i = 0; i < all.count(); ++i) {
+        visitor(all[i], context);
+    }
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->setSingleAllocationByteLimit(size);
+    size_t prevLimit = 0;
+    for_each_shard([&](int i, SkResourceCache* cache) {
+        size_t prev = cache->setSingleAllocationByteLimit(size);
+        if (0 == i) {
+            prevLimit = prev;
+        }
+    });
+    return prevLimit;
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getSingleAllocationByteLimit();
+    Shard* shard = &get_shards()[0];
+    SkAutoMutexAcquire am(shard->fMutex);
+    return shard->fCache->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->getEffectiveSingleAllocationByteLimit();
+    // Any single allocation has to fit in one shard's slice of the budget.
+    Shard* shard = &get_shards()[0];
+    SkAutoMutexAcquire am(shard->fMutex);
+    return shard->fCache->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->purgeAll();
+    for_each_shard([](int, SkResourceCache* cache) { cache->purgeAll(); });
+}
+
+void SkResourceCache::PurgeToFraction(float fraction) {
+    for_each_shard([fraction](int, SkResourceCache* cache) { cache->purgeToFraction(fraction); });
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexAcquire am(gMutex);
-    return get_cache()->find(key, visitor, context);
+    Shard* shard = get_shard(key);
+    SkAutoMutexAcquire am(shard->fMutex);
+    return shard->fCache->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec) {
-    SkAutoMutexAcquire am(gMutex);
-    get_cache()->add(rec);
+    Shard* shard = get_shard(rec->getKey());
+    SkAutoMutexAcquire am(shard->fMutex);
+    shard->fCache->add(rec);
 }
 
 void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
@@ -616,13 +784,23 @@ void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "SkGlyphCache.h"
 #include "SkGraphics.h"
 #include "SkImageFilter.h"
+#include "SkTypefaceCache.h"
 
 size_t SkGraphics::GetResourceCacheTotalBytesUsed() {
     return SkResourceCache::GetTotalBytesUsed();
 }
 
+size_t SkGraphics::GetResourceCachePeakBytesUsed() {
+    return SkResourceCache::GetPeakBytesUsed();
+}
+
+void SkGraphics::ResetResourceCachePeakBytesUsed() {
+    SkResourceCache::ResetPeakBytesUsed();
+}
+
 size_t SkGraphics::GetResourceCacheTotalByteLimit() {
     return SkResourceCache::GetTotalByteLimit();
 }
@@ -639,8 +817,18 @@ size_t SkGraphics::SetResourceCacheSingleAllocationByteLimit(size_t newLimit) {
     return SkResourceCache::SetSingleAllocationByteLimit(newLimit);
 }
 
+void SkGraphics::VisitCacheStats(SkCacheStats::Visitor visitor, void* context) {
+    SkResourceCache::VisitStats(visitor, context);
+    SkGlyphCache::VisitStats(visitor, context);
+    SkTypefaceCache::VisitStats(visitor, context);
+}
+
 void SkGraphics::PurgeResourceCache() {
     SkImageFilter::PurgeCache();
     return SkResourceCache::PurgeAll();
 }
 
+void SkGraphics::PurgeResourceCacheToFraction(float fraction) {
+    SkResourceCache::PurgeToFraction(fraction);
+}
+
@@ -9,6 +9,7 @@
 #define SkResourceCache_DEFINED
 
 #include "SkBitmap.h"
+#include "SkCacheStats.h"
 #include "SkMessageBus.h"
 #include "SkTDArray.h"
 
@@ -78,7 +79,11 @@ public:
         virtual const Key& getKey() const = 0;
         virtual size_t bytesUsed() const = 0;
 
-        // for SkTDynamicHash::Traits
+        // Names the kind of entry in the stats from SkGraphics::VisitCacheStats(), e.g. "bitmap".
+        // Every Rec sharing a Key namespace must return the same static string.
+        virtual const char* getCategory() const = 0;
+
+        // for SkTGroupProbeHash::Traits
         static uint32_t Hash(const Key& key) { return key.hash(); }
         static const Key& GetKey(const Rec& rec) { return rec.getKey(); }
 
@@ -134,6 +139,12 @@ public:
     static void Add(Rec*);
 
     static size_t GetTotalBytesUsed();
+    /**
+     *  The sum of each shard's peak, so it can overstate the peak of the cache as a whole when
+     *  shards peak at different times.
+     */
+    static size_t GetPeakBytesUsed();
+    static void ResetPeakBytesUsed();
     static size_t GetTotalByteLimit();
     static size_t SetTotalByteLimit(size_t newLimit);
 
@@ -143,6 +154,12 @@ public:
 
     static void PurgeAll();
 
+    /**
+     *  Purges the least recently used entries of each shard until at most fraction (0..1) of
+     *  what it held is left. PurgeToFraction(0) is PurgeAll().
+     */
+    static void PurgeToFraction(float fraction);
+
     /**
      *  Returns the DiscardableFactory used by the global cache, or NULL.
      */
@@ -163,6 +180,11 @@ public:
      */
     static void Dump();
 
+    /**
+     *  Calls visitor with the stats of each category of Rec, summed over the whole cache.
+     */
+    static void VisitStats(SkCacheStats::Visitor visitor, void* context);
+
     ///////////////////////////////////////////////////////////////////////////
 
     /**
@@ -196,6 +218,13 @@ public:
     void add(Rec*);
 
     size_t getTotalBytesUsed() const { return fTotalBytesUsed; }
+
+    /**
+     *  Returns the most bytes used at once since the cache was made or since the last
+     *  resetPeakBytesUsed(), which starts tracking again from getTotalBytesUsed().
+     */
+    size_t getPeakBytesUsed() const { return fPeakBytesUsed; }
+    void resetPeakBytesUsed() { fPeakBytesUsed = fTotalBytesUsed; }
     size_t getTotalByteLimit() const { return fTotalByteLimit; }
 
     /**
@@ -222,6 +251,8 @@ public:
         this->purgeAsNeeded(true);
     }
 
+    void purgeToFraction(float fraction);
+
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
     SkBitmap::Allocator* allocator() const { return fAllocator; };
 
@@ -232,6 +263,12 @@ public:
      */
     void dump() const;
 
+    /**
+     *  Calls visitor with the stats of each category of Rec in this cache. A category that has
+     *  only ever missed is reported as "unknown", since no Rec has named it yet.
+     */
+    void visitStats(SkCacheStats::Visitor visitor, void* context) const;
+
 private:
     Rec*    fHead;
     Rec*    fTail;
@@ -244,10 +281,25 @@ private:
     SkBitmap::Allocator* fAllocator;
 
     size_t  fTotalBytesUsed;
+    size_t  fPeakBytesUsed;
     size_t  fTotalByteLimit;
     size_t  fSingleAllocationByteLimit;
     int     fCount;
 
+    // Hit, miss and eviction counts, and current use, for each Key namespace.
+    struct NamespaceStats {
+        void*           fNamespace;
+        const char*     fCategory;  // Set by the first Rec added to the namespace.
+        uint64_t        fHits;
+        uint64_t        fMisses;
+        uint64_t        fEvictions;
+        size_t          fBytes;
+        int             fCount;
+    };
+    SkTDArray<NamespaceStats> fNamespaceStats;
+
+    NamespaceStats* findNamespaceStats(void* nameSpace);
+
     SkMessageBus<PurgeSharedIDMessage>::Inbox fPurgeSharedIDInbox;
 
     void checkMessages();
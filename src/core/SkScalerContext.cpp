@@ -87,6 +87,7 @@ SkScalerContext::SkScalerContext(SkTypeface* typeface, const SkDescriptor* desc)
                                              SkFlattenable::kSkRasterizer_Type)))
       // Initialize based on our settings. Subclasses can also force this.
     , fGenerateImageFromPath(fRec.fFrameWidth > 0 || fPathEffect != NULL || fRasterizer != NULL)
+    , fCachedOutlines(NULL)
 
     , fPreBlend(fMaskFilter ? SkMaskGamma::PreBlend() : SkScalerContext::GetMaskPreBlend(fRec))
     , fPreBlendForFilter(fMaskFilter ? SkScalerContext::GetMaskPreBlend(fRec)
@@ -598,10 +599,30 @@ SkUnichar SkScalerContext::generateGlyphToChar(uint16_t glyph) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SkScalerContext::generateOutline(const SkGlyph& glyph, SkPath* path) {
+    if (!(fRec.fFlags & SkScalerContext::kSubpixelPositioning_Flag)) {
+        this->generatePath(glyph, path);
+        return;
+    }
+
+    if (!fCachedOutlines.get()) {
+        fCachedOutlines.reset(SkNEW_ARRAY(CachedOutline, kCachedOutlineCount));
+    }
+    const uint16_t glyphID = glyph.getGlyphID();
+    CachedOutline& outline = fCachedOutlines.get()[glyphID & (kCachedOutlineCount - 1)];
+    if (!outline.fValid || outline.fGlyphID != glyphID) {
+        outline.fPath.reset();
+        this->generatePath(glyph, &outline.fPath);
+        outline.fGlyphID = glyphID;
+        outline.fValid = true;
+    }
+    *path = outline.fPath;
+}
+
 void SkScalerContext::internalGetPath(const SkGlyph& glyph, SkPath* fillPath,
                                   SkPath* devPath, SkMatrix* fillToDevMatrix) {
     SkPath  path;
-    generatePath(glyph, &path);
+    this->generateOutline(glyph, &path);
 
     if (fRec.fFlags & SkScalerContext::kSubpixelPositioning_Flag) {
         SkFixed dx = glyph.getSubXFixed();
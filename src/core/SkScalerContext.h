@@ -12,6 +12,8 @@
 #include "SkMaskGamma.h"
 #include "SkMatrix.h"
 #include "SkPaint.h"
+#include "SkPath.h"
+#include "SkTemplates.h"
 #include "SkTypeface.h"
 
 class SkGlyph;
@@ -318,6 +320,22 @@ private:
     void internalGetPath(const SkGlyph& glyph, SkPath* fillPath,
                          SkPath* devPath, SkMatrix* fillToDevMatrix);
 
+    // Calls generatePath, except that with subpixel positioning the outline is kept in a small
+    // direct mapped cache by glyph id: every subpixel variant of a glyph has the same outline
+    // before its offset is applied, and each needs it for both its metrics and its image when
+    // drawing from paths.
+    void generateOutline(const SkGlyph& glyph, SkPath* path);
+
+    struct CachedOutline {
+        CachedOutline() : fGlyphID(0), fValid(false) {}
+
+        uint16_t fGlyphID;
+        bool     fValid;
+        SkPath   fPath;
+    };
+    static const int kCachedOutlineCount = 64;
+    SkAutoTDeleteArray<CachedOutline> fCachedOutlines;
+
     // returns the right context from our link-list for this char. If no match
     // is found it returns NULL. If a match is found then the glyphID param is
     // set to the glyphID that maps to the provided char.
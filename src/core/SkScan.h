@@ -22,6 +22,12 @@ class SkPath;
 */
 typedef SkIRect SkXRect;
 
+/** When set, AntiFillPath() computes exact coverage analytically instead of supersampling,
+    where the path and clip allow it. Off by default; tools such as nanobench's --analyticAA set
+    it to compare the two scan converters.
+*/
+extern bool gSkUseAnalyticAA;
+
 class SkScan {
 public:
     /*
@@ -45,6 +51,9 @@ public:
     static void AntiFillXRect(const SkXRect&, const SkRasterClip&, SkBlitter*);
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    /** Like AntiFillPath(), but always uses the analytic coverage scan converter where the path
+        and clip allow it, regardless of gSkUseAnalyticAA. */
+    static void AAAFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -68,7 +77,7 @@ private:
     static void AntiFillXRect(const SkXRect&, const SkRegion*, SkBlitter*);
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
-                             bool forceRLE = false);
+                             bool forceRLE = false, bool analytic = false);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -33,6 +33,10 @@ void sk_fill_path(const SkPath& path, const SkIRect* clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   const SkRegion& clipRgn);
 
+// Fills a non-inverse path with analytic coverage (see SkScan_AAAPath.cpp). clipRect must be no
+// wider than the 32767 pixels an SkAlphaRuns-style run can span.
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitter);
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
@@ -0,0 +1,377 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkScanPriv.h"
+#include "SkGeometry.h"
+#include "SkPath.h"
+#include "SkRasterClip.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+/** @file
+    Analytic anti-aliasing: rather than supersampling each scanline SCALE times (see
+    SkScan_AntiPath.cpp), the path is flattened to lines and each line adds the exact signed
+    area it sweeps to the pixels of every scanline it crosses. A running sum across the row then
+    gives each pixel's coverage, so one pass per scanline yields 256 coverage levels.
+
+    The accumulated area is exact for paths whose contours don't overlap. Where they do, the
+    sum is the winding number weighted by area, which is clamped (winding) or folded (even-odd)
+    into [0, 1], so only pixels that straddle an overlap's edges are approximate.
+ */
+
+bool gSkUseAnalyticAA = false;
+
+// Maximum distance, in pixels, between a flattened curve and the true curve.
+static const SkScalar kFlattenTolerance = 0.25f;
+static const int kMaxCurveLines = 64;
+
+namespace {
+
+struct Line {
+    SkScalar fX0, fY0;  // top
+    SkScalar fX1, fY1;  // bottom
+    SkScalar fDXDY;
+    float    fWinding;
+
+    bool operator<(const Line& other) const { return fY0 < other.fY0; }
+};
+
+// Collects the path's lines, clipped to the clip rect. Lines are cut vertically at the clip,
+// and the parts left of it are moved onto its left edge, since they still change the winding
+// of everything to their right. Parts right of the clip can't affect it and are dropped.
+class LineBuilder {
+public:
+    LineBuilder(const SkIRect& clip) : fClip(SkRect::Make(clip)) {}
+
+    SkTDArray<Line>& lines() { return fLines; }
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        if (p0.fY == p1.fY) {
+            return;
+        }
+        float winding = 1;
+        SkPoint top = p0, bot = p1;
+        if (top.fY > bot.fY) {
+            SkTSwap(top, bot);
+            winding = -1;
+        }
+        if (bot.fY <= fClip.fTop || top.fY >= fClip.fBottom) {
+            return;
+        }
+        const SkScalar dxdy = (bot.fX - top.fX) / (bot.fY - top.fY);
+        if (top.fY < fClip.fTop) {
+            top.set(top.fX + (fClip.fTop - top.fY) * dxdy, fClip.fTop);
+        }
+        if (bot.fY > fClip.fBottom) {
+            bot.set(bot.fX - (bot.fY - fClip.fBottom) * dxdy, fClip.fBottom);
+        }
+
+        // Split where the line crosses the clip's left and right edges.
+        SkScalar splitY[4];
+        int count = 0;
+        splitY[count++] = top.fY;
+        if (dxdy != 0) {
+            const SkScalar edges[2] = { fClip.fLeft, fClip.fRight };
+            for (int i = 0; i < 2; ++i) {
+                SkScalar y = top.fY + (edges[i] - top.fX) / dxdy;
+                if (y > top.fY && y < bot.fY) {
+                    splitY[count++] = y;
+                }
+            }
+            if (3 == count && splitY[2] < splitY[1]) {
+                SkTSwap(splitY[1], splitY[2]);
+            }
+        }
+        splitY[count] = bot.fY;
+
+        for (int i = 0; i < count; ++i) {
+            SkScalar y0 = splitY[i], y1 = splitY[i + 1];
+            SkScalar x0 = top.fX + (y0 - top.fY) * dxdy;
+            SkScalar x1 = top.fX + (y1 - top.fY) * dxdy;
+            SkScalar midX = SkScalarHalf(x0 + x1);
+            if (midX > fClip.fRight) {
+                continue;
+            }
+            x0 = SkTPin(x0, fClip.fLeft, fClip.fRight);
+            x1 = SkTPin(x1, fClip.fLeft, fClip.fRight);
+            this->appendLine(x0, y0, x1, y1, winding);
+        }
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        SkVector dev = pts[0] - pts[1] - pts[1] + pts[2];
+        this->addCurve(pts, SkScalarHalf(dev.length()), false);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        SkVector dev0 = pts[0] - pts[1] - pts[1] + pts[2];
+        SkVector dev1 = pts[1] - pts[2] - pts[2] + pts[3];
+        this->addCurve(pts, SkMaxScalar(dev0.length(), dev1.length()) * 0.75f, true);
+    }
+
+private:
+    // 'deviation' bounds how far the curve strays from its chord; splitting it into n lines
+    // shrinks that by n^2.
+    void addCurve(const SkPoint pts[], SkScalar deviation, bool isCubic) {
+        int n = SkScalarCeilToInt(SkScalarSqrt(deviation / kFlattenTolerance));
+        n = SkTPin(n, 1, kMaxCurveLines);
+        SkPoint prev = pts[0];
+        for (int i = 1; i <= n; ++i) {
+            SkPoint next;
+            if (i == n) {
+                next = pts[isCubic ? 3 : 2];
+            } else if (isCubic) {
+                SkEvalCubicAt(pts, SkIntToScalar(i) / n, &next, NULL, NULL);
+            } else {
+                next = SkEvalQuadAt(pts, SkIntToScalar(i) / n);
+            }
+            this->addLine(prev, next);
+            prev = next;
+        }
+    }
+
+    void appendLine(SkScalar x0, SkScalar y0, SkScalar x1, SkScalar y1, float winding) {
+        if (y0 >= y1) {
+            return;
+        }
+        Line* line = fLines.append();
+        line->fX0 = x0;
+        line->fY0 = y0;
+        line->fX1 = x1;
+        line->fY1 = y1;
+        line->fDXDY = (x1 - x0) / (y1 - y0);
+        line->fWinding = winding;
+    }
+
+    const SkRect    fClip;
+    SkTDArray<Line> fLines;
+};
+
+// Accumulates one scanline. fArea[i] holds the change in coverage between pixel i - 1 and
+// pixel i, so coverage is the running sum. fLo and fHi bound the cells touched so far.
+class RowAccumulator {
+public:
+    RowAccumulator(int width) : fWidth(width), fArea(width + 2), fLo(width + 2), fHi(-1) {
+        sk_bzero(fArea.get(), (width + 2) * sizeof(float));
+    }
+
+    // Adds the area to the right of the line from (x0, y0) to (x1, y1), x relative to the row's
+    // left, with y0 and y1 inside the current row.
+    void accumulate(float x0, float x1, float dy) {
+        if (x0 > x1) {
+            SkTSwap(x0, x1);
+        }
+        float* a = fArea.get();
+        int x0i = (int)x0;
+        int x1i = (int)ceilf(x1);
+        if (x1i <= x0i + 1) {
+            // Within one pixel: split by the line's average distance from the pixel's left.
+            float xmf = 0.5f * (x0 + x1) - x0i;
+            a[x0i] += dy - dy * xmf;
+            a[x0i + 1] += dy * xmf;
+        } else {
+            float s = 1 / (x1 - x0);
+            float x0f = x0 - x0i;
+            float a0 = 0.5f * s * (1 - x0f) * (1 - x0f);
+            float x1f = x1 - x1i + 1;
+            float am = 0.5f * s * x1f * x1f;
+            a[x0i] += dy * a0;
+            if (x1i == x0i + 2) {
+                a[x0i + 1] += dy * (1 - a0 - am);
+            } else {
+                float a1 = s * (1.5f - x0f);
+                a[x0i + 1] += dy * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; ++xi) {
+                    a[xi] += dy * s;
+                }
+                float a2 = a1 + (x1i - x0i - 3) * s;
+                a[x1i - 1] += dy * (1 - a2 - am);
+            }
+            a[x1i] += dy * am;
+        }
+        fLo = SkTMin(fLo, x0i);
+        fHi = SkTMax(fHi, SkTMax(x1i, x0i + 1));
+    }
+
+    // Converts the touched cells to alpha runs and blits them, then clears them for the next row.
+    void blit(SkBlitter* blitter, int left, int y, bool evenOdd,
+              SkAlpha* alpha, int16_t* runs) {
+        if (fHi < fLo) {
+            return;
+        }
+        float* a = fArea.get();
+        const int last = SkTMin(fHi, fWidth - 1);
+        float sum = 0;
+        int first = -1;
+        int runStart = 0;
+        for (int x = fLo; x <= last; ++x) {
+            sum += a[x];
+            SkAlpha value = to_alpha(sum, evenOdd);
+            if (first < 0) {
+                if (0 == value) {
+                    continue;
+                }
+                first = runStart = x;
+                alpha[x] = value;
+            } else if (value != alpha[runStart]) {
+                runs[runStart] = SkToS16(x - runStart);
+                runStart = x;
+                alpha[x] = value;
+            }
+        }
+
+        // Past the last touched cell the coverage stays constant up to the clip's right edge,
+        // e.g. when the path's right side lies beyond the clip.
+        int end = last + 1;
+        SkAlpha tail = to_alpha(sum, evenOdd);
+        if (tail && end < fWidth) {
+            if (first < 0) {
+                first = runStart = end;
+                alpha[end] = tail;
+            } else if (tail != alpha[runStart]) {
+                runs[runStart] = SkToS16(end - runStart);
+                runStart = end;
+                alpha[end] = tail;
+            }
+            end = fWidth;
+        }
+
+        if (first >= 0) {
+            runs[runStart] = SkToS16(end - runStart);
+            runs[end] = 0;
+            blitter->blitAntiH(left + first, y, alpha + first, runs + first);
+        }
+
+        memset(&a[fLo], 0, (fHi - fLo + 1) * sizeof(float));
+        fLo = fWidth + 2;
+        fHi = -1;
+    }
+
+private:
+    static SkAlpha to_alpha(float sum, bool evenOdd) {
+        float coverage = fabsf(sum);
+        if (evenOdd) {
+            coverage -= 2 * floorf(coverage * 0.5f);
+            if (coverage > 1) {
+                coverage = 2 - coverage;
+            }
+        } else if (coverage > 1) {
+            coverage = 1;
+        }
+        return SkToU8((int)(coverage * 255 + 0.5f));
+    }
+
+    int                  fWidth;
+    SkAutoTMalloc<float> fArea;
+    int                  fLo, fHi;
+};
+
+}  // namespace
+
+void sk_analytic_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitter) {
+    SkASSERT(!path.isInverseFillType());
+    SkASSERT(!clipRect.isEmpty());
+
+    LineBuilder builder(clipRect);
+    SkPath::Iter iter(path, true);
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts, false)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kLine_Verb:
+                builder.addLine(pts[0], pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                builder.addQuad(pts);
+                break;
+            case SkPath::kConic_Verb: {
+                SkAutoConicToQuads quadder;
+                const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(),
+                                                              kFlattenTolerance);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    builder.addQuad(quadPts + 2 * i);
+                }
+                break;
+            }
+            case SkPath::kCubic_Verb:
+                builder.addCubic(pts);
+                break;
+            default:
+                break;
+        }
+    }
+
+    SkTDArray<Line>& lines = builder.lines();
+    if (lines.isEmpty()) {
+        return;
+    }
+    SkTQSort(lines.begin(), lines.end() - 1);
+
+    const int width = clipRect.width();
+    const bool evenOdd = SkPath::kEvenOdd_FillType == path.getFillType();
+    const SkScalar left = SkIntToScalar(clipRect.fLeft);
+    RowAccumulator row(width);
+    SkAutoTMalloc<SkAlpha> alpha(width + 1);
+    SkAutoTMalloc<int16_t> runs(width + 1);
+    SkTDArray<const Line*> active;
+
+    int next = 0;
+    int y = SkTMax(clipRect.fTop, SkScalarFloorToInt(lines[0].fY0));
+    for (; y < clipRect.fBottom; ++y) {
+        const SkScalar rowTop = SkIntToScalar(y);
+        const SkScalar rowBot = rowTop + 1;
+        while (next < lines.count() && lines[next].fY0 < rowBot) {
+            *active.append() = &lines[next++];
+        }
+        if (active.isEmpty()) {
+            if (next >= lines.count()) {
+                break;
+            }
+            // Jump over rows no line touches.
+            y = SkScalarFloorToInt(lines[next].fY0) - 1;
+            continue;
+        }
+
+        for (int i = 0; i < active.count(); ) {
+            const Line* line = active[i];
+            SkScalar y0 = SkTMax(line->fY0, rowTop);
+            SkScalar y1 = SkTMin(line->fY1, rowBot);
+            if (y1 > y0) {
+                SkScalar x0 = line->fX0 + (y0 - line->fY0) * line->fDXDY - left;
+                SkScalar x1 = line->fX0 + (y1 - line->fY0) * line->fDXDY - left;
+                row.accumulate(SkTPin<float>(x0, 0, (float)width),
+                               SkTPin<float>(x1, 0, (float)width),
+                               (y1 - y0) * line->fWinding);
+            }
+            if (line->fY1 <= rowBot) {
+                active.removeShuffle(i);
+            } else {
+                ++i;
+            }
+        }
+
+        row.blit(blitter, clipRect.fLeft, y, evenOdd, alpha.get(), runs.get());
+    }
+}
+
+void SkScan::AAAFillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* blitter) {
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    if (clip.isBW()) {
+        AntiFillPath(path, clip.bwRgn(), blitter, false, true);
+    } else {
+        SkRegion        tmp;
+        SkAAClipBlitter aaBlitter;
+
+        tmp.setRect(clip.getBounds());
+        aaBlitter.init(blitter, &clip.aaRgn());
+        AntiFillPath(path, tmp, &aaBlitter, true, true);
+    }
+}
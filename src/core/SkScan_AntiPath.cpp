@@ -11,8 +11,11 @@
 #include "SkPath.h"
 #include "SkMatrix.h"
 #include "SkBlitter.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkAntiRun.h"
+#include "SkTaskGroup.h"
+#include "SkTemplates.h"
 
 #define SHIFT   2
 #define SCALE   (1 << SHIFT)
@@ -143,9 +146,20 @@ private:
             reinterpret_cast<uint8_t*>(fRunsBuffer) + fCurrentRun * kRunsSz);
         fRuns.fAlpha = reinterpret_cast<SkAlpha*>(fRuns.fRuns + fWidth + 1);
         fRuns.reset(fWidth);
+        this->resetRowExtent();
+    }
+
+    void resetRowExtent() {
+        fRowMinX = fWidth;
+        fRowMaxX = -1;
     }
 
     int         fOffsetX;
+    // The range of pixels, relative to fLeft, that the current row has touched. flush() only
+    // passes these on, so a thin slanted path across a wide device doesn't make the real
+    // blitter (and any clip blitter in front of it) walk empty runs the width of the bounds.
+    int         fRowMinX;
+    int         fRowMaxX;
 };
 
 SuperBlitter::SuperBlitter(SkBlitter* realBlitter, const SkIRect& ir, const SkRegion& clip,
@@ -167,7 +181,12 @@ void SuperBlitter::flush() {
         SkASSERT(fCurrentRun < fRunsToBuffer);
         if (!fRuns.empty()) {
             // SkDEBUGCODE(fRuns.dump();)
-            fRealBlitter->blitAntiH(fLeft, fCurrIY, fRuns.fAlpha, fRuns.fRuns);
+            SkASSERT(fRowMinX <= fRowMaxX && fRowMaxX < fWidth);
+            // add() breaks the runs at the edges of everything it touches, so both ends of the
+            // row's extent already start runs; cut off the empty one to the right.
+            fRuns.fRuns[fRowMaxX + 1] = 0;
+            fRealBlitter->blitAntiH(fLeft + fRowMinX, fCurrIY, fRuns.fAlpha + fRowMinX,
+                                    fRuns.fRuns + fRowMinX);
             this->advanceRuns();
             fOffsetX = 0;
         }
@@ -249,6 +268,8 @@ void SuperBlitter::blitH(int x, int y, int width) {
                          n, coverage_to_partial_alpha(fe),
                          (1 << (8 - SHIFT)) - (((y & MASK) + 1) >> SHIFT),
                          fOffsetX);
+    fRowMinX = SkTMin(fRowMinX, start >> SHIFT);
+    fRowMaxX = SkTMax(fRowMaxX, (stop - 1) >> SHIFT);
 
 #ifdef SK_DEBUG
     fRuns.assertValid(y & MASK, (1 << (8 - SHIFT)));
@@ -380,6 +401,7 @@ void SuperBlitter::blitRect(int x, int y, int width, int height) {
         fOffsetX = 0;
         fCurrY = y - 1;
         fRuns.reset(fWidth);
+        this->resetRowExtent();
         x = origX;
     }
 
@@ -623,8 +645,122 @@ static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
     return false;
 }
 
+// Huge AA fills are scan converted in bands of kBandHeight rows on the task threads. Arbitrary
+// blitters aren't safe to share between threads, so each band writes its coverage into disjoint
+// rows of an A8 buffer, and the buffer is then handed to the real blitter as one mask. At most
+// kMaxBands bands are buffered at a time, which bounds the buffer to 8MB even for the widest
+// paths we supersample. The band layout depends only on the path's bounds, so output doesn't
+// vary with the number of cores; edge rounding where a band's clip cuts the path can differ
+// slightly from a single pass, as in any tiled draw.
+static const int kBandHeight = 64;
+static const int kMaxBands = 16;
+// Below this many pixels the extra pass over the coverage buffer isn't worth it.
+static const int kMinBandedArea = 1024 * 1024;
+
+namespace {
+// Writes coverage into rows [fBounds.fTop, fBounds.fBottom) of a shared A8 buffer. Each pixel
+// is written at most once by the supersamplers, so this just stores the alpha.
+class BandCoverageBlitter : public SkBlitter {
+public:
+    BandCoverageBlitter(uint8_t* rows, size_t rowBytes, const SkIRect& bounds)
+        : fRows(rows), fRowBytes(rowBytes), fBounds(bounds) {}
+
+    void blitH(int x, int y, int width) override {
+        memset(this->addr(x, y), 0xFF, width);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        uint8_t* dst = this->addr(x, y);
+        for (;;) {
+            int count = runs[0];
+            if (count <= 0) {
+                return;
+            }
+            memset(dst, antialias[0], count);
+            dst += count;
+            runs += count;
+            antialias += count;
+        }
+    }
+
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        uint8_t* dst = this->addr(x, y);
+        while (--height >= 0) {
+            *dst = alpha;
+            dst += fRowBytes;
+        }
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        uint8_t* dst = this->addr(x, y);
+        while (--height >= 0) {
+            memset(dst, 0xFF, width);
+            dst += fRowBytes;
+        }
+    }
+
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        if (SkMask::kA8_Format != mask.fFormat) {
+            this->INHERITED::blitMask(mask, clip);
+            return;
+        }
+        for (int y = clip.fTop; y < clip.fBottom; ++y) {
+            memcpy(this->addr(clip.fLeft, y), mask.getAddr8(clip.fLeft, y), clip.width());
+        }
+    }
+
+private:
+    uint8_t* addr(int x, int y) const {
+        SkASSERT(fBounds.contains(x, y));
+        return fRows + (y - fBounds.fTop) * fRowBytes + (x - fBounds.fLeft);
+    }
+
+    uint8_t*      fRows;
+    const size_t  fRowBytes;
+    const SkIRect fBounds;
+
+    typedef SkBlitter INHERITED;
+};
+}
+
+static bool should_fill_in_bands(const SkIRect& clippedIR) {
+    return clippedIR.height() > kBandHeight &&
+           (int64_t)clippedIR.width() * clippedIR.height() >= kMinBandedArea;
+}
+
+static void anti_fill_path_in_bands(const SkPath& path, const SkIRect& clippedIR,
+                                    SkBlitter* blitter) {
+    const int width = clippedIR.width();
+    const int chunkHeight = kBandHeight * kMaxBands;
+    SkAutoTMalloc<uint8_t> coverage(width * SkTMin(chunkHeight, clippedIR.height()));
+
+    for (int chunkTop = clippedIR.fTop; chunkTop < clippedIR.fBottom; chunkTop += chunkHeight) {
+        const int chunkBottom = SkTMin(chunkTop + chunkHeight, clippedIR.fBottom);
+        const int bandCount = (chunkBottom - chunkTop + kBandHeight - 1) / kBandHeight;
+        sk_bzero(coverage.get(), width * (chunkBottom - chunkTop));
+
+        sk_parallel_for(bandCount, [&](int i) {
+            SkIRect band = SkIRect::MakeLTRB(clippedIR.fLeft, chunkTop + i * kBandHeight,
+                                             clippedIR.fRight,
+                                             SkTMin(chunkTop + (i + 1) * kBandHeight,
+                                                    chunkBottom));
+            BandCoverageBlitter bandBlitter(coverage.get() + (band.fTop - chunkTop) * width,
+                                            width, band);
+            // A band is never tall enough to be split again.
+            SkScan::AntiFillPath(path, SkRasterClip(band), &bandBlitter);
+        });
+
+        SkMask mask;
+        mask.fImage = coverage.get();
+        mask.fBounds.set(clippedIR.fLeft, chunkTop, clippedIR.fRight, chunkBottom);
+        mask.fRowBytes = width;
+        mask.fFormat = SkMask::kA8_Format;
+        blitter->blitMask(mask, mask.fBounds);
+    }
+}
+
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
-                          SkBlitter* blitter, bool forceRLE) {
+                          SkBlitter* blitter, bool forceRLE, bool analytic) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -664,6 +800,16 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         return;
     }
 
+    if ((analytic || gSkUseAnalyticAA) && !isInverse && origClip.isRect()) {
+        sk_analytic_fill_path(path, clippedIR, blitter);
+        return;
+    }
+
+    if (!isInverse && origClip.isRect() && should_fill_in_bands(clippedIR)) {
+        anti_fill_path_in_bands(path, clippedIR, blitter);
+        return;
+    }
+
     // Our antialiasing can't handle a clip larger than 32767, so we restrict
     // the clip to that limit here. (the runs[] uses int16_t for its index).
     //
@@ -728,8 +874,6 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#include "SkRasterClip.h"
-
 void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip,
                           SkBlitter* blitter) {
     if (clip.isEmpty()) {
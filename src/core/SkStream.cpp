@@ -11,6 +11,7 @@
 #include "SkStreamPriv.h"
 #include "SkData.h"
 #include "SkFixed.h"
+#include "SkRWBuffer.h"
 #include "SkString.h"
 #include "SkOSFile.h"
 #include "SkTypes.h"
@@ -822,6 +823,118 @@ SkStreamAsset* SkDynamicMemoryWStream::detachAsStream() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// The tail is at least a page, so that small writes don't each make a segment.
+static const size_t kMinSegmentTailSize = 4096;
+
+SkSegmentedWStream::SkSegmentedWStream()
+    : fTail(NULL)
+    , fTailStart(0)
+    , fTailUsed(0)
+    , fBytesWritten(0) {}
+
+SkSegmentedWStream::~SkSegmentedWStream() {
+    this->reset();
+}
+
+void SkSegmentedWStream::reset() {
+    fSegments.unrefAll();
+    SkSafeSetNull(fTail);
+    fTailStart = fTailUsed = 0;
+    fBytesWritten = 0;
+}
+
+bool SkSegmentedWStream::write(const void* buffer, size_t size) {
+    if (0 == size) {
+        return true;
+    }
+    fBytesWritten += size;
+    if (fTail && fTail->size() - fTailUsed >= size) {
+        memcpy((char*)fTail->writable_data() + fTailUsed, buffer, size);
+        fTailUsed += size;
+        return true;
+    }
+    // What's in the tail so far becomes a segment, and the rest of it is left unused.
+    this->sealTail();
+    SkSafeUnref(fTail);
+    fTail = SkData::NewUninitialized(SkTMax(size, kMinSegmentTailSize));
+    memcpy(fTail->writable_data(), buffer, size);
+    fTailStart = 0;
+    fTailUsed = size;
+    return true;
+}
+
+void SkSegmentedWStream::writeData(const SkData* data) {
+    if (0 == data->size()) {
+        return;
+    }
+    this->sealTail();
+    *fSegments.append() = SkRef(data);
+    fBytesWritten += data->size();
+}
+
+void SkSegmentedWStream::sealTail() {
+    if (fTailUsed == fTailStart) {
+        return;
+    }
+    // The segment only covers the bytes written so far, so the tail can still be written past it.
+    *fSegments.append() = fTailStart == 0 && fTailUsed == fTail->size() ? SkRef(fTail)
+                        : SkData::NewSubset(fTail, fTailStart, fTailUsed - fTailStart);
+    fTailStart = fTailUsed;
+}
+
+int SkSegmentedWStream::countSegments() const {
+    return fSegments.count() + (fTailUsed > fTailStart ? 1 : 0);
+}
+
+void SkSegmentedWStream::getSegments(Segment segments[]) const {
+    for (int i = 0; i < fSegments.count(); ++i) {
+        segments[i].fBase = fSegments[i]->data();
+        segments[i].fLength = fSegments[i]->size();
+    }
+    if (fTailUsed > fTailStart) {
+        segments[fSegments.count()].fBase = fTail->bytes() + fTailStart;
+        segments[fSegments.count()].fLength = fTailUsed - fTailStart;
+    }
+}
+
+SkData* SkSegmentedWStream::copyToData() const {
+    if (fTailUsed == fTailStart) {
+        if (0 == fSegments.count()) {
+            return SkData::NewEmpty();
+        }
+        if (1 == fSegments.count()) {
+            return SkRef(const_cast<SkData*>(fSegments[0]));
+        }
+    } else if (0 == fSegments.count()) {
+        return SkData::NewSubset(fTail, fTailStart, fTailUsed - fTailStart);
+    }
+    SkData* data = SkData::NewUninitialized(fBytesWritten);
+    char* dst = (char*)data->writable_data();
+    for (int i = 0; i < fSegments.count(); ++i) {
+        memcpy(dst, fSegments[i]->data(), fSegments[i]->size());
+        dst += fSegments[i]->size();
+    }
+    if (fTailUsed > fTailStart) {
+        memcpy(dst, fTail->bytes() + fTailStart, fTailUsed - fTailStart);
+    }
+    return data;
+}
+
+SkStreamAsset* SkSegmentedWStream::detachAsStream() {
+    if (0 == fBytesWritten) {
+        return SkNEW(SkMemoryStream);
+    }
+    this->sealTail();
+    SkRWBuffer buffer;
+    for (int i = 0; i < fSegments.count(); ++i) {
+        buffer.append(fSegments[i]);
+    }
+    this->reset();
+    return buffer.newStreamSnapshot();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 void SkDebugWStream::newline()
 {
 #if defined(SK_DEBUG) || defined(SK_DEVELOPER)
@@ -9,6 +9,8 @@
 
 #include "SkAtomics.h"
 #include "SkFixed.h"
+#include "SkFloatBits.h"
+#include "SkFloatToDecimal.h"
 #include "SkString.h"
 #include "SkUtils.h"
 #include <stdarg.h>
@@ -134,14 +136,67 @@ char* SkStrAppendS64(char string[], int64_t dec, int minDigits) {
 }
 
 char* SkStrAppendFloat(char string[], float value) {
-    // since floats have at most 8 significant digits, we limit our %g to that.
-    static const char gFormat[] = "%.8g";
-    // make it 1 larger for the terminating 0
-    char buffer[SkStrAppendScalar_MaxSize + 1];
-    int len = SNPRINTF(buffer, sizeof(buffer), gFormat, value);
-    memcpy(string, buffer, len);
-    SkASSERT(len <= SkStrAppendScalar_MaxSize);
-    return string + len;
+    // Write the shortest digits that read back as value, laid out as printf's "%.8g" would.
+    SkDEBUGCODE(char* start = string;)
+    if (SkScalarIsNaN(value)) {
+        memcpy(string, "nan", 3);
+        return string + 3;
+    }
+    if (SkFloat2Bits(value) < 0) {
+        *string++ = '-';
+        value = -value;
+    }
+    if (0 == value) {
+        *string++ = '0';
+        return string;
+    }
+    if (!SkScalarIsFinite(value)) {
+        memcpy(string, "inf", 3);
+        return string + 3;
+    }
+
+    int exponent;
+    char digits[SkStrAppendU32_MaxSize];
+    int count = SkToInt(SkStrAppendU32(digits, SkFloatToDecimal(value, &exponent)) - digits);
+    // value == d.ddd * 10^sciExponent
+    int sciExponent = exponent + count - 1;
+
+    if (sciExponent < -4 || sciExponent >= 8) {
+        *string++ = digits[0];
+        if (count > 1) {
+            *string++ = '.';
+            memcpy(string, digits + 1, count - 1);
+            string += count - 1;
+        }
+        *string++ = 'e';
+        *string++ = sciExponent < 0 ? '-' : '+';
+        sciExponent = SkAbs32(sciExponent);
+        *string++ = '0' + sciExponent / 10;
+        *string++ = '0' + sciExponent % 10;
+    } else if (sciExponent < 0) {
+        *string++ = '0';
+        *string++ = '.';
+        for (int i = sciExponent + 1; i < 0; ++i) {
+            *string++ = '0';
+        }
+        memcpy(string, digits, count);
+        string += count;
+    } else if (count <= sciExponent + 1) {
+        memcpy(string, digits, count);
+        string += count;
+        for (int i = count; i <= sciExponent; ++i) {
+            *string++ = '0';
+        }
+    } else {
+        memcpy(string, digits, sciExponent + 1);
+        string += sciExponent + 1;
+        *string++ = '.';
+        memcpy(string, digits + sciExponent + 1, count - sciExponent - 1);
+        string += count - sciExponent - 1;
+    }
+
+    SkASSERT(string - start <= SkStrAppendScalar_MaxSize);
+    return string;
 }
 
 char* SkStrAppendFixed(char string[], SkFixed x) {
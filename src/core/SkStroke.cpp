@@ -6,8 +6,11 @@
  */
 
 #include "SkStrokerPriv.h"
+#include "SkAtomics.h"
 #include "SkGeometry.h"
 #include "SkPathPriv.h"
+#include "SkTArray.h"
+#include "SkTaskGroup.h"
 
 enum {
     kTangent_RecursiveLimit,
@@ -28,6 +31,15 @@ SK_COMPILE_ASSERT(SK_ARRAY_COUNT(kRecursiveLimits) == kQuad_RecursiveLimit + 1,
 
 #ifdef SK_DEBUG
     int gMaxRecursion[SK_ARRAY_COUNT(kRecursiveLimits)] = { 0 };
+
+    // Long paths are stroked on several threads, so the high-water mark is raised atomically.
+    static void update_max_recursion(int index, int depth) {
+        int prev = sk_atomic_load(&gMaxRecursion[index], sk_memory_order_relaxed);
+        while (prev < depth && !sk_atomic_compare_exchange(&gMaxRecursion[index], &prev, depth,
+                                                           sk_memory_order_relaxed,
+                                                           sk_memory_order_relaxed)) {
+        }
+    }
 #endif
 #ifndef DEBUG_QUAD_STROKER
     #define DEBUG_QUAD_STROKER 0
@@ -414,6 +426,8 @@ void SkPathStroker::init(StrokeType strokeType, SkQuadConstruct* quadPts, SkScal
         SkScalar tEnd) {
     fStrokeType = strokeType;
     fFoundTangents = false;
+    // an aborted or degenerate subdivision returns without unwinding the depth
+    fRecursionDepth = 0;
     quadPts->init(tStart, tEnd);
 }
 
@@ -1066,8 +1080,7 @@ bool SkPathStroker::cubicStroke(const SkPoint cubic[4], SkQuadConstruct* quadPts
     if (!SkScalarIsFinite(quadPts->fQuad[2].fX) || !SkScalarIsFinite(quadPts->fQuad[2].fY)) {
         return false;  // just abort if projected quad isn't representable
     }
-    SkDEBUGCODE(gMaxRecursion[fFoundTangents] = SkTMax(gMaxRecursion[fFoundTangents],
-            fRecursionDepth + 1));
+    SkDEBUGCODE(update_max_recursion(fFoundTangents, fRecursionDepth + 1));
     if (++fRecursionDepth > kRecursiveLimits[fFoundTangents]) {
         return false;  // just abort if projected quad isn't representable
     }
@@ -1102,8 +1115,7 @@ bool SkPathStroker::conicStroke(const SkConic& conic, SkQuadConstruct* quadPts)
         addDegenerateLine(quadPts);
         return true;
     }
-    SkDEBUGCODE(gMaxRecursion[kConic_RecursiveLimit] = SkTMax(gMaxRecursion[kConic_RecursiveLimit],
-            fRecursionDepth + 1));
+    SkDEBUGCODE(update_max_recursion(kConic_RecursiveLimit, fRecursionDepth + 1));
     if (++fRecursionDepth > kRecursiveLimits[kConic_RecursiveLimit]) {
         return false;  // just abort if projected quad isn't representable
     }
@@ -1132,8 +1144,7 @@ bool SkPathStroker::quadStroke(const SkPoint quad[3], SkQuadConstruct* quadPts)
         addDegenerateLine(quadPts);
         return true;
     }
-    SkDEBUGCODE(gMaxRecursion[kQuad_RecursiveLimit] = SkTMax(gMaxRecursion[kQuad_RecursiveLimit],
-            fRecursionDepth + 1));
+    SkDEBUGCODE(update_max_recursion(kQuad_RecursiveLimit, fRecursionDepth + 1));
     if (++fRecursionDepth > kRecursiveLimits[kQuad_RecursiveLimit]) {
         return false;  // just abort if projected quad isn't representable
     }
@@ -1279,34 +1290,55 @@ private:
     bool            fSwapWithSrc;
 };
 
-void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
-    SkASSERT(dst);
-
-    SkScalar radius = SkScalarHalf(fWidth);
-
-    AutoTmpPath tmp(src, &dst);
-
-    if (radius <= 0) {
-        return;
-    }
-
-    // If src is really a rect, call our specialty strokeRect() method
-    {
-        SkRect rect;
-        bool isClosed;
-        SkPath::Direction dir;
-        if (src.isRect(&rect, &isClosed, &dir) && isClosed) {
-            this->strokeRect(rect, dst, dir);
-            // our answer should preserve the inverseness of the src
-            if (src.isInverseFillType()) {
-                SkASSERT(!dst->isInverseFillType());
-                dst->toggleInverseFillType();
-            }
-            return;
+// Paths with at least this many points are stroked in parallel, a run of whole contours at a
+// time, each run ending once it has kParallelStrokeChunkPoints points. Each contour's stroke only
+// depends on that contour, so appending the runs' strokes gives the same path as stroking them
+// all at once. A single long contour isn't split: its joins would change.
+static const int kMinParallelStrokePoints = 4096;
+static const int kParallelStrokeChunkPoints = 1024;
+
+// Copies src's verbs into paths that each start with a moveTo and hold whole contours.
+static void split_contours(const SkPath& src, SkTArray<SkPath>* chunks) {
+    SkPath::RawIter iter(src);
+    SkPath* chunk = NULL;
+    SkPoint pts[4];
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                if (NULL == chunk || chunk->countPoints() >= kParallelStrokeChunkPoints) {
+                    chunk = &chunks->push_back();
+                }
+                chunk->moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                chunk->lineTo(pts[1]);
+                break;
+            case SkPath::kQuad_Verb:
+                chunk->quadTo(pts[1], pts[2]);
+                break;
+            case SkPath::kConic_Verb:
+                chunk->conicTo(pts[1], pts[2], iter.conicWeight());
+                break;
+            case SkPath::kCubic_Verb:
+                chunk->cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPath::kClose_Verb:
+                chunk->close();
+                break;
+            default:
+                SkDEBUGFAIL("unexpected verb");
+                break;
         }
     }
+}
 
-    SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(), this->getJoin(), fResScale);
+// Strokes the contours of src into dst. Unless src ends the path being stroked, its last contour
+// is finished the way the next contour's moveTo would finish it.
+static void stroke_contours(const SkPath& src, SkScalar radius, SkScalar miterLimit,
+                            SkPaint::Cap cap, SkPaint::Join join, SkScalar resScale,
+                            bool endsPath, SkPath* dst) {
+    SkPathStroker   stroker(src, radius, miterLimit, cap, join, resScale);
     SkPath::Iter    iter(src, false);
     SkPath::Verb    lastSegment = SkPath::kMove_Verb;
 
@@ -1341,7 +1373,55 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
         }
     }
 DONE:
-    stroker.done(dst, lastSegment == SkPath::kLine_Verb);
+    stroker.done(dst, endsPath && lastSegment == SkPath::kLine_Verb);
+}
+
+void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
+    SkASSERT(dst);
+
+    SkScalar radius = SkScalarHalf(fWidth);
+
+    AutoTmpPath tmp(src, &dst);
+
+    if (radius <= 0) {
+        return;
+    }
+
+    // If src is really a rect, call our specialty strokeRect() method
+    {
+        SkRect rect;
+        bool isClosed;
+        SkPath::Direction dir;
+        if (src.isRect(&rect, &isClosed, &dir) && isClosed) {
+            this->strokeRect(rect, dst, dir);
+            // our answer should preserve the inverseness of the src
+            if (src.isInverseFillType()) {
+                SkASSERT(!dst->isInverseFillType());
+                dst->toggleInverseFillType();
+            }
+            return;
+        }
+    }
+
+    SkTArray<SkPath> chunks;
+    if (src.countPoints() >= kMinParallelStrokePoints) {
+        split_contours(src, &chunks);
+    }
+    if (chunks.count() > 1) {
+        SkTArray<SkPath> strokes;
+        strokes.push_back_n(chunks.count());
+        sk_parallel_for(chunks.count(), [&](int i) {
+            stroke_contours(chunks[i], radius, fMiterLimit, this->getCap(), this->getJoin(),
+                            fResScale, i == chunks.count() - 1, &strokes[i]);
+        });
+        dst->swap(strokes[0]);
+        for (int i = 1; i < strokes.count(); ++i) {
+            dst->addPath(strokes[i]);
+        }
+    } else {
+        stroke_contours(src, radius, fMiterLimit, this->getCap(), this->getJoin(), fResScale,
+                        true, dst);
+    }
 
     if (fDoFill) {
         if (SkPathPriv::CheapIsFirstDirection(src, SkPathPriv::kCCW_FirstDirection)) {
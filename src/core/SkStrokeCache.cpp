@@ -0,0 +1,79 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+
+#include "SkResourceCache.h"
+#include "SkStrokeRec.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(uint32_t pathGenID, SkPath::FillType fillType, const SkStrokeRec& rec)
+        : fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fResScale(rec.getResScale())
+        , fCap(rec.getCap())
+        , fJoin(rec.getJoin())
+        , fStyle(rec.getStyle())
+        , fFillType(fillType)
+    {
+        this->init(&gStrokeKeyNamespaceLabel, pathGenID,
+                   sizeof(fWidth) + sizeof(fMiter) + sizeof(fResScale) + sizeof(fCap) +
+                   sizeof(fJoin) + sizeof(fStyle) + sizeof(fFillType));
+    }
+
+    SkScalar    fWidth;
+    SkScalar    fMiter;
+    SkScalar    fResScale;
+    int32_t     fCap;
+    int32_t     fJoin;
+    int32_t     fStyle;
+    int32_t     fFillType;
+};
+
+struct StrokeRec : public SkResourceCache::Rec {
+    StrokeRec(const StrokeKey& key, const SkPath& stroke)
+        : fKey(key)
+        , fStroke(stroke)
+    {}
+
+    StrokeKey   fKey;
+    SkPath      fStroke;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fStroke.countPoints() * sizeof(SkPoint) + fStroke.countVerbs();
+    }
+    const char* getCategory() const override { return "stroke"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const StrokeRec& rec = static_cast<const StrokeRec&>(baseRec);
+        SkPath* result = static_cast<SkPath*>(contextData);
+
+        *result = rec.fStroke;
+        return true;
+    }
+};
+} // namespace
+
+bool SkStrokeCache::Find(uint32_t pathGenID, SkPath::FillType fillType, const SkStrokeRec& rec,
+                         SkPath* dst, SkResourceCache* localCache) {
+    StrokeKey key(pathGenID, fillType, rec);
+    return CHECK_LOCAL(localCache, find, Find, key, StrokeRec::Visitor, dst);
+}
+
+void SkStrokeCache::Add(uint32_t pathGenID, SkPath::FillType fillType, const SkStrokeRec& rec,
+                        const SkPath& stroke, SkResourceCache* localCache) {
+    StrokeKey key(pathGenID, fillType, rec);
+    return CHECK_LOCAL(localCache, add, Add, SkNEW_ARGS(StrokeRec, (key, stroke)));
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPath.h"
+
+class SkResourceCache;
+class SkStrokeRec;
+
+/**
+ *  Holds the paths that strokes turn paths into, so a path drawn with the same stroke over and
+ *  over is only stroked once. Entries are keyed by the source path's generation ID and fill type,
+ *  and by every stroke parameter, including the res scale: it sets the stroker's tolerance, so a
+ *  different value can give a different path.
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  On success, set dst to the stroke of the path and return true. dst shares the cached path's
+     *  storage until either is changed.
+     *
+     *  On failure, return false and leave dst unchanged.
+     */
+    static bool Find(uint32_t pathGenID, SkPath::FillType, const SkStrokeRec&, SkPath* dst,
+                     SkResourceCache* localCache = NULL);
+
+    /**
+     *  Add the stroke of a path to the cache.
+     */
+    static void Add(uint32_t pathGenID, SkPath::FillType, const SkStrokeRec&,
+                    const SkPath& stroke, SkResourceCache* localCache = NULL);
+};
+
+#endif
@@ -0,0 +1,338 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkTGroupProbeHash_DEFINED
+#define SkTGroupProbeHash_DEFINED
+
+#include "SkChecksum.h"
+#include "SkMath.h"
+#include "SkTypes.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+// A drop-in replacement for SkTDynamicHash, for caches where lookups are hot.
+//
+// SkTDynamicHash compares keys by following each slot's pointer, so every probe touches an entry
+// that's probably not in cache.  Here each slot also has a control byte, holding 7 bits of the
+// entry's hash, kept apart from the slots.  A lookup checks a group of 16 control bytes at once
+// (with one SSE2 compare where we have it) and only follows the pointers whose bits match.
+//
+// Traits requires:
+//   static const Key& GetKey(const T&) { ... }
+//   static uint32_t Hash(const Key&) { ... }
+// We'll look on T for these by default, or you can pass a custom Traits type.
+template <typename T,
+          typename Key,
+          typename Traits = T>
+class SkTGroupProbeHash : SkNoncopyable {
+public:
+    SkTGroupProbeHash() : fCount(0), fDeleted(0), fCapacity(0), fCtrl(NULL), fSlots(NULL) {
+        SkASSERT(this->validate());
+    }
+
+    ~SkTGroupProbeHash() {
+        sk_free(fSlots);
+    }
+
+    class Iter {
+    public:
+        explicit Iter(SkTGroupProbeHash* hash) : fHash(hash), fCurrentIndex(-1) {
+            SkASSERT(hash);
+            ++(*this);
+        }
+        bool done() const {
+            SkASSERT(fCurrentIndex <= fHash->fCapacity);
+            return fCurrentIndex == fHash->fCapacity;
+        }
+        T& operator*() const {
+            SkASSERT(!this->done());
+            return *fHash->fSlots[fCurrentIndex];
+        }
+        void operator++() {
+            do {
+                fCurrentIndex++;
+            } while (!this->done() && !IsFull(fHash->fCtrl[fCurrentIndex]));
+        }
+
+    private:
+        SkTGroupProbeHash* fHash;
+        int fCurrentIndex;
+    };
+
+    class ConstIter {
+    public:
+        explicit ConstIter(const SkTGroupProbeHash* hash) : fHash(hash), fCurrentIndex(-1) {
+            SkASSERT(hash);
+            ++(*this);
+        }
+        bool done() const {
+            SkASSERT(fCurrentIndex <= fHash->fCapacity);
+            return fCurrentIndex == fHash->fCapacity;
+        }
+        const T& operator*() const {
+            SkASSERT(!this->done());
+            return *fHash->fSlots[fCurrentIndex];
+        }
+        void operator++() {
+            do {
+                fCurrentIndex++;
+            } while (!this->done() && !IsFull(fHash->fCtrl[fCurrentIndex]));
+        }
+
+    private:
+        const SkTGroupProbeHash* fHash;
+        int fCurrentIndex;
+    };
+
+    int count() const { return fCount; }
+
+    // Return the entry with this key if we have it, otherwise NULL.
+    T* find(const Key& key) const {
+        int index = this->findIndex(key);
+        return index >= 0 ? fSlots[index] : NULL;
+    }
+
+    // Add an entry with this key.  We require that no entry with newEntry's key is already present.
+    void add(T* newEntry) {
+        SkASSERT(NULL == this->find(GetKey(*newEntry)));
+        this->maybeGrow();
+        this->innerAdd(newEntry);
+        SkASSERT(this->validate());
+    }
+
+    // Remove the entry with this key.  We require that an entry with this key is present.
+    void remove(const Key& key) {
+        int index = this->findIndex(key);
+        SkASSERT(index >= 0);
+        // If this group never filled up no probe ever went past it, so the slot can just be empty.
+        if (MatchEmpty(fCtrl + GroupStart(index))) {
+            fCtrl[index] = kEmpty;
+        } else {
+            fCtrl[index] = kDeleted;
+            fDeleted++;
+        }
+        fCount--;
+        SkASSERT(this->validate());
+    }
+
+    void rewind() {
+        if (fCtrl) {
+            memset(fCtrl, kEmpty, fCapacity);
+        }
+        fCount = 0;
+        fDeleted = 0;
+    }
+
+    void reset() {
+        fCount = 0;
+        fDeleted = 0;
+        fCapacity = 0;
+        sk_free(fSlots);
+        fSlots = NULL;
+        fCtrl = NULL;
+    }
+
+protected:
+    // These methods are used by tests only.
+
+    int capacity() const { return fCapacity; }
+
+    // How many groups do we go through before finding where this entry should be inserted?
+    int countGroupCollisions(const Key& key) const {
+        const uint32_t hash = Hash(key);
+        int group = this->firstGroup(hash);
+        for (int round = 0; round < this->groupCount(); round++) {
+            const uint8_t* ctrl = fCtrl + group * kGroupWidth;
+            uint32_t bits = Match(ctrl, H2(hash));
+            while (bits) {
+                int index = group * kGroupWidth + FirstBit(bits);
+                if (GetKey(*fSlots[index]) == key) {
+                    return round;
+                }
+                bits &= bits - 1;
+            }
+            if (MatchEmptyOrDeleted(ctrl)) {
+                return round;
+            }
+            group = this->nextGroup(group, round);
+        }
+        return 0;
+    }
+
+private:
+    static const int     kGroupWidth = 16;
+    // Full slots hold the low 7 bits of their entry's hash, so only the special values set the
+    // top bit.  That lets one movemask find the empty-or-deleted slots of a group.
+    static const uint8_t kEmpty      = 0x80;
+    static const uint8_t kDeleted    = 0xFE;
+
+    static bool IsFull(uint8_t ctrl) { return 0 == (ctrl & 0x80); }
+    static uint8_t H2(uint32_t hash) { return hash & 0x7F; }
+    static int GroupStart(int index) { return index & ~(kGroupWidth - 1); }
+    static int FirstBit(uint32_t bits) { return 31 - SkCLZ(bits & (0 - bits)); }
+
+    // Each returns a mask with bit i set if the group's ith control byte matches.
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    static uint32_t Match(const uint8_t* ctrl, uint8_t h2) {
+        __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+    }
+    static uint32_t MatchEmptyOrDeleted(const uint8_t* ctrl) {
+        return _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+    }
+#else
+    static uint32_t Match(const uint8_t* ctrl, uint8_t h2) {
+        uint32_t bits = 0;
+        for (int i = 0; i < kGroupWidth; i++) {
+            bits |= (uint32_t)(ctrl[i] == h2) << i;
+        }
+        return bits;
+    }
+    static uint32_t MatchEmptyOrDeleted(const uint8_t* ctrl) {
+        uint32_t bits = 0;
+        for (int i = 0; i < kGroupWidth; i++) {
+            bits |= (uint32_t)(ctrl[i] >> 7) << i;
+        }
+        return bits;
+    }
+#endif
+    static uint32_t MatchEmpty(const uint8_t* ctrl) { return Match(ctrl, kEmpty); }
+
+    int findIndex(const Key& key) const {
+        const uint32_t hash = Hash(key);
+        int group = this->firstGroup(hash);
+        for (int round = 0; round < this->groupCount(); round++) {
+            const uint8_t* ctrl = fCtrl + group * kGroupWidth;
+            uint32_t bits = Match(ctrl, H2(hash));
+            while (bits) {
+                int index = group * kGroupWidth + FirstBit(bits);
+                if (GetKey(*fSlots[index]) == key) {
+                    return index;
+                }
+                bits &= bits - 1;
+            }
+            if (MatchEmpty(ctrl)) {
+                return -1;
+            }
+            group = this->nextGroup(group, round);
+        }
+        return -1;
+    }
+
+    bool validate() const {
+        #define SKTGROUPPROBEHASH_CHECK(x) SkASSERT(x); if (!(x)) return false
+        static const int kLarge = 50;  // Arbitrary, tweak to suit your patience.
+
+        // O(1) checks, always done.
+        // Is capacity sane?
+        SKTGROUPPROBEHASH_CHECK(0 == fCapacity || (SkIsPow2(fCapacity) &&
+                                                   fCapacity >= kGroupWidth));
+
+        // O(N) checks, skipped when very large.
+        if (fCount < kLarge * kLarge) {
+            // Are fCount and fDeleted correct, and are all elements findable?
+            int count = 0, deleted = 0;
+            for (int i = 0; i < fCapacity; i++) {
+                if (kDeleted == fCtrl[i]) {
+                    deleted++;
+                } else if (IsFull(fCtrl[i])) {
+                    count++;
+                    SKTGROUPPROBEHASH_CHECK(H2(Hash(GetKey(*fSlots[i]))) == fCtrl[i]);
+                    SKTGROUPPROBEHASH_CHECK(this->find(GetKey(*fSlots[i])) == fSlots[i]);
+                } else {
+                    SKTGROUPPROBEHASH_CHECK(kEmpty == fCtrl[i]);
+                }
+            }
+            SKTGROUPPROBEHASH_CHECK(count == fCount);
+            SKTGROUPPROBEHASH_CHECK(deleted == fDeleted);
+        }
+        #undef SKTGROUPPROBEHASH_CHECK
+        return true;
+    }
+
+    void innerAdd(T* newEntry) {
+        const uint32_t hash = Hash(GetKey(*newEntry));
+        int group = this->firstGroup(hash);
+        for (int round = 0; round < this->groupCount(); round++) {
+            uint32_t bits = MatchEmptyOrDeleted(fCtrl + group * kGroupWidth);
+            if (bits) {
+                int index = group * kGroupWidth + FirstBit(bits);
+                if (kDeleted == fCtrl[index]) {
+                    fDeleted--;
+                }
+                fCount++;
+                fCtrl[index] = H2(hash);
+                fSlots[index] = newEntry;
+                return;
+            }
+            group = this->nextGroup(group, round);
+        }
+        SkASSERT(false);  // maybeGrow() keeps at least one slot free.
+    }
+
+    void maybeGrow() {
+        // Probing a whole group at a time copes with a fuller table than SkTDynamicHash's 75%.
+        if (8 * (fCount + fDeleted + 1) > 7 * fCapacity) {
+            // If it's mostly deleted slots, rehashing at the same size is enough.
+            int newCapacity = fCapacity;
+            if (0 == newCapacity) {
+                newCapacity = kGroupWidth;
+            } else if (2 * (fCount + 1) > fCapacity) {
+                newCapacity *= 2;
+            }
+            this->resize(newCapacity);
+        }
+    }
+
+    void resize(int newCapacity) {
+        SkDEBUGCODE(int oldCount = fCount;)
+        int oldCapacity = fCapacity;
+        SkAutoTMalloc<T*> oldSlots(fSlots);
+        const uint8_t* oldCtrl = fCtrl;
+
+        fCount = fDeleted = 0;
+        fCapacity = newCapacity;
+        // One allocation: the slots, then the control bytes after them.
+        fSlots = (T**)sk_malloc_throw(fCapacity * (sizeof(T*) + sizeof(uint8_t)));
+        fCtrl = (uint8_t*)(fSlots + fCapacity);
+        memset(fCtrl, kEmpty, fCapacity);
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (IsFull(oldCtrl[i])) {
+                this->innerAdd(oldSlots[i]);
+            }
+        }
+        SkASSERT(oldCount == fCount);
+    }
+
+    int groupCount() const { return fCapacity / kGroupWidth; }
+
+    // The control bytes take the low 7 bits of the hash, so pick the group with the rest.
+    int firstGroup(uint32_t hash) const {
+        return (hash >> 7) & (this->groupCount() - 1);
+    }
+
+    // Given group at round N, what is the group to check at N+1?  round should start at 0.
+    int nextGroup(int group, int round) const {
+        // This will search a power-of-two number of groups fully without repeating one.
+        return (group + round + 1) & (this->groupCount() - 1);
+    }
+
+    static const Key& GetKey(const T& t) { return Traits::GetKey(t); }
+    // Keys like GrUniqueKey hash well, but others may not spread their bits, so mix them in.
+    static uint32_t Hash(const Key& key) { return SkChecksum::Mix(Traits::Hash(key)); }
+
+    int      fCount;     // Number of full slots.
+    int      fDeleted;   // Number of kDeleted slots.
+    int      fCapacity;  // Number of slots.  0, or a power of 2 no less than kGroupWidth.
+    uint8_t* fCtrl;      // fCapacity control bytes, allocated along with fSlots.
+    T**      fSlots;     // Only meaningful where fCtrl is full.
+};
+
+#endif
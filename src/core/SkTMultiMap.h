@@ -10,7 +10,7 @@
 #define SkTMultiMap_DEFINED
 
 #include "GrTypes.h"
-#include "SkTDynamicHash.h"
+#include "SkTGroupProbeHash.h"
 
 /** A set that contains pointers to instances of T. Instances can be looked up with key Key.
  * Multiple (possibly same) values can have the same key.
@@ -116,7 +116,7 @@ public:
 #endif
 
 private:
-    SkTDynamicHash<ValueList, Key> fHash;
+    SkTGroupProbeHash<ValueList, Key> fHash;
     int fCount;
 };
 
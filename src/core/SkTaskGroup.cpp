@@ -10,6 +10,7 @@
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTDArray.h"
+#include "SkTLS.h"
 #include "SkTaskGroup.h"
 #include "SkThreadUtils.h"
 
@@ -37,6 +38,12 @@ int sk_num_cores() {
 
 namespace {
 
+// Each worker thread owns a deque of Work.  Workers push and pop their own work at the back
+// of their deque (LIFO, for locality), and when their deque is empty they steal from the front
+// of other workers' deques (FIFO, so thieves take the oldest, usually largest, pieces of work).
+// Threads outside the pool spread their work round-robin across all the deques.
+//
+// Each deque has its own lock, so threads only contend when they touch the same deque.
 class ThreadPool : SkNoncopyable {
 public:
     static void Add(SkRunnable* task, SkAtomic<int32_t>* pending) {
@@ -70,18 +77,14 @@ public:
         // Acquire pairs with decrement release here or in Loop.
         while (pending->load(sk_memory_order_acquire) > 0) {
             // Lend a hand until our SkTaskGroup of interest is done.
+            // We're stealing work opportunistically,
+            // so we never call fWorkAvailable.wait(), which could sleep us if there's no work.
+            // This means fWorkAvailable is only an upper bound on the amount of queued Work.
             Work work;
-            {
-                // We're stealing work opportunistically,
-                // so we never call fWorkAvailable.wait(), which could sleep us if there's no work.
-                // This means fWorkAvailable is only an upper bound on fWork.count().
-                AutoLock lock(&gGlobal->fWorkLock);
-                if (gGlobal->fWork.isEmpty()) {
-                    // Someone has picked up all the work (including ours).  How nice of them!
-                    // (They may still be working on it, so we can't assert *pending == 0 here.)
-                    continue;
-                }
-                gGlobal->fWork.pop(&work);
+            if (!gGlobal->pop(CurrentWorker(), &work)) {
+                // Someone has picked up all the work (including ours).  How nice of them!
+                // (They may still be working on it, so we can't assert *pending == 0 here.)
+                continue;
             }
             // This Work isn't necessarily part of our SkTaskGroup of interest, but that's fine.
             // We threads gotta stick together.  We're always making forward progress.
@@ -106,18 +109,76 @@ private:
         SkAtomic<int32_t>* pending;   // then decrement pending afterwards.
     };
 
-    explicit ThreadPool(int threads) {
+    // fLock must be held when reading or modifying fWork or fHead.
+    // Live Work is fWork[fHead, fWork.count()).  Owners pop the back, thieves pop the front.
+    struct Deque {
+        Deque() : fHead(0) {}
+
+        bool popBack(Work* work) {
+            AutoLock lock(&fLock);
+            if (fHead == fWork.count()) {
+                return false;
+            }
+            fWork.pop(work);
+            this->resetIfEmpty();
+            return true;
+        }
+
+        bool popFront(Work* work) {
+            AutoLock lock(&fLock);
+            if (fHead == fWork.count()) {
+                return false;
+            }
+            *work = fWork[fHead++];
+            this->resetIfEmpty();
+            return true;
+        }
+
+        void resetIfEmpty() {
+            if (fHead == fWork.count()) {
+                fHead = 0;
+                fWork.rewind();
+            }
+        }
+
+        SkSpinlock      fLock;
+        int             fHead;
+        SkTDArray<Work> fWork;
+        char            fPad[64];  // Keep neighboring deques' locks off each other's cache lines.
+    };
+
+    struct Worker {
+        ThreadPool* fPool;
+        int         fIndex;
+    };
+
+    // Used as a key into SkTLS to find the index of the worker running on this thread.
+    static void* CreateWorkerIndex() { return SkNEW_ARGS(int, (-1)); }
+    static void DeleteWorkerIndex(void* index) { SkDELETE((int*)index); }
+
+    // Returns the index of the worker running on this thread, or -1 if this isn't a worker.
+    static int CurrentWorker() {
+        int* index = (int*)SkTLS::Find(CreateWorkerIndex);
+        return index ? *index : -1;
+    }
+
+    explicit ThreadPool(int threads) : fNextDeque(0) {
         if (threads == -1) {
             threads = sk_num_cores();
         }
+        fDequeCount = threads;
+        fDeques  = SkNEW_ARRAY(Deque,  threads);
+        fWorkers = SkNEW_ARRAY(Worker, threads);
         for (int i = 0; i < threads; i++) {
-            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, this)));
+            fWorkers[i].fPool  = this;
+            fWorkers[i].fIndex = i;
+            fThreads.push(SkNEW_ARGS(SkThread, (&ThreadPool::Loop, &fWorkers[i])));
             fThreads.top()->start();
         }
     }
 
     ~ThreadPool() {
-        SkASSERT(fWork.isEmpty());  // All SkTaskGroups should be destroyed by now.
+        SkASSERT(this->isEmpty());  // All SkTaskGroups should be destroyed by now.
 
         // Send a poison pill to each thread.
         SkAtomic<int> dummy(0);
@@ -128,47 +189,95 @@ private:
         for (int i = 0; i < fThreads.count(); i++) {
             fThreads[i]->join();
         }
-        SkASSERT(fWork.isEmpty());  // Can't hurt to double check.
+        SkASSERT(this->isEmpty());  // Can't hurt to double check.
         fThreads.deleteAll();
+        SkDELETE_ARRAY(fWorkers);
+        SkDELETE_ARRAY(fDeques);
+    }
+
+    bool isEmpty() {
+        for (int i = 0; i < fDequeCount; i++) {
+            AutoLock lock(&fDeques[i].fLock);
+            if (fDeques[i].fHead != fDeques[i].fWork.count()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Workers feed their own deque.  Everyone else spreads work round-robin.
+    int pickDeque() {
+        int worker = CurrentWorker();
+        if (worker >= 0) {
+            return worker;
+        }
+        return (int)((uint32_t)fNextDeque.fetch_add(1, sk_memory_order_relaxed) % fDequeCount);
+    }
+
+    // Try our own deque first (if we have one), then try to steal from everyone else.
+    bool pop(int worker, Work* work) {
+        if (worker >= 0 && fDeques[worker].popBack(work)) {
+            return true;
+        }
+        const int first = worker >= 0 ? worker + 1 : 0;
+        for (int i = 0; i < fDequeCount; i++) {
+            int victim = (first + i) % fDequeCount;
+            if (victim != worker && fDeques[victim].popFront(work)) {
+                return true;
+            }
+        }
+        return false;
     }
 
     void add(void (*fn)(void*), void* arg, SkAtomic<int32_t>* pending) {
         Work work = { fn, arg, pending };
         pending->fetch_add(+1, sk_memory_order_relaxed);  // No barrier needed.
         {
-            AutoLock lock(&fWorkLock);
-            fWork.push(work);
+            Deque& deque = fDeques[this->pickDeque()];
+            AutoLock lock(&deque.fLock);
+            deque.fWork.push(work);
         }
         fWorkAvailable.signal(1);
     }
 
     void batch(void (*fn)(void*), void* arg, int N, size_t stride, SkAtomic<int32_t>* pending) {
+        if (N <= 0) {
+            return;
+        }
         pending->fetch_add(+N, sk_memory_order_relaxed);  // No barrier needed.
-        {
-            AutoLock lock(&fWorkLock);
-            Work* batch = fWork.append(N);
-            for (int i = 0; i < N; i++) {
+
+        // Deal the batch out to the deques in contiguous slices, so each worker starts
+        // with neighboring work of its own and only steals once it has run dry.
+        const int worker = CurrentWorker(),
+                  first  = worker >= 0 ? worker : this->pickDeque(),
+                  slices = SkTMin(N, fDequeCount),
+                  slice  = (N + slices - 1) / slices;
+        for (int s = 0, i = 0; i < N; s++) {
+            const int n = SkTMin(slice, N - i);
+            Deque& deque = fDeques[(first + s) % fDequeCount];
+            AutoLock lock(&deque.fLock);
+            Work* batch = deque.fWork.append(n);
+            for (int j = 0; j < n; j++, i++) {
                 Work work = { fn, (char*)arg + i*stride, pending };
-                batch[i] = work;
+                batch[j] = work;
             }
         }
         fWorkAvailable.signal(N);
     }
 
     static void Loop(void* arg) {
-        ThreadPool* pool = (ThreadPool*)arg;
+        Worker* worker = (Worker*)arg;
+        ThreadPool* pool = worker->fPool;
+        *(int*)SkTLS::Get(CreateWorkerIndex, DeleteWorkerIndex) = worker->fIndex;
+
         Work work;
         while (true) {
             // Sleep until there's work available, and claim one unit of Work as we wake.
             pool->fWorkAvailable.wait();
-            {
-                AutoLock lock(&pool->fWorkLock);
-                if (pool->fWork.isEmpty()) {
-                    // Someone in Wait() stole our work (fWorkAvailable is an upper bound).
-                    // Well, that's fine, back to sleep for us.
-                    continue;
-                }
-                pool->fWork.pop(&work);
+            if (!pool->pop(worker->fIndex, &work)) {
+                // Someone in Wait() stole our work (fWorkAvailable is an upper bound).
+                // Well, that's fine, back to sleep for us.
+                continue;
             }
             if (!work.fn) {
                 return;  // Poison pill.  Time... to die.
@@ -178,11 +287,12 @@ private:
         }
     }
 
-    // fWorkLock must be held when reading or modifying fWork.
-    SkSpinlock      fWorkLock;
-    SkTDArray<Work> fWork;
+    // One deque per worker thread.
+    Deque*            fDeques;
+    int               fDequeCount;
+    SkAtomic<int32_t> fNextDeque;
 
-    // A thread-safe upper bound for fWork.count().
+    // A thread-safe upper bound for the total Work queued in fDeques.
     //
     // We'd have it be an exact count but for the loop in Wait():
     // we never want that to block, so it can't call fWorkAvailable.wait(),
@@ -192,6 +302,7 @@ private:
     SkSemaphore fWorkAvailable;
 
     // These are only changed in a single-threaded context.
+    Worker*              fWorkers;
     SkTDArray<SkThread*> fThreads;
     static ThreadPool* gGlobal;
 
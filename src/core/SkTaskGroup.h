@@ -54,38 +54,70 @@ private:
 int sk_num_cores();
 
 // Call f(i) for i in [0, end).
+//
+// Work is split adaptively: each chunk keeps halving itself, handing the upper half back to
+// the SkTaskGroup, until it is no larger than a minimum grain.  Split-off halves land on the
+// running thread's own deque, so idle threads steal the largest remaining pieces first and
+// uneven per-index costs balance out without any up-front guess at the right chunk count.
 template <typename Func>
 void sk_parallel_for(int end, const Func& f) {
     if (end <= 0) { return; }
 
-    struct Chunk {
+    struct Chunk;
+    struct Shared {
         const Func* f;
-        int start, end;
+        int grain;
+        SkTaskGroup* tg;
+        Chunk* chunks;
+        int maxChunks;
+        SkAtomic<int32_t> next;
     };
 
-    // TODO(mtklein): this chunking strategy could probably use some tuning.
-    int max_chunks  = sk_num_cores() * 2,
-        stride      = (end + max_chunks - 1 ) / max_chunks,
-        nchunks     = (end + stride - 1 ) / stride;
-    SkASSERT(nchunks <= max_chunks);
-
-    // With the chunking strategy above this won't malloc until we have a machine with >512 cores.
-    SkAutoSTMalloc<1024, Chunk> chunks(nchunks);
-
-    for (int i = 0; i < nchunks; i++) {
-        Chunk& c = chunks[i];
-        c.f     = &f;
-        c.start = i * stride;
-        c.end   = SkTMin(c.start + stride, end);
-        SkASSERT(c.start < c.end);  // Nothing will break if start >= end, but it's a wasted chunk.
-    }
-
-    void(*run_chunk)(Chunk*) = [](Chunk* c) {
-        for (int i = c->start; i < c->end; i++) {
-            (*c->f)(i);
+    struct Chunk {
+        Shared* shared;
+        int start, end;
+
+        static void Run(Chunk* c) {
+            Shared* s = c->shared;
+            int start = c->start,
+                end   = c->end;
+            while (end - start > s->grain) {
+                const int mid = start + (end - start) / 2;
+                const int i = s->next.fetch_add(1, sk_memory_order_relaxed);
+                SkASSERT(i < s->maxChunks);
+                Chunk* upper = &s->chunks[i];
+                upper->shared = s;
+                upper->start  = mid;
+                upper->end    = end;
+                s->tg->add(&Chunk::Run, upper);
+                end = mid;
+            }
+            for (int i = start; i < end; i++) {
+                (*s->f)(i);
+            }
         }
     };
-    SkTaskGroup().batch(run_chunk, chunks.get(), nchunks);
+
+    // Halving stops at the grain, so every chunk but the first covers more than grain/2
+    // indices.  That bounds how many chunks we can ever need.
+    SkTaskGroup tg;
+    Shared shared;
+    shared.f         = &f;
+    shared.grain     = SkTMax(1, end / (sk_num_cores() * 8));
+    shared.tg        = &tg;
+    shared.maxChunks = 2 * (end / shared.grain) + 2;
+    shared.next.store(1, sk_memory_order_relaxed);
+
+    // This won't malloc until we have a machine with >64 cores.
+    SkAutoSTMalloc<1024, Chunk> chunks(shared.maxChunks);
+    shared.chunks = chunks.get();
+
+    Chunk& root = chunks[0];
+    root.shared = &shared;
+    root.start  = 0;
+    root.end    = end;
+    tg.add(&Chunk::Run, &root);
+    tg.wait();
 }
 
 #endif//SkTaskGroup_DEFINED
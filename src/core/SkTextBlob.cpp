@@ -7,10 +7,13 @@
 
 #include "SkTextBlob.h"
 
+#include "SkMessageBus.h"
 #include "SkReadBuffer.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
 
+DECLARE_SKMESSAGEBUS_MESSAGE(SkTextBlob::PurgeBlobMessage);
+
 namespace {
 
 // TODO(fmalita): replace with SkFont.
@@ -200,10 +203,16 @@ static int32_t next_id() {
 SkTextBlob::SkTextBlob(int runCount, const SkRect& bounds)
     : fRunCount(runCount)
     , fBounds(bounds)
-    , fUniqueID(next_id()) {
+    , fUniqueID(next_id())
+    , fAddedToCache(false) {
 }
 
 SkTextBlob::~SkTextBlob() {
+    if (fAddedToCache.load()) {
+        PurgeBlobMessage msg = { fUniqueID };
+        SkMessageBus<PurgeBlobMessage>::Post(msg);
+    }
+
     const RunRecord* run = RunRecord::First(this);
     for (int i = 0; i < fRunCount; ++i) {
         const RunRecord* nextRun = RunRecord::Next(run);
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBigPicture.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkMatrix.h"
+#include "SkRecordDraw.h"
+#include "SkRTree.h"
+#include "SkTaskGroup.h"
+#include "SkTiledPictureDraw.h"
+
+void SkTiledPictureDraw::Draw(const SkPicture* picture, const SkBitmap& dst,
+                              const SkMatrix* matrix, int tileWidth, int tileHeight,
+                              const SkIRect* dirty) {
+    if (NULL == picture || dst.drawsNothing() || tileWidth <= 0 || tileHeight <= 0) {
+        return;
+    }
+
+    SkAutoLockPixels alp(dst);
+    if (!dst.getPixels()) {
+        return;
+    }
+
+    SkMatrix ctm = SkMatrix::I();
+    if (matrix) {
+        ctm = *matrix;
+    }
+
+    SkIRect area = SkIRect::MakeWH(dst.width(), dst.height());
+    if (dirty && !area.intersect(*dirty)) {
+        return;
+    }
+
+    // Only the tiles overlapping area are drawn.
+    const int x0 = area.fLeft / tileWidth,
+              y0 = area.fTop  / tileHeight,
+              xTiles = (area.fRight  - 1) / tileWidth  - x0 + 1,
+              yTiles = (area.fBottom - 1) / tileHeight - y0 + 1,
+              nTiles = xTiles * yTiles;
+
+    // Tiles cull through the picture's BBH.  Pictures recorded without one get an RTree
+    // here, built once and shared read-only by all tiles.
+    const SkBigPicture* bp = picture->asSkBigPicture();
+    const SkBBoxHierarchy* bbh = bp ? bp->bbh() : NULL;
+    SkAutoTUnref<SkRTree> tmpBBH;
+    if (bp && !bbh && nTiles > 1) {
+        tmpBBH.reset(SkNEW(SkRTree));
+        SkRecordFillBounds(bp->cullRect(), *bp->record(), tmpBBH);
+        bbh = tmpBBH;
+    }
+
+    sk_parallel_for(nTiles, [&](int i) {
+        const SkIRect tile = SkIRect::MakeXYWH((x0 + i % xTiles) * tileWidth,
+                                               (y0 + i / xTiles) * tileHeight,
+                                               tileWidth, tileHeight);
+        SkBitmap subset;
+        if (!dst.extractSubset(&subset, tile)) {
+            return;
+        }
+
+        SkCanvas canvas(subset);
+        canvas.translate(-SkIntToScalar(tile.fLeft), -SkIntToScalar(tile.fTop));
+        canvas.concat(ctm);
+        // Ops outside the cull rect have their bounds clamped to it in the BBH, so whether a
+        // tile keeps them would depend on the tile.  Clip them away everywhere instead.
+        canvas.clipRect(picture->cullRect());
+
+        if (bp) {
+            SkRecordDraw(*bp->record(), &canvas, bp->drawablePicts(), NULL,
+                         bp->drawableCount(), bbh, NULL);
+        } else {
+            picture->playback(&canvas);
+        }
+    });
+}
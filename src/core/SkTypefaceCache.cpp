@@ -10,53 +10,105 @@
 
 #include "SkTypefaceCache.h"
 #include "SkAtomics.h"
+#include "SkChecksum.h"
 #include "SkMutex.h"
 
 #define TYPEFACE_CACHE_LIMIT    1024
 
-SkTypefaceCache::SkTypefaceCache() {}
+SkTypefaceCache::SkTypefaceCache() : fHits(0), fMisses(0), fEvictions(0) {}
 
 SkTypefaceCache::~SkTypefaceCache() {
-    const Rec* curr = fArray.begin();
-    const Rec* stop = fArray.end();
-    while (curr < stop) {
-        curr->fFace->unref();
-        curr += 1;
+    for (int i = 0; i < fArray.count(); ++i) {
+        fArray[i]->fFace->unref();
+        SkDELETE(fArray[i]);
     }
 }
 
 void SkTypefaceCache::add(SkTypeface* face, const SkFontStyle& requestedStyle) {
+    this->add(face, requestedStyle, NULL, 0);
+}
+
+void SkTypefaceCache::add(SkTypeface* face, const SkFontStyle& requestedStyle,
+                          const uint32_t keyHashes[], int keyHashCount) {
+    SkASSERT(keyHashCount >= 0 && keyHashCount <= kMaxKeyHashes);
     if (fArray.count() >= TYPEFACE_CACHE_LIMIT) {
         this->purge(TYPEFACE_CACHE_LIMIT >> 2);
     }
 
-    Rec* rec = fArray.append();
+    Rec* rec = SkNEW(Rec);
     rec->fFace = SkRef(face);
     rec->fRequestedStyle = requestedStyle;
+    rec->fKeyHashCount = 0;
+    for (int i = 0; i < keyHashCount; ++i) {
+        uint32_t hash = keyHashes[i];
+        bool seen = false;
+        for (int j = 0; j < rec->fKeyHashCount; ++j) {
+            seen |= (rec->fKeyHashes[j] == hash);
+        }
+        if (seen) {
+            continue;
+        }
+        rec->fKeyHashes[rec->fKeyHashCount++] = hash;
+
+        SkTDArray<Rec*>* bucket = fIndex.find(hash);
+        if (!bucket) {
+            bucket = fIndex.set(hash, SkTDArray<Rec*>());
+        }
+        *bucket->append() = rec;
+    }
+    *fArray.append() = rec;
 }
 
 SkTypeface* SkTypefaceCache::findByProcAndRef(FindProc proc, void* ctx) const {
-    const Rec* curr = fArray.begin();
-    const Rec* stop = fArray.end();
-    while (curr < stop) {
-        SkTypeface* currFace = curr->fFace;
-        if (proc(currFace, curr->fRequestedStyle, ctx)) {
-            return SkRef(currFace);
+    for (int i = 0; i < fArray.count(); ++i) {
+        const Rec* rec = fArray[i];
+        if (proc(rec->fFace, rec->fRequestedStyle, ctx)) {
+            return SkRef(rec->fFace);
         }
-        curr += 1;
     }
     return NULL;
 }
 
+SkTypeface* SkTypefaceCache::findByProcAndRef(FindProc proc, void* ctx, uint32_t keyHash) const {
+    const SkTDArray<Rec*>* bucket = fIndex.find(keyHash);
+    if (!bucket) {
+        return NULL;
+    }
+    for (int i = 0; i < bucket->count(); ++i) {
+        const Rec* rec = (*bucket)[i];
+        if (proc(rec->fFace, rec->fRequestedStyle, ctx)) {
+            return SkRef(rec->fFace);
+        }
+    }
+    return NULL;
+}
+
+void SkTypefaceCache::unindex(Rec* rec) {
+    for (int i = 0; i < rec->fKeyHashCount; ++i) {
+        uint32_t hash = rec->fKeyHashes[i];
+        SkTDArray<Rec*>* bucket = fIndex.find(hash);
+        SkASSERT(bucket);
+        int index = bucket->find(rec);
+        SkASSERT(index >= 0);
+        bucket->remove(index);
+        if (bucket->isEmpty()) {
+            fIndex.remove(hash);
+        }
+    }
+}
+
 void SkTypefaceCache::purge(int numToPurge) {
     int count = fArray.count();
     int i = 0;
     while (i < count) {
-        SkTypeface* face = fArray[i].fFace;
-        if (face->unique()) {
-            face->unref();
+        Rec* rec = fArray[i];
+        if (rec->fFace->unique()) {
+            this->unindex(rec);
+            rec->fFace->unref();
+            SkDELETE(rec);
             fArray.remove(i);
             --count;
+            ++fEvictions;
             if (--numToPurge == 0) {
                 return;
             }
@@ -82,6 +134,15 @@ SkFontID SkTypefaceCache::NewFontID() {
     return sk_atomic_inc(&gFontID) + 1;
 }
 
+uint32_t SkTypefaceCache::HashKey(const void* data, size_t length, uint32_t seed) {
+    return SkChecksum::Murmur3(data, length, seed);
+}
+
+uint32_t SkTypefaceCache::HashNameStyle(const char name[], const SkFontStyle& style) {
+    uint32_t seed = (style.weight() << 16) ^ (style.width() << 8) ^ style.slant();
+    return HashKey(name, name ? strlen(name) : 0, seed);
+}
+
 SK_DECLARE_STATIC_MUTEX(gMutex);
 
 void SkTypefaceCache::Add(SkTypeface* face, const SkFontStyle& requestedStyle) {
@@ -89,9 +150,33 @@ void SkTypefaceCache::Add(SkTypeface* face, const SkFontStyle& requestedStyle) {
     Get().add(face, requestedStyle);
 }
 
+void SkTypefaceCache::Add(SkTypeface* face, const SkFontStyle& requestedStyle,
+                          const uint32_t keyHashes[], int keyHashCount) {
+    SkAutoMutexAcquire ama(gMutex);
+    Get().add(face, requestedStyle, keyHashes, keyHashCount);
+}
+
 SkTypeface* SkTypefaceCache::FindByProcAndRef(FindProc proc, void* ctx) {
     SkAutoMutexAcquire ama(gMutex);
-    SkTypeface* typeface = Get().findByProcAndRef(proc, ctx);
+    SkTypefaceCache& cache = Get();
+    SkTypeface* typeface = cache.findByProcAndRef(proc, ctx);
+    if (typeface) {
+        cache.fHits++;
+    } else {
+        cache.fMisses++;
+    }
+    return typeface;
+}
+
+SkTypeface* SkTypefaceCache::FindByProcAndRef(FindProc proc, void* ctx, uint32_t keyHash) {
+    SkAutoMutexAcquire ama(gMutex);
+    SkTypefaceCache& cache = Get();
+    SkTypeface* typeface = cache.findByProcAndRef(proc, ctx, keyHash);
+    if (typeface) {
+        cache.fHits++;
+    } else {
+        cache.fMisses++;
+    }
     return typeface;
 }
 
@@ -100,6 +185,21 @@ void SkTypefaceCache::PurgeAll() {
     Get().purgeAll();
 }
 
+void SkTypefaceCache::VisitStats(SkCacheStats::Visitor visitor, void* context) {
+    SkCacheStats stats;
+    {
+        SkAutoMutexAcquire ama(gMutex);
+        const SkTypefaceCache& cache = Get();
+        stats.fName = "typeface";
+        stats.fHits = cache.fHits;
+        stats.fMisses = cache.fMisses;
+        stats.fEvictions = cache.fEvictions;
+        stats.fBytes = 0;
+        stats.fEntries = cache.fArray.count();
+    }
+    visitor(stats, context);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
@@ -11,8 +11,10 @@
 #ifndef SkTypefaceCache_DEFINED
 #define SkTypefaceCache_DEFINED
 
+#include "SkCacheStats.h"
 #include "SkTypeface.h"
 #include "SkTDArray.h"
+#include "SkTHash.h"
 
 /*  TODO
  *  Provide std way to cache name+requestedStyle aliases to the same typeface.
@@ -41,6 +43,17 @@ public:
      */
     void add(SkTypeface*, const SkFontStyle& requested);
 
+    /** The most lookup keys a single typeface may be added under. */
+    static const int kMaxKeyHashes = 2;
+
+    /**
+     *  As add(), but also indexes the typeface under each of the keyHashes
+     *  (at most kMaxKeyHashes), so that a keyed findByProcAndRef() only has to
+     *  look at the typefaces sharing its key rather than the whole cache.
+     */
+    void add(SkTypeface*, const SkFontStyle& requested,
+             const uint32_t keyHashes[], int keyHashCount);
+
     /**
      *  Iterate through the cache, calling proc(typeface, ctx) with each
      *  typeface. If proc returns true, then we return that typeface (this
@@ -48,6 +61,13 @@ public:
      */
     SkTypeface* findByProcAndRef(FindProc proc, void* ctx) const;
 
+    /**
+     *  As findByProcAndRef(), but only calls proc for the typefaces that were
+     *  added under keyHash. proc still decides what matches, so colliding keys
+     *  are harmless; typefaces added without keys are never found this way.
+     */
+    SkTypeface* findByProcAndRef(FindProc proc, void* ctx, uint32_t keyHash) const;
+
     /**
      *  This will unref all of the typefaces in the cache for which the cache
      *  is the only owner. Normally this is handled automatically as needed.
@@ -62,10 +82,21 @@ public:
      */
     static SkFontID NewFontID();
 
+    /**
+     *  Helpers: hash lookup keys for the keyed add() and findByProcAndRef().
+     *  Callers must derive equal hashes for anything their FindProc treats as
+     *  equal.
+     */
+    static uint32_t HashKey(const void* data, size_t length, uint32_t seed = 0);
+    static uint32_t HashNameStyle(const char name[], const SkFontStyle&);
+
     // These are static wrappers around a global instance of a cache.
 
     static void Add(SkTypeface*, const SkFontStyle& requested);
+    static void Add(SkTypeface*, const SkFontStyle& requested,
+                    const uint32_t keyHashes[], int keyHashCount);
     static SkTypeface* FindByProcAndRef(FindProc proc, void* ctx);
+    static SkTypeface* FindByProcAndRef(FindProc proc, void* ctx, uint32_t keyHash);
     static void PurgeAll();
 
     /**
@@ -73,6 +104,11 @@ public:
      */
     static void Dump();
 
+    /**
+     *  Reports the global cache as "typeface". Typefaces have no known size, so fBytes is 0.
+     */
+    static void VisitStats(SkCacheStats::Visitor, void* context);
+
 private:
     static SkTypefaceCache& Get();
 
@@ -81,8 +117,22 @@ private:
     struct Rec {
         SkTypeface* fFace;
         SkFontStyle fRequestedStyle;
+        uint32_t    fKeyHashes[kMaxKeyHashes];
+        int         fKeyHashCount;
     };
-    SkTDArray<Rec> fArray;
+    // Every cached typeface, oldest first. Recs are heap allocated so that the
+    // index below can point at them.
+    SkTDArray<Rec*> fArray;
+    // Key hash -> the Recs added under it, oldest first.
+    SkTHashMap<uint32_t, SkTDArray<Rec*> > fIndex;
+
+    // Removes rec from the buckets of all its key hashes.
+    void unindex(Rec* rec);
+
+    // Lookups through FindByProcAndRef(), and typefaces dropped by purge().
+    uint64_t fHits;
+    uint64_t fMisses;
+    uint64_t fEvictions;
 };
 
 #endif
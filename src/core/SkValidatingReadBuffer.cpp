@@ -43,7 +43,7 @@ void SkValidatingReadBuffer::setMemory(const void* data, size_t size) {
 const void* SkValidatingReadBuffer::skip(size_t size) {
     size_t inc = SkAlign4(size);
     const void* addr = fReader.peek();
-    this->validate(IsPtrAlign4(addr) && fReader.isAvailable(inc));
+    this->validate(inc >= size && fReader.isAvailable(inc));
     if (!fError) {
         fReader.skip(size);
     }
@@ -54,6 +54,10 @@ const void* SkValidatingReadBuffer::skip(size_t size) {
 // followed by a memcpy. So we've got all our validation in readInt(), readScalar() and skip();
 // if they fail they'll return a zero value or skip nothing, respectively, and set fError to
 // true, which the caller should check to see if an error occurred during the read operation.
+//
+// setMemory() checks that the data starts and ends 4-byte aligned, and every read advances by a
+// multiple of 4, so the cursor stays aligned without being checked on each read. An error sends
+// the cursor to the end, so after one every bounds check fails and fError needn't be tested.
 
 bool SkValidatingReadBuffer::readBool() {
     uint32_t value = this->readInt();
@@ -71,15 +75,21 @@ SkFixed SkValidatingReadBuffer::readFixed() {
 }
 
 int32_t SkValidatingReadBuffer::readInt() {
-    const size_t inc = sizeof(int32_t);
-    this->validate(IsPtrAlign4(fReader.peek()) && fReader.isAvailable(inc));
-    return fError ? 0 : fReader.readInt();
+    SkASSERT(IsPtrAlign4(fReader.peek()));
+    if (fReader.isAvailable(sizeof(int32_t))) {
+        return fReader.readInt();
+    }
+    this->validate(false);
+    return 0;
 }
 
 SkScalar SkValidatingReadBuffer::readScalar() {
-    const size_t inc = sizeof(SkScalar);
-    this->validate(IsPtrAlign4(fReader.peek()) && fReader.isAvailable(inc));
-    return fError ? 0 : fReader.readScalar();
+    SkASSERT(IsPtrAlign4(fReader.peek()));
+    if (fReader.isAvailable(sizeof(SkScalar))) {
+        return fReader.readScalar();
+    }
+    this->validate(false);
+    return 0;
 }
 
 uint32_t SkValidatingReadBuffer::readUInt() {
@@ -120,8 +130,12 @@ void* SkValidatingReadBuffer::readEncodedString(size_t* length, SkPaint::TextEnc
 }
 
 void SkValidatingReadBuffer::readPoint(SkPoint* point) {
-    point->fX = this->readScalar();
-    point->fY = this->readScalar();
+    const void* ptr = this->skip(sizeof(SkPoint));
+    if (!fError) {
+        memcpy(point, ptr, sizeof(SkPoint));
+    } else {
+        point->set(0, 0);
+    }
 }
 
 void SkValidatingReadBuffer::readMatrix(SkMatrix* matrix) {
@@ -172,18 +186,16 @@ void SkValidatingReadBuffer::readPath(SkPath* path) {
 }
 
 bool SkValidatingReadBuffer::readArray(void* value, size_t size, size_t elementSize) {
-    const uint32_t count = this->getArrayCount();
-    this->validate(size == count);
-    (void)this->skip(sizeof(uint32_t)); // Skip array count
+    // The whole array is bounds-checked once, then copied in bulk.
+    const uint32_t count = this->readUInt();
     const uint64_t byteLength64 = sk_64_mul(count, elementSize);
     const size_t byteLength = count * elementSize;
-    this->validate(byteLength == byteLength64);
-    const void* ptr = this->skip(SkAlign4(byteLength));
-    if (!fError) {
-        memcpy(value, ptr, byteLength);
-        return true;
+    if (!this->validate(size == count && byteLength == byteLength64 &&
+                        fReader.isAvailable(SkAlign4(byteLength)))) {
+        return false;
     }
-    return false;
+    memcpy(value, fReader.skip(byteLength), byteLength);
+    return true;
 }
 
 bool SkValidatingReadBuffer::readByteArray(void* value, size_t size) {
@@ -208,7 +220,7 @@ bool SkValidatingReadBuffer::readScalarArray(SkScalar* values, size_t size) {
 
 uint32_t SkValidatingReadBuffer::getArrayCount() {
     const size_t inc = sizeof(uint32_t);
-    fError = fError || !IsPtrAlign4(fReader.peek()) || !fReader.isAvailable(inc);
+    fError = fError || !fReader.isAvailable(inc);
     return fError ? 0 : *(uint32_t*)fReader.peek();
 }
 
@@ -6,6 +6,7 @@
  */
 
 #include "SkVarAlloc.h"
+#include "SkSpinlock.h"
 
 // We use non-standard malloc diagnostic methods to make sure our allocations are sized well.
 #if defined(SK_BUILD_FOR_MAC)
@@ -14,18 +15,67 @@
     #include <malloc.h>
 #endif
 
+// Blocks are always a power of two in size, so freed ones are kept on one list per size, and
+// handed to the next SkVarAlloc that grows into that size: each recording grows through the same
+// sizes as the last one did. Only a few blocks of each of the smaller sizes are kept.
+SK_DECLARE_STATIC_SPINLOCK(gBlockCacheSpinlock);
+
 struct SkVarAlloc::Block {
     Block* prev;
+    unsigned lgSize;
     char* data() { return (char*)(this + 1); }
 
-    static Block* Alloc(Block* prev, size_t size, unsigned flags) {
-        SkASSERT(size >= sizeof(Block));
-        Block* b = (Block*)sk_malloc_flags(size, flags);
-        b->prev = prev;
-        return b;
-    }
+    static Block* Alloc(Block* prev, unsigned lgSize, unsigned flags);
+    static void Free(Block*);
+
+    enum {
+        kMaxCachedLgSize = 16,  // 64K
+        kMaxCachedBlocks = 4,   // of each size
+    };
+    // Guarded by gBlockCacheSpinlock.
+    static Block* gCached[kMaxCachedLgSize + 1];  // linked through prev
+    static int gCachedCount[kMaxCachedLgSize + 1];
 };
 
+SkVarAlloc::Block* SkVarAlloc::Block::gCached[];
+int SkVarAlloc::Block::gCachedCount[];
+
+SkVarAlloc::Block* SkVarAlloc::Block::Alloc(Block* prev, unsigned lgSize, unsigned flags) {
+    SkASSERT((1u << lgSize) >= sizeof(Block));
+    Block* b = NULL;
+    if (lgSize <= kMaxCachedLgSize) {
+        gBlockCacheSpinlock.acquire();
+        b = gCached[lgSize];
+        if (b) {
+            gCached[lgSize] = b->prev;
+            gCachedCount[lgSize]--;
+        }
+        gBlockCacheSpinlock.release();
+    }
+    if (NULL == b) {
+        b = (Block*)sk_malloc_flags((size_t)1 << lgSize, flags);
+        b->lgSize = lgSize;
+    }
+    SkASSERT(b->lgSize == lgSize);
+    b->prev = prev;
+    return b;
+}
+
+void SkVarAlloc::Block::Free(Block* b) {
+    const unsigned lgSize = b->lgSize;
+    if (lgSize <= kMaxCachedLgSize) {
+        gBlockCacheSpinlock.acquire();
+        if (gCachedCount[lgSize] < kMaxCachedBlocks) {
+            b->prev = gCached[lgSize];
+            gCached[lgSize] = b;
+            gCachedCount[lgSize]++;
+            b = NULL;
+        }
+        gBlockCacheSpinlock.release();
+    }
+    sk_free(b);
+}
+
 SkVarAlloc::SkVarAlloc(size_t minLgSize)
     : fBytesAllocated(0)
     , fByte(NULL)
@@ -41,10 +91,23 @@ SkVarAlloc::SkVarAlloc(size_t minLgSize, char* storage, size_t len)
     , fBlock(NULL) {}
 
 SkVarAlloc::~SkVarAlloc() {
+    this->freeBlocks();
+}
+
+void SkVarAlloc::reset(size_t minLgSize, char* storage, size_t len) {
+    this->freeBlocks();
+    fBytesAllocated = 0;
+    fByte = storage;
+    fRemaining = SkToU32(len);
+    fLgSize = SkToU32(minLgSize);
+    fBlock = NULL;
+}
+
+void SkVarAlloc::freeBlocks() {
     Block* b = fBlock;
     while (b) {
         Block* prev = b->prev;
-        sk_free(b);
+        Block::Free(b);
         b = prev;
     }
 }
@@ -52,12 +115,13 @@ SkVarAlloc::~SkVarAlloc() {
 void SkVarAlloc::makeSpace(size_t bytes, unsigned flags) {
     SkASSERT(SkIsAlignPtr(bytes));
 
-    size_t alloc = 1<<fLgSize++;
-    while (alloc < bytes + sizeof(Block)) {
-        alloc *= 2;
+    unsigned lgSize = fLgSize++;
+    while ((size_t)1 << lgSize < bytes + sizeof(Block)) {
+        lgSize++;
     }
+    size_t alloc = (size_t)1 << lgSize;
     fBytesAllocated += alloc;
-    fBlock = Block::Alloc(fBlock, alloc, flags);
+    fBlock = Block::Alloc(fBlock, lgSize, flags);
     fByte = fBlock->data();
     fRemaining = alloc - sizeof(Block);
 
@@ -19,6 +19,11 @@ public:
 
     ~SkVarAlloc();
 
+    // Frees all the blocks, and starts over as if just constructed with these arguments.  Freed
+    // blocks are kept for reuse, so an SkVarAlloc that's reset and grows the same way again
+    // mostly doesn't go back to malloc.
+    void reset(size_t minLgSize, char* storage, size_t len);
+
     // Returns contiguous bytes aligned at least for pointers.  You may pass SK_MALLOC_THROW, etc.
     char* alloc(size_t bytes, unsigned sk_malloc_flags) {
         bytes = SkAlignPtr(bytes);
@@ -40,6 +45,7 @@ public:
 
 private:
     void makeSpace(size_t bytes, unsigned flags);
+    void freeBlocks();
 
     size_t fBytesAllocated;
 
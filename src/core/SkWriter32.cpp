@@ -64,9 +64,20 @@ size_t SkWriter32::WriteStringSize(const char* str, size_t len) {
 }
 
 void SkWriter32::growToAtLeast(size_t size) {
+    this->setCapacity(4096 + SkTMax(size, fCapacity + (fCapacity / 2)));
+}
+
+void SkWriter32::reserveCapacity(size_t size) {
+    if (size > fCapacity) {
+        this->setCapacity(SkAlign4(size));
+    }
+}
+
+void SkWriter32::setCapacity(size_t capacity) {
+    SkASSERT(capacity >= fUsed);
     const bool wasExternal = (fExternal != NULL) && (fData == fExternal);
 
-    fCapacity = 4096 + SkTMax(size, fCapacity + (fCapacity / 2));
+    fCapacity = capacity;
     fInternal.realloc(fCapacity);
     fData = fInternal.get();
 
@@ -79,3 +90,14 @@ void SkWriter32::growToAtLeast(size_t size) {
 SkData* SkWriter32::snapshotAsData() const {
     return SkData::NewWithCopy(fData, fUsed);
 }
+
+SkData* SkWriter32::detachAsData() {
+    SkData* data;
+    if (fData && fData == fInternal.get()) {
+        data = SkData::NewFromMalloc(fInternal.detach(), fUsed);
+    } else {
+        data = SkData::NewWithCopy(fData, fUsed);
+    }
+    this->reset();
+    return data;
+}
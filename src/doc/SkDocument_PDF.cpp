@@ -12,6 +12,7 @@
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
 
 static void emit_pdf_header(SkWStream* stream) {
     stream->writeText("%PDF-1.4\n%");
@@ -40,15 +41,67 @@ static void emit_pdf_footer(SkWStream* stream,
     stream->writeText("\n%%EOF");
 }
 
-static void perform_font_subsetting(
-        const SkTDArray<const SkPDFDevice*>& pageDevices,
-        SkPDFSubstituteMap* substituteMap) {
-    SkASSERT(substituteMap);
+// Writes the indirect objects numbered objNums, in that order, setting
+// offsets[i] to the offset of objNums[i].  Most of the time goes to Flate
+// compressing content and image streams, and each object serializes
+// independently of the others.  So we serialize a batch of objects in
+// parallel into memory, then write the batch out in order.
+static void emit_indirect_objects(SkWStream* stream,
+                                  size_t baseOffset,
+                                  const SkTDArray<int32_t>& objNums,
+                                  const SkPDFObjNumMap& objNumMap,
+                                  const SkPDFSubstituteMap& substitutes,
+                                  int32_t offsets[]) {
+    // Bounds how many serialized objects are held in memory at once.
+    const int batchSize = 4 * sk_num_cores();
+    SkAutoTArray<SkDynamicMemoryWStream> buffers(batchSize);
+    for (int start = 0; start < objNums.count(); start += batchSize) {
+        const int count = SkTMin(batchSize, objNums.count() - start);
+        sk_parallel_for(count, [&](int i) {
+            const int32_t objNum = objNums[start + i];
+            SkPDFObject* object = objNumMap.objects()[objNum - 1];
+            SkASSERT(object);
+            SkASSERT(object == substitutes.getSubstitute(object));
+            SkASSERT(objNumMap.getObjectNumber(object) == objNum);
+            SkDynamicMemoryWStream* buffer = &buffers[i];
+            buffer->writeDecAsText(objNum);
+            buffer->writeText(" 0 obj\n");  // Generation number is always 0.
+            object->emitObject(buffer, objNumMap, substitutes);
+            buffer->writeText("\nendobj\n");
+        });
+        for (int i = 0; i < count; i++) {
+            offsets[start + i] = SkToS32(stream->bytesWritten() - baseOffset);
+            buffers[i].writeToStream(stream);
+            buffers[i].reset();
+        }
+    }
+}
 
-    SkPDFGlyphSetMap usage;
-    for (int i = 0; i < pageDevices.count(); ++i) {
-        usage.merge(pageDevices[i]->getFontGlyphUsage());
+// Writes the cross reference table for objects 1 through offsets.count(),
+// returning its offset.
+static int32_t emit_xref_table(SkWStream* stream,
+                               size_t baseOffset,
+                               const SkTDArray<int32_t>& offsets) {
+    int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - baseOffset);
+
+    // Include the zeroth object in the count.
+    int32_t objCount = SkToS32(offsets.count() + 1);
+
+    stream->writeText("xref\n0 ");
+    stream->writeDecAsText(objCount);
+    stream->writeText("\n0000000000 65535 f \n");
+    for (int i = 0; i < offsets.count(); i++) {
+        SkASSERT(offsets[i] > 0);
+        stream->writeBigDecAsText(offsets[i], 10);
+        stream->writeText(" 00000 n \n");
     }
+    return xRefFileOffset;
+}
+
+static void perform_font_subsetting(const SkPDFGlyphSetMap& usage,
+                                    SkPDFSubstituteMap* substituteMap) {
+    SkASSERT(substituteMap);
+
     SkPDFGlyphSetMap::F2BIter iterator(usage);
     const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next();
     while (entry) {
@@ -194,8 +247,12 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     */
 
     // Build font subsetting info before proceeding.
+    SkPDFGlyphSetMap usage;
+    for (int i = 0; i < pageDevices.count(); ++i) {
+        usage.merge(pageDevices[i]->getFontGlyphUsage());
+    }
     SkPDFSubstituteMap substitutes;
-    perform_font_subsetting(pageDevices, &substitutes);
+    perform_font_subsetting(usage, &substitutes);
 
     SkPDFObjNumMap objNumMap;
     if (objNumMap.addObject(docCatalog.get())) {
@@ -203,30 +260,18 @@ static bool emit_pdf_document(const SkTDArray<const SkPDFDevice*>& pageDevices,
     }
     size_t baseOffset = SkToOffT(stream->bytesWritten());
     emit_pdf_header(stream);
-    SkTDArray<int32_t> offsets;
+    SkTDArray<int32_t> objNums;
     for (int i = 0; i < objNumMap.objects().count(); ++i) {
-        SkPDFObject* object = objNumMap.objects()[i];
-        offsets.push(SkToS32(stream->bytesWritten() - baseOffset));
-        SkASSERT(object == substitutes.getSubstitute(object));
-        SkASSERT(objNumMap.getObjectNumber(object) == i + 1);
-        stream->writeDecAsText(i + 1);
-        stream->writeText(" 0 obj\n");  // Generation number is always 0.
-        object->emitObject(stream, objNumMap, substitutes);
-        stream->writeText("\nendobj\n");
+        objNums.push(i + 1);
     }
-    int32_t xRefFileOffset = SkToS32(stream->bytesWritten() - baseOffset);
+    SkTDArray<int32_t> offsets;
+    offsets.setCount(objNums.count());
+    emit_indirect_objects(stream, baseOffset, objNums, objNumMap, substitutes,
+                          offsets.begin());
+    int32_t xRefFileOffset = emit_xref_table(stream, baseOffset, offsets);
 
     // Include the zeroth object in the count.
     int32_t objCount = SkToS32(offsets.count() + 1);
-
-    stream->writeText("xref\n0 ");
-    stream->writeDecAsText(objCount);
-    stream->writeText("\n0000000000 65535 f \n");
-    for (int i = 0; i < offsets.count(); i++) {
-        SkASSERT(offsets[i] > 0);
-        stream->writeBigDecAsText(offsets[i], 10);
-        stream->writeText(" 00000 n \n");
-    }
     emit_pdf_footer(stream, objNumMap, substitutes, docCatalog.get(), objCount,
                     xRefFileOffset);
 
@@ -337,6 +382,205 @@ private:
     SkAutoTUnref<SkCanvas> fCanvas;
     SkScalar fRasterDpi;
 };
+
+/**
+ *  Writes each page, along with the objects only it uses, when the page ends,
+ *  so that memory use stays near that of a single page.  Objects shared
+ *  through the SkPDFCanon are written the first time a page uses them, and
+ *  then stay in memory only as long as the canon holds them.  Fonts are held
+ *  back until close(), when the glyphs used by every page are known and they
+ *  can be subset.  The page tree is a single node holding all pages.
+ */
+class SkDocument_StreamingPDF : public SkDocument {
+public:
+    SkDocument_StreamingPDF(SkWStream* stream,
+                            void (*doneProc)(SkWStream*, bool),
+                            SkScalar rasterDpi)
+        : SkDocument(stream, doneProc)
+        , fPageTreeRoot(SkNEW_ARGS(SkPDFDict, ("Pages")))
+        , fDests(SkNEW(SkPDFDict))
+        , fBaseOffset(0)
+        , fRasterDpi(rasterDpi) {}
+
+    virtual ~SkDocument_StreamingPDF() {
+        // subclasses must call close() in their destructors
+        this->close();
+    }
+
+protected:
+    SkCanvas* onBeginPage(SkScalar width, SkScalar height,
+                          const SkRect& trimBox) override {
+        SkASSERT(!fCanvas.get());
+        SkASSERT(!fPageDevice.get());
+
+        SkISize pageSize = SkISize::Make(
+                SkScalarRoundToInt(width), SkScalarRoundToInt(height));
+        fPageDevice.reset(SkPDFDevice::Create(pageSize, fRasterDpi, &fCanon));
+        fCanvas.reset(SkNEW_ARGS(SkCanvas, (fPageDevice.get())));
+        fCanvas->clipRect(trimBox);
+        fCanvas->translate(trimBox.x(), trimBox.y());
+        return fCanvas.get();
+    }
+
+    void onEndPage() override {
+        SkASSERT(fCanvas.get());
+        fCanvas->flush();
+        fCanvas.reset(NULL);
+        this->emitPage(this->getStream());
+    }
+
+    bool onClose(SkWStream* stream) override {
+        SkASSERT(!fCanvas.get());
+
+        bool success = !fPages.isEmpty();
+        if (success) {
+            this->emitRemainder(stream);
+        }
+        this->reset();
+        return success;
+    }
+
+    void onAbort() override {
+        fCanvas.reset(NULL);
+        fPageDevice.reset(NULL);
+        this->reset();
+    }
+
+private:
+    // Marks objects that have a number but have not been written yet.
+    static const int32_t kUnwritten = -1;
+
+    void emitPage(SkWStream* stream) {
+        SkASSERT(fOffsets.count() == fObjNumMap.objects().count());
+        if (fPages.isEmpty()) {
+            fBaseOffset = SkToOffT(stream->bytesWritten());
+            emit_pdf_header(stream);
+            // The page tree root is written last, once it knows every page.
+            fObjNumMap.addObject(fPageTreeRoot.get());
+            fOffsets.push(kUnwritten);
+        }
+
+        // Number the fonts before walking the page, so that the walk
+        // doesn't descend into them.  They are written by emitRemainder().
+        fGlyphUsage.merge(fPageDevice->getFontGlyphUsage());
+        SkPDFGlyphSetMap::F2BIter iterator(fGlyphUsage);
+        while (const SkPDFGlyphSetMap::FontGlyphSetPair* entry = iterator.next()) {
+            if (fObjNumMap.addObject(entry->fFont)) {
+                fFonts.push(entry->fFont);
+                fOffsets.push(kUnwritten);
+            }
+        }
+
+        SkAutoTUnref<SkPDFDict> page(create_pdf_page(fPageDevice.get()));
+        page->insertObjRef("Parent", SkRef(fPageTreeRoot.get()));
+        fPageDevice->appendDestinations(fDests, page.get());
+
+        // Nothing is substituted until the fonts are subset.
+        SkPDFSubstituteMap noSubstitutes;
+        if (fObjNumMap.addObject(page.get())) {
+            page->addResources(&fObjNumMap, noSubstitutes);
+        }
+
+        // Hold a ref to everything written, to see below what outlives the page.
+        SkTDArray<SkPDFObject*> written;
+        const SkTDArray<SkPDFObject*>& objects = fObjNumMap.objects();
+        SkTDArray<int32_t> objNums;
+        for (int i = fOffsets.count(); i < objects.count(); i++) {
+            objNums.push(i + 1);
+            written.push(SkRef(objects[i]));
+        }
+        fOffsets.append(objNums.count());
+        emit_indirect_objects(stream, fBaseOffset, objNums, fObjNumMap, noSubstitutes,
+                              fOffsets.end() - objNums.count());
+
+        // The page dictionary stays behind, empty, as the target of the
+        // page tree and of any named destinations.
+        page->clear();
+        fPages.push(page.detach());
+        fPageDevice.reset(NULL);
+
+        // Anything no one else holds was used only by this page, and is
+        // deleted now.  Its address may be reused, so forget it.
+        for (int i = 0; i < written.count(); i++) {
+            if (written[i]->unique()) {
+                fObjNumMap.removeObject(written[i]);
+            }
+        }
+        written.unrefAll();
+    }
+
+    void emitRemainder(SkWStream* stream) {
+        SkPDFSubstituteMap substitutes;
+        perform_font_subsetting(fGlyphUsage, &substitutes);
+        for (int i = 0; i < fFonts.count(); i++) {
+            SkPDFObject* font = substitutes.getSubstitute(fFonts[i]);
+            if (font != fFonts[i]) {
+                fObjNumMap.replaceObject(fFonts[i], font);
+            }
+            font->addResources(&fObjNumMap, substitutes);
+        }
+
+        SkAutoTUnref<SkPDFArray> kids(SkNEW(SkPDFArray));
+        kids->reserve(fPages.count());
+        for (int i = 0; i < fPages.count(); i++) {
+            kids->appendObjRef(SkRef(fPages[i]));
+        }
+        fPageTreeRoot->insertInt("Count", fPages.count());
+        fPageTreeRoot->insertObject("Kids", kids.detach());
+
+        SkAutoTUnref<SkPDFDict> docCatalog(SkNEW_ARGS(SkPDFDict, ("Catalog")));
+        docCatalog->insertObjRef("Pages", SkRef(fPageTreeRoot.get()));
+        if (fDests->size() > 0) {
+            docCatalog->insertObjRef("Dests", SkRef(fDests.get()));
+        }
+        if (fObjNumMap.addObject(docCatalog.get())) {
+            docCatalog->addResources(&fObjNumMap, substitutes);
+        }
+
+        const SkTDArray<SkPDFObject*>& objects = fObjNumMap.objects();
+        while (fOffsets.count() < objects.count()) {
+            fOffsets.push(kUnwritten);
+        }
+        SkTDArray<int32_t> objNums;
+        for (int i = 0; i < objects.count(); i++) {
+            if (kUnwritten == fOffsets[i]) {
+                objNums.push(i + 1);
+            }
+        }
+        SkTDArray<int32_t> offsets;
+        offsets.setCount(objNums.count());
+        emit_indirect_objects(stream, fBaseOffset, objNums, fObjNumMap, substitutes,
+                              offsets.begin());
+        for (int i = 0; i < objNums.count(); i++) {
+            fOffsets[objNums[i] - 1] = offsets[i];
+        }
+        int32_t xRefFileOffset = emit_xref_table(stream, fBaseOffset, fOffsets);
+        emit_pdf_footer(stream, fObjNumMap, substitutes, docCatalog.get(),
+                        fOffsets.count() + 1, xRefFileOffset);
+    }
+
+    void reset() {
+        // The page tree has both child and parent pointers, so it creates a
+        // reference cycle.  We must clear that cycle to properly reclaim memory.
+        fPageTreeRoot->clear();
+        fDests->clear();
+        fPages.unrefAll();
+        fCanon.reset();
+    }
+
+    SkPDFCanon fCanon;
+    SkPDFObjNumMap fObjNumMap;
+    SkTDArray<int32_t> fOffsets;  // Indexed by object number - 1.
+    SkPDFGlyphSetMap fGlyphUsage;
+    SkTDArray<SkPDFFont*> fFonts;
+    SkTDArray<SkPDFDict*> fPages;
+    SkAutoTUnref<SkPDFDict> fPageTreeRoot;
+    SkAutoTUnref<SkPDFDict> fDests;
+    SkAutoTUnref<SkPDFDevice> fPageDevice;
+    SkAutoTUnref<SkCanvas> fCanvas;
+    size_t fBaseOffset;
+    SkScalar fRasterDpi;
+};
 }  // namespace
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -353,3 +597,7 @@ SkDocument* SkDocument::CreatePDF(const char path[], SkScalar dpi) {
     auto delete_wstream = [](SkWStream* stream, bool) { SkDELETE(stream); };
     return SkNEW_ARGS(SkDocument_PDF, (stream, delete_wstream, dpi));
 }
+
+SkDocument* SkDocument::CreateStreamingPDF(SkWStream* stream, SkScalar dpi) {
+    return stream ? SkNEW_ARGS(SkDocument_StreamingPDF, (stream, NULL, dpi)) : NULL;
+}
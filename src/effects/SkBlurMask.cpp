@@ -9,6 +9,7 @@
 
 #include "SkBlurMask.h"
 #include "SkMath.h"
+#include "SkOpts.h"
 #include "SkTemplates.h"
 #include "SkEndian.h"
 
@@ -33,10 +34,8 @@ SkScalar SkBlurMask::ConvertSigmaToRadius(SkScalar sigma) {
 #define UNROLL_SEPARABLE_LOOPS
 
 /**
- * This function performs a box blur in X, of the given radius.  If the
- * "transpose" parameter is true, it will transpose the pixels on write,
- * such that X and Y are swapped. Reads are always performed from contiguous
- * memory in X, for speed. The destination buffer (dst) must be at least
+ * This function performs a box blur in X, of the given radius. The
+ * destination buffer (dst) must be at least
  * (width + leftRadius + rightRadius) * height bytes in size.
  *
  * This is what the inner loop looks like before unrolling, and with the two
@@ -77,16 +76,15 @@ SkScalar SkBlurMask::ConvertSigmaToRadius(SkScalar sigma) {
  *      }
  */
 static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
-                   int leftRadius, int rightRadius, int width, int height,
-                   bool transpose)
+                   int leftRadius, int rightRadius, int width, int height)
 {
     int diameter = leftRadius + rightRadius;
     int kernelSize = diameter + 1;
     int border = SkMin32(width, diameter);
     uint32_t scale = (1 << 24) / kernelSize;
     int new_width = width + SkMax32(leftRadius, rightRadius) * 2;
-    int dst_x_stride = transpose ? height : 1;
-    int dst_y_stride = transpose ? 1 : new_width;
+    const int dst_x_stride = 1;
+    const int dst_y_stride = new_width;
     uint32_t half = 1 << 23;
     for (int y = 0; y < height; ++y) {
         uint32_t sum = 0;
@@ -279,8 +277,7 @@ static int boxBlur(const uint8_t* src, int src_y_stride, uint8_t* dst,
  */
 
 static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
-                         int radius, int width, int height,
-                         bool transpose, uint8_t outer_weight)
+                         int radius, int width, int height, uint8_t outer_weight)
 {
     int diameter = radius * 2;
     int kernelSize = diameter + 1;
@@ -292,8 +289,8 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
     uint32_t half = 1 << 23;
     int new_width = width + diameter;
-    int dst_x_stride = transpose ? height : 1;
-    int dst_y_stride = transpose ? 1 : new_width;
+    const int dst_x_stride = 1;
+    const int dst_y_stride = new_width;
     for (int y = 0; y < height; ++y) {
         uint32_t outer_sum = 0, inner_sum = 0;
         uint8_t* dptr = dst + y * dst_y_stride;
@@ -406,6 +403,80 @@ static int boxBlurInterp(const uint8_t* src, int src_y_stride, uint8_t* dst,
     return new_width;
 }
 
+// Columns are blurred in strips this wide, keeping the running sums and the rows they touch in
+// cache.
+static const int kBlurStripWidth = 512;
+
+/**
+ * The Y counterparts of boxBlur() and boxBlurInterp(), with the same results as running them on
+ * the transposed mask. Rather than transposing, they slide the window down strips of columns,
+ * stepping every column in a row at once with SkOpts::blur_mask_row(). The destination has rows
+ * of width bytes.
+ */
+static int boxBlurY(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                    int leftRadius, int rightRadius, int width, int height)
+{
+    int diameter = leftRadius + rightRadius;
+    uint32_t scale = (1 << 24) / (diameter + 1);
+    int new_height = height + SkMax32(leftRadius, rightRadius) * 2;
+    int top = SkMax32(rightRadius - leftRadius, 0);
+    int bottom = SkMax32(leftRadius - rightRadius, 0);
+
+    SkAutoTMalloc<uint32_t> sums(kBlurStripWidth);
+    SkAutoTMalloc<uint8_t> zeros(kBlurStripWidth);
+    sk_bzero(zeros.get(), kBlurStripWidth);
+
+    sk_bzero(dst, top * width);
+    uint8_t* dptr = dst + top * width;
+    for (int x = 0; x < width; x += kBlurStripWidth) {
+        int count = SkMin32(width - x, kBlurStripWidth);
+        sk_bzero(sums.get(), count * sizeof(uint32_t));
+        for (int y = 0; y < height + diameter; ++y) {
+            const uint8_t* add = y < height ? src + y * src_y_stride + x : zeros.get();
+            const uint8_t* sub = y >= diameter ? src + (y - diameter) * src_y_stride + x
+                                               : zeros.get();
+            SkOpts::blur_mask_row(dptr + y * width + x, sums.get(), add, sub, scale, count);
+        }
+    }
+    sk_bzero(dptr + (height + diameter) * width, bottom * width);
+    return new_height;
+}
+
+static int boxBlurInterpY(const uint8_t* src, int src_y_stride, uint8_t* dst,
+                          int radius, int width, int height, uint8_t outer_weight)
+{
+    int diameter = radius * 2;
+    int kernelSize = diameter + 1;
+    int inner_weight = 255 - outer_weight;
+    outer_weight += outer_weight >> 7;
+    inner_weight += inner_weight >> 7;
+    uint32_t outer_scale = (outer_weight << 16) / kernelSize;
+    uint32_t inner_scale = (inner_weight << 16) / (kernelSize - 2);
+
+    SkAutoTMalloc<uint32_t> sums(kBlurStripWidth);
+    SkAutoTMalloc<uint8_t> zeros(kBlurStripWidth);
+    sk_bzero(zeros.get(), kBlurStripWidth);
+
+    for (int x = 0; x < width; x += kBlurStripWidth) {
+        int count = SkMin32(width - x, kBlurStripWidth);
+        sk_bzero(sums.get(), count * sizeof(uint32_t));
+        for (int y = 0; y < height + diameter; ++y) {
+            const uint8_t* add = y < height ? src + y * src_y_stride + x : zeros.get();
+            const uint8_t* sub = y >= diameter ? src + (y - diameter) * src_y_stride + x
+                                               : zeros.get();
+            // Past the end of a mask shorter than the kernel, boxBlurInterp() keeps the inner
+            // sum it had before adding the last row.
+            const uint8_t* inner = sub;
+            if (y >= height && y < diameter) {
+                inner = src + (height - 1) * src_y_stride + x;
+            }
+            SkOpts::blur_mask_interp_row(dst + y * width + x, sums.get(), add, sub, inner,
+                                         outer_scale, inner_scale, count);
+        }
+    }
+    return height + diameter;
+}
+
 static void get_adjusted_radii(SkScalar passRadius, int *loRadius, int *hiRadius)
 {
     *loRadius = *hiRadius = SkScalarCeilToInt(passRadius);
@@ -553,31 +624,31 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src,
             int loRadius, hiRadius;
             get_adjusted_radii(passRadius, &loRadius, &hiRadius);
             if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h, false);
-                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h, false);
-                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h, true);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlur(tp, h,             dp, loRadius, hiRadius, h, w, false);
-                h = boxBlur(dp, h,             tp, hiRadius, loRadius, h, w, false);
-                h = boxBlur(tp, h,             dp, hiRadius, hiRadius, h, w, true);
+                // Do three X blurs.
+                w = boxBlur(sp, src.fRowBytes, tp, loRadius, hiRadius, w, h);
+                w = boxBlur(tp, w,             dp, hiRadius, loRadius, w, h);
+                w = boxBlur(dp, w,             tp, hiRadius, hiRadius, w, h);
+                // Do three Y blurs.
+                h = boxBlurY(tp, w,            dp, loRadius, hiRadius, w, h);
+                h = boxBlurY(dp, w,            tp, hiRadius, loRadius, w, h);
+                h = boxBlurY(tp, w,            dp, hiRadius, hiRadius, w, h);
             } else {
-                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h, true);
-                h = boxBlur(tp, h,             dp, ry, ry, h, w, true);
+                w = boxBlur(sp, src.fRowBytes, tp, rx, rx, w, h);
+                h = boxBlurY(tp, w,            dp, ry, ry, w, h);
             }
         } else {
             if (kHigh_SkBlurQuality == quality) {
-                // Do three X blurs, with a transpose on the final one.
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(tp, w,             dp, rx, w, h, false, outerWeight);
-                w = boxBlurInterp(dp, w,             tp, rx, w, h, true, outerWeight);
-                // Do three Y blurs, with a transpose on the final one.
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(dp, h,             tp, ry, h, w, false, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                // Do three X blurs.
+                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, outerWeight);
+                w = boxBlurInterp(tp, w,             dp, rx, w, h, outerWeight);
+                w = boxBlurInterp(dp, w,             tp, rx, w, h, outerWeight);
+                // Do three Y blurs.
+                h = boxBlurInterpY(tp, w,            dp, ry, w, h, outerWeight);
+                h = boxBlurInterpY(dp, w,            tp, ry, w, h, outerWeight);
+                h = boxBlurInterpY(tp, w,            dp, ry, w, h, outerWeight);
             } else {
-                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, true, outerWeight);
-                h = boxBlurInterp(tp, h,             dp, ry, h, w, true, outerWeight);
+                w = boxBlurInterp(sp, src.fRowBytes, tp, rx, w, h, outerWeight);
+                h = boxBlurInterpY(tp, w,            dp, ry, w, h, outerWeight);
             }
         }
 
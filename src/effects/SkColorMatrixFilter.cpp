@@ -8,7 +8,7 @@
 #include "SkColorMatrixFilter.h"
 #include "SkColorMatrix.h"
 #include "SkColorPriv.h"
-#include "SkPMFloat.h"
+#include "SkOpts.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkUnPreMultiply.h"
@@ -239,27 +239,6 @@ uint32_t SkColorMatrixFilter::getFlags() const {
     return this->INHERITED::getFlags() | fFlags;
 }
 
-static Sk4f premul(const Sk4f& x) {
-    float scale = SkPMFloat(x).a();
-    Sk4f pm = x * SkPMFloat(1, scale, scale, scale);
-
-#ifdef SK_DEBUG
-    SkPMFloat pmf(pm);
-    SkASSERT(pmf.isValid());
-#endif
-
-    return pm;
-}
-
-static Sk4f unpremul(const SkPMFloat& pm) {
-    float scale = 1 / pm.a(); // candidate for fast/approx invert?
-    return pm * SkPMFloat(1, scale, scale, scale);
-}
-
-static Sk4f clamp_0_1(const Sk4f& value) {
-    return Sk4f::Max(Sk4f::Min(value, Sk4f(1)), Sk4f(0));
-}
-
 void SkColorMatrixFilter::filterSpan(const SkPMColor src[], int count, SkPMColor dst[]) const {
     Proc proc = fProc;
     if (NULL == proc) {
@@ -276,41 +255,7 @@ void SkColorMatrixFilter::filterSpan(const SkPMColor src[], int count, SkPMColor
 #endif
 
     if (use_floats) {
-        // c0-c3 are already in [0,1].
-        const Sk4f c0 = Sk4f::Load(fTranspose + 0);
-        const Sk4f c1 = Sk4f::Load(fTranspose + 4);
-        const Sk4f c2 = Sk4f::Load(fTranspose + 8);
-        const Sk4f c3 = Sk4f::Load(fTranspose + 12);
-        // c4 (the translate vector) is in [0, 255].  Bring it back to [0,1].
-        const Sk4f c4 = Sk4f::Load(fTranspose + 16)*Sk4f(1.0f/255);
-
-        // todo: we could cache this in the constructor...
-        SkPMColor matrix_translate_pmcolor = SkPMFloat(premul(clamp_0_1(c4))).round();
-
-        for (int i = 0; i < count; i++) {
-            const SkPMColor src_c = src[i];
-            if (0 == src_c) {
-                dst[i] = matrix_translate_pmcolor;
-                continue;
-            }
-
-            SkPMFloat srcf(src_c);
-
-            if (0xFF != SkGetPackedA32(src_c)) {
-                srcf = unpremul(srcf);
-            }
-
-            Sk4f r4 = Sk4f(srcf.r());
-            Sk4f g4 = Sk4f(srcf.g());
-            Sk4f b4 = Sk4f(srcf.b());
-            Sk4f a4 = Sk4f(srcf.a());
-
-            // apply matrix
-            Sk4f dst4 = c0 * r4 + c1 * g4 + c2 * b4 + c3 * a4 + c4;
-
-            // clamp, re-premul, and write
-            dst[i] = SkPMFloat(premul(clamp_0_1(dst4))).round();
-        }
+        SkOpts::color_matrix_filter_span(fTranspose, src, count, dst);
     } else {
         const State& state = fState;
         int32_t result[4];
@@ -22,6 +22,9 @@ namespace SkGpuBlurUtils {
 #if SK_SUPPORT_GPU
 
 #define MAX_BLUR_SIGMA 4.0f
+// Unbounded passes fetch texel pairs bilinearly (GrConvolutionEffect::CreateGaussianLinear), so
+// they reach twice the radius for the same cost, and large blurs need one less halving.
+#define MAX_LINEAR_BLUR_SIGMA 8.0f
 
 static void scale_rect(SkRect* rect, float xScale, float yScale) {
     rect->fLeft   = SkScalarMul(rect->fLeft,   xScale);
@@ -30,18 +33,20 @@ static void scale_rect(SkRect* rect, float xScale, float yScale) {
     rect->fBottom = SkScalarMul(rect->fBottom, yScale);
 }
 
-static float adjust_sigma(float sigma, int maxTextureSize, int *scaleFactor, int *radius) {
+static float adjust_sigma(float sigma, float maxSigma, int maxTextureSize, int *scaleFactor,
+                          int *radius) {
     *scaleFactor = 1;
-    while (sigma > MAX_BLUR_SIGMA) {
+    while (sigma > maxSigma) {
         *scaleFactor *= 2;
         sigma *= 0.5f;
         if (*scaleFactor > maxTextureSize) {
             *scaleFactor = maxTextureSize;
-            sigma = MAX_BLUR_SIGMA;
+            sigma = maxSigma;
         }
     }
     *radius = static_cast<int>(ceilf(sigma * 3.0f));
-    SkASSERT(*radius <= GrConvolutionEffect::kMaxKernelRadius);
+    SkASSERT(*radius <= (maxSigma > MAX_BLUR_SIGMA ? GrConvolutionEffect::kMaxLinearKernelRadius
+                                                   : GrConvolutionEffect::kMaxKernelRadius));
     return sigma;
 }
 
@@ -57,8 +62,14 @@ static void convolve_gaussian_1d(GrDrawContext* drawContext,
                                  bool useBounds,
                                  float bounds[2]) {
     GrPaint paint;
-    SkAutoTUnref<GrFragmentProcessor> conv(GrConvolutionEffect::CreateGaussian(
-        paint.getProcessorDataManager(), texture, direction, radius, sigma, useBounds, bounds));
+    SkAutoTUnref<GrFragmentProcessor> conv;
+    if (useBounds) {
+        conv.reset(GrConvolutionEffect::CreateGaussian(paint.getProcessorDataManager(), texture,
+                                                       direction, radius, sigma, true, bounds));
+    } else {
+        conv.reset(GrConvolutionEffect::CreateGaussianLinear(paint.getProcessorDataManager(),
+                                                             texture, direction, radius, sigma));
+    }
     paint.addColorProcessor(conv);
     drawContext->drawNonAARectToRect(rt, clip, paint, SkMatrix::I(), dstRect, srcRect);
 }
@@ -157,8 +168,10 @@ GrTexture* GaussianBlur(GrContext* context,
     int scaleFactorX, radiusX;
     int scaleFactorY, radiusY;
     int maxTextureSize = context->caps()->maxTextureSize();
-    sigmaX = adjust_sigma(sigmaX, maxTextureSize, &scaleFactorX, &radiusX);
-    sigmaY = adjust_sigma(sigmaY, maxTextureSize, &scaleFactorY, &radiusY);
+    // Cropped blurs bound their margin passes texel by texel, so they keep the shorter kernel.
+    const float maxSigma = cropToRect ? MAX_BLUR_SIGMA : MAX_LINEAR_BLUR_SIGMA;
+    sigmaX = adjust_sigma(sigmaX, maxSigma, maxTextureSize, &scaleFactorX, &radiusX);
+    sigmaY = adjust_sigma(sigmaY, maxSigma, maxTextureSize, &scaleFactorY, &radiusY);
 
     SkRect srcRect(rect);
     scale_rect(&srcRect, 1.0f / scaleFactorX, 1.0f / scaleFactorY);
@@ -8,8 +8,10 @@
 #include "SkLightingImageFilter.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkNx.h"
 #include "SkPoint3.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkTypes.h"
 #include "SkWriteBuffer.h"
 
@@ -69,6 +71,14 @@ static inline void fast_normalize(SkPoint3* vector) {
     vector->fZ *= scale;
 }
 
+// Scales lightColor and rounds each component to an int in [0, 255], like
+// SkClampMax(SkScalarRoundToInt(c), 255). rgb[3] is unused.
+static inline void scale_light_color(const SkPoint3& lightColor, SkScalar scale, int rgb[4]) {
+    Sk4f color = Sk4f(lightColor.fX, lightColor.fY, lightColor.fZ, 0) * Sk4f(scale);
+    color = Sk4f::Min(Sk4f::Max(color, Sk4f(0)), Sk4f(255)) + Sk4f(0.5f);
+    color.castTrunc().store(rgb);
+}
+
 class DiffuseLightingType {
 public:
     DiffuseLightingType(SkScalar kd)
@@ -77,20 +87,14 @@ public:
                     const SkPoint3& lightColor) const {
         SkScalar colorScale = SkScalarMul(fKD, normal.dot(surfaceTolight));
         colorScale = SkScalarClampMax(colorScale, SK_Scalar1);
-        SkPoint3 color = lightColor.makeScale(colorScale);
-        return SkPackARGB32(255,
-                            SkClampMax(SkScalarRoundToInt(color.fX), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fY), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fZ), 255));
+        int rgb[4];
+        scale_light_color(lightColor, colorScale, rgb);
+        return SkPackARGB32(255, rgb[0], rgb[1], rgb[2]);
     }
 private:
     SkScalar fKD;
 };
 
-static SkScalar max_component(const SkPoint3& p) {
-    return p.x() > p.y() ? (p.x() > p.z() ? p.x() : p.z()) : (p.y() > p.z() ? p.y() : p.z());
-}
-
 class SpecularLightingType {
 public:
     SpecularLightingType(SkScalar ks, SkScalar shininess)
@@ -103,11 +107,10 @@ public:
         SkScalar colorScale = SkScalarMul(fKS,
             SkScalarPow(normal.dot(halfDir), fShininess));
         colorScale = SkScalarClampMax(colorScale, SK_Scalar1);
-        SkPoint3 color = lightColor.makeScale(colorScale);
-        return SkPackARGB32(SkClampMax(SkScalarRoundToInt(max_component(color)), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fX), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fY), 255),
-                            SkClampMax(SkScalarRoundToInt(color.fZ), 255));
+        int rgb[4];
+        scale_light_color(lightColor, colorScale, rgb);
+        // Rounding and clamping are monotonic, so this is the rounded max component.
+        return SkPackARGB32(SkTMax(rgb[0], SkTMax(rgb[1], rgb[2])), rgb[0], rgb[1], rgb[2]);
     }
 private:
     SkScalar fKS;
@@ -181,6 +184,9 @@ inline SkPoint3 bottomRightNormal(int m[9], SkScalar surfaceScale) {
                          surfaceScale);
 }
 
+static const int kMinRowsPerBand = 64;
+static const int kMaxBands = 16;
+
 template <class LightingType, class LightType> void lightBitmap(
         const LightingType& lightingType, const SkLight* light, const SkBitmap& src, SkBitmap* dst,
         SkScalar surfaceScale, const SkIRect& bounds) {
@@ -217,35 +223,47 @@ template <class LightingType, class LightType> void lightBitmap(
                                      l->lightColor(surfaceToLight));
     }
 
-    for (++y; y < bottom - 1; ++y) {
-        int x = left;
-        const SkPMColor* row0 = src.getAddr32(x, y - 1);
-        const SkPMColor* row1 = src.getAddr32(x, y);
-        const SkPMColor* row2 = src.getAddr32(x, y + 1);
-        int m[9];
-        m[1] = SkGetPackedA32(*row0++);
-        m[2] = SkGetPackedA32(*row0++);
-        m[4] = SkGetPackedA32(*row1++);
-        m[5] = SkGetPackedA32(*row1++);
-        m[7] = SkGetPackedA32(*row2++);
-        m[8] = SkGetPackedA32(*row2++);
-        SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-        for (++x; x < right - 1; ++x) {
-            shiftMatrixLeft(m);
+    // The interior rows are independent, so large bitmaps light them in bands on the task
+    // threads.
+    const int interiorTop = y + 1, interiorRows = bottom - 1 - interiorTop;
+    const int bandCount = SkTPin(interiorRows / kMinRowsPerBand, 1, kMaxBands);
+    const int rowsPerBand = (interiorRows + bandCount - 1) / bandCount;
+    sk_parallel_for(bandCount, [&](int band) {
+        const int bandTop = interiorTop + band * rowsPerBand,
+                  bandBottom = SkTMin(bandTop + rowsPerBand, bottom - 1);
+        SkPMColor* dptr = dst->getAddr32(0, bandTop - bounds.top());
+        for (int y = bandTop; y < bandBottom; ++y) {
+            int x = left;
+            const SkPMColor* row0 = src.getAddr32(x, y - 1);
+            const SkPMColor* row1 = src.getAddr32(x, y);
+            const SkPMColor* row2 = src.getAddr32(x, y + 1);
+            int m[9];
+            m[1] = SkGetPackedA32(*row0++);
             m[2] = SkGetPackedA32(*row0++);
+            m[4] = SkGetPackedA32(*row1++);
             m[5] = SkGetPackedA32(*row1++);
+            m[7] = SkGetPackedA32(*row2++);
             m[8] = SkGetPackedA32(*row2++);
+            SkPoint3 surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+            *dptr++ = lightingType.light(leftNormal(m, surfaceScale), surfaceToLight,
+                                         l->lightColor(surfaceToLight));
+            for (++x; x < right - 1; ++x) {
+                shiftMatrixLeft(m);
+                m[2] = SkGetPackedA32(*row0++);
+                m[5] = SkGetPackedA32(*row1++);
+                m[8] = SkGetPackedA32(*row2++);
+                surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
+                *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
+                                             l->lightColor(surfaceToLight));
+            }
+            shiftMatrixLeft(m);
             surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-            *dptr++ = lightingType.light(interiorNormal(m, surfaceScale), surfaceToLight,
+            *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
                                          l->lightColor(surfaceToLight));
         }
-        shiftMatrixLeft(m);
-        surfaceToLight = l->surfaceToLight(x, y, m[4], surfaceScale);
-        *dptr++ = lightingType.light(rightNormal(m, surfaceScale), surfaceToLight,
-                                     l->lightColor(surfaceToLight));
-    }
+    });
+    y = bottom - 1;
+    dptr = dst->getAddr32(0, y - bounds.top());
 
     {
         int x = left;
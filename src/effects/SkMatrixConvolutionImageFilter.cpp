@@ -8,9 +8,11 @@
 #include "SkMatrixConvolutionImageFilter.h"
 #include "SkBitmap.h"
 #include "SkColorPriv.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkRect.h"
+#include "SkTaskGroup.h"
 #include "SkUnPreMultiply.h"
 
 #if SK_SUPPORT_GPU
@@ -159,6 +161,10 @@ public:
     }
 };
 
+// Large rects are split into bands of rows that run on the task threads.
+static const int kMinRowsPerBand = 64;
+static const int kMaxBands = 16;
+
 template<class PixelFetcher, bool convolveAlpha>
 void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
                                                   SkBitmap* result,
@@ -168,39 +174,44 @@ void SkMatrixConvolutionImageFilter::filterPixels(const SkBitmap& src,
     if (!rect.intersect(bounds)) {
         return;
     }
-    for (int y = rect.fTop; y < rect.fBottom; ++y) {
-        SkPMColor* dptr = result->getAddr32(rect.fLeft - bounds.fLeft, y - bounds.fTop);
-        for (int x = rect.fLeft; x < rect.fRight; ++x) {
-            SkScalar sumA = 0, sumR = 0, sumG = 0, sumB = 0;
-            for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
-                for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
-                    SkPMColor s = PixelFetcher::fetch(src,
-                                                      x + cx - fKernelOffset.fX,
-                                                      y + cy - fKernelOffset.fY,
-                                                      bounds);
-                    SkScalar k = fKernel[cy * fKernelSize.fWidth + cx];
-                    if (convolveAlpha) {
-                        sumA += SkScalarMul(SkIntToScalar(SkGetPackedA32(s)), k);
+    const int bandCount = SkTPin(rect.height() / kMinRowsPerBand, 1, kMaxBands);
+    const int rowsPerBand = (rect.height() + bandCount - 1) / bandCount;
+    sk_parallel_for(bandCount, [&](int band) {
+        const int top = rect.fTop + band * rowsPerBand,
+                  bottom = SkTMin(top + rowsPerBand, rect.fBottom);
+        for (int y = top; y < bottom; ++y) {
+            SkPMColor* dptr = result->getAddr32(rect.fLeft - bounds.fLeft, y - bounds.fTop);
+            for (int x = rect.fLeft; x < rect.fRight; ++x) {
+                // Lanes are A, R, G, B; each lane sums in the same order as a scalar loop would.
+                Sk4f sum(0.0f);
+                for (int cy = 0; cy < fKernelSize.fHeight; cy++) {
+                    for (int cx = 0; cx < fKernelSize.fWidth; cx++) {
+                        SkPMColor s = PixelFetcher::fetch(src,
+                                                          x + cx - fKernelOffset.fX,
+                                                          y + cy - fKernelOffset.fY,
+                                                          bounds);
+                        Sk4f color(SkIntToScalar(SkGetPackedA32(s)),
+                                   SkIntToScalar(SkGetPackedR32(s)),
+                                   SkIntToScalar(SkGetPackedG32(s)),
+                                   SkIntToScalar(SkGetPackedB32(s)));
+                        sum = sum + color * Sk4f(fKernel[cy * fKernelSize.fWidth + cx]);
                     }
-                    sumR += SkScalarMul(SkIntToScalar(SkGetPackedR32(s)), k);
-                    sumG += SkScalarMul(SkIntToScalar(SkGetPackedG32(s)), k);
-                    sumB += SkScalarMul(SkIntToScalar(SkGetPackedB32(s)), k);
                 }
-            }
-            int a = convolveAlpha
-                  ? SkClampMax(SkScalarFloorToInt(SkScalarMul(sumA, fGain) + fBias), 255)
-                  : 255;
-            int r = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumR, fGain) + fBias), a);
-            int g = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumG, fGain) + fBias), a);
-            int b = SkClampMax(SkScalarFloorToInt(SkScalarMul(sumB, fGain) + fBias), a);
-            if (!convolveAlpha) {
-                a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
-                *dptr++ = SkPreMultiplyARGB(a, r, g, b);
-            } else {
-                *dptr++ = SkPackARGB32(a, r, g, b);
+                SkScalar sums[4];
+                (sum * Sk4f(fGain) + Sk4f(fBias)).store(sums);
+                int a = convolveAlpha ? SkClampMax(SkScalarFloorToInt(sums[0]), 255) : 255;
+                int r = SkClampMax(SkScalarFloorToInt(sums[1]), a);
+                int g = SkClampMax(SkScalarFloorToInt(sums[2]), a);
+                int b = SkClampMax(SkScalarFloorToInt(sums[3]), a);
+                if (!convolveAlpha) {
+                    a = SkGetPackedA32(PixelFetcher::fetch(src, x, y, bounds));
+                    *dptr++ = SkPreMultiplyARGB(a, r, g, b);
+                } else {
+                    *dptr++ = SkPackARGB32(a, r, g, b);
+                }
             }
         }
-    }
+    });
 }
 
 template<class PixelFetcher>
@@ -456,6 +456,170 @@ GrFragmentProcessor* GrMorphologyEffect::TestCreate(GrProcessorTestData* d) {
     return GrMorphologyEffect::Create(d->fProcDataManager, d->fTextures[texIdx], dir, radius, type);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Single-pass morphology over a (2 * rx + 1) x (2 * ry + 1) window, for radii small enough that
+ * reading the whole window beats rendering the separable passes' intermediate. Reads are clamped
+ * to a range (in normalized texture coordinates), as GrMorphologyEffect's are.
+ */
+class GrMorphology2DEffect : public GrSingleTextureEffect {
+public:
+    static GrFragmentProcessor* Create(GrProcessorDataManager* procDataManager, GrTexture* tex,
+                                       const SkISize& radius,
+                                       GrMorphologyEffect::MorphologyType type,
+                                       const SkRect& range) {
+        return SkNEW_ARGS(GrMorphology2DEffect, (procDataManager, tex, radius, type, range));
+    }
+
+    const SkISize& radius() const { return fRadius; }
+    GrMorphologyEffect::MorphologyType type() const { return fType; }
+    const SkRect& range() const { return fRange; }
+
+    const char* name() const override { return "Morphology2D"; }
+
+    GrGLFragmentProcessor* createGLInstance() const override;
+
+private:
+    GrMorphology2DEffect(GrProcessorDataManager* procDataManager, GrTexture* texture,
+                         const SkISize& radius, GrMorphologyEffect::MorphologyType type,
+                         const SkRect& range)
+        : INHERITED(procDataManager, texture, GrCoordTransform::MakeDivByTextureWHMatrix(texture))
+        , fRadius(radius)
+        , fType(type)
+        , fRange(range) {
+        this->initClassID<GrMorphology2DEffect>();
+    }
+
+    void onGetGLProcessorKey(const GrGLSLCaps&, GrProcessorKeyBuilder*) const override;
+
+    bool onIsEqual(const GrFragmentProcessor& sBase) const override {
+        const GrMorphology2DEffect& s = sBase.cast<GrMorphology2DEffect>();
+        return fRadius == s.fRadius && fType == s.fType;
+    }
+
+    void onComputeInvariantOutput(GrInvariantOutput* inout) const override {
+        // As with GrMorphologyEffect, the result's components all come from source texels.
+        this->updateInvariantOutputForModulation(inout);
+    }
+
+    SkISize                             fRadius;
+    GrMorphologyEffect::MorphologyType  fType;
+    SkRect                              fRange;
+
+    GR_DECLARE_FRAGMENT_PROCESSOR_TEST;
+
+    typedef GrSingleTextureEffect INHERITED;
+};
+
+class GrGLMorphology2DEffect : public GrGLFragmentProcessor {
+public:
+    GrGLMorphology2DEffect(const GrProcessor& proc) {
+        const GrMorphology2DEffect& m = proc.cast<GrMorphology2DEffect>();
+        fRadius = m.radius();
+        fType = m.type();
+    }
+
+    void emitCode(EmitArgs&) override;
+
+    static inline void GenKey(const GrProcessor& proc, const GrGLSLCaps&,
+                              GrProcessorKeyBuilder* b) {
+        const GrMorphology2DEffect& m = proc.cast<GrMorphology2DEffect>();
+        SkASSERT(m.radius().width() < 256 && m.radius().height() < 256);
+        b->add32(m.radius().width() | (m.radius().height() << 8) | (m.type() << 16));
+    }
+
+    void setData(const GrGLProgramDataManager&, const GrProcessor&) override;
+
+private:
+    SkISize                               fRadius;
+    GrMorphologyEffect::MorphologyType    fType;
+    GrGLProgramDataManager::UniformHandle fPixelSizeUni;
+    GrGLProgramDataManager::UniformHandle fRangeUni;
+
+    typedef GrGLFragmentProcessor INHERITED;
+};
+
+void GrGLMorphology2DEffect::emitCode(EmitArgs& args) {
+    fPixelSizeUni = args.fBuilder->addUniform(GrGLProgramBuilder::kFragment_Visibility,
+                                              kVec2f_GrSLType, kDefault_GrSLPrecision,
+                                              "PixelSize");
+    const char* pixelSize = args.fBuilder->getUniformCStr(fPixelSizeUni);
+    fRangeUni = args.fBuilder->addUniform(GrGLProgramBuilder::kFragment_Visibility,
+                                          kVec4f_GrSLType, kDefault_GrSLPrecision,
+                                          "Range");
+    const char* range = args.fBuilder->getUniformCStr(fRangeUni);
+
+    GrGLFragmentBuilder* fsBuilder = args.fBuilder->getFragmentShaderBuilder();
+    SkString coords2D = fsBuilder->ensureFSCoords2D(args.fCoords, 0);
+    const char* func;
+    if (GrMorphologyEffect::kErode_MorphologyType == fType) {
+        fsBuilder->codeAppendf("\t\t%s = vec4(1, 1, 1, 1);\n", args.fOutputColor);
+        func = "min";
+    } else {
+        fsBuilder->codeAppendf("\t\t%s = vec4(0, 0, 0, 0);\n", args.fOutputColor);
+        func = "max";
+    }
+
+    fsBuilder->codeAppendf("\t\tvec2 origin = %s - vec2(%d.0, %d.0) * %s;\n",
+                           coords2D.c_str(), fRadius.width(), fRadius.height(), pixelSize);
+    fsBuilder->codeAppendf("\t\tfor (int y = 0; y < %d; y++) {\n",
+                           GrMorphologyEffect::WidthFromRadius(fRadius.height()));
+    fsBuilder->codeAppendf("\t\t\tvec2 coord;\n");
+    fsBuilder->codeAppendf("\t\t\tcoord.y = clamp(origin.y + float(y) * %s.y, %s.y, %s.w);\n",
+                           pixelSize, range, range);
+    fsBuilder->codeAppendf("\t\t\tfor (int x = 0; x < %d; x++) {\n",
+                           GrMorphologyEffect::WidthFromRadius(fRadius.width()));
+    fsBuilder->codeAppendf("\t\t\t\tcoord.x = clamp(origin.x + float(x) * %s.x, %s.x, %s.z);\n",
+                           pixelSize, range, range);
+    fsBuilder->codeAppendf("\t\t\t\t%s = %s(%s, ", args.fOutputColor, func, args.fOutputColor);
+    fsBuilder->appendTextureLookup(args.fSamplers[0], "coord");
+    fsBuilder->codeAppend(");\n");
+    fsBuilder->codeAppend("\t\t\t}\n");
+    fsBuilder->codeAppend("\t\t}\n");
+    SkString modulate;
+    GrGLSLMulVarBy4f(&modulate, args.fOutputColor, args.fInputColor);
+    fsBuilder->codeAppend(modulate.c_str());
+}
+
+void GrGLMorphology2DEffect::setData(const GrGLProgramDataManager& pdman,
+                                     const GrProcessor& proc) {
+    const GrMorphology2DEffect& m = proc.cast<GrMorphology2DEffect>();
+    GrTexture& texture = *m.texture(0);
+    SkASSERT(m.radius() == fRadius);
+
+    pdman.set2f(fPixelSizeUni, 1.0f / texture.width(), 1.0f / texture.height());
+    const SkRect& range = m.range();
+    if (texture.origin() == kBottomLeft_GrSurfaceOrigin) {
+        pdman.set4f(fRangeUni, range.fLeft, 1.0f - range.fBottom, range.fRight, 1.0f - range.fTop);
+    } else {
+        pdman.set4f(fRangeUni, range.fLeft, range.fTop, range.fRight, range.fBottom);
+    }
+}
+
+void GrMorphology2DEffect::onGetGLProcessorKey(const GrGLSLCaps& caps,
+                                               GrProcessorKeyBuilder* b) const {
+    GrGLMorphology2DEffect::GenKey(*this, caps, b);
+}
+
+GrGLFragmentProcessor* GrMorphology2DEffect::createGLInstance() const {
+    return SkNEW_ARGS(GrGLMorphology2DEffect, (*this));
+}
+
+GR_DEFINE_FRAGMENT_PROCESSOR_TEST(GrMorphology2DEffect);
+
+GrFragmentProcessor* GrMorphology2DEffect::TestCreate(GrProcessorTestData* d) {
+    int texIdx = d->fRandom->nextBool() ? GrProcessorUnitTest::kSkiaPMTextureIdx :
+                                          GrProcessorUnitTest::kAlphaTextureIdx;
+    static const int kMaxRadius = 3;
+    SkISize radius = SkISize::Make(d->fRandom->nextRangeU(1, kMaxRadius),
+                                   d->fRandom->nextRangeU(1, kMaxRadius));
+    GrMorphologyEffect::MorphologyType type =
+            d->fRandom->nextBool() ? GrMorphologyEffect::kErode_MorphologyType
+                                   : GrMorphologyEffect::kDilate_MorphologyType;
+    return GrMorphology2DEffect::Create(d->fProcDataManager, d->fTextures[texIdx], radius, type,
+                                        SkRect::MakeWH(1, 1));
+}
+
 namespace {
 
 
@@ -546,6 +710,37 @@ void apply_morphology_pass(GrDrawContext* drawContext,
     }
 }
 
+// Up to this many texels per pixel, one 2D pass is cheaper than two separable passes plus the
+// render target between them.
+static const int kMaxSinglePassTexels = 25;
+
+// Larger radii are split into several separable passes (max over [-a,a] then [-b,b] is max over
+// [-(a+b),a+b]), bounding each fragment's loop and the number of distinct programs.
+static const int kMaxPassRadius = 16;
+
+void apply_morphology_2d(GrDrawContext* drawContext,
+                         GrRenderTarget* rt,
+                         const GrClip& clip,
+                         GrTexture* texture,
+                         const SkIRect& srcRect,
+                         const SkIRect& dstRect,
+                         const SkISize& radius,
+                         GrMorphologyEffect::MorphologyType morphType) {
+    const SkRect range = SkRect::MakeLTRB(
+            (SkIntToScalar(srcRect.left())   + 0.5f) / texture->width(),
+            (SkIntToScalar(srcRect.top())    + 0.5f) / texture->height(),
+            (SkIntToScalar(srcRect.right())  - 0.5f) / texture->width(),
+            (SkIntToScalar(srcRect.bottom()) - 0.5f) / texture->height());
+    GrPaint paint;
+    paint.addColorProcessor(GrMorphology2DEffect::Create(paint.getProcessorDataManager(),
+                                                         texture,
+                                                         radius,
+                                                         morphType,
+                                                         range))->unref();
+    drawContext->drawNonAARectToRect(rt, clip, paint, SkMatrix::I(), SkRect::Make(dstRect),
+                                     SkRect::Make(srcRect));
+}
+
 bool apply_morphology(const SkBitmap& input,
                       const SkIRect& rect,
                       GrMorphologyEffect::MorphologyType morphType,
@@ -567,44 +762,55 @@ bool apply_morphology(const SkBitmap& input,
     desc.fConfig = kSkia8888_GrPixelConfig;
     SkIRect srcRect = rect;
 
-    if (radius.fWidth > 0) {
-        GrTexture* scratch = context->textureProvider()->createApproxTexture(desc);
+    GrDrawContext* drawContext = context->drawContext();
+    if (!drawContext) {
+        return false;
+    }
+
+    if (radius.fWidth > 0 && radius.fHeight > 0 &&
+        Gr1DKernelEffect::WidthFromRadius(radius.fWidth) *
+        Gr1DKernelEffect::WidthFromRadius(radius.fHeight) <= kMaxSinglePassTexels) {
+        SkAutoTUnref<GrTexture> scratch(context->textureProvider()->createApproxTexture(desc));
         if (NULL == scratch) {
             return false;
         }
-        GrDrawContext* dstDrawContext = context->drawContext();
-        if (!dstDrawContext) {
-            return false;
-        }
+        apply_morphology_2d(drawContext, scratch->asRenderTarget(), clip, srcTexture,
+                            srcRect, dstRect, radius, morphType);
+        SkImageFilter::WrapTexture(scratch, rect.width(), rect.height(), dst);
+        return true;
+    }
 
-        apply_morphology_pass(dstDrawContext, scratch->asRenderTarget(), clip, srcTexture,
-                              srcRect, dstRect, radius.fWidth, morphType,
-                              Gr1DKernelEffect::kX_Direction);
-        SkIRect clearRect = SkIRect::MakeXYWH(dstRect.fLeft, dstRect.fBottom,
-                                              dstRect.width(), radius.fHeight);
-        GrColor clearColor = GrMorphologyEffect::kErode_MorphologyType == morphType ?
-                                SK_ColorWHITE :
-                                SK_ColorTRANSPARENT;
-        dstDrawContext->clear(scratch->asRenderTarget(), &clearRect, clearColor, false);
-
-        srcTexture.reset(scratch);
-        srcRect = dstRect;
-    }
-    if (radius.fHeight > 0) {
-        GrTexture* scratch = context->textureProvider()->createApproxTexture(desc);
-        if (NULL == scratch) {
-            return false;
+    // The separable passes ping-pong between two scratch targets, however many there are.
+    SkAutoTUnref<GrTexture> scratch[2];
+    int passCount = 0;
+    const Gr1DKernelEffect::Direction directions[] = { Gr1DKernelEffect::kX_Direction,
+                                                       Gr1DKernelEffect::kY_Direction };
+    const int radii[] = { radius.fWidth, radius.fHeight };
+    for (int i = 0; i < 2; ++i) {
+        for (int remaining = radii[i]; remaining > 0; ) {
+            const int passRadius = SkTMin(remaining, kMaxPassRadius);
+            remaining -= passRadius;
+
+            SkAutoTUnref<GrTexture>& target = scratch[passCount++ & 1];
+            if (!target) {
+                target.reset(context->textureProvider()->createApproxTexture(desc));
+                if (NULL == target) {
+                    return false;
+                }
+            }
+            apply_morphology_pass(drawContext, target->asRenderTarget(), clip, srcTexture,
+                                  srcRect, dstRect, passRadius, morphType, directions[i]);
+            srcTexture.reset(SkRef(target.get()));
+            srcRect = dstRect;
         }
-        GrDrawContext* dstDrawContext = context->drawContext();
-        if (!dstDrawContext) {
-            return false;
+        if (Gr1DKernelEffect::kX_Direction == directions[i] && radii[i] > 0) {
+            SkIRect clearRect = SkIRect::MakeXYWH(dstRect.fLeft, dstRect.fBottom,
+                                                  dstRect.width(), radius.fHeight);
+            GrColor clearColor = GrMorphologyEffect::kErode_MorphologyType == morphType ?
+                                    SK_ColorWHITE :
+                                    SK_ColorTRANSPARENT;
+            drawContext->clear(srcTexture->asRenderTarget(), &clearRect, clearColor, false);
         }
-
-        apply_morphology_pass(dstDrawContext, scratch->asRenderTarget(), clip, srcTexture,
-                              srcRect, dstRect, radius.fHeight, morphType,
-                              Gr1DKernelEffect::kY_Direction);
-
-        srcTexture.reset(scratch);
     }
     SkImageFilter::WrapTexture(srcTexture, rect.width(), rect.height(), dst);
     return true;
@@ -7,8 +7,11 @@
 
 #include "SkDither.h"
 #include "SkPerlinNoiseShader.h"
+#include "SkCachedData.h"
 #include "SkColorFilter.h"
+#include "SkNx.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkWriteBuffer.h"
 #include "SkShader.h"
 #include "SkUnPreMultiply.h"
@@ -104,10 +107,18 @@ struct SkPerlinNoiseShader::PaintingData {
     uint8_t     fLatticeSelector[kBlockSize];
     uint16_t    fNoise[4][kBlockSize][2];
     SkPoint     fGradient[4][kBlockSize];
+    // fGradient transposed, so that one load gets a lattice point's gradient for all channels.
+    SkScalar    fGradientX[kBlockSize][4];
+    SkScalar    fGradientY[kBlockSize][4];
     SkISize     fTileSize;
     SkVector    fBaseFrequency;
     StitchData  fStitchDataInit;
 
+    Sk4f noise2D(bool stitchTiles, const StitchData& stitchData,
+                 const SkPoint& noiseVector) const;
+    SkPMColor shade(const SkPerlinNoiseShader& shader, U8CPU paintAlpha,
+                    const SkPoint& point) const;
+
 private:
 
 #if SK_SUPPORT_GPU
@@ -195,6 +206,8 @@ private:
                     fGradient[channel][i].fX + SK_Scalar1, gHalfMax16bits));
                 fNoise[channel][i][1] = SkScalarRoundToInt(SkScalarMul(
                     fGradient[channel][i].fY + SK_Scalar1, gHalfMax16bits));
+                fGradientX[i][channel] = fGradient[channel][i].fX;
+                fGradientY[i][channel] = fGradient[channel][i].fY;
             }
         }
     }
@@ -311,8 +324,10 @@ void SkPerlinNoiseShader::flatten(SkWriteBuffer& buffer) const {
     buffer.writeInt(fTileSize.fHeight);
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
-        int channel, const StitchData& stitchData, const SkPoint& noiseVector) const {
+// Computes the noise of all four channels at once: the lattice is shared, only the gradients
+// differ. Lane k holds channel k, and each lane does exactly the scalar arithmetic.
+Sk4f SkPerlinNoiseShader::PaintingData::noise2D(bool stitchTiles, const StitchData& stitchData,
+                                                const SkPoint& noiseVector) const {
     struct Noise {
         int noisePositionIntegerValue;
         int nextNoisePositionIntegerValue;
@@ -327,10 +342,8 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
     };
     Noise noiseX(noiseVector.x());
     Noise noiseY(noiseVector.y());
-    SkScalar u, v;
-    const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
     // If stitching, adjust lattice points accordingly.
-    if (perlinNoiseShader.fStitchTiles) {
+    if (stitchTiles) {
         noiseX.noisePositionIntegerValue =
             checkNoise(noiseX.noisePositionIntegerValue, stitchData.fWrapX, stitchData.fWidth);
         noiseY.noisePositionIntegerValue =
@@ -344,51 +357,48 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::noise2D(
     noiseY.noisePositionIntegerValue &= kBlockMask;
     noiseX.nextNoisePositionIntegerValue &= kBlockMask;
     noiseY.nextNoisePositionIntegerValue &= kBlockMask;
-    int i =
-        fPaintingData->fLatticeSelector[noiseX.noisePositionIntegerValue];
-    int j =
-        fPaintingData->fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
+    int i = fLatticeSelector[noiseX.noisePositionIntegerValue];
+    int j = fLatticeSelector[noiseX.nextNoisePositionIntegerValue];
     int b00 = (i + noiseY.noisePositionIntegerValue) & kBlockMask;
     int b10 = (j + noiseY.noisePositionIntegerValue) & kBlockMask;
     int b01 = (i + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
     int b11 = (j + noiseY.nextNoisePositionIntegerValue) & kBlockMask;
-    SkScalar sx = smoothCurve(noiseX.noisePositionFractionValue);
-    SkScalar sy = smoothCurve(noiseY.noisePositionFractionValue);
+    Sk4f sx(smoothCurve(noiseX.noisePositionFractionValue));
+    Sk4f sy(smoothCurve(noiseY.noisePositionFractionValue));
     // This is taken 1:1 from SVG spec: http://www.w3.org/TR/SVG11/filters.html#feTurbulenceElement
-    SkPoint fractionValue = SkPoint::Make(noiseX.noisePositionFractionValue,
-                                          noiseY.noisePositionFractionValue); // Offset (0,0)
-    u = fPaintingData->fGradient[channel][b00].dot(fractionValue);
-    fractionValue.fX -= SK_Scalar1; // Offset (-1,0)
-    v = fPaintingData->fGradient[channel][b10].dot(fractionValue);
-    SkScalar a = SkScalarInterp(u, v, sx);
-    fractionValue.fY -= SK_Scalar1; // Offset (-1,-1)
-    v = fPaintingData->fGradient[channel][b11].dot(fractionValue);
-    fractionValue.fX = noiseX.noisePositionFractionValue; // Offset (0,-1)
-    u = fPaintingData->fGradient[channel][b01].dot(fractionValue);
-    SkScalar b = SkScalarInterp(u, v, sx);
-    return SkScalarInterp(a, b, sy);
+    Sk4f fx(noiseX.noisePositionFractionValue),
+         fy(noiseY.noisePositionFractionValue),
+         fx1(noiseX.noisePositionFractionValue - SK_Scalar1),
+         fy1(noiseY.noisePositionFractionValue - SK_Scalar1);
+    auto dot = [this](int b, const Sk4f& x, const Sk4f& y) {
+        return Sk4f::Load(fGradientX[b]) * x + Sk4f::Load(fGradientY[b]) * y;
+    };
+    auto interp = [](const Sk4f& a, const Sk4f& b, const Sk4f& t) {
+        return a + (b - a) * t;
+    };
+    Sk4f a = interp(dot(b00, fx, fy), dot(b10, fx1, fy), sx);    // Offsets (0,0) and (-1,0)
+    Sk4f b = interp(dot(b01, fx, fy1), dot(b11, fx1, fy1), sx);  // Offsets (0,-1) and (-1,-1)
+    return interp(a, b, sy);
 }
 
-SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValueForPoint(
-        int channel, StitchData& stitchData, const SkPoint& point) const {
-    const SkPerlinNoiseShader& perlinNoiseShader = static_cast<const SkPerlinNoiseShader&>(fShader);
-    if (perlinNoiseShader.fStitchTiles) {
-        // Set up TurbulenceInitial stitch values.
-        stitchData = fPaintingData->fStitchDataInit;
-    }
-    SkScalar turbulenceFunctionResult = 0;
-    SkPoint noiseVector(SkPoint::Make(SkScalarMul(point.x(), fPaintingData->fBaseFrequency.fX),
-                                      SkScalarMul(point.y(), fPaintingData->fBaseFrequency.fY)));
+// Returns the premultiplied noise color at point, which is already in noise space.
+SkPMColor SkPerlinNoiseShader::PaintingData::shade(const SkPerlinNoiseShader& shader,
+                                                   U8CPU paintAlpha, const SkPoint& point) const {
+    // Set up TurbulenceInitial stitch values.
+    StitchData stitchData = fStitchDataInit;
+    Sk4f turbulenceFunctionResult(0);
+    SkPoint noiseVector(SkPoint::Make(SkScalarMul(point.x(), fBaseFrequency.fX),
+                                      SkScalarMul(point.y(), fBaseFrequency.fY)));
     SkScalar ratio = SK_Scalar1;
-    for (int octave = 0; octave < perlinNoiseShader.fNumOctaves; ++octave) {
-        SkScalar noise = noise2D(channel, stitchData, noiseVector);
-        SkScalar numer = (perlinNoiseShader.fType == kFractalNoise_Type) ?
-                            noise : SkScalarAbs(noise);
-        turbulenceFunctionResult += numer / ratio;
+    for (int octave = 0; octave < shader.fNumOctaves; ++octave) {
+        Sk4f noise = this->noise2D(shader.fStitchTiles, stitchData, noiseVector);
+        Sk4f numer = (shader.fType == kFractalNoise_Type) ?
+                        noise : Sk4f::Max(noise, Sk4f(0) - noise);
+        turbulenceFunctionResult = turbulenceFunctionResult + numer / Sk4f(ratio);
         noiseVector.fX *= 2;
         noiseVector.fY *= 2;
         ratio *= 2;
-        if (perlinNoiseShader.fStitchTiles) {
+        if (shader.fStitchTiles) {
             // Update stitch values
             stitchData.fWidth  *= 2;
             stitchData.fWrapX   = stitchData.fWidth + kPerlinNoise;
@@ -399,33 +409,154 @@ SkScalar SkPerlinNoiseShader::PerlinNoiseShaderContext::calculateTurbulenceValue
 
     // The value of turbulenceFunctionResult comes from ((turbulenceFunctionResult) + 1) / 2
     // by fractalNoise and (turbulenceFunctionResult) by turbulence.
-    if (perlinNoiseShader.fType == kFractalNoise_Type) {
+    if (shader.fType == kFractalNoise_Type) {
         turbulenceFunctionResult =
-            SkScalarMul(turbulenceFunctionResult, SK_ScalarHalf) + SK_ScalarHalf;
+            turbulenceFunctionResult * Sk4f(SK_ScalarHalf) + Sk4f(SK_ScalarHalf);
     }
 
-    if (channel == 3) { // Scale alpha by paint value
-        turbulenceFunctionResult *= SkIntToScalar(getPaintAlpha()) / 255;
-    }
+    // Scale alpha by paint value
+    turbulenceFunctionResult = turbulenceFunctionResult *
+                               Sk4f(1, 1, 1, SkIntToScalar(paintAlpha) / 255);
 
     // Clamp result
-    return SkScalarPin(turbulenceFunctionResult, 0, SK_Scalar1);
+    turbulenceFunctionResult = Sk4f::Min(Sk4f::Max(turbulenceFunctionResult, Sk4f(0)),
+                                         Sk4f(SK_Scalar1));
+
+    int rgba[4];
+    (Sk4f(255) * turbulenceFunctionResult).castTrunc().store(rgba);
+    return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
 }
 
-SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(
-        const SkPoint& point, StitchData& stitchData) const {
+SkPMColor SkPerlinNoiseShader::PerlinNoiseShaderContext::shade(const SkPoint& point) const {
     SkPoint newPoint;
     fMatrix.mapPoints(&newPoint, &point, 1);
     newPoint.fX = SkScalarRoundToScalar(newPoint.fX);
     newPoint.fY = SkScalarRoundToScalar(newPoint.fY);
+    return fPaintingData->shade(static_cast<const SkPerlinNoiseShader&>(fShader),
+                                this->getPaintAlpha(), newPoint);
+}
+
+// Noise is a pure function of its integral noise space coordinates, so when device space maps to
+// noise space by an integral translate, the noise is rendered in kNoiseBlockSize square blocks
+// that are kept in SkResourceCache, and spans are copied out of them. Redrawing static noise, or
+// scrolling it by whole pixels, then costs a copy per pixel. Spans shorter than kMinCachedSpan
+// are shaded directly, so that small draws don't pay for whole blocks.
+static const int kNoiseBlockSize = 64;
+static const int kMinCachedSpan = 16;
+// Keeps noise space coordinates exact in floats.
+static const SkScalar kMaxCachedTranslate = SkIntToScalar(1 << 22);
+
+namespace {
+static unsigned gNoiseBlockKeyNamespaceLabel;
+
+struct NoiseBlockKey : public SkResourceCache::Key {
+public:
+    NoiseBlockKey(SkPerlinNoiseShader::Type type, SkScalar baseFrequencyX,
+                  SkScalar baseFrequencyY, int numOctaves, SkScalar seed, const SkISize& tileSize,
+                  const SkMatrix& matrix, U8CPU paintAlpha)
+        : fType(type)
+        , fBaseFrequencyX(baseFrequencyX)
+        , fBaseFrequencyY(baseFrequencyY)
+        , fNumOctaves(numOctaves)
+        , fSeed(seed)
+        , fTileWidth(tileSize.width())
+        , fTileHeight(tileSize.height())
+        , fPaintAlpha(paintAlpha)
+    {
+        fMatrix[0] = matrix.getScaleX();
+        fMatrix[1] = matrix.getSkewX();
+        fMatrix[2] = matrix.getSkewY();
+        fMatrix[3] = matrix.getScaleY();
+        this->setBlock(0, 0);
+    }
 
-    U8CPU rgba[4];
-    for (int channel = 3; channel >= 0; --channel) {
-        rgba[channel] = SkScalarFloorToInt(255 *
-            calculateTurbulenceValueForPoint(channel, stitchData, newPoint));
+    // Moves the key to the block whose top left is (x, y) in noise space.
+    void setBlock(int x, int y) {
+        fX = x;
+        fY = y;
+        this->init(&gNoiseBlockKeyNamespaceLabel, 0,
+                   sizeof(fType) + sizeof(fBaseFrequencyX) + sizeof(fBaseFrequencyY) +
+                   sizeof(fNumOctaves) + sizeof(fSeed) + sizeof(fTileWidth) +
+                   sizeof(fTileHeight) + sizeof(fMatrix) + sizeof(fPaintAlpha) +
+                   sizeof(fX) + sizeof(fY));
     }
-    return SkPreMultiplyARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
-}
+
+    int32_t    fType;
+    SkScalar   fBaseFrequencyX;
+    SkScalar   fBaseFrequencyY;
+    int32_t    fNumOctaves;
+    SkScalar   fSeed;
+    int32_t    fTileWidth;
+    int32_t    fTileHeight;
+    // The 2x2 part of the total matrix, which scales the frequencies and tile size.
+    SkScalar   fMatrix[4];
+    int32_t    fPaintAlpha;
+    int32_t    fX;
+    int32_t    fY;
+};
+
+struct NoiseBlockRec : public SkResourceCache::Rec {
+    NoiseBlockRec(const NoiseBlockKey& key, SkCachedData* data)
+        : fKey(key)
+        , fData(data)
+    {
+        fData->attachToCacheAndRef();
+    }
+    ~NoiseBlockRec() {
+        fData->detachFromCacheAndUnref();
+    }
+
+    NoiseBlockKey   fKey;
+    SkCachedData*   fData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return "perlin-noise"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const NoiseBlockRec& rec = static_cast<const NoiseBlockRec&>(baseRec);
+        SkCachedData** result = (SkCachedData**)contextData;
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (NULL == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+} // namespace
+
+// The blocks of the row of blocks that spans are currently being copied from.
+struct SkPerlinNoiseShader::PerlinNoiseShaderContext::BlockCache {
+    BlockCache(const NoiseBlockKey& key, const SkIPoint& deviceToNoise)
+        : fKey(key)
+        , fDeviceToNoise(deviceToNoise)
+        , fRowY(0) {}
+
+    ~BlockCache() {
+        this->releaseRow();
+    }
+
+    void releaseRow() {
+        for (int i = 0; i < fRow.count(); ++i) {
+            fRow[i].fData->unref();
+        }
+        fRow.rewind();
+    }
+
+    struct Block {
+        int32_t       fX;
+        SkCachedData* fData;
+    };
+
+    NoiseBlockKey    fKey;
+    const SkIPoint   fDeviceToNoise;
+    int32_t          fRowY;
+    SkTDArray<Block> fRow;
+};
 
 SkShader::Context* SkPerlinNoiseShader::onCreateContext(const ContextRec& rec,
                                                         void* storage) const {
@@ -439,6 +570,7 @@ size_t SkPerlinNoiseShader::contextSize() const {
 SkPerlinNoiseShader::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
         const SkPerlinNoiseShader& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
+    , fBlockCache(NULL)
 {
     SkMatrix newMatrix = *rec.fMatrix;
     newMatrix.preConcat(shader.getLocalMatrix());
@@ -449,18 +581,80 @@ SkPerlinNoiseShader::PerlinNoiseShaderContext::PerlinNoiseShaderContext(
     // (as opposed to 0 based, usually). The same adjustment is in the setData() function.
     fMatrix.setTranslate(-newMatrix.getTranslateX() + SK_Scalar1, -newMatrix.getTranslateY() + SK_Scalar1);
     fPaintingData = SkNEW_ARGS(PaintingData, (shader.fTileSize, shader.fSeed, shader.fBaseFrequencyX, shader.fBaseFrequencyY, newMatrix));
+
+    const SkScalar tx = fMatrix.getTranslateX(),
+                   ty = fMatrix.getTranslateY();
+    if (!newMatrix.hasPerspective() &&
+        tx == SkScalarFloorToScalar(tx) && SkScalarAbs(tx) < kMaxCachedTranslate &&
+        ty == SkScalarFloorToScalar(ty) && SkScalarAbs(ty) < kMaxCachedTranslate) {
+        NoiseBlockKey key(shader.fType, shader.fBaseFrequencyX, shader.fBaseFrequencyY,
+                          shader.fNumOctaves, shader.fSeed, shader.fTileSize, newMatrix,
+                          this->getPaintAlpha());
+        fBlockCache = SkNEW_ARGS(BlockCache, (key, SkIPoint::Make(SkScalarFloorToInt(tx),
+                                                                  SkScalarFloorToInt(ty))));
+    }
 }
 
 SkPerlinNoiseShader::PerlinNoiseShaderContext::~PerlinNoiseShaderContext() {
+    SkDELETE(fBlockCache);
     SkDELETE(fPaintingData);
 }
 
+const SkPMColor* SkPerlinNoiseShader::PerlinNoiseShaderContext::findBlock(int x, int y) {
+    BlockCache* cache = fBlockCache;
+    if (cache->fRowY != y) {
+        cache->releaseRow();
+        cache->fRowY = y;
+    }
+    for (int i = 0; i < cache->fRow.count(); ++i) {
+        if (cache->fRow[i].fX == x) {
+            return static_cast<const SkPMColor*>(cache->fRow[i].fData->data());
+        }
+    }
+
+    cache->fKey.setBlock(x, y);
+    SkCachedData* data = NULL;
+    if (!SkResourceCache::Find(cache->fKey, NoiseBlockRec::Visitor, &data)) {
+        data = SkResourceCache::NewCachedData(kNoiseBlockSize * kNoiseBlockSize *
+                                              sizeof(SkPMColor));
+        SkPMColor* pixels = static_cast<SkPMColor*>(data->writable_data());
+        const SkPerlinNoiseShader& shader = static_cast<const SkPerlinNoiseShader&>(fShader);
+        for (int j = 0; j < kNoiseBlockSize; ++j) {
+            for (int i = 0; i < kNoiseBlockSize; ++i) {
+                *pixels++ = fPaintingData->shade(shader, this->getPaintAlpha(),
+                                                 SkPoint::Make(SkIntToScalar(x + i),
+                                                               SkIntToScalar(y + j)));
+            }
+        }
+        SkResourceCache::Add(SkNEW_ARGS(NoiseBlockRec, (cache->fKey, data)));
+    }
+    BlockCache::Block* block = cache->fRow.append();
+    block->fX = x;
+    block->fData = data;
+    return static_cast<const SkPMColor*>(data->data());
+}
+
 void SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeSpan(
         int x, int y, SkPMColor result[], int count) {
+    if (fBlockCache && count >= kMinCachedSpan) {
+        const int noiseX = x + fBlockCache->fDeviceToNoise.x(),
+                  noiseY = y + fBlockCache->fDeviceToNoise.y();
+        const int blockY = noiseY & ~(kNoiseBlockSize - 1);
+        for (int nx = noiseX; nx < noiseX + count;) {
+            const int blockX = nx & ~(kNoiseBlockSize - 1);
+            const int n = SkTMin(blockX + kNoiseBlockSize, noiseX + count) - nx;
+            const SkPMColor* block = this->findBlock(blockX, blockY);
+            memcpy(result, block + (noiseY - blockY) * kNoiseBlockSize + (nx - blockX),
+                   n * sizeof(SkPMColor));
+            result += n;
+            nx += n;
+        }
+        return;
+    }
+
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
-    StitchData stitchData;
     for (int i = 0; i < count; ++i) {
-        result[i] = shade(point, stitchData);
+        result[i] = shade(point);
         point.fX += SK_Scalar1;
     }
 }
@@ -468,11 +662,10 @@ void SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeSpan(
 void SkPerlinNoiseShader::PerlinNoiseShaderContext::shadeSpan16(
         int x, int y, uint16_t result[], int count) {
     SkPoint point = SkPoint::Make(SkIntToScalar(x), SkIntToScalar(y));
-    StitchData stitchData;
     DITHER_565_SCAN(y);
     for (int i = 0; i < count; ++i) {
         unsigned dither = DITHER_VALUE(x);
-        result[i] = SkDitherRGB32To565(shade(point, stitchData), dither);
+        result[i] = SkDitherRGB32To565(shade(point), dither);
         DITHER_INC_X(x);
         point.fX += SK_Scalar1;
     }
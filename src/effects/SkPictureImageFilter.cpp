@@ -9,6 +9,7 @@
 #include "SkDevice.h"
 #include "SkCanvas.h"
 #include "SkReadBuffer.h"
+#include "SkShader.h"
 #include "SkSurfaceProps.h"
 #include "SkWriteBuffer.h"
 #include "SkValidationUtils.h"
@@ -121,6 +122,42 @@ bool SkPictureImageFilter::onFilterImage(Proxy* proxy, const SkBitmap&, const Co
     return true;
 }
 
+bool SkPictureImageFilter::onFilterImageAsShader(Proxy*, const SkBitmap&, const Context& ctx,
+                                                 SkShader** shader, SkRect* dstRect) const {
+    // Local-space resolution resamples a local-scale rendering; leave that to onFilterImage().
+    // Rotation and skew would have the shader's tiles show outside the picture's bounds.
+    if (!fPicture ||
+        kDeviceSpace_PictureResolution != fPictureResolution ||
+        !ctx.ctm().isScaleTranslate()) {
+        return false;
+    }
+
+    SkRect floatBounds;
+    ctx.ctm().mapRect(&floatBounds, fCropRect);
+    SkIRect bounds = floatBounds.roundOut();
+    if (!bounds.intersect(ctx.clipBounds()) || bounds.isEmpty()) {
+        return false;
+    }
+
+    // One tile covering exactly the device bounds onFilterImage() would have rendered. The
+    // picture shader rasterizes it at device scale and caches it across draws.
+    SkMatrix inverse;
+    if (!ctx.ctm().invert(&inverse)) {
+        return false;
+    }
+    SkRect tile;
+    inverse.mapRect(&tile, SkRect::Make(bounds));
+
+    *shader = SkShader::CreatePictureShader(fPicture,
+                                            SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode,
+                                            &ctx.ctm(), &tile);
+    if (!*shader) {
+        return false;
+    }
+    dstRect->set(bounds);
+    return true;
+}
+
 void SkPictureImageFilter::drawPictureAtDeviceResolution(SkBaseDevice* device,
                                                          const SkIRect& deviceBounds,
                                                          const Context& ctx) const {
@@ -478,7 +478,7 @@ GrFragmentProcessor* ColorTableEffect::Create(GrContext* context, SkBitmap bitma
         // Passing params=NULL because this effect does no tiling or filtering.
         texture.reset(GrRefCachedBitmapTexture(context, bitmap, NULL));
     } else {
-        texture.reset(SkRef(atlas->getTexture()));
+        texture.reset(SkRef(atlas->getTexture(row)));
     }
 
     return SkNEW_ARGS(ColorTableEffect, (texture, atlas, row, flags));
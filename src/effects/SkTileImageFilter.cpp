@@ -24,9 +24,10 @@ SkTileImageFilter* SkTileImageFilter::Create(const SkRect& srcRect, const SkRect
     return SkNEW_ARGS(SkTileImageFilter, (srcRect, dstRect, input));
 }
 
-bool SkTileImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
-                                      const Context& ctx,
-                                      SkBitmap* dst, SkIPoint* offset) const {
+bool SkTileImageFilter::computeTile(Proxy* proxy, const SkBitmap& src, const Context& ctx,
+                                    SkBitmap* subset, SkMatrix* shaderMatrix, SkRect* dstRect,
+                                    SkIRect* dstIRect, bool* empty) const {
+    *empty = false;
     SkBitmap source = src;
     SkImageFilter* input = getInput(0);
     SkIPoint srcOffset = SkIPoint::Make(0, 0);
@@ -34,12 +35,9 @@ bool SkTileImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
         return false;
     }
 
-    SkRect dstRect;
-    ctx.ctm().mapRect(&dstRect, fDstRect);
-    const SkIRect dstIRect = dstRect.roundOut();
-    int w = dstIRect.width();
-    int h = dstIRect.height();
-    if (!fSrcRect.width() || !fSrcRect.height() || !w || !h) {
+    ctx.ctm().mapRect(dstRect, fDstRect);
+    *dstIRect = dstRect->roundOut();
+    if (!fSrcRect.width() || !fSrcRect.height() || !dstIRect->width() || !dstIRect->height()) {
         return false;
     }
 
@@ -48,18 +46,38 @@ bool SkTileImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     SkIRect srcIRect;
     srcRect.roundOut(&srcIRect);
     srcIRect.offset(-srcOffset);
-    SkBitmap subset;
     SkIRect bounds;
     source.getBounds(&bounds);
 
     if (!srcIRect.intersect(bounds)) {
-        offset->fX = offset->fY = 0;
+        *empty = true;
         return true;
-    } else if (!source.extractSubset(&subset, srcIRect)) {
+    } else if (!source.extractSubset(subset, srcIRect)) {
         return false;
     }
 
-    SkAutoTUnref<SkBaseDevice> device(proxy->createDevice(w, h));
+    shaderMatrix->setTranslate(SkIntToScalar(srcOffset.fX),
+                               SkIntToScalar(srcOffset.fY));
+    return true;
+}
+
+bool SkTileImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
+                                      const Context& ctx,
+                                      SkBitmap* dst, SkIPoint* offset) const {
+    SkBitmap subset;
+    SkMatrix shaderMatrix;
+    SkRect dstRect;
+    SkIRect dstIRect;
+    bool empty;
+    if (!this->computeTile(proxy, src, ctx, &subset, &shaderMatrix, &dstRect, &dstIRect, &empty)) {
+        return false;
+    }
+    if (empty) {
+        offset->fX = offset->fY = 0;
+        return true;
+    }
+
+    SkAutoTUnref<SkBaseDevice> device(proxy->createDevice(dstIRect.width(), dstIRect.height()));
     if (NULL == device.get()) {
         return false;
     }
@@ -67,9 +85,6 @@ bool SkTileImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     SkPaint paint;
     paint.setXfermodeMode(SkXfermode::kSrc_Mode);
 
-    SkMatrix shaderMatrix;
-    shaderMatrix.setTranslate(SkIntToScalar(srcOffset.fX),
-                              SkIntToScalar(srcOffset.fY));
     SkAutoTUnref<SkShader> shader(SkShader::CreateBitmapShader(subset,
                                   SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode,
                                   &shaderMatrix));
@@ -82,6 +97,33 @@ bool SkTileImageFilter::onFilterImage(Proxy* proxy, const SkBitmap& src,
     return true;
 }
 
+bool SkTileImageFilter::onFilterImageAsShader(Proxy* proxy, const SkBitmap& src,
+                                              const Context& ctx,
+                                              SkShader** shader, SkRect* dstRect) const {
+    SkBitmap subset;
+    SkMatrix shaderMatrix;
+    SkRect rect;
+    SkIRect irect;
+    bool empty;
+    if (!this->computeTile(proxy, src, ctx, &subset, &shaderMatrix, &rect, &irect, &empty) ||
+        empty) {
+        return false;
+    }
+
+    // onFilterImage() draws rect with its top-left moved onto irect's, so shift the rect and
+    // the tiles by the same subpixel amount to fill the same pixels with the same tiling.
+    const SkScalar dx = SkIntToScalar(irect.fLeft) - rect.fLeft;
+    const SkScalar dy = SkIntToScalar(irect.fTop) - rect.fTop;
+    shaderMatrix.postTranslate(dx, dy);
+    rect.offset(dx, dy);
+
+    *shader = SkShader::CreateBitmapShader(subset,
+                                           SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode,
+                                           &shaderMatrix);
+    *dstRect = rect;
+    return true;
+}
+
 bool SkTileImageFilter::onFilterBounds(const SkIRect& src, const SkMatrix& ctm,
                                        SkIRect* dst) const {
     SkRect srcRect;
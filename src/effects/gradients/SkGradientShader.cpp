@@ -6,6 +6,8 @@
  */
 
 #include "SkGradientShaderPriv.h"
+#include "SkChecksum.h"
+#include "SkResourceCache.h"
 #include "SkLinearGradient.h"
 #include "SkRadialGradient.h"
 #include "SkTwoPointConicalGradient.h"
@@ -314,12 +316,51 @@ SkGradientShaderBase::GradientShaderBaseContext::GradientShaderBaseContext(
     if (shader.fColorsAreOpaque) {
         fFlags |= kHasSpan16_Flag;
     }
+
+    this->initFloatStops(shader, paintAlpha);
+}
+
+void SkGradientShaderBase::GradientShaderBaseContext::initFloatStops(
+        const SkGradientShaderBase& shader, unsigned paintAlpha) {
+    fFloatIntervalCount = 0;
+    const int count = shader.fColorCount;
+    if (count > kMaxFloatStops) {
+        return;
+    }
+
+    // With opaque colors premul and unpremul interpolation agree, so skip the extra multiply.
+    fPremulAfterLerp = !shader.fColorsAreOpaque &&
+                       !(SkGradientShader::kInterpolateColorsInPremul_Flag & shader.fGradFlags);
+    const float scale = paintAlpha * (1.0f / 255);
+
+    Sk4f prevColor(0);
+    float prevPos = 0;
+    for (int i = 0; i < count; i++) {
+        SkColor c = shader.fOrigColors[i];
+        float a = SkColorGetA(c) * (1.0f / 255);
+        float rgbScale = fPremulAfterLerp ? 1 : a * scale;
+        Sk4f color = SkPMFloat::FromARGB(a * scale,
+                                         SkColorGetR(c) * (1.0f / 255) * rgbScale,
+                                         SkColorGetG(c) * (1.0f / 255) * rgbScale,
+                                         SkColorGetB(c) * (1.0f / 255) * rgbScale);
+        // With more than two colors fRecs holds every position, including the implied ends.
+        float pos = count > 2 ? SkFixedToFloat(shader.fRecs[i].fPos) : (float)i;
+        if (i > 0 && pos > prevPos) {
+            Sk4f slope = (color - prevColor) * Sk4f(1 / (pos - prevPos));
+            (prevColor - slope * Sk4f(prevPos)).store(fIntervalBase[fFloatIntervalCount]);
+            slope.store(fIntervalSlope[fFloatIntervalCount]);
+            fIntervalEnd[fFloatIntervalCount] = pos;
+            fFloatIntervalCount++;
+        }
+        prevColor = color;
+        prevPos = pos;
+    }
 }
 
 SkGradientShaderBase::GradientShaderCache::GradientShaderCache(
         U8CPU alpha, const SkGradientShaderBase& shader)
     : fCacheAlpha(alpha)
-    , fShader(shader)
+    , fStopsLength(shader.writeStops(&fStops))
     , fCache16Inited(false)
     , fCache32Inited(false)
 {
@@ -538,19 +579,18 @@ void SkGradientShaderBase::GradientShaderCache::initCache16(GradientShaderCache*
     SkASSERT(NULL == cache->fCache16Storage);
     cache->fCache16Storage = (uint16_t*)sk_malloc_throw(allocSize);
     cache->fCache16 = cache->fCache16Storage;
-    if (cache->fShader.fColorCount == 2) {
-        Build16bitCache(cache->fCache16, cache->fShader.fOrigColors[0],
-                        cache->fShader.fOrigColors[1], kCache16Count);
+    const SkColor* colors = cache->colors();
+    if (cache->colorCount() == 2) {
+        Build16bitCache(cache->fCache16, colors[0], colors[1], kCache16Count);
     } else {
-        Rec* rec = cache->fShader.fRecs;
         int prevIndex = 0;
-        for (int i = 1; i < cache->fShader.fColorCount; i++) {
-            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache16Shift;
+        for (int i = 1; i < cache->colorCount(); i++) {
+            int nextIndex = SkFixedToFFFF(cache->stopPos(i)) >> kCache16Shift;
             SkASSERT(nextIndex < kCache16Count);
 
             if (nextIndex > prevIndex)
-                Build16bitCache(cache->fCache16 + prevIndex, cache->fShader.fOrigColors[i-1],
-                                cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1);
+                Build16bitCache(cache->fCache16 + prevIndex, colors[i-1], colors[i],
+                                nextIndex - prevIndex + 1);
             prevIndex = nextIndex;
         }
     }
@@ -570,34 +610,132 @@ void SkGradientShaderBase::GradientShaderCache::initCache32(GradientShaderCache*
     SkASSERT(NULL == cache->fCache32PixelRef);
     cache->fCache32PixelRef = SkMallocPixelRef::NewAllocate(info, 0, NULL);
     cache->fCache32 = (SkPMColor*)cache->fCache32PixelRef->getAddr();
-    if (cache->fShader.fColorCount == 2) {
-        Build32bitCache(cache->fCache32, cache->fShader.fOrigColors[0],
-                        cache->fShader.fOrigColors[1], kCache32Count, cache->fCacheAlpha,
-                        cache->fShader.fGradFlags);
+    const SkColor* colors = cache->colors();
+    if (cache->colorCount() == 2) {
+        Build32bitCache(cache->fCache32, colors[0], colors[1], kCache32Count, cache->fCacheAlpha,
+                        cache->gradFlags());
     } else {
-        Rec* rec = cache->fShader.fRecs;
         int prevIndex = 0;
-        for (int i = 1; i < cache->fShader.fColorCount; i++) {
-            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache32Shift;
+        for (int i = 1; i < cache->colorCount(); i++) {
+            int nextIndex = SkFixedToFFFF(cache->stopPos(i)) >> kCache32Shift;
             SkASSERT(nextIndex < kCache32Count);
 
             if (nextIndex > prevIndex)
-                Build32bitCache(cache->fCache32 + prevIndex, cache->fShader.fOrigColors[i-1],
-                                cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1,
-                                cache->fCacheAlpha, cache->fShader.fGradFlags);
+                Build32bitCache(cache->fCache32 + prevIndex, colors[i-1], colors[i],
+                                nextIndex - prevIndex + 1, cache->fCacheAlpha,
+                                cache->gradFlags());
             prevIndex = nextIndex;
         }
     }
 }
 
+namespace {
+static unsigned gGradientCacheKeyNamespaceLabel;
+
+// Charts and the like create many short-lived shaders with the same stops, so the tables are
+// shared by hashing the stops. The Rec's cache keeps its own copy of them to rule out collisions.
+struct GradientCacheKey : public SkResourceCache::Key {
+public:
+    GradientCacheKey(const int32_t stops[], int length, U8CPU alpha)
+        : fStopsHash(SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(stops),
+                                         length * sizeof(int32_t)))
+        , fStopsLength(length)
+        , fAlpha(alpha)
+    {
+        this->init(&gGradientCacheKeyNamespaceLabel, 0,
+                   sizeof(fStopsHash) + sizeof(fStopsLength) + sizeof(fAlpha));
+    }
+
+    uint32_t fStopsHash;
+    int32_t  fStopsLength;
+    uint32_t fAlpha;
+};
+
+struct GradientCacheContext {
+    const int32_t*                              fStops;
+    int                                         fStopsLength;
+    SkGradientShaderBase::GradientShaderCache** fCache;
+};
+
+struct GradientCacheRec : public SkResourceCache::Rec {
+    GradientCacheRec(const GradientCacheKey& key,
+                     SkGradientShaderBase::GradientShaderCache* cache)
+        : fKey(key)
+        , fCache(SkRef(cache)) {}
+
+    GradientCacheKey                                         fKey;
+    SkAutoTUnref<SkGradientShaderBase::GradientShaderCache> fCache;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        // The tables are built lazily; charge for both as if they were.
+        return sizeof(*this) + sizeof(SkGradientShaderBase::GradientShaderCache) +
+               fCache->stopsLength() * sizeof(int32_t) +
+               SkGradientShaderBase::kCache32Count * 4 * sizeof(SkPMColor) +
+               SkGradientShaderBase::kCache16Count * 2 * sizeof(uint16_t);
+    }
+    const char* getCategory() const override { return "gradient"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const GradientCacheRec& rec = static_cast<const GradientCacheRec&>(baseRec);
+        GradientCacheContext* context = static_cast<GradientCacheContext*>(contextData);
+        if (rec.fCache->stopsLength() != context->fStopsLength ||
+            memcmp(rec.fCache->stops(), context->fStops,
+                   context->fStopsLength * sizeof(int32_t))) {
+            // A hash collision; let the new stops' cache replace this one.
+            return false;
+        }
+        *context->fCache = SkRef(rec.fCache.get());
+        return true;
+    }
+};
+} // namespace
+
+SkGradientShaderBase::GradientShaderCache*
+SkGradientShaderBase::GradientShaderCache::FindOrCreate(U8CPU alpha,
+                                                        const SkGradientShaderBase& shader) {
+    SkAutoSTMalloc<16, int32_t> stops;
+    int length = shader.writeStops(&stops);
+
+    GradientCacheKey key(stops.get(), length, alpha);
+    GradientShaderCache* cache = NULL;
+    GradientCacheContext context = { stops.get(), length, &cache };
+    if (!SkResourceCache::Find(key, GradientCacheRec::Visitor, &context)) {
+        cache = SkNEW_ARGS(GradientShaderCache, (alpha, shader));
+        SkResourceCache::Add(SkNEW_ARGS(GradientCacheRec, (key, cache)));
+    }
+    return cache;
+}
+
+int SkGradientShaderBase::writeStops(SkAutoSTMalloc<16, int32_t>* stops) const {
+    int count = 1 + fColorCount + 1;
+    if (fColorCount > 2) {
+        count += fColorCount - 1;    // fRecs[].fPos
+    }
+
+    int32_t* buffer = stops->reset(count);
+
+    *buffer++ = fColorCount;
+    memcpy(buffer, fOrigColors, fColorCount * sizeof(SkColor));
+    buffer += fColorCount;
+    if (fColorCount > 2) {
+        for (int i = 1; i < fColorCount; i++) {
+            *buffer++ = fRecs[i].fPos;
+        }
+    }
+    *buffer++ = fGradFlags;
+    SkASSERT(buffer - stops->get() == count);
+    return count;
+}
+
 /*
- *  The gradient holds a cache for the most recent value of alpha. Successive
- *  callers with the same alpha value will share the same cache.
+ *  The gradient holds a cache for the most recent value of alpha, so successive callers with the
+ *  same alpha skip the global lookup. Caches are shared across gradients with the same stops.
  */
 SkGradientShaderBase::GradientShaderCache* SkGradientShaderBase::refCache(U8CPU alpha) const {
     SkAutoMutexAcquire ama(fCacheMutex);
     if (!fCache || fCache->getAlpha() != alpha) {
-        fCache.reset(SkNEW_ARGS(GradientShaderCache, (alpha, *this)));
+        fCache.reset(GradientShaderCache::FindOrCreate(alpha, *this));
     }
     // Increment the ref counter inside the mutex to ensure the returned pointer is still valid.
     // Otherwise, the pointer may have been overwritten on a different thread before the object's
@@ -606,60 +744,22 @@ SkGradientShaderBase::GradientShaderCache* SkGradientShaderBase::refCache(U8CPU
     return fCache;
 }
 
-SK_DECLARE_STATIC_MUTEX(gGradientCacheMutex);
 /*
  *  Because our caller might rebuild the same (logically the same) gradient
  *  over and over, we'd like to return exactly the same "bitmap" if possible,
  *  allowing the client to utilize a cache of our bitmap (e.g. with a GPU).
- *  To do that, we maintain a private cache of built-bitmaps, based on our
- *  colors and positions. Note: we don't try to flatten the fMapper, so if one
- *  is present, we skip the cache for now.
+ *  Gradients with the same stops share a GradientShaderCache, so handing out
+ *  its pixel ref gives them all the same generation ID.
  */
 void SkGradientShaderBase::getGradientTableBitmap(SkBitmap* bitmap) const {
     // our caller assumes no external alpha, so we ensure that our cache is
     // built with 0xFF
     SkAutoTUnref<GradientShaderCache> cache(this->refCache(0xFF));
 
-    // build our key: [numColors + colors[] + {positions[]} + flags ]
-    int count = 1 + fColorCount + 1;
-    if (fColorCount > 2) {
-        count += fColorCount - 1;    // fRecs[].fPos
-    }
-
-    SkAutoSTMalloc<16, int32_t> storage(count);
-    int32_t* buffer = storage.get();
-
-    *buffer++ = fColorCount;
-    memcpy(buffer, fOrigColors, fColorCount * sizeof(SkColor));
-    buffer += fColorCount;
-    if (fColorCount > 2) {
-        for (int i = 1; i < fColorCount; i++) {
-            *buffer++ = fRecs[i].fPos;
-        }
-    }
-    *buffer++ = fGradFlags;
-    SkASSERT(buffer - storage.get() == count);
-
-    ///////////////////////////////////
-
-    static SkGradientBitmapCache* gCache;
-    // each cache cost 1K of RAM, since each bitmap will be 1x256 at 32bpp
-    static const int MAX_NUM_CACHED_GRADIENT_BITMAPS = 32;
-    SkAutoMutexAcquire ama(gGradientCacheMutex);
-
-    if (NULL == gCache) {
-        gCache = SkNEW_ARGS(SkGradientBitmapCache, (MAX_NUM_CACHED_GRADIENT_BITMAPS));
-    }
-    size_t size = count * sizeof(int32_t);
-
-    if (!gCache->find(storage.get(), size, bitmap)) {
-        // force our cahce32pixelref to be built
-        (void)cache->getCache32();
-        bitmap->setInfo(SkImageInfo::MakeN32Premul(kCache32Count, 1));
-        bitmap->setPixelRef(cache->getCache32PixelRef());
-
-        gCache->add(storage.get(), size, *bitmap);
-    }
+    // force our cache32pixelref to be built
+    (void)cache->getCache32();
+    bitmap->setInfo(SkImageInfo::MakeN32Premul(kCache32Count, 1));
+    bitmap->setPixelRef(cache->getCache32PixelRef());
 }
 
 void SkGradientShaderBase::commonAsAGradient(GradientInfo* info, bool flipGrad) const {
@@ -1101,8 +1201,9 @@ GrGradientEffect::GrGradientEffect(GrContext* ctx,
         fRow = fAtlas->lockRow(bitmap);
         if (-1 != fRow) {
             fYCoord = fAtlas->getYOffset(fRow) + SK_ScalarHalf * fAtlas->getNormalizedTexelHeight();
-            fCoordTransform.reset(kCoordSet, matrix, fAtlas->getTexture(), params.filterMode());
-            fTextureAccess.reset(fAtlas->getTexture(), params);
+            GrTexture* texture = fAtlas->getTexture(fRow);
+            fCoordTransform.reset(kCoordSet, matrix, texture, params.filterMode());
+            fTextureAccess.reset(texture, params);
         } else {
             SkAutoTUnref<GrTexture> texture(GrRefCachedBitmapTexture(ctx, bitmap, &params));
             if (!texture) {
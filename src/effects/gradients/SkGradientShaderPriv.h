@@ -8,17 +8,18 @@
 #ifndef SkGradientShaderPriv_DEFINED
 #define SkGradientShaderPriv_DEFINED
 
-#include "SkGradientBitmapCache.h"
 #include "SkGradientShader.h"
 #include "SkClampRange.h"
 #include "SkColorPriv.h"
 #include "SkReadBuffer.h"
 #include "SkWriteBuffer.h"
 #include "SkMallocPixelRef.h"
+#include "SkBitmap.h"
 #include "SkUtils.h"
 #include "SkTemplates.h"
 #include "SkShader.h"
 #include "SkOnce.h"
+#include "SkPMFloat.h"
 
 static inline void sk_memset32_dither(uint32_t dst[], uint32_t v0, uint32_t v1,
                                int count) {
@@ -79,6 +80,19 @@ static const TileProc gTileProcs[] = {
     mirror_tileproc
 };
 
+// Float versions of the tile procs, mapping any t into [0, 1].
+static inline float tile_float(SkShader::TileMode mode, float t) {
+    if (SkShader::kRepeat_TileMode == mode) {
+        t = t - sk_float_floor(t);
+    } else if (SkShader::kMirror_TileMode == mode) {
+        t = t - 2 * sk_float_floor(t * 0.5f);
+        if (t > 1) {
+            t = 2 - t;
+        }
+    }
+    return SkTPin(t, 0.0f, 1.0f);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class SkGradientShaderBase : public SkShader {
@@ -124,12 +138,22 @@ public:
     SkGradientShaderBase(const Descriptor& desc, const SkMatrix& ptsToUnit);
     virtual ~SkGradientShaderBase();
 
-    // The cache is initialized on-demand when getCache16/32 is called.
+    /**
+     *  The cache is initialized on-demand when getCache16/32 is called. It keeps its own copy of
+     *  the stops, so gradients with the same stops share one cache (and one GPU table row)
+     *  through SkResourceCache; see FindOrCreate().
+     */
     class GradientShaderCache : public SkRefCnt {
     public:
         GradientShaderCache(U8CPU alpha, const SkGradientShaderBase& shader);
         ~GradientShaderCache();
 
+        /**
+         *  Returns a ref to the cache for shader's stops and alpha, shared with any other
+         *  gradient that has the same stops, creating it if needed.
+         */
+        static GradientShaderCache* FindOrCreate(U8CPU alpha, const SkGradientShaderBase& shader);
+
         const uint16_t*     getCache16();
         const SkPMColor*    getCache32();
 
@@ -137,7 +161,17 @@ public:
 
         unsigned getAlpha() const { return fCacheAlpha; }
 
+        // The stops this cache is built from, as written by SkGradientShaderBase::writeStops().
+        const int32_t* stops() const { return fStops.get(); }
+        int stopsLength() const { return fStopsLength; }
+
     private:
+        int colorCount() const { return fStops[0]; }
+        const SkColor* colors() const { return reinterpret_cast<const SkColor*>(&fStops[1]); }
+        // Only valid with more than two colors; for i > 0 the position is stored explicitly.
+        SkFixed stopPos(int i) const { return i ? fStops[this->colorCount() + i] : 0; }
+        uint32_t gradFlags() const { return fStops[fStopsLength - 1]; }
+
         // Working pointers. If either is NULL, we need to recompute the corresponding cache values.
         uint16_t*   fCache16;
         SkPMColor*  fCache32;
@@ -148,7 +182,8 @@ public:
                                               // Larger than 8bits so we can store uninitialized
                                               // value.
 
-        const SkGradientShaderBase& fShader;
+        SkAutoSTMalloc<16, int32_t> fStops;
+        int                         fStopsLength;
 
         // Make sure we only initialize the caches once.
         bool    fCache16Inited, fCache32Inited;
@@ -176,7 +211,39 @@ public:
 
         SkAutoTUnref<GradientShaderCache> fCache;
 
+        enum {
+            // Gradients with at most this many stops (counting any implied at 0 and 1) are
+            // shaded by interpolating the stops in float, rather than through fCache.
+            kMaxFloatStops = 8
+        };
+
+        /**
+         *  True if 32 bit spans should come from floatColorAt(). That skips building a 256 entry
+         *  table for every new paint alpha, and doesn't quantize t to 8 bits, so wide gradients
+         *  don't band.
+         */
+        bool useFloatStops() const { return fFloatIntervalCount > 0; }
+
+        /**
+         *  Returns the color at t, which must already be tiled into [0, 1]. The color is
+         *  interpolated in float, scaled by the paint alpha and dithered by toggle (see
+         *  init_dither_toggle) exactly as the cache would be, then packed once.
+         */
+        SkPMColor floatColorAt(float t, int toggle) const;
+
     private:
+        // For each interval between adjacent stops, the line through its end colors, as the
+        // color at t = 0 and the slope, in SkPMColor component order. fIntervalEnd[i] is the t
+        // where interval i stops; empty intervals are dropped.
+        float       fIntervalBase[kMaxFloatStops - 1][4];
+        float       fIntervalSlope[kMaxFloatStops - 1][4];
+        float       fIntervalEnd[kMaxFloatStops - 1];
+        int         fFloatIntervalCount;
+        // Set if the interpolated colors are unpremultiplied.
+        bool        fPremulAfterLerp;
+
+        void initFloatStops(const SkGradientShaderBase&, unsigned paintAlpha);
+
         typedef SkShader::Context INHERITED;
     };
 
@@ -184,6 +251,12 @@ public:
 
     void getGradientTableBitmap(SkBitmap*) const;
 
+    /**
+     *  Writes everything the color tables depend on: [count, colors[], positions[] (only with
+     *  more than two colors), flags]. Returns the number of int32s in stops.
+     */
+    int writeStops(SkAutoSTMalloc<16, int32_t>* stops) const;
+
     enum {
         /// Seems like enough for visual accuracy. TODO: if pos[] deserves
         /// it, use a larger cache.
@@ -280,6 +353,29 @@ static inline int next_dither_toggle(int toggle) {
     return toggle ^ SkGradientShaderBase::kDitherStride32;
 }
 
+inline SkPMColor SkGradientShaderBase::GradientShaderBaseContext::floatColorAt(float t,
+                                                                              int toggle) const {
+    // The cache's four dither rows add 0, 1/2, 3/4 and 1/4 of a step before truncating.
+    static const float kDitherBias[] = {
+        -0.5f / 255, 0, 0.25f / 255, -0.25f / 255
+    };
+    SkASSERT(t >= 0 && t <= 1);
+
+    int i = 0;
+    while (i < fFloatIntervalCount - 1 && t > fIntervalEnd[i]) {
+        i++;
+    }
+    Sk4f c = Sk4f::Load(fIntervalBase[i]) + Sk4f::Load(fIntervalSlope[i]) * Sk4f(t);
+    if (fPremulAfterLerp) {
+        const SkPMFloat kRGB = SkPMFloat::FromARGB(0, 1, 1, 1),
+                        kA   = SkPMFloat::FromARGB(1, 0, 0, 0);
+        c = c * (SkPMFloat(c).alphas() * kRGB + kA);
+    }
+    c = c + Sk4f(kDitherBias[toggle / kDitherStride32]);
+    // Keep float error from pushing a component past alpha.
+    return SkPMFloat(Sk4f::Min(c, SkPMFloat(c).alphas())).round();
+}
+
 static inline int init_dither_toggle16(int x, int y) {
     return ((x ^ y) & 1) * SkGradientShaderBase::kDitherStride16;
 }
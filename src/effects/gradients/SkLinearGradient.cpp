@@ -213,6 +213,11 @@ void SkLinearGradient::LinearGradientContext::shadeSpan(int x, int y, SkPMColor*
                                                         int count) {
     SkASSERT(count > 0);
 
+    if (this->useFloatStops()) {
+        this->shadeSpanFloat(x, y, dstC, count);
+        return;
+    }
+
     const SkLinearGradient& linearGradient = static_cast<const SkLinearGradient&>(fShader);
 
     SkPoint             srcPt;
@@ -261,6 +266,40 @@ void SkLinearGradient::LinearGradientContext::shadeSpan(int x, int y, SkPMColor*
     }
 }
 
+void SkLinearGradient::LinearGradientContext::shadeSpanFloat(int x, int y,
+                                                             SkPMColor* SK_RESTRICT dstC,
+                                                             int count) {
+    const SkShader::TileMode mode = static_cast<const SkLinearGradient&>(fShader).fTileMode;
+    int toggle = init_dither_toggle(x, y);
+    SkPoint srcPt;
+
+    if (fDstToIndexClass != kPerspective_MatrixClass) {
+        fDstToIndexProc(fDstToIndex, SkIntToScalar(x) + SK_ScalarHalf,
+                                     SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+        SkScalar dx;
+        if (fDstToIndexClass == kFixedStepInX_MatrixClass) {
+            SkFixed dxStorage[1];
+            (void)fDstToIndex.fixedStepInX(SkIntToScalar(y), dxStorage, NULL);
+            dx = SkFixedToScalar(dxStorage[0]);
+        } else {
+            SkASSERT(fDstToIndexClass == kLinear_MatrixClass);
+            dx = fDstToIndex.getScaleX();
+        }
+        // Step from the start of the span rather than accumulating, so long spans don't drift.
+        for (int i = 0; i < count; i++) {
+            *dstC++ = this->floatColorAt(tile_float(mode, srcPt.fX + i * dx), toggle);
+            toggle = next_dither_toggle(toggle);
+        }
+    } else {
+        for (int stop = x + count; x < stop; x++) {
+            fDstToIndexProc(fDstToIndex, SkIntToScalar(x) + SK_ScalarHalf,
+                                         SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+            *dstC++ = this->floatColorAt(tile_float(mode, srcPt.fX), toggle);
+            toggle = next_dither_toggle(toggle);
+        }
+    }
+}
+
 SkShader::BitmapType SkLinearGradient::asABitmap(SkBitmap* bitmap,
                                                 SkMatrix* matrix,
                                                 TileMode xy[]) const {
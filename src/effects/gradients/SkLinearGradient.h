@@ -25,6 +25,8 @@ public:
         void shadeSpan16(int x, int y, uint16_t dstC[], int count) override;
 
     private:
+        void shadeSpanFloat(int x, int y, SkPMColor dstC[], int count);
+
         typedef SkGradientShaderBase::GradientShaderBaseContext INHERITED;
     };
 
@@ -381,6 +381,11 @@ void SkRadialGradient::RadialGradientContext::shadeSpan(int x, int y,
                                                         SkPMColor* SK_RESTRICT dstC, int count) {
     SkASSERT(count > 0);
 
+    if (this->useFloatStops()) {
+        this->shadeSpanFloat(x, y, dstC, count);
+        return;
+    }
+
     const SkRadialGradient& radialGradient = static_cast<const SkRadialGradient&>(fShader);
 
     SkPoint             srcPt;
@@ -427,6 +432,43 @@ void SkRadialGradient::RadialGradientContext::shadeSpan(int x, int y,
     }
 }
 
+void SkRadialGradient::RadialGradientContext::shadeSpanFloat(int x, int y,
+                                                             SkPMColor* SK_RESTRICT dstC,
+                                                             int count) {
+    const SkShader::TileMode mode = static_cast<const SkRadialGradient&>(fShader).fTileMode;
+    int toggle = init_dither_toggle(x, y);
+    SkPoint srcPt;
+
+    if (fDstToIndexClass != kPerspective_MatrixClass) {
+        fDstToIndexProc(fDstToIndex, SkIntToScalar(x) + SK_ScalarHalf,
+                                     SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+        SkScalar dx = fDstToIndex.getScaleX();
+        SkScalar dy = fDstToIndex.getSkewY();
+        if (fDstToIndexClass == kFixedStepInX_MatrixClass) {
+            SkFixed storage[2];
+            (void)fDstToIndex.fixedStepInX(SkIntToScalar(y), &storage[0], &storage[1]);
+            dx = SkFixedToScalar(storage[0]);
+            dy = SkFixedToScalar(storage[1]);
+        } else {
+            SkASSERT(fDstToIndexClass == kLinear_MatrixClass);
+        }
+        for (int i = 0; i < count; i++) {
+            SkScalar fx = srcPt.fX + i * dx,
+                     fy = srcPt.fY + i * dy;
+            SkScalar t = sk_float_sqrt(fx * fx + fy * fy);
+            *dstC++ = this->floatColorAt(tile_float(mode, t), toggle);
+            toggle = next_dither_toggle(toggle);
+        }
+    } else {
+        for (int stop = x + count; x < stop; x++) {
+            fDstToIndexProc(fDstToIndex, SkIntToScalar(x) + SK_ScalarHalf,
+                                         SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+            *dstC++ = this->floatColorAt(tile_float(mode, srcPt.length()), toggle);
+            toggle = next_dither_toggle(toggle);
+        }
+    }
+}
+
 /////////////////////////////////////////////////////////////////////
 
 #if SK_SUPPORT_GPU
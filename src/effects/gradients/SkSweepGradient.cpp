@@ -91,6 +91,11 @@ static unsigned SkATan2_255(float y, float x) {
 
 void SkSweepGradient::SweepGradientContext::shadeSpan(int x, int y, SkPMColor* SK_RESTRICT dstC,
                                                       int count) {
+    if (this->useFloatStops()) {
+        this->shadeSpanFloat(x, y, dstC, count);
+        return;
+    }
+
     SkMatrix::MapXYProc proc = fDstToIndexProc;
     const SkMatrix&     matrix = fDstToIndex;
     const SkPMColor* SK_RESTRICT cache = fCache->getCache32();
@@ -131,6 +136,52 @@ void SkSweepGradient::SweepGradientContext::shadeSpan(int x, int y, SkPMColor* S
     }
 }
 
+//  returns angle in a circle [0..2PI) -> [0..1]
+static float sweep_t(float y, float x) {
+    static const float gOneOver2PI = 0.15915494309189535f;
+
+    float result = sk_float_atan2(y, x) * gOneOver2PI;
+    if (result < 0) {
+        result += 1;
+    }
+    return SkTPin(result, 0.0f, 1.0f);
+}
+
+void SkSweepGradient::SweepGradientContext::shadeSpanFloat(int x, int y,
+                                                           SkPMColor* SK_RESTRICT dstC,
+                                                           int count) {
+    int     toggle = init_dither_toggle(x, y);
+    SkPoint srcPt;
+
+    if (fDstToIndexClass != kPerspective_MatrixClass) {
+        fDstToIndexProc(fDstToIndex, SkIntToScalar(x) + SK_ScalarHalf,
+                                     SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+        SkScalar dx, dy;
+        if (fDstToIndexClass == kFixedStepInX_MatrixClass) {
+            SkFixed storage[2];
+            (void)fDstToIndex.fixedStepInX(SkIntToScalar(y) + SK_ScalarHalf,
+                                           &storage[0], &storage[1]);
+            dx = SkFixedToScalar(storage[0]);
+            dy = SkFixedToScalar(storage[1]);
+        } else {
+            SkASSERT(fDstToIndexClass == kLinear_MatrixClass);
+            dx = fDstToIndex.getScaleX();
+            dy = fDstToIndex.getSkewY();
+        }
+        for (int i = 0; i < count; i++) {
+            *dstC++ = this->floatColorAt(sweep_t(srcPt.fY + i * dy, srcPt.fX + i * dx), toggle);
+            toggle = next_dither_toggle(toggle);
+        }
+    } else {  // perspective case
+        for (int stop = x + count; x < stop; x++) {
+            fDstToIndexProc(fDstToIndex, SkIntToScalar(x) + SK_ScalarHalf,
+                                         SkIntToScalar(y) + SK_ScalarHalf, &srcPt);
+            *dstC++ = this->floatColorAt(sweep_t(srcPt.fY, srcPt.fX), toggle);
+            toggle = next_dither_toggle(toggle);
+        }
+    }
+}
+
 void SkSweepGradient::SweepGradientContext::shadeSpan16(int x, int y, uint16_t* SK_RESTRICT dstC,
                                                         int count) {
     SkMatrix::MapXYProc proc = fDstToIndexProc;
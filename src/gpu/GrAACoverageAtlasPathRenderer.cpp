@@ -0,0 +1,428 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrAACoverageAtlasPathRenderer.h"
+
+#include "GrBatchTarget.h"
+#include "GrContext.h"
+#include "GrPipelineBuilder.h"
+#include "GrResourceProvider.h"
+#include "GrStrokeInfo.h"
+#include "GrVertexBuffer.h"
+#include "batches/GrBatch.h"
+#include "effects/GrBitmapTextGeoProc.h"
+
+#include "SkDraw.h"
+#include "SkFloatBits.h"
+#include "SkRasterClip.h"
+
+#define ATLAS_TEXTURE_WIDTH 512
+#define ATLAS_TEXTURE_HEIGHT 512
+#define PLOT_WIDTH  128
+#define PLOT_HEIGHT 128
+
+#define NUM_PLOTS_X   (ATLAS_TEXTURE_WIDTH / PLOT_WIDTH)
+#define NUM_PLOTS_Y   (ATLAS_TEXTURE_HEIGHT / PLOT_HEIGHT)
+
+// only paths at most this many device pixels wide and tall are drawn
+static const int kMaxDeviceSize = 32;
+
+// masks are positioned to this fraction of a pixel
+static const int kSubpixelSteps = 4;
+
+// padding around the device bounds for antialiased pixels
+static const int kAntiAliasPad = 1;
+
+// Callback to clear out internal path cache when eviction occurs
+void GrAACoverageAtlasPathRenderer::HandleEviction(GrBatchAtlas::AtlasID id, void* pr) {
+    GrAACoverageAtlasPathRenderer* capr = (GrAACoverageAtlasPathRenderer*)pr;
+    // remove any paths that use this plot
+    PathDataList::Iter iter;
+    iter.init(capr->fPathList, PathDataList::Iter::kHead_IterStart);
+    PathData* pathData;
+    while ((pathData = iter.get())) {
+        iter.next();
+        if (id == pathData->fID) {
+            capr->fPathCache.remove(pathData->fKey);
+            capr->fPathList.remove(pathData);
+            SkDELETE(pathData);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+GrAACoverageAtlasPathRenderer::GrAACoverageAtlasPathRenderer() : fAtlas(NULL) {}
+
+GrAACoverageAtlasPathRenderer::~GrAACoverageAtlasPathRenderer() {
+    PathDataList::Iter iter;
+    iter.init(fPathList, PathDataList::Iter::kHead_IterStart);
+    PathData* pathData;
+    while ((pathData = iter.get())) {
+        iter.next();
+        fPathList.remove(pathData);
+        SkDELETE(pathData);
+    }
+    SkDELETE(fAtlas);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool GrAACoverageAtlasPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
+    if (!args.fAntiAlias || args.fPath->isInverseFillType() || args.fPath->isVolatile() ||
+        !args.fStroke->isFillStyle() || args.fViewMatrix->hasPerspective()) {
+        return false;
+    }
+
+    SkRect devBounds;
+    args.fViewMatrix->mapRect(&devBounds, args.fPath->getBounds());
+    return devBounds.width() <= kMaxDeviceSize && devBounds.height() <= kMaxDeviceSize;
+}
+
+GrPathRenderer::StencilSupport
+GrAACoverageAtlasPathRenderer::onGetStencilSupport(const GrDrawTarget*,
+                                                   const GrPipelineBuilder*,
+                                                   const SkPath&,
+                                                   const GrStrokeInfo&) const {
+    return GrPathRenderer::kNoSupport_StencilSupport;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Snaps a translate to a whole pixel plus a multiple of 1 / kSubpixelSteps. Returns the snapped
+// value and the subpixel step it landed on.
+static SkScalar quantize_translate(SkScalar t, uint32_t* step) {
+    SkScalar whole = SkScalarFloorToScalar(t);
+    int s = SkScalarRoundToInt((t - whole) * kSubpixelSteps);
+    if (s == kSubpixelSteps) {
+        whole += SK_Scalar1;
+        s = 0;
+    }
+    *step = s;
+    return whole + SkIntToScalar(s) / kSubpixelSteps;
+}
+
+// Where a path's mask lands for a view matrix, and the key of its cached coverage. The mask
+// content does not change when the translate moves by whole pixels, so only the subpixel step of
+// the translate is in the key.
+struct MaskPlacement {
+    MaskPlacement(const SkPath& path, const SkMatrix& viewMatrix) {
+        uint32_t stepX, stepY;
+        fDrawMatrix = viewMatrix;
+        fDrawMatrix.setTranslateX(quantize_translate(viewMatrix.getTranslateX(), &stepX));
+        fDrawMatrix.setTranslateY(quantize_translate(viewMatrix.getTranslateY(), &stepY));
+
+        SkRect devRect;
+        fDrawMatrix.mapRect(&devRect, path.getBounds());
+        devRect.roundOut(&fDevBounds);
+        fDevBounds.outset(kAntiAliasPad, kAntiAliasPad);
+        fDrawMatrix.postTranslate(-SkIntToScalar(fDevBounds.fLeft),
+                                  -SkIntToScalar(fDevBounds.fTop));
+
+        fKey.fGenID = path.getGenerationID();
+        fKey.fFillAndSubpixel = path.getFillType() | (stepX << 2) | (stepY << 5);
+        fKey.fMatrix[0] = SkFloat2Bits(viewMatrix.getScaleX());
+        fKey.fMatrix[1] = SkFloat2Bits(viewMatrix.getSkewX());
+        fKey.fMatrix[2] = SkFloat2Bits(viewMatrix.getSkewY());
+        fKey.fMatrix[3] = SkFloat2Bits(viewMatrix.getScaleY());
+    }
+
+    // maps the path into the mask's pixels
+    SkMatrix fDrawMatrix;
+    // the mask's device space rect
+    SkIRect fDevBounds;
+    GrAACoverageAtlasPathRenderer::PathData::Key fKey;
+};
+
+class AACoverageAtlasPathBatch : public GrBatch {
+public:
+    typedef GrAACoverageAtlasPathRenderer::PathData PathData;
+    typedef SkTDynamicHash<PathData, PathData::Key> PathCache;
+    typedef GrAACoverageAtlasPathRenderer::PathDataList PathDataList;
+
+    struct Geometry {
+        SkPath fPath;
+        SkMatrix fViewMatrix;
+        GrColor fColor;
+    };
+
+    static GrBatch* Create(const Geometry& geometry, GrBatchAtlas* atlas, PathCache* pathCache,
+                           PathDataList* pathList) {
+        return SkNEW_ARGS(AACoverageAtlasPathBatch, (geometry, atlas, pathCache, pathList));
+    }
+
+    const char* name() const override { return "AACoverageAtlasPathBatch"; }
+
+    void getInvariantOutputColor(GrInitInvariantOutput* out) const override {
+        // When this is called on a batch, there is only one geometry bundle
+        out->setKnownFourComponents(fGeoData[0].fColor);
+    }
+
+    void getInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
+        out->setUnknownSingleComponent();
+    }
+
+    void initBatchTracker(const GrPipelineInfo& init) override {
+        // Handle any color overrides
+        if (!init.readsColor()) {
+            fGeoData[0].fColor = GrColor_ILLEGAL;
+        }
+        init.getOverrideColorIfSet(&fGeoData[0].fColor);
+
+        // setup batch properties
+        fBatch.fColorIgnored = !init.readsColor();
+        fBatch.fUsesLocalCoords = init.readsLocalCoords();
+        fBatch.fCoverageIgnored = !init.readsCoverage();
+    }
+
+    struct FlushInfo {
+        SkAutoTUnref<const GrVertexBuffer> fVertexBuffer;
+        SkAutoTUnref<const GrIndexBuffer>  fIndexBuffer;
+        int fVertexOffset;
+        int fInstancesToFlush;
+    };
+
+    // The vertex layout of GrBitmapTextGeoProc for A8 masks.
+    struct Vertex {
+        SkPoint fPosition;
+        GrColor fColor;
+        int16_t fTexCoords[2];
+    };
+
+    void generateGeometry(GrBatchTarget* batchTarget) override {
+        int instanceCount = fGeoData.count();
+
+        // Quads are in device space; local coords map back through the shared view matrix.
+        SkMatrix localMatrix = SkMatrix::I();
+        if (this->usesLocalCoords() && !fGeoData[0].fViewMatrix.invert(&localMatrix)) {
+            SkDebugf("Could not invert viewmatrix\n");
+            return;
+        }
+
+        GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
+        GrBatchAtlas* atlas = fAtlas;
+        SkAutoTUnref<GrGeometryProcessor> gp(
+                GrBitmapTextGeoProc::Create(this->colorIgnored() ? GrColor_ILLEGAL : GrColor_WHITE,
+                                            atlas->getTexture(), params, kA8_GrMaskFormat,
+                                            localMatrix, this->usesLocalCoords()));
+
+        batchTarget->initDraw(gp, this->pipeline());
+
+        FlushInfo flushInfo;
+
+        // allocate vertices
+        size_t vertexStride = gp->getVertexStride();
+        SkASSERT(vertexStride == sizeof(Vertex));
+
+        const GrVertexBuffer* vertexBuffer;
+        void* vertices = batchTarget->makeVertSpace(vertexStride,
+                                                    kVerticesPerQuad * instanceCount,
+                                                    &vertexBuffer,
+                                                    &flushInfo.fVertexOffset);
+        flushInfo.fVertexBuffer.reset(SkRef(vertexBuffer));
+        flushInfo.fIndexBuffer.reset(batchTarget->resourceProvider()->refQuadIndexBuffer());
+        if (!vertices || !flushInfo.fIndexBuffer) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+
+        flushInfo.fInstancesToFlush = 0;
+        Vertex* verts = reinterpret_cast<Vertex*>(vertices);
+        for (int i = 0; i < instanceCount; i++) {
+            const Geometry& geom = fGeoData[i];
+            MaskPlacement placement(geom.fPath, geom.fViewMatrix);
+
+            // check to see if the mask is cached
+            PathData* pathData = fPathCache->find(placement.fKey);
+            if (NULL == pathData || !atlas->hasID(pathData->fID)) {
+                // Remove the stale cache entry
+                if (pathData) {
+                    fPathCache->remove(pathData->fKey);
+                    fPathList->remove(pathData);
+                    SkDELETE(pathData);
+                }
+                pathData = this->addPathToAtlas(batchTarget, gp, &flushInfo, atlas, geom.fPath,
+                                                placement);
+                if (!pathData) {
+                    SkDebugf("Can't rasterize path\n");
+                    return;
+                }
+            }
+
+            atlas->setLastUseToken(pathData->fID, batchTarget->currentToken());
+
+            const SkIRect& r = placement.fDevBounds;
+            int16_t u0 = pathData->fAtlasLocation.fX;
+            int16_t v0 = pathData->fAtlasLocation.fY;
+            int16_t u1 = u0 + r.width();
+            int16_t v1 = v0 + r.height();
+            Vertex* quad = verts + i * kVerticesPerQuad;
+            quad[0].fPosition.iset(r.fLeft, r.fTop);
+            quad[1].fPosition.iset(r.fLeft, r.fBottom);
+            quad[2].fPosition.iset(r.fRight, r.fBottom);
+            quad[3].fPosition.iset(r.fRight, r.fTop);
+            quad[0].fTexCoords[0] = u0;  quad[0].fTexCoords[1] = v0;
+            quad[1].fTexCoords[0] = u0;  quad[1].fTexCoords[1] = v1;
+            quad[2].fTexCoords[0] = u1;  quad[2].fTexCoords[1] = v1;
+            quad[3].fTexCoords[0] = u1;  quad[3].fTexCoords[1] = v0;
+            for (int j = 0; j < kVerticesPerQuad; ++j) {
+                quad[j].fColor = geom.fColor;
+            }
+            flushInfo.fInstancesToFlush++;
+        }
+
+        this->flush(batchTarget, &flushInfo);
+    }
+
+    SkSTArray<1, Geometry, true>* geoData() { return &fGeoData; }
+
+private:
+    AACoverageAtlasPathBatch(const Geometry& geometry, GrBatchAtlas* atlas, PathCache* pathCache,
+                             PathDataList* pathList) {
+        this->initClassID<AACoverageAtlasPathBatch>();
+        fGeoData.push_back(geometry);
+
+        fAtlas = atlas;
+        fPathCache = pathCache;
+        fPathList = pathList;
+
+        // Compute bounds
+        MaskPlacement placement(geometry.fPath, geometry.fViewMatrix);
+        fBounds.set(placement.fDevBounds);
+    }
+
+    PathData* addPathToAtlas(GrBatchTarget* batchTarget,
+                             const GrGeometryProcessor* gp,
+                             FlushInfo* flushInfo,
+                             GrBatchAtlas* atlas,
+                             const SkPath& path,
+                             const MaskPlacement& placement) {
+        int width = placement.fDevBounds.width();
+        int height = placement.fDevBounds.height();
+
+        SkAutoPixmapStorage dst;
+        if (!dst.tryAlloc(SkImageInfo::MakeA8(width, height))) {
+            return NULL;
+        }
+
+        // rasterize path
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        SkDraw draw;
+        sk_bzero(&draw, sizeof(draw));
+
+        SkRasterClip rasterClip;
+        rasterClip.setRect(SkIRect::MakeWH(width, height));
+        draw.fRC = &rasterClip;
+        draw.fClip = &rasterClip.bwRgn();
+        draw.fMatrix = &placement.fDrawMatrix;
+        draw.fDst = dst;
+
+        draw.drawPathCoverage(path, paint);
+
+        // add to atlas
+        SkIPoint16 atlasLocation;
+        GrBatchAtlas::AtlasID id;
+        bool success = atlas->addToAtlas(&id, batchTarget, width, height, dst.addr(),
+                                         &atlasLocation);
+        if (!success) {
+            this->flush(batchTarget, flushInfo);
+            batchTarget->initDraw(gp, this->pipeline());
+
+            SkDEBUGCODE(success =) atlas->addToAtlas(&id, batchTarget, width, height,
+                                                     dst.addr(), &atlasLocation);
+            SkASSERT(success);
+        }
+
+        // add to cache
+        PathData* pathData = SkNEW(PathData);
+        pathData->fKey = placement.fKey;
+        pathData->fID = id;
+        pathData->fAtlasLocation = atlasLocation;
+
+        fPathCache->add(pathData);
+        fPathList->addToTail(pathData);
+        return pathData;
+    }
+
+    void flush(GrBatchTarget* batchTarget, FlushInfo* flushInfo) {
+        if (!flushInfo->fInstancesToFlush) {
+            return;
+        }
+        GrVertices vertices;
+        int maxInstancesPerDraw = flushInfo->fIndexBuffer->maxQuads();
+        vertices.initInstanced(kTriangles_GrPrimitiveType, flushInfo->fVertexBuffer,
+            flushInfo->fIndexBuffer, flushInfo->fVertexOffset, kVerticesPerQuad,
+            kIndicesPerQuad, flushInfo->fInstancesToFlush, maxInstancesPerDraw);
+        batchTarget->draw(vertices);
+        flushInfo->fVertexOffset += kVerticesPerQuad * flushInfo->fInstancesToFlush;
+        flushInfo->fInstancesToFlush = 0;
+    }
+
+    bool usesLocalCoords() const { return fBatch.fUsesLocalCoords; }
+    bool colorIgnored() const { return fBatch.fColorIgnored; }
+
+    bool onCombineIfPossible(GrBatch* t) override {
+        if (!this->pipeline()->isEqual(*t->pipeline())) {
+            return false;
+        }
+
+        AACoverageAtlasPathBatch* that = t->cast<AACoverageAtlasPathBatch>();
+
+        // Colors are per vertex and positions are in device space, so only the local coords
+        // need a common view matrix.
+        SkASSERT(this->usesLocalCoords() == that->usesLocalCoords());
+        if (this->usesLocalCoords() &&
+            !fGeoData[0].fViewMatrix.cheapEqualTo(that->fGeoData[0].fViewMatrix)) {
+            return false;
+        }
+
+        fGeoData.push_back_n(that->geoData()->count(), that->geoData()->begin());
+        this->joinBounds(that->bounds());
+        return true;
+    }
+
+    struct BatchTracker {
+        bool fUsesLocalCoords;
+        bool fColorIgnored;
+        bool fCoverageIgnored;
+    };
+
+    BatchTracker fBatch;
+    SkSTArray<1, Geometry, true> fGeoData;
+    GrBatchAtlas* fAtlas;
+    PathCache* fPathCache;
+    PathDataList* fPathList;
+};
+
+bool GrAACoverageAtlasPathRenderer::onDrawPath(const DrawPathArgs& args) {
+    // we've already bailed on inverse filled paths, so this is safe
+    if (args.fPath->isEmpty()) {
+        return true;
+    }
+
+    if (!fAtlas) {
+        fAtlas = args.fResourceProvider->createAtlas(kAlpha_8_GrPixelConfig,
+                                                     ATLAS_TEXTURE_WIDTH, ATLAS_TEXTURE_HEIGHT,
+                                                     NUM_PLOTS_X, NUM_PLOTS_Y,
+                                                     &GrAACoverageAtlasPathRenderer::HandleEviction,
+                                                     (void*)this);
+        if (!fAtlas) {
+            return false;
+        }
+    }
+
+    AACoverageAtlasPathBatch::Geometry geometry;
+    geometry.fPath = *args.fPath;
+    geometry.fViewMatrix = *args.fViewMatrix;
+    geometry.fColor = args.fColor;
+
+    SkAutoTUnref<GrBatch> batch(AACoverageAtlasPathBatch::Create(geometry, fAtlas, &fPathCache,
+                                                                 &fPathList));
+    args.fTarget->drawBatch(*args.fPipelineBuilder, batch);
+
+    return true;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrAACoverageAtlasPathRenderer_DEFINED
+#define GrAACoverageAtlasPathRenderer_DEFINED
+
+#include "GrBatchAtlas.h"
+#include "GrPathRenderer.h"
+
+#include "SkChecksum.h"
+#include "SkTDynamicHash.h"
+#include "SkTInternalLList.h"
+
+/**
+ * Renders small antialiased filled paths by rasterizing their exact A8 coverage on the CPU into a
+ * shared atlas, then drawing textured quads in device space. Unlike the distance field path
+ * renderer the masks are not scale independent, so each mask is cached for the path's gen ID,
+ * fill type, the view matrix's 2x2 part and a quarter pixel subpixel position. Plots are
+ * recycled least-recently-used by GrBatchAtlas, so many tiny icons drawn every frame cost one
+ * batched draw.
+ */
+class GrAACoverageAtlasPathRenderer : public GrPathRenderer {
+public:
+    GrAACoverageAtlasPathRenderer();
+    virtual ~GrAACoverageAtlasPathRenderer();
+
+private:
+    StencilSupport onGetStencilSupport(const GrDrawTarget*,
+                                       const GrPipelineBuilder*,
+                                       const SkPath&,
+                                       const GrStrokeInfo&) const override;
+
+    bool onCanDrawPath(const CanDrawPathArgs&) const override;
+
+    bool onDrawPath(const DrawPathArgs&) override;
+
+    struct PathData {
+        struct Key {
+            uint32_t fGenID;
+            // fill type and the subpixel steps of the mask's origin
+            uint32_t fFillAndSubpixel;
+            // the view matrix's scale and skew, bitwise
+            uint32_t fMatrix[4];
+            bool operator==(const Key& other) const {
+                return 0 == memcmp(this, &other, sizeof(Key));
+            }
+        };
+        Key                   fKey;
+        GrBatchAtlas::AtlasID fID;
+        SkIPoint16            fAtlasLocation;
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(PathData);
+
+        static inline const Key& GetKey(const PathData& data) {
+            return data.fKey;
+        }
+
+        static inline uint32_t Hash(const Key& key) {
+            return SkChecksum::Murmur3(reinterpret_cast<const uint32_t*>(&key), sizeof(key));
+        }
+    };
+
+    static void HandleEviction(GrBatchAtlas::AtlasID, void*);
+
+    typedef SkTDynamicHash<PathData, PathData::Key> PathCache;
+    typedef SkTInternalLList<PathData> PathDataList;
+
+    GrBatchAtlas*                      fAtlas;
+    PathCache                          fPathCache;
+    PathDataList                       fPathList;
+
+    typedef GrPathRenderer INHERITED;
+
+    friend class AACoverageAtlasPathBatch;
+    friend struct MaskPlacement;
+};
+
+#endif
@@ -11,6 +11,7 @@
 #include "GrAAHairLinePathRenderer.h"
 #include "GrAAConvexPathRenderer.h"
 #include "GrAALinearizingConvexPathRenderer.h"
+#include "GrAACoverageAtlasPathRenderer.h"
 #include "GrAADistanceFieldPathRenderer.h"
 #include "GrContext.h"
 #include "GrDashLinePathRenderer.h"
@@ -30,5 +31,6 @@ void GrPathRenderer::AddPathRenderers(GrContext* ctx, GrPathRendererChain* chain
     }
     chain->addPathRenderer(SkNEW(GrAAConvexPathRenderer))->unref();
     chain->addPathRenderer(SkNEW(GrAALinearizingConvexPathRenderer))->unref();
+    chain->addPathRenderer(SkNEW(GrAACoverageAtlasPathRenderer))->unref();
     chain->addPathRenderer(SkNEW(GrAADistanceFieldPathRenderer))->unref();
 }
@@ -41,9 +41,9 @@ struct GrAtlasTextBlob : public SkRefCnt {
     /*
      * Each Run inside of the blob can have its texture coordinates regenerated if required.
      * To determine if regeneration is necessary, fAtlasGeneration is used.  If there have been
-     * any evictions inside of the atlas, then we will simply regenerate Runs.  We could track
-     * this at a more fine grained level, but its not clear if this is worth it, as evictions
-     * should be fairly rare.
+     * any evictions inside of the atlas, then we check whether any of the plots recorded in the
+     * SubRun's fBulkUseToken were among them, and only regenerate if so.  Heavy multi-language
+     * text can evict plots often, and most SubRuns only touch a plot or two.
      *
      * One additional point, each run can contain glyphs with any of the three mask formats.
      * We call these SubRuns.  Because a subrun must be a contiguous range, we have to create
@@ -77,7 +77,9 @@ struct GrAtlasTextBlob : public SkRefCnt {
                 , fVertexEndIndex(0)
                 , fGlyphStartIndex(0)
                 , fGlyphEndIndex(0)
-                , fDrawAsDistanceFields(false) {}
+                , fDrawAsDistanceFields(false) {
+                fTranslate.set(0, 0);
+            }
             SubRunInfo(const SubRunInfo& that)
                 : fBulkUseToken(that.fBulkUseToken)
                 , fStrike(SkSafeRef(that.fStrike.get()))
@@ -86,6 +88,7 @@ struct GrAtlasTextBlob : public SkRefCnt {
                 , fVertexEndIndex(that.fVertexEndIndex)
                 , fGlyphStartIndex(that.fGlyphStartIndex)
                 , fGlyphEndIndex(that.fGlyphEndIndex)
+                , fTranslate(that.fTranslate)
                 , fTextRatio(that.fTextRatio)
                 , fMaskFormat(that.fMaskFormat)
                 , fDrawAsDistanceFields(that.fDrawAsDistanceFields)
@@ -105,6 +108,9 @@ struct GrAtlasTextBlob : public SkRefCnt {
             size_t fVertexEndIndex;
             uint32_t fGlyphStartIndex;
             uint32_t fGlyphEndIndex;
+            // Device space translation that bitmap text applies in the vertex shader instead of
+            // writing it into fVertices.
+            SkVector fTranslate;
             SkScalar fTextRatio; // df property
             GrMaskFormat fMaskFormat;
             bool fDrawAsDistanceFields; // df property
@@ -234,9 +240,11 @@ struct GrAtlasTextBlob : public SkRefCnt {
     void setHasDistanceField() { fTextType |= kHasDistanceField_TextType; }
     void setHasBitmap() { fTextType |= kHasBitmap_TextType; }
 
+    // The bytes allocated for this blob from its pool
+    size_t fSize;
+
 #ifdef CACHE_SANITY_CHECK
     static void AssertEqual(const GrAtlasTextBlob&, const GrAtlasTextBlob&);
-    size_t fSize;
 #endif
 };
 
@@ -62,6 +62,16 @@ static const int kLargeDFFontLimit = 384;
 static const int kLargeDFFontLimit = 2 * kLargeDFFontSize;
 #endif
 
+static const int kDFFontSizes[] = { kSmallDFFontSize, kMediumDFFontSize, kLargeDFFontSize };
+
+// The flags distance field glyphs are generated with, whatever the paint asked for.
+static void set_distance_field_flags(SkPaint* skPaint) {
+    skPaint->setLCDRenderText(false);
+    skPaint->setAutohinted(false);
+    skPaint->setHinting(SkPaint::kNormal_Hinting);
+    skPaint->setSubpixelText(true);
+}
+
 SkDEBUGCODE(static const int kExpectedDistanceAdjustTableSize = 8;)
 static const int kDistanceAdjustLumShift = 5;
 
@@ -654,10 +664,20 @@ inline void GrAtlasTextContext::initDistanceFieldPaint(GrAtlasTextBlob* blob,
     blob->fMaxMinScale = SkMaxScalar(dfMaskScaleFloor / scaledTextSize, blob->fMaxMinScale);
     blob->fMinMaxScale = SkMinScalar(dfMaskScaleCeil / scaledTextSize, blob->fMinMaxScale);
 
-    skPaint->setLCDRenderText(false);
-    skPaint->setAutohinted(false);
-    skPaint->setHinting(SkPaint::kNormal_Hinting);
-    skPaint->setSubpixelText(true);
+    set_distance_field_flags(skPaint);
+}
+
+void GrAtlasTextContext::GetDistanceFieldDescriptor(const SkPaint& paint, int sizeIndex,
+                                                    SkAutoDescriptor* desc) {
+    SK_COMPILE_ASSERT(SK_ARRAY_COUNT(kDFFontSizes) == kDistanceFieldSizeCount,
+                      df_font_sizes_mismatch);
+    SkASSERT(sizeIndex >= 0 && sizeIndex < kDistanceFieldSizeCount);
+    SkPaint dfPaint(paint);
+    dfPaint.setTextSize(SkIntToScalar(kDFFontSizes[sizeIndex]));
+    set_distance_field_flags(&dfPaint);
+    // Without LCD text the surface's pixel geometry doesn't change the descriptor.
+    dfPaint.getScalerContextDescriptor(desc, SkSurfaceProps(0, kUnknown_SkPixelGeometry), NULL,
+                                       true);
 }
 
 inline void GrAtlasTextContext::fallbackDrawPosText(GrAtlasTextBlob* blob,
@@ -1566,7 +1586,8 @@ public:
                                                  params,
                                                  maskFormat,
                                                  localMatrix,
-                                                 this->usesLocalCoords()));
+                                                 this->usesLocalCoords(),
+                                                 this->accumulateTranslations()));
         }
 
         FlushInfo flushInfo;
@@ -1608,15 +1629,26 @@ public:
             TextInfo& info = run.fSubRunInfo[args.fSubRun];
 
             uint64_t currentAtlasGen = fFontCache->atlasGeneration(maskFormat);
-            bool regenerateTextureCoords = info.fAtlasGeneration != currentAtlasGen ||
-                                           info.fStrike->isAbandoned();
+            bool regenerateTextureCoords = info.fStrike->isAbandoned();
+            if (!regenerateTextureCoords && info.fAtlasGeneration != currentAtlasGen) {
+                // Something has been evicted since we placed these glyphs, but unless it was one
+                // of the plots this subrun uses, its texture coords are still good.
+                regenerateTextureCoords =
+                        GrBatchAtlas::kInvalidAtlasGeneration == info.fAtlasGeneration ||
+                        !fFontCache->hasGlyphsInBulk(info.fBulkUseToken, maskFormat);
+                if (!regenerateTextureCoords) {
+                    info.fAtlasGeneration = currentAtlasGen;
+                }
+            }
             bool regenerateColors;
             if (usesDistanceFields) {
                 regenerateColors = !isLCD && run.fColor != args.fColor;
             } else {
                 regenerateColors = kA8_GrMaskFormat == maskFormat && run.fColor != args.fColor;
             }
-            bool regeneratePositions = args.fTransX != 0.f || args.fTransY != 0.f;
+            // Bitmap text is moved by the geometry processor, see accumulateTranslations().
+            bool regeneratePositions = usesDistanceFields &&
+                                       (args.fTransX != 0.f || args.fTransY != 0.f);
             int glyphCount = info.fGlyphEndIndex - info.fGlyphStartIndex;
 
             // We regenerate both texture coords and colors in the blob itself, and update the
@@ -1667,6 +1699,19 @@ public:
                     } else {
                         strike = info.fStrike;
                     }
+
+                    // Rasterize every glyph headed for the atlas up front, so that a subrun full
+                    // of new glyphs is rendered in parallel rather than one at a time below.
+                    SkSTArray<64, GrGlyph::PackedID, true> newGlyphs;
+                    for (int glyphIdx = 0; glyphIdx < glyphCount; glyphIdx++) {
+                        GrGlyph* glyph = blob->fGlyphs[glyphIdx + info.fGlyphStartIndex];
+                        if (regenerateGlyphs || !fFontCache->hasGlyph(glyph)) {
+                            newGlyphs.push_back(glyph->fPackedID);
+                        }
+                    }
+                    if (newGlyphs.count() > 1) {
+                        scaler->prepareGlyphImages(newGlyphs.begin(), newGlyphs.count());
+                    }
                 }
 
                 for (int glyphIdx = 0; glyphIdx < glyphCount; glyphIdx++) {
@@ -1757,6 +1802,19 @@ public:
             size_t byteCount = info.fVertexEndIndex - info.fVertexStartIndex;
             memcpy(currVertex, blob->fVertices + info.fVertexStartIndex, byteCount);
 
+            // The geometry processor applies the first geometry's translation.  Geometries that
+            // were moved by a different amount make up the difference in the copy, which leaves
+            // the blob's own vertices untouched.
+            if (!usesDistanceFields && (args.fTransX != fGeoData[0].fTransX ||
+                                        args.fTransY != fGeoData[0].fTransY)) {
+                SkScalar dx = args.fTransX - fGeoData[0].fTransX;
+                SkScalar dy = args.fTransY - fGeoData[0].fTransY;
+                for (size_t offset = 0; offset < byteCount; offset += vertexStride) {
+                    SkPoint* point = reinterpret_cast<SkPoint*>(currVertex + offset);
+                    point->offset(dx, dy);
+                }
+            }
+
             currVertex += byteCount;
         }
         // Make sure to attach the last cache if applicable
@@ -1866,6 +1924,23 @@ private:
         }
     }
 
+    // Rather than rewriting a cached blob's vertices every time it scrolls, bitmap text leaves them
+    // where they were generated and accumulates the device space translation in the subrun. This
+    // folds each geometry's translation into its subrun, replaces the geometry's translation with
+    // the subrun's total, and returns the total for the first geometry, which the geometry
+    // processor applies as a uniform.
+    SkVector accumulateTranslations() {
+        SkASSERT(!this->usesDistanceFields());
+        for (int i = 0; i < fGeoCount; i++) {
+            Geometry& args = fGeoData[i];
+            TextInfo& info = args.fBlob->fRuns[args.fRun].fSubRunInfo[args.fSubRun];
+            info.fTranslate.offset(args.fTransX, args.fTransY);
+            args.fTransX = info.fTranslate.fX;
+            args.fTransY = info.fTranslate.fY;
+        }
+        return SkVector::Make(fGeoData[0].fTransX, fGeoData[0].fTransY);
+    }
+
     void regeneratePositions(intptr_t vertex, size_t vertexStride, SkScalar transX,
                              SkScalar transY) {
         for (int i = 0; i < kVerticesPerGlyph; i++) {
@@ -32,6 +32,12 @@ class GrAtlasTextContext : public GrTextContext {
 public:
     static GrAtlasTextContext* Create(GrContext*, GrDrawContext*, const SkSurfaceProps&);
 
+    // Distance field text is drawn from glyphs generated at one of kDistanceFieldSizeCount text
+    // sizes. This makes the descriptor of the strike that text drawn with the paint takes its
+    // glyphs from at the sizeIndex'th size, so they can be generated ahead of time.
+    static const int kDistanceFieldSizeCount = 3;
+    static void GetDistanceFieldDescriptor(const SkPaint&, int sizeIndex, SkAutoDescriptor*);
+
 private:
     GrAtlasTextContext(GrContext*, GrDrawContext*, const SkSurfaceProps&);
     ~GrAtlasTextContext() override {}
@@ -373,8 +373,18 @@ void GrBatchAtlas::setLastUseToken(AtlasID id, BatchToken batchToken) {
 void GrBatchAtlas::setLastUseTokenBulk(const BulkUseTokenUpdater& updater, BatchToken batchToken) {
     int count = updater.fPlotsToUpdate.count();
     for (int i = 0; i < count; i++) {
-        BatchPlot* plot = fPlotArray[updater.fPlotsToUpdate[i]];
+        BatchPlot* plot = fPlotArray[GetIndexFromID(updater.fPlotsToUpdate[i])];
         this->makeMRU(plot);
         plot->setLastUseToken(batchToken);
     }
 }
+
+bool GrBatchAtlas::hasIDs(const BulkUseTokenUpdater& updater) {
+    int count = updater.fPlotsToUpdate.count();
+    for (int i = 0; i < count; i++) {
+        if (!this->hasID(updater.fPlotsToUpdate[i])) {
+            return false;
+        }
+    }
+    return true;
+}
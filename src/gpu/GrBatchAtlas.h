@@ -62,7 +62,8 @@ public:
     /*
      * A class which can be handed back to GrBatchAtlas for updating in bulk last use tokens.  The
      * current max number of plots the GrBatchAtlas can handle is 32, if in the future this is
-     * insufficient then we can move to a 64 bit int
+     * insufficient then we can move to a 64 bit int.  It remembers the generation of each plot it
+     * was given, so hasIDs() can tell whether any of them have since been evicted.
      */
     class BulkUseTokenUpdater {
     public:
@@ -75,7 +76,7 @@ public:
         void add(AtlasID id) {
             int index = GrBatchAtlas::GetIndexFromID(id);
             if (!this->find(index)) {
-                this->set(index);
+                this->set(id);
             }
         }
 
@@ -90,15 +91,16 @@ public:
             return (fPlotAlreadyUpdated >> index) & 1;
         }
 
-        void set(int index) {
+        void set(AtlasID id) {
+            int index = GrBatchAtlas::GetIndexFromID(id);
             SkASSERT(!this->find(index));
             fPlotAlreadyUpdated = fPlotAlreadyUpdated | (1 << index);
-            fPlotsToUpdate.push_back(index);
+            fPlotsToUpdate.push_back(id);
         }
 
         static const int kMinItems = 4;
         static const int kMaxPlots = 32;
-        SkSTArray<kMinItems, int, true> fPlotsToUpdate;
+        SkSTArray<kMinItems, AtlasID, true> fPlotsToUpdate;
         uint32_t fPlotAlreadyUpdated;
 
         friend class GrBatchAtlas;
@@ -106,6 +108,12 @@ public:
 
     void setLastUseTokenBulk(const BulkUseTokenUpdater& reffer, BatchToken);
 
+    // Returns true if none of the plots in the updater have been evicted since they were added to
+    // it, ie everything placed in them then is still where it was.  This lets a client whose data
+    // lives in a few plots skip regenerating it when the atlasGeneration moves on because of
+    // evictions elsewhere.
+    bool hasIDs(const BulkUseTokenUpdater&);
+
     static const int kGlyphMaxDim = 256;
     static bool GlyphTooLargeForAtlas(int width, int height) {
         return width > kGlyphMaxDim || height > kGlyphMaxDim;
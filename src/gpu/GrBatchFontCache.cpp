@@ -45,7 +45,10 @@ bool GrBatchFontCache::initAtlas(GrMaskFormat format) {
 
 GrBatchFontCache::GrBatchFontCache(GrContext* context)
     : fContext(context)
-    , fPreserveStrike(NULL) {
+    , fPreserveStrike(NULL)
+    , fHits(0)
+    , fMisses(0)
+    , fEvictions(0) {
     for (int i = 0; i < kMaskFormatCount; ++i) {
         fAtlases[i] = NULL;
     }
@@ -61,6 +64,7 @@ GrBatchFontCache::~GrBatchFontCache() {
     for (int i = 0; i < kMaskFormatCount; ++i) {
         SkDELETE(fAtlases[i]);
     }
+    fDistanceFieldGlyphSets.unrefAll();
 }
 
 void GrBatchFontCache::freeAll() {
@@ -77,8 +81,27 @@ void GrBatchFontCache::freeAll() {
     }
 }
 
+void GrBatchFontCache::addDistanceFieldGlyphs(const GrDistanceFieldGlyphSet* set) {
+    *fDistanceFieldGlyphSets.append() = SkRef(set);
+
+    SkTDynamicHash<GrBatchTextStrike, GrFontDescKey>::Iter iter(&fCache);
+    for (; !iter.done(); ++iter) {
+        this->attachDistanceFieldGlyphs(&*iter, set);
+    }
+}
+
+void GrBatchFontCache::attachDistanceFieldGlyphs(GrBatchTextStrike* strike,
+                                                 const GrDistanceFieldGlyphSet* set) {
+    int index = set->findStrike(*strike->fFontScalerKey);
+    if (index >= 0) {
+        strike->fDistanceFieldGlyphs.reset(SkRef(set));
+        strike->fDistanceFieldStrikeIndex = index;
+    }
+}
+
 void GrBatchFontCache::HandleEviction(GrBatchAtlas::AtlasID id, void* ptr) {
     GrBatchFontCache* fontCache = reinterpret_cast<GrBatchFontCache*>(ptr);
+    fontCache->fEvictions++;
 
     SkTDynamicHash<GrBatchTextStrike, GrFontDescKey>::Iter iter(&fontCache->fCache);
     for (; !iter.done(); ++iter) {
@@ -95,6 +118,21 @@ void GrBatchFontCache::HandleEviction(GrBatchAtlas::AtlasID id, void* ptr) {
     }
 }
 
+void GrBatchFontCache::getStats(SkCacheStats* stats) const {
+    stats->fName = "font-atlas";
+    stats->fHits = fHits;
+    stats->fMisses = fMisses;
+    stats->fEvictions = fEvictions;
+    stats->fBytes = 0;
+    for (int i = 0; i < kMaskFormatCount; ++i) {
+        GrTexture* texture = fAtlases[i] ? fAtlases[i]->getTexture() : NULL;
+        if (texture) {
+            stats->fBytes += texture->gpuMemorySize();
+        }
+    }
+    stats->fEntries = fCache.count();
+}
+
 void GrBatchFontCache::dump() const {
     static int gDumpCount = 0;
     for (int i = 0; i < kMaskFormatCount; ++i) {
@@ -127,6 +165,7 @@ void GrBatchFontCache::dump() const {
 GrBatchTextStrike::GrBatchTextStrike(GrBatchFontCache* cache, const GrFontDescKey* key)
     : fFontScalerKey(SkRef(key))
     , fPool(9/*start allocations at 512 bytes*/)
+    , fDistanceFieldStrikeIndex(-1)
     , fAtlasedGlyphs(0)
     , fIsAbandoned(false) {
 
@@ -185,14 +224,22 @@ bool GrBatchTextStrike::addGlyphToAtlas(GrBatchTarget* batchTarget, GrGlyph* gly
     int bytesPerPixel = GrMaskFormatBytesPerPixel(expectedMaskFormat);
 
     size_t size = glyph->fBounds.area() * bytesPerPixel;
-    SkAutoSMalloc<1024> storage(size);
+    SkAutoSMalloc<1024> storage;
+    const void* image = NULL;
 
     if (GrGlyph::kDistance_MaskStyle == GrGlyph::UnpackMaskStyle(glyph->fPackedID)) {
-        if (!scaler->getPackedGlyphDFImage(skGlyph, glyph->width(), glyph->height(),
-                                           storage.get())) {
-            return false;
+        if (fDistanceFieldGlyphs && kA8_GrMaskFormat == expectedMaskFormat) {
+            image = fDistanceFieldGlyphs->findImage(fDistanceFieldStrikeIndex, skGlyph);
+        }
+        if (NULL == image) {
+            image = storage.reset(size);
+            if (!scaler->getPackedGlyphDFImage(skGlyph, glyph->width(), glyph->height(),
+                                               storage.get())) {
+                return false;
+            }
         }
     } else {
+        image = storage.reset(size);
         if (!scaler->getPackedGlyphImage(skGlyph, glyph->width(), glyph->height(),
                                          glyph->width() * bytesPerPixel, expectedMaskFormat,
                                          storage.get())) {
@@ -202,7 +249,7 @@ bool GrBatchTextStrike::addGlyphToAtlas(GrBatchTarget* batchTarget, GrGlyph* gly
 
     bool success = fBatchFontCache->addToAtlas(this, &glyph->fID, batchTarget, expectedMaskFormat,
                                                glyph->width(), glyph->height(),
-                                               storage.get(), &glyph->fAtlasLocation);
+                                               image, &glyph->fAtlasLocation);
     if (success) {
         SkASSERT(GrBatchAtlas::kInvalidAtlasID != glyph->fID);
         fAtlasedGlyphs++;
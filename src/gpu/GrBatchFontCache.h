@@ -9,8 +9,10 @@
 #define GrBatchFontCache_DEFINED
 
 #include "GrBatchAtlas.h"
+#include "GrDistanceFieldGlyphSet.h"
 #include "GrFontScaler.h"
 #include "GrGlyph.h"
+#include "SkCacheStats.h"
 #include "SkGlyph.h"
 #include "SkTDynamicHash.h"
 #include "SkVarAlloc.h"
@@ -83,6 +85,10 @@ private:
     SkAutoTUnref<const GrFontDescKey> fFontScalerKey;
     SkVarAlloc fPool;
 
+    // Precomputed distance fields for this strike's glyphs, if a set has them.
+    SkAutoTUnref<const GrDistanceFieldGlyphSet> fDistanceFieldGlyphs;
+    int fDistanceFieldStrikeIndex;
+
     GrBatchFontCache* fBatchFontCache;
     int fAtlasedGlyphs;
     bool fIsAbandoned;
@@ -111,13 +117,20 @@ public:
     inline GrBatchTextStrike* getStrike(GrFontScaler* scaler) {
         GrBatchTextStrike* strike = fCache.find(*(scaler->getKey()));
         if (NULL == strike) {
+            fMisses++;
             strike = this->generateStrike(scaler);
+        } else {
+            fHits++;
         }
         return strike;
     }
 
     void freeAll();
 
+    // Distance field text drawn in the style of the set's strikes copies the set's glyphs into
+    // the atlas instead of generating them. The cache keeps a ref to the set.
+    void addDistanceFieldGlyphs(const GrDistanceFieldGlyphSet*);
+
     // if getTexture returns NULL, the client must not try to use other functions on the
     // GrBatchFontCache which use the atlas.  This function *must* be called first, before other
     // functions which use the atlas.
@@ -151,6 +164,12 @@ public:
         this->getAtlas(format)->setLastUseTokenBulk(updater, token);
     }
 
+    // Returns true if none of the plots holding the updater's glyphs have been evicted since
+    // the glyphs were added to it.
+    bool hasGlyphsInBulk(const GrBatchAtlas::BulkUseTokenUpdater& updater, GrMaskFormat format) {
+        return this->getAtlas(format)->hasIDs(updater);
+    }
+
     // add to texture atlas that matches this format
     bool addToAtlas(GrBatchTextStrike* strike, GrBatchAtlas::AtlasID* id,
                     GrBatchTarget* batchTarget,
@@ -169,6 +188,10 @@ public:
 
     void dump() const;
 
+    // Reports the cache as "font-atlas": strike lookups, the strikes held and the bytes of the
+    // atlas textures. Evictions counts glyph atlas plots that were evicted.
+    void getStats(SkCacheStats*) const;
+
 private:
     static GrPixelConfig MaskFormatToPixelConfig(GrMaskFormat format) {
         static const GrPixelConfig kPixelConfigs[] = {
@@ -198,10 +221,15 @@ private:
 
     GrBatchTextStrike* generateStrike(GrFontScaler* scaler) {
         GrBatchTextStrike* strike = SkNEW_ARGS(GrBatchTextStrike, (this, scaler->getKey()));
+        for (int i = 0; i < fDistanceFieldGlyphSets.count(); ++i) {
+            this->attachDistanceFieldGlyphs(strike, fDistanceFieldGlyphSets[i]);
+        }
         fCache.add(strike);
         return strike;
     }
 
+    void attachDistanceFieldGlyphs(GrBatchTextStrike*, const GrDistanceFieldGlyphSet*);
+
     GrBatchAtlas* getAtlas(GrMaskFormat format) const {
         int atlasIndex = MaskFormatToAtlasIndex(format);
         SkASSERT(fAtlases[atlasIndex]);
@@ -214,6 +242,10 @@ private:
     SkTDynamicHash<GrBatchTextStrike, GrFontDescKey> fCache;
     GrBatchAtlas* fAtlases[kMaskFormatCount];
     GrBatchTextStrike* fPreserveStrike;
+    uint64_t fHits;
+    uint64_t fMisses;
+    uint64_t fEvictions;
+    SkTDArray<const GrDistanceFieldGlyphSet*> fDistanceFieldGlyphSets;
 };
 
 #endif
@@ -22,7 +22,31 @@ GrBatchTarget::GrBatchTarget(GrGpu* gpu)
     , fInlineUpdatesIndex(0) {
 }
 
+void GrBatchTarget::preparePrograms() {
+    GrProgramDesc desc;
+    const GrPrimitiveProcessor* descPrimProc = NULL;
+    const GrPipeline* descPipeline = NULL;
+    FlushBuffer::Iter iter(fFlushBuffer);
+    while (iter.next()) {
+        BufferedFlush* bf = iter.get();
+        const GrPipeline* pipeline = bf->fPipeline;
+        const GrPrimitiveProcessor* primProc = bf->fPrimitiveProcessor.get();
+        if (primProc == descPrimProc && pipeline == descPipeline) {
+            continue;
+        }
+        fGpu->buildProgramDesc(&desc, *primProc, *pipeline, bf->fBatchTracker);
+        descPrimProc = primProc;
+        descPipeline = pipeline;
+        fGpu->prepareProgram(GrGpu::DrawArgs(primProc, pipeline, &desc, &bf->fBatchTracker));
+    }
+}
+
 void GrBatchTarget::flushNext(int n)  {
+    // A batch's draws usually share one primitive processor and pipeline, so only rebuild the
+    // program key when either changes.
+    GrProgramDesc desc;
+    const GrPrimitiveProcessor* descPrimProc = NULL;
+    const GrPipeline* descPipeline = NULL;
     for (; n > 0; n--) {
         fLastFlushedToken++;
         SkDEBUGCODE(bool verify =) fIter.next();
@@ -37,18 +61,17 @@ void GrBatchTarget::flushNext(int n)  {
             fInlineUploads[fInlineUpdatesIndex++]->upload(TextureUploader(fGpu));
         }
 
-        GrProgramDesc desc;
         const GrPipeline* pipeline = bf->fPipeline;
         const GrPrimitiveProcessor* primProc = bf->fPrimitiveProcessor.get();
-        fGpu->buildProgramDesc(&desc, *primProc, *pipeline, bf->fBatchTracker);
+        if (primProc != descPrimProc || pipeline != descPipeline) {
+            fGpu->buildProgramDesc(&desc, *primProc, *pipeline, bf->fBatchTracker);
+            descPrimProc = primProc;
+            descPipeline = pipeline;
+        }
 
         GrGpu::DrawArgs args(primProc, pipeline, &desc, &bf->fBatchTracker);
 
-        int drawCount = bf->fVertexDraws.count();
-        const SkSTArray<1, GrVertices, true>& vertexDraws = bf->fVertexDraws;
-        for (int i = 0; i < drawCount; i++) {
-            fGpu->draw(args, vertexDraws[i]);
-        }
+        fGpu->draw(args, bf->fVertexDraws.begin(), bf->fVertexDraws.count());
     }
 }
 
@@ -94,6 +94,9 @@ public:
             fAsapUploads[i]->upload(TextureUploader(fGpu));
         }
         fInlineUpdatesIndex = 0;
+        if (fGpu->preparesPrograms()) {
+            this->preparePrograms();
+        }
         fIter = FlushBuffer::Iter(fFlushBuffer);
     }
     void flushNext(int n);
@@ -126,6 +129,9 @@ public:
     }
 
 private:
+    // Hands the program of every buffered draw to GrGpu::prepareProgram().
+    void preparePrograms();
+
     void unmapVertexAndIndexBuffers() {
         fVertexPool.unmap();
         fIndexPool.unmap();
@@ -13,6 +13,7 @@
 #include "GrStrokeInfo.h"
 #include "GrTexture.h"
 #include "GrTextureProvider.h"
+#include "SkCachedData.h"
 #include "SkDraw.h"
 #include "SkGr.h"
 #include "SkMaskFilter.h"
@@ -54,23 +55,22 @@ static bool draw_with_mask_filter(GrDrawContext* drawContext,
                                   const GrClip& clipData,
                                   const SkMatrix& viewMatrix,
                                   const SkPath& devPath,
+                                  uint32_t srcGenID,
                                   SkMaskFilter* filter,
                                   const SkIRect& clipBounds,
                                   GrPaint* grp,
                                   SkPaint::Style style) {
-    SkMask  srcM, dstM;
+    SkMask          dstM;
+    SkCachedData*   data;
 
-    if (!SkDraw::DrawToMask(devPath, &clipBounds, filter, &viewMatrix, &srcM,
-                            SkMask::kComputeBoundsAndRenderImage_CreateMode, style)) {
+    // viewMatrix took the source path to device space, so it is also the key's matrix.
+    if (!SkDraw::DrawToFilteredMask(devPath, srcGenID, viewMatrix, clipBounds, filter,
+                                    viewMatrix, &dstM, &data, style)) {
         return false;
     }
-    SkAutoMaskFreeImage autoSrc(srcM.fImage);
-
-    if (!filter->filterMask(&dstM, srcM, viewMatrix, NULL)) {
-        return false;
-    }
-    // this will free-up dstM when we're done (allocated in filterMask())
-    SkAutoMaskFreeImage autoDst(dstM.fImage);
+    SkAutoTUnref<SkCachedData> cache(data);
+    // this will free-up dstM when we're done, unless it lives in the mask cache
+    SkAutoMaskFreeImage autoDst(data ? NULL : dstM.fImage);
 
     if (clip_bounds_quick_reject(clipBounds, dstM.fBounds)) {
         return false;
@@ -219,6 +219,12 @@ void GrBlurUtils::drawPathWithMaskFilter(GrContext* context,
             }
         }
 
+        // Only a path that reaches device space unchanged can be found again by its ID.
+        uint32_t srcGenID = 0;
+        if (pathPtr == &origSrcPath && !origSrcPath.isVolatile() && strokeInfo.isFillStyle()) {
+            srcGenID = origSrcPath.getGenerationID();
+        }
+
         // avoid possibly allocating a new path in transform if we can
         SkPath* devPathPtr = pathIsMutable ? pathPtr : tmpPath.init();
         if (!pathIsMutable) {
@@ -285,7 +291,7 @@ void GrBlurUtils::drawPathWithMaskFilter(GrContext* context,
         SkPaint::Style style = strokeInfo.isHairlineStyle() ? SkPaint::kStroke_Style :
                                                               SkPaint::kFill_Style;
         draw_with_mask_filter(drawContext, context->textureProvider(), renderTarget,
-                              clip, viewMatrix, *devPathPtr,
+                              clip, viewMatrix, *devPathPtr, srcGenID,
                               paint.getMaskFilter(), clipBounds, &grPaint, style);
         return;
     }
@@ -27,6 +27,12 @@
 static const size_t MIN_VERTEX_BUFFER_SIZE = 1 << 15;
 static const size_t MIN_INDEX_BUFFER_SIZE = 1 << 12;
 
+static const size_t PERSISTENT_VERTEX_RING_SIZE = 1 << 22;
+static const size_t PERSISTENT_INDEX_RING_SIZE = 1 << 19;
+
+// How long to block on the GPU for ring space before falling back to a new buffer (nanoseconds).
+static const uint64_t RING_FENCE_TIMEOUT = 1000 * 1000 * 1000;
+
 // page size
 #define GrBufferAllocPool_MIN_BLOCK_SIZE ((size_t)1 << 15)
 
@@ -42,8 +48,14 @@ do {
 
 GrBufferAllocPool::GrBufferAllocPool(GrGpu* gpu,
                                      BufferType bufferType,
-                                     size_t blockSize)
-    : fBlocks(8) {
+                                     size_t blockSize,
+                                     size_t ringSize)
+    : fBlocks(8)
+    , fRingBuffer(NULL)
+    , fRingHead(0)
+    , fRingTail(0)
+    , fRingBytesUsed(0)
+    , fRingBytesThisCycle(0) {
 
     fGpu = SkRef(gpu);
 
@@ -54,13 +66,20 @@ GrBufferAllocPool::GrBufferAllocPool(GrGpu* gpu,
     fBytesInUse = 0;
 
     fGeometryBufferMapThreshold = gpu->caps()->geometryBufferMapThreshold();
+
+    bool persistent = SkToBool(gpu->caps()->mapBufferFlags() & GrCaps::kPersistent_MapFlag);
+    fRingSize = persistent ? ringSize : 0;
 }
 
 void GrBufferAllocPool::deleteBlocks() {
     if (fBlocks.count()) {
-        GrGeometryBuffer* buffer = fBlocks.back().fBuffer;
-        if (buffer->isMapped()) {
-            UNMAP_BUFFER(fBlocks.back());
+        BufferBlock& back = fBlocks.back();
+        if (back.fRing) {
+            if (back.fBuffer->isMapped()) {
+                this->trimRingBlock(&back);
+            }
+        } else if (back.fBuffer->isMapped()) {
+            UNMAP_BUFFER(back);
         }
     }
     while (!fBlocks.empty()) {
@@ -72,6 +91,15 @@ void GrBufferAllocPool::deleteBlocks() {
 GrBufferAllocPool::~GrBufferAllocPool() {
     VALIDATE();
     this->deleteBlocks();
+    if (fRingBuffer) {
+        // Fences from an abandoned context are gone along with it.
+        if (!fRingBuffer->wasDestroyed()) {
+            for (int i = 0; i < fRingFences.count(); ++i) {
+                fGpu->deleteFence(fRingFences[i].fFence);
+            }
+        }
+        fRingBuffer->unref();
+    }
     fGpu->unref();
 }
 
@@ -79,6 +107,7 @@ void GrBufferAllocPool::reset() {
     VALIDATE();
     fBytesInUse = 0;
     this->deleteBlocks();
+    this->fenceRing();
     // we may have created a large cpu mirror of a large VB. Reset the size
     // to match our minimum.
     fCpuData.reset(fMinBlockSize);
@@ -90,7 +119,9 @@ void GrBufferAllocPool::unmap() {
 
     if (fBufferPtr) {
         BufferBlock& block = fBlocks.back();
-        if (block.fBuffer->isMapped()) {
+        if (block.fRing) {
+            this->trimRingBlock(&block);
+        } else if (block.fBuffer->isMapped()) {
             UNMAP_BUFFER(block);
         } else {
             size_t flushSize = block.fBuffer->gpuMemorySize() - block.fBytesFree;
@@ -108,7 +139,7 @@ void GrBufferAllocPool::validate(bool unusedBlockAllowed) const {
         SkASSERT(!fBlocks.empty());
         if (fBlocks.back().fBuffer->isMapped()) {
             GrGeometryBuffer* buf = fBlocks.back().fBuffer;
-            SkASSERT(buf->mapPtr() == fBufferPtr);
+            SkASSERT((char*)buf->mapPtr() + fBlocks.back().fOffset == fBufferPtr);
         } else {
             SkASSERT(fCpuData.get() == fBufferPtr);
         }
@@ -117,13 +148,15 @@ void GrBufferAllocPool::validate(bool unusedBlockAllowed) const {
     }
     size_t bytesInUse = 0;
     for (int i = 0; i < fBlocks.count() - 1; ++i) {
-        SkASSERT(!fBlocks[i].fBuffer->isMapped());
+        // Ring blocks share one buffer, which the last block may have mapped.
+        SkASSERT(fBlocks[i].fRing || !fBlocks[i].fBuffer->isMapped());
     }
     for (int i = 0; !wasDestroyed && i < fBlocks.count(); ++i) {
         if (fBlocks[i].fBuffer->wasDestroyed()) {
             wasDestroyed = true;
         } else {
-            size_t bytes = fBlocks[i].fBuffer->gpuMemorySize() - fBlocks[i].fBytesFree;
+            SkASSERT(fBlocks[i].fRing == (fBlocks[i].fBuffer == fRingBuffer));
+            size_t bytes = fBlocks[i].fSize - fBlocks[i].fBytesFree;
             bytesInUse += bytes;
             SkASSERT(bytes || unusedBlockAllowed);
         }
@@ -137,6 +170,8 @@ void GrBufferAllocPool::validate(bool unusedBlockAllowed) const {
         } else {
             SkASSERT((0 == fBytesInUse) == fBlocks.empty());
         }
+        SkASSERT(fRingBytesUsed <= fRingSize);
+        SkASSERT(fRingBytesThisCycle <= fRingBytesUsed);
     }
 }
 #endif
@@ -152,12 +187,12 @@ void* GrBufferAllocPool::makeSpace(size_t size,
 
     if (fBufferPtr) {
         BufferBlock& back = fBlocks.back();
-        size_t usedBytes = back.fBuffer->gpuMemorySize() - back.fBytesFree;
-        size_t pad = GrSizeAlignUpPad(usedBytes, alignment);
+        size_t usedBytes = back.fSize - back.fBytesFree;
+        size_t pad = GrSizeAlignUpPad(back.fOffset + usedBytes, alignment);
         if ((size + pad) <= back.fBytesFree) {
             memset((void*)(reinterpret_cast<intptr_t>(fBufferPtr) + usedBytes), 0, pad);
             usedBytes += pad;
-            *offset = usedBytes;
+            *offset = back.fOffset + usedBytes;
             *buffer = back.fBuffer;
             back.fBytesFree -= size + pad;
             fBytesInUse += size + pad;
@@ -174,13 +209,14 @@ void* GrBufferAllocPool::makeSpace(size_t size,
     // updateData() if the amount of data passed is less than the full buffer
     // size.
 
-    if (!this->createBlock(size)) {
+    if (!this->createBlock(size, alignment)) {
         return NULL;
     }
     SkASSERT(fBufferPtr);
 
-    *offset = 0;
     BufferBlock& back = fBlocks.back();
+    SkASSERT(0 == back.fOffset % alignment);
+    *offset = back.fOffset;
     *buffer = back.fBuffer;
     back.fBytesFree -= size;
     fBytesInUse += size;
@@ -195,13 +231,15 @@ void GrBufferAllocPool::putBack(size_t bytes) {
         // caller shouldn't try to put back more than they've taken
         SkASSERT(!fBlocks.empty());
         BufferBlock& block = fBlocks.back();
-        size_t bytesUsed = block.fBuffer->gpuMemorySize() - block.fBytesFree;
+        size_t bytesUsed = block.fSize - block.fBytesFree;
         if (bytes >= bytesUsed) {
             bytes -= bytesUsed;
             fBytesInUse -= bytesUsed;
             // if we locked a vb to satisfy the make space and we're releasing
             // beyond it, then unmap it.
-            if (block.fBuffer->isMapped()) {
+            if (block.fRing) {
+                this->releaseRingBlock(&block);
+            } else if (block.fBuffer->isMapped()) {
                 UNMAP_BUFFER(block);
             }
             this->destroyBlock();
@@ -216,35 +254,48 @@ void GrBufferAllocPool::putBack(size_t bytes) {
     VALIDATE();
 }
 
-bool GrBufferAllocPool::createBlock(size_t requestSize) {
+bool GrBufferAllocPool::createBlock(size_t requestSize, size_t alignment) {
 
     size_t size = SkTMax(requestSize, fMinBlockSize);
     SkASSERT(size >= GrBufferAllocPool_MIN_BLOCK_SIZE);
 
     VALIDATE();
 
-    BufferBlock& block = fBlocks.push_back();
-
-    block.fBuffer = this->getBuffer(size);
-    if (NULL == block.fBuffer) {
-        fBlocks.pop_back();
-        return false;
-    }
-
-    block.fBytesFree = block.fBuffer->gpuMemorySize();
+    // The previous block is finished first so that its unused ring space can be claimed again.
     if (fBufferPtr) {
-        SkASSERT(fBlocks.count() > 1);
-        BufferBlock& prev = fBlocks.fromBack(1);
-        if (prev.fBuffer->isMapped()) {
+        BufferBlock& prev = fBlocks.back();
+        if (prev.fRing) {
+            this->trimRingBlock(&prev);
+        } else if (prev.fBuffer->isMapped()) {
             UNMAP_BUFFER(prev);
         } else {
-            this->flushCpuData(prev, prev.fBuffer->gpuMemorySize() - prev.fBytesFree);
+            this->flushCpuData(prev, prev.fSize - prev.fBytesFree);
         }
         fBufferPtr = NULL;
     }
 
     SkASSERT(NULL == fBufferPtr);
 
+    BufferBlock& block = fBlocks.push_back();
+
+    if (this->claimRingBlock(requestSize, alignment, &block)) {
+        block.fBytesFree = block.fSize;
+        fBufferPtr = (char*)block.fBuffer->mapPtr() + block.fOffset;
+        VALIDATE(true);
+        return true;
+    }
+
+    block.fBuffer = this->getBuffer(size);
+    if (NULL == block.fBuffer) {
+        fBlocks.pop_back();
+        return false;
+    }
+
+    block.fOffset = 0;
+    block.fSize = block.fBuffer->gpuMemorySize();
+    block.fRing = false;
+    block.fBytesFree = block.fSize;
+
     // If the buffer is CPU-backed we map it because it is free to do so and saves a copy.
     // Otherwise when buffer mapping is supported we map if the buffer size is greater than the
     // threshold.
@@ -277,6 +328,127 @@ void GrBufferAllocPool::destroyBlock() {
     fBufferPtr = NULL;
 }
 
+bool GrBufferAllocPool::claimRingBlock(size_t requestSize, size_t alignment, BufferBlock* block) {
+    if (0 == requestSize || requestSize > fRingSize) {
+        return false;
+    }
+    if (NULL == fRingBuffer) {
+        if (kIndex_BufferType == fBufferType) {
+            fRingBuffer = fGpu->createPersistentIndexBuffer(fRingSize);
+        } else {
+            SkASSERT(kVertex_BufferType == fBufferType);
+            fRingBuffer = fGpu->createPersistentVertexBuffer(fRingSize);
+        }
+        if (NULL == fRingBuffer) {
+            // Don't try again, just use regular buffers.
+            fRingSize = 0;
+            return false;
+        }
+    }
+    if (fRingBuffer->wasDestroyed()) {
+        return false;
+    }
+
+    for (;;) {
+        if (0 == fRingBytesUsed) {
+            fRingHead = fRingTail = 0;
+        }
+        // The free space after the head runs to the end of the ring unless the used bytes have
+        // wrapped around, in which case it stops at the tail.
+        size_t end = (fRingHead < fRingTail || fRingBytesUsed == fRingSize) ? fRingTail
+                                                                             : fRingSize;
+        size_t start = GrSizeAlignUp(fRingHead, alignment);
+        if (start < end && requestSize <= end - start) {
+            if (NULL == fRingBuffer->map()) {
+                return false;
+            }
+            // Take all of it. The block gives back what it doesn't use when it is trimmed.
+            size_t claimed = end - fRingHead;
+            fRingBytesUsed += claimed;
+            fRingBytesThisCycle += claimed;
+            fRingHead = end == fRingSize ? 0 : end;
+
+            block->fBuffer = SkRef(fRingBuffer);
+            block->fOffset = start;
+            block->fSize = end - start;
+            block->fRing = true;
+            return true;
+        }
+        if (fRingSize == end && requestSize <= fRingTail) {
+            // Skip the bytes at the end of the ring. They are released along with this cycle.
+            size_t gap = fRingSize - fRingHead;
+            fRingBytesUsed += gap;
+            fRingBytesThisCycle += gap;
+            fRingHead = 0;
+            continue;
+        }
+        if (!this->waitForRingFence()) {
+            return false;
+        }
+    }
+}
+
+void GrBufferAllocPool::trimRingBlock(BufferBlock* block) {
+    SkASSERT(block->fRing);
+    SkASSERT(block->fBuffer->isMapped());
+    // Only the newest claim is still open, so the head sits at its end.
+    SkASSERT(fRingHead == (block->fOffset + block->fSize) % fRingSize);
+    size_t used = block->fSize - block->fBytesFree;
+    fRingBytesUsed -= block->fBytesFree;
+    fRingBytesThisCycle -= block->fBytesFree;
+    fRingHead = (block->fOffset + used) % fRingSize;
+    block->fSize = used;
+    block->fBytesFree = 0;
+    // Unmapping is free for persistent buffers; it just marks the data as ready to draw from.
+    block->fBuffer->unmap();
+}
+
+void GrBufferAllocPool::releaseRingBlock(BufferBlock* block) {
+    SkASSERT(block->fRing);
+    if (block->fBuffer->isMapped()) {
+        block->fBuffer->unmap();
+    }
+    // The space can be handed out again if nothing was claimed after it. Otherwise it is simply
+    // released with the rest of this cycle.
+    if (fRingHead == (block->fOffset + block->fSize) % fRingSize &&
+        block->fSize <= fRingBytesThisCycle) {
+        fRingBytesUsed -= block->fSize;
+        fRingBytesThisCycle -= block->fSize;
+        fRingHead = block->fOffset;
+    }
+}
+
+bool GrBufferAllocPool::waitForRingFence() {
+    if (fRingFences.isEmpty() || !fGpu->waitFence(fRingFences[0].fFence, RING_FENCE_TIMEOUT)) {
+        return false;
+    }
+    const RingFence& oldest = fRingFences[0];
+    fGpu->deleteFence(oldest.fFence);
+    fRingTail = oldest.fEnd;
+    fRingBytesUsed -= oldest.fBytes;
+    fRingFences.remove(0);
+    return true;
+}
+
+void GrBufferAllocPool::fenceRing() {
+    if (0 == fRingBytesThisCycle) {
+        return;
+    }
+    SkASSERT(fRingBuffer);
+    if (fRingBuffer->wasDestroyed()) {
+        // The context was abandoned so nothing can still be reading the ring.
+        fRingFences.reset();
+        fRingBytesUsed = 0;
+        fRingBytesThisCycle = 0;
+        return;
+    }
+    RingFence* fence = fRingFences.append();
+    fence->fFence = fGpu->insertFence();
+    fence->fEnd = fRingHead;
+    fence->fBytes = fRingBytesThisCycle;
+    fRingBytesThisCycle = 0;
+}
+
 void GrBufferAllocPool::flushCpuData(const BufferBlock& block, size_t flushSize) {
     GrGeometryBuffer* buffer = block.fBuffer;
     SkASSERT(buffer);
@@ -316,7 +488,8 @@ GrGeometryBuffer* GrBufferAllocPool::getBuffer(size_t size) {
 ////////////////////////////////////////////////////////////////////////////////
 
 GrVertexBufferAllocPool::GrVertexBufferAllocPool(GrGpu* gpu)
-    : GrBufferAllocPool(gpu, kVertex_BufferType, MIN_VERTEX_BUFFER_SIZE) {
+    : GrBufferAllocPool(gpu, kVertex_BufferType, MIN_VERTEX_BUFFER_SIZE,
+                        PERSISTENT_VERTEX_RING_SIZE) {
 }
 
 void* GrVertexBufferAllocPool::makeSpace(size_t vertexSize,
@@ -344,7 +517,8 @@ void* GrVertexBufferAllocPool::makeSpace(size_t vertexSize,
 ////////////////////////////////////////////////////////////////////////////////
 
 GrIndexBufferAllocPool::GrIndexBufferAllocPool(GrGpu* gpu)
-    : GrBufferAllocPool(gpu, kIndex_BufferType, MIN_INDEX_BUFFER_SIZE) {
+    : GrBufferAllocPool(gpu, kIndex_BufferType, MIN_INDEX_BUFFER_SIZE,
+                        PERSISTENT_INDEX_RING_SIZE) {
 }
 
 void* GrIndexBufferAllocPool::makeSpace(int indexCount,
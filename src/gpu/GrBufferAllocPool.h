@@ -8,6 +8,7 @@
 #ifndef GrBufferAllocPool_DEFINED
 #define GrBufferAllocPool_DEFINED
 
+#include "GrTypesPriv.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTypes.h"
@@ -26,6 +27,11 @@ class GrGpu;
  * At creation time a minimum per-buffer size can be specified. Additionally,
  * a number of buffers to preallocate can be specified. These will
  * be allocated at the min size and kept around until the pool is destroyed.
+ *
+ * When the GPU supports persistently mapped buffers the pool also keeps one
+ * such buffer as a ring. Space is handed out from it directly, with no copy
+ * and no map/unmap per flush, and each reset fences the bytes used since the
+ * previous one so they are only rewritten after the GPU has read them.
  */
 class GrBufferAllocPool : SkNoncopyable {
 public:
@@ -64,10 +70,13 @@ protected:
      * @param bufferSize            The minimum size of created buffers.
      *                              This value will be clamped to some
      *                              reasonable minimum.
+     * @param ringSize              Size of the persistently mapped ring buffer,
+     *                              if the GPU supports one. Zero disables it.
      */
      GrBufferAllocPool(GrGpu* gpu,
                        BufferType bufferType,
-                       size_t   bufferSize = 0);
+                       size_t   bufferSize = 0,
+                       size_t   ringSize = 0);
 
      virtual ~GrBufferAllocPool();
 
@@ -100,13 +109,29 @@ protected:
 private:
     struct BufferBlock {
         size_t              fBytesFree;
+        size_t              fOffset;    // where the block starts in fBuffer
+        size_t              fSize;      // bytes of fBuffer reserved for the block
         GrGeometryBuffer*   fBuffer;
+        bool                fRing;      // fBuffer is the persistently mapped ring buffer
+    };
+
+    // The bytes of the ring the GPU may still read when a reset() happens. Once the fence
+    // signals the tail of the ring moves up to fEnd.
+    struct RingFence {
+        GrFence             fFence;
+        size_t              fEnd;
+        size_t              fBytes;
     };
 
-    bool createBlock(size_t requestSize);
+    bool createBlock(size_t requestSize, size_t alignment);
     void destroyBlock();
     void deleteBlocks();
     void flushCpuData(const BufferBlock& block, size_t flushSize);
+    bool claimRingBlock(size_t requestSize, size_t alignment, BufferBlock* block);
+    void trimRingBlock(BufferBlock* block);
+    void releaseRingBlock(BufferBlock* block);
+    bool waitForRingFence();
+    void fenceRing();
 #ifdef SK_DEBUG
     void validate(bool unusedBlockAllowed = false) const;
 #endif
@@ -121,6 +146,14 @@ private:
     SkAutoMalloc                    fCpuData;
     void*                           fBufferPtr;
     size_t                          fGeometryBufferMapThreshold;
+
+    GrGeometryBuffer*               fRingBuffer;
+    size_t                          fRingSize;
+    size_t                          fRingHead;
+    size_t                          fRingTail;
+    size_t                          fRingBytesUsed;       // between tail and head
+    size_t                          fRingBytesThisCycle;  // since the last fence
+    SkTDArray<RingFence>            fRingFences;
 };
 
 class GrVertexBuffer;
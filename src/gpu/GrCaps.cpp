@@ -91,7 +91,9 @@ GrCaps::GrCaps(const GrContextOptions& options) {
     fCompressedTexSubImageSupport = false;
     fOversizedStencilSupport = false;
     fTextureBarrierSupport = false;
+    fTimerQuerySupport = false;
     fSupportsInstancedDraws = false;
+    fHalfFloatVertexAttributeSupport = false;
     fFullClearIsFree = false;
 
     fUseDrawInsteadOfClear = false;
@@ -135,6 +137,11 @@ static SkString map_flags_to_string(uint32_t flags) {
             str.append(" full");
         }
         SkDEBUGCODE(flags &= ~GrCaps::kSubset_MapFlag);
+
+        if (GrCaps::kPersistent_MapFlag & flags) {
+            str.append(" persistent");
+        }
+        SkDEBUGCODE(flags &= ~GrCaps::kPersistent_MapFlag);
     }
     SkASSERT(0 == flags); // Make sure we handled all the flags.
     return str;
@@ -154,7 +161,10 @@ SkString GrCaps::dump() const {
     r.appendf("Compressed Update Support          : %s\n", gNY[fCompressedTexSubImageSupport]);
     r.appendf("Oversized Stencil Support          : %s\n", gNY[fOversizedStencilSupport]);
     r.appendf("Texture Barrier Support            : %s\n", gNY[fTextureBarrierSupport]);
+    r.appendf("Timer Query Support                : %s\n", gNY[fTimerQuerySupport]);
     r.appendf("Supports instanced draws           : %s\n", gNY[fSupportsInstancedDraws]);
+    r.appendf("Half Float Vertex Attribute Support: %s\n",
+              gNY[fHalfFloatVertexAttributeSupport]);
     r.appendf("Full screen clear is free          : %s\n", gNY[fFullClearIsFree]);
     r.appendf("Draw Instead of Clear [workaround] : %s\n", gNY[fUseDrawInsteadOfClear]);
     r.appendf("Draw Instead of TexSubImage [workaround] : %s\n",
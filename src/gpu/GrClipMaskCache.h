@@ -126,6 +126,22 @@ public:
         back->acquireMask(fResourceProvider, clipGenID, desc, bound);
     }
 
+    /**
+     * Makes an existing mask, e.g. one found in the resource cache from an earlier frame, the
+     * current mask for clipGenID and bound.
+     */
+    void setMask(int32_t clipGenID, GrTexture* mask, const SkIRect& bound) {
+
+        if (fStack.empty()) {
+            SkASSERT(false);
+            return;
+        }
+
+        GrClipStackFrame* back = (GrClipStackFrame*) fStack.back();
+
+        back->setMask(clipGenID, mask, bound);
+    }
+
     int getLastMaskWidth() const {
 
         if (fStack.empty()) {
@@ -203,6 +219,12 @@ private:
             fLastBound = bound;
         }
 
+        void setMask(int32_t clipGenID, GrTexture* mask, const SkIRect& bound) {
+            fLastClipGenID = clipGenID;
+            fLastMask.reset(SkSafeRef(mask));
+            fLastBound = bound;
+        }
+
         void reset () {
             fLastClipGenID = SkClipStack::kInvalidGenID;
 
@@ -20,6 +20,7 @@
 #include "SkRasterClip.h"
 #include "SkTLazy.h"
 #include "effects/GrConvexPolyEffect.h"
+#include "effects/GrOvalEffect.h"
 #include "effects/GrPorterDuffXferProcessor.h"
 #include "effects/GrRRectEffect.h"
 #include "effects/GrTextureDomain.h"
@@ -56,6 +57,19 @@ void setup_drawstate_aaclip(const GrPipelineBuilder& pipelineBuilder,
                                       kDevice_GrCoordSet))->unref();
 }
 
+// Clip masks are keyed by the reduced clip's gen ID and its bounds in clip space, which together
+// determine the mask's contents. Keeping them in the resource cache lets a static clip reuse its
+// mask across flushes and frames, after GrClipMaskCache has dropped its ref.
+void get_clip_mask_key(int32_t clipGenID, const SkIRect& bounds, GrUniqueKey* key) {
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    GrUniqueKey::Builder builder(key, kDomain, 5);
+    builder[0] = clipGenID;
+    builder[1] = bounds.fLeft;
+    builder[2] = bounds.fTop;
+    builder[3] = bounds.fRight;
+    builder[4] = bounds.fBottom;
+}
+
 bool path_needs_SW_renderer(GrContext* context,
                             const GrDrawTarget* gpu,
                             const GrPipelineBuilder& pipelineBuilder,
@@ -153,8 +167,11 @@ bool GrClipMaskManager::installClipEffects(
                 break;
             case SkRegion::kDifference_Op:
                 invert = true;
-                // We don't currently have a cheap test for whether a rect is fully outside an
-                // element's primitive, so don't attempt to set skip.
+                // If the draw misses the element's bounds entirely there is nothing to remove.
+                if (drawBounds && !iter.get()->isInverseFilled() &&
+                    !SkRect::Intersects(iter.get()->getBounds(), boundsInClipSpace)) {
+                    skip = true;
+                }
                 break;
             default:
                 failed = true;
@@ -180,10 +197,22 @@ bool GrClipMaskManager::installClipEffects(
             }
             SkAutoTUnref<GrFragmentProcessor> fp;
             switch (iter.get()->getType()) {
-                case SkClipStack::Element::kPath_Type:
-                    fp.reset(GrConvexPolyEffect::Create(edgeType, iter.get()->getPath(),
-                                                        &clipToRTOffset));
+                case SkClipStack::Element::kPath_Type: {
+                    const SkPath& path = iter.get()->getPath();
+                    SkRect oval;
+                    if (path.isOval(&oval)) {
+                        // Ovals aren't polygons, but clipPath() with a circle is common enough
+                        // to keep out of the stencil.
+                        if (path.isInverseFillType()) {
+                            edgeType = GrInvertProcessorEdgeType(edgeType);
+                        }
+                        oval.offset(clipToRTOffset.fX, clipToRTOffset.fY);
+                        fp.reset(GrOvalEffect::Create(edgeType, oval));
+                    } else {
+                        fp.reset(GrConvexPolyEffect::Create(edgeType, path, &clipToRTOffset));
+                    }
                     break;
+                }
                 case SkClipStack::Element::kRRect_Type: {
                     SkRRect rrect = iter.get()->getRRect();
                     rrect.offset(clipToRTOffset.fX, clipToRTOffset.fY);
@@ -282,6 +311,9 @@ bool GrClipMaskManager::setupClipping(const GrPipelineBuilder& pipelineBuilder,
         } break;
     }
 
+    // BW clips are tried here as well: a few non-AA rects, rrects, ovals or convex polys are
+    // cheaper as analytic effects than clearing and drawing into the stencil buffer.
+    //
     // An element count of 4 was chosen because of the common pattern in Blink of:
     //   isect RR
     //   diff  RR
@@ -294,8 +326,8 @@ bool GrClipMaskManager::setupClipping(const GrPipelineBuilder& pipelineBuilder,
         SkVector clipToRTOffset = { SkIntToScalar(-clip.origin().fX),
                                     SkIntToScalar(-clip.origin().fY) };
         if (elements.isEmpty() ||
-            (requiresAA && this->installClipEffects(pipelineBuilder, arfps, elements, clipToRTOffset,
-                                                    devBounds))) {
+            this->installClipEffects(pipelineBuilder, arfps, elements, clipToRTOffset,
+                                     devBounds)) {
             SkIRect scissorSpaceIBounds(clipSpaceIBounds);
             scissorSpaceIBounds.offset(-clip.origin());
             if (NULL == devBounds ||
@@ -521,11 +553,18 @@ GrTexture* GrClipMaskManager::createTempMask(int width, int height) {
 // Return the texture currently in the cache if it exists. Otherwise, return NULL
 GrTexture* GrClipMaskManager::getCachedMaskTexture(int32_t elementsGenID,
                                                    const SkIRect& clipSpaceIBounds) {
-    bool cached = fAACache.canReuse(elementsGenID, clipSpaceIBounds);
-    if (!cached) {
-        return NULL;
+    if (fAACache.canReuse(elementsGenID, clipSpaceIBounds)) {
+        return fAACache.getLastMask();
     }
 
+    GrUniqueKey key;
+    get_clip_mask_key(elementsGenID, clipSpaceIBounds, &key);
+    SkAutoTUnref<GrTexture> mask(
+            this->getContext()->textureProvider()->findAndRefTextureByUniqueKey(key));
+    if (!mask) {
+        return NULL;
+    }
+    fAACache.setMask(elementsGenID, mask, clipSpaceIBounds);
     return fAACache.getLastMask();
 }
 
@@ -703,6 +742,11 @@ GrTexture* GrClipMaskManager::createAlphaClipMask(int32_t elementsGenID,
         }
     }
 
+    // Only key the mask once it is complete, so a failure above can't leave a partial mask that
+    // later frames would pick up.
+    GrUniqueKey key;
+    get_clip_mask_key(elementsGenID, clipSpaceIBounds, &key);
+    this->getContext()->textureProvider()->assignUniqueKeyToTexture(key, result);
     fCurrClipMaskType = kAlpha_ClipMaskType;
     return result;
 }
@@ -1141,6 +1185,9 @@ GrTexture* GrClipMaskManager::createSoftwareClipMask(int32_t elementsGenID,
     }
     helper.toTexture(result);
 
+    GrUniqueKey key;
+    get_clip_mask_key(elementsGenID, clipSpaceIBounds, &key);
+    this->getContext()->textureProvider()->assignUniqueKeyToTexture(key, result);
     fCurrClipMaskType = kAlpha_ClipMaskType;
     return result;
 }
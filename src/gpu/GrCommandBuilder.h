@@ -68,13 +68,15 @@ protected:
     typedef GrTargetCommands::CopySurface CopySurface;
     typedef GrTargetCommands::XferBarrier XferBarrier;
 
-    GrCommandBuilder(GrGpu* gpu) : fCommands(gpu) {}
+    GrCommandBuilder(GrGpu* gpu) : fCommands(gpu), fGpu(gpu) {}
 
     GrTargetCommands::CmdBuffer* cmdBuffer() { return fCommands.cmdBuffer(); }
     GrBatchTarget* batchTarget() { return fCommands.batchTarget(); }
+    GrGpu* gpu() { return fGpu; }
 
 private:
     GrTargetCommands fCommands;
+    GrGpu* fGpu;
 
 };
 
@@ -17,6 +17,7 @@
 #include "GrContextOptions.h"
 #include "GrDefaultGeoProcFactory.h"
 #include "GrDrawContext.h"
+#include "GrFlushTimer.h"
 #include "GrGpuResource.h"
 #include "GrGpuResourcePriv.h"
 #include "GrGpu.h"
@@ -177,11 +178,11 @@ bool GrContext::init(GrBackend backend, GrBackendContext backendContext,
     if (!fGpu) {
         return false;
     }
-    this->initCommon();
+    this->initCommon(options);
     return true;
 }
 
-void GrContext::initCommon() {
+void GrContext::initCommon(const GrContextOptions& options) {
     fCaps = SkRef(fGpu->caps());
     fResourceCache = SkNEW(GrResourceCache);
     fResourceCache->setOverBudgetCallback(OverBudgetCB, this);
@@ -196,7 +197,8 @@ void GrContext::initCommon() {
     // GrBatchFontCache will eventually replace GrFontCache
     fBatchFontCache = SkNEW_ARGS(GrBatchFontCache, (this));
 
-    fTextBlobCache.reset(SkNEW_ARGS(GrTextBlobCache, (TextBlobCacheOverBudgetCB, this)));
+    fTextBlobCache.reset(SkNEW_ARGS(GrTextBlobCache, (TextBlobCacheOverBudgetCB, this,
+                                                      options.fTextBlobCacheLimit)));
 }
 
 GrContext::~GrContext() {
@@ -206,6 +208,7 @@ GrContext::~GrContext() {
     }
 
     this->flush();
+    this->finishAsyncReads(true);
 
     fDrawingMgr.cleanup();
 
@@ -216,6 +219,8 @@ GrContext::~GrContext() {
     SkDELETE(fResourceProvider);
     SkDELETE(fResourceCache);
     SkDELETE(fBatchFontCache);
+    // The timer's queries must be deleted while the GrGpu is still alive.
+    fFlushTimer.free();
 
     fGpu->unref();
     fCaps->unref();
@@ -230,6 +235,15 @@ void GrContext::abandonContext() {
     fResourceCache->abandonAll();
 
     fGpu->contextAbandoned();
+    if (fFlushTimer) {
+        fFlushTimer->abandon();
+    }
+    // The GrGpu has dropped the reads' buffers so they can only fail.
+    SkTDArray<AsyncRead> failed;
+    failed.swap(fAsyncReads);
+    for (int i = 0; i < failed.count(); ++i) {
+        failed[i].fFunc(failed[i].fInfo, NULL, 0);
+    }
 
     // a path renderer may be holding onto resources that
     // are now unusable
@@ -247,6 +261,10 @@ void GrContext::resetContext(uint32_t state) {
     fGpu->markContextDirty(state);
 }
 
+void GrContext::addDistanceFieldGlyphs(const GrDistanceFieldGlyphSet* set) {
+    fBatchFontCache->addDistanceFieldGlyphs(set);
+}
+
 void GrContext::freeGpuResources() {
     this->flush();
 
@@ -261,6 +279,14 @@ void GrContext::freeGpuResources() {
     fResourceCache->purgeAllUnlocked();
 }
 
+void GrContext::purgeResourcesToFraction(float fraction) {
+    // Flushing first lets resources held only by pending draws be purged.
+    this->flush();
+
+    fTextBlobCache->purgeToFraction(fraction);
+    fResourceCache->purgeUnlockedToFraction(fraction);
+}
+
 void GrContext::getResourceCacheUsage(int* resourceCount, size_t* resourceBytes) const {
     if (resourceCount) {
         *resourceCount = fResourceCache->getBudgetedResourceCount();
@@ -270,6 +296,25 @@ void GrContext::getResourceCacheUsage(int* resourceCount, size_t* resourceBytes)
     }
 }
 
+size_t GrContext::getResourceCachePeakBytes() const {
+    return fResourceCache->getPeakBudgetedResourceBytes();
+}
+
+void GrContext::resetResourceCachePeakBytes() {
+    fResourceCache->resetPeakBudgetedResourceBytes();
+}
+
+void GrContext::visitCacheStats(SkCacheStats::Visitor visitor, void* context) const {
+    SkCacheStats stats[4];
+    fResourceCache->getStats(&stats[0]);
+    fTextBlobCache->getStats(&stats[1]);
+    fLayerCache->getStats(&stats[2]);
+    fBatchFontCache->getStats(&stats[3]);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(stats); ++i) {
+        visitor(stats[i], context);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void GrContext::OverBudgetCB(void* data) {
@@ -296,6 +341,7 @@ void GrContext::TextBlobCacheOverBudgetCB(void* data) {
 
 void GrContext::flush(int flagsBitfield) {
     RETURN_IF_ABANDONED
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("skia.gpu"), "GrContext::flush");
 
     if (kDiscard_FlushBit & flagsBitfield) {
         fDrawingMgr.reset();
@@ -304,6 +350,22 @@ void GrContext::flush(int flagsBitfield) {
     }
     fResourceCache->notifyFlushOccurred();
     fFlushToReduceCacheSize = false;
+    if (fFlushTimer) {
+        fFlushTimer->didFlush();
+    }
+    this->finishAsyncReads(false);
+}
+
+bool GrContext::setGpuTimingCallback(PFGpuTimingFunc func, void* info) {
+    fFlushTimer.free();
+    if (!func) {
+        return true;
+    }
+    if (this->abandoned() || !fCaps->timerQuerySupport()) {
+        return false;
+    }
+    fFlushTimer.reset(SkNEW_ARGS(GrFlushTimer, (fGpu, func, info)));
+    return true;
 }
 
 bool sw_convert_to_premul(GrPixelConfig srcConfig, int width, int height, size_t inRowBytes,
@@ -583,6 +645,67 @@ bool GrContext::readSurfacePixels(GrSurface* src,
     return true;
 }
 
+bool GrContext::readSurfacePixelsAsync(GrSurface* src,
+                                       int left, int top, int width, int height,
+                                       GrPixelConfig config,
+                                       PFReadPixelsFunc func, void* info) {
+    RETURN_FALSE_IF_ABANDONED
+    ASSERT_OWNED_RESOURCE(src);
+    SkASSERT(src && func);
+
+    if (!SkIRect::MakeWH(src->width(), src->height()).contains(
+                SkIRect::MakeXYWH(left, top, width, height))) {
+        return false;
+    }
+
+    size_t rowBytes = GrBytesPerPixel(config) * width;
+    GrGpu::DrawPreference drawPreference = GrGpu::kNoDraw_DrawPreference;
+    GrGpu::ReadPixelTempDrawInfo tempDrawInfo;
+    if (!fGpu->getReadPixelsInfo(src, width, height, rowBytes, config, &drawPreference,
+                                 &tempDrawInfo)) {
+        return false;
+    }
+
+    // A draw the GPU merely prefers (e.g. to flip rows) is skipped. The async read deals with that.
+    if (GrGpu::kRequireDraw_DrawPreference != drawPreference) {
+        if (src->surfacePriv().hasPendingWrite()) {
+            this->flush();
+        }
+        GrAsyncRead read = fGpu->beginAsyncReadPixels(src, left, top, width, height, config);
+        if (read) {
+            AsyncRead* pending = fAsyncReads.append();
+            pending->fRead = read;
+            pending->fFunc = func;
+            pending->fInfo = info;
+            return true;
+        }
+    }
+
+    SkAutoMalloc pixels(rowBytes * height);
+    if (!this->readSurfacePixels(src, left, top, width, height, config, pixels.get(),
+                                 rowBytes)) {
+        return false;
+    }
+    func(info, pixels.get(), rowBytes);
+    return true;
+}
+
+void GrContext::finishAsyncReads(bool wait) {
+    static const uint64_t kWaitForever = ~(uint64_t)0;
+    while (fAsyncReads.count()) {
+        // Callbacks may start more reads or flush, so the read is removed before it is called.
+        AsyncRead pending = fAsyncReads[0];
+        if (!fGpu->isAsyncReadFinished(pending.fRead, wait ? kWaitForever : 0)) {
+            break;
+        }
+        fAsyncReads.remove(0);
+        size_t rowBytes = 0;
+        const void* pixels = fGpu->mapAsyncReadPixels(pending.fRead, &rowBytes);
+        pending.fFunc(pending.fInfo, pixels, rowBytes);
+        fGpu->endAsyncReadPixels(pending.fRead);
+    }
+}
+
 void GrContext::prepareSurfaceForExternalIO(GrSurface* surface) {
     RETURN_IF_ABANDONED
     SkASSERT(surface);
@@ -10,17 +10,79 @@
 #include "GrGpu.h"
 #include "effects/GrDashingEffect.h"
 
+// Gets the points of a path that is a single open polyline. A polyline of more than one line is
+// drawn a line at a time, with the phase carried along, so only hairlines can be drawn that way:
+// a thicker dash around a corner would need a join.
+static bool get_polyline(const SkPath& path, const GrStrokeInfo& stroke,
+                         SkSTArray<16, SkPoint, true>* pts) {
+    SkPoint line[2];
+    if (path.isLine(line)) {
+        pts->push_back_n(2, line);
+        return true;
+    }
+    if (0 != stroke.getWidth() || SkPath::kLine_SegmentMask != path.getSegmentMasks()) {
+        return false;
+    }
+    const int verbCount = path.countVerbs();
+    SkSTArray<16, uint8_t, true> verbs;
+    verbs.push_back_n(verbCount);
+    path.getVerbs(verbs.begin(), verbCount);
+    if (verbCount < 2 || SkPath::kMove_Verb != verbs[0]) {
+        return false;
+    }
+    for (int i = 1; i < verbCount; ++i) {
+        if (SkPath::kLine_Verb != verbs[i]) {
+            return false;
+        }
+    }
+    SkASSERT(path.countPoints() == verbCount);
+    pts->push_back_n(verbCount);
+    path.getPoints(pts->begin(), verbCount);
+    return true;
+}
+
 bool GrDashLinePathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
-    SkPoint pts[2];
-    if (args.fStroke->isDashed() && args.fPath->isLine(pts)) {
-        return GrDashingEffect::CanDrawDashLine(pts, *args.fStroke, *args.fViewMatrix);
+    SkSTArray<16, SkPoint, true> pts;
+    if (!args.fStroke->isDashed() || !get_polyline(*args.fPath, *args.fStroke, &pts)) {
+        return false;
+    }
+    for (int i = 1; i < pts.count(); ++i) {
+        if (!GrDashingEffect::CanDrawDashLine(&pts[i - 1], *args.fStroke, *args.fViewMatrix)) {
+            return false;
+        }
     }
-    return false;
+    return true;
 }
 
 bool GrDashLinePathRenderer::onDrawPath(const DrawPathArgs& args) {
-    SkPoint pts[2];
-    SkAssertResult(args.fPath->isLine(pts));
-    return GrDashingEffect::DrawDashLine(args.fTarget, *args.fPipelineBuilder, args.fColor,
-                                         *args.fViewMatrix, pts, args.fAntiAlias, *args.fStroke);
+    SkSTArray<16, SkPoint, true> pts;
+    SkAssertResult(get_polyline(*args.fPath, *args.fStroke, &pts));
+    if (2 == pts.count()) {
+        return GrDashingEffect::DrawDashLine(args.fTarget, *args.fPipelineBuilder, args.fColor,
+                                             *args.fViewMatrix, pts.begin(), args.fAntiAlias,
+                                             *args.fStroke);
+    }
+
+    // Each line starts where the previous one left off in the intervals.
+    const SkScalar* intervals = args.fStroke->getDashIntervals();
+    const SkScalar intervalLength = intervals[0] + intervals[1];
+    GrStrokeInfo stroke(*args.fStroke);
+    SkPathEffect::DashInfo info;
+    info.fIntervals = const_cast<SkScalar*>(intervals);
+    info.fCount = args.fStroke->getDashCount();
+    info.fPhase = args.fStroke->getDashPhase();
+    for (int i = 1; i < pts.count(); ++i) {
+        const SkScalar length = SkPoint::Distance(pts[i - 1], pts[i]);
+        if (0 == length) {
+            continue;
+        }
+        stroke.setDashInfo(info);
+        if (!GrDashingEffect::DrawDashLine(args.fTarget, *args.fPipelineBuilder, args.fColor,
+                                           *args.fViewMatrix, &pts[i - 1], args.fAntiAlias,
+                                           stroke)) {
+            return false;
+        }
+        info.fPhase = SkScalarMod(info.fPhase + length, intervalLength);
+    }
+    return true;
 }
@@ -22,6 +22,8 @@ enum GPFlag {
     kLocalCoord_GPFlag =            0x2,
     kCoverage_GPFlag=               0x4,
     kTransformedLocalCoord_GPFlag = 0x8,
+    kPackedPosition_GPFlag =        0x10,
+    kHalfLocalCoord_GPFlag =        0x20,
 };
 
 class DefaultGeoProc : public GrGeometryProcessor {
@@ -216,14 +218,17 @@ private:
         bool hasTransformedLocalCoords = SkToBool(gpTypeFlags & kTransformedLocalCoord_GPFlag);
         bool hasLocalCoord = hasExplicitLocalCoords || hasTransformedLocalCoords;
         bool hasCoverage = SkToBool(gpTypeFlags & kCoverage_GPFlag);
-        fInPosition = &this->addVertexAttrib(Attribute("inPosition", kVec2f_GrVertexAttribType,
+        GrVertexAttribType positionType = (gpTypeFlags & kPackedPosition_GPFlag) ?
+                                          kVec2s_GrVertexAttribType : kVec2f_GrVertexAttribType;
+        fInPosition = &this->addVertexAttrib(Attribute("inPosition", positionType,
                                                        kHigh_GrSLPrecision));
         if (hasColor) {
             fInColor = &this->addVertexAttrib(Attribute("inColor", kVec4ub_GrVertexAttribType));
         }
         if (hasLocalCoord) {
-            fInLocalCoords = &this->addVertexAttrib(Attribute("inLocalCoord",
-                                                              kVec2f_GrVertexAttribType));
+            GrVertexAttribType localCoordType = (gpTypeFlags & kHalfLocalCoord_GPFlag) ?
+                                            kVec2h_GrVertexAttribType : kVec2f_GrVertexAttribType;
+            fInLocalCoords = &this->addVertexAttrib(Attribute("inLocalCoord", localCoordType));
             if (hasExplicitLocalCoords) {
                 this->setHasExplicitLocalCoords();
             } else {
@@ -270,6 +275,9 @@ GrGeometryProcessor* DefaultGeoProc::TestCreate(GrProcessorTestData* d) {
     if (d->fRandom->nextBool()) {
         flags |= kTransformedLocalCoord_GPFlag;
     }
+    if (d->fRandom->nextBool()) {
+        flags |= kPackedPosition_GPFlag;
+    }
 
     return DefaultGeoProc::Create(flags,
                                   GrRandomColor(d->fRandom),
@@ -283,11 +291,14 @@ GrGeometryProcessor* DefaultGeoProc::TestCreate(GrProcessorTestData* d) {
 const GrGeometryProcessor* GrDefaultGeoProcFactory::Create(const Color& color,
                                                            const Coverage& coverage,
                                                            const LocalCoords& localCoords,
-                                                           const SkMatrix& viewMatrix) {
+                                                           const SkMatrix& viewMatrix,
+                                                           const Position& position) {
     uint32_t flags = 0;
     flags |= color.fType == Color::kAttribute_Type ? kColor_GPFlag : 0;
     flags |= coverage.fType == Coverage::kAttribute_Type ? kCoverage_GPFlag : 0;
     flags |= localCoords.fType == LocalCoords::kHasExplicit_Type ? kLocalCoord_GPFlag : 0;
+    flags |= localCoords.fType == LocalCoords::kHasExplicitHalf_Type ?
+                                  kLocalCoord_GPFlag | kHalfLocalCoord_GPFlag : 0;
     flags |= localCoords.fType == LocalCoords::kHasTransformed_Type ?
                                   kTransformedLocalCoord_GPFlag : 0;
 
@@ -295,11 +306,28 @@ const GrGeometryProcessor* GrDefaultGeoProcFactory::Create(const Color& color,
     bool coverageWillBeIgnored = coverage.fType == Coverage::kNone_Type;
     bool localCoordsWillBeRead = localCoords.fType != LocalCoords::kUnused_Type;
 
+    SkMatrix gpViewMatrix = viewMatrix;
+    SkMatrix localMatrix = localCoords.fMatrix ? *localCoords.fMatrix : SkMatrix::I();
+    if (Position::kPackedDevice_Type == position.fType) {
+        SkASSERT(viewMatrix.isIdentity());
+        flags |= kPackedPosition_GPFlag;
+
+        // The view matrix unpacks the fixed point tile offsets into device space. Local coords
+        // derived from the position need to see the unpacked position too.
+        static const SkScalar kInvScale = SK_Scalar1 / (1 << kPackedPositionFractionBits);
+        gpViewMatrix.setScale(kInvScale, kInvScale);
+        gpViewMatrix.postTranslate(SkIntToScalar(position.fTileOrigin.fX),
+                                   SkIntToScalar(position.fTileOrigin.fY));
+        if (LocalCoords::kUsePosition_Type == localCoords.fType) {
+            localMatrix.preConcat(gpViewMatrix);
+        }
+    }
+
     GrColor inColor = color.fColor;
     return DefaultGeoProc::Create(flags,
                                   inColor,
-                                  viewMatrix,
-                                  localCoords.fMatrix ? *localCoords.fMatrix : SkMatrix::I(),
+                                  gpViewMatrix,
+                                  localMatrix,
                                   localCoordsWillBeRead,
                                   coverageWillBeIgnored,
                                   inCoverage);
@@ -309,7 +337,8 @@ const GrGeometryProcessor* GrDefaultGeoProcFactory::CreateForDeviceSpace(
                                                                      const Color& color,
                                                                      const Coverage& coverage,
                                                                      const LocalCoords& localCoords,
-                                                                     const SkMatrix& viewMatrix) {
+                                                                     const SkMatrix& viewMatrix,
+                                                                     const Position& position) {
     SkMatrix invert = SkMatrix::I();
     if (LocalCoords::kUnused_Type != localCoords.fType) {
         SkASSERT(LocalCoords::kUsePosition_Type == localCoords.fType);
@@ -324,5 +353,5 @@ const GrGeometryProcessor* GrDefaultGeoProcFactory::CreateForDeviceSpace(
     }
 
     LocalCoords inverted(LocalCoords::kUsePosition_Type, &invert);
-    return Create(color, coverage, inverted, SkMatrix::I());
+    return Create(color, coverage, inverted, SkMatrix::I(), position);
 }
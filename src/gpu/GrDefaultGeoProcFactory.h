@@ -9,6 +9,7 @@
 #define GrDefaultGeoProcFactory_DEFINED
 
 #include "GrGeometryProcessor.h"
+#include "SkHalf.h"
 
 class GrDrawState;
 
@@ -106,6 +107,9 @@ namespace GrDefaultGeoProcFactory {
             kUsePosition_Type,
             kHasExplicit_Type,
             kHasTransformed_Type,
+            // Like kHasExplicit_Type but the local coords are two SkHalfs. Requires
+            // GrCaps::halfFloatVertexAttributeSupport() and see CanUseHalfLocalCoords().
+            kHasExplicitHalf_Type,
         };
         LocalCoords(Type type) : fType(type), fMatrix(NULL) {}
         LocalCoords(Type type, const SkMatrix* matrix) : fType(type), fMatrix(matrix) {
@@ -117,10 +121,71 @@ namespace GrDefaultGeoProcFactory {
         const SkMatrix* fMatrix;
     };
 
+    /*
+     * By default the position attribute is two floats. Batches whose device space vertices all
+     * land in one kMaxPackedTileSize square can instead store them as two int16_ts holding
+     * fixed point offsets from the tile's origin (see PackDevicePosition()). Packed positions
+     * are always in device space so the view matrix passed to Create() must be identity.
+     */
+    struct Position {
+        enum Type {
+            kFloat_Type,
+            kPackedDevice_Type,
+        };
+        Position() : fType(kFloat_Type) { fTileOrigin.set(0, 0); }
+        explicit Position(const SkIPoint& tileOrigin)
+            : fType(kPackedDevice_Type)
+            , fTileOrigin(tileOrigin) {}
+
+        Type fType;
+        SkIPoint fTileOrigin;
+    };
+
+    // Packed positions are 12.4 fixed point
+    static const int kPackedPositionFractionBits = 4;
+    static const int kMaxPackedTileSize = SK_MaxS16 >> kPackedPositionFractionBits;
+
+    // Local coords with a magnitude above this lose more than 1/16th of a unit as halfs
+    static const int kMaxHalfLocalCoord = 256;
+
+    /*
+     * Returns true if all the device space points within 'devBounds' can be packed relative to
+     * a single tile, in which case the tile's origin is returned in 'tileOrigin'.
+     */
+    inline bool CanPackDevicePositions(const SkRect& devBounds, SkIPoint* tileOrigin) {
+        if (!devBounds.isFinite() ||
+            devBounds.fLeft < SK_MinS16 || devBounds.fTop < SK_MinS16 ||
+            devBounds.fRight > SK_MaxS16 || devBounds.fBottom > SK_MaxS16) {
+            return false;
+        }
+        tileOrigin->set(SkScalarFloorToInt(devBounds.fLeft), SkScalarFloorToInt(devBounds.fTop));
+        return devBounds.fRight - tileOrigin->fX < kMaxPackedTileSize &&
+               devBounds.fBottom - tileOrigin->fY < kMaxPackedTileSize;
+    }
+
+    inline void PackDevicePosition(const SkPoint& devPt, const SkIPoint& tileOrigin,
+                                   int16_t packed[2]) {
+        static const SkScalar kScale = SkIntToScalar(1 << kPackedPositionFractionBits);
+        packed[0] = SkToS16(SkScalarRoundToInt((devPt.fX - tileOrigin.fX) * kScale));
+        packed[1] = SkToS16(SkScalarRoundToInt((devPt.fY - tileOrigin.fY) * kScale));
+    }
+
+    inline bool CanUseHalfLocalCoords(const SkRect& localBounds) {
+        const SkScalar kMax = SkIntToScalar(kMaxHalfLocalCoord);
+        return localBounds.fLeft >= -kMax && localBounds.fTop >= -kMax &&
+               localBounds.fRight <= kMax && localBounds.fBottom <= kMax;
+    }
+
+    inline void PackLocalCoord(const SkPoint& localPt, SkHalf packed[2]) {
+        packed[0] = SkFloatToHalf(localPt.fX);
+        packed[1] = SkFloatToHalf(localPt.fY);
+    }
+
     const GrGeometryProcessor* Create(const Color&,
                                       const Coverage&,
                                       const LocalCoords&,
-                                      const SkMatrix& viewMatrix);
+                                      const SkMatrix& viewMatrix,
+                                      const Position& = Position());
 
     /*
      * Use this factory to create a GrGeometryProcessor that expects a device space vertex position
@@ -130,7 +195,8 @@ namespace GrDefaultGeoProcFactory {
     const GrGeometryProcessor* CreateForDeviceSpace(const Color&,
                                                     const Coverage&,
                                                     const LocalCoords&,
-                                                    const SkMatrix& viewMatrix);
+                                                    const SkMatrix& viewMatrix,
+                                                    const Position& = Position());
 
     inline size_t DefaultVertexStride() { return sizeof(PositionAttr); }
 };
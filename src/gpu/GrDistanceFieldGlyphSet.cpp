@@ -0,0 +1,195 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrDistanceFieldGlyphSet.h"
+
+#include "GrAtlasTextContext.h"
+#include "GrFontScaler.h"
+#include "SkDistanceFieldGen.h"
+#include "SkGlyphCache.h"
+#include "SkPaint.h"
+#include "SkStream.h"
+#include "SkTHash.h"
+
+// The serialized form is a header, then for each strike its glyph count, the glyphs and their
+// images, in the order the glyphs are listed.
+static const uint32_t kMagic = SkSetFourByteTag('S', 'D', 'F', 'G');
+static const uint32_t kVersion = 1;
+
+struct GrDistanceFieldGlyphSet::Strike {
+    struct Glyph {
+        uint32_t fOffset;   // into fImages
+        int16_t  fLeft;
+        int16_t  fTop;
+        uint16_t fWidth;
+        uint16_t fHeight;
+        uint8_t  fMaskFormat;
+
+        bool matches(const SkGlyph& glyph) const {
+            return fLeft == glyph.fLeft && fTop == glyph.fTop &&
+                   fWidth == glyph.fWidth && fHeight == glyph.fHeight &&
+                   fMaskFormat == glyph.fMaskFormat;
+        }
+
+        size_t imageSize() const {
+            return (fWidth + 2 * SK_DistanceFieldPad) * (fHeight + 2 * SK_DistanceFieldPad);
+        }
+    };
+
+    SkAutoDescriptor             fDesc;
+    SkAutoTUnref<GrFontDescKey>  fKey;
+    SkTDArray<uint16_t>          fGlyphIDs;
+    SkTHashMap<uint16_t, Glyph>  fGlyphs;
+    SkTDArray<uint8_t>           fImages;
+
+    // The glyph's image must already be in fImages, at its fOffset.
+    void addGlyph(uint16_t glyphID, const Glyph& glyph) {
+        *fGlyphIDs.append() = glyphID;
+        fGlyphs.set(glyphID, glyph);
+    }
+};
+
+GrDistanceFieldGlyphSet::GrDistanceFieldGlyphSet() {}
+
+GrDistanceFieldGlyphSet::~GrDistanceFieldGlyphSet() {
+    fStrikes.deleteAll();
+}
+
+void GrDistanceFieldGlyphSet::initStrikes(const SkPaint& paint) {
+    for (int i = 0; i < GrAtlasTextContext::kDistanceFieldSizeCount; ++i) {
+        Strike* strike = SkNEW(Strike);
+        GrAtlasTextContext::GetDistanceFieldDescriptor(paint, i, &strike->fDesc);
+        strike->fKey.reset(SkNEW_ARGS(GrFontDescKey, (*strike->fDesc.getDesc())));
+        *fStrikes.append() = strike;
+    }
+}
+
+GrDistanceFieldGlyphSet* GrDistanceFieldGlyphSet::Create(const SkPaint& paint,
+                                                         const uint16_t glyphIDs[], int count) {
+    SkAutoTUnref<GrDistanceFieldGlyphSet> set(SkNEW(GrDistanceFieldGlyphSet));
+    set->initStrikes(paint);
+
+    for (int i = 0; i < set->fStrikes.count(); ++i) {
+        Strike* strike = set->fStrikes[i];
+        SkGlyphCache* cache = SkGlyphCache::DetachCache(paint.getTypeface(),
+                                                        strike->fDesc.getDesc());
+        SkAutoTUnref<GrFontScaler> scaler(SkNEW_ARGS(GrFontScaler, (cache)));
+        for (int j = 0; j < count; ++j) {
+            if (strike->fGlyphs.find(glyphIDs[j])) {
+                continue;
+            }
+            // The same lookup and generation as the atlas does for distance field text.
+            const SkGlyph& glyph = cache->getGlyphIDMetrics(glyphIDs[j], 0, 0);
+            SkIRect bounds;
+            if (!scaler->getPackedGlyphDFBounds(glyph, &bounds)) {
+                continue;
+            }
+            const int offset = strike->fImages.count();
+            uint8_t* image = strike->fImages.append(bounds.width() * bounds.height());
+            if (!scaler->getPackedGlyphDFImage(glyph, bounds.width(), bounds.height(), image)) {
+                strike->fImages.setCount(offset);
+                continue;
+            }
+            Strike::Glyph g = { SkToU32(offset), SkToS16(glyph.fLeft), SkToS16(glyph.fTop),
+                                glyph.fWidth, glyph.fHeight, glyph.fMaskFormat };
+            strike->addGlyph(glyphIDs[j], g);
+        }
+        scaler.reset(NULL);
+        SkGlyphCache::AttachCache(cache);
+    }
+    return set.detach();
+}
+
+void GrDistanceFieldGlyphSet::serialize(SkWStream* stream) const {
+    stream->write32(kMagic);
+    stream->write32(kVersion);
+    stream->write32(SK_DistanceFieldPad);
+    stream->write32(fStrikes.count());
+    for (int i = 0; i < fStrikes.count(); ++i) {
+        const Strike* strike = fStrikes[i];
+        stream->write32(strike->fGlyphIDs.count());
+        for (int j = 0; j < strike->fGlyphIDs.count(); ++j) {
+            const Strike::Glyph& g = *strike->fGlyphs.find(strike->fGlyphIDs[j]);
+            stream->write16(strike->fGlyphIDs[j]);
+            stream->write16(g.fLeft);
+            stream->write16(g.fTop);
+            stream->write16(g.fWidth);
+            stream->write16(g.fHeight);
+            stream->write8(g.fMaskFormat);
+            stream->write(strike->fImages.begin() + g.fOffset, g.imageSize());
+        }
+    }
+}
+
+template <typename T> static bool read_value(SkStream* stream, T* value) {
+    return sizeof(T) == stream->read(value, sizeof(T));
+}
+
+GrDistanceFieldGlyphSet* GrDistanceFieldGlyphSet::Deserialize(SkStream* stream,
+                                                              const SkPaint& paint) {
+    uint32_t magic, version, pad, strikeCount;
+    if (!read_value(stream, &magic) || kMagic != magic ||
+        !read_value(stream, &version) || kVersion != version ||
+        !read_value(stream, &pad) || SK_DistanceFieldPad != pad ||
+        !read_value(stream, &strikeCount) ||
+        GrAtlasTextContext::kDistanceFieldSizeCount != strikeCount) {
+        return NULL;
+    }
+
+    SkAutoTUnref<GrDistanceFieldGlyphSet> set(SkNEW(GrDistanceFieldGlyphSet));
+    set->initStrikes(paint);
+    for (int i = 0; i < set->fStrikes.count(); ++i) {
+        Strike* strike = set->fStrikes[i];
+        uint32_t glyphCount;
+        if (!read_value(stream, &glyphCount) || glyphCount > SK_MaxU16 + 1) {
+            return NULL;
+        }
+        for (uint32_t j = 0; j < glyphCount; ++j) {
+            uint16_t glyphID;
+            Strike::Glyph g;
+            if (!read_value(stream, &glyphID) ||
+                !read_value(stream, &g.fLeft) || !read_value(stream, &g.fTop) ||
+                !read_value(stream, &g.fWidth) || !read_value(stream, &g.fHeight) ||
+                !read_value(stream, &g.fMaskFormat) || strike->fGlyphs.find(glyphID)) {
+                return NULL;
+            }
+            g.fOffset = strike->fImages.count();
+            const size_t size = g.imageSize();
+            if (stream->read(strike->fImages.append(SkToInt(size)), size) != size) {
+                return NULL;
+            }
+            strike->addGlyph(glyphID, g);
+        }
+    }
+    return set.detach();
+}
+
+int GrDistanceFieldGlyphSet::countGlyphs(int strikeIndex) const {
+    return fStrikes[strikeIndex]->fGlyphIDs.count();
+}
+
+int GrDistanceFieldGlyphSet::findStrike(const GrFontDescKey& key) const {
+    for (int i = 0; i < fStrikes.count(); ++i) {
+        if (*fStrikes[i]->fKey == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const uint8_t* GrDistanceFieldGlyphSet::findImage(int strikeIndex, const SkGlyph& glyph) const {
+    // Distance field glyphs are always generated at the integer position.
+    if (glyph.getSubXFixed() || glyph.getSubYFixed()) {
+        return NULL;
+    }
+    const Strike* strike = fStrikes[strikeIndex];
+    const Strike::Glyph* g = strike->fGlyphs.find(glyph.getGlyphID());
+    if (NULL == g || !g->matches(glyph)) {
+        return NULL;
+    }
+    return strike->fImages.begin() + g->fOffset;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrDownscaleUtils.h"
+
+#include "GrCaps.h"
+#include "GrContext.h"
+#include "GrDrawContext.h"
+#include "SkBitmapFilter.h"
+#include "effects/GrConvolutionEffect.h"
+
+void GrDownscaleUtils::ComputeLanczosKernel(float scale, float kernel[], int* radius) {
+    SkASSERT(scale >= 0.5f && scale < 1.f);
+    static const float kLanczosWidth = 3.f;
+    SkLanczosFilter filter(kLanczosWidth);
+
+    // Taps whose distance in destination pixels reaches the filter width have no weight.
+    *radius = SkTMin(static_cast<int>(ceilf(kLanczosWidth / scale)) - 1, kMaxLanczosRadius);
+    SkASSERT(*radius <= GrConvolutionEffect::kMaxKernelRadius);
+
+    float sum = 0.f;
+    for (int i = -*radius; i <= *radius; ++i) {
+        float weight = filter.evaluate(i * scale);
+        kernel[i + *radius] = weight;
+        sum += weight;
+    }
+    float scaleBy = 1.f / sum;
+    for (int i = 0; i < Gr1DKernelEffect::WidthFromRadius(*radius); ++i) {
+        kernel[i] *= scaleBy;
+    }
+}
+
+static GrTexture* create_pass_texture(GrContext* context, GrPixelConfig config,
+                                      int width, int height) {
+    GrSurfaceDesc desc;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    desc.fWidth = width;
+    desc.fHeight = height;
+    desc.fConfig = config;
+    // The passes rely on clamping at the texture edges so the textures must be exactly sized.
+    return context->textureProvider()->createTexture(desc, true);
+}
+
+static bool lanczos_pass(GrContext* context, GrTexture* src, const SkIRect& srcRect,
+                         GrTexture* dst, Gr1DKernelEffect::Direction direction, float scale) {
+    GrDrawContext* drawContext = context->drawContext();
+    if (!drawContext) {
+        return false;
+    }
+    float kernel[GrConvolutionEffect::kMaxKernelWidth];
+    int radius;
+    GrDownscaleUtils::ComputeLanczosKernel(scale, kernel, &radius);
+
+    GrPaint paint;
+    SkAutoTUnref<GrFragmentProcessor> conv(GrConvolutionEffect::Create(
+            paint.getProcessorDataManager(), src, direction, radius, kernel, false, NULL));
+    paint.addColorProcessor(conv);
+    drawContext->drawNonAARectToRect(dst->asRenderTarget(), GrClip::WideOpen(), paint,
+                                     SkMatrix::I(), SkRect::MakeIWH(dst->width(), dst->height()),
+                                     SkRect::Make(srcRect));
+    return true;
+}
+
+GrTexture* GrDownscaleUtils::Downscale(GrContext* context, GrTexture* srcTexture,
+                                       const SkIRect& srcRect, int dstWidth, int dstHeight) {
+    SkASSERT(context && srcTexture);
+    SkASSERT(dstWidth > 0 && dstWidth <= srcRect.width());
+    SkASSERT(dstHeight > 0 && dstHeight <= srcRect.height());
+
+    GrPixelConfig config = srcTexture->config();
+    if (!context->caps()->isConfigRenderable(config, false)) {
+        return NULL;
+    }
+
+    SkAutoTUnref<GrTexture> src(SkRef(srcTexture));
+    SkIRect rect = srcRect;
+
+    // Bilinear halving visits every source texel exactly once so it doesn't alias. It leaves at
+    // most a 2x scale for the Lanczos passes.
+    while (rect.width() >= 2 * dstWidth || rect.height() >= 2 * dstHeight) {
+        int width = rect.width() >= 2 * dstWidth ? rect.width() / 2 : rect.width();
+        int height = rect.height() >= 2 * dstHeight ? rect.height() / 2 : rect.height();
+        SkAutoTUnref<GrTexture> dst(create_pass_texture(context, config, width, height));
+        GrDrawContext* drawContext = context->drawContext();
+        if (!dst || !drawContext) {
+            return NULL;
+        }
+
+        GrPaint paint;
+        SkMatrix matrix;
+        matrix.setIDiv(src->width(), src->height());
+        GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kBilerp_FilterMode);
+        paint.addColorTextureProcessor(src, matrix, params);
+        drawContext->drawNonAARectToRect(dst->asRenderTarget(), GrClip::WideOpen(), paint,
+                                         SkMatrix::I(), SkRect::MakeIWH(width, height),
+                                         SkRect::Make(rect));
+        src.reset(dst.detach());
+        rect = SkIRect::MakeWH(width, height);
+    }
+
+    if (rect.width() > dstWidth) {
+        SkAutoTUnref<GrTexture> dst(create_pass_texture(context, config, dstWidth,
+                                                        rect.height()));
+        float scale = static_cast<float>(dstWidth) / rect.width();
+        if (!dst || !lanczos_pass(context, src, rect, dst, Gr1DKernelEffect::kX_Direction, scale)) {
+            return NULL;
+        }
+        src.reset(dst.detach());
+        rect = SkIRect::MakeWH(dstWidth, rect.height());
+    }
+
+    if (rect.height() > dstHeight) {
+        SkAutoTUnref<GrTexture> dst(create_pass_texture(context, config, rect.width(),
+                                                        dstHeight));
+        float scale = static_cast<float>(dstHeight) / rect.height();
+        if (!dst || !lanczos_pass(context, src, rect, dst, Gr1DKernelEffect::kY_Direction, scale)) {
+            return NULL;
+        }
+        src.reset(dst.detach());
+        rect = SkIRect::MakeWH(rect.width(), dstHeight);
+    }
+
+    // Only happens when srcRect was already the requested size.
+    if (src == srcTexture) {
+        SkAutoTUnref<GrTexture> dst(create_pass_texture(context, config, dstWidth, dstHeight));
+        if (!dst) {
+            return NULL;
+        }
+        context->copySurface(dst, src, srcRect, SkIPoint::Make(0, 0));
+        src.reset(dst.detach());
+    }
+    return src.detach();
+}
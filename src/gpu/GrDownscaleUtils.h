@@ -0,0 +1,41 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrDownscaleUtils_DEFINED
+#define GrDownscaleUtils_DEFINED
+
+class GrContext;
+class GrTexture;
+struct SkIRect;
+
+/**
+ * High quality GPU downscaling. The source is first halved with bilinear draws until it is less
+ * than twice the requested size and the remaining scale is then applied with separable Lanczos
+ * passes, matching the filter SkBitmapScaler uses on the CPU.
+ */
+namespace GrDownscaleUtils {
+    // Lanczos passes scale by at most 2x so their kernels never exceed this radius.
+    static const int kMaxLanczosRadius = 5;
+
+    /**
+     * Computes the Lanczos (a = 3) weights for sampling a source texel grid that is being scaled
+     * by 'scale', which must be in [0.5, 1). The weights are normalized and 'kernel' must hold
+     * GrConvolutionEffect::kMaxKernelWidth entries. The kernel's radius is returned in 'radius'.
+     */
+    void ComputeLanczosKernel(float scale, float kernel[], int* radius);
+
+    /**
+     * Scales the 'srcRect' portion of 'srcTexture' down to dstWidth x dstHeight. Neither
+     * dimension may be larger than the matching srcRect dimension. Texels outside of srcRect may
+     * be sampled near its edges. Returns a new texture that the caller must unref, or NULL on
+     * failure.
+     */
+    GrTexture* Downscale(GrContext*, GrTexture* srcTexture, const SkIRect& srcRect,
+                         int dstWidth, int dstHeight);
+};
+
+#endif
@@ -20,6 +20,7 @@
 #include "batches/GrBatch.h"
 #include "batches/GrDrawAtlasBatch.h"
 #include "batches/GrDrawVerticesBatch.h"
+#include "batches/GrNinePatchBatch.h"
 #include "batches/GrStrokeRectBatch.h"
 
 #include "SkGr.h"
@@ -496,6 +497,28 @@ void GrDrawContext::drawAtlas(GrRenderTarget* rt,
     fDrawTarget->drawBatch(pipelineBuilder, batch);
 }
 
+void GrDrawContext::drawImageNine(GrRenderTarget* rt,
+                                  const GrClip& clip,
+                                  const GrPaint& paint,
+                                  const SkMatrix& viewMatrix,
+                                  int imageWidth,
+                                  int imageHeight,
+                                  const SkIRect& center,
+                                  const SkRect& dst) {
+    RETURN_IF_ABANDONED
+    AutoCheckFlush acf(fContext);
+    if (!this->prepareToDraw(rt)) {
+        return;
+    }
+
+    GrPipelineBuilder pipelineBuilder(paint, rt, clip);
+
+    SkAutoTUnref<GrBatch> batch(GrNinePatchBatch::Create(paint.getColor(), viewMatrix,
+                                                         imageWidth, imageHeight, center, dst));
+
+    fDrawTarget->drawBatch(pipelineBuilder, batch);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void GrDrawContext::drawRRect(GrRenderTarget*rt,
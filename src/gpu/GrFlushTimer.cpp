@@ -0,0 +1,133 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrFlushTimer.h"
+
+#include "GrGpu.h"
+
+GrFlushTimer::GrFlushTimer(GrGpu* gpu, GrContext::PFGpuTimingFunc func, void* info)
+    : fGpu(gpu)
+    , fFunc(func)
+    , fInfo(info)
+    , fFlushID(0)
+    , fSectionOpen(false) {
+    SkASSERT(fGpu && fFunc);
+}
+
+GrFlushTimer::~GrFlushTimer() {
+    this->endSection();
+    for (int i = 0; i < fSections.count(); ++i) {
+        fGpu->deleteTimerQuery(fSections[i].fQuery);
+    }
+}
+
+void GrFlushTimer::beginSection(const char* name, uint32_t renderTargetID) {
+    if (fSectionOpen) {
+        Section& open = fSections.top();
+        if (open.fName == name && open.fRenderTargetID == renderTargetID) {
+            ++open.fCount;
+            return;
+        }
+        this->endSection();
+    }
+    GrTimerQuery query = fGpu->beginTimerQuery();
+    if (!query) {
+        return;
+    }
+    Section& section = *fSections.append();
+    section.fFlushID = fFlushID;
+    section.fName = name;
+    section.fRenderTargetID = renderTargetID;
+    section.fCount = 1;
+    section.fQuery = query;
+    fSectionOpen = true;
+}
+
+void GrFlushTimer::endSection() {
+    if (fSectionOpen) {
+        fGpu->endTimerQuery(fSections.top().fQuery);
+        fSectionOpen = false;
+    }
+}
+
+void GrFlushTimer::didFlush() {
+    this->endSection();
+    ++fFlushID;
+    this->resolveSections();
+}
+
+void GrFlushTimer::abandon() {
+    fSections.reset();
+    fSectionOpen = false;
+}
+
+void GrFlushTimer::resolveSections() {
+    SkASSERT(!fSectionOpen);
+    int resolved = 0;
+    while (resolved < fSections.count()) {
+        int flushID = fSections[resolved].fFlushID;
+        int end = resolved + 1;
+        while (end < fSections.count() && fSections[end].fFlushID == flushID) {
+            ++end;
+        }
+        // The GPU finishes the queries in order so the flush is ready once its last one is.
+        uint64_t lastNanoseconds;
+        GrGpu::TimerQueryResult lastResult =
+                fGpu->getTimerQueryResult(fSections[end - 1].fQuery, &lastNanoseconds);
+        if (GrGpu::kPending_TimerQueryResult == lastResult) {
+            break;
+        }
+
+        fEntries.rewind();
+        GrContext::GpuTimingStats stats;
+        stats.fFlushID = flushID;
+        stats.fTotalNanoseconds = 0;
+        bool disjoint = false;
+        for (int i = resolved; i < end; ++i) {
+            const Section& section = fSections[i];
+            uint64_t nanoseconds = lastNanoseconds;
+            GrGpu::TimerQueryResult result = lastResult;
+            if (i < end - 1) {
+                result = fGpu->getTimerQueryResult(section.fQuery, &nanoseconds);
+            }
+            if (GrGpu::kReady_TimerQueryResult != result) {
+                disjoint = true;
+            }
+            fGpu->deleteTimerQuery(section.fQuery);
+            if (disjoint) {
+                continue;
+            }
+            stats.fTotalNanoseconds += nanoseconds;
+
+            GrContext::GpuTimingEntry* entry = NULL;
+            for (int j = 0; j < fEntries.count(); ++j) {
+                if (fEntries[j].fName == section.fName &&
+                    fEntries[j].fRenderTargetID == section.fRenderTargetID) {
+                    entry = &fEntries[j];
+                    break;
+                }
+            }
+            if (!entry) {
+                entry = fEntries.append();
+                entry->fName = section.fName;
+                entry->fRenderTargetID = section.fRenderTargetID;
+                entry->fCount = 0;
+                entry->fNanoseconds = 0;
+            }
+            entry->fCount += section.fCount;
+            entry->fNanoseconds += nanoseconds;
+        }
+        resolved = end;
+
+        if (!disjoint) {
+            stats.fEntries = fEntries.begin();
+            stats.fEntryCount = fEntries.count();
+            fFunc(stats, fInfo);
+        }
+    }
+    fSections.remove(0, resolved);
+}
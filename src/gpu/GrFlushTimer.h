@@ -0,0 +1,63 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrFlushTimer_DEFINED
+#define GrFlushTimer_DEFINED
+
+#include "GrContext.h"
+#include "GrTypesPriv.h"
+#include "SkTDArray.h"
+
+class GrGpu;
+
+/**
+ * Times the commands executed during each flush with GrGpu timer queries and reports the results
+ * to the callback passed to GrContext::setGpuTimingCallback(). Consecutive commands with the same
+ * name and render target share a single query. Queries are only read once the GPU has finished
+ * with them, so each flush is reported from a later call to didFlush().
+ */
+class GrFlushTimer : SkNoncopyable {
+public:
+    GrFlushTimer(GrGpu*, GrContext::PFGpuTimingFunc, void* info);
+    ~GrFlushTimer();
+
+    /**
+     * Attributes the GPU work issued until the next beginSection() or endSection() to 'name' and
+     * the render target. 'name' must have static storage duration.
+     */
+    void beginSection(const char* name, uint32_t renderTargetID);
+    void endSection();
+
+    /** Called at the end of each GrContext flush. Reports the flushes the GPU has finished. */
+    void didFlush();
+
+    /** Forgets all the queries without deleting them in the backend 3D API. */
+    void abandon();
+
+private:
+    struct Section {
+        int          fFlushID;
+        const char*  fName;
+        uint32_t     fRenderTargetID;
+        int          fCount;
+        GrTimerQuery fQuery;
+    };
+
+    // Reports the flushes whose queries are all ready and removes them from fSections.
+    void resolveSections();
+
+    GrGpu*                                  fGpu;
+    GrContext::PFGpuTimingFunc              fFunc;
+    void*                                   fInfo;
+    // Ended sections in issue order, followed by the open one when fSectionOpen.
+    SkTDArray<Section>                      fSections;
+    SkTDArray<GrContext::GpuTimingEntry>    fEntries;
+    int                                     fFlushID;
+    bool                                    fSectionOpen;
+};
+
+#endif
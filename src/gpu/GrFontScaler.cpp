@@ -10,6 +10,7 @@
 #include "SkDescriptor.h"
 #include "SkDistanceFieldGen.h"
 #include "SkGlyphCache.h"
+#include "SkTemplates.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -205,3 +206,16 @@ const SkGlyph& GrFontScaler::grToSkGlyph(GrGlyph::PackedID id) {
                                       GrGlyph::UnpackFixedX(id),
                                       GrGlyph::UnpackFixedY(id));
 }
+
+void GrFontScaler::prepareGlyphImages(const GrGlyph::PackedID ids[], int count) {
+    // Looking up a glyph can grow the strike and move the others, so make sure they all exist
+    // before taking their addresses.
+    for (int i = 0; i < count; ++i) {
+        this->grToSkGlyph(ids[i]);
+    }
+    SkAutoSTMalloc<64, const SkGlyph*> glyphs(count);
+    for (int i = 0; i < count; ++i) {
+        glyphs[i] = &this->grToSkGlyph(ids[i]);
+    }
+    fStrike->findImages(glyphs.get(), count);
+}
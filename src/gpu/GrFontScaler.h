@@ -58,6 +58,9 @@ public:
     bool getPackedGlyphDFImage(const SkGlyph&, int width, int height, void* image);
     const SkPath* getGlyphPath(const SkGlyph&);
     const SkGlyph& grToSkGlyph(GrGlyph::PackedID);
+    // Rasterizes the images of many glyphs at once, in parallel when it pays; the getPacked*Image
+    // calls for these glyphs then only copy.
+    void prepareGlyphImages(const GrGlyph::PackedID ids[], int count);
     
 private:
     SkGlyphCache*  fStrike;
@@ -108,6 +108,7 @@ protected:
 
 private:
     virtual size_t onGpuMemorySize() const { return fGpuMemorySize; }
+    CacheCategory onCacheCategory() const override { return kBuffer_CacheCategory; }
 
     virtual void* onMap() = 0;
     virtual void onUnmap() = 0;
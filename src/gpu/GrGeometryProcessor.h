@@ -70,6 +70,19 @@ protected:
         return fAttribs[fNumAttribs++];
     }
 
+    /**
+     * Like addVertexAttrib() but the attribute is read from the instance buffer and advances once
+     * per instance. Per-instance attributes are laid out in the order they are added, separately
+     * from the per-vertex ones.
+     */
+    const Attribute& addInstanceAttrib(const Attribute& attribute) {
+        SkASSERT(fNumAttribs < kMaxVertexAttribs);
+        fInstanceStride += attribute.fOffset;
+        fAttribs[fNumAttribs] = attribute;
+        fAttribs[fNumAttribs].fPerInstance = true;
+        return fAttribs[fNumAttribs++];
+    }
+
     void setWillUseGeoShader() { fWillUseGeoShader = true; }
 
     /**
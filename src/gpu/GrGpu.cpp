@@ -27,6 +27,8 @@ GrVertices& GrVertices::operator =(const GrVertices& di) {
     fStartIndex     = di.fStartIndex;
     fVertexCount    = di.fVertexCount;
     fIndexCount     = di.fIndexCount;
+    fStartInstance  = di.fStartInstance;
+    fHWInstanceCount = di.fHWInstanceCount;
 
     fInstanceCount          = di.fInstanceCount;
     fVerticesPerInstance    = di.fVerticesPerInstance;
@@ -35,6 +37,7 @@ GrVertices& GrVertices::operator =(const GrVertices& di) {
 
     fVertexBuffer.reset(di.vertexBuffer());
     fIndexBuffer.reset(di.indexBuffer());
+    fInstanceBuffer.reset(di.instanceBuffer());
 
     return *this;
 }
@@ -216,6 +219,26 @@ GrIndexBuffer* GrGpu::createIndexBuffer(size_t size, bool dynamic) {
     return ib;
 }
 
+GrVertexBuffer* GrGpu::createPersistentVertexBuffer(size_t size) {
+    SkASSERT(this->caps()->mapBufferFlags() & GrCaps::kPersistent_MapFlag);
+    this->handleDirtyContext();
+    GrVertexBuffer* vb = this->onCreatePersistentVertexBuffer(size);
+    if (vb) {
+        vb->resourcePriv().removeScratchKey();
+    }
+    return vb;
+}
+
+GrIndexBuffer* GrGpu::createPersistentIndexBuffer(size_t size) {
+    SkASSERT(this->caps()->mapBufferFlags() & GrCaps::kPersistent_MapFlag);
+    this->handleDirtyContext();
+    GrIndexBuffer* ib = this->onCreatePersistentIndexBuffer(size);
+    if (ib) {
+        ib->resourcePriv().removeScratchKey();
+    }
+    return ib;
+}
+
 void GrGpu::clear(const SkIRect& rect,
                   GrColor color,
                   GrRenderTarget* renderTarget) {
@@ -318,6 +341,20 @@ bool GrGpu::readPixels(GrSurface* surface,
                               rowBytes);
 }
 
+GrAsyncRead GrGpu::beginAsyncReadPixels(GrSurface* surface,
+                                        int left, int top, int width, int height,
+                                        GrPixelConfig config) {
+    this->handleDirtyContext();
+
+    if (GrPixelConfigIsCompressed(config) ||
+        !SkIRect::MakeWH(surface->width(), surface->height()).contains(
+                SkIRect::MakeXYWH(left, top, width, height))) {
+        return 0;
+    }
+
+    return this->onBeginAsyncReadPixels(surface, left, top, width, height, config);
+}
+
 bool GrGpu::writePixels(GrSurface* surface,
                         int left, int top, int width, int height,
                         GrPixelConfig config, const void* buffer,
@@ -380,10 +417,21 @@ void GrGpu::removeGpuTraceMarker(const GrGpuTraceMarker* marker) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void GrGpu::draw(const DrawArgs& args, const GrVertices& vertices) {
+    this->draw(args, &vertices, 1);
+}
+
+void GrGpu::draw(const DrawArgs& args, const GrVertices vertices[], int count) {
     this->handleDirtyContext();
-    GrVertices::Iterator iter;
-    const GrNonInstancedVertices* verts = iter.init(vertices);
-    do {
-        this->onDraw(args, *verts);
-    } while ((verts = iter.next()));
+    this->onDrawMultiple(args, vertices, count);
+}
+
+void GrGpu::onDrawMultiple(const DrawArgs& args, const GrVertices vertices[], int count) {
+    for (int i = 0; i < count; ++i) {
+        GrVertices::Iterator iter;
+        const GrNonInstancedVertices* verts = iter.init(vertices[i]);
+        do {
+            fStats.incDraws();
+            this->onDraw(args, *verts);
+        } while ((verts = iter.next()));
+    }
 }
@@ -128,6 +128,18 @@ public:
      */
     GrIndexBuffer* createIndexBuffer(size_t size, bool dynamic);
 
+    /**
+     * Creates dynamic buffers whose storage stays mapped for their entire lifetime. Only valid
+     * when caps()->mapBufferFlags() includes GrCaps::kPersistent_MapFlag. map() always returns
+     * the same pointer and writes are visible to later draws without unmapping, so the caller
+     * must use fences to avoid overwriting data the GPU has not consumed. These buffers are never
+     * recycled through the scratch cache.
+     *
+     * @return The buffer if successful, otherwise NULL.
+     */
+    GrVertexBuffer* createPersistentVertexBuffer(size_t size);
+    GrIndexBuffer* createPersistentIndexBuffer(size_t size);
+
     /**
      * Resolves MSAA.
      */
@@ -230,6 +242,26 @@ public:
                     int left, int top, int width, int height,
                     GrPixelConfig config, void* buffer, size_t rowBytes);
 
+    /**
+     * Asynchronous reads copy a rectangle of a surface into GPU memory once the commands issued
+     * so far have executed, without waiting for them. The rectangle must lie within the surface
+     * and the read must not require a draw (see getReadPixelsInfo()). Returns 0 if the backend
+     * can't read the surface asynchronously, in which case readPixels() should be used.
+     */
+    GrAsyncRead beginAsyncReadPixels(GrSurface* surface,
+                                     int left, int top, int width, int height,
+                                     GrPixelConfig config);
+
+    /** Returns true once the read's pixels have arrived, waiting up to 'timeout' nanoseconds. */
+    virtual bool isAsyncReadFinished(GrAsyncRead, uint64_t timeout) { return false; }
+
+    /**
+     * Returns the read's pixels, top row first, and sets 'rowBytes'. Returns NULL on failure. The
+     * pixels remain valid until endAsyncReadPixels(), which must be called for every read.
+     */
+    virtual const void* mapAsyncReadPixels(GrAsyncRead, size_t* rowBytes) { return NULL; }
+    virtual void endAsyncReadPixels(GrAsyncRead) {}
+
     /**
      * Updates the pixels in a rectangle of a surface.
      *
@@ -302,6 +334,35 @@ public:
     // Called before certain draws in order to guarantee coherent results from dst reads.
     virtual void xferBarrier(GrRenderTarget*, GrXferBarrierType) = 0;
 
+    /**
+     * Fences mark the commands issued so far. waitFence() returns true once the GPU has finished
+     * all of them, waiting up to 'timeout' nanoseconds (zero polls). Only supported when
+     * caps()->mapBufferFlags() includes GrCaps::kPersistent_MapFlag.
+     */
+    virtual GrFence insertFence() = 0;
+    virtual bool waitFence(GrFence, uint64_t timeout) = 0;
+    virtual void deleteFence(GrFence) = 0;
+
+    enum TimerQueryResult {
+        kPending_TimerQueryResult,
+        kReady_TimerQueryResult,
+        // The GPU's timer was disrupted while the query was active so its time is meaningless.
+        kDisjoint_TimerQueryResult,
+    };
+
+    /**
+     * Timer queries measure the GPU time taken by the commands issued between beginTimerQuery()
+     * and endTimerQuery(). Only one query may be active at a time. getTimerQueryResult() never
+     * waits for the GPU. Only supported when caps()->timerQuerySupport(); beginTimerQuery()
+     * returns 0 otherwise.
+     */
+    virtual GrTimerQuery beginTimerQuery() { return 0; }
+    virtual void endTimerQuery(GrTimerQuery) {}
+    virtual TimerQueryResult getTimerQueryResult(GrTimerQuery, uint64_t* nanoseconds) {
+        return kDisjoint_TimerQueryResult;
+    }
+    virtual void deleteTimerQuery(GrTimerQuery) {}
+
     struct DrawArgs {
         DrawArgs(const GrPrimitiveProcessor* primProc,
                  const GrPipeline* pipeline,
@@ -319,7 +380,15 @@ public:
         const GrBatchTracker* fBatchTracker;
     };
 
+    // Before a flush draws anything it may hand the backend the DrawArgs of each draw, if
+    // preparesPrograms() is true. The backend can start building the programs it doesn't have
+    // yet, so that the driver compiles them together instead of stalling on each in turn.
+    virtual bool preparesPrograms() const { return false; }
+    virtual void prepareProgram(const DrawArgs&) {}
+
     void draw(const DrawArgs&, const GrVertices&);
+    // Draws several GrVertices that share the same DrawArgs. The backend may submit them together.
+    void draw(const DrawArgs&, const GrVertices[], int count);
 
     ///////////////////////////////////////////////////////////////////////////
     // Debugging and Stats
@@ -335,6 +404,15 @@ public:
             fTextureCreates = 0;
             fTextureUploads = 0;
             fStencilAttachmentCreates = 0;
+            fDraws = 0;
+            fBatchesRecorded = 0;
+            fBatchesCombined = 0;
+            fSkippedProgramBinds = 0;
+            fSkippedBufferBinds = 0;
+            fSkippedVertexAttribCalls = 0;
+            fSkippedUniformUploads = 0;
+            fMultiDraws = 0;
+            fMultiDrawCalls = 0;
         }
 
         int renderTargetBinds() const { return fRenderTargetBinds; }
@@ -346,6 +424,28 @@ public:
         int textureUploads() const { return fTextureUploads; }
         void incTextureUploads() { fTextureUploads++; }
         void incStencilAttachmentCreates() { fStencilAttachmentCreates++; }
+        int draws() const { return fDraws; }
+        void incDraws() { fDraws++; }
+        // Batches handed to the command builder, and how many of those were merged into an
+        // earlier batch rather than becoming a draw of their own.
+        int batchesRecorded() const { return fBatchesRecorded; }
+        void incBatchesRecorded() { fBatchesRecorded++; }
+        int batchesCombined() const { return fBatchesCombined; }
+        void incBatchesCombined() { fBatchesCombined++; }
+        // 3D API calls that the backend's state shadowing found to be redundant and skipped.
+        int skippedProgramBinds() const { return fSkippedProgramBinds; }
+        void incSkippedProgramBinds() { fSkippedProgramBinds++; }
+        int skippedBufferBinds() const { return fSkippedBufferBinds; }
+        void incSkippedBufferBinds() { fSkippedBufferBinds++; }
+        int skippedVertexAttribCalls() const { return fSkippedVertexAttribCalls; }
+        void incSkippedVertexAttribCalls() { fSkippedVertexAttribCalls++; }
+        int skippedUniformUploads() const { return fSkippedUniformUploads; }
+        void incSkippedUniformUploads() { fSkippedUniformUploads++; }
+        // Draws that were submitted together with a single multi-draw call, and those calls.
+        int multiDraws() const { return fMultiDraws; }
+        void incMultiDraws() { fMultiDraws++; }
+        int multiDrawCalls() const { return fMultiDrawCalls; }
+        void incMultiDrawCalls() { fMultiDrawCalls++; }
         void dump(SkString*);
 
     private:
@@ -354,6 +454,15 @@ public:
         int fTextureCreates;
         int fTextureUploads;
         int fStencilAttachmentCreates;
+        int fDraws;
+        int fBatchesRecorded;
+        int fBatchesCombined;
+        int fSkippedProgramBinds;
+        int fSkippedBufferBinds;
+        int fSkippedVertexAttribCalls;
+        int fSkippedUniformUploads;
+        int fMultiDraws;
+        int fMultiDrawCalls;
 #else
         void dump(SkString*) {};
         void incRenderTargetBinds() {}
@@ -361,6 +470,15 @@ public:
         void incTextureCreates() {}
         void incTextureUploads() {}
         void incStencilAttachmentCreates() {}
+        void incDraws() {}
+        void incBatchesRecorded() {}
+        void incBatchesCombined() {}
+        void incSkippedProgramBinds() {}
+        void incSkippedBufferBinds() {}
+        void incSkippedVertexAttribCalls() {}
+        void incSkippedUniformUploads() {}
+        void incMultiDraws() {}
+        void incMultiDrawCalls() {}
 #endif
     };
 
@@ -422,6 +540,10 @@ protected:
 
     const GrTraceMarkerSet& getActiveTraceMarkers() const { return fActiveTraceMarkers; }
 
+    // Draws each GrVertices, as split up by GrVertices::Iterator, with onDraw(). Backends that can
+    // submit many draws at once override this.
+    virtual void onDrawMultiple(const DrawArgs&, const GrVertices[], int count);
+
     Stats                                   fStats;
     SkAutoTDelete<GrPathRendering>          fPathRendering;
     // Subclass must initialize this in its constructor.
@@ -446,6 +568,8 @@ private:
                                                       GrWrapOwnership) = 0;
     virtual GrVertexBuffer* onCreateVertexBuffer(size_t size, bool dynamic) = 0;
     virtual GrIndexBuffer* onCreateIndexBuffer(size_t size, bool dynamic) = 0;
+    virtual GrVertexBuffer* onCreatePersistentVertexBuffer(size_t size) = 0;
+    virtual GrIndexBuffer* onCreatePersistentIndexBuffer(size_t size) = 0;
 
     // overridden by backend-specific derived class to perform the clear.
     virtual void onClear(GrRenderTarget*, const SkIRect& rect, GrColor color) = 0;
@@ -473,6 +597,14 @@ private:
                               void* buffer,
                               size_t rowBytes) = 0;
 
+    // overridden by backends that can read a surface without waiting for the GPU
+    virtual GrAsyncRead onBeginAsyncReadPixels(GrSurface*,
+                                               int left, int top,
+                                               int width, int height,
+                                               GrPixelConfig) {
+        return 0;
+    }
+
     // overridden by backend-specific derived class to perform the surface write
     virtual bool onWritePixels(GrSurface*,
                                int left, int top, int width, int height,
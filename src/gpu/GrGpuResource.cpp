@@ -23,11 +23,14 @@ GrGpuResource::GrGpuResource(GrGpu* gpu, LifeCycle lifeCycle)
     : fGpu(gpu)
     , fGpuMemorySize(kInvalidGpuMemorySize)
     , fLifeCycle(lifeCycle)
+    , fCacheCategory(kOther_CacheCategory)
     , fUniqueID(CreateUniqueID()) {
     SkDEBUGCODE(fCacheArrayIndex = -1);
 }
 
 void GrGpuResource::registerWithCache() {
+    // The subclass is fully constructed by now, so ask it which category it belongs to.
+    fCacheCategory = this->onCacheCategory();
     get_resource_cache(fGpu)->resourceAccess().insertResource(this);
 }
 
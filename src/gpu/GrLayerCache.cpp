@@ -79,10 +79,23 @@ private:
 #endif
 
 GrLayerCache::GrLayerCache(GrContext* context)
-    : fContext(context) {
+    : fContext(context)
+    , fNumPlotsX(kInitialNumPlotsX)
+    , fNumPlotsY(kInitialNumPlotsY)
+    , fAtlasWantsToGrow(false)
+    , fHits(0)
+    , fMisses(0)
+    , fEvictions(0) {
     memset(fPlotLocks, 0, sizeof(fPlotLocks));
 }
 
+void GrLayerCache::InvalidateCachedTexture(const GrCachedLayer* layer) {
+    if (layer->fTextureKey.isValid()) {
+        const GrUniqueKeyInvalidatedMessage msg(layer->fTextureKey);
+        SkMessageBus<GrUniqueKeyInvalidatedMessage>::Post(msg);
+    }
+}
+
 GrLayerCache::~GrLayerCache() {
 
     SkTDynamicHash<GrCachedLayer, GrCachedLayer::Key>::Iter iter(&fLayerHash);
@@ -101,12 +114,36 @@ GrLayerCache::~GrLayerCache() {
 
 void GrLayerCache::initAtlas() {
     SkASSERT(NULL == fAtlas.get());
-    GR_STATIC_ASSERT(kNumPlotsX*kNumPlotsX == GrPictureInfo::kNumPlots);
+    GR_STATIC_ASSERT(kMaxNumPlotsX*kMaxNumPlotsY == GrPictureInfo::kNumPlots);
+    SkASSERT(fNumPlotsX <= kMaxNumPlotsX && fNumPlotsY <= kMaxNumPlotsY);
 
-    SkISize textureSize = SkISize::Make(kAtlasTextureWidth, kAtlasTextureHeight);
+    SkISize textureSize = SkISize::Make(fNumPlotsX * kPlotWidth, fNumPlotsY * kPlotHeight);
     fAtlas.reset(SkNEW_ARGS(GrAtlas, (fContext->getGpu(), kSkia8888_GrPixelConfig,
                                       kRenderTarget_GrSurfaceFlag,
-                                      textureSize, kNumPlotsX, kNumPlotsY, false)));
+                                      textureSize, fNumPlotsX, fNumPlotsY, false)));
+}
+
+void GrLayerCache::growAtlas() {
+    SkASSERT(fAtlasWantsToGrow);
+    fAtlasWantsToGrow = false;
+
+    if (fAtlas) {
+        GrAtlas::PlotIter iter;
+        GrPlot* plot;
+        for (plot = fAtlas->iterInit(&iter, GrAtlas::kLRUFirst_IterOrder);
+             plot;
+             plot = iter.prev()) {
+            SkASSERT(0 == fPlotLocks[plot->id()]);
+
+            this->purgePlot(plot);
+        }
+
+        // The atlas only lets go of its texture when the atlas is deleted.
+        fAtlas.free();
+    }
+
+    fNumPlotsX = SkTMin(2 * fNumPlotsX, static_cast<int>(kMaxNumPlotsX));
+    fNumPlotsY = SkTMin(2 * fNumPlotsY, static_cast<int>(kMaxNumPlotsY));
 }
 
 void GrLayerCache::freeAll() {
@@ -115,8 +152,10 @@ void GrLayerCache::freeAll() {
     for (; !iter.done(); ++iter) {
         GrCachedLayer* layer = &(*iter);
         this->unlock(layer);
+        InvalidateCachedTexture(layer);
         SkDELETE(layer);
     }
+    fEvictions += fLayerHash.count();
     fLayerHash.rewind();
 
     // The atlas only lets go of its texture when the atlas is deleted.
@@ -189,6 +228,7 @@ bool GrLayerCache::tryToAtlas(GrCachedLayer* layer,
         layer->setLocked(true);
         this->incPlotLock(layer->plot()->id());
         *needsRendering = false;
+        fHits++;
         return true;
     } else {
         if (!fAtlas) {
@@ -223,13 +263,19 @@ bool GrLayerCache::tryToAtlas(GrCachedLayer* layer,
                 layer->setLocked(true);
                 this->incPlotLock(layer->plot()->id());
                 *needsRendering = true;
+                fMisses++;
                 return true;
             }
 
             // The layer was rejected by the atlas (even though we know it is
             // plausibly atlas-able). See if a plot can be purged and try again.
             if (!this->purgePlot()) {
-                break;  // We weren't able to purge any plots
+                // We weren't able to purge any plots. If the atlas isn't already as
+                // big as it can get, make it bigger once the current draw is done with it.
+                if (fNumPlotsX < kMaxNumPlotsX || fNumPlotsY < kMaxNumPlotsY) {
+                    fAtlasWantsToGrow = true;
+                }
+                break;
             }
         }
 
@@ -249,6 +295,36 @@ bool GrLayerCache::lock(GrCachedLayer* layer, const GrSurfaceDesc& desc, bool* n
         return true;
     }
 
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    const GrCachedLayer::Key& layerKey = GrCachedLayer::GetKey(*layer);
+    SkScalar mat[9];
+    layerKey.initialMat().get9(mat);
+
+    GrUniqueKey textureKey;
+    GrUniqueKey::Builder builder(&textureKey, kDomain, 13 + layerKey.keySize());
+    builder[0] = layerKey.pictureID();
+    memcpy(&builder[1], mat, sizeof(mat));
+    builder[10] = desc.fWidth;
+    builder[11] = desc.fHeight;
+    builder[12] = desc.fSampleCnt;
+    memcpy(&builder[13], layerKey.key(), layerKey.keySize() * sizeof(unsigned));
+    builder.finish();
+
+    if (textureKey == layer->fTextureKey && !layer->fCachedRect.isEmpty()) {
+        // See if the rendering from the last time this layer was locked is still around
+        SkAutoTUnref<GrTexture> tex(
+                            fContext->textureProvider()->findAndRefTextureByUniqueKey(textureKey));
+        if (tex) {
+            layer->setTexture(tex, layer->fCachedRect);
+            layer->setLocked(true);
+            *needsRendering = false;
+            fHits++;
+            return true;
+        }
+    }
+    layer->fTextureKey = textureKey;
+    layer->fCachedRect.setEmpty();
+
     // TODO: make the test for exact match depend on the image filters themselves
     SkAutoTUnref<GrTexture> tex;
     if (layer->fFilter) {
@@ -264,6 +340,7 @@ bool GrLayerCache::lock(GrCachedLayer* layer, const GrSurfaceDesc& desc, bool* n
     layer->setTexture(tex, SkIRect::MakeWH(desc.fWidth, desc.fHeight));
     layer->setLocked(true);
     *needsRendering = true;
+    fMisses++;
     return true;
 }
 
@@ -304,6 +381,17 @@ void GrLayerCache::unlock(GrCachedLayer* layer) {
 #endif
 
     } else {
+        // Leave the texture in the resource cache, findable by the layer's key, so
+        // that the next lock can skip rendering. If the texture already has some
+        // other key (e.g., an image filter returned a cached texture) it can't be
+        // rediscovered.
+        GrTexture* texture = layer->texture();
+        const GrUniqueKey& existingKey = texture->getUniqueKey();
+        if (layer->fTextureKey.isValid() &&
+            (!existingKey.isValid() || existingKey == layer->fTextureKey)) {
+            fContext->textureProvider()->assignUniqueKeyToTexture(layer->fTextureKey, texture);
+            layer->fCachedRect = layer->rect();
+        }
         layer->setTexture(NULL, SkIRect::MakeEmpty());
     }
 
@@ -312,7 +400,7 @@ void GrLayerCache::unlock(GrCachedLayer* layer) {
 
 #ifdef SK_DEBUG
 void GrLayerCache::validate() const {
-    int plotLocks[kNumPlotsX * kNumPlotsY];
+    int plotLocks[kMaxNumPlotsX * kMaxNumPlotsY];
     memset(plotLocks, 0, sizeof(plotLocks));
 
     SkTDynamicHash<GrCachedLayer, GrCachedLayer::Key>::ConstIter iter(&fLayerHash);
@@ -343,7 +431,7 @@ void GrLayerCache::validate() const {
         }
     }
 
-    for (int i = 0; i < kNumPlotsX*kNumPlotsY; ++i) {
+    for (int i = 0; i < kMaxNumPlotsX*kMaxNumPlotsY; ++i) {
         SkASSERT(plotLocks[i] == fPlotLocks[i]);
     }
 }
@@ -379,6 +467,7 @@ void GrLayerCache::purge(uint32_t pictureID) {
     for (int i = 0; i < toBeRemoved.count(); ++i) {
         SkASSERT(0 == toBeRemoved[i]->uses());
         this->unlock(toBeRemoved[i]);
+        InvalidateCachedTexture(toBeRemoved[i]);
         fLayerHash.remove(GrCachedLayer::GetKey(*toBeRemoved[i]));
         SkDELETE(toBeRemoved[i]);
     }
@@ -430,8 +519,10 @@ void GrLayerCache::purgePlot(GrPlot* plot) {
         uint32_t pictureIDToRemove = toBeRemoved[i]->pictureID();
 
         // Aggressively remove layers and, if it becomes totally uncached, delete the picture info
+        InvalidateCachedTexture(toBeRemoved[i]);
         fLayerHash.remove(GrCachedLayer::GetKey(*toBeRemoved[i]));
         SkDELETE(toBeRemoved[i]);
+        fEvictions++;
 
         GrPictureInfo* pictInfo = fPictureHash.find(pictureIDToRemove);
         if (pictInfo) {
@@ -483,6 +574,28 @@ void GrLayerCache::processDeletedPictures() {
     for (int i = 0; i < deletedPictures.count(); i++) {
         this->purge(deletedPictures[i].fUniqueID);
     }
+
+    // This is called before any layers are found for a new draw, so no one can be
+    // holding on to the layers that growing the atlas will throw away.
+    if (fAtlasWantsToGrow) {
+        for (int i = 0; i < kMaxNumPlotsX * kMaxNumPlotsY; ++i) {
+            if (fPlotLocks[i] > 0) {
+                return;
+            }
+        }
+        // The layers currently in the atlas will be re-rendered once
+        this->growAtlas();
+    }
+}
+
+void GrLayerCache::getStats(SkCacheStats* stats) const {
+    stats->fName = "layer";
+    stats->fHits = fHits;
+    stats->fMisses = fMisses;
+    stats->fEvictions = fEvictions;
+    GrTexture* atlasTexture = fAtlas ? fAtlas->getTexture() : NULL;
+    stats->fBytes = atlasTexture ? atlasTexture->gpuMemorySize() : 0;
+    stats->fEntries = fLayerHash.count();
 }
 
 #ifdef SK_DEVELOPER
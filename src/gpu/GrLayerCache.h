@@ -11,6 +11,7 @@
 #include "GrAtlas.h"
 #include "GrRect.h"
 
+#include "SkCacheStats.h"
 #include "SkChecksum.h"
 #include "SkImageFilter.h"
 #include "SkMessageBus.h"
@@ -18,13 +19,14 @@
 #include "SkTDynamicHash.h"
 
 // Set to 0 to disable caching of hoisted layers
-#define GR_CACHE_HOISTED_LAYERS 0
+#define GR_CACHE_HOISTED_LAYERS 1
 
 // GrPictureInfo stores the atlas plots used by a single picture. A single
 // plot may be used to store layers from multiple pictures.
 struct GrPictureInfo {
 public:
-    static const int kNumPlots = 4;
+    // Enough for the atlas at its largest size (see GrLayerCache::kMaxNumPlotsX/Y)
+    static const int kNumPlots = 16;
 
     // for SkTDynamicHash - just use the pictureID as the hash key
     static const uint32_t& GetKey(const GrPictureInfo& pictInfo) { return pictInfo.fPictureID; }
@@ -114,6 +116,7 @@ public:
         }
 
         uint32_t pictureID() const { return fIDMatrix.fPictureID; }
+        const SkMatrix& initialMat() const { return fIDMatrix.fInitialMat; }
 
         // TODO: remove these when GrCachedLayer & ReplacementInfo fuse
         const unsigned* key() const { SkASSERT(fFreeKey);  return fKey; }
@@ -159,6 +162,7 @@ public:
         , fTexture(NULL)
         , fRect(SkIRect::MakeEmpty())
         , fPlot(NULL)
+        , fCachedRect(SkIRect::MakeEmpty())
         , fUses(0)
         , fLocked(false) {
         SkASSERT(SK_InvalidGenID != pictureID);
@@ -253,6 +257,13 @@ private:
     // It is always NULL for non-atlased layers.
     GrPlot*         fPlot;
 
+    // For non-atlased layers, the unique key under which the layer's texture
+    // is left in the resource cache while the layer is unlocked and the
+    // bound of the layer in that texture. This allows the layer to be
+    // rediscovered (rather than re-rendered) the next time it is locked.
+    GrUniqueKey     fTextureKey;
+    SkIRect         fCachedRect;
+
     // The number of actively hoisted layers using this cached image (e.g.,
     // extant GrHoistedLayers pointing at this object). This object will
     // be unlocked when the use count reaches 0.
@@ -270,7 +281,7 @@ private:
     void removeUse()  { SkASSERT(fUses > 0); --fUses; }
     int uses() const { return fUses; }
 
-    friend class GrLayerCache;  // for access to usage methods
+    friend class GrLayerCache;  // for access to usage methods and the cached texture key
     friend class TestingAccess; // for testing
 };
 
@@ -310,9 +321,8 @@ public:
     // layer must be (re)drawn.
     // Note that atlased layers should already have been locked and rendered so only
     // free floating layers will have 'needsRendering' set.
-    // Currently, this path always uses a new scratch texture for non-Atlased layers
-    // and (thus) doesn't cache anything. This can yield a lot of re-rendering.
-    // TODO: allow rediscovery of free-floating layers that are still in the resource cache.
+    // Free-floating layers that were rendered by a previous lock and are still in the
+    // resource cache are rediscovered and do not need to be re-rendered.
     bool lock(GrCachedLayer* layer, const GrSurfaceDesc& desc, bool* needsRendering);
 
     // addUse is just here to keep the API symmetric
@@ -325,11 +335,17 @@ public:
         }
     }
 
-    // Cleanup after any SkPicture deletions
+    // Cleanup after any SkPicture deletions and, if the atlas ran out of room
+    // during a previous draw, grow it. Must be called before any layers are
+    // found for a new draw.
     void processDeletedPictures();
 
     SkDEBUGCODE(void validate() const;)
 
+    // Reports the cache as "layer". A hit is a layer whose earlier rendering could be reused, and
+    // fBytes only covers the atlas: free-floating layers live in the GrResourceCache.
+    void getStats(SkCacheStats*) const;
+
 #ifdef SK_DEVELOPER
     void writeLayersToDisk(const SkString& dirName);
 #endif
@@ -343,18 +359,34 @@ public:
 #endif
 
 private:
-    static const int kAtlasTextureWidth = 1024;
-    static const int kAtlasTextureHeight = 1024;
+    // The atlas starts out as 1024x1024 (2x2 plots) and doubles in each
+    // dimension, up to 2048x2048 (4x4 plots), when a single draw needs more
+    // atlased layers than fit. The plot size never changes.
+    static const int kPlotWidth = 512;
+    static const int kPlotHeight = 512;
 
-    static const int kNumPlotsX = 2;
-    static const int kNumPlotsY = 2;
+    static const int kInitialNumPlotsX = 2;
+    static const int kInitialNumPlotsY = 2;
 
-    static const int kPlotWidth = kAtlasTextureWidth / kNumPlotsX;
-    static const int kPlotHeight = kAtlasTextureHeight / kNumPlotsY;
+    static const int kMaxNumPlotsX = 4;
+    static const int kMaxNumPlotsY = 4;
 
     GrContext*                fContext;  // pointer back to owning context
     SkAutoTDelete<GrAtlas>    fAtlas;    // TODO: could lazily allocate
 
+    // The current dimensions of the atlas (in plots)
+    int                       fNumPlotsX;
+    int                       fNumPlotsY;
+
+    // Set when a layer could not be atlased because every plot was locked.
+    // The atlas is grown the next time no plots are locked.
+    bool                      fAtlasWantsToGrow;
+
+    uint64_t                  fHits;
+    uint64_t                  fMisses;
+    // Layers thrown out of the atlas to make room, or by freeAll().
+    uint64_t                  fEvictions;
+
     // We cache this information here (rather then, say, on the owning picture)
     // because we want to be able to clean it up as needed (e.g., if a picture
     // is leaked and never cleans itself up we still want to be able to 
@@ -372,12 +404,20 @@ private:
     // count for that plot. Similarly, once a rendering is complete all the
     // layers used in it decrement the lock count for the used plots.
     // Plots with a 0 lock count are open for recycling/purging.
-    int fPlotLocks[kNumPlotsX * kNumPlotsY];
+    int fPlotLocks[kMaxNumPlotsX * kMaxNumPlotsY];
 
     // Inform the cache that layer's cached image is not currently required
     void unlock(GrCachedLayer* layer);
 
+    // Tell the resource cache that the texture left behind by a free-floating
+    // layer will never be looked up again.
+    static void InvalidateCachedTexture(const GrCachedLayer* layer);
+
     void initAtlas();
+
+    // Throw away the current atlas (and all the layers in it) so that it
+    // will be recreated at a larger size. All plots must be unlocked.
+    void growAtlas();
     GrCachedLayer* createLayer(uint32_t pictureID, int start, int stop,
                                const SkIRect& srcIR, const SkIRect& dstIR,
                                const SkMatrix& initialMat,
@@ -402,6 +442,7 @@ private:
     // for testing
     friend class TestingAccess;
     int numLayers() const { return fLayerHash.count(); }
+    int numPlotsX() const { return fNumPlotsX; }
 };
 
 #endif
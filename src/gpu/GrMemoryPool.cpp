@@ -25,6 +25,7 @@ GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize) {
 
     fHead = CreateBlock(fPreallocSize);
     fTail = fHead;
+    fSpare = NULL;
     fHead->fNext = NULL;
     fHead->fPrev = NULL;
     VALIDATE;
@@ -36,6 +37,9 @@ GrMemoryPool::~GrMemoryPool() {
     SkASSERT(fHead == fTail);
     SkASSERT(0 == fHead->fLiveCount);
     DeleteBlock(fHead);
+    if (fSpare) {
+        DeleteBlock(fSpare);
+    }
 };
 
 void* GrMemoryPool::allocate(size_t size) {
@@ -45,7 +49,14 @@ void* GrMemoryPool::allocate(size_t size) {
     if (fTail->fFreeSize < size) {
         size_t blockSize = size;
         blockSize = SkTMax<size_t>(blockSize, fMinAllocSize);
-        BlockHeader* block = CreateBlock(blockSize);
+        BlockHeader* block;
+        if (fSpare && blockSize == fMinAllocSize) {
+            block = fSpare;
+            fSpare = NULL;
+            ResetBlock(block);
+        } else {
+            block = CreateBlock(blockSize);
+        }
 
         block->fPrev = fTail;
         block->fNext = NULL;
@@ -93,7 +104,11 @@ void GrMemoryPool::release(void* p) {
                 fTail = prev;
             }
             fSize -= block->fSize;
-            DeleteBlock(block);
+            if (NULL == fSpare && block->fSize == fMinAllocSize + kHeaderSize) {
+                fSpare = block;
+            } else {
+                DeleteBlock(block);
+            }
             SkDEBUGCODE(fAllocBlockCnt--);
         }
     } else {
@@ -114,12 +129,16 @@ GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t size) {
         reinterpret_cast<BlockHeader*>(sk_malloc_throw(paddedSize));
     // we assume malloc gives us aligned memory
     SkASSERT(!(reinterpret_cast<intptr_t>(block) % kAlignment));
+    block->fSize = paddedSize;
+    ResetBlock(block);
+    return block;
+}
+
+void GrMemoryPool::ResetBlock(BlockHeader* block) {
     block->fLiveCount = 0;
-    block->fFreeSize = size;
+    block->fFreeSize = block->fSize - kHeaderSize;
     block->fCurrPtr = reinterpret_cast<intptr_t>(block) + kHeaderSize;
     block->fPrevPtr = 0; // gcc warns on assigning NULL to an intptr_t.
-    block->fSize = paddedSize;
-    return block;
 }
 
 void GrMemoryPool::DeleteBlock(BlockHeader* block) {
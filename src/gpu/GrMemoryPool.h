@@ -53,6 +53,8 @@ private:
 
     static BlockHeader* CreateBlock(size_t size);
 
+    static void ResetBlock(BlockHeader*);
+
     static void DeleteBlock(BlockHeader* block);
 
     void validate();
@@ -79,6 +81,9 @@ private:
     size_t                            fMinAllocSize;
     BlockHeader*                      fHead;
     BlockHeader*                      fTail;
+    // The last block of fMinAllocSize that was emptied, kept for the next one that's needed so a
+    // pool that keeps crossing a block boundary doesn't go back to malloc each time.
+    BlockHeader*                      fSpare;
 #ifdef SK_DEBUG
     int                               fAllocationCnt;
     int                               fAllocBlockCnt;
@@ -49,6 +49,8 @@ protected:
 #endif
 
 private:
+    CacheCategory onCacheCategory() const override { return kPath_CacheCategory; }
+
     typedef GrGpuResource INHERITED;
 };
 
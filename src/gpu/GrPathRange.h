@@ -87,6 +87,8 @@ private:
     void willDrawPaths(const void* indices, PathIndexType, int count) const;
     template<typename IndexType> void willDrawPaths(const void* indices, int count) const;
 
+    CacheCategory onCacheCategory() const override { return kPath_CacheCategory; }
+
     mutable SkAutoTUnref<PathGenerator> fPathGenerator;
     mutable SkTArray<uint8_t, true /*MEM_COPY*/> fGeneratedPaths;
     const int fNumPaths;
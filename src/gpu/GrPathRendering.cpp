@@ -8,50 +8,51 @@
 #include "GrPathRendering.h"
 #include "SkDescriptor.h"
 #include "SkGlyph.h"
+#include "SkGlyphCache.h"
 #include "SkMatrix.h"
 #include "SkTypeface.h"
 #include "GrPathRange.h"
 
+// Glyph outlines come from the global SkGlyphCache rather than a private scaler context, so a
+// typeface's outlines are extracted once and then shared by every path range built from the same
+// descriptor: across GrContexts, and across the stroke variations that each need their own range.
 class GlyphGenerator : public GrPathRange::PathGenerator {
 public:
     GlyphGenerator(const SkTypeface& typeface, const SkDescriptor& desc)
-        : fScalerContext(typeface.createScalerContext(&desc))
-#ifdef SK_DEBUG
-        , fDesc(desc.copy())
-#endif
-    {
+        : fTypeface(SkRef(&typeface))
+        , fDesc(desc) {
         fFlipMatrix.setScale(1, -1);
-    }
-
-    virtual ~GlyphGenerator() {
-#ifdef SK_DEBUG
-        SkDescriptor::Free(fDesc);
-#endif
+        SkAutoGlyphCacheNoGamma autoCache(const_cast<SkTypeface*>(fTypeface.get()),
+                                          fDesc.getDesc());
+        fNumPaths = autoCache.getCache()->getGlyphCount();
     }
 
     int getNumPaths() override {
-        return fScalerContext->getGlyphCount();
+        return fNumPaths;
     }
 
     void generatePath(int glyphID, SkPath* out) override {
-        SkGlyph skGlyph;
-        skGlyph.initWithGlyphID(glyphID);
-        fScalerContext->getMetrics(&skGlyph);
-
-        fScalerContext->getPath(skGlyph, out);
-        out->transform(fFlipMatrix); // Load glyphs with the inverted y-direction.
+        SkAutoGlyphCacheNoGamma autoCache(const_cast<SkTypeface*>(fTypeface.get()),
+                                          fDesc.getDesc());
+        SkGlyphCache* cache = autoCache.getCache();
+        const SkPath* path = cache->findPath(cache->getGlyphIDMetrics(SkToU16(glyphID)));
+        if (path) {
+            // Load glyphs with the inverted y-direction.
+            path->transform(fFlipMatrix, out);
+        } else {
+            out->reset();
+        }
     }
 #ifdef SK_DEBUG
     bool isEqualTo(const SkDescriptor& desc) const override {
-        return fDesc->equals(desc);
+        return fDesc.getDesc()->equals(desc);
     }
 #endif
 private:
-    const SkAutoTDelete<SkScalerContext> fScalerContext;
+    SkAutoTUnref<const SkTypeface> fTypeface;
+    SkAutoDescriptor fDesc;
     SkMatrix fFlipMatrix;
-#ifdef SK_DEBUG
-    SkDescriptor* const fDesc;
-#endif
+    int fNumPaths;
 };
 
 GrPathRange* GrPathRendering::createGlyphs(const SkTypeface* typeface,
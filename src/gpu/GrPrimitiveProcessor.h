@@ -174,17 +174,21 @@ public:
         Attribute()
             : fName(NULL)
             , fType(kFloat_GrVertexAttribType)
-            , fOffset(0) {}
+            , fOffset(0)
+            , fPerInstance(false) {}
         Attribute(const char* name, GrVertexAttribType type,
                   GrSLPrecision precision = kDefault_GrSLPrecision)
             : fName(name)
             , fType(type)
             , fOffset(SkAlign4(GrVertexAttribTypeSize(type)))
-            , fPrecision(precision) {}
+            , fPrecision(precision)
+            , fPerInstance(false) {}
         const char* fName;
         GrVertexAttribType fType;
         size_t fOffset;
         GrSLPrecision fPrecision;
+        // Read from the instance buffer of a GrVertices, advancing once per instance.
+        bool fPerInstance;
     };
 
     int numAttribs() const { return fNumAttribs; }
@@ -198,6 +202,10 @@ public:
     // structs.  In this case, it is best to assert the vertexstride == sizeof(VertexStruct).
     size_t getVertexStride() const { return fVertexStride; }
 
+    // Returns the stride of the per-instance attributes, or 0 if the GP has none. These are only
+    // used with GrVertices that have an instance buffer.
+    size_t getInstanceStride() const { return fInstanceStride; }
+
     /**
      * Gets a transformKey from an array of coord transforms
      */
@@ -230,11 +238,13 @@ protected:
     GrPrimitiveProcessor(bool isPathRendering)
         : fNumAttribs(0)
         , fVertexStride(0)
+        , fInstanceStride(0)
         , fIsPathRendering(isPathRendering) {}
 
     Attribute fAttribs[kMaxVertexAttribs];
     int fNumAttribs;
     size_t fVertexStride;
+    size_t fInstanceStride;
 
 private:
     virtual bool hasExplicitLocalCoords() const = 0;
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrRectanizer_maxrects.h"
+#include "SkPoint.h"
+
+bool GrRectanizerMaxRects::addRect(int width, int height, SkIPoint16* loc) {
+    if ((unsigned)width > (unsigned)this->width() ||
+        (unsigned)height > (unsigned)this->height()) {
+        return false;
+    }
+
+    // find the free rect that leaves the smallest leftover side, then the smallest longer side
+    int bestShortSide = SK_MaxS32;
+    int bestLongSide = SK_MaxS32;
+    int bestIndex = -1;
+    for (int i = 0; i < fFreeRects.count(); ++i) {
+        const SkIRect& free = fFreeRects[i];
+        if (free.width() < width || free.height() < height) {
+            continue;
+        }
+        int leftoverX = free.width() - width;
+        int leftoverY = free.height() - height;
+        int shortSide = SkTMin(leftoverX, leftoverY);
+        int longSide = SkTMax(leftoverX, leftoverY);
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+            bestIndex = i;
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+        }
+    }
+
+    if (-1 == bestIndex) {
+        loc->fX = 0;
+        loc->fY = 0;
+        return false;
+    }
+
+    SkIRect used = SkIRect::MakeXYWH(fFreeRects[bestIndex].fLeft, fFreeRects[bestIndex].fTop,
+                                     width, height);
+    this->splitFreeRects(used);
+    this->pruneFreeRects();
+
+    loc->fX = used.fLeft;
+    loc->fY = used.fTop;
+
+    fAreaSoFar += width*height;
+    return true;
+}
+
+void GrRectanizerMaxRects::splitFreeRects(const SkIRect& used) {
+    // New pieces are appended past 'count', so they are never split again by this call.
+    int count = fFreeRects.count();
+    for (int i = 0; i < count; ) {
+        const SkIRect free = fFreeRects[i];
+        if (!SkIRect::Intersects(free, used)) {
+            ++i;
+            continue;
+        }
+        if (used.fLeft > free.fLeft) {
+            fFreeRects.push(SkIRect::MakeLTRB(free.fLeft, free.fTop, used.fLeft, free.fBottom));
+        }
+        if (used.fRight < free.fRight) {
+            fFreeRects.push(SkIRect::MakeLTRB(used.fRight, free.fTop, free.fRight, free.fBottom));
+        }
+        if (used.fTop > free.fTop) {
+            fFreeRects.push(SkIRect::MakeLTRB(free.fLeft, free.fTop, free.fRight, used.fTop));
+        }
+        if (used.fBottom < free.fBottom) {
+            fFreeRects.push(SkIRect::MakeLTRB(free.fLeft, used.fBottom, free.fRight, free.fBottom));
+        }
+        // Move the last unvisited original into this slot, then the newest piece into its old one.
+        fFreeRects[i] = fFreeRects[count - 1];
+        fFreeRects.removeShuffle(count - 1);
+        --count;
+    }
+}
+
+void GrRectanizerMaxRects::pruneFreeRects() {
+    for (int i = 0; i < fFreeRects.count(); ++i) {
+        for (int j = i + 1; j < fFreeRects.count(); ++j) {
+            if (fFreeRects[j].contains(fFreeRects[i])) {
+                fFreeRects.removeShuffle(i);
+                --i;
+                break;
+            }
+            if (fFreeRects[i].contains(fFreeRects[j])) {
+                fFreeRects.removeShuffle(j);
+                --j;
+            }
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrRectanizer_maxrects_DEFINED
+#define GrRectanizer_maxrects_DEFINED
+
+#include "GrRectanizer.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+// Pack rectangles by tracking every maximal free rectangle, which may overlap one another.
+// Each new rect goes in the free rectangle it fits most snugly (best short side fit). This costs
+// more per insert than the skyline but wastes far less space below tall neighbors, so atlases
+// reach a higher occupancy before they must evict.
+// Based on Jukka Jylanki's "A Thousand Ways to Pack the Bin".
+class GrRectanizerMaxRects : public GrRectanizer {
+public:
+    GrRectanizerMaxRects(int w, int h) : INHERITED(w, h) {
+        this->reset();
+    }
+
+    virtual ~GrRectanizerMaxRects() { }
+
+    void reset() override {
+        fAreaSoFar = 0;
+        fFreeRects.reset();
+        fFreeRects.push(SkIRect::MakeWH(this->width(), this->height()));
+    }
+
+    bool addRect(int w, int h, SkIPoint16* loc) override;
+
+    float percentFull() const override {
+        return fAreaSoFar / ((float)this->width() * this->height());
+    }
+
+private:
+    // Replaces every free rect overlapping 'used' with the up to four pieces of it left over.
+    void splitFreeRects(const SkIRect& used);
+    // Drops free rects that are wholly contained in another free rect.
+    void pruneFreeRects();
+
+    SkTDArray<SkIRect> fFreeRects;
+
+    int32_t fAreaSoFar;
+
+    typedef GrRectanizer INHERITED;
+};
+
+#endif
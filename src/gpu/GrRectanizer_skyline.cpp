@@ -6,6 +6,7 @@
  * found in the LICENSE file.
  */
 
+#include "GrRectanizer_maxrects.h"
 #include "GrRectanizer_skyline.h"
 #include "SkPoint.h"
 
@@ -117,6 +118,11 @@ void GrRectanizerSkyline::addSkylineLevel(int skylineIndex, int x, int y, int wi
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Define GR_RECTANIZER_MAXRECTS to pack atlas plots more densely at a higher cost per insert.
 GrRectanizer* GrRectanizer::Factory(int width, int height) {
+#ifdef GR_RECTANIZER_MAXRECTS
+    return SkNEW_ARGS(GrRectanizerMaxRects, (width, height));
+#else
     return SkNEW_ARGS(GrRectanizerSkyline, (width, height));
+#endif
 }
@@ -7,6 +7,8 @@
 
 #include "GrReorderCommandBuilder.h"
 
+#include "GrGpu.h"
+
 template <class Left, class Right>
 static bool intersect(const Left& a, const Right& b) {
     SkASSERT(a.fLeft <= a.fRight && a.fTop <= a.fBottom &&
@@ -15,11 +17,34 @@ static bool intersect(const Left& a, const Right& b) {
            a.fTop < b.fBottom && b.fTop < a.fBottom;
 }
 
+// Does any fragment stage of the pipeline sample from the render target? Geometry processors are
+// not visible here; the textures they read (atlases) are never render targets.
+static bool reads_render_target(const GrPipeline& pipeline, const GrRenderTarget* rt) {
+    for (int s = 0; s < pipeline.numFragmentStages(); ++s) {
+        const GrProcessor* proc = pipeline.getFragmentStage(s).processor();
+        for (int t = 0; t < proc->numTextures(); ++t) {
+            if (proc->texture(t)->asRenderTarget() == rt) {
+                return true;
+            }
+        }
+    }
+    const GrXferProcessor* xp = pipeline.getXferProcessor();
+    for (int t = 0; t < xp->numTextures(); ++t) {
+        if (xp->texture(t)->asRenderTarget() == rt) {
+            return true;
+        }
+    }
+    return false;
+}
+
 GrTargetCommands::Cmd* GrReorderCommandBuilder::recordDrawBatch(State* state, GrBatch* batch) {
     // Check if there is a Batch Draw we can batch with by linearly searching back until we either
     // 1) check every draw
     // 2) intersect with something
     // 3) find a 'blocker'
+    // Commands for other render targets are stepped over unless they read from ours, so draws to
+    // one target interleaved with draws to another (e.g. text into a layer) still batch together
+    // and the target is bound fewer times.
     // Experimentally we have found that most batching occurs within the first 10 comparisons.
     static const int kMaxLookback = 10;
     int i = 0;
@@ -45,6 +70,7 @@ GrTargetCommands::Cmd* GrReorderCommandBuilder::recordDrawBatch(State* state, Gr
     SkDebugf("\tXP: %s\n", state->getPipeline()->getXferProcessor()->name());
 #endif
     GrBATCH_INFO("\tOutcome:\n");
+    this->gpu()->stats()->incBatchesRecorded();
     if (!this->cmdBuffer()->empty()) {
         GrTargetCommands::CmdBuffer::ReverseIter reverseIter(*this->cmdBuffer());
 
@@ -53,14 +79,20 @@ GrTargetCommands::Cmd* GrReorderCommandBuilder::recordDrawBatch(State* state, Gr
                 DrawBatch* previous = static_cast<DrawBatch*>(reverseIter.get());
 
                 if (previous->fBatch->pipeline()->getRenderTarget() != rt) {
-                    GrBATCH_INFO("\t\tBreaking because of (%s, B%u) Rendertarget\n",
+                    // We cannot continue to search backwards past a draw that reads our target
+                    if (reads_render_target(*previous->fBatch->pipeline(), rt)) {
+                        GrBATCH_INFO("\t\tBreaking because (%s, B%u) reads Rendertarget\n",
+                                     previous->fBatch->name(), previous->fBatch->uniqueID());
+                        break;
+                    }
+                    GrBATCH_INFO("\t\tSkipping (%s, B%u) on other Rendertarget\n",
                                  previous->fBatch->name(), previous->fBatch->uniqueID());
-                    break;
+                    continue;
                 }
-                // We cannot continue to search backwards if the render target changes
                 if (previous->fBatch->combineIfPossible(batch)) {
                     GrBATCH_INFO("\t\tCombining with (%s, B%u)\n",
                                  previous->fBatch->name(), previous->fBatch->uniqueID());
+                    this->gpu()->stats()->incBatchesCombined();
                     return NULL;
                 }
 
@@ -72,10 +104,10 @@ GrTargetCommands::Cmd* GrReorderCommandBuilder::recordDrawBatch(State* state, Gr
             } else if (Cmd::kClear_CmdType == reverseIter->type()) {
                 Clear* previous = static_cast<Clear*>(reverseIter.get());
 
-                // We cannot continue to search backwards if the render target changes
+                // A clear of another render target never depends on ours
                 if (previous->renderTarget() != rt) {
-                    GrBATCH_INFO("\t\tBreaking because of Clear's Rendertarget change\n");
-                    break;
+                    GrBATCH_INFO("\t\tSkipping Clear of other Rendertarget\n");
+                    continue;
                 }
 
                 // We set the color to illegal if we are doing a discard.
@@ -72,6 +72,9 @@ GrResourceCache::GrResourceCache()
     , fBytes(0)
     , fBudgetedCount(0)
     , fBudgetedBytes(0)
+    , fPeakBudgetedBytes(0)
+    , fHitCount(0)
+    , fMissCount(0)
     , fOverBudgetCB(NULL)
     , fOverBudgetData(NULL)
     , fFlushTimestamps(NULL)
@@ -79,6 +82,18 @@ GrResourceCache::GrResourceCache()
     SkDEBUGCODE(fCount = 0;)
     SkDEBUGCODE(fNewlyPurgeableResourceForValidation = NULL;)
     this->resetFlushTimestamps();
+
+    // Render targets are often large and transient, while buffers and paths took CPU work to
+    // build, so by default those outlast render targets when the cache has to choose.
+    static const int kDefaultRecreationCosts[] = { 1, 2, 4, 4, 2 };
+    GR_STATIC_ASSERT(SK_ARRAY_COUNT(kDefaultRecreationCosts) == GrGpuResource::kCacheCategoryCnt);
+    for (int i = 0; i < GrGpuResource::kCacheCategoryCnt; ++i) {
+        fCategoryStats[i].fBudgetedCount = 0;
+        fCategoryStats[i].fBudgetedBytes = 0;
+        fCategoryStats[i].fMaxBytes = SIZE_MAX;
+        fCategoryStats[i].fRecreationCost = kDefaultRecreationCosts[i];
+        fCategoryStats[i].fPurgeCount = 0;
+    }
 }
 
 GrResourceCache::~GrResourceCache() {
@@ -94,6 +109,21 @@ void GrResourceCache::setLimits(int count, size_t bytes, int maxUnusedFlushes) {
     this->purgeAsNeeded();
 }
 
+void GrResourceCache::setCategoryLimits(GrGpuResource::CacheCategory category, size_t maxBytes,
+                                        int recreationCost) {
+    SkASSERT(recreationCost > 0);
+    fCategoryStats[category].fMaxBytes = maxBytes;
+    fCategoryStats[category].fRecreationCost = recreationCost;
+    this->purgeAsNeeded();
+}
+
+void GrResourceCache::didChangeCategoryBudget(const GrGpuResource* resource, int countDelta,
+                                              ptrdiff_t bytesDelta) {
+    CategoryStats& stats = fCategoryStats[resource->cacheCategory()];
+    stats.fBudgetedCount += countDelta;
+    stats.fBudgetedBytes += bytesDelta;
+}
+
 void GrResourceCache::resetFlushTimestamps() {
     SkDELETE_ARRAY(fFlushTimestamps);
 
@@ -138,6 +168,8 @@ void GrResourceCache::insertResource(GrGpuResource* resource) {
     if (resource->resourcePriv().isBudgeted()) {
         ++fBudgetedCount;
         fBudgetedBytes += size;
+        fPeakBudgetedBytes = SkTMax(fBudgetedBytes, fPeakBudgetedBytes);
+        this->didChangeCategoryBudget(resource, 1, size);
         TRACE_COUNTER2(TRACE_DISABLED_BY_DEFAULT("skia.gpu.cache"), "skia budget", "used",
                        fBudgetedBytes, "free", fMaxBytes - fBudgetedBytes);
 #if GR_CACHE_STATS
@@ -169,6 +201,7 @@ void GrResourceCache::removeResource(GrGpuResource* resource) {
     if (resource->resourcePriv().isBudgeted()) {
         --fBudgetedCount;
         fBudgetedBytes -= size;
+        this->didChangeCategoryBudget(resource, -1, -static_cast<ptrdiff_t>(size));
         TRACE_COUNTER2(TRACE_DISABLED_BY_DEFAULT("skia.gpu.cache"), "skia budget", "used",
                        fBudgetedBytes, "free", fMaxBytes - fBudgetedBytes);
     }
@@ -178,6 +211,7 @@ void GrResourceCache::removeResource(GrGpuResource* resource) {
     }
     if (resource->getUniqueKey().isValid()) {
         fUniqueHash.remove(resource->getUniqueKey());
+        this->removeUniqueKeyForAnyThread(resource->getUniqueKey());
     }
     this->validate();
 }
@@ -255,8 +289,10 @@ GrGpuResource* GrResourceCache::findAndRefScratchResource(const GrScratchKey& sc
         if (resource) {
             this->refAndMakeResourceMRU(resource);
             this->validate();
+            fHitCount++;
             return resource;
         } else if (flags & kRequireNoPendingIO_ScratchFlag) {
+            fMissCount++;
             return NULL;
         }
         // TODO: fail here when kPrefer is specified, we didn't find a resource without pending io,
@@ -266,10 +302,25 @@ GrGpuResource* GrResourceCache::findAndRefScratchResource(const GrScratchKey& sc
     if (resource) {
         this->refAndMakeResourceMRU(resource);
         this->validate();
+        fHitCount++;
+    } else {
+        fMissCount++;
     }
     return resource;
 }
 
+void GrResourceCache::getStats(SkCacheStats* stats) const {
+    stats->fName = "gpu-resource";
+    stats->fHits = fHitCount;
+    stats->fMisses = fMissCount;
+    stats->fEvictions = 0;
+    for (int i = 0; i < GrGpuResource::kCacheCategoryCnt; ++i) {
+        stats->fEvictions += fCategoryStats[i].fPurgeCount;
+    }
+    stats->fBytes = fBytes;
+    stats->fEntries = this->getResourceCount();
+}
+
 void GrResourceCache::willRemoveScratchKey(const GrGpuResource* resource) {
     SkASSERT(resource->resourcePriv().getScratchKey().isValid());
     fScratchMap.remove(resource->resourcePriv().getScratchKey(), resource);
@@ -281,11 +332,31 @@ void GrResourceCache::removeUniqueKey(GrGpuResource* resource) {
     if (resource->getUniqueKey().isValid()) {
         SkASSERT(resource == fUniqueHash.find(resource->getUniqueKey()));
         fUniqueHash.remove(resource->getUniqueKey());
+        this->removeUniqueKeyForAnyThread(resource->getUniqueKey());
     }
     resource->cacheAccess().removeUniqueKey();
     this->validate();
 }
 
+bool GrResourceCache::hasUniqueKeyFromAnyThread(const GrUniqueKey& key) const {
+    fUniqueKeysLock.acquireShared();
+    bool found = fUniqueKeysForAnyThread.contains(key);
+    fUniqueKeysLock.releaseShared();
+    return found;
+}
+
+void GrResourceCache::addUniqueKeyForAnyThread(const GrUniqueKey& key) {
+    fUniqueKeysLock.acquire();
+    fUniqueKeysForAnyThread.add(key);
+    fUniqueKeysLock.release();
+}
+
+void GrResourceCache::removeUniqueKeyForAnyThread(const GrUniqueKey& key) {
+    fUniqueKeysLock.acquire();
+    fUniqueKeysForAnyThread.remove(key);
+    fUniqueKeysLock.release();
+}
+
 void GrResourceCache::changeUniqueKey(GrGpuResource* resource, const GrUniqueKey& newKey) {
     SkASSERT(resource);
     SkASSERT(this->isInCache(resource));
@@ -294,6 +365,7 @@ void GrResourceCache::changeUniqueKey(GrGpuResource* resource, const GrUniqueKey
     if (resource->getUniqueKey().isValid()) {
         SkASSERT(resource == fUniqueHash.find(resource->getUniqueKey()));
         fUniqueHash.remove(resource->getUniqueKey());
+        this->removeUniqueKeyForAnyThread(resource->getUniqueKey());
         SkASSERT(NULL == fUniqueHash.find(resource->getUniqueKey()));
     }
 
@@ -308,12 +380,14 @@ void GrResourceCache::changeUniqueKey(GrGpuResource* resource, const GrUniqueKey
                 old->cacheAccess().release();
             } else {
                 fUniqueHash.remove(newKey);
+                this->removeUniqueKeyForAnyThread(newKey);
                 old->cacheAccess().removeUniqueKey();
             }
         }
         SkASSERT(NULL == fUniqueHash.find(newKey));
         resource->cacheAccess().setUniqueKey(newKey);
         fUniqueHash.add(resource);
+        this->addUniqueKeyForAnyThread(newKey);
     } else {
         resource->cacheAccess().removeUniqueKey();
     }
@@ -372,8 +446,10 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
         if (!resource->cacheAccess().isExternal() &&
             resource->resourcePriv().getScratchKey().isValid()) {
             // We won't purge an existing resource to make room for this one.
+            const CategoryStats& stats = fCategoryStats[resource->cacheCategory()];
             if (fBudgetedCount < fMaxCount &&
-                fBudgetedBytes + resource->gpuMemorySize() <= fMaxBytes) {
+                fBudgetedBytes + resource->gpuMemorySize() <= fMaxBytes &&
+                stats.fBudgetedBytes + resource->gpuMemorySize() <= stats.fMaxBytes) {
                 resource->resourcePriv().makeBudgeted();
                 return;
             }
@@ -383,7 +459,8 @@ void GrResourceCache::notifyCntReachedZero(GrGpuResource* resource, uint32_t fla
         // Also purge if the resource has neither a valid scratch key nor a unique key.
         bool noKey = !resource->resourcePriv().getScratchKey().isValid() &&
                      !resource->getUniqueKey().isValid();
-        if (!this->overBudget() && !noKey) {
+        if (!this->overBudget() && !this->categoryOverBudget(resource->cacheCategory()) &&
+            !noKey) {
             return;
         }
     }
@@ -408,6 +485,8 @@ void GrResourceCache::didChangeGpuMemorySize(const GrGpuResource* resource, size
 #endif
     if (resource->resourcePriv().isBudgeted()) {
         fBudgetedBytes += delta;
+        fPeakBudgetedBytes = SkTMax(fBudgetedBytes, fPeakBudgetedBytes);
+        this->didChangeCategoryBudget(resource, 0, delta);
         TRACE_COUNTER2(TRACE_DISABLED_BY_DEFAULT("skia.gpu.cache"), "skia budget", "used",
                        fBudgetedBytes, "free", fMaxBytes - fBudgetedBytes);
 #if GR_CACHE_STATS
@@ -428,6 +507,8 @@ void GrResourceCache::didChangeBudgetStatus(GrGpuResource* resource) {
     if (resource->resourcePriv().isBudgeted()) {
         ++fBudgetedCount;
         fBudgetedBytes += size;
+        fPeakBudgetedBytes = SkTMax(fBudgetedBytes, fPeakBudgetedBytes);
+        this->didChangeCategoryBudget(resource, 1, size);
 #if GR_CACHE_STATS
         fBudgetedHighWaterBytes = SkTMax(fBudgetedBytes, fBudgetedHighWaterBytes);
         fBudgetedHighWaterCount = SkTMax(fBudgetedCount, fBudgetedHighWaterCount);
@@ -436,6 +517,7 @@ void GrResourceCache::didChangeBudgetStatus(GrGpuResource* resource) {
     } else {
         --fBudgetedCount;
         fBudgetedBytes -= size;
+        this->didChangeCategoryBudget(resource, -1, -static_cast<ptrdiff_t>(size));
     }
     TRACE_COUNTER2(TRACE_DISABLED_BY_DEFAULT("skia.gpu.cache"), "skia budget", "used",
                    fBudgetedBytes, "free", fMaxBytes - fBudgetedBytes);
@@ -463,14 +545,23 @@ void GrResourceCache::purgeAsNeeded() {
             }
             GrGpuResource* resource = fPurgeableQueue.peek();
             SkASSERT(resource->isPurgeable());
+            ++fCategoryStats[resource->cacheCategory()].fPurgeCount;
             resource->cacheAccess().release();
         }
     }
 
+    for (int i = 0; i < GrGpuResource::kCacheCategoryCnt; ++i) {
+        GrGpuResource::CacheCategory category = static_cast<GrGpuResource::CacheCategory>(i);
+        if (this->categoryOverBudget(category)) {
+            this->purgeCategory(category);
+        }
+    }
+
     bool stillOverbudget = this->overBudget();
     while (stillOverbudget && fPurgeableQueue.count()) {
-        GrGpuResource* resource = fPurgeableQueue.peek();
+        GrGpuResource* resource = this->pickResourceToPurge();
         SkASSERT(resource->isPurgeable());
+        ++fCategoryStats[resource->cacheCategory()].fPurgeCount;
         resource->cacheAccess().release();
         stillOverbudget = this->overBudget();
     }
@@ -485,6 +576,64 @@ void GrResourceCache::purgeAsNeeded() {
     }
 }
 
+void GrResourceCache::purgeCategory(GrGpuResource::CacheCategory category) {
+    // Gather the category's purgeable resources and release them, least recently used first.
+    SkTDArray<GrGpuResource*> resources;
+    for (int i = 0; i < fPurgeableQueue.count(); ++i) {
+        GrGpuResource* resource = fPurgeableQueue.at(i);
+        if (resource->cacheCategory() == category && resource->resourcePriv().isBudgeted()) {
+            *resources.append() = resource;
+        }
+    }
+    if (resources.isEmpty()) {
+        return;
+    }
+
+    struct Less {
+        bool operator()(GrGpuResource* a, GrGpuResource* b) {
+            return CompareTimestamp(a,b);
+        }
+    };
+    Less less;
+    SkTQSort(resources.begin(), resources.end() - 1, less);
+
+    // Releasing one of these only makes resources that weren't purgeable before purgeable, so the
+    // rest of the array stays valid.
+    for (int i = 0; i < resources.count() && this->categoryOverBudget(category); ++i) {
+        SkASSERT(resources[i]->isPurgeable());
+        ++fCategoryStats[category].fPurgeCount;
+        resources[i]->cacheAccess().release();
+    }
+}
+
+GrGpuResource* GrResourceCache::pickResourceToPurge() {
+    SkASSERT(fPurgeableQueue.count());
+
+    // Look at this many of the least recently used purgeable resources.
+    static const int kCandidateCnt = 8;
+    GrGpuResource* candidates[kCandidateCnt];
+    int count = 0;
+    while (count < kCandidateCnt && fPurgeableQueue.count()) {
+        candidates[count++] = fPurgeableQueue.peek();
+        fPurgeableQueue.pop();
+    }
+
+    // Take the cheapest to recreate. The candidates come out oldest first, so ties go to the
+    // oldest, and with equal costs this is plain LRU.
+    int best = 0;
+    for (int i = 1; i < count; ++i) {
+        if (fCategoryStats[candidates[i]->cacheCategory()].fRecreationCost <
+            fCategoryStats[candidates[best]->cacheCategory()].fRecreationCost) {
+            best = i;
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        fPurgeableQueue.insert(candidates[i]);
+    }
+    return candidates[best];
+}
+
 void GrResourceCache::purgeAllUnlocked() {
     // We could disable maintaining the heap property here, but it would add a lot of complexity.
     // Moreover, this is rarely called.
@@ -497,6 +646,26 @@ void GrResourceCache::purgeAllUnlocked() {
     this->validate();
 }
 
+void GrResourceCache::purgeUnlockedToFraction(float fraction) {
+    size_t purgeableBytes = 0;
+    for (int i = 0; i < fPurgeableQueue.count(); ++i) {
+        purgeableBytes += fPurgeableQueue.at(i)->gpuMemorySize();
+    }
+    fraction = SkTPin(fraction, 0.0f, 1.0f);
+    const size_t keep = static_cast<size_t>(purgeableBytes * fraction);
+
+    while (purgeableBytes > keep && fPurgeableQueue.count()) {
+        GrGpuResource* resource = fPurgeableQueue.peek();
+        SkASSERT(resource->isPurgeable());
+        // Releasing a resource can make others purgeable that weren't counted above.
+        purgeableBytes -= SkTMin(purgeableBytes, resource->gpuMemorySize());
+        ++fCategoryStats[resource->cacheCategory()].fPurgeCount;
+        resource->cacheAccess().release();
+    }
+
+    this->validate();
+}
+
 void GrResourceCache::processInvalidUniqueKeys(
     const SkTArray<GrUniqueKeyInvalidatedMessage>& msgs) {
     for (int i = 0; i < msgs.count(); ++i) {
@@ -625,6 +794,8 @@ void GrResourceCache::validate() const {
         int fScratch;
         int fCouldBeScratch;
         int fContent;
+        int fCategoryBudgetedCount[GrGpuResource::kCacheCategoryCnt];
+        size_t fCategoryBudgetedBytes[GrGpuResource::kCacheCategoryCnt];
         const ScratchMap* fScratchMap;
         const UniqueHash* fUniqueHash;
 
@@ -664,6 +835,8 @@ void GrResourceCache::validate() const {
             if (resource->resourcePriv().isBudgeted()) {
                 ++fBudgetedCount;
                 fBudgetedBytes += resource->gpuMemorySize();
+                ++fCategoryBudgetedCount[resource->cacheCategory()];
+                fCategoryBudgetedBytes[resource->cacheCategory()] += resource->gpuMemorySize();
             }
         }
     };
@@ -690,6 +863,11 @@ void GrResourceCache::validate() const {
     SkASSERT(stats.fBytes == fBytes);
     SkASSERT(stats.fBudgetedBytes == fBudgetedBytes);
     SkASSERT(stats.fBudgetedCount == fBudgetedCount);
+    SkASSERT(fBudgetedBytes <= fPeakBudgetedBytes);
+    for (int i = 0; i < GrGpuResource::kCacheCategoryCnt; ++i) {
+        SkASSERT(stats.fCategoryBudgetedCount[i] == fCategoryStats[i].fBudgetedCount);
+        SkASSERT(stats.fCategoryBudgetedBytes[i] == fCategoryStats[i].fBudgetedBytes);
+    }
 #if GR_CACHE_STATS
     SkASSERT(fBudgetedHighWaterCount <= fHighWaterCount);
     SkASSERT(fBudgetedHighWaterBytes <= fHighWaterBytes);
@@ -699,6 +877,7 @@ void GrResourceCache::validate() const {
     SkASSERT(fBudgetedCount <= fBudgetedHighWaterCount);
 #endif
     SkASSERT(stats.fContent == fUniqueHash.count());
+    SkASSERT(fUniqueKeysForAnyThread.count() == fUniqueHash.count());
     SkASSERT(stats.fScratch + stats.fCouldBeScratch == fScratchMap.count());
 
     // This assertion is not currently valid because we can be in recursive notifyCntReachedZero()
@@ -13,10 +13,14 @@
 #include "GrGpuResourceCacheAccess.h"
 #include "GrGpuResourcePriv.h"
 #include "GrResourceKey.h"
+#include "SkCacheStats.h"
 #include "SkMessageBus.h"
 #include "SkRefCnt.h"
+#include "SkSharedMutex.h"
 #include "SkTArray.h"
 #include "SkTDPQueue.h"
+#include "SkTGroupProbeHash.h"
+#include "SkTHash.h"
 #include "SkTInternalLList.h"
 #include "SkTMultiMap.h"
 
@@ -44,6 +48,12 @@ class SkString;
  * timestamp of the n-th prior flush. If the resource's last use timestamp is older than the old
  * flush then the resource is proactively purged even when the cache is under budget. By default
  * this feature is disabled, though it can be enabled by calling GrResourceCache::setLimits.
+ *
+ * Each GrGpuResource::CacheCategory may also have its own limit on budgeted bytes, and a cost of
+ * recreating its resources, relative to the other categories. When the cache must purge to get
+ * under budget it looks at a few of the least recently used purgeable resources and releases the
+ * one that's cheapest to recreate, oldest first among equals. That way large transient render
+ * targets go before buffers and paths that took more work to build.
  */
 class GrResourceCache {
 public:
@@ -72,6 +82,36 @@ public:
      */
     void setLimits(int count, size_t bytes, int maxUnusedFlushes = kDefaultMaxUnusedFlushes);
 
+    /**
+     * Sets the most budgeted bytes that resources of a category may use, which is enforced as well
+     * as the overall budget, and how costly they are to recreate relative to other categories.
+     * Higher costs keep resources in the cache longer. By default categories have no limit of
+     * their own.
+     */
+    void setCategoryLimits(GrGpuResource::CacheCategory, size_t maxBytes, int recreationCost);
+
+    struct CategoryStats {
+        int     fBudgetedCount;
+        size_t  fBudgetedBytes;
+        size_t  fMaxBytes;
+        int     fRecreationCost;
+        // How many resources of the category purgeAsNeeded() has released.
+        int     fPurgeCount;
+    };
+
+    /**
+     * Returns the current budget use, limits, and purge count of a category of resources.
+     */
+    const CategoryStats& getCategoryStats(GrGpuResource::CacheCategory category) const {
+        return fCategoryStats[category];
+    }
+
+    /**
+     * Reports the cache as "gpu-resource": scratch and unique key lookups, resources purged by
+     * category, and all resources held whether budgeted or not.
+     */
+    void getStats(SkCacheStats*) const;
+
     /**
      * Returns the number of resources.
      */
@@ -94,6 +134,17 @@ public:
      */
     size_t getBudgetedResourceBytes() const { return fBudgetedBytes; }
 
+    /**
+     * Returns the most bytes budgeted resources have consumed at once since the cache was created
+     * or since the last resetPeakBudgetedResourceBytes().
+     */
+    size_t getPeakBudgetedResourceBytes() const { return fPeakBudgetedBytes; }
+
+    /**
+     * Starts tracking the peak again from the budgeted bytes in use now.
+     */
+    void resetPeakBudgetedResourceBytes() { fPeakBudgetedBytes = fBudgetedBytes; }
+
     /**
      * Returns the cached resources count budget.
      */
@@ -142,6 +193,9 @@ public:
         GrGpuResource* resource = fUniqueHash.find(key);
         if (resource) {
             this->refAndMakeResourceMRU(resource);
+            fHitCount++;
+        } else {
+            fMissCount++;
         }
         return resource;
     }
@@ -153,6 +207,13 @@ public:
         return SkToBool(fUniqueHash.find(key));
     }
 
+    /**
+     * Like hasUniqueKey(), but may be called from any thread, e.g. to decide on a worker thread
+     * whether a texture still has to be prepared for upload. The answer may be out of date by the
+     * time the caller acts on it, and the cache must outlive the call.
+     */
+    bool hasUniqueKeyFromAnyThread(const GrUniqueKey& key) const;
+
     /** Purges resources to become under budget and processes resources with invalidated unique
         keys. */
     void purgeAsNeeded();
@@ -160,6 +221,10 @@ public:
     /** Purges all resources that don't have external owners. */
     void purgeAllUnlocked();
 
+    /** Purges the least recently used resources without external owners until at most fraction
+        (0..1) of the bytes they held is left. */
+    void purgeUnlockedToFraction(float fraction);
+
     /**
      * The callback function used by the cache when it is still over budget after a purge. The
      * passed in 'data' is the same 'data' handed to setOverbudgetCallback.
@@ -204,7 +269,15 @@ private:
     void processInvalidUniqueKeys(const SkTArray<GrUniqueKeyInvalidatedMessage>&);
     void addToNonpurgeableArray(GrGpuResource*);
     void removeFromNonpurgeableArray(GrGpuResource*);
+    void addUniqueKeyForAnyThread(const GrUniqueKey&);
+    void removeUniqueKeyForAnyThread(const GrUniqueKey&);
     bool overBudget() const { return fBudgetedBytes > fMaxBytes || fBudgetedCount > fMaxCount; }
+    bool categoryOverBudget(GrGpuResource::CacheCategory category) const {
+        return fCategoryStats[category].fBudgetedBytes > fCategoryStats[category].fMaxBytes;
+    }
+    void didChangeCategoryBudget(const GrGpuResource*, int countDelta, ptrdiff_t bytesDelta);
+    void purgeCategory(GrGpuResource::CacheCategory);
+    GrGpuResource* pickResourceToPurge();
 
     uint32_t getNextTimestamp();
 
@@ -233,7 +306,9 @@ private:
 
         static uint32_t Hash(const GrUniqueKey& key) { return key.hash(); }
     };
-    typedef SkTDynamicHash<GrGpuResource, GrUniqueKey, UniqueHashTraits> UniqueHash;
+    typedef SkTGroupProbeHash<GrGpuResource, GrUniqueKey, UniqueHashTraits> UniqueHash;
+    // A copy of UniqueHash's keys, so that other threads needn't touch the resources themselves.
+    typedef SkTHashSet<GrUniqueKey, &UniqueHashTraits::Hash> UniqueKeySet;
 
     static bool CompareTimestamp(GrGpuResource* const& a, GrGpuResource* const& b) {
         return a->cacheAccess().timestamp() < b->cacheAccess().timestamp();
@@ -278,6 +353,12 @@ private:
     // our current stats for resources that count against the budget
     int                                 fBudgetedCount;
     size_t                              fBudgetedBytes;
+    size_t                              fPeakBudgetedBytes;  // Resettable, unlike the high water.
+    CategoryStats                       fCategoryStats[GrGpuResource::kCacheCategoryCnt];
+
+    // Lookups by scratch or unique key.
+    uint64_t                            fHitCount;
+    uint64_t                            fMissCount;
 
     PFOverBudgetCB                      fOverBudgetCB;
     void*                               fOverBudgetData;
@@ -289,6 +370,10 @@ private:
 
     InvalidUniqueKeyInbox               fInvalidUniqueKeyInbox;
 
+    // Only changed on the owning thread, which holds the lock exclusively while it does.
+    mutable SkSharedMutex               fUniqueKeysLock;
+    UniqueKeySet                        fUniqueKeysForAnyThread;
+
     // This resource is allowed to be in the nonpurgeable array for the sake of validate() because
     // we're in the midst of converting it to purgeable status.
     SkDEBUGCODE(GrGpuResource*          fNewlyPurgeableResourceForValidation;)
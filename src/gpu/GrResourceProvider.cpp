@@ -15,10 +15,13 @@
 #include "GrVertexBuffer.h"
 
 GR_DECLARE_STATIC_UNIQUE_KEY(gQuadIndexBufferKey);
+GR_DECLARE_STATIC_UNIQUE_KEY(gUnitQuadVertexBufferKey);
 
 GrResourceProvider::GrResourceProvider(GrGpu* gpu, GrResourceCache* cache) : INHERITED(gpu, cache) {
     GR_DEFINE_STATIC_UNIQUE_KEY(gQuadIndexBufferKey);
     fQuadIndexBufferKey = gQuadIndexBufferKey;
+    GR_DEFINE_STATIC_UNIQUE_KEY(gUnitQuadVertexBufferKey);
+    fUnitQuadVertexBufferKey = gUnitQuadVertexBufferKey;
 }
 
 const GrIndexBuffer* GrResourceProvider::createInstancedIndexBuffer(const uint16_t* pattern,
@@ -67,6 +70,24 @@ const GrIndexBuffer* GrResourceProvider::createQuadIndexBuffer() {
     return this->createInstancedIndexBuffer(kPattern, 6, kMaxQuads, 4, fQuadIndexBufferKey);
 }
 
+const GrVertexBuffer* GrResourceProvider::createUnitQuadVertexBuffer() {
+    SkPoint corners[4];
+    corners[0].setRectFan(0, 0, SK_Scalar1, SK_Scalar1, sizeof(SkPoint));
+
+    // This is typically used in GrBatchs, so we assume kNoPendingIO.
+    GrVertexBuffer* buffer = this->createVertexBuffer(sizeof(corners), kStatic_BufferUsage,
+                                                      kNoPendingIO_Flag);
+    if (!buffer) {
+        return NULL;
+    }
+    if (!buffer->updateData(corners, sizeof(corners))) {
+        buffer->unref();
+        return NULL;
+    }
+    this->assignUniqueKeyToResource(fUnitQuadVertexBufferKey, buffer);
+    return buffer;
+}
+
 GrPath* GrResourceProvider::createPath(const SkPath& path, const GrStrokeInfo& stroke) {
     SkASSERT(this->gpu()->pathRendering());
     return this->gpu()->pathRendering()->createPath(path, stroke);
@@ -12,6 +12,7 @@
 #include "GrIndexBuffer.h"
 #include "GrTextureProvider.h"
 #include "GrPathRange.h"
+#include "GrVertexBuffer.h"
 
 class GrBatchAtlas;
 class GrIndexBuffer;
@@ -78,6 +79,19 @@ public:
         return this->createQuadIndexBuffer();
     }
 
+    /**
+     * Returns a vertex buffer holding the four corners of the unit square as SkPoints, in the
+     * fan order expected by refQuadIndexBuffer(). Used as the per-vertex data of instanced quads.
+     * @ return the unit quad vertex buffer
+     */
+    const GrVertexBuffer* refUnitQuadVertexBuffer() {
+        if (GrVertexBuffer* buffer =
+            this->findAndRefTByUniqueKey<GrVertexBuffer>(fUnitQuadVertexBufferKey)) {
+            return buffer;
+        }
+        return this->createUnitQuadVertexBuffer();
+    }
+
     /**
      * Factories for GrPath and GrPathRange objects. It's an error to call these if path rendering
      * is not supported.
@@ -142,8 +156,10 @@ private:
                                                     const GrUniqueKey& key);
 
     const GrIndexBuffer* createQuadIndexBuffer();
+    const GrVertexBuffer* createUnitQuadVertexBuffer();
 
     GrUniqueKey fQuadIndexBufferKey;
+    GrUniqueKey fUnitQuadVertexBufferKey;
 
     typedef GrTextureProvider INHERITED;
 };
@@ -15,6 +15,7 @@
 #include "SkData.h"
 #include "SkDistanceFieldGen.h"
 #include "SkStrokeRec.h"
+#include "SkTaskGroup.h"
 
 // TODO: try to remove this #include
 #include "GrContext.h"
@@ -97,6 +98,45 @@ static bool choose_compressed_fmt(const GrCaps* caps,
     return false;
 }
 
+// Large masks are rasterized in horizontal bands in parallel. Each band draws through a clip of
+// its own rows, so the bands write disjoint pixels. Like any tiled draw, edge rounding can differ
+// slightly from a single pass, so the band count depends only on the mask size (never on the core
+// count) to keep the output the same on every machine.
+static const int kBandHeight = 64;
+static const int kMaxBands = 16;
+static const int kMinParallelMaskArea = 256 * 256;
+
+int band_count(const SkPixmap& pixels) {
+    if (pixels.width() * pixels.height() < kMinParallelMaskArea) {
+        return 1;
+    }
+    return SkTMin(kMaxBands, pixels.height() / kBandHeight);
+}
+
+// Calls drawFn(const SkDraw&) once per band, each with fRC limited to that band.
+template <typename DrawFn>
+void draw_in_bands(const SkDraw& draw, int bandCount, const DrawFn& drawFn) {
+    if (bandCount <= 1) {
+        drawFn(draw);
+        return;
+    }
+    const SkIRect& bounds = draw.fRC->getBounds();
+    sk_parallel_for(bandCount, [&](int i) {
+        SkIRect band = SkIRect::MakeLTRB(bounds.fLeft,
+                                         bounds.fTop + bounds.height() * i / bandCount,
+                                         bounds.fRight,
+                                         bounds.fTop + bounds.height() * (i + 1) / bandCount);
+        if (band.isEmpty()) {
+            return;
+        }
+        SkRasterClip bandClip(band);
+        SkDraw bandDraw(draw);
+        bandDraw.fRC = &bandClip;
+        bandDraw.fClip = &bandClip.bwRgn();
+        drawFn(bandDraw);
+    });
+}
+
 }
 
 /**
@@ -114,7 +154,9 @@ void GrSWMaskHelper::draw(const SkRect& rect, SkRegion::Op op,
     paint.setAntiAlias(antiAlias);
     paint.setColor(SkColorSetARGB(alpha, alpha, alpha, alpha));
 
-    fDraw.drawRect(rect, paint);
+    draw_in_bands(fDraw, band_count(fPixels), [&](const SkDraw& draw) {
+        draw.drawRect(rect, paint);
+    });
 
     SkSafeUnref(mode);
 }
@@ -143,21 +185,37 @@ void GrSWMaskHelper::draw(const SkPath& path, const SkStrokeRec& stroke, SkRegio
 
     SkTBlitterAllocator allocator;
     SkBlitter* blitter = NULL;
+    // The compressing blitter writes whole blocks, so it has to see every row itself.
+    int bandCount = 1;
     if (kBlitter_CompressionMode == fCompressionMode) {
         SkASSERT(fCompressedBuffer.get());
         blitter = SkTextureCompressor::CreateBlitterForFormat(
             fPixels.width(), fPixels.height(), fCompressedBuffer.get(), &allocator,
                                                               fCompressedFormat);
+    } else {
+        bandCount = band_count(fPixels);
     }
 
-    if (SkRegion::kReplace_Op == op && 0xFF == alpha) {
+    bool coverage = SkRegion::kReplace_Op == op && 0xFF == alpha;
+    if (coverage) {
         SkASSERT(0xFF == paint.getAlpha());
-        fDraw.drawPathCoverage(path, paint, blitter);
     } else {
         paint.setXfermodeMode(op_to_mode(op));
         paint.setColor(SkColorSetARGB(alpha, alpha, alpha, alpha));
-        fDraw.drawPath(path, paint, blitter);
     }
+
+    // SkPath computes its bounds and convexity lazily. Do that here, before the bands share it,
+    // and give each band its own copy of the SkPath.
+    path.getBounds();
+    path.getConvexity();
+    draw_in_bands(fDraw, bandCount, [&](const SkDraw& draw) {
+        SkPath bandPath(path);
+        if (coverage) {
+            draw.drawPathCoverage(bandPath, paint, blitter);
+        } else {
+            draw.drawPath(bandPath, paint, blitter);
+        }
+    });
 }
 
 bool GrSWMaskHelper::init(const SkIRect& resultBounds,
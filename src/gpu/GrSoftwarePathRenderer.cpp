@@ -8,8 +8,11 @@
 
 #include "GrSoftwarePathRenderer.h"
 #include "GrContext.h"
+#include "GrResourceKey.h"
 #include "GrSWMaskHelper.h"
 #include "GrVertexBuffer.h"
+#include "SkMessageBus.h"
+#include "SkPathPriv.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 bool GrSoftwarePathRenderer::onCanDrawPath(const CanDrawPathArgs& args) const {
@@ -32,6 +35,78 @@ GrSoftwarePathRenderer::onGetStencilSupport(const GrDrawTarget*,
 
 namespace {
 
+// When the SkPathRef genID changes, invalidate a corresponding GrResource described by key.
+class PathInvalidator : public SkPathRef::GenIDChangeListener {
+public:
+    explicit PathInvalidator(const GrUniqueKey& key) : fMsg(key) {}
+private:
+    GrUniqueKeyInvalidatedMessage fMsg;
+
+    void onChange() override {
+        SkMessageBus<GrUniqueKeyInvalidatedMessage>::Post(fMsg);
+    }
+};
+
+// Cached masks are positioned to this fraction of a pixel.
+static const int kMaskSubpixelSteps = 4;
+
+// Snaps a translate to a whole pixel plus a multiple of 1 / kMaskSubpixelSteps. Returns the
+// snapped value and the subpixel step it landed on.
+SkScalar quantize_translate(SkScalar t, uint32_t* step) {
+    SkScalar whole = SkScalarFloorToScalar(t);
+    int s = SkScalarRoundToInt((t - whole) * kMaskSubpixelSteps);
+    if (s == kMaskSubpixelSteps) {
+        whole += SK_Scalar1;
+        s = 0;
+    }
+    *step = s;
+    return whole + SkIntToScalar(s) / kMaskSubpixelSteps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Masks of non-volatile paths that are not cut by the clip are cached in the resource cache. The
+// key holds the path's gen ID, fill, AA, stroke, and the matrix without the integer part of its
+// translate, so a path drawn again (or moved by whole pixels) reuses its mask. The fractional
+// translate is snapped to a subpixel step and *maskMatrix/*maskBounds are what must be used to
+// render the mask. Returns false if the mask should not be cached.
+bool get_mask_key(const SkPath& path,
+                  const GrStrokeInfo& stroke,
+                  bool antiAlias,
+                  const SkMatrix& viewMatrix,
+                  const SkIRect& devClipBounds,
+                  SkMatrix* maskMatrix,
+                  SkIRect* maskBounds,
+                  GrUniqueKey* key) {
+    if (path.isVolatile() || viewMatrix.hasPerspective()) {
+        return false;
+    }
+
+    uint32_t stepX, stepY;
+    *maskMatrix = viewMatrix;
+    maskMatrix->setTranslateX(quantize_translate(viewMatrix.getTranslateX(), &stepX));
+    maskMatrix->setTranslateY(quantize_translate(viewMatrix.getTranslateY(), &stepY));
+
+    SkRect devBounds;
+    maskMatrix->mapRect(&devBounds, path.getBounds());
+    devBounds.roundOut(maskBounds);
+    if (maskBounds->isEmpty() || !devClipBounds.contains(*maskBounds)) {
+        return false;
+    }
+
+    static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
+    int strokeDataSize32 = stroke.computeUniqueKeyFragmentData32Cnt();
+    GrUniqueKey::Builder builder(key, kDomain, 6 + strokeDataSize32);
+    builder[0] = path.getGenerationID();
+    builder[1] = path.getFillType() | (antiAlias ? 0x4 : 0x0) | (stepX << 3) | (stepY << 6);
+    builder[2] = SkFloat2Bits(viewMatrix.getScaleX());
+    builder[3] = SkFloat2Bits(viewMatrix.getSkewX());
+    builder[4] = SkFloat2Bits(viewMatrix.getSkewY());
+    builder[5] = SkFloat2Bits(viewMatrix.getScaleY());
+    stroke.asUniqueKeyFragment(&builder[6]);
+    builder.finish();
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // gets device coord bounds of path (not considering the fill) and clip. The
 // path bounds will be a subset of the clip bounds. returns false if
@@ -127,12 +202,32 @@ bool GrSoftwarePathRenderer::onDrawPath(const DrawPathArgs& args) {
         return true;
     }
 
-    SkAutoTUnref<GrTexture> texture(
-            GrSWMaskHelper::DrawPathMaskToTexture(fContext, *args.fPath, *args.fStroke,
-                                                  devPathBounds,
-                                                  args.fAntiAlias, args.fViewMatrix));
-    if (NULL == texture) {
-        return false;
+    SkMatrix maskMatrix = *args.fViewMatrix;
+    SkIRect maskBounds;
+    GrUniqueKey maskKey;
+    bool useCache = get_mask_key(*args.fPath, *args.fStroke, args.fAntiAlias, *args.fViewMatrix,
+                                 devClipBounds, &maskMatrix, &maskBounds, &maskKey);
+    if (useCache) {
+        devPathBounds = maskBounds;
+    } else {
+        maskMatrix = *args.fViewMatrix;
+    }
+
+    SkAutoTUnref<GrTexture> texture;
+    if (useCache) {
+        texture.reset(fContext->textureProvider()->findAndRefTextureByUniqueKey(maskKey));
+    }
+    if (!texture) {
+        texture.reset(GrSWMaskHelper::DrawPathMaskToTexture(fContext, *args.fPath,
+                                                            *args.fStroke, devPathBounds,
+                                                            args.fAntiAlias, &maskMatrix));
+        if (NULL == texture) {
+            return false;
+        }
+        if (useCache) {
+            fContext->textureProvider()->assignUniqueKeyToTexture(maskKey, texture);
+            SkPathPriv::AddGenIDChangeListener(*args.fPath, SkNEW(PathInvalidator(maskKey)));
+        }
     }
 
     GrSWMaskHelper::DrawToTargetWithPathMask(texture, args.fTarget, args.fPipelineBuilder,
@@ -65,6 +65,7 @@ protected:
     }
 
 private:
+    CacheCategory onCacheCategory() const override { return kRenderTarget_CacheCategory; }
 
     int fWidth;
     int fHeight;
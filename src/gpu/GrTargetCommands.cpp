@@ -8,6 +8,7 @@
 #include "GrTargetCommands.h"
 
 #include "GrBufferedDrawTarget.h"
+#include "GrFlushTimer.h"
 
 GrBATCH_SPEW(int32_t GrTargetCommands::Cmd::gUniqueID = 0;)
 
@@ -23,6 +24,7 @@ void GrTargetCommands::flush(GrBufferedDrawTarget* bufferedDrawTarget) {
     }
 
     GrGpu* gpu = bufferedDrawTarget->getGpu();
+    GrFlushTimer* timer = gpu->getContext()->getFlushTimer();
 
     // Loop over all batches and generate geometry
     CmdBuffer::Iter genIter(fCmdBuffer);
@@ -48,11 +50,18 @@ void GrTargetCommands::flush(GrBufferedDrawTarget* bufferedDrawTarget) {
             gpu->addGpuTraceMarker(&newMarker);
         }
 
+        if (timer) {
+            GrRenderTarget* rt = iter->renderTarget();
+            timer->beginSection(iter->name(), rt ? rt->getUniqueID() : SK_InvalidUniqueID);
+        }
         iter->execute(gpu);
         if (iter->isTraced()) {
             gpu->removeGpuTraceMarker(&newMarker);
         }
     }
+    if (timer) {
+        timer->endSection();
+    }
 
     fBatchTarget.postFlush();
 }
@@ -54,6 +54,10 @@ public:
 
         virtual void execute(GrGpu*) = 0;
 
+        // Identify the command's work when GPU timing is enabled. See GrFlushTimer.
+        virtual const char* name() const = 0;
+        virtual GrRenderTarget* renderTarget() const = 0;
+
         CmdType type() const { return fType; }
 
         // trace markers
@@ -142,6 +146,8 @@ private:
         const GrPath* path() const { return fPath.get(); }
 
         void execute(GrGpu*) override;
+        const char* name() const override { return "StencilPath"; }
+        GrRenderTarget* renderTarget() const override { return fRenderTarget.get(); }
 
         SkMatrix                                                fViewMatrix;
         bool                                                    fUseHWAA;
@@ -161,6 +167,8 @@ private:
         const GrPath* path() const { return fPath.get(); }
 
         void execute(GrGpu*) override;
+        const char* name() const override { return "DrawPath"; }
+        GrRenderTarget* renderTarget() const override { return fState->getRenderTarget(); }
 
         SkAutoTUnref<State>     fState;
         GrStencilSettings       fStencilSettings;
@@ -177,6 +185,8 @@ private:
         const GrPathRange* pathRange() const { return fPathRange.get();  }
 
         void execute(GrGpu*) override;
+        const char* name() const override { return "DrawPaths"; }
+        GrRenderTarget* renderTarget() const override { return fState->getRenderTarget(); }
 
         SkAutoTUnref<State>             fState;
         char*                           fIndices;
@@ -194,9 +204,12 @@ private:
     struct Clear : public Cmd {
         Clear(GrRenderTarget* rt) : Cmd(kClear_CmdType), fRenderTarget(rt) {}
 
-        GrRenderTarget* renderTarget() const { return fRenderTarget.get(); }
+        GrRenderTarget* renderTarget() const override { return fRenderTarget.get(); }
 
         void execute(GrGpu*) override;
+        const char* name() const override {
+            return GrColor_ILLEGAL == fColor ? "Discard" : "Clear";
+        }
 
         SkIRect fRect;
         GrColor fColor;
@@ -209,9 +222,10 @@ private:
     struct ClearStencilClip : public Cmd {
         ClearStencilClip(GrRenderTarget* rt) : Cmd(kClearStencil_CmdType), fRenderTarget(rt) {}
 
-        GrRenderTarget* renderTarget() const { return fRenderTarget.get(); }
+        GrRenderTarget* renderTarget() const override { return fRenderTarget.get(); }
 
         void execute(GrGpu*) override;
+        const char* name() const override { return "ClearStencilClip"; }
 
         SkIRect fRect;
         bool    fInsideClip;
@@ -231,6 +245,8 @@ private:
         GrSurface* src() const { return fSrc.get(); }
 
         void execute(GrGpu*) override;
+        const char* name() const override { return "CopySurface"; }
+        GrRenderTarget* renderTarget() const override { return fDst.get()->asRenderTarget(); }
 
         SkIPoint    fDstPoint;
         SkIRect     fSrcRect;
@@ -250,6 +266,8 @@ private:
         }
 
         void execute(GrGpu*) override;
+        const char* name() const override { return fBatch->name(); }
+        GrRenderTarget* renderTarget() const override { return fState->getRenderTarget(); }
 
         SkAutoTUnref<State>    fState;
         SkAutoTUnref<GrBatch>  fBatch;
@@ -265,6 +283,8 @@ private:
         }
 
         void execute(GrGpu*) override;
+        const char* name() const override { return "XferBarrier"; }
+        GrRenderTarget* renderTarget() const override { return fRenderTarget.get(); }
 
         GrXferBarrierType   fBarrierType;
 
@@ -15,6 +15,7 @@
 #include "GrResourceCache.h"
 #include "GrResourceProvider.h"
 #include "SkChunkAlloc.h"
+#include "SkFloatBits.h"
 #include "SkGeometry.h"
 
 #include "batches/GrBatch.h"
@@ -1518,27 +1519,31 @@ public:
     }
 
     void generateGeometry(GrBatchTarget* batchTarget) override {
-        // construct a cache key from the path's genID and the view matrix
+        SkScalar screenSpaceTol = GrPathUtils::kDefaultTolerance;
+        SkScalar tol = GrPathUtils::scaleToleranceToSrc(
+            screenSpaceTol, fViewMatrix, fPath.getBounds());
+
+        // construct a cache key from the path's genID and the tolerance. The vertices are in path
+        // space, so they can be reused under any translation. Bucketing the tolerance by its
+        // power of two lets the tessellations for a few zoom levels live in the cache together.
         static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
         GrUniqueKey key;
         int clipBoundsSize32 =
             fPath.isInverseFillType() ? sizeof(fClipBounds) / sizeof(uint32_t) : 0;
         int strokeDataSize32 = fStroke.computeUniqueKeyFragmentData32Cnt();
-        GrUniqueKey::Builder builder(&key, kDomain, 2 + clipBoundsSize32 + strokeDataSize32);
+        GrUniqueKey::Builder builder(&key, kDomain, 3 + clipBoundsSize32 + strokeDataSize32);
         builder[0] = fPath.getGenerationID();
         builder[1] = fPath.getFillType();
+        builder[2] = SkFloat2Bits(tol) >> 23;
         // For inverse fills, the tessellation is dependent on clip bounds.
         if (fPath.isInverseFillType()) {
-            memcpy(&builder[2], &fClipBounds, sizeof(fClipBounds));
+            memcpy(&builder[3], &fClipBounds, sizeof(fClipBounds));
         }
-        fStroke.asUniqueKeyFragment(&builder[2 + clipBoundsSize32]);
+        fStroke.asUniqueKeyFragment(&builder[3 + clipBoundsSize32]);
         builder.finish();
         GrResourceProvider* rp = batchTarget->resourceProvider();
         SkAutoTUnref<GrVertexBuffer> vertexBuffer(rp->findAndRefTByUniqueKey<GrVertexBuffer>(key));
         int actualCount;
-        SkScalar screenSpaceTol = GrPathUtils::kDefaultTolerance;
-        SkScalar tol = GrPathUtils::scaleToleranceToSrc(
-            screenSpaceTol, fViewMatrix, fPath.getBounds());
         if (!cache_match(vertexBuffer.get(), tol, &actualCount)) {
             actualCount = tessellate(&key, rp, vertexBuffer);
         }
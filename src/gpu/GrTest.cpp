@@ -72,6 +72,14 @@ void GrGpu::Stats::dump(SkString* out) {
     out->appendf("Textures Created: %d\n", fTextureCreates);
     out->appendf("Texture Uploads: %d\n", fTextureUploads);
     out->appendf("Stencil Buffer Creates: %d\n", fStencilAttachmentCreates);
+    out->appendf("Draws: %d\n", fDraws);
+    out->appendf("Batches Recorded: %d\n", fBatchesRecorded);
+    out->appendf("Batches Combined: %d\n", fBatchesCombined);
+    out->appendf("Skipped Program Binds: %d\n", fSkippedProgramBinds);
+    out->appendf("Skipped Buffer Binds: %d\n", fSkippedBufferBinds);
+    out->appendf("Skipped Vertex Attrib Calls: %d\n", fSkippedVertexAttribCalls);
+    out->appendf("Skipped Uniform Uploads: %d\n", fSkippedUniformUploads);
+    out->appendf("Multi Draws: %d (in %d calls)\n", fMultiDraws, fMultiDrawCalls);
 }
 #endif
 
@@ -129,6 +137,19 @@ void GrResourceCache::dumpStats(SkString* out) const {
     out->appendf("\t\tEntry Bytes: current %d (budgeted %d, %.2g%% full, %d unbudgeted) high %d\n",
                  SkToInt(fBytes), SkToInt(fBudgetedBytes), byteUtilization,
                  SkToInt(stats.fUnbudgetedSize), SkToInt(fHighWaterBytes));
+
+    static const char* kCategoryNames[] = { "Render Targets", "Textures", "Buffers", "Paths",
+                                            "Other" };
+    GR_STATIC_ASSERT(SK_ARRAY_COUNT(kCategoryNames) == GrGpuResource::kCacheCategoryCnt);
+    for (int i = 0; i < GrGpuResource::kCacheCategoryCnt; ++i) {
+        const CategoryStats& category = fCategoryStats[i];
+        out->appendf("\t\t%s: %d budgeted items %d bytes", kCategoryNames[i],
+                     category.fBudgetedCount, SkToInt(category.fBudgetedBytes));
+        if (SIZE_MAX != category.fMaxBytes) {
+            out->appendf(" (limit %d)", SkToInt(category.fMaxBytes));
+        }
+        out->appendf(", cost %d, %d purged\n", category.fRecreationCost, category.fPurgeCount);
+    }
 }
 
 #endif
@@ -177,6 +198,10 @@ public:
 
     void xferBarrier(GrRenderTarget*, GrXferBarrierType) override {}
 
+    GrFence insertFence() override { return 0; }
+    bool waitFence(GrFence, uint64_t) override { return true; }
+    void deleteFence(GrFence) override {}
+
 private:
     void onResetContext(uint32_t resetBits) override {}
 
@@ -202,6 +227,10 @@ private:
 
     GrIndexBuffer* onCreateIndexBuffer(size_t size, bool dynamic) override { return NULL; }
 
+    GrVertexBuffer* onCreatePersistentVertexBuffer(size_t size) override { return NULL; }
+
+    GrIndexBuffer* onCreatePersistentIndexBuffer(size_t size) override { return NULL; }
+
     void onClear(GrRenderTarget*, const SkIRect& rect, GrColor color) override {}
 
     void onClearStencilClip(GrRenderTarget*, const SkIRect& rect, bool insideClip) override {}
@@ -262,7 +291,7 @@ void GrContext::initMockContext() {
     SkASSERT(NULL == fGpu);
     fGpu = SkNEW_ARGS(MockGpu, (this, options));
     SkASSERT(fGpu);
-    this->initCommon();
+    this->initCommon(options);
 
     // We delete these because we want to test the cache starting with zero resources. Also, none of
     // these objects are required for any of tests that use this context. TODO: make stop allocating
@@ -28,9 +28,7 @@ GrAtlasTextBlob* GrTextBlobCache::createBlob(int glyphCount, int runCount, size_
 #endif
 
     GrAtlasTextBlob* cacheBlob = SkNEW_PLACEMENT(allocation, GrAtlasTextBlob);
-#ifdef CACHE_SANITY_CHECK
     cacheBlob->fSize = size;
-#endif
 
     // setup offsets for vertices / glyphs
     cacheBlob->fVertices = sizeof(GrAtlasTextBlob) + reinterpret_cast<unsigned char*>(cacheBlob);
@@ -54,5 +52,105 @@ void GrTextBlobCache::freeAll() {
         blob->unref();
         ++iter;
     }
+    fEvictions += fCache.count();
     fCache.rewind();
+    fBlobIDCache.reset();
+    fCurrentSize = 0;
+}
+
+void GrTextBlobCache::purgeToFraction(float fraction) {
+    fraction = SkTPin(fraction, 0.0f, 1.0f);
+    const size_t keep = static_cast<size_t>(fCurrentSize * fraction);
+    BitmapBlobList::Iter iter;
+    iter.init(fBlobList, BitmapBlobList::Iter::kTail_IterStart);
+    GrAtlasTextBlob* lruBlob;
+    while (fCurrentSize > keep && (lruBlob = iter.get())) {
+        // Backup the iterator before removing and unrefing the blob
+        iter.prev();
+        this->remove(lruBlob);
+        fEvictions++;
+    }
+}
+
+void GrTextBlobCache::add(GrAtlasTextBlob* blob) {
+    this->purgeStaleBlobs();
+
+    fCache.add(blob);
+    fBlobList.addToHead(blob);
+    BlobIDCacheEntry* entry = fBlobIDCache.find(blob->fKey.fUniqueID);
+    if (!entry) {
+        entry = fBlobIDCache.set(blob->fKey.fUniqueID, BlobIDCacheEntry());
+    }
+    *entry->append() = blob;
+    fCurrentSize += blob->fSize;
+
+    this->checkPurge(blob);
+}
+
+void GrTextBlobCache::remove(GrAtlasTextBlob* blob) {
+    const uint32_t id = blob->fKey.fUniqueID;
+    BlobIDCacheEntry* entry = fBlobIDCache.find(id);
+    SkASSERT(entry);
+    int index = entry->find(blob);
+    SkASSERT(index >= 0);
+    entry->removeShuffle(index);
+    if (entry->isEmpty()) {
+        fBlobIDCache.remove(id);
+    }
+
+    fCache.remove(blob->fKey);
+    fBlobList.remove(blob);
+    SkASSERT(fCurrentSize >= blob->fSize);
+    fCurrentSize -= blob->fSize;
+    blob->unref();
+}
+
+void GrTextBlobCache::purgeStaleBlobs() {
+    SkTArray<SkTextBlob::PurgeBlobMessage> msgs;
+    fPurgeBlobInbox.poll(&msgs);
+
+    for (int i = 0; i < msgs.count(); ++i) {
+        // Removing the last blob for an ID removes its entry.
+        while (BlobIDCacheEntry* entry = fBlobIDCache.find(msgs[i].fID)) {
+            this->remove(entry->top());
+        }
+    }
+}
+
+void GrTextBlobCache::checkPurge(GrAtlasTextBlob* blob) {
+    // If we are overbudget, then unref until we are below budget again
+    if (fCurrentSize > fBudget) {
+        BitmapBlobList::Iter iter;
+        iter.init(fBlobList, BitmapBlobList::Iter::kTail_IterStart);
+        GrAtlasTextBlob* lruBlob = iter.get();
+        SkASSERT(lruBlob);
+        while (fCurrentSize > fBudget && (lruBlob = iter.get()) && lruBlob != blob) {
+            // Backup the iterator before removing and unrefing the blob
+            iter.prev();
+            this->remove(lruBlob);
+            fEvictions++;
+        }
+
+        // If we break out of the loop with lruBlob == blob, then we haven't purged enough
+        // use the call back and try to free some more.  If we are still overbudget after this,
+        // then this single textblob is over our budget
+        if (blob && lruBlob == blob) {
+            (*fCallback)(fData);
+        }
+
+#ifdef SPEW_BUDGET_MESSAGE
+        if (fCurrentSize > fBudget) {
+            SkDebugf("Single textblob is larger than our whole budget");
+        }
+#endif
+    }
+}
+
+void GrTextBlobCache::getStats(SkCacheStats* stats) const {
+    stats->fName = "text-blob";
+    stats->fHits = fHits;
+    stats->fMisses = fMisses;
+    stats->fEvictions = fEvictions;
+    stats->fBytes = fCurrentSize;
+    stats->fEntries = fCache.count();
 }
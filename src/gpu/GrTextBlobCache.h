@@ -9,7 +9,10 @@
 #define GrTextBlobCache_DEFINED
 
 #include "GrAtlasTextContext.h"
+#include "SkCacheStats.h"
+#include "SkMessageBus.h"
 #include "SkTDynamicHash.h"
+#include "SkTHash.h"
 #include "SkTextBlob.h"
 
 class GrTextBlobCache {
@@ -20,11 +23,16 @@ public:
      */
     typedef void (*PFOverBudgetCB)(void* data);
 
-    GrTextBlobCache(PFOverBudgetCB cb, void* data)
+    // A budget of zero selects the default.
+    GrTextBlobCache(PFOverBudgetCB cb, void* data, size_t budget = 0)
         : fPool(kPreAllocSize, kMinGrowthSize)
         , fCallback(cb)
         , fData(data)
-        , fBudget(kDefaultBudget) {
+        , fCurrentSize(0)
+        , fBudget(budget ? budget : kDefaultBudget)
+        , fHits(0)
+        , fMisses(0)
+        , fEvictions(0) {
         SkASSERT(cb && data);
     }
     ~GrTextBlobCache();
@@ -64,26 +72,24 @@ public:
         BlobGlyphCount(&glyphCount, &runCount, blob);
         GrAtlasTextBlob* cacheBlob = this->createBlob(glyphCount, runCount, maxVAStride);
         SetupCacheBlobKey(cacheBlob, key, blurRec, paint);
+        blob->notifyAddedToCache();
         this->add(cacheBlob);
         return cacheBlob;
     }
 
     GrAtlasTextBlob* find(const GrAtlasTextBlob::Key& key) {
-        return fCache.find(key);
+        GrAtlasTextBlob* blob = fCache.find(key);
+        if (blob) {
+            fHits++;
+        } else {
+            fMisses++;
+        }
+        return blob;
     }
 
-    void remove(GrAtlasTextBlob* blob) {
-        fCache.remove(blob->fKey);
-        fBlobList.remove(blob);
-        blob->unref();
-    }
+    void remove(GrAtlasTextBlob* blob);
 
-    void add(GrAtlasTextBlob* blob) {
-        fCache.add(blob);
-        fBlobList.addToHead(blob);
-
-        this->checkPurge(blob);
-    }
+    void add(GrAtlasTextBlob* blob);
 
     void makeMRU(GrAtlasTextBlob* blob) {
         if (fBlobList.head() == blob) {
@@ -96,6 +102,9 @@ public:
 
     void freeAll();
 
+    // Drops the least recently used blobs until at most fraction (0..1) of currentSize() is left.
+    void purgeToFraction(float fraction);
+
     // TODO move to SkTextBlob
     static void BlobGlyphCount(int* glyphCount, int* runCount, const SkTextBlob* blob) {
         SkTextBlob::RunIterator itCounter(blob);
@@ -109,39 +118,25 @@ public:
         this->checkPurge();
     }
 
+    // The bytes held by cached blobs.  Blobs still referenced by pending draws may keep more
+    // than this alive in the pool.
+    size_t currentSize() const { return fCurrentSize; }
+    int count() const { return fCache.count(); }
+
+    // Drops the cached blobs of every SkTextBlob deleted since the last call.  This happens
+    // before each new blob is cached, so the cache only holds blobs that can still be drawn.
+    void purgeStaleBlobs();
+
+    // Reports the cache as "text-blob".
+    void getStats(SkCacheStats*) const;
+
 private:
     typedef SkTInternalLList<GrAtlasTextBlob> BitmapBlobList;
 
-    void checkPurge(GrAtlasTextBlob* blob = NULL) {
-        // If we are overbudget, then unref until we are below budget again
-        if (fPool.size() > fBudget) {
-            BitmapBlobList::Iter iter;
-            iter.init(fBlobList, BitmapBlobList::Iter::kTail_IterStart);
-            GrAtlasTextBlob* lruBlob = iter.get();
-            SkASSERT(lruBlob);
-            while (fPool.size() > fBudget && (lruBlob = iter.get()) && lruBlob != blob) {
-                fCache.remove(lruBlob->fKey);
-
-                // Backup the iterator before removing and unrefing the blob
-                iter.prev();
-                fBlobList.remove(lruBlob);
-                lruBlob->unref();
-            }
-
-            // If we break out of the loop with lruBlob == blob, then we haven't purged enough
-            // use the call back and try to free some more.  If we are still overbudget after this,
-            // then this single textblob is over our budget
-            if (blob && lruBlob == blob) {
-                (*fCallback)(fData);
-            }
-
-#ifdef SPEW_BUDGET_MESSAGE
-            if (fPool.size() > fBudget) {
-                SkDebugf("Single textblob is larger than our whole budget");
-            }
-#endif
-        }
-    }
+    // One SkTextBlob can be cached under several keys, eg drawn filled and stroked.
+    typedef SkTDArray<GrAtlasTextBlob*> BlobIDCacheEntry;
+
+    void checkPurge(GrAtlasTextBlob* blob = NULL);
 
     // Budget was chosen to be ~4 megabytes.  The min alloc and pre alloc sizes in the pool are
     // based off of the largest cached textblob I have seen in the skps(a couple of kilobytes).
@@ -150,10 +145,17 @@ private:
     static const int kDefaultBudget = 1 << 22;
     BitmapBlobList fBlobList;
     SkTDynamicHash<GrAtlasTextBlob, GrAtlasTextBlob::Key> fCache;
+    SkTHashMap<uint32_t, BlobIDCacheEntry> fBlobIDCache;
+    SkMessageBus<SkTextBlob::PurgeBlobMessage>::Inbox fPurgeBlobInbox;
     GrMemoryPool fPool;
     PFOverBudgetCB fCallback;
     void* fData;
+    size_t fCurrentSize;
     size_t fBudget;
+    uint64_t fHits;
+    uint64_t fMisses;
+    // Blobs dropped to get back under budget or by freeAll().
+    uint64_t fEvictions;
 };
 
 #endif
@@ -60,6 +60,25 @@ GrTexture* GrTextureProvider::internalCreateApproxTexture(const GrSurfaceDesc& d
     }
 }
 
+// Rounds a dimension up for approximate scratch matching. Small sizes go to the next power of
+// two, but past kMagicTol that can nearly double the memory per dimension, so larger sizes also
+// get the bucket halfway between two powers of two.
+static int approx_scratch_size(int value, int minSize) {
+    static const int kMagicTol = 1024;
+
+    value = SkTMax(minSize, value);
+    if (SkIsPow2(value)) {
+        return value;
+    }
+    int ceilPow2 = GrNextPow2(value);
+    if (value <= kMagicTol) {
+        return ceilPow2;
+    }
+    int floorPow2 = ceilPow2 >> 1;
+    int mid = floorPow2 + (floorPow2 >> 1);
+    return value <= mid ? mid : ceilPow2;
+}
+
 GrTexture* GrTextureProvider::refScratchTexture(const GrSurfaceDesc& inDesc,
                                                 uint32_t flags) {
     SkASSERT(!this->isAbandoned());
@@ -69,15 +88,18 @@ GrTexture* GrTextureProvider::refScratchTexture(const GrSurfaceDesc& inDesc,
 
     if (fGpu->caps()->reuseScratchTextures() || (desc->fFlags & kRenderTarget_GrSurfaceFlag)) {
         if (!(kExact_ScratchTextureFlag & flags)) {
-            // bin by pow2 with a reasonable min
+            // bin by approximate size with a reasonable min
             const int minSize = SkTMin(16, fGpu->caps()->minTextureSize());
             GrSurfaceDesc* wdesc = desc.writable();
-            wdesc->fWidth  = SkTMax(minSize, GrNextPow2(desc->fWidth));
-            wdesc->fHeight = SkTMax(minSize, GrNextPow2(desc->fHeight));
+            wdesc->fWidth  = approx_scratch_size(desc->fWidth, minSize);
+            wdesc->fHeight = approx_scratch_size(desc->fHeight, minSize);
         }
 
         GrScratchKey key;
         GrTexturePriv::ComputeScratchKey(*desc, &key);
+        // Render targets may be reused while they still have pending IO: the draw target replays
+        // its commands in order, so a layer's render target can serve a later layer of the same
+        // flush once the first has been drawn and unreffed.
         uint32_t scratchFlags = 0;
         if (kNoPendingIO_ScratchTextureFlag & flags) {
             scratchFlags = GrResourceCache::kRequireNoPendingIO_ScratchFlag;
@@ -128,6 +150,10 @@ bool GrTextureProvider::existsResourceWithUniqueKey(const GrUniqueKey& key) cons
     return this->isAbandoned() ? false : fCache->hasUniqueKey(key);
 }
 
+bool GrTextureProvider::existsTextureWithUniqueKeyFromAnyThread(const GrUniqueKey& key) const {
+    return this->isAbandoned() ? false : fCache->hasUniqueKeyFromAnyThread(key);
+}
+
 GrGpuResource* GrTextureProvider::findAndRefResourceByUniqueKey(const GrUniqueKey& key) {
     return this->isAbandoned() ? NULL : fCache->findAndRefUniqueResource(key);
 }
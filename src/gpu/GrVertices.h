@@ -20,8 +20,15 @@ public:
     int indexCount() const { return fIndexCount; }
     bool isIndexed() const { return fIndexCount > 0; }
 
+    /** When there is an instance buffer the vertices (or indices) are drawn once per instance
+        with the GPU's instanced draw call. See GrCaps::supportsInstancedDraws(). */
+    int startInstance() const { return fStartInstance; }
+    int hwInstanceCount() const { return fHWInstanceCount; }
+    bool isHWInstanced() const { return fHWInstanceCount > 0; }
+
     const GrVertexBuffer* vertexBuffer() const { return fVertexBuffer.get(); }
     const GrIndexBuffer* indexBuffer() const { return fIndexBuffer.get(); }
+    const GrVertexBuffer* instanceBuffer() const { return fInstanceBuffer.get(); }
 
 protected:
     GrPrimitiveType         fPrimitiveType;
@@ -29,8 +36,11 @@ protected:
     int                     fStartIndex;
     int                     fVertexCount;
     int                     fIndexCount;
+    int                     fStartInstance;
+    int                     fHWInstanceCount;
     GrPendingIOResource<const GrVertexBuffer, kRead_GrIOType> fVertexBuffer;
     GrPendingIOResource<const GrIndexBuffer, kRead_GrIOType>  fIndexBuffer;
+    GrPendingIOResource<const GrVertexBuffer, kRead_GrIOType> fInstanceBuffer;
     friend class GrVertices;
 };
 
@@ -62,6 +72,9 @@ public:
         fVerticesPerInstance = 0;
         fIndicesPerInstance = 0;
         fMaxInstancesPerDraw = 0;
+        fInstanceBuffer.reset(NULL);
+        fStartInstance = 0;
+        fHWInstanceCount = 0;
     }
 
     void initIndexed(GrPrimitiveType primType,
@@ -88,6 +101,9 @@ public:
         fVerticesPerInstance = 0;
         fIndicesPerInstance = 0;
         fMaxInstancesPerDraw = 0;
+        fInstanceBuffer.reset(NULL);
+        fStartInstance = 0;
+        fHWInstanceCount = 0;
     }
 
 
@@ -119,6 +135,42 @@ public:
         fVertexCount = instanceCount * fVerticesPerInstance;
         fIndexCount = instanceCount * fIndicesPerInstance;
         fMaxInstancesPerDraw = maxInstancesPerDraw;
+        fInstanceBuffer.reset(NULL);
+        fStartInstance = 0;
+        fHWInstanceCount = 0;
+    }
+
+    /** Draws the same geometry once for each record in the instance buffer, reading the
+        primitive processor's per-instance attributes from there. The index buffer may be NULL.
+        To be used only when GrCaps::supportsInstancedDraws() is true. */
+    void initHWInstanced(GrPrimitiveType primType,
+                         const GrVertexBuffer* vertexBuffer,
+                         const GrIndexBuffer* indexBuffer,
+                         const GrVertexBuffer* instanceBuffer,
+                         int vertexCount,
+                         int indexCount,
+                         int startInstance,
+                         int instanceCount) {
+        SkASSERT(vertexBuffer);
+        SkASSERT(instanceBuffer);
+        SkASSERT(vertexCount);
+        SkASSERT(!indexBuffer == !indexCount);
+        SkASSERT(instanceCount);
+        SkASSERT(startInstance >= 0);
+        fPrimitiveType = primType;
+        fVertexBuffer.reset(vertexBuffer);
+        fIndexBuffer.reset(indexBuffer);
+        fInstanceBuffer.reset(instanceBuffer);
+        fStartVertex = 0;
+        fStartIndex = 0;
+        fVertexCount = vertexCount;
+        fIndexCount = indexCount;
+        fStartInstance = startInstance;
+        fHWInstanceCount = instanceCount;
+        fInstanceCount = 0;
+        fVerticesPerInstance = 0;
+        fIndicesPerInstance = 0;
+        fMaxInstancesPerDraw = 0;
     }
 
 
@@ -148,6 +200,8 @@ public:
             fInstanceBatch.fPrimitiveType = vertices.fPrimitiveType;
             fInstanceBatch.fStartIndex = vertices.fStartIndex;
             fInstanceBatch.fStartVertex = vertices.fStartVertex;
+            fInstanceBatch.fStartInstance = 0;
+            fInstanceBatch.fHWInstanceCount = 0;
             fInstancesRemaining = vertices.fInstanceCount - vertices.fMaxInstancesPerDraw;
             return &fInstanceBatch;
         }
@@ -9,6 +9,7 @@
 
 #include "GrBlurUtils.h"
 #include "GrContext.h"
+#include "GrDownscaleUtils.h"
 #include "GrDrawContext.h"
 #include "GrFontScaler.h"
 #include "GrGpu.h"
@@ -1088,6 +1089,11 @@ void SkGpuDevice::drawBitmapCommon(const SkDraw& draw,
                               tileSize, doBicubic);
     } else {
         // take the simple case
+        if (kHigh_SkFilterQuality == paintFilterQuality && !doBicubic &&
+            SkCanvas::kFast_SrcRectConstraint == constraint &&
+            this->drawDownscaledBitmap(bitmap, viewM, srcRect, paint)) {
+            return;
+        }
         bool needsTextureDomain = needs_texture_domain(bitmap,
                                                        srcRect,
                                                        params,
@@ -1105,6 +1111,19 @@ void SkGpuDevice::drawBitmapCommon(const SkDraw& draw,
     }
 }
 
+static bool can_upload_yuv_planes(GrContext* context, const SkBitmap& bitmap) {
+    SkPixelRef* pixelRef = bitmap.pixelRef();
+    if (NULL == pixelRef || bitmap.getTexture()) {
+        return false;
+    }
+    SkISize sizes[3];
+    if (!pixelRef->getYUV8Planes(sizes, NULL, NULL, NULL)) {
+        return false;
+    }
+    const int maxTextureSize = context->caps()->maxTextureSize();
+    return sizes[0].fWidth <= maxTextureSize && sizes[0].fHeight <= maxTextureSize;
+}
+
 // Break 'bitmap' into several tiles to draw it since it has already
 // been determined to be too large to fit in VRAM
 void SkGpuDevice::drawTiledBitmap(const SkBitmap& bitmap,
@@ -1119,8 +1138,10 @@ void SkGpuDevice::drawTiledBitmap(const SkBitmap& bitmap,
     // The following pixel lock is technically redundant, but it is desirable
     // to lock outside of the tile loop to prevent redecoding the whole image
     // at each tile in cases where 'bitmap' holds an SkDiscardablePixelRef that
-    // is larger than the limit of the discardable memory pool.
-    SkAutoLockPixels alp(bitmap);
+    // is larger than the limit of the discardable memory pool. Lazy images that
+    // can decode to YUV planes skip it: the planes are cached and shared by the
+    // tiles, and locking would force an RGBA decode instead.
+    SkAutoLockPixels alp(bitmap, !can_upload_yuv_planes(fContext, bitmap));
     SkRect clippedSrcRect = SkRect::Make(clippedSrcIRect);
 
     int nx = bitmap.width() / tileSize;
@@ -1284,6 +1305,64 @@ void SkGpuDevice::internalDrawBitmap(const SkBitmap& bitmap,
                                       paintRect);
 }
 
+/*
+ *  High quality minification. Rather than sampling the bitmap's mip maps the src rect is scaled
+ *  down to its device size on the GPU with GrDownscaleUtils and then drawn with bilerp. Returns
+ *  false if the draw isn't a minifying scale+translate of an integral src rect.
+ */
+bool SkGpuDevice::drawDownscaledBitmap(const SkBitmap& bitmap,
+                                       const SkMatrix& viewMatrix,
+                                       const SkRect& srcRect,
+                                       const SkPaint& paint) {
+    if (!viewMatrix.isScaleTranslate() ||
+        viewMatrix.getScaleX() <= 0 || viewMatrix.getScaleY() <= 0) {
+        return false;
+    }
+    SkIRect iSrcRect;
+    srcRect.round(&iSrcRect);
+    if (SkRect::Make(iSrcRect) != srcRect || iSrcRect.isEmpty()) {
+        return false;
+    }
+
+    SkRect dstRect = SkRect::MakeWH(srcRect.width(), srcRect.height());
+    SkRect devRect;
+    viewMatrix.mapRect(&devRect, dstRect);
+    int dstWidth = SkTPin(SkScalarRoundToInt(devRect.width()), 1, iSrcRect.width());
+    int dstHeight = SkTPin(SkScalarRoundToInt(devRect.height()), 1, iSrcRect.height());
+    if (dstWidth == iSrcRect.width() && dstHeight == iSrcRect.height()) {
+        return false;
+    }
+
+    GrTextureParams params(SkShader::kClamp_TileMode, GrTextureParams::kNone_FilterMode);
+    GrTexture* texture;
+    AutoBitmapTexture abt(fContext, bitmap, &params, &texture);
+    if (NULL == texture) {
+        return false;
+    }
+    SkAutoTUnref<GrTexture> downscaled(GrDownscaleUtils::Downscale(fContext, texture, iSrcRect,
+                                                                   dstWidth, dstHeight));
+    if (!downscaled) {
+        return false;
+    }
+
+    GrPaint grPaint;
+    params.setFilterMode(GrTextureParams::kBilerp_FilterMode);
+    SkAutoTUnref<GrFragmentProcessor> fp(GrSimpleTextureEffect::Create(
+            grPaint.getProcessorDataManager(), downscaled, SkMatrix::I(), params));
+    grPaint.addColorProcessor(fp);
+    bool alphaOnly = !(kAlpha_8_SkColorType == bitmap.colorType());
+    GrColor paintColor = (alphaOnly) ? SkColor2GrColorJustAlpha(paint.getColor()) :
+                                       SkColor2GrColor(paint.getColor());
+    if (!SkPaint2GrPaintNoShader(this->context(), fRenderTarget, paint, paintColor, false,
+                                 &grPaint)) {
+        return true;
+    }
+
+    fDrawContext->drawNonAARectToRect(fRenderTarget, fClip, grPaint, viewMatrix, dstRect,
+                                      SkRect::MakeWH(SK_Scalar1, SK_Scalar1));
+    return true;
+}
+
 bool SkGpuDevice::filterTexture(GrContext* context, GrTexture* texture,
                                 int width, int height,
                                 const SkImageFilter* filter,
@@ -1539,6 +1618,40 @@ void SkGpuDevice::drawImageRect(const SkDraw& draw, const SkImage* image, const
     }
 }
 
+void SkGpuDevice::drawBitmapNine(const SkDraw& draw, const SkBitmap& bitmap, const SkIRect& center,
+                                 const SkRect& dst, const SkPaint& paint) {
+    // The nine-patch batch only draws non-AA, non-perspective quads
+    if (paint.isAntiAlias() || paint.getMaskFilter() || draw.fMatrix->hasPerspective()) {
+        this->INHERITED::drawBitmapNine(draw, bitmap, center, dst, paint);
+        return;
+    }
+
+    CHECK_SHOULD_DRAW(draw);
+    GR_CREATE_TRACE_MARKER_CONTEXT("SkGpuDevice::drawBitmapNine", fContext);
+
+    // The patches sample one clamped texture, rather than nine texture-domain draws, so all
+    // nine (and neighbouring nine-patches of the same image) can be a single draw.
+    SkPaint p(paint);
+    p.setShader(SkShader::CreateBitmapShader(bitmap, SkShader::kClamp_TileMode,
+                                             SkShader::kClamp_TileMode))->unref();
+
+    GrPaint grPaint;
+    if (!SkPaint2GrPaint(this->context(), fRenderTarget, p, *draw.fMatrix, true, &grPaint)) {
+        return;
+    }
+
+    fDrawContext->drawImageNine(fRenderTarget, fClip, grPaint, *draw.fMatrix,
+                                bitmap.width(), bitmap.height(), center, dst);
+}
+
+void SkGpuDevice::drawImageNine(const SkDraw& draw, const SkImage* image, const SkIRect& center,
+                                const SkRect& dst, const SkPaint& paint) {
+    SkBitmap bm;
+    if (wrap_as_bm(image, &bm)) {
+        this->drawBitmapNine(draw, bm, center, dst, paint);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // must be in SkCanvas::VertexMode order
@@ -117,6 +117,10 @@ public:
     void drawImage(const SkDraw&, const SkImage*, SkScalar x, SkScalar y, const SkPaint&) override;
     void drawImageRect(const SkDraw&, const SkImage*, const SkRect* src, const SkRect& dst,
                        const SkPaint&, SkCanvas::SrcRectConstraint) override;
+    void drawBitmapNine(const SkDraw&, const SkBitmap&, const SkIRect& center,
+                        const SkRect& dst, const SkPaint&) override;
+    void drawImageNine(const SkDraw&, const SkImage*, const SkIRect& center,
+                       const SkRect& dst, const SkPaint&) override;
 
     void flush() override;
 
@@ -209,6 +213,10 @@ private:
                             SkCanvas::SrcRectConstraint,
                             bool bicubic,
                             bool needsTextureDomain);
+    bool drawDownscaledBitmap(const SkBitmap&,
+                              const SkMatrix& viewMatrix,
+                              const SkRect& srcRect,
+                              const SkPaint&);
     void drawTiledBitmap(const SkBitmap& bitmap,
                          const SkMatrix& viewMatrix,
                          const SkRect& srcRect,
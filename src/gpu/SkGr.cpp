@@ -341,13 +341,14 @@ static GrTexture *load_etc1_texture(GrContext* ctx, const GrUniqueKey& optionalK
 
 static GrTexture* load_yuv_texture(GrContext* ctx, const GrUniqueKey& optionalKey,
                                    const SkBitmap& bm, const GrSurfaceDesc& desc) {
-    // Subsets are not supported, the whole pixelRef is loaded when using YUV decoding
+    // The whole pixelRef is decoded to YUV planes (and cached by its generation ID), so that
+    // subsets, e.g. the tiles SkGpuDevice makes of a large lazy image, can share one decode.
+    // Only the subset is converted to RGB.
     SkPixelRef* pixelRef = bm.pixelRef();
-    if ((NULL == pixelRef) || 
-        (pixelRef->info().width()  != bm.info().width()) ||
-        (pixelRef->info().height() != bm.info().height())) {
+    if (NULL == pixelRef) {
         return NULL;
     }
+    const SkIPoint origin = bm.pixelRefOrigin();
 
     const bool useCache = optionalKey.isValid();
     SkYUVPlanesCache::Info yuvInfo;
@@ -398,6 +399,12 @@ static GrTexture* load_yuv_texture(GrContext* ctx, const GrUniqueKey& optionalKe
         }
     }
 
+    // The planes are uploaded whole, so they have to fit in a texture.
+    const int maxTextureSize = ctx->caps()->maxTextureSize();
+    if (yuvInfo.fSize[0].fWidth > maxTextureSize || yuvInfo.fSize[0].fHeight > maxTextureSize) {
+        return NULL;
+    }
+
     GrSurfaceDesc yuvDesc;
     yuvDesc.fConfig = kAlpha_8_GrPixelConfig;
     SkAutoTUnref<GrTexture> yuvTextures[3];
@@ -436,15 +443,19 @@ static GrTexture* load_yuv_texture(GrContext* ctx, const GrUniqueKey& optionalKe
                                                    yuvTextures[1], yuvTextures[2],
                                                    yuvInfo.fSize, yuvInfo.fColorSpace));
     paint.addColorProcessor(yuvToRgbProcessor);
-    SkRect r = SkRect::MakeWH(SkIntToScalar(yuvInfo.fSize[0].fWidth),
-                              SkIntToScalar(yuvInfo.fSize[0].fHeight));
+    // Draw the subset in plane coordinates (which are the local coords the effect samples with)
+    // and translate it to the origin of the result.
+    SkRect r = SkRect::MakeXYWH(SkIntToScalar(origin.fX), SkIntToScalar(origin.fY),
+                                SkIntToScalar(bm.width()), SkIntToScalar(bm.height()));
+    SkMatrix viewMatrix;
+    viewMatrix.setTranslate(-SkIntToScalar(origin.fX), -SkIntToScalar(origin.fY));
 
     GrDrawContext* drawContext = ctx->drawContext();
     if (!drawContext) {
         return NULL;
     }
 
-    drawContext->drawRect(renderTarget, GrClip::WideOpen(), paint, SkMatrix::I(), r);
+    drawContext->drawRect(renderTarget, GrClip::WideOpen(), paint, viewMatrix, r);
 
     return result;
 }
@@ -592,7 +603,7 @@ bool GrIsBitmapInCache(const GrContext* ctx,
 
     GrUniqueKey key, stretchedKey;
     make_bitmap_keys(bitmap, stretch, &key, &stretchedKey);
-    return ctx->textureProvider()->existsTextureWithUniqueKey(
+    return ctx->textureProvider()->existsTextureWithUniqueKeyFromAnyThread(
         (Stretch::kNone_Type == stretch.fType) ? key : stretchedKey);
 }
 
@@ -673,6 +684,8 @@ GrPixelConfig SkImageInfo2GrPixelConfig(SkColorType ct, SkAlphaType, SkColorProf
             return kIndex_8_GrPixelConfig;
         case kGray_8_SkColorType:
             return kAlpha_8_GrPixelConfig; // TODO: gray8 support on gpu
+        case kRGBA_F16_SkColorType:
+            return kRGBA_half_GrPixelConfig;
     }
     SkASSERT(0);    // shouldn't get here
     return kUnknown_GrPixelConfig;
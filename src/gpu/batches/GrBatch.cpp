@@ -21,16 +21,85 @@
 // different threads. The GrContext is not used concurrently on different threads and there is a
 // memory barrier between accesses of a context on different threads. Also, there may be multiple
 // GrContexts and those contexts may be in use concurrently on different threads.
+//
+// Batches are created and deleted at a high rate, in a handful of sizes, so freed ones are kept on
+// a free list per size class and handed to the next batch of that class, rather than being
+// released to the pool, which would have to find and possibly free their block.
 namespace {
 SK_DECLARE_STATIC_SPINLOCK(gBatchSpinlock);
+
+class BatchPool {
+public:
+    enum {
+        kSizeClassBytes = 32,
+        kSizeClassCount = 32,  // up to 1K
+        kMaxFreeCount   = 32,  // of each size class
+    };
+
+    BatchPool() : fPool(16384, 16384) {
+        sk_bzero(fFree, sizeof(fFree));
+        sk_bzero(fFreeCount, sizeof(fFreeCount));
+    }
+
+    // Everything on the free lists goes back to the pool, which must be empty when it's deleted.
+    ~BatchPool() {
+        for (int i = 0; i < kSizeClassCount; ++i) {
+            while (FreeBatch* batch = fFree[i]) {
+                fFree[i] = batch->fNext;
+                fPool.release(batch);
+            }
+        }
+    }
+
+    void* allocate(size_t size) {
+        const size_t sizeClass = SizeClass(size);
+        if (sizeClass >= kSizeClassCount) {
+            return fPool.allocate(size);
+        }
+        if (FreeBatch* batch = fFree[sizeClass]) {
+            fFree[sizeClass] = batch->fNext;
+            fFreeCount[sizeClass]--;
+            return batch;
+        }
+        // All the batches of a size class are allocated in its largest size.
+        return fPool.allocate((sizeClass + 1) * kSizeClassBytes);
+    }
+
+    void release(void* target, size_t size) {
+        const size_t sizeClass = SizeClass(size);
+        if (sizeClass >= kSizeClassCount || fFreeCount[sizeClass] >= kMaxFreeCount) {
+            fPool.release(target);
+            return;
+        }
+        FreeBatch* batch = static_cast<FreeBatch*>(target);
+        batch->fNext = fFree[sizeClass];
+        fFree[sizeClass] = batch;
+        fFreeCount[sizeClass]++;
+    }
+
+private:
+    struct FreeBatch {
+        FreeBatch* fNext;
+    };
+
+    static size_t SizeClass(size_t size) {
+        SkASSERT(size > 0);
+        return (size - 1) / kSizeClassBytes;
+    }
+
+    GrMemoryPool fPool;
+    FreeBatch*   fFree[kSizeClassCount];
+    int          fFreeCount[kSizeClassCount];
+};
+
 class MemoryPoolAccessor {
 public:
     MemoryPoolAccessor() { gBatchSpinlock.acquire(); }
 
     ~MemoryPoolAccessor() { gBatchSpinlock.release(); }
 
-    GrMemoryPool* pool() const {
-        static GrMemoryPool gPool(16384, 16384);
+    BatchPool* pool() const {
+        static BatchPool gPool;
         return &gPool;
     }
 };
@@ -44,8 +113,8 @@ void* GrBatch::operator new(size_t size) {
     return MemoryPoolAccessor().pool()->allocate(size);
 }
 
-void GrBatch::operator delete(void* target) {
-    return MemoryPoolAccessor().pool()->release(target);
+void GrBatch::operator delete(void* target, size_t size) {
+    return MemoryPoolAccessor().pool()->release(target, size);
 }
 
 void* GrBatch::InstancedHelper::init(GrBatchTarget* batchTarget, GrPrimitiveType primType,
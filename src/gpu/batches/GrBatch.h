@@ -85,7 +85,7 @@ public:
     int numberOfDraws() const { return fNumberOfDraws; }
 
     void* operator new(size_t size);
-    void operator delete(void* target);
+    void operator delete(void* target, size_t size);
 
     void* operator new(size_t size, void* placement) {
         return ::operator new(size, placement);
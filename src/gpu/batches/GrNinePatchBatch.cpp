@@ -0,0 +1,213 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrNinePatchBatch.h"
+
+#include "GrBatch.h"
+#include "GrBatchTarget.h"
+#include "GrBatchTest.h"
+#include "GrDefaultGeoProcFactory.h"
+#include "SkNinePatchIter.h"
+#include "SkRandom.h"
+
+class NinePatchBatch : public GrBatch {
+public:
+    static const int kVertsPerRect = 4;
+    static const int kRectsPerNinePatch = 9;
+
+    struct Geometry {
+        SkMatrix fViewMatrix;
+        SkIRect fCenter;
+        SkRect fDst;
+        int fImageWidth;
+        int fImageHeight;
+        GrColor fColor;
+    };
+
+    static GrBatch* Create(const Geometry& geometry) {
+        return SkNEW_ARGS(NinePatchBatch, (geometry));
+    }
+
+    const char* name() const override { return "NinePatchBatch"; }
+
+    void getInvariantOutputColor(GrInitInvariantOutput* out) const override {
+        // When this is called on a batch, there is only one geometry bundle
+        out->setKnownFourComponents(fGeoData[0].fColor);
+    }
+
+    void getInvariantOutputCoverage(GrInitInvariantOutput* out) const override {
+        out->setKnownSingleComponent(0xff);
+    }
+
+    void initBatchTracker(const GrPipelineInfo& init) override {
+        // Handle any color overrides
+        if (!init.readsColor()) {
+            fGeoData[0].fColor = GrColor_ILLEGAL;
+        }
+        init.getOverrideColorIfSet(&fGeoData[0].fColor);
+
+        // setup batch properties
+        fBatch.fColorIgnored = !init.readsColor();
+        fBatch.fColor = fGeoData[0].fColor;
+        fBatch.fCoverageIgnored = !init.readsCoverage();
+    }
+
+    void generateGeometry(GrBatchTarget* batchTarget) override {
+        // Positions are mapped to device space here, so nine-patches drawn with different view
+        // matrices still share a draw. Colors go in the vertices unless they all match.
+        using namespace GrDefaultGeoProcFactory;
+        const bool vertexColor = !this->colorIgnored() && GrColor_ILLEGAL == this->color();
+        Color color(Color::kAttribute_Type);
+        if (this->colorIgnored()) {
+            color = Color(Color::kNone_Type);
+        } else if (!vertexColor) {
+            color = Color(this->color());
+        }
+        Coverage coverage(this->coverageIgnored() ? Coverage::kNone_Type : Coverage::kSolid_Type);
+        LocalCoords localCoords(LocalCoords::kHasExplicit_Type);
+        SkAutoTUnref<const GrGeometryProcessor> gp(
+                GrDefaultGeoProcFactory::Create(color, coverage, localCoords, SkMatrix::I()));
+        if (!gp) {
+            SkDebugf("Could not create GrGeometryProcessor\n");
+            return;
+        }
+
+        batchTarget->initDraw(gp, this->pipeline());
+
+        size_t vertexStride = gp->getVertexStride();
+        const size_t colorOffset = sizeof(SkPoint);
+        const size_t localCoordOffset = sizeof(SkPoint) + (vertexColor ? sizeof(GrColor) : 0);
+        SkASSERT(vertexStride == localCoordOffset + sizeof(SkPoint));
+
+        int instanceCount = fGeoData.count();
+        QuadHelper helper;
+        void* vertices = helper.init(batchTarget, vertexStride,
+                                     kRectsPerNinePatch * instanceCount);
+        if (!vertices) {
+            SkDebugf("Could not allocate vertices\n");
+            return;
+        }
+
+        intptr_t vert = reinterpret_cast<intptr_t>(vertices);
+        SkDEBUGCODE(int rectsDrawn = 0;)
+        for (int i = 0; i < instanceCount; i++) {
+            const Geometry& geom = fGeoData[i];
+            SkNinePatchIter iter(geom.fImageWidth, geom.fImageHeight, geom.fCenter, geom.fDst);
+
+            SkRect srcR, dstR;
+            while (iter.next(&srcR, &dstR)) {
+                SkPoint positions[kVertsPerRect];
+                positions->setRectFan(dstR.fLeft, dstR.fTop, dstR.fRight, dstR.fBottom,
+                                      sizeof(SkPoint));
+                geom.fViewMatrix.mapPoints(positions, kVertsPerRect);
+
+                SkPoint coords[kVertsPerRect];
+                coords->setRectFan(srcR.fLeft, srcR.fTop, srcR.fRight, srcR.fBottom,
+                                   sizeof(SkPoint));
+
+                for (int j = 0; j < kVertsPerRect; ++j) {
+                    *reinterpret_cast<SkPoint*>(vert) = positions[j];
+                    if (vertexColor) {
+                        *reinterpret_cast<GrColor*>(vert + colorOffset) = geom.fColor;
+                    }
+                    *reinterpret_cast<SkPoint*>(vert + localCoordOffset) = coords[j];
+                    vert += vertexStride;
+                }
+                SkDEBUGCODE(++rectsDrawn;)
+            }
+        }
+        SkASSERT(rectsDrawn == kRectsPerNinePatch * instanceCount);
+
+        helper.issueDraw(batchTarget);
+    }
+
+    SkSTArray<1, Geometry, true>* geoData() { return &fGeoData; }
+
+private:
+    NinePatchBatch(const Geometry& geometry) {
+        this->initClassID<NinePatchBatch>();
+        fGeoData.push_back(geometry);
+
+        fBounds = geometry.fDst;
+        geometry.fViewMatrix.mapRect(&fBounds);
+        // We don't antialias, so outset a half pixel in each direction to account for snapping
+        fBounds.outset(0.5f, 0.5f);
+    }
+
+    GrColor color() const { return fBatch.fColor; }
+    bool colorIgnored() const { return fBatch.fColorIgnored; }
+    bool coverageIgnored() const { return fBatch.fCoverageIgnored; }
+
+    bool onCombineIfPossible(GrBatch* t) override {
+        if (!this->pipeline()->isEqual(*t->pipeline())) {
+            return false;
+        }
+
+        NinePatchBatch* that = t->cast<NinePatchBatch>();
+
+        if (this->color() != that->color()) {
+            fBatch.fColor = GrColor_ILLEGAL;
+        }
+        fGeoData.push_back_n(that->geoData()->count(), that->geoData()->begin());
+        this->joinBounds(that->bounds());
+        return true;
+    }
+
+    struct BatchTracker {
+        GrColor fColor;
+        bool fColorIgnored;
+        bool fCoverageIgnored;
+    };
+
+    BatchTracker fBatch;
+    SkSTArray<1, Geometry, true> fGeoData;
+};
+
+namespace GrNinePatchBatch {
+
+GrBatch* Create(GrColor color,
+                const SkMatrix& viewMatrix,
+                int imageWidth,
+                int imageHeight,
+                const SkIRect& center,
+                const SkRect& dst) {
+    SkASSERT(!viewMatrix.hasPerspective());
+    SkASSERT(SkNinePatchIter::Valid(imageWidth, imageHeight, center));
+
+    NinePatchBatch::Geometry geometry;
+    geometry.fViewMatrix = viewMatrix;
+    geometry.fCenter = center;
+    geometry.fDst = dst;
+    geometry.fImageWidth = imageWidth;
+    geometry.fImageHeight = imageHeight;
+    geometry.fColor = color;
+    return NinePatchBatch::Create(geometry);
+}
+
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef GR_TEST_UTILS
+
+BATCH_TEST_DEFINE(NinePatchBatch) {
+    GrColor color = GrRandomColor(random);
+    SkMatrix viewMatrix = GrTest::TestMatrixRectStaysRect(random);
+
+    int imageWidth = random->nextRangeU(3, 100);
+    int imageHeight = random->nextRangeU(3, 100);
+    SkIRect center;
+    center.fLeft = random->nextRangeU(0, imageWidth - 2);
+    center.fTop = random->nextRangeU(0, imageHeight - 2);
+    center.fRight = random->nextRangeU(center.fLeft + 1, imageWidth - 1);
+    center.fBottom = random->nextRangeU(center.fTop + 1, imageHeight - 1);
+
+    SkRect dst = GrTest::TestRect(random);
+    return GrNinePatchBatch::Create(color, viewMatrix, imageWidth, imageHeight, center, dst);
+}
+
+#endif
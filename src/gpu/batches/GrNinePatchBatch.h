@@ -0,0 +1,35 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrNinePatchBatch_DEFINED
+#define GrNinePatchBatch_DEFINED
+
+#include "GrColor.h"
+
+class GrBatch;
+class SkMatrix;
+struct SkIRect;
+struct SkRect;
+
+/*
+ * A factory for returning batches which draw nine-patches. All the patches of an image are
+ * emitted as quads of one draw, and nine-patches that share a pipeline (and so a texture) combine
+ * into a single draw. The local coords of each quad are in the pixel space of the image. Non-AA
+ * only, and the view matrix must not have perspective.
+ */
+namespace GrNinePatchBatch {
+
+GrBatch* Create(GrColor color,
+                const SkMatrix& viewMatrix,
+                int imageWidth,
+                int imageHeight,
+                const SkIRect& center,
+                const SkRect& dst);
+
+};
+
+#endif
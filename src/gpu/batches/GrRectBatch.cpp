@@ -11,7 +11,151 @@
 #include "GrBatchTarget.h"
 #include "GrBatchTest.h"
 #include "GrDefaultGeoProcFactory.h"
+#include "GrGeometryProcessor.h"
 #include "GrPrimitiveProcessor.h"
+#include "GrResourceProvider.h"
+#include "GrVertexBuffer.h"
+#include "gl/GrGLGeometryProcessor.h"
+#include "gl/builders/GrGLProgramBuilder.h"
+
+/**
+ * Draws rects by instancing a unit quad. Each instance supplies its rect (left, top, right,
+ * bottom) and color; the shared view matrix is applied in the vertex shader. Local coords are the
+ * pre-view-matrix positions, optionally transformed by the local matrix.
+ */
+class InstancedRectGeoProc : public GrGeometryProcessor {
+public:
+    struct Instance {
+        SkRect  fRect;
+        GrColor fColor;
+    };
+
+    static GrGeometryProcessor* Create(const SkMatrix& viewMatrix, const SkMatrix& localMatrix,
+                                       bool colorIgnored, bool coverageIgnored,
+                                       bool usesLocalCoords) {
+        return SkNEW_ARGS(InstancedRectGeoProc, (viewMatrix, localMatrix, colorIgnored,
+                                                 coverageIgnored, usesLocalCoords));
+    }
+
+    const char* name() const override { return "InstancedRectGeoProc"; }
+
+    const Attribute* inCorner() const { return fInCorner; }
+    const Attribute* inRect() const { return fInRect; }
+    const Attribute* inColor() const { return fInColor; }
+    const SkMatrix& viewMatrix() const { return fViewMatrix; }
+    const SkMatrix& localMatrix() const { return fLocalMatrix; }
+    bool colorIgnored() const { return fColorIgnored; }
+    bool coverageIgnored() const { return fCoverageIgnored; }
+    bool usesLocalCoords() const { return fUsesLocalCoords; }
+
+    class GLProcessor : public GrGLGeometryProcessor {
+    public:
+        GLProcessor(const GrGeometryProcessor&, const GrBatchTracker&)
+            : fViewMatrix(SkMatrix::InvalidMatrix()) {}
+
+        void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override {
+            const InstancedRectGeoProc& gp = args.fGP.cast<InstancedRectGeoProc>();
+            GrGLGPBuilder* pb = args.fPB;
+            GrGLVertexBuilder* vsBuilder = pb->getVertexShaderBuilder();
+            GrGLFragmentBuilder* fs = pb->getFragmentShaderBuilder();
+
+            // emit attributes
+            vsBuilder->emitAttributes(gp);
+
+            vsBuilder->codeAppendf("vec2 rectPos = mix(%s.xy, %s.zw, %s);",
+                                   gp.inRect()->fName, gp.inRect()->fName, gp.inCorner()->fName);
+
+            if (!gp.colorIgnored()) {
+                pb->addPassThroughAttribute(gp.inColor(), args.fOutputColor);
+            }
+
+            // Setup position
+            this->setupPosition(pb, gpArgs, "rectPos", gp.viewMatrix(), &fViewMatrixUniform);
+
+            // emit transforms with position
+            this->emitTransforms(pb, gpArgs->fPositionVar, "rectPos", gp.localMatrix(),
+                                 args.fTransformsIn, args.fTransformsOut);
+
+            if (!gp.coverageIgnored()) {
+                fs->codeAppendf("%s = vec4(1);", args.fOutputCoverage);
+            }
+        }
+
+        static inline void GenKey(const GrGeometryProcessor& gp,
+                                  const GrBatchTracker&,
+                                  const GrGLSLCaps&,
+                                  GrProcessorKeyBuilder* b) {
+            const InstancedRectGeoProc& irgp = gp.cast<InstancedRectGeoProc>();
+            uint32_t key = irgp.colorIgnored() ? 0x1 : 0x0;
+            key |= irgp.coverageIgnored() ? 0x2 : 0x0;
+            key |= irgp.usesLocalCoords() && irgp.localMatrix().hasPerspective() ? 0x4 : 0x0;
+            key |= ComputePosKey(irgp.viewMatrix()) << 3;
+            b->add32(key);
+        }
+
+        void setData(const GrGLProgramDataManager& pdman,
+                     const GrPrimitiveProcessor& gp,
+                     const GrBatchTracker&) override {
+            const InstancedRectGeoProc& irgp = gp.cast<InstancedRectGeoProc>();
+            if (!irgp.viewMatrix().isIdentity() && !fViewMatrix.cheapEqualTo(irgp.viewMatrix())) {
+                fViewMatrix = irgp.viewMatrix();
+                GrGLfloat viewMatrix[3 * 3];
+                GrGLGetMatrix<3>(viewMatrix, fViewMatrix);
+                pdman.setMatrix3f(fViewMatrixUniform, viewMatrix);
+            }
+        }
+
+        void setTransformData(const GrPrimitiveProcessor& primProc,
+                              const GrGLProgramDataManager& pdman,
+                              int index,
+                              const SkTArray<const GrCoordTransform*, true>& transforms) override {
+            this->setTransformDataHelper<InstancedRectGeoProc>(primProc, pdman, index, transforms);
+        }
+
+    private:
+        SkMatrix fViewMatrix;
+        UniformHandle fViewMatrixUniform;
+
+        typedef GrGLGeometryProcessor INHERITED;
+    };
+
+    void getGLProcessorKey(const GrBatchTracker& bt,
+                           const GrGLSLCaps& caps,
+                           GrProcessorKeyBuilder* b) const override {
+        GLProcessor::GenKey(*this, bt, caps, b);
+    }
+
+    GrGLPrimitiveProcessor* createGLInstance(const GrBatchTracker& bt,
+                                             const GrGLSLCaps&) const override {
+        return SkNEW_ARGS(GLProcessor, (*this, bt));
+    }
+
+private:
+    InstancedRectGeoProc(const SkMatrix& viewMatrix, const SkMatrix& localMatrix,
+                         bool colorIgnored, bool coverageIgnored, bool usesLocalCoords)
+        : fViewMatrix(viewMatrix)
+        , fLocalMatrix(localMatrix)
+        , fColorIgnored(colorIgnored)
+        , fCoverageIgnored(coverageIgnored)
+        , fUsesLocalCoords(usesLocalCoords) {
+        this->initClassID<InstancedRectGeoProc>();
+        fInCorner = &this->addVertexAttrib(Attribute("inCorner", kVec2f_GrVertexAttribType));
+        fInRect = &this->addInstanceAttrib(Attribute("inRect", kVec4f_GrVertexAttribType,
+                                                     kHigh_GrSLPrecision));
+        fInColor = &this->addInstanceAttrib(Attribute("inColor", kVec4ub_GrVertexAttribType));
+    }
+
+    const Attribute* fInCorner;
+    const Attribute* fInRect;
+    const Attribute* fInColor;
+    SkMatrix fViewMatrix;
+    SkMatrix fLocalMatrix;
+    bool fColorIgnored;
+    bool fCoverageIgnored;
+    bool fUsesLocalCoords;
+
+    typedef GrGeometryProcessor INHERITED;
+};
 
 class RectBatch : public GrBatch {
 public:
@@ -55,7 +199,15 @@ public:
     }
 
     void generateGeometry(GrBatchTarget* batchTarget) override {
-        SkAutoTUnref<const GrGeometryProcessor> gp(this->createRectGP());
+        if (this->canDrawInstanced(batchTarget->caps())) {
+            this->generateInstancedGeometry(batchTarget);
+            return;
+        }
+
+        VertexLayout layout;
+        this->computeVertexLayout(batchTarget->caps(), &layout);
+
+        SkAutoTUnref<const GrGeometryProcessor> gp(this->createRectGP(layout));
         if (!gp) {
             SkDebugf("Could not create GrGeometryProcessor\n");
             return;
@@ -65,9 +217,7 @@ public:
 
         int instanceCount = fGeoData.count();
         size_t vertexStride = gp->getVertexStride();
-        SkASSERT(this->hasLocalRect() ?
-                 vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorLocalCoordAttr) :
-                 vertexStride == sizeof(GrDefaultGeoProcFactory::PositionColorAttr));
+        SkASSERT(vertexStride == layout.stride());
         QuadHelper helper;
         void* vertices = helper.init(batchTarget, vertexStride, instanceCount);
 
@@ -80,29 +230,43 @@ public:
 
             intptr_t offset = reinterpret_cast<intptr_t>(vertices) +
                               kVerticesPerQuad * i * vertexStride;
-            SkPoint* positions = reinterpret_cast<SkPoint*>(offset);
 
+            SkPoint positions[kVerticesPerQuad];
             positions->setRectFan(geom.fRect.fLeft, geom.fRect.fTop,
-                                  geom.fRect.fRight, geom.fRect.fBottom, vertexStride);
-            geom.fViewMatrix.mapPointsWithStride(positions, vertexStride, kVerticesPerQuad);
+                                  geom.fRect.fRight, geom.fRect.fBottom, sizeof(SkPoint));
+            geom.fViewMatrix.mapPoints(positions, kVerticesPerQuad);
 
             // TODO we should only do this if local coords are being read
+            SkPoint coords[kVerticesPerQuad];
             if (geom.fHasLocalRect) {
-                static const int kLocalOffset = sizeof(SkPoint) + sizeof(GrColor);
-                SkPoint* coords = reinterpret_cast<SkPoint*>(offset + kLocalOffset);
                 coords->setRectFan(geom.fLocalRect.fLeft, geom.fLocalRect.fTop,
                                    geom.fLocalRect.fRight, geom.fLocalRect.fBottom,
-                                   vertexStride);
+                                   sizeof(SkPoint));
                 if (geom.fHasLocalMatrix) {
-                    geom.fLocalMatrix.mapPointsWithStride(coords, vertexStride, kVerticesPerQuad);
+                    geom.fLocalMatrix.mapPoints(coords, kVerticesPerQuad);
                 }
             }
 
-            static const int kColorOffset = sizeof(SkPoint);
-            GrColor* vertColor = reinterpret_cast<GrColor*>(offset + kColorOffset);
-            for (int j = 0; j < 4; ++j) {
-                *vertColor = geom.fColor;
-                vertColor = (GrColor*) ((intptr_t) vertColor + vertexStride);
+            for (int j = 0; j < kVerticesPerQuad; ++j) {
+                intptr_t vert = offset + j * vertexStride;
+                if (layout.fPackedPositions) {
+                    GrDefaultGeoProcFactory::PackDevicePosition(positions[j], layout.fTileOrigin,
+                                                                reinterpret_cast<int16_t*>(vert));
+                } else {
+                    *reinterpret_cast<SkPoint*>(vert) = positions[j];
+                }
+                if (layout.fVertexColor) {
+                    *reinterpret_cast<GrColor*>(vert + layout.colorOffset()) = geom.fColor;
+                }
+                if (geom.fHasLocalRect) {
+                    intptr_t localCoord = vert + layout.localCoordOffset();
+                    if (layout.fHalfLocalCoords) {
+                        GrDefaultGeoProcFactory::PackLocalCoord(
+                                coords[j], reinterpret_cast<SkHalf*>(localCoord));
+                    } else {
+                        *reinterpret_cast<SkPoint*>(localCoord) = coords[j];
+                    }
+                }
             }
         }
 
@@ -129,6 +293,65 @@ private:
     bool hasLocalMatrix() const { return fGeoData[0].fHasLocalMatrix; }
     bool coverageIgnored() const { return fBatch.fCoverageIgnored; }
 
+    // The instanced path applies a single view matrix on the GPU, so it needs every rect to share
+    // it. Batches with explicit local rects keep using the CPU-expanded quads.
+    bool canDrawInstanced(const GrCaps& caps) const {
+        if (!caps.supportsInstancedDraws() || this->hasLocalRect()) {
+            return false;
+        }
+        for (int i = 1; i < fGeoData.count(); ++i) {
+            if (!fGeoData[i].fViewMatrix.cheapEqualTo(this->viewMatrix())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void generateInstancedGeometry(GrBatchTarget* batchTarget) {
+        SkAutoTUnref<const GrGeometryProcessor> gp(
+                InstancedRectGeoProc::Create(this->viewMatrix(),
+                                             this->hasLocalMatrix() ? this->localMatrix() :
+                                                                      SkMatrix::I(),
+                                             this->colorIgnored(),
+                                             this->coverageIgnored(),
+                                             this->usesLocalCoords()));
+
+        SkAutoTUnref<const GrVertexBuffer> quad(
+                batchTarget->resourceProvider()->refUnitQuadVertexBuffer());
+        SkAutoTUnref<const GrIndexBuffer> indices(
+                batchTarget->resourceProvider()->refQuadIndexBuffer());
+        if (!quad || !indices) {
+            SkDebugf("Could not allocate unit quad buffers\n");
+            return;
+        }
+
+        batchTarget->initDraw(gp, this->pipeline());
+
+        int instanceCount = fGeoData.count();
+        size_t instanceStride = gp->getInstanceStride();
+        SkASSERT(instanceStride == sizeof(InstancedRectGeoProc::Instance));
+        const GrVertexBuffer* instanceBuffer;
+        int firstInstance;
+        void* data = batchTarget->makeVertSpace(instanceStride, instanceCount, &instanceBuffer,
+                                                &firstInstance);
+        if (!data) {
+            SkDebugf("Could not allocate instances\n");
+            return;
+        }
+
+        InstancedRectGeoProc::Instance* instances =
+                reinterpret_cast<InstancedRectGeoProc::Instance*>(data);
+        for (int i = 0; i < instanceCount; i++) {
+            instances[i].fRect = fGeoData[i].fRect;
+            instances[i].fColor = fGeoData[i].fColor;
+        }
+
+        GrVertices vertices;
+        vertices.initHWInstanced(kTriangles_GrPrimitiveType, quad, indices, instanceBuffer,
+                                 kVerticesPerQuad, kIndicesPerQuad, firstInstance, instanceCount);
+        batchTarget->draw(vertices);
+    }
+
     bool onCombineIfPossible(GrBatch* t) override {
         if (!this->pipeline()->isEqual(*t->pipeline())) {
             return false;
@@ -163,32 +386,84 @@ private:
         return true;
     }
 
-    /** We always use per-vertex colors so that rects can be batched across color changes. Sometimes
-        we  have explicit local coords and sometimes not. We *could* always provide explicit local
-        coords and just duplicate the positions when the caller hasn't provided a local coord rect,
-        but we haven't seen a use case which frequently switches between local rect and no local
-        rect draws.
-
-        The color param is used to determine whether the opaque hint can be set on the draw state.
-        The caller must populate the vertex colors itself.
+    /** Rects can be batched across color changes so colors are normally per-vertex. When every
+        rect in the batch turns out to have the same color (or color is ignored) the color is
+        moved to a uniform instead. Positions are packed into 16 bits when the batch fits in one
+        device space tile and explicit local coords are stored as halfs when they are small
+        enough and the GPU supports it.
 
-        The vertex attrib order is always pos, color, [local coords].
+        The vertex attrib order is always pos, [color], [local coords].
      */
-    const GrGeometryProcessor* createRectGP() {
+    struct VertexLayout {
+        bool     fPackedPositions;
+        SkIPoint fTileOrigin;
+        bool     fVertexColor;
+        bool     fHalfLocalCoords;
+        bool     fHasLocalCoords;
+
+        size_t colorOffset() const {
+            return fPackedPositions ? 2 * sizeof(int16_t) : sizeof(SkPoint);
+        }
+        size_t localCoordOffset() const {
+            return this->colorOffset() + (fVertexColor ? sizeof(GrColor) : 0);
+        }
+        size_t stride() const {
+            size_t localCoordSize = 0;
+            if (fHasLocalCoords) {
+                localCoordSize = fHalfLocalCoords ? 2 * sizeof(SkHalf) : sizeof(SkPoint);
+            }
+            return this->localCoordOffset() + localCoordSize;
+        }
+    };
+
+    void computeVertexLayout(const GrCaps& caps, VertexLayout* layout) const {
+        layout->fPackedPositions = GrDefaultGeoProcFactory::CanPackDevicePositions(
+                                                                    this->bounds(),
+                                                                    &layout->fTileOrigin);
+        layout->fVertexColor = !this->colorIgnored() && GrColor_ILLEGAL == this->color();
+        layout->fHasLocalCoords = this->hasLocalRect();
+        layout->fHalfLocalCoords = false;
+        if (this->hasLocalRect() && caps.halfFloatVertexAttributeSupport()) {
+            SkRect localBounds;
+            localBounds.setEmpty();
+            for (int i = 0; i < fGeoData.count(); ++i) {
+                SkRect mappedLocalRect = fGeoData[i].fLocalRect;
+                if (fGeoData[i].fHasLocalMatrix) {
+                    fGeoData[i].fLocalMatrix.mapRect(&mappedLocalRect);
+                }
+                localBounds.join(mappedLocalRect);
+            }
+            layout->fHalfLocalCoords = GrDefaultGeoProcFactory::CanUseHalfLocalCoords(
+                                                                                    localBounds);
+        }
+    }
+
+    const GrGeometryProcessor* createRectGP(const VertexLayout& layout) {
         using namespace GrDefaultGeoProcFactory;
         Color color(Color::kAttribute_Type);
+        if (this->colorIgnored()) {
+            color = Color(Color::kNone_Type);
+        } else if (!layout.fVertexColor) {
+            color = Color(this->color());
+        }
         Coverage coverage(this->coverageIgnored() ? Coverage::kNone_Type : Coverage::kSolid_Type);
+        Position position;
+        if (layout.fPackedPositions) {
+            position = Position(layout.fTileOrigin);
+        }
 
         // if we have a local rect, then we apply the localMatrix directly to the localRect to
         // generate vertex local coords
         if (this->hasLocalRect()) {
-            LocalCoords localCoords(LocalCoords::kHasExplicit_Type);
-            return GrDefaultGeoProcFactory::Create(color, coverage, localCoords, SkMatrix::I());
+            LocalCoords localCoords(layout.fHalfLocalCoords ? LocalCoords::kHasExplicitHalf_Type :
+                                                              LocalCoords::kHasExplicit_Type);
+            return GrDefaultGeoProcFactory::Create(color, coverage, localCoords, SkMatrix::I(),
+                                                   position);
         } else {
             LocalCoords localCoords(LocalCoords::kUsePosition_Type,
                                     this->hasLocalMatrix() ? &this->localMatrix() : NULL);
             return GrDefaultGeoProcFactory::CreateForDeviceSpace(color, coverage, localCoords,
-                                                                 this->viewMatrix());
+                                                                 this->viewMatrix(), position);
         }
     }
 
@@ -31,8 +31,10 @@ public:
     Gr1DKernelEffect(GrProcessorDataManager* procDataManager,
                      GrTexture* texture,
                      Direction direction,
-                     int radius)
-        : INHERITED(procDataManager, texture, GrCoordTransform::MakeDivByTextureWHMatrix(texture))
+                     int radius,
+                     GrTextureParams::FilterMode filterMode = GrTextureParams::kNone_FilterMode)
+        : INHERITED(procDataManager, texture, GrCoordTransform::MakeDivByTextureWHMatrix(texture),
+                    filterMode)
         , fDirection(direction)
         , fRadius(radius) {}
 
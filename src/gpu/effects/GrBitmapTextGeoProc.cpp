@@ -17,7 +17,9 @@
 class GrGLBitmapTextGeoProc : public GrGLGeometryProcessor {
 public:
     GrGLBitmapTextGeoProc(const GrGeometryProcessor&, const GrBatchTracker&)
-        : fColor(GrColor_ILLEGAL) {}
+        : fColor(GrColor_ILLEGAL) {
+        fTranslate.set(SK_ScalarNaN, SK_ScalarNaN);
+    }
 
     void onEmitCode(EmitArgs& args, GrGPArgs* gpArgs) override{
         const GrBitmapTextGeoProc& cte = args.fGP.cast<GrBitmapTextGeoProc>();
@@ -52,10 +54,23 @@ public:
         }
 
         // Setup position
-        this->setupPosition(pb, gpArgs, cte.inPosition()->fName);
+        const char* localCoords = cte.inPosition()->fName;
+        if (cte.hasTranslate()) {
+            const char* translateName;
+            fTranslateUniform = pb->addUniform(GrGLProgramBuilder::kVertex_Visibility,
+                                               kVec2f_GrSLType, kHigh_GrSLPrecision,
+                                               "Translate", &translateName);
+            gpArgs->fPositionVar.set(kVec2f_GrSLType, "pos2");
+            vsBuilder->codeAppendf("vec2 %s = %s + %s;", gpArgs->fPositionVar.c_str(),
+                                   cte.inPosition()->fName, translateName);
+            // The local matrix maps the translated (current) device position.
+            localCoords = gpArgs->fPositionVar.c_str();
+        } else {
+            this->setupPosition(pb, gpArgs, cte.inPosition()->fName);
+        }
 
         // emit transforms
-        this->emitTransforms(args.fPB, gpArgs->fPositionVar, cte.inPosition()->fName,
+        this->emitTransforms(args.fPB, gpArgs->fPositionVar, localCoords,
                              cte.localMatrix(), args.fTransformsIn, args.fTransformsOut);
 
         GrGLFragmentBuilder* fsBuilder = pb->getFragmentShaderBuilder();
@@ -84,6 +99,10 @@ public:
             pdman.set4fv(fColorUniform, 1, c);
             fColor = btgp.color();
         }
+        if (btgp.hasTranslate() && btgp.translate() != fTranslate) {
+            pdman.set2f(fTranslateUniform, btgp.translate().fX, btgp.translate().fY);
+            fTranslate = btgp.translate();
+        }
     }
 
     void setTransformData(const GrPrimitiveProcessor& primProc,
@@ -101,6 +120,7 @@ public:
         uint32_t key = 0;
         key |= gp.usesLocalCoords() && gp.localMatrix().hasPerspective() ? 0x1 : 0x0;
         key |= gp.colorIgnored() ? 0x2 : 0x0;
+        key |= gp.hasTranslate() ? 0x4 : 0x0;
         key |= gp.maskFormat() << 3;
         b->add32(key);
 
@@ -114,7 +134,9 @@ public:
 
 private:
     GrColor fColor;
+    SkVector fTranslate;
     UniformHandle fColorUniform;
+    UniformHandle fTranslateUniform;
 
     typedef GrGLGeometryProcessor INHERITED;
 };
@@ -123,10 +145,12 @@ private:
 
 GrBitmapTextGeoProc::GrBitmapTextGeoProc(GrColor color, GrTexture* texture,
                                          const GrTextureParams& params, GrMaskFormat format,
-                                         const SkMatrix& localMatrix, bool usesLocalCoords)
+                                         const SkMatrix& localMatrix, bool usesLocalCoords,
+                                         const SkVector& translate)
     : fColor(color)
     , fLocalMatrix(localMatrix)
     , fUsesLocalCoords(usesLocalCoords)
+    , fTranslate(translate)
     , fTextureAccess(texture, params)
     , fInColor(NULL)
     , fMaskFormat(format) {
@@ -188,7 +212,13 @@ GrGeometryProcessor* GrBitmapTextGeoProc::TestCreate(GrProcessorTestData* d) {
             break;
     }
 
+    SkVector translate = SkVector::Make(0, 0);
+    if (d->fRandom->nextBool()) {
+        translate.set(SkIntToScalar(d->fRandom->nextRangeU(0, 64)),
+                      SkIntToScalar(d->fRandom->nextRangeU(0, 64)));
+    }
+
     return GrBitmapTextGeoProc::Create(GrRandomColor(d->fRandom), d->fTextures[texIdx], params,
                                        format, GrTest::TestMatrix(d->fRandom),
-                                       d->fRandom->nextBool());
+                                       d->fRandom->nextBool(), translate);
 }
@@ -21,11 +21,16 @@ class GrInvariantOutput;
  */
 class GrBitmapTextGeoProc : public GrGeometryProcessor {
 public:
+    /**
+     * translate is a device space offset added to every vertex position in the vertex shader, so
+     * that cached text can be moved without rewriting its vertices.
+     */
     static GrGeometryProcessor* Create(GrColor color, GrTexture* tex, const GrTextureParams& p,
                                        GrMaskFormat format, const SkMatrix& localMatrix,
-                                       bool usesLocalCoords) {
+                                       bool usesLocalCoords,
+                                       const SkVector& translate = SkVector::Make(0, 0)) {
         return SkNEW_ARGS(GrBitmapTextGeoProc, (color, tex, p, format, localMatrix,
-                usesLocalCoords));
+                usesLocalCoords, translate));
     }
 
     virtual ~GrBitmapTextGeoProc() {}
@@ -41,6 +46,8 @@ public:
     bool hasVertexColor() const { return SkToBool(fInColor); }
     const SkMatrix& localMatrix() const { return fLocalMatrix; }
     bool usesLocalCoords() const { return fUsesLocalCoords; }
+    const SkVector& translate() const { return fTranslate; }
+    bool hasTranslate() const { return !fTranslate.isZero(); }
 
     virtual void getGLProcessorKey(const GrBatchTracker& bt,
                                    const GrGLSLCaps& caps,
@@ -51,11 +58,13 @@ public:
 
 private:
     GrBitmapTextGeoProc(GrColor, GrTexture* texture, const GrTextureParams& params,
-                        GrMaskFormat format, const SkMatrix& localMatrix, bool usesLocalCoords);
+                        GrMaskFormat format, const SkMatrix& localMatrix, bool usesLocalCoords,
+                        const SkVector& translate);
 
     GrColor          fColor;
     SkMatrix         fLocalMatrix;
     bool             fUsesLocalCoords;
+    SkVector         fTranslate;
     GrTextureAccess  fTextureAccess;
     const Attribute* fInPosition;
     const Attribute* fInColor;
@@ -24,14 +24,16 @@ public:
     static inline void GenKey(const GrProcessor&, const GrGLSLCaps&, GrProcessorKeyBuilder*);
 
 private:
-    int width() const { return Gr1DKernelEffect::WidthFromRadius(fRadius); }
+    int tapCount() const { return GrConvolutionEffect::TapCount(fRadius, fLinearTaps); }
     bool useBounds() const { return fUseBounds; }
     Gr1DKernelEffect::Direction direction() const { return fDirection; }
 
     int                 fRadius;
+    bool                fLinearTaps;
     bool                fUseBounds;
     Gr1DKernelEffect::Direction    fDirection;
     UniformHandle       fKernelUni;
+    UniformHandle       fTapOffsetsUni;
     UniformHandle       fImageIncrementUni;
     UniformHandle       fBoundsUni;
 
@@ -41,6 +43,7 @@ private:
 GrGLConvolutionEffect::GrGLConvolutionEffect(const GrProcessor& processor) {
     const GrConvolutionEffect& c = processor.cast<GrConvolutionEffect>();
     fRadius = c.radius();
+    fLinearTaps = c.linearTaps();
     fUseBounds = c.useBounds();
     fDirection = c.direction();
 }
@@ -56,21 +59,50 @@ void GrGLConvolutionEffect::emitCode(EmitArgs& args) {
     }
     fKernelUni = args.fBuilder->addUniformArray(GrGLProgramBuilder::kFragment_Visibility,
                                           kFloat_GrSLType, kDefault_GrSLPrecision,
-                                          "Kernel", this->width());
+                                          "Kernel", this->tapCount());
+    if (fLinearTaps) {
+        fTapOffsetsUni = args.fBuilder->addUniformArray(GrGLProgramBuilder::kFragment_Visibility,
+                                                        kFloat_GrSLType, kDefault_GrSLPrecision,
+                                                        "TapOffsets", this->tapCount());
+    }
 
     GrGLFragmentBuilder* fsBuilder = args.fBuilder->getFragmentShaderBuilder();
     SkString coords2D = fsBuilder->ensureFSCoords2D(args.fCoords, 0);
 
     fsBuilder->codeAppendf("\t\t%s = vec4(0, 0, 0, 0);\n", args.fOutputColor);
 
-    int width = this->width();
+    int tapCount = this->tapCount();
     const GrGLShaderVar& kernel = args.fBuilder->getUniformVariable(fKernelUni);
     const char* imgInc = args.fBuilder->getUniformCStr(fImageIncrementUni);
 
+    if (fLinearTaps) {
+        // Each fetch lands between two texels, so bilinear filtering weights them for us.
+        const GrGLShaderVar& offsets = args.fBuilder->getUniformVariable(fTapOffsetsUni);
+        for (int i = 0; i < tapCount; i++) {
+            SkString index;
+            SkString kernelIndex;
+            SkString offsetIndex;
+            index.appendS32(i);
+            kernel.appendArrayAccess(index.c_str(), &kernelIndex);
+            offsets.appendArrayAccess(index.c_str(), &offsetIndex);
+
+            SkString coord;
+            coord.printf("%s + %s * %s", coords2D.c_str(), offsetIndex.c_str(), imgInc);
+            fsBuilder->codeAppendf("\t\t%s += ", args.fOutputColor);
+            fsBuilder->appendTextureLookup(args.fSamplers[0], coord.c_str());
+            fsBuilder->codeAppendf(" * %s;\n", kernelIndex.c_str());
+        }
+
+        SkString modulate;
+        GrGLSLMulVarBy4f(&modulate, args.fOutputColor, args.fInputColor);
+        fsBuilder->codeAppend(modulate.c_str());
+        return;
+    }
+
     fsBuilder->codeAppendf("\t\tvec2 coord = %s - %d.0 * %s;\n", coords2D.c_str(), fRadius, imgInc);
 
     // Manually unroll loop because some drivers don't; yields 20-30% speedup.
-    for (int i = 0; i < width; i++) {
+    for (int i = 0; i < tapCount; i++) {
         SkString index;
         SkString kernelIndex;
         index.appendS32(i);
@@ -127,14 +159,20 @@ void GrGLConvolutionEffect::setData(const GrGLProgramDataManager& pdman,
             pdman.set2f(fBoundsUni, bounds[0], bounds[1]);
         }
     }
-    pdman.set1fv(fKernelUni, this->width(), conv.kernel());
+    pdman.set1fv(fKernelUni, this->tapCount(), conv.kernel());
+    if (conv.linearTaps()) {
+        pdman.set1fv(fTapOffsetsUni, this->tapCount(), conv.tapOffsets());
+    }
 }
 
 void GrGLConvolutionEffect::GenKey(const GrProcessor& processor, const GrGLSLCaps&,
                                    GrProcessorKeyBuilder* b) {
     const GrConvolutionEffect& conv = processor.cast<GrConvolutionEffect>();
     uint32_t key = conv.radius();
-    key <<= 2;
+    key <<= 3;
+    if (conv.linearTaps()) {
+        key |= 0x4;
+    }
     if (conv.useBounds()) {
         key |= 0x2;
         key |= GrConvolutionEffect::kY_Direction == conv.direction() ? 0x1 : 0x0;
@@ -144,6 +182,25 @@ void GrGLConvolutionEffect::GenKey(const GrProcessor& processor, const GrGLSLCap
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Fills the 2 * radius + 1 entries of kernel with a normalized Gaussian.
+static void fill_gaussian_kernel(float* kernel, int radius, float gaussianSigma) {
+    const int width = Gr1DKernelEffect::WidthFromRadius(radius);
+    float sum = 0.0f;
+    float denom = 1.0f / (2.0f * gaussianSigma * gaussianSigma);
+    for (int i = 0; i < width; ++i) {
+        float x = static_cast<float>(i - radius);
+        // Note that the constant term (1/(sqrt(2*pi*sigma^2)) of the Gaussian
+        // is dropped here, since we renormalize the kernel below.
+        kernel[i] = sk_float_exp(- x * x * denom);
+        sum += kernel[i];
+    }
+    // Normalize the kernel
+    float scale = 1.0f / sum;
+    for (int i = 0; i < width; ++i) {
+        kernel[i] *= scale;
+    }
+}
+
 GrConvolutionEffect::GrConvolutionEffect(GrProcessorDataManager* procDataManager,
                                          GrTexture* texture,
                                          Direction direction,
@@ -151,7 +208,9 @@ GrConvolutionEffect::GrConvolutionEffect(GrProcessorDataManager* procDataManager
                                          const float* kernel,
                                          bool useBounds,
                                          float bounds[2])
-    : INHERITED(procDataManager, texture, direction, radius), fUseBounds(useBounds) {
+    : INHERITED(procDataManager, texture, direction, radius)
+    , fLinearTaps(false)
+    , fUseBounds(useBounds) {
     this->initClassID<GrConvolutionEffect>();
     SkASSERT(radius <= kMaxKernelRadius);
     SkASSERT(kernel);
@@ -169,26 +228,48 @@ GrConvolutionEffect::GrConvolutionEffect(GrProcessorDataManager* procDataManager
                                          float gaussianSigma,
                                          bool useBounds,
                                          float bounds[2])
-    : INHERITED(procDataManager, texture, direction, radius), fUseBounds(useBounds) {
+    : INHERITED(procDataManager, texture, direction, radius)
+    , fLinearTaps(false)
+    , fUseBounds(useBounds) {
     this->initClassID<GrConvolutionEffect>();
     SkASSERT(radius <= kMaxKernelRadius);
-    int width = this->width();
+    fill_gaussian_kernel(fKernel, radius, gaussianSigma);
+    memcpy(fBounds, bounds, sizeof(fBounds));
+}
 
-    float sum = 0.0f;
-    float denom = 1.0f / (2.0f * gaussianSigma * gaussianSigma);
-    for (int i = 0; i < width; ++i) {
-        float x = static_cast<float>(i - this->radius());
-        // Note that the constant term (1/(sqrt(2*pi*sigma^2)) of the Gaussian
-        // is dropped here, since we renormalize the kernel below.
-        fKernel[i] = sk_float_exp(- x * x * denom);
-        sum += fKernel[i];
-    }
-    // Normalize the kernel
-    float scale = 1.0f / sum;
-    for (int i = 0; i < width; ++i) {
-        fKernel[i] *= scale;
+GrConvolutionEffect::GrConvolutionEffect(GrProcessorDataManager* procDataManager,
+                                         GrTexture* texture,
+                                         Direction direction,
+                                         int radius,
+                                         float gaussianSigma)
+    : INHERITED(procDataManager, texture, direction, radius, GrTextureParams::kBilerp_FilterMode)
+    , fLinearTaps(true)
+    , fUseBounds(false) {
+    this->initClassID<GrConvolutionEffect>();
+    SkASSERT(radius <= kMaxLinearKernelRadius);
+    float kernel[2 * kMaxLinearKernelRadius + 1];
+    fill_gaussian_kernel(kernel, radius, gaussianSigma);
+    const float* center = kernel + radius;
+
+    // The center texel is fetched alone; the rest are fetched in pairs (i, i + 1) on either side,
+    // at the point between them where bilinear filtering weights them in the kernel's ratio. An
+    // odd radius leaves the outermost texel to pair with one of zero weight.
+    const int tapCount = this->tapCount();
+    const int centerTap = tapCount / 2;
+    fKernel[centerTap] = center[0];
+    fTapOffsets[centerTap] = 0;
+    for (int tap = 1; tap <= centerTap; ++tap) {
+        const int i = 2 * tap - 1;
+        const float w0 = center[i];
+        const float w1 = i + 1 <= radius ? center[i + 1] : 0.0f;
+        const float weight = w0 + w1;
+        const float offset = i + w1 / weight;
+        fKernel[centerTap + tap] = fKernel[centerTap - tap] = weight;
+        fTapOffsets[centerTap + tap] = offset;
+        fTapOffsets[centerTap - tap] = -offset;
     }
-    memcpy(fBounds, bounds, sizeof(fBounds));
+    fBounds[0] = 0.0f;
+    fBounds[1] = 1.0f;
 }
 
 GrConvolutionEffect::~GrConvolutionEffect() {
@@ -207,9 +288,12 @@ bool GrConvolutionEffect::onIsEqual(const GrFragmentProcessor& sBase) const {
     const GrConvolutionEffect& s = sBase.cast<GrConvolutionEffect>();
     return (this->radius() == s.radius() &&
             this->direction() == s.direction() &&
+            this->linearTaps() == s.linearTaps() &&
             this->useBounds() == s.useBounds() &&
             0 == memcmp(fBounds, s.fBounds, sizeof(fBounds)) &&
-            0 == memcmp(fKernel, s.fKernel, this->width() * sizeof(float)));
+            0 == memcmp(fKernel, s.fKernel, this->tapCount() * sizeof(float)) &&
+            (!this->linearTaps() ||
+             0 == memcmp(fTapOffsets, s.fTapOffsets, this->tapCount() * sizeof(float))));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -220,6 +304,15 @@ GrFragmentProcessor* GrConvolutionEffect::TestCreate(GrProcessorTestData* d) {
     int texIdx = d->fRandom->nextBool() ? GrProcessorUnitTest::kSkiaPMTextureIdx :
                                           GrProcessorUnitTest::kAlphaTextureIdx;
     Direction dir = d->fRandom->nextBool() ? kX_Direction : kY_Direction;
+    if (d->fRandom->nextBool()) {
+        int radius = d->fRandom->nextRangeU(1, kMaxLinearKernelRadius);
+        float sigma = radius / 3.0f;
+        return GrConvolutionEffect::CreateGaussianLinear(d->fProcDataManager,
+                                                         d->fTextures[texIdx],
+                                                         dir,
+                                                         radius,
+                                                         sigma);
+    }
     int radius = d->fRandom->nextRangeU(1, kMaxKernelRadius);
     float kernel[kMaxKernelWidth];
     for (size_t i = 0; i < SK_ARRAY_COUNT(kernel); ++i) {
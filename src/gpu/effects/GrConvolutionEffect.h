@@ -54,10 +54,41 @@ public:
                                                 bounds));
     }
 
+    /**
+     * Convolve with a Gaussian kernel, reading adjacent pairs of texels with one bilinear fetch
+     * weighted by their combined kernel value. This needs about half the fetches of
+     * CreateGaussian(), so a radius of up to kMaxLinearKernelRadius is allowed. It cannot be
+     * bounded, since a fetch may straddle the bounds.
+     */
+    static GrFragmentProcessor* CreateGaussianLinear(GrProcessorDataManager* procDataManager,
+                                                     GrTexture* tex,
+                                                     Direction dir,
+                                                     int halfWidth,
+                                                     float gaussianSigma) {
+        return SkNEW_ARGS(GrConvolutionEffect, (procDataManager,
+                                                tex,
+                                                dir,
+                                                halfWidth,
+                                                gaussianSigma));
+    }
+
     virtual ~GrConvolutionEffect();
 
+    /** The weights of the texture fetches; there are tapCount() of them. */
     const float* kernel() const { return fKernel; }
 
+    /**
+     * For linear taps, the offset of each fetch from the kernel center, in texels. NULL if every
+     * texel is fetched individually.
+     */
+    const float* tapOffsets() const { return fLinearTaps ? fTapOffsets : NULL; }
+    bool linearTaps() const { return fLinearTaps; }
+    int tapCount() const { return TapCount(this->radius(), fLinearTaps); }
+
+    static int TapCount(int radius, bool linearTaps) {
+        return linearTaps ? 1 + 2 * ((radius + 1) / 2) : WidthFromRadius(radius);
+    }
+
     const float* bounds() const { return fBounds; }
     bool useBounds() const { return fUseBounds; }
 
@@ -74,11 +105,16 @@ public:
         // With a C++11 we could have a constexpr version of WidthFromRadius()
         // and not have to duplicate this calculation.
         kMaxKernelWidth = 2 * kMaxKernelRadius + 1,
+        // Linear taps fetch two texels at a time, so twice the radius fits in the same number of
+        // fetches.
+        kMaxLinearKernelRadius = 2 * kMaxKernelRadius,
     };
 
 protected:
 
     float fKernel[kMaxKernelWidth];
+    float fTapOffsets[kMaxKernelWidth];
+    bool fLinearTaps;
     bool fUseBounds;
     float fBounds[2];
 
@@ -98,6 +134,12 @@ private:
                         bool useBounds,
                         float bounds[2]);
 
+    /// Convolve with a Gaussian kernel using bilinear fetches
+    GrConvolutionEffect(GrProcessorDataManager*,
+                        GrTexture*, Direction,
+                        int halfWidth,
+                        float gaussianSigma);
+
     void onGetGLProcessorKey(const GrGLSLCaps&, GrProcessorKeyBuilder*) const override;
 
     bool onIsEqual(const GrFragmentProcessor&) const override;
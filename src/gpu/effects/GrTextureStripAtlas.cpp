@@ -52,12 +52,17 @@ void GrTextureStripAtlas::CleanUp(const GrContext*, void* info) {
 }
 
 GrTextureStripAtlas* GrTextureStripAtlas::GetAtlas(const GrTextureStripAtlas::Desc& desc) {
-    AtlasEntry* entry = GetCache()->find(desc);
+    // The page height doesn't affect how rows are addressed, so leave it out of the key and let
+    // every user of the same row format share the one set of pages.
+    Desc key = desc;
+    key.fHeight = 0;
+
+    AtlasEntry* entry = GetCache()->find(key);
     if (NULL == entry) {
         entry = SkNEW(AtlasEntry);
 
         entry->fAtlas = SkNEW_ARGS(GrTextureStripAtlas, (desc));
-        entry->fDesc = desc;
+        entry->fDesc = key;
 
         desc.fContext->addCleanUp(CleanUp, entry);
 
@@ -67,30 +72,39 @@ GrTextureStripAtlas* GrTextureStripAtlas::GetAtlas(const GrTextureStripAtlas::De
     return entry->fAtlas;
 }
 
-GrTextureStripAtlas::GrTextureStripAtlas(GrTextureStripAtlas::Desc desc)
+GrTextureStripAtlas::Page::Page(int firstRow, int numRows)
     : fCacheKey(sk_atomic_inc(&gCacheCount))
-    , fLockedRows(0)
-    , fDesc(desc)
-    , fNumRows(desc.fHeight / desc.fRowHeight)
     , fTexture(NULL)
-    , fRows(SkNEW_ARRAY(AtlasRow, fNumRows))
+    , fRows(SkNEW_ARRAY(AtlasRow, numRows)) {
+    for (int i = 0; i < numRows; ++i) {
+        fRows[i].fIndex = firstRow + i;
+    }
+}
+
+GrTextureStripAtlas::Page::~Page() {
+    SkSafeUnref(fTexture);
+    SkDELETE_ARRAY(fRows);
+}
+
+GrTextureStripAtlas::GrTextureStripAtlas(GrTextureStripAtlas::Desc desc)
+    : fLockedRows(0)
+    , fDesc(desc)
+    , fRowsPerPage(desc.fHeight / desc.fRowHeight)
     , fLRUFront(NULL)
     , fLRUBack(NULL) {
-    SkASSERT(fNumRows * fDesc.fRowHeight == fDesc.fHeight);
-    this->initLRU();
+    SkASSERT(fRowsPerPage * fDesc.fRowHeight == fDesc.fHeight);
     fNormalizedYHeight = SK_Scalar1 / fDesc.fHeight;
     VALIDATE;
 }
 
 GrTextureStripAtlas::~GrTextureStripAtlas() {
-    SkDELETE_ARRAY(fRows);
+    fPages.deleteAll();
 }
 
 int GrTextureStripAtlas::lockRow(const SkBitmap& data) {
     VALIDATE;
     if (0 == fLockedRows) {
-        this->lockTexture();
-        if (!fTexture) {
+        if (!this->lockTexture()) {
             return -1;
         }
     }
@@ -108,9 +122,7 @@ int GrTextureStripAtlas::lockRow(const SkBitmap& data) {
         ++row->fLocks;
         ++fLockedRows;
 
-        // Since all the rows are always stored in a contiguous array, we can save the memory
-        // required for storing row numbers and just compute it with some pointer arithmetic
-        rowNumber = static_cast<int>(row - fRows);
+        rowNumber = row->fIndex;
     } else {
         // ~index is the index where we will insert the new key to keep things sorted
         index = ~index;
@@ -121,11 +133,17 @@ int GrTextureStripAtlas::lockRow(const SkBitmap& data) {
         ++fLockedRows;
 
         if (NULL == row) {
-            // force a flush, which should unlock all the rows; then try again
-            fDesc.fContext->flush();
+            // Every row is in use. Grow by a page if we can; otherwise force a flush, which
+            // should unlock all the rows, and try again.
+            if (!this->addPage()) {
+                fDesc.fContext->flush();
+            }
             row = this->getLRU();
             if (NULL == row) {
                 --fLockedRows;
+                if (0 == fLockedRows) {
+                    this->unlockTexture();
+                }
                 return -1;
             }
         }
@@ -151,13 +169,13 @@ int GrTextureStripAtlas::lockRow(const SkBitmap& data) {
         row->fKey = key;
         row->fLocks = 1;
         fKeyTable.insert(index, 1, &row);
-        rowNumber = static_cast<int>(row - fRows);
+        rowNumber = row->fIndex;
 
         SkAutoLockPixels lock(data);
 
         // Pass in the kDontFlush flag, since we know we're writing to a part of this texture
         // that is not currently in use
-        fTexture->writePixels(0,  rowNumber * fDesc.fRowHeight,
+        this->getTexture(rowNumber)->writePixels(0, (rowNumber % fRowsPerPage) * fDesc.fRowHeight,
                               fDesc.fWidth, fDesc.fRowHeight,
                               SkImageInfo2GrPixelConfig(data.info()),
                               data.getPixels(),
@@ -172,11 +190,12 @@ int GrTextureStripAtlas::lockRow(const SkBitmap& data) {
 
 void GrTextureStripAtlas::unlockRow(int row) {
     VALIDATE;
-    --fRows[row].fLocks;
+    AtlasRow* atlasRow = this->getRow(row);
+    --atlasRow->fLocks;
     --fLockedRows;
-    SkASSERT(fRows[row].fLocks >= 0 && fLockedRows >= 0);
-    if (0 == fRows[row].fLocks) {
-        this->appendLRU(fRows + row);
+    SkASSERT(atlasRow->fLocks >= 0 && fLockedRows >= 0);
+    if (0 == atlasRow->fLocks) {
+        this->appendLRU(atlasRow);
     }
     if (0 == fLockedRows) {
         this->unlockTexture();
@@ -190,7 +209,23 @@ GrTextureStripAtlas::AtlasRow* GrTextureStripAtlas::getLRU() {
     return row;
 }
 
-void GrTextureStripAtlas::lockTexture() {
+bool GrTextureStripAtlas::lockTexture() {
+    if (fPages.isEmpty()) {
+        return this->addPage();
+    }
+    for (int i = 0; i < fPages.count(); ++i) {
+        if (!this->lockPageTexture(fPages[i])) {
+            for (int j = 0; j < i; ++j) {
+                fPages[j]->fTexture->unref();
+                fPages[j]->fTexture = NULL;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GrTextureStripAtlas::lockPageTexture(Page* page) {
     GrSurfaceDesc texDesc;
     texDesc.fWidth = fDesc.fWidth;
     texDesc.fHeight = fDesc.fHeight;
@@ -199,41 +234,57 @@ void GrTextureStripAtlas::lockTexture() {
     static const GrUniqueKey::Domain kDomain = GrUniqueKey::GenerateDomain();
     GrUniqueKey key;
     GrUniqueKey::Builder builder(&key, kDomain, 1);
-    builder[0] = static_cast<uint32_t>(fCacheKey);
+    builder[0] = static_cast<uint32_t>(page->fCacheKey);
     builder.finish();
 
-    fTexture = fDesc.fContext->textureProvider()->findAndRefTextureByUniqueKey(key);
-    if (NULL == fTexture) {
-        fTexture = fDesc.fContext->textureProvider()->createTexture(texDesc, true, NULL, 0);
-        if (!fTexture) {
-            return;
+    SkASSERT(NULL == page->fTexture);
+    page->fTexture = fDesc.fContext->textureProvider()->findAndRefTextureByUniqueKey(key);
+    if (NULL == page->fTexture) {
+        page->fTexture = fDesc.fContext->textureProvider()->createTexture(texDesc, true, NULL, 0);
+        if (!page->fTexture) {
+            return false;
         }
-        fDesc.fContext->textureProvider()->assignUniqueKeyToTexture(key, fTexture);
-        // This is a new texture, so all of our cache info is now invalid
-        this->initLRU();
-        fKeyTable.rewind();
+        fDesc.fContext->textureProvider()->assignUniqueKeyToTexture(key, page->fTexture);
+        // This is a new texture, so the cache info for this page is now invalid
+        this->invalidatePage(page);
     }
-    SkASSERT(fTexture);
+    return true;
 }
 
 void GrTextureStripAtlas::unlockTexture() {
-    SkASSERT(fTexture && 0 == fLockedRows);
-    fTexture->unref();
-    fTexture = NULL;
+    SkASSERT(0 == fLockedRows);
+    for (int i = 0; i < fPages.count(); ++i) {
+        SkASSERT(fPages[i]->fTexture);
+        fPages[i]->fTexture->unref();
+        fPages[i]->fTexture = NULL;
+    }
 }
 
-void GrTextureStripAtlas::initLRU() {
-    fLRUFront = NULL;
-    fLRUBack = NULL;
-    // Initially all the rows are in the LRU list
-    for (int i = 0; i < fNumRows; ++i) {
-        fRows[i].fKey = kEmptyAtlasRowKey;
-        fRows[i].fNext = NULL;
-        fRows[i].fPrev = NULL;
-        this->appendLRU(fRows + i);
+bool GrTextureStripAtlas::addPage() {
+    if (fPages.count() >= kMaxPages) {
+        return false;
+    }
+    Page* page = SkNEW_ARGS(Page, (fPages.count() * fRowsPerPage, fRowsPerPage));
+    if (!this->lockPageTexture(page)) {
+        SkDELETE(page);
+        return false;
+    }
+    *fPages.append() = page;
+    for (int i = 0; i < fRowsPerPage; ++i) {
+        this->appendLRU(page->fRows + i);
+    }
+    return true;
+}
+
+void GrTextureStripAtlas::invalidatePage(Page* page) {
+    for (int i = 0; i < fRowsPerPage; ++i) {
+        AtlasRow* row = page->fRows + i;
+        SkASSERT(0 == row->fLocks);
+        if (kEmptyAtlasRowKey != row->fKey) {
+            fKeyTable.remove(this->searchByKey(row->fKey));
+            row->fKey = kEmptyAtlasRowKey;
+        }
     }
-    SkASSERT(NULL == fLRUFront || NULL == fLRUFront->fPrev);
-    SkASSERT(NULL == fLRUBack || NULL == fLRUBack->fNext);
 }
 
 void GrTextureStripAtlas::appendLRU(AtlasRow* row) {
@@ -310,26 +361,30 @@ void GrTextureStripAtlas::validate() {
     int rowLocks = 0;
     int freeRows = 0;
 
-    for (int i = 0; i < fNumRows; ++i) {
-        rowLocks += fRows[i].fLocks;
-        if (0 == fRows[i].fLocks) {
-            ++freeRows;
-            bool inLRU = false;
-            // Step through the LRU and make sure it's present
-            for (AtlasRow* r = fLRUFront; r != NULL; r = r->fNext) {
-                if (r == &fRows[i]) {
-                    inLRU = true;
-                    break;
+    for (int p = 0; p < fPages.count(); ++p) {
+        for (int i = 0; i < fRowsPerPage; ++i) {
+            const AtlasRow& row = fPages[p]->fRows[i];
+            SkASSERT(p * fRowsPerPage + i == row.fIndex);
+            rowLocks += row.fLocks;
+            if (0 == row.fLocks) {
+                ++freeRows;
+                bool inLRU = false;
+                // Step through the LRU and make sure it's present
+                for (AtlasRow* r = fLRUFront; r != NULL; r = r->fNext) {
+                    if (r == &row) {
+                        inLRU = true;
+                        break;
+                    }
                 }
+                SkASSERT(inLRU);
+            } else {
+                // If we are locked, we should have a key
+                SkASSERT(kEmptyAtlasRowKey != row.fKey);
             }
-            SkASSERT(inLRU);
-        } else {
-            // If we are locked, we should have a key
-            SkASSERT(kEmptyAtlasRowKey != fRows[i].fKey);
-        }
 
-        // If we have a key != kEmptyAtlasRowKey, it should be in the key table
-        SkASSERT(fRows[i].fKey == kEmptyAtlasRowKey || this->searchByKey(fRows[i].fKey) >= 0);
+            // If we have a key != kEmptyAtlasRowKey, it should be in the key table
+            SkASSERT(row.fKey == kEmptyAtlasRowKey || this->searchByKey(row.fKey) >= 0);
+        }
     }
 
     // Our count of locks should equal the sum of row locks, unless we ran out of rows and flushed,
@@ -340,12 +395,14 @@ void GrTextureStripAtlas::validate() {
     // We should have one lru entry for each free row
     SkASSERT(freeRows == lruCount);
 
-    // If we have locked rows, we should have a locked texture, otherwise
-    // it should be unlocked
-    if (fLockedRows == 0) {
-        SkASSERT(NULL == fTexture);
-    } else {
-        SkASSERT(fTexture);
+    // If we have locked rows, we should have locked textures, otherwise
+    // they should be unlocked
+    for (int p = 0; p < fPages.count(); ++p) {
+        if (fLockedRows == 0) {
+            SkASSERT(NULL == fPages[p]->fTexture);
+        } else {
+            SkASSERT(fPages[p]->fTexture);
+        }
     }
 }
 #endif
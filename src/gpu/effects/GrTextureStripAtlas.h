@@ -16,13 +16,16 @@
 #include "SkTypes.h"
 
 /**
- * Maintains a single large texture whose rows store many textures of a small fixed height,
- * stored in rows across the x-axis such that we can safely wrap/repeat them horizontally.
+ * Maintains large textures ("pages") whose rows store many textures of a small fixed height,
+ * stored in rows across the x-axis such that we can safely wrap/repeat them horizontally. When
+ * every row is locked the atlas grows by another page, up to kMaxPages, before falling back to
+ * a flush.
  */
 class GrTextureStripAtlas {
 public:
     /**
-     * Descriptor struct which we'll use as a hash table key
+     * Descriptor struct which we'll use as a hash table key. Descriptors that differ only in
+     * fHeight share an atlas; fHeight is the page height used when the atlas is first created.
      **/
     struct Desc {
         Desc() { sk_bzero(this, sizeof(*this)); }
@@ -52,8 +55,8 @@ public:
     void unlockRow(int row);
 
     /**
-     * These functions help turn an integer row index in [0, 1, 2, ... numRows] into a scalar y
-     * texture coordinate in [0, 1] that we can use in a shader.
+     * These functions help turn an integer row index returned by lockRow() into a scalar y
+     * texture coordinate in [0, 1] within that row's page, getTexture(row).
      *
      * If a regular texture access without using the atlas looks like:
      *
@@ -67,11 +70,16 @@ public:
      * atlas and scaleFactor, returned by getNormalizedTexelHeight, is the normalized height of
      * one texel row.
      */
-    SkScalar getYOffset(int row) const { return SkIntToScalar(row) / fNumRows; }
+    SkScalar getYOffset(int row) const { return SkIntToScalar(row % fRowsPerPage) / fRowsPerPage; }
     SkScalar getNormalizedTexelHeight() const { return fNormalizedYHeight; }
 
     GrContext* getContext() const { return fDesc.fContext; }
-    GrTexture* getTexture() const { return fTexture; }
+    GrTexture* getTexture(int row) const { return fPages[row / fRowsPerPage]->fTexture; }
+
+    int numPages() const { return fPages.count(); }
+
+    // The most pages a single atlas will grow to before it resorts to flushing.
+    static const int kMaxPages = 8;
 
 private:
 
@@ -83,9 +91,11 @@ private:
      * together to represent LRU status
      */
     struct AtlasRow : SkNoncopyable {
-        AtlasRow() : fKey(kEmptyAtlasRowKey), fLocks(0), fNext(NULL), fPrev(NULL) { }
+        AtlasRow() : fKey(kEmptyAtlasRowKey), fIndex(0), fLocks(0), fNext(NULL), fPrev(NULL) { }
         // GenerationID of the bitmap that is represented by this row, 0xffffffff means "empty"
         uint32_t fKey;
+        // Row number across all pages, as returned by lockRow()
+        int32_t fIndex;
         // How many times this has been locked (0 == unlocked)
         int32_t fLocks;
         // We maintain an LRU linked list between unlocked nodes with these pointers
@@ -93,18 +103,52 @@ private:
         AtlasRow* fPrev;
     };
 
+    /**
+     * One texture's worth of rows. Rows are never moved once allocated, so AtlasRow pointers
+     * remain valid as the atlas grows.
+     */
+    struct Page : SkNoncopyable {
+        Page(int firstRow, int numRows);
+        ~Page();
+
+        // A unique ID for this texture (formed with: gCacheCount++), so we can be sure that if
+        // we get a texture back from the texture cache, that it's the same one we last used.
+        const int32_t fCacheKey;
+        GrTexture* fTexture;
+        AtlasRow* fRows;
+    };
+
     /**
      * We'll only allow construction via the static GrTextureStripAtlas::GetAtlas
      */
     GrTextureStripAtlas(Desc desc);
 
-    void lockTexture();
+    /**
+     * Refs every page's texture, recreating any the resource cache has purged. Returns false if
+     * a texture could not be created, in which case nothing is left locked.
+     */
+    bool lockTexture();
     void unlockTexture();
 
     /**
-     * Initialize our LRU list (if one already exists, clear it and start anew)
+     * Refs (or creates) the texture for a page. A recreated texture invalidates the page's rows.
      */
-    void initLRU();
+    bool lockPageTexture(Page* page);
+
+    /**
+     * Adds a page of empty rows to the LRU list. Must be called with the textures locked.
+     * Returns false if we are at kMaxPages or the texture could not be created.
+     */
+    bool addPage();
+
+    /**
+     * Forget the contents of a page's rows, all of which must be unlocked.
+     */
+    void invalidatePage(Page* page);
+
+    AtlasRow* getRow(int row) {
+        return fPages[row / fRowsPerPage]->fRows + row % fRowsPerPage;
+    }
 
     /**
      * Grabs the least recently used free row out of the LRU list, returns NULL if no rows are free.
@@ -156,26 +200,19 @@ private:
 
     static Hash* GetCache();
 
-    // We increment gCacheCount for each atlas
+    // We increment gCacheCount for each atlas page
     static int32_t gCacheCount;
 
-    // A unique ID for this texture (formed with: gCacheCount++), so we can be sure that if we
-    // get a texture back from the texture cache, that it's the same one we last used.
-    const int32_t fCacheKey;
-
-    // Total locks on all rows (when this reaches zero, we can unlock our texture)
+    // Total locks on all rows (when this reaches zero, we can unlock our textures)
     int32_t fLockedRows;
 
     const Desc fDesc;
-    const uint16_t fNumRows;
-    GrTexture* fTexture;
+    const uint16_t fRowsPerPage;
 
     SkScalar fNormalizedYHeight;
 
-    // Array of AtlasRows which store the state of all our rows. Stored in a contiguous array, in
-    // order that they appear in our texture, this means we can subtract this pointer from a row
-    // pointer to get its index in the texture, and can save storing a row number in AtlasRow.
-    AtlasRow* fRows;
+    // The pages in the order they were added; row n lives in fPages[n / fRowsPerPage].
+    SkTDArray<Page*> fPages;
 
     // Head and tail for linked list of least-recently-used rows (front = least recently used).
     // Note that when a texture is locked, it gets removed from this list until it is unlocked.
@@ -23,7 +23,9 @@
 GrGLBufferImpl::GrGLBufferImpl(GrGLGpu* gpu, const Desc& desc, GrGLenum bufferType)
     : fDesc(desc)
     , fBufferType(bufferType)
-    , fMapPtr(NULL) {
+    , fMapPtr(NULL)
+    , fPersistentMapPtr(NULL) {
+    SkASSERT(!desc.fPersistent || (desc.fID && desc.fDynamic));
     if (0 == desc.fID) {
         fCPUData = sk_malloc_flags(desc.fSizeInBytes, SK_MALLOC_THROW);
         fGLSizeInBytes = 0;
@@ -52,6 +54,8 @@ void GrGLBufferImpl::release(GrGLGpu* gpu) {
         fDesc.fID = 0;
         fGLSizeInBytes = 0;
     }
+    // Deleting the buffer object implicitly unmaps persistent storage.
+    fPersistentMapPtr = NULL;
     fMapPtr = NULL;
     VALIDATE();
 }
@@ -60,6 +64,7 @@ void GrGLBufferImpl::abandon() {
     fDesc.fID = 0;
     fGLSizeInBytes = 0;
     fMapPtr = NULL;
+    fPersistentMapPtr = NULL;
     sk_free(fCPUData);
     fCPUData = NULL;
     VALIDATE();
@@ -81,6 +86,19 @@ void* GrGLBufferImpl::map(GrGLGpu* gpu) {
     SkASSERT(!this->isMapped());
     if (0 == fDesc.fID) {
         fMapPtr = fCPUData;
+    } else if (fDesc.fPersistent) {
+        // Persistent storage is mapped once and stays mapped until the buffer is deleted. Writes
+        // are coherent so the caller only has to make sure the GPU is done with what it replaces.
+        if (NULL == fPersistentMapPtr) {
+            this->bind(gpu);
+            static const GrGLbitfield kAccess = GR_GL_MAP_WRITE_BIT |
+                                                GR_GL_MAP_PERSISTENT_BIT |
+                                                GR_GL_MAP_COHERENT_BIT;
+            GR_GL_CALL_RET(gpu->glInterface(),
+                           fPersistentMapPtr,
+                           MapBufferRange(fBufferType, 0, fGLSizeInBytes, kAccess));
+        }
+        fMapPtr = fPersistentMapPtr;
     } else {
         switch (gpu->glCaps().mapBufferType()) {
             case GrGLCaps::kNone_MapBufferType:
@@ -136,7 +154,7 @@ void* GrGLBufferImpl::map(GrGLGpu* gpu) {
 void GrGLBufferImpl::unmap(GrGLGpu* gpu) {
     VALIDATE();
     SkASSERT(this->isMapped());
-    if (0 != fDesc.fID) {
+    if (0 != fDesc.fID && !fDesc.fPersistent) {
         switch (gpu->glCaps().mapBufferType()) {
             case GrGLCaps::kNone_MapBufferType:
                 SkDEBUGFAIL("Shouldn't get here.");
@@ -170,6 +188,16 @@ bool GrGLBufferImpl::updateData(GrGLGpu* gpu, const void* src, size_t srcSizeInB
         memcpy(fCPUData, src, srcSizeInBytes);
         return true;
     }
+    if (fDesc.fPersistent) {
+        // Immutable storage can't be respecified with glBufferData, so write through the mapping.
+        void* dst = this->map(gpu);
+        if (NULL == dst) {
+            return false;
+        }
+        memcpy(dst, src, srcSizeInBytes);
+        this->unmap(gpu);
+        return true;
+    }
     this->bind(gpu);
     GrGLenum usage = fDesc.fDynamic ? DYNAMIC_USAGE_PARAM : GR_GL_STATIC_DRAW;
 
@@ -222,4 +250,6 @@ void GrGLBufferImpl::validate() const {
     SkASSERT(NULL == fCPUData || 0 == fGLSizeInBytes);
     SkASSERT(NULL == fMapPtr || fCPUData || fGLSizeInBytes == fDesc.fSizeInBytes);
     SkASSERT(NULL == fCPUData || NULL == fMapPtr || fCPUData == fMapPtr);
+    SkASSERT(NULL == fPersistentMapPtr || fDesc.fPersistent);
+    SkASSERT(!fDesc.fPersistent || NULL == fMapPtr || fPersistentMapPtr == fMapPtr);
 }
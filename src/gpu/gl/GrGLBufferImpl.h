@@ -23,6 +23,7 @@ public:
         GrGLuint    fID;            // set to 0 to indicate buffer is CPU-backed and not a VBO.
         size_t      fSizeInBytes;
         bool        fDynamic;
+        bool        fPersistent;    // storage was allocated with glBufferStorage and stays mapped.
     };
 
     GrGLBufferImpl(GrGLGpu*, const Desc&, GrGLenum bufferType);
@@ -51,6 +52,7 @@ private:
     GrGLenum     fBufferType; // GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER
     void*        fCPUData;
     void*        fMapPtr;
+    void*        fPersistentMapPtr;  // Non-NULL once a persistent buffer has been mapped.
     size_t       fGLSizeInBytes;     // In certain cases we make the size of the GL buffer object
                                      // smaller or larger than the size in fDesc.
 
@@ -26,11 +26,20 @@ GrGLCaps::GrGLCaps(const GrContextOptions& contextOptions,
     fMaxFragmentUniformVectors = 0;
     fMaxVertexAttributes = 0;
     fMaxFragmentTextureUnits = 0;
+    fUniformBufferOffsetAlignment = 0;
+    fMaxUniformBlockSize = 0;
     fRGBA8RenderbufferSupport = false;
     fBGRAIsInternalFormat = false;
     fTextureSwizzleSupport = false;
     fUnpackRowLengthSupport = false;
     fUnpackFlipYSupport = false;
+    fUnpackBufferSupport = false;
+    fPackBufferSupport = false;
+    fProgramBinarySupport = false;
+    fUniformBufferObjectSupport = false;
+    fMultiDrawIndirectSupport = false;
+    fDisjointTimerQuery = false;
+    fParallelShaderCompileSupport = false;
     fPackRowLengthSupport = false;
     fPackFlipYSupport = false;
     fTextureUsageSupport = false;
@@ -403,6 +412,14 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
         }
     }
 
+    // Persistently mapped buffers need immutable storage from glBufferStorage and sync objects to
+    // tell when the GPU has finished reading a range that is about to be rewritten.
+    if (kMapBufferRange_MapBufferType == fMapBufferType && !fUseNonVBOVertexAndIndexDynamicData &&
+        gli->fFunctions.fBufferStorage && gli->fFunctions.fFenceSync &&
+        gli->fFunctions.fClientWaitSync && gli->fFunctions.fDeleteSync) {
+        fMapBufferFlags |= kPersistent_MapFlag;
+    }
+
     // On many GPUs, map memory is very expensive, so we effectively disable it here by setting the
     // threshold to the maximum unless the client gives us a hint that map memory is cheap.
     if (fGeometryBufferMapThreshold < 0) {
@@ -416,6 +433,75 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
 #endif
     }
 
+    // The binary formats a driver reports may be empty even when the entry points exist.
+    if (gli->fFunctions.fGetProgramBinary && gli->fFunctions.fProgramBinary) {
+        GrGLint numFormats = 0;
+        GR_GL_GetIntegerv(gli, GR_GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        fProgramBinarySupport = numFormats > 0;
+    }
+
+    // Uniform blocks need GLSL 1.40 (or ESSL 3.00) to be declared without an extension directive.
+    if (gli->fFunctions.fBindBufferRange && gli->fFunctions.fGetUniformBlockIndex &&
+        gli->fFunctions.fUniformBlockBinding) {
+        if (kGL_GrGLStandard == standard) {
+            fUniformBufferObjectSupport = ctxInfo.glslGeneration() >= k140_GrGLSLGeneration;
+        } else {
+            fUniformBufferObjectSupport = ctxInfo.glslGeneration() >= k330_GrGLSLGeneration;
+        }
+    }
+    if (fUniformBufferObjectSupport) {
+        GR_GL_GetIntegerv(gli, GR_GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT,
+                          &fUniformBufferOffsetAlignment);
+        GR_GL_GetIntegerv(gli, GR_GL_MAX_UNIFORM_BLOCK_SIZE, &fMaxUniformBlockSize);
+        // The alignment must be a power of two. Don't trust a driver that says otherwise.
+        if (fUniformBufferOffsetAlignment <= 0 ||
+            !SkIsPow2(fUniformBufferOffsetAlignment) || fMaxUniformBlockSize <= 0) {
+            fUniformBufferObjectSupport = false;
+        }
+    }
+
+    // ES 3.1 only has single indirect draws, and they need a bound vertex array object, which we
+    // only use on core profiles.
+    if (kGL_GrGLStandard == standard && gli->fFunctions.fMultiDrawElementsIndirect) {
+        fMultiDrawIndirectSupport = version >= GR_GL_VER(4, 3) ||
+                                    ctxInfo.hasExtension("GL_ARB_multi_draw_indirect");
+    }
+
+    // ES only gets GL_TIME_ELAPSED from EXT_disjoint_timer_query, whose results must be discarded
+    // when GL_GPU_DISJOINT reports that the GPU's timer was disrupted.
+    if (gli->fFunctions.fGenQueries && gli->fFunctions.fDeleteQueries &&
+        gli->fFunctions.fBeginQuery && gli->fFunctions.fEndQuery &&
+        gli->fFunctions.fGetQueryObjectuiv && gli->fFunctions.fGetQueryObjectui64v) {
+        if (kGL_GrGLStandard == standard) {
+            fTimerQuerySupport = version >= GR_GL_VER(3, 3) ||
+                                 ctxInfo.hasExtension("GL_ARB_timer_query") ||
+                                 ctxInfo.hasExtension("GL_EXT_timer_query");
+        } else {
+            fTimerQuerySupport = ctxInfo.hasExtension("GL_EXT_disjoint_timer_query");
+            fDisjointTimerQuery = fTimerQuerySupport;
+        }
+    }
+
+    fParallelShaderCompileSupport = ctxInfo.hasExtension("GL_KHR_parallel_shader_compile") ||
+                                    ctxInfo.hasExtension("GL_ARB_parallel_shader_compile");
+
+    // Texture uploads through pixel unpack buffers are written with glMapBufferRange so that the
+    // unsynchronized and invalidate flags are available.
+    if (kMapBufferRange_MapBufferType == fMapBufferType) {
+        if (kGL_GrGLStandard == standard) {
+            fUnpackBufferSupport = version >= GR_GL_VER(2,1) ||
+                                   ctxInfo.hasExtension("GL_ARB_pixel_buffer_object");
+        } else {
+            fUnpackBufferSupport = version >= GR_GL_VER(3,0) ||
+                                   ctxInfo.hasExtension("GL_NV_pixel_buffer_object");
+        }
+    }
+
+    // Pixel buffer objects work in both directions. Reading back through one is only useful when
+    // a sync object can tell us that the GPU has written the pixels.
+    fPackBufferSupport = fUnpackBufferSupport && gli->fFunctions.fFenceSync &&
+                         gli->fFunctions.fClientWaitSync && gli->fFunctions.fDeleteSync;
+
     if (kGL_GrGLStandard == standard) {
         SkASSERT(ctxInfo.version() >= GR_GL_VER(2,0) ||
                  ctxInfo.hasExtension("GL_ARB_texture_non_power_of_two"));
@@ -498,6 +584,16 @@ void GrGLCaps::init(const GrContextOptions& contextOptions,
                  ctxInfo.hasExtension("GL_EXT_instanced_arrays"));
     }
 
+    // GL_OES_vertex_half_float uses a different enum (GR_GL_HALF_FLOAT_OES) for the attribute
+    // type than core GL and ES 3.0, so we only use half float attributes where GR_GL_HALF_FLOAT
+    // is accepted.
+    if (kGL_GrGLStandard == standard) {
+        fHalfFloatVertexAttributeSupport = version >= GR_GL_VER(3, 0) ||
+                                           ctxInfo.hasExtension("GL_ARB_half_float_vertex");
+    } else {
+        fHalfFloatVertexAttributeSupport = version >= GR_GL_VER(3, 0);
+    }
+
     this->initConfigTexturableTable(ctxInfo, gli, srgbSupport);
     this->initConfigRenderableTable(ctxInfo, srgbSupport);
     this->initShaderPrecisionTable(ctxInfo, gli, glslCaps);
@@ -1120,11 +1216,21 @@ SkString GrGLCaps::dump() const {
     r.appendf("Max FS Uniform Vectors: %d\n", fMaxFragmentUniformVectors);
     r.appendf("Max FS Texture Units: %d\n", fMaxFragmentTextureUnits);
     r.appendf("Max Vertex Attributes: %d\n", fMaxVertexAttributes);
+    r.appendf("Max Uniform Block Size: %d\n", fMaxUniformBlockSize);
     r.appendf("Support RGBA8 Render Buffer: %s\n", (fRGBA8RenderbufferSupport ? "YES": "NO"));
     r.appendf("BGRA is an internal format: %s\n", (fBGRAIsInternalFormat ? "YES": "NO"));
     r.appendf("Support texture swizzle: %s\n", (fTextureSwizzleSupport ? "YES": "NO"));
     r.appendf("Unpack Row length support: %s\n", (fUnpackRowLengthSupport ? "YES": "NO"));
     r.appendf("Unpack Flip Y support: %s\n", (fUnpackFlipYSupport ? "YES": "NO"));
+    r.appendf("Unpack buffer support: %s\n", (fUnpackBufferSupport ? "YES": "NO"));
+    r.appendf("Pack buffer support: %s\n", (fPackBufferSupport ? "YES": "NO"));
+    r.appendf("Program binary support: %s\n", (fProgramBinarySupport ? "YES": "NO"));
+    r.appendf("Uniform buffer object support: %s\n",
+              (fUniformBufferObjectSupport ? "YES": "NO"));
+    r.appendf("Multi draw indirect support: %s\n", (fMultiDrawIndirectSupport ? "YES": "NO"));
+    r.appendf("Disjoint timer query: %s\n", (fDisjointTimerQuery ? "YES": "NO"));
+    r.appendf("Parallel shader compile support: %s\n",
+              (fParallelShaderCompileSupport ? "YES": "NO"));
     r.appendf("Pack Row length support: %s\n", (fPackRowLengthSupport ? "YES": "NO"));
     r.appendf("Pack Flip Y support: %s\n", (fPackFlipYSupport ? "YES": "NO"));
 
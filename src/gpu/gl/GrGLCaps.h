@@ -198,6 +198,34 @@ public:
     /// Is there support for GL_UNPACK_FLIP_Y
     bool unpackFlipYSupport() const { return fUnpackFlipYSupport; }
 
+    /// Can texture data be uploaded from a GL_PIXEL_UNPACK_BUFFER
+    bool unpackBufferSupport() const { return fUnpackBufferSupport; }
+
+    /// Can pixels be read into a GL_PIXEL_PACK_BUFFER and fenced to read them back asynchronously
+    bool packBufferSupport() const { return fPackBufferSupport; }
+
+    /// Can linked programs be saved and reloaded with glGetProgramBinary / glProgramBinary
+    bool programBinarySupport() const { return fProgramBinarySupport; }
+
+    /// Can uniforms be sourced from std140 uniform blocks backed by buffers bound with
+    /// glBindBufferRange (GL 3.1 / ARB_uniform_buffer_object, ES 3.0)
+    bool uniformBufferObjectSupport() const { return fUniformBufferObjectSupport; }
+
+    /// Required alignment of the offset passed to glBindBufferRange for uniform buffers
+    int uniformBufferOffsetAlignment() const { return fUniformBufferOffsetAlignment; }
+
+    /// Largest uniform block, in bytes
+    int maxUniformBlockSize() const { return fMaxUniformBlockSize; }
+
+    /// Can consecutive indexed draws be submitted together with glMultiDrawElementsIndirect
+    bool multiDrawIndirectSupport() const { return fMultiDrawIndirectSupport; }
+
+    /// Must GL_GPU_DISJOINT be checked before trusting timer query results (EXT_disjoint_timer_query)
+    bool disjointTimerQuery() const { return fDisjointTimerQuery; }
+
+    /// Does the driver compile and link on its own threads (KHR/ARB_parallel_shader_compile)
+    bool parallelShaderCompileSupport() const { return fParallelShaderCompileSupport; }
+
     /// Is there support for GL_PACK_ROW_LENGTH
     bool packRowLengthSupport() const { return fPackRowLengthSupport; }
 
@@ -351,6 +379,8 @@ private:
     int fMaxFragmentUniformVectors;
     int fMaxVertexAttributes;
     int fMaxFragmentTextureUnits;
+    int fUniformBufferOffsetAlignment;
+    int fMaxUniformBlockSize;
 
     MSFBOType           fMSFBOType;
     InvalidateFBType    fInvalidateFBType;
@@ -362,6 +392,13 @@ private:
     bool fTextureSwizzleSupport : 1;
     bool fUnpackRowLengthSupport : 1;
     bool fUnpackFlipYSupport : 1;
+    bool fUnpackBufferSupport : 1;
+    bool fPackBufferSupport : 1;
+    bool fProgramBinarySupport : 1;
+    bool fUniformBufferObjectSupport : 1;
+    bool fMultiDrawIndirectSupport : 1;
+    bool fDisjointTimerQuery : 1;
+    bool fParallelShaderCompileSupport : 1;
     bool fPackRowLengthSupport : 1;
     bool fPackFlipYSupport : 1;
     bool fTextureUsageSupport : 1;
@@ -127,6 +127,7 @@ public:
     BufferManager   fBufferManager;
     GrGLuint        fCurrArrayBuffer;
     GrGLuint        fCurrElementArrayBuffer;
+    GrGLuint        fCurrPixelUnpackBuffer;
     GrGLuint        fCurrProgramID;
     GrGLuint        fCurrShaderID;
 
@@ -137,6 +138,7 @@ public:
     ThreadContext()
         : fCurrArrayBuffer(0)
         , fCurrElementArrayBuffer(0)
+        , fCurrPixelUnpackBuffer(0)
         , fCurrProgramID(0)
         , fCurrShaderID(0) {}
 
@@ -178,6 +180,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBufferData(GrGLenum target,
     case GR_GL_ELEMENT_ARRAY_BUFFER:
         id = ctx->fCurrElementArrayBuffer;
         break;
+    case GR_GL_PIXEL_UNPACK_BUFFER:
+        id = ctx->fCurrPixelUnpackBuffer;
+        break;
     default:
         SkFAIL("Unexpected target to nullGLBufferData");
         break;
@@ -221,6 +226,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLBindBuffer(GrGLenum target, GrGLuint buffer)
     case GR_GL_ELEMENT_ARRAY_BUFFER:
         ctx->fCurrElementArrayBuffer = buffer;
         break;
+    case GR_GL_PIXEL_UNPACK_BUFFER:
+        ctx->fCurrPixelUnpackBuffer = buffer;
+        break;
     }
 }
 
@@ -234,6 +242,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLDeleteBuffers(GrGLsizei n, const GrGLuint* id
         if (ids[i] == ctx->fCurrElementArrayBuffer) {
             ctx->fCurrElementArrayBuffer = 0;
         }
+        if (ids[i] == ctx->fCurrPixelUnpackBuffer) {
+            ctx->fCurrPixelUnpackBuffer = 0;
+        }
 
         BufferObj* buffer = ctx->fBufferManager.lookUp(ids[i]);
         ctx->fBufferManager.free(buffer);
@@ -251,6 +262,9 @@ GrGLvoid* GR_GL_FUNCTION_TYPE nullGLMapBufferRange(GrGLenum target, GrGLintptr o
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             id = ctx->fCurrElementArrayBuffer;
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            id = ctx->fCurrPixelUnpackBuffer;
+            break;
     }
 
     if (id > 0) {
@@ -273,6 +287,9 @@ GrGLvoid* GR_GL_FUNCTION_TYPE nullGLMapBuffer(GrGLenum target, GrGLenum access)
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             id = ctx->fCurrElementArrayBuffer;
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            id = ctx->fCurrPixelUnpackBuffer;
+            break;
     }
 
     if (id > 0) {
@@ -301,6 +318,9 @@ GrGLboolean GR_GL_FUNCTION_TYPE nullGLUnmapBuffer(GrGLenum target) {
     case GR_GL_ELEMENT_ARRAY_BUFFER:
         id = ctx->fCurrElementArrayBuffer;
         break;
+    case GR_GL_PIXEL_UNPACK_BUFFER:
+        id = ctx->fCurrPixelUnpackBuffer;
+        break;
     }
     if (id > 0) {
         BufferObj* buffer = ctx->fBufferManager.lookUp(id);
@@ -326,6 +346,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE nullGLGetBufferParameteriv(GrGLenum target, GrGLenu
                 case GR_GL_ELEMENT_ARRAY_BUFFER:
                     id = ctx->fCurrElementArrayBuffer;
                     break;
+                case GR_GL_PIXEL_UNPACK_BUFFER:
+                    id = ctx->fCurrPixelUnpackBuffer;
+                    break;
             }
             if (id > 0) {
                 BufferObj* buffer = ctx->fBufferManager.lookUp(id);
@@ -110,8 +110,13 @@
 #define GR_GL_ELEMENT_ARRAY_BUFFER           0x8893
 #define GR_GL_ARRAY_BUFFER_BINDING           0x8894
 #define GR_GL_ELEMENT_ARRAY_BUFFER_BINDING   0x8895
+#define GR_GL_PIXEL_PACK_BUFFER              0x88EB
+#define GR_GL_PIXEL_UNPACK_BUFFER            0x88EC
+#define GR_GL_UNIFORM_BUFFER                 0x8A11
+#define GR_GL_DRAW_INDIRECT_BUFFER           0x8F3F
 
 #define GR_GL_STREAM_DRAW                    0x88E0
+#define GR_GL_STREAM_READ                    0x88E1
 #define GR_GL_STATIC_DRAW                    0x88E4
 #define GR_GL_DYNAMIC_DRAW                   0x88E8
 
@@ -428,6 +433,7 @@
 #define GR_GL_SHADER_TYPE                      0x8B4F
 #define GR_GL_DELETE_STATUS                    0x8B80
 #define GR_GL_LINK_STATUS                      0x8B82
+#define GR_GL_COMPLETION_STATUS                0x91B1
 #define GR_GL_VALIDATE_STATUS                  0x8B83
 #define GR_GL_ATTACHED_SHADERS                 0x8B85
 #define GR_GL_ACTIVE_UNIFORMS                  0x8B86
@@ -438,6 +444,9 @@
 #define GR_GL_CURRENT_PROGRAM                  0x8B8D
 #define GR_GL_MAX_FRAGMENT_UNIFORM_COMPONENTS  0x8B49
 #define GR_GL_MAX_VERTEX_UNIFORM_COMPONENTS    0x8B4A
+#define GR_GL_MAX_UNIFORM_BLOCK_SIZE           0x8A30
+#define GR_GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT  0x8A34
+#define GR_GL_INVALID_INDEX                    0xFFFFFFFF
 
 /* StencilFunction */
 #define GR_GL_NEVER                          0x0200
@@ -712,6 +721,18 @@
 #define GR_GL_MAP_INVALIDATE_BUFFER_BIT          0x0008
 #define GR_GL_MAP_FLUSH_EXPLICIT_BIT             0x0010
 #define GR_GL_MAP_UNSYNCHRONIZED_BIT             0x0020
+#define GR_GL_MAP_PERSISTENT_BIT                 0x0040
+#define GR_GL_MAP_COHERENT_BIT                   0x0080
+#define GR_GL_DYNAMIC_STORAGE_BIT                0x0100
+#define GR_GL_CLIENT_STORAGE_BIT                 0x0200
+
+/* Sync Objects */
+#define GR_GL_SYNC_GPU_COMMANDS_COMPLETE         0x9117
+#define GR_GL_SYNC_FLUSH_COMMANDS_BIT            0x00000001
+#define GR_GL_ALREADY_SIGNALED                   0x911A
+#define GR_GL_TIMEOUT_EXPIRED                    0x911B
+#define GR_GL_CONDITION_SATISFIED                0x911C
+#define GR_GL_WAIT_FAILED                        0x911D
 
 /* Read Format */
 #define GR_GL_IMPLEMENTATION_COLOR_READ_TYPE   0x8B9A
@@ -727,6 +748,12 @@
 #define GR_GL_SHADER_BINARY_FORMATS          0x8DF8
 #define GR_GL_NUM_SHADER_BINARY_FORMATS      0x8DF9
 
+/* Program Binary */
+#define GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GR_GL_PROGRAM_BINARY_LENGTH          0x8741
+#define GR_GL_NUM_PROGRAM_BINARY_FORMATS     0x87FE
+#define GR_GL_PROGRAM_BINARY_FORMATS         0x87FF
+
 /* Shader Precision-Specified Types */
 #define GR_GL_LOW_FLOAT                      0x8DF0
 #define GR_GL_MEDIUM_FLOAT                   0x8DF1
@@ -744,6 +771,7 @@
 #define GR_GL_ANY_SAMPLES_PASSED             0x8C2F
 #define GR_GL_TIME_ELAPSED                   0x88BF
 #define GR_GL_TIMESTAMP                      0x8E28
+#define GR_GL_GPU_DISJOINT                   0x8FBB
 #define GR_GL_PRIMITIVES_GENERATED           0x8C87
 #define GR_GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN 0x8C88
 
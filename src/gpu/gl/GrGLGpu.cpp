@@ -19,6 +19,7 @@
 #include "GrVertices.h"
 #include "builders/GrGLShaderStringBuilder.h"
 #include "glsl/GrGLSLCaps.h"
+#include "SkChecksum.h"
 #include "SkStrokeRec.h"
 #include "SkTemplates.h"
 
@@ -173,16 +174,20 @@ GrGpu* GrGLGpu::Create(GrBackendContext backendContext, const GrContextOptions&
     }
     GrGLContext* glContext = GrGLContext::Create(glInterface, options);
     if (glContext) {
-        return SkNEW_ARGS(GrGLGpu, (glContext, context));
+        return SkNEW_ARGS(GrGLGpu, (glContext, options, context));
     }
     return NULL;
 }
 
 static bool gPrintStartupSpew;
 
-GrGLGpu::GrGLGpu(GrGLContext* ctx, GrContext* context)
+GrGLGpu::GrGLGpu(GrGLContext* ctx, const GrContextOptions& options, GrContext* context)
     : GrGpu(context)
-    , fGLContext(ctx) {
+    , fGLContext(ctx)
+    , fPersistentCache(NULL)
+    , fDriverHash(0)
+    , fAllowPendingPrograms(options.fAllowPendingPrograms &&
+                            ctx->caps()->parallelShaderCompileSupport()) {
     SkASSERT(ctx);
     fCaps.reset(SkRef(ctx->caps()));
 
@@ -209,6 +214,19 @@ GrGLGpu::GrGLGpu(GrGLContext* ctx, GrContext* context)
 
     fProgramCache = SkNEW_ARGS(ProgramCache, (this));
 
+    if (options.fPersistentCache && this->glCaps().programBinarySupport()) {
+        fPersistentCache = options.fPersistentCache;
+        const GrGLenum strings[] = { GR_GL_VENDOR, GR_GL_RENDERER, GR_GL_VERSION };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(strings); ++i) {
+            const GrGLubyte* str;
+            GL_CALL_RET(str, GetString(strings[i]));
+            if (str) {
+                const char* cstr = reinterpret_cast<const char*>(str);
+                fDriverHash = SkChecksum::Murmur3(cstr, strlen(cstr), fDriverHash);
+            }
+        }
+    }
+
     SkASSERT(this->glCaps().maxVertexAttributes() >= GrGeometryProcessor::kMaxVertexAttribs);
 
     fLastSuccessfulStencilFmtIdx = 0;
@@ -216,6 +234,12 @@ GrGLGpu::GrGLGpu(GrGLContext* ctx, GrContext* context)
     fTempSrcFBOID = 0;
     fTempDstFBOID = 0;
     fStencilClearFBOID = 0;
+    memset(fUploadBuffers.fIDs, 0, sizeof(fUploadBuffers.fIDs));
+    fUploadBuffers.fCurr = 0;
+    fUploadBuffers.fOffset = 0;
+    fUniformBuffers.init(GR_GL_UNIFORM_BUFFER);
+    fIndirectBuffers.init(GR_GL_DRAW_INDIRECT_BUFFER);
+    fHWUniformBlock.invalidate();
 
     if (this->glCaps().shaderCaps()->pathRenderingSupport()) {
         fPathRendering.reset(new GrGLPathRendering(this));
@@ -245,6 +269,27 @@ GrGLGpu::~GrGLGpu() {
         GL_CALL(DeleteBuffers(1, &fCopyProgram.fArrayBuffer));
     }
 
+    for (int i = 0; i < kUploadBufferCount; ++i) {
+        if (0 != fUploadBuffers.fIDs[i]) {
+            GL_CALL(DeleteBuffers(1, &fUploadBuffers.fIDs[i]));
+        }
+    }
+    for (int i = 0; i < kStreamBufferCount; ++i) {
+        if (0 != fUniformBuffers.fIDs[i]) {
+            GL_CALL(DeleteBuffers(1, &fUniformBuffers.fIDs[i]));
+        }
+        if (0 != fIndirectBuffers.fIDs[i]) {
+            GL_CALL(DeleteBuffers(1, &fIndirectBuffers.fIDs[i]));
+        }
+    }
+
+    if (fFreeTimerQueries.count()) {
+        GL_CALL(DeleteQueries(fFreeTimerQueries.count(), fFreeTimerQueries.begin()));
+    }
+    while (fAsyncReads.count()) {
+        this->endAsyncReadPixels((GrAsyncRead)(intptr_t)fAsyncReads.top());
+    }
+
     if (0 != fCopyProgram.fProgram) {
         GL_CALL(DeleteProgram(fCopyProgram.fProgram));
     }
@@ -261,6 +306,14 @@ void GrGLGpu::contextAbandoned() {
     fStencilClearFBOID = 0;
     fCopyProgram.fArrayBuffer = 0;
     fCopyProgram.fProgram = 0;
+    memset(fUploadBuffers.fIDs, 0, sizeof(fUploadBuffers.fIDs));
+    fUploadBuffers.fOffset = 0;
+    // Programs may still hold ranges in the abandoned buffers.
+    fUniformBuffers.abandon();
+    fIndirectBuffers.abandon();
+    fFreeTimerQueries.reset();
+    fAsyncReads.deleteAll();
+    fHWUniformBlock.invalidate();
     if (this->glCaps().shaderCaps()->pathRenderingSupport()) {
         this->glPathRendering()->abandonGpuResources();
     }
@@ -378,10 +431,15 @@ void GrGLGpu::onResetContext(uint32_t resetBits) {
         if (this->glCaps().packFlipYSupport()) {
             GL_CALL(PixelStorei(GR_GL_PACK_REVERSE_ROW_ORDER, GR_GL_FALSE));
         }
+        // We only bind an unpack buffer for the duration of an upload.
+        if (this->glCaps().unpackBufferSupport()) {
+            GL_CALL(BindBuffer(GR_GL_PIXEL_UNPACK_BUFFER, 0));
+        }
     }
 
     if (resetBits & kProgram_GrGLBackendState) {
         fHWProgramID = 0;
+        fHWUniformBlock.invalidate();
     }
 }
 
@@ -679,6 +737,8 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
     bool restoreGLRowLength = false;
     bool swFlipY = false;
     bool glFlipY = false;
+    const bool hasData = SkToBool(data);
+    bool staged = false;
     if (data) {
         if (kBottomLeft_GrSurfaceOrigin == desc.fOrigin) {
             if (this->glCaps().unpackFlipYSupport()) {
@@ -687,7 +747,38 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
                 swFlipY = true;
             }
         }
-        if (this->glCaps().unpackRowLengthSupport() && !swFlipY) {
+        size_t stagedOffset;
+        char* stagedDst = (char*)this->mapUploadBuffer(height * trimRowBytes, &stagedOffset);
+        if (stagedDst) {
+            // Trim (and flip, if needed) while copying into the upload buffer. GL then reads
+            // the pixels from the bound buffer, at the offset passed in place of a pointer.
+            const char* src = (const char*)data;
+            if (swFlipY) {
+                src += (height - 1) * rowBytes;
+            }
+            for (int y = 0; y < height; y++) {
+                memcpy(stagedDst, src, trimRowBytes);
+                if (swFlipY) {
+                    src -= rowBytes;
+                } else {
+                    src += rowBytes;
+                }
+                stagedDst += trimRowBytes;
+            }
+            GrGLboolean unmapped;
+            GL_CALL_RET(unmapped, UnmapBuffer(GR_GL_PIXEL_UNPACK_BUFFER));
+            if (unmapped) {
+                data = reinterpret_cast<const void*>(stagedOffset);
+                staged = true;
+            } else {
+                // The buffer's contents were lost (e.g. on a mode switch); upload from
+                // client memory below.
+                GL_CALL(BindBuffer(GR_GL_PIXEL_UNPACK_BUFFER, 0));
+            }
+        }
+        if (staged) {
+            // The staged copy is already trimmed and flipped.
+        } else if (this->glCaps().unpackRowLengthSupport() && !swFlipY) {
             // can't use this for flipping, only non-neg values allowed. :(
             if (rowBytes != trimRowBytes) {
                 GrGLint rowLength = static_cast<GrGLint>(rowBytes / bpp);
@@ -750,7 +841,7 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
         } else {
             // if we have data and we used TexStorage to create the texture, we
             // now upload with TexSubImage.
-            if (data && useTexStorage) {
+            if (hasData && useTexStorage) {
                 GL_CALL(TexSubImage2D(GR_GL_TEXTURE_2D,
                                       0, // level
                                       left, top,
@@ -770,6 +861,9 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
                               externalFormat, externalType, data));
     }
 
+    if (staged) {
+        GL_CALL(BindBuffer(GR_GL_PIXEL_UNPACK_BUFFER, 0));
+    }
     if (restoreGLRowLength) {
         SkASSERT(this->glCaps().unpackRowLengthSupport());
         GL_CALL(PixelStorei(GR_GL_UNPACK_ROW_LENGTH, 0));
@@ -780,6 +874,115 @@ bool GrGLGpu::uploadTexData(const GrSurfaceDesc& desc,
     return succeeded;
 }
 
+void* GrGLGpu::mapUploadBuffer(size_t size, size_t* offset) {
+    if (!this->glCaps().unpackBufferSupport() ||
+        size < kMinStagedUploadSize || size > kUploadBufferSize) {
+        return NULL;
+    }
+
+    // Keep each staged upload 16 byte aligned, which satisfies any unpack alignment.
+    size_t start = (fUploadBuffers.fOffset + 15) & ~(size_t)15;
+    bool orphan = false;
+    if (start + size > kUploadBufferSize) {
+        fUploadBuffers.fCurr = (fUploadBuffers.fCurr + 1) % kUploadBufferCount;
+        start = 0;
+        orphan = true;
+    }
+    GrGLuint* id = &fUploadBuffers.fIDs[fUploadBuffers.fCurr];
+    if (0 == *id) {
+        GL_CALL(GenBuffers(1, id));
+        if (0 == *id) {
+            return NULL;
+        }
+        start = 0;
+        orphan = true;
+    }
+
+    GL_CALL(BindBuffer(GR_GL_PIXEL_UNPACK_BUFFER, *id));
+    if (orphan) {
+        GL_CALL(BufferData(GR_GL_PIXEL_UNPACK_BUFFER, kUploadBufferSize, NULL,
+                           GR_GL_STREAM_DRAW));
+    }
+    void* ptr;
+    GL_CALL_RET(ptr, MapBufferRange(GR_GL_PIXEL_UNPACK_BUFFER, start, size,
+                                    GR_GL_MAP_WRITE_BIT | GR_GL_MAP_INVALIDATE_RANGE_BIT |
+                                    GR_GL_MAP_UNSYNCHRONIZED_BIT));
+    if (!ptr) {
+        GL_CALL(BindBuffer(GR_GL_PIXEL_UNPACK_BUFFER, 0));
+        return NULL;
+    }
+    fUploadBuffers.fOffset = start + size;
+    *offset = start;
+    return ptr;
+}
+
+int GrGLGpu::streamData(StreamBuffers* buffers, const void* data, size_t size,
+                        size_t alignment, size_t* offset) {
+    SkASSERT(size <= kStreamBufferSize);
+    SkASSERT(SkIsPow2(alignment));
+    size_t start = (buffers->fOffset + alignment - 1) & ~(alignment - 1);
+    bool orphan = false;
+    if (start + size > kStreamBufferSize) {
+        buffers->fCurr = (buffers->fCurr + 1) % kStreamBufferCount;
+        start = 0;
+        orphan = true;
+    }
+    int curr = buffers->fCurr;
+    GrGLuint* id = &buffers->fIDs[curr];
+    if (0 == *id) {
+        GL_CALL(GenBuffers(1, id));
+        if (0 == *id) {
+            return -1;
+        }
+        start = 0;
+        orphan = true;
+    }
+
+    GL_CALL(BindBuffer(buffers->fTarget, *id));
+    if (orphan) {
+        // Draws that haven't executed yet keep reading the old storage.
+        GL_CALL(BufferData(buffers->fTarget, kStreamBufferSize, NULL, GR_GL_STREAM_DRAW));
+        ++buffers->fGenerations[curr];
+    }
+    GL_CALL(BufferSubData(buffers->fTarget, start, size, data));
+    buffers->fOffset = start + size;
+    *offset = start;
+    return curr;
+}
+
+void GrGLGpu::flushUniformBlock(const void* data, size_t size, bool dirty,
+                                GrGLProgramDataManager::UniformBlockRange* range) {
+    SkASSERT(this->glCaps().uniformBufferObjectSupport());
+    SkASSERT(size > 0 && size <= kUniformBufferSize);
+
+    if (dirty || range->fBuffer < 0 ||
+        range->fGeneration != fUniformBuffers.fGenerations[range->fBuffer]) {
+        size_t offset;
+        range->fBuffer = this->streamData(&fUniformBuffers, data, size,
+                                          this->glCaps().uniformBufferOffsetAlignment(), &offset);
+        if (range->fBuffer < 0) {
+            return;
+        }
+        range->fGeneration = fUniformBuffers.fGenerations[range->fBuffer];
+        range->fOffset = offset;
+        range->fSize = size;
+    } else {
+        fStats.incSkippedUniformUploads();
+    }
+
+    GrGLuint id = fUniformBuffers.fIDs[range->fBuffer];
+    if (fHWUniformBlock.fID == id && fHWUniformBlock.fOffset == range->fOffset &&
+        fHWUniformBlock.fSize == range->fSize) {
+        fStats.incSkippedBufferBinds();
+        return;
+    }
+    GL_CALL(BindBufferRange(GR_GL_UNIFORM_BUFFER, kUniformBlockBinding, id, range->fOffset,
+                            range->fSize));
+    fHWUniformBlock.fID = id;
+    fHWUniformBlock.fOffset = range->fOffset;
+    fHWUniformBlock.fSize = range->fSize;
+}
+
 // TODO: This function is using a lot of wonky semantics like, if width == -1
 // then set width = desc.fWdith ... blah. A better way to do it might be to
 // create a CompressedTexData struct that takes a desc/ptr and figures out
@@ -1362,6 +1565,7 @@ bool GrGLGpu::attachStencilAttachmentToRenderTarget(GrStencilAttachment* sb, GrR
 GrVertexBuffer* GrGLGpu::onCreateVertexBuffer(size_t size, bool dynamic) {
     GrGLVertexBuffer::Desc desc;
     desc.fDynamic = dynamic;
+    desc.fPersistent = false;
     desc.fSizeInBytes = size;
 
     if (this->glCaps().useNonVBOVertexAndIndexDynamicData() && desc.fDynamic) {
@@ -1394,6 +1598,7 @@ GrVertexBuffer* GrGLGpu::onCreateVertexBuffer(size_t size, bool dynamic) {
 GrIndexBuffer* GrGLGpu::onCreateIndexBuffer(size_t size, bool dynamic) {
     GrGLIndexBuffer::Desc desc;
     desc.fDynamic = dynamic;
+    desc.fPersistent = false;
     desc.fSizeInBytes = size;
 
     if (this->glCaps().useNonVBOVertexAndIndexDynamicData() && desc.fDynamic) {
@@ -1423,6 +1628,61 @@ GrIndexBuffer* GrGLGpu::onCreateIndexBuffer(size_t size, bool dynamic) {
     }
 }
 
+// Persistent buffers get immutable storage that can stay mapped, coherently, while draws read it.
+static const GrGLbitfield kPersistentStorageFlags = GR_GL_MAP_WRITE_BIT |
+                                                    GR_GL_MAP_PERSISTENT_BIT |
+                                                    GR_GL_MAP_COHERENT_BIT;
+
+GrVertexBuffer* GrGLGpu::onCreatePersistentVertexBuffer(size_t size) {
+    GrGLVertexBuffer::Desc desc;
+    desc.fDynamic = true;
+    desc.fPersistent = true;
+    desc.fSizeInBytes = size;
+
+    GL_CALL(GenBuffers(1, &desc.fID));
+    if (!desc.fID) {
+        return NULL;
+    }
+    fHWGeometryState.setVertexBufferID(this, desc.fID);
+    CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
+    GL_ALLOC_CALL(this->glInterface(),
+                  BufferStorage(GR_GL_ARRAY_BUFFER,
+                                (GrGLsizeiptr) desc.fSizeInBytes,
+                                NULL,   // data ptr
+                                kPersistentStorageFlags));
+    if (CHECK_ALLOC_ERROR(this->glInterface()) != GR_GL_NO_ERROR) {
+        GL_CALL(DeleteBuffers(1, &desc.fID));
+        this->notifyVertexBufferDelete(desc.fID);
+        return NULL;
+    }
+    return SkNEW_ARGS(GrGLVertexBuffer, (this, desc));
+}
+
+GrIndexBuffer* GrGLGpu::onCreatePersistentIndexBuffer(size_t size) {
+    GrGLIndexBuffer::Desc desc;
+    desc.fDynamic = true;
+    desc.fPersistent = true;
+    desc.fSizeInBytes = size;
+
+    GL_CALL(GenBuffers(1, &desc.fID));
+    if (!desc.fID) {
+        return NULL;
+    }
+    fHWGeometryState.setIndexBufferIDOnDefaultVertexArray(this, desc.fID);
+    CLEAR_ERROR_BEFORE_ALLOC(this->glInterface());
+    GL_ALLOC_CALL(this->glInterface(),
+                  BufferStorage(GR_GL_ELEMENT_ARRAY_BUFFER,
+                                (GrGLsizeiptr) desc.fSizeInBytes,
+                                NULL,  // data ptr
+                                kPersistentStorageFlags));
+    if (CHECK_ALLOC_ERROR(this->glInterface()) != GR_GL_NO_ERROR) {
+        GL_CALL(DeleteBuffers(1, &desc.fID));
+        this->notifyIndexBufferDelete(desc.fID);
+        return NULL;
+    }
+    return SkNEW_ARGS(GrGLIndexBuffer, (this, desc));
+}
+
 void GrGLGpu::flushScissor(const GrScissorState& scissorState,
                            const GrGLIRect& rtViewport,
                            GrSurfaceOrigin rtOrigin) {
@@ -1472,6 +1732,8 @@ bool GrGLGpu::flushGLState(const DrawArgs& args) {
     if (fHWProgramID != programID) {
         GL_CALL(UseProgram(programID));
         fHWProgramID = programID;
+    } else {
+        fStats.incSkippedProgramBinds();
     }
 
     if (blendInfo.fWriteColor) {
@@ -1502,6 +1764,13 @@ bool GrGLGpu::flushGLState(const DrawArgs& args) {
 void GrGLGpu::setupGeometry(const GrPrimitiveProcessor& primProc,
                             const GrNonInstancedVertices& vertices,
                             size_t* indexOffsetInBytes) {
+    this->setupGeometry(primProc, vertices, vertices.startVertex(), indexOffsetInBytes);
+}
+
+void GrGLGpu::setupGeometry(const GrPrimitiveProcessor& primProc,
+                            const GrNonInstancedVertices& vertices,
+                            int startVertex,
+                            size_t* indexOffsetInBytes) {
     GrGLVertexBuffer* vbuf;
     vbuf = (GrGLVertexBuffer*) vertices.vertexBuffer();
 
@@ -1527,17 +1796,44 @@ void GrGLGpu::setupGeometry(const GrPrimitiveProcessor& primProc,
 
         GrGLsizei stride = static_cast<GrGLsizei>(primProc.getVertexStride());
 
-        size_t vertexOffsetInBytes = stride * vertices.startVertex();
+        size_t vertexOffsetInBytes = stride * startVertex;
 
         vertexOffsetInBytes += vbuf->baseOffset();
 
+        // Per-instance attribs are sourced from their own buffer with their own stride.
+        GrGLVertexBuffer* instBuf = (GrGLVertexBuffer*) vertices.instanceBuffer();
+        GrGLsizei instanceStride = static_cast<GrGLsizei>(primProc.getInstanceStride());
+        size_t instanceOffsetInBytes = 0;
+        if (instBuf) {
+            SkASSERT(vertices.isHWInstanced());
+            SkASSERT(!instBuf->isMapped());
+            instanceOffsetInBytes = instBuf->baseOffset() +
+                                    instanceStride * vertices.startInstance();
+        }
+
         uint32_t usedAttribArraysMask = 0;
         size_t offset = 0;
+        size_t instanceOffset = 0;
 
         for (int attribIndex = 0; attribIndex < vaCount; attribIndex++) {
             const GrGeometryProcessor::Attribute& attrib = primProc.getAttrib(attribIndex);
             usedAttribArraysMask |= (1 << attribIndex);
             GrVertexAttribType attribType = attrib.fType;
+            if (attrib.fPerInstance) {
+                SkASSERT(instBuf);
+                attribState->set(this,
+                                 attribIndex,
+                                 instBuf->bufferID(),
+                                 GrGLAttribTypeToLayout(attribType).fCount,
+                                 GrGLAttribTypeToLayout(attribType).fType,
+                                 GrGLAttribTypeToLayout(attribType).fNormalized,
+                                 instanceStride,
+                                 reinterpret_cast<GrGLvoid*>(instanceOffsetInBytes +
+                                                             instanceOffset),
+                                 1);
+                instanceOffset += attrib.fOffset;
+                continue;
+            }
             attribState->set(this,
                              attribIndex,
                              vbuf->bufferID(),
@@ -1783,12 +2079,13 @@ bool GrGLGpu::onGetReadPixelsInfo(GrSurface* srcSurface, int width, int height,
     return true;
 }
 
-bool GrGLGpu::onReadPixels(GrSurface* surface,
-                           int left, int top,
-                           int width, int height,
-                           GrPixelConfig config,
-                           void* buffer,
-                           size_t rowBytes) {
+bool GrGLGpu::setupReadPixels(GrSurface* surface,
+                              int left, int top,
+                              int width, int height,
+                              GrPixelConfig config,
+                              GrGLenum* format,
+                              GrGLenum* type,
+                              GrGLIRect* readRect) {
     SkASSERT(surface);
 
     GrGLRenderTarget* tgt = static_cast<GrGLRenderTarget*>(surface->asRenderTarget());
@@ -1801,17 +2098,14 @@ bool GrGLGpu::onReadPixels(GrSurface* surface,
         return false;
     }
 
-    GrGLenum format = 0;
-    GrGLenum type = 0;
-    bool flipY = kBottomLeft_GrSurfaceOrigin == surface->origin();
-    if (!this->configToGLFormats(config, false, NULL, &format, &type)) {
+    if (!this->configToGLFormats(config, false, NULL, format, type)) {
         return false;
     }
 
     // glReadPixels does not allow GL_SRGB_ALPHA. Instead use GL_RGBA. This will not trigger a
     // conversion when the src is srgb.
-    if (GR_GL_SRGB_ALPHA == format) {
-        format = GR_GL_RGBA;
+    if (GR_GL_SRGB_ALPHA == *format) {
+        *format = GR_GL_RGBA;
     }
 
     // resolve the render target if necessary
@@ -1835,8 +2129,24 @@ bool GrGLGpu::onReadPixels(GrSurface* surface,
     const GrGLIRect& glvp = tgt->getViewport();
 
     // the read rect is viewport-relative
+    readRect->setRelativeTo(glvp, left, top, width, height, tgt->origin());
+    return true;
+}
+
+bool GrGLGpu::onReadPixels(GrSurface* surface,
+                           int left, int top,
+                           int width, int height,
+                           GrPixelConfig config,
+                           void* buffer,
+                           size_t rowBytes) {
+    GrGLenum format = 0;
+    GrGLenum type = 0;
     GrGLIRect readRect;
-    readRect.setRelativeTo(glvp, left, top, width, height, tgt->origin());
+    if (!this->setupReadPixels(surface, left, top, width, height, config, &format, &type,
+                               &readRect)) {
+        return false;
+    }
+    bool flipY = kBottomLeft_GrSurfaceOrigin == surface->origin();
 
     size_t tightRowBytes = GrBytesPerPixel(config) * width;
 
@@ -1914,6 +2224,98 @@ bool GrGLGpu::onReadPixels(GrSurface* surface,
     return true;
 }
 
+GrAsyncRead GrGLGpu::onBeginAsyncReadPixels(GrSurface* surface,
+                                            int left, int top,
+                                            int width, int height,
+                                            GrPixelConfig config) {
+    if (!this->glCaps().packBufferSupport()) {
+        return 0;
+    }
+    GrGLenum format = 0;
+    GrGLenum type = 0;
+    GrGLIRect readRect;
+    if (!this->setupReadPixels(surface, left, top, width, height, config, &format, &type,
+                               &readRect)) {
+        return 0;
+    }
+
+    // Rows are padded to the default GL_PACK_ALIGNMENT of 4.
+    size_t rowBytes = SkAlign4(GrBytesPerPixel(config) * width);
+    GrGLuint buffer = 0;
+    GL_CALL(GenBuffers(1, &buffer));
+    if (!buffer) {
+        return 0;
+    }
+    GL_CALL(BindBuffer(GR_GL_PIXEL_PACK_BUFFER, buffer));
+    GL_CALL(BufferData(GR_GL_PIXEL_PACK_BUFFER, rowBytes * height, NULL, GR_GL_STREAM_READ));
+
+    bool flipY = kBottomLeft_GrSurfaceOrigin == surface->origin();
+    if (flipY && this->glCaps().packFlipYSupport()) {
+        GL_CALL(PixelStorei(GR_GL_PACK_REVERSE_ROW_ORDER, 1));
+    }
+    GL_CALL(ReadPixels(readRect.fLeft, readRect.fBottom,
+                       readRect.fWidth, readRect.fHeight,
+                       format, type, NULL));
+    if (flipY && this->glCaps().packFlipYSupport()) {
+        GL_CALL(PixelStorei(GR_GL_PACK_REVERSE_ROW_ORDER, 0));
+        flipY = false;
+    }
+    GL_CALL(BindBuffer(GR_GL_PIXEL_PACK_BUFFER, 0));
+
+    AsyncRead* read = SkNEW(AsyncRead);
+    read->fBuffer = buffer;
+    read->fFence = this->insertFence();
+    read->fHeight = height;
+    read->fRowBytes = rowBytes;
+    read->fFlipY = flipY;
+    read->fMapped = false;
+    *fAsyncReads.append() = read;
+    return (GrAsyncRead)(intptr_t)read;
+}
+
+bool GrGLGpu::isAsyncReadFinished(GrAsyncRead handle, uint64_t timeout) {
+    AsyncRead* read = (AsyncRead*)(intptr_t)handle;
+    return this->waitFence(read->fFence, timeout);
+}
+
+const void* GrGLGpu::mapAsyncReadPixels(GrAsyncRead handle, size_t* rowBytes) {
+    AsyncRead* read = (AsyncRead*)(intptr_t)handle;
+    SkASSERT(!read->fMapped);
+    size_t size = read->fRowBytes * read->fHeight;
+    GL_CALL(BindBuffer(GR_GL_PIXEL_PACK_BUFFER, read->fBuffer));
+    void* mapped;
+    GL_CALL_RET(mapped, MapBufferRange(GR_GL_PIXEL_PACK_BUFFER, 0, size, GR_GL_MAP_READ_BIT));
+    const char* pixels = static_cast<const char*>(mapped);
+    GL_CALL(BindBuffer(GR_GL_PIXEL_PACK_BUFFER, 0));
+    if (!pixels) {
+        return NULL;
+    }
+    read->fMapped = true;
+    *rowBytes = read->fRowBytes;
+    if (!read->fFlipY) {
+        return pixels;
+    }
+    char* flipped = static_cast<char*>(read->fFlipped.reset(size));
+    for (int y = 0; y < read->fHeight; ++y) {
+        memcpy(flipped + (read->fHeight - 1 - y) * read->fRowBytes, pixels + y * read->fRowBytes,
+               read->fRowBytes);
+    }
+    return flipped;
+}
+
+void GrGLGpu::endAsyncReadPixels(GrAsyncRead handle) {
+    AsyncRead* read = (AsyncRead*)(intptr_t)handle;
+    if (read->fMapped) {
+        GL_CALL(BindBuffer(GR_GL_PIXEL_PACK_BUFFER, read->fBuffer));
+        GL_CALL(UnmapBuffer(GR_GL_PIXEL_PACK_BUFFER));
+        GL_CALL(BindBuffer(GR_GL_PIXEL_PACK_BUFFER, 0));
+    }
+    GL_CALL(DeleteBuffers(1, &read->fBuffer));
+    this->deleteFence(read->fFence);
+    fAsyncReads.remove(fAsyncReads.find(read));
+    SkDELETE(read);
+}
+
 void GrGLGpu::flushRenderTarget(GrGLRenderTarget* target, const SkIRect* bound) {
 
     SkASSERT(target);
@@ -2008,16 +2410,29 @@ void GrGLGpu::onDraw(const DrawArgs& args, const GrNonInstancedVertices& vertice
             reinterpret_cast<GrGLvoid*>(indexOffsetInBytes + sizeof(uint16_t) *
                                         vertices.startIndex());
         // info.startVertex() was accounted for by setupGeometry.
-        GL_CALL(DrawElements(gPrimitiveType2GLMode[vertices.primitiveType()],
-                             vertices.indexCount(),
-                             GR_GL_UNSIGNED_SHORT,
-                             indices));
+        if (vertices.isHWInstanced()) {
+            GL_CALL(DrawElementsInstanced(gPrimitiveType2GLMode[vertices.primitiveType()],
+                                          vertices.indexCount(),
+                                          GR_GL_UNSIGNED_SHORT,
+                                          indices,
+                                          vertices.hwInstanceCount()));
+        } else {
+            GL_CALL(DrawElements(gPrimitiveType2GLMode[vertices.primitiveType()],
+                                 vertices.indexCount(),
+                                 GR_GL_UNSIGNED_SHORT,
+                                 indices));
+        }
     } else {
         // Pass 0 for parameter first. We have to adjust glVertexAttribPointer() to account for
         // startVertex in the DrawElements case. So we always rely on setupGeometry to have
         // accounted for startVertex.
-        GL_CALL(DrawArrays(gPrimitiveType2GLMode[vertices.primitiveType()], 0,
-                           vertices.vertexCount()));
+        if (vertices.isHWInstanced()) {
+            GL_CALL(DrawArraysInstanced(gPrimitiveType2GLMode[vertices.primitiveType()], 0,
+                                        vertices.vertexCount(), vertices.hwInstanceCount()));
+        } else {
+            GL_CALL(DrawArrays(gPrimitiveType2GLMode[vertices.primitiveType()], 0,
+                               vertices.vertexCount()));
+        }
     }
 #if SWAP_PER_DRAW
     glFlush();
@@ -2033,6 +2448,105 @@ void GrGLGpu::onDraw(const DrawArgs& args, const GrNonInstancedVertices& vertice
 #endif
 }
 
+// Can the draw be one of the commands of a glMultiDrawElementsIndirect? The commands can't
+// express HW instancing with an instance buffer offset, or index data in client memory.
+static bool can_draw_indirect(const GrNonInstancedVertices& vertices) {
+    return vertices.isIndexed() && !vertices.isHWInstanced() &&
+           !vertices.vertexBuffer()->isCPUBacked() && !vertices.indexBuffer()->isCPUBacked();
+}
+
+void GrGLGpu::onDrawMultiple(const DrawArgs& args, const GrVertices vertices[], int count) {
+    if (!this->glCaps().multiDrawIndirectSupport()) {
+        INHERITED::onDrawMultiple(args, vertices, count);
+        return;
+    }
+
+    // Consecutive draws from the same vertex and index buffers are queued as indirect commands.
+    // The attributes point at the start of the vertex buffer and each command's base vertex
+    // selects its vertices, so that one setup serves the whole queue. 'geometry' is the
+    // GrVertices that the queue's buffers came from; GrVertices::Iterator reuses its storage.
+    SkTDArray<DrawElementsIndirectCommand> commands;
+    const GrNonInstancedVertices* geometry = NULL;
+    static const int kMaxCommands = kStreamBufferSize / sizeof(DrawElementsIndirectCommand);
+
+    for (int i = 0; i < count; ++i) {
+        GrVertices::Iterator iter;
+        const GrNonInstancedVertices* verts = iter.init(vertices[i]);
+        do {
+            fStats.incDraws();
+            if (!can_draw_indirect(*verts)) {
+                if (geometry) {
+                    this->flushIndirectDraws(args, *geometry, &commands);
+                    geometry = NULL;
+                }
+                this->onDraw(args, *verts);
+                continue;
+            }
+            if (geometry && (geometry->vertexBuffer() != verts->vertexBuffer() ||
+                             geometry->indexBuffer() != verts->indexBuffer() ||
+                             geometry->primitiveType() != verts->primitiveType() ||
+                             commands.count() == kMaxCommands)) {
+                this->flushIndirectDraws(args, *geometry, &commands);
+                geometry = NULL;
+            }
+            if (!geometry) {
+                geometry = &vertices[i];
+            }
+            DrawElementsIndirectCommand& command = *commands.append();
+            command.fCount = verts->indexCount();
+            command.fInstanceCount = 1;
+            command.fFirstIndex = verts->startIndex();
+            command.fBaseVertex = verts->startVertex();
+            command.fBaseInstance = 0;
+        } while ((verts = iter.next()));
+    }
+    if (geometry) {
+        this->flushIndirectDraws(args, *geometry, &commands);
+    }
+}
+
+void GrGLGpu::flushIndirectDraws(const DrawArgs& args, const GrNonInstancedVertices& geometry,
+                                 SkTDArray<DrawElementsIndirectCommand>* commands) {
+    SkASSERT(!commands->isEmpty());
+    if (!this->flushGLState(args)) {
+        commands->rewind();
+        return;
+    }
+
+    // A lone draw isn't worth streaming a command for. Its start vertex goes in the attributes.
+    bool single = 1 == commands->count();
+    size_t indexOffsetInBytes = 0;
+    this->setupGeometry(*args.fPrimitiveProcessor, geometry,
+                        single ? (*commands)[0].fBaseVertex : 0, &indexOffsetInBytes);
+    // can_draw_indirect() only allows GPU index buffers, which have no base offset.
+    SkASSERT(0 == indexOffsetInBytes);
+
+    SkASSERT((size_t)geometry.primitiveType() < SK_ARRAY_COUNT(gPrimitiveType2GLMode));
+    GrGLenum mode = gPrimitiveType2GLMode[geometry.primitiveType()];
+    if (single) {
+        const DrawElementsIndirectCommand& command = (*commands)[0];
+        GL_CALL(DrawElements(mode, command.fCount, GR_GL_UNSIGNED_SHORT,
+                             reinterpret_cast<GrGLvoid*>(sizeof(uint16_t) * command.fFirstIndex)));
+        commands->rewind();
+        return;
+    }
+
+    size_t offset;
+    if (this->streamData(&fIndirectBuffers, commands->begin(), commands->bytes(),
+                         sizeof(GrGLuint), &offset) < 0) {
+        commands->rewind();
+        return;
+    }
+    GL_CALL(MultiDrawElementsIndirect(mode, GR_GL_UNSIGNED_SHORT,
+                                      reinterpret_cast<GrGLvoid*>(offset), commands->count(),
+                                      0));
+    fStats.incMultiDrawCalls();
+    for (int i = 0; i < commands->count(); ++i) {
+        fStats.incMultiDraws();
+    }
+    commands->rewind();
+}
+
 void GrGLGpu::onResolveRenderTarget(GrRenderTarget* target) {
     GrGLRenderTarget* rt = static_cast<GrGLRenderTarget*>(target);
     if (rt->needsResolve()) {
@@ -3083,6 +3597,68 @@ void GrGLGpu::xferBarrier(GrRenderTarget* rt, GrXferBarrierType type) {
     }
 }
 
+GrFence GrGLGpu::insertFence() {
+    GrGLsync sync;
+    GL_CALL_RET(sync, FenceSync(GR_GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    return (GrFence)(intptr_t)sync;
+}
+
+bool GrGLGpu::waitFence(GrFence fence, uint64_t timeout) {
+    GrGLenum result;
+    GL_CALL_RET(result, ClientWaitSync((GrGLsync)fence, GR_GL_SYNC_FLUSH_COMMANDS_BIT, timeout));
+    return GR_GL_ALREADY_SIGNALED == result || GR_GL_CONDITION_SATISFIED == result;
+}
+
+void GrGLGpu::deleteFence(GrFence fence) {
+    GL_CALL(DeleteSync((GrGLsync)fence));
+}
+
+GrTimerQuery GrGLGpu::beginTimerQuery() {
+    if (!this->caps()->timerQuerySupport()) {
+        return 0;
+    }
+    GrGLuint query = 0;
+    if (fFreeTimerQueries.count()) {
+        fFreeTimerQueries.pop(&query);
+    } else {
+        GL_CALL(GenQueries(1, &query));
+    }
+    if (query) {
+        GL_CALL(BeginQuery(GR_GL_TIME_ELAPSED, query));
+    }
+    return query;
+}
+
+void GrGLGpu::endTimerQuery(GrTimerQuery query) {
+    SkASSERT(query);
+    GL_CALL(EndQuery(GR_GL_TIME_ELAPSED));
+}
+
+GrGpu::TimerQueryResult GrGLGpu::getTimerQueryResult(GrTimerQuery query, uint64_t* nanoseconds) {
+    GrGLuint id = static_cast<GrGLuint>(query);
+    GrGLuint available = 0;
+    GL_CALL(GetQueryObjectuiv(id, GR_GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available) {
+        return kPending_TimerQueryResult;
+    }
+    if (this->glCaps().disjointTimerQuery()) {
+        GrGLint disjoint = 0;
+        GL_CALL(GetIntegerv(GR_GL_GPU_DISJOINT, &disjoint));
+        if (disjoint) {
+            return kDisjoint_TimerQueryResult;
+        }
+    }
+    GrGLuint64 elapsed = 0;
+    GL_CALL(GetQueryObjectui64v(id, GR_GL_QUERY_RESULT, &elapsed));
+    *nanoseconds = elapsed;
+    return kReady_TimerQueryResult;
+}
+
+void GrGLGpu::deleteTimerQuery(GrTimerQuery query) {
+    SkASSERT(query);
+    *fFreeTimerQueries.append() = static_cast<GrGLuint>(query);
+}
+
 void GrGLGpu::didAddGpuTraceMarker() {
     if (this->caps()->gpuTracingSupport()) {
         const GrTraceMarkerSet& markerArray = this->getActiveTraceMarkers();
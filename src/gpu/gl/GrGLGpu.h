@@ -8,6 +8,7 @@
 #ifndef GrGLGpu_DEFINED
 #define GrGLGpu_DEFINED
 
+#include "GrContextOptions.h"
 #include "GrGLContext.h"
 #include "GrGLIRect.h"
 #include "GrGLIndexBuffer.h"
@@ -47,6 +48,12 @@ public:
     GrGLSLGeneration glslGeneration() const { return fGLContext->glslGeneration(); }
     const GrGLCaps& glCaps() const { return *fGLContext->caps(); }
 
+    // The client's cache for linked program binaries, or NULL if they can't be used.
+    GrContextOptions::PersistentCache* persistentCache() const { return fPersistentCache; }
+    // Identifies the GL driver, so that cached binaries are only reloaded by the one that made
+    // them.
+    uint32_t driverHash() const { return fDriverHash; }
+
     GrGLPathRendering* glPathRendering() {
         SkASSERT(glCaps().shaderCaps()->pathRenderingSupport());
         return static_cast<GrGLPathRendering*>(pathRendering());
@@ -57,6 +64,19 @@ public:
     // Used by GrGLProgram to configure OpenGL state.
     void bindTexture(int unitIdx, const GrTextureParams& params, GrGLTexture* texture);
 
+    enum {
+        // Programs that use a uniform block have it bound to this binding point.
+        kUniformBlockBinding = 0,
+        // Size of each of the streaming uniform buffers. No uniform block may be larger.
+        kUniformBufferSize   = 64 * 1024,
+    };
+
+    // Used by GrGLProgramDataManager to bind a program's uniform block. The data is written to a
+    // streaming uniform buffer only if it is dirty or the range it was last written to has since
+    // been overwritten. 'range' is updated to where the data now lives.
+    void flushUniformBlock(const void* data, size_t size, bool dirty,
+                           GrGLProgramDataManager::UniformBlockRange* range);
+
     bool onGetReadPixelsInfo(GrSurface* srcSurface, int readWidth, int readHeight, size_t rowBytes,
                              GrPixelConfig readConfig, DrawPreference*,
                              ReadPixelTempDrawInfo*) override;
@@ -98,11 +118,27 @@ public:
 
     void xferBarrier(GrRenderTarget*, GrXferBarrierType) override;
 
+    GrFence insertFence() override;
+    bool waitFence(GrFence, uint64_t timeout) override;
+    void deleteFence(GrFence) override;
+
+    GrTimerQuery beginTimerQuery() override;
+    void endTimerQuery(GrTimerQuery) override;
+    TimerQueryResult getTimerQueryResult(GrTimerQuery, uint64_t* nanoseconds) override;
+    void deleteTimerQuery(GrTimerQuery) override;
+
+    bool isAsyncReadFinished(GrAsyncRead, uint64_t timeout) override;
+    const void* mapAsyncReadPixels(GrAsyncRead, size_t* rowBytes) override;
+    void endAsyncReadPixels(GrAsyncRead) override;
+
     void buildProgramDesc(GrProgramDesc*,
                           const GrPrimitiveProcessor&,
                           const GrPipeline&,
                           const GrBatchTracker&) const override;
 
+    bool preparesPrograms() const override { return fAllowPendingPrograms; }
+    void prepareProgram(const DrawArgs& args) override { fProgramCache->prepareProgram(args); }
+
     const GrGLContext* glContextForTesting() const override {
         return &this->glContext();
     }
@@ -113,7 +149,7 @@ public:
     void deleteTestingOnlyBackendTexture(GrBackendObject id) const override;
 
 private:
-    GrGLGpu(GrGLContext* ctx, GrContext* context);
+    GrGLGpu(GrGLContext* ctx, const GrContextOptions& options, GrContext* context);
 
     // GrGpu overrides
     void onResetContext(uint32_t resetBits) override;
@@ -125,6 +161,8 @@ private:
                                          const void* srcData) override;
     GrVertexBuffer* onCreateVertexBuffer(size_t size, bool dynamic) override;
     GrIndexBuffer* onCreateIndexBuffer(size_t size, bool dynamic) override;
+    GrVertexBuffer* onCreatePersistentVertexBuffer(size_t size) override;
+    GrIndexBuffer* onCreatePersistentIndexBuffer(size_t size) override;
     GrTexture* onWrapBackendTexture(const GrBackendTextureDesc&, GrWrapOwnership) override;
     GrRenderTarget* onWrapBackendRenderTarget(const GrBackendRenderTargetDesc&,
                                               GrWrapOwnership) override;
@@ -143,6 +181,21 @@ private:
                       void* buffer,
                       size_t rowBytes) override;
 
+    GrAsyncRead onBeginAsyncReadPixels(GrSurface*,
+                                       int left, int top,
+                                       int width, int height,
+                                       GrPixelConfig) override;
+
+    // Checks that glReadPixels can read 'surface' as 'config', resolves it if necessary and
+    // binds it for reading.
+    bool setupReadPixels(GrSurface*,
+                         int left, int top,
+                         int width, int height,
+                         GrPixelConfig,
+                         GrGLenum* format,
+                         GrGLenum* type,
+                         GrGLIRect* readRect);
+
     bool onWritePixels(GrSurface*,
                        int left, int top, int width, int height,
                        GrPixelConfig config, const void* buffer,
@@ -151,6 +204,7 @@ private:
     void onResolveRenderTarget(GrRenderTarget* target) override;
 
     void onDraw(const DrawArgs&, const GrNonInstancedVertices&) override;
+    void onDrawMultiple(const DrawArgs&, const GrVertices[], int count) override;
 
     void clearStencil(GrRenderTarget*) override;
 
@@ -170,6 +224,23 @@ private:
     void setupGeometry(const GrPrimitiveProcessor&,
                        const GrNonInstancedVertices& vertices,
                        size_t* indexOffsetInBytes);
+    // Variant that points the attributes at startVertex rather than vertices.startVertex().
+    void setupGeometry(const GrPrimitiveProcessor&,
+                       const GrNonInstancedVertices& vertices,
+                       int startVertex,
+                       size_t* indexOffsetInBytes);
+
+    // Issues the queued indirect draw commands (see onDrawMultiple) with one
+    // glMultiDrawElementsIndirect.
+    struct DrawElementsIndirectCommand {
+        GrGLuint fCount;
+        GrGLuint fInstanceCount;
+        GrGLuint fFirstIndex;
+        GrGLint  fBaseVertex;
+        GrGLuint fBaseInstance;
+    };
+    void flushIndirectDraws(const DrawArgs&, const GrNonInstancedVertices& geometry,
+                            SkTDArray<DrawElementsIndirectCommand>* commands);
 
     // Subclasses should call this to flush the blend state.
     void flushBlend(const GrXferProcessor::BlendInfo& blendInfo);
@@ -198,6 +269,8 @@ private:
 
         void abandon();
         GrGLProgram* refProgram(const DrawArgs&);
+        // Starts compiling the program for args, without waiting for it, if it isn't cached.
+        void prepareProgram(const DrawArgs&);
 
     private:
         enum {
@@ -208,9 +281,15 @@ private:
         };
 
         struct Entry;
+        struct PendingProgram;
 
         struct ProgDescLess;
 
+        // Creates the program for a cache miss, finishing a prepared one if there is one.
+        GrGLProgram* createProgram(const DrawArgs&);
+        // Returns the index into fPending of the program for desc, or -1.
+        int findPending(const GrProgramDesc&) const;
+
         // binary search for entry matching desc. returns index into fEntries that matches desc or ~
         // of the index of where it should be inserted.
         int search(const GrProgramDesc& desc) const;
@@ -220,14 +299,18 @@ private:
         // hash table based on lowest kHashBits bits of the program key. Used to avoid binary
         // searching fEntries.
         Entry*                      fHashTable[1 << kHashBits];
+        // The entry returned by the last successful refProgram(). Checked before the hash table.
+        Entry*                      fMRUEntry;
 
         int                         fCount;
         unsigned int                fCurrLRUStamp;
         GrGLGpu*                    fGpu;
+        SkTDArray<PendingProgram*>  fPending;
 #ifdef PROGRAM_CACHE_STATS
         int                         fTotalRequests;
         int                         fCacheMisses;
         int                         fHashMisses; // cache hit but hash table missed
+        int                         fMRUHits;    // cache hit on the most recently used entry
 #endif
     };
 
@@ -273,6 +356,11 @@ private:
                        const void* data,
                        size_t rowBytes);
 
+    // Maps 'size' bytes of the current texture upload buffer and leaves it bound to
+    // GL_PIXEL_UNPACK_BUFFER. Returns NULL if the upload should come from client memory instead.
+    // On success 'offset' is the location of the mapped range within the buffer.
+    void* mapUploadBuffer(size_t size, size_t* offset);
+
     // helper for onCreateCompressedTexture. If width and height are
     // set to -1, then this function will use desc.fWidth and desc.fHeight
     // for the size of the data. The isNewTexture flag should be set to true
@@ -305,6 +393,12 @@ private:
     // GL program-related state
     ProgramCache*               fProgramCache;
 
+    // Where linked program binaries are saved across processes, or NULL. Keys include
+    // fDriverHash so that binaries are never offered to a different driver.
+    GrContextOptions::PersistentCache*  fPersistentCache;
+    uint32_t                            fDriverHash;
+    bool                                fAllowPendingPrograms;
+
     ///////////////////////////////////////////////////////////////////////////
     ///@name Caching of GL State
     ///@{
@@ -322,6 +416,85 @@ private:
 
     GrGLuint                    fStencilClearFBOID;
 
+    // Texture uploads are staged through a ring of pixel unpack buffers so that glTex[Sub]Image2D
+    // returns without waiting for the transfer. Uploads are packed into the current buffer until
+    // it fills. A buffer is orphaned (given new storage) each time the ring comes back around to
+    // it, so ranges that pending transfers may still read are never written, and it can be mapped
+    // unsynchronized without fences.
+    enum {
+        kUploadBufferCount   = 4,
+        kUploadBufferSize    = 2 * 1024 * 1024,
+        // Smaller uploads aren't worth the map/unmap.
+        kMinStagedUploadSize = 16 * 1024,
+    };
+    struct {
+        GrGLuint    fIDs[kUploadBufferCount];
+        int         fCurr;
+        size_t      fOffset;    // first free byte of fIDs[fCurr]
+    } fUploadBuffers;
+
+    // Uniform blocks and indirect draw commands are streamed through rings of buffers in the same
+    // way, written with glBufferSubData. A buffer's generation is bumped each time it is
+    // orphaned, which invalidates the ranges written to it.
+    enum {
+        kStreamBufferCount = 4,
+        kStreamBufferSize  = kUniformBufferSize,
+    };
+    struct StreamBuffers {
+        GrGLenum    fTarget;
+        GrGLuint    fIDs[kStreamBufferCount];
+        uint32_t    fGenerations[kStreamBufferCount];
+        int         fCurr;
+        size_t      fOffset;    // first free byte of fIDs[fCurr]
+
+        void init(GrGLenum target) {
+            fTarget = target;
+            memset(fIDs, 0, sizeof(fIDs));
+            memset(fGenerations, 0, sizeof(fGenerations));
+            fCurr = 0;
+            fOffset = 0;
+        }
+        void abandon() {
+            memset(fIDs, 0, sizeof(fIDs));
+            for (int i = 0; i < kStreamBufferCount; ++i) {
+                ++fGenerations[i];
+            }
+            fOffset = 0;
+        }
+    };
+    StreamBuffers fUniformBuffers;
+    StreamBuffers fIndirectBuffers;
+
+    // Deleted timer queries are kept for reuse rather than deleted in GL.
+    SkTDArray<GrGLuint> fFreeTimerQueries;
+
+    // A glReadPixels into a pixel pack buffer, fenced so that it can be mapped without stalling.
+    struct AsyncRead {
+        GrGLuint        fBuffer;
+        GrFence         fFence;
+        int             fHeight;
+        size_t          fRowBytes;
+        // The rows are bottom-to-top in the buffer and are flipped into fFlipped when mapped.
+        bool            fFlipY;
+        bool            fMapped;
+        SkAutoMalloc    fFlipped;
+    };
+    SkTDArray<AsyncRead*> fAsyncReads;
+
+    // Writes data to the next 'alignment' aligned range of a stream ring, orphaning a buffer when
+    // the ring comes back around to it. The buffer is left bound to the ring's target. Returns the
+    // index of the buffer that was written, or -1 on failure.
+    int streamData(StreamBuffers*, const void* data, size_t size, size_t alignment,
+                   size_t* offset);
+
+    // The range last bound to kUniformBlockBinding. A zero fID means unknown.
+    struct {
+        GrGLuint        fID;
+        GrGLintptr      fOffset;
+        GrGLsizeiptr    fSize;
+        void invalidate() { fID = 0; }
+    } fHWUniformBlock;
+
     // last scissor / viewport scissor state seen by the GL.
     struct {
         TriState    fEnabled;
@@ -370,6 +543,8 @@ private:
                 GR_GL_CALL(gpu->glInterface(), BindVertexArray(arrayID));
                 fBoundVertexArrayIDIsValid = true;
                 fBoundVertexArrayID = arrayID;
+            } else {
+                gpu->stats()->incSkippedBufferBinds();
             }
         }
 
@@ -398,6 +573,8 @@ private:
                 GR_GL_CALL(gpu->glInterface(), BindBuffer(GR_GL_ARRAY_BUFFER, id));
                 fBoundVertexBufferIDIsValid = true;
                 fBoundVertexBufferID = id;
+            } else {
+                gpu->stats()->incSkippedBufferBinds();
             }
         }
 
@@ -412,6 +589,8 @@ private:
                 GR_GL_CALL(gpu->glInterface(), BindBuffer(GR_GL_ELEMENT_ARRAY_BUFFER, id));
                 fDefaultVertexArrayBoundIndexBufferIDIsValid = true;
                 fDefaultVertexArrayBoundIndexBufferID = id;
+            } else {
+                gpu->stats()->incSkippedBufferBinds();
             }
         }
 
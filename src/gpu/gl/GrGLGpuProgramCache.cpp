@@ -29,6 +29,15 @@ struct GrGLGpu::ProgramCache::Entry {
     unsigned int                fLRUStamp;
 };
 
+// A program prepared for an upcoming draw that the driver may still be compiling.
+struct GrGLGpu::ProgramCache::PendingProgram {
+    GrProgramDesc                           fDesc;
+    SkAutoTDelete<GrGLProgramBuilder>       fBuilder;
+};
+
+// Limits how many programs are compiled ahead of their draws at once.
+static const int kMaxPendingPrograms = 16;
+
 struct GrGLGpu::ProgramCache::ProgDescLess {
     bool operator() (const GrProgramDesc& desc, const Entry* entry) {
         SkASSERT(entry->fProgram.get());
@@ -41,14 +50,26 @@ struct GrGLGpu::ProgramCache::ProgDescLess {
     }
 };
 
+// Folds the desc checksum down to a slot in the direct mapped hash table.
+static inline int hash_index(const GrProgramDesc& desc, int hashBits) {
+    uint32_t hashIdx = desc.getChecksum();
+    hashIdx ^= hashIdx >> 16;
+    if (hashBits <= 8) {
+        hashIdx ^= hashIdx >> 8;
+    }
+    return hashIdx & ((1 << hashBits) - 1);
+}
+
 GrGLGpu::ProgramCache::ProgramCache(GrGLGpu* gpu)
-    : fCount(0)
+    : fMRUEntry(NULL)
+    , fCount(0)
     , fCurrLRUStamp(0)
     , fGpu(gpu)
 #ifdef PROGRAM_CACHE_STATS
     , fTotalRequests(0)
     , fCacheMisses(0)
     , fHashMisses(0)
+    , fMRUHits(0)
 #endif
 {
     for (int i = 0; i < 1 << kHashBits; ++i) {
@@ -60,6 +81,7 @@ GrGLGpu::ProgramCache::~ProgramCache() {
     for (int i = 0; i < fCount; ++i){
         SkDELETE(fEntries[i]);
     }
+    fPending.deleteAll();
     // dump stats
 #ifdef PROGRAM_CACHE_STATS
     if (c_DisplayCache) {
@@ -71,6 +93,7 @@ GrGLGpu::ProgramCache::~ProgramCache() {
                                             0.f);
         int cacheHits = fTotalRequests - fCacheMisses;
         SkDebugf("Hash miss %%: %f\n", (cacheHits > 0) ? 100.f * fHashMisses / cacheHits : 0.f);
+        SkDebugf("MRU hit %%: %f\n", (cacheHits > 0) ? 100.f * fMRUHits / cacheHits : 0.f);
         SkDebugf("---------------------\n");
     }
 #endif
@@ -83,6 +106,56 @@ void GrGLGpu::ProgramCache::abandon() {
         SkDELETE(fEntries[i]);
     }
     fCount = 0;
+    fMRUEntry = NULL;
+    for (int i = 0; i < 1 << kHashBits; ++i) {
+        fHashTable[i] = NULL;
+    }
+    for (int i = 0; i < fPending.count(); ++i) {
+        fPending[i]->fBuilder->abandon();
+    }
+    fPending.deleteAll();
+}
+
+int GrGLGpu::ProgramCache::findPending(const GrProgramDesc& desc) const {
+    for (int i = 0; i < fPending.count(); ++i) {
+        if (fPending[i]->fDesc == desc) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void GrGLGpu::ProgramCache::prepareProgram(const DrawArgs& args) {
+    if (this->search(*args.fDesc) >= 0 || this->findPending(*args.fDesc) >= 0) {
+        return;
+    }
+    if (fPending.count() >= kMaxPendingPrograms) {
+        // The oldest one is most likely left over from a draw that never happened.
+        SkDELETE(fPending[0]);
+        fPending.remove(0);
+    }
+    GrGLProgramBuilder* builder = GrGLProgramBuilder::CreatePendingProgram(args, fGpu);
+    if (!builder) {
+        // The draw will try again and report the failure.
+        return;
+    }
+    PendingProgram* pending = SkNEW(PendingProgram);
+    pending->fDesc = *args.fDesc;
+    pending->fBuilder.reset(builder);
+    *fPending.append() = pending;
+}
+
+GrGLProgram* GrGLGpu::ProgramCache::createProgram(const DrawArgs& args) {
+    int pendingIdx = this->findPending(*args.fDesc);
+    if (pendingIdx < 0) {
+        return GrGLProgramBuilder::CreateProgram(args, fGpu);
+    }
+    // This waits for the driver if it is still compiling.
+    PendingProgram* pending = fPending[pendingIdx];
+    GrGLProgram* program = pending->fBuilder->finishProgram();
+    SkDELETE(pending);
+    fPending.remove(pendingIdx);
+    return program;
 }
 
 int GrGLGpu::ProgramCache::search(const GrProgramDesc& desc) const {
@@ -97,16 +170,22 @@ GrGLProgram* GrGLGpu::ProgramCache::refProgram(const DrawArgs& args) {
 
     Entry* entry = NULL;
 
-    uint32_t hashIdx = args.fDesc->getChecksum();
-    hashIdx ^= hashIdx >> 16;
-    if (kHashBits <= 8) {
-        hashIdx ^= hashIdx >> 8;
+    // Consecutive draws very often use the same program, so check the last one we handed out
+    // before probing the hash table.
+    if (fMRUEntry && fMRUEntry->fProgram->getDesc() == *args.fDesc) {
+        entry = fMRUEntry;
+#ifdef PROGRAM_CACHE_STATS
+        ++fMRUHits;
+#endif
     }
-    hashIdx &=((1 << kHashBits) - 1);
-    Entry* hashedEntry = fHashTable[hashIdx];
-    if (hashedEntry && hashedEntry->fProgram->getDesc() == *args.fDesc) {
-        SkASSERT(hashedEntry->fProgram);
-        entry = hashedEntry;
+
+    int hashIdx = hash_index(*args.fDesc, kHashBits);
+    if (NULL == entry) {
+        Entry* hashedEntry = fHashTable[hashIdx];
+        if (hashedEntry && hashedEntry->fProgram->getDesc() == *args.fDesc) {
+            SkASSERT(hashedEntry->fProgram);
+            entry = hashedEntry;
+        }
     }
 
     int entryIdx;
@@ -125,7 +204,7 @@ GrGLProgram* GrGLGpu::ProgramCache::refProgram(const DrawArgs& args) {
 #ifdef PROGRAM_CACHE_STATS
         ++fCacheMisses;
 #endif
-        GrGLProgram* program = GrGLProgramBuilder::CreateProgram(args, fGpu);
+        GrGLProgram* program = this->createProgram(args);
         if (NULL == program) {
             return NULL;
         }
@@ -143,7 +222,7 @@ GrGLProgram* GrGLGpu::ProgramCache::refProgram(const DrawArgs& args) {
                 }
             }
             entry = fEntries[purgeIdx];
-            int purgedHashIdx = entry->fProgram->getDesc().getChecksum() & ((1 << kHashBits) - 1);
+            int purgedHashIdx = hash_index(entry->fProgram->getDesc(), kHashBits);
             if (fHashTable[purgedHashIdx] == entry) {
                 fHashTable[purgedHashIdx] = NULL;
             }
@@ -184,6 +263,7 @@ GrGLProgram* GrGLGpu::ProgramCache::refProgram(const DrawArgs& args) {
     }
 
     fHashTable[hashIdx] = entry;
+    fMRUEntry = entry;
     entry->fLRUStamp = fCurrLRUStamp;
 
     if (SK_MaxU32 == fCurrLRUStamp) {
@@ -99,6 +99,8 @@ void GrGLProgram::setData(const GrPrimitiveProcessor& primProc,
 
     // Some of GrGLProgram subclasses need to update state here
     this->didSetData();
+
+    fProgramDataManager.flushUniformBlock();
 }
 
 void GrGLProgram::setFragmentData(const GrPrimitiveProcessor& primProc,
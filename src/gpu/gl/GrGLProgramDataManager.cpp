@@ -14,8 +14,93 @@
          SkASSERT(arrayCount <= uni.fArrayCount || \
                   (1 == arrayCount && GrGLShaderVar::kNonArray == uni.fArrayCount))
 
+// The number of 32 bit values needed to shadow one element of a uniform of the given type
+static int uniform_value_count(GrSLType type) {
+    switch (type) {
+        case kFloat_GrSLType:
+        case kSampler2D_GrSLType:
+            return 1;
+        case kVec2f_GrSLType:
+            return 2;
+        case kVec3f_GrSLType:
+            return 3;
+        case kVec4f_GrSLType:
+            return 4;
+        case kMat33f_GrSLType:
+            return 9;
+        case kMat44f_GrSLType:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+// Returns the std140 base alignment and size of a single (non-array) uniform of the given type.
+// Matrices are stored as arrays of vec4 columns.
+static void std140_align_and_size(GrSLType type, int* align, int* size) {
+    switch (type) {
+        case kFloat_GrSLType:
+            *align = *size = 4;
+            break;
+        case kVec2f_GrSLType:
+            *align = *size = 8;
+            break;
+        case kVec3f_GrSLType:
+            *align = 16;
+            *size = 12;
+            break;
+        case kVec4f_GrSLType:
+            *align = *size = 16;
+            break;
+        case kMat33f_GrSLType:
+            *align = 16;
+            *size = 48;
+            break;
+        case kMat44f_GrSLType:
+            *align = 16;
+            *size = 64;
+            break;
+        default:
+            SkFAIL("Unexpected uniform block member type.");
+            *align = *size = 0;
+            break;
+    }
+}
+
+// The std140 stride between array elements. Every element is rounded up to a whole vec4.
+static int std140_array_stride(GrSLType type) {
+    int align, size;
+    std140_align_and_size(type, &align, &size);
+    return (size + 15) & ~15;
+}
+
+size_t GrGLProgramDataManager::LayoutUniformBlock(UniformInfoArray* uniforms) {
+    int offset = 0;
+    for (int i = 0; i < uniforms->count(); ++i) {
+        UniformInfo& uniform = (*uniforms)[i];
+        GrSLType type = uniform.fVariable.getType();
+        if (kSampler2D_GrSLType == type) {
+            uniform.fBlockOffset = -1;
+            continue;
+        }
+        int align, size;
+        if (uniform.fVariable.isArray()) {
+            align = 16;
+            size = std140_array_stride(type) * uniform.fVariable.getArrayCount();
+        } else {
+            std140_align_and_size(type, &align, &size);
+        }
+        offset = (offset + align - 1) & ~(align - 1);
+        uniform.fBlockOffset = offset;
+        offset += size;
+    }
+    return (offset + 15) & ~15;
+}
+
 GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, const UniformInfoArray& uniforms)
-    : fGpu(gpu) {
+    : fGpu(gpu)
+    , fBlockDirty(false) {
+    size_t blockSize = 0;
     int count = uniforms.count();
     fUniforms.push_back_n(count);
     for (int i = 0; i < count; i++) {
@@ -29,6 +114,31 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, const UniformInfoAr
         );
         // TODO: Move the Xoom uniform array in both FS and VS bug workaround here.
 
+        int arrayCount = builderUniform.fVariable.getArrayCount();
+        if (GrGLShaderVar::kNonArray == arrayCount) {
+            arrayCount = 1;
+        }
+        uniform.fShadowOffset = fShadowValues.count();
+        uniform.fShadowSize = uniform_value_count(builderUniform.fVariable.getType()) * arrayCount;
+        fShadowValues.append(uniform.fShadowSize);
+        *fShadowValidCounts.append() = 0;
+
+        uniform.fBlockOffset = builderUniform.fBlockOffset;
+        uniform.fBlockArrayStride = 0;
+        if (uniform.fBlockOffset >= 0) {
+            GrSLType type = builderUniform.fVariable.getType();
+            int align, size;
+            std140_align_and_size(type, &align, &size);
+            uniform.fBlockArrayStride = std140_array_stride(type);
+            if (builderUniform.fVariable.isArray()) {
+                size = uniform.fBlockArrayStride * arrayCount;
+            }
+            blockSize = SkTMax(blockSize, (size_t)(uniform.fBlockOffset + size));
+            uniform.fVSLocation = kUnusedUniform;
+            uniform.fFSLocation = kUnusedUniform;
+            continue;
+        }
+
         if (GrGLProgramBuilder::kVertex_Visibility & builderUniform.fVisibility) {
             uniform.fVSLocation = builderUniform.fLocation;
         } else {
@@ -40,6 +150,11 @@ GrGLProgramDataManager::GrGLProgramDataManager(GrGLGpu* gpu, const UniformInfoAr
             uniform.fFSLocation = kUnusedUniform;
         }
     }
+    if (blockSize) {
+        // Padding is never read, but zero it so the block's contents are deterministic.
+        fBlockData.setCount(SkToInt((blockSize + 15) & ~15));
+        sk_bzero(fBlockData.begin(), fBlockData.count());
+    }
 }
 
 void GrGLProgramDataManager::setSampler(UniformHandle u, GrGLint texUnit) const {
@@ -50,6 +165,9 @@ void GrGLProgramDataManager::setSampler(UniformHandle u, GrGLint texUnit) const
     // reference the sampler then the compiler may have optimized it out. Uncomment this assert
     // once stages insert their own samplers.
     // this->printUnused(uni);
+    if (!this->needsUpload(u, &texUnit, 1)) {
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1i(uni.fFSLocation, texUnit));
     }
@@ -63,6 +181,14 @@ void GrGLProgramDataManager::set1f(UniformHandle u, GrGLfloat v0) const {
     SkASSERT(uni.fType == kFloat_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    const GrGLfloat values[] = { v0 };
+    if (!this->needsUpload(u, values, 1)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, values, 1, 1, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1f(uni.fFSLocation, v0));
     }
@@ -82,6 +208,13 @@ void GrGLProgramDataManager::set1fv(UniformHandle u,
     // Once the uniform manager is responsible for inserting the duplicate uniform
     // arrays in VS and FS driver bug workaround, this can be enabled.
     // this->printUni(uni);
+    if (!this->needsUpload(u, v, arrayCount)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, v, arrayCount, 1, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform1fv(uni.fFSLocation, arrayCount, v));
     }
@@ -95,6 +228,14 @@ void GrGLProgramDataManager::set2f(UniformHandle u, GrGLfloat v0, GrGLfloat v1)
     SkASSERT(uni.fType == kVec2f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    const GrGLfloat values[] = { v0, v1 };
+    if (!this->needsUpload(u, values, 2)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, values, 1, 2, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2f(uni.fFSLocation, v0, v1));
     }
@@ -111,6 +252,13 @@ void GrGLProgramDataManager::set2fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->needsUpload(u, v, 2 * arrayCount)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, v, arrayCount, 2, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform2fv(uni.fFSLocation, arrayCount, v));
     }
@@ -124,6 +272,14 @@ void GrGLProgramDataManager::set3f(UniformHandle u, GrGLfloat v0, GrGLfloat v1,
     SkASSERT(uni.fType == kVec3f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    const GrGLfloat values[] = { v0, v1, v2 };
+    if (!this->needsUpload(u, values, 3)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, values, 1, 3, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3f(uni.fFSLocation, v0, v1, v2));
     }
@@ -140,6 +296,13 @@ void GrGLProgramDataManager::set3fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->needsUpload(u, v, 3 * arrayCount)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, v, arrayCount, 3, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform3fv(uni.fFSLocation, arrayCount, v));
     }
@@ -157,6 +320,14 @@ void GrGLProgramDataManager::set4f(UniformHandle u,
     SkASSERT(uni.fType == kVec4f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    const GrGLfloat values[] = { v0, v1, v2, v3 };
+    if (!this->needsUpload(u, values, 4)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, values, 1, 4, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4f(uni.fFSLocation, v0, v1, v2, v3));
     }
@@ -173,6 +344,13 @@ void GrGLProgramDataManager::set4fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->needsUpload(u, v, 4 * arrayCount)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, v, arrayCount, 4, 1);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), Uniform4fv(uni.fFSLocation, arrayCount, v));
     }
@@ -186,6 +364,13 @@ void GrGLProgramDataManager::setMatrix3f(UniformHandle u, const GrGLfloat matrix
     SkASSERT(uni.fType == kMat33f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->needsUpload(u, matrix, 9)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, matrix, 1, 3, 3);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), UniformMatrix3fv(uni.fFSLocation, 1, false, matrix));
     }
@@ -199,6 +384,13 @@ void GrGLProgramDataManager::setMatrix4f(UniformHandle u, const GrGLfloat matrix
     SkASSERT(uni.fType == kMat44f_GrSLType);
     SkASSERT(GrGLShaderVar::kNonArray == uni.fArrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->needsUpload(u, matrix, 16)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, matrix, 1, 4, 4);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(), UniformMatrix4fv(uni.fFSLocation, 1, false, matrix));
     }
@@ -215,6 +407,13 @@ void GrGLProgramDataManager::setMatrix3fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->needsUpload(u, matrices, 9 * arrayCount)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, matrices, arrayCount, 3, 3);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(),
                    UniformMatrix3fv(uni.fFSLocation, arrayCount, false, matrices));
@@ -233,6 +432,13 @@ void GrGLProgramDataManager::setMatrix4fv(UniformHandle u,
     SkASSERT(arrayCount > 0);
     ASSERT_ARRAY_UPLOAD_IN_BOUNDS(uni, arrayCount);
     SkDEBUGCODE(this->printUnused(uni);)
+    if (!this->needsUpload(u, matrices, 16 * arrayCount)) {
+        return;
+    }
+    if (uni.fBlockOffset >= 0) {
+        this->writeToBlock(uni, matrices, arrayCount, 4, 4);
+        return;
+    }
     if (kUnusedUniform != uni.fFSLocation) {
         GR_GL_CALL(fGpu->glInterface(),
                    UniformMatrix4fv(uni.fFSLocation, arrayCount, false, matrices));
@@ -258,9 +464,50 @@ void GrGLProgramDataManager::setSkMatrix(UniformHandle u, const SkMatrix& matrix
     this->setMatrix3f(u, mt);
 }
 
+bool GrGLProgramDataManager::needsUpload(UniformHandle u, const void* values, int count) const {
+    const Uniform& uni = fUniforms[u.toProgramDataIndex()];
+    SkASSERT(count <= uni.fShadowSize);
+    GR_STATIC_ASSERT(sizeof(GrGLfloat) == sizeof(uint32_t) && sizeof(GrGLint) == sizeof(uint32_t));
+
+    // The values are compared bitwise so that, e.g., NaNs don't defeat the shadowing
+    uint32_t* shadow = fShadowValues.begin() + uni.fShadowOffset;
+    int* validCount = &fShadowValidCounts[u.toProgramDataIndex()];
+    if (count <= *validCount && !memcmp(shadow, values, count * sizeof(uint32_t))) {
+        fGpu->stats()->incSkippedUniformUploads();
+        return false;
+    }
+    memcpy(shadow, values, count * sizeof(uint32_t));
+    *validCount = SkTMax(*validCount, count);
+    return true;
+}
+
+void GrGLProgramDataManager::writeToBlock(const Uniform& uni, const GrGLfloat values[],
+                                          int arrayCount, int rows, int cols) const {
+    SkASSERT(uni.fBlockOffset >= 0);
+    uint8_t* element = fBlockData.begin() + uni.fBlockOffset;
+    for (int e = 0; e < arrayCount; ++e) {
+        // Each matrix column starts on a vec4 boundary.
+        for (int c = 0; c < cols; ++c) {
+            memcpy(element + 4 * sizeof(GrGLfloat) * c, values, rows * sizeof(GrGLfloat));
+            values += rows;
+        }
+        element += uni.fBlockArrayStride;
+    }
+    fBlockDirty = true;
+}
+
+void GrGLProgramDataManager::flushUniformBlock() const {
+    if (fBlockData.isEmpty()) {
+        return;
+    }
+    fGpu->flushUniformBlock(fBlockData.begin(), fBlockData.count(), fBlockDirty, &fBlockRange);
+    fBlockDirty = false;
+}
+
 #ifdef SK_DEBUG
 void GrGLProgramDataManager::printUnused(const Uniform& uni) const {
-    if (kUnusedUniform == uni.fFSLocation && kUnusedUniform == uni.fVSLocation) {
+    if (uni.fBlockOffset < 0 &&
+        kUnusedUniform == uni.fFSLocation && kUnusedUniform == uni.fVSLocation) {
         GrCapsDebugf(fGpu->caps(), "Unused uniform in shader\n");
     }
 }
@@ -12,6 +12,7 @@
 #include "GrAllocator.h"
 
 #include "SkTArray.h"
+#include "SkTDArray.h"
 
 class GrGLGpu;
 class SkMatrix;
@@ -60,6 +61,9 @@ public:
         GrGLShaderVar fVariable;
         uint32_t      fVisibility;
         GrGLint       fLocation;
+        // Byte offset of the uniform in the program's uniform block, or -1 if the uniform is not
+        // in the block (it is a sampler or the program doesn't use a uniform block).
+        int           fBlockOffset;
     };
 
     // This uses an allocator rather than array so that the GrGLShaderVars don't move in memory
@@ -67,6 +71,20 @@ public:
     // name strings. Otherwise, we'd have to hand out copies.
     typedef GrTAllocator<UniformInfo> UniformInfoArray;
 
+    /** Where a program's uniform block was last written in the GPU's streaming uniform buffers.
+        The range can be rebound without another upload until its buffer is orphaned. */
+    struct UniformBlockRange {
+        UniformBlockRange() : fBuffer(-1), fGeneration(0), fOffset(0), fSize(0) {}
+        int             fBuffer;
+        uint32_t        fGeneration;
+        GrGLintptr      fOffset;
+        GrGLsizeiptr    fSize;
+    };
+
+    /** Places every non-sampler uniform in a std140 uniform block by setting the uniforms'
+        fBlockOffset. Returns the size of the block in bytes. */
+    static size_t LayoutUniformBlock(UniformInfoArray*);
+
     GrGLProgramDataManager(GrGLGpu*, const UniformInfoArray&);
 
     /** Functions for uploading uniform values. The varities ending in v can be used to upload to an
@@ -91,6 +109,10 @@ public:
     // convenience method for uploading a SkMatrix to a 3x3 matrix uniform
     void setSkMatrix(UniformHandle, const SkMatrix&) const;
 
+    /** If the program has a uniform block, streams any changed values to a uniform buffer and
+        binds the block's range. Must be called after the uniforms are set for a draw. */
+    void flushUniformBlock() const;
+
 private:
     enum {
         kUnusedUniform = -1,
@@ -99,6 +121,13 @@ private:
     struct Uniform {
         GrGLint     fVSLocation;
         GrGLint     fFSLocation;
+        // Where the uniform's last uploaded value lives in fShadowValues and how many 32 bit
+        // values (across all array elements) it can hold.
+        int         fShadowOffset;
+        int         fShadowSize;
+        // Where the uniform lives in fBlockData, or -1 if it is set with glUniform* calls.
+        int         fBlockOffset;
+        int         fBlockArrayStride;
         SkDEBUGCODE(
             GrSLType    fType;
             int         fArrayCount;
@@ -107,9 +136,29 @@ private:
 
     SkDEBUGCODE(void printUnused(const Uniform&) const;)
 
+    // Returns false if the first 'count' 32 bit values of the uniform are already known to be
+    // 'values' (and so the GL call can be skipped). Otherwise, records them and returns true.
+    // Uniform values are part of the GL program object so the shadow never needs invalidating.
+    bool needsUpload(UniformHandle, const void* values, int count) const;
+
+    // Copies arrayCount elements, each of 'cols' column-major columns of 'rows' floats, into the
+    // uniform's std140 location in fBlockData.
+    void writeToBlock(const Uniform&, const GrGLfloat values[], int arrayCount, int rows,
+                      int cols) const;
+
     SkTArray<Uniform, true> fUniforms;
     GrGLGpu* fGpu;
 
+    // The last values uploaded for every uniform and, per uniform, the number of leading values
+    // that are known to be valid.
+    mutable SkTDArray<uint32_t> fShadowValues;
+    mutable SkTDArray<int> fShadowValidCounts;
+
+    // The program's uniform block, if it has one, and where it was last streamed to.
+    mutable SkTDArray<uint8_t> fBlockData;
+    mutable bool fBlockDirty;
+    mutable UniformBlockRange fBlockRange;
+
     typedef SkNoncopyable INHERITED;
 };
 
@@ -17,17 +17,21 @@ void GrGLAttribArrayState::set(GrGLGpu* gpu,
                                GrGLenum type,
                                GrGLboolean normalized,
                                GrGLsizei stride,
-                               GrGLvoid* offset) {
+                               GrGLvoid* offset,
+                               GrGLuint divisor) {
     SkASSERT(index >= 0 && index < fAttribArrayStates.count());
     AttribArrayState* array = &fAttribArrayStates[index];
     if (!array->fEnableIsValid || !array->fEnabled) {
         GR_GL_CALL(gpu->glInterface(), EnableVertexAttribArray(index));
         array->fEnableIsValid = true;
         array->fEnabled = true;
+    } else {
+        gpu->stats()->incSkippedVertexAttribCalls();
     }
     if (!array->fAttribPointerIsValid ||
         array->fVertexBufferID != vertexBufferID ||
         array->fSize != size ||
+        array->fType != type ||
         array->fNormalized != normalized ||
         array->fStride != stride ||
         array->fOffset != offset) {
@@ -42,9 +46,22 @@ void GrGLAttribArrayState::set(GrGLGpu* gpu,
         array->fAttribPointerIsValid = true;
         array->fVertexBufferID = vertexBufferID;
         array->fSize = size;
+        array->fType = type;
         array->fNormalized = normalized;
         array->fStride = stride;
         array->fOffset = offset;
+    } else {
+        gpu->stats()->incSkippedVertexAttribCalls();
+    }
+    // Without instancing support every attrib keeps the default divisor of zero.
+    SkASSERT(!divisor || gpu->glCaps().supportsInstancedDraws());
+    if (gpu->glCaps().supportsInstancedDraws() &&
+        (!array->fDivisorIsValid || array->fDivisor != divisor)) {
+        GR_GL_CALL(gpu->glInterface(), VertexAttribDivisor(index, divisor));
+        array->fDivisorIsValid = true;
+        array->fDivisor = divisor;
+    } else if (gpu->glCaps().supportsInstancedDraws()) {
+        gpu->stats()->incSkippedVertexAttribCalls();
     }
 }
 
@@ -84,10 +101,12 @@ GrGLAttribArrayState* GrGLVertexArray::bind(GrGLGpu* gpu) {
 GrGLAttribArrayState* GrGLVertexArray::bindWithIndexBuffer(GrGLGpu* gpu, GrGLuint ibufferID) {
     GrGLAttribArrayState* state = this->bind(gpu);
     if (state) {
-        if (!fIndexBufferIDIsValid || ibufferID != fIndexBufferID) {            
+        if (!fIndexBufferIDIsValid || ibufferID != fIndexBufferID) {
             GR_GL_CALL(gpu->glInterface(), BindBuffer(GR_GL_ELEMENT_ARRAY_BUFFER, ibufferID));
             fIndexBufferIDIsValid = true;
             fIndexBufferID = ibufferID;
+        } else {
+            gpu->stats()->incSkippedBufferBinds();
         }
     }
     return state;
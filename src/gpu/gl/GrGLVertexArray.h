@@ -33,6 +33,7 @@ static inline const GrGLAttribLayout& GrGLAttribTypeToLayout(GrVertexAttribType
         {1, GR_GL_UNSIGNED_BYTE, true},  // kUByte_GrVertexAttribType
         {4, GR_GL_UNSIGNED_BYTE, true},  // kVec4ub_GrVertexAttribType
         {2, GR_GL_SHORT, false},         // kVec2s_GrVertexAttribType
+        {2, GR_GL_HALF_FLOAT, false},    // kVec2h_GrVertexAttribType
     };
     GR_STATIC_ASSERT(0 == kFloat_GrVertexAttribType);
     GR_STATIC_ASSERT(1 == kVec2f_GrVertexAttribType);
@@ -41,6 +42,7 @@ static inline const GrGLAttribLayout& GrGLAttribTypeToLayout(GrVertexAttribType
     GR_STATIC_ASSERT(4 == kUByte_GrVertexAttribType);
     GR_STATIC_ASSERT(5 == kVec4ub_GrVertexAttribType);
     GR_STATIC_ASSERT(6 == kVec2s_GrVertexAttribType);
+    GR_STATIC_ASSERT(7 == kVec2h_GrVertexAttribType);
     GR_STATIC_ASSERT(SK_ARRAY_COUNT(kLayouts) == kGrVertexAttribTypeCount);
     return kLayouts[type];
 }
@@ -65,7 +67,8 @@ public:
     /**
      * This function enables and sets vertex attrib state for the specified attrib index. It is
      * assumed that the GrGLAttribArrayState is tracking the state of the currently bound vertex
-     * array object.
+     * array object. A non-zero divisor advances the attrib once per that many instances; it may
+     * only be used when the GL caps support instanced draws.
      */
     void set(GrGLGpu*,
              int attribIndex,
@@ -74,7 +77,8 @@ public:
              GrGLenum type,
              GrGLboolean normalized,
              GrGLsizei stride,
-             GrGLvoid* offset);
+             GrGLvoid* offset,
+             GrGLuint divisor = 0);
 
     /**
      * This function disables vertex attribs not present in the mask. It is assumed that the
@@ -112,10 +116,12 @@ private:
             void invalidate() {
                 fEnableIsValid = false;
                 fAttribPointerIsValid = false;
+                fDivisorIsValid = false;
             }
 
             bool        fEnableIsValid;
             bool        fAttribPointerIsValid;
+            bool        fDivisorIsValid;
             bool        fEnabled;
             GrGLuint    fVertexBufferID;
             GrGLint     fSize;
@@ -123,6 +129,7 @@ private:
             GrGLboolean fNormalized;
             GrGLsizei   fStride;
             GrGLvoid*   fOffset;
+            GrGLuint    fDivisor;
     };
 
     SkSTArray<16, AttribArrayState, true> fAttribArrayStates;
@@ -20,6 +20,7 @@
 #include "GrGLPathProgramBuilder.h"
 #include "GrGLProgramBuilder.h"
 #include "GrTexture.h"
+#include "SkData.h"
 #include "SkRTConf.h"
 #include "SkTraceEvent.h"
 
@@ -49,6 +50,25 @@ GrGLProgram* GrGLProgramBuilder::CreateProgram(const DrawArgs& args, GrGLGpu* gp
     return pb->finalize();
 }
 
+GrGLProgramBuilder* GrGLProgramBuilder::CreatePendingProgram(const DrawArgs& args,
+                                                             GrGLGpu* gpu) {
+    GrAutoLocaleSetter als("C");
+
+    SkAutoTDelete<GrGLProgramBuilder> builder(CreateProgramBuilder(args, gpu));
+    builder->fDeferStatusChecks = true;
+
+    GrGLSLExpr4 inputColor;
+    GrGLSLExpr4 inputCoverage;
+
+    if (!builder->emitAndInstallProcs(&inputColor, &inputCoverage) || !builder->link()) {
+        return NULL;
+    }
+
+    builder->fOwnedDesc.reset(SkNEW(GrProgramDesc));
+    *builder->fOwnedDesc = *args.fDesc;
+    return builder.detach();
+}
+
 GrGLProgramBuilder* GrGLProgramBuilder::CreateProgramBuilder(const DrawArgs& args,
                                                              GrGLGpu* gpu) {
     if (args.fPrimitiveProcessor->isPathRendering()) {
@@ -74,7 +94,22 @@ GrGLProgramBuilder::GrGLProgramBuilder(GrGLGpu* gpu, const DrawArgs& args)
     , fArgs(args)
     , fGpu(gpu)
     , fUniforms(kVarsPerBlock)
-    , fSamplerUniforms(4) {
+    , fSamplerUniforms(4)
+    , fProgramID(0)
+    , fDeferStatusChecks(false)
+    , fLoadedBinary(false)
+    , fUsesUniformBlock(false) {
+}
+
+GrGLProgramBuilder::~GrGLProgramBuilder() {
+    if (fProgramID) {
+        this->cleanupProgram(fProgramID, fShadersToDelete);
+    }
+}
+
+void GrGLProgramBuilder::abandon() {
+    fProgramID = 0;
+    fShadersToDelete.reset();
 }
 
 void GrGLProgramBuilder::addVarying(const char* name,
@@ -158,6 +193,8 @@ GrGLProgramDataManager::UniformHandle GrGLProgramBuilder::addUniformArray(
     uni.fVariable.setArrayCount(count);
     uni.fVisibility = visibility;
     uni.fVariable.setPrecision(precision);
+    uni.fLocation = -1;
+    uni.fBlockOffset = -1;
 
     if (outName) {
         *outName = uni.fVariable.c_str();
@@ -168,11 +205,50 @@ GrGLProgramDataManager::UniformHandle GrGLProgramBuilder::addUniformArray(
 void GrGLProgramBuilder::appendUniformDecls(ShaderVisibility visibility,
                                             SkString* out) const {
     for (int i = 0; i < fUniforms.count(); ++i) {
-        if (fUniforms[i].fVisibility & visibility) {
+        if (fUniforms[i].fBlockOffset < 0 && (fUniforms[i].fVisibility & visibility)) {
             fUniforms[i].fVariable.appendDecl(this->ctxInfo(), out);
             out->append(";\n");
         }
     }
+    if (!fUsesUniformBlock) {
+        return;
+    }
+    // The block must be declared identically in every shader that uses it, so it holds all of the
+    // block uniforms regardless of their visibility. Members can't repeat the uniform qualifier
+    // and, on ES, their precisions must agree between the shaders.
+    out->appendf("layout(std140) uniform %s {\n", this->uniformBlockName());
+    for (int i = 0; i < fUniforms.count(); ++i) {
+        if (fUniforms[i].fBlockOffset < 0) {
+            continue;
+        }
+        GrGLShaderVar member(fUniforms[i].fVariable);
+        member.setTypeModifier(GrGLShaderVar::kNone_TypeModifier);
+        if (kDefault_GrSLPrecision == member.getPrecision()) {
+            member.setPrecision(kHigh_GrSLPrecision);
+        }
+        out->append("\t");
+        member.appendDecl(this->ctxInfo(), out);
+        out->append(";\n");
+    }
+    out->append("};\n");
+}
+
+void GrGLProgramBuilder::layoutUniformBlock() {
+    SkASSERT(!fUsesUniformBlock);
+    // Path rendering programs are left alone because NVPR sets some of their inputs by location.
+    if (!fGpu->glCaps().uniformBufferObjectSupport() ||
+        this->primitiveProcessor().isPathRendering()) {
+        return;
+    }
+    size_t size = GrGLProgramDataManager::LayoutUniformBlock(&fUniforms);
+    if (size > 0 && size <= SkTMin<size_t>(fGpu->glCaps().maxUniformBlockSize(),
+                                          GrGLGpu::kUniformBufferSize)) {
+        fUsesUniformBlock = true;
+        return;
+    }
+    for (int i = 0; i < fUniforms.count(); ++i) {
+        fUniforms[i].fBlockOffset = -1;
+    }
 }
 
 const GrGLContextInfo& GrGLProgramBuilder::ctxInfo() const {
@@ -399,48 +475,138 @@ void GrGLProgramBuilder::emitSamplers(const GrProcessor& processor,
     }
 }
 
+// Program binaries in the client's persistent cache are keyed on the driver and the program desc,
+// which determines the generated shaders. The stored data is the binary format followed by the
+// binary itself.
+static SkData* create_binary_key(const GrGLGpu* gpu, const GrProgramDesc& desc) {
+    SkData* key = SkData::NewUninitialized(sizeof(uint32_t) + desc.keyLength());
+    uint32_t* words = static_cast<uint32_t*>(key->writable_data());
+    words[0] = gpu->driverHash();
+    memcpy(&words[1], desc.asKey(), desc.keyLength());
+    return key;
+}
+
+static bool is_linked(const GrGLGpu* gpu, GrGLuint programID) {
+    GrGLint linked = GR_GL_INIT_ZERO;
+    GR_GL_CALL(gpu->glInterface(), GetProgramiv(programID, GR_GL_LINK_STATUS, &linked));
+    return SkToBool(linked);
+}
+
+static bool load_program_binary(const GrGLGpu* gpu, GrGLuint programID, const SkData& key) {
+    SkAutoTUnref<SkData> data(gpu->persistentCache()->load(key));
+    if (!data || data->size() <= sizeof(GrGLenum)) {
+        return false;
+    }
+    GrGLenum format;
+    memcpy(&format, data->data(), sizeof(format));
+    GR_GL_CALL(gpu->glInterface(), ProgramBinary(programID, format,
+                                                 data->bytes() + sizeof(format),
+                                                 SkToInt(data->size() - sizeof(format))));
+    // The driver may reject a binary it made, e.g. after an update that kept the version string.
+    return is_linked(gpu, programID);
+}
+
+static void store_program_binary(const GrGLGpu* gpu, GrGLuint programID, const SkData& key) {
+    if (!is_linked(gpu, programID)) {
+        return;
+    }
+    GrGLint length = 0;
+    GR_GL_CALL(gpu->glInterface(), GetProgramiv(programID, GR_GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) {
+        return;
+    }
+    SkAutoTUnref<SkData> data(SkData::NewUninitialized(sizeof(GrGLenum) + length));
+    uint8_t* bytes = static_cast<uint8_t*>(data->writable_data());
+    GrGLenum format = 0;
+    GrGLsizei written = 0;
+    GR_GL_CALL(gpu->glInterface(), GetProgramBinary(programID, length, &written, &format,
+                                                    bytes + sizeof(format)));
+    if (written != length) {
+        return;
+    }
+    memcpy(bytes, &format, sizeof(format));
+    gpu->persistentCache()->store(key, *data);
+}
+
 GrGLProgram* GrGLProgramBuilder::finalize() {
-    // verify we can get a program id
-    GrGLuint programID;
-    GL_CALL_RET(programID, CreateProgram());
-    if (0 == programID) {
+    if (!this->link()) {
         return NULL;
     }
+    return this->finishProgram();
+}
 
-    // compile shaders and bind attributes / uniforms
-    SkTDArray<GrGLuint> shadersToDelete;
+bool GrGLProgramBuilder::link() {
+    SkASSERT(0 == fProgramID);
+    this->layoutUniformBlock();
 
-    if (!fVS.compileAndAttachShaders(programID, &shadersToDelete)) {
-        this->cleanupProgram(programID, shadersToDelete);
-        return NULL;
+    // verify we can get a program id
+    GL_CALL_RET(fProgramID, CreateProgram());
+    if (0 == fProgramID) {
+        return false;
+    }
+
+    // A binary from an earlier process skips compiling and linking. The resource locations it
+    // was linked with are the ones we would bind now, since they only depend on the desc.
+    if (fGpu->persistentCache()) {
+        fBinaryKey.reset(create_binary_key(fGpu, this->desc()));
+        this->bindProgramResourceLocations(fProgramID);
+        if (load_program_binary(fGpu, fProgramID, *fBinaryKey)) {
+            fLoadedBinary = true;
+            return true;
+        }
+    }
+
+    // compile shaders and bind attributes / uniforms
+    if (!fVS.compileAndAttachShaders(fProgramID, &fShadersToDelete)) {
+        return false;
     }
 
     // NVPR actually requires a vertex shader to compile
     bool useNvpr = primitiveProcessor().isPathRendering();
     if (!useNvpr) {
-        fVS.bindVertexAttributes(programID);
+        fVS.bindVertexAttributes(fProgramID);
     }
 
-    if (!fFS.compileAndAttachShaders(programID, &shadersToDelete)) {
-        this->cleanupProgram(programID, shadersToDelete);
-        return NULL;
+    if (!fFS.compileAndAttachShaders(fProgramID, &fShadersToDelete)) {
+        return false;
     }
 
-    this->bindProgramResourceLocations(programID);
+    this->bindProgramResourceLocations(fProgramID);
 
-    GL_CALL(LinkProgram(programID));
+    if (fBinaryKey && fGpu->glInterface()->fFunctions.fProgramParameteri) {
+        GL_CALL(ProgramParameteri(fProgramID, GR_GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GR_GL_TRUE));
+    }
+    GL_CALL(LinkProgram(fProgramID));
+    return true;
+}
 
-    // Calling GetProgramiv is expensive in Chromium. Assume success in release builds.
-    bool checkLinked = kChromium_GrGLDriver != fGpu->ctxInfo().driver();
+GrGLProgram* GrGLProgramBuilder::finishProgram() {
+    SkASSERT(fProgramID);
+    if (!fLoadedBinary) {
+        // Calling GetProgramiv is expensive in Chromium. Assume success in release builds, unless
+        // shader compile errors were never checked.
+        bool checkLinked = fDeferStatusChecks || kChromium_GrGLDriver != fGpu->ctxInfo().driver();
 #ifdef SK_DEBUG
-    checkLinked = true;
+        checkLinked = true;
 #endif
-    if (checkLinked) {
-        checkLinkStatus(programID);
+        if (checkLinked && !this->checkLinkStatus(fProgramID)) {
+            this->cleanupShaders(fShadersToDelete);
+            fShadersToDelete.reset();
+            fProgramID = 0;
+            return NULL;
+        }
     }
+    GrGLuint programID = fProgramID;
+    fProgramID = 0;
+
     this->resolveProgramResourceLocations(programID);
 
-    this->cleanupShaders(shadersToDelete);
+    this->cleanupShaders(fShadersToDelete);
+    fShadersToDelete.reset();
+
+    if (fBinaryKey && !fLoadedBinary) {
+        store_program_binary(fGpu, programID, *fBinaryKey);
+    }
 
     return this->createProgram(programID);
 }
@@ -450,6 +616,9 @@ void GrGLProgramBuilder::bindProgramResourceLocations(GrGLuint programID) {
     if (usingBindUniform) {
         int count = fUniforms.count();
         for (int i = 0; i < count; ++i) {
+            if (fUniforms[i].fBlockOffset >= 0) {
+                continue;
+            }
             GL_CALL(BindUniformLocation(programID, i, fUniforms[i].fVariable.c_str()));
             fUniforms[i].fLocation = i;
         }
@@ -487,11 +656,23 @@ void GrGLProgramBuilder::resolveProgramResourceLocations(GrGLuint programID) {
     if (!usingBindUniform) {
         int count = fUniforms.count();
         for (int i = 0; i < count; ++i) {
+            if (fUniforms[i].fBlockOffset >= 0) {
+                continue;
+            }
             GrGLint location;
             GL_CALL_RET(location, GetUniformLocation(programID, fUniforms[i].fVariable.c_str()));
             fUniforms[i].fLocation = location;
         }
     }
+
+    // Linking or loading a binary resets the block's binding, so this is always needed.
+    if (fUsesUniformBlock) {
+        GrGLuint blockIndex;
+        GL_CALL_RET(blockIndex, GetUniformBlockIndex(programID, this->uniformBlockName()));
+        if (GR_GL_INVALID_INDEX != blockIndex) {
+            GL_CALL(UniformBlockBinding(programID, blockIndex, GrGLGpu::kUniformBlockBinding));
+        }
+    }
 }
 
 void GrGLProgramBuilder::cleanupProgram(GrGLuint programID, const SkTDArray<GrGLuint>& shaderIDs) {
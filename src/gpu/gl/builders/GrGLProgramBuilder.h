@@ -18,6 +18,7 @@
 #include "../GrGLXferProcessor.h"
 #include "../../GrPendingFragmentStage.h"
 #include "../../GrPipeline.h"
+#include "SkData.h"
 
 // Enough precision to represent 1 / 2048 accurately in printf
 #define GR_SIGNIFICANT_POW2_DECIMAL_DIG 11
@@ -234,6 +235,21 @@ public:
      */
     static GrGLProgram* CreateProgram(const DrawArgs&, GrGLGpu*);
 
+    /** Like CreateProgram, but doesn't wait for the driver to compile and link the shaders. Call
+     *  finishProgram() to get the program. The returned builder doesn't refer to the DrawArgs,
+     *  so it may outlive them. Returns NULL on failure.
+     */
+    static GrGLProgramBuilder* CreatePendingProgram(const DrawArgs&, GrGLGpu*);
+
+    ~GrGLProgramBuilder() override;
+
+    /** Returns the linked program, or NULL if compiling or linking failed. Waits for the driver
+     *  to finish if it is still compiling. */
+    GrGLProgram* finishProgram();
+
+    /** The context was lost; release the program without making GL calls. */
+    void abandon();
+
     UniformHandle addUniformArray(uint32_t visibility,
                                   GrSLType type,
                                   GrSLPrecision precision,
@@ -288,9 +304,9 @@ protected:
 
     const GrPrimitiveProcessor& primitiveProcessor() const { return *fArgs.fPrimitiveProcessor; }
     const GrPipeline& pipeline() const { return *fArgs.fPipeline; }
-    const GrProgramDesc& desc() const { return *fArgs.fDesc; }
+    const GrProgramDesc& desc() const { return fOwnedDesc ? *fOwnedDesc : *fArgs.fDesc; }
     const GrBatchTracker& batchTracker() const { return *fArgs.fBatchTracker; }
-    const GrProgramDesc::KeyHeader& header() const { return fArgs.fDesc->header(); }
+    const GrProgramDesc::KeyHeader& header() const { return this->desc().header(); }
 
     // Generates a name for a variable. The generated string will be name prefixed by the prefix
     // char (unless the prefix is '\0'). It also mangles the name to be stage-specific if we're
@@ -331,6 +347,8 @@ protected:
                       GrGLInstalledProc<Proc>*);
 
     GrGLProgram* finalize();
+    // Issues the compiles and the link (or loads a cached binary) for fProgramID.
+    bool link();
     virtual void bindProgramResourceLocations(GrGLuint programID);
     bool checkLinkStatus(GrGLuint programID);
     virtual void resolveProgramResourceLocations(GrGLuint programID);
@@ -342,6 +360,11 @@ protected:
 
     void appendUniformDecls(ShaderVisibility, SkString*) const;
 
+    // Moves the non-sampler uniforms into a uniform block, if the context supports it and the
+    // block isn't too big. Must be called before the shaders are compiled.
+    void layoutUniformBlock();
+    const char* uniformBlockName() const { return "uniformBlock"; }
+
     // reset is called by program creator between each processor's emit code.  It increments the
     // stage offset for variable name mangling, and also ensures verfication variables in the
     // fragment shader are cleared.
@@ -401,6 +424,18 @@ protected:
     GrGLPrimitiveProcessor::TransformsOut fOutCoords;
     SkTArray<UniformHandle> fSamplerUniforms;
 
+    // The program being linked, and its shaders, between link() and finishProgram().
+    GrGLuint fProgramID;
+    SkTDArray<GrGLuint> fShadersToDelete;
+    // Don't query compile or link status until finishProgram(), so that the driver can work on
+    // them in the background.
+    bool fDeferStatusChecks;
+    bool fLoadedBinary;
+    bool fUsesUniformBlock;
+    SkAutoTUnref<SkData> fBinaryKey;
+    // A copy of the DrawArgs' desc, for pending builders.
+    SkAutoTDelete<GrProgramDesc> fOwnedDesc;
+
     friend class GrGLShaderBuilder;
     friend class GrGLVertexBuilder;
     friend class GrGLFragmentShaderBuilder;
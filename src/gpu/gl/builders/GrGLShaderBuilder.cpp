@@ -210,7 +210,8 @@ GrGLShaderBuilder::finalize(GrGLuint programId, GrGLenum type, SkTDArray<GrGLuin
                                                    fCompilerStrings.begin(),
                                                    fCompilerStringLengths.begin(),
                                                    fCompilerStrings.count(),
-                                                   gpu->stats());
+                                                   gpu->stats(),
+                                                   fProgramBuilder->fDeferStatusChecks);
 
     fFinalized = true;
 
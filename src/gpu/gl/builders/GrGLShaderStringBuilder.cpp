@@ -23,7 +23,8 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
                                     const char** strings,
                                     int* lengths,
                                     int count,
-                                    GrGpu::Stats* stats) {
+                                    GrGpu::Stats* stats,
+                                    bool deferStatusCheck) {
     const GrGLInterface* gli = glCtx.interface();
 
     GrGLuint shaderId;
@@ -54,10 +55,14 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
     GR_GL_CALL(gli, CompileShader(shaderId));
 
     // Calling GetShaderiv in Chromium is quite expensive. Assume success in release builds.
+    // Callers that defer the check rely on the link status to catch compile errors.
     bool checkCompiled = kChromium_GrGLDriver != glCtx.driver();
 #ifdef SK_DEBUG
     checkCompiled = true;
 #endif
+    if (deferStatusCheck) {
+        checkCompiled = false;
+    }
     if (checkCompiled) {
         GrGLint compiled = GR_GL_INIT_ZERO;
         GR_GL_CALL(gli, GetShaderiv(shaderId, GR_GL_COMPILE_STATUS, &compiled));
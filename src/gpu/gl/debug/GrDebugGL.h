@@ -65,6 +65,9 @@ public:
     void setElementArrayBuffer(GrBufferObj *elementArrayBuffer);
     GrBufferObj *getElementArrayBuffer()                            { return fElementArrayBuffer; }
 
+    void setPixelUnpackBuffer(GrBufferObj *pixelUnpackBuffer);
+    GrBufferObj *getPixelUnpackBuffer()                             { return fPixelUnpackBuffer; }
+
     void setVertexArray(GrVertexArrayObj* vertexArray);
     GrVertexArrayObj* getVertexArray() { return fVertexArray; }
 
@@ -130,6 +133,7 @@ private:
     GrGLuint        fCurTextureUnit;
     GrBufferObj*    fArrayBuffer;
     GrBufferObj*    fElementArrayBuffer;
+    GrBufferObj*    fPixelUnpackBuffer;
     GrFrameBufferObj* fFrameBuffer;
     GrRenderBufferObj* fRenderBuffer;
     GrProgramObj* fProgram;
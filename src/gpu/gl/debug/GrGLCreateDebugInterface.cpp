@@ -78,7 +78,8 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBufferData(GrGLenum target,
                                                const GrGLvoid* data,
                                                GrGLenum usage) {
     GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
-                   GR_GL_ELEMENT_ARRAY_BUFFER == target);
+                   GR_GL_ELEMENT_ARRAY_BUFFER == target ||
+                   GR_GL_PIXEL_UNPACK_BUFFER == target);
     GrAlwaysAssert(size >= 0);
     GrAlwaysAssert(GR_GL_STREAM_DRAW == usage ||
                    GR_GL_STATIC_DRAW == usage ||
@@ -92,6 +93,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBufferData(GrGLenum target,
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             buffer = GrDebugGL::getInstance()->getElementArrayBuffer();
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            buffer = GrDebugGL::getInstance()->getPixelUnpackBuffer();
+            break;
         default:
             SkFAIL("Unexpected target to glBufferData");
             break;
@@ -571,7 +575,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBindVertexArray(GrGLuint id) {
 }
 
 GrGLvoid GR_GL_FUNCTION_TYPE debugGLBindBuffer(GrGLenum target, GrGLuint bufferID) {
-    GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target || GR_GL_ELEMENT_ARRAY_BUFFER == target);
+    GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
+                   GR_GL_ELEMENT_ARRAY_BUFFER == target ||
+                   GR_GL_PIXEL_UNPACK_BUFFER == target);
 
     GrBufferObj *buffer = GR_FIND(bufferID,
                                   GrBufferObj,
@@ -585,6 +591,9 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLBindBuffer(GrGLenum target, GrGLuint bufferI
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             GrDebugGL::getInstance()->setElementArrayBuffer(buffer);
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            GrDebugGL::getInstance()->setPixelUnpackBuffer(buffer);
+            break;
         default:
             SkFAIL("Unexpected target to glBindBuffer");
             break;
@@ -607,6 +616,11 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLDeleteBuffers(GrGLsizei n, const GrGLuint* i
             // this ID is the current element array buffer
             GrDebugGL::getInstance()->setElementArrayBuffer(NULL);
         }
+        if (GrDebugGL::getInstance()->getPixelUnpackBuffer() &&
+            ids[i] == GrDebugGL::getInstance()->getPixelUnpackBuffer()->getID()) {
+            // this ID is the current pixel unpack buffer
+            GrDebugGL::getInstance()->setPixelUnpackBuffer(NULL);
+        }
     }
 
     // then actually "delete" the buffers
@@ -625,7 +639,8 @@ GrGLvoid GR_GL_FUNCTION_TYPE debugGLDeleteBuffers(GrGLsizei n, const GrGLuint* i
 GrGLvoid* GR_GL_FUNCTION_TYPE debugGLMapBufferRange(GrGLenum target, GrGLintptr offset,
                                                     GrGLsizeiptr length, GrGLbitfield access) {
     GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
-                   GR_GL_ELEMENT_ARRAY_BUFFER == target);
+                   GR_GL_ELEMENT_ARRAY_BUFFER == target ||
+                   GR_GL_PIXEL_UNPACK_BUFFER == target);
 
     // We only expect read access and we expect that the buffer or range is always invalidated.
     GrAlwaysAssert(!SkToBool(GR_GL_MAP_READ_BIT & access));
@@ -639,6 +654,9 @@ GrGLvoid* GR_GL_FUNCTION_TYPE debugGLMapBufferRange(GrGLenum target, GrGLintptr
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             buffer = GrDebugGL::getInstance()->getElementArrayBuffer();
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            buffer = GrDebugGL::getInstance()->getPixelUnpackBuffer();
+            break;
         default:
             SkFAIL("Unexpected target to glMapBufferRange");
             break;
@@ -680,7 +698,8 @@ GrGLvoid* GR_GL_FUNCTION_TYPE debugGLMapBuffer(GrGLenum target, GrGLenum access)
 GrGLboolean GR_GL_FUNCTION_TYPE debugGLUnmapBuffer(GrGLenum target) {
 
     GrAlwaysAssert(GR_GL_ARRAY_BUFFER == target ||
-                   GR_GL_ELEMENT_ARRAY_BUFFER == target);
+                   GR_GL_ELEMENT_ARRAY_BUFFER == target ||
+                   GR_GL_PIXEL_UNPACK_BUFFER == target);
 
     GrBufferObj *buffer = NULL;
     switch (target) {
@@ -690,6 +709,9 @@ GrGLboolean GR_GL_FUNCTION_TYPE debugGLUnmapBuffer(GrGLenum target) {
         case GR_GL_ELEMENT_ARRAY_BUFFER:
             buffer = GrDebugGL::getInstance()->getElementArrayBuffer();
             break;
+        case GR_GL_PIXEL_UNPACK_BUFFER:
+            buffer = GrDebugGL::getInstance()->getPixelUnpackBuffer();
+            break;
         default:
             SkFAIL("Unexpected target to glUnmapBuffer");
             break;
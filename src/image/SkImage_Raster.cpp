@@ -44,7 +44,7 @@ public:
             return false;
         }
 
-        if (rowBytes < SkImageMinRowBytes(info)) {
+        if (rowBytes < info.minRowBytes()) {
             return false;
         }
 
@@ -230,6 +230,21 @@ SkImage* SkImage::NewFromGenerator(SkImageGenerator* generator, const SkIRect* s
     return SkNEW_ARGS(SkImage_Raster, (bitmap, NULL));
 }
 
+SkImage* SkImage::NewRasterFromGenerator(SkImageGenerator* generator,
+                                         SkBitmap::Allocator* allocator) {
+    SkAutoTDelete<SkImageGenerator> autoGenerator(generator);
+    SkBitmap bitmap;
+    if (NULL == generator || !generator->tryGenerateBitmap(&bitmap, NULL, allocator)) {
+        return NULL;
+    }
+    if (!SkImage_Raster::ValidArgs(bitmap.info(), bitmap.rowBytes(), NULL, NULL)) {
+        return NULL;
+    }
+
+    // The bitmap is immutable, so the image shares its pixel ref rather than copying it.
+    return SkNEW_ARGS(SkImage_Raster, (bitmap, NULL));
+}
+
 SkImage* SkNewImageFromPixelRef(const SkImageInfo& info, SkPixelRef* pr,
                                 const SkIPoint& pixelRefOrigin, size_t rowBytes,
                                 const SkSurfaceProps* props) {
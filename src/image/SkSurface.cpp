@@ -187,6 +187,18 @@ bool SkSurface::readPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t d
     return this->getCanvas()->readPixels(dstInfo, dstPixels, dstRowBytes, srcX, srcY);
 }
 
+SkIRect SkSurface::getDamage() {
+    SkIRect damage;
+    if (!asSB(this)->onGetDamage(&damage)) {
+        damage = SkIRect::MakeWH(fWidth, fHeight);
+    }
+    return damage;
+}
+
+void SkSurface::resetDamage() {
+    asSB(this)->onResetDamage();
+}
+
 GrBackendObject SkSurface::getTextureHandle(BackendHandleAccess access) {
     return asSB(this)->onGetTextureHandle(access);
 }
@@ -74,6 +74,14 @@ public:
      */
     virtual void onRestoreBackingMutability() {}
 
+    /**
+     *  Surfaces that track their damage return true and set damage to the bounds of the pixels
+     *  changed since the last onResetDamage(). The default returns false and getDamage()
+     *  reports the whole surface.
+     */
+    virtual bool onGetDamage(SkIRect*) { return false; }
+    virtual void onResetDamage() {}
+
     inline SkCanvas* getCachedCanvas();
     inline SkImage* getCachedImage(Budgeted);
 
@@ -95,8 +95,9 @@ SkImage* SkSurface_Gpu::onNewImageSnapshot(Budgeted budgeted) {
 }
 
 // Create a new render target and, if necessary, copy the contents of the old
-// render target into it. Note that this flushes the SkGpuDevice but
-// doesn't force an OpenGL flush.
+// render target into it. When the next draw overwrites the whole surface the
+// copy is skipped. Note that this flushes the SkGpuDevice but doesn't force an
+// OpenGL flush.
 void SkSurface_Gpu::onCopyOnWrite(ContentChangeMode mode) {
     GrRenderTarget* rt = fDevice->accessRenderTarget();
     // are we sharing our render target with the image? Note this call should never create a new
@@ -106,6 +107,11 @@ void SkSurface_Gpu::onCopyOnWrite(ContentChangeMode mode) {
     if (rt->asTexture() == as_IB(image)->getTexture()) {
         this->fDevice->replaceRenderTarget(SkSurface::kRetain_ContentChangeMode == mode);
         SkTextureImageApplyBudgetedDecision(image);
+        if (kDiscard_ContentChangeMode == mode) {
+            // The replacement may be a recycled scratch target. Its stale contents needn't be
+            // preserved since the next draw overwrites all of them.
+            this->SkSurface_Gpu::onDiscard();
+        }
     } else if (kDiscard_ContentChangeMode == mode) {
         this->SkSurface_Gpu::onDiscard();
     }
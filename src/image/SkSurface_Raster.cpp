@@ -8,6 +8,7 @@
 #include "SkSurface_Base.h"
 #include "SkImagePriv.h"
 #include "SkCanvas.h"
+#include "SkBitmapDevice.h"
 #include "SkDevice.h"
 #include "SkMallocPixelRef.h"
 
@@ -28,8 +29,14 @@ public:
     void onDraw(SkCanvas*, SkScalar x, SkScalar y, const SkPaint*) override;
     void onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
+    bool onGetDamage(SkIRect*) override;
+    void onResetDamage() override;
 
 private:
+    SkBitmapDevice* getDevice() {
+        return static_cast<SkBitmapDevice*>(this->getCachedCanvas()->getDevice());
+    }
+
     SkBitmap    fBitmap;
     bool        fWeOwnThePixels;
 
@@ -56,6 +63,9 @@ bool SkSurface_Raster::Valid(const SkImageInfo& info, size_t rowBytes) {
         case kN32_SkColorType:
             shift = 2;
             break;
+        case kRGBA_F16_SkColorType:
+            shift = 3;
+            break;
         default:
             return false;
     }
@@ -147,6 +157,8 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
         if (kDiscard_ContentChangeMode == mode) {
             fBitmap.setPixelRef(NULL);
             fBitmap.allocPixels();
+            // The new pixels are uninitialized.
+            this->getDevice()->addDamage(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()));
         } else {
             SkBitmap prev(fBitmap);
             prev.deepCopyTo(&fBitmap);
@@ -159,6 +171,19 @@ void SkSurface_Raster::onCopyOnWrite(ContentChangeMode mode) {
     }
 }
 
+bool SkSurface_Raster::onGetDamage(SkIRect* damage) {
+    SkBitmapDevice* device = this->getDevice();
+    if (!device->isTrackingDamage()) {
+        return false;
+    }
+    *damage = device->getDamage();
+    return true;
+}
+
+void SkSurface_Raster::onResetDamage() {
+    this->getDevice()->resetDamage();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkSurface* SkSurface::NewRasterDirectReleaseProc(const SkImageInfo& info, void* pixels, size_t rb,
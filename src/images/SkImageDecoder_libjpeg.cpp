@@ -8,6 +8,7 @@
 
 #include "SkImageDecoder.h"
 #include "SkImageEncoder.h"
+#include "SkImageEncoderPriv.h"
 #include "SkJpegUtility.h"
 #include "SkColorPriv.h"
 #include "SkDither.h"
@@ -1325,8 +1326,8 @@ static void Write_Index_YUV(uint8_t* SK_RESTRICT dst,
     }
 }
 
-static WriteScanline ChooseWriter(const SkBitmap& bm) {
-    switch (bm.colorType()) {
+static WriteScanline ChooseWriter(SkColorType ct) {
+    switch (ct) {
         case kN32_SkColorType:
             return Write_32_YUV;
         case kRGB_565_SkColorType:
@@ -1342,13 +1343,25 @@ static WriteScanline ChooseWriter(const SkBitmap& bm) {
 
 class SkJPEGImageEncoder : public SkImageEncoder {
 protected:
-    virtual bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) {
+    bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) override {
+        SkAutoLockPixels alp(bm);
+        SkPixmap pixmap;
+        if (NULL == bm.getPixels() || !bm.peekPixels(&pixmap)) {
+            return false;
+        }
+        SkPixmapRowSource source(pixmap);
+        return this->onEncodeRows(stream, bm.info(), &source, quality);
+    }
+
+    bool onEncodeRows(SkWStream* stream, const SkImageInfo& info, RowSource* source,
+                      int quality) override {
 #ifdef TIME_ENCODE
         SkAutoTime atm("JPEG Encode");
 #endif
 
-        SkAutoLockPixels alp(bm);
-        if (NULL == bm.getPixels()) {
+        // The writers need the color table up front, so read the first band now.
+        SkBandReader reader(info, source);
+        if (!reader.row(0)) {
             return false;
         }
 
@@ -1366,15 +1379,15 @@ protected:
         }
 
         // Keep after setjmp or mark volatile.
-        const WriteScanline writer = ChooseWriter(bm);
+        const WriteScanline writer = ChooseWriter(info.colorType());
         if (NULL == writer) {
             return false;
         }
 
         jpeg_create_compress(&cinfo);
         cinfo.dest = &sk_wstream;
-        cinfo.image_width = bm.width();
-        cinfo.image_height = bm.height();
+        cinfo.image_width = info.width();
+        cinfo.image_height = info.height();
         cinfo.input_components = 3;
 #ifdef WE_CONVERT_TO_YUV
         cinfo.in_color_space = JCS_YCbCr;
@@ -1391,19 +1404,22 @@ protected:
 
         jpeg_start_compress(&cinfo, TRUE);
 
-        const int       width = bm.width();
+        const int       width = info.width();
         uint8_t*        oneRowP = (uint8_t*)oneRow.reset(width * 3);
 
-        const SkPMColor* colors = bm.getColorTable() ? bm.getColorTable()->readColors() : NULL;
-        const void*      srcRow = bm.getPixels();
+        const SkPMColor* colors = reader.colorTable() ? reader.colorTable()->readColors() : NULL;
 
         while (cinfo.next_scanline < cinfo.image_height) {
             JSAMPROW row_pointer[1];    /* pointer to JSAMPLE row[s] */
 
+            const void* srcRow = reader.row(cinfo.next_scanline);
+            if (!srcRow) {
+                jpeg_destroy_compress(&cinfo);
+                return false;
+            }
             writer(oneRowP, srcRow, width, colors);
             row_pointer[0] = oneRowP;
             (void) jpeg_write_scanlines(&cinfo, row_pointer, 1);
-            srcRow = (const void*)((const char*)srcRow + bm.rowBytes());
         }
 
         jpeg_finish_compress(&cinfo);
@@ -7,6 +7,7 @@
 
 #include "SkImageDecoder.h"
 #include "SkImageEncoder.h"
+#include "SkImageEncoderPriv.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
 #include "SkDither.h"
@@ -1105,8 +1106,10 @@ static inline int pack_palette(SkColorTable* ctable,
 class SkPNGImageEncoder : public SkImageEncoder {
 protected:
     bool onEncode(SkWStream* stream, const SkBitmap& bm, int quality) override;
+    bool onEncodeRows(SkWStream* stream, const SkImageInfo& info, RowSource* source,
+                      int quality) override;
 private:
-    bool doEncode(SkWStream* stream, const SkBitmap& bm,
+    bool doEncode(SkWStream* stream, const SkImageInfo& info, SkBandReader* reader,
                   const bool& hasAlpha, int colorType,
                   int bitDepth, SkColorType ct,
                   png_color_8& sig_bit);
@@ -1114,10 +1117,22 @@ private:
     typedef SkImageEncoder INHERITED;
 };
 
-bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int /*quality*/) {
-    SkColorType ct = bitmap.colorType();
+bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int quality) {
+    SkAutoLockPixels alp(bitmap);
+    // readyToDraw checks for pixels (and colortable if that is required)
+    SkPixmap pixmap;
+    if (!bitmap.readyToDraw() || !bitmap.peekPixels(&pixmap)) {
+        return false;
+    }
+    SkPixmapRowSource source(pixmap);
+    return this->onEncodeRows(stream, bitmap.info(), &source, quality);
+}
 
-    const bool hasAlpha = !bitmap.isOpaque();
+bool SkPNGImageEncoder::onEncodeRows(SkWStream* stream, const SkImageInfo& info,
+                                     RowSource* source, int /*quality*/) {
+    SkColorType ct = info.colorType();
+
+    const bool hasAlpha = !info.isOpaque();
     int colorType = PNG_COLOR_MASK_COLOR;
     int bitDepth = 8;   // default for color
     png_color_8 sig_bit;
@@ -1157,14 +1172,12 @@ bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int
         sig_bit.alpha = 0;
     }
 
-    SkAutoLockPixels alp(bitmap);
-    // readyToDraw checks for pixels (and colortable if that is required)
-    if (!bitmap.readyToDraw()) {
+    // The palette has to be written before any rows, so read the first band now.
+    SkBandReader reader(info, source);
+    if (!reader.row(0)) {
         return false;
     }
-
-    // we must do this after we have locked the pixels
-    SkColorTable* ctable = bitmap.getColorTable();
+    SkColorTable* ctable = reader.colorTable();
     if (ctable) {
         if (ctable->count() == 0) {
             return false;
@@ -1173,16 +1186,18 @@ bool SkPNGImageEncoder::onEncode(SkWStream* stream, const SkBitmap& bitmap, int
         bitDepth = computeBitDepth(ctable->count());
     }
 
-    return doEncode(stream, bitmap, hasAlpha, colorType, bitDepth, ct, sig_bit);
+    return doEncode(stream, info, &reader, hasAlpha, colorType, bitDepth, ct, sig_bit);
 }
 
-bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
+bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkImageInfo& info, SkBandReader* reader,
                   const bool& hasAlpha, int colorType,
                   int bitDepth, SkColorType ct,
                   png_color_8& sig_bit) {
 
     png_structp png_ptr;
     png_infop info_ptr;
+    // Allocated before setjmp, so a failing row source doesn't leak it.
+    SkAutoSMalloc<1024> rowStorage(info.width() << 2);
 
     png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, sk_error_fn,
                                       NULL);
@@ -1215,7 +1230,7 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     * currently be PNG_COMPRESSION_TYPE_BASE and PNG_FILTER_TYPE_BASE. REQUIRED
     */
 
-    png_set_IHDR(png_ptr, info_ptr, bitmap.width(), bitmap.height(),
+    png_set_IHDR(png_ptr, info_ptr, info.width(), info.height(),
                  bitDepth, colorType,
                  PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
                  PNG_FILTER_TYPE_BASE);
@@ -1224,7 +1239,7 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
     png_color paletteColors[256];
     png_byte trans[256];
     if (kIndex_8_SkColorType == ct) {
-        SkColorTable* ct = bitmap.getColorTable();
+        SkColorTable* ct = reader->colorTable();
         int numTrans = pack_palette(ct, paletteColors, trans, hasAlpha);
         png_set_PLTE(png_ptr, info_ptr, paletteColors, ct->count());
         if (numTrans > 0) {
@@ -1236,16 +1251,17 @@ bool SkPNGImageEncoder::doEncode(SkWStream* stream, const SkBitmap& bitmap,
 #endif
     png_write_info(png_ptr, info_ptr);
 
-    const char* srcImage = (const char*)bitmap.getPixels();
-    SkAutoSMalloc<1024> rowStorage(bitmap.width() << 2);
     char* storage = (char*)rowStorage.get();
     transform_scanline_proc proc = choose_proc(ct, hasAlpha);
 
-    for (int y = 0; y < bitmap.height(); y++) {
+    for (int y = 0; y < info.height(); y++) {
+        const char* srcRow = (const char*)reader->row(y);
+        if (!srcRow) {
+            png_error(png_ptr, "row source failed");
+        }
         png_bytep row_ptr = (png_bytep)storage;
-        proc(srcImage, bitmap.width(), storage);
+        proc(srcRow, info.width(), storage);
         png_write_rows(png_ptr, &row_ptr, 1);
-        srcImage += bitmap.rowBytes();
     }
 
     png_write_end(png_ptr, info_ptr);
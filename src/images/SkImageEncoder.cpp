@@ -6,6 +6,7 @@
  */
 
 #include "SkImageEncoder.h"
+#include "SkImageEncoderPriv.h"
 #include "SkBitmap.h"
 #include "SkStream.h"
 #include "SkTemplates.h"
@@ -25,6 +26,36 @@ bool SkImageEncoder::encodeFile(const char file[], const SkBitmap& bm,
     return this->onEncode(&stream, bm, quality);
 }
 
+bool SkImageEncoder::encodeRows(SkWStream* stream, const SkImageInfo& info, RowSource* source,
+                                int quality) {
+    if (info.isEmpty()) {
+        return false;
+    }
+    quality = SkMin32(100, SkMax32(0, quality));
+    return this->onEncodeRows(stream, info, source, quality);
+}
+
+bool SkImageEncoder::onEncodeRows(SkWStream* stream, const SkImageInfo& info, RowSource* source,
+                                  int quality) {
+    SkBandReader reader(info, source);
+    if (!reader.row(0)) {
+        return false;
+    }
+    SkBitmap bm;
+    if (!bm.tryAllocPixels(info, NULL, reader.colorTable())) {
+        return false;
+    }
+    const size_t rowSize = info.minRowBytes();
+    for (int y = 0; y < info.height(); y++) {
+        const void* row = reader.row(y);
+        if (!row) {
+            return false;
+        }
+        memcpy(bm.getAddr(0, y), row, rowSize);
+    }
+    return this->onEncode(stream, bm, quality);
+}
+
 SkData* SkImageEncoder::encodeData(const SkBitmap& bm, int quality) {
     SkDynamicMemoryWStream stream;
     quality = SkMin32(100, SkMax32(0, quality));
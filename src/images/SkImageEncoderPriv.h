@@ -0,0 +1,66 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageEncoderPriv_DEFINED
+#define SkImageEncoderPriv_DEFINED
+
+#include "SkImageEncoder.h"
+#include "SkPixmap.h"
+
+/**
+ *  Hands an encoder all of a pixmap's rows as one band, so onEncode() can share its
+ *  implementation with onEncodeRows().
+ */
+class SkPixmapRowSource : public SkImageEncoder::RowSource {
+public:
+    explicit SkPixmapRowSource(const SkPixmap& pixmap) : fPixmap(pixmap) {}
+
+    bool nextBand(int y, SkPixmap* band) override {
+        return fPixmap.extractSubset(band, SkIRect::MakeLTRB(0, y, fPixmap.width(),
+                                                                fPixmap.height()));
+    }
+
+private:
+    const SkPixmap& fPixmap;
+};
+
+/**
+ *  Reads the rows of an image from a RowSource in order, fetching the next band when the current
+ *  one runs out, and checking each band against the image's info.
+ */
+class SkBandReader {
+public:
+    SkBandReader(const SkImageInfo& info, SkImageEncoder::RowSource* source)
+        : fInfo(info), fSource(source), fTop(0) {}
+
+    /** Returns row y's pixels, or NULL if the source fails.  y must not decrease between calls. */
+    const void* row(int y) {
+        SkASSERT(y >= fTop && y < fInfo.height());
+        if (!fBand.addr() || y >= fTop + fBand.height()) {
+            fTop = y;
+            if (!fSource->nextBand(y, &fBand) || !fBand.addr() || fBand.height() <= 0 ||
+                fBand.width()     != fInfo.width()     ||
+                fBand.colorType() != fInfo.colorType() ||
+                fBand.alphaType() != fInfo.alphaType()) {
+                fBand.reset();
+                return NULL;
+            }
+        }
+        return fBand.addr(0, y - fTop);
+    }
+
+    /** The color table of the band last read, for kIndex_8_SkColorType. */
+    SkColorTable* colorTable() const { return fBand.ctable(); }
+
+private:
+    const SkImageInfo&          fInfo;
+    SkImageEncoder::RowSource*  fSource;
+    SkPixmap                    fBand;
+    int                         fTop;  // The row fBand starts at.
+};
+
+#endif
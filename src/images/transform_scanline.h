@@ -78,6 +78,28 @@ static void transform_scanline_444(const char* SK_RESTRICT src, int width,
     }
 }
 
+/**
+ * Unpremultiply one kARGB_8888_Config pixel into 4-bytes-per-pixel RGBA.
+ */
+static inline void unpremultiply_8888(SkPMColor c, const SkUnPreMultiply::Scale* table,
+                                      char* SK_RESTRICT dst) {
+    unsigned a = SkGetPackedA32(c);
+    unsigned r = SkGetPackedR32(c);
+    unsigned g = SkGetPackedG32(c);
+    unsigned b = SkGetPackedB32(c);
+
+    if (0 != a && 255 != a) {
+        SkUnPreMultiply::Scale scale = table[a];
+        r = SkUnPreMultiply::ApplyScale(scale, r);
+        g = SkUnPreMultiply::ApplyScale(scale, g);
+        b = SkUnPreMultiply::ApplyScale(scale, b);
+    }
+    dst[0] = r;
+    dst[1] = g;
+    dst[2] = b;
+    dst[3] = a;
+}
+
 /**
  * Transform from kARGB_8888_Config to 4-bytes-per-pixel RGBA.
  * (This would be the identity transformation, except for byte-order and
@@ -89,23 +111,25 @@ static void transform_scanline_8888(const char* SK_RESTRICT src, int width,
     const SkUnPreMultiply::Scale* SK_RESTRICT table =
                                               SkUnPreMultiply::GetScaleTable();
 
-    for (int i = 0; i < width; i++) {
-        SkPMColor c = *srcP++;
-        unsigned a = SkGetPackedA32(c);
-        unsigned r = SkGetPackedR32(c);
-        unsigned g = SkGetPackedG32(c);
-        unsigned b = SkGetPackedB32(c);
-
-        if (0 != a && 255 != a) {
-            SkUnPreMultiply::Scale scale = table[a];
-            r = SkUnPreMultiply::ApplyScale(scale, r);
-            g = SkUnPreMultiply::ApplyScale(scale, g);
-            b = SkUnPreMultiply::ApplyScale(scale, b);
+    // Most pixels are opaque and need no unpremultiplying, so check four at a time and just
+    // repack groups that are all opaque.
+    int i = 0;
+    for (; i + 4 <= width; i += 4, srcP += 4, dst += 16) {
+        if (255 == SkGetPackedA32(srcP[0] & srcP[1] & srcP[2] & srcP[3])) {
+            for (int j = 0; j < 4; j++) {
+                dst[4*j + 0] = SkGetPackedR32(srcP[j]);
+                dst[4*j + 1] = SkGetPackedG32(srcP[j]);
+                dst[4*j + 2] = SkGetPackedB32(srcP[j]);
+                dst[4*j + 3] = (char)255;
+            }
+        } else {
+            for (int j = 0; j < 4; j++) {
+                unpremultiply_8888(srcP[j], table, dst + 4*j);
+            }
         }
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
-        *dst++ = a;
+    }
+    for (; i < width; i++, srcP++, dst += 4) {
+        unpremultiply_8888(*srcP, table, dst);
     }
 }
 
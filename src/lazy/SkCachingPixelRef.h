@@ -50,6 +50,23 @@ protected:
         return fImageGenerator->refEncodedData();
     }
 
+    SkISize onGetScaledDimensions(SkScalar desiredScale) override {
+        return fImageGenerator->getScaledDimensions(desiredScale);
+    }
+    bool onGenerateScaledPixels(const SkImageInfo& info, void* pixels, size_t rowBytes) override {
+        return fImageGenerator->getPixels(info, pixels, rowBytes);
+    }
+
+    bool onGetYUV8Planes(SkISize sizes[3], void* planes[3], size_t rowBytes[3],
+                         SkYUVColorSpace* colorSpace) override {
+        // Like SkDiscardablePixelRef, don't re-decode to YUV8 planes while the
+        // RGBA pixels are locked.
+        if (fLockedBitmap.getPixels()) {
+            return false;
+        }
+        return fImageGenerator->getYUV8Planes(sizes, planes, rowBytes, colorSpace);
+    }
+
 private:
     SkImageGenerator* const fImageGenerator;
     bool                    fErrorInDecoding;
@@ -33,6 +33,13 @@ protected:
         return fGenerator->refEncodedData();
     }
 
+    SkISize onGetScaledDimensions(SkScalar desiredScale) override {
+        return fGenerator->getScaledDimensions(desiredScale);
+    }
+    bool onGenerateScaledPixels(const SkImageInfo& info, void* pixels, size_t rowBytes) override {
+        return fGenerator->getPixels(info, pixels, rowBytes);
+    }
+
 private:
     SkImageGenerator* const fGenerator;
     SkDiscardableMemory::Factory* const fDMFactory;
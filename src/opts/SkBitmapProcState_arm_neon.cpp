@@ -40,6 +40,7 @@ const SkBitmapProcState::SampleProc32 gSkBitmapProcStateSample32_neon[] = {
     S16_opaque_D32_filter_DX_neon,
     S16_alpha_D32_filter_DX_neon,
 
+#ifndef SK_LEAN_COLOR_TYPES
     SI8_opaque_D32_nofilter_DXDY_neon,
     SI8_alpha_D32_nofilter_DXDY_neon,
     SI8_opaque_D32_nofilter_DX_neon,
@@ -57,6 +58,10 @@ const SkBitmapProcState::SampleProc32 gSkBitmapProcStateSample32_neon[] = {
     S4444_alpha_D32_filter_DXDY_neon,
     S4444_opaque_D32_filter_DX_neon,
     S4444_alpha_D32_filter_DX_neon,
+#else
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+#endif
 
     // A8 treats alpha/opauqe the same (equally efficient)
     SA8_alpha_D32_nofilter_DXDY_neon,
@@ -90,10 +95,14 @@ const SkBitmapProcState::SampleProc16 gSkBitmapProcStateSample16_neon[] = {
     S16_D16_filter_DXDY_neon,
     S16_D16_filter_DX_neon,
 
+#ifndef SK_LEAN_COLOR_TYPES
     SI8_D16_nofilter_DXDY_neon,
     SI8_D16_nofilter_DX_neon,
     SI8_D16_filter_DXDY_neon,
     SI8_D16_filter_DX_neon,
+#else
+    NULL, NULL, NULL, NULL,
+#endif
 
     // Don't support 4444 -> 565
     NULL, NULL, NULL, NULL,
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitRow_opts_AVX2.h"
+
+// Some compilers can't compile AVX2 intrinsics.  We give them stub methods.
+// The stubs should never be called, so we make them crash just to confirm that.
+#if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT, const SkPMColor* SK_RESTRICT, int, U8CPU) {
+    sk_throw();
+}
+
+#else
+
+#include <immintrin.h>      // AVX2 intrinsics
+#include "SkColorPriv.h"
+
+// The same math as SkPMSrcOver_SSE2(), eight pixels at a time.
+static inline __m256i SkPMSrcOver_AVX2(const __m256i& src, const __m256i& dst) {
+    const __m256i mask = _mm256_set1_epi32(0xFF00FF);
+
+    // 256 - alpha, replicated into both 16-bit halves of each pixel.
+    __m256i alpha = _mm256_srli_epi32(_mm256_slli_epi32(src, 24 - SK_A32_SHIFT), 24);
+    __m256i scale = _mm256_sub_epi32(_mm256_set1_epi32(256), alpha);
+    scale = _mm256_or_si256(_mm256_slli_epi32(scale, 16), scale);
+
+    // rb = ((dst & mask) * scale) >> 8
+    __m256i rb = _mm256_and_si256(mask, dst);
+    rb = _mm256_srli_epi16(_mm256_mullo_epi16(rb, scale), 8);
+
+    // ag = ((dst >> 8) & mask) * scale, keeping the high bytes.
+    __m256i ag = _mm256_srli_epi16(dst, 8);
+    ag = _mm256_andnot_si256(mask, _mm256_mullo_epi16(ag, scale));
+
+    return _mm256_add_epi32(src, _mm256_or_si256(rb, ag));
+}
+
+void S32A_Opaque_BlitRow32_AVX2(SkPMColor* SK_RESTRICT dst,
+                                const SkPMColor* SK_RESTRICT src,
+                                int count,
+                                U8CPU alpha) {
+    SkASSERT(alpha == 255);
+    // As long as we can, we'll work on 32 pixels at once.
+    int count32 = count / 32;
+    __m256i* dst8 = (__m256i*)dst;
+    const __m256i* src8 = (const __m256i*)src;
+
+    const __m256i alphaMask = _mm256_set1_epi32(0xFF << SK_A32_SHIFT);
+    for (int i = 0; i < count32 * 4; i += 4) {
+        // Load 32 source pixels.
+        __m256i s0 = _mm256_loadu_si256(src8+i+0),
+                s1 = _mm256_loadu_si256(src8+i+1),
+                s2 = _mm256_loadu_si256(src8+i+2),
+                s3 = _mm256_loadu_si256(src8+i+3);
+
+        const __m256i ORed = _mm256_or_si256(s3, _mm256_or_si256(s2, _mm256_or_si256(s1, s0)));
+        if (_mm256_testz_si256(ORed, alphaMask)) {
+            // All 32 source pixels are fully transparent.  There's nothing to do!
+            continue;
+        }
+        const __m256i ANDed = _mm256_and_si256(s3, _mm256_and_si256(s2, _mm256_and_si256(s1, s0)));
+        if (_mm256_testc_si256(ANDed, alphaMask)) {
+            // All 32 source pixels are fully opaque.  There's no need to read dst or blend it.
+            _mm256_storeu_si256(dst8+i+0, s0);
+            _mm256_storeu_si256(dst8+i+1, s1);
+            _mm256_storeu_si256(dst8+i+2, s2);
+            _mm256_storeu_si256(dst8+i+3, s3);
+            continue;
+        }
+        // The general slow case: do the blend for all 32 pixels.
+        _mm256_storeu_si256(dst8+i+0, SkPMSrcOver_AVX2(s0, _mm256_loadu_si256(dst8+i+0)));
+        _mm256_storeu_si256(dst8+i+1, SkPMSrcOver_AVX2(s1, _mm256_loadu_si256(dst8+i+1)));
+        _mm256_storeu_si256(dst8+i+2, SkPMSrcOver_AVX2(s2, _mm256_loadu_si256(dst8+i+2)));
+        _mm256_storeu_si256(dst8+i+3, SkPMSrcOver_AVX2(s3, _mm256_loadu_si256(dst8+i+3)));
+    }
+
+    // Wrap up the last <= 31 pixels eight at a time, then one at a time.
+    int i = count32 * 32;
+    for ( ; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        if (!_mm256_testz_si256(s, alphaMask)) {
+            __m256i* d = (__m256i*)(dst + i);
+            _mm256_storeu_si256(d, SkPMSrcOver_AVX2(s, _mm256_loadu_si256(d)));
+        }
+    }
+    for ( ; i < count; i++) {
+        // This check is not really necessarily, but it prevents pointless autovectorization.
+        if (src[i] & 0xFF000000) {
+            dst[i] = SkPMSrcOver(src[i], dst[i]);
+        }
+    }
+}
+
+#endif
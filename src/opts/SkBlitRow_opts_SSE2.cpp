@@ -305,6 +305,7 @@ void SkARGB32_A8_BlitMask_SSE2(void* device, size_t dstRB, const void* maskPtr,
                                size_t maskRB, SkColor origColor,
                                int width, int height) {
     SkPMColor color = SkPreMultiplyColor(origColor);
+    const bool opaque = 0xFF == SkGetPackedA32(color);
     size_t dstOffset = dstRB - (width << 2);
     size_t maskOffset = maskRB - width;
     SkPMColor* dst = (SkPMColor *)device;
@@ -321,16 +322,44 @@ void SkARGB32_A8_BlitMask_SSE2(void* device, size_t dstRB, const void* maskPtr,
             __m128i *d = reinterpret_cast<__m128i*>(dst);
             __m128i src_pixel = _mm_set1_epi32(color);
             while (count >= 4) {
-                // Load 4 dst pixels
-                __m128i dst_pixel = _mm_load_si128(d);
-
-                // Set the alpha value
-                __m128i alpha_wide = _mm_cvtsi32_si128(*reinterpret_cast<const uint32_t*>(mask));
-                alpha_wide = _mm_unpacklo_epi8(alpha_wide, _mm_setzero_si128());
-                alpha_wide = _mm_unpacklo_epi16(alpha_wide, _mm_setzero_si128());
-
-                __m128i result = SkBlendARGB32_SSE2(src_pixel, dst_pixel, alpha_wide);
-                _mm_store_si128(d, result);
+                // Skip runs of zero coverage and, for opaque colors, fill runs of full coverage
+                // sixteen pixels at a time. Large glyphs and shapes are mostly made of these.
+                if (count >= 16) {
+                    __m128i aa16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+                    if (0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(aa16, _mm_setzero_si128()))) {
+                        mask += 16;
+                        d += 4;
+                        count -= 16;
+                        continue;
+                    }
+                    if (opaque &&
+                        0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(aa16, _mm_set1_epi8(-1)))) {
+                        _mm_store_si128(d + 0, src_pixel);
+                        _mm_store_si128(d + 1, src_pixel);
+                        _mm_store_si128(d + 2, src_pixel);
+                        _mm_store_si128(d + 3, src_pixel);
+                        mask += 16;
+                        d += 4;
+                        count -= 16;
+                        continue;
+                    }
+                }
+
+                uint32_t aa4 = *reinterpret_cast<const uint32_t*>(mask);
+                if (opaque && 0xFFFFFFFF == aa4) {
+                    _mm_store_si128(d, src_pixel);
+                } else if (0 != aa4) {
+                    // Load 4 dst pixels
+                    __m128i dst_pixel = _mm_load_si128(d);
+
+                    // Set the alpha value
+                    __m128i alpha_wide = _mm_cvtsi32_si128(aa4);
+                    alpha_wide = _mm_unpacklo_epi8(alpha_wide, _mm_setzero_si128());
+                    alpha_wide = _mm_unpacklo_epi16(alpha_wide, _mm_setzero_si128());
+
+                    __m128i result = SkBlendARGB32_SSE2(src_pixel, dst_pixel, alpha_wide);
+                    _mm_store_si128(d, result);
+                }
                 // Load the next 4 dst pixels and alphas
                 mask = mask + 4;
                 d++;
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkBlurMask_opts_DEFINED
+#define SkBlurMask_opts_DEFINED
+
+#include "SkTypes.h"
+
+// These procs step a vertical box blur of an A8 mask down one row, for count columns at once.
+// sums holds each column's running sum; the row at add enters the window, the row at sub leaves
+// it after the output is written.  The arithmetic matches the scalar blurs in SkBlurMask.cpp.
+
+namespace SK_OPTS_NS {
+
+static void blur_mask_row_portable(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                                   const uint8_t sub[], uint32_t scale, int count) {
+    const uint32_t half = 1 << 23;
+    for (int i = 0; i < count; i++) {
+        sums[i] += add[i];
+        dst[i] = (sums[i] * scale + half) >> 24;
+        sums[i] -= sub[i];
+    }
+}
+
+// Interpolates between the window in sums and a window one smaller at each end: the inner window
+// is the outer one before add enters, less the row at inner.
+static void blur_mask_interp_row_portable(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                                          const uint8_t sub[], const uint8_t inner[],
+                                          uint32_t outerScale, uint32_t innerScale, int count) {
+    const uint32_t half = 1 << 23;
+    for (int i = 0; i < count; i++) {
+        uint32_t innerSum = sums[i] - inner[i];
+        uint32_t outerSum = sums[i] + add[i];
+        dst[i] = (outerSum * outerScale + innerSum * innerScale + half) >> 24;
+        sums[i] = outerSum - sub[i];
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+// SSE2 has no 32 bit mullo, so multiply the even and odd lanes separately.
+static inline __m128i mullo_32(__m128i a, __m128i b) {
+    __m128i mul20 = _mm_mul_epu32(a, b),
+            mul31 = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(mul20, _MM_SHUFFLE(0,0,2,0)),
+                              _mm_shuffle_epi32(mul31, _MM_SHUFFLE(0,0,2,0)));
+}
+
+// Zero extends 16 bytes into four vectors of 32 bit lanes.
+static inline void widen_8_to_32(__m128i bytes, __m128i wide[4]) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = _mm_unpacklo_epi8(bytes, zero),
+                  hi = _mm_unpackhi_epi8(bytes, zero);
+    wide[0] = _mm_unpacklo_epi16(lo, zero);
+    wide[1] = _mm_unpackhi_epi16(lo, zero);
+    wide[2] = _mm_unpacklo_epi16(hi, zero);
+    wide[3] = _mm_unpackhi_epi16(hi, zero);
+}
+
+// Packs four vectors of 32 bit lanes, each already <= 255, into 16 bytes.
+static inline __m128i narrow_32_to_8(const __m128i wide[4]) {
+    return _mm_packus_epi16(_mm_packs_epi32(wide[0], wide[1]),
+                            _mm_packs_epi32(wide[2], wide[3]));
+}
+
+// Sixteen columns at a time.
+static void blur_mask_row(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                          const uint8_t sub[], uint32_t scale, int count) {
+    const __m128i vscale = _mm_set1_epi32(scale),
+                  half   = _mm_set1_epi32(1 << 23);
+    for (; count >= 16; count -= 16) {
+        __m128i adds[4], subs[4], out[4];
+        widen_8_to_32(_mm_loadu_si128((const __m128i*)add), adds);
+        widen_8_to_32(_mm_loadu_si128((const __m128i*)sub), subs);
+        for (int k = 0; k < 4; k++) {
+            __m128i sum = _mm_add_epi32(_mm_loadu_si128((const __m128i*)sums + k), adds[k]);
+            out[k] = _mm_srli_epi32(_mm_add_epi32(mullo_32(sum, vscale), half), 24);
+            _mm_storeu_si128((__m128i*)sums + k, _mm_sub_epi32(sum, subs[k]));
+        }
+        _mm_storeu_si128((__m128i*)dst, narrow_32_to_8(out));
+        dst += 16;
+        sums += 16;
+        add += 16;
+        sub += 16;
+    }
+    blur_mask_row_portable(dst, sums, add, sub, scale, count);
+}
+
+static void blur_mask_interp_row(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                                 const uint8_t sub[], const uint8_t inner[],
+                                 uint32_t outerScale, uint32_t innerScale, int count) {
+    const __m128i vouter = _mm_set1_epi32(outerScale),
+                  vinner = _mm_set1_epi32(innerScale),
+                  half   = _mm_set1_epi32(1 << 23);
+    for (; count >= 16; count -= 16) {
+        __m128i adds[4], subs[4], inners[4], out[4];
+        widen_8_to_32(_mm_loadu_si128((const __m128i*)add), adds);
+        widen_8_to_32(_mm_loadu_si128((const __m128i*)sub), subs);
+        widen_8_to_32(_mm_loadu_si128((const __m128i*)inner), inners);
+        for (int k = 0; k < 4; k++) {
+            __m128i sum      = _mm_loadu_si128((const __m128i*)sums + k),
+                    innerSum = _mm_sub_epi32(sum, inners[k]),
+                    outerSum = _mm_add_epi32(sum, adds[k]);
+            out[k] = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(mullo_32(outerSum, vouter),
+                                                                mullo_32(innerSum, vinner)),
+                                                  half), 24);
+            _mm_storeu_si128((__m128i*)sums + k, _mm_sub_epi32(outerSum, subs[k]));
+        }
+        _mm_storeu_si128((__m128i*)dst, narrow_32_to_8(out));
+        dst += 16;
+        sums += 16;
+        add += 16;
+        sub += 16;
+        inner += 16;
+    }
+    blur_mask_interp_row_portable(dst, sums, add, sub, inner, outerScale, innerScale, count);
+}
+
+#else
+
+static void blur_mask_row(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                          const uint8_t sub[], uint32_t scale, int count) {
+    blur_mask_row_portable(dst, sums, add, sub, scale, count);
+}
+
+static void blur_mask_interp_row(uint8_t dst[], uint32_t sums[], const uint8_t add[],
+                                 const uint8_t sub[], const uint8_t inner[],
+                                 uint32_t outerScale, uint32_t innerScale, int count) {
+    blur_mask_interp_row_portable(dst, sums, add, sub, inner, outerScale, innerScale, count);
+}
+
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkBlurMask_opts_DEFINED
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkColorCubeFilter_opts_DEFINED
+#define SkColorCubeFilter_opts_DEFINED
+
+#include "SkColor.h"
+#include "SkColorPriv.h"
+#include "SkNx.h"
+#include "SkUnPreMultiply.h"
+
+namespace SK_OPTS_NS {
+
+// Spreads the bytes of c across an Sk4f: b, g, r, a.
+static inline Sk4f color_to_floats(SkColor c) {
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    const __m128i zeros = _mm_setzero_si128();
+    return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)c),
+                                                                zeros), zeros));
+#elif !defined(SKNX_NO_SIMD) && defined(SK_ARM_HAS_NEON)
+    const uint16x8_t c16 = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(c)));
+    return vcvtq_f32_u32(vmovl_u16(vget_low_u16(c16)));
+#else
+    return Sk4f((float)SkColorGetB(c), (float)SkColorGetG(c),
+                (float)SkColorGetR(c), (float)SkColorGetA(c));
+#endif
+}
+
+// Trilinearly interpolates the cube at each unpremultiplied color. All three channels of a
+// corner are weighted with one multiply-add, and the result is premultiplied and rounded in the
+// same Sk4f.
+static void color_cube_filter_span(const SkPMColor src[], int count, SkPMColor dst[],
+                                   const int* colorToIndex[2], const SkScalar* colorToFactors[2],
+                                   int dim, const SkColor* colorCube) {
+    for (int i = 0; i < count; ++i) {
+        const U8CPU a = SkGetPackedA32(src[i]);
+        if (0 == a) {
+            dst[i] = 0;
+            continue;
+        }
+        const SkColor input = SkUnPreMultiply::PMColorToColor(src[i]);
+        const U8CPU r = SkColorGetR(input),
+                    g = SkColorGetG(input),
+                    b = SkColorGetB(input);
+
+        Sk4f color(0);
+        for (int x = 0; x < 2; ++x) {
+            const int rIndex = colorToIndex[x][r];
+            const SkScalar rFactor = colorToFactors[x][r];
+            for (int y = 0; y < 2; ++y) {
+                const int rgIndex = rIndex + colorToIndex[y][g] * dim;
+                const SkScalar rgFactor = rFactor * colorToFactors[y][g];
+                for (int z = 0; z < 2; ++z) {
+                    const SkColor lutColor = colorCube[rgIndex + colorToIndex[z][b] * dim * dim];
+                    color = color + color_to_floats(lutColor) *
+                                    Sk4f(rgFactor * colorToFactors[z][b]);
+                }
+            }
+        }
+
+        // Premultiply by the source alpha; the 0.5 rounds as we truncate.
+        color = color * Sk4f(a * (1.0f / 255)) + Sk4f(0.5f);
+        dst[i] = SkPackARGB32(a, SkTMin((U8CPU)color.kth<2>(), a),
+                                 SkTMin((U8CPU)color.kth<1>(), a),
+                                 SkTMin((U8CPU)color.kth<0>(), a));
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkColorCubeFilter_opts_DEFINED
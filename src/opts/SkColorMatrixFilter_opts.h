@@ -0,0 +1,139 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkColorMatrixFilter_opts_DEFINED
+#define SkColorMatrixFilter_opts_DEFINED
+
+#include "SkColorPriv.h"
+#include "SkNx.h"
+
+// Applies a 4x5 color matrix to four pixels at a time. The pixels are split into one Sk4f per
+// channel, so each output channel is four multiply-adds shared by all four pixels, and the
+// unpremultiply takes one vector reciprocal for all four alphas.
+
+namespace SK_OPTS_NS {
+
+#if !defined(SKNX_NO_SIMD) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+// Splits four pixels into one Sk4f per byte, in SkPMColor byte order, each in [0, 255].
+static inline void load_planes(const SkPMColor src[4], Sk4f planes[4]) {
+    const __m128i px = _mm_loadu_si128((const __m128i*)src),
+                  mask = _mm_set1_epi32(0xFF);
+    planes[0] = _mm_cvtepi32_ps(_mm_and_si128(px, mask));
+    planes[1] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px,  8), mask));
+    planes[2] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 16), mask));
+    planes[3] = _mm_cvtepi32_ps(_mm_srli_epi32(px, 24));
+}
+
+// Truncates four planes in [0, 255] back to bytes and packs them into four pixels.
+static inline void store_planes(const Sk4f planes[4], SkPMColor dst[4]) {
+    const __m128i px = _mm_or_si128(
+            _mm_or_si128(_mm_cvttps_epi32(planes[0].fVec),
+                         _mm_slli_epi32(_mm_cvttps_epi32(planes[1].fVec),  8)),
+            _mm_or_si128(_mm_slli_epi32(_mm_cvttps_epi32(planes[2].fVec), 16),
+                         _mm_slli_epi32(_mm_cvttps_epi32(planes[3].fVec), 24)));
+    _mm_storeu_si128((__m128i*)dst, px);
+}
+
+#elif !defined(SKNX_NO_SIMD) && defined(SK_ARM_HAS_NEON)
+
+static inline void load_planes(const SkPMColor src[4], Sk4f planes[4]) {
+    const uint32x4_t px = vld1q_u32(src),
+                     mask = vdupq_n_u32(0xFF);
+    planes[0] = vcvtq_f32_u32(vandq_u32(px, mask));
+    planes[1] = vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px,  8), mask));
+    planes[2] = vcvtq_f32_u32(vandq_u32(vshrq_n_u32(px, 16), mask));
+    planes[3] = vcvtq_f32_u32(vshrq_n_u32(px, 24));
+}
+
+static inline void store_planes(const Sk4f planes[4], SkPMColor dst[4]) {
+    const uint32x4_t px = vorrq_u32(
+            vorrq_u32(vcvtq_u32_f32(planes[0].fVec),
+                      vshlq_n_u32(vcvtq_u32_f32(planes[1].fVec),  8)),
+            vorrq_u32(vshlq_n_u32(vcvtq_u32_f32(planes[2].fVec), 16),
+                      vshlq_n_u32(vcvtq_u32_f32(planes[3].fVec), 24)));
+    vst1q_u32(dst, px);
+}
+
+#else  // No SIMD Sk4f.
+
+static inline void load_planes(const SkPMColor src[4], Sk4f planes[4]) {
+    for (int i = 0; i < 4; i++) {
+        float bytes[4];
+        for (int j = 0; j < 4; j++) {
+            bytes[j] = (float)((src[j] >> (8 * i)) & 0xFF);
+        }
+        planes[i] = Sk4f::Load(bytes);
+    }
+}
+
+static inline void store_planes(const Sk4f planes[4], SkPMColor dst[4]) {
+    float bytes[4][4];
+    for (int i = 0; i < 4; i++) {
+        planes[i].store(bytes[i]);
+    }
+    for (int j = 0; j < 4; j++) {
+        dst[j] = (uint32_t)bytes[0][j]       | (uint32_t)bytes[1][j] <<  8 |
+                 (uint32_t)bytes[2][j] << 16 | (uint32_t)bytes[3][j] << 24;
+    }
+}
+
+#endif
+
+// Filters four pixels. transpose is the matrix's columns, each in SkPMColor byte order, with the
+// translate column in [0, 255]; see SkColorMatrixFilter.
+static inline void color_matrix_4(const float transpose[20], const SkPMColor src[4],
+                                  SkPMColor dst[4]) {
+    Sk4f in[4];
+    load_planes(src, in);
+
+    // Unpremultiply to [0, 1]. Transparent pixels become transparent black.
+    const Sk4f a = in[SK_A32_SHIFT / 8];
+    const Sk4f invA = (a > Sk4f(0)).thenElse(a.invert(), Sk4f(0));
+    const Sk4f r = in[SK_R32_SHIFT / 8] * invA,
+               g = in[SK_G32_SHIFT / 8] * invA,
+               b = in[SK_B32_SHIFT / 8] * invA,
+               unitA = a * Sk4f(1.0f / 255);
+
+    Sk4f out[4];
+    for (int k = 0; k < 4; k++) {
+        out[k] = Sk4f(transpose[k +  0]) * r +
+                 Sk4f(transpose[k +  4]) * g +
+                 Sk4f(transpose[k +  8]) * b +
+                 Sk4f(transpose[k + 12]) * unitA +
+                 Sk4f(transpose[k + 16] * (1.0f / 255));
+        out[k] = Sk4f::Max(Sk4f::Min(out[k], Sk4f(1)), Sk4f(0));
+    }
+
+    // Premultiply, scale to [0, 255] and round.
+    const Sk4f outA = out[SK_A32_SHIFT / 8];
+    const Sk4f scale = outA * Sk4f(255);
+    for (int k = 0; k < 4; k++) {
+        out[k] = (k == SK_A32_SHIFT / 8 ? Sk4f(255) * outA : scale * out[k]) + Sk4f(0.5f);
+    }
+    store_planes(out, dst);
+}
+
+static void color_matrix_filter_span(const float transpose[20], const SkPMColor src[],
+                                     int count, SkPMColor dst[]) {
+    while (count >= 4) {
+        color_matrix_4(transpose, src, dst);
+        src += 4;
+        dst += 4;
+        count -= 4;
+    }
+    if (count > 0) {
+        SkPMColor tmp[4] = { 0, 0, 0, 0 };
+        memcpy(tmp, src, count * sizeof(SkPMColor));
+        color_matrix_4(transpose, tmp, tmp);
+        memcpy(dst, tmp, count * sizeof(SkPMColor));
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkColorMatrixFilter_opts_DEFINED
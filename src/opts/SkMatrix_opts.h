@@ -0,0 +1,219 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrix_opts_DEFINED
+#define SkMatrix_opts_DEFINED
+
+#include "SkMatrix.h"
+
+// Each proc maps count points from src to dst, which may be the same array, through the nine
+// values of a matrix, in SkMatrix's order, of at most the type it's named for. Every point maps
+// to the same bits whether it's mapped in a step or on its own: its x and y are computed in the
+// same order, and a point whose w is zero is scaled by zero rather than divided by it.
+//
+// The AVX2 procs map four points per step with 256-bit registers. The others map two per step
+// with Sk4s, which isn't used in the AVX2 build: like Sk4px, its inline functions have external
+// linkage, and the linker could hand AVX2 copies of them to callers that only have SSE2. For the
+// same reason the procs take the matrix's values rather than calling SkMatrix's accessors.
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    #include <immintrin.h>
+#else
+    #include "SkNx.h"
+#endif
+
+namespace SK_OPTS_NS {
+
+static void matrix_translate(SkPoint dst[], const SkPoint src[], int count,
+                             const SkScalar m[9]) {
+    const SkScalar tx = m[SkMatrix::kMTransX],
+                   ty = m[SkMatrix::kMTransY];
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256 trans = _mm256_setr_ps(tx, ty, tx, ty, tx, ty, tx, ty);
+    for (; count >= 4; count -= 4) {
+        _mm256_storeu_ps(&dst->fX, _mm256_add_ps(_mm256_loadu_ps(&src->fX), trans));
+        src += 4;
+        dst += 4;
+    }
+#else
+    const Sk4s trans(tx, ty, tx, ty);
+    for (; count >= 4; count -= 4) {
+        (Sk4s::Load(&src[0].fX) + trans).store(&dst[0].fX);
+        (Sk4s::Load(&src[2].fX) + trans).store(&dst[2].fX);
+        src += 4;
+        dst += 4;
+    }
+    if (count >= 2) {
+        (Sk4s::Load(&src->fX) + trans).store(&dst->fX);
+        src += 2;
+        dst += 2;
+        count -= 2;
+    }
+#endif
+    for (; count > 0; --count) {
+        dst->fX = src->fX + tx;
+        dst->fY = src->fY + ty;
+        src += 1;
+        dst += 1;
+    }
+}
+
+static void matrix_scale_translate(SkPoint dst[], const SkPoint src[], int count,
+                                   const SkScalar m[9]) {
+    const SkScalar tx = m[SkMatrix::kMTransX],
+                   ty = m[SkMatrix::kMTransY],
+                   sx = m[SkMatrix::kMScaleX],
+                   sy = m[SkMatrix::kMScaleY];
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256 trans = _mm256_setr_ps(tx, ty, tx, ty, tx, ty, tx, ty),
+                 scale = _mm256_setr_ps(sx, sy, sx, sy, sx, sy, sx, sy);
+    for (; count >= 4; count -= 4) {
+        __m256 xy = _mm256_mul_ps(_mm256_loadu_ps(&src->fX), scale);
+        _mm256_storeu_ps(&dst->fX, _mm256_add_ps(xy, trans));
+        src += 4;
+        dst += 4;
+    }
+#else
+    const Sk4s trans(tx, ty, tx, ty),
+               scale(sx, sy, sx, sy);
+    for (; count >= 4; count -= 4) {
+        (Sk4s::Load(&src[0].fX) * scale + trans).store(&dst[0].fX);
+        (Sk4s::Load(&src[2].fX) * scale + trans).store(&dst[2].fX);
+        src += 4;
+        dst += 4;
+    }
+    if (count >= 2) {
+        (Sk4s::Load(&src->fX) * scale + trans).store(&dst->fX);
+        src += 2;
+        dst += 2;
+        count -= 2;
+    }
+#endif
+    for (; count > 0; --count) {
+        dst->fX = src->fX * sx + tx;
+        dst->fY = src->fY * sy + ty;
+        src += 1;
+        dst += 1;
+    }
+}
+
+// x' = x*sx + y*kx + tx and y' = x*ky + y*sy + ty. Each step mixes the points with their x and y
+// swapped, which adds the same products, just the other way round for y'.
+static void matrix_affine(SkPoint dst[], const SkPoint src[], int count, const SkScalar m[9]) {
+    const SkScalar tx = m[SkMatrix::kMTransX],
+                   ty = m[SkMatrix::kMTransY],
+                   sx = m[SkMatrix::kMScaleX],
+                   sy = m[SkMatrix::kMScaleY],
+                   kx = m[SkMatrix::kMSkewX],
+                   ky = m[SkMatrix::kMSkewY];
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256 trans = _mm256_setr_ps(tx, ty, tx, ty, tx, ty, tx, ty),
+                 scale = _mm256_setr_ps(sx, sy, sx, sy, sx, sy, sx, sy),
+                 skew  = _mm256_setr_ps(kx, ky, kx, ky, kx, ky, kx, ky);
+    for (; count >= 4; count -= 4) {
+        __m256 xy = _mm256_loadu_ps(&src->fX),
+               yx = _mm256_permute_ps(xy, _MM_SHUFFLE(2,3,0,1));
+        __m256 sum = _mm256_add_ps(_mm256_mul_ps(xy, scale), _mm256_mul_ps(yx, skew));
+        _mm256_storeu_ps(&dst->fX, _mm256_add_ps(sum, trans));
+        src += 4;
+        dst += 4;
+    }
+#else
+    const Sk4s trans(tx, ty, tx, ty),
+               scale(sx, sy, sx, sy),
+               skew (kx, ky, kx, ky);
+    for (; count >= 2; count -= 2) {
+        Sk4s xy = Sk4s::Load(&src->fX),
+             yx(src[0].fY, src[0].fX, src[1].fY, src[1].fX);
+        (xy * scale + yx * skew + trans).store(&dst->fX);
+        src += 2;
+        dst += 2;
+    }
+#endif
+    for (; count > 0; --count) {
+        SkScalar x = src->fX * sx + src->fY * kx + tx,
+                 y = src->fX * ky + src->fY * sy + ty;
+        dst->fX = x;
+        dst->fY = y;
+        src += 1;
+        dst += 1;
+    }
+}
+
+// x' = (x*sx + y*kx + tx) / w and y' = (x*ky + y*sy + ty) / w, with w = x*p0 + (y*p1 + p2), in
+// the order SkMatrix uses while SK_LEGACY_MATRIX_MATH_ORDER is defined. Each step works on the
+// points with their x, and then their y, copied into both lanes, so every lane adds the same
+// products in the same order, and takes one reciprocal per point.
+static void matrix_perspective(SkPoint dst[], const SkPoint src[], int count,
+                               const SkScalar m[9]) {
+    const SkScalar tx = m[SkMatrix::kMTransX],
+                   ty = m[SkMatrix::kMTransY],
+                   sx = m[SkMatrix::kMScaleX],
+                   sy = m[SkMatrix::kMScaleY],
+                   kx = m[SkMatrix::kMSkewX],
+                   ky = m[SkMatrix::kMSkewY],
+                   p0 = m[SkMatrix::kMPersp0],
+                   p1 = m[SkMatrix::kMPersp1],
+                   p2 = m[SkMatrix::kMPersp2];
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    const __m256 trans = _mm256_setr_ps(tx, ty, tx, ty, tx, ty, tx, ty),
+                 fromX = _mm256_setr_ps(sx, ky, sx, ky, sx, ky, sx, ky),
+                 fromY = _mm256_setr_ps(kx, sy, kx, sy, kx, sy, kx, sy),
+                 persp0 = _mm256_set1_ps(p0),
+                 persp1 = _mm256_set1_ps(p1),
+                 persp2 = _mm256_set1_ps(p2),
+                 zero = _mm256_setzero_ps(),
+                 one = _mm256_set1_ps(1);
+    for (; count >= 4; count -= 4) {
+        __m256 xy = _mm256_loadu_ps(&src->fX),
+               xx = _mm256_moveldup_ps(xy),
+               yy = _mm256_movehdup_ps(xy);
+        __m256 sum = _mm256_add_ps(_mm256_mul_ps(xx, fromX), _mm256_mul_ps(yy, fromY));
+        sum = _mm256_add_ps(sum, trans);
+        __m256 w = _mm256_add_ps(_mm256_mul_ps(yy, persp1), persp2);
+        w = _mm256_add_ps(_mm256_mul_ps(xx, persp0), w);
+        // NaN w is not equal to zero, so it is inverted like any other
+        __m256 invW = _mm256_and_ps(_mm256_div_ps(one, w), _mm256_cmp_ps(w, zero, _CMP_NEQ_UQ));
+        _mm256_storeu_ps(&dst->fX, _mm256_mul_ps(sum, invW));
+        src += 4;
+        dst += 4;
+    }
+#else
+    const Sk4s trans(tx, ty, tx, ty),
+               fromX(sx, ky, sx, ky),
+               fromY(kx, sy, kx, sy),
+               persp0(p0),
+               persp1(p1),
+               persp2(p2),
+               zero(0);
+    for (; count >= 2; count -= 2) {
+        Sk4s xx(src[0].fX, src[0].fX, src[1].fX, src[1].fX),
+             yy(src[0].fY, src[0].fY, src[1].fY, src[1].fY);
+        Sk4s w = xx * persp0 + (yy * persp1 + persp2);
+        Sk4s invW = (w != zero).thenElse(w.invert(), zero);
+        ((xx * fromX + yy * fromY + trans) * invW).store(&dst->fX);
+        src += 2;
+        dst += 2;
+    }
+#endif
+    for (; count > 0; --count) {
+        SkScalar x = src->fX * sx + src->fY * kx + tx,
+                 y = src->fX * ky + src->fY * sy + ty,
+                 w = src->fX * p0 + (src->fY * p1 + p2);
+        if (w) {
+            w = 1 / w;
+        }
+        dst->fX = x * w;
+        dst->fY = y * w;
+        src += 1;
+        dst += 1;
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMatrix_opts_DEFINED
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMipMap_opts_DEFINED
+#define SkMipMap_opts_DEFINED
+
+#include "SkColorPriv.h"
+#include "SkTypes.h"
+
+// Each proc writes count pixels of a mipmap level, pixel x being the truncated average of the 2x2
+// block at (2x, 0) in the level above, whose two rows start at src and src + srcRowBytes.
+
+namespace SK_OPTS_NS {
+
+static void downsample_8888_portable(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint32_t* p0 = static_cast<const uint32_t*>(src);
+    const uint32_t* p1 = reinterpret_cast<const uint32_t*>((const char*)src + srcRowBytes);
+    uint32_t* d = static_cast<uint32_t*>(dst);
+    for (int i = 0; i < count; i++) {
+        uint32_t ag = 0, rb = 0;
+        const uint32_t c[] = { p0[0], p0[1], p1[0], p1[1] };
+        for (int j = 0; j < 4; j++) {
+            ag += (c[j] >> 8) & 0xFF00FF;
+            rb += c[j] & 0xFF00FF;
+        }
+        *d++ = ((rb >> 2) & 0xFF00FF) | ((ag << 6) & 0xFF00FF00);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+static inline uint32_t expand_565(U16CPU c) {
+    return (c & ~SK_G16_MASK_IN_PLACE) | ((c & SK_G16_MASK_IN_PLACE) << 16);
+}
+
+// Returns dirt in the top 16 bits, which the caller drops.
+static inline U16CPU collapse_565(uint32_t c) {
+    return (c & ~SK_G16_MASK_IN_PLACE) | ((c >> 16) & SK_G16_MASK_IN_PLACE);
+}
+
+static void downsample_565_portable(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint16_t* p0 = static_cast<const uint16_t*>(src);
+    const uint16_t* p1 = reinterpret_cast<const uint16_t*>((const char*)src + srcRowBytes);
+    uint16_t* d = static_cast<uint16_t*>(dst);
+    for (int i = 0; i < count; i++) {
+        uint32_t c = expand_565(p0[0]) + expand_565(p0[1]) + expand_565(p1[0]) + expand_565(p1[1]);
+        *d++ = (uint16_t)collapse_565(c >> 2);
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+static void downsample_a8_portable(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const uint8_t* p0 = static_cast<const uint8_t*>(src);
+    const uint8_t* p1 = p0 + srcRowBytes;
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    for (int i = 0; i < count; i++) {
+        *d++ = (p0[0] + p0[1] + p1[0] + p1[1]) >> 2;
+        p0 += 2;
+        p1 += 2;
+    }
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+
+// Adds horizontally adjacent 32 bit lanes: returns { a0+a1, a2+a3, b0+b1, b2+b3 }.
+static inline __m128i add_pairs_32(__m128i a, __m128i b) {
+    const __m128 fa = _mm_castsi128_ps(a),
+                 fb = _mm_castsi128_ps(b);
+    return _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(2,0,2,0))),
+                         _mm_castps_si128(_mm_shuffle_ps(fa, fb, _MM_SHUFFLE(3,1,3,1))));
+}
+
+// The same bit tricks as the portable version, four destination pixels at a time.
+static void downsample_8888(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const __m128i* p0 = static_cast<const __m128i*>(src);
+    const __m128i* p1 = reinterpret_cast<const __m128i*>((const char*)src + srcRowBytes);
+    __m128i* d = static_cast<__m128i*>(dst);
+    const __m128i mask = _mm_set1_epi32(0xFF00FF);
+
+    for (; count >= 4; count -= 4) {
+        const __m128i a0 = _mm_loadu_si128(p0 + 0), a1 = _mm_loadu_si128(p0 + 1),
+                      b0 = _mm_loadu_si128(p1 + 0), b1 = _mm_loadu_si128(p1 + 1);
+        __m128i rb = add_pairs_32(_mm_add_epi32(_mm_and_si128(a0, mask),
+                                                _mm_and_si128(b0, mask)),
+                                  _mm_add_epi32(_mm_and_si128(a1, mask),
+                                                _mm_and_si128(b1, mask)));
+        __m128i ag = add_pairs_32(_mm_add_epi32(_mm_and_si128(_mm_srli_epi32(a0, 8), mask),
+                                                _mm_and_si128(_mm_srli_epi32(b0, 8), mask)),
+                                  _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(a1, 8), mask),
+                                                _mm_and_si128(_mm_srli_epi32(b1, 8), mask)));
+        rb = _mm_and_si128(_mm_srli_epi32(rb, 2), mask);
+        ag = _mm_andnot_si128(mask, _mm_slli_epi32(ag, 6));
+        _mm_storeu_si128(d++, _mm_or_si128(rb, ag));
+        p0 += 2;
+        p1 += 2;
+    }
+    downsample_8888_portable(d, p0, srcRowBytes, count);
+}
+
+// Eight destination pixels at a time, widened to 32 bits for the green trick.
+static void downsample_565(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const __m128i* p0 = static_cast<const __m128i*>(src);
+    const __m128i* p1 = reinterpret_cast<const __m128i*>((const char*)src + srcRowBytes);
+    __m128i* d = static_cast<__m128i*>(dst);
+    const __m128i zero  = _mm_setzero_si128(),
+                  green = _mm_set1_epi32(SK_G16_MASK_IN_PLACE);
+
+    // Expands 565 pixels in 32 bit lanes to put green in the top half.
+    auto expand = [&](__m128i c) {
+        return _mm_or_si128(_mm_andnot_si128(green, c),
+                            _mm_slli_epi32(_mm_and_si128(c, green), 16));
+    };
+    // Sums the 2x2 blocks for the four destination pixels in a[] and b[], rows of 8 sources.
+    auto sum = [&](__m128i a, __m128i b) {
+        return add_pairs_32(_mm_add_epi32(expand(_mm_unpacklo_epi16(a, zero)),
+                                          expand(_mm_unpacklo_epi16(b, zero))),
+                            _mm_add_epi32(expand(_mm_unpackhi_epi16(a, zero)),
+                                          expand(_mm_unpackhi_epi16(b, zero))));
+    };
+    // Collapses back to 565, sign extending so _mm_packs_epi32 can't saturate.
+    auto collapse = [&](__m128i c) {
+        c = _mm_srli_epi32(c, 2);
+        c = _mm_or_si128(_mm_andnot_si128(green, c),
+                         _mm_and_si128(_mm_srli_epi32(c, 16), green));
+        return _mm_srai_epi32(_mm_slli_epi32(c, 16), 16);
+    };
+
+    for (; count >= 8; count -= 8) {
+        const __m128i lo = sum(_mm_loadu_si128(p0 + 0), _mm_loadu_si128(p1 + 0)),
+                      hi = sum(_mm_loadu_si128(p0 + 1), _mm_loadu_si128(p1 + 1));
+        _mm_storeu_si128(d++, _mm_packs_epi32(collapse(lo), collapse(hi)));
+        p0 += 2;
+        p1 += 2;
+    }
+    downsample_565_portable(d, p0, srcRowBytes, count);
+}
+
+// Sixteen destination pixels at a time, adding in 16 bit lanes.
+static void downsample_a8(void* dst, const void* src, size_t srcRowBytes, int count) {
+    const __m128i* p0 = static_cast<const __m128i*>(src);
+    const __m128i* p1 = reinterpret_cast<const __m128i*>((const char*)src + srcRowBytes);
+    __m128i* d = static_cast<__m128i*>(dst);
+    const __m128i lowBytes = _mm_set1_epi16(0xFF);
+
+    // Sums each horizontal pair of bytes of a and b, giving eight 16 bit lanes.
+    auto sum = [&](__m128i a, __m128i b) {
+        return _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, lowBytes), _mm_srli_epi16(a, 8)),
+                             _mm_add_epi16(_mm_and_si128(b, lowBytes), _mm_srli_epi16(b, 8)));
+    };
+
+    for (; count >= 16; count -= 16) {
+        const __m128i lo = sum(_mm_loadu_si128(p0 + 0), _mm_loadu_si128(p1 + 0)),
+                      hi = sum(_mm_loadu_si128(p0 + 1), _mm_loadu_si128(p1 + 1));
+        _mm_storeu_si128(d++, _mm_packus_epi16(_mm_srli_epi16(lo, 2), _mm_srli_epi16(hi, 2)));
+        p0 += 2;
+        p1 += 2;
+    }
+    downsample_a8_portable(d, p0, srcRowBytes, count);
+}
+
+#else
+
+static void downsample_8888(void* dst, const void* src, size_t srcRowBytes, int count) {
+    downsample_8888_portable(dst, src, srcRowBytes, count);
+}
+
+static void downsample_565(void* dst, const void* src, size_t srcRowBytes, int count) {
+    downsample_565_portable(dst, src, srcRowBytes, count);
+}
+
+static void downsample_a8(void* dst, const void* src, size_t srcRowBytes, int count) {
+    downsample_a8_portable(dst, src, srcRowBytes, count);
+}
+
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkMipMap_opts_DEFINED
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkOpts.h"
+
+#define SK_OPTS_NS avx2
+#include "SkBlurImageFilter_opts.h"
+#include "SkMatrix_opts.h"
+#include "SkMorphologyImageFilter_opts.h"
+#include "SkSwizzler_opts.h"
+#include "SkUtils_opts.h"
+
+// SkXfermode_opts.h is left out on purpose: it still lives in an anonymous namespace rather
+// than SK_OPTS_NS, and pulls in Sk4px/SkPMFloat inline functions that have external linkage.
+// Building those with -mavx2 here could let the linker hand AVX2 copies to SSE2-only callers.
+
+namespace SkOpts {
+    void Init_avx2() {
+        memset16 = avx2::memset16;
+        memset32 = avx2::memset32;
+
+        box_blur_xx = avx2::box_blur_xx;
+        box_blur_xy = avx2::box_blur_xy;
+        box_blur_yx = avx2::box_blur_yx;
+
+        dilate_x = avx2::dilate_x;
+        dilate_y = avx2::dilate_y;
+         erode_x = avx2::erode_x;
+         erode_y = avx2::erode_y;
+
+        RGBA_to_rgbA   = avx2::RGBA_to_rgbA;
+        RGBA_to_bgrA   = avx2::RGBA_to_bgrA;
+        RGBA_to_BGRA   = avx2::RGBA_to_BGRA;
+        rgbA_to_RGBA   = avx2::rgbA_to_RGBA;
+        rgbA_to_BGRA   = avx2::rgbA_to_BGRA;
+        RGB_to_RGB1    = avx2::RGB_to_RGB1;
+        RGB_to_BGR1    = avx2::RGB_to_BGR1;
+        gray_to_RGB1   = avx2::gray_to_RGB1;
+        index_to_color = avx2::index_to_color;
+
+        matrix_translate       = avx2::matrix_translate;
+        matrix_scale_translate = avx2::matrix_scale_translate;
+        matrix_affine          = avx2::matrix_affine;
+        matrix_perspective     = avx2::matrix_perspective;
+    }
+}
@@ -9,8 +9,11 @@
 
 #define SK_OPTS_NS neon
 #include "SkBlurImageFilter_opts.h"
+#include "SkColorCubeFilter_opts.h"
+#include "SkColorMatrixFilter_opts.h"
 #include "SkFloatingPoint_opts.h"
 #include "SkMorphologyImageFilter_opts.h"
+#include "SkSwizzler_opts.h"
 #include "SkTextureCompressor_opts.h"
 #include "SkUtils_opts.h"
 #include "SkXfermode_opts.h"
@@ -33,5 +36,18 @@ namespace SkOpts {
 
         texture_compressor    = neon::texture_compressor;
         fill_block_dimensions = neon::fill_block_dimensions;
+
+        RGBA_to_rgbA   = neon::RGBA_to_rgbA;
+        RGBA_to_bgrA   = neon::RGBA_to_bgrA;
+        RGBA_to_BGRA   = neon::RGBA_to_BGRA;
+        rgbA_to_RGBA   = neon::rgbA_to_RGBA;
+        rgbA_to_BGRA   = neon::rgbA_to_BGRA;
+        RGB_to_RGB1    = neon::RGB_to_RGB1;
+        RGB_to_BGR1    = neon::RGB_to_BGR1;
+        gray_to_RGB1   = neon::gray_to_RGB1;
+        index_to_color = neon::index_to_color;
+
+        color_matrix_filter_span = neon::color_matrix_filter_span;
+        color_cube_filter_span   = neon::color_cube_filter_span;
     }
 }
@@ -9,6 +9,10 @@
 
 #define SK_OPTS_NS sse2
 #include "SkBlurImageFilter_opts.h"
+#include "SkBlurMask_opts.h"
+#include "SkColorCubeFilter_opts.h"
+#include "SkColorMatrixFilter_opts.h"
+#include "SkMipMap_opts.h"
 #include "SkMorphologyImageFilter_opts.h"
 #include "SkUtils_opts.h"
 #include "SkXfermode_opts.h"
@@ -27,5 +31,15 @@ namespace SkOpts {
         dilate_y = sse2::dilate_y;
          erode_x = sse2::erode_x;
          erode_y = sse2::erode_y;
+
+        downsample_8888 = sse2::downsample_8888;
+        downsample_565  = sse2::downsample_565;
+        downsample_a8   = sse2::downsample_a8;
+
+        blur_mask_row        = sse2::blur_mask_row;
+        blur_mask_interp_row = sse2::blur_mask_interp_row;
+
+        color_matrix_filter_span = sse2::color_matrix_filter_span;
+        color_cube_filter_span   = sse2::color_cube_filter_span;
     }
 }
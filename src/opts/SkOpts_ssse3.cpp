@@ -7,8 +7,19 @@
 
 #include "SkOpts.h"
 
+#define SK_OPTS_NS ssse3
+#include "SkSwizzler_opts.h"
+
 namespace SkOpts {
     void Init_ssse3() {
-
+        RGBA_to_rgbA   = ssse3::RGBA_to_rgbA;
+        RGBA_to_bgrA   = ssse3::RGBA_to_bgrA;
+        RGBA_to_BGRA   = ssse3::RGBA_to_BGRA;
+        rgbA_to_RGBA   = ssse3::rgbA_to_RGBA;
+        rgbA_to_BGRA   = ssse3::rgbA_to_BGRA;
+        RGB_to_RGB1    = ssse3::RGB_to_RGB1;
+        RGB_to_BGR1    = ssse3::RGB_to_BGR1;
+        gray_to_RGB1   = ssse3::gray_to_RGB1;
+        index_to_color = ssse3::index_to_color;
     }
 }
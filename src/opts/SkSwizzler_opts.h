@@ -0,0 +1,497 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSwizzler_opts_DEFINED
+#define SkSwizzler_opts_DEFINED
+
+#include "SkColorPriv.h"
+#include "SkTypes.h"
+
+// These all work on bytes in memory order, so RGBA_to_bgrA means "premultiply and swap the
+// first and third bytes".  Procs that read alpha return the bitwise AND of every alpha in the
+// high byte and the bitwise OR in the low byte, which is what SkSwizzler::GetResult() expects.
+// All of them may be called in place, with dst == src.
+
+namespace SK_OPTS_NS {
+
+static inline uint16_t alpha_result(U8CPU andAlpha, U8CPU orAlpha) {
+    return SkToU16((andAlpha << 8) | orAlpha);
+}
+
+// Folds a second alpha result into the first.
+static inline uint16_t combine_alpha_results(uint16_t a, uint16_t b) {
+    return alpha_result((a >> 8) & (b >> 8), (a | b) & 0xFF);
+}
+
+template <bool kSwapRB>
+static uint16_t premul_portable(uint32_t* dst, const uint8_t* src, int count) {
+    uint8_t* d = (uint8_t*)dst;
+    U8CPU andAlpha = 0xFF, orAlpha = 0;
+    for (int i = 0; i < count; i++) {
+        const U8CPU a = src[3];
+        andAlpha &= a;
+        orAlpha  |= a;
+        const U8CPU r = SkMulDiv255Round(src[0], a),
+                    g = SkMulDiv255Round(src[1], a),
+                    b = SkMulDiv255Round(src[2], a);
+        d[0] = kSwapRB ? b : r;
+        d[1] = g;
+        d[2] = kSwapRB ? r : b;
+        d[3] = a;
+        src += 4;
+        d += 4;
+    }
+    return alpha_result(andAlpha, orAlpha);
+}
+
+// Multiplies c by a correctly rounded 255/a, so every implementation rounds identically.
+static inline U8CPU unpremul_component(U8CPU c, float scale) {
+    return SkTMin((U8CPU)(c * scale + 0.5f), 255u);
+}
+
+template <bool kSwapRB>
+static uint16_t unpremul_portable(uint32_t* dst, const uint8_t* src, int count) {
+    uint8_t* d = (uint8_t*)dst;
+    U8CPU andAlpha = 0xFF, orAlpha = 0;
+    for (int i = 0; i < count; i++) {
+        const U8CPU a = src[3];
+        andAlpha &= a;
+        orAlpha  |= a;
+        const float scale = a ? 255.0f / a : 0;
+        const U8CPU r = unpremul_component(src[0], scale),
+                    g = unpremul_component(src[1], scale),
+                    b = unpremul_component(src[2], scale);
+        d[0] = kSwapRB ? b : r;
+        d[1] = g;
+        d[2] = kSwapRB ? r : b;
+        d[3] = a;
+        src += 4;
+        d += 4;
+    }
+    return alpha_result(andAlpha, orAlpha);
+}
+
+static uint16_t RGBA_to_BGRA_portable(uint32_t* dst, const uint8_t* src, int count) {
+    uint8_t* d = (uint8_t*)dst;
+    U8CPU andAlpha = 0xFF, orAlpha = 0;
+    for (int i = 0; i < count; i++) {
+        const U8CPU r = src[0],
+                    b = src[2],
+                    a = src[3];
+        andAlpha &= a;
+        orAlpha  |= a;
+        d[0] = b;
+        d[1] = src[1];
+        d[2] = r;
+        d[3] = a;
+        src += 4;
+        d += 4;
+    }
+    return alpha_result(andAlpha, orAlpha);
+}
+
+template <bool kSwapRB>
+static void RGB_to_xxx1_portable(uint32_t* dst, const uint8_t* src, int count) {
+    uint8_t* d = (uint8_t*)dst;
+    for (int i = 0; i < count; i++) {
+        d[0] = kSwapRB ? src[2] : src[0];
+        d[1] = src[1];
+        d[2] = kSwapRB ? src[0] : src[2];
+        d[3] = 0xFF;
+        src += 3;
+        d += 4;
+    }
+}
+
+static void gray_to_RGB1_portable(uint32_t* dst, const uint8_t* src, int count) {
+    uint8_t* d = (uint8_t*)dst;
+    for (int i = 0; i < count; i++) {
+        d[0] = d[1] = d[2] = src[i];
+        d[3] = 0xFF;
+        d += 4;
+    }
+}
+
+static uint16_t index_to_color_portable(uint32_t* dst, const uint8_t* src, int count,
+                                        const uint32_t table[]) {
+    // Accumulate whole colors and pick out the alphas once at the end.
+    uint32_t andColor = ~0u, orColor = 0;
+    for (int i = 0; i < count; i++) {
+        const uint32_t c = table[src[i]];
+        andColor &= c;
+        orColor  |= c;
+        dst[i] = c;
+    }
+    return alpha_result((andColor >> SK_A32_SHIFT) & 0xFF, (orColor >> SK_A32_SHIFT) & 0xFF);
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+
+// Reduces the alpha bytes of four accumulated pixels.
+static inline uint16_t alpha_result(__m128i andPixels, __m128i orPixels) {
+    andPixels = _mm_and_si128(andPixels, _mm_srli_si128(andPixels, 8));
+    andPixels = _mm_and_si128(andPixels, _mm_srli_si128(andPixels, 4));
+    orPixels  = _mm_or_si128 (orPixels,  _mm_srli_si128(orPixels,  8));
+    orPixels  = _mm_or_si128 (orPixels,  _mm_srli_si128(orPixels,  4));
+    return alpha_result((uint32_t)_mm_cvtsi128_si32(andPixels) >> 24,
+                        (uint32_t)_mm_cvtsi128_si32(orPixels)  >> 24);
+}
+
+// (x + 127) / 255 for 16-bit lanes up to 255 * 255, matching SkMulDiv255Round().
+static inline __m128i div255_round(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+template <bool kSwapRB>
+static uint16_t premul(uint32_t* dst, const uint8_t* src, int count) {
+    const __m128i swapRB = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+    // Or'd into the broadcast alphas so that alpha itself is multiplied by 255.
+    const __m128i keepAlpha = _mm_setr_epi16(0,0,0,255, 0,0,0,255);
+    const __m128i zeros = _mm_setzero_si128();
+
+    __m128i andPixels = _mm_set1_epi8(~0),
+            orPixels  = _mm_setzero_si128();
+    while (count >= 4) {
+        __m128i px = _mm_loadu_si128((const __m128i*)src);
+        andPixels = _mm_and_si128(andPixels, px);
+        orPixels  = _mm_or_si128 (orPixels,  px);
+        if (kSwapRB) {
+            px = _mm_shuffle_epi8(px, swapRB);
+        }
+
+        __m128i lo = _mm_unpacklo_epi8(px, zeros),
+                hi = _mm_unpackhi_epi8(px, zeros);
+        const __m128i loAlpha = _mm_or_si128(
+                _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF), keepAlpha);
+        const __m128i hiAlpha = _mm_or_si128(
+                _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF), keepAlpha);
+        lo = div255_round(_mm_mullo_epi16(lo, loAlpha));
+        hi = div255_round(_mm_mullo_epi16(hi, hiAlpha));
+
+        _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(lo, hi));
+        src += 16;
+        dst += 4;
+        count -= 4;
+    }
+    return combine_alpha_results(alpha_result(andPixels, orPixels),
+                                 premul_portable<kSwapRB>(dst, src, count));
+}
+
+// Unpremultiplies one pixel held as four float lanes, leaving alpha's lane undefined.
+static inline __m128i unpremul_pixel(__m128 px) {
+    const __m128 a = _mm_shuffle_ps(px, px, 0xFF);
+    // Division is exact on SSE, so this matches unpremul_portable(); zero alphas scale by zero.
+    const __m128 scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(255), a),
+                                    _mm_cmpneq_ps(a, _mm_setzero_ps()));
+    return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(px, scale), _mm_set1_ps(0.5f)));
+}
+
+template <bool kSwapRB>
+static uint16_t unpremul(uint32_t* dst, const uint8_t* src, int count) {
+    const __m128i swapRB = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    const __m128i zeros = _mm_setzero_si128();
+
+    __m128i andPixels = _mm_set1_epi8(~0),
+            orPixels  = _mm_setzero_si128();
+    while (count >= 4) {
+        __m128i px = _mm_loadu_si128((const __m128i*)src);
+        andPixels = _mm_and_si128(andPixels, px);
+        orPixels  = _mm_or_si128 (orPixels,  px);
+        if (kSwapRB) {
+            px = _mm_shuffle_epi8(px, swapRB);
+        }
+
+        const __m128i lo = _mm_unpacklo_epi8(px, zeros),
+                      hi = _mm_unpackhi_epi8(px, zeros);
+        const __m128i p0 = unpremul_pixel(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zeros))),
+                      p1 = unpremul_pixel(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zeros))),
+                      p2 = unpremul_pixel(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zeros))),
+                      p3 = unpremul_pixel(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zeros)));
+        // Saturating packs clamp colors that were larger than their alpha, and the original
+        // alphas go back in on top.
+        const __m128i colors = _mm_packus_epi16(_mm_packs_epi32(p0, p1),
+                                                _mm_packs_epi32(p2, p3));
+        _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_andnot_si128(alphaMask, colors),
+                                                     _mm_and_si128(alphaMask, px)));
+        src += 16;
+        dst += 4;
+        count -= 4;
+    }
+    return combine_alpha_results(alpha_result(andPixels, orPixels),
+                                 unpremul_portable<kSwapRB>(dst, src, count));
+}
+
+static uint16_t RGBA_to_BGRA(uint32_t* dst, const uint8_t* src, int count) {
+    const __m128i swapRB = _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
+
+    __m128i andPixels = _mm_set1_epi8(~0),
+            orPixels  = _mm_setzero_si128();
+    while (count >= 4) {
+        const __m128i px = _mm_loadu_si128((const __m128i*)src);
+        andPixels = _mm_and_si128(andPixels, px);
+        orPixels  = _mm_or_si128 (orPixels,  px);
+        _mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(px, swapRB));
+        src += 16;
+        dst += 4;
+        count -= 4;
+    }
+    return combine_alpha_results(alpha_result(andPixels, orPixels),
+                                 RGBA_to_BGRA_portable(dst, src, count));
+}
+
+template <bool kSwapRB>
+static void RGB_to_xxx1(uint32_t* dst, const uint8_t* src, int count) {
+    const char _ = ~0;  // Zeros that byte, which the alpha below fills in.
+    const __m128i expand = kSwapRB
+            ? _mm_setr_epi8(2,1,0,_, 5,4,3,_, 8,7,6,_, 11,10,9,_)
+            : _mm_setr_epi8(0,1,2,_, 3,4,5,_, 6,7,8,_, 9,10,11,_);
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+
+    // Each load reads 16 bytes but consumes only 12, so stop while 6 pixels remain.
+    while (count >= 6) {
+        const __m128i px = _mm_loadu_si128((const __m128i*)src);
+        _mm_storeu_si128((__m128i*)dst, _mm_or_si128(_mm_shuffle_epi8(px, expand), alpha));
+        src += 12;
+        dst += 4;
+        count -= 4;
+    }
+    RGB_to_xxx1_portable<kSwapRB>(dst, src, count);
+}
+
+static void gray_to_RGB1(uint32_t* dst, const uint8_t* src, int count) {
+    const char _ = ~0;
+    const __m128i alpha = _mm_set1_epi32(0xFF000000);
+    while (count >= 16) {
+        const __m128i grays = _mm_loadu_si128((const __m128i*)src);
+        const __m128i a = _mm_shuffle_epi8(grays,
+                _mm_setr_epi8(0,0,0,_, 1,1,1,_, 2,2,2,_, 3,3,3,_));
+        const __m128i b = _mm_shuffle_epi8(grays,
+                _mm_setr_epi8(4,4,4,_, 5,5,5,_, 6,6,6,_, 7,7,7,_));
+        const __m128i c = _mm_shuffle_epi8(grays,
+                _mm_setr_epi8(8,8,8,_, 9,9,9,_, 10,10,10,_, 11,11,11,_));
+        const __m128i d = _mm_shuffle_epi8(grays,
+                _mm_setr_epi8(12,12,12,_, 13,13,13,_, 14,14,14,_, 15,15,15,_));
+        _mm_storeu_si128((__m128i*)(dst +  0), _mm_or_si128(a, alpha));
+        _mm_storeu_si128((__m128i*)(dst +  4), _mm_or_si128(b, alpha));
+        _mm_storeu_si128((__m128i*)(dst +  8), _mm_or_si128(c, alpha));
+        _mm_storeu_si128((__m128i*)(dst + 12), _mm_or_si128(d, alpha));
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+    gray_to_RGB1_portable(dst, src, count);
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+static uint16_t index_to_color(uint32_t* dst, const uint8_t* src, int count,
+                               const uint32_t table[]) {
+    __m256i andColors = _mm256_set1_epi32(~0),
+            orColors  = _mm256_setzero_si256();
+    while (count >= 8) {
+        const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src));
+        const __m256i colors = _mm256_i32gather_epi32((const int*)table, indices, 4);
+        andColors = _mm256_and_si256(andColors, colors);
+        orColors  = _mm256_or_si256 (orColors,  colors);
+        _mm256_storeu_si256((__m256i*)dst, colors);
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+
+    const __m128i andHalves = _mm_and_si128(_mm256_castsi256_si128(andColors),
+                                            _mm256_extracti128_si256(andColors, 1));
+    const __m128i orHalves  = _mm_or_si128 (_mm256_castsi256_si128(orColors),
+                                            _mm256_extracti128_si256(orColors, 1));
+    uint32_t ands[4], ors[4];
+    _mm_storeu_si128((__m128i*)ands, andHalves);
+    _mm_storeu_si128((__m128i*)ors,  orHalves);
+    const uint32_t andColor = ands[0] & ands[1] & ands[2] & ands[3],
+                   orColor  = ors[0]  | ors[1]  | ors[2]  | ors[3];
+    return combine_alpha_results(
+            alpha_result((andColor >> SK_A32_SHIFT) & 0xFF, (orColor >> SK_A32_SHIFT) & 0xFF),
+            index_to_color_portable(dst, src, count, table));
+}
+#else
+static uint16_t index_to_color(uint32_t* dst, const uint8_t* src, int count,
+                               const uint32_t table[]) {
+    // There is no gather before AVX2, so the lookups stay scalar.
+    return index_to_color_portable(dst, src, count, table);
+}
+#endif
+
+#elif defined(SK_ARM_HAS_NEON)
+
+static inline uint16_t alpha_result(uint8x8_t andAlphas, uint8x8_t orAlphas) {
+    U8CPU andAlpha = 0xFF, orAlpha = 0;
+    uint8_t ands[8], ors[8];
+    vst1_u8(ands, andAlphas);
+    vst1_u8(ors,  orAlphas);
+    for (int i = 0; i < 8; i++) {
+        andAlpha &= ands[i];
+        orAlpha  |= ors[i];
+    }
+    return alpha_result(andAlpha, orAlpha);
+}
+
+// (c * a + 127) / 255, matching SkMulDiv255Round().
+static inline uint8x8_t mul_div255_round(uint8x8_t c, uint8x8_t a) {
+    const uint16x8_t prod = vmull_u8(c, a);
+    return vraddhn_u16(prod, vrshrq_n_u16(prod, 8));
+}
+
+template <bool kSwapRB>
+static uint16_t premul(uint32_t* dst, const uint8_t* src, int count) {
+    uint8x8_t andAlphas = vdup_n_u8(0xFF),
+              orAlphas  = vdup_n_u8(0);
+    while (count >= 8) {
+        uint8x8x4_t px = vld4_u8(src);
+        const uint8x8_t a = px.val[3];
+        andAlphas = vand_u8(andAlphas, a);
+        orAlphas  = vorr_u8(orAlphas,  a);
+
+        const uint8x8_t r = mul_div255_round(px.val[0], a),
+                        g = mul_div255_round(px.val[1], a),
+                        b = mul_div255_round(px.val[2], a);
+        px.val[0] = kSwapRB ? b : r;
+        px.val[1] = g;
+        px.val[2] = kSwapRB ? r : b;
+        vst4_u8((uint8_t*)dst, px);
+        src += 32;
+        dst += 8;
+        count -= 8;
+    }
+    return combine_alpha_results(alpha_result(andAlphas, orAlphas),
+                                 premul_portable<kSwapRB>(dst, src, count));
+}
+
+template <bool kSwapRB>
+static uint16_t unpremul(uint32_t* dst, const uint8_t* src, int count) {
+    // ARMv7 NEON only estimates reciprocals, which would round differently from the other
+    // implementations, so this stays scalar.
+    return unpremul_portable<kSwapRB>(dst, src, count);
+}
+
+static uint16_t RGBA_to_BGRA(uint32_t* dst, const uint8_t* src, int count) {
+    uint8x8_t andAlphas = vdup_n_u8(0xFF),
+              orAlphas  = vdup_n_u8(0);
+    while (count >= 8) {
+        uint8x8x4_t px = vld4_u8(src);
+        andAlphas = vand_u8(andAlphas, px.val[3]);
+        orAlphas  = vorr_u8(orAlphas,  px.val[3]);
+
+        const uint8x8_t r = px.val[0];
+        px.val[0] = px.val[2];
+        px.val[2] = r;
+        vst4_u8((uint8_t*)dst, px);
+        src += 32;
+        dst += 8;
+        count -= 8;
+    }
+    return combine_alpha_results(alpha_result(andAlphas, orAlphas),
+                                 RGBA_to_BGRA_portable(dst, src, count));
+}
+
+template <bool kSwapRB>
+static void RGB_to_xxx1(uint32_t* dst, const uint8_t* src, int count) {
+    while (count >= 8) {
+        const uint8x8x3_t rgb = vld3_u8(src);
+        uint8x8x4_t px;
+        px.val[0] = kSwapRB ? rgb.val[2] : rgb.val[0];
+        px.val[1] = rgb.val[1];
+        px.val[2] = kSwapRB ? rgb.val[0] : rgb.val[2];
+        px.val[3] = vdup_n_u8(0xFF);
+        vst4_u8((uint8_t*)dst, px);
+        src += 24;
+        dst += 8;
+        count -= 8;
+    }
+    RGB_to_xxx1_portable<kSwapRB>(dst, src, count);
+}
+
+static void gray_to_RGB1(uint32_t* dst, const uint8_t* src, int count) {
+    while (count >= 8) {
+        const uint8x8_t gray = vld1_u8(src);
+        uint8x8x4_t px;
+        px.val[0] = gray;
+        px.val[1] = gray;
+        px.val[2] = gray;
+        px.val[3] = vdup_n_u8(0xFF);
+        vst4_u8((uint8_t*)dst, px);
+        src += 8;
+        dst += 8;
+        count -= 8;
+    }
+    gray_to_RGB1_portable(dst, src, count);
+}
+
+static uint16_t index_to_color(uint32_t* dst, const uint8_t* src, int count,
+                               const uint32_t table[]) {
+    // NEON has no gather, so the lookups stay scalar.
+    return index_to_color_portable(dst, src, count, table);
+}
+
+#else  // Neither NEON nor >=SSSE3.
+
+template <bool kSwapRB>
+static uint16_t premul(uint32_t* dst, const uint8_t* src, int count) {
+    return premul_portable<kSwapRB>(dst, src, count);
+}
+
+template <bool kSwapRB>
+static uint16_t unpremul(uint32_t* dst, const uint8_t* src, int count) {
+    return unpremul_portable<kSwapRB>(dst, src, count);
+}
+
+static uint16_t RGBA_to_BGRA(uint32_t* dst, const uint8_t* src, int count) {
+    return RGBA_to_BGRA_portable(dst, src, count);
+}
+
+template <bool kSwapRB>
+static void RGB_to_xxx1(uint32_t* dst, const uint8_t* src, int count) {
+    RGB_to_xxx1_portable<kSwapRB>(dst, src, count);
+}
+
+static void gray_to_RGB1(uint32_t* dst, const uint8_t* src, int count) {
+    gray_to_RGB1_portable(dst, src, count);
+}
+
+static uint16_t index_to_color(uint32_t* dst, const uint8_t* src, int count,
+                               const uint32_t table[]) {
+    return index_to_color_portable(dst, src, count, table);
+}
+
+#endif
+
+static uint16_t RGBA_to_rgbA(uint32_t* dst, const uint8_t* src, int count) {
+    return premul<false>(dst, src, count);
+}
+
+static uint16_t RGBA_to_bgrA(uint32_t* dst, const uint8_t* src, int count) {
+    return premul<true>(dst, src, count);
+}
+
+static uint16_t rgbA_to_RGBA(uint32_t* dst, const uint8_t* src, int count) {
+    return unpremul<false>(dst, src, count);
+}
+
+static uint16_t rgbA_to_BGRA(uint32_t* dst, const uint8_t* src, int count) {
+    return unpremul<true>(dst, src, count);
+}
+
+static void RGB_to_RGB1(uint32_t* dst, const uint8_t* src, int count) {
+    RGB_to_xxx1<false>(dst, src, count);
+}
+
+static void RGB_to_BGR1(uint32_t* dst, const uint8_t* src, int count) {
+    RGB_to_xxx1<true>(dst, src, count);
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkSwizzler_opts_DEFINED
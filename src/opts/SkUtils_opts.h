@@ -13,6 +13,14 @@ namespace SK_OPTS_NS {
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
 
 static void memset16(uint16_t* dst, uint16_t val, int n) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    auto dst16 = (__m256i*)dst;
+    auto val16 = _mm256_set1_epi16(val);
+    for ( ; n >= 16; n -= 16) {
+        _mm256_storeu_si256(dst16++, val16);
+    }
+    dst = (uint16_t*)dst16;
+#endif
     auto dst8 = (__m128i*)dst;
     auto val8 = _mm_set1_epi16(val);
     for ( ; n >= 8; n -= 8) {
@@ -33,6 +41,14 @@ static void memset16(uint16_t* dst, uint16_t val, int n) {
 }
 
 static void memset32(uint32_t* dst, uint32_t val, int n) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    auto dst8 = (__m256i*)dst;
+    auto val8 = _mm256_set1_epi32(val);
+    for ( ; n >= 8; n -= 8) {
+        _mm256_storeu_si256(dst8++, val8);
+    }
+    dst = (uint32_t*)dst8;
+#endif
     auto dst4 = (__m128i*)dst;
     auto val4 = _mm_set1_epi32(val);
     for ( ; n >= 4; n -= 4) {
@@ -188,13 +188,62 @@ XFERMODE_AA(Plus) {  // [ clamp( (1-AA)D + (AA)(S+D) ) == clamp(D + AA*S) ]
     return d.saturatedAdd(s.approxMulDiv255(aa));
 }
 
+// Modes whose D coefficient is 1, 1-Sa or 1-S interpolate to the same result if S is simply
+// scaled by AA first, which saves the wide multiplies of the interpolation.
+#define XFERMODE_AA_AS_ALPHA(Name) \
+    XFERMODE_AA(Name) { return Name(s.approxMulDiv255(aa), d); }
+
+XFERMODE_AA_AS_ALPHA(SrcOver)   // [ S + (1 - Sa) * D ]
+XFERMODE_AA_AS_ALPHA(DstOver)   // [ D + (1 - Da) * S ]
+XFERMODE_AA_AS_ALPHA(DstOut)    // [ (1 - Sa) * D ]
+XFERMODE_AA_AS_ALPHA(SrcATop)   // [ S * Da + (1 - Sa) * D ]
+XFERMODE_AA_AS_ALPHA(Xor)       // [ S * (1 - Da) + (1 - Sa) * D ]
+XFERMODE_AA_AS_ALPHA(Screen)    // [ S + (1 - S) * D ]
+
+#undef XFERMODE_AA_AS_ALPHA
 #undef XFERMODE_AA
 
+typedef Sk4px (SK_VECTORCALL *Proc4)(Sk4px, Sk4px);
+typedef Sk4px (SK_VECTORCALL *AAProc4)(Sk4px, Sk4px, Sk4px);
+
+// An A8 dst is blended as if its pixels were black with its alphas, four at a time.
+static void xfer_a8(SkAlpha dst[], const SkPMColor src[], int n, const SkAlpha aa[],
+                    Proc4 proc4, AAProc4 aaproc4) {
+    auto blend4 = [&](SkAlpha d[4], const SkPMColor s[4], const SkAlpha a[4]) {
+        const Sk4px src4 = Sk4px::Load4(s),
+                    dst4 = Sk4px::Load4Alphas(d).zeroColors();
+        SkPMColor res[4];
+        (a ? aaproc4(src4, dst4, Sk4px::Load4Alphas(a)) : proc4(src4, dst4)).store4(res);
+        for (int i = 0; i < 4; i++) {
+            d[i] = SkToU8(SkGetPackedA32(res[i]));
+        }
+    };
+
+    while (n >= 4) {
+        blend4(dst, src, aa);
+        dst += 4;
+        src += 4;
+        if (aa) {
+            aa += 4;
+        }
+        n -= 4;
+    }
+    if (n > 0) {
+        SkPMColor src4[4] = { 0, 0, 0, 0 };
+        SkAlpha dst4[4] = { 0, 0, 0, 0 },
+                aa4[4]  = { 0, 0, 0, 0 };
+        memcpy(src4, src, n * sizeof(SkPMColor));
+        memcpy(dst4, dst, n);
+        if (aa) {
+            memcpy(aa4, aa, n);
+        }
+        blend4(dst4, src4, aa ? aa4 : nullptr);
+        memcpy(dst, dst4, n);
+    }
+}
+
 class Sk4pxXfermode : public SkProcCoeffXfermode {
 public:
-    typedef Sk4px (SK_VECTORCALL *Proc4)(Sk4px, Sk4px);
-    typedef Sk4px (SK_VECTORCALL *AAProc4)(Sk4px, Sk4px, Sk4px);
-
     Sk4pxXfermode(const ProcCoeff& rec, SkXfermode::Mode mode, Proc4 proc4, AAProc4 aaproc4)
         : INHERITED(rec, mode)
         , fProc4(proc4)
@@ -226,6 +275,10 @@ public:
         }
     }
 
+    void xferA8(SkAlpha dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
+        xfer_a8(dst, src, n, aa, fProc4, fAAProc4);
+    }
+
 private:
     Proc4 fProc4;
     AAProc4 fAAProc4;
@@ -241,6 +294,9 @@ public:
 
     void xfer32(SkPMColor dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
         for (int i = 0; i < n; i++) {
+            if (aa && 0 == aa[i]) {
+                continue;
+            }
             dst[i] = aa ? this->xfer32(dst[i], src[i], aa[i])
                         : this->xfer32(dst[i], src[i]);
         }
@@ -248,6 +304,9 @@ public:
 
     void xfer16(uint16_t dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
         for (int i = 0; i < n; i++) {
+            if (aa && 0 == aa[i]) {
+                continue;
+            }
             SkPMColor dst32 = SkPixel16ToPixel32(dst[i]);
             dst32 = aa ? this->xfer32(dst32, src[i], aa[i])
                        : this->xfer32(dst32, src[i]);
@@ -255,6 +314,18 @@ public:
         }
     }
 
+    void xferA8(SkAlpha dst[], const SkPMColor src[], int n, const SkAlpha aa[]) const override {
+        for (int i = 0; i < n; i++) {
+            if (aa && 0 == aa[i]) {
+                continue;
+            }
+            SkPMColor dst32 = (SkPMColor)dst[i] << SK_A32_SHIFT;
+            dst32 = aa ? this->xfer32(dst32, src[i], aa[i])
+                       : this->xfer32(dst32, src[i]);
+            dst[i] = SkToU8(SkGetPackedA32(dst32));
+        }
+    }
+
 private:
     inline SkPMColor xfer32(SkPMColor dst, SkPMColor src) const {
         return fProcF(SkPMFloat(src), SkPMFloat(dst)).round();
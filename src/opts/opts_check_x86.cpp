@@ -13,12 +13,16 @@
 #include "SkBlitRow.h"
 #include "SkBlitRow_opts_SSE2.h"
 #include "SkBlitRow_opts_SSE4.h"
+#include "SkBlitRow_opts_AVX2.h"
 #include "SkLazyPtr.h"
 #include "SkRTConf.h"
 
 #if defined(_MSC_VER) && defined(_WIN64)
 #include <intrin.h>
 #endif
+#if defined(_MSC_VER)
+#include <immintrin.h>  // _xgetbv()
+#endif
 
 /* This file must *not* be compiled with -msse or any other optional SIMD
    extension, otherwise gcc may generate SIMD instructions even for scalar ops
@@ -28,13 +32,15 @@
 
 
 /* Function to get the CPU SSE-level in runtime, for different compilers. */
+// Sub-leaf 0 is always requested (ecx = 0), which leaf 7 needs and the others ignore.
 #ifdef _MSC_VER
 static inline void getcpuid(int info_type, int info[4]) {
 #if defined(_WIN64)
-    __cpuid(info, info_type);
+    __cpuidex(info, info_type, 0);
 #else
     __asm {
         mov    eax, [info_type]
+        xor    ecx, ecx
         cpuid
         mov    edi, [info]
         mov    [edi], eax
@@ -49,7 +55,7 @@ static inline void getcpuid(int info_type, int info[4]) {
     asm volatile (
         "cpuid \n\t"
         : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #else
@@ -61,11 +67,22 @@ static inline void getcpuid(int info_type, int info[4]) {
         "movl %%ebx, %1   \n\t"
         "popl %%ebx       \n\t"
         : "=a"(info[0]), "=r"(info[1]), "=c"(info[2]), "=d"(info[3])
-        : "a"(info_type)
+        : "a"(info_type), "c"(0)
     );
 }
 #endif
 
+// Returns the OS-enabled register state mask (XCR0).  Only call when CPUID reports OSXSAVE.
+#ifdef _MSC_VER
+static inline uint64_t getxcr0() { return _xgetbv(0); }
+#else
+static inline uint64_t getxcr0() {
+    uint32_t eax, edx;
+    asm volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (uint64_t)edx << 32 | eax;
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /* Fetch the SIMD level directly from the CPU, at run-time.
@@ -74,11 +91,24 @@ static inline void getcpuid(int info_type, int info[4]) {
 namespace {  // get_SIMD_level() technically must have external linkage, so no static.
 int* get_SIMD_level() {
     int cpu_info[4] = { 0, 0, 0, 0 };
+    getcpuid(0, cpu_info);
+    const int max_leaf = cpu_info[0];
     getcpuid(1, cpu_info);
 
     int* level = SkNEW(int);
 
-    if ((cpu_info[2] & (1<<20)) != 0) {
+    // AVX2 also needs the OS to have enabled YMM state (OSXSAVE, then XCR0 bits 1 and 2).
+    bool avx2 = false;
+    if ((cpu_info[2] & (1<<27)) != 0 && (cpu_info[2] & (1<<28)) != 0 &&
+        (getxcr0() & 6) == 6 && max_leaf >= 7) {
+        int leaf7[4] = { 0, 0, 0, 0 };
+        getcpuid(7, leaf7);
+        avx2 = (leaf7[1] & (1<<5)) != 0;
+    }
+
+    if (avx2) {
+        *level = SK_CPU_SSE_LEVEL_AVX2;
+    } else if ((cpu_info[2] & (1<<20)) != 0) {
         *level = SK_CPU_SSE_LEVEL_SSE42;
     } else if ((cpu_info[2] & (1<<19)) != 0) {
         *level = SK_CPU_SSE_LEVEL_SSE41;
@@ -239,7 +269,17 @@ static const SkBlitRow::Proc32 platform_32_procs_SSE4[] = {
     S32A_Blend_BlitRow32_SSE2,          // S32A_Blend,
 };
 
+static const SkBlitRow::Proc32 platform_32_procs_AVX2[] = {
+    NULL,                               // S32_Opaque,
+    S32_Blend_BlitRow32_SSE2,           // S32_Blend,
+    S32A_Opaque_BlitRow32_AVX2,         // S32A_Opaque
+    S32A_Blend_BlitRow32_SSE2,          // S32A_Blend,
+};
+
 SkBlitRow::Proc32 SkBlitRow::PlatformProcs32(unsigned flags) {
+    if (supports_simd(SK_CPU_SSE_LEVEL_AVX2)) {
+        return platform_32_procs_AVX2[flags];
+    } else
     if (supports_simd(SK_CPU_SSE_LEVEL_SSE41)) {
         return platform_32_procs_SSE4[flags];
     } else
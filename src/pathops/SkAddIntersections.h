@@ -11,8 +11,12 @@
 #include "SkIntersections.h"
 
 class SkOpCoincidence;
+class SkOpContourHead;
 
-bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coincidence,
+/** Finds the intersections between all the sorted contours' segments, and their coincidence.
+    With many segments to check, the pairs of contours are searched on SkTaskGroup threads;
+    the intersections are still added in the same order, so the result is the same. */
+void AddIntersectTs(SkOpContourHead* contourList, SkOpCoincidence* coincidence,
         SkChunkAlloc* allocator);
 
 #endif
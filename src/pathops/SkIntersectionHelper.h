@@ -60,6 +60,10 @@ public:
         return fSegment;
     }
 
+    void set(SkOpSegment* segment) {
+        fSegment = segment;
+    }
+
     SegmentType segmentType() const {
         SegmentType type = (SegmentType) fSegment->verb();
         if (type != kLine_Segment) {
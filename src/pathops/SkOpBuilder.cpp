@@ -10,6 +10,7 @@
 #include "SkPathPriv.h"
 #include "SkPathOps.h"
 #include "SkPathOpsCommon.h"
+#include "SkTaskGroup.h"
 
 static bool one_contour(const SkPath& path) {
     SkChunkAlloc allocator(256);
@@ -25,7 +26,7 @@ static bool one_contour(const SkPath& path) {
     return true;
 }
 
-void FixWinding(SkPath* path) {
+void FixWinding(SkPath* path, SkChunkAlloc* allocatorPtr) {
     SkPath::FillType fillType = path->getFillType();
     if (fillType == SkPath::kInverseEvenOdd_FillType) {
         fillType = SkPath::kInverseWinding_FillType;
@@ -42,7 +43,7 @@ void FixWinding(SkPath* path) {
         path->setFillType(fillType);
         return;
     }
-    SkChunkAlloc allocator(4096);
+    SkChunkAlloc& allocator = *allocatorPtr;
     SkOpContourHead contourHead;
     SkOpGlobalState globalState(NULL, &contourHead  SkDEBUGPARAMS(NULL));
     SkOpEdgeBuilder builder(*path, &contourHead, &allocator, &globalState);
@@ -69,6 +70,7 @@ void FixWinding(SkPath* path) {
     }
     if (!writePath) {
         path->setFillType(fillType);
+        allocator.rewind();
         return;
     }
     SkPath empty;
@@ -83,8 +85,44 @@ void FixWinding(SkPath* path) {
     } while ((test = test->next()));
     *path = *woundPath.nativePath();
     path->setFillType(fillType);
+    allocator.rewind();
 }
 
+// Unions the paths in pairs, then the unions of the pairs in pairs, and so on, so that each edge
+// is intersected with the others about log(count) times instead of up to count times. The pairs
+// of each round don't depend on one another, so they are unioned concurrently.
+static bool union_in_tree(SkTArray<SkPath>* paths, SkPath* result, SkChunkAlloc* allocator) {
+    int count = paths->count();
+    while (count > 1) {
+        int pairs = count >> 1;
+        SkAutoSTMalloc<32, bool> succeeded(pairs);
+        if (1 == pairs) {
+            succeeded[0] = OpWithAllocator((*paths)[0], (*paths)[1], kUnion_SkPathOp,
+                    &(*paths)[0], allocator);
+        } else {
+            bool* succeededPtr = succeeded.get();
+            sk_parallel_for(pairs, [paths, succeededPtr](int index) {
+                SkPath* one = &(*paths)[index * 2];
+                succeededPtr[index] = Op(*one, (*paths)[index * 2 + 1], kUnion_SkPathOp, one);
+            });
+        }
+        for (int index = 0; index < pairs; ++index) {
+            if (!succeeded[index]) {
+                return false;
+            }
+            (*paths)[index].swap((*paths)[index * 2]);
+        }
+        if (count & 1) {
+            (*paths)[pairs].swap((*paths)[count - 1]);
+        }
+        count = pairs + (count & 1);
+    }
+    result->swap((*paths)[0]);
+    return true;
+}
+
+SkOpBuilder::SkOpBuilder() : fAllocator(kPathOpsAllocatorMinSize) {}
+
 void SkOpBuilder::add(const SkPath& path, SkPathOp op) {
     if (0 == fOps.count() && op != kUnion_SkPathOp) {
         fPathRefs.push_back() = SkPath();
@@ -140,9 +178,24 @@ bool SkOpBuilder::resolve(SkPath* result) {
         }
     }
     if (!allUnion) {
+        bool onlyUnion = true;
+        for (int index = 0; index < count; ++index) {
+            if (kUnion_SkPathOp != fOps[index]) {
+                onlyUnion = false;
+                break;
+            }
+        }
+        if (onlyUnion && count > 2) {
+            bool success = union_in_tree(&fPathRefs, result, &fAllocator);
+            reset();
+            if (!success) {
+                *result = original;
+            }
+            return success;
+        }
         *result = fPathRefs[0];
         for (int index = 1; index < count; ++index) {
-            if (!Op(*result, fPathRefs[index], fOps[index], result)) {
+            if (!OpWithAllocator(*result, fPathRefs[index], fOps[index], result, &fAllocator)) {
                 reset();
                 *result = original;
                 return false;
@@ -153,19 +206,19 @@ bool SkOpBuilder::resolve(SkPath* result) {
     }
     SkPath sum;
     for (int index = 0; index < count; ++index) {
-        if (!Simplify(fPathRefs[index], &fPathRefs[index])) {
+        if (!SimplifyWithAllocator(fPathRefs[index], &fPathRefs[index], &fAllocator)) {
             reset();
             *result = original;
             return false;
         }
         if (!fPathRefs[index].isEmpty()) {
             // convert the even odd result back to winding form before accumulating it
-            FixWinding(&fPathRefs[index]);
+            FixWinding(&fPathRefs[index], &fAllocator);
             sum.addPath(fPathRefs[index]);
         }
     }
     reset();
-    bool success = Simplify(sum, result);
+    bool success = SimplifyWithAllocator(sum, result, &fAllocator);
     if (!success) {
         *result = original;
     }
@@ -10,6 +10,7 @@
 #include "SkOpAngle.h"
 #include "SkTDArray.h"
 
+class SkChunkAlloc;
 class SkOpCoincidence;
 class SkOpContour;
 class SkPathWriter;
@@ -22,11 +23,21 @@ SkOpSegment* FindChase(SkTDArray<SkOpSpanBase*>* chase, SkOpSpanBase** startPtr,
 SkOpSpan* FindSortableTop(SkOpContourHead* );
 SkOpSegment* FindUndone(SkOpContourHead* , SkOpSpanBase** startPtr,
                         SkOpSpanBase** endPtr);
-void FixWinding(SkPath* path);
+void FixWinding(SkPath* path, SkChunkAlloc* );
 bool SortContourList(SkOpContourHead** , bool evenOdd, bool oppEvenOdd);
 bool HandleCoincidence(SkOpContourHead* , SkOpCoincidence* , SkChunkAlloc* );
 bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
              bool expectSuccess  SkDEBUGPARAMS(const char* testName));
+
+// The smallest block the contours, segments and spans of an op are allocated from.
+// FIXME: tune
+static const size_t kPathOpsAllocatorMinSize = 4096;
+
+// Op() and Simplify(), allocating from the caller's allocator, which is rewound when they
+// return so that its largest block can be reused by the next op.
+bool OpWithAllocator(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+                     SkChunkAlloc* );
+bool SimplifyWithAllocator(const SkPath& path, SkPath* result, SkChunkAlloc* );
 #if DEBUG_ACTIVE_SPANS
 void DebugShowActiveSpans(SkOpContourHead* );
 #endif
@@ -222,9 +222,9 @@ static void dump_op(const SkPath& one, const SkPath& two, SkPathOp op) {
 }
 #endif
 
-bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
-        bool expectSuccess  SkDEBUGPARAMS(const char* testName)) {
-    SkChunkAlloc allocator(4096);  // FIXME: add a constant expression here, tune
+static bool op_with_allocator(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        SkChunkAlloc* allocatorPtr  SkDEBUGPARAMS(const char* testName)) {
+    SkChunkAlloc& allocator = *allocatorPtr;
     SkOpContour contour;
     SkOpContourHead* contourList = static_cast<SkOpContourHead*>(&contour);
     SkOpCoincidence coincidence;
@@ -274,13 +274,7 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
         return true;
     }
     // find all intersections between segments
-    SkOpContour* current = contourList;
-    do {
-        SkOpContour* next = current;
-        while (AddIntersectTs(current, next, &coincidence, &allocator)
-                && (next = next->next()))
-            ;
-    } while ((current = current->next()));
+    AddIntersectTs(contourList, &coincidence, &allocator);
 #if DEBUG_VALIDATE
     globalState.setPhase(SkOpGlobalState::kWalking);
 #endif
@@ -303,6 +297,19 @@ bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
     return true;
 }
 
+bool OpDebug(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        bool expectSuccess  SkDEBUGPARAMS(const char* testName)) {
+    SkChunkAlloc allocator(kPathOpsAllocatorMinSize);
+    return op_with_allocator(one, two, op, result, &allocator  SkDEBUGPARAMS(testName));
+}
+
+bool OpWithAllocator(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result,
+        SkChunkAlloc* allocator) {
+    bool success = op_with_allocator(one, two, op, result, allocator  SkDEBUGPARAMS(NULL));
+    allocator->rewind();
+    return success;
+}
+
 bool Op(const SkPath& one, const SkPath& two, SkPathOp op, SkPath* result) {
     return OpDebug(one, two, op, result, true  SkDEBUGPARAMS(NULL));
 }
@@ -150,9 +150,9 @@ static bool bridgeXor(SkOpContourHead* contourList, SkPathWriter* simple,
     return closable;
 }
 
-// FIXME : add this as a member of SkPath
-bool Simplify(const SkPath& path, SkPath* result) {
-    SkChunkAlloc allocator(4096);  // FIXME: constant-ize, tune
+static bool simplify_with_allocator(const SkPath& path, SkPath* result,
+        SkChunkAlloc* allocatorPtr) {
+    SkChunkAlloc& allocator = *allocatorPtr;
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     SkPath::FillType fillType = path.isInverseFillType() ? SkPath::kInverseEvenOdd_FillType
             : SkPath::kEvenOdd_FillType;
@@ -184,12 +184,7 @@ bool Simplify(const SkPath& path, SkPath* result) {
         return true;
     }
     // find all intersections between segments
-    SkOpContour* current = contourList;
-    do {
-        SkOpContour* next = current;
-        while (AddIntersectTs(current, next, &coincidence, &allocator)
-                && (next = next->next()));
-    } while ((current = current->next()));
+    AddIntersectTs(contourList, &coincidence, &allocator);
 #if DEBUG_VALIDATE
     globalState.setPhase(SkOpGlobalState::kWalking);
 #endif
@@ -213,3 +208,14 @@ bool Simplify(const SkPath& path, SkPath* result) {
     return true;
 }
 
+// FIXME : add this as a member of SkPath
+bool Simplify(const SkPath& path, SkPath* result) {
+    SkChunkAlloc allocator(kPathOpsAllocatorMinSize);
+    return simplify_with_allocator(path, result, &allocator);
+}
+
+bool SimplifyWithAllocator(const SkPath& path, SkPath* result, SkChunkAlloc* allocator) {
+    bool success = simplify_with_allocator(path, result, allocator);
+    allocator->rewind();
+    return success;
+}
@@ -431,10 +431,40 @@ void PDFJpegBitmap::emitObject(SkWStream* stream,
     stream->write(fData->data(), fData->size());
     pdf_stream_end(stream);
 }
+
+// Returns the JFIF data the pixel ref was decoded from, if it is the same
+// size as the pixel ref.  Requires the pixel ref to be lazy.
+SkData* ref_jfif_data(SkPixelRef* pixelRef, SkJFIFInfo* info) {
+    SkAutoTUnref<SkData> data(pixelRef->refEncodedData());
+    if (data && SkIsJFIF(data, info) &&
+        info->fWidth == pixelRef->info().width() &&
+        info->fHeight == pixelRef->info().height()) {
+        return data.detach();
+    }
+    return NULL;
+}
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool SkPDFBitmap::GetJpegWhole(const SkBitmap& bitmap, SkBitmap* whole) {
+    SkASSERT(whole);
+    SkPixelRef* pixelRef = bitmap.pixelRef();
+    if (!pixelRef || !pixelRef->isImmutable() ||
+        (bitmap.pixelRefOrigin().isZero() &&
+         bitmap.dimensions() == pixelRef->info().dimensions())) {
+        return false;
+    }
+    SkJFIFInfo info;
+    SkAutoTUnref<SkData> data(ref_jfif_data(pixelRef, &info));
+    if (!data) {
+        return false;
+    }
+    whole->setInfo(pixelRef->info(), bitmap.rowBytes());
+    whole->setPixelRef(pixelRef);
+    return true;
+}
+
 SkPDFBitmap* SkPDFBitmap::Create(SkPDFCanon* canon, const SkBitmap& bitmap) {
     SkASSERT(canon);
     if (!SkColorTypeIsValid(bitmap.colorType()) ||
@@ -452,13 +482,16 @@ SkPDFBitmap* SkPDFBitmap::Create(SkPDFCanon* canon, const SkBitmap& bitmap) {
 
     if (bm.pixelRef() && bm.pixelRefOrigin().isZero() &&
         bm.dimensions() == bm.pixelRef()->info().dimensions()) {
-        // Requires the bitmap to be backed by lazy pixels.
-        SkAutoTUnref<SkData> data(bm.pixelRef()->refEncodedData());
         SkJFIFInfo info;
-        if (data && SkIsJFIF(data, &info)) {
+        SkAutoTUnref<SkData> data(ref_jfif_data(bm.pixelRef(), &info));
+        if (data) {
+            if (SkPDFBitmap* canonBitmap = canon->findJpegBitmap(data)) {
+                return SkRef(canonBitmap);
+            }
             bool yuv = info.fType == SkJFIFInfo::kYCbCr;
             SkPDFBitmap* pdfBitmap = SkNEW_ARGS(PDFJpegBitmap, (bm, data, yuv));
             canon->addBitmap(pdfBitmap);
+            canon->addJpegBitmap(pdfBitmap, data);
             return pdfBitmap;
         }
     }
@@ -26,6 +26,13 @@ class SkPDFBitmap : public SkPDFObject {
 public:
     // Returns NULL on unsupported bitmap;
     static SkPDFBitmap* Create(SkPDFCanon*, const SkBitmap&);
+
+    // If bitmap is a subset of immutable pixels that can be embedded as
+    // their original JPEG data, set *whole to all of those pixels and
+    // return true.  Drawing *whole clipped to the subset avoids decoding
+    // and re-encoding the subset.
+    static bool GetJpegWhole(const SkBitmap& bitmap, SkBitmap* whole);
+
     bool equals(const SkBitmap& other) const {
         return fBitmap.getGenerationID() == other.getGenerationID() &&
                fBitmap.pixelRefOrigin() == other.pixelRefOrigin() &&
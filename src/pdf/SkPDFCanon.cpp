@@ -5,9 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "SkChecksum.h"
+#include "SkData.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
 #include "SkPDFFont.h"
+#include "SkPDFFormXObject.h"
 #include "SkPDFShader.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -27,6 +30,16 @@ void SkPDFCanon::reset() {
     fGraphicStateRecords.reset();
     fBitmapRecords.unrefAll();
     fBitmapRecords.reset();
+    for (int i = 0; i < fJpegRecords.count(); ++i) {
+        fJpegRecords[i].fData->unref();
+        fJpegRecords[i].fBitmap->unref();
+    }
+    fJpegRecords.reset();
+    for (int i = 0; i < fPictureRecords.count(); ++i) {
+        fPictureRecords[i].fForm->unref();
+        SkDELETE(fPictureRecords[i].fGlyphUsage);
+    }
+    fPictureRecords.reset();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -128,3 +141,51 @@ SkPDFBitmap* SkPDFCanon::findBitmap(const SkBitmap& bm) const {
 void SkPDFCanon::addBitmap(SkPDFBitmap* pdfBitmap) {
     fBitmapRecords.push(SkRef(pdfBitmap));
 }
+
+SkPDFBitmap* SkPDFCanon::findJpegBitmap(const SkData* data) const {
+    SkASSERT(data);
+    const uint64_t hash = SkChecksum::Hash64(data->data(), data->size());
+    for (int i = 0; i < fJpegRecords.count(); ++i) {
+        if (fJpegRecords[i].fHash == hash && fJpegRecords[i].fData->equals(data)) {
+            return fJpegRecords[i].fBitmap;
+        }
+    }
+    return NULL;
+}
+
+void SkPDFCanon::addJpegBitmap(SkPDFBitmap* pdfBitmap, SkData* data) {
+    SkASSERT(pdfBitmap && data);
+    JpegRec* rec = fJpegRecords.push();
+    rec->fData = SkRef(data);
+    rec->fHash = SkChecksum::Hash64(data->data(), data->size());
+    rec->fBitmap = SkRef(pdfBitmap);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+SkPDFFormXObject* SkPDFCanon::findPictureForm(
+        uint32_t pictureID,
+        const SkMatrix& linear,
+        const SkPDFGlyphSetMap** glyphUsage) const {
+    SkASSERT(glyphUsage);
+    for (int i = 0; i < fPictureRecords.count(); ++i) {
+        const PictureRec& rec = fPictureRecords[i];
+        if (rec.fPictureID == pictureID && rec.fLinear == linear) {
+            *glyphUsage = rec.fGlyphUsage;
+            return rec.fForm;
+        }
+    }
+    return NULL;
+}
+
+void SkPDFCanon::addPictureForm(SkPDFFormXObject* form,
+                                uint32_t pictureID,
+                                const SkMatrix& linear,
+                                SkPDFGlyphSetMap* glyphUsage) {
+    SkASSERT(form && glyphUsage);
+    PictureRec* rec = fPictureRecords.push();
+    rec->fPictureID = pictureID;
+    rec->fLinear = linear;
+    rec->fForm = SkRef(form);
+    rec->fGlyphUsage = glyphUsage;
+}
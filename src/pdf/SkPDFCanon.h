@@ -7,14 +7,18 @@
 #ifndef SkPDFCanon_DEFINED
 #define SkPDFCanon_DEFINED
 
+#include "SkMatrix.h"
 #include "SkPDFGraphicState.h"
 #include "SkPDFShader.h"
 #include "SkTDArray.h"
 #include "SkTHash.h"
 
 class SkBitmap;
+class SkData;
 class SkPDFFont;
 class SkPDFBitmap;
+class SkPDFFormXObject;
+class SkPDFGlyphSetMap;
 class SkPaint;
 
 /**
@@ -63,6 +67,24 @@ public:
     SkPDFBitmap* findBitmap(const SkBitmap&) const;
     void addBitmap(SkPDFBitmap*);
 
+    // Bitmaps embedded as encoded JPEG data are also found by that data, so
+    // separate decodes of the same JPEG share one image XObject.
+    SkPDFBitmap* findJpegBitmap(const SkData*) const;
+    void addJpegBitmap(SkPDFBitmap*, SkData*);
+
+    // Pictures drawn as form XObjects are found by picture ID and by the
+    // scale and skew (the matrix without its translation) they were drawn
+    // with, so every page that draws the same picture shares one form.
+    // glyphUsage is the fonts and glyphs the form draws; addPictureForm()
+    // takes ownership of it.
+    SkPDFFormXObject* findPictureForm(uint32_t pictureID,
+                                      const SkMatrix& linear,
+                                      const SkPDFGlyphSetMap** glyphUsage) const;
+    void addPictureForm(SkPDFFormXObject*,
+                        uint32_t pictureID,
+                        const SkMatrix& linear,
+                        SkPDFGlyphSetMap* glyphUsage);
+
 private:
     struct FontRec {
         SkPDFFont* fFont;
@@ -93,5 +115,20 @@ private:
     SkTHashSet<WrapGS, WrapGS::Hash> fGraphicStateRecords;
 
     SkTDArray<SkPDFBitmap*> fBitmapRecords;
+
+    struct JpegRec {
+        SkData* fData;
+        uint64_t fHash;  // SkChecksum::Hash64() of fData, compared before the bytes.
+        SkPDFBitmap* fBitmap;
+    };
+    SkTDArray<JpegRec> fJpegRecords;
+
+    struct PictureRec {
+        uint32_t fPictureID;
+        SkMatrix fLinear;
+        SkPDFFormXObject* fForm;
+        SkPDFGlyphSetMap* fGlyphUsage;
+    };
+    SkTDArray<PictureRec> fPictureRecords;
 };
 #endif  // SkPDFCanon_DEFINED
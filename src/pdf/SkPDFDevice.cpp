@@ -17,6 +17,7 @@
 #include "SkPath.h"
 #include "SkPathOps.h"
 #include "SkPDFBitmap.h"
+#include "SkPDFCanon.h"
 #include "SkPDFFont.h"
 #include "SkPDFFormXObject.h"
 #include "SkPDFGraphicState.h"
@@ -1370,6 +1371,86 @@ void SkPDFDevice::drawDevice(const SkDraw& d, SkBaseDevice* device,
     fFontGlyphUsage->merge(pdfDevice->getFontGlyphUsage());
 }
 
+bool SkPDFDevice::EXPERIMENTAL_drawPicture(SkCanvas* canvas, const SkPicture* picture,
+                                           const SkMatrix* matrix, const SkPaint* paint) {
+    // Play the picture back once into a form XObject, then draw that form
+    // wherever the same picture is drawn with the same scale and skew, on
+    // this page or any other.  Cases a translated form can't reproduce are
+    // left to SkCanvas to play back.
+    if (paint || canvas->getDrawFilter() || !canvas->isClipRect() ||
+        !this->getOrigin().isZero()) {
+        return false;
+    }
+    SkIRect clipBounds;
+    if (!canvas->getClipDeviceBounds(&clipBounds)) {
+        return true;  // Nothing is visible.
+    }
+    SkMatrix total = canvas->getTotalMatrix();
+    if (matrix) {
+        total.preConcat(*matrix);
+    }
+    if (total.hasPerspective()) {
+        return false;
+    }
+    SkMatrix linear = total;
+    linear.setTranslateX(0);
+    linear.setTranslateY(0);
+    SkRect mappedCull;
+    linear.mapRect(&mappedCull, picture->cullRect());
+    SkIRect bounds;
+    mappedCull.roundOut(&bounds);
+    if (bounds.isEmpty()) {
+        return false;
+    }
+
+    const SkPDFGlyphSetMap* glyphUsage = NULL;
+    SkPDFFormXObject* form = fCanon->findPictureForm(picture->uniqueID(), linear, &glyphUsage);
+    if (!form) {
+        SkAutoTUnref<SkPDFDevice> pictureDevice(
+                SkPDFDevice::Create(bounds.size(), fRasterDpi, fCanon));
+        {
+            SkCanvas pictureCanvas(pictureDevice.get());
+            pictureCanvas.translate(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop));
+            pictureCanvas.concat(linear);
+            picture->playback(&pictureCanvas);
+        }
+        // Links and named destinations belong to the page, not to a form.
+        if (pictureDevice->fAnnotations || !pictureDevice->fNamedDestinations.isEmpty()) {
+            return false;
+        }
+        SkAutoTUnref<SkPDFFormXObject> newForm(
+                SkNEW_ARGS(SkPDFFormXObject, (pictureDevice.get())));
+        SkPDFGlyphSetMap* newGlyphUsage = SkNEW(SkPDFGlyphSetMap);
+        newGlyphUsage->merge(pictureDevice->getFontGlyphUsage());
+        fCanon->addPictureForm(newForm.get(), picture->uniqueID(), linear, newGlyphUsage);
+        form = newForm.get();
+        glyphUsage = newGlyphUsage;
+    }
+
+    const SkScalar x = total.getTranslateX() + SkIntToScalar(bounds.fLeft);
+    const SkScalar y = total.getTranslateY() + SkIntToScalar(bounds.fTop);
+    SkMatrix formMatrix;
+    formMatrix.setTranslate(x, y);
+    const SkPaint formPaint;
+    ScopedContentEntry content(this, canvas->getClipStack(), SkRegion(clipBounds), formMatrix,
+                               formPaint);
+    if (!content.entry()) {
+        return true;
+    }
+    if (content.needShape()) {
+        SkPath shape;
+        shape.addRect(SkRect::MakeXYWH(x, y, SkIntToScalar(bounds.width()),
+                                       SkIntToScalar(bounds.height())));
+        content.setShape(shape);
+    }
+    if (content.needSource()) {
+        SkPDFUtils::DrawFormXObject(this->addXObjectResource(form),
+                                    &content.entry()->fContent);
+        fFontGlyphUsage->merge(*glyphUsage);
+    }
+    return true;
+}
+
 SkImageInfo SkPDFDevice::imageInfo() const {
     return fLegacyBitmap.info();
 }
@@ -2201,6 +2282,14 @@ void SkPDFDevice::internalDrawBitmap(const SkMatrix& origMatrix,
     if (!bitmap->extractSubset(&subsetBitmap, subset)) {
         return;
     }
+    SkBitmap jpegBitmap;
+    if (SkPDFBitmap::GetJpegWhole(subsetBitmap, &jpegBitmap)) {
+        // Embed the whole JPEG and clip it to the subset, instead of
+        // decoding the subset and compressing it again.
+        this->drawJpegSubset(subsetBitmap, jpegBitmap,
+                             &content.entry()->fContent);
+        return;
+    }
     SkAutoTUnref<SkPDFObject> image(SkPDFBitmap::Create(fCanon, subsetBitmap));
     if (!image) {
         return;
@@ -2209,3 +2298,39 @@ void SkPDFDevice::internalDrawBitmap(const SkMatrix& origMatrix,
     SkPDFUtils::DrawFormXObject(this->addXObjectResource(image.get()),
                                 &content.entry()->fContent);
 }
+
+void SkPDFDevice::drawJpegSubset(const SkBitmap& subsetBitmap,
+                                 const SkBitmap& jpegBitmap,
+                                 SkWStream* content) {
+    SkAutoTUnref<SkPDFObject> image(SkPDFBitmap::Create(fCanon, jpegBitmap));
+    if (!image) {
+        return;
+    }
+    // The content space maps the unit square to the subset.  Map the unit
+    // square of the whole image so that the subset lands in the same place.
+    SkMatrix subsetToPixels;
+    subsetToPixels.setScale(SK_Scalar1, -SK_Scalar1);
+    subsetToPixels.postTranslate(0, SK_Scalar1);
+    subsetToPixels.postScale(SkIntToScalar(subsetBitmap.width()),
+                             SkIntToScalar(subsetBitmap.height()));
+    SkMatrix pixelsToSubset;
+    if (!subsetToPixels.invert(&pixelsToSubset)) {
+        return;
+    }
+    const SkIPoint origin = subsetBitmap.pixelRefOrigin();
+    SkMatrix wholeToSubset;
+    wholeToSubset.setScale(SK_Scalar1, -SK_Scalar1);
+    wholeToSubset.postTranslate(0, SK_Scalar1);
+    wholeToSubset.postScale(SkIntToScalar(jpegBitmap.width()),
+                            SkIntToScalar(jpegBitmap.height()));
+    wholeToSubset.postTranslate(-SkIntToScalar(origin.x()),
+                                -SkIntToScalar(origin.y()));
+    wholeToSubset.postConcat(pixelsToSubset);
+
+    content->writeText("q\n");
+    SkPDFUtils::AppendRectangle(SkRect::MakeWH(SK_Scalar1, SK_Scalar1), content);
+    content->writeText("W n\n");
+    SkPDFUtils::AppendTransform(wholeToSubset, content);
+    SkPDFUtils::DrawFormXObject(this->addXObjectResource(image.get()), content);
+    content->writeText("Q\n");
+}
@@ -110,6 +110,8 @@ public:
                       int indexCount, const SkPaint& paint) override;
     void drawDevice(const SkDraw&, SkBaseDevice*, int x, int y,
                     const SkPaint&) override;
+    bool EXPERIMENTAL_drawPicture(SkCanvas*, const SkPicture*, const SkMatrix*,
+                                  const SkPaint*) override;
 
     void onAttachToCanvas(SkCanvas* canvas) override;
     void onDetachFromCanvas() override;
@@ -280,6 +282,9 @@ private:
                             const SkBitmap& bitmap,
                             const SkIRect* srcRect,
                             const SkPaint& paint);
+    void drawJpegSubset(const SkBitmap& subsetBitmap,
+                        const SkBitmap& jpegBitmap,
+                        SkWStream* content);
 
     /** Helper method for copyContentToData. It is responsible for copying the
      *  list of content entries |entry| to |data|.
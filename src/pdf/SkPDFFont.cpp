@@ -18,8 +18,10 @@
 #include "SkPDFTypes.h"
 #include "SkPDFUtils.h"
 #include "SkRefCnt.h"
+#include "SkResourceCache.h"
 #include "SkScalar.h"
 #include "SkStream.h"
+#include "SkStreamPriv.h"
 #include "SkTypefacePriv.h"
 #include "SkTypes.h"
 #include "SkUtils.h"
@@ -577,6 +579,116 @@ static SkPDFStream* generate_tounicode_cmap(
     return new SkPDFStream(cmapData.get());
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Process-wide typeface cache
+///////////////////////////////////////////////////////////////////////////////
+
+// Every document that embeds a typeface asks it for the same metrics and the
+// same font file, so both are kept in the global SkResourceCache, keyed by
+// typeface ID, rather than recomputed and reread for each document.
+namespace {
+static unsigned gPDFFontMetricsKeyNamespaceLabel;
+static unsigned gPDFFontDataKeyNamespaceLabel;
+
+struct PDFFontKey : public SkResourceCache::Key {
+    PDFFontKey(void* nameSpace, uint32_t fontID, uint32_t perGlyphInfo)
+        : fFontID(fontID)
+        , fPerGlyphInfo(perGlyphInfo) {
+        this->init(nameSpace, 0, sizeof(fFontID) + sizeof(fPerGlyphInfo));
+    }
+
+    uint32_t fFontID;
+    uint32_t fPerGlyphInfo;
+};
+
+struct PDFFontMetricsRec : public SkResourceCache::Rec {
+    PDFFontMetricsRec(const PDFFontKey& key, const SkAdvancedTypefaceMetrics* metrics)
+        : fKey(key)
+        , fMetrics(SkRef(metrics)) {}
+
+    PDFFontKey fKey;
+    SkAutoTUnref<const SkAdvancedTypefaceMetrics> fMetrics;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        size_t size = sizeof(*this) + sizeof(SkAdvancedTypefaceMetrics) +
+                      fMetrics->fGlyphToUnicode.count() * sizeof(SkUnichar);
+        if (fMetrics->fGlyphNames.get()) {
+            size += (fMetrics->fLastGlyphID + 1) * sizeof(SkString);
+        }
+        return size;
+    }
+    const char* getCategory() const override { return "pdf-font-metrics"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
+        const PDFFontMetricsRec& rec = static_cast<const PDFFontMetricsRec&>(baseRec);
+        *static_cast<const SkAdvancedTypefaceMetrics**>(context) = SkRef(rec.fMetrics.get());
+        return true;
+    }
+};
+
+struct PDFFontDataRec : public SkResourceCache::Rec {
+    struct Value {
+        SkData* fData;
+        int fTtcIndex;
+    };
+
+    PDFFontDataRec(const PDFFontKey& key, SkData* data, int ttcIndex)
+        : fKey(key) {
+        fValue.fData = SkRef(data);
+        fValue.fTtcIndex = ttcIndex;
+    }
+    ~PDFFontDataRec() { fValue.fData->unref(); }
+
+    PDFFontKey fKey;
+    Value fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "pdf-font-data"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
+        const PDFFontDataRec& rec = static_cast<const PDFFontDataRec&>(baseRec);
+        Value* result = static_cast<Value*>(context);
+        result->fData = SkRef(rec.fValue.fData);
+        result->fTtcIndex = rec.fValue.fTtcIndex;
+        return true;
+    }
+};
+}  // namespace
+
+// static
+const SkAdvancedTypefaceMetrics* SkPDFFont::RefFontMetrics(
+        SkTypeface* typeface, SkTypeface::PerGlyphInfo perGlyphInfo) {
+    PDFFontKey key(&gPDFFontMetricsKeyNamespaceLabel, typeface->uniqueID(), perGlyphInfo);
+    const SkAdvancedTypefaceMetrics* metrics = NULL;
+    if (SkResourceCache::Find(key, PDFFontMetricsRec::Visitor, &metrics)) {
+        return metrics;
+    }
+    metrics = typeface->getAdvancedTypefaceMetrics(perGlyphInfo, NULL, 0);
+    if (metrics) {
+        SkResourceCache::Add(SkNEW_ARGS(PDFFontMetricsRec, (key, metrics)));
+    }
+    return metrics;
+}
+
+// Returns the contents of the typeface's font file, or NULL.
+static SkData* ref_font_data(const SkTypeface* typeface, int* ttcIndex) {
+    PDFFontKey key(&gPDFFontDataKeyNamespaceLabel, typeface->uniqueID(), 0);
+    PDFFontDataRec::Value value;
+    if (SkResourceCache::Find(key, PDFFontDataRec::Visitor, &value)) {
+        *ttcIndex = value.fTtcIndex;
+        return value.fData;
+    }
+    SkAutoTDelete<SkStream> stream(typeface->openStream(ttcIndex));
+    if (!stream.get()) {
+        return NULL;
+    }
+    SkData* data = SkCopyStreamToData(stream.get());
+    SkResourceCache::Add(SkNEW_ARGS(PDFFontDataRec, (key, data, *ttcIndex)));
+    return data;
+}
+
 #if defined (SK_SFNTLY_SUBSETTER)
 static void sk_delete_array(const void* ptr, void*) {
     // Use C-style cast to cast away const and cast type simultaneously.
@@ -589,42 +701,32 @@ static size_t get_subset_font_stream(const char* fontName,
                                      const SkTDArray<uint32_t>& subset,
                                      SkPDFStream** fontStream) {
     int ttcIndex;
-    SkAutoTDelete<SkStream> fontData(typeface->openStream(&ttcIndex));
+    SkAutoTUnref<SkData> fontData(ref_font_data(typeface, &ttcIndex));
     SkASSERT(fontData.get());
 
-    size_t fontSize = fontData->getLength();
+    size_t fontSize = fontData->size();
 
 #if defined (SK_SFNTLY_SUBSETTER)
-    // Read font into buffer.
-    SkPDFStream* subsetFontStream = NULL;
-    SkTDArray<unsigned char> originalFont;
-    originalFont.setCount(SkToInt(fontSize));
-    if (fontData->read(originalFont.begin(), fontSize) == fontSize) {
-        unsigned char* subsetFont = NULL;
-        // sfntly requires unsigned int* to be passed in, as far as we know,
-        // unsigned int is equivalent to uint32_t on all platforms.
-        SK_COMPILE_ASSERT(sizeof(unsigned int) == sizeof(uint32_t),
-                          unsigned_int_not_32_bits);
-        int subsetFontSize = SfntlyWrapper::SubsetFont(fontName,
-                                                       originalFont.begin(),
-                                                       fontSize,
-                                                       subset.begin(),
-                                                       subset.count(),
-                                                       &subsetFont);
-        if (subsetFontSize > 0 && subsetFont != NULL) {
-            SkAutoDataUnref data(SkData::NewWithProc(subsetFont,
-                                                     subsetFontSize,
-                                                     sk_delete_array,
-                                                     NULL));
-            subsetFontStream = new SkPDFStream(data.get());
-            fontSize = subsetFontSize;
-        }
-    }
-    if (subsetFontStream) {
-        *fontStream = subsetFontStream;
-        return fontSize;
+    // Subset straight from the cached font file.
+    unsigned char* subsetFont = NULL;
+    // sfntly requires unsigned int* to be passed in, as far as we know,
+    // unsigned int is equivalent to uint32_t on all platforms.
+    SK_COMPILE_ASSERT(sizeof(unsigned int) == sizeof(uint32_t),
+                      unsigned_int_not_32_bits);
+    int subsetFontSize = SfntlyWrapper::SubsetFont(fontName,
+                                                   fontData->bytes(),
+                                                   fontSize,
+                                                   subset.begin(),
+                                                   subset.count(),
+                                                   &subsetFont);
+    if (subsetFontSize > 0 && subsetFont != NULL) {
+        SkAutoDataUnref data(SkData::NewWithProc(subsetFont,
+                                                 subsetFontSize,
+                                                 sk_delete_array,
+                                                 NULL));
+        *fontStream = new SkPDFStream(data.get());
+        return subsetFontSize;
     }
-    fontData->rewind();
 #else
     sk_ignore_unused_variable(fontName);
     sk_ignore_unused_variable(subset);
@@ -835,16 +937,14 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFCanon* canon,
         info = SkTBitOr<SkTypeface::PerGlyphInfo>(
                   info, SkTypeface::kHAdvance_PerGlyphInfo);
 #endif
-        fontMetrics.reset(
-            typeface->getAdvancedTypefaceMetrics(info, NULL, 0));
+        fontMetrics.reset(RefFontMetrics(typeface, info));
 #if defined (SK_SFNTLY_SUBSETTER)
         if (fontMetrics.get() &&
             fontMetrics->fType != SkAdvancedTypefaceMetrics::kTrueType_Font) {
             // Font does not support subsetting, get new info with advance.
             info = SkTBitOr<SkTypeface::PerGlyphInfo>(
                       info, SkTypeface::kHAdvance_PerGlyphInfo);
-            fontMetrics.reset(
-                typeface->getAdvancedTypefaceMetrics(info, NULL, 0));
+            fontMetrics.reset(RefFontMetrics(typeface, info));
         }
 #endif
     }
@@ -1073,10 +1173,9 @@ bool SkPDFCIDFont::addFontDescriptor(int16_t defaultWidth,
                 fontStream.reset(rawStream);
             } else {
                 int ttcIndex;
-                SkAutoTDelete<SkStream> fontData(
-                        typeface()->openStream(&ttcIndex));
+                SkAutoTUnref<SkData> fontData(ref_font_data(typeface(), &ttcIndex));
                 fontStream.reset(new SkPDFStream(fontData.get()));
-                fontSize = fontData->getLength();
+                fontSize = fontData->size();
             }
             SkASSERT(fontSize);
             SkASSERT(fontStream.get());
@@ -1088,7 +1187,7 @@ bool SkPDFCIDFont::addFontDescriptor(int16_t defaultWidth,
         case SkAdvancedTypefaceMetrics::kCFF_Font:
         case SkAdvancedTypefaceMetrics::kType1CID_Font: {
             int ttcIndex;
-            SkAutoTDelete<SkStream> fontData(typeface()->openStream(&ttcIndex));
+            SkAutoTUnref<SkData> fontData(ref_font_data(typeface(), &ttcIndex));
             SkAutoTUnref<SkPDFStream> fontStream(
                 new SkPDFStream(fontData.get()));
 
@@ -187,6 +187,12 @@ protected:
 
     static bool Find(uint32_t fontID, uint16_t glyphID, int* index);
 
+    // Returns the typeface's metrics for the whole font, or NULL.  They are
+    // kept in the global SkResourceCache, so each typeface computes them
+    // once per process rather than once per document.
+    static const SkAdvancedTypefaceMetrics* RefFontMetrics(
+            SkTypeface* typeface, SkTypeface::PerGlyphInfo perGlyphInfo);
+
 private:
     SkAutoTUnref<SkTypeface> fTypeface;
 
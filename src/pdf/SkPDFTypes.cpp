@@ -462,11 +462,26 @@ bool SkPDFObjNumMap::addObject(SkPDFObject* obj) {
     if (fObjectNumbers.find(obj)) {
         return false;
     }
-    fObjectNumbers.set(obj, fObjectNumbers.count() + 1);
     fObjects.push(obj);
+    fObjectNumbers.set(obj, fObjects.count());
     return true;
 }
 
+void SkPDFObjNumMap::removeObject(SkPDFObject* obj) {
+    const int32_t objectNumber = this->getObjectNumber(obj);
+    fObjectNumbers.remove(obj);
+    fObjects[objectNumber - 1] = NULL;
+}
+
+void SkPDFObjNumMap::replaceObject(SkPDFObject* original,
+                                   SkPDFObject* substitute) {
+    SkASSERT(!fObjectNumbers.find(substitute));
+    const int32_t objectNumber = this->getObjectNumber(original);
+    fObjectNumbers.remove(original);
+    fObjectNumbers.set(substitute, objectNumber);
+    fObjects[objectNumber - 1] = substitute;
+}
+
 int32_t SkPDFObjNumMap::getObjectNumber(SkPDFObject* obj) const {
     int32_t* objectNumberFound = fObjectNumbers.find(obj);
     SkASSERT(objectNumberFound);
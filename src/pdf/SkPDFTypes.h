@@ -323,6 +323,21 @@ public:
      */
     int32_t getObjectNumber(SkPDFObject* obj) const;
 
+    /** Stop tracking an object that has already been written, so that it
+     *  may be deleted and its address reused.  Its object number stays
+     *  taken, and objects() holds NULL in its place.
+     *  @param obj         The object to forget.
+     */
+    void removeObject(SkPDFObject* obj);
+
+    /** Give substitute the object number of original, which is no longer
+     *  tracked.  Used when the final form of an object is not known until
+     *  after other objects have been written referring to it.
+     *  @param original    An object in the catalog.
+     *  @param substitute  An object not yet in the catalog.
+     */
+    void replaceObject(SkPDFObject* original, SkPDFObject* substitute);
+
     const SkTDArray<SkPDFObject*>& objects() const { return fObjects; }
 
 private:
@@ -7,6 +7,7 @@
 
 
 #include "SkData.h"
+#include "SkFloatToDecimal.h"
 #include "SkGeometry.h"
 #include "SkPaint.h"
 #include "SkPath.h"
@@ -283,19 +284,44 @@ void SkPDFUtils::AppendScalar(SkScalar value, SkWStream* stream) {
         stream->writeDecAsText(0);
         return;
     }
-    // SkStrAppendFloat might still use scientific notation, so use snprintf
-    // directly..
-    static const int kFloat_MaxSize = 19;
+    // SkStrAppendFloat might still use scientific notation, so lay out the
+    // shortest round-trip digits ourselves. With the limits above, that is at
+    // most "-0.0000" followed by the digits.
+    static const int kFloat_MaxSize = 7 + SkFloatToDecimal_MaxDigits;
     char buffer[kFloat_MaxSize];
-    int len = SNPRINTF(buffer, kFloat_MaxSize, "%#.8f", value);
-    // %f always prints trailing 0s, so strip them.
-    for (; buffer[len - 1] == '0' && len > 0; len--) {
-        buffer[len - 1] = '\0';
+    char* end = buffer;
+    if (value < 0) {
+        *end++ = '-';
+        value = -value;
     }
-    if (buffer[len - 1] == '.') {
-        buffer[len - 1] = '\0';
+    int exponent;
+    char digits[SkStrAppendU32_MaxSize];
+    int count = SkToInt(SkStrAppendU32(digits, SkFloatToDecimal(value, &exponent)) - digits);
+    // The number of digits before the decimal point.
+    int wholeCount = count + exponent;
+    if (wholeCount <= 0) {
+        *end++ = '0';
+        *end++ = '.';
+        for (int i = wholeCount; i < 0; ++i) {
+            *end++ = '0';
+        }
+        memcpy(end, digits, count);
+        end += count;
+    } else if (exponent >= 0) {
+        memcpy(end, digits, count);
+        end += count;
+        for (int i = 0; i < exponent; ++i) {
+            *end++ = '0';
+        }
+    } else {
+        memcpy(end, digits, wholeCount);
+        end += wholeCount;
+        *end++ = '.';
+        memcpy(end, digits + wholeCount, count - wholeCount);
+        end += count - wholeCount;
     }
-    stream->writeText(buffer);
+    SkASSERT(end - buffer <= kFloat_MaxSize);
+    stream->write(buffer, end - buffer);
     return;
 #endif  // SK_ALLOW_LARGE_PDF_SCALARS
 }
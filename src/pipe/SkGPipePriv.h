@@ -164,6 +164,10 @@ enum {
 enum {
     kClip_HasAntiAlias_DrawOpFlag = 1 << 0,
 };
+enum {
+    // The bitmap's pixels are in an SkGPipeSharedMemory segment, rather than in the stream.
+    kDef_Bitmap_Shared_DrawOpFlag = 1 << 0,
+};
 ///////////////////////////////////////////////////////////////////////////////
 
 class BitmapInfo : SkNoncopyable {
@@ -7,12 +7,17 @@
  */
 
 
+#include "SkBigPicture.h"
 #include "SkBitmapHeap.h"
 #include "SkCanvas.h"
+#include "SkClipStack.h"
 #include "SkPaint.h"
 #include "SkGPipe.h"
 #include "SkGPipePriv.h"
+#include "SkMallocPixelRef.h"
+#include "SkPictureRecorder.h"
 #include "SkReader32.h"
+#include "SkRTree.h"
 #include "SkStream.h"
 
 #include "SkAnnotation.h"
@@ -79,6 +84,70 @@ static void set_paintflat(SkPaint* paint, SkFlattenable* obj, unsigned paintFlat
     }
 }
 
+namespace {
+
+// Keeps a segment of shared memory mapped while a bitmap's pixel ref uses it.
+struct SharedPixels {
+    SkGPipeSharedMemory* fSharedMemory;
+    uint32_t             fHandle;
+    void*                fAddr;
+};
+
+}  // namespace
+
+static void unmap_shared_pixels(void*, void* context) {
+    SharedPixels* shared = static_cast<SharedPixels*>(context);
+    shared->fSharedMemory->unmap(shared->fHandle, shared->fAddr);
+    shared->fSharedMemory->unref();
+    SkDELETE(shared);
+}
+
+// Reads a bitmap written by handle, and points it at its pixels in the mapped segment. Leaves
+// the bitmap empty if the segment can't be mapped, or doesn't hold the pixels.
+static void read_shared_bitmap(SkReadBuffer* reader, SkGPipeSharedMemory* sharedMemory,
+                               SkBitmap* bm) {
+    const uint32_t handle = reader->readUInt();
+    const uint32_t offset = reader->readUInt();
+    const uint32_t width = reader->readUInt();
+    const uint32_t height = reader->readUInt();
+    const uint32_t colorType = reader->readUInt();
+    const uint32_t alphaType = reader->readUInt();
+    const uint32_t rowBytes = reader->readUInt();
+    bm->reset();
+    if (NULL == sharedMemory || 0 == width || width > SK_MaxS32 || 0 == height ||
+        height > SK_MaxS32 || !SkColorTypeIsValid(colorType) ||
+        !SkAlphaTypeIsValid(alphaType) || kIndex_8_SkColorType == colorType) {
+        return;
+    }
+    const SkImageInfo info = SkImageInfo::Make(width, height, (SkColorType)colorType,
+                                               (SkAlphaType)alphaType);
+    if (rowBytes < info.minRowBytes64()) {
+        return;
+    }
+    size_t size;
+    void* addr = sharedMemory->map(handle, &size);
+    if (NULL == addr) {
+        return;
+    }
+    SharedPixels* shared = SkNEW(SharedPixels);
+    shared->fSharedMemory = SkRef(sharedMemory);
+    shared->fHandle = handle;
+    shared->fAddr = addr;
+    if (offset > size || info.getSafeSize64(rowBytes) > (int64_t)(size - offset)) {
+        unmap_shared_pixels(NULL, shared);
+        return;
+    }
+    SkAutoTUnref<SkPixelRef> pr(SkMallocPixelRef::NewWithProc(info, rowBytes, NULL,
+                                                              (char*)addr + offset,
+                                                              unmap_shared_pixels, shared));
+    if (NULL == pr.get()) {
+        unmap_shared_pixels(NULL, shared);
+        return;
+    }
+    bm->setInfo(info, rowBytes);
+    bm->setPixelRef(pr);
+}
+
 template <typename T> class SkRefCntTDArray : public SkTDArray<T> {
 public:
     ~SkRefCntTDArray() { this->unrefAll(); }
@@ -145,8 +214,10 @@ public:
     /**
      * Add a bitmap to the array of bitmaps, or replace an existing one.
      * This is only used when in cross process mode without a shared heap.
+     * If shared, the bitmap's pixels are in the shared memory, rather than
+     * in the stream.
      */
-    void addBitmap(int index) {
+    void addBitmap(int index, bool shared) {
         SkASSERT(shouldFlattenBitmaps(fFlags));
         SkBitmap* bm;
         if(fBitmaps.count() == index) {
@@ -155,7 +226,15 @@ public:
         } else {
             bm = fBitmaps[index];
         }
-        fReader->readBitmap(bm);
+        if (shared) {
+            read_shared_bitmap(fReader, fSharedMemory, bm);
+        } else {
+            fReader->readBitmap(bm);
+        }
+    }
+
+    void setSharedMemory(SkGPipeSharedMemory* sharedMemory) {
+        fSharedMemory = sharedMemory;
     }
 
     /**
@@ -237,6 +316,8 @@ private:
     // Only used when sharing bitmaps with the writer.
     SkBitmapHeap*             fSharedHeap;
     SkAutoTUnref<SkImageHeap> fImageHeap;
+    // Owned by the SkGPipeReader.
+    SkGPipeSharedMemory*      fSharedMemory;
     unsigned                  fFlags;
 };
 
@@ -832,7 +913,7 @@ static void def_PaintFlat_rp(SkCanvas*, SkReader32*, uint32_t op32,
 static void def_Bitmap_rp(SkCanvas*, SkReader32*, uint32_t op32,
                           SkGPipeState* state) {
     unsigned index = DrawOp_unpackData(op32);
-    state->addBitmap(index);
+    state->addBitmap(index, SkToBool(DrawOp_unpackFlags(op32) & kDef_Bitmap_Shared_DrawOpFlag));
 }
 
 static void def_Factory_rp(SkCanvas*, SkReader32* reader, uint32_t,
@@ -926,6 +1007,7 @@ SkGPipeState::SkGPipeState()
     : fReader(0)
     , fSilent(false)
     , fSharedHeap(NULL)
+    , fSharedMemory(NULL)
     , fFlags(0) {
 
 }
@@ -945,27 +1027,116 @@ SkGPipeReader::SkGPipeReader() {
     fCanvas = NULL;
     fState = NULL;
     fProc = NULL;
+    fSharedMemory = NULL;
+    fTileWidth = fTileHeight = 0;
+    fTileRecorder = NULL;
 }
 
 SkGPipeReader::SkGPipeReader(SkCanvas* target) {
     fCanvas = NULL;
+    fTileWidth = fTileHeight = 0;
+    fTileRecorder = NULL;
     this->setCanvas(target);
     fState = NULL;
     fProc = NULL;
+    fSharedMemory = NULL;
 }
 
 void SkGPipeReader::setCanvas(SkCanvas *target) {
     SkRefCnt_SafeAssign(fCanvas, target);
+    if (target && fTileRecorder) {
+        // Leave tiled mode; ops not yet drawn to the tiled target are dropped.
+        SkDELETE(fTileRecorder);
+        fTileRecorder = NULL;
+        fTiledTarget.reset();
+    }
+}
+
+void SkGPipeReader::setTiledTarget(const SkBitmap& dst, int tileWidth, int tileHeight) {
+    this->setCanvas(NULL);
+    fTiledTarget = dst;
+    fTileWidth = tileWidth;
+    fTileHeight = tileHeight;
+    if (NULL == fTileRecorder) {
+        fTileRecorder = SkNEW(SkPictureRecorder);
+    }
+    this->beginTileRecording();
+}
+
+void SkGPipeReader::beginTileRecording() {
+    SkRTreeFactory factory;
+    fTileRecorder->beginRecording(SkRect::MakeWH(SkIntToScalar(fTiledTarget.width()),
+                                                 SkIntToScalar(fTiledTarget.height())),
+                                  &factory);
+}
+
+namespace {
+
+// Reapplies the clips of one canvas, in device space, to another.
+class ClipCopier : public SkCanvas::ClipVisitor {
+public:
+    ClipCopier(SkCanvas* canvas) : fCanvas(canvas) {}
+
+    void clipRect(const SkRect& rect, SkRegion::Op op, bool aa) override {
+        fCanvas->clipRect(rect, op, aa);
+    }
+    void clipRRect(const SkRRect& rrect, SkRegion::Op op, bool aa) override {
+        fCanvas->clipRRect(rrect, op, aa);
+    }
+    void clipPath(const SkPath& path, SkRegion::Op op, bool aa) override {
+        fCanvas->clipPath(path, op, aa);
+    }
+
+private:
+    SkCanvas* fCanvas;
+};
+
+}  // namespace
+
+void SkGPipeReader::drawTiles() {
+    if (NULL == fTileRecorder) {
+        return;
+    }
+
+    SkCanvas* recording = fTileRecorder->getRecordingCanvas();
+    const SkMatrix matrix = recording->getTotalMatrix();
+    const SkClipStack clips(*recording->getClipStack());
+
+    SkAutoTUnref<SkPicture> picture(fTileRecorder->endRecording());
+    if (picture->approximateOpCount() > 0) {
+        // Only the tiles under the recorded ops need drawing.
+        SkIRect dirty = SkIRect::MakeWH(fTiledTarget.width(), fTiledTarget.height());
+        const SkBigPicture* bp = picture->asSkBigPicture();
+        if (bp && bp->bbh()) {
+            bp->bbh()->getRootBound().roundOut(&dirty);
+        }
+        SkTiledPictureDraw::Draw(picture, fTiledTarget, NULL, fTileWidth, fTileHeight, &dirty);
+    }
+
+    this->beginTileRecording();
+    recording = fTileRecorder->getRecordingCanvas();
+    ClipCopier copier(recording);
+    SkClipStack::B2TIter iter(clips);
+    while (const SkClipStack::Element* element = iter.next()) {
+        element->replay(&copier);
+    }
+    recording->setMatrix(matrix);
+}
+
+void SkGPipeReader::setSharedMemory(SkGPipeSharedMemory* sharedMemory) {
+    SkRefCnt_SafeAssign(fSharedMemory, sharedMemory);
 }
 
 SkGPipeReader::~SkGPipeReader() {
     SkSafeUnref(fCanvas);
     delete fState;
+    SkSafeUnref(fSharedMemory);
+    SkDELETE(fTileRecorder);
 }
 
 SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
                                               uint32_t playbackFlags, size_t* bytesRead) {
-    if (NULL == fCanvas) {
+    if (NULL == fCanvas && NULL == fTileRecorder) {
         return kError_Status;
     }
 
@@ -974,13 +1145,14 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
     }
 
     fState->setSilent(playbackFlags & kSilent_PlaybackFlag);
+    fState->setSharedMemory(fSharedMemory);
 
     SkASSERT(SK_ARRAY_COUNT(gReadTable) == (kDone_DrawOp + 1));
 
     const ReadProc* table = gReadTable;
     SkReadBuffer reader(data, length);
     reader.setBitmapDecoder(fProc);
-    SkCanvas* canvas = fCanvas;
+    SkCanvas* canvas = fTileRecorder ? fTileRecorder->getRecordingCanvas() : fCanvas;
     Status status = kEOF_Status;
 
     fState->setReader(&reader);
@@ -1010,6 +1182,10 @@ SkGPipeReader::Status SkGPipeReader::playback(const void* data, size_t length,
             }
     }
 
+    if (kDone_Status == status) {
+        this->drawTiles();
+    }
+
     if (bytesRead) {
         *bytesRead = reader.offset();
     }
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGPipeRingController.h"
+
+#include "SkAtomics.h"
+#include "SkMath.h"
+#include "SkSemaphore.h"
+
+// Each side that waits sets its flag, then checks once more whether it needs to wait. The other
+// side changes what is waited for, then clears the flag and signals if it was set. Both are
+// sequentially consistent, so either the waiter sees the change, or its flag is seen and it is
+// signaled. A waiter that sees the change but finds its flag already cleared has a signal coming,
+// which it must take.
+
+static size_t ring_capacity(size_t capacity) {
+    return SkNextPow2(SkToInt(SkTMax<size_t>(capacity, 8)));
+}
+
+SkGPipeRingController::SkGPipeRingController(size_t capacity, int numberOfReaders,
+                                             size_t batchBytes)
+    : fStorage(ring_capacity(capacity))
+    , fCapacity(ring_capacity(capacity))
+    , fBatchBytes(batchBytes)
+    , fNumberOfReaders(numberOfReaders)
+    , fWritten(0)
+    , fPublished(0)
+    , fTail(0)
+    , fHead(0)
+    , fWrapAt(0)
+    , fWriterDone(false)
+    , fReaderDone(false)
+    , fWriterWaiting(false)
+    , fReaderWaiting(false)
+    , fSpaceAvailable(SkNEW(SkSemaphore))
+    , fDataAvailable(SkNEW(SkSemaphore)) {
+    SkASSERT(numberOfReaders > 0);
+}
+
+SkGPipeRingController::~SkGPipeRingController() {}
+
+void* SkGPipeRingController::requestBlock(size_t minRequest, size_t* actual) {
+    if (minRequest > fCapacity / 2) {
+        return NULL;
+    }
+    const size_t mask = fCapacity - 1;
+    // A block doesn't wrap around the end of the ring. If it doesn't fit before the end, the rest
+    // of the lap is skipped. Since the block is at most half the ring, the skipped bytes and the
+    // block fit in it once the reader has caught up.
+    size_t start = fWritten;
+    if (fCapacity - (start & mask) < minRequest) {
+        start = (start | mask) + 1;
+    }
+    if (!this->waitForSpace(start + minRequest)) {
+        return NULL;
+    }
+    if (start != fWritten) {
+        // The reader is past the previous skip, since it freed the start of this lap. fTail is
+        // only moved past this one after its store, which publishes it.
+        sk_atomic_store(&fWrapAt, fWritten, sk_memory_order_relaxed);
+        fWritten = start;
+    }
+    const size_t head = sk_atomic_load(&fHead, sk_memory_order_acquire);
+    *actual = SkTMin(fCapacity - (start & mask), head + fCapacity - start);
+    return fStorage.get() + (start & mask);
+}
+
+void SkGPipeRingController::notifyWritten(size_t bytes) {
+    if (0 == bytes) {
+        this->publish();
+        sk_atomic_store(&fWriterDone, true);
+        if (sk_atomic_exchange(&fReaderWaiting, false)) {
+            fDataAvailable->signal();
+        }
+        return;
+    }
+    fWritten += bytes;
+    if (fWritten - fPublished >= fBatchBytes) {
+        this->publish();
+    }
+}
+
+void SkGPipeRingController::flush() {
+    this->publish();
+}
+
+void SkGPipeRingController::publish() {
+    if (fPublished == fWritten) {
+        return;
+    }
+    sk_atomic_store(&fTail, fWritten);
+    fPublished = fWritten;
+    if (sk_atomic_exchange(&fReaderWaiting, false)) {
+        fDataAvailable->signal();
+    }
+}
+
+bool SkGPipeRingController::waitForSpace(size_t end) {
+    while (end - sk_atomic_load(&fHead, sk_memory_order_acquire) > fCapacity) {
+        if (sk_atomic_load(&fReaderDone)) {
+            return false;
+        }
+        // The reader can only free what it has been given.
+        this->publish();
+        sk_atomic_store(&fWriterWaiting, true);
+        if (end - sk_atomic_load(&fHead) > fCapacity && !sk_atomic_load(&fReaderDone)) {
+            fSpaceAvailable->wait();
+        } else if (!sk_atomic_exchange(&fWriterWaiting, false)) {
+            fSpaceAvailable->wait();
+        }
+    }
+    return !sk_atomic_load(&fReaderDone);
+}
+
+size_t SkGPipeRingController::waitForData(size_t head) {
+    for (;;) {
+        // fWriterDone is set after the last store to fTail, so fTail is loaded after it.
+        const bool done = sk_atomic_load(&fWriterDone, sk_memory_order_acquire);
+        const size_t tail = sk_atomic_load(&fTail, sk_memory_order_acquire);
+        if (tail != head || done) {
+            return tail;
+        }
+        sk_atomic_store(&fReaderWaiting, true);
+        if (sk_atomic_load(&fTail) == head && !sk_atomic_load(&fWriterDone)) {
+            fDataAvailable->wait();
+        } else if (!sk_atomic_exchange(&fReaderWaiting, false)) {
+            fDataAvailable->wait();
+        }
+    }
+}
+
+SkGPipeReader::Status SkGPipeRingController::playback(SkGPipeReader* const readers[],
+                                                      uint32_t playbackFlags) {
+    const size_t mask = fCapacity - 1;
+    size_t head = sk_atomic_load(&fHead, sk_memory_order_relaxed);
+    SkGPipeReader::Status status = SkGPipeReader::kEOF_Status;
+    for (;;) {
+        const size_t tail = this->waitForData(head);
+        if (tail == head) {
+            return status;
+        }
+        // A skip never starts a lap, so 0 stands for none yet.
+        const size_t wrapAt = sk_atomic_load(&fWrapAt, sk_memory_order_relaxed);
+        while (head != tail) {
+            const size_t lapEnd = (head | mask) + 1;
+            size_t end = tail - head > lapEnd - head ? lapEnd : tail;
+            if ((wrapAt & mask) && wrapAt - head < end - head) {
+                end = wrapAt;
+            }
+            if (end == head) {
+                head = lapEnd;
+                continue;
+            }
+            for (int i = 0; i < fNumberOfReaders; ++i) {
+                status = readers[i]->playback(fStorage.get() + (head & mask), end - head,
+                                              playbackFlags);
+                if (SkGPipeReader::kError_Status == status) {
+                    sk_atomic_store(&fReaderDone, true);
+                    if (sk_atomic_exchange(&fWriterWaiting, false)) {
+                        fSpaceAvailable->signal();
+                    }
+                    return status;
+                }
+            }
+            head = end;
+        }
+        sk_atomic_store(&fHead, head);
+        if (sk_atomic_exchange(&fWriterWaiting, false)) {
+            fSpaceAvailable->signal();
+        }
+    }
+}
@@ -212,6 +212,8 @@ public:
             this->writeOp(kDone_DrawOp);
             this->doNotify();
         }
+        // Tell the controller that nothing else will be written.
+        fController->notifyWritten(0);
         if (shouldFlattenBitmaps(fFlags)) {
             // The following circular references exist:
             // fFlattenableHeap -> fWriteBuffer -> fBitmapStorage -> fExternalStorage -> fCanvas
@@ -386,6 +388,28 @@ void SkGPipeCanvas::flattenFactoryNames() {
 
 bool SkGPipeCanvas::shuttleBitmap(const SkBitmap& bm, int32_t slot) {
     SkASSERT(shouldFlattenBitmaps(fFlags));
+    SkGPipeSharedMemory* sharedMemory = fController->sharedMemory();
+    // Bitmaps with a color table are always copied, since the table isn't in the pixels.
+    SkAutoLockPixels alp(bm, sharedMemory && kIndex_8_SkColorType != bm.colorType());
+    uint32_t handle;
+    size_t offset;
+    if (sharedMemory && bm.getPixels() && kIndex_8_SkColorType != bm.colorType() &&
+        sharedMemory->findSegment(bm.getPixels(), bm.getSafeSize(), &handle, &offset) &&
+        offset <= SK_MaxU32) {
+        if (this->needOpBytes(7 * sizeof(uint32_t))) {
+            this->writeOp(kDef_Bitmap_DrawOp, kDef_Bitmap_Shared_DrawOpFlag, slot);
+            fWriter.write32(handle);
+            fWriter.write32(SkToU32(offset));
+            fWriter.write32(bm.width());
+            fWriter.write32(bm.height());
+            fWriter.write32(bm.colorType());
+            fWriter.write32(bm.alphaType());
+            fWriter.write32(SkToU32(bm.rowBytes()));
+            return true;
+        }
+        return false;
+    }
+
     SkWriteBuffer buffer;
     buffer.setNamedFactoryRecorder(fFactorySet);
     buffer.writeBitmap(bm);
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkDiscardableMemory.h"
+#include "SkDiscardableMemoryPool.h"
+#include "SkOnce.h"
+#include "SkTemplates.h"
+#include "SkTypes.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#ifndef MADV_FREE
+    #define MADV_FREE 8
+#endif
+
+// Discardable memory the kernel may reclaim while it is unlocked.
+//
+// unlock() hands the pages to the kernel with madvise(MADV_FREE): under memory pressure it may
+// drop them, after which they read back as zeros; otherwise they keep their contents, and any
+// write takes a page back. So before unlocking we stash the first word of each page and put a
+// nonzero marker there instead. lock() atomically swaps each marker back: the write pins the
+// page again, and reading back anything but the marker means the page was dropped.
+
+static const uint32_t kMarker = 0x5AD15CA2;
+
+// Smaller requests come from the pool: a mapping costs a system call and at least a page.
+static const size_t kMinMadviseBytes = 64 * 1024;
+
+static size_t gPageSize;
+static bool gMadviseFreeSupported;
+
+static void probe_madvise_free() {
+    gPageSize = sysconf(_SC_PAGESIZE);
+    void* addr = mmap(NULL, gPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED != addr) {
+        // Kernels before 4.5 reject MADV_FREE with EINVAL.
+        gMadviseFreeSupported = 0 == madvise(addr, gPageSize, MADV_FREE);
+        munmap(addr, gPageSize);
+    }
+}
+
+namespace {
+
+class SkMadviseDiscardableMemory : public SkDiscardableMemory {
+public:
+    static SkMadviseDiscardableMemory* Create(size_t bytes) {
+        const size_t size = (bytes + gPageSize - 1) / gPageSize * gPageSize;
+        void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == addr) {
+            return NULL;
+        }
+        return SkNEW_ARGS(SkMadviseDiscardableMemory, (addr, size));
+    }
+
+    ~SkMadviseDiscardableMemory() override {
+        SkASSERT(!fLocked);
+        munmap(fAddr, fSize);
+    }
+
+    bool lock() override {
+        SkASSERT(!fLocked);
+        bool discarded = false;
+        for (int i = 0; i < fPageCount; ++i) {
+            if (kMarker != sk_atomic_exchange(this->pageWord(i), kMarker)) {
+                discarded = true;
+            }
+        }
+        if (discarded) {
+            return false;
+        }
+        for (int i = 0; i < fPageCount; ++i) {
+            *this->pageWord(i) = fSavedWords[i];
+        }
+        fLocked = true;
+        return true;
+    }
+
+    void* data() override {
+        SkASSERT(fLocked);
+        return fAddr;
+    }
+
+    void unlock() override {
+        SkASSERT(fLocked);
+        for (int i = 0; i < fPageCount; ++i) {
+            uint32_t* word = this->pageWord(i);
+            fSavedWords[i] = *word;
+            *word = kMarker;
+        }
+        // The markers must be written first: a write after this would take the page back.
+        madvise(fAddr, fSize, MADV_FREE);
+        fLocked = false;
+    }
+
+private:
+    SkMadviseDiscardableMemory(void* addr, size_t size)
+        : fAddr(addr)
+        , fSize(size)
+        , fPageCount(SkToInt(size / gPageSize))
+        , fSavedWords(fPageCount)
+        , fLocked(true) {}
+
+    uint32_t* pageWord(int page) {
+        return reinterpret_cast<uint32_t*>(static_cast<char*>(fAddr) + page * gPageSize);
+    }
+
+    void*                   fAddr;
+    size_t                  fSize;
+    int                     fPageCount;
+    SkAutoTMalloc<uint32_t> fSavedWords;
+    bool                    fLocked;
+};
+
+}  // namespace
+
+SK_DECLARE_STATIC_ONCE(probe_once);
+
+SkDiscardableMemory* SkDiscardableMemory::Create(size_t bytes) {
+    SkOnce(&probe_once, probe_madvise_free);
+    if (gMadviseFreeSupported && bytes >= kMinMadviseBytes) {
+        if (SkDiscardableMemory* dm = SkMadviseDiscardableMemory::Create(bytes)) {
+            return dm;
+        }
+    }
+    return SkGetGlobalDiscardableMemoryPool()->create(bytes);
+}
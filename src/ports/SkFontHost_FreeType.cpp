@@ -1576,6 +1576,17 @@ size_t SkTypeface_FreeType::onGetTableData(SkFontTableTag tag, size_t offset,
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+SkStreamAsset* SkTypeface_FreeType::FontFile::openStream() const {
+    SkAutoMutexAcquire lock(fMutex);
+    if (NULL == fData.get()) {
+        fData.reset(SkData::NewFromFileName(fPath.c_str()));
+    }
+    if (fData.get()) {
+        return SkNEW_ARGS(SkMemoryStream, (fData.get()));
+    }
+    return SkStream::NewFromFile(fPath.c_str());
+}
+
 SkTypeface_FreeType::Scanner::Scanner() : fLibrary(NULL) {
     if (FT_New_Library(&gFTMemory, &fLibrary)) {
         return;
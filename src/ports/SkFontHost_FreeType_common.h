@@ -9,9 +9,11 @@
 #ifndef SKFONTHOST_FREETYPE_COMMON_H_
 #define SKFONTHOST_FREETYPE_COMMON_H_
 
+#include "SkData.h"
 #include "SkGlyph.h"
 #include "SkMutex.h"
 #include "SkScalerContext.h"
+#include "SkString.h"
 #include "SkTypeface.h"
 #include "SkTypes.h"
 
@@ -61,6 +63,30 @@ public:
         mutable SkMutex fLibraryMutex;
     };
 
+    /** For SkFontMgrs to share one mapping of a font file among the typefaces of all the faces
+     *  in it, instead of mapping the file again every time one of them opens a stream. The file
+     *  is mapped lazily, by the first openStream(), and unmapped along with the last reference.
+     */
+    class FontFile : public SkRefCnt {
+    public:
+        explicit FontFile(const char path[]) : fPath(path) {}
+
+        const SkString& path() const { return fPath; }
+
+        /** Returns a new stream over the whole file, or NULL if it cannot be opened. The stream
+         *  reads the shared mapping (so FreeType can use the memory directly) unless the file
+         *  could not be mapped.
+         */
+        SkStreamAsset* openStream() const;
+
+    private:
+        const SkString fPath;
+        mutable SkMutex fMutex;
+        mutable SkAutoTUnref<SkData> fData;
+
+        typedef SkRefCnt INHERITED;
+    };
+
 protected:
     SkTypeface_FreeType(const SkFontStyle& style, SkFontID uniqueID, bool isFixedPitch)
         : INHERITED(style, uniqueID, isFixedPitch)
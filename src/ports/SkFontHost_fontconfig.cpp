@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "SkChecksum.h"
 #include "SkFontConfigInterface.h"
 #include "SkFontConfigTypeface.h"
 #include "SkFontDescriptor.h"
@@ -84,6 +85,11 @@ static bool find_by_FontIdentity(SkTypeface* cachedTypeface, const SkFontStyle&,
     return cachedFCTypeface->getIdentity() == *indentity;
 }
 
+static uint32_t hash_FontIdentity(const SkFontConfigInterface::FontIdentity& identity) {
+    uint32_t seed = SkChecksum::Mix(identity.fID) ^ identity.fTTCIndex;
+    return SkTypefaceCache::HashKey(identity.fString.c_str(), identity.fString.size(), seed);
+}
+
 SkTypeface* FontConfigTypeface::LegacyCreateTypeface(const char familyName[],
                                                      SkTypeface::Style style)
 {
@@ -95,7 +101,8 @@ SkTypeface* FontConfigTypeface::LegacyCreateTypeface(const char familyName[],
     // Check if requested NameStyle is in the NameStyle cache.
     SkFontStyle requestedStyle(style);
     NameStyle nameStyle(familyName, requestedStyle);
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_NameStyle, &nameStyle);
+    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(
+            find_by_NameStyle, &nameStyle, SkTypefaceCache::HashNameStyle(familyName, requestedStyle));
     if (face) {
         //SkDebugf("found cached face <%s> <%s> %p [%d]\n",
         //         familyName, ((FontConfigTypeface*)face)->getFamilyName(),
@@ -111,11 +118,17 @@ SkTypeface* FontConfigTypeface::LegacyCreateTypeface(const char familyName[],
     }
 
     // Check if a typeface with this FontIdentity is already in the FontIdentity cache.
-    face = SkTypefaceCache::FindByProcAndRef(find_by_FontIdentity, &indentity);
+    uint32_t identityHash = hash_FontIdentity(indentity);
+    face = SkTypefaceCache::FindByProcAndRef(find_by_FontIdentity, &indentity, identityHash);
     if (!face) {
         face = FontConfigTypeface::Create(SkFontStyle(outStyle), indentity, outFamilyName);
-        // Add this FontIdentity to the FontIdentity cache.
-        SkTypefaceCache::Add(face, requestedStyle);
+        // Add this FontIdentity to the FontIdentity cache, keyed so that both lookups above
+        // can find it without walking the whole cache.
+        const uint32_t keyHashes[] = {
+            identityHash,
+            SkTypefaceCache::HashNameStyle(outFamilyName.c_str(), requestedStyle),
+        };
+        SkTypefaceCache::Add(face, requestedStyle, keyHashes, SK_ARRAY_COUNT(keyHashes));
     }
     // TODO: Ensure requested NameStyle and resolved NameStyle are both in the NameStyle cache.
 
@@ -499,6 +499,21 @@ static bool find_by_CTFontRef(SkTypeface* cached, const SkFontStyle&, void* cont
     return CFEqual(self, other);
 }
 
+static uint32_t hash_CTFontRef(CTFontRef fontRef) {
+    // CFEqual objects are required to have equal CFHash values.
+    return (uint32_t)CFHash(fontRef);
+}
+
+/** Adds face to the cache, keyed for both find_by_CTFontRef and find_by_NameStyle. */
+static void add_to_cache(SkTypeface* face, const SkFontStyle& requestedStyle) {
+    const SkTypeface_Mac* macFace = static_cast<SkTypeface_Mac*>(face);
+    const uint32_t keyHashes[] = {
+        hash_CTFontRef(macFace->fFontRef),
+        SkTypefaceCache::HashNameStyle(macFace->fRequestedName.c_str(), requestedStyle),
+    };
+    SkTypefaceCache::Add(face, requestedStyle, keyHashes, SK_ARRAY_COUNT(keyHashes));
+}
+
 /** Creates a typeface from a name, searching the cache. */
 static SkTypeface* NewFromName(const char familyName[], const SkFontStyle& theStyle) {
     CTFontSymbolicTraits ctFontTraits = 0;
@@ -547,10 +562,11 @@ static SkTypeface* NewFromName(const char familyName[], const SkFontStyle& theSt
         return NULL;
     }
 
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef, (void*)ctFont.get());
+    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef, (void*)ctFont.get(),
+                                                         hash_CTFontRef(ctFont));
     if (!face) {
         face = NewFromFontRef(ctFont.detach(), NULL, NULL, false);
-        SkTypefaceCache::Add(face, face->fontStyle());
+        add_to_cache(face, face->fontStyle());
     }
     return face;
 }
@@ -563,7 +579,7 @@ static SkTypeface* GetDefaultFace() {
 
     if (NULL == gDefaultFace) {
         gDefaultFace = NewFromName(FONT_DEFAULT_NAME, SkFontStyle());
-        SkTypefaceCache::Add(gDefaultFace, SkFontStyle());
+        add_to_cache(gDefaultFace, SkFontStyle());
     }
     return gDefaultFace;
 }
@@ -580,14 +596,15 @@ CTFontRef SkTypeface_GetCTFontRef(const SkTypeface* face) {
  *  not found, returns a new entry (after adding it to the cache).
  */
 SkTypeface* SkCreateTypefaceFromCTFont(CTFontRef fontRef, CFTypeRef resourceRef) {
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef, (void*)fontRef);
+    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_CTFontRef, (void*)fontRef,
+                                                         hash_CTFontRef(fontRef));
     if (!face) {
         CFRetain(fontRef);
         if (resourceRef) {
             CFRetain(resourceRef);
         }
         face = NewFromFontRef(fontRef, resourceRef, NULL, false);
-        SkTypefaceCache::Add(face, face->fontStyle());
+        add_to_cache(face, face->fontStyle());
     }
     return face;
 }
@@ -2185,7 +2202,9 @@ static SkTypeface* createFromDesc(CFStringRef cfFamilyName, CTFontDescriptorRef
     cacheRequest.fName = skFamilyName.c_str();
     cacheRequest.fStyle = fontstyle_from_descriptor(desc);
 
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_NameStyle, &cacheRequest);
+    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(
+            find_by_NameStyle, &cacheRequest,
+            SkTypefaceCache::HashNameStyle(cacheRequest.fName, cacheRequest.fStyle));
     if (face) {
         return face;
     }
@@ -2201,7 +2220,7 @@ static SkTypeface* createFromDesc(CFStringRef cfFamilyName, CTFontDescriptorRef
     face = SkNEW_ARGS(SkTypeface_Mac, (ctFont.detach(), NULL,
                                        cacheRequest.fStyle, isFixedPitch,
                                        skFamilyName.c_str(), false));
-    SkTypefaceCache::Add(face, face->fontStyle());
+    add_to_cache(face, face->fontStyle());
     return face;
 }
 
@@ -2471,12 +2490,13 @@ protected:
         }
 
         NameStyle cacheRequest = { familyName, style };
-        SkTypeface* face = SkTypefaceCache::FindByProcAndRef(find_by_NameStyle, &cacheRequest);
+        SkTypeface* face = SkTypefaceCache::FindByProcAndRef(
+                find_by_NameStyle, &cacheRequest, SkTypefaceCache::HashNameStyle(familyName, style));
 
         if (NULL == face) {
             face = NewFromName(familyName, style);
             if (face) {
-                SkTypefaceCache::Add(face, style);
+                add_to_cache(face, style);
             } else {
                 face = GetDefaultFace();
                 face->ref();
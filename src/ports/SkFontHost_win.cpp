@@ -319,10 +319,11 @@ static bool FindByLogFont(SkTypeface* face, const SkFontStyle& requestedStyle, v
 SkTypeface* SkCreateTypefaceFromLOGFONT(const LOGFONT& origLF) {
     LOGFONT lf = origLF;
     make_canonical(&lf);
-    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(FindByLogFont, &lf);
+    uint32_t keyHash = SkTypefaceCache::HashKey(&lf, sizeof(LOGFONT));
+    SkTypeface* face = SkTypefaceCache::FindByProcAndRef(FindByLogFont, &lf, keyHash);
     if (NULL == face) {
         face = LogFontTypeface::Create(lf);
-        SkTypefaceCache::Add(face, get_style(lf));
+        SkTypefaceCache::Add(face, get_style(lf), &keyHash, 1);
     }
     return face;
 }
@@ -93,20 +93,21 @@ private:
 /** The file SkTypeface implementation for the custom font manager. */
 class SkTypeface_File : public SkTypeface_Custom {
 public:
+    /** The faces of a collection share its FontFile, and so its mapping. */
     SkTypeface_File(const SkFontStyle& style, bool isFixedPitch, bool sysFont,
-                    const SkString familyName, const char path[], int index)
+                    const SkString familyName, FontFile* file, int index)
         : INHERITED(style, isFixedPitch, sysFont, familyName, index)
-        , fPath(path)
+        , fFile(SkRef(file))
     { }
 
 protected:
     SkStreamAsset* onOpenStream(int* ttcIndex) const override {
         *ttcIndex = this->getIndex();
-        return SkStream::NewFromFile(fPath.c_str());
+        return fFile->openStream();
     }
 
 private:
-    SkString fPath;
+    const SkAutoTUnref<FontFile> fFile;
 
     typedef SkTypeface_Custom INHERITED;
 };
@@ -390,6 +391,9 @@ private:
                 continue;
             }
 
+            // The scanning stream is not kept; the file is mapped again when a face is first used.
+            SkAutoTUnref<SkTypeface_FreeType::FontFile> file(
+                    SkNEW_ARGS(SkTypeface_FreeType::FontFile, (filename.c_str())));
             for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
                 bool isFixedPitch;
                 SkString realname;
@@ -405,7 +409,7 @@ private:
                                                     isFixedPitch,
                                                     true,  // system-font (cannot delete)
                                                     realname,
-                                                    filename.c_str(),
+                                                    file.get(),
                                                     faceIndex));
 
                 SkFontStyleSet_Custom* addTo = find_family(*families, realname.c_str());
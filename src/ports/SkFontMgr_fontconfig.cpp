@@ -18,6 +18,7 @@
 #include "SkStream.h"
 #include "SkString.h"
 #include "SkTDArray.h"
+#include "SkTHash.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
 #include "SkTypefaceCache.h"
@@ -414,11 +415,14 @@ private:
 
 class SkTypeface_fontconfig : public SkTypeface_FreeType {
 public:
-    /** @param pattern takes ownership of the reference. */
-    static SkTypeface_fontconfig* Create(FcPattern* pattern) {
-        return SkNEW_ARGS(SkTypeface_fontconfig, (pattern));
+    /** @param pattern takes ownership of the reference.
+     *  @param file the font file named by the pattern, possibly shared with other typefaces.
+     */
+    static SkTypeface_fontconfig* Create(FcPattern* pattern, FontFile* file) {
+        return SkNEW_ARGS(SkTypeface_fontconfig, (pattern, file));
     }
     mutable SkAutoFcPattern fPattern;
+    const SkAutoTUnref<FontFile> fFile;
 
     void onGetFamilyName(SkString* familyName) const override {
         *familyName = get_string(fPattern, FC_FAMILY);
@@ -435,7 +439,7 @@ public:
     SkStreamAsset* onOpenStream(int* ttcIndex) const override {
         FCLocker lock;
         *ttcIndex = get_int(fPattern, FC_INDEX, 0);
-        return SkStream::NewFromFile(get_string(fPattern, FC_FILE));
+        return fFile->openStream();
     }
 
     virtual ~SkTypeface_fontconfig() {
@@ -446,11 +450,12 @@ public:
 
 private:
     /** @param pattern takes ownership of the reference. */
-    SkTypeface_fontconfig(FcPattern* pattern)
+    SkTypeface_fontconfig(FcPattern* pattern, FontFile* file)
         : INHERITED(skfontstyle_from_fcpattern(pattern),
                     SkTypefaceCache::NewFontID(),
                     FC_PROPORTIONAL != get_int(pattern, FC_SPACING, FC_PROPORTIONAL))
         , fPattern(pattern)
+        , fFile(SkRef(file))
     { };
 
     typedef SkTypeface_FreeType INHERITED;
@@ -578,6 +583,12 @@ class SkFontMgr_fontconfig : public SkFontMgr {
         return FcTrue == FcPatternEqual(cshFace->fPattern, ctxPattern);
     }
 
+    static bool FindByFontFile(SkTypeface* cached, const SkFontStyle&, void* ctx) {
+        SkTypeface_fontconfig* cshFace = static_cast<SkTypeface_fontconfig*>(cached);
+        const char* path = static_cast<const char*>(ctx);
+        return cshFace->fFile->path().equals(path);
+    }
+
     mutable SkMutex fTFCacheMutex;
     mutable SkTypefaceCache fTFCache;
     /** Creates a typeface using a typeface cache.
@@ -588,8 +599,16 @@ class SkFontMgr_fontconfig : public SkFontMgr {
         SkAutoMutexAcquire ama(fTFCacheMutex);
         SkTypeface* face = fTFCache.findByProcAndRef(FindByFcPattern, pattern);
         if (NULL == face) {
+            // The faces of a collection share the mapping of its file.
+            const char* path = get_string(pattern, FC_FILE);
+            SkAutoTUnref<SkTypeface_fontconfig> sibling(static_cast<SkTypeface_fontconfig*>(
+                    fTFCache.findByProcAndRef(FindByFontFile, const_cast<char*>(path))));
+            SkAutoTUnref<SkTypeface_FreeType::FontFile> file(sibling.get()
+                    ? SkRef(sibling->fFile.get())
+                    : SkNEW_ARGS(SkTypeface_FreeType::FontFile, (path)));
+
             FcPatternReference(pattern);
-            face = SkTypeface_fontconfig::Create(pattern);
+            face = SkTypeface_fontconfig::Create(pattern, file);
             if (face) {
                 fTFCache.add(face, SkFontStyle());
             }
@@ -597,15 +616,79 @@ class SkFontMgr_fontconfig : public SkFontMgr {
         return face;
     }
 
+    /** The results of onMatchFamilyStyle and onMatchFamilyStyleCharacter, so that repeated
+     *  queries (like the fallback for every character of mixed-script text) skip FcFontMatch.
+     *  Keyed by match_key() and guarded by FCLocker. The values are refs, or NULL for no match.
+     *  Every typeface here is also in fTFCache, which can't purge it while we hold a ref, so
+     *  dropping our ref never deletes one (whose destructor would take FCLocker again).
+     */
+    mutable SkTHashMap<SkString, SkTypeface*> fMatchCache;
+    /** The font sets the match cache was filled from; if fontconfig's change, it's stale. */
+    mutable FcFontSet* fMatchCacheFontSets[2];
+    mutable int fMatchCacheFontCounts[2];
+
+    static const int kMaxMatchCacheCount = 512;
+    /** Character fallback is cached per block of this many code points. */
+    static const int kMatchCacheCharacterBlockBits = 7;
+
+    static SkString match_key(char kind, const char familyName[], const SkFontStyle& style) {
+        // The family goes last, since it is the only part that could contain the separators.
+        SkString key;
+        key.printf("%c%c%d,%d,%d|", kind, familyName ? '+' : '-',
+                   style.weight(), style.width(), style.slant());
+        return key;
+    }
+
+    void purgeMatchCache() const {
+        FCLocker::AssertHeld();
+        fMatchCache.foreach([](const SkString&, SkTypeface** face) { SkSafeUnref(*face); });
+        fMatchCache.reset();
+    }
+
+    /** Purges the match cache if fontconfig's fonts have changed since it was filled, as when
+     *  fonts are added to the config. */
+    void validateMatchCache() const {
+        FCLocker::AssertHeld();
+        static const FcSetName fcNameSet[] = { FcSetSystem, FcSetApplication };
+        for (int setIndex = 0; setIndex < (int)SK_ARRAY_COUNT(fcNameSet); ++setIndex) {
+            FcFontSet* fonts = FcConfigGetFonts(fFC, fcNameSet[setIndex]);
+            int count = fonts ? fonts->nfont : 0;
+            if (fonts != fMatchCacheFontSets[setIndex] || count != fMatchCacheFontCounts[setIndex]) {
+                this->purgeMatchCache();
+                fMatchCacheFontSets[setIndex] = fonts;
+                fMatchCacheFontCounts[setIndex] = count;
+            }
+        }
+    }
+
+    /** Takes ownership of the ref on face, if any, and returns a new one. */
+    SkTypeface* addToMatchCache(const SkString& key, SkTypeface* face) const {
+        FCLocker::AssertHeld();
+        if (fMatchCache.count() >= kMaxMatchCacheCount) {
+            this->purgeMatchCache();
+        }
+        SkTypeface** old = fMatchCache.find(key);
+        if (old) {
+            SkSafeUnref(*old);
+        }
+        fMatchCache.set(key, face);
+        return SkSafeRef(face);
+    }
+
 public:
     /** Takes control of the reference to 'config'. */
     explicit SkFontMgr_fontconfig(FcConfig* config)
         : fFC(config ? config : FcInitLoadConfigAndFonts())
-        , fFamilyNames(GetFamilyNames(fFC)) { }
+        , fFamilyNames(GetFamilyNames(fFC))
+    {
+        sk_bzero(fMatchCacheFontSets, sizeof(fMatchCacheFontSets));
+        sk_bzero(fMatchCacheFontCounts, sizeof(fMatchCacheFontCounts));
+    }
 
     virtual ~SkFontMgr_fontconfig() {
         // Hold the lock while unrefing the config.
         FCLocker lock;
+        this->purgeMatchCache();
         fFC.reset();
     }
 
@@ -733,6 +816,13 @@ protected:
     {
         FCLocker lock;
 
+        this->validateMatchCache();
+        SkString key = match_key('F', familyName, style);
+        key.append(familyName);
+        if (SkTypeface** cached = fMatchCache.find(key)) {
+            return SkSafeRef(*cached);
+        }
+
         SkAutoFcPattern pattern;
         FcPatternAddString(pattern, FC_FAMILY, (FcChar8*)familyName);
         fcpattern_from_skfontstyle(style, pattern);
@@ -760,10 +850,10 @@ protected:
         FcResult result;
         SkAutoFcPattern font(FcFontMatch(fFC, pattern, &result));
         if (NULL == font || !FontAccessible(font) || !FontFamilyNameMatches(font, matchPattern)) {
-            return NULL;
+            return this->addToMatchCache(key, NULL);
         }
 
-        return createTypefaceFromFcPattern(font);
+        return this->addToMatchCache(key, createTypefaceFromFcPattern(font));
     }
 
     virtual SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
@@ -774,6 +864,23 @@ protected:
     {
         FCLocker lock;
 
+        // A font found for one character of a block very likely has the rest of the block too,
+        // so neighbours share an entry, but it is only used once checked for the character.
+        this->validateMatchCache();
+        SkString key = match_key('C', familyName, style);
+        key.appendHex(character >> kMatchCacheCharacterBlockBits);
+        for (int i = 0; i < bcp47Count; ++i) {
+            key.appendf(",%s", bcp47[i]);
+        }
+        key.append("|");
+        key.append(familyName);
+        if (SkTypeface** cached = fMatchCache.find(key)) {
+            SkTypeface_fontconfig* face = static_cast<SkTypeface_fontconfig*>(*cached);
+            if (face && FontContainsCharacter(face->fPattern, character)) {
+                return SkRef(face);
+            }
+        }
+
         SkAutoFcPattern pattern;
         if (familyName) {
             FcValue familyNameValue;
@@ -802,10 +909,11 @@ protected:
         FcResult result;
         SkAutoFcPattern font(FcFontMatch(fFC, pattern, &result));
         if (NULL == font || !FontAccessible(font) || !FontContainsCharacter(font, character)) {
+            // Nothing to check another character against; leave the block's entry alone.
             return NULL;
         }
 
-        return createTypefaceFromFcPattern(font);
+        return this->addToMatchCache(key, createTypefaceFromFcPattern(font));
     }
 
     virtual SkTypeface* onMatchFaceStyle(const SkTypeface* typeface,
@@ -61,16 +61,29 @@
 class SkPrivateEffectInitializer {
 public:
     static void Init() {
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkArcToPathEffect)
+        // Flattenables that core creates on its own.
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkBitmapProcShader)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkColorShader)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposePathEffect)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposeShader)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkEmptyShader)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkLocalMatrixShader)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkMatrixImageFilter)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkModeColorFilter)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPictureShader)
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkSumPathEffect)
+        SkColorFilter::InitializeFlattenables();
+        SkXfermode::InitializeFlattenables();
+
+#ifndef SK_LEAN_EFFECTS
+        // Lean builds leave these unregistered, so that a static link only pulls in the
+        // effects the client actually calls.
+        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkArcToPathEffect)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkBitmapSource)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkBlurDrawLooper)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkBlurImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkColorCubeFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkColorMatrixFilter)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkColorShader)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposePathEffect)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposeShader)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkCornerPathEffect)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkDashPathEffect)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkDilateImageFilter)
@@ -78,29 +91,22 @@ public:
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkDisplacementMapEffect)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkDropShadowImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkEmbossMaskFilter)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkEmptyShader)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkErodeImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkLayerDrawLooper)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkLayerRasterizer)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkLerpXfermode)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkLocalMatrixShader)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkLumaColorFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPath1DPathEffect)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkLine2DPathEffect)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkModeColorFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPath2DPathEffect)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPerlinNoiseShader)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPictureImageFilter)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPictureShader)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkPixelXorXfermode)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkRectShaderImageFilter)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkSumPathEffect)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkTileImageFilter)
-        SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkMatrixImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkXfermodeImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkMagnifierImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkMatrixConvolutionImageFilter)
-
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkOffsetImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkComposeImageFilter)
         SK_DEFINE_FLATTENABLE_REGISTRAR_ENTRY(SkMergeImageFilter)
@@ -109,12 +115,11 @@ public:
 
         SkArithmeticMode::InitializeFlattenables();
         SkBlurMaskFilter::InitializeFlattenables();
-        SkColorFilter::InitializeFlattenables();
         SkGradientShader::InitializeFlattenables();
         SkLightingImageFilter::InitializeFlattenables();
         SkLightingShader::InitializeFlattenables();
         SkTableColorFilter::InitializeFlattenables();
-        SkXfermode::InitializeFlattenables();
+#endif
     }
 };
 
@@ -48,15 +48,22 @@ protected:
     }
     bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
                      SkPMColor ctableEntries[], int* ctableCount) override {
+        const int sampleSize = this->sampleSizeFor(info.dimensions());
+        if (0 == sampleSize) {
+            return false;
+        }
+
         SkMemoryStream stream(fData->data(), fData->size(), false);
         SkAutoTUnref<BareMemoryAllocator> allocator(SkNEW_ARGS(BareMemoryAllocator,
                                                                (info, pixels, rowBytes)));
         fDecoder->setAllocator(allocator);
         fDecoder->setRequireUnpremultipliedColors(kUnpremul_SkAlphaType == info.alphaType());
+        fDecoder->setSampleSize(sampleSize);
 
         SkBitmap bm;
         const SkImageDecoder::Result result = fDecoder->decode(&stream, &bm, info.colorType(),
                                                                SkImageDecoder::kDecodePixels_Mode);
+        fDecoder->resetSampleSize();
         if (SkImageDecoder::kFailure == result) {
             return false;
         }
@@ -83,7 +90,42 @@ protected:
         return fDecoder->decodeYUV8Planes(&stream, sizes, planes, rowBytes, colorSpace);
     }
 
+    SkISize onGetScaledDimensions(SkScalar desiredScale) override {
+        // Only JPEG really scales as it decodes (DCT scaling by 1/2, 1/4 or 1/8).  The other
+        // decoders just point sample, which looks worse than decoding in full and filtering.
+        int sampleSize = 1;
+        if (SkImageDecoder::kJPEG_Format == fDecoder->getFormat()) {
+            while (sampleSize < kMaxJpegSampleSize && 2 * sampleSize * desiredScale <= 1) {
+                sampleSize *= 2;
+            }
+        }
+        return ScaledDimensions(fInfo.dimensions(), sampleSize);
+    }
+
 private:
+    static const int kMaxJpegSampleSize = 8;
+
+    // libjpeg rounds DCT-scaled dimensions up.
+    static SkISize ScaledDimensions(const SkISize& size, int sampleSize) {
+        return SkISize::Make((size.width()  + sampleSize - 1) / sampleSize,
+                             (size.height() + sampleSize - 1) / sampleSize);
+    }
+
+    // Returns the sample size that decodes to the given dimensions, or 0 if there isn't one.
+    int sampleSizeFor(const SkISize& size) const {
+        if (size == fInfo.dimensions()) {
+            return 1;
+        }
+        if (SkImageDecoder::kJPEG_Format == fDecoder->getFormat()) {
+            for (int sampleSize = 2; sampleSize <= kMaxJpegSampleSize; sampleSize *= 2) {
+                if (size == ScaledDimensions(fInfo.dimensions(), sampleSize)) {
+                    return sampleSize;
+                }
+            }
+        }
+        return 0;
+    }
+
     typedef SkImageGenerator INHERITED;
 };
 
@@ -9,6 +9,17 @@
 
 #include <stdlib.h>
 
+#ifdef SK_COUNT_ALLOCATIONS
+    #include "SkAllocationCounter.h"
+    #define COUNT_ALLOCATION(size) SkCountAllocation(size)
+    #define COUNT_LIVE(p)          SkCountLive(p)
+    #define COUNT_FREE(p)          SkCountFree(p)
+#else
+    #define COUNT_ALLOCATION(size)
+    #define COUNT_LIVE(p)
+    #define COUNT_FREE(p)
+#endif
+
 #define SK_DEBUGFAILF(fmt, ...) \
     SkASSERT((SkDebugf(fmt"\n", __VA_ARGS__), false))
 
@@ -41,17 +52,24 @@ void* sk_malloc_throw(size_t size) {
 }
 
 void* sk_realloc_throw(void* addr, size_t size) {
-    return throw_on_failure(size, realloc(addr, size));
+    COUNT_ALLOCATION(size);
+    COUNT_FREE(addr);
+    void* p = realloc(addr, size);
+    COUNT_LIVE(p);
+    return throw_on_failure(size, p);
 }
 
 void sk_free(void* p) {
     if (p) {
+        COUNT_FREE(p);
         free(p);
     }
 }
 
 void* sk_malloc_flags(size_t size, unsigned flags) {
+    COUNT_ALLOCATION(size);
     void* p = malloc(size);
+    COUNT_LIVE(p);
     if (flags & SK_MALLOC_THROW) {
         return throw_on_failure(size, p);
     } else {
@@ -60,7 +78,10 @@ void* sk_malloc_flags(size_t size, unsigned flags) {
 }
 
 void* sk_calloc(size_t size) {
-    return calloc(size, 1);
+    COUNT_ALLOCATION(size);
+    void* p = calloc(size, 1);
+    COUNT_LIVE(p);
+    return p;
 }
 
 void* sk_calloc_throw(size_t size) {
@@ -75,6 +75,19 @@ static const char* svg_text_align(SkPaint::Align align) {
     return text_align_map[align];
 }
 
+// Writes name(v0 v1 ...), with each value formatted by SkString::appendScalar().
+static void svg_function(SkString* str, const char name[], const SkScalar values[], int count) {
+    str->set(name);
+    str->append("(");
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+            str->append(" ");
+        }
+        str->appendScalar(values[i]);
+    }
+    str->append(")");
+}
+
 static SkString svg_transform(const SkMatrix& t) {
     SkASSERT(!t.isIdentity());
 
@@ -83,22 +96,26 @@ static SkString svg_transform(const SkMatrix& t) {
     case SkMatrix::kPerspective_Mask:
         SkDebugf("Can't handle perspective matrices.");
         break;
-    case SkMatrix::kTranslate_Mask:
-        tstr.printf("translate(%g %g)", t.getTranslateX(), t.getTranslateY());
-        break;
-    case SkMatrix::kScale_Mask:
-        tstr.printf("scale(%g %g)", t.getScaleX(), t.getScaleY());
-        break;
-    default:
+    case SkMatrix::kTranslate_Mask: {
+        const SkScalar values[] = { t.getTranslateX(), t.getTranslateY() };
+        svg_function(&tstr, "translate", values, SK_ARRAY_COUNT(values));
+    } break;
+    case SkMatrix::kScale_Mask: {
+        const SkScalar values[] = { t.getScaleX(), t.getScaleY() };
+        svg_function(&tstr, "scale", values, SK_ARRAY_COUNT(values));
+    } break;
+    default: {
         // http://www.w3.org/TR/SVG/coords.html#TransformMatrixDefined
         //    | a c e |
         //    | b d f |
         //    | 0 0 1 |
-        tstr.printf("matrix(%g %g %g %g %g %g)",
-                    t.getScaleX(),     t.getSkewY(),
-                    t.getSkewX(),      t.getScaleY(),
-                    t.getTranslateX(), t.getTranslateY());
-        break;
+        const SkScalar values[] = {
+            t.getScaleX(),     t.getSkewY(),
+            t.getSkewX(),      t.getScaleY(),
+            t.getTranslateX(), t.getTranslateY(),
+        };
+        svg_function(&tstr, "matrix", values, SK_ARRAY_COUNT(values));
+    } break;
     }
 
     return tstr;
@@ -7,6 +7,7 @@
 
 #include "SkDashPathPriv.h"
 #include "SkPathMeasure.h"
+#include "SkResourceCache.h"
 
 static inline int is_even(int x) {
     return (~x) << 31;
@@ -218,16 +219,9 @@ private:
 };
 
 
-bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
-                                const SkRect* cullRect, const SkScalar aIntervals[],
-                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
-                                SkScalar intervalLength) {
-
-    // we do nothing if the src wants to be filled, or if our dashlength is 0
-    if (rec->isFillStyle() || initialDashLength < 0) {
-        return false;
-    }
-
+static bool dash_path(SkPath* dst, const SkPath& src, SkStrokeRec* rec, const SkRect* cullRect,
+                      const SkScalar aIntervals[], int32_t count, SkScalar initialDashLength,
+                      int32_t initialDashIndex, SkScalar intervalLength) {
     const SkScalar* intervals = aIntervals;
     SkScalar        dashCount = 0;
     int             segCount = 0;
@@ -317,6 +311,92 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+// Dashes with at most this many intervals are cached.
+static const int kMaxCachedIntervals = 8;
+
+namespace {
+static unsigned gDashKeyNamespaceLabel;
+
+struct DashKey : public SkResourceCache::Key {
+public:
+    DashKey(uint32_t pathGenID, const SkScalar intervals[], int32_t count,
+            SkScalar initialDashLength, int32_t initialDashIndex)
+        : fCount(count)
+        , fInitialDashLength(initialDashLength)
+        , fInitialDashIndex(initialDashIndex)
+    {
+        SkASSERT(count <= kMaxCachedIntervals);
+        sk_bzero(fIntervals, sizeof(fIntervals));
+        memcpy(fIntervals, intervals, count * sizeof(SkScalar));
+
+        this->init(&gDashKeyNamespaceLabel, pathGenID,
+                   sizeof(fCount) + sizeof(fInitialDashLength) + sizeof(fInitialDashIndex) +
+                   sizeof(fIntervals));
+    }
+
+    int32_t     fCount;
+    SkScalar    fInitialDashLength;
+    int32_t     fInitialDashIndex;
+    SkScalar    fIntervals[kMaxCachedIntervals];
+};
+
+struct DashRec : public SkResourceCache::Rec {
+    DashRec(const DashKey& key, const SkPath& dashes)
+        : fKey(key)
+        , fDashes(dashes)
+    {}
+
+    DashKey     fKey;
+    SkPath      fDashes;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fDashes.countPoints() * sizeof(SkPoint) + fDashes.countVerbs();
+    }
+    const char* getCategory() const override { return "dash"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const DashRec& rec = static_cast<const DashRec&>(baseRec);
+        SkPath* result = static_cast<SkPath*>(contextData);
+
+        *result = rec.fDashes;
+        return true;
+    }
+};
+} // namespace
+
+bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
+                                const SkRect* cullRect, const SkScalar aIntervals[],
+                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
+                                SkScalar intervalLength) {
+
+    // we do nothing if the src wants to be filled, or if our dashlength is 0
+    if (rec->isFillStyle() || initialDashLength < 0) {
+        return false;
+    }
+
+    // Only lines are culled or dashed with the stroke in mind. Every other path dashes the same
+    // way for any stroke and cull rect, so its dashes are cached by its generation ID, and
+    // drawing it again copies them instead of measuring the path and dashing it again.
+    if (!dst->isEmpty() || src.isVolatile() || count > kMaxCachedIntervals || src.isLine(NULL)) {
+        return dash_path(dst, src, rec, cullRect, aIntervals, count, initialDashLength,
+                         initialDashIndex, intervalLength);
+    }
+
+    DashKey key(src.getGenerationID(), aIntervals, count, initialDashLength, initialDashIndex);
+    if (SkResourceCache::Find(key, DashRec::Visitor, dst)) {
+        return true;
+    }
+    if (!dash_path(dst, src, rec, cullRect, aIntervals, count, initialDashLength,
+                   initialDashIndex, intervalLength)) {
+        return false;
+    }
+    SkResourceCache::Add(SkNEW_ARGS(DashRec, (key, *dst)));
+    return true;
+}
+
 bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
                                 const SkRect* cullRect, const SkPathEffect::DashInfo& info) {
     SkScalar initialDashLength = 0;
@@ -18,8 +18,10 @@
 #include "SkPaint.h"
 #include "SkPaintPriv.h"
 #include "SkRRect.h"
+#include "SkSemaphore.h"
 #include "SkShader.h"
 #include "SkSurface.h"
+#include "SkThreadUtils.h"
 
 enum {
     // Deferred canvas will auto-flush when recording reaches this limit
@@ -89,6 +91,7 @@ public:
     void* requestBlock(size_t minRequest, size_t* actual) override;
     void notifyWritten(size_t bytes) override;
     void playback(bool silent);
+    SkCanvas* playbackCanvas() const { return fPlaybackCanvas; }
     bool hasPendingCommands() const { return fAllocator.totalUsed() != 0; }
     size_t storageAllocatedForRecording() const { return fAllocator.totalCapacity(); }
 private:
@@ -105,12 +108,14 @@ private:
     SkChunkAlloc fAllocator;
     SkTDArray<PipeBlock> fBlockList;
     SkGPipeReader fReader;
+    SkCanvas* fPlaybackCanvas;
 };
 
 DeferredPipeController::DeferredPipeController() :
     fAllocator(kMinBlockSize) {
     fBlock = NULL;
     fBytesWritten = 0;
+    fPlaybackCanvas = NULL;
 }
 
 DeferredPipeController::~DeferredPipeController() {
@@ -119,6 +124,7 @@ DeferredPipeController::~DeferredPipeController() {
 
 void DeferredPipeController::setPlaybackCanvas(SkCanvas* canvas) {
     fReader.setCanvas(canvas);
+    fPlaybackCanvas = canvas;
 }
 
 void* DeferredPipeController::requestBlock(size_t minRequest, size_t *actual) {
@@ -157,6 +163,95 @@ void DeferredPipeController::playback(bool silent) {
     this->purgeCaches();
 }
 
+//-----------------------------------------------------------------------------
+// DeferredPlaybackThread
+//-----------------------------------------------------------------------------
+
+// Plays back the recordings it is handed, one at a time, on its own thread.
+class DeferredPlaybackThread : SkNoncopyable {
+public:
+    DeferredPlaybackThread();
+    ~DeferredPlaybackThread();
+
+    // Takes ownership of the controller, which must have finished recording, plays it back into
+    // its canvas and flushes that. Must only be called when the thread is idle.
+    void play(DeferredPipeController*);
+    // Returns once the thread is idle.
+    void wait();
+
+private:
+    static void Run(void*);
+
+    SkThread                fThread;
+    SkSemaphore             fWork;
+    SkSemaphore             fDone;
+    DeferredPipeController* fController;  // NULL tells the thread to quit
+    bool                    fBusy;        // only used by the thread calling play() and wait()
+};
+
+DeferredPlaybackThread::DeferredPlaybackThread()
+    : fThread(Run, this)
+    , fController(NULL)
+    , fBusy(false) {
+    fThread.start();
+}
+
+DeferredPlaybackThread::~DeferredPlaybackThread() {
+    this->wait();
+    fController = NULL;
+    fWork.signal();
+    fThread.join();
+}
+
+void DeferredPlaybackThread::play(DeferredPipeController* controller) {
+    SkASSERT(!fBusy && controller);
+    fController = controller;
+    fBusy = true;
+    fWork.signal();
+}
+
+void DeferredPlaybackThread::wait() {
+    if (fBusy) {
+        fDone.wait();
+        fBusy = false;
+    }
+}
+
+void DeferredPlaybackThread::Run(void* data) {
+    DeferredPlaybackThread* thread = static_cast<DeferredPlaybackThread*>(data);
+    for (;;) {
+        thread->fWork.wait();
+        DeferredPipeController* controller = thread->fController;
+        if (NULL == controller) {
+            return;
+        }
+        controller->playback(false);
+        controller->playbackCanvas()->flush();
+        SkDELETE(controller);
+        thread->fController = NULL;
+        thread->fDone.signal();
+    }
+}
+
+// Applies the clips of one canvas to another, whose matrix must be the identity.
+class ClipCopier : public SkCanvas::ClipVisitor {
+public:
+    ClipCopier(SkCanvas* dst) : fDst(dst) {}
+
+    void clipRect(const SkRect& rect, SkRegion::Op op, bool antialias) override {
+        fDst->clipRect(rect, op, antialias);
+    }
+    void clipRRect(const SkRRect& rrect, SkRegion::Op op, bool antialias) override {
+        fDst->clipRRect(rrect, op, antialias);
+    }
+    void clipPath(const SkPath& path, SkRegion::Op op, bool antialias) override {
+        fDst->clipPath(path, op, antialias);
+    }
+
+private:
+    SkCanvas* fDst;
+};
+
 //-----------------------------------------------------------------------------
 // SkDeferredDevice
 //-----------------------------------------------------------------------------
@@ -177,6 +272,7 @@ public:
     size_t freeMemoryIfPossible(size_t bytesToFree);
     void flushPendingCommands(PlaybackMode);
     void skipPendingCommands();
+    void setThreadedPlayback(bool);
     void setMaxRecordingStorage(size_t);
     void recordedDrawCommand();
     void setIsDrawingToLayer(bool value) {fIsDrawingToLayer = value;}
@@ -278,9 +374,13 @@ private:
     void init();
     void aboutToDraw();
     void prepareForImmediatePixelWrite();
+    bool handOffPendingCommands();
+    void waitForPlayback();
 
-    DeferredPipeController fPipeController;
+    SkAutoTDelete<DeferredPipeController> fPipeController;
     SkGPipeWriter  fPipeWriter;
+    // Only set when playing back on another thread.
+    SkAutoTDelete<DeferredPlaybackThread> fPlaybackThread;
     SkCanvas* fImmediateCanvas;
     SkCanvas* fRecordingCanvas;
     SkSurface* fSurface;
@@ -290,12 +390,15 @@ private:
     bool fIsDrawingToLayer;
     size_t fMaxRecordingStorageBytes;
     size_t fPreviousStorageAllocated;
+    // The recording only holds the matrix and clip it was started with by a hand-off.
+    bool fRecordingIsPrelude;
 
     typedef SkBaseDevice INHERITED;
 };
 
 SkDeferredDevice::SkDeferredDevice(SkSurface* surface) 
-    : INHERITED(surface->props()) {
+    : INHERITED(surface->props())
+    , fPipeController(SkNEW(DeferredPipeController)) {
     fMaxRecordingStorageBytes = kDefaultMaxRecordingStorageBytes;
     fNotificationClient = NULL;
     fImmediateCanvas = NULL;
@@ -305,9 +408,10 @@ SkDeferredDevice::SkDeferredDevice(SkSurface* surface)
 }
 
 void SkDeferredDevice::setSurface(SkSurface* surface) {
+    this->waitForPlayback();
     SkRefCnt_SafeAssign(fImmediateCanvas, surface->getCanvas());
     SkRefCnt_SafeAssign(fSurface, surface);
-    fPipeController.setPlaybackCanvas(fImmediateCanvas);
+    fPipeController->setPlaybackCanvas(fImmediateCanvas);
 }
 
 void SkDeferredDevice::init() {
@@ -316,6 +420,7 @@ void SkDeferredDevice::init() {
     fIsDrawingToLayer = false;
     fCanDiscardCanvasContents = false;
     fPreviousStorageAllocated = 0;
+    fRecordingIsPrelude = false;
     fMaxRecordingStorageBytes = kDefaultMaxRecordingStorageBytes;
     fNotificationClient = NULL;
     this->beginRecording();
@@ -323,6 +428,7 @@ void SkDeferredDevice::init() {
 
 SkDeferredDevice::~SkDeferredDevice() {
     this->flushPendingCommands(kSilent_PlaybackMode);
+    fPlaybackThread.reset(NULL);
     SkSafeUnref(fImmediateCanvas);
     SkSafeUnref(fSurface);
 }
@@ -334,7 +440,7 @@ void SkDeferredDevice::setMaxRecordingStorage(size_t maxStorage) {
 
 void SkDeferredDevice::beginRecording() {
     SkASSERT(NULL == fRecordingCanvas);
-    fRecordingCanvas = fPipeWriter.startRecording(&fPipeController, 0,
+    fRecordingCanvas = fPipeWriter.startRecording(fPipeController, 0,
         immediateDevice()->width(), immediateDevice()->height());
 }
 
@@ -346,7 +452,7 @@ void SkDeferredDevice::setNotificationClient(
 void SkDeferredDevice::skipPendingCommands() {
     if (!fIsDrawingToLayer) {
         fCanDiscardCanvasContents = true;
-        if (fPipeController.hasPendingCommands()) {
+        if (this->hasPendingCommands()) {
             fFreshFrame = true;
             flushPendingCommands(kSilent_PlaybackMode);
         }
@@ -360,7 +466,7 @@ bool SkDeferredDevice::isFreshFrame() {
 }
 
 bool SkDeferredDevice::hasPendingCommands() {
-    return fPipeController.hasPendingCommands();
+    return fPipeController->hasPendingCommands() && !fRecordingIsPrelude;
 }
 
 void SkDeferredDevice::aboutToDraw() {
@@ -376,14 +482,17 @@ void SkDeferredDevice::aboutToDraw() {
 }
 
 void SkDeferredDevice::flushPendingCommands(PlaybackMode playbackMode) {
-    if (!fPipeController.hasPendingCommands()) {
+    // What was handed to the playback thread comes first, and then what is pending is played back
+    // here, so that the surface is up to date when this returns.
+    this->waitForPlayback();
+    if (!this->hasPendingCommands()) {
         return;
     }
     if (playbackMode == kNormal_PlaybackMode) {
         aboutToDraw();
     }
     fPipeWriter.flushRecording(true);
-    fPipeController.playback(kSilent_PlaybackMode == playbackMode);
+    fPipeController->playback(kSilent_PlaybackMode == playbackMode);
     if (fNotificationClient) {
         if (playbackMode == kSilent_PlaybackMode) {
             fNotificationClient->skippedPendingDrawCommands();
@@ -395,7 +504,65 @@ void SkDeferredDevice::flushPendingCommands(PlaybackMode playbackMode) {
     fPreviousStorageAllocated = storageAllocatedForRecording();
 }
 
+void SkDeferredDevice::setThreadedPlayback(bool threaded) {
+    if (!threaded) {
+        fPlaybackThread.reset(NULL);
+    } else if (NULL == fPlaybackThread.get()) {
+        fPlaybackThread.reset(SkNEW(DeferredPlaybackThread));
+    }
+}
+
+void SkDeferredDevice::waitForPlayback() {
+    if (fPlaybackThread.get()) {
+        fPlaybackThread->wait();
+    }
+}
+
+// Ends the recording and hands it to the playback thread, which plays it back while the next one
+// is recorded. This is only done outside of any save(), so that the next recording can pick up
+// where this one left off by just setting its matrix and clip.
+bool SkDeferredDevice::handOffPendingCommands() {
+    if (NULL == fPlaybackThread.get() || !this->hasPendingCommands() ||
+        1 != fRecordingCanvas->getSaveCount()) {
+        return false;
+    }
+    // The previous recording may still be drawing into the surface, which the notifications could
+    // copy or discard.
+    fPlaybackThread->wait();
+    this->aboutToDraw();
+
+    const SkMatrix matrix = fRecordingCanvas->getTotalMatrix();
+    SkAutoTUnref<SkCanvas> previous(SkRef(fRecordingCanvas));
+    fPipeWriter.endRecording();
+    fPlaybackThread->play(fPipeController.detach());
+    fPipeController.reset(SkNEW(DeferredPipeController));
+    fPipeController->setPlaybackCanvas(fImmediateCanvas);
+    fRecordingCanvas = NULL;
+    this->beginRecording();
+
+    // The playback canvas is left with the same matrix and clip, but the new recording needs them
+    // too, so it resets them and sets them again from scratch.
+    fRecordingCanvas->resetMatrix();
+    fRecordingCanvas->clipRect(SkRect::MakeWH(SkIntToScalar(this->width()),
+                                              SkIntToScalar(this->height())),
+                               SkRegion::kReplace_Op);
+    ClipCopier copier(fRecordingCanvas);
+    previous->replayClips(&copier);
+    fRecordingCanvas->setMatrix(matrix);
+    fRecordingIsPrelude = true;
+
+    if (fNotificationClient) {
+        fNotificationClient->flushedDrawCommands();
+    }
+    fPreviousStorageAllocated = storageAllocatedForRecording();
+    return true;
+}
+
 void SkDeferredDevice::flush() {
+    // The playback thread flushes the surface's canvas when it's done.
+    if (this->handOffPendingCommands()) {
+        return;
+    }
     this->flushPendingCommands(kNormal_PlaybackMode);
     fImmediateCanvas->flush();
 }
@@ -407,11 +574,12 @@ size_t SkDeferredDevice::freeMemoryIfPossible(size_t bytesToFree) {
 }
 
 size_t SkDeferredDevice::storageAllocatedForRecording() const {
-    return (fPipeController.storageAllocatedForRecording()
+    return (fPipeController->storageAllocatedForRecording()
             + fPipeWriter.storageAllocatedForRecording());
 }
 
 void SkDeferredDevice::recordedDrawCommand() {
+    fRecordingIsPrelude = false;
     size_t storageAllocated = this->storageAllocatedForRecording();
 
     if (storageAllocated > fMaxRecordingStorageBytes) {
@@ -419,7 +587,9 @@ void SkDeferredDevice::recordedDrawCommand() {
         size_t tryFree = storageAllocated - fMaxRecordingStorageBytes;
         if (this->freeMemoryIfPossible(tryFree) < tryFree) {
             // Flush is necessary to free more space.
-            this->flushPendingCommands(kNormal_PlaybackMode);
+            if (!this->handOffPendingCommands()) {
+                this->flushPendingCommands(kNormal_PlaybackMode);
+            }
             // Free as much as possible to avoid oscillating around fMaxRecordingStorageBytes
             // which could cause a high flushing frequency.
             this->freeMemoryIfPossible(~0U);
@@ -440,6 +610,7 @@ SkCanvas* SkDeferredDevice::recordingCanvas() {
 
 SkImage* SkDeferredDevice::newImageSnapshot() {
     this->flush();
+    this->waitForPlayback();
     return fSurface ? fSurface->newImageSnapshot() : NULL;
 }
 
@@ -456,7 +627,8 @@ void SkDeferredDevice::prepareForImmediatePixelWrite() {
     // The purpose of the following code is to make sure commands are flushed, that
     // aboutToDraw() is called and that notifyContentWillChange is called, without
     // calling anything redundantly.
-    if (fPipeController.hasPendingCommands()) {
+    this->waitForPlayback();
+    if (this->hasPendingCommands()) {
         this->flushPendingCommands(kNormal_PlaybackMode);
     } else {
         bool mustNotifyDirectly = !fCanDiscardCanvasContents;
@@ -646,6 +818,10 @@ void SkDeferredCanvas::silentFlush() {
     }
 }
 
+void SkDeferredCanvas::setThreadedPlayback(bool threaded) {
+    this->getDeferredDevice()->setThreadedPlayback(threaded);
+}
+
 SkDeferredCanvas::~SkDeferredCanvas() {
 }
 
@@ -6,9 +6,11 @@
  * found in the LICENSE file.
  */
 #include "SkNWayCanvas.h"
+#include "SkTaskGroup.h"
 
 SkNWayCanvas::SkNWayCanvas(int width, int height)
-        : INHERITED(width, height) {}
+        : INHERITED(width, height)
+        , fConcurrentPicturePlayback(false) {}
 
 SkNWayCanvas::~SkNWayCanvas() {
     this->removeAll();
@@ -271,8 +273,49 @@ void SkNWayCanvas::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y
     }
 }
 
+namespace {
+
+struct PictureDraw {
+    SkCanvas*           fCanvas;
+    const SkPicture*    fPicture;
+    const SkMatrix*     fMatrix;
+    const SkPaint*      fPaint;
+
+    static void Draw(PictureDraw* draw) {
+        draw->fCanvas->drawPicture(draw->fPicture, draw->fMatrix, draw->fPaint);
+    }
+};
+
+}  // namespace
+
 void SkNWayCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* matrix,
                                  const SkPaint* paint) {
+    if (fConcurrentPicturePlayback && fList.count() > 1) {
+        // Raster and other CPU backed canvases each get their own task. GPU canvases must stay
+        // on the thread that owns their context, so we draw those here while the tasks run.
+        SkAutoSTMalloc<4, PictureDraw> draws(fList.count());
+        int cpuCount = 0;
+        for (int i = 0; i < fList.count(); ++i) {
+            if (NULL == fList[i]->getGrContext()) {
+                PictureDraw& draw = draws[cpuCount++];
+                draw.fCanvas = fList[i];
+                draw.fPicture = picture;
+                draw.fMatrix = matrix;
+                draw.fPaint = paint;
+            }
+        }
+
+        SkTaskGroup tg;
+        tg.batch(PictureDraw::Draw, draws.get(), cpuCount);
+        for (int i = 0; i < fList.count(); ++i) {
+            if (fList[i]->getGrContext()) {
+                fList[i]->drawPicture(picture, matrix, paint);
+            }
+        }
+        tg.wait();
+        return;
+    }
+
     Iter iter(fList);
     while (iter.next()) {
         iter->drawPicture(picture, matrix, paint);
@@ -188,31 +188,25 @@ bool SkParsePath::FromSVGString(const char data[], SkPath* result) {
 
 #include "SkGeometry.h"
 #include "SkString.h"
-#include "SkStream.h"
-
-static void write_scalar(SkWStream* stream, SkScalar value) {
-    char buffer[64];
-#ifdef SK_BUILD_FOR_WIN32
-    int len = _snprintf(buffer, sizeof(buffer), "%g", value);
-#else
-    int len = snprintf(buffer, sizeof(buffer), "%g", value);
-#endif
-    char* stop = buffer + len;
-    stream->write(buffer, stop - buffer);
-}
-
-static void append_scalars(SkWStream* stream, char verb, const SkScalar data[],
-                           int count) {
-    stream->write(&verb, 1);
-    write_scalar(stream, data[0]);
+#include "SkTDArray.h"
+
+// Appends verb and count scalars to str, which must have room for them.
+static void append_scalars(SkTDArray<char>* str, char verb, const SkScalar data[], int count) {
+    char* start = str->append(1 + count * (1 + SkStrAppendScalar_MaxSize));
+    char* dst = start;
+    *dst++ = verb;
+    dst = SkStrAppendScalar(dst, data[0]);
     for (int i = 1; i < count; i++) {
-        stream->write(" ", 1);
-        write_scalar(stream, data[i]);
+        *dst++ = ' ';
+        dst = SkStrAppendScalar(dst, data[i]);
     }
+    str->setCount(SkToInt(dst - str->begin()));
 }
 
 void SkParsePath::ToSVGString(const SkPath& path, SkString* str) {
-    SkDynamicMemoryWStream  stream;
+    // Format straight into one growing buffer, rather than through a stream.
+    SkTDArray<char> buffer;
+    buffer.setReserve(path.countPoints() * (1 + SkStrAppendScalar_MaxSize) * 2 + path.countVerbs());
 
     SkPath::Iter    iter(path, false);
     SkPoint         pts[4];
@@ -224,27 +218,26 @@ void SkParsePath::ToSVGString(const SkPath& path, SkString* str) {
                 SkAutoConicToQuads quadder;
                 const SkPoint* quadPts = quadder.computeQuads(pts, iter.conicWeight(), tol);
                 for (int i = 0; i < quadder.countQuads(); ++i) {
-                    append_scalars(&stream, 'Q', &quadPts[i*2 + 1].fX, 4);
+                    append_scalars(&buffer, 'Q', &quadPts[i*2 + 1].fX, 4);
                 }
             } break;
            case SkPath::kMove_Verb:
-                append_scalars(&stream, 'M', &pts[0].fX, 2);
+                append_scalars(&buffer, 'M', &pts[0].fX, 2);
                 break;
             case SkPath::kLine_Verb:
-                append_scalars(&stream, 'L', &pts[1].fX, 2);
+                append_scalars(&buffer, 'L', &pts[1].fX, 2);
                 break;
             case SkPath::kQuad_Verb:
-                append_scalars(&stream, 'Q', &pts[1].fX, 4);
+                append_scalars(&buffer, 'Q', &pts[1].fX, 4);
                 break;
             case SkPath::kCubic_Verb:
-                append_scalars(&stream, 'C', &pts[1].fX, 6);
+                append_scalars(&buffer, 'C', &pts[1].fX, 6);
                 break;
             case SkPath::kClose_Verb:
-                stream.write("Z", 1);
+                *buffer.append() = 'Z';
                 break;
             case SkPath::kDone_Verb:
-                str->resize(stream.getOffset());
-                stream.copyTo(str->writable_str());
+                str->set(buffer.begin(), buffer.count());
             return;
         }
     }
@@ -167,23 +167,88 @@ void SkPatchGrid::draw(SkCanvas* canvas, SkPaint& paint) {
         }
     }
     // Draw the patches by generating their geometry with the maximum level of detail per axis.
+    if (!this->drawAsOneMesh(canvas, paint, maxCols, maxRows)) {
+        for (int x = 0; x < fCols; x++) {
+            for (int y = 0; y < fRows; y++) {
+                SkPoint cubics[12];
+                SkPoint texCoords[4];
+                SkColor colors[4];
+                this->getPatch(x, y, cubics, colors, texCoords);
+                SkPatchUtils::VertexData data;
+                if (SkPatchUtils::getVertexData(&data, cubics,
+                                                fModeFlags & kColors_VertexType ? colors : NULL,
+                                                fModeFlags & kTexs_VertexType ? texCoords : NULL,
+                                                maxCols[x], maxRows[y])) {
+                    canvas->drawVertices(SkCanvas::kTriangles_VertexMode, data.fVertexCount,
+                                         data.fPoints, data.fTexCoords, data.fColors, fXferMode,
+                                         data.fIndices, data.fIndexCount, paint);
+                }
+            }
+        }
+    }
+    SkDELETE_ARRAY(maxCols);
+    SkDELETE_ARRAY(maxRows);
+}
+
+bool SkPatchGrid::drawAsOneMesh(SkCanvas* canvas, const SkPaint& paint, const int lodCols[],
+                                const int lodRows[]) {
+    // Adjacent patches share their edge curves, and every patch in a column (row) is evaluated
+    // with the same level of detail, so the vertices along a shared edge are the same for both
+    // patches. Lay all of them out in one (totalX + 1) * (totalY + 1) mesh indexed as
+    // x * (totalY + 1) + y, which lets neighbours write their shared edge to the same vertices.
+    int64_t totalX = 0, totalY = 0;
     for (int x = 0; x < fCols; x++) {
+        totalX += lodCols[x];
+    }
+    for (int y = 0; y < fRows; y++) {
+        totalY += lodRows[y];
+    }
+    const int64_t vertexCount = (totalX + 1) * (totalY + 1);
+    const int64_t indexCount = totalX * totalY * 6;
+    if (0 == fCols || 0 == fRows || vertexCount > SK_MaxU16 + 1 || indexCount > SK_MaxS32) {
+        // 16 bit indices can't address the whole mesh
+        return false;
+    }
+
+    const bool hasColors = SkToBool(fModeFlags & kColors_VertexType);
+    const bool hasTexs = SkToBool(fModeFlags & kTexs_VertexType);
+    const int stride = SkToInt(totalY + 1);
+
+    SkAutoTMalloc<SkPoint> points(SkToInt(vertexCount));
+    SkAutoTMalloc<uint16_t> indices(SkToInt(indexCount));
+    SkAutoTMalloc<SkPoint> texCoords;
+    SkAutoTMalloc<uint32_t> vertColors;
+    if (hasTexs) {
+        texCoords.reset(SkToInt(vertexCount));
+    }
+    if (hasColors) {
+        vertColors.reset(SkToInt(vertexCount));
+    }
+
+    int startX = 0;
+    for (int x = 0; x < fCols; x++) {
+        int startY = 0;
         for (int y = 0; y < fRows; y++) {
             SkPoint cubics[12];
-            SkPoint texCoords[4];
+            SkPoint patchTexCoords[4];
             SkColor colors[4];
-            this->getPatch(x, y, cubics, colors, texCoords);
-            SkPatchUtils::VertexData data;
-            if (SkPatchUtils::getVertexData(&data, cubics,
-                                            fModeFlags & kColors_VertexType ? colors : NULL,
-                                            fModeFlags & kTexs_VertexType ? texCoords : NULL,
-                                            maxCols[x], maxRows[y])) {
-                canvas->drawVertices(SkCanvas::kTriangles_VertexMode, data.fVertexCount,
-                                     data.fPoints, data.fTexCoords, data.fColors, fXferMode,
-                                     data.fIndices, data.fIndexCount, paint);
-            }
+            this->getPatch(x, y, cubics, colors, patchTexCoords);
+
+            const int first = startX * stride + startY;
+            SkPatchUtils::EvaluatePatch(cubics, hasColors ? colors : NULL,
+                                        hasTexs ? patchTexCoords : NULL,
+                                        lodCols[x], lodRows[y], stride,
+                                        points.get() + first,
+                                        hasTexs ? texCoords.get() + first : NULL,
+                                        hasColors ? vertColors.get() + first : NULL);
+            startY += lodRows[y];
         }
+        startX += lodCols[x];
     }
-    SkDELETE_ARRAY(maxCols);
-    SkDELETE_ARRAY(maxRows);
+    SkPatchUtils::SetGridIndices(SkToInt(totalX), SkToInt(totalY), stride, indices.get());
+
+    canvas->drawVertices(SkCanvas::kTriangles_VertexMode, SkToInt(vertexCount), points.get(),
+                         hasTexs ? texCoords.get() : NULL, hasColors ? vertColors.get() : NULL,
+                         fXferMode, indices.get(), SkToInt(indexCount), paint);
+    return true;
 }
@@ -130,6 +130,14 @@ public:
     }
     
 private:
+    /**
+     * Tessellates the whole grid into one mesh whose adjacent patches share their edge vertices,
+     * and draws it with a single drawVertices. Returns false, without drawing, if the mesh would
+     * need more vertices than 16 bit indices can address.
+     */
+    bool drawAsOneMesh(SkCanvas* canvas, const SkPaint& paint, const int lodCols[],
+                       const int lodRows[]);
+
     int fRows, fCols;
     VertexType fModeFlags;
     SkPoint* fCornerPts;
@@ -7,8 +7,10 @@
 
 #include "SkPatchUtils.h"
 
+#include "SkCachedData.h"
 #include "SkColorPriv.h"
 #include "SkGeometry.h"
+#include "SkResourceCache.h"
 
 /**
  * Evaluator to sample the values of a cubic bezier using forward differences.
@@ -189,53 +191,48 @@ void SkPatchUtils::getRightCubic(const SkPoint cubics[12], SkPoint points[4]) {
     points[3] = cubics[kRightP3_CubicCtrlPts];
 }
 
-bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint cubics[12],
-                   const SkColor colors[4], const SkPoint texCoords[4], int lodX, int lodY) {
-    if (lodX < 1 || lodY < 1 || NULL == cubics || NULL == data) {
-        return false;
-    }
-
+// Clamps the level of detail so the patch never needs more than 60000 indices, and computes the
+// vertex and index counts for it. Returns false if the counts would overflow.
+static bool compute_counts(int* lodX, int* lodY, int* vertexCount, int* indexCount) {
     // check for overflow in multiplication
-    const int64_t lodX64 = (lodX + 1),
-                   lodY64 = (lodY + 1),
+    const int64_t lodX64 = (*lodX + 1),
+                   lodY64 = (*lodY + 1),
                    mult64 = lodX64 * lodY64;
     if (mult64 > SK_MaxS32) {
         return false;
     }
-    data->fVertexCount = SkToS32(mult64);
+    *vertexCount = SkToS32(mult64);
 
     // it is recommended to generate draw calls of no more than 65536 indices, so we never generate
     // more than 60000 indices. To accomplish that we resize the LOD and vertex count
-    if (data->fVertexCount > 10000 || lodX > 200 || lodY > 200) {
-        SkScalar weightX = static_cast<SkScalar>(lodX) / (lodX + lodY);
-        SkScalar weightY = static_cast<SkScalar>(lodY) / (lodX + lodY);
+    if (*vertexCount > 10000 || *lodX > 200 || *lodY > 200) {
+        SkScalar weightX = static_cast<SkScalar>(*lodX) / (*lodX + *lodY);
+        SkScalar weightY = static_cast<SkScalar>(*lodY) / (*lodX + *lodY);
 
         // 200 comes from the 100 * 2 which is the max value of vertices because of the limit of
         // 60000 indices ( sqrt(60000 / 6) that comes from data->fIndexCount = lodX * lodY * 6)
-        lodX = static_cast<int>(weightX * 200);
-        lodY = static_cast<int>(weightY * 200);
-        data->fVertexCount = (lodX + 1) * (lodY + 1);
+        *lodX = static_cast<int>(weightX * 200);
+        *lodY = static_cast<int>(weightY * 200);
+        *vertexCount = (*lodX + 1) * (*lodY + 1);
     }
-    data->fIndexCount = lodX * lodY * 6;
-    
-    data->fPoints = SkNEW_ARRAY(SkPoint, data->fVertexCount);
-    data->fIndices = SkNEW_ARRAY(uint16_t, data->fIndexCount);
-    
-    // if colors is not null then create array for colors
+    *indexCount = *lodX * *lodY * 6;
+    return true;
+}
+
+void SkPatchUtils::EvaluatePatch(const SkPoint cubics[12], const SkColor colors[4],
+                                 const SkPoint texCoords[4], int lodX, int lodY, int stride,
+                                 SkPoint points[], SkPoint texCoordsOut[], uint32_t colorsOut[]) {
+    SkASSERT(lodX >= 1 && lodY >= 1 && stride > lodY);
+
+    // if colors is not null then premultiply them
     SkPMColor colorsPM[kNumCorners];
     if (colors) {
         // premultiply colors to avoid color bleeding.
         for (int i = 0; i < kNumCorners; i++) {
             colorsPM[i] = SkPreMultiplyColor(colors[i]);
         }
-        data->fColors = SkNEW_ARRAY(uint32_t, data->fVertexCount);
-    }
-    
-    // if texture coordinates are not null then create array for them
-    if (texCoords) {
-        data->fTexCoords = SkNEW_ARRAY(SkPoint, data->fVertexCount);
     }
-    
+
     SkPoint pts[kNumPtsCubic];
     SkPatchUtils::getBottomCubic(cubics, pts);
     FwDCubicEvaluator fBottom(pts);
@@ -250,14 +247,13 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
     fTop.restart(lodX);
     
     SkScalar u = 0.0f;
-    int stride = lodY + 1;
     for (int x = 0; x <= lodX; x++) {
         SkPoint bottom = fBottom.next(), top = fTop.next();
         fLeft.restart(lodY);
         fRight.restart(lodY);
         SkScalar v = 0.f;
         for (int y = 0; y <= lodY; y++) {
-            int dataIndex = x * (lodY + 1) + y;
+            int dataIndex = x * stride + y;
             
             SkPoint left = fLeft.next(), right = fRight.next();
             
@@ -274,7 +270,7 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
                                                      + u * fTop.getCtrlPoints()[3].y())
                                        + v * ((1.0f - u) * fBottom.getCtrlPoints()[0].y()
                                               + u * fBottom.getCtrlPoints()[3].y()));
-            data->fPoints[dataIndex] = s0 + s1 - s2;
+            points[dataIndex] = s0 + s1 - s2;
             
             if (colors) {
                 uint8_t a = uint8_t(bilerp(u, v,
@@ -297,11 +293,11 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
                                    SkScalar(SkColorGetB(colorsPM[kTopRight_Corner])),
                                    SkScalar(SkColorGetB(colorsPM[kBottomLeft_Corner])),
                                    SkScalar(SkColorGetB(colorsPM[kBottomRight_Corner]))));
-                data->fColors[dataIndex] = SkPackARGB32(a,r,g,b);
+                colorsOut[dataIndex] = SkPackARGB32(a,r,g,b);
             }
             
             if (texCoords) {
-                data->fTexCoords[dataIndex] = SkPoint::Make(
+                texCoordsOut[dataIndex] = SkPoint::Make(
                                             bilerp(u, v, texCoords[kTopLeft_Corner].x(),
                                                    texCoords[kTopRight_Corner].x(),
                                                    texCoords[kBottomLeft_Corner].x(),
@@ -312,20 +308,200 @@ bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint c
                                                    texCoords[kBottomRight_Corner].y()));
                 
             }
-            
-            if(x < lodX && y < lodY) {
-                int i = 6 * (x * lodY + y);
-                data->fIndices[i] = x * stride + y;
-                data->fIndices[i + 1] = x * stride + 1 + y;
-                data->fIndices[i + 2] = (x + 1) * stride + 1 + y;
-                data->fIndices[i + 3] = data->fIndices[i];
-                data->fIndices[i + 4] = data->fIndices[i + 2];
-                data->fIndices[i + 5] = (x + 1) * stride + y;
-            }
             v = SkScalarClampMax(v + 1.f / lodY, 1);
         }
         u = SkScalarClampMax(u + 1.f / lodX, 1);
     }
+}
+
+void SkPatchUtils::SetGridIndices(int lodX, int lodY, int stride, uint16_t indices[]) {
+    SkASSERT(stride > lodY);
+    for (int x = 0; x < lodX; x++) {
+        for (int y = 0; y < lodY; y++) {
+            int i = 6 * (x * lodY + y);
+            indices[i] = x * stride + y;
+            indices[i + 1] = x * stride + 1 + y;
+            indices[i + 2] = (x + 1) * stride + 1 + y;
+            indices[i + 3] = indices[i];
+            indices[i + 4] = indices[i + 2];
+            indices[i + 5] = (x + 1) * stride + y;
+        }
+    }
+}
+
+bool SkPatchUtils::getVertexData(SkPatchUtils::VertexData* data, const SkPoint cubics[12],
+                   const SkColor colors[4], const SkPoint texCoords[4], int lodX, int lodY) {
+    if (lodX < 1 || lodY < 1 || NULL == cubics || NULL == data) {
+        return false;
+    }
+
+    if (!compute_counts(&lodX, &lodY, &data->fVertexCount, &data->fIndexCount)) {
+        return false;
+    }
+    
+    data->fPoints = SkNEW_ARRAY(SkPoint, data->fVertexCount);
+    data->fIndices = SkNEW_ARRAY(uint16_t, data->fIndexCount);
+    
+    // if colors is not null then create array for colors
+    if (colors) {
+        data->fColors = SkNEW_ARRAY(uint32_t, data->fVertexCount);
+    }
+    
+    // if texture coordinates are not null then create array for them
+    if (texCoords) {
+        data->fTexCoords = SkNEW_ARRAY(SkPoint, data->fVertexCount);
+    }
+
+    EvaluatePatch(cubics, colors, texCoords, lodX, lodY, lodY + 1,
+                  data->fPoints, data->fTexCoords, data->fColors);
+    SetGridIndices(lodX, lodY, lodY + 1, data->fIndices);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPatchKeyNamespaceLabel;
+
+struct PatchKey : public SkResourceCache::Key {
+    PatchKey(const SkPoint cubics[12], const SkColor colors[4], const SkPoint texCoords[4],
+             int lodX, int lodY) {
+        memcpy(fCubics, cubics, sizeof(fCubics));
+        if (colors) {
+            memcpy(fColors, colors, sizeof(fColors));
+        } else {
+            memset(fColors, 0, sizeof(fColors));
+        }
+        if (texCoords) {
+            memcpy(fTexCoords, texCoords, sizeof(fTexCoords));
+        } else {
+            memset(fTexCoords, 0, sizeof(fTexCoords));
+        }
+        fLodX = lodX;
+        fLodY = lodY;
+        fFlags = (colors ? 1 : 0) | (texCoords ? 2 : 0);
+        this->init(&gPatchKeyNamespaceLabel, 0,
+                   sizeof(fCubics) + sizeof(fColors) + sizeof(fTexCoords) +
+                   sizeof(fLodX) + sizeof(fLodY) + sizeof(fFlags));
+    }
+
+    SkPoint     fCubics[SkPatchUtils::kNumCtrlPts];
+    SkColor     fColors[SkPatchUtils::kNumCorners];
+    SkPoint     fTexCoords[SkPatchUtils::kNumCorners];
+    int32_t     fLodX;
+    int32_t     fLodY;
+    uint32_t    fFlags;
+};
+
+struct PatchValue {
+    SkCachedData*   fData;
+    int             fVertexCount;
+    int             fIndexCount;
+};
+
+struct PatchRec : public SkResourceCache::Rec {
+    PatchRec(const PatchKey& key, const PatchValue& value) : fKey(key), fValue(value) {
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~PatchRec() {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    PatchKey    fKey;
+    PatchValue  fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "patch-mesh"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PatchRec& rec = static_cast<const PatchRec&>(baseRec);
+        PatchValue* result = static_cast<PatchValue*>(contextData);
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (NULL == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = rec.fValue;
+        return true;
+    }
+};
+} // namespace
+
+// The cached block holds the points, then the optional texture coordinates and colors, then the
+// indices.
+static void set_cached_pointers(SkPatchUtils::VertexData* data, bool hasColors, bool hasTexCoords) {
+    char* block = static_cast<char*>(data->fCachedData->writable_data());
+    data->fPoints = reinterpret_cast<SkPoint*>(block);
+    block += data->fVertexCount * sizeof(SkPoint);
+    if (hasTexCoords) {
+        data->fTexCoords = reinterpret_cast<SkPoint*>(block);
+        block += data->fVertexCount * sizeof(SkPoint);
+    }
+    if (hasColors) {
+        data->fColors = reinterpret_cast<uint32_t*>(block);
+        block += data->fVertexCount * sizeof(uint32_t);
+    }
+    data->fIndices = reinterpret_cast<uint16_t*>(block);
+}
+
+bool SkPatchUtils::GetCachedVertexData(VertexData* data, const SkPoint cubics[12],
+                                       const SkColor colors[4], const SkPoint texCoords[4],
+                                       int lodX, int lodY) {
+    if (lodX < 1 || lodY < 1 || NULL == cubics || NULL == data) {
+        return false;
+    }
+    SkASSERT(NULL == data->fPoints && NULL == data->fCachedData);
+
+    PatchKey key(cubics, colors, texCoords, lodX, lodY);
+    PatchValue value;
+    if (SkResourceCache::Find(key, PatchRec::Visitor, &value)) {
+        data->fCachedData = value.fData;
+        data->fVertexCount = value.fVertexCount;
+        data->fIndexCount = value.fIndexCount;
+        set_cached_pointers(data, SkToBool(colors), SkToBool(texCoords));
+        return true;
+    }
+
+    if (!compute_counts(&lodX, &lodY, &data->fVertexCount, &data->fIndexCount)) {
+        return false;
+    }
+
+    size_t vertexSize = sizeof(SkPoint);
+    if (colors) {
+        vertexSize += sizeof(uint32_t);
+    }
+    if (texCoords) {
+        vertexSize += sizeof(SkPoint);
+    }
+    size_t size = data->fVertexCount * vertexSize + data->fIndexCount * sizeof(uint16_t);
+    data->fCachedData = SkResourceCache::NewCachedData(size);
+    if (NULL == data->fCachedData) {
+        return false;
+    }
+    set_cached_pointers(data, SkToBool(colors), SkToBool(texCoords));
+
+    EvaluatePatch(cubics, colors, texCoords, lodX, lodY, lodY + 1,
+                  data->fPoints, data->fTexCoords, data->fColors);
+    SetGridIndices(lodX, lodY, lodY + 1, data->fIndices);
+
+    value.fData = data->fCachedData;
+    value.fVertexCount = data->fVertexCount;
+    value.fIndexCount = data->fIndexCount;
+    SkResourceCache::Add(SkNEW_ARGS(PatchRec, (key, value)));
     return true;
+}
 
+SkPatchUtils::VertexData::~VertexData() {
+    if (fCachedData) {
+        // The arrays live in the cached block.
+        fCachedData->unref();
+    } else {
+        SkDELETE_ARRAY(fPoints);
+        SkDELETE_ARRAY(fTexCoords);
+        SkDELETE_ARRAY(fColors);
+        SkDELETE_ARRAY(fIndices);
+    }
 }
@@ -11,6 +11,8 @@
 #include "SkColorPriv.h"
 #include "SkMatrix.h"
 
+class SkCachedData;
+
 class SK_API SkPatchUtils {
     
 public:
@@ -25,6 +27,9 @@ public:
         SkPoint* fTexCoords;
         uint32_t* fColors;
         uint16_t* fIndices;
+        // When set (by GetCachedVertexData), the arrays above point into this locked cache entry
+        // instead of being owned.
+        SkCachedData* fCachedData;
         
         VertexData()
         : fVertexCount(0)
@@ -32,14 +37,10 @@ public:
         , fPoints(NULL)
         , fTexCoords(NULL)
         , fColors(NULL)
-        , fIndices(NULL) { }
+        , fIndices(NULL)
+        , fCachedData(NULL) { }
         
-        ~VertexData() {
-            SkDELETE_ARRAY(fPoints);
-            SkDELETE_ARRAY(fTexCoords);
-            SkDELETE_ARRAY(fColors);
-            SkDELETE_ARRAY(fIndices);
-        }
+        ~VertexData();
     };
     
     // Enums for control points based on the order specified in the constructor (clockwise).
@@ -116,6 +117,31 @@ public:
     static bool getVertexData(SkPatchUtils::VertexData* data, const SkPoint cubics[12],
                               const SkColor colors[4], const SkPoint texCoords[4],
                               int lodX, int lodY);
+
+    /**
+     * Same as getVertexData(), but the tessellation is shared through the SkResourceCache, keyed by
+     * the cubics, colors, texCoords and level of detail, so redrawing an unchanged patch does not
+     * tessellate it again. data must be freshly constructed.
+     */
+    static bool GetCachedVertexData(SkPatchUtils::VertexData* data, const SkPoint cubics[12],
+                                    const SkColor colors[4], const SkPoint texCoords[4],
+                                    int lodX, int lodY);
+
+    /**
+     * Evaluates the patch at (lodX + 1) * (lodY + 1) points. The vertex at the x-th step along the
+     * top/bottom and y-th step along the left/right curves is written at index x * stride + y of
+     * points, and of texCoordsOut/colorsOut when colors/texCoords are given. getVertexData()
+     * uses a stride of lodY + 1; larger strides let several patches share one mesh.
+     */
+    static void EvaluatePatch(const SkPoint cubics[12], const SkColor colors[4],
+                              const SkPoint texCoords[4], int lodX, int lodY, int stride,
+                              SkPoint points[], SkPoint texCoordsOut[], uint32_t colorsOut[]);
+
+    /**
+     * Writes the lodX * lodY * 6 triangle indices for a grid of vertices laid out as by
+     * EvaluatePatch().
+     */
+    static void SetGridIndices(int lodX, int lodY, int stride, uint16_t indices[]);
 };
 
 #endif
@@ -0,0 +1,239 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPictureUtils.h"
+
+#include "SkBitmapController.h"
+#include "SkCanvas.h"
+#include "SkImage_Base.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkShader.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+#include "SkTaskGroup.h"
+
+namespace {
+
+// One bitmap we want decoded, at the filter quality and (inverse) CTM it will be drawn with.
+struct DecodeRequest {
+    SkBitmap        fBitmap;
+    SkMatrix        fInverse;
+    SkFilterQuality fQuality;
+};
+
+// Identifies a DecodeRequest well enough to skip duplicates.  Only medium and high quality
+// depend on the draw scale.
+struct DecodeKey {
+    uint32_t fGenerationID;
+    int32_t  fQuality;
+    SkIPoint fOrigin;
+    SkISize  fSize;
+    SkScalar fInverse[4];
+
+    bool operator==(const DecodeKey& that) const { return 0 == memcmp(this, &that, sizeof(that)); }
+};
+
+// Plays back a picture, recording the lazy bitmaps it draws instead of drawing them.  Draws the
+// clip rejects are skipped, as they would be during real playback.
+class DecodeGatherCanvas : public SkCanvas {
+public:
+    DecodeGatherCanvas(int width, int height) : INHERITED(width, height) {}
+
+    SkTArray<DecodeRequest>& requests() { return fRequests; }
+
+protected:
+    void onDrawPaint(const SkPaint& paint) override {
+        this->addShader(paint);
+    }
+    void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+        if (!this->quickReject(rect)) { this->addShader(paint); }
+    }
+    void onDrawOval(const SkRect& oval, const SkPaint& paint) override {
+        if (!this->quickReject(oval)) { this->addShader(paint); }
+    }
+    void onDrawRRect(const SkRRect& rrect, const SkPaint& paint) override {
+        if (!this->quickReject(rrect.getBounds())) { this->addShader(paint); }
+    }
+    void onDrawDRRect(const SkRRect& outer, const SkRRect&, const SkPaint& paint) override {
+        if (!this->quickReject(outer.getBounds())) { this->addShader(paint); }
+    }
+    void onDrawPath(const SkPath& path, const SkPaint& paint) override {
+        if (path.isInverseFillType() || !this->quickReject(path.getBounds())) {
+            this->addShader(paint);
+        }
+    }
+    void onDrawVertices(VertexMode, int, const SkPoint[], const SkPoint texs[], const SkColor[],
+                        SkXfermode*, const uint16_t[], int, const SkPaint& paint) override {
+        if (texs) { this->addShader(paint); }
+    }
+
+    void onDrawBitmap(const SkBitmap& bitmap, SkScalar x, SkScalar y,
+                      const SkPaint* paint) override {
+        const SkRect dst = SkRect::MakeXYWH(x, y, SkIntToScalar(bitmap.width()),
+                                                  SkIntToScalar(bitmap.height()));
+        this->addRect(bitmap, NULL, dst, paint);
+    }
+    void onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, const SkRect& dst,
+                          const SkPaint* paint, SrcRectConstraint) override {
+        this->addRect(bitmap, src, dst, paint);
+    }
+    void onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect&, const SkRect& dst,
+                          const SkPaint* paint) override {
+        // The nine patches each scale differently; the unscaled corners are the common case.
+        if (!this->quickReject(dst)) { this->add(bitmap, SkMatrix::I(), paint); }
+    }
+    void onDrawSprite(const SkBitmap& bitmap, int, int, const SkPaint*) override {
+        // Sprites ignore the CTM and are never filtered.
+        if (is_lazy(bitmap)) {
+            DecodeRequest* request = &fRequests.push_back();
+            request->fBitmap = bitmap;
+            request->fInverse.reset();
+            request->fQuality = kNone_SkFilterQuality;
+        }
+    }
+
+    void onDrawImage(const SkImage* image, SkScalar x, SkScalar y, const SkPaint* paint) override {
+        SkBitmap bitmap;
+        if (get_bitmap(image, &bitmap)) { this->onDrawBitmap(bitmap, x, y, paint); }
+    }
+    void onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst,
+                         const SkPaint* paint, SrcRectConstraint) override {
+        SkBitmap bitmap;
+        if (get_bitmap(image, &bitmap)) { this->addRect(bitmap, src, dst, paint); }
+    }
+    void onDrawImageNine(const SkImage* image, const SkIRect& center, const SkRect& dst,
+                         const SkPaint* paint) override {
+        SkBitmap bitmap;
+        if (get_bitmap(image, &bitmap)) { this->onDrawBitmapNine(bitmap, center, dst, paint); }
+    }
+    void onDrawAtlas(const SkImage* image, const SkRSXform[], const SkRect[], const SkColor[],
+                     int, SkXfermode::Mode, const SkRect* cull, const SkPaint* paint) override {
+        SkBitmap bitmap;
+        if ((!cull || !this->quickReject(*cull)) && get_bitmap(image, &bitmap)) {
+            this->add(bitmap, SkMatrix::I(), paint);
+        }
+    }
+
+    // Text draws no bitmaps we can predecode.
+    void onDrawText(const void*, size_t, SkScalar, SkScalar, const SkPaint&) override {}
+    void onDrawPosText(const void*, size_t, const SkPoint[], const SkPaint&) override {}
+    void onDrawPosTextH(const void*, size_t, const SkScalar[], SkScalar,
+                        const SkPaint&) override {}
+    void onDrawTextOnPath(const void*, size_t, const SkPath&, const SkMatrix*,
+                          const SkPaint&) override {}
+    void onDrawTextBlob(const SkTextBlob*, SkScalar, SkScalar, const SkPaint&) override {}
+    void onDrawPoints(PointMode, size_t, const SkPoint[], const SkPaint&) override {}
+    void onDrawPatch(const SkPoint[12], const SkColor[4], const SkPoint[4], SkXfermode*,
+                     const SkPaint&) override {}
+
+private:
+    // A bitmap whose pixels aren't there until it's locked is one a generator decodes lazily.
+    static bool is_lazy(const SkBitmap& bitmap) {
+        return bitmap.pixelRef() && NULL == bitmap.getPixels() && !bitmap.drawsNothing();
+    }
+
+    static bool get_bitmap(const SkImage* image, SkBitmap* bitmap) {
+        // Texture-backed images have nothing to decode, and reading them back would be a waste.
+        return !image->isTextureBacked() && as_IB(image)->getROPixels(bitmap);
+    }
+
+    void addRect(const SkBitmap& bitmap, const SkRect* src, const SkRect& dst,
+                 const SkPaint* paint) {
+        if (this->quickReject(dst)) {
+            return;
+        }
+        const SkRect bounds = SkRect::MakeIWH(bitmap.width(), bitmap.height());
+        SkMatrix local;
+        local.setRectToRect(src ? *src : bounds, dst, SkMatrix::kFill_ScaleToFit);
+        this->add(bitmap, local, paint);
+    }
+
+    void addShader(const SkPaint& paint) {
+        SkBitmap bitmap;
+        SkMatrix local;
+        SkShader::TileMode xy[2];
+        if (paint.getShader() &&
+            SkShader::kDefault_BitmapType == paint.getShader()->asABitmap(&bitmap, &local, xy)) {
+            this->add(bitmap, local, &paint);
+        }
+    }
+
+    void add(const SkBitmap& bitmap, const SkMatrix& local, const SkPaint* paint) {
+        if (!is_lazy(bitmap)) {
+            return;
+        }
+        SkMatrix matrix, inverse;
+        matrix.setConcat(this->getTotalMatrix(), local);
+        if (!matrix.invert(&inverse)) {
+            return;
+        }
+        const SkFilterQuality quality = paint ? paint->getFilterQuality() : kNone_SkFilterQuality;
+
+        DecodeKey key;
+        sk_bzero(&key, sizeof(key));
+        key.fGenerationID = bitmap.getGenerationID();
+        key.fQuality      = quality;
+        key.fOrigin       = bitmap.pixelRefOrigin();
+        key.fSize         = bitmap.dimensions();
+        if (quality >= kMedium_SkFilterQuality) {
+            key.fInverse[0] = inverse.getScaleX();
+            key.fInverse[1] = inverse.getSkewX();
+            key.fInverse[2] = inverse.getSkewY();
+            key.fInverse[3] = inverse.getScaleY();
+        }
+        if (fSeen.contains(key)) {
+            return;
+        }
+        fSeen.add(key);
+
+        DecodeRequest* request = &fRequests.push_back();
+        request->fBitmap  = bitmap;
+        request->fInverse = inverse;
+        request->fQuality = quality;
+    }
+
+    SkTArray<DecodeRequest> fRequests;
+    SkTHashSet<DecodeKey>   fSeen;
+
+    typedef SkCanvas INHERITED;
+};
+
+} // namespace
+
+void SkPictureUtils::PredecodeImages(const SkPicture* picture, const SkMatrix& matrix,
+                                     const SkIRect* deviceClip) {
+    if (!picture || !picture->willPlayBackBitmaps()) {
+        return;
+    }
+    SkIRect clip;
+    if (deviceClip) {
+        clip = *deviceClip;
+    } else {
+        SkRect bounds;
+        matrix.mapRect(&bounds, picture->cullRect());
+        bounds.roundOut(&clip);
+    }
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    DecodeGatherCanvas canvas(clip.width(), clip.height());
+    canvas.translate(-SkIntToScalar(clip.left()), -SkIntToScalar(clip.top()));
+    canvas.concat(matrix);
+    picture->playback(&canvas);
+
+    // This is exactly what SkBitmapProcState asks for at draw time, so it warms the same
+    // discardable memory, mipmap and scaled-bitmap cache entries playback will look up.
+    SkTArray<DecodeRequest>& requests = canvas.requests();
+    sk_parallel_for(requests.count(), [&](int i) {
+        const DecodeRequest& request = requests[i];
+        SkDefaultBitmapController controller;
+        SkAutoTDelete<SkBitmapController::State> state(
+                controller.requestBitmap(request.fBitmap, request.fInverse, request.fQuality));
+    });
+}
@@ -0,0 +1,310 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRingBufferTracer.h"
+
+#include "SkAtomics.h"
+#include "SkMutex.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include "SkTraceEventCommon.h"
+
+#include <chrono>
+
+static uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+namespace {
+
+static const int kMaxArgs = 2;
+
+struct Event {
+    const char* fName;
+    const uint8_t* fCategory;
+    uint64_t fBeginNs;
+    uint64_t fEndNs;            // Only meaningful for complete ('X') events, 0 while open.
+    char fPhase;
+    uint8_t fNumArgs;
+    uint8_t fArgTypes[kMaxArgs];
+    const char* fArgNames[kMaxArgs];
+    uint64_t fArgValues[kMaxArgs];
+};
+
+// Each thread caches the buffer it writes into. The tracer ID guards against the cached buffer
+// belonging to a different (possibly deleted) tracer.
+#if defined(_MSC_VER)
+    static __declspec(thread) SkRingBufferTracer::ThreadBuffer* gThreadBuffer;
+    static __declspec(thread) int32_t gThreadBufferTracerID;
+#else
+    static __thread SkRingBufferTracer::ThreadBuffer* gThreadBuffer;
+    static __thread int32_t gThreadBufferTracerID;
+#endif
+
+static int32_t gNextTracerID = 1;
+
+static const int kMaxCategories = 64;
+
+}  // namespace
+
+struct SkRingBufferTracer::ThreadBuffer {
+    ThreadBuffer(int capacity, int tid, const void* owner)
+        : fEvents(capacity), fCapacity(capacity), fTID(tid), fOwner(owner) {
+        fWritten.store(0);
+    }
+
+    SkAutoTArray<Event> fEvents;
+    const int fCapacity;
+    const int fTID;
+    // Identifies the thread that writes to this buffer; the address of its gThreadBuffer.
+    const void* fOwner;
+    // Total number of events ever started in this buffer. Only the owning thread writes it.
+    SkAtomic<uint64_t> fWritten;
+};
+
+struct SkRingBufferTracer::Impl {
+    explicit Impl(int eventsPerThread)
+        : fEventsPerThread(eventsPerThread)
+        , fID(sk_atomic_inc(&gNextTracerID))
+        , fCategoryCount(0)
+        , fEnabled(false) {
+        sk_bzero(fCategoryFlags, sizeof(fCategoryFlags));
+        fOverflowFlag = 0;
+    }
+
+    ~Impl() { fBuffers.deleteAll(); }
+
+    const int fEventsPerThread;
+    const int32_t fID;
+
+    // Guards fBuffers, fCategoryNames and fCategoryCount, but not the flags themselves, which
+    // the TRACE_EVENT macros read without locking.
+    mutable SkMutex fMutex;
+    SkTDArray<ThreadBuffer*> fBuffers;
+    const char* fCategoryNames[kMaxCategories];
+    uint8_t fCategoryFlags[kMaxCategories];
+    int fCategoryCount;
+    // Handed out once the category table is full, and never enabled.
+    uint8_t fOverflowFlag;
+    bool fEnabled;
+};
+
+SkRingBufferTracer::SkRingBufferTracer(int eventsPerThread)
+    : fImpl(SkNEW_ARGS(Impl, (SkTMax(eventsPerThread, 1)))) {}
+
+SkRingBufferTracer::~SkRingBufferTracer() {
+    SkDELETE(fImpl);
+}
+
+void SkRingBufferTracer::setEnabled(bool enabled) {
+    SkAutoMutexAcquire lock(fImpl->fMutex);
+    fImpl->fEnabled = enabled;
+    uint8_t flag = enabled ? kEnabledForRecording_CategoryGroupEnabledFlags : 0;
+    for (int i = 0; i < fImpl->fCategoryCount; ++i) {
+        sk_atomic_store(&fImpl->fCategoryFlags[i], flag, sk_memory_order_relaxed);
+    }
+}
+
+bool SkRingBufferTracer::isEnabled() const {
+    SkAutoMutexAcquire lock(fImpl->fMutex);
+    return fImpl->fEnabled;
+}
+
+const uint8_t* SkRingBufferTracer::getCategoryGroupEnabled(const char* name) {
+    // The macros cache the returned pointer per call site, so this is rarely called.
+    SkAutoMutexAcquire lock(fImpl->fMutex);
+    for (int i = 0; i < fImpl->fCategoryCount; ++i) {
+        if (0 == strcmp(fImpl->fCategoryNames[i], name)) {
+            return &fImpl->fCategoryFlags[i];
+        }
+    }
+    if (fImpl->fCategoryCount == kMaxCategories) {
+        SkDEBUGF(("SkRingBufferTracer: too many categories, ignoring %s\n", name));
+        return &fImpl->fOverflowFlag;
+    }
+    int index = fImpl->fCategoryCount++;
+    fImpl->fCategoryNames[index] = name;
+    fImpl->fCategoryFlags[index] = fImpl->fEnabled ? kEnabledForRecording_CategoryGroupEnabledFlags
+                                                   : 0;
+    return &fImpl->fCategoryFlags[index];
+}
+
+const char* SkRingBufferTracer::getCategoryGroupName(const uint8_t* categoryEnabledFlag) {
+    ptrdiff_t index = categoryEnabledFlag - fImpl->fCategoryFlags;
+    if (index >= 0 && index < kMaxCategories) {
+        SkAutoMutexAcquire lock(fImpl->fMutex);
+        if (index < fImpl->fCategoryCount) {
+            return fImpl->fCategoryNames[index];
+        }
+    }
+    return "overflow";
+}
+
+SkRingBufferTracer::ThreadBuffer* SkRingBufferTracer::threadBuffer() {
+    if (gThreadBufferTracerID == fImpl->fID) {
+        return gThreadBuffer;
+    }
+
+    // First event from this thread, or this thread last recorded into another tracer.
+    const void* owner = &gThreadBuffer;
+    ThreadBuffer* buffer = NULL;
+    SkAutoMutexAcquire lock(fImpl->fMutex);
+    for (int i = 0; i < fImpl->fBuffers.count(); ++i) {
+        if (fImpl->fBuffers[i]->fOwner == owner) {
+            buffer = fImpl->fBuffers[i];
+            break;
+        }
+    }
+    if (!buffer) {
+        buffer = SkNEW_ARGS(ThreadBuffer, (fImpl->fEventsPerThread, fImpl->fBuffers.count() + 1,
+                                           owner));
+        fImpl->fBuffers.push(buffer);
+    }
+    gThreadBuffer = buffer;
+    gThreadBufferTracerID = fImpl->fID;
+    return buffer;
+}
+
+SkEventTracer::Handle SkRingBufferTracer::addTraceEvent(char phase,
+                                                        const uint8_t* categoryEnabledFlag,
+                                                        const char* name,
+                                                        uint64_t id,
+                                                        int32_t numArgs,
+                                                        const char** argNames,
+                                                        const uint8_t* argTypes,
+                                                        const uint64_t* argValues,
+                                                        uint8_t flags) {
+    if (flags & TRACE_EVENT_FLAG_COPY) {
+        return 0;
+    }
+    ThreadBuffer* buffer = this->threadBuffer();
+    uint64_t index = buffer->fWritten.load(sk_memory_order_relaxed);
+    Event& event = buffer->fEvents[static_cast<int>(index % buffer->fCapacity)];
+    event.fName = name;
+    event.fCategory = categoryEnabledFlag;
+    event.fBeginNs = now_ns();
+    event.fEndNs = 0;
+    event.fPhase = phase;
+    event.fNumArgs = 0;
+    for (int i = 0; i < numArgs && i < kMaxArgs; ++i) {
+        if (TRACE_VALUE_TYPE_COPY_STRING == argTypes[i] ||
+            TRACE_VALUE_TYPE_CONVERTABLE == argTypes[i]) {
+            continue;
+        }
+        event.fArgNames[event.fNumArgs] = argNames[i];
+        event.fArgTypes[event.fNumArgs] = argTypes[i];
+        event.fArgValues[event.fNumArgs] = argValues[i];
+        event.fNumArgs++;
+    }
+    buffer->fWritten.store(index + 1, sk_memory_order_release);
+    return index + 1;
+}
+
+void SkRingBufferTracer::updateTraceEventDuration(const uint8_t* categoryEnabledFlag,
+                                                  const char* name,
+                                                  SkEventTracer::Handle handle) {
+    if (0 == handle) {
+        return;
+    }
+    // Scoped events end on the thread that began them.
+    ThreadBuffer* buffer = this->threadBuffer();
+    uint64_t index = handle - 1;
+    if (buffer->fWritten.load(sk_memory_order_relaxed) - index > (uint64_t)buffer->fCapacity) {
+        return;  // Already overwritten by newer events.
+    }
+    Event& event = buffer->fEvents[static_cast<int>(index % buffer->fCapacity)];
+    SkASSERT(event.fName == name);
+    event.fEndNs = now_ns();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void append_json_string(SkString* out, const char* str) {
+    out->append("\"");
+    for (const char* c = str; *c; ++c) {
+        if ('"' == *c || '\\' == *c) {
+            out->appendf("\\%c", *c);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            out->appendf("\\u%04x", *c);
+        } else {
+            out->append(c, 1);
+        }
+    }
+    out->append("\"");
+}
+
+static void append_arg_value(SkString* out, uint8_t type, uint64_t value) {
+    union {
+        uint64_t u;
+        int64_t i;
+        double d;
+        const void* p;
+        const char* s;
+    } v;
+    v.u = value;
+    switch (type) {
+        case TRACE_VALUE_TYPE_BOOL:    out->append(v.u ? "true" : "false");     break;
+        case TRACE_VALUE_TYPE_UINT:    out->appendf("%llu", (unsigned long long)v.u); break;
+        case TRACE_VALUE_TYPE_INT:     out->appendf("%lld", (long long)v.i);    break;
+        case TRACE_VALUE_TYPE_DOUBLE:  out->appendf("%g", v.d);                 break;
+        case TRACE_VALUE_TYPE_POINTER: out->appendf("\"%p\"", v.p);             break;
+        case TRACE_VALUE_TYPE_STRING:  append_json_string(out, v.s ? v.s : ""); break;
+        default:                       out->append("null");                     break;
+    }
+}
+
+void SkRingBufferTracer::dumpJSON(SkWStream* stream) const {
+    stream->writeText("{\"traceEvents\":[");
+    bool first = true;
+
+    SkAutoMutexAcquire lock(fImpl->fMutex);
+    SkString line;
+    for (int b = 0; b < fImpl->fBuffers.count(); ++b) {
+        const ThreadBuffer* buffer = fImpl->fBuffers[b];
+        uint64_t written = buffer->fWritten.load(sk_memory_order_acquire);
+        uint64_t start = written > (uint64_t)buffer->fCapacity ? written - buffer->fCapacity : 0;
+        for (uint64_t i = start; i < written; ++i) {
+            const Event& event = buffer->fEvents[static_cast<int>(i % buffer->fCapacity)];
+            if (TRACE_EVENT_PHASE_COMPLETE == event.fPhase && 0 == event.fEndNs) {
+                continue;  // Still open.
+            }
+            line.reset();
+            line.append(first ? "\n{" : ",\n{");
+            first = false;
+
+            line.append("\"name\":");
+            append_json_string(&line, event.fName);
+            line.append(",\"cat\":");
+            ptrdiff_t category = event.fCategory - fImpl->fCategoryFlags;
+            append_json_string(&line, category >= 0 && category < fImpl->fCategoryCount
+                                      ? fImpl->fCategoryNames[category] : "overflow");
+            line.appendf(",\"ph\":\"%c\",\"pid\":0,\"tid\":%d,\"ts\":%.3f",
+                         event.fPhase, buffer->fTID, event.fBeginNs * 1e-3);
+            if (TRACE_EVENT_PHASE_COMPLETE == event.fPhase) {
+                line.appendf(",\"dur\":%.3f", (event.fEndNs - event.fBeginNs) * 1e-3);
+            }
+            if (event.fNumArgs > 0) {
+                line.append(",\"args\":{");
+                for (int a = 0; a < event.fNumArgs; ++a) {
+                    if (a > 0) {
+                        line.append(",");
+                    }
+                    append_json_string(&line, event.fArgNames[a]);
+                    line.append(":");
+                    append_arg_value(&line, event.fArgTypes[a], event.fArgValues[a]);
+                }
+                line.append("}");
+            }
+            line.append("}");
+            stream->write(line.c_str(), line.size());
+        }
+    }
+    stream->writeText("\n]}\n");
+}
@@ -12,9 +12,11 @@
 
 #include "SkBitmap.h"
 #include "SkBitmapProcShader.h"
+#include "SkColorPriv.h"
 #include "SkData.h"
 #include "SkEndian.h"
 #include "SkOpts.h"
+#include "SkTaskGroup.h"
 
 #ifndef SK_IGNORE_ETC1_SUPPORT
 #  include "etc1.h"
@@ -30,6 +32,64 @@ static bool compress_etc1_565(uint8_t* dst, const uint8_t* src,
 #endif
 }
 
+// ETC1 carries no alpha, so the N32 encoder drops it and the source should be opaque.
+static bool compress_etc1_n32(uint8_t* dst, const uint8_t* src,
+                              int width, int height, size_t rowBytes) {
+#ifndef SK_IGNORE_ETC1_SUPPORT
+    SkAutoTMalloc<uint8_t> rgb(width * height * 3);
+    uint8_t* rgbPtr = rgb.get();
+    for (int y = 0; y < height; ++y) {
+        const SkPMColor* row = reinterpret_cast<const SkPMColor*>(src + y * rowBytes);
+        for (int x = 0; x < width; ++x) {
+            *rgbPtr++ = SkGetPackedR32(row[x]);
+            *rgbPtr++ = SkGetPackedG32(row[x]);
+            *rgbPtr++ = SkGetPackedB32(row[x]);
+        }
+    }
+    return 0 == etc1_encode_image(rgb.get(), width, height, 3, width * 3, dst);
+#else
+    return false;
+#endif
+}
+
+// Each row of blocks compresses independently of the others, so large images are compressed
+// in bands of block rows on the task threads.
+static const int kMinParallelArea = 256 * 256;
+static const int kMinBlockRowsPerBand = 4;
+static const int kMaxBands = 16;
+
+static bool compress_in_bands(SkOpts::TextureCompressor proc, uint8_t* dst, const uint8_t* src,
+                              int width, int height, size_t rowBytes,
+                              SkTextureCompressor::Format format) {
+    int dimX, dimY;
+    SkTextureCompressor::GetBlockDimensions(format, &dimX, &dimY, true);
+    if (width * height < kMinParallelArea || (width % dimX) != 0 || (height % dimY) != 0) {
+        return proc(dst, src, width, height, rowBytes);
+    }
+
+    const int blockRows = height / dimY;
+    const int bandCount = SkTMin(kMaxBands, blockRows / kMinBlockRowsPerBand);
+    if (bandCount <= 1) {
+        return proc(dst, src, width, height, rowBytes);
+    }
+    const size_t dstBlockRowBytes = SkTextureCompressor::GetCompressedDataSize(format, width,
+                                                                               dimY);
+
+    bool succeeded[kMaxBands];
+    sk_parallel_for(bandCount, [&](int i) {
+        const int top = blockRows * i / bandCount;
+        const int bottom = blockRows * (i + 1) / bandCount;
+        succeeded[i] = proc(dst + top * dstBlockRowBytes, src + top * dimY * rowBytes,
+                            width, (bottom - top) * dimY, rowBytes);
+    });
+    for (int i = 0; i < bandCount; ++i) {
+        if (!succeeded[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace SkTextureCompressor {
@@ -121,7 +181,7 @@ int GetCompressedDataSize(Format fmt, int width, int height) {
 bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcColorType,
                             int width, int height, size_t rowBytes, Format format) {
     SkOpts::TextureCompressor proc = SkOpts::texture_compressor(srcColorType, format);
-    if (proc && proc(dst, src, width, height, rowBytes)) {
+    if (proc && compress_in_bands(proc, dst, src, width, height, rowBytes, format)) {
         return true;
     }
 
@@ -134,10 +194,13 @@ bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcCol
         case kRGB_565_SkColorType:
             if (format == kETC1_Format) { proc = compress_etc1_565; }
             break;
+        case kN32_SkColorType:
+            if (format == kETC1_Format) { proc = compress_etc1_n32; }
+            break;
         default:
             break;
     }
-    if (proc && proc(dst, src, width, height, rowBytes)) {
+    if (proc && compress_in_bands(proc, dst, src, width, height, rowBytes, format)) {
         return true;
     }
 
@@ -23,11 +23,8 @@ namespace SkTextureCompressor {
         kR11_EAC_Format,    // 4x4 blocks, (de)compresses A8
 
         // RGB only formats
-        kETC1_Format,       // 4x4 blocks, compresses RGB 565, decompresses 8-bit RGB
-                            //    NOTE: ETC1 supports 8-bit RGB compression, but we
-                            //    currently don't have any RGB8 SkColorTypes. We could
-                            //    support 8-bit RGBA but we would have to preprocess the
-                            //    bitmap to insert alphas.
+        kETC1_Format,       // 4x4 blocks, compresses RGB 565 and opaque N32 (alpha is
+                            //    dropped), decompresses 8-bit RGB
 
         // Multi-purpose formats
         kASTC_4x4_Format,   // 4x4 blocks, no compression, decompresses RGBA
@@ -63,6 +60,7 @@ namespace SkTextureCompressor {
     // Compresses the given src data into dst. The src data is assumed to be
     // large enough to hold width*height pixels. The dst data is expected to
     // be large enough to hold the compressed data according to the format.
+    // Large images are compressed on multiple threads when SkTaskGroup is enabled.
     bool CompressBufferToFormat(uint8_t* dst, const uint8_t* src, SkColorType srcColorType,
                                 int width, int height, size_t rowBytes, Format format);
 
@@ -30,9 +30,9 @@ void SkXMLWriter::addAttribute(const char name[], const char value[])
 
 void SkXMLWriter::addS32Attribute(const char name[], int32_t value)
 {
-    SkString    tmp;
-    tmp.appendS32(value);
-    this->addAttribute(name, tmp.c_str());
+    char    tmp[SkStrAppendS32_MaxSize];
+    char*   stop = SkStrAppendS32(tmp, value);
+    this->addAttributeLen(name, tmp, stop - tmp);
 }
 
 void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigits)
@@ -44,9 +44,9 @@ void SkXMLWriter::addHexAttribute(const char name[], uint32_t value, int minDigi
 
 void SkXMLWriter::addScalarAttribute(const char name[], SkScalar value)
 {
-    SkString    tmp;
-    tmp.appendScalar(value);
-    this->addAttribute(name, tmp.c_str());
+    char    tmp[SkStrAppendScalar_MaxSize];
+    char*   stop = SkStrAppendScalar(tmp, value);
+    this->addAttributeLen(name, tmp, stop - tmp);
 }
 
 void SkXMLWriter::addText(const char text[], size_t length) {
@@ -93,25 +93,15 @@ void SkXMLWriter::startElement(const char name[])
     this->startElementLen(name, strlen(name));
 }
 
-static const char* escape_char(char c, char storage[2])
+// Returns the entity that replaces c, or NULL if c needs no escaping.
+static const char* escape_char(char c)
 {
-    static const char* gEscapeChars[] = {
-        "<&lt;",
-        ">&gt;",
-        //"\"&quot;",
-        //"'&apos;",
-        "&&amp;"
-    };
-
-    const char** array = gEscapeChars;
-    for (unsigned i = 0; i < SK_ARRAY_COUNT(gEscapeChars); i++)
-    {
-        if (array[i][0] == c)
-            return &array[i][1];
+    switch (c) {
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        case '&': return "&amp;";
+        default:  return NULL;
     }
-    storage[0] = c;
-    storage[1] = 0;
-    return storage;
 }
 
 static size_t escape_markup(char dst[], const char src[], size_t length)
@@ -121,18 +111,23 @@ static size_t escape_markup(char dst[], const char src[], size_t length)
 
     while (src < stop)
     {
-        char        orig[2];
-        const char* seq = escape_char(*src, orig);
-        size_t      seqSize = strlen(seq);
-
-        if (dst)
+        const char* seq = escape_char(*src);
+        if (NULL == seq)
         {
-            memcpy(dst, seq, seqSize);
-            dst += seqSize;
+            if (dst)
+                *dst++ = *src;
+        }
+        else
+        {
+            size_t  seqSize = strlen(seq);
+            if (dst)
+            {
+                memcpy(dst, seq, seqSize);
+                dst += seqSize;
+            }
+            // now record the extra size needed
+            extra += seqSize - 1;   // minus one to subtract the original char
         }
-
-        // now record the extra size needed
-        extra += seqSize - 1;   // minus one to subtract the original char
 
         // bump to the next src char
         src += 1;
@@ -421,6 +421,35 @@ static void test_regressions() {
     }
 }
 
+// setRect() skips the scan converter when it can, so check that it covers what the rect's path
+// would, with and without aa, for edges on and off pixel boundaries.
+static void test_rect_matches_path(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 1000; ++i) {
+        SkRect r = SkRect::MakeLTRB(rand.nextRangeScalar(-10, 40), rand.nextRangeScalar(-10, 40),
+                                    rand.nextRangeScalar(-10, 40), rand.nextRangeScalar(-10, 40));
+        r.sort();
+        if (i & 1) {
+            r.set(SkScalarRoundToScalar(r.fLeft), SkScalarRoundToScalar(r.fTop),
+                  SkScalarRoundToScalar(r.fRight), SkScalarRoundToScalar(r.fBottom));
+        }
+        SkPath path;
+        path.addRect(r);
+        for (int doAA = 0; doAA < 2; ++doAA) {
+            SkAAClip clip, pathClip;
+            clip.setRect(r, SkToBool(doAA));
+            pathClip.setPath(path, NULL, SkToBool(doAA));
+
+            SkMask mask, pathMask;
+            clip.copyToMask(&mask);
+            pathClip.copyToMask(&pathMask);
+            REPORTER_ASSERT(reporter, mask == pathMask);
+            SkMask::FreeImage(mask.fImage);
+            SkMask::FreeImage(pathMask.fImage);
+        }
+    }
+}
+
 // Building aaclip meant aa-scan-convert a path into a huge clip.
 // the old algorithm sized the supersampler to the size of the clip, which overflowed
 // its internal 16bit coordinates. The fix was to intersect the clip+path_bounds before
@@ -445,4 +474,5 @@ DEF_TEST(AAClip, reporter) {
     test_nearly_integral(reporter);
     test_really_a_rect(reporter);
     test_crbug_422693(reporter);
+    test_rect_matches_path(reporter);
 }
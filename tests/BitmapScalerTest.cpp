@@ -0,0 +1,60 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkBitmapScaler.h"
+#include "SkColorPriv.h"
+#include "Test.h"
+
+static SkPMColor src_color(int x, int y) {
+    return SkPackARGB32(0xFF, y & 0xFF, (y * 3) & 0xFF, (x * 4) & 0xFF);
+}
+
+// A 2x box filtered downscale has an exact answer. The image is tall enough to be convolved in
+// several bands, and every filter has the same factors, so this covers both the banding and the
+// sharing of periodic filter factors.
+DEF_TEST(BitmapScaler_BoxDownscale, reporter) {
+    const int kSrcW = 64, kSrcH = 2048;
+    SkBitmap src;
+    src.allocN32Pixels(kSrcW, kSrcH, true);
+    for (int y = 0; y < kSrcH; ++y) {
+        for (int x = 0; x < kSrcW; ++x) {
+            *src.getAddr32(x, y) = src_color(x, y);
+        }
+    }
+    SkAutoPixmapUnlock unlocker;
+    REPORTER_ASSERT(reporter, src.requestLock(&unlocker));
+
+    SkBitmap dst;
+    REPORTER_ASSERT(reporter, SkBitmapScaler::Resize(&dst, unlocker.pixmap(),
+                                                     SkBitmapScaler::RESIZE_BOX,
+                                                     kSrcW / 2, kSrcH / 2));
+    REPORTER_ASSERT(reporter, dst.width() == kSrcW / 2 && dst.height() == kSrcH / 2);
+
+    SkAutoLockPixels alp(dst);
+    for (int y = 0; y < dst.height(); ++y) {
+        for (int x = 0; x < dst.width(); ++x) {
+            SkPMColor c = *dst.getAddr32(x, y);
+            SkPMColor s[] = {
+                src_color(2*x, 2*y),   src_color(2*x + 1, 2*y),
+                src_color(2*x, 2*y+1), src_color(2*x + 1, 2*y + 1),
+            };
+            int r = 0, g = 0, b = 0;
+            for (int i = 0; i < 4; ++i) {
+                r += SkGetPackedR32(s[i]);
+                g += SkGetPackedG32(s[i]);
+                b += SkGetPackedB32(s[i]);
+            }
+            if (SkTAbs(4 * (int)SkGetPackedR32(c) - r) > 4 ||
+                SkTAbs(4 * (int)SkGetPackedG32(c) - g) > 4 ||
+                SkTAbs(4 * (int)SkGetPackedB32(c) - b) > 4) {
+                ERRORF(reporter, "pixel (%d, %d) is %08x", x, y, c);
+                return;
+            }
+        }
+    }
+}
@@ -8,6 +8,7 @@
 #include "Test.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkRandom.h"
 #include "SkTaskGroup.h"
 #include "SkXfermode.h"
 
@@ -299,3 +300,40 @@ DEF_TEST(Blend_premul_begets_premul, r) {
     // Parallelism helps speed things up on my desktop from ~725s to ~50s.
     sk_parallel_for(SkXfermode::kLastMode, test_mode);
 }
+
+// An A8 dst must end up with the alpha the mode gives a 32-bit dst, with and without coverage,
+// however many pixels are blended at once.
+DEF_TEST(Blend_xferA8, r) {
+    SkRandom rand;
+    const int kCount = 11;
+    SkPMColor src[kCount], dst32[kCount];
+    SkAlpha dstA8[kCount], aa[kCount];
+    for (int m = 0; m <= SkXfermode::kLastSeparableMode; m++) {
+        SkXfermode::Mode mode = (SkXfermode::Mode)m;
+        SkAutoTUnref<SkXfermode> xfermode(SkXfermode::Create(mode));
+        if (!xfermode) {
+            continue;  // SrcOver
+        }
+        for (int count = 1; count <= kCount; count++) {
+            for (int useAA = 0; useAA < 2; useAA++) {
+                for (int i = 0; i < count; i++) {
+                    const U8CPU sa = rand.nextU() & 0xFF;
+                    src[i] = SkPackARGB32(sa, rand.nextULessThan(sa + 1),
+                                          rand.nextULessThan(sa + 1), rand.nextULessThan(sa + 1));
+                    dstA8[i] = rand.nextU() & 0xFF;
+                    dst32[i] = SkPackARGB32(dstA8[i], 0, 0, 0);
+                    aa[i] = rand.nextU() & 0xFF;
+                }
+                const SkAlpha* coverage = useAA ? aa : nullptr;
+                xfermode->xfer32(dst32, src, count, coverage);
+                xfermode->xferA8(dstA8, src, count, coverage);
+                for (int i = 0; i < count; i++) {
+                    if (SkGetPackedA32(dst32[i]) != dstA8[i]) {
+                        ERRORF(r, "%s: A8 alpha %02x, 32-bit alpha %02x",
+                               SkXfermode::ModeName(mode), dstA8[i], SkGetPackedA32(dst32[i]));
+                    }
+                }
+            }
+        }
+    }
+}
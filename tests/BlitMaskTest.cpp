@@ -0,0 +1,67 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBlitMask.h"
+#include "SkColorPriv.h"
+#include "SkRandom.h"
+#include "Test.h"
+
+// Fills mask with runs of zero, full and random coverage of random lengths.
+static void make_runs_mask(SkRandom* rand, uint8_t mask[], int count) {
+    int i = 0;
+    while (i < count) {
+        int run = SkTMin(count - i, (int)rand->nextRangeU(1, 40));
+        int kind = rand->nextULessThan(3);
+        for (int j = 0; j < run; ++j) {
+            mask[i + j] = 0 == kind ? 0 : 1 == kind ? 0xFF : (uint8_t)rand->nextU();
+        }
+        i += run;
+    }
+}
+
+// Blitting a whole mask must match blitting it one pixel at a time, however its coverage runs
+// line up with the pixels.
+DEF_TEST(BlitMask_A8Runs, reporter) {
+    static const SkColor kColors[] = { SK_ColorBLACK, 0xFF4080C0, 0x804080C0, 0x00FFFFFF };
+    static const int kWidth = 123;
+    static const int kHeight = 3;
+
+    SkRandom rand;
+    for (size_t c = 0; c < SK_ARRAY_COUNT(kColors); ++c) {
+        SkBlitMask::ColorProc proc = SkBlitMask::ColorFactory(kN32_SkColorType,
+                                                              SkMask::kA8_Format, kColors[c]);
+        REPORTER_ASSERT(reporter, proc);
+        if (!proc) {
+            continue;
+        }
+        for (int offset = 0; offset < 4; ++offset) {
+            uint8_t mask[kHeight][kWidth];
+            SkPMColor dst[kHeight][kWidth + 4];
+            SkPMColor expected[kHeight][kWidth + 4];
+            for (int y = 0; y < kHeight; ++y) {
+                make_runs_mask(&rand, mask[y], kWidth);
+                for (int x = 0; x < kWidth + 4; ++x) {
+                    unsigned a = rand.nextU() & 0xFF;
+                    dst[y][x] = expected[y][x] = SkPackARGB32(a, rand.nextULessThan(a + 1),
+                                                              rand.nextULessThan(a + 1),
+                                                              rand.nextULessThan(a + 1));
+                }
+            }
+
+            int width = kWidth - offset;
+            proc(&dst[0][offset], sizeof(dst[0]), mask, sizeof(mask[0]), kColors[c],
+                 width, kHeight);
+            for (int y = 0; y < kHeight; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    proc(&expected[y][offset + x], sizeof(SkPMColor), &mask[y][x], 1,
+                         kColors[c], 1, 1);
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == memcmp(dst, expected, sizeof(dst)));
+        }
+    }
+}
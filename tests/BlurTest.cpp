@@ -14,6 +14,7 @@
 #include "SkMath.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 #if SK_SUPPORT_GPU
@@ -565,10 +566,88 @@ static void test_asABlur(skiatest::Reporter* reporter) {
     }
 }
 
+// One box blur pass of radius r along a line of count values read every stride bytes, growing
+// the line by r at each end and rounding like SkBlurMask::BoxBlur.
+static void box_blur_1d(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride,
+                        int count, int r) {
+    const uint32_t scale = (1 << 24) / (2 * r + 1);
+    for (int j = 0; j < count + 2 * r; ++j) {
+        uint32_t sum = 0;
+        for (int k = SkTMax(j - 2 * r, 0); k <= SkTMin(j, count - 1); ++k) {
+            sum += src[k * srcStride];
+        }
+        dst[j * dstStride] = (sum * scale + (1 << 23)) >> 24;
+    }
+}
+
+// Checks BoxBlur against a brute force blur for sigmas whose box radius is an integer, on masks
+// both narrower than the kernel and wider than the strips it blurs columns in.
+static void test_box_blur(skiatest::Reporter* reporter) {
+    static const struct {
+        SkScalar      fSigma;
+        SkBlurQuality fQuality;
+        int           fRadius;
+        int           fPasses;
+    } gBlurs[] = {
+        { 3,              kLow_SkBlurQuality,  4, 1 },
+        { 3 + 1 / 6.0f,   kHigh_SkBlurQuality, 3, 3 },
+    };
+    static const SkISize gSizes[] = {
+        { 5, 70 }, { 37, 3 }, { 600, 9 },
+    };
+
+    SkRandom rand;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gBlurs); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(gSizes); ++j) {
+            SkMask src;
+            src.fBounds.set(0, 0, gSizes[j].width(), gSizes[j].height());
+            src.fFormat = SkMask::kA8_Format;
+            src.fRowBytes = src.fBounds.width();
+            SkAutoMaskFreeImage srcImage(src.fImage = SkMask::AllocImage(src.computeImageSize()));
+            for (size_t k = 0; k < src.computeImageSize(); ++k) {
+                src.fImage[k] = rand.nextU() & 0xFF;
+            }
+
+            // Blur the rows, then the columns, of a copy padded out to the final size.
+            const int pad = gBlurs[i].fRadius * gBlurs[i].fPasses;
+            const int w = src.fBounds.width() + 2 * pad,
+                      h = src.fBounds.height() + 2 * pad;
+            SkAutoTMalloc<uint8_t> expected(w * h), tmp(w * h);
+            int lineW = src.fBounds.width(), lineH = src.fBounds.height();
+            for (int y = 0; y < lineH; ++y) {
+                memcpy(expected.get() + y * w, src.fImage + y * src.fRowBytes, lineW);
+            }
+            for (int pass = 0; pass < gBlurs[i].fPasses; ++pass, lineW += 2 * gBlurs[i].fRadius) {
+                for (int y = 0; y < lineH; ++y) {
+                    box_blur_1d(expected.get() + y * w, 1, tmp.get() + y * w, 1,
+                                lineW, gBlurs[i].fRadius);
+                }
+                memcpy(expected.get(), tmp.get(), w * h);
+            }
+            for (int pass = 0; pass < gBlurs[i].fPasses; ++pass, lineH += 2 * gBlurs[i].fRadius) {
+                for (int x = 0; x < w; ++x) {
+                    box_blur_1d(expected.get() + x, w, tmp.get() + x, w,
+                                lineH, gBlurs[i].fRadius);
+                }
+                memcpy(expected.get(), tmp.get(), w * h);
+            }
+
+            SkMask dst;
+            REPORTER_ASSERT(reporter, SkBlurMask::BoxBlur(&dst, src, gBlurs[i].fSigma,
+                                                          kNormal_SkBlurStyle,
+                                                          gBlurs[i].fQuality));
+            SkAutoMaskFreeImage dstImage(dst.fImage);
+            REPORTER_ASSERT(reporter, dst.fBounds.width() == w && dst.fBounds.height() == h);
+            REPORTER_ASSERT(reporter, 0 == memcmp(dst.fImage, expected.get(), w * h));
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 DEF_GPUTEST(Blur, reporter, factory) {
     test_blur_drawing(reporter);
     test_sigma_range(reporter, factory);
     test_asABlur(reporter);
+    test_box_blur(reporter);
 }
@@ -44,3 +44,51 @@ static void test_c(skiatest::Reporter* reporter) {
 DEF_TEST(C_API, reporter) {
     test_c(reporter);
 }
+
+DEF_TEST(C_API_Execute, reporter) {
+    sk_imageinfo_t info = {
+        2, 1, sk_colortype_get_default_8888(), PREMUL_SK_ALPHATYPE
+    };
+    uint32_t pixels[2] = { 0, 0 };
+    sk_surfaceprops_t surfaceProps = { UNKNOWN_SK_PIXELGEOMETRY };
+    sk_surface_t* surface = sk_surface_new_raster_direct(&info, pixels, sizeof(pixels),
+                                                         &surfaceProps);
+    sk_canvas_t* canvas = sk_surface_get_canvas(surface);
+
+    sk_paint_t* white = sk_paint_new();
+    sk_paint_set_color(white, sk_color_set_argb(0xFF, 0xFF, 0xFF, 0xFF));
+    sk_paint_t* black = sk_paint_new();
+    const sk_paint_t* paints[] = { black, white };
+    sk_canvas_handles_t handles = { paints, 2, NULL, 0, NULL, 0 };
+
+    // Fill with black, then draw white over the right-hand pixel only.
+    union {
+        uint32_t u;
+        float f;
+    } ops[] = {
+        { DRAW_PAINT_SK_CANVAS_OP }, { 0 },
+        { SAVE_SK_CANVAS_OP },
+        { TRANSLATE_SK_CANVAS_OP }, { 0 }, { 0 },
+        { DRAW_RECT_SK_CANVAS_OP }, { 0 }, { 0 }, { 0 }, { 0 }, { 1 },
+        { RESTORE_SK_CANVAS_OP },
+    };
+    ops[4].f = 1;
+    ops[9].f = ops[10].f = 1;
+    REPORTER_ASSERT(reporter, sk_canvas_execute(canvas, ops, sizeof(ops), &handles));
+    REPORTER_ASSERT(reporter, 0xFF000000 == pixels[0]);
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[1]);
+
+    // Bad indices, truncated ops and unknown opcodes all stop execution.
+    uint32_t badPaint[] = { DRAW_PAINT_SK_CANVAS_OP, 2 };
+    REPORTER_ASSERT(reporter, !sk_canvas_execute(canvas, badPaint, sizeof(badPaint), &handles));
+    uint32_t truncated[] = { DRAW_PAINT_SK_CANVAS_OP, 1, TRANSLATE_SK_CANVAS_OP };
+    REPORTER_ASSERT(reporter, !sk_canvas_execute(canvas, truncated, sizeof(truncated), &handles));
+    REPORTER_ASSERT(reporter, 0xFFFFFFFF == pixels[0]);
+    uint32_t unknown[] = { 0xBAD };
+    REPORTER_ASSERT(reporter, !sk_canvas_execute(canvas, unknown, sizeof(unknown), &handles));
+    REPORTER_ASSERT(reporter, sk_canvas_execute(canvas, NULL, 0, &handles));
+
+    sk_paint_delete(black);
+    sk_paint_delete(white);
+    sk_surface_unref(surface);
+}
@@ -774,3 +774,38 @@ DEF_TEST(Canvas_ClipEmptyPath, reporter) {
     canvas.clipPath(path);  // should not assert here
     canvas.restore();
 }
+
+DEF_TEST(Canvas_NWayConcurrentPicture, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* recordingCanvas = recorder.beginRecording(SkRect::MakeWH(kWidth, kHeight));
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    recordingCanvas->drawRect(SkRect::MakeWH(1, 1), paint);
+    paint.setColor(SK_ColorBLUE);
+    recordingCanvas->drawRect(SkRect::MakeXYWH(1, 1, 1, 1), paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkBitmap expected;
+    createBitmap(&expected, SK_ColorWHITE);
+    SkCanvas(expected).drawPicture(picture);
+
+    const int kTargets = 3;
+    SkBitmap stores[kTargets];
+    SkAutoTUnref<SkCanvas> targets[kTargets];
+    SkNWayCanvas nWayCanvas(kWidth, kHeight);
+    nWayCanvas.setConcurrentPicturePlayback(true);
+    for (int i = 0; i < kTargets; ++i) {
+        createBitmap(&stores[i], SK_ColorWHITE);
+        targets[i].reset(SkNEW_ARGS(SkCanvas, (stores[i])));
+        nWayCanvas.addCanvas(targets[i]);
+    }
+    nWayCanvas.drawPicture(picture);
+
+    for (int i = 0; i < kTargets; ++i) {
+        for (int y = 0; y < kHeight; ++y) {
+            for (int x = 0; x < kWidth; ++x) {
+                REPORTER_ASSERT(reporter, *stores[i].getAddr32(x, y) == *expected.getAddr32(x, y));
+            }
+        }
+    }
+}
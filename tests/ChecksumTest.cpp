@@ -63,3 +63,32 @@ DEF_TEST(GoodHash, r) {
     // Tests SkString is correctly specialized.
     ASSERT(SkGoodHash(SkString("Hi")) == 55667557);
 }
+
+DEF_TEST(Checksum_Hash64, r) {
+    // Reference xxHash64 values.
+    ASSERT(SkChecksum::Hash64(NULL, 0) == 0xef46db3751d8e999ULL);
+    const char kText[] = "Nobody inspects the spammish repetition";
+    ASSERT(SkChecksum::Hash64(kText, strlen(kText)) == 0xfbcea83c8a378bf1ULL);
+
+    // Every length from 0 through a few stripes, at every alignment, should hash consistently,
+    // and changing any single byte should change the hash.
+    uint8_t data[128 + 8];
+    SkRandom rand;
+    for (size_t i = 0; i < SK_ARRAY_COUNT(data); ++i) {
+        data[i] = rand.nextU() & 0xFF;
+    }
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t bytes = 0; bytes <= 128; ++bytes) {
+            const uint8_t* p = data + offset;
+            const uint64_t hash = SkChecksum::Hash64(p, bytes);
+            uint8_t copy[128];
+            memcpy(copy, p, bytes);
+            ASSERT(hash == SkChecksum::Hash64(copy, bytes));
+            ASSERT(hash != SkChecksum::Hash64(copy, bytes, 1));
+            if (bytes > 0) {
+                copy[bytes - 1] ^= 0x01;
+                ASSERT(hash != SkChecksum::Hash64(copy, bytes));
+            }
+        }
+    }
+}
@@ -190,6 +190,12 @@ static void test_cache(skiatest::Reporter* reporter, GrContext* context) {
     REPORTER_ASSERT(reporter, cache.canReuse(clip2.getTopmostGenID(), bound2));
     REPORTER_ASSERT(reporter, !cache.canReuse(clip1.getTopmostGenID(), bound1));
 
+    // setMask adopts a mask made elsewhere
+    cache.setMask(clip1.getTopmostGenID(), texture1, bound1);
+    check_state(reporter, cache, clip1, texture1, bound1);
+    REPORTER_ASSERT(reporter, cache.canReuse(clip1.getTopmostGenID(), bound1));
+    cache.setMask(clip2.getTopmostGenID(), texture2, bound2);
+
     // pop the state
     cache.pop();
 
@@ -600,7 +600,7 @@ static void test_rect_merging(skiatest::Reporter* reporter) {
         REPORTER_ASSERT(reporter, isIntersectionOfRects);
     }
 
-    // reverse nested (aa inside bw) - should _not_ merge
+    // reverse nested (aa around bw) - the aa rect changes nothing, so it's dropped
     {
         SkClipStack stack;
 
@@ -608,11 +608,59 @@ static void test_rect_merging(skiatest::Reporter* reporter) {
 
         stack.clipDevRect(nestedParent, SkRegion::kIntersect_Op, true);
 
-        REPORTER_ASSERT(reporter, 2 == count(stack));
+        REPORTER_ASSERT(reporter, 1 == count(stack));
 
         stack.getBounds(&bound, &type, &isIntersectionOfRects);
 
-        REPORTER_ASSERT(reporter, !isIntersectionOfRects);
+        REPORTER_ASSERT(reporter, isIntersectionOfRects);
+        SkClipStack::Iter iter(stack, SkClipStack::Iter::kTop_IterStart);
+        REPORTER_ASSERT(reporter, !iter.prev()->isAA());
+    }
+}
+
+// Deep save stacks that clip to the same or bigger shapes at each level shouldn't grow, and
+// quickContains() should answer from the top of the stack as it would from every element.
+static void test_redundant_clips(skiatest::Reporter* reporter) {
+    SkClipStack stack;
+    stack.clipDevRect(SkRect::MakeLTRB(10.5f, 10.5f, 90.5f, 90.5f), SkRegion::kIntersect_Op, true);
+    const int32_t genID = stack.getTopmostGenID();
+    for (int i = 0; i < 100; ++i) {
+        stack.save();
+        stack.clipDevRect(SkRect::MakeLTRB(10, 10, 91, 91), SkRegion::kIntersect_Op, i & 1);
+        SkRRect rrect;
+        rrect.setRectXY(SkRect::MakeLTRB(0, 0, 100, 100), 5, 5);
+        stack.clipDevRRect(rrect, SkRegion::kIntersect_Op, true);
+    }
+    REPORTER_ASSERT(reporter, 1 == count(stack));
+    REPORTER_ASSERT(reporter, genID == stack.getTopmostGenID());
+
+    // a rect that cuts into the clip's edge pixels still has to be kept
+    stack.save();
+    stack.clipDevRect(SkRect::MakeLTRB(10.75f, 0, 100, 100), SkRegion::kIntersect_Op, false);
+    REPORTER_ASSERT(reporter, 2 == count(stack));
+    stack.restore();
+    REPORTER_ASSERT(reporter, 1 == count(stack));
+
+    // nested rects at new save levels, checked against each of them as quickContains() used to
+    SkRandom rand;
+    SkClipStack nested;
+    SkTDArray<SkRect> rects;
+    for (int i = 0; i < 50; ++i) {
+        nested.save();
+        SkRect r = SkRect::MakeLTRB(rand.nextRangeScalar(0, 40), rand.nextRangeScalar(0, 40),
+                                    rand.nextRangeScalar(60, 100), rand.nextRangeScalar(60, 100));
+        nested.clipDevRect(r, SkRegion::kIntersect_Op, true);
+        *rects.append() = r;
+        for (int j = 0; j < 10; ++j) {
+            SkRect test = SkRect::MakeLTRB(rand.nextRangeScalar(0, 50), rand.nextRangeScalar(0, 50),
+                                           rand.nextRangeScalar(50, 100),
+                                           rand.nextRangeScalar(50, 100));
+            bool expected = true;
+            for (int k = 0; k < rects.count(); ++k) {
+                expected = expected && rects[k].contains(test);
+            }
+            REPORTER_ASSERT(reporter, expected == nested.quickContains(test));
+        }
     }
 }
 
@@ -1209,6 +1257,7 @@ DEF_TEST(ClipStack, reporter) {
     test_bounds(reporter, SkClipStack::Element::kPath_Type);
     test_isWideOpen(reporter);
     test_rect_merging(reporter);
+    test_redundant_clips(reporter);
     test_rect_replace(reporter);
     test_rect_inverse_fill(reporter);
     test_path_replace(reporter);
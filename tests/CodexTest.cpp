@@ -8,6 +8,8 @@
 #include "Resources.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
+#include "SkColorPriv.h"
+#include "SkData.h"
 #include "SkMD5.h"
 #include "SkRandom.h"
 #include "SkScanlineDecoder.h"
@@ -140,9 +142,13 @@ static void check(skiatest::Reporter* r,
 
         if (supportsSubsetDecoding) {
             REPORTER_ASSERT(r, result == SkCodec::kSuccess);
-            // Webp is the only codec that supports subsets, and it will have modified the subset
-            // to have even left/top.
-            REPORTER_ASSERT(r, SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop));
+            // Webp will have modified the subset to have even left/top, and jpeg to have its
+            // left on an iMCU boundary, which is a multiple of 8.
+            if (kJPEG_SkEncodedFormat == codec->getEncodedFormat()) {
+                REPORTER_ASSERT(r, SkIsAlign8(subset.fLeft));
+            } else {
+                REPORTER_ASSERT(r, SkIsAlign2(subset.fLeft) && SkIsAlign2(subset.fTop));
+            }
         } else {
             // No subsets will work.
             REPORTER_ASSERT(r, result == SkCodec::kUnimplemented);
@@ -175,11 +181,11 @@ DEF_TEST(Codec, r) {
     check(r, "randPixels.gif", SkISize::Make(8, 8), false, false);
 
     // JPG
-    check(r, "CMYK.jpg", SkISize::Make(642, 516), true, false);
-    check(r, "color_wheel.jpg", SkISize::Make(128, 128), true, false);
-    check(r, "grayscale.jpg", SkISize::Make(128, 128), true, false);
-    check(r, "mandrill_512_q075.jpg", SkISize::Make(512, 512), true, false);
-    check(r, "randPixels.jpg", SkISize::Make(8, 8), true, false);
+    check(r, "CMYK.jpg", SkISize::Make(642, 516), true, true);
+    check(r, "color_wheel.jpg", SkISize::Make(128, 128), true, true);
+    check(r, "grayscale.jpg", SkISize::Make(128, 128), true, true);
+    check(r, "mandrill_512_q075.jpg", SkISize::Make(512, 512), true, true);
+    check(r, "randPixels.jpg", SkISize::Make(8, 8), true, true);
 
     // PNG
     check(r, "arrow.png", SkISize::Make(187, 312), true, false);
@@ -264,6 +270,11 @@ DEF_TEST(Codec_Dimensions, r) {
     test_dimensions(r, "grayscale.jpg");
     test_dimensions(r, "mandrill_512_q075.jpg");
     test_dimensions(r, "randPixels.jpg");
+
+    // Sampled decodes
+    test_dimensions(r, "mandrill_128.png");
+    test_dimensions(r, "randPixels.bmp");
+    test_dimensions(r, "mandrill.wbmp");
 }
 
 static void test_empty(skiatest::Reporter* r, const char path[]) {
@@ -324,3 +335,728 @@ DEF_TEST(Codec_Params, r) {
     test_invalid_parameters(r, "index8.png");
     test_invalid_parameters(r, "mandrill.wbmp");
 }
+
+static void test_parallel_decode(skiatest::Reporter* r, const char path[], SkColorType colorType) {
+    SkMD5::Digest digests[2];
+    for (int i = 0; i < 2; i++) {
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(resource(path)));
+        if (!codec) {
+            SkDebugf("Missing resource '%s'\n", path);
+            return;
+        }
+
+        SkImageInfo info = codec->getInfo().makeColorType(colorType);
+        SkBitmap bm;
+        bm.allocPixels(info);
+        SkAutoLockPixels autoLockPixels(bm);
+
+        SkCodec::Options options;
+        options.fParallelDecode = (1 == i);
+        const SkCodec::Result result = codec->getPixels(info, bm.getPixels(), bm.rowBytes(),
+                                                        &options, NULL, NULL);
+        REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+        md5(bm, &digests[i]);
+    }
+    REPORTER_ASSERT(r, digests[0] == digests[1]);
+}
+
+DEF_TEST(Codec_ParallelDecode, r) {
+    // Restart markers every 7 MCUs, which do not line up with the 32 MCU rows
+    test_parallel_decode(r, "mandrill_512_restart.jpg", kN32_SkColorType);
+    test_parallel_decode(r, "mandrill_512_restart.jpg", kGray_8_SkColorType);
+    test_parallel_decode(r, "mandrill_512_restart.jpg", kRGB_565_SkColorType);
+
+    // No restart markers, so these fall back to a serial decode
+    test_parallel_decode(r, "mandrill_512_q075.jpg", kN32_SkColorType);
+    test_parallel_decode(r, "CMYK.jpg", kN32_SkColorType);
+}
+
+static void test_incremental_decode(skiatest::Reporter* r, const char path[], size_t chunkSize) {
+    SkAutoTUnref<SkData> data(SkData::NewFromFileName(GetResourcePath(path).c_str()));
+    if (!data) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+
+    // Decode the whole image for comparison
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    SkAutoLockPixels autoLockExpected(expected);
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+            codec->getPixels(info, expected.getPixels(), expected.rowBytes()));
+    SkMD5::Digest goodDigest;
+    md5(expected, &goodDigest);
+
+    // Nothing can be decoded before starting
+    int rowsDecoded;
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters ==
+            codec->incrementalDecode(data->data(), data->size(), &rowsDecoded));
+
+    // Create a codec from as little of the data as possible, and then feed it the rest
+    size_t offset = chunkSize;
+    SkCodec* partialCodec = NULL;
+    while (NULL == partialCodec && offset < data->size()) {
+        partialCodec = SkCodec::NewFromStream(SkNEW_ARGS(SkMemoryStream,
+                                                         (data->data(), offset, true)));
+        if (NULL == partialCodec) {
+            offset += chunkSize;
+        }
+    }
+    codec.reset(partialCodec);
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+
+    SkBitmap bm;
+    bm.allocPixels(info);
+    SkAutoLockPixels autoLockPixels(bm);
+    SkCodec::Result result = codec->startIncrementalDecode(info, bm.getPixels(), bm.rowBytes());
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    if (SkCodec::kSuccess != result) {
+        return;
+    }
+
+    int lastRowsDecoded = 0;
+    result = SkCodec::kIncompleteInput;
+    while (offset < data->size()) {
+        REPORTER_ASSERT(r, SkCodec::kIncompleteInput == result);
+        const size_t length = SkTMin(chunkSize, data->size() - offset);
+        result = codec->incrementalDecode(data->bytes() + offset, length, &rowsDecoded);
+        offset += length;
+        REPORTER_ASSERT(r, rowsDecoded >= lastRowsDecoded && rowsDecoded <= info.height());
+        lastRowsDecoded = rowsDecoded;
+    }
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+
+    // Querying the progress of a finished decode changes nothing
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->incrementalDecode(NULL, 0, &rowsDecoded));
+    REPORTER_ASSERT(r, info.height() == rowsDecoded);
+    compare_to_good_digest(r, goodDigest, bm);
+}
+
+DEF_TEST(Codec_IncrementalDecode, r) {
+    // png
+    test_incremental_decode(r, "mandrill_128.png", 1000);
+    test_incremental_decode(r, "mandrill_128_interlaced.png", 1000);
+    test_incremental_decode(r, "plane.png", 97);
+
+    // jpeg
+    test_incremental_decode(r, "mandrill_512_q075.jpg", 1000);
+    test_incremental_decode(r, "CMYK.jpg", 4096);
+    // progressive
+    test_incremental_decode(r, "brickwork-texture.jpg", 4096);
+    test_incremental_decode(r, "grayscale.jpg", 50);
+
+    // gif
+    test_incremental_decode(r, "box.gif", 100);
+    test_incremental_decode(r, "color_wheel.gif", 500);
+}
+
+// Decodes the full image and checks that a sampled decode matches its sampled pixels.
+static void test_sampled_decode(skiatest::Reporter* r, SkCodec* codec, const char name[]) {
+    SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    if (kUnpremul_SkAlphaType == info.alphaType()) {
+        info = info.makeAlphaType(kPremul_SkAlphaType);
+    }
+    SkBitmap full;
+    full.allocPixels(info);
+    SkCodec::Result result = codec->getPixels(info, full.getPixels(), full.rowBytes());
+    if (SkCodec::kSuccess != result) {
+        ERRORF(r, "Unable to decode '%s'", name);
+        return;
+    }
+
+    const int sampleSizes[] = { 2, 3, 4, 7 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(sampleSizes); i++) {
+        const int sampleSize = sampleSizes[i];
+        const SkISize dims = codec->getScaledDimensions(1.0f / sampleSize);
+        REPORTER_ASSERT(r, dims.width() == SkTMax(1, info.width() / sampleSize));
+        REPORTER_ASSERT(r, dims.height() == SkTMax(1, info.height() / sampleSize));
+
+        SkBitmap sampled;
+        sampled.allocPixels(info.makeWH(dims.width(), dims.height()));
+        result = codec->getPixels(sampled.info(), sampled.getPixels(), sampled.rowBytes());
+        if (SkCodec::kSuccess != result) {
+            ERRORF(r, "Unable to sample '%s' by %d", name, sampleSize);
+            continue;
+        }
+
+        const int sampleX = info.width() / dims.width();
+        const int sampleY = info.height() / dims.height();
+        for (int y = 0; y < dims.height(); y++) {
+            for (int x = 0; x < dims.width(); x++) {
+                const SkPMColor expected = *full.getAddr32(sampleX / 2 + x * sampleX,
+                                                           sampleY / 2 + y * sampleY);
+                if (*sampled.getAddr32(x, y) != expected) {
+                    ERRORF(r, "'%s' sampled by %d differs at (%d, %d)", name, sampleSize, x, y);
+                    return;
+                }
+            }
+        }
+    }
+
+    // Dimensions that cannot be reached by sampling are rejected.
+    if (info.width() > 2) {
+        SkBitmap bm;
+        bm.allocPixels(info.makeWH(info.width() - 1, info.height()));
+        result = codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes());
+        REPORTER_ASSERT(r, SkCodec::kInvalidScale == result);
+    }
+}
+
+static void test_sampled_decode(skiatest::Reporter* r, const char path[]) {
+    SkAutoTDelete<SkStream> stream(resource(path));
+    if (!stream) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(stream.detach()));
+    if (!codec) {
+        ERRORF(r, "Unable to create codec '%s'", path);
+        return;
+    }
+    test_sampled_decode(r, codec, path);
+}
+
+static void write_le(SkDynamicMemoryWStream* stream, uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        stream->write8((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// Creates a bottom-up, 16 bit bmp that uses bit masks for 565 pixels.
+static SkData* make_565_mask_bmp(int width, int height) {
+    const uint32_t rowBytes = SkAlign4(width * 2);
+    const uint32_t offset = 14 + 40 + 12;
+    SkDynamicMemoryWStream stream;
+    stream.write8('B');
+    stream.write8('M');
+    write_le(&stream, offset + rowBytes * height, 4);
+    write_le(&stream, 0, 4);
+    write_le(&stream, offset, 4);
+    write_le(&stream, 40, 4);
+    write_le(&stream, width, 4);
+    write_le(&stream, height, 4);
+    write_le(&stream, 1, 2);
+    write_le(&stream, 16, 2);
+    write_le(&stream, 3, 4);    // BI_BITFIELDS
+    write_le(&stream, rowBytes * height, 4);
+    write_le(&stream, 2835, 4);
+    write_le(&stream, 2835, 4);
+    write_le(&stream, 0, 4);
+    write_le(&stream, 0, 4);
+    write_le(&stream, 0xF800, 4);
+    write_le(&stream, 0x07E0, 4);
+    write_le(&stream, 0x001F, 4);
+    SkRandom random;
+    for (int y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < rowBytes / 2; x++) {
+            write_le(&stream, random.nextU() & 0xFFFF, 2);
+        }
+    }
+    return stream.copyToData();
+}
+
+DEF_TEST(Codec_SampledDecode, r) {
+    test_sampled_decode(r, "mandrill_128.png");
+    test_sampled_decode(r, "mandrill_128_interlaced.png");
+    test_sampled_decode(r, "index8.png");
+    test_sampled_decode(r, "yellow_rose.png");
+    test_sampled_decode(r, "randPixels.bmp");
+    test_sampled_decode(r, "mandrill.wbmp");
+    test_sampled_decode(r, "box.gif");
+    test_sampled_decode(r, "randPixels.gif");
+
+    SkAutoTUnref<SkData> maskBmp(make_565_mask_bmp(37, 29));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(maskBmp));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        test_sampled_decode(r, codec, "565 mask bmp");
+    }
+}
+
+// An opaque image decoded to 565 should match its N32 decode, truncated to 565.
+static void test_565_decode(skiatest::Reporter* r, SkCodec* codec, const char name[]) {
+    const SkImageInfo n32Info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap n32;
+    n32.allocPixels(n32Info);
+    SkCodec::Result result =
+            codec->getPixels(n32Info, n32.getPixels(), n32.rowBytes(), NULL, NULL, NULL);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+
+    const SkImageInfo info565 = codec->getInfo().makeColorType(kRGB_565_SkColorType);
+    SkBitmap bm565;
+    bm565.allocPixels(info565);
+    result = codec->getPixels(info565, bm565.getPixels(), bm565.rowBytes(), NULL, NULL, NULL);
+    if (kOpaque_SkAlphaType != codec->getInfo().alphaType()) {
+        REPORTER_ASSERT(r, SkCodec::kInvalidConversion == result);
+        return;
+    }
+    if (SkCodec::kSuccess != result) {
+        ERRORF(r, "Could not decode %s to 565", name);
+        return;
+    }
+    for (int y = 0; y < info565.height(); y++) {
+        for (int x = 0; x < info565.width(); x++) {
+            if (*bm565.getAddr16(x, y) != SkPixel32ToPixel16(*n32.getAddr32(x, y))) {
+                ERRORF(r, "%s decoded to 565 differs at (%d, %d)", name, x, y);
+                return;
+            }
+        }
+    }
+}
+
+static void test_565_decode(skiatest::Reporter* r, const char path[]) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(resource(path)));
+    if (!codec) {
+        SkDebugf("Missing resource '%s'\n", path);
+        return;
+    }
+    test_565_decode(r, codec, path);
+}
+
+DEF_TEST(Codec_565, r) {
+    test_565_decode(r, "mandrill_128.png");
+    test_565_decode(r, "index8.png");
+    test_565_decode(r, "randPixels.bmp");
+    test_565_decode(r, "mandrill.wbmp");
+    test_565_decode(r, "baby_tux.png");
+
+    SkAutoTUnref<SkData> maskBmp(make_565_mask_bmp(37, 29));
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(maskBmp));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        test_565_decode(r, codec, "565 mask bmp");
+    }
+}
+
+DEF_TEST(Codec_DecodeBatch, r) {
+    const char* paths[] = { "mandrill_128.png", "index8.png", "color_wheel.jpg", "CMYK.jpg",
+                            "mandrill_128_interlaced.png", "randPixels.bmp" };
+    const int kCount = SK_ARRAY_COUNT(paths) + 1;
+
+    SkAutoTUnref<SkData> data[kCount];
+    for (int i = 0; i < kCount - 1; i++) {
+        data[i].reset(SkData::NewFromFileName(GetResourcePath(paths[i]).c_str()));
+        if (!data[i]) {
+            SkDebugf("Missing resource '%s'\n", paths[i]);
+            return;
+        }
+    }
+    // The last is not an image at all.
+    const char garbage[] = "not an image, just some bytes";
+    data[kCount - 1].reset(SkData::NewWithCopy(garbage, sizeof(garbage)));
+
+    SkCodec::BatchItem items[kCount];
+    for (int i = 0; i < kCount; i++) {
+        items[i].fEncoded = data[i];
+    }
+    SkCodec::DecodeBatch(items, kCount);
+
+    // Each image must match decoding it on its own.
+    for (int i = 0; i < kCount - 1; i++) {
+        REPORTER_ASSERT(r, SkCodec::kSuccess == items[i].fResult);
+        if (SkCodec::kSuccess != items[i].fResult) {
+            continue;
+        }
+        SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data[i]));
+        REPORTER_ASSERT(r, codec);
+        if (!codec) {
+            continue;
+        }
+        const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+        REPORTER_ASSERT(r, items[i].fBitmap.info() == info);
+
+        SkBitmap expected;
+        expected.allocPixels(info);
+        SkAutoLockPixels autoLockExpected(expected);
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                codec->getPixels(info, expected.getPixels(), expected.rowBytes()));
+        SkMD5::Digest goodDigest;
+        md5(expected, &goodDigest);
+        compare_to_good_digest(r, goodDigest, items[i].fBitmap);
+    }
+    REPORTER_ASSERT(r, SkCodec::kInvalidInput == items[kCount - 1].fResult);
+
+    // An empty batch does nothing.
+    SkCodec::DecodeBatch(NULL, 0);
+}
+
+namespace {
+// One frame of the animated gif made by make_animated_gif().
+struct GifFrame {
+    int fLeft, fTop, fWidth, fHeight;
+    int fColorIndex;    // Every pixel, or every other pixel if fTransparent.
+    int fDisposal;      // 1 keep, 2 restore background, 3 restore previous
+    bool fTransparent;  // Index 0 is transparent, and used for every other pixel.
+    int fDelay;         // In hundredths of a second.
+    int fRequiredFrame; // What SkCodec should report.
+};
+
+const int kGifSize = 4;
+const uint8_t gGifColors[][3] = { { 0, 0, 0 }, { 0xFF, 0, 0 }, { 0, 0xFF, 0 }, { 0, 0, 0xFF } };
+const GifFrame gGifFrames[] = {
+    { 0, 0, 4, 4, 1, 1, false, 10, SkCodec::kNone },
+    { 1, 1, 2, 2, 2, 1, false, 20, 0 },
+    { 2, 2, 2, 2, 3, 2, false, 0,  1 },
+    { 0, 0, 1, 1, 2, 1, false, 5,  2 },
+    { 0, 0, 4, 1, 3, 3, false, 5,  3 },
+    { 3, 0, 1, 4, 2, 1, false, 5,  3 },
+    { 0, 0, 4, 4, 3, 1, true,  5,  5 },
+    { 1, 0, 2, 2, 1, 1, false, 5,  6 },
+    { 0, 3, 4, 1, 2, 2, false, 5,  7 },
+    { 0, 0, 2, 2, 3, 1, false, 5,  8 },
+    { 0, 0, 4, 4, 2, 1, false, 5,  SkCodec::kNone },
+    { 2, 1, 1, 1, 3, 1, false, 5,  10 },
+};
+
+int gif_frame_index(const GifFrame& frame, int x, int y) {
+    return frame.fTransparent && 0 == (x + y) % 2 ? 0 : frame.fColorIndex;
+}
+
+SkPMColor gif_color(int index) {
+    return SkPackARGB32(0xFF, gGifColors[index][0], gGifColors[index][1], gGifColors[index][2]);
+}
+}  // namespace
+
+// Writes 2 bit indices as gif LZW data, clearing the code table after every two codes so
+// that every code is 3 bits.
+static void write_gif_lzw(SkDynamicMemoryWStream* stream, const SkTDArray<uint8_t>& indices) {
+    const unsigned kClear = 4, kEnd = 5;
+    SkTDArray<uint8_t> bytes;
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (int i = 0; i <= indices.count(); i++) {
+        SkTDArray<unsigned> codes;
+        if (i == indices.count()) {
+            *codes.append() = kEnd;
+        } else {
+            if (0 == i % 2) {
+                *codes.append() = kClear;
+            }
+            *codes.append() = indices[i];
+        }
+        for (int j = 0; j < codes.count(); j++) {
+            bits |= codes[j] << bitCount;
+            bitCount += 3;
+            while (bitCount >= 8) {
+                *bytes.append() = bits & 0xFF;
+                bits >>= 8;
+                bitCount -= 8;
+            }
+        }
+    }
+    if (bitCount > 0) {
+        *bytes.append() = bits & 0xFF;
+    }
+
+    stream->write8(2);  // Minimum code size
+    for (int i = 0; i < bytes.count(); i += 255) {
+        const int blockSize = SkTMin(255, bytes.count() - i);
+        stream->write8(blockSize);
+        stream->write(bytes.begin() + i, blockSize);
+    }
+    stream->write8(0);
+}
+
+static SkData* make_animated_gif() {
+    SkDynamicMemoryWStream stream;
+    stream.write("GIF89a", 6);
+    write_le(&stream, kGifSize, 2);
+    write_le(&stream, kGifSize, 2);
+    stream.write8(0x91);    // Global color table of 4 colors
+    stream.write8(0);       // Background index
+    stream.write8(0);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gGifColors); i++) {
+        stream.write(gGifColors[i], 3);
+    }
+    for (size_t i = 0; i < SK_ARRAY_COUNT(gGifFrames); i++) {
+        const GifFrame& frame = gGifFrames[i];
+        // Graphics control extension
+        stream.write8(0x21);
+        stream.write8(0xF9);
+        stream.write8(4);
+        stream.write8((frame.fDisposal << 2) | (frame.fTransparent ? 1 : 0));
+        write_le(&stream, frame.fDelay, 2);
+        stream.write8(0);
+        stream.write8(0);
+        // Image descriptor
+        stream.write8(0x2C);
+        write_le(&stream, frame.fLeft, 2);
+        write_le(&stream, frame.fTop, 2);
+        write_le(&stream, frame.fWidth, 2);
+        write_le(&stream, frame.fHeight, 2);
+        stream.write8(0);
+        SkTDArray<uint8_t> indices;
+        for (int y = frame.fTop; y < frame.fTop + frame.fHeight; y++) {
+            for (int x = frame.fLeft; x < frame.fLeft + frame.fWidth; x++) {
+                *indices.append() = gif_frame_index(frame, x, y);
+            }
+        }
+        write_gif_lzw(&stream, indices);
+    }
+    stream.write8(0x3B);
+    return stream.copyToData();
+}
+
+// Draws frame i of gGifFrames on canvas, which holds frame i - 1, the way the gif spec says.
+static void draw_gif_frame(int i, SkPMColor canvas[], SkPMColor beforePrev[]) {
+    SkPMColor before[kGifSize * kGifSize];
+    memcpy(before, canvas, sizeof(before));
+    if (i > 0) {
+        const GifFrame& prev = gGifFrames[i - 1];
+        if (2 == prev.fDisposal) {
+            for (int y = prev.fTop; y < prev.fTop + prev.fHeight; y++) {
+                for (int x = prev.fLeft; x < prev.fLeft + prev.fWidth; x++) {
+                    canvas[y * kGifSize + x] = SK_ColorTRANSPARENT;
+                }
+            }
+        } else if (3 == prev.fDisposal) {
+            memcpy(canvas, beforePrev, sizeof(before));
+        }
+        memcpy(before, canvas, sizeof(before));
+    }
+    const GifFrame& frame = gGifFrames[i];
+    for (int y = frame.fTop; y < frame.fTop + frame.fHeight; y++) {
+        for (int x = frame.fLeft; x < frame.fLeft + frame.fWidth; x++) {
+            const int index = gif_frame_index(frame, x, y);
+            if (!frame.fTransparent || 0 != index) {
+                canvas[y * kGifSize + x] = gif_color(index);
+            }
+        }
+    }
+    memcpy(beforePrev, before, sizeof(before));
+}
+
+static bool matches_canvas(const SkBitmap& bm, const SkPMColor canvas[]) {
+    SkAutoLockPixels autoLockPixels(bm);
+    for (int y = 0; y < kGifSize; y++) {
+        for (int x = 0; x < kGifSize; x++) {
+            if (*bm.getAddr32(x, y) != canvas[y * kGifSize + x]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+DEF_TEST(Codec_Frames, r) {
+    SkAutoTUnref<SkData> data(make_animated_gif());
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromData(data));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    const int frameCount = SK_ARRAY_COUNT(gGifFrames);
+    REPORTER_ASSERT(r, frameCount == codec->getFrameCount());
+    SkCodec::FrameInfo frameInfo;
+    for (int i = 0; i < frameCount; i++) {
+        REPORTER_ASSERT(r, codec->getFrameInfo(i, &frameInfo));
+        REPORTER_ASSERT(r, gGifFrames[i].fRequiredFrame == frameInfo.fRequiredFrame);
+        REPORTER_ASSERT(r, gGifFrames[i].fDelay * 10 == frameInfo.fDuration);
+    }
+    REPORTER_ASSERT(r, !codec->getFrameInfo(frameCount, &frameInfo));
+
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkPMColor canvas[kGifSize * kGifSize];
+    SkPMColor beforePrev[kGifSize * kGifSize];
+    sk_bzero(canvas, sizeof(canvas));
+    sk_bzero(beforePrev, sizeof(beforePrev));
+    SkBitmap played;
+    played.allocPixels(info);
+    for (int i = 0; i < frameCount; i++) {
+        draw_gif_frame(i, canvas, beforePrev);
+
+        // Decoding a frame on its own decodes the frames below it.
+        SkCodec::Options options;
+        options.fFrameIndex = i;
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                codec->getPixels(info, bm.getPixels(), bm.rowBytes(), &options, NULL, NULL));
+        REPORTER_ASSERT(r, matches_canvas(bm, canvas));
+
+        // Playing in order only decodes each frame once.
+        options.fPriorFrame = i - 1;
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                codec->getPixels(info, played.getPixels(), played.rowBytes(), &options, NULL,
+                                 NULL));
+        REPORTER_ASSERT(r, matches_canvas(played, canvas));
+    }
+
+    // Seeking back starts from a cached frame, with the same result.
+    {
+        SkCodec::Options options;
+        options.fFrameIndex = 9;
+        SkBitmap bm;
+        bm.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                codec->getPixels(info, bm.getPixels(), bm.rowBytes(), &options, NULL, NULL));
+        SkAutoTDelete<SkCodec> fresh(SkCodec::NewFromData(data));
+        SkBitmap expected;
+        expected.allocPixels(info);
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                fresh->getPixels(info, expected.getPixels(), expected.rowBytes(), &options,
+                                 NULL, NULL));
+        SkMD5::Digest digest;
+        md5(expected, &digest);
+        compare_to_good_digest(r, digest, bm);
+    }
+
+    // Frames drawn on others can't be decoded to a color table, nor past the last frame.
+    {
+        SkCodec::Options options;
+        options.fFrameIndex = 1;
+        uint8_t indices[kGifSize * kGifSize];
+        SkPMColor colors[256];
+        int colorCount = 256;
+        REPORTER_ASSERT(r, SkCodec::kInvalidConversion ==
+                codec->getPixels(codec->getInfo(), indices, kGifSize, &options, colors,
+                                 &colorCount));
+        options.fFrameIndex = frameCount;
+        REPORTER_ASSERT(r, SkCodec::kInvalidParameters ==
+                codec->getPixels(info, played.getPixels(), played.rowBytes(), &options, NULL,
+                                 NULL));
+    }
+
+    // Still images have one frame.
+    SkAutoTDelete<SkCodec> still(SkCodec::NewFromStream(resource("mandrill_128.png")));
+    if (still) {
+        REPORTER_ASSERT(r, 1 == still->getFrameCount());
+        REPORTER_ASSERT(r, still->getFrameInfo(0, &frameInfo));
+        REPORTER_ASSERT(r, SkCodec::kNone == frameInfo.fRequiredFrame);
+        REPORTER_ASSERT(r, !still->getFrameInfo(1, &frameInfo));
+    }
+}
+
+// A jpeg subset should match the same rows and columns of a full decode.  With
+// jpeg_crop_scanline, the columns at the edges of the subset are upsampled without their
+// neighbors, so they are only close.
+DEF_TEST(Codec_JpegSubset, r) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(resource("mandrill_512_q075.jpg")));
+    if (!codec) {
+        SkDebugf("Missing resource 'mandrill_512_q075.jpg'\n");
+        return;
+    }
+    SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+    SkBitmap full;
+    full.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+            codec->getPixels(info, full.getPixels(), full.rowBytes(), NULL, NULL, NULL));
+
+    SkIRect subset = SkIRect::MakeXYWH(37, 101, 150, 211);
+    REPORTER_ASSERT(r, codec->getValidSubset(&subset));
+    REPORTER_ASSERT(r, 101 == subset.top() && 187 == subset.right() && subset.left() <= 37);
+
+    SkCodec::Options opts;
+    opts.fSubset = &subset;
+    SkBitmap bm;
+    bm.allocPixels(info.makeWH(subset.width(), subset.height()));
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+            codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes(), &opts, NULL, NULL));
+
+    int mismatches = 0;
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 1; x < bm.width() - 1; x++) {
+            if (*bm.getAddr32(x, y) != *full.getAddr32(x + subset.left(), y + subset.top())) {
+                mismatches++;
+            }
+        }
+    }
+    REPORTER_ASSERT(r, 0 == mismatches);
+
+    // Subsets must start on an iMCU, and cannot be scaled.
+    SkIRect unaligned = SkIRect::MakeXYWH(subset.left() + 1, 0, 16, 16);
+    opts.fSubset = &unaligned;
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters ==
+            codec->getPixels(bm.info().makeWH(16, 16), bm.getPixels(), bm.rowBytes(), &opts,
+                             NULL, NULL));
+    opts.fSubset = &subset;
+    REPORTER_ASSERT(r, SkCodec::kInvalidScale ==
+            codec->getPixels(bm.info().makeWH(subset.width() / 2, subset.height() / 2),
+                             bm.getPixels(), bm.rowBytes(), &opts, NULL, NULL));
+}
+
+// A stream that can't rewind, as from the network.
+class NonRewindableStream : public SkStream {
+public:
+    explicit NonRewindableStream(SkStream* stream) : fStream(stream) {}
+
+    size_t read(void* buffer, size_t size) override { return fStream->read(buffer, size); }
+    bool isAtEnd() const override { return fStream->isAtEnd(); }
+
+private:
+    SkAutoTDelete<SkStream> fStream;
+};
+
+// NewFromStream buffers a stream that can't rewind, so it can read the header again after
+// sniffing it, and the codec can decode more than once.
+DEF_TEST(Codec_NonRewindableStream, r) {
+    SkStreamAsset* stream = resource("mandrill_128.png");
+    if (!stream) {
+        SkDebugf("Missing resource 'mandrill_128.png'\n");
+        return;
+    }
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(SkNEW_ARGS(NonRewindableStream,
+                                                                   (stream))));
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    SkBitmap bm;
+    bm.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+    for (int i = 0; i < 2; i++) {
+        REPORTER_ASSERT(r, SkCodec::kSuccess ==
+                codec->getPixels(bm.info(), bm.getPixels(), bm.rowBytes(), NULL, NULL, NULL));
+    }
+}
+
+namespace {
+
+// Allocates pixels with padded rows, as an external buffer pool might.
+class PaddedAllocator : public SkBitmap::Allocator {
+public:
+    bool allocPixelRef(SkBitmap* bitmap, SkColorTable*) override {
+        const SkImageInfo info = bitmap->info();
+        return bitmap->tryAllocPixels(info, info.minRowBytes() + 32);
+    }
+};
+
+}  // namespace
+
+// decodeToBitmap() decodes straight into the allocator's pixels, whatever their rowBytes.
+DEF_TEST(Codec_DecodeToBitmap, r) {
+    SkAutoTDelete<SkCodec> codec(SkCodec::NewFromStream(resource("mandrill_128.png")));
+    if (!codec) {
+        SkDebugf("Missing resource 'mandrill_128.png'\n");
+        return;
+    }
+    const SkImageInfo info = codec->getInfo().makeColorType(kN32_SkColorType);
+
+    SkBitmap expected;
+    expected.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess ==
+            codec->getPixels(info, expected.getPixels(), expected.rowBytes()));
+
+    PaddedAllocator allocator;
+    SkBitmap bm;
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->decodeToBitmap(&bm, &info, &allocator));
+    REPORTER_ASSERT(r, bm.isImmutable());
+    REPORTER_ASSERT(r, info.minRowBytes() + 32 == bm.rowBytes());
+    SkAutoLockPixels alp(bm);
+    for (int y = 0; y < info.height(); ++y) {
+        REPORTER_ASSERT(r, !memcmp(expected.getAddr(0, y), bm.getAddr(0, y), info.minRowBytes()));
+    }
+
+    // Index8 needs a color table that an allocator can't know up front.
+    const SkImageInfo index8 = info.makeColorType(kIndex_8_SkColorType);
+    REPORTER_ASSERT(r, SkCodec::kSuccess != codec->decodeToBitmap(&bm, &index8, &allocator));
+    REPORTER_ASSERT(r, NULL == bm.pixelRef());
+}
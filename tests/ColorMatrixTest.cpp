@@ -10,6 +10,7 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkColor.h"
+#include "SkColorPriv.h"
 #include "SkColorMatrixFilter.h"
 #include "SkPaint.h"
 
@@ -96,6 +97,36 @@ static inline void test_colorMatrixCTS(skiatest::Reporter* reporter) {
     assert_color(reporter, SK_ColorBLUE, bitmap.getColor(0, 0));
 }
 
+// Spans are filtered four pixels at a time, so every pixel must come out the same however long
+// the span it's in, and transparent pixels must pick up the matrix's translate.
+static inline void test_colorMatrixSpans(skiatest::Reporter* reporter) {
+    SkScalar sepia[20] = {
+            0.393f, 0.769f, 0.189f, 0.0f, 0.0f,
+            0.349f, 0.686f, 0.168f, 0.0f, 0.0f,
+            0.272f, 0.534f, 0.131f, 0.0f, 0.0f,
+            0.0f,   0.0f,   0.0f,   0.8f, 32.0f };
+    SkAutoTUnref<SkColorFilter> filter(SkColorMatrixFilter::Create(sepia));
+
+    const int kCount = 11;
+    SkPMColor src[kCount], span[kCount];
+    for (int i = 0; i < kCount; i++) {
+        const U8CPU a = i * 25;
+        src[i] = SkPackARGB32(a, a, a / 2, a / 3);
+    }
+    for (int count = 1; count <= kCount; count++) {
+        filter->filterSpan(src, count, span);
+        for (int i = 0; i < count; i++) {
+            SkPMColor single;
+            filter->filterSpan(&src[i], 1, &single);
+            REPORTER_ASSERT(reporter, single == span[i]);
+        }
+    }
+
+    filter->filterSpan(src, 1, span);
+    REPORTER_ASSERT(reporter, SkPackARGB32(32, 0, 0, 0) == span[0]);
+}
+
 DEF_TEST(ColorMatrix, reporter) {
     test_colorMatrixCTS(reporter);
+    test_colorMatrixSpans(reporter);
 }
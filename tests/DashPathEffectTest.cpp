@@ -8,6 +8,8 @@
 #include "Test.h"
 
 #include "SkDashPathEffect.h"
+#include "SkPath.h"
+#include "SkStrokeRec.h"
 #include "SkWriteBuffer.h"
 
 // crbug.com/348821 was rooted in SkDashPathEffect refusing to flatten and unflatten itself when
@@ -86,3 +88,41 @@ DEF_TEST(DashPathEffectTest_asPoints, r) {
         }
     }
 }
+
+// Dashes of a path are cached by its generation ID; each lookup must give what dashing the path
+// from scratch does, and a changed path must be dashed again.
+DEF_TEST(DashPathEffectTest_cache, r) {
+    const SkScalar intervals[] = { 4, 2, 1, 2 };
+    SkAutoTUnref<SkDashPathEffect> dash(SkDashPathEffect::Create(intervals, 4, 3));
+    SkStrokeRec rec(SkStrokeRec::kHairline_InitStyle);
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(100, 0, 0, 100, 90, 90);
+    path.lineTo(10, 80);
+    path.close();
+    path.moveTo(50, 50);
+    path.quadTo(80, 20, 60, 60);
+
+    // volatile paths are never cached
+    SkPath uncached(path);
+    uncached.setIsVolatile(true);
+    SkPath expected;
+    REPORTER_ASSERT(r, dash->filterPath(&expected, uncached, &rec, NULL));
+    REPORTER_ASSERT(r, expected.countPoints() > 0);
+
+    for (int i = 0; i < 2; ++i) {
+        SkPath dashed;
+        REPORTER_ASSERT(r, dash->filterPath(&dashed, path, &rec, NULL));
+        REPORTER_ASSERT(r, dashed == expected);
+    }
+
+    path.lineTo(100, 100);
+    uncached = path;
+    uncached.setIsVolatile(true);
+    expected.reset();
+    REPORTER_ASSERT(r, dash->filterPath(&expected, uncached, &rec, NULL));
+    SkPath dashed;
+    REPORTER_ASSERT(r, dash->filterPath(&dashed, path, &rec, NULL));
+    REPORTER_ASSERT(r, dashed == expected);
+}
@@ -313,3 +313,98 @@ DEF_TEST(RWBuffer, reporter) {
         SkDELETE(streams[i]);
     }
 }
+
+DEF_TEST(RWBuffer_SharedData, reporter) {
+    SkAutoTUnref<SkData> shared(SkData::NewUninitialized(26 * 200));
+    for (int i = 0; i < 200; ++i) {
+        memcpy((char*)shared->writable_data() + 26 * i, gABC, 26);
+    }
+
+    SkAutoTUnref<SkROBuffer> reader;
+    {
+        SkRWBuffer buffer;
+        buffer.append(shared);
+        buffer.append(gABC, 26);
+        buffer.append(shared);
+        memcpy(buffer.append(26), gABC, 26);
+        reader.reset(buffer.newRBufferSnapshot());
+        REPORTER_ASSERT(reporter, 2 * shared->size() + 2 * 26 == buffer.size());
+        SkAutoTDelete<SkStream> stream(buffer.newStreamSnapshot());
+        check_alphabet_stream(reporter, stream);
+    }
+    check_alphabet_buffer(reporter, reader);
+
+    // The shared bytes are referred to, not copied.
+    SkROBuffer::Iter iter(reader);
+    REPORTER_ASSERT(reporter, iter.data() == shared->data());
+    REPORTER_ASSERT(reporter, iter.size() == shared->size());
+    REPORTER_ASSERT(reporter, iter.next() && iter.next());
+    REPORTER_ASSERT(reporter, iter.data() == shared->data());
+    REPORTER_ASSERT(reporter, !shared->unique());
+    reader.reset(NULL);
+    REPORTER_ASSERT(reporter, shared->unique());
+}
+
+// Reads an SkMemoryStream, but can't rewind, and counts the bytes it hands out.
+class ForwardOnlyStream : public SkStream {
+public:
+    ForwardOnlyStream(const void* data, size_t length)
+        : fStream(data, length, false), fBytesRead(0) {}
+
+    size_t read(void* buffer, size_t size) override {
+        size_t bytes = fStream.read(buffer, size);
+        fBytesRead += bytes;
+        return bytes;
+    }
+    bool isAtEnd() const override { return fStream.isAtEnd(); }
+
+    size_t bytesRead() const { return fBytesRead; }
+
+private:
+    SkMemoryStream fStream;
+    size_t         fBytesRead;
+};
+
+DEF_TEST(RWBuffer_SharedStream, reporter) {
+    const size_t N = 1000;
+    SkAutoTMalloc<char> abcs(N * 26);
+    for (size_t i = 0; i < N; ++i) {
+        memcpy(abcs.get() + i * 26, gABC, 26);
+    }
+    ForwardOnlyStream* source = SkNEW_ARGS(ForwardOnlyStream, (abcs.get(), N * 26));
+    SkAutoTDelete<SkStreamRewindable> reader(SkSharedStreamBuffer::NewReader(source));
+    REPORTER_ASSERT(reporter, !reader->hasLength());
+
+    // Read a little, rewind, and read it again.
+    char storage[26 * 3];
+    REPORTER_ASSERT(reporter, 13 == reader->read(storage, 13));
+    REPORTER_ASSERT(reporter, reader->rewind());
+    REPORTER_ASSERT(reporter, 26 == reader->read(storage, 26));
+    check_abcs(reporter, storage, 26);
+    REPORTER_ASSERT(reporter, 26 == reader->getPosition());
+
+    // A second reader starts at the beginning, and reads past the first in uneven pieces that
+    // straddle the buffer's blocks.
+    SkAutoTDelete<SkStreamRewindable> other(reader->duplicate());
+    REPORTER_ASSERT(reporter, other);
+    SkAutoTMalloc<char> all(N * 26);
+    size_t offset = 0;
+    for (size_t piece = 1; offset < N * 26; piece = piece * 3 % 1999 + 1) {
+        const size_t bytes = other->read(all.get() + offset, SkTMin(piece, N * 26 - offset));
+        REPORTER_ASSERT(reporter, bytes > 0);
+        offset += bytes;
+    }
+    check_abcs(reporter, all.get(), N * 26);
+    REPORTER_ASSERT(reporter, 0 == other->read(storage, 1));
+    REPORTER_ASSERT(reporter, other->isAtEnd());
+
+    // The first reader carries on from where it was, from the shared copy.
+    REPORTER_ASSERT(reporter, !reader->isAtEnd());
+    REPORTER_ASSERT(reporter, reader->skip(26 * (N - 3)) == 26 * (N - 3));
+    REPORTER_ASSERT(reporter, 26 * 2 == reader->read(storage, sizeof(storage)));
+    check_abcs(reporter, storage, 26 * 2);
+    REPORTER_ASSERT(reporter, reader->isAtEnd());
+
+    // Between them, the readers read the source only once.
+    REPORTER_ASSERT(reporter, N * 26 == source->bytesRead());
+}
@@ -924,6 +924,80 @@ static void TestDeferredCanvasGetCanvasSize(skiatest::Reporter* reporter) {
     }
 }
 
+static void draw_frame(SkCanvas* canvas, int frame) {
+    SkPaint paint;
+    paint.setAntiAlias(SkToBool(frame & 1));
+    for (int i = 0; i < 50; ++i) {
+        paint.setColor(SkColorSetARGB(0x80 + i, i * 5, frame * 30, 255 - i * 5));
+        SkRect rect = SkRect::MakeXYWH(SkIntToScalar((i * 7 + frame * 3) % 50),
+                                       SkIntToScalar((i * 13) % 50), 14.5f, 9.5f);
+        if (i % 3) {
+            canvas->drawRect(rect, paint);
+        } else {
+            canvas->drawOval(rect, paint);
+        }
+    }
+    if (2 == frame) {
+        // Persists into the following frames.
+        canvas->translate(3, 5);
+        canvas->clipRect(SkRect::MakeXYWH(2, 2, 40, 50));
+    }
+    if (4 == frame) {
+        // Not handed off, since it's flushed within a save().
+        canvas->save();
+        canvas->rotate(10);
+        canvas->drawRect(SkRect::MakeWH(20, 20), paint);
+        canvas->flush();
+        canvas->restore();
+    }
+}
+
+static bool equal_pixels(SkImage* a, SkImage* b) {
+    SkBitmap bmA, bmB;
+    bmA.allocN32Pixels(a->width(), a->height());
+    bmB.allocN32Pixels(b->width(), b->height());
+    if (!a->readPixels(bmA.info(), bmA.getPixels(), bmA.rowBytes(), 0, 0) ||
+        !b->readPixels(bmB.info(), bmB.getPixels(), bmB.rowBytes(), 0, 0)) {
+        return false;
+    }
+    return !memcmp(bmA.getPixels(), bmB.getPixels(), bmA.getSize());
+}
+
+static void TestDeferredCanvasThreadedPlayback(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(64, 64));
+    SkAutoTUnref<SkSurface> threadedSurface(SkSurface::NewRasterN32Premul(64, 64));
+    SkAutoTUnref<SkDeferredCanvas> canvas(SkDeferredCanvas::Create(surface.get()));
+    SkAutoTUnref<SkDeferredCanvas> threaded(SkDeferredCanvas::Create(threadedSurface.get()));
+    threaded->setThreadedPlayback(true);
+
+    NotificationCounter notificationCounter;
+    threaded->setNotificationClient(&notificationCounter);
+
+    for (int frame = 0; frame < 8; ++frame) {
+        draw_frame(canvas, frame);
+        draw_frame(threaded, frame);
+        canvas->flush();
+        threaded->flush();
+        if (frame % 3 == 2) {
+            SkAutoTUnref<SkImage> image(canvas->newImageSnapshot());
+            SkAutoTUnref<SkImage> threadedImage(threaded->newImageSnapshot());
+            REPORTER_ASSERT(reporter, equal_pixels(image, threadedImage));
+        }
+    }
+    REPORTER_ASSERT(reporter, 9 == notificationCounter.fFlushedDrawCommandsCount);
+
+    // Deleting the canvas waits for the playback thread.
+    draw_frame(canvas, 8);
+    draw_frame(threaded, 8);
+    canvas->flush();
+    threaded->flush();
+    canvas.reset(NULL);
+    threaded.reset(NULL);
+    SkAutoTUnref<SkImage> image(surface->newImageSnapshot());
+    SkAutoTUnref<SkImage> threadedImage(threadedSurface->newImageSnapshot());
+    REPORTER_ASSERT(reporter, equal_pixels(image, threadedImage));
+}
+
 DEF_TEST(DeferredCanvas_CPU, reporter) {
     TestDeferredCanvasFlush(reporter);
     TestDeferredCanvasSilentFlush(reporter);
@@ -939,6 +1013,7 @@ DEF_TEST(DeferredCanvas_CPU, reporter) {
     TestDeferredCanvasGetCanvasSize(reporter);
     TestDeferredCanvasSurface(reporter, NULL);
     TestDeferredCanvasSetSurface(reporter, NULL);
+    TestDeferredCanvasThreadedPlayback(reporter);
 }
 
 DEF_GPUTEST(DeferredCanvas_GPU, reporter, factory) {
@@ -132,7 +132,54 @@ static void test_complex(skiatest::Reporter* reporter) {
     }
 }
 
+// Every row of the clipped bounds must land in exactly one band, and every band's clip must be
+// part of the original clip.
+static void test_bands(skiatest::Reporter* reporter) {
+    const SkIRect bounds = SkIRect::MakeLTRB(-100, 7, 3000, 2900);
+    SkRegion rgn;
+    make_rgn(&rgn, 2000, 2000, 0x09);
+    SkRasterClip rc;
+    rc.op(rgn, SkRegion::kReplace_Op);
+
+    SkIRect clippedBounds;
+    const int bands = SkDeviceLooper::CountBands(rc, bounds, &clippedBounds);
+    REPORTER_ASSERT(reporter, bands >= 1);
+    REPORTER_ASSERT(reporter, SkIRect::MakeLTRB(0, 7, 2000, 2000) == clippedBounds);
+    int top = clippedBounds.top();
+    for (int i = 0; i < bands; ++i) {
+        SkIRect band = SkDeviceLooper::BandBounds(clippedBounds, i, bands);
+        REPORTER_ASSERT(reporter, band.top() == top);
+        REPORTER_ASSERT(reporter, band.left() == clippedBounds.left());
+        REPORTER_ASSERT(reporter, band.right() == clippedBounds.right());
+        top = band.bottom();
+    }
+    REPORTER_ASSERT(reporter, top == clippedBounds.bottom());
+
+    // Bands may run on other threads, so just count them there.
+    SkAtomic<int32_t> calls(0);
+    SkDeviceLooper::ForEachBand(rc, bounds, [&](const SkRasterClip&) {
+        calls.fetch_add(1);
+    });
+    REPORTER_ASSERT(reporter, bands == calls.load());
+
+    SkRegion covered;
+    for (int i = 0; i < bands; ++i) {
+        SkRegion bandRgn(rgn);
+        bandRgn.op(SkDeviceLooper::BandBounds(clippedBounds, i, bands), SkRegion::kIntersect_Op);
+        REPORTER_ASSERT(reporter, !covered.intersects(bandRgn));
+        covered.op(bandRgn, SkRegion::kUnion_Op);
+    }
+    SkRegion expected(rgn);
+    expected.op(bounds, SkRegion::kIntersect_Op);
+    REPORTER_ASSERT(reporter, covered == expected);
+
+    // Small draws are never split.
+    REPORTER_ASSERT(reporter, 1 == SkDeviceLooper::CountBands(rc, SkIRect::MakeWH(100, 100),
+                                                              &clippedBounds));
+}
+
 DEF_TEST(DeviceLooper, reporter) {
     test_simple(reporter);
     test_complex(reporter);
+    test_bands(reporter);
 }
@@ -30,3 +30,31 @@ DEF_TEST(DiscardableMemory, reporter) {
     REPORTER_ASSERT(reporter, 0 == memcmp(ptr, testString, len));
     dm->unlock();
 }
+
+// Large enough that ports may back it with pages the OS can reclaim while unlocked.
+DEF_TEST(DiscardableMemory_Large, reporter) {
+    const size_t len = 1 << 20;
+    SkAutoTDelete<SkDiscardableMemory> dm(SkDiscardableMemory::Create(len));
+    REPORTER_ASSERT(reporter, dm.get() != NULL);
+    if (NULL == dm.get()) {
+        return;
+    }
+    uint8_t* bytes = static_cast<uint8_t*>(dm->data());
+    for (size_t i = 0; i < len; ++i) {
+        bytes[i] = SkToU8(i * 7 + 1);
+    }
+    for (int i = 0; i < 3; ++i) {
+        dm->unlock();
+        if (!dm->lock()) {
+            // The memory was discarded, which is allowed.
+            return;
+        }
+        bytes = static_cast<uint8_t*>(dm->data());
+        bool intact = true;
+        for (size_t j = 0; j < len; ++j) {
+            intact &= bytes[j] == SkToU8(j * 7 + 1);
+        }
+        REPORTER_ASSERT(reporter, intact);
+    }
+    dm->unlock();
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkDistanceFieldGen.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// The distance field of a shape that is symmetric left to right and top to bottom should be too,
+// at least to within rounding, all the way out to the padding.
+static void test_symmetric(skiatest::Reporter* reporter, const uint8_t* image, int width,
+                           int height, bool bw) {
+    const int dfWidth = width + 2*SK_DistanceFieldPad;
+    const int dfHeight = height + 2*SK_DistanceFieldPad;
+    SkAutoTMalloc<uint8_t> df(dfWidth*dfHeight);
+    const bool generated = bw ?
+            SkGenerateDistanceFieldFromBWImage(df.get(), image, width, height, (width + 7)/8) :
+            SkGenerateDistanceFieldFromA8Image(df.get(), image, width, height, width);
+    REPORTER_ASSERT(reporter, generated);
+
+    for (int y = 0; y < dfHeight; ++y) {
+        for (int x = 0; x < dfWidth; ++x) {
+            const int val = df[y*dfWidth + x];
+            const int mirrorX = df[y*dfWidth + dfWidth-1 - x];
+            const int mirrorY = df[(dfHeight-1 - y)*dfWidth + x];
+            REPORTER_ASSERT(reporter, SkTAbs(val - mirrorX) <= 1);
+            REPORTER_ASSERT(reporter, SkTAbs(val - mirrorY) <= 1);
+        }
+    }
+    // Inside the ring is above the midpoint, the hole and far outside are below it.
+    const int row = (dfHeight/2)*dfWidth;
+    REPORTER_ASSERT(reporter, df[row + SK_DistanceFieldPad + 6] > 128);
+    REPORTER_ASSERT(reporter, df[row + dfWidth/2] < 128);
+    REPORTER_ASSERT(reporter, 0 == df[0]);
+}
+
+DEF_TEST(DistanceFieldGen, reporter) {
+    // A square ring, wide enough that each row takes several groups of four texels.
+    static const int kSize = 22;
+    uint8_t a8[kSize*kSize];
+    uint8_t bw[kSize*((kSize + 7)/8)];
+    sk_bzero(bw, sizeof(bw));
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            const bool inside = x >= 3 && x < kSize-3 && y >= 3 && y < kSize-3 &&
+                                !(x >= 9 && x < kSize-9 && y >= 9 && y < kSize-9);
+            a8[y*kSize + x] = inside ? 0xFF : 0;
+            if (inside) {
+                bw[y*((kSize + 7)/8) + x/8] |= 0x80 >> (x & 7);
+            }
+        }
+    }
+    test_symmetric(reporter, a8, kSize, kSize, false);
+    test_symmetric(reporter, bw, kSize, kSize, true);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrAtlasTextContext.h"
+#include "GrDistanceFieldGlyphSet.h"
+#include "GrFontScaler.h"
+#include "SkData.h"
+#include "SkGlyphCache.h"
+#include "SkPaint.h"
+#include "SkStream.h"
+
+// Checks every glyph of set against the distance fields the atlas would generate for it.
+static void check_glyphs(skiatest::Reporter* reporter, const GrDistanceFieldGlyphSet* set,
+                         const SkPaint& paint, const uint16_t ids[], int count) {
+    REPORTER_ASSERT(reporter, GrAtlasTextContext::kDistanceFieldSizeCount == set->countStrikes());
+    for (int i = 0; i < set->countStrikes(); ++i) {
+        SkAutoDescriptor desc;
+        GrAtlasTextContext::GetDistanceFieldDescriptor(paint, i, &desc);
+        SkAutoTUnref<GrFontDescKey> key(SkNEW_ARGS(GrFontDescKey, (*desc.getDesc())));
+        REPORTER_ASSERT(reporter, i == set->findStrike(*key));
+
+        SkGlyphCache* cache = SkGlyphCache::DetachCache(paint.getTypeface(), desc.getDesc());
+        SkAutoTUnref<GrFontScaler> scaler(SkNEW_ARGS(GrFontScaler, (cache)));
+        for (int j = 0; j < count; ++j) {
+            const SkGlyph& glyph = cache->getGlyphIDMetrics(ids[j], 0, 0);
+            SkIRect bounds;
+            scaler->getPackedGlyphDFBounds(glyph, &bounds);
+            SkAutoTMalloc<uint8_t> expected(bounds.width() * bounds.height());
+            const uint8_t* image = set->findImage(i, glyph);
+            if (scaler->getPackedGlyphDFImage(glyph, bounds.width(), bounds.height(),
+                                              expected.get())) {
+                REPORTER_ASSERT(reporter, image && !memcmp(image, expected.get(),
+                                                           bounds.width() * bounds.height()));
+            } else {
+                REPORTER_ASSERT(reporter, NULL == image);
+            }
+        }
+        scaler.reset(NULL);
+        SkGlyphCache::AttachCache(cache);
+    }
+}
+
+DEF_TEST(DistanceFieldGlyphSet, reporter) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    static const char kText[] = "Hamburgefons 0123 ,.;";
+    const int count = paint.textToGlyphs(kText, sizeof(kText) - 1, NULL);
+    SkAutoTMalloc<uint16_t> ids(count);
+    paint.textToGlyphs(kText, sizeof(kText) - 1, ids.get());
+
+    SkAutoTUnref<GrDistanceFieldGlyphSet> set(GrDistanceFieldGlyphSet::Create(paint, ids.get(),
+                                                                              count));
+    check_glyphs(reporter, set, paint, ids.get(), count);
+
+    SkDynamicMemoryWStream wStream;
+    set->serialize(&wStream);
+    SkAutoTUnref<SkData> data(wStream.copyToData());
+    {
+        SkMemoryStream stream(data);
+        SkAutoTUnref<GrDistanceFieldGlyphSet> loaded(GrDistanceFieldGlyphSet::Deserialize(&stream,
+                                                                                          paint));
+        REPORTER_ASSERT(reporter, loaded.get());
+        if (loaded.get()) {
+            for (int i = 0; i < set->countStrikes(); ++i) {
+                REPORTER_ASSERT(reporter, set->countGlyphs(i) == loaded->countGlyphs(i));
+            }
+            check_glyphs(reporter, loaded, paint, ids.get(), count);
+        }
+    }
+
+    // A set is only found for text drawn in its style.
+    {
+        SkPaint bold(paint);
+        bold.setFakeBoldText(true);
+        SkAutoDescriptor desc;
+        GrAtlasTextContext::GetDistanceFieldDescriptor(bold, 0, &desc);
+        SkAutoTUnref<GrFontDescKey> key(SkNEW_ARGS(GrFontDescKey, (*desc.getDesc())));
+        REPORTER_ASSERT(reporter, -1 == set->findStrike(*key));
+    }
+
+    // Truncated data is rejected.
+    {
+        SkMemoryStream stream(data->data(), data->size() - 1);
+        SkAutoTUnref<GrDistanceFieldGlyphSet> loaded(GrDistanceFieldGlyphSet::Deserialize(&stream,
+                                                                                          paint));
+        REPORTER_ASSERT(reporter, NULL == loaded.get());
+    }
+}
+
+#endif
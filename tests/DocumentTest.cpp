@@ -1,6 +1,8 @@
 #include "Test.h"
 
+#include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkData.h"
 #include "SkDocument.h"
 #include "SkOSFile.h"
 #include "SkStream.h"
@@ -96,10 +98,133 @@ static void test_close(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, stream.bytesWritten() != 0);
 }
 
+static void draw_page(SkCanvas* canvas, const SkBitmap& bitmap, int pageIndex) {
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    SkString text;
+    text.printf("Page %d", pageIndex);
+    canvas->drawText(text.c_str(), text.size(), 10, 20, paint);
+    canvas->drawBitmap(bitmap, 10, 30);
+
+    // A layer becomes a form XObject used only by this page.
+    canvas->saveLayerAlpha(NULL, 0x80);
+    canvas->drawCircle(50, 50, 20, paint);
+    canvas->restore();
+}
+
+// Returns the offset of the last occurrence of substring in data, or -1.
+static int find_last(const SkData* data, const char substring[]) {
+    const char* bytes = (const char*)data->data();
+    const int length = SkToInt(strlen(substring));
+    for (int i = SkToInt(data->size()) - length; i >= 0; i--) {
+        if (0 == memcmp(bytes + i, substring, length)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int count_occurrences(const SkData* data, const char substring[]) {
+    const char* bytes = (const char*)data->data();
+    const size_t length = strlen(substring);
+    int count = 0;
+    for (size_t i = 0; i + length <= data->size(); i++) {
+        count += 0 == memcmp(bytes + i, substring, length);
+    }
+    return count;
+}
+
+// Checks that every cross reference table entry points at its object.
+static void check_xref_table(skiatest::Reporter* reporter, const SkData* data) {
+    // The cross reference table and trailer are plain text.
+    const int startXRef = find_last(data, "startxref\n");
+    const int xRef = find_last(data, "xref\n0 ");
+    REPORTER_ASSERT(reporter, startXRef > 0 && xRef > 0);
+    if (startXRef <= 0 || xRef <= 0) {
+        return;
+    }
+    const char* bytes = (const char*)data->data();
+    REPORTER_ASSERT(reporter, xRef == atoi(bytes + startXRef + strlen("startxref\n")));
+
+    const int objCount = atoi(bytes + xRef + strlen("xref\n0 "));
+    const char* entry = strstr(bytes + xRef, "65535 f \n") + strlen("65535 f \n");
+    for (int i = 1; i < objCount; i++, entry += 20) {
+        SkString expected;
+        expected.printf("%d 0 obj\n", i);
+        const int offset = atoi(entry);
+        REPORTER_ASSERT(reporter, offset > 0 && offset < xRef &&
+                                  0 == memcmp(bytes + offset, expected.c_str(), expected.size()));
+    }
+}
+
+static void test_streaming(skiatest::Reporter* reporter) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(16, 16);
+    bitmap.eraseColor(SK_ColorGREEN);
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreateStreamingPDF(&stream));
+
+    const int kPageCount = 3;
+    size_t lastBytesWritten = 0;
+    for (int i = 0; i < kPageCount; i++) {
+        draw_page(doc->beginPage(100, 100), bitmap, i);
+        doc->endPage();
+        // Each page is written as soon as it ends.
+        REPORTER_ASSERT(reporter, stream.bytesWritten() > lastBytesWritten);
+        lastBytesWritten = stream.bytesWritten();
+    }
+    REPORTER_ASSERT(reporter, doc->close());
+
+    SkAutoTUnref<SkData> data(stream.copyToData());
+    REPORTER_ASSERT(reporter, 0 == memcmp(data->data(), "%PDF", 4));
+    REPORTER_ASSERT(reporter, kPageCount == count_occurrences(data, "/Type /Page\n"));
+    // The bitmap is shared by every page, but written once.
+    REPORTER_ASSERT(reporter, 1 == count_occurrences(data, "/Subtype /Image"));
+    check_xref_table(reporter, data);
+
+    // A streaming document with no pages fails to close, like any other.
+    SkDynamicMemoryWStream emptyStream;
+    SkAutoTUnref<SkDocument> emptyDoc(SkDocument::CreateStreamingPDF(&emptyStream));
+    REPORTER_ASSERT(reporter, !emptyDoc->close());
+    REPORTER_ASSERT(reporter, emptyStream.bytesWritten() == 0);
+}
+
+static SkData* make_image_heavy_pdf(bool streaming) {
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(streaming ? SkDocument::CreateStreamingPDF(&stream)
+                                           : SkDocument::CreatePDF(&stream));
+    for (int i = 0; i < 20; i++) {
+        // A distinct bitmap for each page, so none are shared.
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(64, 64);
+        bitmap.eraseARGB(0xFF, i * 12, 255 - i * 12, 0x80);
+        draw_page(doc->beginPage(100, 100), bitmap, i);
+        doc->endPage();
+    }
+    doc->close();
+    return stream.copyToData();
+}
+
+// Objects are serialized in parallel, but must come out in order with the
+// same bytes every time.
+static void test_parallel_serialization(skiatest::Reporter* reporter) {
+    const bool streamingModes[] = { false, true };
+    for (bool streaming : streamingModes) {
+        SkAutoTUnref<SkData> first(make_image_heavy_pdf(streaming));
+        SkAutoTUnref<SkData> second(make_image_heavy_pdf(streaming));
+        REPORTER_ASSERT(reporter, first->equals(second));
+        REPORTER_ASSERT(reporter, 20 == count_occurrences(first, "/Subtype /Image"));
+        check_xref_table(reporter, first);
+    }
+}
+
 DEF_TEST(document_tests, reporter) {
     test_empty(reporter);
     test_abort(reporter);
     test_abortWithFile(reporter);
     test_file(reporter);
     test_close(reporter);
+    test_streaming(reporter);
+    test_parallel_serialization(reporter);
 }
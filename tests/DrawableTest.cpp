@@ -0,0 +1,81 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkDrawable.h"
+#include "Test.h"
+
+namespace {
+
+class CountingDrawable : public SkDrawable {
+public:
+    CountingDrawable() : fDraws(0), fColor(SK_ColorRED) {}
+
+    void setColor(SkColor color) {
+        fColor = color;
+        this->notifyDrawingChanged();
+    }
+
+    int fDraws;
+
+protected:
+    SkRect onGetBounds() override { return SkRect::MakeWH(10, 10); }
+
+    void onDraw(SkCanvas* canvas) override {
+        fDraws++;
+        SkPaint paint;
+        paint.setColor(fColor);
+        canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+    }
+
+private:
+    SkColor fColor;
+};
+
+}  // namespace
+
+DEF_TEST(Drawable_SnapshotCache, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(50, 50);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+
+    SkAutoTUnref<CountingDrawable> drawable(SkNEW(CountingDrawable));
+
+    // Without caching, every draw runs onDraw().
+    drawable->draw(&canvas);
+    drawable->draw(&canvas);
+    REPORTER_ASSERT(r, 2 == drawable->fDraws);
+
+    drawable->setCachesSnapshot(true);
+    drawable->fDraws = 0;
+    drawable->draw(&canvas, 0, 0);
+    drawable->draw(&canvas, 20, 20);   // Translation alone reuses the snapshot.
+    REPORTER_ASSERT(r, 1 == drawable->fDraws);
+    REPORTER_ASSERT(r, SK_ColorRED == bitmap.getColor(5, 5));
+    REPORTER_ASSERT(r, SK_ColorRED == bitmap.getColor(25, 25));
+    REPORTER_ASSERT(r, SK_ColorWHITE == bitmap.getColor(35, 35));
+
+    // A new generation ID re-renders.
+    drawable->setColor(SK_ColorBLUE);
+    drawable->draw(&canvas);
+    REPORTER_ASSERT(r, 2 == drawable->fDraws);
+    REPORTER_ASSERT(r, SK_ColorBLUE == bitmap.getColor(5, 5));
+
+    // So does a new scale, which is rendered at that scale.
+    SkMatrix scale = SkMatrix::MakeScale(2);
+    drawable->draw(&canvas, &scale);
+    REPORTER_ASSERT(r, 3 == drawable->fDraws);
+    REPORTER_ASSERT(r, SK_ColorBLUE == bitmap.getColor(15, 15));
+
+    // Perspective always gets the real drawing.
+    SkMatrix persp;
+    persp.setPerspX(SK_Scalar1 / 1000);
+    drawable->draw(&canvas, &persp);
+    drawable->draw(&canvas, &persp);
+    REPORTER_ASSERT(r, 5 == drawable->fDraws);
+}
@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkRandom.h"
 #include "SkTDynamicHash.h"
+#include "SkTGroupProbeHash.h"
 #include "Test.h"
 
 namespace {
@@ -31,6 +33,29 @@ private:
     typedef SkTDynamicHash<Entry, int> INHERITED;
 };
 
+// Every key hashes alike, so they all start probing from the same group.
+struct CollidingEntry {
+    int key;
+
+    static const int& GetKey(const CollidingEntry& entry) { return entry.key; }
+    static uint32_t Hash(const int&) { return 0; }
+};
+
+template <typename T>
+class GroupProbeHash : public SkTGroupProbeHash<T, int> {
+public:
+    GroupProbeHash() : INHERITED() {}
+
+    // Promote protected methods to public for this test.
+    int capacity() const { return this->INHERITED::capacity(); }
+    int countGroupCollisions(const int& key) const {
+        return this->INHERITED::countGroupCollisions(key);
+    }
+
+private:
+    typedef SkTGroupProbeHash<T, int> INHERITED;
+};
+
 }  // namespace
 
 #define ASSERT(x) REPORTER_ASSERT(reporter, x)
@@ -226,3 +251,100 @@ DEF_TEST(DynamicHash_reset, reporter) {
 DEF_TEST(DynamicHash_rewind, reporter) {
     TestResetOrRewind(reporter, false);
 }
+
+DEF_TEST(GroupProbeHash_growth, reporter) {
+    GroupProbeHash<Entry> hash;
+    ASSERT(hash.capacity() == 0);
+
+    Entry entries[15];
+    for (int i = 0; i < 15; i++) {
+        entries[i].key = i;
+        entries[i].value = i;
+        hash.add(&entries[i]);
+        // One group holds up to 7/8 of its slots before growing.
+        ASSERT(hash.capacity() == (i < 14 ? 16 : 32));
+    }
+    ASSERT(hash.count() == 15);
+    for (int i = 0; i < 15; i++) {
+        ASSERT(hash.find(i) == &entries[i]);
+    }
+}
+
+DEF_TEST(GroupProbeHash_lookup, reporter) {
+    GroupProbeHash<CollidingEntry> hash;
+    CollidingEntry entries[40];
+    for (int i = 0; i < 40; i++) {
+        entries[i].key = i;
+    }
+
+    // Before we insert anything, nothing can collide.
+    ASSERT(hash.countGroupCollisions(0) == 0);
+
+    // A group takes 16 colliding entries before they spill into the next one.
+    for (int i = 0; i < 16; i++) {
+        hash.add(&entries[i]);
+    }
+    ASSERT(hash.capacity() == 32);
+    ASSERT(hash.countGroupCollisions(0) == 0);
+    ASSERT(hash.countGroupCollisions(20) == 1);
+    for (int i = 16; i < 20; i++) {
+        hash.add(&entries[i]);
+    }
+    ASSERT(hash.countGroupCollisions(19) == 1);
+    ASSERT(hash.countGroupCollisions(20) == 1);
+
+    for (int i = 0; i < 20; i++) {
+        ASSERT(hash.find(i) == &entries[i]);
+    }
+    ASSERT(hash.find(20) == NULL);
+    ASSERT(hash.find(39) == NULL);
+
+    // Removing from a full group leaves a tombstone, so entries past it stay findable.
+    hash.remove(3);
+    ASSERT(hash.find(3) == NULL);
+    ASSERT(hash.find(19) == &entries[19]);
+    hash.add(&entries[20]);
+    ASSERT(hash.countGroupCollisions(20) == 0);
+    ASSERT(hash.find(20) == &entries[20]);
+    ASSERT(hash.count() == 20);
+}
+
+DEF_TEST(GroupProbeHash_random, reporter) {
+    static const int kN = 1000;
+    Entry entries[kN];
+    bool present[kN];
+    for (int i = 0; i < kN; i++) {
+        entries[i].key = i;
+        entries[i].value = i;
+        present[i] = false;
+    }
+
+    SkRandom rand;
+    GroupProbeHash<Entry> hash;
+    int count = 0;
+    for (int n = 0; n < 20000; n++) {
+        int i = rand.nextULessThan(kN);
+        if (present[i]) {
+            hash.remove(i);
+            count--;
+        } else {
+            hash.add(&entries[i]);
+            count++;
+        }
+        present[i] = !present[i];
+        ASSERT(hash.count() == count);
+        int j = rand.nextULessThan(kN);
+        ASSERT(hash.find(j) == (present[j] ? &entries[j] : NULL));
+    }
+
+    int seen = 0;
+    for (GroupProbeHash<Entry>::ConstIter iter(&hash); !iter.done(); ++iter) {
+        ASSERT(present[(*iter).key]);
+        seen++;
+    }
+    ASSERT(seen == count);
+
+    hash.rewind();
+    ASSERT(hash.count() == 0);
+    ASSERT(hash.find(entries[0].key) == NULL);
+}
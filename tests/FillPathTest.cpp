@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkScan.h"
 #include "Test.h"
@@ -43,3 +46,206 @@ DEF_TEST(FillPathInverse, reporter) {
 
   REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// Large AA fills are scan converted in parallel bands. The result should still be a clean
+// circle: solid inside, empty outside and about the right total coverage, with no seams.
+DEF_TEST(FillPathAntiAliasBands, reporter) {
+  const int size = 1500;
+  const SkScalar radius = 700;
+  SkBitmap bitmap;
+  bitmap.allocPixels(SkImageInfo::MakeA8(size, size));
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+
+  SkCanvas canvas(bitmap);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  SkPath path;
+  path.addCircle(size / 2 + 0.3f, size / 2 + 0.3f, radius);
+  canvas.drawPath(path, paint);
+
+  double total = 0;
+  bool solidCenterColumn = true;
+  for (int y = 0; y < size; ++y) {
+    const uint8_t* row = bitmap.getAddr8(0, y);
+    for (int x = 0; x < size; ++x) {
+      total += row[x];
+    }
+    if (SkScalarAbs(y + 0.5f - size / 2) < radius - 2 && 0xFF != row[size / 2]) {
+      solidCenterColumn = false;
+    }
+  }
+  REPORTER_ASSERT(reporter, solidCenterColumn);
+  REPORTER_ASSERT(reporter, 0 == *bitmap.getAddr8(0, 0));
+  REPORTER_ASSERT(reporter, 0 == *bitmap.getAddr8(size - 1, size - 1));
+
+  const double expected = 255 * SK_ScalarPI * radius * radius;
+  REPORTER_ASSERT(reporter, SkTAbs(total - expected) < expected * 0.001);
+}
+
+// Stores the coverage of a scan conversion in an A8 bitmap.
+struct CoverageBlitter : public SkBlitter {
+  CoverageBlitter(int width, int height) {
+    fBitmap.allocPixels(SkImageInfo::MakeA8(width, height));
+    fBitmap.eraseColor(SK_ColorTRANSPARENT);
+  }
+
+  void blitH(int x, int y, int width) override {
+    memset(fBitmap.getAddr8(x, y), 0xFF, width);
+  }
+
+  void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+    for (int count = runs[0]; count > 0; count = runs[0]) {
+      memset(fBitmap.getAddr8(x, y), antialias[0], count);
+      x += count;
+      runs += count;
+      antialias += count;
+    }
+  }
+
+  SkAlpha at(int x, int y) { return *fBitmap.getAddr8(x, y); }
+
+  SkBitmap fBitmap;
+};
+
+DEF_TEST(FillPathAnalyticAA, reporter) {
+  const SkIRect clip = SkIRect::MakeWH(40, 40);
+
+  // Partial pixels get their exact coverage.
+  {
+    CoverageBlitter blitter(40, 40);
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(10.25f, 10.5f, 20.75f, 30.5f));
+    SkScan::AAAFillPath(path, SkRasterClip(clip), &blitter);
+    REPORTER_ASSERT(reporter, 255 == blitter.at(15, 20));
+    REPORTER_ASSERT(reporter, 191 == blitter.at(10, 20));
+    REPORTER_ASSERT(reporter, 191 == blitter.at(20, 20));
+    REPORTER_ASSERT(reporter, 128 == blitter.at(15, 10));
+    REPORTER_ASSERT(reporter, 128 == blitter.at(15, 30));
+    REPORTER_ASSERT(reporter, 96 == blitter.at(10, 10));
+    REPORTER_ASSERT(reporter, 0 == blitter.at(9, 20));
+    REPORTER_ASSERT(reporter, 0 == blitter.at(21, 20));
+    REPORTER_ASSERT(reporter, 0 == blitter.at(15, 31));
+  }
+
+  // Edges outside the clip still fill the clipped part.
+  {
+    CoverageBlitter blitter(40, 40);
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(-10, 5, 50, 15));
+    SkScan::AAAFillPath(path, SkRasterClip(clip), &blitter);
+    bool solid = true;
+    for (int x = 0; x < 40; ++x) {
+      solid &= 255 == blitter.at(x, 10);
+    }
+    REPORTER_ASSERT(reporter, solid);
+    REPORTER_ASSERT(reporter, 0 == blitter.at(20, 4));
+  }
+
+  // Overlapping contours follow the fill rule.
+  {
+    SkPath path;
+    path.addRect(SkRect::MakeLTRB(5, 5, 25, 25));
+    path.addRect(SkRect::MakeLTRB(5, 5, 25, 25));
+    CoverageBlitter winding(40, 40);
+    SkScan::AAAFillPath(path, SkRasterClip(clip), &winding);
+    REPORTER_ASSERT(reporter, 255 == winding.at(15, 15));
+
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    CoverageBlitter evenOdd(40, 40);
+    SkScan::AAAFillPath(path, SkRasterClip(clip), &evenOdd);
+    REPORTER_ASSERT(reporter, 0 == evenOdd.at(15, 15));
+  }
+
+  // Curves come out close to the supersampler's result.
+  {
+    SkPath path;
+    path.addCircle(20.3f, 19.6f, 15);
+    CoverageBlitter analytic(40, 40), supersampled(40, 40);
+    SkScan::AAAFillPath(path, SkRasterClip(clip), &analytic);
+    SkScan::AntiFillPath(path, SkRasterClip(clip), &supersampled);
+    int maxDiff = 0;
+    for (int y = 0; y < 40; ++y) {
+      for (int x = 0; x < 40; ++x) {
+        maxDiff = SkTMax(maxDiff, SkAbs32(analytic.at(x, y) - supersampled.at(x, y)));
+      }
+    }
+    REPORTER_ASSERT(reporter, maxDiff <= 40);
+    REPORTER_ASSERT(reporter, 255 == analytic.at(20, 20));
+    REPORTER_ASSERT(reporter, 0 == analytic.at(0, 0));
+  }
+}
+
+// Records the widest row a scan conversion hands to blitAntiH().
+struct RowWidthBlitter : public SkBlitter {
+  RowWidthBlitter() : fMaxWidth(0) {}
+
+  void blitH(int x, int y, int width) override {
+    fMaxWidth = SkTMax(fMaxWidth, width);
+  }
+
+  void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+    int width = 0;
+    for (int count = runs[0]; count > 0; count = runs[width]) {
+      width += count;
+    }
+    fMaxWidth = SkTMax(fMaxWidth, width);
+  }
+
+  int fMaxWidth;
+};
+
+// A thin slanted sliver spans the whole width of its bounds, but each row only covers a few
+// pixels; only those should reach the blitter.
+DEF_TEST(FillPathAntiAliasRowExtent, reporter) {
+  SkPath path;
+  path.moveTo(0, 0);
+  path.lineTo(4000, 100);
+  path.lineTo(4000, 101.5f);
+  path.lineTo(0, 1.5f);
+  path.close();
+
+  RowWidthBlitter blitter;
+  SkScan::AntiFillPath(path, SkRasterClip(SkIRect::MakeWH(4000, 200)), &blitter);
+  REPORTER_ASSERT(reporter, blitter.fMaxWidth > 0 && blitter.fMaxWidth < 100);
+}
+
+// Repeated fills of a large path reuse its edges from SkResourceCache. The scan converter
+// advances edges in place, so every reuse has to start from the pristine edges again.
+DEF_TEST(FillPathEdgeCache, reporter) {
+  SkPath path;
+  path.moveTo(10, 10);
+  for (int i = 0; i < 400; ++i) {
+    SkScalar angle = 2 * SK_ScalarPI * i / 400;
+    SkScalar r = (i & 1) ? 20 : 90;
+    if (i % 5) {
+      path.lineTo(100 + r * SkScalarCos(angle), 100 + r * SkScalarSin(angle));
+    } else {
+      path.quadTo(100, 100, 100 + r * SkScalarCos(angle), 100 + r * SkScalarSin(angle));
+    }
+  }
+  path.close();
+  SkPath volatilePath(path);
+  volatilePath.setIsVolatile(true);
+
+  const SkIRect clips[] = { SkIRect::MakeWH(200, 200), SkIRect::MakeLTRB(50, 30, 150, 170) };
+  for (size_t c = 0; c < SK_ARRAY_COUNT(clips); ++c) {
+    for (int aa = 0; aa < 2; ++aa) {
+      CoverageBlitter expected(200, 200), first(200, 200), second(200, 200);
+      SkRasterClip clip(clips[c]);
+      if (aa) {
+        SkScan::AntiFillPath(volatilePath, clip, &expected);
+        SkScan::AntiFillPath(path, clip, &first);
+        SkScan::AntiFillPath(path, clip, &second);
+      } else {
+        SkScan::FillPath(volatilePath, clip, &expected);
+        SkScan::FillPath(path, clip, &first);
+        SkScan::FillPath(path, clip, &second);
+      }
+      size_t size = expected.fBitmap.getSize();
+      REPORTER_ASSERT(reporter, !memcmp(expected.fBitmap.getPixels(),
+                                        first.fBitmap.getPixels(), size));
+      REPORTER_ASSERT(reporter, !memcmp(expected.fBitmap.getPixels(),
+                                        second.fBitmap.getPixels(), size));
+    }
+  }
+}
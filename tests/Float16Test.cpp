@@ -0,0 +1,119 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkHalf.h"
+#include "SkPMFloat.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static bool colors_close(SkColor a, SkColor b, int tolerance) {
+    return SkTAbs((int)SkColorGetA(a) - (int)SkColorGetA(b)) <= tolerance &&
+           SkTAbs((int)SkColorGetR(a) - (int)SkColorGetR(b)) <= tolerance &&
+           SkTAbs((int)SkColorGetG(a) - (int)SkColorGetG(b)) <= tolerance &&
+           SkTAbs((int)SkColorGetB(a) - (int)SkColorGetB(b)) <= tolerance;
+}
+
+DEF_TEST(Float16_HalfToPMFloat, reporter) {
+    // Every finite, non-negative half must survive the trip through floats, in every lane.
+    for (uint32_t h = 0; h <= SK_HalfMax; ++h) {
+        uint64_t rgba = (uint64_t)h | (uint64_t)(SK_HalfMax - h) << 16 |
+                        (uint64_t)(h >> 1) << 32 | (uint64_t)0x3c00 << 48;
+        Sk4f pm = SkHalfToPMFloat(rgba);
+        SkPMFloat pmf(pm);
+        if (pmf.r() != SkHalfToFloat(h) || pmf.a() != 1.0f ||
+            SkPMFloatToHalf(pm) != rgba) {
+            ERRORF(reporter, "half 0x%x did not round trip", h);
+            return;
+        }
+    }
+
+    // Out of range values are clamped.
+    uint64_t clamped = SkPMFloatToHalf(SkPMFloat::FromARGB(1e6f, -1, 0.5f, 1));
+    REPORTER_ASSERT(reporter, SK_HalfMax == (SkHalf)(clamped >> 48));
+    REPORTER_ASSERT(reporter, 0 == (SkHalf)(clamped >> 0));
+}
+
+static void draw_test_content(SkCanvas* canvas) {
+    canvas->clear(SK_ColorWHITE);
+    SkPaint paint;
+    paint.setColor(0x80FF4020);
+    canvas->drawRect(SkRect::MakeXYWH(2, 2, 12, 12), paint);
+    paint.setAntiAlias(true);
+    paint.setColor(0xC02080FF);
+    canvas->drawCircle(8, 8, 5.5f, paint);
+    paint.setXfermodeMode(SkXfermode::kMultiply_Mode);
+    paint.setColor(0xFF808080);
+    canvas->drawRect(SkRect::MakeXYWH(0, 0, 16, 4), paint);
+}
+
+// Drawing into half floats must match drawing into 8888 up to its rounding.
+DEF_TEST(Float16_Draw, reporter) {
+    SkImageInfo info = SkImageInfo::Make(16, 16, kRGBA_F16_SkColorType, kPremul_SkAlphaType);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info));
+    REPORTER_ASSERT(reporter, surface);
+    if (!surface) {
+        return;
+    }
+    SkAutoTUnref<SkSurface> reference(SkSurface::NewRaster(info.makeColorType(kN32_SkColorType)));
+
+    draw_test_content(surface->getCanvas());
+    draw_test_content(reference->getCanvas());
+
+    SkBitmap f16, n32;
+    f16.allocPixels(info);
+    REPORTER_ASSERT(reporter, surface->getCanvas()->readPixels(&f16, 0, 0));
+    n32.allocN32Pixels(16, 16);
+    REPORTER_ASSERT(reporter, surface->getCanvas()->readPixels(&n32, 0, 0));
+
+    SkBitmap expected;
+    expected.allocN32Pixels(16, 16);
+    REPORTER_ASSERT(reporter, reference->getCanvas()->readPixels(&expected, 0, 0));
+
+    for (int y = 0; y < 16; ++y) {
+        for (int x = 0; x < 16; ++x) {
+            SkColor want = expected.getColor(x, y);
+            if (!colors_close(f16.getColor(x, y), want, 2) ||
+                !colors_close(n32.getColor(x, y), want, 2)) {
+                ERRORF(reporter, "pixel %d,%d: %08x %08x, expected %08x", x, y,
+                       f16.getColor(x, y), n32.getColor(x, y), want);
+                return;
+            }
+        }
+    }
+}
+
+// Half float bitmaps are sampled by the bitmap shader, with and without filtering.
+DEF_TEST(Float16_DrawBitmap, reporter) {
+    SkBitmap src;
+    src.allocPixels(SkImageInfo::Make(4, 4, kRGBA_F16_SkColorType, kPremul_SkAlphaType));
+    src.eraseColor(SK_ColorRED);
+    src.eraseArea(SkIRect::MakeWH(2, 4), SK_ColorBLUE);
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == src.getColor(0, 0));
+    REPORTER_ASSERT(reporter, SK_ColorRED == src.getColor(3, 3));
+    REPORTER_ASSERT(reporter, SkBitmap::ComputeIsOpaque(src));
+
+    SkBitmap dst;
+    dst.allocN32Pixels(16, 16);
+    SkCanvas canvas(dst);
+    canvas.clear(SK_ColorBLACK);
+    canvas.scale(4, 4);
+
+    SkPaint paint;
+    canvas.drawBitmap(src, 0, 0, &paint);
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == dst.getColor(1, 8));
+    REPORTER_ASSERT(reporter, SK_ColorRED == dst.getColor(14, 8));
+
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    canvas.drawBitmap(src, 0, 0, &paint);
+    // Bilerp blends the two columns across their boundary and keeps the ends pure.
+    SkColor mid = dst.getColor(8, 8);
+    REPORTER_ASSERT(reporter, SkColorGetR(mid) > 0 && SkColorGetB(mid) > 0);
+    REPORTER_ASSERT(reporter, SK_ColorBLUE == dst.getColor(0, 8));
+    REPORTER_ASSERT(reporter, SK_ColorRED == dst.getColor(15, 8));
+}
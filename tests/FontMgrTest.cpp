@@ -111,10 +111,60 @@ static void test_fontiter(skiatest::Reporter* reporter, bool verbose) {
     }
 }
 
+/*
+ *  Repeated matches, like the fallback lookups for each character of a run of text, should keep
+ *  finding the same typeface, and a fallback typeface must have the character it was found for.
+ */
+static void test_match_character(skiatest::Reporter* reporter) {
+    SkAutoTUnref<SkFontMgr> fm(SkFontMgr::RefDefault());
+    const SkFontStyle style;
+    const SkUnichar chars[] = { 'A', 'B', 'z', 0x00E9, 0x03A9, 0x0416, 0x4E2D, 0x4E2E, 0x3042 };
+    const char* langs[] = { "en", "ja" };
+
+    for (int i = 0; i < 2; ++i) {
+        SkAutoTUnref<SkTypeface> first(fm->matchFamilyStyle(NULL, style));
+        SkAutoTUnref<SkTypeface> again(fm->matchFamilyStyle(NULL, style));
+        REPORTER_ASSERT(reporter, first.get() == again.get());
+    }
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(chars); ++i) {
+        SkAutoTUnref<SkTypeface> first(fm->matchFamilyStyleCharacter(NULL, style, langs,
+                                                                     SK_ARRAY_COUNT(langs),
+                                                                     chars[i]));
+        if (NULL == first.get()) {
+            continue;
+        }
+        uint16_t glyph;
+        first->charsToGlyphs(&chars[i], SkTypeface::kUTF32_Encoding, &glyph, 1);
+        REPORTER_ASSERT(reporter, 0 != glyph);
+
+        SkAutoTUnref<SkTypeface> again(fm->matchFamilyStyleCharacter(NULL, style, langs,
+                                                                     SK_ARRAY_COUNT(langs),
+                                                                     chars[i]));
+        REPORTER_ASSERT(reporter, again.get() && first->uniqueID() == again->uniqueID());
+    }
+}
+
 DEFINE_bool(verboseFontMgr, false, "run verbose fontmgr tests.");
 
 DEF_TEST(FontMgr, reporter) {
     test_fontiter(reporter, FLAGS_verboseFontMgr);
     test_alias_names(reporter);
     test_font(reporter);
+    test_match_character(reporter);
+}
+
+#include "SkGraphics.h"
+
+// WarmUp() races the lazy initializers it triggers; whichever side gets there first, callers
+// must see the same singletons.
+DEF_TEST(FontMgr_WarmUp, reporter) {
+    SkGraphics::WarmUp();
+    SkAutoTUnref<SkFontMgr> fm(SkFontMgr::RefDefault());
+    SkAutoTUnref<SkTypeface> face(SkTypeface::RefDefault());
+    SkGraphics::WarmUp();
+    SkAutoTUnref<SkFontMgr> again(SkFontMgr::RefDefault());
+    REPORTER_ASSERT(reporter, fm.get() && fm.get() == again.get());
+    SkAutoTUnref<SkTypeface> faceAgain(SkTypeface::RefDefault());
+    REPORTER_ASSERT(reporter, face.get() == faceAgain.get());
 }
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphCache.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkTemplates.h"
+#include "Test.h"
+
+// Images generated together, on the task threads with their own scaler contexts, must match the
+// ones generated one at a time.
+DEF_TEST(GlyphCache_FindImages, reporter) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(19);
+    static const char kText[] = "The quick brown fox jumps over the lazy dog. 0123456789 "
+                                "PACK MY BOX WITH FIVE DOZEN LIQUOR JUGS? {}[]()<>#%&@!";
+    const int count = paint.textToGlyphs(kText, sizeof(kText) - 1, NULL);
+    SkAutoTMalloc<uint16_t> ids(count);
+    paint.textToGlyphs(kText, sizeof(kText) - 1, ids.get());
+
+    // Both strikes stay detached at once, so they can't be the same one.
+    SkAutoGlyphCache serial(paint, NULL, NULL);
+    SkAutoGlyphCache batched(paint, NULL, NULL);
+    REPORTER_ASSERT(reporter, serial.getCache() != batched.getCache());
+
+    for (int i = 0; i < count; ++i) {
+        batched.getCache()->getGlyphIDMetrics(ids[i]);
+    }
+    SkAutoTMalloc<const SkGlyph*> glyphs(count);
+    for (int i = 0; i < count; ++i) {
+        glyphs[i] = &batched.getCache()->getGlyphIDMetrics(ids[i]);
+    }
+    batched.getCache()->findImages(glyphs.get(), count);
+
+    for (int i = 0; i < count; ++i) {
+        const SkGlyph& expected = serial.getCache()->getGlyphIDMetrics(ids[i]);
+        const void* expectedImage = serial.getCache()->findImage(expected);
+        const SkGlyph& glyph = batched.getCache()->getGlyphIDMetrics(ids[i]);
+        REPORTER_ASSERT(reporter, SkToBool(expectedImage) == SkToBool(glyph.fImage));
+        if (expectedImage && glyph.fImage) {
+            REPORTER_ASSERT(reporter, expected.fMaskFormat == glyph.fMaskFormat);
+            REPORTER_ASSERT(reporter, !memcmp(expectedImage, glyph.fImage,
+                                              expected.computeImageSize()));
+        }
+    }
+}
+
+// With subpixel positioning the variants of a glyph share a cached outline. Whatever order the
+// variants are generated in, their paths and images must come out the same.
+DEF_TEST(GlyphCache_SubpixelOutlines, reporter) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setSubpixelText(true);
+    paint.setTextSize(17);
+    // Stroking makes the images come from the outlines too.
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(1.5f);
+
+    // More glyphs than the outline cache has slots, so entries get replaced.
+    static const int kGlyphCount = 150;
+    static const SkFixed kSubX[] = { 0, SK_Fixed1 / 4, SK_Fixed1 / 2, SK_Fixed1 * 3 / 4 };
+    static const int kVariantCount = SK_ARRAY_COUNT(kSubX);
+
+    SkAutoGlyphCache byGlyph(paint, NULL, NULL);
+    SkAutoGlyphCache byVariant(paint, NULL, NULL);
+    for (int id = 0; id < kGlyphCount; ++id) {
+        for (int v = 0; v < kVariantCount; ++v) {
+            const SkGlyph& glyph = byGlyph.getCache()->getGlyphIDMetrics(id, kSubX[v], 0);
+            byGlyph.getCache()->findImage(glyph);
+            byGlyph.getCache()->findPath(glyph);
+        }
+    }
+    for (int v = 0; v < kVariantCount; ++v) {
+        for (int id = 0; id < kGlyphCount; ++id) {
+            const SkGlyph& glyph = byVariant.getCache()->getGlyphIDMetrics(id, kSubX[v], 0);
+            byVariant.getCache()->findImage(glyph);
+            byVariant.getCache()->findPath(glyph);
+        }
+    }
+
+    for (int id = 0; id < kGlyphCount; ++id) {
+        for (int v = 0; v < kVariantCount; ++v) {
+            const SkGlyph& a = byGlyph.getCache()->getGlyphIDMetrics(id, kSubX[v], 0);
+            const SkGlyph& b = byVariant.getCache()->getGlyphIDMetrics(id, kSubX[v], 0);
+            REPORTER_ASSERT(reporter, a.fWidth == b.fWidth && a.fHeight == b.fHeight &&
+                                      a.fLeft == b.fLeft && a.fTop == b.fTop);
+            REPORTER_ASSERT(reporter, SkToBool(a.fPath) == SkToBool(b.fPath));
+            if (a.fPath && b.fPath) {
+                REPORTER_ASSERT(reporter, *a.fPath == *b.fPath);
+            }
+            REPORTER_ASSERT(reporter, SkToBool(a.fImage) == SkToBool(b.fImage));
+            if (a.fImage && b.fImage) {
+                REPORTER_ASSERT(reporter, SkMask::kA8_Format == a.fMaskFormat);
+                // Only the pixels are written; the padding at the end of each row isn't.
+                for (int y = 0; y < a.fHeight; ++y) {
+                    REPORTER_ASSERT(reporter, !memcmp((const char*)a.fImage + y * a.rowBytes(),
+                                                      (const char*)b.fImage + y * b.rowBytes(),
+                                                      a.fWidth));
+                }
+            }
+        }
+    }
+}
+
+// Measuring glyph ids and UTF32 goes through the strike's bulk lookups; it must agree with
+// measuring the same text as UTF8, which still goes a glyph at a time.
+DEF_TEST(GlyphCache_BulkMetrics, reporter) {
+    static const char kText[] = "Sphinx of black quartz, judge my vow! 1234567890 ~`^_=+|\\/";
+    static const size_t kLen = sizeof(kText) - 1;
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(23);
+    const int count = paint.textToGlyphs(kText, kLen, NULL);
+    SkAutoTMalloc<uint16_t> ids(count);
+    paint.textToGlyphs(kText, kLen, ids.get());
+    SkAutoTMalloc<SkUnichar> chars(count);
+    paint.glyphsToUnichars(ids.get(), count, chars.get());
+
+    {
+        SkAutoGlyphCache cache(paint, NULL, NULL);
+        SkAutoTMalloc<SkFixed> advanceX(count), advanceY(count);
+        SkAutoTMalloc<SkIRect> bounds(count);
+        cache.getCache()->getGlyphIDAdvances(ids.get(), count, advanceX.get(), advanceY.get(),
+                                             bounds.get());
+        for (int i = 0; i < count; ++i) {
+            const SkGlyph& glyph = cache.getCache()->getGlyphIDMetrics(ids[i]);
+            REPORTER_ASSERT(reporter, glyph.fAdvanceX == advanceX[i]);
+            REPORTER_ASSERT(reporter, glyph.fAdvanceY == advanceY[i]);
+            REPORTER_ASSERT(reporter, SkIRect::MakeXYWH(glyph.fLeft, glyph.fTop,
+                                                        glyph.fWidth, glyph.fHeight) == bounds[i]);
+        }
+    }
+
+    for (int vertical = 0; vertical < 2; ++vertical) {
+        for (int scaled = 0; scaled < 2; ++scaled) {
+            paint.setVerticalText(SkToBool(vertical));
+            // Big enough text is measured at a canonical size and scaled.
+            paint.setTextSize(scaled ? 300.f : 23.f);
+
+            paint.setTextEncoding(SkPaint::kUTF8_TextEncoding);
+            SkRect expectedBounds;
+            const SkScalar expectedWidth = paint.measureText(kText, kLen, &expectedBounds);
+            SkAutoTMalloc<SkScalar> expectedWidths(count);
+            SkAutoTMalloc<SkRect> expectedGlyphBounds(count);
+            paint.getTextWidths(kText, kLen, expectedWidths.get(), expectedGlyphBounds.get());
+
+            const struct {
+                SkPaint::TextEncoding fEncoding;
+                const void*           fText;
+                size_t                fLength;
+            } kRecs[] = {
+                { SkPaint::kGlyphID_TextEncoding, ids.get(),   count * sizeof(uint16_t) },
+                { SkPaint::kUTF32_TextEncoding,   chars.get(), count * sizeof(SkUnichar) },
+            };
+            for (size_t r = 0; r < SK_ARRAY_COUNT(kRecs); ++r) {
+                paint.setTextEncoding(kRecs[r].fEncoding);
+                SkRect textBounds;
+                REPORTER_ASSERT(reporter, expectedWidth ==
+                                paint.measureText(kRecs[r].fText, kRecs[r].fLength, &textBounds));
+                REPORTER_ASSERT(reporter, expectedBounds == textBounds);
+                REPORTER_ASSERT(reporter, expectedWidth ==
+                                paint.measureText(kRecs[r].fText, kRecs[r].fLength));
+
+                SkAutoTMalloc<SkScalar> widths(count);
+                SkAutoTMalloc<SkRect> glyphBounds(count);
+                REPORTER_ASSERT(reporter, count == paint.getTextWidths(kRecs[r].fText,
+                                                                       kRecs[r].fLength,
+                                                                       widths.get(),
+                                                                       glyphBounds.get()));
+                for (int i = 0; i < count; ++i) {
+                    REPORTER_ASSERT(reporter, expectedWidths[i] == widths[i]);
+                    REPORTER_ASSERT(reporter, expectedGlyphBounds[i] == glyphBounds[i]);
+                }
+            }
+        }
+    }
+}
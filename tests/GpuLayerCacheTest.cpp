@@ -29,6 +29,9 @@ public:
                                const unsigned* key, int keySize) {
         return cache->findLayer(pictureID, initialMat, key, keySize);
     }
+    static int NumPlotsX(GrLayerCache* cache) {
+        return cache->numPlotsX();
+    }
 };
 
 // Add several layers to the cache
@@ -179,14 +182,28 @@ DEF_GPUTEST(GpuLayerCache, reporter, factory) {
         {
             unsigned indices[1] = { kInitialNumLayers+1 };
 
-            // Add an additional layer. Since all the layers are unlocked this 
-            // will force out the first atlased layer
-            create_layers(reporter, &cache, *picture, 1, kInitialNumLayers);
-            GrCachedLayer* layer = TestingAccess::Find(&cache, picture->uniqueID(), SkMatrix::I(),
-                                                       indices, 1);
+            // The 5th layer didn't fit in the atlas while the first 4 were locked
+            // so the atlas grows (throwing away the atlased layers) once they
+            // are all unlocked.
+            REPORTER_ASSERT(reporter, 2 == TestingAccess::NumPlotsX(&cache));
+            cache.processDeletedPictures();
+            REPORTER_ASSERT(reporter, 4 == TestingAccess::NumPlotsX(&cache));
+
+            // Add an additional layer. It lands in the newly grown atlas.
+            GrCachedLayer* layer = cache.findLayerOrCreate(picture->uniqueID(),
+                                                           kInitialNumLayers+1,
+                                                           kInitialNumLayers+2,
+                                                           SkIRect::MakeEmpty(),
+                                                           SkIRect::MakeEmpty(),
+                                                           SkMatrix::I(),
+                                                           indices, 1,
+                                                           NULL);
             REPORTER_ASSERT(reporter, layer);
+            REPORTER_ASSERT(reporter, TestingAccess::NumLayers(&cache) == 2);
 
             lock_layer(reporter, &cache, layer);
+            REPORTER_ASSERT(reporter, layer->isAtlased());
+            REPORTER_ASSERT(reporter, 2048 == layer->texture()->width());
             cache.removeUse(layer);
         }
 
@@ -195,26 +212,38 @@ DEF_GPUTEST(GpuLayerCache, reporter, factory) {
 
             GrCachedLayer* layer = TestingAccess::Find(&cache, picture->uniqueID(), SkMatrix::I(),
                                                        indices, 1);
-#if GR_CACHE_HOISTED_LAYERS
-            // 3 old layers plus the new one should be in the atlas.
-            if (1 == i || 2 == i || 3 == i || 5 == i) {
+            if (5 == i) {
+                // The new layer should still be in the atlas
                 REPORTER_ASSERT(reporter, layer);
                 REPORTER_ASSERT(reporter, !layer->locked());
                 REPORTER_ASSERT(reporter, layer->texture());
                 REPORTER_ASSERT(reporter, layer->isAtlased());
             } else if (4 == i) {
-#endif
                 // The one that was never atlased should still be around
                 REPORTER_ASSERT(reporter, layer);
 
                 REPORTER_ASSERT(reporter, NULL == layer->texture());
                 REPORTER_ASSERT(reporter, !layer->isAtlased());
-#if GR_CACHE_HOISTED_LAYERS
+
+                // Its rendering was left in the resource cache when it was
+                // unlocked so locking it again doesn't require re-rendering.
+                GrSurfaceDesc desc;
+                desc.fWidth = 512;
+                desc.fHeight = 512;
+                desc.fConfig = kSkia8888_GrPixelConfig;
+
+                bool needsRerendering;
+                REPORTER_ASSERT(reporter, cache.lock(layer, desc, &needsRerendering));
+                REPORTER_ASSERT(reporter, !needsRerendering);
+                REPORTER_ASSERT(reporter, layer->texture());
+                REPORTER_ASSERT(reporter, !layer->isAtlased());
+
+                cache.addUse(layer);
+                cache.removeUse(layer);
             } else {
-                // The one bumped out of the atlas (i.e., 0) should be gone
+                // The ones in the atlas when it grew should be gone
                 REPORTER_ASSERT(reporter, NULL == layer);
             }
-#endif
         }
 
         //--------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 #if SK_SUPPORT_GPU
 
+#include "GrRectanizer_maxrects.h"
 #include "GrRectanizer_pow2.h"
 #include "GrRectanizer_skyline.h"
 #include "SkRandom.h"
@@ -58,6 +59,33 @@ static void test_pow2(skiatest::Reporter* reporter, const SkTDArray<SkISize>& re
     test_rectanizer_inserts(reporter, &pow2Rectanizer, rects);
 }
 
+static void test_maxrects(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
+    GrRectanizerMaxRects maxRectsRectanizer(kWidth, kHeight);
+
+    test_rectanizer_basic(reporter, &maxRectsRectanizer);
+    test_rectanizer_inserts(reporter, &maxRectsRectanizer, rects);
+
+    // Placed rects must stay in bounds and never overlap.
+    maxRectsRectanizer.reset();
+    SkRandom rand;
+    SkTDArray<SkIRect> placed;
+    for (;;) {
+        int w = rand.nextRangeU(1, kWidth / 16);
+        int h = rand.nextRangeU(1, kHeight / 16);
+        SkIPoint16 loc;
+        if (!maxRectsRectanizer.addRect(w, h, &loc)) {
+            break;
+        }
+        SkIRect r = SkIRect::MakeXYWH(loc.fX, loc.fY, w, h);
+        REPORTER_ASSERT(reporter, r.fRight <= kWidth && r.fBottom <= kHeight);
+        for (int i = 0; i < placed.count(); ++i) {
+            REPORTER_ASSERT(reporter, !SkIRect::Intersects(r, placed[i]));
+        }
+        placed.push(r);
+    }
+    REPORTER_ASSERT(reporter, maxRectsRectanizer.percentFull() > 0.85f);
+}
+
 DEF_GPUTEST(GpuRectanizer, reporter, factory) {
     SkTDArray<SkISize> rects;
     SkRandom rand;
@@ -69,6 +97,7 @@ DEF_GPUTEST(GpuRectanizer, reporter, factory) {
 
     test_skyline(reporter, rects);
     test_pow2(reporter, rects);
+    test_maxrects(reporter, rects);
 }
 
 #endif
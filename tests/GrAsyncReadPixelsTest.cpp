@@ -0,0 +1,90 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+
+namespace {
+struct ReadResult {
+    int      fCalls;
+    bool     fSucceeded;
+    uint32_t fPixels[2];
+};
+}
+
+static void record_read(void* info, const void* pixels, size_t rowBytes) {
+    ReadResult* result = static_cast<ReadResult*>(info);
+    ++result->fCalls;
+    result->fSucceeded = SkToBool(pixels);
+    if (pixels) {
+        const uint32_t* row = static_cast<const uint32_t*>(pixels);
+        result->fPixels[0] = row[0];
+        row = reinterpret_cast<const uint32_t*>(static_cast<const char*>(pixels) + rowBytes);
+        result->fPixels[1] = row[0];
+    }
+}
+
+DEF_GPUTEST(GrAsyncReadPixels, reporter, factory) {
+    for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+        if (!GrContextFactory::IsRenderingGLContext(glType)) {
+            continue;
+        }
+        GrContext* context = factory->get(glType);
+        if (NULL == context) {
+            continue;
+        }
+
+        SkImageInfo info = SkImageInfo::MakeN32Premul(16, 16);
+        SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context,
+                                                                   SkSurface::kNo_Budgeted,
+                                                                   info));
+        if (!surface) {
+            continue;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+        GrRenderTarget* rt = canvas->internal_private_accessTopLayerRenderTarget();
+        if (!rt) {
+            continue;
+        }
+
+        // The top row is red and the rest blue, so a flipped read is caught.
+        canvas->clear(SK_ColorBLUE);
+        SkPaint paint;
+        paint.setColor(SK_ColorRED);
+        canvas->drawRect(SkRect::MakeWH(16, 1), paint);
+
+        ReadResult result = { 0, false, { 0, 0 } };
+        REPORTER_ASSERT(reporter, context->readSurfacePixelsAsync(rt, 0, 0, 16, 2,
+                                                                  kSkia8888_GrPixelConfig,
+                                                                  record_read, &result));
+        context->finishAsyncReads(true);
+        REPORTER_ASSERT(reporter, 1 == result.fCalls);
+        REPORTER_ASSERT(reporter, result.fSucceeded);
+
+        uint32_t expected[2 * 16];
+        REPORTER_ASSERT(reporter, context->readSurfacePixels(rt, 0, 0, 16, 2,
+                                                             kSkia8888_GrPixelConfig, expected));
+        REPORTER_ASSERT(reporter, expected[0] == result.fPixels[0]);
+        REPORTER_ASSERT(reporter, expected[16] == result.fPixels[1]);
+        REPORTER_ASSERT(reporter, result.fPixels[0] != result.fPixels[1]);
+
+        // Reads outside of the surface are rejected without calling back.
+        REPORTER_ASSERT(reporter, !context->readSurfacePixelsAsync(rt, 8, 8, 16, 16,
+                                                                   kSkia8888_GrPixelConfig,
+                                                                   record_read, &result));
+        context->finishAsyncReads(true);
+        REPORTER_ASSERT(reporter, 1 == result.fCalls);
+    }
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrDefaultGeoProcFactory.h"
+
+DEF_TEST(GrDefaultGeoProcFactory_PackedPositions, reporter) {
+    using namespace GrDefaultGeoProcFactory;
+
+    SkIPoint tileOrigin;
+    REPORTER_ASSERT(reporter, CanPackDevicePositions(SkRect::MakeLTRB(10.5f, -3.25f, 500, 700),
+                                                     &tileOrigin));
+    REPORTER_ASSERT(reporter, SkIPoint::Make(10, -4) == tileOrigin);
+
+    // Too big for a single tile
+    REPORTER_ASSERT(reporter, !CanPackDevicePositions(SkRect::MakeWH(4096, 10), &tileOrigin));
+    REPORTER_ASSERT(reporter, !CanPackDevicePositions(SkRect::MakeLTRB(0, 0, SK_ScalarInfinity,
+                                                                       10), &tileOrigin));
+
+    // Positions round trip to within 1/32 of a pixel
+    REPORTER_ASSERT(reporter, CanPackDevicePositions(SkRect::MakeLTRB(100, 200, 2100, 2200),
+                                                     &tileOrigin));
+    static const SkPoint kPts[] = { { 100, 200 }, { 2099.97f, 2200 }, { 1000.3f, 1234.56f } };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(kPts); ++i) {
+        int16_t packed[2];
+        PackDevicePosition(kPts[i], tileOrigin, packed);
+        SkScalar x = tileOrigin.fX + packed[0] / SkIntToScalar(1 << kPackedPositionFractionBits);
+        SkScalar y = tileOrigin.fY + packed[1] / SkIntToScalar(1 << kPackedPositionFractionBits);
+        REPORTER_ASSERT(reporter, SkScalarAbs(x - kPts[i].fX) <= SK_Scalar1 / 32);
+        REPORTER_ASSERT(reporter, SkScalarAbs(y - kPts[i].fY) <= SK_Scalar1 / 32);
+    }
+}
+
+DEF_TEST(GrDefaultGeoProcFactory_HalfLocalCoords, reporter) {
+    using namespace GrDefaultGeoProcFactory;
+
+    REPORTER_ASSERT(reporter, CanUseHalfLocalCoords(SkRect::MakeLTRB(-1, 0, 256, 100)));
+    REPORTER_ASSERT(reporter, !CanUseHalfLocalCoords(SkRect::MakeWH(1024, 1)));
+
+    SkHalf packed[2];
+    PackLocalCoord(SkPoint::Make(0.5f, 200.125f), packed);
+    REPORTER_ASSERT(reporter, 0.5f == SkHalfToFloat(packed[0]));
+    REPORTER_ASSERT(reporter, 200.125f == SkHalfToFloat(packed[1]));
+}
+
+DEF_TEST(GrDefaultGeoProcFactory_CompactStride, reporter) {
+    using namespace GrDefaultGeoProcFactory;
+
+    Coverage coverage(Coverage::kSolid_Type);
+
+    // The uncompacted layout: float position, color and float local coords
+    SkAutoTUnref<const GrGeometryProcessor> gp(
+            Create(Color(Color::kAttribute_Type), coverage,
+                   LocalCoords(LocalCoords::kHasExplicit_Type), SkMatrix::I()));
+    REPORTER_ASSERT(reporter, sizeof(PositionColorLocalCoordAttr) == gp->getVertexStride());
+
+    // Uniform color, packed positions and half local coords
+    gp.reset(Create(Color(GrColor_WHITE), coverage,
+                    LocalCoords(LocalCoords::kHasExplicitHalf_Type), SkMatrix::I(),
+                    Position(SkIPoint::Make(64, 64))));
+    REPORTER_ASSERT(reporter, 2 * sizeof(int16_t) + 2 * sizeof(SkHalf) == gp->getVertexStride());
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrDownscaleUtils.h"
+#include "GrTexture.h"
+#include "SkUtils.h"
+#include "effects/GrConvolutionEffect.h"
+
+DEF_TEST(GrDownscaleUtils_LanczosKernel, reporter) {
+    static const float kScales[] = { 0.5f, 0.6f, 0.75f, 0.99f };
+    for (size_t s = 0; s < SK_ARRAY_COUNT(kScales); ++s) {
+        float kernel[GrConvolutionEffect::kMaxKernelWidth];
+        int radius;
+        GrDownscaleUtils::ComputeLanczosKernel(kScales[s], kernel, &radius);
+        REPORTER_ASSERT(reporter, radius >= 3 && radius <= GrDownscaleUtils::kMaxLanczosRadius);
+
+        float sum = 0.f;
+        for (int i = 0; i < 2 * radius + 1; ++i) {
+            sum += kernel[i];
+        }
+        REPORTER_ASSERT(reporter, SkScalarNearlyEqual(sum, 1.f));
+        for (int i = 1; i <= radius; ++i) {
+            REPORTER_ASSERT(reporter, SkScalarNearlyEqual(kernel[radius - i],
+                                                          kernel[radius + i]));
+            REPORTER_ASSERT(reporter, kernel[radius] > kernel[radius + i]);
+        }
+    }
+}
+
+// A flat image must stay flat however far it is scaled down.
+DEF_GPUTEST(GrDownscaleUtils_Downscale, reporter, factory) {
+    for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+        if (!GrContextFactory::IsRenderingGLContext(glType)) {
+            continue;
+        }
+        GrContext* context = factory->get(glType);
+        if (NULL == context) {
+            continue;
+        }
+
+        static const int kSize = 64;
+        static const uint32_t kColor = 0xFF4080C0;
+        SkAutoTMalloc<uint32_t> pixels(kSize * kSize);
+        sk_memset32(pixels.get(), kColor, kSize * kSize);
+
+        GrSurfaceDesc desc;
+        desc.fWidth = kSize;
+        desc.fHeight = kSize;
+        desc.fConfig = kRGBA_8888_GrPixelConfig;
+        SkAutoTUnref<GrTexture> src(context->textureProvider()->createTexture(desc, false,
+                                                                             pixels.get(), 0));
+        if (!src) {
+            continue;
+        }
+
+        static const int kDstSizes[] = { 48, 21, 5 };
+        for (size_t i = 0; i < SK_ARRAY_COUNT(kDstSizes); ++i) {
+            int dstSize = kDstSizes[i];
+            SkAutoTUnref<GrTexture> dst(GrDownscaleUtils::Downscale(
+                    context, src, SkIRect::MakeWH(kSize, kSize), dstSize, dstSize));
+            REPORTER_ASSERT(reporter, dst);
+            if (!dst) {
+                continue;
+            }
+            REPORTER_ASSERT(reporter, dst->width() == dstSize && dst->height() == dstSize);
+
+            SkAutoTMalloc<uint32_t> result(dstSize * dstSize);
+            REPORTER_ASSERT(reporter, dst->readPixels(0, 0, dstSize, dstSize,
+                                                      kRGBA_8888_GrPixelConfig, result.get()));
+            bool flat = true;
+            for (int p = 0; p < dstSize * dstSize; ++p) {
+                for (int c = 0; c < 32; c += 8) {
+                    int expected = (kColor >> c) & 0xFF;
+                    int actual = (result[p] >> c) & 0xFF;
+                    if (SkTAbs(expected - actual) > 1) {
+                        flat = false;
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, flat);
+        }
+    }
+}
+
+#endif
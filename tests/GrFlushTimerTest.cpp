@@ -0,0 +1,91 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+#include "gl/GrGLUtil.h"
+
+namespace {
+struct TimingResults {
+    int      fReports;
+    bool     fEntriesSumToTotal;
+    uint32_t fRenderTargetID;
+    bool     fSawRenderTarget;
+};
+}
+
+static void record_timing(const GrContext::GpuTimingStats& stats, void* info) {
+    TimingResults* results = static_cast<TimingResults*>(info);
+    ++results->fReports;
+    uint64_t total = 0;
+    for (int i = 0; i < stats.fEntryCount; ++i) {
+        total += stats.fEntries[i].fNanoseconds;
+        if (stats.fEntries[i].fRenderTargetID == results->fRenderTargetID) {
+            results->fSawRenderTarget = true;
+        }
+    }
+    if (total != stats.fTotalNanoseconds) {
+        results->fEntriesSumToTotal = false;
+    }
+}
+
+// Each flush's timing is reported from a later flush once the GPU has finished it.
+DEF_GPUTEST(GrFlushTimer, reporter, factory) {
+    for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+        if (!GrContextFactory::IsRenderingGLContext(glType)) {
+            continue;
+        }
+        GrContext* context = factory->get(glType);
+        if (NULL == context) {
+            continue;
+        }
+
+        SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+        SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context,
+                                                                   SkSurface::kNo_Budgeted,
+                                                                   info));
+        if (!surface) {
+            continue;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+        GrRenderTarget* rt = canvas->internal_private_accessTopLayerRenderTarget();
+        if (!rt) {
+            continue;
+        }
+
+        TimingResults results = { 0, true, rt->getUniqueID(), false };
+        if (!context->setGpuTimingCallback(record_timing, &results)) {
+            continue;
+        }
+
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(4, 4, 20, 20), paint);
+        context->flush();
+
+        SkGLContext* glContext = factory->getGLContext(glType);
+        for (int i = 0; i < 100 && !results.fReports; ++i) {
+            GR_GL_CALL(glContext->gl(), Finish());
+            context->flush();
+        }
+        context->setGpuTimingCallback(NULL, NULL);
+
+        // A disjoint flush is dropped so the report may legitimately never come.
+        if (results.fReports) {
+            REPORTER_ASSERT(reporter, results.fEntriesSumToTotal);
+            REPORTER_ASSERT(reporter, results.fSawRenderTarget);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+#include "gl/GrGLProgramDataManager.h"
+
+static void add_uniform(GrGLProgramDataManager::UniformInfoArray* uniforms, GrSLType type,
+                        int arrayCount) {
+    GrGLProgramDataManager::UniformInfo& uni = uniforms->push_back();
+    uni.fVariable.setType(type);
+    uni.fVariable.setArrayCount(arrayCount);
+    uni.fBlockOffset = -1;
+}
+
+// Uniform block members must be placed where the std140 rules put them since the GLSL compiler
+// is never asked for the offsets.
+DEF_TEST(GrGLUniformBlock_Std140Layout, reporter) {
+    GrGLProgramDataManager::UniformInfoArray uniforms(8);
+    add_uniform(&uniforms, kFloat_GrSLType, GrGLShaderVar::kNonArray);    // 0
+    add_uniform(&uniforms, kVec2f_GrSLType, GrGLShaderVar::kNonArray);    // 8
+    add_uniform(&uniforms, kSampler2D_GrSLType, GrGLShaderVar::kNonArray);
+    add_uniform(&uniforms, kVec3f_GrSLType, GrGLShaderVar::kNonArray);    // 16
+    add_uniform(&uniforms, kFloat_GrSLType, GrGLShaderVar::kNonArray);    // 28
+    add_uniform(&uniforms, kMat33f_GrSLType, GrGLShaderVar::kNonArray);   // 32
+    add_uniform(&uniforms, kFloat_GrSLType, 3);                           // 80, stride 16
+    add_uniform(&uniforms, kVec2f_GrSLType, GrGLShaderVar::kNonArray);    // 128
+
+    size_t size = GrGLProgramDataManager::LayoutUniformBlock(&uniforms);
+
+    static const int kExpectedOffsets[] = { 0, 8, -1, 16, 28, 32, 80, 128 };
+    for (int i = 0; i < uniforms.count(); ++i) {
+        REPORTER_ASSERT(reporter, kExpectedOffsets[i] == uniforms[i].fBlockOffset);
+    }
+    // The block is padded to a whole vec4.
+    REPORTER_ASSERT(reporter, 144 == size);
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrGpu.h"
+#include "SkCanvas.h"
+#include "SkSurface.h"
+
+#if GR_GPU_STATS
+
+// Drawing the same thing twice should let the backend's state shadowing skip rebinding the
+// program.
+DEF_GPUTEST(GrGpuStatsSkippedCalls, reporter, factory) {
+    for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+        if (!GrContextFactory::IsRenderingGLContext(glType)) {
+            continue;
+        }
+        GrContext* context = factory->get(glType);
+        if (NULL == context) {
+            continue;
+        }
+
+        SkImageInfo info = SkImageInfo::MakeN32Premul(64, 64);
+        SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context,
+                                                                   SkSurface::kNo_Budgeted,
+                                                                   info));
+        if (!surface) {
+            continue;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+
+        SkPaint paint;
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawRect(SkRect::MakeXYWH(4, 4, 20, 20), paint);
+        canvas->flush();
+
+        GrGpu::Stats* stats = context->getGpu()->stats();
+        int programBinds = stats->skippedProgramBinds();
+
+        canvas->drawRect(SkRect::MakeXYWH(4, 4, 20, 20), paint);
+        canvas->flush();
+
+        REPORTER_ASSERT(reporter, stats->skippedProgramBinds() > programBinds);
+    }
+}
+
+#endif
+#endif
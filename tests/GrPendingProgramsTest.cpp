@@ -0,0 +1,88 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+#if SK_SUPPORT_GPU
+#include "GrContextFactory.h"
+#include "SkCanvas.h"
+#include "SkColorFilter.h"
+#include "SkGradientShader.h"
+#include "SkSurface.h"
+
+static const int kSize = 64;
+
+// Every draw uses a program the context hasn't built yet, and the AA clip is drawn into a cached
+// clip mask, so a draw that was skipped while its program compiled would show up in the pixels.
+static void draw_scene(SkCanvas* canvas) {
+    SkPath clip;
+    clip.moveTo(2, 2);
+    clip.lineTo(kSize - 5, 7);
+    clip.lineTo(kSize / 2, kSize - 3);
+    clip.close();
+    clip.addCircle(kSize / 2, kSize / 2, 12, SkPath::kCCW_Direction);
+    canvas->clipPath(clip, SkRegion::kIntersect_Op, true);
+
+    const SkPoint pts[] = { { 0, 0 }, { kSize, kSize } };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    SkPaint paint;
+    paint.setShader(SkGradientShader::CreateLinear(pts, colors, NULL, 2,
+                                                   SkShader::kClamp_TileMode))->unref();
+    canvas->drawRect(SkRect::MakeWH(kSize, kSize), paint);
+
+    paint.setShader(SkGradientShader::CreateRadial(pts[1], kSize / 2, colors, NULL, 2,
+                                                   SkShader::kMirror_TileMode))->unref();
+    paint.setAntiAlias(true);
+    canvas->drawOval(SkRect::MakeXYWH(8, 8, 40, 24), paint);
+
+    paint.setShader(NULL);
+    paint.setColor(SK_ColorGREEN);
+    paint.setColorFilter(SkColorFilter::CreateModeFilter(0x80FFFF00,
+                                                         SkXfermode::kSrcOver_Mode))->unref();
+    canvas->drawCircle(40, 40, 14, paint);
+}
+
+static bool render(GrContextFactory* factory, GrContextFactory::GLContextType type,
+                   SkBitmap* bitmap) {
+    GrContext* context = factory->get(type);
+    if (NULL == context) {
+        return false;
+    }
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (!surface) {
+        return false;
+    }
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    draw_scene(surface->getCanvas());
+    bitmap->allocPixels(info);
+    return surface->getCanvas()->readPixels(bitmap, 0, 0);
+}
+
+// Programs prepared ahead of a flush must still be used by its draws, never skipped.
+DEF_GPUTEST(GrPendingPrograms, reporter, factory) {
+    GrContextOptions options;
+    options.fAllowPendingPrograms = true;
+    GrContextFactory pendingFactory(options);
+
+    for (int type = 0; type < GrContextFactory::kLastGLContextType; ++type) {
+        GrContextFactory::GLContextType glType = static_cast<GrContextFactory::GLContextType>(type);
+        if (!GrContextFactory::IsRenderingGLContext(glType)) {
+            continue;
+        }
+        SkBitmap expected, actual;
+        if (!render(factory, glType, &expected) ||
+            !render(&pendingFactory, glType, &actual)) {
+            continue;
+        }
+        SkAutoLockPixels e(expected), a(actual);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                              expected.getSafeSize()));
+    }
+}
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+#if SK_SUPPORT_GPU
+
+#include "GrContext.h"
+#include "GrContextFactory.h"
+#include "GrTexture.h"
+#include "SkBitmap.h"
+#include "Test.h"
+#include "effects/GrTextureStripAtlas.h"
+
+// Tests that the atlas grows by a page when every row is locked, rather than failing lockRow(),
+// and that descriptors differing only in page height share an atlas.
+DEF_GPUTEST(GrTextureStripAtlas, reporter, factory) {
+    GrContext* context = factory->get(GrContextFactory::kNull_GLContextType);
+    if (NULL == context) {
+        return;
+    }
+
+    static const int kWidth = 12;
+    static const int kRowsPerPage = 4;
+    static const int kNumStrips = kRowsPerPage + 2;
+
+    GrTextureStripAtlas::Desc desc;
+    desc.fWidth = kWidth;
+    desc.fHeight = kRowsPerPage;
+    desc.fRowHeight = 1;
+    desc.fContext = context;
+    desc.fConfig = kSkia8888_GrPixelConfig;
+    GrTextureStripAtlas* atlas = GrTextureStripAtlas::GetAtlas(desc);
+
+    GrTextureStripAtlas::Desc tallerDesc = desc;
+    tallerDesc.fHeight = 2 * kRowsPerPage;
+    REPORTER_ASSERT(reporter, atlas == GrTextureStripAtlas::GetAtlas(tallerDesc));
+
+    SkBitmap strips[kNumStrips];
+    int rows[kNumStrips];
+    for (int i = 0; i < kNumStrips; ++i) {
+        strips[i].allocN32Pixels(kWidth, 1);
+        strips[i].eraseColor(SkColorSetARGB(0xFF, i, i, i));
+        rows[i] = atlas->lockRow(strips[i]);
+        REPORTER_ASSERT(reporter, rows[i] >= 0);
+        for (int j = 0; j < i; ++j) {
+            REPORTER_ASSERT(reporter, rows[i] != rows[j]);
+        }
+    }
+    REPORTER_ASSERT(reporter, atlas->numPages() >= 2);
+    REPORTER_ASSERT(reporter,
+                    atlas->getTexture(rows[0]) != atlas->getTexture(rows[kNumStrips - 1]));
+
+    // Locking a strip again finds the row it already occupies.
+    REPORTER_ASSERT(reporter, rows[kNumStrips - 1] == atlas->lockRow(strips[kNumStrips - 1]));
+    atlas->unlockRow(rows[kNumStrips - 1]);
+
+    for (int i = 0; i < kNumStrips; ++i) {
+        SkScalar y = atlas->getYOffset(rows[i]);
+        REPORTER_ASSERT(reporter, y >= 0 && y < SK_Scalar1);
+        atlas->unlockRow(rows[i]);
+    }
+}
+
+#endif
@@ -163,6 +163,70 @@ static void TestConstantGradient(skiatest::Reporter*) {
     }
 }
 
+// A steep ramp between two close stops should come out smooth rather than in the few steps a
+// 256 entry table has for it, and the paint's alpha should simply scale it.
+static void test_float_stops(skiatest::Reporter* reporter) {
+    const int kWidth = 1000;
+    const SkColor colors[] = { SK_ColorBLACK, SK_ColorBLACK, SK_ColorWHITE, SK_ColorWHITE };
+    const SkScalar pos[] = { 0, 0.45f, 0.55f, 1 };
+    const SkPoint pts[] = {{ 0, 0 }, { SkIntToScalar(kWidth), 0 }};
+
+    SkAutoTUnref<SkShader> linear(SkGradientShader::CreateLinear(pts, colors, pos, 4,
+                                                                 SkShader::kClamp_TileMode));
+    SkAutoTUnref<SkShader> radial(SkGradientShader::CreateRadial(pts[0], SkIntToScalar(kWidth),
+                                                                 colors, pos, 4,
+                                                                 SkShader::kClamp_TileMode));
+    SkShader* shaders[] = { linear.get(), radial.get() };
+    const U8CPU alphas[] = { 0xFF, 0x80 };
+
+    SkBitmap bm;
+    bm.allocN32Pixels(kWidth, 1);
+    for (size_t i = 0; i < SK_ARRAY_COUNT(shaders); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(alphas); ++j) {
+            const U8CPU alpha = alphas[j];
+            bm.eraseColor(SK_ColorTRANSPARENT);
+            SkPaint paint;
+            paint.setShader(shaders[i]);
+            paint.setAlpha(alpha);
+            paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+            SkCanvas canvas(bm);
+            canvas.drawPaint(paint);
+
+            SkAutoLockPixels alp(bm);
+            int prev = 0;
+            for (int x = 0; x < kWidth; ++x) {
+                float t = (x + 0.5f) / kWidth;
+                float expected = SkTPin((t - 0.45f) * 10, 0.0f, 1.0f) * alpha;
+                int g = SkGetPackedG32(*bm.getAddr32(x, 0));
+                REPORTER_ASSERT(reporter, SkScalarAbs(g - expected) <= 2);
+                REPORTER_ASSERT(reporter, g - prev <= 4);
+                prev = g;
+            }
+        }
+    }
+}
+
+// Separately created gradients with the same stops should share one color table.
+static void test_shared_table(skiatest::Reporter* reporter) {
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    const SkScalar pos[] = { 0, 0.3f, 1 };
+    const SkPoint pts[] = {{ 0, 0 }, { 100, 0 }};
+    const SkPoint pts2[] = {{ 10, 10 }, { 50, 60 }};
+
+    SkAutoTUnref<SkShader> a(SkGradientShader::CreateLinear(pts, colors, pos, 3,
+                                                            SkShader::kClamp_TileMode));
+    SkAutoTUnref<SkShader> b(SkGradientShader::CreateLinear(pts2, colors, pos, 3,
+                                                            SkShader::kClamp_TileMode));
+    SkAutoTUnref<SkShader> c(SkGradientShader::CreateLinear(pts, colors, NULL, 3,
+                                                            SkShader::kClamp_TileMode));
+    SkBitmap bmA, bmB, bmC;
+    REPORTER_ASSERT(reporter, SkShader::kLinear_BitmapType == a->asABitmap(&bmA, NULL, NULL));
+    REPORTER_ASSERT(reporter, SkShader::kLinear_BitmapType == b->asABitmap(&bmB, NULL, NULL));
+    REPORTER_ASSERT(reporter, SkShader::kLinear_BitmapType == c->asABitmap(&bmC, NULL, NULL));
+    REPORTER_ASSERT(reporter, bmA.getGenerationID() == bmB.getGenerationID());
+    REPORTER_ASSERT(reporter, bmA.getGenerationID() != bmC.getGenerationID());
+}
+
 typedef void (*GradProc)(skiatest::Reporter* reporter, const GradRec&);
 
 static void TestGradientShaders(skiatest::Reporter* reporter) {
@@ -200,4 +264,6 @@ DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestConstantGradient(reporter);
     test_big_grad(reporter);
+    test_float_stops(reporter);
+    test_shared_table(reporter);
 }
@@ -26,6 +26,7 @@ struct TestingRec : public SkResourceCache::Rec {
 
     const Key& getKey() const override { return fKey; }
     size_t bytesUsed() const override { return sizeof(fKey) + sizeof(fValue); }
+    const char* getCategory() const override { return "test"; }
 
     static bool Visitor(const SkResourceCache::Rec& baseRec, void* context) {
         const TestingRec& rec = static_cast<const TestingRec&>(baseRec);
@@ -149,3 +150,62 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+static void copy_stats(const SkCacheStats& stats, void* context) {
+    *static_cast<SkCacheStats*>(context) = stats;
+}
+
+DEF_TEST(ImageCache_stats, r) {
+    const size_t recSize = TestingRec(TestingKey(0), 0).bytesUsed();
+    SkResourceCache cache(4 * recSize);
+
+    intptr_t value;
+    REPORTER_ASSERT(r, !cache.find(TestingKey(0), TestingRec::Visitor, &value));
+    for (int i = 0; i < 6; ++i) {
+        cache.add(SkNEW_ARGS(TestingRec, (TestingKey(i), i)));
+    }
+    // Reaching the budget evicts the oldest entry, so only the newest three remain.
+    REPORTER_ASSERT(r, !cache.find(TestingKey(0), TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, cache.find(TestingKey(5), TestingRec::Visitor, &value));
+
+    SkCacheStats stats;
+    sk_bzero(&stats, sizeof(stats));
+    cache.visitStats(copy_stats, &stats);
+    REPORTER_ASSERT(r, stats.fName && 0 == strcmp("test", stats.fName));
+    REPORTER_ASSERT(r, 1 == stats.fHits);
+    REPORTER_ASSERT(r, 2 == stats.fMisses);
+    REPORTER_ASSERT(r, 3 == stats.fEntries);
+    REPORTER_ASSERT(r, 3 == stats.fEvictions);
+    REPORTER_ASSERT(r, 3 * recSize == stats.fBytes);
+
+    // The fourth add peaked at the budget before evicting.
+    REPORTER_ASSERT(r, 4 * recSize == cache.getPeakBytesUsed());
+    cache.resetPeakBytesUsed();
+    REPORTER_ASSERT(r, 3 * recSize == cache.getPeakBytesUsed());
+}
+
+DEF_TEST(ImageCache_purgeToFraction, r) {
+    SkResourceCache cache(1024 * 1024);
+    for (int i = 0; i < 8; ++i) {
+        cache.add(SkNEW_ARGS(TestingRec, (TestingKey(i), i)));
+    }
+    // Touch the oldest entry, so it is among the most recently used half.
+    intptr_t value;
+    REPORTER_ASSERT(r, cache.find(TestingKey(0), TestingRec::Visitor, &value));
+
+    const size_t bytes = cache.getTotalBytesUsed();
+    cache.purgeToFraction(0.5f);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() == bytes / 2);
+    REPORTER_ASSERT(r, cache.find(TestingKey(0), TestingRec::Visitor, &value));
+    for (int i = 1; i <= 4; ++i) {
+        REPORTER_ASSERT(r, !cache.find(TestingKey(i), TestingRec::Visitor, &value));
+    }
+    for (int i = 5; i < 8; ++i) {
+        REPORTER_ASSERT(r, cache.find(TestingKey(i), TestingRec::Visitor, &value));
+    }
+
+    cache.purgeToFraction(1);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() == bytes / 2);
+    cache.purgeToFraction(0);
+    REPORTER_ASSERT(r, 0 == cache.getTotalBytesUsed());
+}
@@ -20,6 +20,7 @@
 #include "SkImageGeneratorPriv.h"
 #include "SkImagePriv.h"
 #include "SkOSFile.h"
+#include "SkPixmap.h"
 #include "SkPoint.h"
 #include "SkShader.h"
 #include "SkStream.h"
@@ -753,3 +754,64 @@ DEF_TEST(ImageDecoding_JpegOverwrite, r) {
     REPORTER_ASSERT(r, !allocator->ready());  // Decoder used correct memory
     REPORTER_ASSERT(r, sentinal == pixels[pixelCount]);
 }
+
+// Hands out a bitmap's rows a few at a time, or fails at failRow.
+class BandedRowSource : public SkImageEncoder::RowSource {
+public:
+    BandedRowSource(const SkBitmap& bm, int bandHeight, int failRow)
+        : fBitmap(bm), fBandHeight(bandHeight), fFailRow(failRow) {}
+
+    bool nextBand(int y, SkPixmap* band) override {
+        if (y >= fFailRow) {
+            return false;
+        }
+        const int h = SkTMin(fBandHeight, fBitmap.height() - y);
+        band->reset(fBitmap.info().makeWH(fBitmap.width(), h), fBitmap.getAddr(0, y),
+                    fBitmap.rowBytes(), fBitmap.getColorTable());
+        return true;
+    }
+
+private:
+    const SkBitmap& fBitmap;
+    const int       fBandHeight;
+    const int       fFailRow;
+};
+
+DEF_TEST(ImageEncoder_rows, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(37, 29);
+    for (int y = 0; y < bm.height(); y++) {
+        for (int x = 0; x < bm.width(); x++) {
+            // Mostly opaque, with some translucent pixels to unpremultiply.
+            const U8CPU a = (x + y) % 7 ? 0xFF : 0x80;
+            *bm.getAddr32(x, y) = SkPreMultiplyARGB(a, x * 7, y * 9, 0x40);
+        }
+    }
+
+    // JPEG and PNG write a row at a time; ARGB gathers the bands into a bitmap first.
+    SkImageEncoder* encoders[] = {
+        SkImageEncoder::Create(SkImageEncoder::kJPEG_Type),
+        SkImageEncoder::Create(SkImageEncoder::kPNG_Type),
+        CreateARGBImageEncoder(),
+    };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(encoders); i++) {
+        SkAutoTDelete<SkImageEncoder> encoder(encoders[i]);
+        if (!encoder) {
+            continue;
+        }
+        SkAutoTUnref<SkData> whole(encoder->encodeData(bm, 90));
+        if (!whole) {
+            continue;
+        }
+
+        SkDynamicMemoryWStream banded;
+        BandedRowSource source(bm, 5, bm.height());
+        REPORTER_ASSERT(r, encoder->encodeRows(&banded, bm.info(), &source, 90));
+        SkAutoTUnref<SkData> bandedData(banded.copyToData());
+        REPORTER_ASSERT(r, whole->equals(bandedData));
+
+        SkDynamicMemoryWStream failed;
+        BandedRowSource failing(bm, 5, 10);
+        REPORTER_ASSERT(r, !encoder->encodeRows(&failed, bm.info(), &failing, 90));
+    }
+}
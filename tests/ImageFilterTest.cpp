@@ -1159,6 +1159,135 @@ DEF_TEST(PartialCropRect, reporter) {
     REPORTER_ASSERT(reporter, result.height() == 30);
 }
 
+// Checks that a and b, placed at their offsets, have the same pixels, b being transparent
+// wherever a doesn't reach.
+static bool same_placed_pixels(const SkBitmap& a, const SkIPoint& aOffset,
+                               const SkBitmap& b, const SkIPoint& bOffset) {
+    SkAutoLockPixels alpa(a), alpb(b);
+    const SkIRect aBounds = SkIRect::MakeXYWH(aOffset.x(), aOffset.y(), a.width(), a.height());
+    for (int y = 0; y < b.height(); ++y) {
+        for (int x = 0; x < b.width(); ++x) {
+            const int ax = x + bOffset.x(), ay = y + bOffset.y();
+            const SkPMColor expected = aBounds.contains(ax, ay)
+                                     ? *a.getAddr32(ax - aOffset.x(), ay - aOffset.y()) : 0;
+            if (*b.getAddr32(x, y) != expected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+DEF_TEST(ImageFilterCacheContentKeys, reporter) {
+    SkBitmap bitmap = make_gradient_circle(64, 64);
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+    SkBitmapDevice device(bitmap, props);
+    SkImageFilter::Proxy proxy(&device);
+
+    SkAutoTUnref<SkImageFilter::Cache> cache(SkImageFilter::Cache::Create(1024 * 1024));
+    SkImageFilter::Context ctx(SkMatrix::I(), SkIRect::MakeLargest(), cache);
+    // Each frame re-creates the same chain, so only content keys can find last frame's result.
+    auto drawFrame = [&](SkScalar sigma) {
+        SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(sigma, sigma));
+        SkAutoTUnref<SkImageFilter> offset(SkOffsetImageFilter::Create(3, 4, blur));
+        SkBitmap result;
+        SkIPoint resultOffset;
+        REPORTER_ASSERT(reporter, offset->filterImage(&proxy, bitmap, ctx,
+                                                      &result, &resultOffset));
+    };
+
+    SkImageFilter::Cache::Stats stats;
+    drawFrame(2);
+    drawFrame(2);
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 0 == stats.fHits);
+    REPORTER_ASSERT(reporter, 4 == stats.fMisses);
+    REPORTER_ASSERT(reporter, 4 == stats.fCount);
+
+    cache->setKeyMode(SkImageFilter::Cache::kContent_KeyMode);
+    cache->resetStats();
+    drawFrame(2);
+    drawFrame(2);
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 1 == stats.fHits);
+    REPORTER_ASSERT(reporter, 2 == stats.fMisses);
+
+    // A different chain mustn't find the cached result.
+    drawFrame(3);
+    cache->getStats(&stats);
+    REPORTER_ASSERT(reporter, 1 == stats.fHits);
+    REPORTER_ASSERT(reporter, 4 == stats.fMisses);
+    REPORTER_ASSERT(reporter, 8 == stats.fCount);
+    REPORTER_ASSERT(reporter, stats.fBytes > 0);
+}
+
+DEF_TEST(ImageFilterTiledEvaluation, reporter) {
+    SkBitmap bitmap = make_gradient_circle(300, 200);
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+    SkBitmapDevice device(bitmap, props);
+    SkImageFilter::Proxy proxy(&device);
+
+    SkAutoTUnref<SkImageFilter> blur(SkBlurImageFilter::Create(3, 2));
+    SkAutoTUnref<SkImageFilter> offset(SkOffsetImageFilter::Create(7, -5, blur));
+    SkAutoTUnref<SkImageFilter> gray(make_grayscale(offset, NULL));
+    SkAutoTUnref<SkImageFilter> blurAgain(SkBlurImageFilter::Create(2, 4, gray));
+    SkAutoTUnref<SkImageFilter> merge(SkMergeImageFilter::Create(blurAgain, blur));
+
+    SkImageFilter* filters[] = { blur, offset, blurAgain, merge };
+    const SkIRect clips[] = { SkIRect::MakeLargest(), SkIRect::MakeLTRB(-10, 20, 250, 190) };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(filters); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(clips); ++j) {
+            SkImageFilter::Context ctx(SkMatrix::I(), clips[j], NULL);
+            SkBitmap untiled, tiled;
+            SkIPoint untiledOffset, tiledOffset;
+            REPORTER_ASSERT(reporter, filters[i]->filterImage(&proxy, bitmap, ctx,
+                                                              &untiled, &untiledOffset));
+            // Small enough to need several tiles.
+            REPORTER_ASSERT(reporter, filters[i]->filterImageTiled(&proxy, bitmap, ctx,
+                                                                   160 * 160 * 4,
+                                                                   &tiled, &tiledOffset));
+            REPORTER_ASSERT(reporter, same_placed_pixels(untiled, untiledOffset,
+                                                         tiled, tiledOffset));
+        }
+    }
+}
+
+// The canvas draws a tile filter as a shaded rect; it must match drawing filterImage()'s result.
+DEF_TEST(ImageFilterTileAsShader, reporter) {
+    SkBitmap source = make_gradient_circle(64, 64);
+    SkAutoTUnref<SkImageFilter> tile(SkTileImageFilter::Create(SkRect::MakeXYWH(8, 8, 24, 20),
+                                                               SkRect::MakeXYWH(3.5f, 2.25f,
+                                                                                90, 70),
+                                                               NULL));
+    const SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+
+    SkBitmap direct, viaBitmap;
+    direct.allocN32Pixels(100, 100);
+    viaBitmap.allocN32Pixels(100, 100);
+    direct.eraseColor(SK_ColorTRANSPARENT);
+    viaBitmap.eraseColor(SK_ColorTRANSPARENT);
+
+    SkPaint paint;
+    paint.setImageFilter(tile);
+    SkCanvas(direct).drawSprite(source, 4, 5, &paint);
+
+    SkBitmapDevice device(viaBitmap, props);
+    SkImageFilter::Proxy proxy(&device);
+    SkImageFilter::Context ctx(SkMatrix::I(), source.bounds(), NULL);
+    SkShader* shader = NULL;
+    SkRect rect;
+    REPORTER_ASSERT(reporter, tile->filterImageAsShader(&proxy, source, ctx, &shader, &rect));
+    SkSafeUnref(shader);
+    SkBitmap result;
+    SkIPoint offset;
+    REPORTER_ASSERT(reporter, tile->filterImage(&proxy, source, ctx, &result, &offset));
+    SkCanvas(viaBitmap).drawSprite(result, 4 + offset.x(), 5 + offset.y());
+
+    SkAutoLockPixels lockDirect(direct), lockVia(viaBitmap);
+    REPORTER_ASSERT(reporter, 0 == memcmp(direct.getPixels(), viaBitmap.getPixels(),
+                                          direct.getSize()));
+}
+
 #if SK_SUPPORT_GPU
 
 DEF_GPUTEST(ImageFilterCropRectGPU, reporter, factory) {
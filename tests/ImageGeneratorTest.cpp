@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmapCache.h"
+#include "SkBitmapController.h"
 #include "SkData.h"
 #include "SkGraphics.h"
+#include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
 #include "Test.h"
 
@@ -70,3 +73,46 @@ DEF_TEST(ImageGenerator, reporter) {
 
     test_imagegenerator_factory(reporter);
 }
+
+DEF_TEST(ImageGenerator_ScaledDecode, reporter) {
+    SkBitmap src;
+    src.allocN32Pixels(400, 300, true);
+    src.eraseColor(SK_ColorBLUE);
+    SkAutoTUnref<SkData> encoded(SkImageEncoder::EncodeData(src, SkImageEncoder::kJPEG_Type, 90));
+    if (!encoded) {
+        return;
+    }
+
+    SkAutoTDelete<SkImageGenerator> gen(SkImageGenerator::NewFromEncoded(encoded));
+    REPORTER_ASSERT(reporter, gen);
+    if (!gen) {
+        return;
+    }
+    // JPEG scales down by 1/2, 1/4 or 1/8, never below the scale asked for.
+    REPORTER_ASSERT(reporter, SkISize::Make(400, 300) == gen->getScaledDimensions(0.9f));
+    REPORTER_ASSERT(reporter, SkISize::Make(200, 150) == gen->getScaledDimensions(0.3f));
+    REPORTER_ASSERT(reporter, SkISize::Make(100,  75) == gen->getScaledDimensions(0.2f));
+    REPORTER_ASSERT(reporter, SkISize::Make( 50,  38) == gen->getScaledDimensions(0.01f));
+
+    SkBitmap scaled;
+    scaled.allocPixels(gen->getInfo().makeWH(100, 75));
+    REPORTER_ASSERT(reporter, gen->getPixels(scaled.info(), scaled.getPixels(),
+                                             scaled.rowBytes()));
+    REPORTER_ASSERT(reporter, SkColorGetB(scaled.getColor(50, 37)) > 0xF0);
+    REPORTER_ASSERT(reporter, !gen->getPixels(gen->getInfo().makeWH(123, 45),
+                                              scaled.getPixels(), scaled.rowBytes()));
+
+    // Drawn at a quarter size with filtering, the lazy bitmap is decoded at that size, and cached.
+    SkBitmap lazy;
+    REPORTER_ASSERT(reporter, SkInstallDiscardablePixelRef(gen.detach(), &lazy));
+    SkMatrix inverse;
+    inverse.setScale(4, 4);
+    SkDefaultBitmapController controller;
+    SkAutoTDelete<SkBitmapController::State> state(
+            controller.requestBitmap(lazy, inverse, kMedium_SkFilterQuality));
+    REPORTER_ASSERT(reporter, state && 100 == state->pixmap().width() &&
+                                        75 == state->pixmap().height());
+    REPORTER_ASSERT(reporter, NULL == lazy.getPixels());
+    SkBitmap cached;
+    REPORTER_ASSERT(reporter, SkBitmapCache::Find(lazy, 100, 75, &cached));
+}
@@ -9,7 +9,9 @@
 #include "SkData.h"
 #include "SkDevice.h"
 #include "SkImageEncoder.h"
+#include "SkImageGenerator.h"
 #include "SkImage_Base.h"
+#include "SkMallocPixelRef.h"
 #include "SkRRect.h"
 #include "SkSurface.h"
 #include "SkUtils.h"
@@ -250,6 +252,108 @@ DEF_TEST(image_newfrombitmap, reporter) {
     }
 }
 
+static void count_release(const void*, void* context) {
+    (*static_cast<int*>(context))++;
+}
+
+// Images wrap caller memory with any rowBytes, without copying it.
+DEF_TEST(Image_NewFromRaster_RowBytes, reporter) {
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeA8(3, 5),          // rowBytes of 3 isn't a multiple of 4
+        SkImageInfo::MakeN32Premul(3, 5),   // padded rows
+    };
+    const size_t rowBytes[] = { 3, 3 * 4 + 8 };
+
+    for (size_t i = 0; i < SK_ARRAY_COUNT(infos); ++i) {
+        SkAutoTMalloc<uint8_t> pixels(infos[i].getSafeSize(rowBytes[i]));
+        int released = 0;
+        SkAutoTUnref<SkImage> image(SkImage::NewFromRaster(infos[i], pixels.get(), rowBytes[i],
+                                                           count_release, &released));
+        REPORTER_ASSERT(reporter, image);
+        if (!image) {
+            continue;
+        }
+        SkPixmap pmap;
+        REPORTER_ASSERT(reporter, image->peekPixels(&pmap));
+        REPORTER_ASSERT(reporter, pixels.get() == pmap.addr());
+        REPORTER_ASSERT(reporter, rowBytes[i] == pmap.rowBytes());
+        REPORTER_ASSERT(reporter, 0 == released);
+        image.reset(NULL);
+        REPORTER_ASSERT(reporter, 1 == released);
+    }
+}
+
+namespace {
+
+// Hands out pixels from one caller-owned buffer, with padded rows, like a buffer pool would.
+class PoolAllocator : public SkBitmap::Allocator {
+public:
+    PoolAllocator(size_t size) : fPool(size), fSize(size), fReleased(0) {}
+
+    bool allocPixelRef(SkBitmap* bitmap, SkColorTable* ctable) override {
+        const size_t rowBytes = bitmap->info().minRowBytes() + 16;
+        if (bitmap->info().getSafeSize(rowBytes) > fSize || !bitmap->setInfo(bitmap->info(),
+                                                                             rowBytes)) {
+            return false;
+        }
+        SkAutoTUnref<SkPixelRef> pr(SkMallocPixelRef::NewWithProc(bitmap->info(), rowBytes,
+                                                                  ctable, fPool.get(),
+                                                                  Release, this));
+        bitmap->setPixelRef(pr);
+        return true;
+    }
+
+    static void Release(void*, void* context) {
+        static_cast<PoolAllocator*>(context)->fReleased++;
+    }
+
+    SkAutoTMalloc<uint8_t> fPool;
+    size_t                 fSize;
+    int                    fReleased;
+};
+
+class SolidImageGenerator : public SkImageGenerator {
+public:
+    SolidImageGenerator(int width, int height)
+        : SkImageGenerator(SkImageInfo::MakeN32Premul(width, height)) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     SkPMColor[], int*) override {
+        for (int y = 0; y < info.height(); ++y) {
+            sk_memset32((uint32_t*)((char*)pixels + y * rowBytes), SK_ColorGREEN, info.width());
+        }
+        return true;
+    }
+};
+
+}  // namespace
+
+// Decoding through an allocator lands the pixels in the allocator's memory, and the image
+// wraps that memory directly.
+DEF_TEST(Image_NewRasterFromGenerator, reporter) {
+    PoolAllocator pool(64 * 1024);
+    {
+        SkAutoTUnref<SkImage> image(SkImage::NewRasterFromGenerator(
+                SkNEW_ARGS(SolidImageGenerator, (20, 10)), &pool));
+        REPORTER_ASSERT(reporter, image);
+        if (!image) {
+            return;
+        }
+        SkPixmap pmap;
+        REPORTER_ASSERT(reporter, image->peekPixels(&pmap));
+        REPORTER_ASSERT(reporter, pool.fPool.get() == pmap.addr());
+        REPORTER_ASSERT(reporter, 20 * 4 + 16 == pmap.rowBytes());
+        REPORTER_ASSERT(reporter, SK_ColorGREEN == *pmap.addr32(19, 9));
+        REPORTER_ASSERT(reporter, 0 == pool.fReleased);
+    }
+    REPORTER_ASSERT(reporter, 1 == pool.fReleased);
+
+    // Too big for the pool.
+    REPORTER_ASSERT(reporter, NULL == SkImage::NewRasterFromGenerator(
+            SkNEW_ARGS(SolidImageGenerator, (1000, 1000)), &pool));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #if SK_SUPPORT_GPU
 
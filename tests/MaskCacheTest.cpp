@@ -5,7 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkBlurMaskFilter.h"
 #include "SkCachedData.h"
+#include "SkCanvas.h"
 #include "SkMaskCache.h"
 #include "SkResourceCache.h"
 #include "Test.h"
@@ -104,3 +106,106 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkScalar sigma = 0.8f;
+    uint32_t genID = 42;
+    SkPath::FillType fillType = SkPath::kWinding_FillType;
+    SkMatrix matrix = SkMatrix::MakeScale(2, 3);
+    SkBlurStyle style = kNormal_SkBlurStyle;
+    SkBlurQuality quality = kLow_SkBlurQuality;
+    SkMask mask;
+
+    SkCachedData* data = SkMaskCache::FindAndRef(sigma, style, quality, genID, fillType, matrix,
+                                                 &mask, &cache);
+    REPORTER_ASSERT(reporter, NULL == data);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    mask.fBounds.setXYWH(0, 0, 100, 100);
+    mask.fRowBytes = 100;
+    mask.fFormat = SkMask::kBW_Format;
+    SkMaskCache::Add(sigma, style, quality, genID, fillType, matrix, mask, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // Any change to the key misses.
+    SkMatrix translated = matrix;
+    translated.postTranslate(0.25f, 0);
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, genID, fillType,
+                                                       translated, &mask, &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, genID + 1,
+                                                       fillType, matrix, &mask, &cache));
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(sigma, style, quality, genID,
+                                                       SkPath::kEvenOdd_FillType, matrix,
+                                                       &mask, &cache));
+
+    sk_bzero(&mask, sizeof(mask));
+    data = SkMaskCache::FindAndRef(sigma, style, quality, genID, fillType, matrix, &mask, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    REPORTER_ASSERT(reporter, mask.fBounds.top() == 0 && mask.fBounds.bottom() == 100);
+    REPORTER_ASSERT(reporter, data->data() == (const void*)mask.fImage);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    cache.purgeAll();
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
+
+static void draw_blurred_path(SkBitmap* bm, const SkPath& path, const SkMatrix& matrix) {
+    bm->allocN32Pixels(160, 160);
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bm);
+    canvas.concat(matrix);
+    SkPaint paint;
+    paint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 3))->unref();
+    canvas.drawPath(path, paint);
+}
+
+static bool equal_offset(const SkBitmap& a, const SkBitmap& b, int dx, int dy) {
+    for (int y = 0; y + dy < a.height(); ++y) {
+        for (int x = 0; x + dx < a.width(); ++x) {
+            if (*a.getAddr32(x, y) != *b.getAddr32(x + dx, y + dy)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Blurred path masks found in the cache must match freshly built ones, wherever they're drawn.
+DEF_TEST(PathMaskCache_Draw, reporter) {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(40, 10);
+    path.quadTo(50, 50, 10, 40);
+    path.close();
+    SkPath volatilePath = path;
+    volatilePath.setIsVolatile(true);
+
+    // Translations on the quarter pixel grid aren't moved when snapped.
+    const SkMatrix matrices[] = {
+        SkMatrix::MakeTrans(10.25f, 20.5f),
+        SkMatrix::MakeScale(2),
+    };
+    for (const SkMatrix& matrix : matrices) {
+        SkBitmap expected, first, second;
+        draw_blurred_path(&expected, volatilePath, matrix);
+        draw_blurred_path(&first, path, matrix);
+        draw_blurred_path(&second, path, matrix);
+        REPORTER_ASSERT(reporter, equal_offset(expected, first, 0, 0));
+        REPORTER_ASSERT(reporter, equal_offset(expected, second, 0, 0));
+
+        SkMatrix moved = matrix;
+        moved.postTranslate(20, 30);
+        SkBitmap offset;
+        draw_blurred_path(&offset, path, moved);
+        REPORTER_ASSERT(reporter, equal_offset(expected, offset, 20, 30));
+    }
+}
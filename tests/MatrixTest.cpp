@@ -940,3 +940,42 @@ DEF_TEST(Matrix_Concat, r) {
 
     REPORTER_ASSERT(r, expected == SkMatrix::Concat(a, b));
 }
+
+// mapPoints() maps several points at a time; each must come out as it does when mapped alone, with
+// any count, in place or not, and with points the perspective sends to infinity.
+DEF_TEST(Matrix_MapPoints, r) {
+    SkMatrix matrices[5];
+    matrices[0].setTranslate(10.5f, -3.25f);
+    matrices[1].setScale(1.5f, -0.75f, 3, 7);
+    matrices[2].setRotate(17);
+    matrices[3].setRotate(-41, 5, 9);
+    matrices[3].postScale(2, 3);
+    matrices[4] = matrices[3];
+    matrices[4].setPerspX(1.f / 256);
+    matrices[4].setPerspY(-1.f / 512);
+
+    SkRandom rand;
+    SkPoint src[37], dst[37], inPlace[37];
+    for (int i = 0; i < (int) SK_ARRAY_COUNT(src); ++i) {
+        src[i].set(rand.nextRangeF(-1000, 1000), rand.nextRangeF(-1000, 1000));
+    }
+    // on the line where the perspective's w is zero
+    src[5].set(0, 512);
+    src[10].set(256, 1024);
+
+    for (size_t m = 0; m < SK_ARRAY_COUNT(matrices); ++m) {
+        const SkMatrix& matrix = matrices[m];
+        for (int count = 0; count <= (int) SK_ARRAY_COUNT(src); ++count) {
+            matrix.mapPoints(dst, src, count);
+            memcpy(inPlace, src, count * sizeof(SkPoint));
+            matrix.mapPoints(inPlace, count);
+            for (int i = 0; i < count; ++i) {
+                SkPoint expected;
+                matrix.mapPoints(&expected, &src[i], 1);
+                // compare bits, so that non-finite results must match too
+                REPORTER_ASSERT(r, !memcmp(&expected, &dst[i], sizeof(SkPoint)));
+                REPORTER_ASSERT(r, !memcmp(&expected, &inPlace[i], sizeof(SkPoint)));
+            }
+        }
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkBitmap.h"
+#include "SkColorPriv.h"
 #include "SkMipMap.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -53,3 +54,78 @@ DEF_TEST(MipMap, reporter) {
         }
     }
 }
+
+// Checks the first level of each mipmap colortype against a per channel truncated average,
+// at odd sizes, including one large enough to be built in parallel bands.
+DEF_TEST(MipMap_Downsample, reporter) {
+    SkRandom rand;
+    const SkColorType colorTypes[] = {
+        kN32_SkColorType, kRGB_565_SkColorType, kAlpha_8_SkColorType
+    };
+    const SkISize sizes[] = {
+        SkISize::Make(3, 3), SkISize::Make(37, 23), SkISize::Make(1025, 1027)
+    };
+    for (SkColorType ct : colorTypes) {
+        for (const SkISize& size : sizes) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size.width(), size.height(), ct,
+                                             kAlpha_8_SkColorType == ct ? kPremul_SkAlphaType
+                                                                        : kOpaque_SkAlphaType));
+            uint8_t* bytes = static_cast<uint8_t*>(bm.getPixels());
+            for (size_t i = 0; i < bm.getSize(); ++i) {
+                bytes[i] = rand.nextU() & 0xFF;
+            }
+
+            SkAutoTUnref<SkMipMap> mm(SkMipMap::Build(bm, NULL));
+            SkMipMap::Level level;
+            REPORTER_ASSERT(reporter, mm->extractLevel(SK_ScalarHalf, &level));
+            REPORTER_ASSERT(reporter, SkToInt(level.fWidth) == size.width() / 2);
+            REPORTER_ASSERT(reporter, SkToInt(level.fHeight) == size.height() / 2);
+
+            int errors = 0;
+            for (int y = 0; y < (int)level.fHeight; ++y) {
+                const uint8_t* row = (const uint8_t*)level.fPixels + y * level.fRowBytes;
+                for (int x = 0; x < (int)level.fWidth; ++x) {
+                    switch (ct) {
+                        case kN32_SkColorType: {
+                            uint32_t c[] = { *bm.getAddr32(2*x, 2*y), *bm.getAddr32(2*x+1, 2*y),
+                                             *bm.getAddr32(2*x, 2*y+1),
+                                             *bm.getAddr32(2*x+1, 2*y+1) };
+                            uint32_t expected = 0;
+                            for (int shift = 0; shift < 32; shift += 8) {
+                                uint32_t sum = 0;
+                                for (uint32_t p : c) {
+                                    sum += (p >> shift) & 0xFF;
+                                }
+                                expected |= (sum >> 2) << shift;
+                            }
+                            errors += expected != ((const uint32_t*)row)[x];
+                            break;
+                        }
+                        case kRGB_565_SkColorType: {
+                            uint16_t c[] = { *bm.getAddr16(2*x, 2*y), *bm.getAddr16(2*x+1, 2*y),
+                                             *bm.getAddr16(2*x, 2*y+1),
+                                             *bm.getAddr16(2*x+1, 2*y+1) };
+                            unsigned r = 0, g = 0, b = 0;
+                            for (uint16_t p : c) {
+                                r += SkGetPackedR16(p);
+                                g += SkGetPackedG16(p);
+                                b += SkGetPackedB16(p);
+                            }
+                            errors += SkPackRGB16(r >> 2, g >> 2, b >> 2) !=
+                                      ((const uint16_t*)row)[x];
+                            break;
+                        }
+                        default: {
+                            unsigned sum = *bm.getAddr8(2*x, 2*y) + *bm.getAddr8(2*x+1, 2*y) +
+                                           *bm.getAddr8(2*x, 2*y+1) + *bm.getAddr8(2*x+1, 2*y+1);
+                            errors += (sum >> 2) != row[x];
+                            break;
+                        }
+                    }
+                }
+            }
+            REPORTER_ASSERT(reporter, 0 == errors);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkNinePatchIter.h"
+#include "SkRect.h"
+#include "Test.h"
+
+DEF_TEST(NinePatchIter, reporter) {
+    const SkIRect center = SkIRect::MakeLTRB(2, 3, 8, 7);
+    const SkRect dst = SkRect::MakeXYWH(100, 200, 50, 40);
+    SkNinePatchIter iter(10, 10, center, dst);
+
+    const SkScalar srcX[] = { 0, 2, 8, 10 };
+    const SkScalar srcY[] = { 0, 3, 7, 10 };
+    const SkScalar dstX[] = { 100, 102, 148, 150 };
+    const SkScalar dstY[] = { 200, 203, 237, 240 };
+
+    SkRect srcR, dstR;
+    int count = 0;
+    while (iter.next(&srcR, &dstR)) {
+        const int x = count % 3;
+        const int y = count / 3;
+        REPORTER_ASSERT(reporter, count < 9);
+        if (count >= 9) {
+            break;
+        }
+        REPORTER_ASSERT(reporter, srcR == SkRect::MakeLTRB(srcX[x], srcY[y],
+                                                           srcX[x + 1], srcY[y + 1]));
+        REPORTER_ASSERT(reporter, dstR == SkRect::MakeLTRB(dstX[x], dstY[y],
+                                                           dstX[x + 1], dstY[y + 1]));
+        ++count;
+    }
+    REPORTER_ASSERT(reporter, 9 == count);
+}
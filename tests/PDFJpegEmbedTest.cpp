@@ -125,3 +125,51 @@ DEF_TEST(JpegIdentification, r) {
         }
     }
 }
+
+static int count_occurrences(SkData* needle, SkData* haystack) {
+    int count = 0;
+    const size_t size = needle->size();
+    for (size_t i = 0; i + size <= haystack->size(); ++i) {
+        if (0 == memcmp(haystack->bytes() + i, needle->bytes(), size)) {
+            ++count;
+            i += size - 1;
+        }
+    }
+    return count;
+}
+
+/**
+ *  Test that subsets of a JPEG, and separate decodes of the same JPEG data,
+ *  all embed the original data once rather than re-encoding the pixels.
+ */
+DEF_TEST(PDFJpegEmbedSubsets, r) {
+    SkAutoTUnref<SkData> mandrillData(
+            load_resource(r, "PDFJpegEmbedSubsets", "mandrill_512_q075.jpg"));
+    if (!mandrillData) {
+        return;
+    }
+
+    SkDynamicMemoryWStream pdf;
+    SkAutoTUnref<SkDocument> document(SkDocument::CreatePDF(&pdf));
+    SkCanvas* canvas = document->beginPage(612, 792);
+
+    SkBitmap bm1(bitmap_from_data(mandrillData));
+    SkBitmap bm2(bitmap_from_data(mandrillData));
+    REPORTER_ASSERT(r, bm1.getGenerationID() != bm2.getGenerationID());
+    canvas->drawBitmap(bm1, 0, 0, NULL);
+    canvas->drawBitmap(bm2, 100, 100, NULL);
+    SkRect src = SkRect::MakeXYWH(128, 64, 200, 300);
+    canvas->drawBitmapRect(bm1, src, SkRect::MakeXYWH(0, 300, 100, 150), NULL);
+    SkBitmap subset;
+    REPORTER_ASSERT(r, bm2.extractSubset(&subset, SkIRect::MakeXYWH(10, 20, 30, 40)));
+    canvas->drawBitmap(subset, 300, 300, NULL);
+
+    document->endPage();
+    document->close();
+    SkAutoTUnref<SkData> pdfData(pdf.copyToData());
+
+    REPORTER_ASSERT(r, 1 == count_occurrences(mandrillData, pdfData));
+    static const char kImage[] = "/Subtype /Image";
+    SkAutoTUnref<SkData> image(SkData::NewWithoutCopy(kImage, strlen(kImage)));
+    REPORTER_ASSERT(r, 1 == count_occurrences(image, pdfData));
+}
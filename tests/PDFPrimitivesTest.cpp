@@ -16,6 +16,7 @@
 #include "SkPDFDevice.h"
 #include "SkPDFStream.h"
 #include "SkPDFTypes.h"
+#include "SkPictureRecorder.h"
 #include "SkReadBuffer.h"
 #include "SkScalar.h"
 #include "SkStream.h"
@@ -206,7 +207,7 @@ static void TestPDFUnion(skiatest::Reporter* reporter) {
     ASSERT_EMIT_EQ(reporter, biggerScalar, "50000000");
 
     SkPDFUnion smallestScalar = SkPDFUnion::Scalar(1.0 / 65536);
-    ASSERT_EMIT_EQ(reporter, smallestScalar, "0.00001526");
+    ASSERT_EMIT_EQ(reporter, smallestScalar, "0.000015258789");
 #endif
 
     SkPDFUnion stringSimple = SkPDFUnion::String("test ) string ( foo");
@@ -413,3 +414,45 @@ DEF_TEST(PDFImageFilter, reporter) {
     // Filter was used in rendering; should be visited.
     REPORTER_ASSERT(reporter, filter->visited());
 }
+
+static int count_occurrences(const SkData* data, const char* needle) {
+    size_t needleLen = strlen(needle);
+    int count = 0;
+    for (size_t i = 0; i + needleLen <= data->size(); ++i) {
+        if (0 == memcmp(data->bytes() + i, needle, needleLen)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// Check that a picture drawn on several pages is emitted as one form
+// XObject for each scale it is drawn at, however many times it is drawn.
+DEF_TEST(PDFPictureForms, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* recordingCanvas = recorder.beginRecording(SkRect::MakeWH(50, 20));
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    recordingCanvas->drawRect(SkRect::MakeWH(50, 20), paint);
+    paint.setColor(SK_ColorRED);
+    recordingCanvas->drawCircle(25, 10, 8, paint);
+    SkAutoTUnref<SkPicture> logo(recorder.endRecording());
+
+    SkDynamicMemoryWStream stream;
+    SkAutoTUnref<SkDocument> doc(SkDocument::CreatePDF(&stream));
+    for (int page = 0; page < 3; ++page) {
+        SkCanvas* canvas = doc->beginPage(200.0f, 200.0f);
+        canvas->drawPicture(logo);
+        SkMatrix matrix = SkMatrix::MakeTrans(100, SkIntToScalar(10 * page));
+        canvas->drawPicture(logo, &matrix, NULL);
+        if (2 == page) {
+            matrix.setScale(2, 2);
+            canvas->drawPicture(logo, &matrix, NULL);
+        }
+        doc->endPage();
+    }
+    doc->close();
+
+    SkAutoTUnref<SkData> pdf(stream.copyToData());
+    REPORTER_ASSERT(reporter, 2 == count_occurrences(pdf, "/Subtype /Form"));
+}
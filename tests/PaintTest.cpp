@@ -168,6 +168,37 @@ DEF_TEST(Paint_copy, reporter) {
     REPORTER_ASSERT(reporter, cleanPaint == copiedPaint);
 }
 
+// Copies share their effects until one of them changes an effect.
+DEF_TEST(Paint_copyOnWrite, reporter) {
+    SkAutoTUnref<SkMaskFilter> mask(SkBlurMaskFilter::Create(kNormal_SkBlurStyle,
+                                    SkBlurMask::ConvertRadiusToSigma(SkIntToScalar(1))));
+    SkAutoTUnref<SkXfermode> xfer(SkXfermode::Create(SkXfermode::kMultiply_Mode));
+
+    SkPaint paint;
+    paint.setMaskFilter(mask);
+    SkPaint copy(paint);
+    copy.setXfermode(xfer);
+    REPORTER_ASSERT(reporter, copy.getMaskFilter() == mask);
+    REPORTER_ASSERT(reporter, copy.getXfermode() == xfer);
+    REPORTER_ASSERT(reporter, paint.getMaskFilter() == mask);
+    REPORTER_ASSERT(reporter, NULL == paint.getXfermode());
+    REPORTER_ASSERT(reporter, paint != copy);
+
+    copy.setXfermode(NULL);
+    REPORTER_ASSERT(reporter, paint == copy);
+    REPORTER_ASSERT(reporter, paint.getHash() == copy.getHash());
+
+    paint.setMaskFilter(NULL);
+    REPORTER_ASSERT(reporter, NULL == paint.getMaskFilter());
+    REPORTER_ASSERT(reporter, copy.getMaskFilter() == mask);
+
+    // Clearing every effect compares (and hashes) equal to a paint that never had any.
+    copy.setMaskFilter(NULL);
+    SkPaint clean;
+    REPORTER_ASSERT(reporter, clean == copy);
+    REPORTER_ASSERT(reporter, clean.getHash() == copy.getHash());
+}
+
 // found and fixed for webkit: mishandling when we hit recursion limit on
 // mostly degenerate cubic flatness test
 DEF_TEST(Paint_regression_cubic, reporter) {
@@ -63,3 +63,32 @@ DEF_TEST(ParsePath, reporter) {
     p.addRoundRect(r, 4, 4.5f);
     test_to_from(reporter, p);
 }
+
+// ToSVGString writes the shortest scalars that read back as the same floats.
+DEF_TEST(ParsePath_ToSVGString, reporter) {
+    SkPath path;
+    path.moveTo(0, -0.5f);
+    path.lineTo(123456.7f, 1e-5f);
+    path.quadTo(-999999.6f, 0.000123456789f, 2.5f, 1e7f);
+    path.close();
+
+    SkString str;
+    SkParsePath::ToSVGString(path, &str);
+    static const char kExpected[] =
+            "M0 -0.5L123456.7 1e-05Q-999999.6 0.00012345679 2.5 10000000L0 -0.5Z";
+    REPORTER_ASSERT(reporter, str.equals(kExpected));
+    if (!str.equals(kExpected)) {
+        SkDebugf("str=%s\n", str.c_str());
+    }
+
+    for (int i = -2000; i <= 2000; i++) {
+        const SkScalar value = i / 7.f;
+        path.reset();
+        path.moveTo(value, -value);
+        SkParsePath::ToSVGString(path, &str);
+
+        SkPath path2;
+        REPORTER_ASSERT(reporter, SkParsePath::FromSVGString(str.c_str(), &path2));
+        REPORTER_ASSERT(reporter, path2.getPoint(0) == SkPoint::Make(value, -value));
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPatchUtils.h"
+#include "Test.h"
+
+static void make_patch(SkPoint cubics[12], SkScalar offset) {
+    const SkPoint pts[] = {
+        { 0, 0 }, { 30, -10 }, { 70, 10 }, { 100, 0 },      // top
+        { 110, 30 }, { 90, 70 },                            // right
+        { 100, 100 }, { 70, 110 }, { 30, 90 }, { 0, 100 },  // bottom
+        { -10, 70 }, { 10, 30 },                            // left
+    };
+    for (int i = 0; i < SkPatchUtils::kNumCtrlPts; ++i) {
+        cubics[i].set(pts[i].fX + offset, pts[i].fY);
+    }
+}
+
+DEF_TEST(PatchUtils_CachedVertexData, reporter) {
+    SkPoint cubics[12];
+    make_patch(cubics, 1234.5f);
+    const SkColor colors[4] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorCYAN };
+    const SkPoint texCoords[4] = { { 0, 0 }, { 16, 0 }, { 16, 16 }, { 0, 16 } };
+
+    SkPatchUtils::VertexData expected;
+    REPORTER_ASSERT(reporter, SkPatchUtils::getVertexData(&expected, cubics, colors, texCoords,
+                                                          12, 9));
+
+    SkPatchUtils::VertexData first;
+    REPORTER_ASSERT(reporter, SkPatchUtils::GetCachedVertexData(&first, cubics, colors, texCoords,
+                                                                12, 9));
+    REPORTER_ASSERT(reporter, expected.fVertexCount == first.fVertexCount);
+    REPORTER_ASSERT(reporter, expected.fIndexCount == first.fIndexCount);
+    REPORTER_ASSERT(reporter, !memcmp(expected.fPoints, first.fPoints,
+                                      expected.fVertexCount * sizeof(SkPoint)));
+    REPORTER_ASSERT(reporter, !memcmp(expected.fTexCoords, first.fTexCoords,
+                                      expected.fVertexCount * sizeof(SkPoint)));
+    REPORTER_ASSERT(reporter, !memcmp(expected.fColors, first.fColors,
+                                      expected.fVertexCount * sizeof(uint32_t)));
+    REPORTER_ASSERT(reporter, !memcmp(expected.fIndices, first.fIndices,
+                                      expected.fIndexCount * sizeof(uint16_t)));
+
+    // The same patch at the same level of detail comes back from the cache.
+    SkPatchUtils::VertexData second;
+    REPORTER_ASSERT(reporter, SkPatchUtils::GetCachedVertexData(&second, cubics, colors, texCoords,
+                                                                12, 9));
+    REPORTER_ASSERT(reporter, first.fPoints == second.fPoints);
+
+    // Anything that changes the tessellation misses it.
+    SkPatchUtils::VertexData noColors;
+    REPORTER_ASSERT(reporter, SkPatchUtils::GetCachedVertexData(&noColors, cubics, NULL, texCoords,
+                                                                12, 9));
+    REPORTER_ASSERT(reporter, NULL == noColors.fColors);
+    REPORTER_ASSERT(reporter, first.fPoints != noColors.fPoints);
+
+    SkPatchUtils::VertexData otherLOD;
+    REPORTER_ASSERT(reporter, SkPatchUtils::GetCachedVertexData(&otherLOD, cubics, colors,
+                                                                texCoords, 12, 10));
+    REPORTER_ASSERT(reporter, first.fPoints != otherLOD.fPoints);
+    REPORTER_ASSERT(reporter, 13 * 11 == otherLOD.fVertexCount);
+}
@@ -8,6 +8,7 @@
 #include "PathOpsExtendedTest.h"
 #include "PathOpsTestCommon.h"
 #include "SkBitmap.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 DEF_TEST(PathOpsBuilder, reporter) {
@@ -271,3 +272,60 @@ DEF_TEST(Fuzz846, reporter) {
     builder.resolve(&result);
 }
 
+
+// Many overlapping contours, so the intersections are found on the task threads, and a builder
+// reused across resolves, so later ops run in the arena the earlier ones left behind. Neither may
+// change the result.
+DEF_TEST(PathOpsBuilderReuse, reporter) {
+    SkRandom rand;
+    SkPath paths[4];
+    for (int i = 0; i < (int) SK_ARRAY_COUNT(paths); ++i) {
+        for (int j = 0; j < 30; ++j) {
+            SkScalar x = rand.nextRangeF(0, 100);
+            SkScalar y = rand.nextRangeF(0, 100);
+            paths[i].addRect(x, y, x + rand.nextRangeF(5, 50), y + rand.nextRangeF(5, 50));
+        }
+    }
+    SkOpBuilder builder;
+    for (int i = 1; i < (int) SK_ARRAY_COUNT(paths); ++i) {
+        SkPath expected;
+        REPORTER_ASSERT(reporter, Op(paths[0], paths[i], kXOR_SkPathOp, &expected));
+        builder.add(paths[0], kUnion_SkPathOp);
+        builder.add(paths[i], kXOR_SkPathOp);
+        SkPath result;
+        REPORTER_ASSERT(reporter, builder.resolve(&result));
+        REPORTER_ASSERT(reporter, result == expected);
+    }
+}
+
+// Unions of many paths are merged in pairs; the result must cover what unioning them one at a
+// time does.
+DEF_TEST(PathOpsBuilderUnionTree, reporter) {
+    SkRandom rand;
+    for (int count = 3; count <= 67; count += 32) {
+        SkOpBuilder builder;
+        SkPath expected;
+        for (int index = 0; index < count; ++index) {
+            SkPath path;
+            SkScalar x = rand.nextRangeF(0, 200);
+            SkScalar y = rand.nextRangeF(0, 200);
+            SkScalar size = rand.nextRangeF(5, 40);
+            if (index & 1) {
+                path.addCircle(x, y, size);
+            } else {
+                // neither convex nor apart from the others, so the paths can't just be added
+                path.moveTo(x, y);
+                path.lineTo(x + size, y + size);
+                path.lineTo(x + size, y);
+                path.lineTo(x, y + size);
+                path.close();
+            }
+            builder.add(path, kUnion_SkPathOp);
+            REPORTER_ASSERT(reporter, Op(expected, path, kUnion_SkPathOp, &expected));
+        }
+        SkPath result;
+        REPORTER_ASSERT(reporter, builder.resolve(&result));
+        int pixelDiff = comparePaths(reporter, __FUNCTION__, result, expected);
+        REPORTER_ASSERT(reporter, pixelDiff == 0);
+    }
+}
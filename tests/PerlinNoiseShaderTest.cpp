@@ -0,0 +1,68 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkPerlinNoiseShader.h"
+#include "Test.h"
+
+static const int kW = 150, kH = 100;
+
+// Spans this narrow are shaded directly instead of from the cache of rendered noise blocks.
+static const int kNarrowColumn = 8;
+
+static void draw_noise(SkBitmap* bm, SkShader* shader, int dx, int dy, bool narrow) {
+    bm->allocN32Pixels(kW, kH);
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bm);
+    canvas.translate(SkIntToScalar(dx), SkIntToScalar(dy));
+    SkPaint paint;
+    paint.setShader(shader);
+    paint.setAlpha(0xC0);
+    paint.setXfermodeMode(SkXfermode::kSrc_Mode);
+    const SkRect bounds = SkRect::MakeXYWH(SkIntToScalar(-dx), SkIntToScalar(-dy),
+                                           SkIntToScalar(kW), SkIntToScalar(kH));
+    if (!narrow) {
+        canvas.drawRect(bounds, paint);
+        return;
+    }
+    for (SkScalar x = bounds.left(); x < bounds.right(); x += kNarrowColumn) {
+        canvas.drawRect(SkRect::MakeLTRB(x, bounds.top(), x + kNarrowColumn, bounds.bottom()),
+                        paint);
+    }
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    SkAutoLockPixels alpa(a), alpb(b);
+    for (int y = 0; y < kH; ++y) {
+        if (memcmp(a.getAddr32(0, y), b.getAddr32(0, y), kW * sizeof(SkPMColor))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Noise copied from cached blocks must match noise shaded pixel by pixel, wherever the draw
+// falls relative to the block grid.
+DEF_TEST(PerlinNoiseShader_CachedBlocks, reporter) {
+    const SkISize tileSize = SkISize::Make(40, 30);
+    SkAutoTUnref<SkShader> fractal(SkPerlinNoiseShader::CreateFractalNoise(0.05f, 0.08f, 3, 2));
+    SkAutoTUnref<SkShader> stitched(SkPerlinNoiseShader::CreateTurbulence(0.1f, 0.03f, 2, 5,
+                                                                          &tileSize));
+    SkShader* shaders[] = { fractal, stitched };
+    const SkIPoint offsets[] = { { 0, 0 }, { 37, -91 }, { -200, 13 } };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(shaders); ++i) {
+        for (size_t j = 0; j < SK_ARRAY_COUNT(offsets); ++j) {
+            SkBitmap direct, cached, cachedAgain;
+            draw_noise(&direct, shaders[i], offsets[j].x(), offsets[j].y(), true);
+            draw_noise(&cached, shaders[i], offsets[j].x(), offsets[j].y(), false);
+            draw_noise(&cachedAgain, shaders[i], offsets[j].x(), offsets[j].y(), false);
+            REPORTER_ASSERT(reporter, equal_pixels(direct, cached));
+            REPORTER_ASSERT(reporter, equal_pixels(direct, cachedAgain));
+        }
+    }
+}
@@ -40,3 +40,33 @@ DEF_TEST(PictureShader_empty, reporter) {
     canvas.drawRect(SkRect::MakeWH(1,1), paint);
     REPORTER_ASSERT(reporter, *bitmap.getAddr32(0,0) == SK_ColorGREEN);
 }
+
+// Test that a picture shader keeps drawing correctly as the CTM scale drifts between buckets,
+// whether it shades with a freshly rasterized tile or a nearby cached one.
+DEF_TEST(PictureShader_scaleBuckets, reporter) {
+    SkPictureRecorder recorder;
+    SkCanvas* pictureCanvas = recorder.beginRecording(10, 10, NULL, 0);
+    SkPaint green;
+    green.setColor(SK_ColorGREEN);
+    pictureCanvas->drawRect(SkRect::MakeWH(10, 10), green);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkPaint paint;
+    paint.setShader(SkShader::CreatePictureShader(
+            picture, SkShader::kRepeat_TileMode, SkShader::kRepeat_TileMode, NULL, NULL))->unref();
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    SkCanvas canvas(bitmap);
+
+    const SkScalar scales[] = { 1, 1.01f, 1.05f, 1.1f, 1.3f, 2, 1.9f, 0.6f, 0.55f, 1 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(scales); i++) {
+        canvas.clear(SK_ColorRED);
+        canvas.save();
+        canvas.scale(scales[i], scales[i]);
+        canvas.drawPaint(paint);
+        canvas.restore();
+        REPORTER_ASSERT(reporter, *bitmap.getAddr32(32, 32) == SK_ColorGREEN);
+        REPORTER_ASSERT(reporter, *bitmap.getAddr32(3, 60) == SK_ColorGREEN);
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "SkBBoxHierarchy.h"
 #include "SkBlurImageFilter.h"
+#include "SkBlurMaskFilter.h"
 #include "SkCanvas.h"
 #include "SkColorMatrixFilter.h"
 #include "SkColorPriv.h"
@@ -29,6 +30,8 @@
 #include "SkRecord.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkTaskGroup.h"
+#include "SkUtils.h"
 #include "sk_tool_utils.h"
 
 #if SK_SUPPORT_GPU
@@ -124,6 +127,64 @@ static void rand_op(SkCanvas* canvas, SkRandom& rand) {
     }
 }
 
+static void test_gpu_cost_model(skiatest::Reporter* reporter) {
+    SkPictureRecorder recorder;
+
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    {
+        SkPath path;
+        path.moveTo(0, 0);
+        path.lineTo(0, 100);
+        path.lineTo(50, 50);
+        path.lineTo(100, 100);
+        path.lineTo(100, 0);
+        path.close();
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 4; ++i) {
+            canvas->drawPath(path, paint);
+        }
+
+        SkPaint blurPaint;
+        blurPaint.setMaskFilter(SkBlurMaskFilter::Create(kNormal_SkBlurStyle, 2))->unref();
+        canvas->drawRect(SkRect::MakeWH(10, 10), blurPaint);
+    }
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    SkPicture::GpuCostFeatures features = picture->gpuCostFeatures();
+    REPORTER_ASSERT(reporter, 4 == features.fConcaveAAPaths);
+    REPORTER_ASSERT(reporter, 0 == features.fPathEffects);
+    REPORTER_ASSERT(reporter, 1 == features.fMaskFilters);
+    REPORTER_ASSERT(reporter, 40000 == features.fConcaveAAPathArea);
+
+    // The default model only charges for slow paths, and allows five of them.
+    REPORTER_ASSERT(reporter, 4 == picture->estimateGpuCostPenalty());
+    REPORTER_ASSERT(reporter, picture->suitableForGpuRasterization(NULL));
+
+    SkPicture::GpuCostModel model;
+    model.fMaskFilter = 2;
+    REPORTER_ASSERT(reporter, 6 == picture->estimateGpuCostPenalty(model));
+    const char* reason = NULL;
+    REPORTER_ASSERT(reporter, !picture->suitableForGpuRasterization(NULL, model, &reason));
+    REPORTER_ASSERT(reporter, reason);
+
+    model = SkPicture::GpuCostModel();
+    model.fConcaveAAPath = 0;
+    model.fConcaveAAPathMegapixel = 100;
+    REPORTER_ASSERT(reporter, SkScalarNearlyEqual(4, picture->estimateGpuCostPenalty(model)));
+
+    // Features of nested pictures are included in their parent's.
+    canvas = recorder.beginRecording(100, 100);
+    canvas->drawPicture(picture);
+    canvas->drawPicture(picture);
+    SkAutoTUnref<SkPicture> parent(recorder.endRecording());
+    features = parent->gpuCostFeatures();
+    REPORTER_ASSERT(reporter, 8 == features.fConcaveAAPaths);
+    REPORTER_ASSERT(reporter, 2 == features.fMaskFilters);
+    REPORTER_ASSERT(reporter, !parent->suitableForGpuRasterization(NULL));
+}
+
 #if SK_SUPPORT_GPU
 
 static void test_gpu_veto(skiatest::Reporter* reporter) {
@@ -1146,6 +1207,7 @@ DEF_TEST(Picture, reporter) {
 #endif
     test_unbalanced_save_restores(reporter);
     test_peephole();
+    test_gpu_cost_model(reporter);
 #if SK_SUPPORT_GPU
     test_gpu_veto(reporter);
 #endif
@@ -1333,6 +1395,50 @@ DEF_TEST(Picture_getRecordingCanvas, r) {
     }
 }
 
+static SkColor draw_picture_color(const SkPicture* picture) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(10, 10);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.drawPicture(picture);
+    return bitmap.getColor(5, 5);
+}
+
+DEF_TEST(Picture_ReuseStorage, r) {
+    SkBitmap immut;
+    immut.allocN32Pixels(4, 4);
+    immut.setImmutable();
+
+    static const SkColor kColors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE, SK_ColorCYAN };
+    SkPictureRecorder rec;
+    SkAutoTUnref<SkPicture> previous;
+    for (int i = 0; i < 4; ++i) {
+        SkCanvas* canvas = rec.beginRecording(10, 10, NULL,
+                                              SkPictureRecorder::kReuseStorage_RecordFlag);
+        if (2 == i) {
+            // The first recording's picture is gone, so its storage is reused, and what it held
+            // on to is released.
+            REPORTER_ASSERT(r, immut.pixelRef()->unique());
+        }
+        if (0 == i) {
+            canvas->drawBitmap(immut, 0, 0);
+        }
+        SkPaint paint;
+        paint.setColor(kColors[i]);
+        canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+        canvas->drawRect(SkRect::MakeWH(5, 5), paint);
+        SkAutoTUnref<SkPicture> picture(rec.endRecording());
+        REPORTER_ASSERT(r, kColors[i] == draw_picture_color(picture));
+
+        // The previous picture is still alive while this one was recorded, and is left intact.
+        if (previous) {
+            REPORTER_ASSERT(r, kColors[i - 1] == draw_picture_color(previous));
+        }
+        previous.reset(picture.detach());
+    }
+    REPORTER_ASSERT(r, immut.pixelRef()->unique());
+}
+
 DEF_TEST(MiniRecorderLeftHanging, r) {
     // Any shader or other ref-counted effect will do just fine here.
     SkPaint paint;
@@ -1362,3 +1468,205 @@ DEF_TEST(Picture_preserveCullRect, r) {
     REPORTER_ASSERT(r, deserializedPicture->cullRect().right() == 3);
     REPORTER_ASSERT(r, deserializedPicture->cullRect().bottom() == 4);
 }
+
+static bool draws_same(SkPicture* a, SkPicture* b) {
+    SkBitmap bmA, bmB;
+    bmA.allocN32Pixels(40, 40);
+    bmB.allocN32Pixels(40, 40);
+    bmA.eraseColor(SK_ColorTRANSPARENT);
+    bmB.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvasA(bmA), canvasB(bmB);
+    canvasA.drawPicture(a);
+    canvasB.drawPicture(b);
+    SkAutoLockPixels lockA(bmA), lockB(bmB);
+    return 0 == memcmp(bmA.getPixels(), bmB.getPixels(), bmA.getSize());
+}
+
+// The buffer section holding the ops is padded to start 4-byte aligned in the stream, so SKPs
+// read from memory can use it in place.  Whether or not that is possible, the picture must
+// read back the same.
+DEF_TEST(Picture_AlignedOpData, r) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(40, 40);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(5, 5, 20, 10), paint);
+    SkPath path;
+    path.addCircle(20, 20, 8);
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawPath(path, paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    const uint32_t kBufferTag = SkSetFourByteTag('a', 'r', 'a', 'y');
+    for (size_t prefix = 0; prefix < 4; ++prefix) {
+        SkDynamicMemoryWStream wstream;
+        for (size_t i = 0; i < prefix; ++i) {
+            wstream.write8(0);
+        }
+        picture->serialize(&wstream);
+        SkAutoTUnref<SkData> data(wstream.copyToData());
+
+        // The buffer section, holding the ops, follows the tag and size.
+        bool foundOps = false;
+        for (size_t i = prefix; i + 8 <= data->size(); ++i) {
+            uint32_t tag;
+            memcpy(&tag, data->bytes() + i, sizeof(tag));
+            if (kBufferTag == tag) {
+                REPORTER_ASSERT(r, SkIsAlign4(i + 8));
+                foundOps = true;
+                break;
+            }
+        }
+        REPORTER_ASSERT(r, foundOps);
+
+        // Read in place, and from a stream whose memory is not aligned the same way.
+        SkMemoryStream alignedStream(data);
+        alignedStream.skip(prefix);
+        SkAutoTUnref<SkPicture> aligned(SkPicture::CreateFromStream(&alignedStream));
+        REPORTER_ASSERT(r, aligned && draws_same(picture, aligned));
+
+        SkAutoTMalloc<char> shifted(data->size() + 1);
+        memcpy(shifted.get() + 1, data->data(), data->size());
+        SkMemoryStream shiftedStream(shifted.get() + 1, data->size());
+        shiftedStream.skip(prefix);
+        SkAutoTUnref<SkPicture> copied(SkPicture::CreateFromStream(&shiftedStream));
+        REPORTER_ASSERT(r, copied && draws_same(picture, copied));
+    }
+}
+
+namespace {
+
+// Fills its pixels with a solid color, counting how many times it's asked to.
+class CountingGenerator : public SkImageGenerator {
+public:
+    CountingGenerator(int32_t* decodes)
+        : INHERITED(SkImageInfo::MakeN32Premul(16, 16)), fDecodes(decodes) {}
+
+protected:
+    bool onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                     SkPMColor[], int*) override {
+        sk_atomic_inc(fDecodes);
+        for (int y = 0; y < info.height(); y++) {
+            sk_memset32((uint32_t*)((char*)pixels + y * rowBytes), SK_ColorBLUE, info.width());
+        }
+        return true;
+    }
+
+private:
+    int32_t* fDecodes;
+
+    typedef SkImageGenerator INHERITED;
+};
+
+} // namespace
+
+DEF_TEST(Picture_PredecodeImages, r) {
+    int32_t visibleDecodes = 0, hiddenDecodes = 0, shaderDecodes = 0;
+    SkAutoTUnref<SkImage> visible(
+            SkImage::NewFromGenerator(SkNEW_ARGS(CountingGenerator, (&visibleDecodes))));
+    SkAutoTUnref<SkImage> hidden(
+            SkImage::NewFromGenerator(SkNEW_ARGS(CountingGenerator, (&hiddenDecodes))));
+    SkBitmap shaderBitmap;
+    REPORTER_ASSERT(r, SkInstallDiscardablePixelRef(SkNEW_ARGS(CountingGenerator,
+                                                               (&shaderDecodes)),
+                                                    &shaderBitmap));
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    paint.setFilterQuality(kMedium_SkFilterQuality);
+    canvas->drawImageRect(visible, SkRect::MakeWH(8, 8), &paint);
+    canvas->drawImage(visible, 20, 20);
+    canvas->drawImage(hidden, 80, 80);
+    SkPaint shaderPaint;
+    shaderPaint.setShader(SkShader::CreateBitmapShader(shaderBitmap, SkShader::kRepeat_TileMode,
+                                                       SkShader::kRepeat_TileMode))->unref();
+    canvas->drawRect(SkRect::MakeXYWH(40, 0, 10, 10), shaderPaint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    // Only the images drawn inside the clip get decoded, each just once.
+    const SkIRect clip = SkIRect::MakeWH(60, 60);
+    SkPictureUtils::PredecodeImages(picture, SkMatrix::I(), &clip);
+    REPORTER_ASSERT(r, 1 == visibleDecodes);
+    REPORTER_ASSERT(r, 0 == hiddenDecodes);
+    REPORTER_ASSERT(r, 1 == shaderDecodes);
+
+    // Playback finds them already decoded.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(60, 60);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas playback(bitmap);
+    playback.drawPicture(picture);
+    REPORTER_ASSERT(r, 1 == visibleDecodes);
+    REPORTER_ASSERT(r, 1 == shaderDecodes);
+    REPORTER_ASSERT(r, SK_ColorBLUE == bitmap.getColor(25, 25));
+    REPORTER_ASSERT(r, SK_ColorBLUE == bitmap.getColor(45, 5));
+}
+
+// One picture, played back from many threads at once, must draw the same thing every time.
+// The paths are recorded with unknown convexity and no generation ID, so the playbacks race to
+// fill in those caches, and the lazy image is decoded on demand by whichever thread gets there.
+DEF_TEST(Picture_ParallelPlayback, r) {
+    int32_t decodes = 0;
+    SkAutoTUnref<SkImage> lazy(
+            SkImage::NewFromGenerator(SkNEW_ARGS(CountingGenerator, (&decodes))));
+
+    SkPath convex;
+    convex.moveTo(10, 10);
+    convex.lineTo(50, 15);
+    convex.lineTo(45, 50);
+    convex.lineTo(12, 40);
+    convex.close();
+    SkPath concave;
+    concave.moveTo(60, 10);
+    concave.lineTo(90, 10);
+    concave.lineTo(75, 25);
+    concave.lineTo(90, 40);
+    concave.lineTo(60, 40);
+    concave.close();
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorRED);
+    canvas->drawPath(convex, paint);
+    canvas->drawPath(concave, paint);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    canvas->drawPath(convex, paint);
+    canvas->drawImage(lazy, 20, 60);
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawText("threads", 7, 50, 90, paint);
+    SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    SkBitmap expected;
+    expected.allocPixels(info);
+    expected.eraseColor(SK_ColorWHITE);
+    {   // Draw the reference from a re-recorded copy so the original's caches stay cold.
+        SkPictureRecorder copyRecorder;
+        picture->playback(copyRecorder.beginRecording(100, 100));
+        SkAutoTUnref<SkPicture> copy(copyRecorder.endRecording());
+        SkCanvas(expected).drawPicture(copy);
+    }
+
+    static const int kThreads = 16;
+    SkBitmap results[kThreads];
+    for (int i = 0; i < kThreads; i++) {
+        results[i].allocPixels(info);
+        results[i].eraseColor(SK_ColorWHITE);
+    }
+    sk_parallel_for(kThreads, [&](int i) {
+        SkCanvas(results[i]).drawPicture(picture);
+    });
+
+    SkAutoLockPixels lockExpected(expected);
+    for (int i = 0; i < kThreads; i++) {
+        SkAutoLockPixels lock(results[i]);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), results[i].getPixels(),
+                                       expected.getSafeSize()));
+    }
+    REPORTER_ASSERT(r, decodes >= 1);
+}
@@ -9,8 +9,11 @@
 #include "SkBitmap.h"
 #include "SkCanvas.h"
 #include "SkGPipe.h"
+#include "SkGPipeRingController.h"
 #include "SkPaint.h"
+#include "SkRandom.h"
 #include "SkShader.h"
+#include "SkThreadUtils.h"
 #include "Test.h"
 
 // Ensures that the pipe gracefully handles drawing an invalid bitmap.
@@ -54,3 +57,253 @@ DEF_TEST(Pipe, reporter) {
 
     testDrawingAfterEndRecording(&canvas);
 }
+
+static void draw_lots(SkCanvas* canvas) {
+    SkRandom rand;
+    SkPaint paint;
+    for (int i = 0; i < 2000; ++i) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        paint.setAntiAlias(rand.nextBool());
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(-8, 64), rand.nextRangeScalar(-8, 64),
+                                    rand.nextRangeScalar(1, 16), rand.nextRangeScalar(1, 16));
+        if (i % 3) {
+            canvas->drawRect(r, paint);
+        } else {
+            SkPath path;
+            path.addOval(r);
+            path.lineTo(rand.nextRangeScalar(0, 64), rand.nextRangeScalar(0, 64));
+            canvas->drawPath(path, paint);
+        }
+    }
+}
+
+struct RingPlayback {
+    SkGPipeRingController* fController;
+    SkGPipeReader*         fReaders[2];
+    SkGPipeReader::Status  fStatus;
+};
+
+static void play_ring(void* data) {
+    RingPlayback* playback = static_cast<RingPlayback*>(data);
+    playback->fStatus = playback->fController->playback(playback->fReaders);
+}
+
+// Records on this thread while another plays back through a ring small enough to fill up and
+// wrap around many times, and checks that every reader draws what was recorded.
+static void test_ring(skiatest::Reporter* reporter, int numberOfReaders, uint32_t flags) {
+    SkBitmap expected;
+    expected.allocN32Pixels(64, 64);
+    expected.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected);
+    draw_lots(&expectedCanvas);
+
+    SkBitmap bitmaps[2];
+    SkAutoTUnref<SkCanvas> canvases[2];
+    SkAutoTDelete<SkGPipeReader> readers[2];
+    RingPlayback playback;
+    SkGPipeRingController controller(40 * 1024, numberOfReaders, 512);
+    playback.fController = &controller;
+    playback.fStatus = SkGPipeReader::kError_Status;
+    for (int i = 0; i < numberOfReaders; ++i) {
+        bitmaps[i].allocN32Pixels(64, 64);
+        bitmaps[i].eraseColor(SK_ColorWHITE);
+        canvases[i].reset(SkNEW_ARGS(SkCanvas, (bitmaps[i])));
+        readers[i].reset(SkNEW_ARGS(SkGPipeReader, (canvases[i])));
+        playback.fReaders[i] = readers[i];
+    }
+
+    SkThread thread(play_ring, &playback);
+    thread.start();
+    {
+        SkGPipeWriter writer;
+        draw_lots(writer.startRecording(&controller, flags));
+        writer.endRecording();
+        thread.join();
+    }
+
+    REPORTER_ASSERT(reporter, SkGPipeReader::kDone_Status == playback.fStatus);
+    for (int i = 0; i < numberOfReaders; ++i) {
+        REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), bitmaps[i].getPixels(),
+                                          expected.getSize()));
+    }
+}
+
+DEF_TEST(Pipe_RingController, reporter) {
+    test_ring(reporter, 1, 0);
+    test_ring(reporter, 1, SkGPipeWriter::kCrossProcess_Flag);
+    test_ring(reporter, 2, SkGPipeWriter::kSimultaneousReaders_Flag);
+
+    // A block bigger than half the ring ends the recording, and the reader with it.
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    SkAutoTUnref<SkCanvas> canvas(SkNEW_ARGS(SkCanvas, (bitmap)));
+    SkGPipeReader reader(canvas);
+    SkGPipeRingController controller(16 * 1024);
+    SkGPipeReader* readers[] = { &reader };
+    SkGPipeWriter writer;
+    writer.startRecording(&controller);
+    writer.endRecording();
+    REPORTER_ASSERT(reporter, SkGPipeReader::kDone_Status != controller.playback(readers));
+}
+
+// One segment of "shared" memory, which the reader maps at the same address.
+class TestSharedMemory : public SkGPipeSharedMemory {
+public:
+    TestSharedMemory(size_t size) : fSegment(size), fSize(size), fMapped(0), fMaps(0) {}
+
+    bool findSegment(const void* pixels, size_t size, uint32_t* handle, size_t* offset) override {
+        const uint8_t* p = static_cast<const uint8_t*>(pixels);
+        if (p < fSegment.get() || p + size > fSegment.get() + fSize) {
+            return false;
+        }
+        *handle = kHandle;
+        *offset = p - fSegment.get();
+        return true;
+    }
+
+    void* map(uint32_t handle, size_t* size) override {
+        if (kHandle != handle) {
+            return NULL;
+        }
+        fMapped++;
+        fMaps++;
+        *size = fSize;
+        return fSegment.get();
+    }
+
+    void unmap(uint32_t handle, void* addr) override {
+        SkASSERT(kHandle == handle && fSegment.get() == addr);
+        fMapped--;
+    }
+
+    uint8_t* segment() { return fSegment.get(); }
+
+    enum { kHandle = 7 };
+    SkAutoTMalloc<uint8_t> fSegment;
+    size_t                 fSize;
+    int                    fMapped;
+    int                    fMaps;
+};
+
+class SharedMemoryPipeController : public PipeController {
+public:
+    SharedMemoryPipeController(SkCanvas* target, TestSharedMemory* sharedMemory)
+        : INHERITED(target), fSharedMemory(sharedMemory), fBytes(0) {
+        fReader.setSharedMemory(sharedMemory);
+    }
+
+    void notifyWritten(size_t bytes) override {
+        fBytes += bytes;
+        this->INHERITED::notifyWritten(bytes);
+    }
+    SkGPipeSharedMemory* sharedMemory() const override { return fSharedMemory; }
+
+    TestSharedMemory* fSharedMemory;
+    size_t            fBytes;
+
+    typedef PipeController INHERITED;
+};
+
+// Draws bitmap through a cross-process pipe, checks that it draws as it does directly, and
+// returns how many bytes went through the pipe.
+static size_t draw_shared(skiatest::Reporter* reporter, const SkBitmap& bitmap,
+                          TestSharedMemory* sharedMemory) {
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(bitmap.width() + 10, bitmap.height() + 10);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.allocN32Pixels(bitmap.width() + 10, bitmap.height() + 10);
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas expectedCanvas(expected);
+    expectedCanvas.drawBitmap(bitmap, 5, 5);
+
+    SkCanvas canvas(actual);
+    size_t bytes;
+    {
+        SharedMemoryPipeController controller(&canvas, sharedMemory);
+        SkGPipeWriter writer;
+        writer.startRecording(&controller, SkGPipeWriter::kCrossProcess_Flag)->drawBitmap(bitmap,
+                                                                                       5, 5);
+        writer.endRecording();
+        bytes = controller.fBytes;
+    }
+    REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                      expected.getSize()));
+    return bytes;
+}
+
+DEF_TEST(Pipe_SharedMemory, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(128, 128);
+    SkAutoTUnref<TestSharedMemory> sharedMemory(SkNEW_ARGS(TestSharedMemory,
+                                                           (64 + info.getSafeSize(512))));
+    SkBitmap bitmap;
+    bitmap.installPixels(info, sharedMemory->segment() + 64, 512);
+    for (int y = 0; y < bitmap.height(); ++y) {
+        for (int x = 0; x < bitmap.width(); ++x) {
+            *bitmap.getAddr32(x, y) = SkPackARGB32(0xFF, x * 2, y * 2, 0x80);
+        }
+    }
+
+    // The pixels are handed over by handle, and unmapped once the reader is done.
+    const size_t sharedBytes = draw_shared(reporter, bitmap, sharedMemory);
+    REPORTER_ASSERT(reporter, sharedBytes < info.getSafeSize(512) / 16);
+    REPORTER_ASSERT(reporter, sharedMemory->fMaps > 0);
+    REPORTER_ASSERT(reporter, 0 == sharedMemory->fMapped);
+
+    // Pixels outside of the shared memory are copied into the stream.
+    SkBitmap copy;
+    bitmap.copyTo(&copy);
+    const int maps = sharedMemory->fMaps;
+    REPORTER_ASSERT(reporter, draw_shared(reporter, copy, sharedMemory) > info.getSafeSize(info.minRowBytes()));
+    REPORTER_ASSERT(reporter, maps == sharedMemory->fMaps);
+}
+
+class TiledReaderPipeController : public PipeController {
+public:
+    TiledReaderPipeController(const SkBitmap& dst) : INHERITED(NULL) {
+        fReader.setTiledTarget(dst, 32, 32);
+    }
+
+private:
+    typedef PipeController INHERITED;
+};
+
+// Aliased rects rasterize the same whether or not they are clipped to a tile.
+static void draw_rects(SkCanvas* canvas) {
+    SkRandom rand;
+    SkPaint paint;
+    canvas->translate(3, 5);
+    canvas->clipRect(SkRect::MakeWH(80, 60));
+    for (int i = 0; i < 300; ++i) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(rand.nextULessThan(90)),
+                                          SkIntToScalar(rand.nextULessThan(70)),
+                                          SkIntToScalar(rand.nextRangeU(1, 20)),
+                                          SkIntToScalar(rand.nextRangeU(1, 20))), paint);
+    }
+}
+
+// Checks that a reader with a tiled target draws the same pixels as one with a canvas.
+DEF_TEST(Pipe_TiledPlayback, reporter) {
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(100, 70);
+    actual.allocN32Pixels(100, 70);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+
+    SkCanvas expectedCanvas(expected);
+    {
+        PipeController controller(&expectedCanvas);
+        SkGPipeWriter writer;
+        draw_rects(writer.startRecording(&controller));
+        writer.endRecording();
+    }
+    {
+        TiledReaderPipeController controller(actual);
+        SkGPipeWriter writer;
+        draw_rects(writer.startRecording(&controller));
+        writer.endRecording();
+    }
+
+    REPORTER_ASSERT(reporter, !memcmp(expected.getPixels(), actual.getPixels(),
+                                      expected.getSize()));
+}
@@ -7,6 +7,7 @@
 
 #include "SkCanvas.h"
 #include "SkDrawLooper.h"
+#include "SkRandom.h"
 #include "SkTypes.h"
 #include "Test.h"
 
@@ -103,7 +104,40 @@ static void test_layers(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, false == canvas.quickReject(SkRect::MakeWH(60, 60)));
 }
 
+// Under translate and scale matrices quickReject() maps the rect rather than the clip bounds,
+// so check it against the mapped rect: a rect that reaches into the clip is never rejected, and
+// one more than a pixel (the outset kept for aa) away from it always is.
+static void test_scale_translate(skiatest::Reporter* reporter) {
+    SkCanvas canvas(100, 100);
+    canvas.clipRect(SkRect::MakeLTRB(20, 30, 60, 70));
+    const SkRect clip = SkRect::MakeLTRB(20, 30, 60, 70);
+
+    SkRandom rand;
+    for (int i = 0; i < 1000; ++i) {
+        SkMatrix matrix;
+        matrix.setTranslate(rand.nextRangeScalar(-50, 50), rand.nextRangeScalar(-50, 50));
+        if (i & 1) {
+            matrix.preScale(rand.nextRangeScalar(0.25f, 4), rand.nextRangeScalar(0.25f, 4));
+        }
+        canvas.setMatrix(matrix);
+
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeScalar(-100, 100),
+                                    rand.nextRangeScalar(-100, 100),
+                                    rand.nextRangeScalar(0, 50), rand.nextRangeScalar(0, 50));
+        SkRect dev;
+        matrix.mapRect(&dev, r);
+        SkRect outset = clip;
+        outset.outset(1.5f, 1.5f);
+        if (SkRect::Intersects(dev, clip)) {
+            REPORTER_ASSERT(reporter, !canvas.quickReject(r));
+        } else if (!SkRect::Intersects(dev, outset)) {
+            REPORTER_ASSERT(reporter, canvas.quickReject(r));
+        }
+    }
+}
+
 DEF_TEST(QuickReject, reporter) {
     test_drawBitmap(reporter);
     test_layers(reporter);
+    test_scale_translate(reporter);
 }
@@ -11,6 +11,7 @@
 #include "SkDebugCanvas.h"
 #include "SkDropShadowImageFilter.h"
 #include "SkImagePriv.h"
+#include "SkLayerInfo.h"
 #include "SkRecord.h"
 #include "SkRecordDraw.h"
 #include "SkRecordOpts.h"
@@ -172,6 +173,48 @@ DEF_TEST(RecordDraw_BBH, r) {
     }
 }
 
+// Large records compute their bounds in parallel chunks.  They should match the serial bounds
+// SkRecordComputeLayers() computes, even for Save blocks and matrices spanning the chunks.
+DEF_TEST(RecordDraw_ParallelBBH, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+    SkPaint layerPaint;
+    layerPaint.setAlpha(0x80);
+    recorder.save();
+        recorder.clipRect(SkRect::MakeWH(1000, 800));
+        for (int i = 0; i < 6000; i++) {
+            if (i % 3 == 0) {
+                recorder.saveLayer(NULL, &layerPaint);
+            } else {
+                recorder.save();
+            }
+                recorder.translate(SkIntToScalar(i % 7), SkIntToScalar(i % 5));
+                recorder.clipRect(SkRect::MakeXYWH(SkIntToScalar(i % 300), 0, 600, 600));
+                recorder.drawRect(SkRect::MakeXYWH(0, 0, SkIntToScalar(i % 50), 20), SkPaint());
+                if (i % 11 == 0) {
+                    recorder.save();
+                        recorder.scale(2, 2);
+                        recorder.drawPaint(SkPaint());
+                    recorder.restore();
+                }
+            recorder.restore();
+        }
+    recorder.restore();
+    REPORTER_ASSERT(r, record.count() > 3 * 8192);
+
+    const SkRect cull = SkRect::MakeWH(SkIntToScalar(W), SkIntToScalar(H));
+    TestBBH parallel, serial;
+    SkLayerInfo layers;
+    SkRecordFillBounds(cull, record, &parallel);
+    SkRecordComputeLayers(cull, record, NULL, &serial, &layers);
+
+    REPORTER_ASSERT(r, parallel.fEntries.count() == (int)record.count());
+    REPORTER_ASSERT(r, serial.fEntries.count() == (int)record.count());
+    for (int i = 0; i < parallel.fEntries.count() && i < serial.fEntries.count(); i++) {
+        REPORTER_ASSERT(r, parallel.fEntries[i].bounds == serial.fEntries[i].bounds);
+    }
+}
+
 // A regression test for crbug.com/409110.
 DEF_TEST(RecordDraw_TextBounds, r) {
     SkRecord record;
@@ -331,3 +374,48 @@ DEF_TEST(RecordDraw_drawImage, r){
     REPORTER_ASSERT(r, canvas.fDrawImageRectCalled);
 
 }
+
+// Ops entirely hidden beneath a later opaque draw aren't played back.
+DEF_TEST(RecordDraw_Occlusion, r) {
+    SkPaint translucent;
+    translucent.setColor(0x80FF0000);
+
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+    recorder.drawRect(SkRect::MakeLTRB(10, 10, 50, 50), SkPaint());      // Hidden by 2.
+    recorder.drawOval(SkRect::MakeLTRB(100, 100, 150, 150), SkPaint());  // Hidden by 3.
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 60, 60), SkPaint());
+    recorder.save();
+        recorder.scale(2, 2);
+        recorder.drawRect(SkRect::MakeLTRB(40, 40, 80, 80), SkPaint());
+    recorder.restore();
+    recorder.drawRect(SkRect::MakeLTRB(55, 55, 65, 65), SkPaint());      // Partly visible.
+    recorder.drawRect(SkRect::MakeLTRB(0, 0, 30, 30), translucent);
+
+    SkRecord rerecord;
+    SkRecorder canvas(&rerecord, W, H);
+    SkRecordDraw(record, &canvas, NULL, NULL, 0, NULL/*bbh*/, NULL/*callback*/);
+    REPORTER_ASSERT(r, 4 == count_instances_of_type<SkRecords::DrawRect>(rerecord));
+    REPORTER_ASSERT(r, 0 == count_instances_of_type<SkRecords::DrawOval>(rerecord));
+
+    // Translucent draws, draws inside layers, and draws outside of rectangular clips don't hide
+    // anything.
+    SkRecord kept;
+    SkRecorder keptRecorder(&kept, W, H);
+    keptRecorder.drawRect(SkRect::MakeLTRB(10, 10, 20, 20), SkPaint());
+    keptRecorder.drawRect(SkRect::MakeLTRB(0, 0, 30, 30), translucent);
+    keptRecorder.saveLayer(NULL, NULL);
+        keptRecorder.drawRect(SkRect::MakeLTRB(0, 0, 30, 30), SkPaint());
+    keptRecorder.restore();
+    SkRRect oval;
+    oval.setOval(SkRect::MakeLTRB(0, 0, 30, 30));
+    keptRecorder.save();
+        keptRecorder.clipRRect(oval);
+        keptRecorder.drawRect(SkRect::MakeLTRB(0, 0, 30, 30), SkPaint());
+    keptRecorder.restore();
+
+    SkRecord keptRerecord;
+    SkRecorder keptCanvas(&keptRerecord, W, H);
+    SkRecordDraw(kept, &keptCanvas, NULL, NULL, 0, NULL/*bbh*/, NULL/*callback*/);
+    REPORTER_ASSERT(r, 4 == count_instances_of_type<SkRecords::DrawRect>(keptRerecord));
+}
@@ -13,6 +13,7 @@
 #include "SkRecordOpts.h"
 #include "SkRecorder.h"
 #include "SkRecords.h"
+#include "SkSurface.h"
 #include "SkXfermode.h"
 #include "SkPictureRecorder.h"
 #include "SkPictureImageFilter.h"
@@ -170,7 +171,7 @@ DEF_TEST(RecordOpts_NoopSaveLayerDrawRestore, r) {
 
     const SkRecords::DrawRect* drawRect = assert_type<SkRecords::DrawRect>(r, record, 16);
     REPORTER_ASSERT(r, drawRect != NULL);
-    REPORTER_ASSERT(r, drawRect->paint.getColor() == 0x03020202);
+    REPORTER_ASSERT(r, drawRect->paint->getColor() == 0x03020202);
 }
 
 static void assert_merge_svg_opacity_and_filter_layers(skiatest::Reporter* r,
@@ -308,3 +309,122 @@ DEF_TEST(RecordOpts_MergeSvgOpacityAndFilterLayers, r) {
     assert_type<SkRecords::Restore>(r, record, index + 3);
     index += 4;
 }
+
+DEF_TEST(RecordOpts_NoopRedundantSetMatrices, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkMatrix scale;
+    scale.setScale(2, 3);
+
+    recorder.setMatrix(SkMatrix::I());      // 0: Redundant, we start at identity.
+    recorder.setMatrix(scale);              // 1
+    recorder.drawRect(SkRect::MakeWH(10, 10), SkPaint());
+    recorder.setMatrix(scale);              // 3: Redundant.
+    recorder.save();
+        recorder.setMatrix(SkMatrix::I());  // 5
+    recorder.restore();                     // 6: Back to scale...
+    recorder.setMatrix(scale);              // 7: ...so this is redundant too.
+
+    SkRecordNoopRedundantSetMatrices(&record);
+    assert_type<SkRecords::NoOp>     (r, record, 0);
+    assert_type<SkRecords::SetMatrix>(r, record, 1);
+    assert_type<SkRecords::NoOp>     (r, record, 3);
+    assert_type<SkRecords::SetMatrix>(r, record, 5);
+    assert_type<SkRecords::NoOp>     (r, record, 7);
+}
+
+DEF_TEST(RecordOpts_NoopRedundantClipRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    recorder.clipRect(SkRect::MakeWH(100, 100));             // 0: We don't know the clip yet.
+    recorder.clipRect(SkRect::MakeWH(200, 200));             // 1: Contains the clip.
+    recorder.clipRect(SkRect::MakeLTRB(-0.5f, -0.5f, 100.5f, 100.5f), SkRegion::kIntersect_Op,
+                      true);                                 // 2: AA edges are too close.
+    recorder.clipRect(SkRect::MakeWH(50, 200));              // 3: Shrinks the clip.
+    recorder.clipRect(SkRect::MakeWH(500, 500), SkRegion::kUnion_Op);  // 4: Not an intersect.
+    recorder.save();
+        recorder.scale(2, 2);
+        recorder.clipRect(SkRect::MakeLTRB(-1, -1, 300, 300));  // 7: Contains the clip, scaled.
+    recorder.restore();
+
+    SkRecordNoopRedundantClipRects(&record);
+    assert_type<SkRecords::ClipRect>(r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 1);
+    assert_type<SkRecords::ClipRect>(r, record, 2);
+    assert_type<SkRecords::ClipRect>(r, record, 3);
+    assert_type<SkRecords::ClipRect>(r, record, 4);
+    assert_type<SkRecords::NoOp>    (r, record, 7);
+}
+
+DEF_TEST(RecordOpts_NoopOccludedDrawRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkPaint opaque, translucent, stroke;
+    opaque.setColor(0xFF00FF00);
+    translucent.setColor(0x8000FF00);
+    stroke.setStyle(SkPaint::kStroke_Style);
+    stroke.setStrokeWidth(4);
+
+    recorder.drawRect(SkRect::MakeXYWH(10, 10, 20, 20), translucent);   // 0: Covered by 3.
+    recorder.drawRect(SkRect::MakeXYWH(15, 15, 10, 10), stroke);        // 1: Covered by 3.
+    recorder.drawRect(SkRect::MakeXYWH(0, 0, 100, 100), translucent);   // 2: Too big.
+    recorder.drawRect(SkRect::MakeXYWH(5, 5, 40, 40), opaque);          // 3
+    recorder.drawRect(SkRect::MakeXYWH(6, 6, 38, 38), opaque);          // 4: Hugs 5 too closely.
+    recorder.drawRect(SkRect::MakeXYWH(5.5f, 5.5f, 39, 39), opaque);    // 5
+    recorder.clipRect(SkRect::MakeWH(500, 500));                        // 6
+    recorder.drawRect(SkRect::MakeWH(200, 200), opaque);                // 7: Clip came between.
+
+    SkRecordNoopOccludedDrawRects(&record);
+    assert_type<SkRecords::NoOp>    (r, record, 0);
+    assert_type<SkRecords::NoOp>    (r, record, 1);
+    assert_type<SkRecords::DrawRect>(r, record, 2);
+    assert_type<SkRecords::DrawRect>(r, record, 3);
+    assert_type<SkRecords::DrawRect>(r, record, 4);
+    assert_type<SkRecords::DrawRect>(r, record, 5);
+    assert_type<SkRecords::DrawRect>(r, record, 7);
+}
+
+DEF_TEST(RecordOpts_MergeImageRects, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, W, H);
+
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(16, 16));
+    surface->getCanvas()->clear(SK_ColorGREEN);
+    SkAutoTUnref<SkImage> image(surface->newImageSnapshot());
+
+    SkPaint alpha, other;
+    alpha.setAlpha(0x80);
+    other.setAlpha(0x40);
+
+    const SkRect src = SkRect::MakeXYWH(4, 4, 8, 8);
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(0, 0, 8, 8), &alpha);    // 0
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(10, 0, 16, 16), &alpha);  // 1
+    recorder.drawImageRect(image, SkRect::MakeXYWH(10, 20, 16, 16), &alpha);      // 2: No src.
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(0, 20, 8, 16), &alpha);   // 3: Stretched.
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(0, 40, 8, 8), &alpha);    // 4
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(0, 50, 8, 8), &other);    // 5: New paint.
+    recorder.drawImageRect(image, src, SkRect::MakeXYWH(0, 60, 8, 8), &other);    // 6
+
+    SkRecordMergeImageRects(&record);
+    const SkRecords::DrawImageRects* merged =
+        assert_type<SkRecords::DrawImageRects>(r, record, 0);
+    assert_type<SkRecords::NoOp>          (r, record, 1);
+    assert_type<SkRecords::NoOp>          (r, record, 2);
+    assert_type<SkRecords::DrawImageRect> (r, record, 3);
+    assert_type<SkRecords::DrawImageRect> (r, record, 4);
+    assert_type<SkRecords::DrawImageRects>(r, record, 5);
+    assert_type<SkRecords::NoOp>          (r, record, 6);
+
+    if (merged) {
+        REPORTER_ASSERT(r, 3 == merged->count);
+        REPORTER_ASSERT(r, merged->image == image.get());
+        REPORTER_ASSERT(r, merged->paint && 0x80 == merged->paint->getAlpha());
+        REPORTER_ASSERT(r, merged->srcs[1] == src);
+        REPORTER_ASSERT(r, merged->srcs[2] == SkRect::MakeWH(16, 16));
+        REPORTER_ASSERT(r, merged->dsts[1] == SkRect::MakeXYWH(10, 0, 16, 16));
+        REPORTER_ASSERT(r, merged->cull == SkRect::MakeWH(26, 36));
+    }
+}
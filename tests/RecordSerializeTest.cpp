@@ -0,0 +1,202 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Test.h"
+
+#include "SkBigPicture.h"
+#include "SkImage.h"
+#include "SkPictureRecorder.h"
+#include "SkReadBuffer.h"
+#include "SkRecord.h"
+#include "SkRecordSerialize.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTextBlob.h"
+#include "SkValidatingReadBuffer.h"
+#include "SkWriteBuffer.h"
+
+static const int W = 64, H = 64;
+
+static SkPicture* make_picture(bool withTextBlob = true) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8);
+    bitmap.eraseColor(SK_ColorRED);
+    bitmap.setImmutable();
+
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRasterN32Premul(8, 8));
+    surface->getCanvas()->clear(SK_ColorGREEN);
+    SkAutoTUnref<SkImage> image(surface->newImageSnapshot());
+
+    SkPictureRecorder nestedRecorder;
+    SkCanvas* nestedCanvas = nestedRecorder.beginRecording(16, 16);
+    nestedCanvas->drawColor(SK_ColorBLUE);
+    nestedCanvas->drawOval(SkRect::MakeWH(8, 8), SkPaint());
+    SkAutoTUnref<SkPicture> nested(nestedRecorder.endRecording());
+
+    SkPaint paint;
+    paint.setColor(SK_ColorYELLOW);
+    paint.setAntiAlias(true);
+
+    SkPaint font;
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    SkTextBlobBuilder blobBuilder;
+    const SkTextBlobBuilder::RunBuffer& run = blobBuilder.allocRun(font, 2, 0, 10);
+    run.glyphs[0] = 1;
+    run.glyphs[1] = 2;
+    SkAutoTUnref<const SkTextBlob> blob(blobBuilder.build());
+
+    SkPath path;
+    path.addCircle(32, 32, 10);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(W, H);
+    canvas->save();
+        canvas->clipRect(SkRect::MakeWH(60, 60));
+        canvas->clipPath(path, SkRegion::kUnion_Op, true);
+        canvas->translate(2, 3);
+        canvas->drawRect(SkRect::MakeXYWH(4, 4, 20, 20), paint);
+        canvas->drawPath(path, paint);
+        canvas->drawPath(path, paint);
+    canvas->restore();
+    canvas->saveLayer(NULL, &paint);
+        canvas->drawBitmap(bitmap, 30, 30);
+        canvas->drawBitmapRect(bitmap, SkRect::MakeXYWH(40, 40, 16, 16), NULL);
+        canvas->drawImage(image, 2, 40);
+        canvas->drawPicture(nested);
+        canvas->drawText("ab", 2, 10, 60, paint);
+        if (withTextBlob) {
+            canvas->drawTextBlob(blob, 20, 60, paint);
+        }
+        const SkPoint pts[] = { {1, 1}, {50, 10}, {20, 50} };
+        canvas->drawPoints(SkCanvas::kPolygon_PointMode, SK_ARRAY_COUNT(pts), pts, paint);
+        const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+        canvas->drawVertices(SkCanvas::kTriangles_VertexMode, SK_ARRAY_COUNT(pts), pts,
+                             NULL, colors, NULL, NULL, 0, paint);
+        SkRRect rrect;
+        rrect.setOval(SkRect::MakeXYWH(10, 30, 20, 10));
+        canvas->drawRRect(rrect, paint);
+    canvas->restore();
+    return recorder.endRecording();
+}
+
+static void draw(SkPicture* picture, SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(W, H);
+    bitmap->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bitmap);
+    canvas.drawPicture(picture);
+}
+
+static bool draws_same(SkPicture* a, SkPicture* b) {
+    SkBitmap bmA, bmB;
+    draw(a, &bmA);
+    draw(b, &bmB);
+    SkAutoLockPixels lockA(bmA), lockB(bmB);
+    return 0 == memcmp(bmA.getPixels(), bmB.getPixels(), bmA.getSize());
+}
+
+struct TypeOf {
+    template <typename T> SkRecords::Type operator()(const T&) { return T::kType; }
+};
+
+// Checks that b was recorded with the same sequence of ops as a.
+static void assert_same_ops(skiatest::Reporter* r, const SkPicture* a, const SkPicture* b) {
+    const SkBigPicture* bigA = a->asSkBigPicture();
+    const SkBigPicture* bigB = b->asSkBigPicture();
+    REPORTER_ASSERT(r, bigA && bigB);
+    if (!bigA || !bigB) {
+        return;
+    }
+    const SkRecord& recordA = *bigA->record();
+    const SkRecord& recordB = *bigB->record();
+    REPORTER_ASSERT(r, recordA.count() == recordB.count());
+    for (unsigned i = 0; i < recordA.count() && i < recordB.count(); i++) {
+        TypeOf typeOf;
+        REPORTER_ASSERT(r, recordA.visit<SkRecords::Type>(i, typeOf) ==
+                           recordB.visit<SkRecords::Type>(i, typeOf));
+    }
+}
+
+DEF_TEST(RecordSerialize_RoundTrip, r) {
+    SkAutoTUnref<SkPicture> picture(make_picture());
+
+    SkWriteBuffer writer;
+    SkRecordSerialize(*picture, &writer);
+    SkAutoTUnref<SkData> data(SkData::NewUninitialized(writer.bytesWritten()));
+    writer.writeToMemory(data->writable_data());
+
+    SkValidatingReadBuffer reader(data->data(), data->size());
+    SkAutoTUnref<SkPicture> copy(SkRecordDeserialize(&reader));
+    REPORTER_ASSERT(r, copy && reader.isValid() && reader.eof());
+    if (copy) {
+        REPORTER_ASSERT(r, copy->cullRect() == picture->cullRect());
+        assert_same_ops(r, picture, copy);
+        REPORTER_ASSERT(r, draws_same(picture, copy));
+    }
+
+    // Every truncation must fail cleanly.  SkTextBlob asserts on bad input, so leave it out here.
+    SkAutoTUnref<SkPicture> blobless(make_picture(false));
+    SkWriteBuffer bloblessWriter;
+    SkRecordSerialize(*blobless, &bloblessWriter);
+    data.reset(SkData::NewUninitialized(bloblessWriter.bytesWritten()));
+    bloblessWriter.writeToMemory(data->writable_data());
+    for (size_t size = 0; size < data->size(); size += 4) {
+        SkValidatingReadBuffer truncated(data->data(), size);
+        SkAutoTUnref<SkPicture> bad(SkRecordDeserialize(&truncated));
+        REPORTER_ASSERT(r, !bad);
+    }
+}
+
+DEF_TEST(RecordSerialize_SharesDictionaries, r) {
+    SkPath path;
+    path.addCircle(32, 32, 20);
+    path.addRect(SkRect::MakeWH(30, 40));
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+
+    // The same path and paint drawn many times should only be written once.
+    size_t sizes[2];
+    for (int i = 0; i < 2; i++) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(W, H);
+        const int draws = 1 + 99 * i;
+        for (int j = 0; j < draws; j++) {
+            canvas->drawPath(path, paint);
+        }
+        SkAutoTUnref<SkPicture> picture(recorder.endRecording());
+
+        SkWriteBuffer writer;
+        SkRecordSerialize(*picture, &writer);
+        sizes[i] = writer.bytesWritten();
+    }
+    REPORTER_ASSERT(r, sizes[1] - sizes[0] <= 99 * 3 * sizeof(uint32_t));
+}
+
+DEF_TEST(RecordSerialize_StreamAndBuffer, r) {
+    SkAutoTUnref<SkPicture> picture(make_picture());
+
+    SkDynamicMemoryWStream stream;
+    picture->serialize(&stream);
+    SkAutoTDelete<SkStreamAsset> asset(stream.detachAsStream());
+    SkAutoTUnref<SkPicture> fromStream(SkPicture::CreateFromStream(asset));
+    REPORTER_ASSERT(r, fromStream);
+    if (fromStream) {
+        assert_same_ops(r, picture, fromStream);
+        REPORTER_ASSERT(r, draws_same(picture, fromStream));
+    }
+
+    SkWriteBuffer writer(SkWriteBuffer::kCrossProcess_Flag);
+    picture->flatten(writer);
+    SkAutoTUnref<SkData> data(SkData::NewUninitialized(writer.bytesWritten()));
+    writer.writeToMemory(data->writable_data());
+    SkReadBuffer reader(data->data(), data->size());
+    SkAutoTUnref<SkPicture> fromBuffer(SkPicture::CreateFromBuffer(reader));
+    REPORTER_ASSERT(r, fromBuffer);
+    if (fromBuffer) {
+        assert_same_ops(r, picture, fromBuffer);
+        REPORTER_ASSERT(r, draws_same(picture, fromBuffer));
+    }
+}
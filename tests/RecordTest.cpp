@@ -11,6 +11,7 @@
 #include "SkImageInfo.h"
 #include "SkShader.h"
 #include "SkRecord.h"
+#include "SkRecorder.h"
 #include "SkRecords.h"
 
 // Sums the area of any DrawRect command it sees.
@@ -60,7 +61,7 @@ DEF_TEST(Record, r) {
     // Add a simple DrawRect command.
     SkRect rect = SkRect::MakeWH(10, 10);
     SkPaint paint;
-    APPEND(record, SkRecords::DrawRect, paint, rect);
+    APPEND(record, SkRecords::DrawRect, record.internPaint(paint), rect);
 
     // Its area should be 100.
     AreaSummer summer;
@@ -78,6 +79,36 @@ DEF_TEST(Record, r) {
 
 #undef APPEND
 
+struct PaintOf {
+    template <typename T> const SkPaint* operator()(const T&) { return NULL; }
+    const SkPaint* operator()(const SkRecords::DrawRect& op) { return op.paint.get(); }
+    const SkPaint* operator()(const SkRecords::DrawOval& op) { return op.paint.get(); }
+};
+
+// Equal paints should be stored once, however many commands use them.
+DEF_TEST(Record_InternsPaints, r) {
+    SkRecord record;
+    SkRecorder recorder(&record, 1920, 1080);
+
+    SkPaint red, blue;
+    red.setColor(SK_ColorRED);
+    blue.setColor(SK_ColorBLUE);
+    for (int i = 0; i < 10; i++) {
+        recorder.drawRect(SkRect::MakeWH(10, 10), red);
+        recorder.drawOval(SkRect::MakeWH(10, 10), 0 == i % 2 ? red : blue);
+    }
+
+    PaintOf paintOf;
+    const SkPaint* redPaint  = record.visit<const SkPaint*>(0, paintOf);
+    const SkPaint* bluePaint = record.visit<const SkPaint*>(3, paintOf);
+    REPORTER_ASSERT(r, *redPaint == red);
+    REPORTER_ASSERT(r, *bluePaint == blue);
+    for (unsigned i = 0; i < record.count(); i++) {
+        const SkPaint* expected = (i % 4 == 3) ? bluePaint : redPaint;
+        REPORTER_ASSERT(r, record.visit<const SkPaint*>(i, paintOf) == expected);
+    }
+}
+
 template <typename T>
 static bool is_aligned(const T* p) {
     return (((uintptr_t)p) & (sizeof(T) - 1)) == 0;
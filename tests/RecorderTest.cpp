@@ -7,6 +7,7 @@
 
 #include "Test.h"
 
+#include "SkBigPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkRecord.h"
 #include "SkRecorder.h"
@@ -108,3 +109,32 @@ DEF_TEST(Recorder_drawImage_takeReference, reporter) {
     }
     REPORTER_ASSERT(reporter, image->unique());
 }
+
+// Small nested pictures are inlined into the parent record; larger ones are referenced.
+DEF_TEST(Recorder_InlinesSmallPictures, r) {
+    SkPictureRecorder recorder;
+    SkPaint paint;
+
+    SkCanvas* canvas = recorder.beginRecording(100, 100);
+    canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+    canvas->drawRect(SkRect::MakeXYWH(20, 20, 10, 10), paint);
+    SkAutoTUnref<SkPicture> small(recorder.endRecording());
+
+    canvas = recorder.beginRecording(100, 100);
+    for (int i = 0; i < SkRecorder::kMaxPictureOpsToInline + 1; i++) {
+        canvas->drawRect(SkRect::MakeXYWH(SkIntToScalar(i), 0, 1, 1), paint);
+    }
+    SkAutoTUnref<SkPicture> large(recorder.endRecording());
+
+    canvas = recorder.beginRecording(100, 100);
+    canvas->drawPicture(small);
+    canvas->drawPicture(large);
+    SkAutoTUnref<SkPicture> parent(recorder.endRecording());
+
+    const SkBigPicture* bp = parent->asSkBigPicture();
+    REPORTER_ASSERT(r, bp);
+    Tally tally;
+    tally.apply(*bp->record());
+    REPORTER_ASSERT(r, 1 == tally.count<SkRecords::DrawPicture>());
+    REPORTER_ASSERT(r, 2 == tally.count<SkRecords::DrawRect>());
+}
@@ -7,6 +7,7 @@
 
 #include "SkBitmap.h"
 #include "SkCanvas.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "Test.h"
 
@@ -46,6 +47,35 @@ static void test_stroke_width_clipping(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, has_green_pixels(bm));
 }
 
+// Longer arrays of points are read four at a time; wherever the extreme or non-finite points
+// fall, the bounds must match the ones found a point at a time.
+static void test_bounds_check(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    SkPoint pts[100];
+    for (int count = 1; count <= (int) SK_ARRAY_COUNT(pts); ++count) {
+        for (int i = 0; i < count; ++i) {
+            pts[i].set(rand.nextRangeF(-100, 100), rand.nextRangeF(-100, 100));
+        }
+        SkRect expected = SkRect::MakeXYWH(pts[0].fX, pts[0].fY, 0, 0);
+        for (int i = 1; i < count; ++i) {
+            expected.growToInclude(pts[i].fX, pts[i].fY);
+        }
+        SkRect bounds;
+        REPORTER_ASSERT(reporter, bounds.setBoundsCheck(pts, count));
+        REPORTER_ASSERT(reporter, expected == bounds);
+
+        const SkPoint saved = pts[count - 1];
+        pts[count - 1].fY = SK_ScalarNaN;
+        REPORTER_ASSERT(reporter, !bounds.setBoundsCheck(pts, count));
+        REPORTER_ASSERT(reporter, bounds.isEmpty());
+        pts[count - 1] = saved;
+        pts[count / 2].fX = SK_ScalarInfinity;
+        REPORTER_ASSERT(reporter, !bounds.setBoundsCheck(pts, count));
+        REPORTER_ASSERT(reporter, bounds.isEmpty());
+    }
+}
+
 DEF_TEST(Rect, reporter) {
     test_stroke_width_clipping(reporter);
+    test_bounds_check(reporter);
 }
@@ -263,6 +263,41 @@ DEF_TEST(Region, reporter) {
     test_fromchrome(reporter);
 }
 
+DEF_TEST(Region_opMany, reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 100; i++) {
+        const int N = 1 + rand.nextU() % 40;
+        SkIRect rects[40];
+        SkRegion rgns[40];
+        for (int j = 0; j < N; j++) {
+            rand_rect(&rects[j], rand);
+            randRgn(rand, &rgns[j], 4);
+        }
+        SkRegion start;
+        randRgn(rand, &start, 4);
+
+        for (int op = 0; op < SkRegion::kOpCnt; op++) {
+            SkRegion expected(start);
+            for (int j = 0; j < N; j++) {
+                expected.op(rects[j], (SkRegion::Op)op);
+            }
+            SkRegion rgn(start);
+            REPORTER_ASSERT(reporter, rgn.opMany(rects, N, (SkRegion::Op)op) ==
+                                      !expected.isEmpty());
+            REPORTER_ASSERT(reporter, rgn == expected);
+
+            expected = start;
+            for (int j = 0; j < N; j++) {
+                expected.op(rgns[j], (SkRegion::Op)op);
+            }
+            rgn = start;
+            REPORTER_ASSERT(reporter, rgn.opMany(rgns, N, (SkRegion::Op)op) ==
+                                      !expected.isEmpty());
+            REPORTER_ASSERT(reporter, rgn == expected);
+        }
+    }
+}
+
 // Test that writeToMemory reports the same number of bytes whether there was a
 // buffer to write to or not.
 static void test_write(const SkRegion& region, skiatest::Reporter* r) {
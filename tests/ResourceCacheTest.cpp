@@ -23,6 +23,7 @@
 #include "SkGr.h"
 #include "SkMessageBus.h"
 #include "SkSurface.h"
+#include "SkTaskGroup.h"
 #include "Test.h"
 
 static const int gWidth = 640;
@@ -69,6 +70,30 @@ static void test_cache(skiatest::Reporter* reporter, GrContext* context, SkCanva
     context->setResourceCacheLimits(oldMaxNum, oldMaxBytes);
 }
 
+static void test_approx_scratch_textures(skiatest::Reporter* reporter, GrContext* context) {
+    GrSurfaceDesc desc;
+    desc.fConfig = kSkia8888_GrPixelConfig;
+    desc.fFlags = kRenderTarget_GrSurfaceFlag;
+    desc.fWidth = 1100;
+    desc.fHeight = 600;
+
+    // Large sizes round up to halfway between powers of two rather than all the way.
+    SkAutoTUnref<GrTexture> layer1(context->textureProvider()->createApproxTexture(desc));
+    if (!layer1) {
+        return;
+    }
+    REPORTER_ASSERT(reporter, 1536 == layer1->width());
+    REPORTER_ASSERT(reporter, 1024 == layer1->height());
+
+    // Once the first is done with, a later layer in the same bucket gets the same render target.
+    GrTexture* firstTexture = layer1.get();
+    layer1.reset(NULL);
+    desc.fWidth = 1500;
+    desc.fHeight = 1000;
+    SkAutoTUnref<GrTexture> layer2(context->textureProvider()->createApproxTexture(desc));
+    REPORTER_ASSERT(reporter, layer2.get() == firstTexture);
+}
+
 static void test_stencil_buffers(skiatest::Reporter* reporter, GrContext* context) {
     GrSurfaceDesc smallDesc;
     smallDesc.fFlags = kRenderTarget_GrSurfaceFlag;
@@ -227,6 +252,7 @@ static void test_wrapped_resources(skiatest::Reporter* reporter, GrContext* cont
 class TestResource : public GrGpuResource {
     static const size_t kDefaultSize = 100;
     enum ScratchConstructor { kScratchConstructor };
+    enum CategoryConstructor { kCategoryConstructor };
 public:
     
     /** Property that distinctly categorizes the resource.
@@ -237,7 +263,8 @@ public:
         : INHERITED(gpu, lifeCycle)
         , fToDelete(NULL)
         , fSize(size)
-        , fProperty(kA_SimulatedProperty) {
+        , fProperty(kA_SimulatedProperty)
+        , fCategory(kOther_CacheCategory) {
         ++fNumAlive;
         this->registerWithCache();
     }
@@ -246,7 +273,8 @@ public:
         : INHERITED(gpu, lifeCycle)
         , fToDelete(NULL)
         , fSize(kDefaultSize)
-        , fProperty(kA_SimulatedProperty) {
+        , fProperty(kA_SimulatedProperty)
+        , fCategory(kOther_CacheCategory) {
         ++fNumAlive;
         this->registerWithCache();
     }
@@ -255,7 +283,8 @@ public:
         : INHERITED(gpu, kCached_LifeCycle)
         , fToDelete(NULL)
         , fSize(kDefaultSize)
-        , fProperty(kA_SimulatedProperty) {
+        , fProperty(kA_SimulatedProperty)
+        , fCategory(kOther_CacheCategory) {
         ++fNumAlive;
         this->registerWithCache();
     }
@@ -264,6 +293,10 @@ public:
         return SkNEW_ARGS(TestResource, (gpu, property, cached, kScratchConstructor));
     }
 
+    static TestResource* CreateWithCategory(GrGpu* gpu, CacheCategory category, size_t size) {
+        return SkNEW_ARGS(TestResource, (gpu, category, size, kCategoryConstructor));
+    }
+
     ~TestResource() {
         --fNumAlive;
         SkSafeUnref(fToDelete);
@@ -299,7 +332,8 @@ private:
         : INHERITED(gpu, cached ? kCached_LifeCycle : kUncached_LifeCycle)
         , fToDelete(NULL)
         , fSize(kDefaultSize)
-        , fProperty(property) {
+        , fProperty(property)
+        , fCategory(kOther_CacheCategory) {
         GrScratchKey scratchKey;
         ComputeScratchKey(fProperty, &scratchKey);
         this->setScratchKey(scratchKey);
@@ -307,12 +341,24 @@ private:
         this->registerWithCache();
     }
 
+    TestResource(GrGpu* gpu, CacheCategory category, size_t size, CategoryConstructor)
+        : INHERITED(gpu, kCached_LifeCycle)
+        , fToDelete(NULL)
+        , fSize(size)
+        , fProperty(kA_SimulatedProperty)
+        , fCategory(category) {
+        ++fNumAlive;
+        this->registerWithCache();
+    }
+
     size_t onGpuMemorySize() const override { return fSize; }
+    CacheCategory onCacheCategory() const override { return fCategory; }
 
     TestResource* fToDelete;
     size_t fSize;
     static int fNumAlive;
     SimulatedProperty fProperty;
+    CacheCategory fCategory;
     typedef GrGpuResource INHERITED;
 };
 int TestResource::fNumAlive = 0;
@@ -540,6 +586,10 @@ static void test_unbudgeted(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, 0 == cache->getResourceBytes());
     REPORTER_ASSERT(reporter, 0 == cache->getBudgetedResourceCount());
     REPORTER_ASSERT(reporter, 0 == cache->getBudgetedResourceBytes());
+
+    REPORTER_ASSERT(reporter, cache->getPeakBudgetedResourceBytes() >= 21);
+    cache->resetPeakBudgetedResourceBytes();
+    REPORTER_ASSERT(reporter, 0 == cache->getPeakBudgetedResourceBytes());
 }
 
 // This method can't be static because it needs to friended in GrGpuResource::CacheAccess.
@@ -930,6 +980,123 @@ static void test_purge_invalidated(skiatest::Reporter* reporter) {
     SkSafeUnref(scratch);
 }
 
+static void test_unique_key_from_any_thread(skiatest::Reporter* reporter) {
+    Mock mock(20, 30000);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+
+    static const int kKeyCount = 10;
+    GrUniqueKey keys[kKeyCount];
+    for (int i = 0; i < kKeyCount; ++i) {
+        make_unique_key<0>(&keys[i], i);
+    }
+
+    // Give the even keys to resources, and move one key from one resource to another.
+    SkAutoTUnref<TestResource> a(SkNEW_ARGS(TestResource, (context->getGpu())));
+    SkAutoTUnref<TestResource> b(SkNEW_ARGS(TestResource, (context->getGpu())));
+    a->resourcePriv().setUniqueKey(keys[0]);
+    a->resourcePriv().setUniqueKey(keys[2]);
+    b->resourcePriv().setUniqueKey(keys[2]);
+    a->resourcePriv().setUniqueKey(keys[4]);
+    SkAutoTUnref<TestResource> c(SkNEW_ARGS(TestResource, (context->getGpu())));
+    c->resourcePriv().setUniqueKey(keys[0]);
+
+    // Other threads see what the owning thread does.
+    SkAtomic<int> mismatches(0);
+    sk_parallel_for(kKeyCount, [&](int i) {
+        if (cache->hasUniqueKeyFromAnyThread(keys[i]) != (i % 2 == 0 && i <= 4)) {
+            mismatches.fetch_add(1);
+        }
+    });
+    REPORTER_ASSERT(reporter, 0 == mismatches.load());
+    for (int i = 0; i < kKeyCount; ++i) {
+        REPORTER_ASSERT(reporter,
+                        cache->hasUniqueKey(keys[i]) == cache->hasUniqueKeyFromAnyThread(keys[i]));
+    }
+
+    a->resourcePriv().removeUniqueKey();
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKeyFromAnyThread(keys[4]));
+    c.reset(NULL);
+    b.reset(NULL);
+    cache->purgeAllUnlocked();
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKeyFromAnyThread(keys[0]));
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKeyFromAnyThread(keys[2]));
+}
+
+static void test_category_budgets(skiatest::Reporter* reporter) {
+    Mock mock(10, 300);
+    GrContext* context = mock.context();
+    GrResourceCache* cache = mock.cache();
+
+    GrUniqueKey bufferKey, renderTargetKey, texKey1, texKey2;
+    make_unique_key<0>(&bufferKey, 1);
+    make_unique_key<0>(&renderTargetKey, 2);
+    make_unique_key<0>(&texKey1, 3);
+    make_unique_key<0>(&texKey2, 4);
+
+    // The buffer is the least recently used, but the render target is cheaper to recreate.
+    TestResource* buffer = TestResource::CreateWithCategory(context->getGpu(),
+                                                            GrGpuResource::kBuffer_CacheCategory,
+                                                            100);
+    buffer->resourcePriv().setUniqueKey(bufferKey);
+    buffer->unref();
+    TestResource* renderTarget = TestResource::CreateWithCategory(
+            context->getGpu(), GrGpuResource::kRenderTarget_CacheCategory, 100);
+    renderTarget->resourcePriv().setUniqueKey(renderTargetKey);
+    renderTarget->unref();
+    REPORTER_ASSERT(reporter, 100 == cache->getCategoryStats(
+                              GrGpuResource::kBuffer_CacheCategory).fBudgetedBytes);
+    REPORTER_ASSERT(reporter, 1 == cache->getCategoryStats(
+                              GrGpuResource::kRenderTarget_CacheCategory).fBudgetedCount);
+
+    // Going over budget releases the render target rather than the buffer.
+    TestResource* other = SkNEW_ARGS(TestResource, (context->getGpu(), 150,
+                                                    GrGpuResource::kCached_LifeCycle));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(bufferKey));
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(renderTargetKey));
+    const GrResourceCache::CategoryStats& rtStats =
+            cache->getCategoryStats(GrGpuResource::kRenderTarget_CacheCategory);
+    REPORTER_ASSERT(reporter, 0 == rtStats.fBudgetedCount && 0 == rtStats.fBudgetedBytes);
+    REPORTER_ASSERT(reporter, 1 == rtStats.fPurgeCount);
+    REPORTER_ASSERT(reporter, 0 == cache->getCategoryStats(
+                              GrGpuResource::kBuffer_CacheCategory).fPurgeCount);
+    other->unref();
+    cache->purgeAllUnlocked();
+
+    // A category over its own limit gives up its least recently used resources, even though the
+    // cache as a whole is under budget.
+    cache->setCategoryLimits(GrGpuResource::kTexture_CacheCategory, 150, 2);
+    TestResource* tex1 = TestResource::CreateWithCategory(context->getGpu(),
+                                                          GrGpuResource::kTexture_CacheCategory,
+                                                          100);
+    tex1->resourcePriv().setUniqueKey(texKey1);
+    tex1->unref();
+    buffer = TestResource::CreateWithCategory(context->getGpu(),
+                                              GrGpuResource::kBuffer_CacheCategory, 100);
+    buffer->resourcePriv().setUniqueKey(bufferKey);
+    buffer->unref();
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(texKey1));
+    TestResource* tex2 = TestResource::CreateWithCategory(context->getGpu(),
+                                                          GrGpuResource::kTexture_CacheCategory,
+                                                          100);
+    tex2->resourcePriv().setUniqueKey(texKey2);
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(texKey1));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(texKey2));
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(bufferKey));
+    const GrResourceCache::CategoryStats& texStats =
+            cache->getCategoryStats(GrGpuResource::kTexture_CacheCategory);
+    REPORTER_ASSERT(reporter, 1 == texStats.fBudgetedCount && 100 == texStats.fBudgetedBytes);
+    REPORTER_ASSERT(reporter, 150 == texStats.fMaxBytes && 1 == texStats.fPurgeCount);
+
+    // Growing past the limit while in use is allowed, but the resource goes once it's purgeable.
+    tex2->setSize(200);
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(texKey2));
+    tex2->unref();
+    REPORTER_ASSERT(reporter, !cache->hasUniqueKey(texKey2));
+    REPORTER_ASSERT(reporter, 0 == texStats.fBudgetedCount && 0 == texStats.fBudgetedBytes);
+    REPORTER_ASSERT(reporter, cache->hasUniqueKey(bufferKey));
+}
+
 static void test_cache_chained_purge(skiatest::Reporter* reporter) {
     Mock mock(3, 30000);
     GrContext* context = mock.context();
@@ -1274,6 +1441,7 @@ DEF_GPUTEST(ResourceCache, reporter, factory) {
                                                                    SkSurface::kNo_Budgeted, info));
         test_cache(reporter, context, surface->getCanvas());
         test_stencil_buffers(reporter, context);
+        test_approx_scratch_textures(reporter, context);
         test_wrapped_resources(reporter, context);
     }
 
@@ -1287,6 +1455,8 @@ DEF_GPUTEST(ResourceCache, reporter, factory) {
     test_remove_scratch_key(reporter);
     test_scratch_key_consistency(reporter);
     test_purge_invalidated(reporter);
+    test_unique_key_from_any_thread(reporter);
+    test_category_budgets(reporter);
     test_cache_chained_purge(reporter);
     test_resource_size_changed(reporter);
     test_timestamp_wrap(reporter);
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkData.h"
+#include "SkRingBufferTracer.h"
+#include "SkStream.h"
+#include "SkString.h"
+#include "SkTraceEventCommon.h"
+#include "Test.h"
+
+static SkString dump(const SkRingBufferTracer& tracer) {
+    SkDynamicMemoryWStream stream;
+    tracer.dumpJSON(&stream);
+    SkAutoTUnref<SkData> data(stream.copyToData());
+    return SkString(static_cast<const char*>(data->data()), data->size());
+}
+
+static SkEventTracer::Handle begin(SkRingBufferTracer* tracer, const uint8_t* category,
+                                   const char* name) {
+    return tracer->addTraceEvent(TRACE_EVENT_PHASE_COMPLETE, category, name, 0, 0, NULL, NULL,
+                                 NULL, TRACE_EVENT_FLAG_NONE);
+}
+
+DEF_TEST(RingBufferTracer_Enable, reporter) {
+    SkRingBufferTracer tracer;
+    const uint8_t* before = tracer.getCategoryGroupEnabled("skia");
+    REPORTER_ASSERT(reporter, 0 == *before);
+    REPORTER_ASSERT(reporter, before == tracer.getCategoryGroupEnabled("skia"));
+    REPORTER_ASSERT(reporter, 0 == strcmp("skia", tracer.getCategoryGroupName(before)));
+
+    tracer.setEnabled(true);
+    REPORTER_ASSERT(reporter, tracer.isEnabled());
+    REPORTER_ASSERT(reporter, 0 != *before);
+    // Categories seen for the first time while enabled start enabled.
+    REPORTER_ASSERT(reporter, 0 != *tracer.getCategoryGroupEnabled("skia.gpu"));
+
+    tracer.setEnabled(false);
+    REPORTER_ASSERT(reporter, 0 == *before);
+}
+
+DEF_TEST(RingBufferTracer_Dump, reporter) {
+    SkRingBufferTracer tracer;
+    tracer.setEnabled(true);
+    const uint8_t* category = tracer.getCategoryGroupEnabled("skia");
+
+    SkEventTracer::Handle outer = begin(&tracer, category, "outer");
+    SkEventTracer::Handle inner = begin(&tracer, category, "inner");
+    tracer.updateTraceEventDuration(category, "inner", inner);
+    tracer.updateTraceEventDuration(category, "outer", outer);
+
+    const char* argNames[] = { "count" };
+    const uint8_t argTypes[] = { TRACE_VALUE_TYPE_INT };
+    const uint64_t argValues[] = { 42 };
+    tracer.addTraceEvent(TRACE_EVENT_PHASE_INSTANT, category, "instant", 0, 1, argNames,
+                         argTypes, argValues, TRACE_EVENT_FLAG_NONE);
+    // Still open when dumped, so left out.
+    begin(&tracer, category, "unfinished");
+
+    SkString json = dump(tracer);
+    REPORTER_ASSERT(reporter, json.startsWith("{\"traceEvents\":["));
+    REPORTER_ASSERT(reporter, json.contains("\"name\":\"outer\",\"cat\":\"skia\",\"ph\":\"X\""));
+    REPORTER_ASSERT(reporter, json.contains("\"name\":\"inner\""));
+    REPORTER_ASSERT(reporter, json.contains("\"args\":{\"count\":42}"));
+    REPORTER_ASSERT(reporter, !json.contains("unfinished"));
+}
+
+// Once a thread's buffer is full its oldest events are overwritten.
+DEF_TEST(RingBufferTracer_Wrap, reporter) {
+    static const char* kNames[] = { "e0", "e1", "e2", "e3", "e4", "e5" };
+    SkRingBufferTracer tracer(4);
+    tracer.setEnabled(true);
+    const uint8_t* category = tracer.getCategoryGroupEnabled("skia");
+
+    SkEventTracer::Handle first = begin(&tracer, category, kNames[0]);
+    for (size_t i = 1; i < SK_ARRAY_COUNT(kNames); ++i) {
+        tracer.updateTraceEventDuration(category, kNames[i], begin(&tracer, category, kNames[i]));
+    }
+    // Ending an overwritten event is harmless.
+    tracer.updateTraceEventDuration(category, kNames[0], first);
+
+    SkString json = dump(tracer);
+    REPORTER_ASSERT(reporter, !json.contains("\"e0\"") && !json.contains("\"e1\""));
+    REPORTER_ASSERT(reporter, json.contains("\"e2\"") && json.contains("\"e5\""));
+}
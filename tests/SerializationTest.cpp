@@ -543,3 +543,19 @@ DEF_TEST(Serialization, reporter) {
 
     TestPictureTypefaceSerialization(reporter);
 }
+
+DEF_TEST(Serialization_FactoryNames, reporter) {
+    SkAutoTUnref<SkColorFilter> filter(SkTableColorFilter::Create(NULL));
+    SkFlattenable::Factory factory = filter->getFactory();
+    const char* name = SkFlattenable::FactoryToName(factory);
+    REPORTER_ASSERT(reporter, name);
+    if (name) {
+        REPORTER_ASSERT(reporter, SkFlattenable::NameToFactory(name) == factory);
+        SkFlattenable::Type type;
+        REPORTER_ASSERT(reporter, SkFlattenable::NameToType(name, &type));
+        REPORTER_ASSERT(reporter, SkFlattenable::kSkColorFilter_Type == type);
+    }
+    REPORTER_ASSERT(reporter, NULL == SkFlattenable::NameToFactory("NotAFlattenable"));
+    SkFlattenable::Type type;
+    REPORTER_ASSERT(reporter, !SkFlattenable::NameToType("NotAFlattenable", &type));
+}
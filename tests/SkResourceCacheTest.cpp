@@ -286,3 +286,21 @@ DEF_TEST(BitmapCache_discarded_bitmap, reporter) {
     test_bitmap_notify(reporter, cache);
     test_mipmap_notify(reporter, cache);
 }
+
+// The global cache may be sharded; its limit must still round-trip exactly.
+DEF_TEST(ResourceCache_GlobalByteLimit, reporter) {
+    size_t originalByteLimit = SkGraphics::GetResourceCacheTotalByteLimit();
+    if (SkResourceCache::GetDiscardableFactory()) {
+        return;  // Discardable caches have no byte budget.
+    }
+
+    const size_t limits[] = { 0, 1, 7, 1023, 3 * 1024 * 1024 + 5 };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(limits); ++i) {
+        SkGraphics::SetResourceCacheTotalByteLimit(limits[i]);
+        REPORTER_ASSERT(reporter, limits[i] == SkGraphics::GetResourceCacheTotalByteLimit());
+        REPORTER_ASSERT(reporter, SkGraphics::GetResourceCacheTotalBytesUsed() <= limits[i]);
+    }
+
+    REPORTER_ASSERT(reporter, limits[SK_ARRAY_COUNT(limits) - 1] ==
+                              SkGraphics::SetResourceCacheTotalByteLimit(originalByteLimit));
+}
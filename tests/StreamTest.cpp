@@ -335,3 +335,63 @@ DEF_TEST(StreamPeek_BlockMemoryStream, rep) {
     }
     stream_peek_test(rep, asset, expected);
 }
+
+DEF_TEST(SegmentedWStream, r) {
+    SkRandom rand(1234);
+    SkDynamicMemoryWStream expectedStream;
+    SkSegmentedWStream stream;
+    SkAutoTUnref<SkData> shared(SkData::NewUninitialized(10000));
+    for (size_t i = 0; i < shared->size(); ++i) {
+        ((uint8_t*)shared->writable_data())[i] = rand.nextU() & 0xFF;
+    }
+
+    uint8_t buffer[100];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 50; ++j) {
+            const size_t size = rand.nextRangeU(1, sizeof(buffer));
+            for (size_t k = 0; k < size; ++k) {
+                buffer[k] = rand.nextU() & 0xFF;
+            }
+            stream.write(buffer, size);
+            expectedStream.write(buffer, size);
+        }
+        stream.writeData(shared);
+        expectedStream.write(shared->data(), shared->size());
+    }
+    stream.write(buffer, 10);
+    expectedStream.write(buffer, 10);
+    REPORTER_ASSERT(r, expectedStream.bytesWritten() == stream.bytesWritten());
+    SkAutoTUnref<SkData> expected(expectedStream.copyToData());
+
+    // The shared data is referred to, not copied, and the segments hold everything in order.
+    SkTDArray<SkSegmentedWStream::Segment> segments;
+    segments.setCount(stream.countSegments());
+    stream.getSegments(segments.begin());
+    REPORTER_ASSERT(r, segments.count() >= 7);
+    size_t offset = 0;
+    int sharedCount = 0;
+    for (int i = 0; i < segments.count(); ++i) {
+        if (segments[i].fBase == shared->data()) {
+            REPORTER_ASSERT(r, shared->size() == segments[i].fLength);
+            sharedCount++;
+        }
+        REPORTER_ASSERT(r, offset + segments[i].fLength <= expected->size());
+        REPORTER_ASSERT(r, !memcmp(expected->bytes() + offset, segments[i].fBase,
+                                   segments[i].fLength));
+        offset += segments[i].fLength;
+    }
+    REPORTER_ASSERT(r, 3 == sharedCount);
+    REPORTER_ASSERT(r, expected->size() == offset);
+
+    SkAutoTUnref<SkData> copy(stream.copyToData());
+    REPORTER_ASSERT(r, copy->equals(expected));
+
+    SkAutoTDelete<SkStreamAsset> asset(stream.detachAsStream());
+    REPORTER_ASSERT(r, 0 == stream.bytesWritten() && 0 == stream.countSegments());
+    stream_peek_test(r, asset, expected);
+
+    // Data written on its own is handed back as it is.
+    stream.writeData(shared);
+    copy.reset(stream.copyToData());
+    REPORTER_ASSERT(r, copy.get() == shared.get());
+}
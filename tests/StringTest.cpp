@@ -7,6 +7,9 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include "SkFloatBits.h"
+#include "SkRandom.h"
 #include "SkString.h"
 #include "Test.h"
 
@@ -156,13 +159,16 @@ DEF_TEST(String, reporter) {
         { SK_Scalar1,   "1" },
         { -SK_Scalar1,  "-1" },
         { SK_Scalar1/2, "0.5" },
-  #if defined(SK_BUILD_FOR_WIN) && (_MSC_VER < 1900) 
-        { 3.4028234e38f,   "3.4028235e+038" },
-        { -3.4028234e38f, "-3.4028235e+038" },
-  #else
+        { 0.1f,         "0.1" },
+        { 1.0f/3,       "0.33333334" },
+        { 123456.7f,    "123456.7" },
+        { 16777216.f,   "16777216" },
+        { 1e8f,         "1e+08" },
+        { 0.0001f,      "0.0001" },
+        { 0.00001f,     "1e-05" },
+        { 1.4e-45f,     "1e-45" },
         { 3.4028234e38f,   "3.4028235e+38" },
         { -3.4028234e38f, "-3.4028235e+38" },
-  #endif
     };
     for (size_t i = 0; i < SK_ARRAY_COUNT(gRec); i++) {
         a.reset();
@@ -173,6 +179,19 @@ DEF_TEST(String, reporter) {
         }
     }
 
+    // appendScalar() writes the shortest string that reads back as the same float.
+    SkRandom rand;
+    for (int i = 0; i < 10000; i++) {
+        float value = SkBits2Float(rand.nextU());
+        if (!SkScalarIsFinite(value)) {
+            continue;
+        }
+        a.reset();
+        a.appendScalar(value);
+        REPORTER_ASSERT(reporter, a.size() <= SkStrAppendScalar_MaxSize);
+        REPORTER_ASSERT(reporter, strtof(a.c_str(), NULL) == value);
+    }
+
     REPORTER_ASSERT(reporter, SkStringPrintf("%i", 0).equals("0"));
 
     char buffer [40];
@@ -7,8 +7,11 @@
 
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRect.h"
+#include "SkResourceCache.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkStrokeRec.h"
 #include "Test.h"
 
@@ -160,8 +163,83 @@ static void test_strokerec_equality(skiatest::Reporter* reporter) {
     }
 }
 
+// Paths long enough are stroked a few contours at a time; the result must match stroking their
+// contours one by one.
+static void test_strokelongpath(skiatest::Reporter* reporter) {
+    SkStroke stroke;
+    stroke.setWidth(3);
+    stroke.setJoin(SkPaint::kRound_Join);
+    stroke.setCap(SkPaint::kRound_Cap);
+
+    SkRandom rand;
+    SkPath path, expected;
+    for (int i = 0; i < 500; ++i) {
+        SkPath contour;
+        contour.moveTo(rand.nextRangeF(0, 1000), rand.nextRangeF(0, 1000));
+        for (int j = 0; j < 10; ++j) {
+            contour.lineTo(rand.nextRangeF(0, 1000), rand.nextRangeF(0, 1000));
+        }
+        // an open contour's end cap depends on what follows it, unless it ends with a curve
+        if (i & 1) {
+            contour.close();
+        } else {
+            contour.quadTo(rand.nextRangeF(0, 1000), rand.nextRangeF(0, 1000),
+                           rand.nextRangeF(0, 1000), rand.nextRangeF(0, 1000));
+        }
+        path.addPath(contour);
+
+        SkPath contourStroke;
+        stroke.strokePath(contour, &contourStroke);
+        expected.addPath(contourStroke);
+    }
+
+    SkPath result;
+    stroke.strokePath(path, &result);
+    REPORTER_ASSERT(reporter, result == expected);
+}
+
+static void test_strokecache(skiatest::Reporter* reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path;
+    path.moveTo(0, 0);
+    path.quadTo(50, 100, 100, 0);
+    path.lineTo(20, 80);
+    SkStrokeRec rec(SkStrokeRec::kFill_InitStyle);
+    rec.setStrokeStyle(4);
+    rec.setStrokeParams(SkPaint::kRound_Cap, SkPaint::kRound_Join, 4);
+    SkPath stroke;
+    rec.applyToPath(&stroke, path);
+
+    const uint32_t genID = path.getGenerationID();
+    SkPath found;
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(genID, path.getFillType(), rec, &found,
+                                                   &cache));
+    SkStrokeCache::Add(genID, path.getFillType(), rec, stroke, &cache);
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(genID, path.getFillType(), rec, &found,
+                                                  &cache));
+    REPORTER_ASSERT(reporter, found == stroke);
+
+    // Any difference in the path or the stroke misses.
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(genID, SkPath::kEvenOdd_FillType, rec,
+                                                   &found, &cache));
+    SkStrokeRec other(rec);
+    other.setResScale(2);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(genID, path.getFillType(), other, &found,
+                                                   &cache));
+    other = rec;
+    other.setStrokeStyle(4, true);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(genID, path.getFillType(), other, &found,
+                                                   &cache));
+    path.lineTo(30, 30);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path.getGenerationID(), path.getFillType(),
+                                                   rec, &found, &cache));
+}
+
 DEF_TEST(Stroke, reporter) {
     test_strokecubic(reporter);
     test_strokerect(reporter);
     test_strokerec_equality(reporter);
+    test_strokelongpath(reporter);
+    test_strokecache(reporter);
 }
@@ -846,6 +846,36 @@ static void test_surface_budget(skiatest::Reporter* reporter, GrContext* context
     }
 }
 
+static SkPMColor read_first_pixel(const SkImage* image) {
+    SkPMColor pixel = 0;
+    image->readPixels(SkImageInfo::MakeN32Premul(1, 1), &pixel, sizeof(pixel), 0, 0);
+    return pixel;
+}
+
+// An opaque bitmap covering the surface lets copy-on-write swap in a new render target without
+// copying. The snapshot must still see the old contents.
+static void test_surface_discard_cow(skiatest::Reporter* reporter, GrContext* context) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(8, 8);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(context, SkSurface::kNo_Budgeted,
+                                                               info, 0));
+    SkASSERT(surface);
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorRED);
+    SkAutoTUnref<SkImage> before(surface->newImageSnapshot());
+
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(8, 8, true);
+    bitmap.eraseColor(SK_ColorBLUE);
+    canvas->drawBitmap(bitmap, 0, 0);
+
+    SkSurface_Gpu* gpuSurface = static_cast<SkSurface_Gpu*>(surface.get());
+    REPORTER_ASSERT(reporter, gpuSurface->getDevice()->accessRenderTarget()->asTexture() !=
+                              as_IB(before)->getTexture());
+    SkAutoTUnref<SkImage> after(surface->newImageSnapshot());
+    REPORTER_ASSERT(reporter, SkPreMultiplyColor(SK_ColorRED) == read_first_pixel(before));
+    REPORTER_ASSERT(reporter, SkPreMultiplyColor(SK_ColorBLUE) == read_first_pixel(after));
+}
+
 #endif
 
 static void TestSurfaceNoCanvas(skiatest::Reporter* reporter,
@@ -922,6 +952,7 @@ DEF_GPUTEST(Surface, reporter, factory) {
                 TestGetTexture(reporter, kGpuScratch_SurfaceType, context);
                 test_empty_surface(reporter, context);
                 test_surface_budget(reporter, context);
+                test_surface_discard_cow(reporter, context);
                 test_wrapped_texture_surface(reporter, context);
             }
         }
@@ -1029,3 +1060,81 @@ DEF_GPUTEST(SkImage_NewFromTexture, reporter, factory) {
     REPORTER_ASSERT(reporter, releaseCtx.fIsReleased);
 }
 #endif
+
+// Every pixel that changes between before and after must be inside damage.
+static bool changes_inside(const SkBitmap& before, const SkBitmap& after, const SkIRect& damage) {
+    for (int y = 0; y < after.height(); ++y) {
+        for (int x = 0; x < after.width(); ++x) {
+            if (*before.getAddr32(x, y) != *after.getAddr32(x, y) && !damage.contains(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+DEF_TEST(Surface_Damage, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(100, 100);
+    const SkIRect bounds = SkIRect::MakeWH(100, 100);
+
+    // Surfaces that don't track damage always report all of their pixels.
+    SkAutoTUnref<SkSurface> untracked(SkSurface::NewRaster(info));
+    REPORTER_ASSERT(reporter, bounds == untracked->getDamage());
+    untracked->resetDamage();
+    REPORTER_ASSERT(reporter, bounds == untracked->getDamage());
+
+    const SkSurfaceProps props(SkSurfaceProps::kTrackDamage_Flag,
+                               SkSurfaceProps::kLegacyFontHost_InitType);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRaster(info, &props));
+    SkCanvas* canvas = surface->getCanvas();
+    REPORTER_ASSERT(reporter, surface->getDamage().isEmpty());
+
+    canvas->clear(SK_ColorWHITE);
+    REPORTER_ASSERT(reporter, bounds == surface->getDamage());
+    surface->resetDamage();
+    REPORTER_ASSERT(reporter, surface->getDamage().isEmpty());
+
+    SkBitmap before, after;
+    before.allocPixels(info);
+    after.allocPixels(info);
+    canvas->readPixels(&before, 0, 0);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawRect(SkRect::MakeXYWH(10.5f, 10.5f, 20, 20), paint);
+    SkIRect damage = surface->getDamage();
+    REPORTER_ASSERT(reporter, damage.contains(SkIRect::MakeLTRB(10, 10, 31, 31)));
+    REPORTER_ASSERT(reporter, SkIRect::MakeLTRB(8, 8, 33, 33).contains(damage));
+
+    // Clipped draws only damage the clip.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(50, 50, 60, 60));
+    canvas->drawCircle(50, 50, 40, paint);
+    canvas->restore();
+    REPORTER_ASSERT(reporter, !surface->getDamage().contains(70, 70));
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    canvas->drawLine(70, 80, 90, 85, paint);
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setTextSize(12);
+    canvas->drawText("Damage", 6, 40, 95, paint);
+    paint.setTextAlign(SkPaint::kRight_Align);
+    canvas->drawText("R", 1, 99, 60, paint);
+    SkPoint pos[] = { { 5, 50 }, { 12, 70 } };
+    canvas->drawPosText("ab", 2, pos, paint);
+    const SkRect layerBounds = SkRect::MakeXYWH(70, 5, 10, 10);
+    canvas->saveLayer(&layerBounds, NULL);
+    canvas->drawRect(layerBounds, paint);
+    canvas->restore();
+
+    canvas->readPixels(&after, 0, 0);
+    REPORTER_ASSERT(reporter, changes_inside(before, after, surface->getDamage()));
+    REPORTER_ASSERT(reporter, bounds != surface->getDamage());
+
+    surface->resetDamage();
+    SkPMColor pixel = SkPreMultiplyColor(SK_ColorRED);
+    canvas->writePixels(SkImageInfo::MakeN32Premul(1, 1), &pixel, 4, 42, 43);
+    REPORTER_ASSERT(reporter, SkIRect::MakeXYWH(42, 43, 1, 1) == surface->getDamage());
+}
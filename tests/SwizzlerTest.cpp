@@ -5,6 +5,9 @@
  * found in the LICENSE file.
  */
 
+#include "SkColorPriv.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
 #include "SkSwizzler.h"
 #include "Test.h"
 
@@ -132,3 +135,132 @@ DEF_TEST(SwizzlerFill, r) {
         }
     }
 }
+
+// Reference for the SkOpts swizzles, one byte at a time in memory order.
+static uint16_t swizzle_bytes(uint8_t* dst, const uint8_t* src, int count, int srcBpp,
+                              bool swapRB, bool premul) {
+    uint8_t andAlpha = 0xFF, orAlpha = 0;
+    for (int i = 0; i < count; i++) {
+        const uint8_t a = 4 == srcBpp ? src[3] : 0xFF;
+        const uint8_t r = 1 == srcBpp ? src[0] : src[swapRB ? 2 : 0],
+                      g = 1 == srcBpp ? src[0] : src[1],
+                      b = 1 == srcBpp ? src[0] : src[swapRB ? 0 : 2];
+        dst[0] = premul ? SkMulDiv255Round(r, a) : r;
+        dst[1] = premul ? SkMulDiv255Round(g, a) : g;
+        dst[2] = premul ? SkMulDiv255Round(b, a) : b;
+        dst[3] = a;
+        andAlpha &= a;
+        orAlpha  |= a;
+        src += srcBpp;
+        dst += 4;
+    }
+    return SkSwizzler::GetResult(orAlpha, andAlpha);
+}
+
+// Reference for the SkOpts unpremultiplies, which scale by a correctly rounded 255/a.
+static uint16_t unpremul_bytes(uint8_t* dst, const uint8_t* src, int count, bool swapRB) {
+    uint8_t andAlpha = 0xFF, orAlpha = 0;
+    for (int i = 0; i < count; i++) {
+        const uint8_t a = src[3];
+        const float scale = a ? 255.0f / a : 0;
+        uint8_t c[3];
+        for (int j = 0; j < 3; j++) {
+            c[j] = SkTMin((unsigned)(src[j] * scale + 0.5f), 255u);
+        }
+        dst[0] = c[swapRB ? 2 : 0];
+        dst[1] = c[1];
+        dst[2] = c[swapRB ? 0 : 2];
+        dst[3] = a;
+        andAlpha &= a;
+        orAlpha  |= a;
+        src += 4;
+        dst += 4;
+    }
+    return SkSwizzler::GetResult(orAlpha, andAlpha);
+}
+
+// The SkOpts swizzles must match the reference exactly, including the SIMD loops and tails.
+DEF_TEST(SwizzlerOpts, r) {
+    SkRandom rand;
+    const int kMaxCount = 67;
+    uint8_t src[4 * kMaxCount];
+    uint32_t table[256];
+    for (int i = 0; i < 256; i++) {
+        table[i] = rand.nextU();
+    }
+
+    uint32_t expected[kMaxCount], actual[kMaxCount];
+    for (int count = 0; count <= kMaxCount; count++) {
+        // Random alphas, then all opaque, then all transparent.
+        for (int alphas = 0; alphas < 3; alphas++) {
+            for (int i = 0; i < 4 * kMaxCount; i++) {
+                src[i] = rand.nextU() & 0xFF;
+                if (alphas > 0 && 3 == i % 4) {
+                    src[i] = 1 == alphas ? 0xFF : 0;
+                }
+            }
+
+            struct {
+                SkOpts::Swizzle_8888 proc;
+                bool swapRB, premul;
+            } procs[] = {
+                { SkOpts::RGBA_to_rgbA, false, true  },
+                { SkOpts::RGBA_to_bgrA, true,  true  },
+                { SkOpts::RGBA_to_BGRA, true,  false },
+            };
+            for (auto p : procs) {
+                const uint16_t expectedAlpha = swizzle_bytes((uint8_t*)expected, src, count, 4,
+                                                             p.swapRB, p.premul);
+                REPORTER_ASSERT(r, expectedAlpha == p.proc(actual, src, count));
+                REPORTER_ASSERT(r, 0 == memcmp(expected, actual, count * sizeof(uint32_t)));
+            }
+
+            // The unpremultiplies must also work in place.
+            const SkOpts::Swizzle_8888 unpremuls[] = { SkOpts::rgbA_to_RGBA, SkOpts::rgbA_to_BGRA };
+            for (int swapRB = 0; swapRB < 2; swapRB++) {
+                const uint16_t expectedAlpha = unpremul_bytes((uint8_t*)expected, src, count,
+                                                              SkToBool(swapRB));
+                memcpy(actual, src, count * sizeof(uint32_t));
+                REPORTER_ASSERT(r, expectedAlpha ==
+                                   unpremuls[swapRB](actual, (const uint8_t*)actual, count));
+                REPORTER_ASSERT(r, 0 == memcmp(expected, actual, count * sizeof(uint32_t)));
+            }
+
+            swizzle_bytes((uint8_t*)expected, src, count, 3, false, false);
+            SkOpts::RGB_to_RGB1(actual, src, count);
+            REPORTER_ASSERT(r, 0 == memcmp(expected, actual, count * sizeof(uint32_t)));
+
+            swizzle_bytes((uint8_t*)expected, src, count, 3, true, false);
+            SkOpts::RGB_to_BGR1(actual, src, count);
+            REPORTER_ASSERT(r, 0 == memcmp(expected, actual, count * sizeof(uint32_t)));
+
+            swizzle_bytes((uint8_t*)expected, src, count, 1, false, false);
+            SkOpts::gray_to_RGB1(actual, src, count);
+            REPORTER_ASSERT(r, 0 == memcmp(expected, actual, count * sizeof(uint32_t)));
+
+            uint8_t andAlpha = 0xFF, orAlpha = 0;
+            for (int i = 0; i < count; i++) {
+                expected[i] = table[src[i]];
+                andAlpha &= SkGetPackedA32(expected[i]);
+                orAlpha  |= SkGetPackedA32(expected[i]);
+            }
+            REPORTER_ASSERT(r, SkSwizzler::GetResult(orAlpha, andAlpha) ==
+                               SkOpts::index_to_color(actual, src, count, table));
+            REPORTER_ASSERT(r, 0 == memcmp(expected, actual, count * sizeof(uint32_t)));
+        }
+    }
+}
+
+// Premultiplying an unpremultiplied color must give back the original for every valid color.
+DEF_TEST(SwizzlerOpts_UnpremulRoundTrip, r) {
+    uint32_t premul[256], unpremul[256], roundTrip[256];
+    for (int a = 0; a < 256; a++) {
+        for (int c = 0; c <= a; c++) {
+            premul[c] = SkPackARGB32NoCheck(a, c, a - c, c / 2);
+        }
+        const int count = a + 1;
+        SkOpts::rgbA_to_RGBA(unpremul, (const uint8_t*)premul, count);
+        SkOpts::RGBA_to_rgbA(roundTrip, (const uint8_t*)unpremul, count);
+        REPORTER_ASSERT(r, 0 == memcmp(premul, roundTrip, count * sizeof(uint32_t)));
+    }
+}
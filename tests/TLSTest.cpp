@@ -78,3 +78,27 @@ DEF_TEST(TLS, reporter) {
     test_threads(&testTLSDestructor);
     REPORTER_ASSERT(reporter, 0 == gCounter);
 }
+
+DEF_TEST(TLSFontCache, reporter) {
+    const char text[] = "Hamburgefons";
+    const size_t len = strlen(text);
+    SkPaint paint;
+    paint.setTextSize(SkIntToScalar(17));
+
+    const SkScalar shared = paint.measureText(text, len);
+
+    SkGraphics::SetTLSFontCacheLimit(1 * 1024 * 1024);
+    REPORTER_ASSERT(reporter, 1 * 1024 * 1024 == SkGraphics::GetTLSFontCacheLimit());
+
+    // Twice: once to park the strike on this thread, once to find it there.
+    REPORTER_ASSERT(reporter, shared == paint.measureText(text, len));
+    REPORTER_ASSERT(reporter, shared == paint.measureText(text, len));
+
+    // Purging hands this thread's strikes back to the global cache.
+    SkGraphics::PurgeFontCache();
+    REPORTER_ASSERT(reporter, shared == paint.measureText(text, len));
+
+    SkGraphics::SetTLSFontCacheLimit(0);
+    REPORTER_ASSERT(reporter, 0 == SkGraphics::GetTLSFontCacheLimit());
+    REPORTER_ASSERT(reporter, shared == paint.measureText(text, len));
+}
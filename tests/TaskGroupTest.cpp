@@ -0,0 +1,53 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+
+DEF_TEST(TaskGroup_parallel_for, r) {
+    // Every index must be visited exactly once, whatever the split.
+    const int kSizes[] = { 1, 2, 3, 7, 64, 1000, 4099 };
+    for (size_t s = 0; s < SK_ARRAY_COUNT(kSizes); s++) {
+        const int N = kSizes[s];
+        SkAutoTMalloc<SkAtomic<int32_t>> visits(N);
+        for (int i = 0; i < N; i++) {
+            visits[i].store(0);
+        }
+        sk_parallel_for(N, [&](int i) { visits[i].fetch_add(1); });
+        for (int i = 0; i < N; i++) {
+            REPORTER_ASSERT(r, 1 == visits[i].load());
+        }
+    }
+}
+
+static void add_one(SkAtomic<int32_t>* counter) { counter->fetch_add(1); }
+
+struct Spawner {
+    SkTaskGroup*       tg;
+    SkAtomic<int32_t>* counter;
+};
+
+// Tasks may add more tasks to their own SkTaskGroup while it's being waited on.
+static void spawn_more(Spawner* s) {
+    for (int i = 0; i < 10; i++) {
+        s->tg->add(add_one, s->counter);
+    }
+}
+
+DEF_TEST(TaskGroup_nested, r) {
+    SkAtomic<int32_t> counter(0);
+    SkTaskGroup tg;
+    Spawner spawners[20];
+    for (int i = 0; i < 20; i++) {
+        spawners[i].tg      = &tg;
+        spawners[i].counter = &counter;
+    }
+    tg.batch(spawn_more, spawners, 20);
+    tg.wait();
+    REPORTER_ASSERT(r, 200 == counter.load());
+}
@@ -24,6 +24,7 @@
 
 #if SK_SUPPORT_GPU
 #include "GrContextFactory.h"
+#include "GrTextBlobCache.h"
 
 struct TextBlobWrapper {
     // This class assumes it 'owns' the textblob it wraps, and thus does not need to take a ref
@@ -154,6 +155,58 @@ DEF_GPUTEST(TextBlobCache, reporter, factory) {
     text_blob_cache_inner(reporter, factory, 4096, 256, 30, true);
 }
 
+static const SkTextBlob* make_blob(const SkPaint& font, int glyphCount) {
+    SkTextBlobBuilder builder;
+    const SkTextBlobBuilder::RunBuffer& run = builder.allocRun(font, glyphCount, 0, 0, NULL);
+    for (int i = 0; i < glyphCount; i++) {
+        run.glyphs[i] = i + 1;
+    }
+    return builder.build();
+}
+
+// Deleting an SkTextBlob should drop what the GrContext cached for it, and the cache should
+// stay within the byte limit given in GrContextOptions.
+DEF_GPUTEST(TextBlobCachePurgeAndLimit, reporter, factory) {
+    GrContextOptions options;
+    options.fTextBlobCacheLimit = 1 << 16;
+    GrContextFactory limitedFactory(options);
+    GrContext* ctx = limitedFactory.get(GrContextFactory::kNull_GLContextType);
+    SkImageInfo info = SkImageInfo::MakeN32Premul(kWidth, kHeight);
+    SkAutoTUnref<SkSurface> surface(SkSurface::NewRenderTarget(ctx, SkSurface::kNo_Budgeted,
+                                                               info));
+    if (!surface) {
+        return;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    GrTextBlobCache* cache = ctx->getTextBlobCache();
+
+    SkPaint font;
+    font.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    SkPaint paint;
+    SkAutoTUnref<const SkTextBlob> keep(make_blob(font, 16));
+    canvas->drawTextBlob(keep, 0, 20, paint);
+    {
+        SkAutoTUnref<const SkTextBlob> temp(make_blob(font, 16));
+        canvas->drawTextBlob(temp, 0, 40, paint);
+        paint.setStyle(SkPaint::kStroke_Style);
+        canvas->drawTextBlob(temp, 0, 40, paint);
+        paint.setStyle(SkPaint::kFill_Style);
+        REPORTER_ASSERT(reporter, 3 == cache->count());
+    }
+    // The deleted blob's two entries go before the next blob is cached.
+    SkAutoTUnref<const SkTextBlob> next(make_blob(font, 16));
+    canvas->drawTextBlob(next, 0, 60, paint);
+    REPORTER_ASSERT(reporter, 2 == cache->count());
+
+    // Many blobs, each far smaller than the limit, must not push the cache past it.
+    for (int i = 0; i < 100; i++) {
+        SkAutoTUnref<const SkTextBlob> blob(make_blob(font, 64));
+        canvas->drawTextBlob(blob, 0, 80, paint);
+        REPORTER_ASSERT(reporter, cache->currentSize() <= options.fTextBlobCacheLimit);
+    }
+    ctx->flush();
+}
+
 DEF_GPUTEST(TextBlobAbnormal, reporter, factory) {
 #ifdef SK_BUILD_FOR_ANDROID
     text_blob_cache_inner(reporter, factory, 256, 256, 30, false);
@@ -273,3 +273,79 @@ DEF_TEST(CompressLATC, reporter) {
         }
     }
 }
+
+/**
+ * Large images are compressed in bands of block rows. Make sure each band lands where a
+ * single pass would have put it.
+ */
+DEF_TEST(CompressLargeInBands, reporter) {
+    // Multiples of every compressed block dimension.
+    static const int kWidth = 480;
+    static const int kHeight = 480;
+    static const int kStripHeight = 12;
+
+    SkAutoPixmapStorage pixmap;
+    pixmap.alloc(SkImageInfo::MakeA8(kWidth, kHeight));
+    uint8_t* pixels = reinterpret_cast<uint8_t*>(pixmap.writable_addr());
+    for (int y = 0; y < kHeight; ++y) {
+        for (int x = 0; x < kWidth; ++x) {
+            pixels[y * pixmap.rowBytes() + x] = static_cast<uint8_t>(x ^ (y * 7));
+        }
+    }
+
+    for (int i = 0; i < SkTextureCompressor::kFormatCnt; ++i) {
+        const SkTextureCompressor::Format fmt = static_cast<SkTextureCompressor::Format>(i);
+        if (!compresses_a8(fmt)) {
+            continue;
+        }
+        SkAutoDataUnref data(SkTextureCompressor::CompressBitmapToFormat(pixmap, fmt));
+        REPORTER_ASSERT(reporter, data);
+        if (NULL == data) {
+            continue;
+        }
+
+        // Strips this small are compressed in a single pass.
+        const int stripSize = SkTextureCompressor::GetCompressedDataSize(fmt, kWidth,
+                                                                         kStripHeight);
+        const uint8_t* bytes = data->bytes();
+        for (int top = 0; top + kStripHeight <= kHeight; top += kStripHeight * 5) {
+            SkAutoTMalloc<uint8_t> strip(stripSize);
+            REPORTER_ASSERT(reporter, SkTextureCompressor::CompressBufferToFormat(
+                    strip.get(), pixels + top * pixmap.rowBytes(), kAlpha_8_SkColorType,
+                    kWidth, kStripHeight, pixmap.rowBytes(), fmt));
+            const size_t offset = top / kStripHeight * stripSize;
+            REPORTER_ASSERT(reporter, 0 == memcmp(bytes + offset, strip.get(), stripSize));
+        }
+    }
+}
+
+#ifndef SK_IGNORE_ETC1_SUPPORT
+/**
+ * Opaque N32 bitmaps compress to ETC1. A flat color should survive the round trip closely.
+ */
+DEF_TEST(CompressETC1FromN32, reporter) {
+    static const int kWidth = 16;
+    static const int kHeight = 8;
+    static const SkColor kColor = SkColorSetRGB(0x40, 0x80, 0xC0);
+
+    SkAutoPixmapStorage pixmap;
+    pixmap.alloc(SkImageInfo::MakeN32(kWidth, kHeight, kOpaque_SkAlphaType));
+    pixmap.erase(kColor);
+
+    SkAutoDataUnref data(SkTextureCompressor::CompressBitmapToFormat(
+            pixmap, SkTextureCompressor::kETC1_Format));
+    REPORTER_ASSERT(reporter, data);
+    if (NULL == data) {
+        return;
+    }
+
+    uint8_t rgb[kWidth * kHeight * 3];
+    REPORTER_ASSERT(reporter, SkTextureCompressor::DecompressBufferFromFormat(
+            rgb, kWidth * 3, data->bytes(), kWidth, kHeight, SkTextureCompressor::kETC1_Format));
+    for (int i = 0; i < kWidth * kHeight; ++i) {
+        REPORTER_ASSERT(reporter, SkTAbs(rgb[3 * i + 0] - 0x40) <= 8);
+        REPORTER_ASSERT(reporter, SkTAbs(rgb[3 * i + 1] - 0x80) <= 8);
+        REPORTER_ASSERT(reporter, SkTAbs(rgb[3 * i + 2] - 0xC0) <= 8);
+    }
+}
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkColorPriv.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+#include "SkRTree.h"
+#include "SkTiledPictureDraw.h"
+#include "Test.h"
+
+static SkPicture* make_picture(SkBBHFactory* factory) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(300, 500, factory);
+
+    // Some of these spill past the cull rect, which SkTiledPictureDraw clips away.
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 200; i++) {
+        paint.setColor(rand.nextU() | 0xFF000000);
+        SkRect r = SkRect::MakeXYWH(rand.nextRangeF(-20, 300), rand.nextRangeF(-20, 500),
+                                    rand.nextRangeF(1, 80),   rand.nextRangeF(1, 80));
+        if (i & 1) {
+            canvas->drawOval(r, paint);
+        } else {
+            canvas->drawRect(r, paint);
+        }
+    }
+    return recorder.endRecording();
+}
+
+// Clipping to a tile can move anti-aliased curve edges by a fraction of a pixel.
+static const int kTolerance = 16;
+
+static bool close_enough(SkPMColor a, SkPMColor b) {
+    return SkTAbs((int)SkGetPackedA32(a) - (int)SkGetPackedA32(b)) <= kTolerance &&
+           SkTAbs((int)SkGetPackedR32(a) - (int)SkGetPackedR32(b)) <= kTolerance &&
+           SkTAbs((int)SkGetPackedG32(a) - (int)SkGetPackedG32(b)) <= kTolerance &&
+           SkTAbs((int)SkGetPackedB32(a) - (int)SkGetPackedB32(b)) <= kTolerance;
+}
+
+static void check_tiled(skiatest::Reporter* r, const SkPicture* pic,
+                        const SkMatrix* matrix, int tileW, int tileH) {
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(300, 500);
+    actual.allocN32Pixels(300, 500);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.eraseColor(SK_ColorWHITE);
+
+    SkCanvas canvas(expected);
+    if (matrix) {
+        canvas.concat(*matrix);
+    }
+    canvas.clipRect(pic->cullRect());
+    canvas.drawPicture(pic);
+
+    SkTiledPictureDraw::Draw(pic, actual, matrix, tileW, tileH);
+
+    SkAutoLockPixels e(expected), a(actual);
+    int mismatches = 0;
+    for (int y = 0; y < expected.height(); ++y) {
+        for (int x = 0; x < expected.width(); ++x) {
+            if (!close_enough(*expected.getAddr32(x, y), *actual.getAddr32(x, y))) {
+                ++mismatches;
+            }
+        }
+    }
+    REPORTER_ASSERT(r, 0 == mismatches);
+}
+
+DEF_TEST(TiledPictureDraw, r) {
+    SkRTreeFactory factory;
+    SkAutoTUnref<SkPicture> withBBH(make_picture(&factory));
+    SkAutoTUnref<SkPicture> withoutBBH(make_picture(NULL));
+
+    SkMatrix scale;
+    scale.setScale(0.75f, 1.25f);
+
+    const SkPicture* pics[] = { withBBH, withoutBBH };
+    for (size_t i = 0; i < SK_ARRAY_COUNT(pics); i++) {
+        check_tiled(r, pics[i], NULL, 64, 64);
+        check_tiled(r, pics[i], NULL, 1000, 1000);  // One tile.
+        check_tiled(r, pics[i], &scale, 37, 91);    // Tiles don't divide the bitmap.
+    }
+}
+
+// Only the tiles intersecting the dirty rect are drawn.
+DEF_TEST(TiledPictureDraw_Dirty, r) {
+    SkRTreeFactory factory;
+    SkAutoTUnref<SkPicture> pic(make_picture(&factory));
+
+    SkBitmap actual;
+    actual.allocN32Pixels(300, 500);
+    actual.eraseColor(SK_ColorWHITE);
+
+    const SkIRect dirty = SkIRect::MakeXYWH(70, 130, 10, 10);
+    SkTiledPictureDraw::Draw(pic, actual, NULL, 64, 64, &dirty);
+
+    const SkIRect drawn = SkIRect::MakeLTRB(64, 128, 128, 192);
+    bool outsideUntouched = true, insideDrawn = false;
+    for (int y = 0; y < actual.height(); ++y) {
+        for (int x = 0; x < actual.width(); ++x) {
+            const bool white = SK_ColorWHITE == actual.getColor(x, y);
+            if (drawn.contains(x, y)) {
+                insideDrawn |= !white;
+            } else {
+                outsideUntouched &= white;
+            }
+        }
+    }
+    REPORTER_ASSERT(r, outsideUntouched);
+    REPORTER_ASSERT(r, insideDrawn);
+}
@@ -24,3 +24,47 @@ DEF_TEST(Typeface, reporter) {
     REPORTER_ASSERT(reporter, NULL == t3.get());
 #endif
 }
+
+#include "SkTypefaceCache.h"
+
+static bool find_by_pointer(SkTypeface* face, const SkFontStyle&, void* ctx) {
+    return face == ctx;
+}
+
+DEF_TEST(TypefaceCache_KeyHashes, reporter) {
+    SkAutoTUnref<SkTypeface> normal(SkTypeface::RefDefault(SkTypeface::kNormal));
+    SkAutoTUnref<SkTypeface> bold(SkTypeface::RefDefault(SkTypeface::kBold));
+    if (!normal || !bold || normal.get() == bold.get()) {
+        return;
+    }
+
+    SkTypefaceCache cache;
+    const SkFontStyle style;
+    const uint32_t normalKey = SkTypefaceCache::HashNameStyle("normal", style);
+    const uint32_t boldKeys[] = {
+        SkTypefaceCache::HashNameStyle("bold", style),
+        SkTypefaceCache::HashKey("alias", 5),
+    };
+    cache.add(normal, style, &normalKey, 1);
+    cache.add(bold, style, boldKeys, SK_ARRAY_COUNT(boldKeys));
+
+    // Keyed lookups only see the typefaces added under that key.
+    SkAutoTUnref<SkTypeface> found(cache.findByProcAndRef(find_by_pointer, normal, normalKey));
+    REPORTER_ASSERT(reporter, found.get() == normal.get());
+    found.reset(cache.findByProcAndRef(find_by_pointer, bold, normalKey));
+    REPORTER_ASSERT(reporter, NULL == found.get());
+    for (size_t i = 0; i < SK_ARRAY_COUNT(boldKeys); ++i) {
+        found.reset(cache.findByProcAndRef(find_by_pointer, bold, boldKeys[i]));
+        REPORTER_ASSERT(reporter, found.get() == bold.get());
+    }
+
+    // Unkeyed lookups still see everything.
+    found.reset(cache.findByProcAndRef(find_by_pointer, bold));
+    REPORTER_ASSERT(reporter, found.get() == bold.get());
+    found.reset(NULL);
+
+    // Purging keeps faces that are still owned elsewhere, along with their keys.
+    cache.purgeAll();
+    found.reset(cache.findByProcAndRef(find_by_pointer, normal, normalKey));
+    REPORTER_ASSERT(reporter, found.get() == normal.get());
+}
@@ -11,3 +11,21 @@ DEF_TEST(VarAlloc, r) {
     REPORTER_ASSERT(r, va.approxBytesAllocated() >= 128);
 #endif
 }
+
+DEF_TEST(VarAlloc_Recycle, r) {
+    // Blocks freed by one SkVarAlloc may be handed to the next, which must see them as new.
+    size_t bytesAllocated = 0;
+    for (int i = 0; i < 8; ++i) {
+        SkVarAlloc va(9);
+        for (int j = 0; j < 100; ++j) {
+            const size_t bytes = 16 + 48 * j;
+            char* p = va.alloc(bytes, SK_MALLOC_THROW);
+            memset(p, j, bytes);
+            REPORTER_ASSERT(r, SkIsAlignPtr((intptr_t)p));
+        }
+        if (0 == i) {
+            bytesAllocated = va.approxBytesAllocated();
+        }
+        REPORTER_ASSERT(r, bytesAllocated == va.approxBytesAllocated());
+    }
+}
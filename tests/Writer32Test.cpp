@@ -281,3 +281,49 @@ DEF_TEST(Writer32_misc, reporter) {
     test_rewind(reporter);
 }
 
+
+DEF_TEST(Writer32_reserveCapacity, reporter) {
+    SkWriter32 writer;
+    writer.reserveCapacity(4096);
+    // Filling the reserved capacity should not move the storage.
+    const uint32_t* storage = (const uint32_t*)writer.reserve(4);
+    for (int i = 1; i < 1024; ++i) {
+        writer.write32(i);
+    }
+    REPORTER_ASSERT(reporter, writer.contiguousArray() == storage);
+
+    // Reserving less than we already have is a no-op.
+    writer.reserveCapacity(16);
+    REPORTER_ASSERT(reporter, writer.contiguousArray() == storage);
+    REPORTER_ASSERT(reporter, 4096 == writer.bytesWritten());
+
+    // Reserving from external storage must carry over what was written so far.
+    uint32_t external[4];
+    writer.reset(external, sizeof(external));
+    writer.write32(0xDEADBEEF);
+    writer.reserveCapacity(1024);
+    REPORTER_ASSERT(reporter, writer.contiguousArray() != external);
+    REPORTER_ASSERT(reporter, 0xDEADBEEF == writer.readTAt<uint32_t>(0));
+}
+
+DEF_TEST(Writer32_detachAsData, reporter) {
+    SkWriter32 writer;
+    for (int i = 0; i < 100; ++i) {
+        writer.write32(i);
+    }
+    // Dynamically allocated storage is handed over without a copy.
+    const void* storage = writer.contiguousArray();
+    SkAutoTUnref<SkData> data(writer.detachAsData());
+    REPORTER_ASSERT(reporter, data->data() == storage);
+    REPORTER_ASSERT(reporter, 100 * sizeof(uint32_t) == data->size());
+    REPORTER_ASSERT(reporter, 99 == ((const uint32_t*)data->data())[99]);
+    REPORTER_ASSERT(reporter, 0 == writer.bytesWritten());
+
+    // External storage is copied, since the caller still owns it.
+    uint32_t external[4];
+    writer.reset(external, sizeof(external));
+    writer.write32(7);
+    data.reset(writer.detachAsData());
+    REPORTER_ASSERT(reporter, data->data() != external);
+    REPORTER_ASSERT(reporter, 7 == *(const uint32_t*)data->data());
+}
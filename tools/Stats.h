@@ -21,7 +21,7 @@ struct Stats {
     Stats(const SkTArray<double>& samples) {
         int n = samples.count();
         if (!n) {
-            min = max = mean = var = median = 0;
+            min = max = mean = var = median = p90 = p95 = p99 = 0;
             return;
         }
 
@@ -48,6 +48,9 @@ struct Stats {
         memcpy(sorted.get(), samples.begin(), n * sizeof(double));
         SkTQSort(sorted.get(), sorted.get() + n - 1);
         median = sorted[n/2];
+        p90 = Percentile(sorted.get(), n, 90);
+        p95 = Percentile(sorted.get(), n, 95);
+        p99 = Percentile(sorted.get(), n, 99);
 
         // Normalize samples to [min, max] in as many quanta as we have distinct bars to print.
         for (int i = 0; i < n; i++) {
@@ -72,7 +75,14 @@ struct Stats {
     double mean;    // Estimate of population mean.
     double var;     // Estimate of population variance.
     double median;
+    double p90, p95, p99;  // Nearest-rank percentiles.
     SkString plot;  // A single-line bar chart (_not_ histogram) of the samples.
+
+private:
+    static double Percentile(const double sorted[], int n, int percent) {
+        const int rank = (n * percent + 99) / 100;  // ceil(n * percent / 100)
+        return sorted[SkTPin(rank - 1, 0, n - 1)];
+    }
 };
 
 #endif//Stats_DEFINED
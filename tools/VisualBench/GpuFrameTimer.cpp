@@ -0,0 +1,65 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ */
+
+#include "GpuFrameTimer.h"
+#include "gl/GrGLDefines.h"
+#include "gl/GrGLUtil.h"
+
+GpuFrameTimer::GpuFrameTimer(const GrGLInterface* gl, int maxFrameLag)
+    : fInterface(SkRef(gl))
+    , fFrames(0)
+    , fRead(0) {
+    fSupported = GrGLGetVersion(gl) > GR_GL_VER(3,3) ||
+                 gl->hasExtension("GL_ARB_timer_query") ||
+                 gl->hasExtension("GL_EXT_timer_query");
+    if (fSupported) {
+        fQueries.setCount(SkTMax(maxFrameLag, 0) + 1);
+        GR_GL_CALL(gl, GenQueries(fQueries.count(), fQueries.begin()));
+    }
+}
+
+GpuFrameTimer::~GpuFrameTimer() {
+    if (fSupported) {
+        GR_GL_CALL(fInterface.get(), DeleteQueries(fQueries.count(), fQueries.begin()));
+    }
+}
+
+void GpuFrameTimer::beginFrame() {
+    if (!fSupported) {
+        return;
+    }
+    if (fFrames - fRead == fQueries.count()) {
+        // Every query is in flight, so the oldest must be read before it can be reused.
+        this->readOldest();
+    }
+    GR_GL_CALL(fInterface.get(), BeginQuery(GR_GL_TIME_ELAPSED,
+                                            fQueries[fFrames % fQueries.count()]));
+    fFrames++;
+}
+
+void GpuFrameTimer::endFrame() {
+    if (fSupported) {
+        GR_GL_CALL(fInterface.get(), EndQuery(GR_GL_TIME_ELAPSED));
+    }
+}
+
+void GpuFrameTimer::readOldest() {
+    SkASSERT(fRead < fFrames);
+    GrGLuint64 ns = 0;
+    GR_GL_CALL(fInterface.get(), GetQueryObjectui64v(fQueries[fRead % fQueries.count()],
+                                                     GR_GL_QUERY_RESULT, &ns));
+    fFrameMs.push_back(ns / 1000000.0);
+    fRead++;
+}
+
+const SkTArray<double>& GpuFrameTimer::finish() {
+    while (fRead < fFrames) {
+        this->readOldest();
+    }
+    return fFrameMs;
+}
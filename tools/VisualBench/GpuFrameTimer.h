@@ -0,0 +1,48 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ */
+
+#ifndef GpuFrameTimer_DEFINED
+#define GpuFrameTimer_DEFINED
+
+#include "SkRefCnt.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+#include "gl/GrGLInterface.h"
+
+/**
+ * Times every frame on the GPU with GL_TIME_ELAPSED queries. Unlike GpuTimer, which waits for its
+ * result right away, each query is only read back maxFrameLag frames later, once the GPU has
+ * caught up, so timing doesn't stall the pipeline.
+ */
+class GpuFrameTimer {
+public:
+    GpuFrameTimer(const GrGLInterface*, int maxFrameLag);
+    ~GpuFrameTimer();
+
+    /** False if the GL has no timer queries; the other calls then do nothing. */
+    bool isSupported() const { return fSupported; }
+
+    void beginFrame();
+    void endFrame();
+
+    /** Waits for any frames still pending and returns the GPU time, in ms, of every frame. */
+    const SkTArray<double>& finish();
+
+private:
+    // Reads back the oldest pending query.
+    void readOldest();
+
+    SkAutoTUnref<const GrGLInterface> fInterface;
+    bool                              fSupported;
+    SkTDArray<unsigned>               fQueries;  // One per frame in flight.
+    int                               fFrames;   // Frames begun.
+    int                               fRead;     // Frames whose time has been read back.
+    SkTArray<double>                  fFrameMs;
+};
+
+#endif
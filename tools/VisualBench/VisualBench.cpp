@@ -36,6 +36,10 @@ DEFINE_int32(msaa, 0, "Number of msaa samples.");
 DEFINE_bool2(fullscreen, f, true, "Run fullscreen.");
 DEFINE_bool2(verbose, v, false, "enable verbose output from the test driver.");
 DEFINE_string(key, "", "");  // dummy to enable gm tests that have platform-specific names
+DEFINE_int32(animationFrames, 300, "With --animation, number of frames of each skp to time.");
+DEFINE_double(frameBudgetMs, 16.67, "With --animation, frames slower than this are janky, and "
+                                    "each further budget a frame takes is a dropped frame.");
+DEFINE_string(outResultsFile, "", "If given, write results here as JSON.");
 
 static SkString humanize(double ms) {
     if (FLAGS_verbose) {
@@ -55,6 +59,14 @@ VisualBench::VisualBench(void* hwnd, int argc, char** argv)
     , fState(kPreWarmLoops_State)
     , fBenchmark(NULL) {
     SkCommandLineFlags::Parse(argc, argv);
+    if (!FLAGS_animation.isEmpty()) {
+        fState = kPreWarmAnimationPerCanvasPreDraw_State;
+    }
+    if (FLAGS_outResultsFile.isEmpty()) {
+        fResults.reset(SkNEW(ResultsWriter));
+    } else {
+        fResults.reset(SkNEW_ARGS(NanoJSONResultsWriter, (FLAGS_outResultsFile[0])));
+    }
 
     this->setTitle();
     this->setupBackend();
@@ -62,7 +74,12 @@ VisualBench::VisualBench(void* hwnd, int argc, char** argv)
     fBenchmarkStream.reset(SkNEW(VisualBenchmarkStream));
 
     // Print header
-    SkDebugf("curr/maxrss\tloops\tflushes\tmin\tmedian\tmean\tmax\tstddev\tbench\n");
+    if (FLAGS_animation.isEmpty()) {
+        SkDebugf("curr/maxrss\tloops\tflushes\tmin\tmedian\tmean\tmax\tstddev\tbench\n");
+    } else {
+        SkDebugf("curr/maxrss\tframes\tmedian\tmean\tp95\tp99\tmax\tjanky\tdropped\t"
+                 "gpu_median\tgpu_p95\tbench\n");
+    }
 }
 
 VisualBench::~VisualBench() {
@@ -157,6 +174,62 @@ void VisualBench::printStats() {
                  stdDevPercent,
                  shortName);
     }
+
+    const SkIPoint size = fBenchmark->getSize();
+    fResults->bench(shortName, size.fX, size.fY);
+    fResults->config(FLAGS_msaa ? SkStringPrintf("msaa%d", FLAGS_msaa).c_str() : "gpu");
+    fResults->metric("min_ms", Stats(measurements).min);
+    fResults->flush();
+}
+
+void VisualBench::printAnimationStats() {
+    const Stats frames(fFrameMs);
+    int janky = 0, dropped = 0;
+    for (int i = 0; i < fFrameMs.count(); i++) {
+        if (fFrameMs[i] > FLAGS_frameBudgetMs) {
+            // A frame that takes n budgets to draw stands in for n frames.
+            janky++;
+            dropped += (int)ceil(fFrameMs[i] / FLAGS_frameBudgetMs) - 1;
+        }
+    }
+    const Stats gpu(fGpuFrameTimer->finish());
+
+    const char* shortName = fBenchmark->getUniqueName();
+    SkDebugf("%4d/%-4dMB\t%d\t%s\t%s\t%s\t%s\t%s\t%d\t%d\t%s\t%s\t%s\n",
+             sk_tools::getCurrResidentSetSizeMB(),
+             sk_tools::getMaxResidentSetSizeMB(),
+             fFrameMs.count(),
+             HUMANIZE(frames.median),
+             HUMANIZE(frames.mean),
+             HUMANIZE(frames.p95),
+             HUMANIZE(frames.p99),
+             HUMANIZE(frames.max),
+             janky,
+             dropped,
+             fGpuFrameTimer->isSupported() ? HUMANIZE(gpu.median) : "-",
+             fGpuFrameTimer->isSupported() ? HUMANIZE(gpu.p95) : "-",
+             shortName);
+
+    const SkIPoint size = fBenchmark->getSize();
+    fResults->bench(shortName, size.fX, size.fY);
+    fResults->config(FLAGS_msaa ? SkStringPrintf("msaa%d", FLAGS_msaa).c_str() : "gpu");
+    fResults->configOption("animation", FLAGS_animation[0]);
+    fResults->metric("frames",          fFrameMs.count());
+    fResults->metric("frame_median_ms", frames.median);
+    fResults->metric("frame_mean_ms",   frames.mean);
+    fResults->metric("frame_p90_ms",    frames.p90);
+    fResults->metric("frame_p95_ms",    frames.p95);
+    fResults->metric("frame_p99_ms",    frames.p99);
+    fResults->metric("frame_max_ms",    frames.max);
+    fResults->metric("janky_frames",    janky);
+    fResults->metric("dropped_frames",  dropped);
+    if (fGpuFrameTimer->isSupported()) {
+        fResults->metric("gpu_median_ms", gpu.median);
+        fResults->metric("gpu_p95_ms",    gpu.p95);
+        fResults->metric("gpu_p99_ms",    gpu.p99);
+        fResults->metric("gpu_max_ms",    gpu.max);
+    }
+    fResults->flush();
 }
 
 bool VisualBench::advanceRecordIfNecessary(SkCanvas* canvas) {
@@ -201,7 +274,15 @@ void VisualBench::draw(SkCanvas* canvas) {
         this->closeWindow();
         return;
     }
+    // In animations, every frame's GPU work is timed too.
+    GpuFrameTimer* gpuTimer = kAnimation_State == fState ? fGpuFrameTimer.get() : NULL;
+    if (gpuTimer) {
+        gpuTimer->beginFrame();
+    }
     this->renderFrame(canvas);
+    if (gpuTimer) {
+        gpuTimer->endFrame();
+    }
     switch (fState) {
         case kPreWarmLoopsPerCanvasPreDraw_State: {
             this->perCanvasPreDraw(canvas, kPreWarmLoops_State);
@@ -227,6 +308,21 @@ void VisualBench::draw(SkCanvas* canvas) {
             this->timing(canvas);
             break;
         }
+        case kPreWarmAnimationPerCanvasPreDraw_State: {
+            this->perCanvasPreDraw(canvas, kPreWarmAnimation_State);
+            break;
+        }
+        case kPreWarmAnimation_State: {
+            this->preWarm(kAnimation_State);
+            if (kAnimation_State == fState) {
+                fGpuFrameTimer.reset(SkNEW_ARGS(GpuFrameTimer, (fInterface, FLAGS_gpuFrameLag)));
+            }
+            break;
+        }
+        case kAnimation_State: {
+            this->animation(canvas);
+            break;
+        }
     }
 
     // Invalidate the window to force a redraw. Poor man's animation mechanism.
@@ -297,6 +393,22 @@ inline void VisualBench::timing(SkCanvas* canvas) {
     }
 }
 
+inline void VisualBench::animation(SkCanvas* canvas) {
+    // Each frame is timed from the end of the frame before it, so its time covers everything
+    // between two presents, including any wait for the GPU to catch up.
+    fFrameMs.push_back(this->elapsed());
+    fTimer.start();
+    if (fFrameMs.count() >= FLAGS_animationFrames) {
+        this->printAnimationStats();
+        fFrameMs.reset();
+        // The queries must go before resetTimingState() replaces the GL interface.
+        fGpuFrameTimer.reset(NULL);
+        this->postDraw(canvas);
+        this->nextState(kPreWarmAnimationPerCanvasPreDraw_State);
+        this->resetTimingState();
+    }
+}
+
 void VisualBench::onSizeChange() {
     this->setupRenderTarget();
 }
@@ -11,6 +11,8 @@
 
 #include "SkWindow.h"
 
+#include "GpuFrameTimer.h"
+#include "ResultsWriter.h"
 #include "SkPicture.h"
 #include "SkString.h"
 #include "SkSurface.h"
@@ -58,6 +60,14 @@ private:
      *                                       otherwise, we enter the
      *                                       kPreWarmTimingPerCanvasPreDraw_State for another sample
      *                                       In either case we reset the context.
+     *
+     * With --animation, every benchmark is an animated skp and is instead run through:
+     * kPreWarmAnimationPerCanvasPreDraw_State: The benchmark's canvas hook.
+     * kPreWarmAnimation_State:                 We prewarm the gpu to enter a steady state.
+     * kAnimation_State:                        We time each of --animationFrames frames on its
+     *                                          own, drawing the picture once per frame, then
+     *                                          report the distribution of frame times and move
+     *                                          on to the next benchmark.
      */
     enum State {
         kPreWarmLoopsPerCanvasPreDraw_State,
@@ -66,6 +76,9 @@ private:
         kPreWarmTimingPerCanvasPreDraw_State,
         kPreWarmTiming_State,
         kTiming_State,
+        kPreWarmAnimationPerCanvasPreDraw_State,
+        kPreWarmAnimation_State,
+        kAnimation_State,
     };
     void setTitle();
     bool setupBackend();
@@ -85,6 +98,8 @@ private:
     void resetTimingState();
     void postDraw(SkCanvas*);
     void recordMeasurement();
+    inline void animation(SkCanvas*);
+    void printAnimationStats();
 
     struct Record {
         SkTArray<double> fMeasurements;
@@ -99,6 +114,11 @@ private:
     State fState;
     SkAutoTDelete<VisualBenchmarkStream> fBenchmarkStream;
     SkAutoTUnref<Benchmark> fBenchmark;
+    SkAutoTDelete<ResultsWriter> fResults;
+
+    // Per-frame measurements of the current animation, in ms.
+    SkTArray<double> fFrameMs;
+    SkAutoTDelete<GpuFrameTimer> fGpuFrameTimer;
 
     // support framework
     SkAutoTUnref<SkSurface> fSurface;
@@ -8,6 +8,7 @@
 
 #include <VisualBench/VisualBenchmarkStream.h>
 #include "GMBench.h"
+#include "SKPAnimationBench.h"
 #include "SkOSFile.h"
 #include "SkPictureRecorder.h"
 #include "SkStream.h"
@@ -23,6 +24,10 @@ DEFINE_string2(match, m, NULL,
                "If a bench does not match any list entry,\n"
                "it is skipped unless some list entry starts with ~");
 DEFINE_string(skps, "skps", "Directory to read skps from.");
+DEFINE_string(animation, "", "If zoom or scroll, skip benches and GMs, and play each skp with that "
+                             "animation, timing every frame.");
+DEFINE_double(animationPeriodMs, 3000, "Time for one zoom in and out, or scroll down and up.");
+DEFINE_double(zoomMax, 4, "How far the zoom animation zooms in.");
 
 VisualBenchmarkStream::VisualBenchmarkStream()
     : fBenches(BenchRegistry::Head())
@@ -76,6 +81,10 @@ Benchmark* VisualBenchmarkStream::next() {
 }
 
 Benchmark* VisualBenchmarkStream::innerNext() {
+    if (!FLAGS_animation.isEmpty()) {
+        return this->nextAnimation();
+    }
+
     while (fBenches) {
         Benchmark* bench = fBenches->factory()(NULL);
         fBenches = fBenches->next();
@@ -113,3 +122,33 @@ Benchmark* VisualBenchmarkStream::innerNext() {
 
     return NULL;
 }
+
+Benchmark* VisualBenchmarkStream::nextAnimation() {
+    while (fCurrentSKP < fSKPs.count()) {
+        const SkString& path = fSKPs[fCurrentSKP++];
+        SkAutoTUnref<SkPicture> pic;
+        if (!ReadPicture(path.c_str(), &pic)) {
+            continue;
+        }
+
+        SkAutoTUnref<SKPAnimationBench::Animation> animation;
+        if (0 == strcmp(FLAGS_animation[0], "zoom")) {
+            animation.reset(SKPAnimationBench::CreateZoomAnimation(SkDoubleToScalar(FLAGS_zoomMax),
+                                                                   FLAGS_animationPeriodMs));
+        } else if (0 == strcmp(FLAGS_animation[0], "scroll")) {
+            animation.reset(SKPAnimationBench::CreateScrollAnimation(pic->cullRect().height(),
+                                                                     FLAGS_animationPeriodMs));
+        } else {
+            SkDebugf("Unknown --animation %s.\n", FLAGS_animation[0]);
+            return NULL;
+        }
+
+        SkString name = SkOSPath::Basename(path.c_str());
+        fSourceType = "skp";
+        fBenchType = "animation";
+        return SkNEW_ARGS(SKPAnimationBench, (name.c_str(), pic.get(), pic->cullRect().roundOut(),
+                                              animation, false));
+    }
+
+    return NULL;
+}
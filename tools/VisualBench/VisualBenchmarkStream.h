@@ -15,6 +15,7 @@
 #include "SkPicture.h"
 
 DECLARE_string(match);
+DECLARE_string(animation);
 
 class VisualBenchmarkStream {
 public:
@@ -26,6 +27,8 @@ public:
 
 private:
     Benchmark* innerNext();
+    // With --animation, only skps are played, each as an SKPAnimationBench.
+    Benchmark* nextAnimation();
 
     const BenchRegistry* fBenches;
     const skiagm::GMRegistry* fGMs;
@@ -42,6 +42,9 @@ DEFINE_bool(preAbandonGpuContext, false, "Abandons the GrContext before running
 
 DEFINE_bool(abandonGpuContext, false, "Abandon the GrContext after running each test.");
 
+DEFINE_bool(perfCounters, false, "Record hardware performance counters around each timed run. "
+                                 "Linux only.");
+
 DEFINE_string(skps, "skps", "Directory to read skps from.");
 
 DEFINE_int32(threads, -1, "Run threadsafe tests on a threadpool with this many extra threads, "
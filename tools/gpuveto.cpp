@@ -13,10 +13,18 @@
 
 DEFINE_string2(readFile, r, "", "skp file to process.");
 DEFINE_bool2(quiet, q, false, "quiet");
+DEFINE_bool2(verbose, v, false, "Print the GPU cost features and penalty.");
+DEFINE_double(concaveAAPathCost, 1, "Cost of each AA concave path.");
+DEFINE_double(pathEffectCost, 1, "Cost of each path effect.");
+DEFINE_double(maskFilterCost, 0, "Cost of each mask filter.");
+DEFINE_double(concaveAAPathMegapixelCost, 0, "Cost per megapixel of AA concave path bounds.");
+DEFINE_double(gpuCostBudget, 5, "Penalty above which the picture is unsuitable.");
 
 // This tool just loads a single skp, replays into a new SkPicture (to
 // regenerate the GPU-specific tracking information) and reports
-// the value of the suitableForGpuRasterization method.
+// the value of the suitableForGpuRasterization method.  The cost model
+// weights can be overridden on the command line to evaluate candidate
+// models against a corpus of skps.
 // Return codes:
 static const int kSuccess = 0;
 static const int kError = 1;
@@ -60,7 +68,24 @@ int tool_main(int argc, char** argv) {
                                               NULL, 0));
     SkAutoTUnref<SkPicture> recorded(recorder.endRecording());
 
-    if (recorded->suitableForGpuRasterization(NULL)) {
+    SkPicture::GpuCostModel model;
+    model.fConcaveAAPath          = SkDoubleToScalar(FLAGS_concaveAAPathCost);
+    model.fPathEffect             = SkDoubleToScalar(FLAGS_pathEffectCost);
+    model.fMaskFilter             = SkDoubleToScalar(FLAGS_maskFilterCost);
+    model.fConcaveAAPathMegapixel = SkDoubleToScalar(FLAGS_concaveAAPathMegapixelCost);
+    model.fBudget                 = SkDoubleToScalar(FLAGS_gpuCostBudget);
+
+    if (FLAGS_verbose) {
+        const SkPicture::GpuCostFeatures features = recorded->gpuCostFeatures();
+        SkDebugf("concave AA paths: %d (area %g)\n",
+                 features.fConcaveAAPaths, features.fConcaveAAPathArea);
+        SkDebugf("path effects: %d\n", features.fPathEffects);
+        SkDebugf("mask filters: %d\n", features.fMaskFilters);
+        SkDebugf("penalty: %g (budget %g)\n", recorded->estimateGpuCostPenalty(model),
+                 model.fBudget);
+    }
+
+    if (recorded->suitableForGpuRasterization(NULL, model)) {
         SkDebugf("suitable\n");
     } else {
         SkDebugf("unsuitable\n");
@@ -9,6 +9,7 @@
 #include "SkBitmap.h"
 #include "SkColor.h"
 #include "SkColorPriv.h"
+#include "SkNx.h"
 #include "SkTypes.h"
 
 /*static*/ char const * const DiffRecord::ResultNames[DiffRecord::kResultCount] = {
@@ -140,16 +141,22 @@ bool DiffResource::getMatchingStatuses(char* selector, bool statuses[kStatusCoun
     return understood;
 }
 
-static inline bool colors_match_thresholded(SkPMColor c0, SkPMColor c1, const int threshold) {
-    int da = SkGetPackedA32(c0) - SkGetPackedA32(c1);
-    int dr = SkGetPackedR32(c0) - SkGetPackedR32(c1);
-    int dg = SkGetPackedG32(c0) - SkGetPackedG32(c1);
-    int db = SkGetPackedB32(c0) - SkGetPackedB32(c1);
+// Returns the per-channel absolute difference of two colors, packed the same way.
+static inline SkPMColor abs_diff_pmcolor(SkPMColor c0, SkPMColor c1) {
+    return SkPackARGB32NoCheck(SkAbs32(SkGetPackedA32(c0) - SkGetPackedA32(c1)),
+                               SkAbs32(SkGetPackedR32(c0) - SkGetPackedR32(c1)),
+                               SkAbs32(SkGetPackedG32(c0) - SkGetPackedG32(c1)),
+                               SkAbs32(SkGetPackedB32(c0) - SkGetPackedB32(c1)));
+}
 
-    return ((SkAbs32(da) <= threshold) &&
-            (SkAbs32(dr) <= threshold) &&
-            (SkAbs32(dg) <= threshold) &&
-            (SkAbs32(db) <= threshold));
+// Computes abs_diff_pmcolor() for four pixels at once.
+static inline void abs_diff_pmcolor_x4(const SkPMColor c0[4], const SkPMColor c1[4],
+                                       SkPMColor diff[4]) {
+    Sk16b a = Sk16b::Load(reinterpret_cast<const uint8_t*>(c0)),
+          b = Sk16b::Load(reinterpret_cast<const uint8_t*>(c1)),
+          m = Sk16b::Min(a, b);
+    // One of a-m and b-m is zero in every byte, so their sum is |a-b| and never overflows.
+    ((a - m) + (b - m)).store(reinterpret_cast<uint8_t*>(diff));
 }
 
 const SkPMColor PMCOLOR_WHITE = SkPreMultiplyColor(SK_ColorWHITE);
@@ -175,40 +182,58 @@ void compute_diff(DiffRecord* dr, DiffMetricProc diffFunction, const int colorTh
     // # of pixels at the end.
     dr->fWeightedFraction = 0;
     for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            SkPMColor c0 = *dr->fBase.fBitmap.getAddr32(x, y);
-            SkPMColor c1 = *dr->fComparison.fBitmap.getAddr32(x, y);
-            SkPMColor outputDifference = diffFunction(c0, c1);
-            uint32_t thisA = SkAbs32(SkGetPackedA32(c0) - SkGetPackedA32(c1));
-            uint32_t thisR = SkAbs32(SkGetPackedR32(c0) - SkGetPackedR32(c1));
-            uint32_t thisG = SkAbs32(SkGetPackedG32(c0) - SkGetPackedG32(c1));
-            uint32_t thisB = SkAbs32(SkGetPackedB32(c0) - SkGetPackedB32(c1));
-            totalMismatchA += thisA;
-            totalMismatchR += thisR;
-            totalMismatchG += thisG;
-            totalMismatchB += thisB;
-            // In HSV, value is defined as max RGB component.
-            int value = MAX3(thisR, thisG, thisB);
-            dr->fWeightedFraction += ((float) value) / 255;
-            if (thisA > dr->fMaxMismatchA) {
-                dr->fMaxMismatchA = thisA;
-            }
-            if (thisR > dr->fMaxMismatchR) {
-                dr->fMaxMismatchR = thisR;
-            }
-            if (thisG > dr->fMaxMismatchG) {
-                dr->fMaxMismatchG = thisG;
-            }
-            if (thisB > dr->fMaxMismatchB) {
-                dr->fMaxMismatchB = thisB;
-            }
-            if (!colors_match_thresholded(c0, c1, colorThreshold)) {
-                mismatchedPixels++;
-                *dr->fDifference.fBitmap.getAddr32(x, y) = outputDifference;
-                *dr->fWhite.fBitmap.getAddr32(x, y) = PMCOLOR_WHITE;
+        const SkPMColor* base = dr->fBase.fBitmap.getAddr32(0, y);
+        const SkPMColor* comparison = dr->fComparison.fBitmap.getAddr32(0, y);
+        SkPMColor* difference = dr->fDifference.fBitmap.getAddr32(0, y);
+        SkPMColor* white = dr->fWhite.fBitmap.getAddr32(0, y);
+        for (int x = 0; x < w; x += 4) {
+            const int n = SkTMin(4, w - x);
+            SkPMColor absDiffs[4];
+            if (4 == n) {
+                abs_diff_pmcolor_x4(base + x, comparison + x, absDiffs);
             } else {
-                *dr->fDifference.fBitmap.getAddr32(x, y) = 0;
-                *dr->fWhite.fBitmap.getAddr32(x, y) = PMCOLOR_BLACK;
+                for (int i = 0; i < n; i++) {
+                    absDiffs[i] = abs_diff_pmcolor(base[x + i], comparison[x + i]);
+                }
+            }
+            for (int i = 0; i < n; i++) {
+                // Identical pixels contribute nothing to any metric.
+                if (0 == absDiffs[i]) {
+                    difference[x + i] = 0;
+                    white[x + i] = PMCOLOR_BLACK;
+                    continue;
+                }
+                uint32_t thisA = SkGetPackedA32(absDiffs[i]);
+                uint32_t thisR = SkGetPackedR32(absDiffs[i]);
+                uint32_t thisG = SkGetPackedG32(absDiffs[i]);
+                uint32_t thisB = SkGetPackedB32(absDiffs[i]);
+                totalMismatchA += thisA;
+                totalMismatchR += thisR;
+                totalMismatchG += thisG;
+                totalMismatchB += thisB;
+                // In HSV, value is defined as max RGB component.
+                int value = MAX3(thisR, thisG, thisB);
+                dr->fWeightedFraction += ((float) value) / 255;
+                if (thisA > dr->fMaxMismatchA) {
+                    dr->fMaxMismatchA = thisA;
+                }
+                if (thisR > dr->fMaxMismatchR) {
+                    dr->fMaxMismatchR = thisR;
+                }
+                if (thisG > dr->fMaxMismatchG) {
+                    dr->fMaxMismatchG = thisG;
+                }
+                if (thisB > dr->fMaxMismatchB) {
+                    dr->fMaxMismatchB = thisB;
+                }
+                if (MAX2(MAX2(thisA, thisR), MAX2(thisG, thisB)) > (uint32_t)colorThreshold) {
+                    mismatchedPixels++;
+                    difference[x + i] = diffFunction(base[x + i], comparison[x + i]);
+                    white[x + i] = PMCOLOR_WHITE;
+                } else {
+                    difference[x + i] = 0;
+                    white[x + i] = PMCOLOR_BLACK;
+                }
             }
         }
     }
@@ -17,6 +17,7 @@
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 #include "SkTSearch.h"
+#include "SkTaskGroup.h"
 
 __SK_FORCE_IMAGE_DECODER_LINKING;
 
@@ -372,6 +373,54 @@ static void get_bounds(DiffRecord& drp) {
 
 #define VERBOSE_STATUS(status,color,filename) if (verbose) printf( "[ " color " %10s " ANSI_COLOR_RESET " ] %s\n", status, filename->c_str())
 
+/// Reads and compares a pair of files found in both directories, first byte for byte and then,
+/// if they differ, pixel by pixel. Fills in drp's statuses and result.
+static void compare_files(DiffRecord* drp,
+                          DiffMetricProc dmp,
+                          const int colorThreshold,
+                          const SkString& outputDir,
+                          bool verbose) {
+    const SkString* baseName = &drp->fBase.fFilename;
+    const SkString* comparisonName = &drp->fComparison.fFilename;
+
+    SkAutoDataUnref baseFileBits(read_file(drp->fBase.fFullPath.c_str()));
+    if (baseFileBits) {
+        drp->fBase.fStatus = DiffResource::kRead_Status;
+    }
+    SkAutoDataUnref comparisonFileBits(read_file(drp->fComparison.fFullPath.c_str()));
+    if (comparisonFileBits) {
+        drp->fComparison.fStatus = DiffResource::kRead_Status;
+    }
+    if (NULL == baseFileBits || NULL == comparisonFileBits) {
+        if (NULL == baseFileBits) {
+            drp->fBase.fStatus = DiffResource::kCouldNotRead_Status;
+            VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, baseName);
+        }
+        if (NULL == comparisonFileBits) {
+            drp->fComparison.fStatus = DiffResource::kCouldNotRead_Status;
+            VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, comparisonName);
+        }
+        drp->fResult = DiffRecord::kCouldNotCompare_Result;
+
+    } else if (are_buffers_equal(baseFileBits, comparisonFileBits)) {
+        drp->fResult = DiffRecord::kEqualBits_Result;
+        VERBOSE_STATUS("MATCH", ANSI_COLOR_GREEN, baseName);
+    } else {
+        AutoReleasePixels arp(drp);
+        get_bitmap(baseFileBits, drp->fBase, SkImageDecoder::kDecodePixels_Mode);
+        get_bitmap(comparisonFileBits, drp->fComparison,
+                   SkImageDecoder::kDecodePixels_Mode);
+        VERBOSE_STATUS("DIFFERENT", ANSI_COLOR_RED, baseName);
+        if (DiffResource::kDecoded_Status == drp->fBase.fStatus &&
+            DiffResource::kDecoded_Status == drp->fComparison.fStatus) {
+            create_and_write_diff_image(drp, dmp, colorThreshold,
+                                        outputDir, drp->fBase.fFilename);
+        } else {
+            drp->fResult = DiffRecord::kCouldNotCompare_Result;
+        }
+    }
+}
+
 /// Creates difference images, returns the number that have a 0 metric.
 /// If outputDir.isEmpty(), don't write out diff files.
 static void create_diff_images (DiffMetricProc dmp,
@@ -405,6 +454,7 @@ static void create_diff_images (DiffMetricProc dmp,
               sizeof(SkString*), SkCastForQSort(compare_file_name_metrics));
     }
 
+    RecordArray records;
     int i = 0;
     int j = 0;
 
@@ -468,53 +518,12 @@ static void create_diff_images (DiffMetricProc dmp,
             drp->fComparison.fFullPath = comparisonPath;
             drp->fComparison.fStatus = DiffResource::kExists_Status;
 
-            SkAutoDataUnref baseFileBits(read_file(drp->fBase.fFullPath.c_str()));
-            if (baseFileBits) {
-                drp->fBase.fStatus = DiffResource::kRead_Status;
-            }
-            SkAutoDataUnref comparisonFileBits(read_file(drp->fComparison.fFullPath.c_str()));
-            if (comparisonFileBits) {
-                drp->fComparison.fStatus = DiffResource::kRead_Status;
-            }
-            if (NULL == baseFileBits || NULL == comparisonFileBits) {
-                if (NULL == baseFileBits) {
-                    drp->fBase.fStatus = DiffResource::kCouldNotRead_Status;
-                    VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, baseFiles[i]);
-                }
-                if (NULL == comparisonFileBits) {
-                    drp->fComparison.fStatus = DiffResource::kCouldNotRead_Status;
-                    VERBOSE_STATUS("READ FAIL", ANSI_COLOR_RED, comparisonFiles[j]);
-                }
-                drp->fResult = DiffRecord::kCouldNotCompare_Result;
-
-            } else if (are_buffers_equal(baseFileBits, comparisonFileBits)) {
-                drp->fResult = DiffRecord::kEqualBits_Result;
-                VERBOSE_STATUS("MATCH", ANSI_COLOR_GREEN, baseFiles[i]);
-            } else {
-                AutoReleasePixels arp(drp);
-                get_bitmap(baseFileBits, drp->fBase, SkImageDecoder::kDecodePixels_Mode);
-                get_bitmap(comparisonFileBits, drp->fComparison,
-                           SkImageDecoder::kDecodePixels_Mode);
-                VERBOSE_STATUS("DIFFERENT", ANSI_COLOR_RED, baseFiles[i]);
-                if (DiffResource::kDecoded_Status == drp->fBase.fStatus &&
-                    DiffResource::kDecoded_Status == drp->fComparison.fStatus) {
-                    create_and_write_diff_image(drp, dmp, colorThreshold,
-                                                outputDir, drp->fBase.fFilename);
-                } else {
-                    drp->fResult = DiffRecord::kCouldNotCompare_Result;
-                }
-            }
-
+            // The pair is read, compared and diffed in parallel below.
             ++i;
             ++j;
         }
 
-        if (getBounds) {
-            get_bounds(*drp);
-        }
-        SkASSERT(DiffRecord::kUnknown_Result != drp->fResult);
-        differences->push(drp);
-        summary->add(drp);
+        records.push(drp);
     }
 
     for (; i < baseFiles.count(); ++i) {
@@ -531,11 +540,7 @@ static void create_diff_images (DiffMetricProc dmp,
         drp->fComparison.fStatus = DiffResource::kDoesNotExist_Status;
 
         drp->fResult = DiffRecord::kCouldNotCompare_Result;
-        if (getBounds) {
-            get_bounds(*drp);
-        }
-        differences->push(drp);
-        summary->add(drp);
+        records.push(drp);
     }
 
     for (; j < comparisonFiles.count(); ++j) {
@@ -552,11 +557,24 @@ static void create_diff_images (DiffMetricProc dmp,
         drp->fComparison.fStatus = DiffResource::kExists_Status;
 
         drp->fResult = DiffRecord::kCouldNotCompare_Result;
+        records.push(drp);
+    }
+
+    // Reading, decoding and diffing dominate, and each record is independent.
+    sk_parallel_for(records.count(), [&](int k) {
+        DiffRecord* drp = records[k];
+        if (DiffRecord::kUnknown_Result == drp->fResult) {
+            compare_files(drp, dmp, colorThreshold, outputDir, verbose);
+        }
         if (getBounds) {
             get_bounds(*drp);
         }
-        differences->push(drp);
-        summary->add(drp);
+    });
+
+    for (int k = 0; k < records.count(); ++k) {
+        SkASSERT(DiffRecord::kUnknown_Result != records[k]->fResult);
+        differences->push(records[k]);
+        summary->add(records[k]);
     }
 
     release_file_list(&baseFiles);
@@ -804,6 +822,7 @@ int tool_main(int argc, char** argv) {
         matchSubstrings.push(new SkString(""));
     }
 
+    SkTaskGroup::Enabler enabled;
     create_diff_images(diffProc, colorThreshold, &differences,
                        baseDir, comparisonDir, outputDir,
                        matchSubstrings, nomatchSubstrings, recurseIntoSubdirs, generateDiffs,
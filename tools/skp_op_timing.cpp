@@ -0,0 +1,342 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Plays back a corpus of .skps one op at a time, timing every op, and writes a histogram of op
+// times for each op type and combination of paint features, aggregated across the corpus, as JSON.
+// Where SKPBench times whole pictures and dump_record prints the ops of one .skp, this shows which
+// ops dominate real content on a given backend.
+
+#include "SkCanvas.h"
+#include "SkCommandLineFlags.h"
+#include "SkGraphics.h"
+#include "SkJSONCPP.h"
+#include "SkOSFile.h"
+#include "SkPicture.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecordOpts.h"
+#include "SkRecordPattern.h"
+#include "SkRecorder.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+#include "SkTSort.h"
+#include "SkTemplates.h"
+
+#include "LazyDecodeBitmap.h"
+#include "Timer.h"
+
+#if SK_SUPPORT_GPU
+    #include "GrContext.h"
+    #include "GrContextFactory.h"
+#endif
+
+DEFINE_string2(skps, r, "skps", ".skps, or directories of .skps, to time.");
+DEFINE_string(match, "", "The usual filters on file names to time.");
+DEFINE_string(config, "8888", "Backend to time on: 8888, 565, or gpu.");
+DEFINE_int32(loops, 5, "Play each .skp this many times, keeping each op's fastest time.");
+DEFINE_bool2(optimize, O, false, "Run SkRecordOptimize before timing.");
+DEFINE_string2(outResultsFile, o, "", "Write the JSON here instead of to stdout.");
+
+using namespace SkRecords;
+
+// The paint features we split each op type by.
+enum Feature {
+    kAA_Feature          = 1 << 0,
+    kShader_Feature      = 1 << 1,
+    kMaskFilter_Feature  = 1 << 2,
+    kImageFilter_Feature = 1 << 3,
+};
+static const int kFeatureCount = 4;
+static const char* kFeatureNames[kFeatureCount] = { "aa", "shader", "maskfilter", "imagefilter" };
+
+#define COUNT_TYPE(T) +1
+static const int kOpTypeCount = 0 SK_RECORD_TYPES(COUNT_TYPE);
+#undef COUNT_TYPE
+
+#define NAME_TYPE(T) #T,
+static const char* kOpTypeNames[] = { SK_RECORD_TYPES(NAME_TYPE) };
+#undef NAME_TYPE
+
+// Bucket 0 holds ops under 1us, bucket i > 0 those in [2^(i-1), 2^i) us, and the last bucket
+// everything slower.
+static const int kBucketCount = 20;
+
+struct OpStats {
+    int     fCount;
+    double  fTotalMs;
+    double  fMaxMs;
+    int     fBuckets[kBucketCount];
+};
+
+static OpStats gStats[kOpTypeCount][1 << kFeatureCount];
+
+static int bucket_for(double ms) {
+    double us = ms * 1000;
+    int bucket = 0;
+    while (bucket < kBucketCount - 1 && us >= (double)(1 << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+static unsigned paint_features(const SkPaint* paint) {
+    if (!paint) {
+        return 0;
+    }
+    unsigned features = 0;
+    if (paint->isAntiAlias())    { features |= kAA_Feature; }
+    if (paint->getShader())      { features |= kShader_Feature; }
+    if (paint->getMaskFilter())  { features |= kMaskFilter_Feature; }
+    if (paint->getImageFilter()) { features |= kImageFilter_Feature; }
+    return features;
+}
+
+struct TypeOf {
+    template <typename T>
+    Type operator()(const T&) { return T::kType; }
+};
+
+// Draws and SaveLayers are split by their paint's features.  Everything else has no features.
+static unsigned op_features(SkRecord* record, unsigned i) {
+    IsDraw draw;
+    if (record->mutate<bool>(i, draw)) {
+        return paint_features(draw.get());
+    }
+    Is<SaveLayer> saveLayer;
+    if (record->mutate<bool>(i, saveLayer)) {
+        return paint_features(saveLayer.get()->paint);
+    }
+    return 0;
+}
+
+// Something to draw into, and a way to wait until its draws have really happened.
+class Target {
+public:
+    virtual ~Target() {}
+    virtual SkCanvas* canvas() = 0;
+    // Called after every op, inside its timing.
+    virtual void finish() {}
+};
+
+class RasterTarget : public Target {
+public:
+    RasterTarget(const SkImageInfo& info) : fSurface(SkSurface::NewRaster(info)) {}
+    SkCanvas* canvas() override { return fSurface ? fSurface->getCanvas() : NULL; }
+
+private:
+    SkAutoTUnref<SkSurface> fSurface;
+};
+
+#if SK_SUPPORT_GPU
+static SkAutoTDelete<GrContextFactory> gGrFactory;
+
+// GPU ops are flushed and waited on one by one, so their times include the GPU's work, plus
+// a round trip each that whole-picture timings would not pay.
+class GpuTarget : public Target {
+public:
+    GpuTarget(const SkImageInfo& info) {
+        const GrContextFactory::GLContextType type = GrContextFactory::kNative_GLContextType;
+        fContext = gGrFactory->get(type);
+        fGL = gGrFactory->getGLContext(type);
+        if (fContext) {
+            fSurface.reset(SkSurface::NewRenderTarget(fContext, SkSurface::kNo_Budgeted, info));
+        }
+    }
+    SkCanvas* canvas() override { return fSurface ? fSurface->getCanvas() : NULL; }
+    void finish() override {
+        fContext->flush();
+        SK_GL(*fGL, Finish());
+    }
+
+private:
+    GrContext*              fContext;
+    SkGLContext*            fGL;
+    SkAutoTUnref<SkSurface> fSurface;
+};
+#endif
+
+static Target* make_target(const SkImageInfo& info) {
+    if (0 == strcmp(FLAGS_config[0], "8888")) {
+        return SkNEW_ARGS(RasterTarget, (info));
+    }
+    if (0 == strcmp(FLAGS_config[0], "565")) {
+        return SkNEW_ARGS(RasterTarget, (info.makeColorType(kRGB_565_SkColorType)
+                                             .makeAlphaType(kOpaque_SkAlphaType)));
+    }
+#if SK_SUPPORT_GPU
+    if (0 == strcmp(FLAGS_config[0], "gpu")) {
+        return SkNEW_ARGS(GpuTarget, (info));
+    }
+#endif
+    SkDebugf("Unknown config %s.\n", FLAGS_config[0]);
+    exit(1);
+    return NULL;
+}
+
+static bool time_skp(const char* path) {
+    SkAutoTDelete<SkStream> stream(SkStream::NewFromFile(path));
+    if (!stream) {
+        SkDebugf("Could not read %s.\n", path);
+        return false;
+    }
+    SkAutoTUnref<SkPicture> src(SkPicture::CreateFromStream(stream, sk_tools::LazyDecodeBitmap));
+    if (!src) {
+        SkDebugf("Could not read %s as an SkPicture.\n", path);
+        return false;
+    }
+    const int w = SkScalarCeilToInt(src->cullRect().width());
+    const int h = SkScalarCeilToInt(src->cullRect().height());
+
+    SkRecord record;
+    SkRecorder recorder(&record, w, h);
+    src->playback(&recorder);
+    if (FLAGS_optimize) {
+        SkRecordOptimize(&record);
+    }
+
+    SkAutoTDelete<Target> target(make_target(SkImageInfo::MakeN32Premul(w, h)));
+    SkCanvas* canvas = target->canvas();
+    if (!canvas) {
+        SkDebugf("Could not make a %s canvas for %s.\n", FLAGS_config[0], path);
+        return false;
+    }
+
+    SkAutoTArray<double> fastest(SkToInt(record.count()));
+    for (int loop = 0; loop < FLAGS_loops; loop++) {
+        canvas->clear(SK_ColorTRANSPARENT);
+        target->finish();
+
+        // Undo any matrix and clip changes the .skp leaves behind before the next loop.
+        SkAutoCanvasRestore acr(canvas, true);
+        SkRecords::Draw draw(canvas, NULL, NULL, 0, NULL);
+        for (unsigned i = 0; i < record.count(); i++) {
+            WallTimer timer;
+            timer.start();
+                record.visit<void>(i, draw);
+                target->finish();
+            timer.end();
+            if (0 == loop || timer.fWall < fastest[i]) {
+                fastest[i] = timer.fWall;
+            }
+        }
+    }
+
+    TypeOf typeOf;
+    for (unsigned i = 0; i < record.count(); i++) {
+        OpStats& stats = gStats[record.visit<Type>(i, typeOf)][op_features(&record, i)];
+        stats.fCount++;
+        stats.fTotalMs += fastest[i];
+        stats.fMaxMs = SkTMax(stats.fMaxMs, fastest[i]);
+        stats.fBuckets[bucket_for(fastest[i])]++;
+    }
+    return true;
+}
+
+static Json::Value to_json(int skps) {
+    Json::Value root;
+    root["config"] = FLAGS_config[0];
+    root["skps"] = skps;
+    root["loops"] = FLAGS_loops;
+    for (int b = 0; b < kBucketCount - 1; b++) {
+        root["bucket_upper_bounds_us"].append(1 << b);
+    }
+
+    // Sorted slowest first, since those are the ops worth looking at.
+    SkTDArray<const OpStats*> sorted;
+    for (int type = 0; type < kOpTypeCount; type++) {
+        for (int features = 0; features < (1 << kFeatureCount); features++) {
+            if (gStats[type][features].fCount > 0) {
+                *sorted.append() = &gStats[type][features];
+            }
+        }
+    }
+    if (sorted.count() > 1) {
+        SkTQSort(sorted.begin(), sorted.end() - 1, [](const OpStats* a, const OpStats* b) {
+            return a->fTotalMs > b->fTotalMs;
+        });
+    }
+
+    root["ops"] = Json::Value(Json::arrayValue);
+    for (int i = 0; i < sorted.count(); i++) {
+        const OpStats& stats = *sorted[i];
+        const int index = SkToInt(&stats - &gStats[0][0]);
+        const int type = index >> kFeatureCount,
+                  features = index & ((1 << kFeatureCount) - 1);
+
+        Json::Value op;
+        op["op"] = kOpTypeNames[type];
+        op["features"] = Json::Value(Json::arrayValue);
+        for (int f = 0; f < kFeatureCount; f++) {
+            if (features & (1 << f)) {
+                op["features"].append(kFeatureNames[f]);
+            }
+        }
+        op["count"]    = stats.fCount;
+        op["total_ms"] = stats.fTotalMs;
+        op["mean_us"]  = stats.fTotalMs * 1000 / stats.fCount;
+        op["max_us"]   = stats.fMaxMs * 1000;
+        for (int b = 0; b < kBucketCount; b++) {
+            op["histogram"].append(stats.fBuckets[b]);
+        }
+        root["ops"].append(op);
+    }
+    return root;
+}
+
+int tool_main(int argc, char** argv);
+int tool_main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Times each op of a corpus of .skps, grouped by type and paint.");
+    SkCommandLineFlags::Parse(argc, argv);
+    SkAutoGraphics ag;
+#if SK_SUPPORT_GPU
+    gGrFactory.reset(SkNEW(GrContextFactory));
+#endif
+
+    SkTArray<SkString> paths;
+    for (int i = 0; i < FLAGS_skps.count(); i++) {
+        if (SkStrEndsWith(FLAGS_skps[i], ".skp")) {
+            paths.push_back() = FLAGS_skps[i];
+        } else {
+            SkOSFile::Iter it(FLAGS_skps[i], ".skp");
+            SkString path;
+            while (it.next(&path)) {
+                paths.push_back() = SkOSPath::Join(FLAGS_skps[i], path.c_str());
+            }
+        }
+    }
+
+    int timed = 0;
+    for (int i = 0; i < paths.count(); i++) {
+        if (SkCommandLineFlags::ShouldSkip(FLAGS_match, paths[i].c_str())) {
+            continue;
+        }
+        if (time_skp(paths[i].c_str())) {
+            timed++;
+        }
+    }
+
+    SkString json(Json::StyledWriter().write(to_json(timed)).c_str());
+    if (FLAGS_outResultsFile.isEmpty()) {
+        fputs(json.c_str(), stdout);
+    } else {
+        SkFILEWStream stream(FLAGS_outResultsFile[0]);
+        stream.writeText(json.c_str());
+    }
+
+#if SK_SUPPORT_GPU
+    gGrFactory.reset(NULL);
+#endif
+    return 0;
+}
+
+#if !defined SK_BUILD_FOR_IOS
+int main(int argc, char * const argv[]) {
+    return tool_main(argc, (char**) argv);
+}
+#endif
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "PerfCounters.h"
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <string.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+const char* PerfCounters::Name(Counter c) {
+    switch (c) {
+        case kCycles_Counter:       return "cycles";
+        case kInstructions_Counter: return "instructions";
+        case kL1DMisses_Counter:    return "l1d_misses";
+        case kLLCMisses_Counter:    return "llc_misses";
+        case kBranchMisses_Counter: return "branch_misses";
+    }
+    SkASSERT(false);
+    return "";
+}
+
+PerfCounters::PerfCounters() {
+    for (int i = 0; i < kCounterCount; i++) {
+        fFDs[i] = -1;
+        fCounts[i] = 0;
+    }
+}
+
+#if defined(__linux__)
+
+static int open_counter(PerfCounters::Counter c) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (c) {
+        case PerfCounters::kCycles_Counter:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfCounters::kInstructions_Counter:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfCounters::kL1DMisses_Counter:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D |
+                          PERF_COUNT_HW_CACHE_OP_READ << 8 |
+                          PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+            break;
+        case PerfCounters::kLLCMisses_Counter:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfCounters::kBranchMisses_Counter:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(__NR_perf_event_open, &attr, 0/*this thread*/, -1/*any cpu*/,
+                        -1/*no group*/, 0/*flags*/);
+}
+
+PerfCounters::~PerfCounters() {
+    for (int i = 0; i < kCounterCount; i++) {
+        if (fFDs[i] >= 0) {
+            close(fFDs[i]);
+        }
+    }
+}
+
+bool PerfCounters::open() {
+    bool any = false;
+    for (int i = 0; i < kCounterCount; i++) {
+        if (fFDs[i] < 0) {
+            fFDs[i] = open_counter((Counter)i);
+        }
+        any = any || fFDs[i] >= 0;
+    }
+    return any;
+}
+
+void PerfCounters::start() {
+    for (int i = 0; i < kCounterCount; i++) {
+        if (fFDs[i] >= 0) {
+            ioctl(fFDs[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fFDs[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void PerfCounters::end() {
+    for (int i = 0; i < kCounterCount; i++) {
+        if (fFDs[i] < 0) {
+            continue;
+        }
+        ioctl(fFDs[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        uint64_t values[3];  // The count, then time enabled and time running.
+        if ((ssize_t)sizeof(values) != read(fFDs[i], values, sizeof(values)) || 0 == values[2]) {
+            fCounts[i] = 0;
+        } else if (values[2] < values[1]) {
+            fCounts[i] = (uint64_t)((double)values[0] * values[1] / values[2]);
+        } else {
+            fCounts[i] = values[0];
+        }
+    }
+}
+
+#else
+
+PerfCounters::~PerfCounters() {}
+bool PerfCounters::open() { return false; }
+void PerfCounters::start() {}
+void PerfCounters::end() {}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2015 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef PerfCounters_DEFINED
+#define PerfCounters_DEFINED
+
+#include "SkTypes.h"
+
+/**
+ * Counts hardware events (cycles, instructions, cache and branch misses) on the calling thread
+ * between start() and end().  Counters come from perf_event_open(), so they're only available on
+ * Linux, and only when the kernel and CPU let us have them; elsewhere open() returns false and
+ * start() and end() do nothing.
+ */
+class PerfCounters : SkNoncopyable {
+public:
+    enum Counter {
+        kCycles_Counter,
+        kInstructions_Counter,
+        kL1DMisses_Counter,
+        kLLCMisses_Counter,
+        kBranchMisses_Counter,
+
+        kLast_Counter = kBranchMisses_Counter
+    };
+    static const int kCounterCount = kLast_Counter + 1;
+
+    // A short name for the counter, suitable for JSON keys, e.g. "llc_misses".
+    static const char* Name(Counter);
+
+    PerfCounters();
+    ~PerfCounters();
+
+    // Opens counters for the calling thread.  Returns true if any counter is available.
+    bool open();
+
+    bool has(Counter c) const { return fFDs[c] >= 0; }
+
+    void start();
+    void end();
+
+    // The count between the last start() and end().  Counts are scaled up if the kernel had to
+    // share the hardware counter with other events.  Zero for counters we don't have.
+    uint64_t count(Counter c) const { return fCounts[c]; }
+
+private:
+    int      fFDs[kCounterCount];
+    uint64_t fCounts[kCounterCount];
+};
+
+#endif